@@ -24,6 +24,7 @@
 #include <asm/cacheflush.h>
 #include <asm/alternative.h>
 #include <asm/cpufeature.h>
+#include <asm/insn.h>
 #include <linux/stop_machine.h>
 
 extern struct alt_instr __alt_instructions[], __alt_instructions_end[];
@@ -33,11 +34,33 @@ struct alt_region {
 	struct alt_instr *end;
 };
 
+/*
+ * A B or BL in the replacement was assembled relative to
+ * .altinstr_replacement; move its offset to where it ends up.
+ */
+static u32 get_alt_insn(u8 *insnptr, u8 *altinsnptr)
+{
+	u32 insn = le32_to_cpu(*(__le32 *)altinsnptr);
+	unsigned long target;
+
+	if (aarch64_insn_is_b(insn) || aarch64_insn_is_bl(insn)) {
+		/* sign extended imm26, in bytes */
+		target = (unsigned long)altinsnptr + ((s32)(insn << 6) >> 4);
+		insn = aarch64_insn_gen_branch_imm((unsigned long)insnptr, target,
+						   aarch64_insn_is_b(insn) ?
+						   AARCH64_INSN_BRANCH_NOLINK :
+						   AARCH64_INSN_BRANCH_LINK);
+	}
+
+	return insn;
+}
+
 static int __apply_alternatives(void *alt_region)
 {
 	struct alt_instr *alt;
 	struct alt_region *region = alt_region;
 	u8 *origptr, *replptr;
+	int i;
 
 	for (alt = region->begin; alt < region->end; alt++) {
 		if (!cpus_have_cap(alt->cpufeature))
@@ -49,7 +72,10 @@ static int __apply_alternatives(void *alt_region)
 
 		origptr = (u8 *)&alt->orig_offset + alt->orig_offset;
 		replptr = (u8 *)&alt->alt_offset + alt->alt_offset;
-		memcpy(origptr, replptr, alt->alt_len);
+		/* not memcpy(), which may be one of the patched routines */
+		for (i = 0; i < alt->alt_len; i += AARCH64_INSN_SIZE)
+			*(__le32 *)(origptr + i) =
+				cpu_to_le32(get_alt_insn(origptr + i, replptr + i));
 		flush_icache_range((uintptr_t)origptr,
 				   (uintptr_t)(origptr + alt->alt_len));
 	}
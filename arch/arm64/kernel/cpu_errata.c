@@ -104,11 +104,32 @@ struct arm64_cpu_capabilities arm64_errata[] = {
 	}
 };
 
+/*
+ * Not an erratum: memcpy() and copy_page() have loops for the in-order
+ * A53, which only pay when no other kind of core runs them.  The
+ * alternatives are applied once all boot CPUs are up.
+ */
+static void check_local_cpu_tuning(void)
+{
+	static bool seen;
+
+	if ((read_cpuid_id() & CPU_MODEL_MASK) != MIDR_CORTEX_A53) {
+		if (cpus_have_cap(ARM64_TUNE_CORTEX_A53))
+			pr_info("mixed cores, generic string routines\n");
+		clear_bit(ARM64_TUNE_CORTEX_A53, cpu_hwcaps);
+	} else if (!seen) {
+		cpus_set_cap(ARM64_TUNE_CORTEX_A53);
+	}
+	seen = true;
+}
+
 void check_local_cpu_errata(void)
 {
 	struct arm64_cpu_capabilities *cpus = arm64_errata;
 	int i;
 
+	check_local_cpu_tuning();
+
 	for (i = 0; cpus[i].desc; i++) {
 		if (!cpus[i].is_affected(&cpus[i]))
 			continue;
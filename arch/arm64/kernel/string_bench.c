@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2015 MediaTek Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Throughput of memcpy(), memset() and copy_page() over a range of
+ * sizes, for comparing the generic and the A53 routines (see
+ * ARM64_TUNE_CORTEX_A53).  cat /sys/kernel/debug/string_bench runs it.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/mm.h>
+#include <linux/sizes.h>
+#include <linux/string.h>
+#include <linux/vmalloc.h>
+#include <asm/cpufeature.h>
+#include <asm/page.h>
+
+#define BENCH_BUF_SIZE	SZ_4M
+#define BENCH_BYTES	SZ_32M	/* moved per size and routine */
+
+static const size_t bench_sizes[] = {
+	64, 256, SZ_1K, SZ_4K, SZ_16K, SZ_64K, SZ_256K, SZ_1M, SZ_4M,
+};
+
+/* GB/s * 100 */
+static unsigned long bench_rate(size_t bytes, ktime_t start)
+{
+	s64 ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	return ns > 0 ? div64_s64((s64)bytes * 100, ns) : 0;
+}
+
+static void bench_copy_pages(void *dst, void *src, size_t size)
+{
+	size_t off;
+
+	for (off = 0; off < size; off += PAGE_SIZE)
+		copy_page(dst + off, src + off);
+}
+
+static int string_bench_show(struct seq_file *m, void *v)
+{
+	void *src, *dst;
+	unsigned long cpy, set, page;
+	size_t size, done, off;
+	ktime_t start;
+	int i;
+
+	src = vmalloc(BENCH_BUF_SIZE);
+	dst = vmalloc(BENCH_BUF_SIZE);
+	if (!src || !dst) {
+		vfree(src);
+		vfree(dst);
+		return -ENOMEM;
+	}
+	memset(src, 0x5a, BENCH_BUF_SIZE);
+	memset(dst, 0, BENCH_BUF_SIZE);
+
+	seq_printf(m, "routines: %s\n", cpus_have_cap(ARM64_TUNE_CORTEX_A53) ?
+		   "cortex-a53" : "generic");
+	seq_printf(m, "%10s %10s %10s %10s  (GB/s)\n", "size", "memcpy", "memset",
+		   "copy_page");
+
+	for (i = 0; i < ARRAY_SIZE(bench_sizes); i++) {
+		size = bench_sizes[i];
+
+		/* walk the buffer so that large sizes do not stay in cache */
+		start = ktime_get();
+		for (done = 0, off = 0; done < BENCH_BYTES; done += size) {
+			memcpy(dst + off, src + off, size);
+			off = (off + size) % BENCH_BUF_SIZE;
+		}
+		cpy = bench_rate(done, start);
+
+		start = ktime_get();
+		for (done = 0, off = 0; done < BENCH_BYTES; done += size) {
+			memset(dst + off, 0x33, size);
+			off = (off + size) % BENCH_BUF_SIZE;
+		}
+		set = bench_rate(done, start);
+
+		page = 0;
+		if (size >= PAGE_SIZE) {
+			start = ktime_get();
+			for (done = 0, off = 0; done < BENCH_BYTES; done += size) {
+				bench_copy_pages(dst + off, src + off, size);
+				off = (off + size) % BENCH_BUF_SIZE;
+			}
+			page = bench_rate(done, start);
+		}
+
+		seq_printf(m, "%10zu %7lu.%02lu %7lu.%02lu", size, cpy / 100,
+			   cpy % 100, set / 100, set % 100);
+		if (page)
+			seq_printf(m, " %7lu.%02lu\n", page / 100, page % 100);
+		else
+			seq_printf(m, " %10s\n", "-");
+		cond_resched();
+	}
+
+	vfree(src);
+	vfree(dst);
+	return 0;
+}
+
+static int string_bench_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, string_bench_show, NULL);
+}
+
+static const struct file_operations string_bench_fops = {
+	.open = string_bench_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init string_bench_init(void)
+{
+	debugfs_create_file("string_bench", 0400, NULL, NULL, &string_bench_fops);
+	return 0;
+}
+late_initcall(string_bench_init);
@@ -373,6 +373,104 @@ static void __init parse_dt_cpu_capacity(void)
 	}
 }
 
+#ifdef CONFIG_SCHED_HMP
+/*
+ * Energy model, one cpu and one cluster level table per cpu:
+ *
+ *	cpu@0 {
+ *		sched-energy-costs = <&CPU_COST_0 &CLUSTER_COST_0>;
+ *	};
+ *	CPU_COST_0: core-cost0 {
+ *		busy-cost-data = <cap power ...>;
+ *		idle-cost-data = <power ...>;
+ *	};
+ */
+static struct sched_group_energy *energy_costs[NR_CPUS][NR_SCHED_ENERGY_LEVELS];
+
+const struct sched_group_energy *
+arch_get_energy_costs(int cpu, enum sched_energy_level level)
+{
+	return energy_costs[cpu][level];
+}
+
+static struct sched_group_energy * __init parse_energy_costs(struct device_node *np)
+{
+	struct sched_group_energy *sge;
+	int nr_cap, nr_idle, i;
+	u32 *val;
+
+	nr_cap = of_property_count_u32_elems(np, "busy-cost-data");
+	nr_idle = of_property_count_u32_elems(np, "idle-cost-data");
+	if (nr_cap <= 0 || (nr_cap & 1) || nr_idle <= 0) {
+		pr_err("%s: bad energy cost data\n", np->full_name);
+		return NULL;
+	}
+	nr_cap /= 2;
+
+	sge = kzalloc(sizeof(*sge) + nr_cap * sizeof(struct capacity_state) +
+		      nr_idle * sizeof(struct idle_state), GFP_NOWAIT);
+	val = kcalloc(max(2 * nr_cap, nr_idle), sizeof(u32), GFP_NOWAIT);
+	if (!sge || !val)
+		goto fail;
+
+	sge->nr_cap_states = nr_cap;
+	sge->cap_states = (struct capacity_state *)(sge + 1);
+	sge->nr_idle_states = nr_idle;
+	sge->idle_states = (struct idle_state *)(sge->cap_states + nr_cap);
+
+	if (of_property_read_u32_array(np, "busy-cost-data", val, 2 * nr_cap))
+		goto fail;
+	for (i = 0; i < nr_cap; i++) {
+		sge->cap_states[i].cap = val[2 * i];
+		sge->cap_states[i].power = val[2 * i + 1];
+		if (i && sge->cap_states[i].cap <= sge->cap_states[i - 1].cap) {
+			pr_err("%s: capacities not increasing\n", np->full_name);
+			goto fail;
+		}
+	}
+
+	if (of_property_read_u32_array(np, "idle-cost-data", val, nr_idle))
+		goto fail;
+	for (i = 0; i < nr_idle; i++)
+		sge->idle_states[i].power = val[i];
+
+	kfree(val);
+	return sge;
+
+fail:
+	kfree(val);
+	kfree(sge);
+	return NULL;
+}
+
+static void __init parse_dt_energy_costs(void)
+{
+	struct device_node *cn, *np;
+	int cpu, level;
+
+	for_each_possible_cpu(cpu) {
+		cn = of_get_cpu_node(cpu, NULL);
+		if (!cn)
+			continue;
+
+		for (level = 0; level < NR_SCHED_ENERGY_LEVELS; level++) {
+			np = of_parse_phandle(cn, "sched-energy-costs", level);
+			if (!np)
+				break;
+			energy_costs[cpu][level] = parse_energy_costs(np);
+			of_node_put(np);
+		}
+		of_node_put(cn);
+
+		if (energy_costs[cpu][SCHED_ENERGY_CPU])
+			pr_info("CPU%d: energy model with %u capacity states\n",
+				cpu, energy_costs[cpu][SCHED_ENERGY_CPU]->nr_cap_states);
+	}
+}
+#else
+static inline void parse_dt_energy_costs(void) { }
+#endif /* CONFIG_SCHED_HMP */
+
 /*
  * cpu topology table
  */
@@ -495,7 +593,7 @@ void __init init_cpu_topology(void)
 		reset_cpu_topology();
 
 	parse_dt_cpu_capacity();
-
+	parse_dt_energy_costs();
 }
 
 #ifdef CONFIG_MTK_CPU_TOPOLOGY
@@ -232,6 +232,7 @@ static int __kprobes do_page_fault(unsigned long addr, unsigned int esr,
 	if (!down_read_trylock(&mm->mmap_sem)) {
 		if (!user_mode(regs) && !search_exception_tables(regs->pc))
 			goto no_context;
+		count_vm_event(PGFAULT_SEM_WAIT);
 retry:
 		down_read(&mm->mmap_sem);
 	} else {
@@ -279,6 +280,7 @@ retry:
 			 * starvation.
 			 */
 			mm_flags &= ~FAULT_FLAG_ALLOW_RETRY;
+			count_vm_event(PGFAULT_RETRY);
 			goto retry;
 		}
 	}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2015 MediaTek Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Range based inner cache maintenance, see <mt-plat/mt_cache_sync.h>.
+ *
+ * echo <KB> > /sys/kernel/debug/mt_cache_sync/bench times a clean and a
+ * flush of a dirty buffer of that size by VA against the set/way flush of
+ * all CPUs; cat it for the result.  all_kb is where the second one wins.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/export.h>
+#include <linux/mm.h>
+#include <linux/sizes.h>
+#include <linux/hardirq.h>
+#include <linux/dma-direction.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/mutex.h>
+#include <linux/ktime.h>
+#include <linux/vmalloc.h>
+#include <linux/uaccess.h>
+#include <asm/cacheflush.h>
+
+#include <mt-plat/mt_cache_sync.h>
+
+#define MT_CACHE_BENCH_MAX_KB	(64 * 1024)
+
+/* clean or flush size from which the set/way flush is used, KB; 0: never */
+static u32 mt_cache_all_kb = 4096;
+
+static DEFINE_MUTEX(mt_cache_bench_lock);
+static u32 mt_cache_bench_kb;
+static s64 mt_cache_bench_ns[3];	/* clean by VA, flush by VA, set/way */
+
+static void __mt_cache_sync_va(const void *va, size_t size, enum mt_cache_op op)
+{
+	if (op == MT_CACHE_CLEAN)
+		__dma_map_area(va, size, DMA_TO_DEVICE);
+	else if (op == MT_CACHE_INVALIDATE)
+		__dma_unmap_area(va, size, DMA_FROM_DEVICE);
+	else
+		__dma_flush_range(va, va + size);
+}
+
+static bool mt_cache_use_all(size_t size, enum mt_cache_op op)
+{
+	u32 kb = ACCESS_ONCE(mt_cache_all_kb);
+
+	if (op == MT_CACHE_INVALIDATE || !kb || size < (size_t)kb * SZ_1K)
+		return false;
+	return !in_interrupt() && !irqs_disabled();
+}
+
+void mt_cache_sync_range(const void *va, size_t size, enum mt_cache_op op)
+{
+	if (mt_cache_use_all(size, op))
+		smp_inner_dcache_flush_all();
+	else
+		__mt_cache_sync_va(va, size, op);
+}
+EXPORT_SYMBOL(mt_cache_sync_range);
+
+void mt_cache_sync_sg(struct scatterlist *sgl, unsigned int nents,
+		      size_t offset, size_t len, enum mt_cache_op op)
+{
+	struct scatterlist *sg;
+	unsigned int i;
+
+	if (mt_cache_use_all(len, op)) {
+		smp_inner_dcache_flush_all();
+		return;
+	}
+
+	/* no highmem here, an entry is contiguous in the linear map */
+	for_each_sg(sgl, sg, nents, i) {
+		size_t n;
+
+		if (offset >= sg->length) {
+			offset -= sg->length;
+			continue;
+		}
+		n = min_t(size_t, sg->length - offset, len);
+		__mt_cache_sync_va(page_address(sg_page(sg)) + sg->offset + offset,
+				   n, op);
+		offset = 0;
+		len -= n;
+		if (!len)
+			break;
+	}
+}
+EXPORT_SYMBOL(mt_cache_sync_sg);
+
+static s64 mt_cache_bench_one(void *buf, size_t size, int how)
+{
+	ktime_t start;
+
+	memset(buf, how, size);
+	start = ktime_get();
+	if (how == 0)
+		__mt_cache_sync_va(buf, size, MT_CACHE_CLEAN);
+	else if (how == 1)
+		__mt_cache_sync_va(buf, size, MT_CACHE_FLUSH);
+	else
+		smp_inner_dcache_flush_all();
+	return ktime_to_ns(ktime_sub(ktime_get(), start));
+}
+
+static int mt_cache_bench_show(struct seq_file *m, void *v)
+{
+	mutex_lock(&mt_cache_bench_lock);
+	seq_printf(m, "%10s %12s %12s %12s\n", "KB", "clean_va_us", "flush_va_us",
+		   "setway_us");
+	if (mt_cache_bench_kb)
+		seq_printf(m, "%10u %12lld %12lld %12lld\n", mt_cache_bench_kb,
+			   mt_cache_bench_ns[0] / NSEC_PER_USEC,
+			   mt_cache_bench_ns[1] / NSEC_PER_USEC,
+			   mt_cache_bench_ns[2] / NSEC_PER_USEC);
+	seq_printf(m, "all_kb: %u\n", mt_cache_all_kb);
+	mutex_unlock(&mt_cache_bench_lock);
+
+	return 0;
+}
+
+static int mt_cache_bench_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mt_cache_bench_show, NULL);
+}
+
+static ssize_t mt_cache_bench_write(struct file *filp, const char __user *ubuf,
+				    size_t cnt, loff_t *ppos)
+{
+	char buf[16];
+	unsigned long kb;
+	void *mem;
+	int ret, i;
+
+	if (cnt >= sizeof(buf))
+		return -EINVAL;
+
+	if (copy_from_user(&buf, ubuf, cnt))
+		return -EFAULT;
+
+	buf[cnt] = 0;
+
+	ret = kstrtoul(buf, 10, &kb);
+	if (ret < 0)
+		return ret;
+	if (!kb || kb > MT_CACHE_BENCH_MAX_KB)
+		return -EINVAL;
+
+	mem = vmalloc(kb * SZ_1K);
+	if (!mem)
+		return -ENOMEM;
+
+	mutex_lock(&mt_cache_bench_lock);
+	for (i = 0; i < ARRAY_SIZE(mt_cache_bench_ns); i++)
+		mt_cache_bench_ns[i] = mt_cache_bench_one(mem, kb * SZ_1K, i);
+	mt_cache_bench_kb = kb;
+	mutex_unlock(&mt_cache_bench_lock);
+
+	vfree(mem);
+	return cnt;
+}
+
+static const struct file_operations mt_cache_bench_fops = {
+	.open = mt_cache_bench_open,
+	.read = seq_read,
+	.write = mt_cache_bench_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init mt_cache_sync_init(void)
+{
+	struct dentry *dir;
+
+	dir = debugfs_create_dir("mt_cache_sync", NULL);
+	if (!dir)
+		return 0;
+
+	debugfs_create_u32("all_kb", 0644, dir, &mt_cache_all_kb);
+	debugfs_create_file("bench", 0644, dir, NULL, &mt_cache_bench_fops);
+
+	return 0;
+}
+late_initcall(mt_cache_sync_init);
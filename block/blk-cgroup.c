@@ -19,6 +19,7 @@
 #include <linux/genhd.h>
 #include <linux/delay.h>
 #include <linux/atomic.h>
+#include <linux/writeback.h>
 #include "blk-cgroup.h"
 #include "blk.h"
 
@@ -768,11 +769,72 @@ void blkg_conf_finish(struct blkg_conf_ctx *ctx)
 }
 EXPORT_SYMBOL_GPL(blkg_conf_finish);
 
+/**
+ * blkcg_dirty_class - how hard the dirty limits should hit a task
+ * @tsk: the dirtying task
+ *
+ * Returns 1 if @tsk is in a foreground blkcg, -1 if it is in any other
+ * non-root blkcg and 0 in the root.  balance_dirty_pages() lifts the limits
+ * for the former and lowers them for the latter, so that background groups
+ * are throttled before foreground writers are.
+ */
+int blkcg_dirty_class(struct task_struct *tsk)
+{
+	struct blkcg *blkcg;
+	int class = 0;
+
+	rcu_read_lock();
+	blkcg = task_blkcg(tsk);
+	if (blkcg != &blkcg_root)
+		class = blkcg->cfq_foreground ? 1 : -1;
+	rcu_read_unlock();
+
+	return class;
+}
+
+/**
+ * blkcg_account_dirty - account dirtying and throttling to a task's blkcg
+ * @tsk: the dirtying task
+ * @dirtied: pages it dirtied
+ * @paused: jiffies it was just paused for, 0 if not throttled
+ */
+void blkcg_account_dirty(struct task_struct *tsk, unsigned long dirtied,
+			 unsigned long paused)
+{
+	struct blkcg *blkcg;
+
+	rcu_read_lock();
+	blkcg = task_blkcg(tsk);
+	if (dirtied)
+		atomic_long_add(dirtied, &blkcg->nr_dirtied);
+	if (paused) {
+		atomic_long_inc(&blkcg->nr_dirty_throttled);
+		atomic_long_add(paused, &blkcg->dirty_paused);
+	}
+	rcu_read_unlock();
+}
+
+static int blkcg_print_dirty_stat(struct seq_file *sf, void *v)
+{
+	struct blkcg *blkcg = css_to_blkcg(seq_css(sf));
+
+	seq_printf(sf, "dirtied %ld\nthrottled %ld\npaused_ms %u\n",
+		   atomic_long_read(&blkcg->nr_dirtied),
+		   atomic_long_read(&blkcg->nr_dirty_throttled),
+		   jiffies_to_msecs(atomic_long_read(&blkcg->dirty_paused)));
+	return 0;
+}
+
 struct cftype blkcg_files[] = {
 	{
 		.name = "reset_stats",
 		.write_u64 = blkcg_reset_stats,
 	},
+	{
+		/* pages dirtied, times and ms paused in balance_dirty_pages */
+		.name = "dirty_stat",
+		.seq_show = blkcg_print_dirty_stat,
+	},
 	{ }	/* terminate */
 };
 
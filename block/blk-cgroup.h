@@ -53,6 +53,12 @@ struct blkcg {
 	/* TODO: per-policy storage in blkcg */
 	unsigned int			cfq_weight;	/* belongs to cfq */
 	unsigned int			cfq_leaf_weight;
+	bool				cfq_foreground;
+
+	/* dirty throttling of the group's tasks, see blkcg_dirty_class() */
+	atomic_long_t			nr_dirtied;
+	atomic_long_t			nr_dirty_throttled;
+	atomic_long_t			dirty_paused;	/* jiffies */
 };
 
 struct blkg_stat {
@@ -34,6 +34,8 @@ static int cfq_slice_idle = HZ / 125;
 static int cfq_group_idle = HZ / 125;
 static const int cfq_target_latency = HZ * 3/10; /* 300 ms */
 static const int cfq_hist_divisor = 4;
+/* foreground read latency target, 0 disables write throttling */
+static const int cfq_fg_latency = HZ / 20; /* 50 ms */
 
 /*
  * offset from end of service tree
@@ -49,6 +51,24 @@ static const int cfq_hist_divisor = 4;
 #define CFQ_HW_QUEUE_MIN	(5)
 #define CFQ_SERVICE_SHIFT       12
 
+/*
+ * async IO is held to a single request in flight for this long after a
+ * foreground read missed its latency target
+ */
+#define CFQ_FG_THROTTLE		(HZ / 10)
+
+/*
+ * completion latency histogram, power of two buckets in ms
+ */
+#define CFQ_LAT_BUCKETS		12
+
+enum cfq_lat_class {
+	CFQ_LAT_FG_READ,
+	CFQ_LAT_SYNC,
+	CFQ_LAT_ASYNC,
+	CFQ_LAT_NR,
+};
+
 #define CFQQ_SEEK_THR		(sector_t)(8 * 100)
 #define CFQQ_CLOSE_THR		(sector_t)(8 * 1024)
 #define CFQQ_SECT_THR_NONROT	(sector_t)(2 * 32)
@@ -377,6 +397,13 @@ struct cfq_data {
 	unsigned int cfq_group_idle;
 	unsigned int cfq_latency;
 	unsigned int cfq_target_latency;
+	unsigned int cfq_fg_latency;
+
+	/*
+	 * foreground read latency tracking
+	 */
+	unsigned long fg_throttle_end;
+	unsigned long lat_hist[CFQ_LAT_NR][CFQ_LAT_BUCKETS];
 
 	/*
 	 * Fallback dummy cfqq for extreme OOM conditions
@@ -624,6 +651,11 @@ static inline void cfqg_put(struct cfq_group *cfqg)
 	return blkg_put(cfqg_to_blkg(cfqg));
 }
 
+static inline bool cfqg_is_foreground(struct cfq_group *cfqg)
+{
+	return cfqg_to_blkg(cfqg)->blkcg->cfq_foreground;
+}
+
 #define cfq_log_cfqq(cfqd, cfqq, fmt, args...)	do {			\
 	char __pbuf[128];						\
 									\
@@ -756,6 +788,7 @@ static void cfqg_stats_xfer_dead(struct cfq_group *cfqg)
 static inline struct cfq_group *cfqg_parent(struct cfq_group *cfqg) { return NULL; }
 static inline void cfqg_get(struct cfq_group *cfqg) { }
 static inline void cfqg_put(struct cfq_group *cfqg) { }
+static inline bool cfqg_is_foreground(struct cfq_group *cfqg) { return false; }
 
 #define cfq_log_cfqq(cfqd, cfqq, fmt, args...)	\
 	blk_add_trace_msg((cfqd)->queue, "cfq%d%c%c " fmt, (cfqq)->pid,	\
@@ -1772,6 +1805,26 @@ static int cfq_set_leaf_weight(struct cgroup_subsys_state *css,
 	return __cfq_set_weight(css, cft, val, true);
 }
 
+static u64 cfq_read_foreground(struct cgroup_subsys_state *css,
+			       struct cftype *cft)
+{
+	return css_to_blkcg(css)->cfq_foreground;
+}
+
+static int cfq_set_foreground(struct cgroup_subsys_state *css,
+			      struct cftype *cft, u64 val)
+{
+	struct blkcg *blkcg = css_to_blkcg(css);
+
+	if (val > 1)
+		return -EINVAL;
+
+	spin_lock_irq(&blkcg->lock);
+	blkcg->cfq_foreground = val;
+	spin_unlock_irq(&blkcg->lock);
+	return 0;
+}
+
 static int cfqg_print_stat(struct seq_file *sf, void *v)
 {
 	blkcg_print_blkgs(sf, css_to_blkcg(seq_css(sf)), blkg_prfill_stat,
@@ -1884,6 +1937,14 @@ static struct cftype cfq_blkcg_files[] = {
 		.write_u64 = cfq_set_leaf_weight,
 	},
 
+	/* sync reads of a foreground group are boosted over other groups */
+	{
+		.name = "foreground",
+		.flags = CFTYPE_NOT_ON_ROOT,
+		.read_u64 = cfq_read_foreground,
+		.write_u64 = cfq_set_foreground,
+	},
+
 	/* statistics, covers only the tasks in the cfqg */
 	{
 		.name = "time",
@@ -3213,6 +3274,15 @@ static bool cfq_may_dispatch(struct cfq_data *cfqd, struct cfq_queue *cfqq)
 	if (cfqd->rq_in_flight[BLK_RW_SYNC] && !cfq_cfqq_sync(cfqq))
 		return false;
 
+	/*
+	 * Foreground reads recently missed their latency target, keep
+	 * async writeback down to a single request in flight.
+	 */
+	if (!cfq_cfqq_sync(cfqq) && cfqd->fg_throttle_end &&
+	    time_before(jiffies, cfqd->fg_throttle_end) &&
+	    cfqd->rq_in_flight[BLK_RW_ASYNC])
+		return false;
+
 	max_dispatch = max_t(unsigned int, cfqd->cfq_quantum / 2, 1);
 	if (cfq_class_idle(cfqq))
 		max_dispatch = 1;
@@ -3812,6 +3882,15 @@ cfq_should_preempt(struct cfq_data *cfqd, struct cfq_queue *new_cfqq,
 	if (rq_is_sync(rq) && !cfq_cfqq_sync(cfqq))
 		return true;
 
+	/*
+	 * A sync read from the foreground group may cut into the slice
+	 * of any background group.
+	 */
+	if (rq_is_sync(rq) && rq_data_dir(rq) == READ &&
+	    cfqg_is_foreground(new_cfqq->cfqg) &&
+	    !cfqg_is_foreground(cfqq->cfqg))
+		return true;
+
 	if (new_cfqq->cfqg != cfqq->cfqg)
 		return false;
 
@@ -4029,6 +4108,31 @@ static bool cfq_should_wait_busy(struct cfq_data *cfqd, struct cfq_queue *cfqq)
 	return false;
 }
 
+static void cfq_update_latency(struct cfq_data *cfqd, struct cfq_queue *cfqq,
+			       struct request *rq, unsigned long now)
+{
+	unsigned long lat = now - rq->start_time;
+	unsigned int ms = jiffies_to_msecs(lat);
+	int class, bucket;
+
+	if (!cfq_cfqq_sync(cfqq))
+		class = CFQ_LAT_ASYNC;
+	else if (rq_data_dir(rq) == READ && cfqg_is_foreground(cfqq->cfqg))
+		class = CFQ_LAT_FG_READ;
+	else
+		class = CFQ_LAT_SYNC;
+
+	bucket = ms ? min_t(int, fls(ms), CFQ_LAT_BUCKETS - 1) : 0;
+	cfqd->lat_hist[class][bucket]++;
+
+	if (class == CFQ_LAT_FG_READ && cfqd->cfq_fg_latency &&
+	    lat > cfqd->cfq_fg_latency) {
+		if (!time_before(now, cfqd->fg_throttle_end))
+			cfq_log_cfqq(cfqd, cfqq, "fg read late %ums", ms);
+		cfqd->fg_throttle_end = now + CFQ_FG_THROTTLE;
+	}
+}
+
 static void cfq_completed_request(struct request_queue *q, struct request *rq)
 {
 	struct cfq_queue *cfqq = RQ_CFQQ(rq);
@@ -4051,6 +4155,7 @@ static void cfq_completed_request(struct request_queue *q, struct request *rq)
 				     rq_io_start_time_ns(rq), rq->cmd_flags);
 
 	cfqd->rq_in_flight[cfq_cfqq_sync(cfqq)]--;
+	cfq_update_latency(cfqd, cfqq, rq, now);
 
 	if (sync) {
 		struct cfq_rb_root *st;
@@ -4463,6 +4568,7 @@ static int cfq_init_queue(struct request_queue *q, struct elevator_type *e)
 	cfqd->cfq_slice_idle = cfq_slice_idle;
 	cfqd->cfq_group_idle = cfq_group_idle;
 	cfqd->cfq_latency = 1;
+	cfqd->cfq_fg_latency = cfq_fg_latency;
 	cfqd->hw_tag = -1;
 	/*
 	 * we optimistically start assuming sync ops weren't delayed in last
@@ -4516,6 +4622,7 @@ SHOW_FUNCTION(cfq_slice_async_show, cfqd->cfq_slice[0], 1);
 SHOW_FUNCTION(cfq_slice_async_rq_show, cfqd->cfq_slice_async_rq, 0);
 SHOW_FUNCTION(cfq_low_latency_show, cfqd->cfq_latency, 0);
 SHOW_FUNCTION(cfq_target_latency_show, cfqd->cfq_target_latency, 1);
+SHOW_FUNCTION(cfq_fg_latency_show, cfqd->cfq_fg_latency, 1);
 #undef SHOW_FUNCTION
 
 #define STORE_FUNCTION(__FUNC, __PTR, MIN, MAX, __CONV)			\
@@ -4550,8 +4657,33 @@ STORE_FUNCTION(cfq_slice_async_rq_store, &cfqd->cfq_slice_async_rq, 1,
 		UINT_MAX, 0);
 STORE_FUNCTION(cfq_low_latency_store, &cfqd->cfq_latency, 0, 1, 0);
 STORE_FUNCTION(cfq_target_latency_store, &cfqd->cfq_target_latency, 1, UINT_MAX, 1);
+STORE_FUNCTION(cfq_fg_latency_store, &cfqd->cfq_fg_latency, 0, UINT_MAX, 1);
 #undef STORE_FUNCTION
 
+/*
+ * One line per class, bucket n counts completions below 2^n ms and
+ * the last bucket everything above.
+ */
+static ssize_t cfq_latency_hist_show(struct elevator_queue *e, char *page)
+{
+	static const char * const names[CFQ_LAT_NR] = {
+		[CFQ_LAT_FG_READ]	= "fg_read",
+		[CFQ_LAT_SYNC]		= "sync",
+		[CFQ_LAT_ASYNC]		= "async",
+	};
+	struct cfq_data *cfqd = e->elevator_data;
+	ssize_t len = 0;
+	int i, j;
+
+	for (i = 0; i < CFQ_LAT_NR; i++) {
+		len += sprintf(page + len, "%-8s", names[i]);
+		for (j = 0; j < CFQ_LAT_BUCKETS; j++)
+			len += sprintf(page + len, " %lu", cfqd->lat_hist[i][j]);
+		len += sprintf(page + len, "\n");
+	}
+	return len;
+}
+
 #define CFQ_ATTR(name) \
 	__ATTR(name, S_IRUGO|S_IWUSR, cfq_##name##_show, cfq_##name##_store)
 
@@ -4568,6 +4700,8 @@ static struct elv_fs_entry cfq_attrs[] = {
 	CFQ_ATTR(group_idle),
 	CFQ_ATTR(low_latency),
 	CFQ_ATTR(target_latency),
+	CFQ_ATTR(fg_latency),
+	__ATTR(latency_hist, S_IRUGO, cfq_latency_hist_show, NULL),
 	__ATTR_NULL
 };
 
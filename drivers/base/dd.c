@@ -21,6 +21,7 @@
 #include <linux/delay.h>
 #include <linux/module.h>
 #include <linux/kthread.h>
+#include <linux/sched.h>
 #include <linux/wait.h>
 #include <linux/async.h>
 #include <linux/pm_runtime.h>
@@ -28,6 +29,7 @@
 
 #include "base.h"
 #include "power/power.h"
+#include "bootprof.h"
 
 /*
  * Deferred Probe infrastructure.
@@ -53,6 +55,8 @@ static LIST_HEAD(deferred_probe_pending_list);
 static LIST_HEAD(deferred_probe_active_list);
 static struct workqueue_struct *deferred_wq;
 static atomic_t deferred_trigger_count = ATOMIC_INIT(0);
+/* deferred_wq is single threaded, this is the one retrying probes */
+static struct task_struct *deferred_probe_task;
 
 /*
  * deferred_probe_work_func() - Retry probing devices in the active list.
@@ -73,6 +77,7 @@ static void deferred_probe_work_func(struct work_struct *work)
 	 * get/put_device() to ensure the device structure cannot disappear
 	 * from under our feet.
 	 */
+	deferred_probe_task = current;
 	mutex_lock(&deferred_probe_mutex);
 	while (!list_empty(&deferred_probe_active_list)) {
 		private = list_first_entry(&deferred_probe_active_list,
@@ -106,6 +111,7 @@ static void deferred_probe_work_func(struct work_struct *work)
 		put_device(dev);
 	}
 	mutex_unlock(&deferred_probe_mutex);
+	deferred_probe_task = NULL;
 }
 static DECLARE_WORK(deferred_probe_work, deferred_probe_work_func);
 
@@ -279,6 +285,7 @@ static int really_probe(struct device *dev, struct device_driver *drv)
 {
 	int ret = 0;
 	int local_trigger_count = atomic_read(&deferred_trigger_count);
+	u64 ts = sched_clock();
 
 	atomic_inc(&probe_count);
 	pr_debug("bus: '%s': %s: probing driver %s with device %s\n",
@@ -309,6 +316,8 @@ static int really_probe(struct device *dev, struct device_driver *drv)
 	}
 
 	driver_bound(dev);
+	log_boot_probe(dev, drv, current == deferred_probe_task,
+		       sched_clock() - ts, 0);
 	ret = 1;
 	pr_debug("bus: '%s': %s: bound device %s to driver %s\n",
 		 drv->bus->name, __func__, dev_name(dev), drv->name);
@@ -319,6 +328,8 @@ probe_failed:
 	driver_sysfs_remove(dev);
 	dev->driver = NULL;
 	dev_set_drvdata(dev, NULL);
+	log_boot_probe(dev, drv, current == deferred_probe_task,
+		       sched_clock() - ts, ret);
 
 	if (ret == -EPROBE_DEFER) {
 		/* Driver requested deferred probing */
@@ -33,9 +33,11 @@
 #include <linux/cpuidle.h>
 #include <linux/timer.h>
 #include <linux/wakeup_reason.h>
+#include <linux/slab.h>
 
 #include "../base.h"
 #include "power.h"
+#include "bootprof.h"
 
 #define HIB_DPM_DEBUG 0
 #define _TAG_HIB_M "HIB/DPM"
@@ -78,6 +80,23 @@ struct dpm_drv_wd_data {
 
 static int async_error;
 
+/*
+ * PM dependencies between devices that are not parent and child, e.g. a
+ * driver whose callbacks use another device's hardware.  The consumer is
+ * resumed after and suspended before its supplier, so that both can be
+ * handled asynchronously.
+ */
+struct dpm_link {
+	struct list_head node;
+	struct device *supplier;
+	struct device *consumer;
+};
+
+#define DPM_LINK_WAIT_MAX	4
+
+static LIST_HEAD(dpm_links);
+static DEFINE_MUTEX(dpm_links_mtx);
+
 static char *pm_verb(int event)
 {
 	switch (event) {
@@ -162,6 +181,7 @@ void device_pm_remove(struct device *dev)
 	mutex_lock(&dpm_list_mtx);
 	list_del_init(&dev->power.entry);
 	mutex_unlock(&dpm_list_mtx);
+	device_pm_remove_links(dev);
 	device_wakeup_disable(dev);
 	pm_runtime_remove(dev);
 }
@@ -205,6 +225,76 @@ void device_pm_move_last(struct device *dev)
 	list_move_tail(&dev->power.entry, &dpm_list);
 }
 
+static int dpm_reorder_fn(struct device *dev, void *data)
+{
+	device_pm_move_last(dev);
+	device_for_each_child(dev, NULL, dpm_reorder_fn);
+	return 0;
+}
+
+/**
+ * device_pm_add_link - Make the PM core order one device after another.
+ * @consumer: Device whose PM callbacks depend on @supplier.
+ * @supplier: Device @consumer depends on.
+ *
+ * @consumer and its children are moved to the end of dpm_list, so that the
+ * order is right for synchronous devices too.  The link goes away when
+ * either device is removed.
+ */
+int device_pm_add_link(struct device *consumer, struct device *supplier)
+{
+	struct dpm_link *link;
+	int error = 0;
+
+	if (!consumer || !supplier || consumer == supplier)
+		return -EINVAL;
+
+	mutex_lock(&dpm_list_mtx);
+	mutex_lock(&dpm_links_mtx);
+	list_for_each_entry(link, &dpm_links, node) {
+		if (link->consumer == consumer && link->supplier == supplier)
+			goto Unlock;
+	}
+
+	link = kzalloc(sizeof(*link), GFP_KERNEL);
+	if (!link) {
+		error = -ENOMEM;
+		goto Unlock;
+	}
+	link->consumer = consumer;
+	link->supplier = supplier;
+	list_add_tail(&link->node, &dpm_links);
+
+	pr_debug("PM: Linking %s:%s to %s:%s\n",
+		 consumer->bus ? consumer->bus->name : "No Bus", dev_name(consumer),
+		 supplier->bus ? supplier->bus->name : "No Bus", dev_name(supplier));
+	dpm_reorder_fn(consumer, NULL);
+ Unlock:
+	mutex_unlock(&dpm_links_mtx);
+	mutex_unlock(&dpm_list_mtx);
+	return error;
+}
+EXPORT_SYMBOL_GPL(device_pm_add_link);
+
+/**
+ * device_pm_remove_links - Drop the PM dependencies of a device.
+ * @dev: Device being removed.
+ */
+void device_pm_remove_links(struct device *dev)
+{
+	struct dpm_link *link, *tmp;
+
+	mutex_lock(&dpm_links_mtx);
+	list_for_each_entry_safe(link, tmp, &dpm_links, node) {
+		if (link->consumer == dev || link->supplier == dev) {
+			list_del(&link->node);
+			kfree(link);
+		}
+	}
+	mutex_unlock(&dpm_links_mtx);
+}
+EXPORT_SYMBOL_GPL(device_pm_remove_links);
+
 static ktime_t initcall_debug_start(struct device *dev)
 {
 	ktime_t calltime = ktime_set(0, 0);
@@ -259,6 +349,53 @@ static void dpm_wait_for_children(struct device *dev, bool async)
        device_for_each_child(dev, &async, dpm_wait_fn);
 }
 
+/*
+ * The other ends are collected first, so that no lock is held while waiting
+ * for a device whose own callback may need to look at the links.
+ */
+static void dpm_wait_for_links(struct device *dev, bool async, bool suppliers)
+{
+	struct device *devs[DPM_LINK_WAIT_MAX];
+	struct dpm_link *link;
+	int i, n = 0;
+
+	if (list_empty(&dpm_links))
+		return;
+
+	mutex_lock(&dpm_links_mtx);
+	list_for_each_entry(link, &dpm_links, node) {
+		struct device *other;
+
+		if (suppliers && link->consumer == dev)
+			other = link->supplier;
+		else if (!suppliers && link->supplier == dev)
+			other = link->consumer;
+		else
+			continue;
+
+		if (WARN_ONCE(n == DPM_LINK_WAIT_MAX, "PM: %s has too many links\n",
+			      dev_name(dev)))
+			break;
+		devs[n++] = get_device(other);
+	}
+	mutex_unlock(&dpm_links_mtx);
+
+	for (i = 0; i < n; i++) {
+		dpm_wait(devs[i], async);
+		put_device(devs[i]);
+	}
+}
+
+static void dpm_wait_for_suppliers(struct device *dev, bool async)
+{
+	dpm_wait_for_links(dev, async, true);
+}
+
+static void dpm_wait_for_consumers(struct device *dev, bool async)
+{
+	dpm_wait_for_links(dev, async, false);
+}
+
 /**
  * pm_op - Return the PM operation appropriate for given PM event.
  * @ops: PM operations to choose from.
@@ -393,13 +530,14 @@ static void dpm_show_time(ktime_t starttime, pm_message_t state, char *info)
 static int dpm_run_callback(pm_callback_t cb, struct device *dev,
 			    pm_message_t state, char *info)
 {
-	ktime_t calltime;
+	ktime_t calltime, starttime;
 	int error;
 
 	if (!cb)
 		return 0;
 
 	calltime = initcall_debug_start(dev);
+	starttime = ktime_get();
 
 	pm_dev_dbg(dev, state, info);
 	trace_device_pm_callback_start(dev, info, state.event);
@@ -408,6 +546,7 @@ static int dpm_run_callback(pm_callback_t cb, struct device *dev,
 	suspend_report_result(cb, error);
 
 	initcall_debug_report(dev, calltime, error, state, info);
+	log_resume_dev(dev, info, starttime);
 
 	return error;
 }
@@ -504,6 +643,7 @@ static int device_resume_noirq(struct device *dev, pm_message_t state, bool asyn
 		goto Out;
 
 	dpm_wait(dev->parent, async);
+	dpm_wait_for_suppliers(dev, async);
 
 	if (dev->pm_domain) {
 		info = "noirq power domain ";
@@ -564,6 +704,7 @@ void dpm_resume_noirq(pm_message_t state)
 	ktime_t starttime = ktime_get();
 
 	trace_suspend_resume(TPS("dpm_resume_noirq"), state.event, true);
+	log_resume_phase(RESUME_PHASE_NOIRQ);
 	mutex_lock(&dpm_list_mtx);
 	pm_transition = state;
 
@@ -633,6 +774,7 @@ static int device_resume_early(struct device *dev, pm_message_t state, bool asyn
 		goto Out;
 
 	dpm_wait(dev->parent, async);
+	dpm_wait_for_suppliers(dev, async);
 
 	if (dev->pm_domain) {
 		info = "early power domain ";
@@ -686,6 +828,7 @@ void dpm_resume_early(pm_message_t state)
 	ktime_t starttime = ktime_get();
 
 	trace_suspend_resume(TPS("dpm_resume_early"), state.event, true);
+	log_resume_phase(RESUME_PHASE_EARLY);
 	mutex_lock(&dpm_list_mtx);
 	pm_transition = state;
 
@@ -765,6 +908,7 @@ static int device_resume(struct device *dev, pm_message_t state, bool async)
 	}
 
 	dpm_wait(dev->parent, async);
+	dpm_wait_for_suppliers(dev, async);
 	dpm_watchdog_set(&wd, dev);
 	device_lock(dev);
 
@@ -882,6 +1026,7 @@ void dpm_resume(pm_message_t state)
 	ktime_t starttime = ktime_get();
 
 	trace_suspend_resume(TPS("dpm_resume"), state.event, true);
+	log_resume_phase(RESUME_PHASE_RESUME);
 	might_sleep();
 
 	mutex_lock(&dpm_list_mtx);
@@ -985,6 +1130,7 @@ void dpm_complete(pm_message_t state)
 	struct list_head list;
 
 	trace_suspend_resume(TPS("dpm_complete"), state.event, true);
+	log_resume_phase(RESUME_PHASE_COMPLETE);
 	might_sleep();
 
 	INIT_LIST_HEAD(&list);
@@ -1019,6 +1165,7 @@ void dpm_resume_end(pm_message_t state)
 {
 	dpm_resume(state);
 	dpm_complete(state);
+	log_resume_phase(RESUME_PHASE_DONE);
 }
 EXPORT_SYMBOL_GPL(dpm_resume_end);
 
@@ -1073,6 +1220,7 @@ static int __device_suspend_noirq(struct device *dev, pm_message_t state, bool a
 		goto Complete;
 
 	dpm_wait_for_children(dev, async);
+	dpm_wait_for_consumers(dev, async);
 
 	if (dev->pm_domain) {
 		info = "noirq power domain ";
@@ -1215,6 +1363,7 @@ static int __device_suspend_late(struct device *dev, pm_message_t state, bool as
 		goto Complete;
 
 	dpm_wait_for_children(dev, async);
+	dpm_wait_for_consumers(dev, async);
 
 	if (dev->pm_domain) {
 		info = "late power domain ";
@@ -1386,6 +1535,7 @@ static int __device_suspend(struct device *dev, pm_message_t state, bool async)
 	DECLARE_DPM_WATCHDOG_ON_STACK(wd);
 
 	dpm_wait_for_children(dev, async);
+	dpm_wait_for_consumers(dev, async);
 
 	if (async_error)
 		goto Complete;
@@ -13,6 +13,8 @@
 #include <linux/slab.h>
 #include <linux/wait.h>
 #include <linux/sched.h>
+#include <linux/cpu.h>
+#include <linux/percpu.h>
 
 #include "zcomp.h"
 #include "zcomp_lzo.h"
@@ -22,6 +24,9 @@
 #ifdef CONFIG_ZRAM_LZ4K_COMPRESS
 #include "zcomp_lz4k.h"
 #endif
+#ifdef CONFIG_ZRAM_CRYPTO_COMPRESS
+#include "zcomp_crypto.h"
+#endif
 
 /*
  * single zcomp_strm backend
@@ -46,6 +51,19 @@ struct zcomp_strm_multi {
 	wait_queue_head_t strm_wait;
 };
 
+/*
+ * per-cpu zcomp_strm backend: every cpu owns a stream, so writers running
+ * on different cpus never share a lock or a wait queue. A stream is only
+ * borrowed from another cpu if the local one is busy (the holder slept or
+ * got migrated); the hot path is an uncontended mutex_trylock.
+ */
+struct zcomp_strm_percpu {
+	struct zcomp *comp;
+	struct zcomp_strm * __percpu *strm;
+	struct mutex __percpu *strm_lock;
+	struct notifier_block notifier;
+};
+
 static struct zcomp_backend *backends[] = {
 	&zcomp_lzo,
 #ifdef CONFIG_ZRAM_LZ4_COMPRESS
@@ -53,6 +71,9 @@ static struct zcomp_backend *backends[] = {
 #endif
 #ifdef CONFIG_ZRAM_LZ4K_COMPRESS
 	&zcomp_lz4k,
+#endif
+#ifdef CONFIG_ZRAM_CRYPTO_COMPRESS
+	&zcomp_crypto,
 #endif
 	NULL
 };
@@ -72,7 +93,10 @@ static void zcomp_strm_free(struct zcomp *comp, struct zcomp_strm *zstrm)
 {
 	if (zstrm->private)
 		comp->backend->destroy(zstrm->private);
+	if (zstrm->recomp_private)
+		comp->recomp_backend->destroy(zstrm->recomp_private);
 	free_pages((unsigned long)zstrm->buffer, 1);
+	free_pages((unsigned long)zstrm->recomp_buffer, 1);
 	kfree(zstrm);
 }
 
@@ -82,7 +106,7 @@ static void zcomp_strm_free(struct zcomp *comp, struct zcomp_strm *zstrm)
  */
 static struct zcomp_strm *zcomp_strm_alloc(struct zcomp *comp)
 {
-	struct zcomp_strm *zstrm = kmalloc(sizeof(*zstrm), GFP_KERNEL);
+	struct zcomp_strm *zstrm = kzalloc(sizeof(*zstrm), GFP_KERNEL);
 	if (!zstrm)
 		return NULL;
 
@@ -93,6 +117,18 @@ static struct zcomp_strm *zcomp_strm_alloc(struct zcomp *comp)
 	 */
 	zstrm->buffer = (void *)__get_free_pages(GFP_KERNEL | __GFP_ZERO, 1);
 	if (!zstrm->private || !zstrm->buffer) {
+		zcomp_strm_free(comp, zstrm);
+		return NULL;
+	}
+
+	if (!comp->recomp_backend)
+		return zstrm;
+
+	/* the recompression result must not overwrite the first one */
+	zstrm->recomp_private = comp->recomp_backend->create();
+	zstrm->recomp_buffer = (void *)__get_free_pages(GFP_KERNEL |
+							__GFP_ZERO, 1);
+	if (!zstrm->recomp_private || !zstrm->recomp_buffer) {
 		zcomp_strm_free(comp, zstrm);
 		zstrm = NULL;
 	}
@@ -164,6 +200,10 @@ static bool zcomp_strm_multi_set_max_streams(struct zcomp *comp, int num_strm)
 	struct zcomp_strm_multi *zs = comp->stream;
 	struct zcomp_strm *zstrm;
 
+	/* switching to per-cpu streams needs a device reset */
+	if (num_strm < 1)
+		return false;
+
 	spin_lock(&zs->strm_lock);
 	zs->max_strm = num_strm;
 	/*
@@ -224,6 +264,186 @@ static int zcomp_strm_multi_create(struct zcomp *comp, int max_strm)
 	return 0;
 }
 
+static struct zcomp_strm *zcomp_strm_percpu_trylock(struct zcomp_strm_percpu *zs,
+						    int cpu)
+{
+	struct zcomp_strm *zstrm;
+
+	if (!mutex_trylock(per_cpu_ptr(zs->strm_lock, cpu)))
+		return NULL;
+
+	zstrm = *per_cpu_ptr(zs->strm, cpu);
+	if (!zstrm) {
+		mutex_unlock(per_cpu_ptr(zs->strm_lock, cpu));
+		return NULL;
+	}
+	/* remember the owner for zcomp_strm_percpu_release() */
+	zstrm->cpu = cpu;
+	return zstrm;
+}
+
+static struct zcomp_strm *zcomp_strm_percpu_find(struct zcomp *comp)
+{
+	struct zcomp_strm_percpu *zs = comp->stream;
+	struct zcomp_strm *zstrm;
+	int this_cpu = raw_smp_processor_id();
+	int cpu;
+
+	zstrm = zcomp_strm_percpu_trylock(zs, this_cpu);
+	if (likely(zstrm))
+		return zstrm;
+
+	for_each_online_cpu(cpu) {
+		if (cpu == this_cpu)
+			continue;
+		zstrm = zcomp_strm_percpu_trylock(zs, cpu);
+		if (zstrm)
+			return zstrm;
+	}
+
+	/* everybody is busy, queue up behind the local stream */
+	for (;;) {
+		cpu = raw_smp_processor_id();
+		mutex_lock(per_cpu_ptr(zs->strm_lock, cpu));
+		zstrm = *per_cpu_ptr(zs->strm, cpu);
+		if (zstrm) {
+			zstrm->cpu = cpu;
+			return zstrm;
+		}
+		/* cpu went away while we slept */
+		mutex_unlock(per_cpu_ptr(zs->strm_lock, cpu));
+		cond_resched();
+	}
+}
+
+static void zcomp_strm_percpu_release(struct zcomp *comp,
+		struct zcomp_strm *zstrm)
+{
+	struct zcomp_strm_percpu *zs = comp->stream;
+
+	mutex_unlock(per_cpu_ptr(zs->strm_lock, zstrm->cpu));
+}
+
+static bool zcomp_strm_percpu_set_max_streams(struct zcomp *comp, int num_strm)
+{
+	/* the number of streams follows the number of cpus */
+	return num_strm == 0;
+}
+
+static int zcomp_strm_percpu_add(struct zcomp_strm_percpu *zs, int cpu)
+{
+	struct zcomp_strm *zstrm;
+
+	if (*per_cpu_ptr(zs->strm, cpu))
+		return 0;
+
+	zstrm = zcomp_strm_alloc(zs->comp);
+	if (!zstrm)
+		return -ENOMEM;
+
+	mutex_lock(per_cpu_ptr(zs->strm_lock, cpu));
+	*per_cpu_ptr(zs->strm, cpu) = zstrm;
+	mutex_unlock(per_cpu_ptr(zs->strm_lock, cpu));
+	return 0;
+}
+
+static void zcomp_strm_percpu_remove(struct zcomp_strm_percpu *zs, int cpu)
+{
+	struct zcomp_strm *zstrm;
+
+	/* waits for a task that borrowed the stream from this cpu */
+	mutex_lock(per_cpu_ptr(zs->strm_lock, cpu));
+	zstrm = *per_cpu_ptr(zs->strm, cpu);
+	*per_cpu_ptr(zs->strm, cpu) = NULL;
+	mutex_unlock(per_cpu_ptr(zs->strm_lock, cpu));
+
+	if (zstrm)
+		zcomp_strm_free(zs->comp, zstrm);
+}
+
+static int zcomp_strm_percpu_notify(struct notifier_block *nb,
+		unsigned long action, void *hcpu)
+{
+	struct zcomp_strm_percpu *zs = container_of(nb,
+			struct zcomp_strm_percpu, notifier);
+	int cpu = (long)hcpu;
+
+	switch (action & ~CPU_TASKS_FROZEN) {
+	case CPU_UP_PREPARE:
+		if (zcomp_strm_percpu_add(zs, cpu))
+			return notifier_from_errno(-ENOMEM);
+		break;
+	case CPU_DEAD:
+	case CPU_UP_CANCELED:
+		zcomp_strm_percpu_remove(zs, cpu);
+		break;
+	default:
+		break;
+	}
+	return NOTIFY_OK;
+}
+
+static void zcomp_strm_percpu_destroy(struct zcomp *comp)
+{
+	struct zcomp_strm_percpu *zs = comp->stream;
+	int cpu;
+
+	cpu_notifier_register_begin();
+	__unregister_cpu_notifier(&zs->notifier);
+	for_each_possible_cpu(cpu)
+		zcomp_strm_percpu_remove(zs, cpu);
+	cpu_notifier_register_done();
+
+	free_percpu(zs->strm_lock);
+	free_percpu(zs->strm);
+	kfree(zs);
+}
+
+static int zcomp_strm_percpu_create(struct zcomp *comp)
+{
+	struct zcomp_strm_percpu *zs;
+	int cpu;
+
+	comp->destroy = zcomp_strm_percpu_destroy;
+	comp->strm_find = zcomp_strm_percpu_find;
+	comp->strm_release = zcomp_strm_percpu_release;
+	comp->set_max_streams = zcomp_strm_percpu_set_max_streams;
+	zs = kzalloc(sizeof(struct zcomp_strm_percpu), GFP_KERNEL);
+	if (!zs)
+		return -ENOMEM;
+
+	zs->comp = comp;
+	zs->strm = alloc_percpu(struct zcomp_strm *);
+	zs->strm_lock = alloc_percpu(struct mutex);
+	if (!zs->strm || !zs->strm_lock)
+		goto err_free;
+
+	for_each_possible_cpu(cpu)
+		mutex_init(per_cpu_ptr(zs->strm_lock, cpu));
+
+	zs->notifier.notifier_call = zcomp_strm_percpu_notify;
+	cpu_notifier_register_begin();
+	for_each_online_cpu(cpu) {
+		if (zcomp_strm_percpu_add(zs, cpu))
+			goto err_remove;
+	}
+	__register_cpu_notifier(&zs->notifier);
+	cpu_notifier_register_done();
+
+	comp->stream = zs;
+	return 0;
+
+err_remove:
+	for_each_possible_cpu(cpu)
+		zcomp_strm_percpu_remove(zs, cpu);
+	cpu_notifier_register_done();
+err_free:
+	free_percpu(zs->strm_lock);
+	free_percpu(zs->strm);
+	kfree(zs);
+	return -ENOMEM;
+}
+
 static struct zcomp_strm *zcomp_strm_single_find(struct zcomp *comp)
 {
 	struct zcomp_strm_single *zs = comp->stream;
@@ -320,6 +540,14 @@ int zcomp_compress(struct zcomp *comp, struct zcomp_strm *zstrm,
 	return comp->backend->compress(src, zstrm->buffer, dst_len,
 			zstrm->private);
 }
+
+/* compress @src with the recompression backend into ->recomp_buffer */
+int zcomp_recompress(struct zcomp *comp, struct zcomp_strm *zstrm,
+		const unsigned char *src, size_t *dst_len)
+{
+	return comp->recomp_backend->compress(src, zstrm->recomp_buffer,
+			dst_len, zstrm->recomp_private);
+}
 #endif
 int zcomp_decompress(struct zcomp *comp, const unsigned char *src,
 		size_t src_len, unsigned char *dst)
@@ -327,6 +555,12 @@ int zcomp_decompress(struct zcomp *comp, const unsigned char *src,
 	return comp->backend->decompress(src, src_len, dst);
 }
 
+int zcomp_recomp_decompress(struct zcomp *comp, const unsigned char *src,
+		size_t src_len, unsigned char *dst)
+{
+	return comp->recomp_backend->decompress(src, src_len, dst);
+}
+
 void zcomp_destroy(struct zcomp *comp)
 {
 	comp->destroy(comp);
@@ -339,22 +573,34 @@ void zcomp_destroy(struct zcomp *comp)
  * backend pointer or ERR_PTR if things went bad. ERR_PTR(-EINVAL)
  * if requested algorithm is not supported, ERR_PTR(-ENOMEM) in
  * case of allocation error.
+ * @recompress is the optional algorithm for pages that the first one
+ * compresses poorly, NULL for none.
  */
-struct zcomp *zcomp_create(const char *compress, int max_strm)
+struct zcomp *zcomp_create(const char *compress, const char *recompress,
+		int max_strm)
 {
 	struct zcomp *comp;
-	struct zcomp_backend *backend;
+	struct zcomp_backend *backend, *recomp_backend = NULL;
 
 	backend = find_backend(compress);
 	if (!backend)
 		return ERR_PTR(-EINVAL);
 
+	if (recompress) {
+		recomp_backend = find_backend(recompress);
+		if (!recomp_backend || recomp_backend == backend)
+			return ERR_PTR(-EINVAL);
+	}
+
 	comp = kzalloc(sizeof(struct zcomp), GFP_KERNEL);
 	if (!comp)
 		return ERR_PTR(-ENOMEM);
 
 	comp->backend = backend;
-	if (max_strm > 1)
+	comp->recomp_backend = recomp_backend;
+	if (max_strm == ZCOMP_STRM_PERCPU)
+		zcomp_strm_percpu_create(comp);
+	else if (max_strm > 1)
 		zcomp_strm_multi_create(comp, max_strm);
 	else
 		zcomp_strm_single_create(comp);
@@ -23,8 +23,16 @@ struct zcomp_strm {
 	void *private;
 	/* used in multi stream backend, protected by backend strm_lock */
 	struct list_head list;
+	/* used in per-cpu stream backend, cpu whose stream this is */
+	int cpu;
+	/* recompression buffer and private data, if comp->recomp_backend */
+	void *recomp_buffer;
+	void *recomp_private;
 };
 
+/* max_strm value selecting one stream per cpu */
+#define ZCOMP_STRM_PERCPU	0
+
 /* static compression backend */
 #ifdef CONFIG_ZSM
 struct zcomp_backend {
@@ -57,6 +65,8 @@ struct zcomp_backend {
 struct zcomp {
 	void *stream;
 	struct zcomp_backend *backend;
+	/* optional higher-ratio backend for poorly compressed pages */
+	struct zcomp_backend *recomp_backend;
 
 	struct zcomp_strm *(*strm_find)(struct zcomp *comp);
 	void (*strm_release)(struct zcomp *comp, struct zcomp_strm *zstrm);
@@ -66,7 +76,8 @@ struct zcomp {
 
 ssize_t zcomp_available_show(const char *comp, char *buf);
 
-struct zcomp *zcomp_create(const char *comp, int max_strm);
+struct zcomp *zcomp_create(const char *comp, const char *recomp,
+		int max_strm);
 void zcomp_destroy(struct zcomp *comp);
 
 struct zcomp_strm *zcomp_strm_find(struct zcomp *comp);
@@ -77,9 +88,13 @@ int zcomp_compress_zram(struct zcomp *comp, struct zcomp_strm *zstrm,
 #else
 int zcomp_compress(struct zcomp *comp, struct zcomp_strm *zstrm,
 		const unsigned char *src, size_t *dst_len);
+int zcomp_recompress(struct zcomp *comp, struct zcomp_strm *zstrm,
+		const unsigned char *src, size_t *dst_len);
 #endif
 int zcomp_decompress(struct zcomp *comp, const unsigned char *src,
 		size_t src_len, unsigned char *dst);
+int zcomp_recomp_decompress(struct zcomp *comp, const unsigned char *src,
+		size_t src_len, unsigned char *dst);
 
 bool zcomp_set_max_streams(struct zcomp *comp, int num_strm);
 #endif /* _ZCOMP_H_ */
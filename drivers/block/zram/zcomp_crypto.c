@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2014 Sergey Senozhatsky.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version
+ * 2 of the License, or (at your option) any later version.
+ */
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/mutex.h>
+#include <linux/percpu.h>
+#include <linux/crypto.h>
+#include <linux/err.h>
+
+#include "zcomp_crypto.h"
+
+/*
+ * The "crypto" backend compresses with any compression algorithm
+ * registered with the crypto API, including ones implemented by an
+ * offload engine. The algorithm is chosen once, at module load time.
+ */
+static char crypto_comp_alg[CRYPTO_MAX_ALG_NAME] = "lz4k";
+module_param_string(crypto_comp_alg, crypto_comp_alg,
+		    sizeof(crypto_comp_alg), 0444);
+MODULE_PARM_DESC(crypto_comp_alg,
+		 "Crypto API compression algorithm used by the crypto backend");
+
+/*
+ * Decompression gets no stream, so every cpu owns a tfm for it. They are
+ * shared by all streams of all devices and live as long as any stream.
+ */
+static DEFINE_MUTEX(zcomp_crypto_lock);
+static int zcomp_crypto_users;
+static struct crypto_comp * __percpu *zcomp_crypto_dtfm;
+
+static void zcomp_crypto_free_dtfms(void)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct crypto_comp *tfm = *per_cpu_ptr(zcomp_crypto_dtfm, cpu);
+
+		if (!IS_ERR_OR_NULL(tfm))
+			crypto_free_comp(tfm);
+	}
+	free_percpu(zcomp_crypto_dtfm);
+	zcomp_crypto_dtfm = NULL;
+}
+
+static int zcomp_crypto_get_dtfms(void)
+{
+	int cpu, ret = 0;
+
+	mutex_lock(&zcomp_crypto_lock);
+	if (zcomp_crypto_users++)
+		goto out;
+
+	zcomp_crypto_dtfm = alloc_percpu(struct crypto_comp *);
+	if (!zcomp_crypto_dtfm) {
+		ret = -ENOMEM;
+		goto fail;
+	}
+	for_each_possible_cpu(cpu) {
+		struct crypto_comp *tfm = crypto_alloc_comp(crypto_comp_alg,
+							    0, 0);
+
+		*per_cpu_ptr(zcomp_crypto_dtfm, cpu) = tfm;
+		if (IS_ERR(tfm)) {
+			ret = PTR_ERR(tfm);
+			zcomp_crypto_free_dtfms();
+			goto fail;
+		}
+	}
+	goto out;
+fail:
+	zcomp_crypto_users--;
+out:
+	mutex_unlock(&zcomp_crypto_lock);
+	return ret;
+}
+
+static void zcomp_crypto_put_dtfms(void)
+{
+	mutex_lock(&zcomp_crypto_lock);
+	if (!--zcomp_crypto_users)
+		zcomp_crypto_free_dtfms();
+	mutex_unlock(&zcomp_crypto_lock);
+}
+
+static void *zcomp_crypto_create(void)
+{
+	struct crypto_comp *tfm;
+
+	if (zcomp_crypto_get_dtfms()) {
+		pr_err("zram: cannot allocate crypto compressor %s\n",
+		       crypto_comp_alg);
+		return NULL;
+	}
+
+	tfm = crypto_alloc_comp(crypto_comp_alg, 0, 0);
+	if (IS_ERR(tfm)) {
+		zcomp_crypto_put_dtfms();
+		return NULL;
+	}
+	return tfm;
+}
+
+static void zcomp_crypto_destroy(void *private)
+{
+	crypto_free_comp(private);
+	zcomp_crypto_put_dtfms();
+}
+
+static int zcomp_crypto_compress(const unsigned char *src, unsigned char *dst,
+		size_t *dst_len, void *private)
+{
+	/* the stream buffer is two pages, like lzo's worst case */
+	unsigned int len = 2 * PAGE_SIZE;
+	int ret;
+
+	ret = crypto_comp_compress(private, src, PAGE_SIZE, dst, &len);
+	*dst_len = len;
+	/* return  : Success if return 0 */
+	return ret;
+}
+
+static int zcomp_crypto_decompress(const unsigned char *src, size_t src_len,
+		unsigned char *dst)
+{
+	struct crypto_comp **tfm;
+	unsigned int dst_len = PAGE_SIZE;
+	int ret;
+
+	tfm = get_cpu_ptr(zcomp_crypto_dtfm);
+	ret = crypto_comp_decompress(*tfm, src, src_len, dst, &dst_len);
+	put_cpu_ptr(zcomp_crypto_dtfm);
+	/* return  : Success if return 0 */
+	return ret;
+}
+
+struct zcomp_backend zcomp_crypto = {
+	.compress = zcomp_crypto_compress,
+	.decompress = zcomp_crypto_decompress,
+	.create = zcomp_crypto_create,
+	.destroy = zcomp_crypto_destroy,
+	.name = "crypto",
+};
@@ -35,6 +35,7 @@
 #include <linux/err.h>
 #include <linux/proc_fs.h>
 #include <linux/seq_file.h>
+#include <linux/sched.h>
 
 #ifdef CONFIG_ZSM
 #include <linux/rbtree.h>
@@ -502,6 +503,39 @@ static ssize_t mem_used_max_store(struct device *dev,
 	return len;
 }
 
+static ssize_t compact_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+	struct zram_meta *meta;
+
+	down_read(&zram->init_lock);
+	if (!init_done(zram)) {
+		up_read(&zram->init_lock);
+		return -EINVAL;
+	}
+
+	meta = zram->meta;
+	zs_compact(meta->mem_pool);
+	up_read(&zram->init_lock);
+
+	return len;
+}
+
+static ssize_t pages_compacted_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct zram *zram = dev_to_zram(dev);
+	struct zs_pool_stats pool_stats = { 0 };
+
+	down_read(&zram->init_lock);
+	if (init_done(zram))
+		zs_pool_stats(zram->meta->mem_pool, &pool_stats);
+	up_read(&zram->init_lock);
+
+	return scnprintf(buf, PAGE_SIZE, "%lu\n", pool_stats.pages_compacted);
+}
+
 static ssize_t max_comp_streams_store(struct device *dev,
 		struct device_attribute *attr, const char *buf, size_t len)
 {
@@ -512,7 +546,7 @@ static ssize_t max_comp_streams_store(struct device *dev,
 	ret = kstrtoint(buf, 0, &num);
 	if (ret < 0)
 		return ret;
-	if (num < 1)
+	if (num < 0)
 		return -EINVAL;
 
 	down_write(&zram->init_lock);
@@ -597,6 +631,600 @@ static inline int is_partial_io(struct bio_vec *bvec)
 	return bvec->bv_len != PAGE_SIZE;
 }
 
+#ifdef CONFIG_ZRAM_WRITEBACK
+/* max pages written to the backing device with a single bio */
+#define ZRAM_WB_BATCH	32
+
+/* caller should hold this table index entry's bit_spinlock */
+static void zram_accessed(struct zram *zram, u32 index)
+{
+	zram_clear_flag(zram->meta, index, ZRAM_IDLE);
+	zram->meta->table[index].ac_time = jiffies;
+}
+
+static void reset_bdev(struct zram *zram)
+{
+	if (!zram->bdev)
+		return;
+
+	blkdev_put(zram->bdev, FMODE_READ | FMODE_WRITE | FMODE_EXCL);
+	zram->bdev = NULL;
+	vfree(zram->bitmap);
+	zram->bitmap = NULL;
+	zram->nr_pages = 0;
+	kfree(zram->backing_dev_name);
+	zram->backing_dev_name = NULL;
+}
+
+static ssize_t backing_dev_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct zram *zram = dev_to_zram(dev);
+	ssize_t ret;
+
+	down_read(&zram->init_lock);
+	ret = scnprintf(buf, PAGE_SIZE, "%s\n",
+			zram->backing_dev_name ? : "none");
+	up_read(&zram->init_lock);
+
+	return ret;
+}
+
+static ssize_t backing_dev_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+	struct block_device *bdev;
+	unsigned long nr_pages, *bitmap = NULL;
+	char *file_name;
+	size_t sz;
+	int err;
+
+	file_name = kstrndup(buf, len, GFP_KERNEL);
+	if (!file_name)
+		return -ENOMEM;
+
+	/* ignore trailing newline */
+	sz = strlen(file_name);
+	if (sz > 0 && file_name[sz - 1] == '\n')
+		file_name[sz - 1] = 0x00;
+
+	down_write(&zram->init_lock);
+	if (init_done(zram)) {
+		pr_info("Can't setup backing device for initialized device\n");
+		err = -EBUSY;
+		goto out;
+	}
+
+	bdev = blkdev_get_by_path(file_name,
+			FMODE_READ | FMODE_WRITE | FMODE_EXCL, zram);
+	if (IS_ERR(bdev)) {
+		err = PTR_ERR(bdev);
+		goto out;
+	}
+
+	nr_pages = i_size_read(bdev->bd_inode) >> PAGE_SHIFT;
+	if (nr_pages)
+		bitmap = vzalloc(BITS_TO_LONGS(nr_pages) * sizeof(long));
+	if (!bitmap) {
+		err = -ENOMEM;
+		goto out_put;
+	}
+
+	reset_bdev(zram);
+	zram->bdev = bdev;
+	zram->bitmap = bitmap;
+	zram->nr_pages = nr_pages;
+	zram->backing_dev_name = file_name;
+	up_write(&zram->init_lock);
+
+	pr_info("setup backing device %s, %lu pages\n", file_name, nr_pages);
+	return len;
+
+out_put:
+	blkdev_put(bdev, FMODE_READ | FMODE_WRITE | FMODE_EXCL);
+out:
+	up_write(&zram->init_lock);
+	kfree(file_name);
+	return err;
+}
+
+/* allocate @nr contiguous blocks so that a batch goes out sequentially */
+static bool alloc_block_bdev(struct zram *zram, unsigned long *blk,
+			     unsigned int nr)
+{
+	unsigned long start;
+	bool found = false;
+
+	spin_lock(&zram->bitmap_lock);
+	start = bitmap_find_next_zero_area(zram->bitmap, zram->nr_pages,
+					   0, nr, 0);
+	if (start + nr <= zram->nr_pages) {
+		bitmap_set(zram->bitmap, start, nr);
+		found = true;
+	}
+	spin_unlock(&zram->bitmap_lock);
+
+	if (found) {
+		*blk = start;
+		atomic64_add(nr, &zram->stats.bd_count);
+	}
+	return found;
+}
+
+static void free_block_bdev(struct zram *zram, unsigned long blk)
+{
+	spin_lock(&zram->bitmap_lock);
+	WARN_ON_ONCE(!test_and_clear_bit(blk, zram->bitmap));
+	spin_unlock(&zram->bitmap_lock);
+	atomic64_dec(&zram->stats.bd_count);
+}
+
+static int read_from_bdev(struct zram *zram, struct page *page,
+			  unsigned long blk)
+{
+	struct bio *bio;
+	int ret;
+
+	bio = bio_alloc(GFP_NOIO, 1);
+	if (!bio)
+		return -ENOMEM;
+
+	bio->bi_iter.bi_sector = blk << SECTORS_PER_PAGE_SHIFT;
+	bio->bi_bdev = zram->bdev;
+	if (!bio_add_page(bio, page, PAGE_SIZE, 0)) {
+		bio_put(bio);
+		return -EIO;
+	}
+
+	ret = submit_bio_wait(READ_SYNC, bio);
+	bio_put(bio);
+	atomic64_inc(&zram->stats.bd_reads);
+
+	return ret;
+}
+
+/*
+ * Read a written back page into @mem, or into @bvec at @offset when @mem
+ * is NULL. Sleeps, so it must not be called with the page kmapped.
+ */
+static int zram_read_bdev(struct zram *zram, unsigned long blk, char *mem,
+			  struct bio_vec *bvec, int offset)
+{
+	struct page *page;
+	char *src, *dst;
+	int ret;
+
+	if (!mem && !is_partial_io(bvec)) {
+		ret = read_from_bdev(zram, bvec->bv_page, blk);
+		if (!ret)
+			flush_dcache_page(bvec->bv_page);
+		return ret;
+	}
+
+	page = alloc_page(GFP_NOIO);
+	if (!page)
+		return -ENOMEM;
+
+	ret = read_from_bdev(zram, page, blk);
+	if (ret)
+		goto out;
+
+	src = kmap_atomic(page);
+	if (mem) {
+		copy_page(mem, src);
+	} else {
+		dst = kmap_atomic(bvec->bv_page);
+		memcpy(dst + bvec->bv_offset, src + offset, bvec->bv_len);
+		kunmap_atomic(dst);
+		flush_dcache_page(bvec->bv_page);
+	}
+	kunmap_atomic(src);
+out:
+	__free_page(page);
+	return ret;
+}
+
+static ssize_t idle_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+	struct zram_meta *meta;
+	unsigned long nr_pages, index, cutoff;
+	unsigned int secs = 0;
+	bool all = sysfs_streq(buf, "all");
+
+	/* "all" or an age in seconds */
+	if (!all && (kstrtouint(buf, 10, &secs) || !secs))
+		return -EINVAL;
+	cutoff = jiffies - (unsigned long)secs * HZ;
+
+	down_read(&zram->init_lock);
+	if (!init_done(zram)) {
+		up_read(&zram->init_lock);
+		return -EINVAL;
+	}
+
+	meta = zram->meta;
+	nr_pages = zram->disksize >> PAGE_SHIFT;
+	for (index = 0; index < nr_pages; index++) {
+		struct zram_table_entry *entry = &meta->table[index];
+
+		bit_spin_lock(ZRAM_ACCESS, &entry->value);
+		if (entry->handle && !zram_test_flag(meta, index, ZRAM_WB) &&
+		    (all || time_before(entry->ac_time, cutoff)))
+			zram_set_flag(meta, index, ZRAM_IDLE);
+		bit_spin_unlock(ZRAM_ACCESS, &entry->value);
+
+		if (!(index % 1024))
+			cond_resched();
+	}
+	up_read(&zram->init_lock);
+
+	return len;
+}
+
+/* pick @index for writeback, marking it ZRAM_UNDER_WB */
+static bool zram_wb_select(struct zram *zram, u32 index, bool huge)
+{
+	struct zram_meta *meta = zram->meta;
+	bool selected = false;
+
+	bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
+	if (!meta->table[index].handle ||
+	    zram_test_flag(meta, index, ZRAM_WB) ||
+	    zram_test_flag(meta, index, ZRAM_ZERO))
+		goto out;
+
+	if (huge ? zram_get_obj_size(meta, index) == PAGE_SIZE :
+		   zram_test_flag(meta, index, ZRAM_IDLE)) {
+		zram_set_flag(meta, index, ZRAM_UNDER_WB);
+		selected = true;
+	}
+out:
+	bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+	return selected;
+}
+
+static void zram_wb_abort(struct zram *zram, u32 index)
+{
+	struct zram_meta *meta = zram->meta;
+
+	bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
+	zram_clear_flag(meta, index, ZRAM_UNDER_WB);
+	bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+}
+
+/*
+ * The page was written out to @blk. Drop its compressed copy, unless it
+ * was rewritten, freed or (for idle writeback) accessed in the meantime.
+ */
+static void zram_wb_commit(struct zram *zram, u32 index, unsigned long blk,
+			   bool huge)
+{
+	struct zram_meta *meta = zram->meta;
+
+	bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
+	if (!zram_test_flag(meta, index, ZRAM_UNDER_WB) ||
+	    (!huge && !zram_test_flag(meta, index, ZRAM_IDLE))) {
+		zram_clear_flag(meta, index, ZRAM_UNDER_WB);
+		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+		free_block_bdev(zram, blk);
+		return;
+	}
+
+	zs_free(meta->mem_pool, meta->table[index].handle);
+	atomic64_sub(zram_get_obj_size(meta, index),
+		     &zram->stats.compr_data_size);
+	zram_clear_flag(meta, index, ZRAM_UNDER_WB);
+	zram_clear_flag(meta, index, ZRAM_IDLE);
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+	/* the backing device holds the page uncompressed */
+	if (zram_test_flag(meta, index, ZRAM_RECOMP)) {
+		zram_clear_flag(meta, index, ZRAM_RECOMP);
+		atomic64_dec(&zram->stats.recomp_pages);
+	}
+#endif
+	zram_set_flag(meta, index, ZRAM_WB);
+	meta->table[index].handle = blk;
+	zram_set_obj_size(meta, index, 0);
+	bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+}
+
+static int zram_decompress_page(struct zram *zram, char *mem, u32 index);
+
+static ssize_t writeback_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+	struct page *pages[ZRAM_WB_BATCH];
+	u32 slots[ZRAM_WB_BATCH];
+	unsigned long nr_slots, index, blk;
+	unsigned int nr, i;
+	struct bio *bio;
+	bool huge;
+	ssize_t ret = 0;
+
+	if (sysfs_streq(buf, "idle"))
+		huge = false;
+	else if (sysfs_streq(buf, "huge"))
+		huge = true;
+	else
+		return -EINVAL;
+
+	memset(pages, 0, sizeof(pages));
+	for (i = 0; i < ZRAM_WB_BATCH; i++) {
+		pages[i] = alloc_page(GFP_KERNEL);
+		if (!pages[i]) {
+			ret = -ENOMEM;
+			goto out_free;
+		}
+	}
+
+	down_read(&zram->init_lock);
+	if (!init_done(zram) || !zram->bdev) {
+		ret = -EINVAL;
+		goto out_unlock;
+	}
+
+	mutex_lock(&zram->wb_lock);
+	nr_slots = zram->disksize >> PAGE_SHIFT;
+	index = 0;
+	while (index < nr_slots) {
+		nr = 0;
+		for (; index < nr_slots && nr < ZRAM_WB_BATCH; index++) {
+			if (!zram_wb_select(zram, index, huge))
+				continue;
+			if (zram_decompress_page(zram,
+					page_address(pages[nr]), index)) {
+				zram_wb_abort(zram, index);
+				continue;
+			}
+			slots[nr++] = index;
+		}
+		if (!nr)
+			break;
+
+		if (!alloc_block_bdev(zram, &blk, nr)) {
+			ret = -ENOSPC;
+			goto out_abort;
+		}
+
+		bio = bio_alloc(GFP_KERNEL, nr);
+		if (!bio) {
+			ret = -ENOMEM;
+			goto out_free_blocks;
+		}
+		bio->bi_iter.bi_sector = blk << SECTORS_PER_PAGE_SHIFT;
+		bio->bi_bdev = zram->bdev;
+		for (i = 0; i < nr; i++) {
+			if (!bio_add_page(bio, pages[i], PAGE_SIZE, 0))
+				break;
+		}
+		/* pages the queue limits did not take wait for the next run */
+		while (nr > i) {
+			nr--;
+			zram_wb_abort(zram, slots[nr]);
+			free_block_bdev(zram, blk + nr);
+		}
+
+		ret = submit_bio_wait(WRITE, bio);
+		bio_put(bio);
+		if (ret)
+			goto out_free_blocks;
+		atomic64_add(nr, &zram->stats.bd_writes);
+
+		for (i = 0; i < nr; i++)
+			zram_wb_commit(zram, slots[i], blk + i, huge);
+
+		cond_resched();
+	}
+	goto out_done;
+
+out_free_blocks:
+	for (i = 0; i < nr; i++)
+		free_block_bdev(zram, blk + i);
+out_abort:
+	for (i = 0; i < nr; i++)
+		zram_wb_abort(zram, slots[i]);
+out_done:
+	mutex_unlock(&zram->wb_lock);
+out_unlock:
+	up_read(&zram->init_lock);
+out_free:
+	for (i = 0; i < ZRAM_WB_BATCH && pages[i]; i++)
+		__free_page(pages[i]);
+
+	return ret ? ret : len;
+}
+#else
+static inline void zram_accessed(struct zram *zram, u32 index) {}
+static inline void reset_bdev(struct zram *zram) {}
+#endif
+
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+static ssize_t recomp_algorithm_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	size_t sz;
+	struct zram *zram = dev_to_zram(dev);
+
+	down_read(&zram->init_lock);
+	sz = zcomp_available_show(zram->recomp_compressor, buf);
+	up_read(&zram->init_lock);
+
+	return sz;
+}
+
+static ssize_t recomp_algorithm_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+
+	down_write(&zram->init_lock);
+	if (init_done(zram)) {
+		up_write(&zram->init_lock);
+		pr_info("Can't change algorithm for initialized device\n");
+		return -EBUSY;
+	}
+	if (sysfs_streq(buf, "none"))
+		zram->recomp_compressor[0] = '\0';
+	else
+		strlcpy(zram->recomp_compressor, buf,
+			sizeof(zram->recomp_compressor));
+	up_write(&zram->init_lock);
+	return len;
+}
+
+static ssize_t recomp_threshold_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct zram *zram = dev_to_zram(dev);
+
+	return scnprintf(buf, PAGE_SIZE, "%zu\n", zram->recomp_threshold);
+}
+
+static ssize_t recomp_threshold_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t len)
+{
+	struct zram *zram = dev_to_zram(dev);
+	unsigned long val;
+	int ret;
+
+	ret = kstrtoul(buf, 10, &val);
+	if (ret)
+		return ret;
+	if (val >= PAGE_SIZE)
+		return -EINVAL;
+
+	zram->recomp_threshold = val;
+	return len;
+}
+
+static ssize_t comp_stat_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct zram *zram = dev_to_zram(dev);
+	struct zcomp_backend *backend;
+	struct zram_comp_stats *stats;
+	ssize_t sz = 0;
+	int prio;
+
+	down_read(&zram->init_lock);
+	if (!init_done(zram))
+		goto out;
+
+	for (prio = 0; prio < ZRAM_NR_COMPS; prio++) {
+		backend = prio == ZRAM_PRIMARY_COMP ? zram->comp->backend :
+			  zram->comp->recomp_backend;
+		if (!backend)
+			continue;
+
+		stats = &zram->stats.comp[prio];
+		sz += scnprintf(buf + sz, PAGE_SIZE - sz,
+				"%-8s %8llu %12llu %14llu %8llu %14llu\n",
+				backend->name,
+				(u64)atomic64_read(&stats->comp_pages),
+				(u64)atomic64_read(&stats->comp_size),
+				(u64)atomic64_read(&stats->comp_nsecs),
+				(u64)atomic64_read(&stats->decomp_pages),
+				(u64)atomic64_read(&stats->decomp_nsecs));
+	}
+out:
+	up_read(&zram->init_lock);
+
+	return sz;
+}
+
+static const char *zram_recomp_name(struct zram *zram)
+{
+	return zram->recomp_compressor[0] ? zram->recomp_compressor : NULL;
+}
+
+static void zram_comp_account(struct zram *zram, enum zram_comp_prio prio,
+			      size_t clen, u64 start)
+{
+	struct zram_comp_stats *stats = &zram->stats.comp[prio];
+
+	atomic64_inc(&stats->comp_pages);
+	atomic64_add(clen, &stats->comp_size);
+	atomic64_add(local_clock() - start, &stats->comp_nsecs);
+}
+
+/*
+ * Compress @src with the primary backend and, if that result is larger
+ * than recomp_threshold, with the recompression backend too. @recomp is
+ * set when the smaller result is the one in ->recomp_buffer.
+ */
+static int zram_compress(struct zram *zram, struct zcomp_strm *zstrm,
+			 const unsigned char *src, size_t *clen, bool *recomp)
+{
+	size_t rlen;
+	u64 start;
+	int ret;
+
+	start = local_clock();
+	ret = zcomp_compress(zram->comp, zstrm, src, clen);
+	if (ret)
+		return ret;
+	zram_comp_account(zram, ZRAM_PRIMARY_COMP, *clen, start);
+
+	if (!zram->comp->recomp_backend || *clen <= zram->recomp_threshold)
+		return 0;
+
+	start = local_clock();
+	/* a failed retry keeps the first result */
+	if (zcomp_recompress(zram->comp, zstrm, src, &rlen))
+		return 0;
+	zram_comp_account(zram, ZRAM_SECONDARY_COMP, rlen, start);
+
+	if (rlen < *clen) {
+		*clen = rlen;
+		*recomp = true;
+	}
+	return 0;
+}
+
+static int zram_decompress(struct zram *zram, const unsigned char *src,
+			   size_t size, unsigned char *mem, bool recomp)
+{
+	struct zram_comp_stats *stats;
+	u64 start = local_clock();
+	int ret;
+
+	if (recomp) {
+		stats = &zram->stats.comp[ZRAM_SECONDARY_COMP];
+		ret = zcomp_recomp_decompress(zram->comp, src, size, mem);
+	} else {
+		stats = &zram->stats.comp[ZRAM_PRIMARY_COMP];
+		ret = zcomp_decompress(zram->comp, src, size, mem);
+	}
+	atomic64_inc(&stats->decomp_pages);
+	atomic64_add(local_clock() - start, &stats->decomp_nsecs);
+
+	return ret;
+}
+#else
+static inline const char *zram_recomp_name(struct zram *zram)
+{
+	return NULL;
+}
+
+#ifndef CONFIG_ZSM
+static inline int zram_compress(struct zram *zram, struct zcomp_strm *zstrm,
+			const unsigned char *src, size_t *clen, bool *recomp)
+{
+	return zcomp_compress(zram->comp, zstrm, src, clen);
+}
+#endif
+
+static inline int zram_decompress(struct zram *zram, const unsigned char *src,
+			size_t size, unsigned char *mem, bool recomp)
+{
+	return zcomp_decompress(zram->comp, src, size, mem);
+}
+#endif
+
 /*
  * Check if request is within bounds and aligned on zram logical blocks.
  */
@@ -710,6 +1338,24 @@ static void zram_free_page(struct zram *zram, size_t index)
 	unsigned long handle = meta->table[index].handle;
 #ifdef CONFIG_ZSM
 	int ret = 0;
+#endif
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+	if (zram_test_flag(meta, index, ZRAM_RECOMP)) {
+		zram_clear_flag(meta, index, ZRAM_RECOMP);
+		atomic64_dec(&zram->stats.recomp_pages);
+	}
+#endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+	zram_clear_flag(meta, index, ZRAM_IDLE);
+	/* tells a running writeback that the slot has changed */
+	zram_clear_flag(meta, index, ZRAM_UNDER_WB);
+	if (zram_test_flag(meta, index, ZRAM_WB)) {
+		zram_clear_flag(meta, index, ZRAM_WB);
+		free_block_bdev(zram, handle);
+		atomic64_dec(&zram->stats.pages_stored);
+		meta->table[index].handle = 0;
+		return;
+	}
 #endif
 	if (unlikely(!handle)) {
 		/*
@@ -758,6 +1404,14 @@ static int zram_decompress_page(struct zram *zram, char *mem, u32 index)
 	size_t size;
 
 	bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
+#ifdef CONFIG_ZRAM_WRITEBACK
+	if (zram_test_flag(meta, index, ZRAM_WB)) {
+		unsigned long blk = meta->table[index].handle;
+
+		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+		return zram_read_bdev(zram, blk, mem, NULL, 0);
+	}
+#endif
 	handle = meta->table[index].handle;
 	size = zram_get_obj_size(meta, index);
 
@@ -771,7 +1425,8 @@ static int zram_decompress_page(struct zram *zram, char *mem, u32 index)
 	if (size == PAGE_SIZE)
 		copy_page(mem, cmem);
 	else
-		ret = zcomp_decompress(zram->comp, cmem, size, mem);
+		ret = zram_decompress(zram, cmem, size, mem,
+				zram_test_flag(meta, index, ZRAM_RECOMP));
 	zs_unmap_object(meta->mem_pool, handle);
 	bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
 
@@ -795,12 +1450,22 @@ static int zram_bvec_read(struct zram *zram, struct bio_vec *bvec,
 	page = bvec->bv_page;
 
 	bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
+#ifdef CONFIG_ZRAM_WRITEBACK
+	if (zram_test_flag(meta, index, ZRAM_WB)) {
+		unsigned long blk = meta->table[index].handle;
+
+		zram_accessed(zram, index);
+		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
+		return zram_read_bdev(zram, blk, NULL, bvec, offset);
+	}
+#endif
 	if (unlikely(!meta->table[index].handle) ||
 			zram_test_flag(meta, index, ZRAM_ZERO)) {
 		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
 		handle_zero_page(bvec);
 		return 0;
 	}
+	zram_accessed(zram, index);
 	bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
 
 	if (is_partial_io(bvec))
@@ -850,8 +1515,12 @@ static inline void update_used_max(struct zram *zram,
 	} while (old_max != cur_max);
 }
 
+/*
+ * @batch_strm: compression stream already held by the caller for the whole
+ * bio, or NULL to look one up for this page only.
+ */
 static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
-			   int offset)
+			   int offset, struct zcomp_strm *batch_strm)
 {
 	int ret = 0;
 #ifdef CONFIG_ZSM
@@ -864,6 +1533,7 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 	struct zram_meta *meta = zram->meta;
 	struct zcomp_strm *zstrm;
 	bool locked = false;
+	bool recomp = false;
 	unsigned long alloced_pages;
 
 	page = bvec->bv_page;
@@ -896,8 +1566,12 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 #endif
 	}
 
-	zstrm = zcomp_strm_find(zram->comp);
-	locked = true;
+	if (batch_strm) {
+		zstrm = batch_strm;
+	} else {
+		zstrm = zcomp_strm_find(zram->comp);
+		locked = true;
+	}
 	user_mem = kmap_atomic(page);
 
 	if (is_partial_io(bvec)) {
@@ -916,6 +1590,7 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 		bit_spin_lock(ZRAM_ACCESS, &meta->table[index].value);
 		zram_free_page(zram, index);
 		zram_set_flag(meta, index, ZRAM_ZERO);
+		zram_accessed(zram, index);
 		bit_spin_unlock(ZRAM_ACCESS, &meta->table[index].value);
 
 		atomic64_inc(&zram->stats.zero_pages);
@@ -925,7 +1600,7 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 #ifdef CONFIG_ZSM
 	ret = zcomp_compress_zram(zram->comp, zstrm, uncmem, &clen, &checksum);
 #else
-	ret = zcomp_compress(zram->comp, zstrm, uncmem, &clen);
+	ret = zram_compress(zram, zstrm, uncmem, &clen, &recomp);
 #endif
 	if (!is_partial_io(bvec)) {
 		kunmap_atomic(user_mem);
@@ -937,9 +1612,10 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 		pr_err("Compression failed! err=%d\n", ret);
 		goto out;
 	}
-	src = zstrm->buffer;
+	src = recomp ? zstrm->recomp_buffer : zstrm->buffer;
 	if (unlikely(clen > max_zpage_size)) {
 		clen = PAGE_SIZE;
+		recomp = false;
 		if (is_partial_io(bvec))
 			src = uncmem;
 #ifdef CONFIG_ZSM
@@ -1022,8 +1698,10 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 		memcpy(cmem, src, clen);
 	}
 
-	zcomp_strm_release(zram->comp, zstrm);
-	locked = false;
+	if (locked) {
+		zcomp_strm_release(zram->comp, zstrm);
+		locked = false;
+	}
 	zs_unmap_object(meta->mem_pool, handle);
 
 	/*
@@ -1034,6 +1712,13 @@ static int zram_bvec_write(struct zram *zram, struct bio_vec *bvec, u32 index,
 	zram_free_page(zram, index);
 	meta->table[index].handle = handle;
 	zram_set_obj_size(meta, index, clen);
+	zram_accessed(zram, index);
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+	if (recomp) {
+		zram_set_flag(meta, index, ZRAM_RECOMP);
+		atomic64_inc(&zram->stats.recomp_pages);
+	}
+#endif
 #ifdef CONFIG_ZSM
 	zsm_set_flag_index(meta, index, ZRAM_ZSM_DONE_NODE);
 #endif
@@ -1051,7 +1736,7 @@ out:
 }
 
 static int zram_bvec_rw(struct zram *zram, struct bio_vec *bvec, u32 index,
-			int offset, struct bio *bio)
+			int offset, struct bio *bio, struct zcomp_strm *zstrm)
 {
 	int ret;
 	int rw = bio_data_dir(bio);
@@ -1061,7 +1746,7 @@ static int zram_bvec_rw(struct zram *zram, struct bio_vec *bvec, u32 index,
 		ret = zram_bvec_read(zram, bvec, index, offset, bio);
 	} else {
 		atomic64_inc(&zram->stats.num_writes);
-		ret = zram_bvec_write(zram, bvec, index, offset);
+		ret = zram_bvec_write(zram, bvec, index, offset, zstrm);
 	}
 
 	if (unlikely(ret)) {
@@ -1121,6 +1806,7 @@ static void zram_reset_device(struct zram *zram, bool reset_capacity)
 	down_write(&zram->init_lock);
 
 	zram->limit_pages = 0;
+	reset_bdev(zram);
 
 	if (!init_done(zram)) {
 		up_write(&zram->init_lock);
@@ -1132,14 +1818,15 @@ static void zram_reset_device(struct zram *zram, bool reset_capacity)
 	for (index = 0; index < zram->disksize >> PAGE_SHIFT; index++) {
 		unsigned long handle = meta->table[index].handle;
 
-		if (!handle)
+		/* written back pages hold a block number, not a handle */
+		if (!handle || zram_test_flag(meta, index, ZRAM_WB))
 			continue;
 
 		zs_free(meta->mem_pool, handle);
 	}
 
 	zcomp_destroy(zram->comp);
-	zram->max_comp_streams = 1;
+	zram->max_comp_streams = ZRAM_DEFAULT_COMP_STREAMS;
 
 	zram_meta_free(zram->meta);
 	zram->meta = NULL;
@@ -1184,7 +1871,8 @@ static ssize_t disksize_store(struct device *dev,
 	if (!meta)
 		return -ENOMEM;
 
-	comp = zcomp_create(zram->compressor, zram->max_comp_streams);
+	comp = zcomp_create(zram->compressor, zram_recomp_name(zram),
+			zram->max_comp_streams);
 	if (IS_ERR(comp)) {
 		pr_info("Cannot initialise %s compressing backend\n",
 				zram->compressor);
@@ -1269,6 +1957,7 @@ static void __zram_make_request(struct zram *zram, struct bio *bio)
 	u32 index;
 	struct bio_vec bvec;
 	struct bvec_iter iter;
+	struct zcomp_strm *zstrm = NULL;
 
 	index = bio->bi_iter.bi_sector >> SECTORS_PER_PAGE_SHIFT;
 	offset = (bio->bi_iter.bi_sector &
@@ -1280,6 +1969,13 @@ static void __zram_make_request(struct zram *zram, struct bio *bio)
 		return;
 	}
 
+	/*
+	 * A multi-page write keeps one compression stream for the whole bio
+	 * instead of looking one up (and possibly waiting for it) per page.
+	 */
+	if (bio_data_dir(bio) == WRITE && bio_segments(bio) > 1)
+		zstrm = zcomp_strm_find(zram->comp);
+
 	bio_for_each_segment(bvec, bio, iter) {
 		int max_transfer_size = PAGE_SIZE - offset;
 
@@ -1294,25 +1990,31 @@ static void __zram_make_request(struct zram *zram, struct bio *bio)
 			bv.bv_len = max_transfer_size;
 			bv.bv_offset = bvec.bv_offset;
 
-			if (zram_bvec_rw(zram, &bv, index, offset, bio) < 0)
+			if (zram_bvec_rw(zram, &bv, index, offset, bio, zstrm) < 0)
 				goto out;
 
 			bv.bv_len = bvec.bv_len - max_transfer_size;
 			bv.bv_offset += max_transfer_size;
-			if (zram_bvec_rw(zram, &bv, index + 1, 0, bio) < 0)
+			if (zram_bvec_rw(zram, &bv, index + 1, 0, bio,
+					 zstrm) < 0)
 				goto out;
 		} else
-			if (zram_bvec_rw(zram, &bvec, index, offset, bio) < 0)
+			if (zram_bvec_rw(zram, &bvec, index, offset, bio,
+					 zstrm) < 0)
 				goto out;
 
 		update_position(&index, &offset, &bvec);
 	}
 
+	if (zstrm)
+		zcomp_strm_release(zram->comp, zstrm);
 	set_bit(BIO_UPTODATE, &bio->bi_flags);
 	bio_endio(bio, 0);
 	return;
 
 out:
+	if (zstrm)
+		zcomp_strm_release(zram->comp, zstrm);
 	bio_io_error(bio);
 }
 
@@ -1372,10 +2074,25 @@ static DEVICE_ATTR(mem_limit, S_IRUGO | S_IWUSR, mem_limit_show,
 		mem_limit_store);
 static DEVICE_ATTR(mem_used_max, S_IRUGO | S_IWUSR, mem_used_max_show,
 		mem_used_max_store);
+static DEVICE_ATTR(compact, S_IWUSR, NULL, compact_store);
+static DEVICE_ATTR(pages_compacted, S_IRUGO, pages_compacted_show, NULL);
 static DEVICE_ATTR(max_comp_streams, S_IRUGO | S_IWUSR,
 		max_comp_streams_show, max_comp_streams_store);
 static DEVICE_ATTR(comp_algorithm, S_IRUGO | S_IWUSR,
 		comp_algorithm_show, comp_algorithm_store);
+#ifdef CONFIG_ZRAM_WRITEBACK
+static DEVICE_ATTR(backing_dev, S_IRUGO | S_IWUSR,
+		backing_dev_show, backing_dev_store);
+static DEVICE_ATTR(idle, S_IWUSR, NULL, idle_store);
+static DEVICE_ATTR(writeback, S_IWUSR, NULL, writeback_store);
+#endif
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+static DEVICE_ATTR(recomp_algorithm, S_IRUGO | S_IWUSR,
+		recomp_algorithm_show, recomp_algorithm_store);
+static DEVICE_ATTR(recomp_threshold, S_IRUGO | S_IWUSR,
+		recomp_threshold_show, recomp_threshold_store);
+static DEVICE_ATTR(comp_stat, S_IRUGO, comp_stat_show, NULL);
+#endif
 
 ZRAM_ATTR_RO(num_reads);
 ZRAM_ATTR_RO(num_writes);
@@ -1385,6 +2102,14 @@ ZRAM_ATTR_RO(invalid_io);
 ZRAM_ATTR_RO(notify_free);
 ZRAM_ATTR_RO(zero_pages);
 ZRAM_ATTR_RO(compr_data_size);
+#ifdef CONFIG_ZRAM_WRITEBACK
+ZRAM_ATTR_RO(bd_count);
+ZRAM_ATTR_RO(bd_reads);
+ZRAM_ATTR_RO(bd_writes);
+#endif
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+ZRAM_ATTR_RO(recomp_pages);
+#endif
 
 static struct attribute *zram_disk_attrs[] = {
 	&dev_attr_disksize.attr,
@@ -1402,8 +2127,24 @@ static struct attribute *zram_disk_attrs[] = {
 	&dev_attr_mem_used_total.attr,
 	&dev_attr_mem_limit.attr,
 	&dev_attr_mem_used_max.attr,
+	&dev_attr_compact.attr,
+	&dev_attr_pages_compacted.attr,
 	&dev_attr_max_comp_streams.attr,
 	&dev_attr_comp_algorithm.attr,
+#ifdef CONFIG_ZRAM_WRITEBACK
+	&dev_attr_backing_dev.attr,
+	&dev_attr_idle.attr,
+	&dev_attr_writeback.attr,
+	&dev_attr_bd_count.attr,
+	&dev_attr_bd_reads.attr,
+	&dev_attr_bd_writes.attr,
+#endif
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+	&dev_attr_recomp_algorithm.attr,
+	&dev_attr_recomp_threshold.attr,
+	&dev_attr_comp_stat.attr,
+	&dev_attr_recomp_pages.attr,
+#endif
 	NULL,
 };
 
@@ -1416,6 +2157,10 @@ static int create_device(struct zram *zram, int device_id)
 	int ret = -ENOMEM;
 
 	init_rwsem(&zram->init_lock);
+#ifdef CONFIG_ZRAM_WRITEBACK
+	spin_lock_init(&zram->bitmap_lock);
+	mutex_init(&zram->wb_lock);
+#endif
 #ifdef CONFIG_ZSM
 	spin_lock_init(&zram_node_mutex);
 	spin_lock_init(&zram_node4k_mutex);
@@ -1486,8 +2231,12 @@ static int create_device(struct zram *zram, int device_id)
 		goto out_free_disk;
 	}
 	strlcpy(zram->compressor, default_compressor, sizeof(zram->compressor));
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+	zram->recomp_compressor[0] = '\0';
+	zram->recomp_threshold = PAGE_SIZE / 2;
+#endif
 	zram->meta = NULL;
-	zram->max_comp_streams = 1;
+	zram->max_comp_streams = ZRAM_DEFAULT_COMP_STREAMS;
 	return 0;
 
 out_free_disk:
@@ -45,6 +45,16 @@ static const size_t max_zpage_size = PAGE_SIZE / 4 * 3;
  * always return failure.
  */
 
+/*
+ * Default number of compression streams, ZCOMP_STRM_PERCPU (0) gives every
+ * cpu its own stream.
+ */
+#ifdef CONFIG_ZRAM_PERCPU_COMP_STREAMS
+#define ZRAM_DEFAULT_COMP_STREAMS	ZCOMP_STRM_PERCPU
+#else
+#define ZRAM_DEFAULT_COMP_STREAMS	1
+#endif
+
 /*-- End of configurable params */
 
 #define SECTOR_SHIFT		9
@@ -78,6 +88,10 @@ enum zram_pageflags {
 	ZRAM_ZSM_DONE_NODE,
 	ZRAM_ZERO = ZRAM_FLAG_SHIFT + 1,
 	ZRAM_ACCESS,	/* page in now accessed */
+	ZRAM_WB,	/* page is stored on the backing device */
+	ZRAM_UNDER_WB,	/* page is being written to the backing device */
+	ZRAM_IDLE,	/* page not accessed since it was marked idle */
+	ZRAM_RECOMP,	/* page compressed with the recompression backend */
 	__NR_ZRAM_PAGEFLAGS,
 };
 #else
@@ -85,6 +99,10 @@ enum zram_pageflags {
 	/* Page consists entirely of zeros */
 	ZRAM_ZERO = ZRAM_FLAG_SHIFT + 1,
 	ZRAM_ACCESS,	/* page in now accessed */
+	ZRAM_WB,	/* page is stored on the backing device */
+	ZRAM_UNDER_WB,	/* page is being written to the backing device */
+	ZRAM_IDLE,	/* page not accessed since it was marked idle */
+	ZRAM_RECOMP,	/* page compressed with the recompression backend */
 	__NR_ZRAM_PAGEFLAGS,
 };
 #endif
@@ -106,10 +124,30 @@ struct zram_table_entry {
 };
 #else
 struct zram_table_entry {
-	unsigned long handle;
+	unsigned long handle;	/* backing device block for ZRAM_WB pages */
 	unsigned long value;
+#ifdef CONFIG_ZRAM_WRITEBACK
+	unsigned long ac_time;	/* jiffies of the last access */
+#endif
+};
+#endif
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+/* index into zram_stats.comp[] */
+enum zram_comp_prio {
+	ZRAM_PRIMARY_COMP,	/* comp_algorithm */
+	ZRAM_SECONDARY_COMP,	/* recomp_algorithm */
+	ZRAM_NR_COMPS,
+};
+
+struct zram_comp_stats {
+	atomic64_t comp_pages;		/* pages compressed */
+	atomic64_t comp_size;		/* bytes they compressed to */
+	atomic64_t comp_nsecs;		/* time spent compressing */
+	atomic64_t decomp_pages;	/* pages decompressed */
+	atomic64_t decomp_nsecs;	/* time spent decompressing */
 };
 #endif
+
 struct zram_stats {
 	atomic64_t compr_data_size;	/* compressed size of pages stored */
 	atomic64_t num_reads;	/* failed + successful */
@@ -121,6 +159,15 @@ struct zram_stats {
 	atomic64_t zero_pages;		/* no. of zero filled pages */
 	atomic64_t pages_stored;	/* no. of pages currently stored */
 	atomic_long_t max_used_pages;	/* no. of maximum pages stored */
+#ifdef CONFIG_ZRAM_WRITEBACK
+	atomic64_t bd_count;	/* no. of pages on the backing device */
+	atomic64_t bd_reads;	/* no. of pages read from the backing device */
+	atomic64_t bd_writes;	/* no. of pages written to the backing device */
+#endif
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+	struct zram_comp_stats comp[ZRAM_NR_COMPS];
+	atomic64_t recomp_pages;	/* no. of pages stored recompressed */
+#endif
 #ifdef CONFIG_ZSM
 	atomic64_t zsm_saved;          /* saved physical size*/
 	atomic64_t zsm_saved4k;
@@ -153,6 +200,22 @@ struct zram {
 	unsigned long limit_pages;
 
 	char compressor[10];
+#ifdef CONFIG_ZRAM_ADAPTIVE_COMP
+	/* empty for none */
+	char recomp_compressor[10];
+	/* pages compressing to more bytes than this are recompressed */
+	size_t recomp_threshold;
+#endif
+#ifdef CONFIG_ZRAM_WRITEBACK
+	struct block_device *bdev;
+	char *backing_dev_name;
+	/* one bit per PAGE_SIZE block of the backing device */
+	unsigned long *bitmap;
+	unsigned long nr_pages;
+	spinlock_t bitmap_lock;
+	/* serializes writeback_store() */
+	struct mutex wb_lock;
+#endif
 };
 
 /* mlog */
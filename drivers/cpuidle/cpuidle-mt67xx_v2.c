@@ -48,6 +48,117 @@ int __attribute__((weak)) rgidle_enter(int cpu)
 	return 1;
 }
 
+#ifdef CONFIG_CPU_IDLE_MTK_MENU
+/*
+ * The menu governor wants the states ordered from the shallowest to the
+ * deepest, mt_idle.c numbers them the other way round (IDLE_TYPE_*).
+ */
+#define MT_IDLE_NR_TYPES		6
+#define MT_IDLE_STATE_TYPE(idx)		(MT_IDLE_NR_TYPES - 1 - (idx))
+
+int __attribute__((weak)) mt_idle_enter(int cpu, int type)
+{
+	return MT_IDLE_STATE_TYPE(0);
+}
+
+static int mt_menu_enter(struct cpuidle_device *dev,
+			      struct cpuidle_driver *drv, int index)
+{
+	int type;
+
+	/* SPM conditions may refuse the state, report the one entered */
+	type = mt_idle_enter(smp_processor_id(), MT_IDLE_STATE_TYPE(index));
+	if (type < 0 || type >= MT_IDLE_NR_TYPES)
+		return index;
+
+	return MT_IDLE_STATE_TYPE(type);
+}
+
+/* defaults, overridden by /cpus/idle-states/<name> in the device tree */
+static struct cpuidle_driver mt67xx_v2_cpuidle_driver = {
+	.name             = "mt67xx_v2_cpuidle",
+	.owner            = THIS_MODULE,
+	.states[0] = {
+		.enter            = mt_menu_enter,
+		.exit_latency     = 1,
+		.target_residency = 1,
+		.flags            = CPUIDLE_FLAG_TIME_VALID,
+		.name             = "rgidle",
+		.desc             = "WFI",
+	},
+	.states[1] = {
+		.enter            = mt_menu_enter,
+		.exit_latency     = 20,
+		.target_residency = 100,
+		.flags            = CPUIDLE_FLAG_TIME_VALID,
+		.name             = "slidle",
+		.desc             = "slidle",
+	},
+	.states[2] = {
+		.enter            = mt_menu_enter,
+		.exit_latency     = 300,
+		.target_residency = 3000,          /* 3 ms */
+		.flags            = CPUIDLE_FLAG_TIME_VALID,
+		.name             = "mcdi",
+		.desc             = "MCDI",
+	},
+	.states[3] = {
+		.enter            = mt_menu_enter,
+		.exit_latency     = 1000,
+		.target_residency = 2000,          /* 2 ms */
+		.flags            = CPUIDLE_FLAG_TIME_VALID,
+		.name             = "sodi",
+		.desc             = "SODI",
+	},
+	.states[4] = {
+		.enter            = mt_menu_enter,
+		.exit_latency     = 1500,
+		.target_residency = 5000,          /* 5 ms */
+		.flags            = CPUIDLE_FLAG_TIME_VALID,
+		.name             = "sodi3",
+		.desc             = "SODI3",
+	},
+	.states[5] = {
+		.enter            = mt_menu_enter,
+		.exit_latency     = 1500,
+		.target_residency = 2000,          /* 2 ms */
+		.flags            = CPUIDLE_FLAG_TIME_VALID,
+		.name             = "dpidle",
+		.desc             = "deepidle",
+	},
+	.state_count = 6,
+	.safe_state_index = 0,
+};
+
+static void __init mt67xx_v2_idle_states_init(struct cpuidle_driver *drv)
+{
+	struct device_node *np, *state_node;
+	u32 entry, exit, residency;
+	int i;
+
+	np = of_find_node_by_path("/cpus/idle-states");
+	if (!np)
+		return;
+
+	for (i = 0; i < drv->state_count; i++) {
+		state_node = of_get_child_by_name(np, drv->states[i].name);
+		if (!state_node)
+			continue;
+
+		if (!of_property_read_u32(state_node, "exit-latency-us", &exit)) {
+			if (of_property_read_u32(state_node, "entry-latency-us", &entry))
+				entry = 0;
+			drv->states[i].exit_latency = entry + exit;
+		}
+		if (!of_property_read_u32(state_node, "min-residency-us", &residency))
+			drv->states[i].target_residency = residency;
+
+		of_node_put(state_node);
+	}
+
+	of_node_put(np);
+}
+#else
 static int mt_dpidle_enter(struct cpuidle_device *dev,
 			      struct cpuidle_driver *drv, int index)
 {
@@ -139,6 +250,11 @@ static struct cpuidle_driver mt67xx_v2_cpuidle_driver = {
 	.safe_state_index = 0,
 };
 
+static inline void mt67xx_v2_idle_states_init(struct cpuidle_driver *drv)
+{
+}
+#endif
+
 #ifdef CONFIG_ARM64
 
 static const struct of_device_id mt67xx_v2_idle_state_match[] __initconst = {
@@ -170,6 +286,8 @@ int __init mt67xx_v2_cpuidle_init(void)
 		}
 	}
 
+	mt67xx_v2_idle_states_init(drv);
+
 	ret = cpuidle_register(drv, NULL);
 	if (ret) {
 		pr_err("failed to register cpuidle driver\n");
@@ -181,6 +299,8 @@ int __init mt67xx_v2_cpuidle_init(void)
 #else
 int __init mt67xx_v2_cpuidle_init(void)
 {
+	mt67xx_v2_idle_states_init(&mt67xx_v2_cpuidle_driver);
+
 	return cpuidle_register(&mt67xx_v2_cpuidle_driver, NULL);
 }
 #endif
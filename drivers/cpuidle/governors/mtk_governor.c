@@ -98,6 +98,10 @@ static int __init init_mtk_governor(void)
 {
 	/* TODO: check if debugfs_create_file() failed */
 	mt_cpuidle_framework_init();
+	/* states are ordered for the menu governor, see cpuidle-mt67xx_v2.c */
+	if (IS_ENABLED(CONFIG_CPU_IDLE_MTK_MENU))
+		return 0;
+
 	return cpuidle_register_governor(&mtk_governor);
 }
 
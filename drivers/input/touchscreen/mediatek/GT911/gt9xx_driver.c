@@ -6,6 +6,7 @@
 #include "gt9xx_firmware.h"
 
 #include "mt_boot_common.h"
+#include "perfmgr.h"
 #ifdef GTP_PROXIMITY
 #include <linux/hwmsensor.h>
 #include <linux/hwmsen_dev.h>
@@ -510,10 +511,10 @@ int i2c_read_bytes(struct i2c_client *client, u16 addr, u8 *rxbuf, int len)
 
 		msg[1].buf = &rxbuf[offset];
 
-		if (left > MAX_TRANSACTION_LENGTH) {
-			msg[1].len = MAX_TRANSACTION_LENGTH;
-			left -= MAX_TRANSACTION_LENGTH;
-			offset += MAX_TRANSACTION_LENGTH;
+		if (left > GTP_READ_TRANSACTION_LENGTH) {
+			msg[1].len = GTP_READ_TRANSACTION_LENGTH;
+			left -= GTP_READ_TRANSACTION_LENGTH;
+			offset += GTP_READ_TRANSACTION_LENGTH;
 		} else {
 			msg[1].len = left;
 			left = 0;
@@ -1135,6 +1136,7 @@ out:
 static irqreturn_t tpd_interrupt_handler(int irq, void *dev_id)
 {
 	TPD_DEBUG_PRINT_INT;
+	perfmgr_touch_irq_boost();
 	tpd_flag = 1;
 	wake_up_interruptible(&waiter);
 	return IRQ_HANDLED;
@@ -1304,6 +1306,7 @@ static int touch_event_handler(void *unused)
 	u8  end_cmd[3] = {GTP_READ_COOR_ADDR >> 8, GTP_READ_COOR_ADDR & 0xFF, 0};
 	u8  point_data[2 + 1 + 8 * GTP_MAX_TOUCH + 1] = {GTP_READ_COOR_ADDR >> 8, GTP_READ_COOR_ADDR & 0xFF};
 	u8  touch_num = 0;
+	u8  read_num = 0;
 	u8  finger = 0;
 	static u8 pre_touch;
 	static u8 pre_key;
@@ -1324,7 +1327,7 @@ static int touch_event_handler(void *unused)
 	s32 temp;
 #endif
 
-	sched_setscheduler(current, SCHED_RR, &param);
+	sched_setscheduler(current, SCHED_FIFO, &param);
 
 	do {
 		set_current_state(TASK_INTERRUPTIBLE);
@@ -1345,7 +1348,9 @@ static int touch_event_handler(void *unused)
 			continue;
 		}
 
-		ret = gtp_i2c_read(i2c_client_point, point_data, 12);
+		/* as many points as last time in one transfer, most reports need no more */
+		read_num = pre_touch > 1 ? pre_touch : 1;
+		ret = gtp_i2c_read(i2c_client_point, point_data, GTP_ADDR_LENGTH + 2 + 8 * read_num);
 
 		if (ret < 0) {
 			GTP_ERROR("I2C transfer error. errno:%d ", ret);
@@ -1401,11 +1406,14 @@ static int touch_event_handler(void *unused)
 			goto exit_work_func;
 		}
 
-		if (touch_num > 1) {
-			u8 buf[8 * GTP_MAX_TOUCH] = {(GTP_READ_COOR_ADDR + 10) >> 8, (GTP_READ_COOR_ADDR + 10) & 0xff};
+		if (touch_num > read_num) {
+			u8 buf[GTP_ADDR_LENGTH + 8 * GTP_MAX_TOUCH];
 
-			ret = gtp_i2c_read(i2c_client_point, buf, 2 + 8 * (touch_num - 1));
-			memcpy(&point_data[12], &buf[2], 8 * (touch_num - 1));
+			buf[0] = (GTP_READ_COOR_ADDR + 2 + 8 * read_num) >> 8;
+			buf[1] = (GTP_READ_COOR_ADDR + 2 + 8 * read_num) & 0xff;
+			ret = gtp_i2c_read(i2c_client_point, buf, 2 + 8 * (touch_num - read_num));
+			memcpy(&point_data[GTP_ADDR_LENGTH + 2 + 8 * read_num], &buf[2],
+			       8 * (touch_num - read_num));
 		}
 #ifdef CONFIG_GTP_HAVE_TOUCH_KEY
 		key_value = point_data[3 + 8 * touch_num];
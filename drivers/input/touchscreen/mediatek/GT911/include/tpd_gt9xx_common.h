@@ -230,6 +230,8 @@ enum CHIP_TYPE_T {
 #define GTP_DMA_MAX_TRANSACTION_LENGTH  255   /* for DMA mode */
 #define GTP_DMA_MAX_I2C_TRANSFER_SIZE   (GTP_DMA_MAX_TRANSACTION_LENGTH - GTP_ADDR_LENGTH)
 #define MAX_TRANSACTION_LENGTH        8
+/* reads go DMA on the bus past its 8 byte FIFO, so they are not split */
+#define GTP_READ_TRANSACTION_LENGTH   GTP_DMA_MAX_I2C_TRANSFER_SIZE
 #define TPD_I2C_NUMBER				  0
 #define I2C_MASTER_CLOCK              300
 #define MAX_I2C_TRANSFER_SIZE         (MAX_TRANSACTION_LENGTH - GTP_ADDR_LENGTH)
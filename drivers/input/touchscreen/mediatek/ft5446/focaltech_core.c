@@ -38,6 +38,7 @@
 #include "charging.h"
 
 #include <mt-plat/battery_common.h>
+#include <mt-plat/perfmgr.h>
 
 /* #define TIMER_DEBUG */
 
@@ -1028,7 +1029,7 @@ static int touch_event_handler(void *unused)
 			finfo.p[i] = 1;
 	}
 
-	sched_setscheduler(current, SCHED_RR, &param);
+	sched_setscheduler(current, SCHED_FIFO, &param);
 
 	do {
 		/*enable_irq(touch_irq);*/
@@ -1159,6 +1160,7 @@ static int tpd_i2c_detect(struct i2c_client *client, struct i2c_board_info *info
 static irqreturn_t tpd_eint_interrupt_handler(int irq, void *dev_id)
 {
 	TPD_DEBUG("TPD interrupt has been triggered\n");
+	perfmgr_touch_irq_boost();
 	tpd_flag = 1;
 
 #if FT_ESD_PROTECT
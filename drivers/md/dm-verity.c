@@ -11,13 +11,20 @@
  * default prefetch value. Data are read in "prefetch_cluster" chunks from the
  * hash device. Setting this greatly improves performance when data and hash
  * are on the same disk on different partitions on devices with poor random
- * access behavior.
+ * access behavior. Each target adapts its own cluster between this value
+ * and DM_VERITY_PREFETCH_MAX_SHIFT times it, depending on how many hash
+ * blocks its reads miss and how many prefetched blocks are really used.
+ *
+ * In the file "/sys/module/dm_verity/parameters/parallel_blocks" you can set
+ * the number of data blocks from which a bio is verified in parallel chunks
+ * on several cpus. 0 disables parallel verification.
  */
 
 #include "dm-bufio.h"
 
 #include <linux/module.h>
 #include <linux/device-mapper.h>
+#include <linux/vmalloc.h>
 #include <crypto/hash.h>
 
 #define DM_MSG_PREFIX			"verity"
@@ -26,12 +33,25 @@
 #define DM_VERITY_MEMPOOL_SIZE		4
 #define DM_VERITY_DEFAULT_PREFETCH_SIZE	262144
 
+#define DM_VERITY_PREFETCH_MAX_SHIFT	3
+#define DM_VERITY_PREFETCH_SAMPLE	256
+
+#define DM_VERITY_DEFAULT_PARALLEL_BLOCKS	64
+#define DM_VERITY_MIN_CHUNK_BLOCKS	16
+
 #define DM_VERITY_MAX_LEVELS		63
 
+#define DM_VERITY_OPT_AT_MOST_ONCE	"check_at_most_once"
+#define DM_VERITY_OPT_PIN_LEVELS	"pin_hash_levels"
+
 static unsigned dm_verity_prefetch_cluster = DM_VERITY_DEFAULT_PREFETCH_SIZE;
 
 module_param_named(prefetch_cluster, dm_verity_prefetch_cluster, uint, S_IRUGO | S_IWUSR);
 
+static unsigned dm_verity_parallel_blocks = DM_VERITY_DEFAULT_PARALLEL_BLOCKS;
+
+module_param_named(parallel_blocks, dm_verity_parallel_blocks, uint, S_IRUGO | S_IWUSR);
+
 struct dm_verity {
 	struct dm_dev *data_dev;
 	struct dm_dev *hash_dev;
@@ -41,6 +61,7 @@ struct dm_verity {
 	struct crypto_shash *tfm;
 	u8 *root_digest;	/* digest of the root block */
 	u8 *salt;		/* salt: its size is salt_size */
+	u8 *initial_hashstate;	/* exported state after hashing the salt */
 	unsigned salt_size;
 	sector_t data_start;	/* data offset in 512-byte sectors */
 	sector_t hash_start;	/* hash start in blocks */
@@ -58,6 +79,23 @@ struct dm_verity {
 	mempool_t *vec_mempool;	/* mempool of bio vector */
 
 	struct workqueue_struct *verify_wq;
+	struct workqueue_struct *chunk_wq;	/* parallel parts of one io */
+
+	/* data blocks that verified once, for check_at_most_once */
+	unsigned long *validated_blocks;
+
+	/* adaptive prefetch, see verity_prefetch_cluster() */
+	unsigned prefetch_base;		/* module parameter it started from */
+	unsigned prefetch_cluster;	/* current cluster in bytes */
+	atomic_t pf_lookups;		/* level 0 hash block lookups */
+	atomic_t pf_misses;		/* ... that had to read the block */
+	atomic_t pf_useful;		/* ... that used a prefetched block */
+	atomic_t pf_extra;		/* blocks prefetched beyond the io */
+
+	/* upper hash levels held in memory for the lifetime of the target */
+	unsigned pin_levels;
+	unsigned n_pinned;
+	struct dm_buffer **pinned;
 
 	/* starting blocks for each tree level. 0 is the lowest level. */
 	sector_t hash_level_block[DM_VERITY_MAX_LEVELS];
@@ -88,6 +126,20 @@ struct dm_verity_io {
 	 */
 };
 
+/*
+ * A part of a large bio that is verified on another cpu. The embedded io
+ * only provides the hash descriptor and digests, so it must be last.
+ */
+struct dm_verity_chunk {
+	struct work_struct work;
+	struct bio *bio;
+	sector_t block;
+	unsigned n_blocks;
+	struct bvec_iter iter;
+	int error;
+	struct dm_verity_io io;
+};
+
 struct dm_verity_prefetch_work {
 	struct work_struct work;
 	struct dm_verity *v;
@@ -115,7 +167,9 @@ static u8 *io_want_digest(struct dm_verity *v, struct dm_verity_io *io)
  * hash_verified is nonzero, hash of the block has been verified.
  *
  * The variable hash_verified is set to 0 when allocating the buffer, then
- * it can be changed to 1 and it is never reset to 0 again.
+ * it can be changed to 1 and it is never reset to 0 again. "accessed" works
+ * the same way and tells whether a level 0 buffer was used since it was read,
+ * so the first use of a prefetched buffer can be counted.
  *
  * There is no lock around this value, a race condition can at worst cause
  * that multiple processes verify the hash of the same buffer simultaneously
@@ -124,6 +178,7 @@ static u8 *io_want_digest(struct dm_verity *v, struct dm_verity_io *io)
  */
 struct buffer_aux {
 	int hash_verified;
+	int accessed;
 };
 
 /*
@@ -134,6 +189,7 @@ static void dm_bufio_alloc_callback(struct dm_buffer *buf)
 	struct buffer_aux *aux = dm_bufio_get_aux_data(buf);
 
 	aux->hash_verified = 0;
+	aux->accessed = 0;
 }
 
 /*
@@ -174,6 +230,75 @@ static void verity_hash_at_level(struct dm_verity *v, sector_t block, int level,
 		*offset = idx << (v->hash_dev_block_bits - v->hash_per_block_bits);
 }
 
+/*
+ * Start a hash: salted version 1 hashes resume from the state exported
+ * after the salt, which saves a block of hashing per data block.
+ */
+static int verity_hash_init(struct dm_verity *v, struct shash_desc *desc)
+{
+	int r;
+
+	desc->tfm = v->tfm;
+	desc->flags = CRYPTO_TFM_REQ_MAY_SLEEP;
+
+	if (v->initial_hashstate) {
+		r = crypto_shash_import(desc, v->initial_hashstate);
+		if (r < 0)
+			DMERR("crypto_shash_import failed: %d", r);
+		return r;
+	}
+
+	r = crypto_shash_init(desc);
+	if (r < 0) {
+		DMERR("crypto_shash_init failed: %d", r);
+		return r;
+	}
+
+	if (likely(v->version >= 1)) {
+		r = crypto_shash_update(desc, v->salt, v->salt_size);
+		if (r < 0) {
+			DMERR("crypto_shash_update failed: %d", r);
+			return r;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Hash the last "len" bytes of the input and produce the digest. For
+ * version 1 this is a single finup, which sha256-ce does in one pass.
+ */
+static int verity_hash_final(struct dm_verity *v, struct shash_desc *desc,
+			     const u8 *data, unsigned len, u8 *digest)
+{
+	int r;
+
+	if (likely(v->version >= 1)) {
+		r = crypto_shash_finup(desc, data, len, digest);
+		if (r < 0)
+			DMERR("crypto_shash_finup failed: %d", r);
+		return r;
+	}
+
+	r = crypto_shash_update(desc, data, len);
+	if (r < 0) {
+		DMERR("crypto_shash_update failed: %d", r);
+		return r;
+	}
+
+	r = crypto_shash_update(desc, v->salt, v->salt_size);
+	if (r < 0) {
+		DMERR("crypto_shash_update failed: %d", r);
+		return r;
+	}
+
+	r = crypto_shash_final(desc, digest);
+	if (r < 0)
+		DMERR("crypto_shash_final failed: %d", r);
+	return r;
+}
+
 /*
  * Verify hash of a metadata block pertaining to the specified data block
  * ("block" argument) at a specified level ("level" argument).
@@ -195,15 +320,29 @@ static int verity_verify_level(struct dm_verity_io *io, sector_t block,
 	int r;
 	sector_t hash_block;
 	unsigned offset;
+	bool miss;
 
 	verity_hash_at_level(v, block, level, &hash_block, &offset);
 
-	data = dm_bufio_read(v->bufio, hash_block, &buf);
+	data = dm_bufio_get(v->bufio, hash_block, &buf);
+	miss = !data;
+	if (miss)
+		data = dm_bufio_read(v->bufio, hash_block, &buf);
 	if (unlikely(IS_ERR(data)))
 		return PTR_ERR(data);
 
 	aux = dm_bufio_get_aux_data(buf);
 
+	if (skip_unverified) {
+		/* the first, level 0 lookup for a data block */
+		atomic_inc(&v->pf_lookups);
+		if (miss)
+			atomic_inc(&v->pf_misses);
+		else if (!aux->accessed)
+			atomic_inc(&v->pf_useful);
+		aux->accessed = 1;
+	}
+
 	if (!aux->hash_verified) {
 		struct shash_desc *desc;
 		u8 *result;
@@ -214,42 +353,16 @@ static int verity_verify_level(struct dm_verity_io *io, sector_t block,
 		}
 
 		desc = io_hash_desc(v, io);
-		desc->tfm = v->tfm;
-		desc->flags = CRYPTO_TFM_REQ_MAY_SLEEP;
-		r = crypto_shash_init(desc);
-		if (r < 0) {
-			DMERR("crypto_shash_init failed: %d", r);
+		r = verity_hash_init(v, desc);
+		if (r < 0)
 			goto release_ret_r;
-		}
-
-		if (likely(v->version >= 1)) {
-			r = crypto_shash_update(desc, v->salt, v->salt_size);
-			if (r < 0) {
-				DMERR("crypto_shash_update failed: %d", r);
-				goto release_ret_r;
-			}
-		}
-
-		r = crypto_shash_update(desc, data, 1 << v->hash_dev_block_bits);
-		if (r < 0) {
-			DMERR("crypto_shash_update failed: %d", r);
-			goto release_ret_r;
-		}
-
-		if (!v->version) {
-			r = crypto_shash_update(desc, v->salt, v->salt_size);
-			if (r < 0) {
-				DMERR("crypto_shash_update failed: %d", r);
-				goto release_ret_r;
-			}
-		}
 
 		result = io_real_digest(v, io);
-		r = crypto_shash_final(desc, result);
-		if (r < 0) {
-			DMERR("crypto_shash_final failed: %d", r);
+		r = verity_hash_final(v, desc, data,
+				      1 << v->hash_dev_block_bits, result);
+		if (r < 0)
 			goto release_ret_r;
-		}
+
 		if (unlikely(memcmp(result, io_want_digest(v, io), v->digest_size))) {
 			DMERR_LIMIT("metadata block %llu is corrupted",
 				(unsigned long long)hash_block);
@@ -274,22 +387,30 @@ release_ret_r:
 }
 
 /*
- * Verify one "dm_verity_io" structure.
+ * Verify "n_blocks" data blocks starting at "block", whose data is at "iter"
+ * in the bio.  "io" provides the hash descriptor and digest buffers.
  */
-static int verity_verify_io(struct dm_verity_io *io)
+static int verity_verify_blocks(struct dm_verity_io *io, struct bio *bio,
+				sector_t block, unsigned n_blocks,
+				struct bvec_iter *iter)
 {
 	struct dm_verity *v = io->v;
-	struct bio *bio = dm_bio_from_per_bio_data(io,
-						   v->ti->per_bio_data_size);
 	unsigned b;
 	int i;
 
-	for (b = 0; b < io->n_blocks; b++) {
+	for (b = 0; b < n_blocks; b++) {
 		struct shash_desc *desc;
 		u8 *result;
 		int r;
 		unsigned todo;
 
+		if (v->validated_blocks &&
+		    likely(test_bit(block + b, v->validated_blocks))) {
+			bio_advance_iter(bio, iter,
+					 1 << v->data_dev_block_bits);
+			continue;
+		}
+
 		if (likely(v->levels)) {
 			/*
 			 * First, we try to get the requested hash for
@@ -298,7 +419,7 @@ static int verity_verify_io(struct dm_verity_io *io)
 			 * function returns 0 and we fall back to whole
 			 * chain verification.
 			 */
-			int r = verity_verify_level(io, io->block + b, 0, true);
+			int r = verity_verify_level(io, block + b, 0, true);
 			if (likely(!r))
 				goto test_block_hash;
 			if (r < 0)
@@ -308,75 +429,153 @@ static int verity_verify_io(struct dm_verity_io *io)
 		memcpy(io_want_digest(v, io), v->root_digest, v->digest_size);
 
 		for (i = v->levels - 1; i >= 0; i--) {
-			int r = verity_verify_level(io, io->block + b, i, false);
+			int r = verity_verify_level(io, block + b, i, false);
 			if (unlikely(r))
 				return r;
 		}
 
 test_block_hash:
 		desc = io_hash_desc(v, io);
-		desc->tfm = v->tfm;
-		desc->flags = CRYPTO_TFM_REQ_MAY_SLEEP;
-		r = crypto_shash_init(desc);
-		if (r < 0) {
-			DMERR("crypto_shash_init failed: %d", r);
+		r = verity_hash_init(v, desc);
+		if (r < 0)
 			return r;
-		}
 
-		if (likely(v->version >= 1)) {
-			r = crypto_shash_update(desc, v->salt, v->salt_size);
-			if (r < 0) {
-				DMERR("crypto_shash_update failed: %d", r);
-				return r;
-			}
-		}
+		result = io_real_digest(v, io);
 		todo = 1 << v->data_dev_block_bits;
 		do {
 			u8 *page;
 			unsigned len;
-			struct bio_vec bv = bio_iter_iovec(bio, io->iter);
+			struct bio_vec bv = bio_iter_iovec(bio, *iter);
 
 			page = kmap_atomic(bv.bv_page);
 			len = bv.bv_len;
 			if (likely(len >= todo))
 				len = todo;
-			r = crypto_shash_update(desc, page + bv.bv_offset, len);
+			if (likely(len == todo))
+				r = verity_hash_final(v, desc,
+						      page + bv.bv_offset, len,
+						      result);
+			else {
+				r = crypto_shash_update(desc,
+						page + bv.bv_offset, len);
+				if (r < 0)
+					DMERR("crypto_shash_update failed: %d",
+					      r);
+			}
 			kunmap_atomic(page);
 
-			if (r < 0) {
-				DMERR("crypto_shash_update failed: %d", r);
+			if (r < 0)
 				return r;
-			}
 
-			bio_advance_iter(bio, &io->iter, len);
+			bio_advance_iter(bio, iter, len);
 			todo -= len;
 		} while (todo);
 
-		if (!v->version) {
-			r = crypto_shash_update(desc, v->salt, v->salt_size);
-			if (r < 0) {
-				DMERR("crypto_shash_update failed: %d", r);
-				return r;
-			}
-		}
-
-		result = io_real_digest(v, io);
-		r = crypto_shash_final(desc, result);
-		if (r < 0) {
-			DMERR("crypto_shash_final failed: %d", r);
-			return r;
-		}
 		if (unlikely(memcmp(result, io_want_digest(v, io), v->digest_size))) {
 			DMERR_LIMIT("data block %llu is corrupted",
-				(unsigned long long)(io->block + b));
+				(unsigned long long)(block + b));
 			v->hash_failed = 1;
 			return -EIO;
 		}
+
+		if (v->validated_blocks)
+			set_bit(block + b, v->validated_blocks);
 	}
 
 	return 0;
 }
 
+static void verity_chunk_work(struct work_struct *w)
+{
+	struct dm_verity_chunk *chunk =
+		container_of(w, struct dm_verity_chunk, work);
+
+	chunk->error = verity_verify_blocks(&chunk->io, chunk->bio,
+					    chunk->block, chunk->n_blocks,
+					    &chunk->iter);
+}
+
+/*
+ * Split a large io into chunks, verify the first one here and the others
+ * on chunk_wq. Chunks never wait for anything, so waiting for them from
+ * verify_wq cannot deadlock. Returns 1 if the io should be verified
+ * serially instead.
+ */
+static int verity_verify_parallel(struct dm_verity_io *io, struct bio *bio)
+{
+	struct dm_verity *v = io->v;
+	struct dm_verity_chunk *chunks, *chunk;
+	size_t chunk_size;
+	unsigned nr, per, first, c;
+	struct bvec_iter iter;
+	sector_t block;
+	int r;
+
+	nr = min_t(unsigned, num_online_cpus(),
+		   io->n_blocks / DM_VERITY_MIN_CHUNK_BLOCKS);
+	if (nr < 2)
+		return 1;
+
+	chunk_size = ALIGN(sizeof(struct dm_verity_chunk) + v->shash_descsize +
+			   v->digest_size * 2,
+			   __alignof__(struct dm_verity_chunk));
+	chunks = kmalloc(chunk_size * (nr - 1), GFP_NOIO | __GFP_NOWARN);
+	if (!chunks)
+		return 1;
+
+	per = io->n_blocks / nr;
+	first = io->n_blocks - per * (nr - 1);
+
+	iter = io->iter;
+	bio_advance_iter(bio, &iter, first << v->data_dev_block_bits);
+	block = io->block + first;
+	for (c = 0; c < nr - 1; c++) {
+		chunk = (void *)((u8 *)chunks + c * chunk_size);
+		INIT_WORK(&chunk->work, verity_chunk_work);
+		chunk->bio = bio;
+		chunk->block = block;
+		chunk->n_blocks = per;
+		chunk->iter = iter;
+		chunk->io.v = v;
+		queue_work(v->chunk_wq, &chunk->work);
+
+		bio_advance_iter(bio, &iter, per << v->data_dev_block_bits);
+		block += per;
+	}
+
+	r = verity_verify_blocks(io, bio, io->block, first, &io->iter);
+
+	for (c = 0; c < nr - 1; c++) {
+		chunk = (void *)((u8 *)chunks + c * chunk_size);
+		flush_work(&chunk->work);
+		if (!r)
+			r = chunk->error;
+	}
+
+	kfree(chunks);
+	return r;
+}
+
+/*
+ * Verify one "dm_verity_io" structure.
+ */
+static int verity_verify_io(struct dm_verity_io *io)
+{
+	struct dm_verity *v = io->v;
+	struct bio *bio = dm_bio_from_per_bio_data(io,
+						   v->ti->per_bio_data_size);
+	unsigned parallel = ACCESS_ONCE(dm_verity_parallel_blocks);
+
+	if (parallel && io->n_blocks >= parallel) {
+		int r = verity_verify_parallel(io, bio);
+		if (r <= 0)
+			return r;
+	}
+
+	return verity_verify_blocks(io, bio, io->block, io->n_blocks,
+				    &io->iter);
+}
+
 /*
  * End one "io" structure with a given error.
  */
@@ -411,6 +610,52 @@ static void verity_end_io(struct bio *bio, int error)
 	queue_work(io->v->verify_wq, &io->work);
 }
 
+/*
+ * Return the prefetch cluster in bytes, adapted to how well it worked for
+ * the last DM_VERITY_PREFETCH_SAMPLE lookups: double it when more than 1/8
+ * of the lookups had to read their hash block, halve it when less than
+ * a quarter of the blocks prefetched beyond the io were ever used.
+ *
+ * Prefetch work items run concurrently, a lost update only delays the
+ * adaptation by one sample.
+ */
+static unsigned verity_prefetch_cluster(struct dm_verity *v)
+{
+	unsigned base = ACCESS_ONCE(dm_verity_prefetch_cluster);
+	unsigned cluster = ACCESS_ONCE(v->prefetch_cluster);
+	unsigned lookups, misses, useful, extra;
+
+	if (unlikely(base != v->prefetch_base)) {
+		/* the module parameter was changed, start over from it */
+		v->prefetch_base = base;
+		v->prefetch_cluster = base;
+		atomic_set(&v->pf_lookups, 0);
+		atomic_set(&v->pf_misses, 0);
+		atomic_set(&v->pf_useful, 0);
+		atomic_set(&v->pf_extra, 0);
+		return base;
+	}
+
+	if (!base || atomic_read(&v->pf_lookups) < DM_VERITY_PREFETCH_SAMPLE)
+		return cluster;
+
+	lookups = atomic_xchg(&v->pf_lookups, 0);
+	misses = atomic_xchg(&v->pf_misses, 0);
+	useful = atomic_xchg(&v->pf_useful, 0);
+	extra = atomic_xchg(&v->pf_extra, 0);
+
+	if (misses * 8 > lookups) {
+		if (cluster < base << DM_VERITY_PREFETCH_MAX_SHIFT)
+			cluster <<= 1;
+	} else if (useful * 4 < extra) {
+		if (cluster > 1U << v->data_dev_block_bits)
+			cluster >>= 1;
+	}
+
+	v->prefetch_cluster = cluster;
+	return cluster;
+}
+
 /*
  * Prefetch buffers for the specified io.
  * The root buffer is not prefetched, it is assumed that it will be cached
@@ -429,7 +674,8 @@ static void verity_prefetch_io(struct work_struct *work)
 		verity_hash_at_level(v, pw->block, i, &hash_block_start, NULL);
 		verity_hash_at_level(v, pw->block + pw->n_blocks - 1, i, &hash_block_end, NULL);
 		if (!i) {
-			unsigned cluster = ACCESS_ONCE(dm_verity_prefetch_cluster);
+			unsigned cluster = verity_prefetch_cluster(v);
+			sector_t n_blocks = hash_block_end - hash_block_start + 1;
 
 			cluster >>= v->data_dev_block_bits;
 			if (unlikely(!cluster))
@@ -442,6 +688,9 @@ static void verity_prefetch_io(struct work_struct *work)
 			hash_block_end |= cluster - 1;
 			if (unlikely(hash_block_end >= v->hash_blocks))
 				hash_block_end = v->hash_blocks - 1;
+
+			atomic_add(hash_block_end - hash_block_start + 1 -
+				   n_blocks, &v->pf_extra);
 		}
 no_prefetch_cluster:
 		dm_bufio_prefetch(v->bufio, hash_block_start,
@@ -546,6 +795,13 @@ static void verity_status(struct dm_target *ti, status_type_t type,
 		else
 			for (x = 0; x < v->salt_size; x++)
 				DMEMIT("%02x", v->salt[x]);
+		x = (v->validated_blocks ? 1 : 0) + (v->pin_levels ? 2 : 0);
+		if (x)
+			DMEMIT(" %u", x);
+		if (v->validated_blocks)
+			DMEMIT(" " DM_VERITY_OPT_AT_MOST_ONCE);
+		if (v->pin_levels)
+			DMEMIT(" " DM_VERITY_OPT_PIN_LEVELS " %u", v->pin_levels);
 		break;
 	}
 }
@@ -600,19 +856,62 @@ static void verity_io_hints(struct dm_target *ti, struct queue_limits *limits)
 	blk_limits_io_min(limits, limits->logical_block_size);
 }
 
+/*
+ * Read the top "pin_levels" levels of the hash tree and keep the buffers
+ * held, so that dm-bufio never evicts them and reads never wait for them.
+ */
+static int verity_pin_levels(struct dm_verity *v)
+{
+	sector_t start = v->hash_level_block[v->levels - 1];
+	sector_t end;
+	sector_t block;
+
+	if (v->pin_levels < v->levels)
+		end = v->hash_level_block[v->levels - v->pin_levels - 1];
+	else
+		end = v->hash_blocks;
+
+	v->pinned = kcalloc(end - start, sizeof(struct dm_buffer *),
+			    GFP_KERNEL);
+	if (!v->pinned)
+		return -ENOMEM;
+
+	dm_bufio_prefetch(v->bufio, start, end - start);
+
+	for (block = start; block < end; block++) {
+		void *data = dm_bufio_read(v->bufio, block,
+					   &v->pinned[v->n_pinned]);
+		if (IS_ERR(data))
+			return PTR_ERR(data);
+		v->n_pinned++;
+	}
+
+	return 0;
+}
+
 static void verity_dtr(struct dm_target *ti)
 {
 	struct dm_verity *v = ti->private;
+	unsigned i;
 
 	if (v->verify_wq)
 		destroy_workqueue(v->verify_wq);
 
+	if (v->chunk_wq)
+		destroy_workqueue(v->chunk_wq);
+
 	if (v->vec_mempool)
 		mempool_destroy(v->vec_mempool);
 
+	for (i = 0; i < v->n_pinned; i++)
+		dm_bufio_release(v->pinned[i]);
+	kfree(v->pinned);
+
 	if (v->bufio)
 		dm_bufio_client_destroy(v->bufio);
 
+	vfree(v->validated_blocks);
+	kfree(v->initial_hashstate);
 	kfree(v->salt);
 	kfree(v->root_digest);
 
@@ -643,6 +942,13 @@ static void verity_dtr(struct dm_target *ti)
  *	<algorithm>
  *	<digest>
  *	<salt>		Hex string or "-" if no salt.
+ *
+ * Optional parameters, preceded by their count:
+ *	check_at_most_once	Verify each data block only the first time it
+ *				is read. Saves cpu at the cost of not
+ *				detecting later changes on the data device.
+ *	pin_hash_levels <n>	Read the top n levels of the hash tree when
+ *				the target is created and keep them in memory.
  */
 static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 {
@@ -653,6 +959,13 @@ static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 	int i;
 	sector_t hash_position;
 	char dummy;
+	struct dm_arg_set as;
+	const char *opt_string;
+	unsigned opt_params;
+	static struct dm_arg _args[] = {
+		{0, 3, "Invalid number of feature args"},
+		{1, DM_VERITY_MAX_LEVELS, "Invalid number of hash levels to pin"},
+	};
 
 	v = kzalloc(sizeof(struct dm_verity), GFP_KERNEL);
 	if (!v) {
@@ -668,8 +981,8 @@ static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 		goto bad;
 	}
 
-	if (argc != 10) {
-		ti->error = "Invalid argument count: exactly 10 arguments required";
+	if (argc < 10) {
+		ti->error = "Invalid argument count: at least 10 arguments required";
 		r = -EINVAL;
 		goto bad;
 	}
@@ -821,6 +1134,76 @@ static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 	}
 	v->hash_blocks = hash_position;
 
+	as.argc = argc - 10;
+	as.argv = argv + 10;
+	if (as.argc) {
+		r = dm_read_arg_group(_args, &as, &opt_params, &ti->error);
+		if (r)
+			goto bad;
+
+		while (opt_params--) {
+			opt_string = dm_shift_arg(&as);
+			if (!opt_string) {
+				ti->error = "Not enough feature arguments";
+				r = -EINVAL;
+				goto bad;
+			}
+
+			if (!strcasecmp(opt_string, DM_VERITY_OPT_AT_MOST_ONCE)) {
+				if (v->validated_blocks)
+					continue;
+				v->validated_blocks =
+					vzalloc(BITS_TO_LONGS(v->data_blocks) *
+						sizeof(unsigned long));
+				if (!v->validated_blocks) {
+					ti->error = "Cannot allocate bitset for check_at_most_once";
+					r = -ENOMEM;
+					goto bad;
+				}
+			} else if (!strcasecmp(opt_string, DM_VERITY_OPT_PIN_LEVELS) &&
+				   opt_params) {
+				opt_params--;
+				r = dm_read_arg(_args + 1, &as, &v->pin_levels,
+						&ti->error);
+				if (r)
+					goto bad;
+				if (v->pin_levels > v->levels)
+					v->pin_levels = v->levels;
+			} else {
+				ti->error = "Unrecognized verity feature request";
+				r = -EINVAL;
+				goto bad;
+			}
+		}
+	}
+
+	if (v->version >= 1) {
+		/*
+		 * Every version 1 hash starts with the salt. Hash it once
+		 * here; if the algorithm cannot export its state, each hash
+		 * simply starts from scratch.
+		 */
+		struct shash_desc *desc = kmalloc(v->shash_descsize, GFP_KERNEL);
+
+		v->initial_hashstate = kmalloc(crypto_shash_statesize(v->tfm),
+					       GFP_KERNEL);
+		if (!desc || !v->initial_hashstate) {
+			kfree(desc);
+			ti->error = "Cannot allocate initial hash state";
+			r = -ENOMEM;
+			goto bad;
+		}
+		desc->tfm = v->tfm;
+		desc->flags = CRYPTO_TFM_REQ_MAY_SLEEP;
+		if (crypto_shash_init(desc) ||
+		    crypto_shash_update(desc, v->salt, v->salt_size) ||
+		    crypto_shash_export(desc, v->initial_hashstate)) {
+			kfree(v->initial_hashstate);
+			v->initial_hashstate = NULL;
+		}
+		kfree(desc);
+	}
+
 	v->bufio = dm_bufio_client_create(v->hash_dev->bdev,
 		1 << v->hash_dev_block_bits, 1, sizeof(struct buffer_aux),
 		dm_bufio_alloc_callback, NULL);
@@ -837,6 +1220,14 @@ static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 		goto bad;
 	}
 
+	if (v->pin_levels) {
+		r = verity_pin_levels(v);
+		if (r) {
+			ti->error = "Cannot read hash levels to pin";
+			goto bad;
+		}
+	}
+
 	ti->per_bio_data_size = roundup(sizeof(struct dm_verity_io) + v->shash_descsize + v->digest_size * 2, __alignof__(struct dm_verity_io));
 
 	v->vec_mempool = mempool_create_kmalloc_pool(DM_VERITY_MEMPOOL_SIZE,
@@ -855,6 +1246,13 @@ static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 		goto bad;
 	}
 
+	v->chunk_wq = alloc_workqueue("kverityd_chunk", WQ_CPU_INTENSIVE | WQ_MEM_RECLAIM | WQ_UNBOUND, num_possible_cpus());
+	if (!v->chunk_wq) {
+		ti->error = "Cannot allocate chunk workqueue";
+		r = -ENOMEM;
+		goto bad;
+	}
+
 	return 0;
 
 bad:
@@ -865,7 +1263,7 @@ bad:
 
 static struct target_type verity_target = {
 	.name		= "verity",
-	.version	= {1, 2, 0},
+	.version	= {1, 4, 0},
 	.module		= THIS_MODULE,
 	.ctr		= verity_ctr,
 	.dtr		= verity_dtr,
@@ -4,6 +4,7 @@
 #include <linux/gpio.h>
 #endif
 #include <upmu_common.h>
+#include <mt_pmic_wrap.h>
 #include <linux/timer.h>
 #include <linux/of.h>
 #include <linux/of_irq.h>
@@ -281,12 +282,15 @@ static inline void headset_plug_out(void)
 static inline void enable_accdet(u32 state_swctrl)
 {
 	/*enable ACCDET unit*/
-	ACCDET_DEBUG("accdet: enable_accdet\n");
-	/*enable clock*/
-	pmic_pwrap_write(TOP_CKPDN_CLR, RG_ACCDET_CLK_CLR);
-	pmic_pwrap_write(ACCDET_STATE_SWCTRL, pmic_pwrap_read(ACCDET_STATE_SWCTRL) | state_swctrl);
-	pmic_pwrap_write(ACCDET_CTRL, pmic_pwrap_read(ACCDET_CTRL) | ACCDET_ENABLE);
+	struct pwrap_op ops[] = {
+		/*enable clock*/
+		PWRAP_WR(TOP_CKPDN_CLR, RG_ACCDET_CLK_CLR),
+		PWRAP_UPD(ACCDET_STATE_SWCTRL, state_swctrl, state_swctrl),
+		PWRAP_UPD(ACCDET_CTRL, ACCDET_ENABLE, ACCDET_ENABLE),
+	};
 
+	ACCDET_DEBUG("accdet: enable_accdet\n");
+	pwrap_batch(ops, ARRAY_SIZE(ops));
 }
 
 static inline void disable_accdet(void)
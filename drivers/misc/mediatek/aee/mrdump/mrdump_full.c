@@ -8,6 +8,8 @@
 #include <linux/elfcore.h>
 #include <linux/kallsyms.h>
 #include <linux/memblock.h>
+#include <linux/bitmap.h>
+#include <linux/bootmem.h>
 #include <linux/miscdevice.h>
 #include <mt-plat/mtk_ram_console.h>
 #include <linux/reboot.h>
@@ -42,6 +44,9 @@ static bool mrdump_enable = 1;
 static int mrdump_output_device;
 static int mrdump_output_fstype;
 static unsigned long mrdump_output_lbaooo;
+static bool mrdump_compress;
+static bool mrdump_skip_free;
+static unsigned long *mrdump_free_bitmap;
 
 static struct mrdump_control_block mrdump_cblock __attribute__((section (".mrdump")));
 
@@ -205,6 +210,93 @@ static void __mrdump_reboot_stop_all(struct mrdump_crash_record *crash_record, i
 #endif
 
 
+static int mrdump_free_bitmap_alloc(void)
+{
+	struct mrdump_dumpdesc *dumpdesc_p = &mrdump_cblock.dumpdesc;
+	unsigned long nr_pfn = max_pfn - PHYS_PFN_OFFSET;
+
+	if (mrdump_free_bitmap)
+		return 0;
+
+	/* lk reads it by physical address, so it has to be contiguous */
+	mrdump_free_bitmap = alloc_pages_exact(BITS_TO_LONGS(nr_pfn) * sizeof(long),
+					       GFP_KERNEL | __GFP_ZERO);
+	if (!mrdump_free_bitmap) {
+		pr_err("MT-RAMDUMP: no memory for the free page bitmap\n");
+		return -ENOMEM;
+	}
+
+	dumpdesc_p->free_bitmap_pa = virt_to_phys(mrdump_free_bitmap);
+	dumpdesc_p->free_start_pfn = PHYS_PFN_OFFSET;
+	dumpdesc_p->free_nr_pfn = nr_pfn;
+	return 0;
+}
+
+static void mrdump_set_options(void)
+{
+	uint32_t options = 0;
+
+	if (mrdump_compress)
+		options |= MRDUMP_OPT_COMPRESS | MRDUMP_OPT_SKIP_ZERO;
+	if (mrdump_skip_free && mrdump_free_bitmap)
+		options |= MRDUMP_OPT_SKIP_FREE;
+	mrdump_cblock.dumpdesc.dump_options = options;
+	__inner_flush_dcache_all();
+}
+
+static void mrdump_mark_range(unsigned long pfn, unsigned long nr)
+{
+	unsigned long start = mrdump_cblock.dumpdesc.free_start_pfn;
+	unsigned long end = start + mrdump_cblock.dumpdesc.free_nr_pfn;
+
+	if (pfn < start || pfn + nr > end)
+		return;
+	bitmap_set(mrdump_free_bitmap, pfn - start, nr);
+}
+
+/*
+ * Called with the other cpus stopped, so no zone lock: one of them may
+ * have been stopped in the middle of a list update, hence the checks on
+ * every page and the bound on each walk.
+ */
+static void mrdump_mark_free_pages(void)
+{
+	struct zone *zone;
+	struct page *page;
+	unsigned int order, t;
+	unsigned long budget;
+	int cpu;
+
+	memset(mrdump_free_bitmap, 0,
+	       BITS_TO_LONGS(mrdump_cblock.dumpdesc.free_nr_pfn) * sizeof(long));
+
+	for_each_populated_zone(zone) {
+		budget = zone->managed_pages;
+
+		for (order = 0; order < MAX_ORDER; order++) {
+			for (t = 0; t < MIGRATE_TYPES; t++) {
+				list_for_each_entry(page, &zone->free_area[order].free_list[t], lru) {
+					if (!budget-- || !PageBuddy(page) || page_private(page) != order)
+						break;
+					mrdump_mark_range(page_to_pfn(page), 1UL << order);
+				}
+			}
+		}
+
+		for_each_online_cpu(cpu) {
+			struct per_cpu_pages *pcp = &per_cpu_ptr(zone->pageset, cpu)->pcp;
+
+			for (t = 0; t < MIGRATE_PCPTYPES; t++) {
+				list_for_each_entry(page, &pcp->lists[t], lru) {
+					if (!budget--)
+						break;
+					mrdump_mark_range(page_to_pfn(page), 1);
+				}
+			}
+		}
+	}
+}
+
 static void __mrdump_reboot_va(AEE_REBOOT_MODE reboot_mode, struct pt_regs *regs, const char *msg, va_list ap)
 {
 	struct mrdump_crash_record *crash_record;
@@ -232,6 +324,9 @@ static void __mrdump_reboot_va(AEE_REBOOT_MODE reboot_mode, struct pt_regs *regs
 	crash_record->fault_cpu = cpu;
 	save_current_task();
 
+	if (mrdump_cblock.dumpdesc.dump_options & MRDUMP_OPT_SKIP_FREE)
+		mrdump_mark_free_pages();
+
 	/* FIXME: Check reboot_mode is valid */
 	crash_record->reboot_mode = reboot_mode;
 	__inner_flush_dcache_all();
@@ -379,6 +474,10 @@ int __init mrdump_platform_init(const struct mrdump_platform *plat)
 	machdesc_p->phys_offset = (uint64_t)PHYS_OFFSET;
 	machdesc_p->master_page_table = (uintptr_t)&swapper_pg_dir;
 
+	if (mrdump_skip_free)
+		mrdump_free_bitmap_alloc();
+	mrdump_set_options();
+
 	/* Allocate memory for saving cpu registers. */
 	crash_notes = alloc_percpu(note_buf_t);
 	if (!crash_notes) {
@@ -516,6 +615,27 @@ static int param_set_mrdump_lbaooo(const char *val, const struct kernel_param *k
 	return retval;
 }
 
+/* before mrdump_platform_init() only the value is taken, it applies it */
+static int param_set_mrdump_compress(const char *val, const struct kernel_param *kp)
+{
+	int retval = param_set_bool(val, kp);
+
+	if ((retval == 0) && (mrdump_plat != NULL))
+		mrdump_set_options();
+	return retval;
+}
+
+static int param_set_mrdump_skip_free(const char *val, const struct kernel_param *kp)
+{
+	int retval = param_set_bool(val, kp);
+
+	if ((retval == 0) && (mrdump_plat != NULL)) {
+		if (mrdump_skip_free)
+			retval = mrdump_free_bitmap_alloc();
+		mrdump_set_options();
+	}
+	return retval;
+}
 
 module_param_string(lk, mrdump_lk, sizeof(mrdump_lk), S_IRUGO);
 
@@ -558,6 +678,24 @@ param_check_int(device, &mrdump_output_device);
 module_param_cb(device, &param_ops_mrdump_device, &mrdump_output_device, S_IRUGO | S_IWUSR);
 __MODULE_PARM_TYPE(device, int);
 
+/* sys/modules/mrdump/parameter/compress */
+struct kernel_param_ops param_ops_mrdump_compress = {
+	.set = param_set_mrdump_compress,
+	.get = param_get_bool,
+};
+param_check_bool(compress, &mrdump_compress);
+module_param_cb(compress, &param_ops_mrdump_compress, &mrdump_compress, S_IRUGO | S_IWUSR);
+__MODULE_PARM_TYPE(compress, bool);
+
+/* sys/modules/mrdump/parameter/skip_free */
+struct kernel_param_ops param_ops_mrdump_skip_free = {
+	.set = param_set_mrdump_skip_free,
+	.get = param_get_bool,
+};
+param_check_bool(skip_free, &mrdump_skip_free);
+module_param_cb(skip_free, &param_ops_mrdump_skip_free, &mrdump_skip_free, S_IRUGO | S_IWUSR);
+__MODULE_PARM_TYPE(skip_free, bool);
+
 MODULE_LICENSE("GPL");
 MODULE_DESCRIPTION("MediaTek MRDUMP module");
 MODULE_AUTHOR("MediaTek Inc.");
@@ -54,6 +54,27 @@ static struct class *almk_class;
 static spinlock_t almk_lock;
 static int almk_status;
 
+/*
+ * Camera HAL asks for the safe size of the same few pids on every capture
+ * request. The LMK watermark of a pid only moves when its adj or the LMK
+ * state changes, so keep it for a short while: entries are dropped when
+ * LMK kills something, and otherwise expire after ALMK_CACHE_TTL so adj
+ * changes are picked up too.
+ */
+#define ALMK_CACHE_SIZE 8
+#define ALMK_CACHE_TTL (HZ / 10)
+
+struct almk_cache_entry {
+	pid_t pid;
+	unsigned int kill_gen;
+	unsigned long stamp;
+	unsigned int low_bound_pages;
+	unsigned int lmk_pages;
+};
+
+static struct almk_cache_entry almk_cache[ALMK_CACHE_SIZE];
+static unsigned int almk_cache_next;
+
 
 
 
@@ -85,6 +106,60 @@ static int check_all_minfree(void *param, void *param2)
 }
 #endif
 
+/* Look up the cached watermarks of @pid, returns false on a miss */
+static bool almk_cache_lookup(pid_t pid, unsigned int *low_bound_pages,
+			      unsigned int *lmk_pages)
+{
+	unsigned int kill_gen = lowmem_kill_generation();
+	bool hit = false;
+	int i;
+
+	spin_lock(&almk_lock);
+	for (i = 0; i < ALMK_CACHE_SIZE; i++) {
+		struct almk_cache_entry *e = &almk_cache[i];
+
+		if (e->pid != pid || !e->stamp)
+			continue;
+
+		if (e->kill_gen == kill_gen &&
+		    time_before(jiffies, e->stamp + ALMK_CACHE_TTL)) {
+			*low_bound_pages = e->low_bound_pages;
+			*lmk_pages = e->lmk_pages;
+			hit = true;
+		}
+		break;
+	}
+	spin_unlock(&almk_lock);
+
+	return hit;
+}
+
+static void almk_cache_store(pid_t pid, unsigned int kill_gen,
+			     unsigned int low_bound_pages, unsigned int lmk_pages)
+{
+	struct almk_cache_entry *e = NULL;
+	int i;
+
+	spin_lock(&almk_lock);
+	for (i = 0; i < ALMK_CACHE_SIZE; i++) {
+		if (almk_cache[i].pid == pid) {
+			e = &almk_cache[i];
+			break;
+		}
+	}
+	if (!e) {
+		e = &almk_cache[almk_cache_next];
+		almk_cache_next = (almk_cache_next + 1) % ALMK_CACHE_SIZE;
+	}
+
+	e->pid = pid;
+	e->kill_gen = kill_gen;
+	e->stamp = jiffies ? jiffies : 1;
+	e->low_bound_pages = low_bound_pages;
+	e->lmk_pages = lmk_pages;
+	spin_unlock(&almk_lock);
+}
+
 static unsigned int get_max_safe_size(pid_t pid)
 {
 
@@ -92,12 +167,20 @@ static unsigned int get_max_safe_size(pid_t pid)
 
 	unsigned int lmk_pages;
 
-	unsigned int lowBoundPages = get_min_free_pages(pid);
+	unsigned int lowBoundPages;
 
 	unsigned int max_safe_size;
 
-	lmk_pages = query_lmk_minfree(0);
+	if (!almk_cache_lookup(pid, &lowBoundPages, &lmk_pages)) {
+		/* sample the generation first so a racing kill invalidates us */
+		unsigned int kill_gen = lowmem_kill_generation();
+
+		lowBoundPages = get_min_free_pages(pid);
+		lmk_pages = query_lmk_minfree(0);
+		almk_cache_store(pid, kill_gen, lowBoundPages, lmk_pages);
+	}
 
+	/* vmstat counters: plain atomic reads, no need to cache these */
 
 	all_free_pages = global_page_state(NR_FREE_PAGES) +
 	    global_page_state(NR_FILE_PAGES) + global_page_state(NR_FILE_DIRTY);
@@ -14,6 +14,7 @@ typedef struct {
 	extern int get_min_free_pages(pid_t pid);
 	extern int get_min_free_pages(pid_t pid);
 	extern int query_lmk_minfree(int index);
+	extern unsigned int lowmem_kill_generation(void);
 
 #define ALMK_IOCTL_MAGIC        'x'
 
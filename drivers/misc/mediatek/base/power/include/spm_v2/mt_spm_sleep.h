@@ -26,6 +26,7 @@ extern void spm_output_sleep_option(void);
 /* record last wakesta */
 extern u32 spm_get_last_wakeup_src(void);
 extern u32 spm_get_last_wakeup_misc(void);
+extern ssize_t spm_get_suspend_timeline(char *buf);
 extern u32 spm_get_register(void __force __iomem *offset);
 extern void spm_set_register(void __force __iomem *offset, u32 value);
 #endif
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2015 MediaTek Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Suspend and resume MediaTek platform devices asynchronously.
+ *
+ * Every platform device bound from a "mediatek," node is switched to async
+ * PM, so msdc, audio and the display blocks no longer resume one after the
+ * other.  The PM core already orders a device after its parent; the
+ * dependencies it cannot see are listed in mt_pm_deps[] and passed to it
+ * with device_pm_add_link().  /sys/power/pm_async turns it all off.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/device.h>
+#include <linux/notifier.h>
+#include <linux/of.h>
+#include <linux/of_platform.h>
+#include <linux/platform_device.h>
+#include <linux/pm.h>
+
+#define MT_PM_ASYNC_PREFIX	"mediatek,"
+
+struct mt_pm_dep {
+	const char *consumer;
+	const char *supplier;
+};
+
+static const struct mt_pm_dep mt_pm_deps[] = {
+	/* primary_display_resume() drives the display engine */
+	{ "mediatek,mtkfb", "mediatek,dispsys" },
+};
+
+static bool mt_pm_async_node(struct device_node *np)
+{
+	struct property *prop;
+	const char *compat;
+
+	of_property_for_each_string(np, "compatible", prop, compat) {
+		if (!strncmp(compat, MT_PM_ASYNC_PREFIX, strlen(MT_PM_ASYNC_PREFIX)))
+			return true;
+	}
+	return false;
+}
+
+/* bound platform device of the first @compat node, with a reference held */
+static struct device *mt_pm_find_dev(const char *compat)
+{
+	struct device_node *np;
+	struct platform_device *pdev;
+
+	np = of_find_compatible_node(NULL, NULL, compat);
+	if (!np)
+		return NULL;
+	pdev = of_find_device_by_node(np);
+	of_node_put(np);
+	if (!pdev)
+		return NULL;
+	if (!pdev->dev.driver) {
+		put_device(&pdev->dev);
+		return NULL;
+	}
+	return &pdev->dev;
+}
+
+/* whichever end binds last adds the link */
+static void mt_pm_link(struct device *dev)
+{
+	const struct mt_pm_dep *dep;
+	struct device *other;
+	int ret;
+
+	for (dep = mt_pm_deps; dep < mt_pm_deps + ARRAY_SIZE(mt_pm_deps); dep++) {
+		if (of_device_is_compatible(dev->of_node, dep->consumer)) {
+			other = mt_pm_find_dev(dep->supplier);
+			if (!other)
+				continue;
+			ret = device_pm_add_link(dev, other);
+		} else if (of_device_is_compatible(dev->of_node, dep->supplier)) {
+			other = mt_pm_find_dev(dep->consumer);
+			if (!other)
+				continue;
+			ret = device_pm_add_link(other, dev);
+		} else {
+			continue;
+		}
+
+		if (ret)
+			pr_err("[PM_ASYNC] link %s - %s failed %d\n",
+			       dep->consumer, dep->supplier, ret);
+		put_device(other);
+	}
+}
+
+static int mt_pm_async_notify(struct notifier_block *nb, unsigned long action,
+			      void *data)
+{
+	struct device *dev = data;
+
+	if (action != BUS_NOTIFY_BOUND_DRIVER || !dev->of_node)
+		return NOTIFY_DONE;
+
+	if (!mt_pm_async_node(dev->of_node))
+		return NOTIFY_DONE;
+
+	device_enable_async_suspend(dev);
+	mt_pm_link(dev);
+
+	return NOTIFY_OK;
+}
+
+static struct notifier_block mt_pm_async_nb = {
+	.notifier_call = mt_pm_async_notify,
+};
+
+/* before of_platform_populate(), so that no device is bound yet */
+static int __init mt_pm_async_init(void)
+{
+	return bus_register_notifier(&platform_bus_type, &mt_pm_async_nb);
+}
+core_initcall(mt_pm_async_init);
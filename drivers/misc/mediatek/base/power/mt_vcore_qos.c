@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2015 MediaTek Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Vcore/DRAM QoS: one kicker on vcore dvfs, driven by the bandwidth and
+ * latency contracts of its clients.  /sys/kernel/debug/vcore_qos/ holds
+ * the thresholds and a dump of the requests.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/mutex.h>
+#include <linux/workqueue.h>
+#include <linux/jiffies.h>
+
+#include <mt_vcore_dvfs.h>
+#include "mt_vcore_qos.h"
+
+#define TAG	"[VCORE_QOS] "
+
+/* sum of bandwidths from which the low power OPP is not enough, MB/s */
+static u32 vcore_qos_hpm_bw = 1500;
+/* a latency contract under this cannot wait for an LPM -> HPM switch, us */
+static u32 vcore_qos_switch_us = 500;
+/* time at the performance OPP after the last client needing it, ms */
+static u32 vcore_qos_lpm_delay_ms = 50;
+
+static LIST_HEAD(vcore_qos_list);
+static DEFINE_MUTEX(vcore_qos_lock);
+static bool vcore_qos_hpm;
+static unsigned int vcore_qos_switches;
+
+static void vcore_qos_drop_work(struct work_struct *work);
+static DECLARE_DELAYED_WORK(vcore_qos_drop, vcore_qos_drop_work);
+
+static bool vcore_qos_need_hpm(void)
+{
+	struct vcore_qos_request *req;
+	u32 bw = 0, lat = VCORE_QOS_LAT_ANY;
+
+	list_for_each_entry(req, &vcore_qos_list, node) {
+		bw += req->bw_mbps;
+		lat = min(lat, req->lat_us);
+	}
+
+	return bw >= vcore_qos_hpm_bw || lat < vcore_qos_switch_us;
+}
+
+/* called with vcore_qos_lock held */
+static int vcore_qos_apply(void)
+{
+	int ret;
+
+	if (!vcore_qos_need_hpm()) {
+		if (vcore_qos_hpm)
+			mod_delayed_work(system_freezable_wq, &vcore_qos_drop,
+					 msecs_to_jiffies(vcore_qos_lpm_delay_ms));
+		return 0;
+	}
+
+	/* the drop work rechecks under the lock, no need to wait for it */
+	cancel_delayed_work(&vcore_qos_drop);
+	if (vcore_qos_hpm)
+		return 0;
+
+	ret = vcorefs_request_dvfs_opp(KIR_EMIBW, OPPI_PERF);
+	if (ret) {
+		pr_err(TAG"request HPM failed %d\n", ret);
+		return ret;
+	}
+	vcore_qos_hpm = true;
+	vcore_qos_switches++;
+	return 0;
+}
+
+static void vcore_qos_drop_work(struct work_struct *work)
+{
+	int ret;
+
+	mutex_lock(&vcore_qos_lock);
+	if (vcore_qos_hpm && !vcore_qos_need_hpm()) {
+		ret = vcorefs_request_dvfs_opp(KIR_EMIBW, OPPI_UNREQ);
+		if (!ret) {
+			vcore_qos_hpm = false;
+			vcore_qos_switches++;
+		} else {
+			pr_err(TAG"release HPM failed %d\n", ret);
+		}
+	}
+	mutex_unlock(&vcore_qos_lock);
+}
+
+int vcore_qos_update_request(struct vcore_qos_request *req, u32 bw_mbps,
+			     u32 lat_us)
+{
+	int ret;
+
+	mutex_lock(&vcore_qos_lock);
+	req->bw_mbps = bw_mbps;
+	req->lat_us = lat_us;
+	if (list_empty(&req->node))
+		list_add_tail(&req->node, &vcore_qos_list);
+	ret = vcore_qos_apply();
+	mutex_unlock(&vcore_qos_lock);
+
+	return ret;
+}
+EXPORT_SYMBOL(vcore_qos_update_request);
+
+void vcore_qos_remove_request(struct vcore_qos_request *req)
+{
+	mutex_lock(&vcore_qos_lock);
+	list_del_init(&req->node);
+	vcore_qos_apply();
+	mutex_unlock(&vcore_qos_lock);
+}
+EXPORT_SYMBOL(vcore_qos_remove_request);
+
+static int vcore_qos_show(struct seq_file *m, void *v)
+{
+	struct vcore_qos_request *req;
+	u32 bw = 0, lat = VCORE_QOS_LAT_ANY;
+
+	mutex_lock(&vcore_qos_lock);
+	seq_printf(m, "%-16s %10s %10s\n", "client", "bw(MB/s)", "lat(us)");
+	list_for_each_entry(req, &vcore_qos_list, node) {
+		bw += req->bw_mbps;
+		lat = min(lat, req->lat_us);
+		if (req->lat_us == VCORE_QOS_LAT_ANY)
+			seq_printf(m, "%-16s %10u %10s\n", req->name, req->bw_mbps, "-");
+		else
+			seq_printf(m, "%-16s %10u %10u\n", req->name, req->bw_mbps,
+				   req->lat_us);
+	}
+	if (lat == VCORE_QOS_LAT_ANY)
+		seq_printf(m, "%-16s %10u %10s\n", "total", bw, "-");
+	else
+		seq_printf(m, "%-16s %10u %10u\n", "total", bw, lat);
+	seq_printf(m, "opp: %s (%s), switches: %u\n",
+		   vcore_qos_hpm ? "HPM" : "LPM",
+		   delayed_work_pending(&vcore_qos_drop) ? "dropping" : "steady",
+		   vcore_qos_switches);
+	mutex_unlock(&vcore_qos_lock);
+
+	return 0;
+}
+
+static int vcore_qos_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, vcore_qos_show, NULL);
+}
+
+static const struct file_operations vcore_qos_fops = {
+	.open = vcore_qos_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init vcore_qos_init(void)
+{
+	struct dentry *dir;
+
+	dir = debugfs_create_dir("vcore_qos", NULL);
+	if (!dir)
+		return 0;
+
+	debugfs_create_file("requests", 0444, dir, NULL, &vcore_qos_fops);
+	debugfs_create_u32("hpm_bw", 0644, dir, &vcore_qos_hpm_bw);
+	debugfs_create_u32("switch_us", 0644, dir, &vcore_qos_switch_us);
+	debugfs_create_u32("lpm_delay_ms", 0644, dir, &vcore_qos_lpm_delay_ms);
+
+	return 0;
+}
+late_initcall(vcore_qos_init);
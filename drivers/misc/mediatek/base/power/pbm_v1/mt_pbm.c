@@ -8,6 +8,7 @@
 #include <linux/kthread.h>
 #include <linux/atomic.h>
 #include <linux/mutex.h>
+#include <linux/seqlock.h>
 #include <linux/delay.h>
 #include <linux/string.h>
 #include <linux/sysfs.h>
@@ -186,8 +187,23 @@ static int md3_pa_pwr[SECTION_NUM+1] = { GUARDING_PATTERN,
 int g_dlpt_need_do = 1;
 static DEFINE_MUTEX(pbm_mutex);
 static DEFINE_MUTEX(pbm_table_lock);
+static DEFINE_MUTEX(pbm_limit_lock);	/* serializes the PPM/GPU limit calls */
 static struct task_struct *pbm_thread;
 static atomic_t kthread_nreq = ATOMIC_INIT(0);
+
+/*
+ * CPU/GPU limits precomputed by the kthread for each MD1 on/off and flash
+ * on/off state, so that the MD and flash kickers apply the new limits
+ * themselves instead of waiting for a full budget evaluation.
+ */
+struct pbm_budget {
+	int tocpu;
+	int togpu;	/* 0: GPU limit left as it is */
+};
+
+static struct pbm_budget pbm_budget_table[2][2];	/* [switch_md1][switch_flash] */
+static bool pbm_budget_valid;
+static seqcount_t pbm_budget_seq = SEQCNT_ZERO(pbm_budget_seq);
 /* extern u32 get_devinfo_with_index(u32 index); */
 
 /*
@@ -709,31 +725,12 @@ unsigned long hpf_get_power_md3(void)
 	return hpfmgr->loading_md3;
 }
 
-static void pbm_allocate_budget_manager(void)
+static void pbm_split_budget(int _dlpt, int cpu, int gpu, int cpu_lower_bound,
+			     struct pbm_budget *budget)
 {
-	int _dlpt = 0, leakage = 0, md1 = 0, md3 = 0, dlpt = 0, cpu = 0, gpu = 0, flash = 0;
 	int tocpu = 0, togpu = 0;
 	int multiple = 0;
-	int cpu_lower_bound = tscpu_get_min_cpu_pwr();
-
-	mutex_lock(&pbm_table_lock);
-	/* dump_kicker_info(); */
-	leakage = hpf_get_power_leakage();
-	md1 = hpf_get_power_md1();
-	md3 = hpf_get_power_md3();
-	dlpt = hpf_get_power_dlpt();
-	cpu = hpf_get_power_cpu();
-	gpu = hpf_get_power_gpu();
-	flash = hpf_get_power_flash();
-	mutex_unlock(&pbm_table_lock);
 
-	/* no any resource can allocate */
-	if (dlpt == 0) {
-		pbm_debug("DLPT=0\n");
-		return;
-	}
-
-	_dlpt = dlpt - (leakage + md1 + md3 + flash);
 	if (_dlpt < 0)
 		_dlpt = 0;
 
@@ -747,8 +744,6 @@ static void pbm_allocate_budget_manager(void)
 
 		if (tocpu <= 0)
 			tocpu = 1;
-
-		mt_ppm_dlpt_set_limit_by_pbm(tocpu);
 	} else {
 		multiple = (_dlpt * 1000) / (cpu + gpu);
 
@@ -770,21 +765,111 @@ static void pbm_allocate_budget_manager(void)
 			tocpu = 1;
 		if (togpu <= 0)
 			togpu = 1;
+	}
+
+	budget->tocpu = tocpu;
+	budget->togpu = togpu;
+}
+
+static void pbm_apply_budget(const struct pbm_budget *budget)
+{
+	mutex_lock(&pbm_limit_lock);
+	mt_ppm_dlpt_set_limit_by_pbm(budget->tocpu);
+	if (budget->togpu)
+		mt_gpufreq_set_power_limit_by_pbm(budget->togpu);
+	mutex_unlock(&pbm_limit_lock);
+}
+
+static void pbm_allocate_budget_manager(void)
+{
+	struct hpf *hpfmgr = &hpf_ctrl;
+	struct pbm_budget table[2][2];
+	struct pbm_budget *budget;
+	int leakage = 0, md1 = 0, md1_on = 0, md3 = 0, dlpt = 0, cpu = 0, gpu = 0, flash = 0;
+	int base, md1_state, flash_state;
+	int cpu_lower_bound = tscpu_get_min_cpu_pwr();
 
-		mt_ppm_dlpt_set_limit_by_pbm(tocpu);
-		mt_gpufreq_set_power_limit_by_pbm(togpu);
+	mutex_lock(&pbm_table_lock);
+	/* dump_kicker_info(); */
+	leakage = hpf_get_power_leakage();
+	md1 = hpf_get_power_md1();
+	md3 = hpf_get_power_md3();
+	dlpt = hpf_get_power_dlpt();
+	cpu = hpf_get_power_cpu();
+	gpu = hpf_get_power_gpu();
+	flash = hpf_get_power_flash();
+	md1_state = hpfmgr->switch_md1 ? 1 : 0;
+	flash_state = hpfmgr->switch_flash ? 1 : 0;
+	mutex_unlock(&pbm_table_lock);
+
+	/* no any resource can allocate */
+	if (dlpt == 0) {
+		pbm_debug("DLPT=0\n");
+		return;
 	}
 
+	/* MD1 off -> on is not measured yet, assume its maximum */
+	md1_on = md1_state ? md1 : MD1_MAX_PW;
+	base = dlpt - (leakage + md3);
+
+	pbm_split_budget(base, cpu, gpu, cpu_lower_bound, &table[0][0]);
+	pbm_split_budget(base - hpfmgr->loading_flash, cpu, gpu, cpu_lower_bound, &table[0][1]);
+	pbm_split_budget(base - md1_on, cpu, gpu, cpu_lower_bound, &table[1][0]);
+	pbm_split_budget(base - md1_on - hpfmgr->loading_flash, cpu, gpu, cpu_lower_bound,
+			 &table[1][1]);
+
+	/* writers are serialized by pbm_mutex */
+	write_seqcount_begin(&pbm_budget_seq);
+	memcpy(pbm_budget_table, table, sizeof(table));
+	pbm_budget_valid = true;
+	write_seqcount_end(&pbm_budget_seq);
+
+	budget = &table[md1_state][flash_state];
+	pbm_apply_budget(budget);
+
 	if (mt_pbm_debug) {
-		pbm_debug("(C/G)=%d,%d => (D/L/M1/M3/F/C/G)=%d,%d,%d,%d,%d,%d,%d (Multi:%d),%d\n",
-			 cpu, gpu, dlpt, leakage, md1, md3, flash, tocpu, togpu, multiple, cpu_lower_bound);
+		pbm_debug("(C/G)=%d,%d => (D/L/M1/M3/F/C/G)=%d,%d,%d,%d,%d,%d,%d,%d\n",
+			 cpu, gpu, dlpt, leakage, md1, md3, flash, budget->tocpu, budget->togpu,
+			 cpu_lower_bound);
 	} else {
-		if ((cpu > tocpu) || (gpu > togpu))
-			pbm_crit("(C/G)=%d,%d => (D/L/M1/M3/F/C/G)=%d,%d,%d,%d,%d,%d,%d (Multi:%d),%d\n",
-				 cpu, gpu, dlpt, leakage, md1, md3, flash, tocpu, togpu, multiple, cpu_lower_bound);
+		if ((cpu > budget->tocpu) || (gpu > budget->togpu))
+			pbm_crit("(C/G)=%d,%d => (D/L/M1/M3/F/C/G)=%d,%d,%d,%d,%d,%d,%d,%d\n",
+				 cpu, gpu, dlpt, leakage, md1, md3, flash, budget->tocpu,
+				 budget->togpu, cpu_lower_bound);
 	}
 }
 
+/*
+ * Apply the precomputed limits of the current MD1/flash state right away.
+ * The kthread still runs afterwards and refines them with fresh leakage and
+ * MD readings.
+ */
+static void pbm_apply_budget_table(void)
+{
+	struct hpf *hpfmgr = &hpf_ctrl;
+	struct pbm_budget budget;
+	unsigned int seq;
+	bool valid;
+	int md1_state = hpfmgr->switch_md1 ? 1 : 0;
+	int flash_state = hpfmgr->switch_flash ? 1 : 0;
+
+	if (!g_dlpt_need_do || g_dlpt_stop)
+		return;
+
+	do {
+		seq = read_seqcount_begin(&pbm_budget_seq);
+		valid = pbm_budget_valid;
+		budget = pbm_budget_table[md1_state][flash_state];
+	} while (read_seqcount_retry(&pbm_budget_seq, seq));
+
+	if (!valid)
+		return;
+
+	pbm_apply_budget(&budget);
+	pbm_debug("fast path (M1/F)=%d,%d => (C/G)=%d,%d\n",
+		  md1_state, flash_state, budget.tocpu, budget.togpu);
+}
+
 static bool pbm_func_enable_check(void)
 {
 	struct pbm *pwrctrl = &pbm_ctrl;
@@ -856,15 +941,9 @@ static bool pbm_update_table_info(enum pbm_kicker kicker, struct mrp *mrpmgr)
 
 static void pbm_wake_up_thread(enum pbm_kicker kicker, struct mrp *mrpmgr)
 {
-	if (atomic_read(&kthread_nreq) <= 0) {
-		atomic_inc(&kthread_nreq);
+	/* a request made while the thread runs makes it run once more */
+	if (atomic_xchg(&kthread_nreq, 1) <= 0)
 		wake_up_process(pbm_thread);
-	}
-
-	while (kicker == KR_FLASH && mrpmgr->switch_flash == 1) {
-		if (atomic_read(&kthread_nreq) == 0)
-			return;
-	}
 }
 
 static void mtk_power_budget_manager(enum pbm_kicker kicker, struct mrp *mrpmgr)
@@ -882,6 +961,10 @@ static void mtk_power_budget_manager(enum pbm_kicker kicker, struct mrp *mrpmgr)
 	if (!pbm_enable)
 		return;
 
+	/* flash and MD on/off must be covered before the current changes */
+	if (kicker == KR_FLASH || kicker == KR_MD1)
+		pbm_apply_budget_table();
+
 	pbm_wake_up_thread(kicker, mrpmgr);
 }
 
@@ -984,10 +1067,11 @@ static int pbm_thread_handle(void *data)
 		if (kthread_should_stop())
 			break;
 
-		if (atomic_read(&kthread_nreq) <= 0) {
+		if (atomic_xchg(&kthread_nreq, 0) <= 0) {
 			schedule();
 			continue;
 		}
+		__set_current_state(TASK_RUNNING);
 
 		mutex_lock(&pbm_mutex);
 		if (g_dlpt_need_do == 1) {
@@ -998,14 +1082,15 @@ static int pbm_thread_handle(void *data)
 				pbm_err("DISABLE PBM\n");
 
 				if (g_dlpt_state_sync == 0) {
+					mutex_lock(&pbm_limit_lock);
 					mt_ppm_dlpt_set_limit_by_pbm(0);
 					mt_gpufreq_set_power_limit_by_pbm(0);
+					mutex_unlock(&pbm_limit_lock);
 					g_dlpt_state_sync = 1;
 					pbm_err("Release DLPT limit\n");
 				}
 			}
 		}
-		atomic_dec(&kthread_nreq);
 		mutex_unlock(&pbm_mutex);
 	}
 
@@ -144,6 +144,7 @@ enum ppm_policy {
 	PPM_POLICY_USER_LIMIT,
 	PPM_POLICY_LCM_OFF,
 	PPM_POLICY_PERF_SERV,
+	PPM_POLICY_PREDICT,
 	PPM_POLICY_HICA,
 
 	NR_PPM_POLICIES,
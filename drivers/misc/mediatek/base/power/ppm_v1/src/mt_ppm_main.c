@@ -287,6 +287,7 @@ static void ppm_main_update_limit(struct ppm_policy_data *p,
 	case PPM_POLICY_PWR_THRO:
 	case PPM_POLICY_THERMAL:
 	case PPM_POLICY_PERF_SERV:
+	case PPM_POLICY_PREDICT:
 	case PPM_POLICY_USER_LIMIT:
 		/* out of range! use policy's min/max cpufreq idx setting */
 		if (c_limit->min_cpufreq_idx <  p_limit->max_cpufreq_idx ||
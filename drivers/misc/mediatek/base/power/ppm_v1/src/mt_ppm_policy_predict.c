@@ -0,0 +1,336 @@
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/jiffies.h>
+#include <linux/math64.h>
+#include <linux/workqueue.h>
+
+#include <mt-plat/mt_sched.h>
+#include "mt_ppm_internal.h"
+
+/*
+ * Predictive core online
+ *
+ * Bringing a core online costs several ms, which a frame workload pays at
+ * the start of every burst when hotplug reacts to the load.  This policy
+ * samples the runqueue history from sched_avg and, once bursts of more
+ * than one core's worth of runnable tasks recur with a stable period (a
+ * frame loop), holds the burst peak as min core so the cores stay online
+ * and only go to idle between bursts.  The hold is dropped PREDICT_HOLD_MS
+ * after the last periodic burst.
+ */
+
+#define PREDICT_HIST_SIZE		4
+#define PREDICT_SAMPLE_MS		8
+#define PREDICT_HOLD_MS			500
+#define PREDICT_BURST_CORE		2
+#define PREDICT_MIN_PERIOD_MS		8
+#define PREDICT_MAX_PERIOD_MS		100
+#define PREDICT_JITTER_PCT		15
+
+static enum ppm_power_state ppm_predict_get_power_state_cb(enum ppm_power_state cur_state);
+static void ppm_predict_update_limit_cb(enum ppm_power_state new_state);
+static void ppm_predict_status_change_cb(bool enable);
+static void ppm_predict_mode_change_cb(enum ppm_mode mode);
+
+/* other members will init by ppm_main */
+static struct ppm_policy_data predict_policy = {
+	.name			= __stringify(PPM_POLICY_PREDICT),
+	.lock			= __MUTEX_INITIALIZER(predict_policy.lock),
+	.policy			= PPM_POLICY_PREDICT,
+	.priority		= PPM_POLICY_PRIO_PERFORMANCE_BASE,
+	.get_power_state_cb	= ppm_predict_get_power_state_cb,
+	.update_limit_cb	= ppm_predict_update_limit_cb,
+	.status_change_cb	= ppm_predict_status_change_cb,
+	.mode_change_cb		= ppm_predict_mode_change_cb,
+};
+
+static struct ppm_predict_data {
+	bool is_enabled;
+
+	/* previous sched_avg sample */
+	u64 last_sum;
+	u64 last_time;
+
+	/* burst history */
+	bool in_burst;
+	unsigned int burst_peak;
+	unsigned long last_onset;
+	unsigned int period[PREDICT_HIST_SIZE];	/* ms between burst onsets */
+	unsigned int peak[PREDICT_HIST_SIZE];	/* cores needed by each burst */
+	unsigned int nr_period;
+	unsigned int nr_peak;
+
+	/* prediction */
+	unsigned int target_core;
+	unsigned int min_core;		/* applied, 0 if not holding */
+	unsigned long hold_until;
+
+	struct delayed_work work;
+} predict_data = {
+	.is_enabled = true,
+};
+
+static void ppm_predict_hist_add(unsigned int *hist, unsigned int *nr, unsigned int val)
+{
+	hist[*nr % PREDICT_HIST_SIZE] = val;
+	(*nr)++;
+}
+
+/* periods of the last PREDICT_HIST_SIZE bursts agree within the jitter */
+static bool ppm_predict_is_periodic(void)
+{
+	unsigned int i, lo = UINT_MAX, hi = 0, sum = 0;
+
+	if (predict_data.nr_period < PREDICT_HIST_SIZE)
+		return false;
+
+	for (i = 0; i < PREDICT_HIST_SIZE; i++) {
+		lo = MIN(lo, predict_data.period[i]);
+		hi = MAX(hi, predict_data.period[i]);
+		sum += predict_data.period[i];
+	}
+
+	return (hi - lo) * 100 * PREDICT_HIST_SIZE <= sum * PREDICT_JITTER_PCT;
+}
+
+static void ppm_predict_burst_begin(unsigned int core, unsigned long now)
+{
+	unsigned int period = jiffies_to_msecs(now - predict_data.last_onset);
+
+	if (period >= PREDICT_MIN_PERIOD_MS && period <= PREDICT_MAX_PERIOD_MS)
+		ppm_predict_hist_add(predict_data.period, &predict_data.nr_period, period);
+	else
+		predict_data.nr_period = 0;
+
+	predict_data.last_onset = now;
+	predict_data.in_burst = true;
+	predict_data.burst_peak = core;
+}
+
+static void ppm_predict_burst_end(unsigned long now)
+{
+	unsigned int i;
+
+	predict_data.in_burst = false;
+	ppm_predict_hist_add(predict_data.peak, &predict_data.nr_peak, predict_data.burst_peak);
+
+	if (!ppm_predict_is_periodic())
+		return;
+
+	predict_data.target_core = 0;
+	for (i = 0; i < MIN(predict_data.nr_peak, PREDICT_HIST_SIZE); i++)
+		predict_data.target_core = MAX(predict_data.target_core, predict_data.peak[i]);
+	predict_data.hold_until = now + msecs_to_jiffies(PREDICT_HOLD_MS);
+}
+
+static void ppm_predict_work(struct work_struct *work)
+{
+	u64 sum = sched_get_nr_prod_sum();
+	u64 time = sched_clock();
+	unsigned long now = jiffies;
+	unsigned int nr = 0, core, min_core;
+
+	if (time > predict_data.last_time && predict_data.last_time)
+		nr = (unsigned int)div64_u64((sum - predict_data.last_sum) * 100,
+					     time - predict_data.last_time);
+	predict_data.last_sum = sum;
+	predict_data.last_time = time;
+
+	/* cores needed over the last sample */
+	core = DIV_ROUND_UP(nr, 100);
+
+	if (core >= PREDICT_BURST_CORE) {
+		if (!predict_data.in_burst)
+			ppm_predict_burst_begin(core, now);
+		else
+			predict_data.burst_peak = MAX(predict_data.burst_peak, core);
+	} else if (predict_data.in_burst) {
+		ppm_predict_burst_end(now);
+	}
+
+	min_core = time_before(now, predict_data.hold_until) ? predict_data.target_core : 0;
+	if (min_core != predict_data.min_core) {
+		ppm_lock(&predict_policy.lock);
+		predict_data.min_core = min_core;
+		predict_policy.is_activated = (min_core != 0);
+		ppm_unlock(&predict_policy.lock);
+
+		ppm_dbg("@%s: predicted %d cores, period = %d ms\n", __func__, min_core,
+			predict_data.period[(predict_data.nr_period - 1) % PREDICT_HIST_SIZE]);
+		ppm_task_wakeup();
+	}
+
+	if (predict_data.is_enabled)
+		queue_delayed_work(system_freezable_wq, &predict_data.work,
+				   msecs_to_jiffies(PREDICT_SAMPLE_MS));
+}
+
+static enum ppm_power_state ppm_predict_get_power_state_cb(enum ppm_power_state cur_state)
+{
+	return cur_state;
+}
+
+static void ppm_predict_update_limit_cb(enum ppm_power_state new_state)
+{
+	unsigned int i, root, left = predict_data.min_core;
+
+	FUNC_ENTER(FUNC_LV_POLICY);
+
+	ppm_ver("@%s: predict policy update limit for new state = %s\n",
+		__func__, ppm_get_power_state_name(new_state));
+
+	ppm_hica_set_default_limit_by_state(PPM_POWER_STATE_NONE, &predict_policy);
+
+	/* fill the root cluster of the state first */
+	root = ppm_get_root_cluster_by_state(new_state);
+	if (root >= predict_policy.req.cluster_num)
+		root = 0;
+
+	for (i = 0; i < predict_policy.req.cluster_num && left; i++) {
+		unsigned int id = (root + i) % predict_policy.req.cluster_num;
+		unsigned int core = MIN(left, get_cluster_max_cpu_core(id));
+
+		predict_policy.req.limit[id].min_cpu_core = core;
+		left -= core;
+	}
+
+	FUNC_EXIT(FUNC_LV_POLICY);
+}
+
+static void ppm_predict_status_change_cb(bool enable)
+{
+	FUNC_ENTER(FUNC_LV_POLICY);
+
+	ppm_ver("@%s: predict policy status changed to %d\n", __func__, enable);
+
+	FUNC_EXIT(FUNC_LV_POLICY);
+}
+
+static void ppm_predict_mode_change_cb(enum ppm_mode mode)
+{
+	FUNC_ENTER(FUNC_LV_POLICY);
+
+	ppm_ver("@%s: ppm mode changed to %d\n", __func__, mode);
+
+	FUNC_EXIT(FUNC_LV_POLICY);
+}
+
+static int ppm_predict_enable_proc_show(struct seq_file *m, void *v)
+{
+	seq_printf(m, "%d\n", predict_data.is_enabled);
+
+	return 0;
+}
+
+static ssize_t ppm_predict_enable_proc_write(struct file *file, const char __user *buffer,
+					size_t count, loff_t *pos)
+{
+	unsigned int enable;
+
+	char *buf = ppm_copy_from_user_for_proc(buffer, count);
+
+	if (!buf)
+		return -EINVAL;
+
+	if (!kstrtouint(buf, 10, &enable)) {
+		if (enable && !predict_data.is_enabled) {
+			predict_data.is_enabled = true;
+			predict_data.last_time = 0;
+			queue_delayed_work(system_freezable_wq, &predict_data.work, 0);
+		} else if (!enable && predict_data.is_enabled) {
+			predict_data.is_enabled = false;
+			cancel_delayed_work_sync(&predict_data.work);
+
+			ppm_lock(&predict_policy.lock);
+			predict_data.min_core = 0;
+			predict_data.hold_until = jiffies;
+			predict_policy.is_activated = false;
+			ppm_unlock(&predict_policy.lock);
+			ppm_task_wakeup();
+		}
+	} else
+		ppm_err("@%s: Invalid input!\n", __func__);
+
+	free_page((unsigned long)buf);
+	return count;
+}
+
+static int ppm_predict_status_proc_show(struct seq_file *m, void *v)
+{
+	unsigned int i;
+
+	seq_printf(m, "min_core = %d, target_core = %d, periodic = %d\n",
+		predict_data.min_core, predict_data.target_core, ppm_predict_is_periodic());
+	seq_puts(m, "period(ms) =");
+	for (i = 0; i < MIN(predict_data.nr_period, PREDICT_HIST_SIZE); i++)
+		seq_printf(m, " %d", predict_data.period[i]);
+	seq_puts(m, "\npeak(core) =");
+	for (i = 0; i < MIN(predict_data.nr_peak, PREDICT_HIST_SIZE); i++)
+		seq_printf(m, " %d", predict_data.peak[i]);
+	seq_puts(m, "\n");
+
+	return 0;
+}
+
+PROC_FOPS_RW(predict_enable);
+PROC_FOPS_RO(predict_status);
+
+static int __init ppm_predict_policy_init(void)
+{
+	int i, ret = 0;
+
+	struct pentry {
+		const char *name;
+		const struct file_operations *fops;
+	};
+
+	const struct pentry entries[] = {
+		PROC_ENTRY(predict_enable),
+		PROC_ENTRY(predict_status),
+	};
+
+	FUNC_ENTER(FUNC_LV_POLICY);
+
+	/* create procfs */
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (!proc_create(entries[i].name, S_IRUGO | S_IWUSR | S_IWGRP, policy_dir, entries[i].fops)) {
+			ppm_err("%s(), create /proc/ppm/policy/%s failed\n", __func__, entries[i].name);
+			ret = -EINVAL;
+			goto out;
+		}
+	}
+
+	if (ppm_main_register_policy(&predict_policy)) {
+		ppm_err("@%s: predict policy register failed\n", __func__);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	/* deferrable, an idle system has nothing to predict */
+	INIT_DEFERRABLE_WORK(&predict_data.work, ppm_predict_work);
+	queue_delayed_work(system_freezable_wq, &predict_data.work,
+			   msecs_to_jiffies(PREDICT_SAMPLE_MS));
+
+	ppm_info("@%s: register %s done!\n", __func__, predict_policy.name);
+
+out:
+	FUNC_EXIT(FUNC_LV_POLICY);
+
+	return ret;
+}
+
+static void __exit ppm_predict_policy_exit(void)
+{
+	FUNC_ENTER(FUNC_LV_POLICY);
+
+	predict_data.is_enabled = false;
+	cancel_delayed_work_sync(&predict_data.work);
+	ppm_main_unregister_policy(&predict_policy);
+
+	FUNC_EXIT(FUNC_LV_POLICY);
+}
+
+module_init(ppm_predict_policy_init);
+module_exit(ppm_predict_policy_exit);
@@ -116,112 +116,12 @@ void __attribute__((weak)) tscpu_start_thermal_timer(void)
 
 }
 
-void __attribute__((weak)) mtkts_bts_cancel_thermal_timer(void)
+void __attribute__((weak)) mtk_thermal_idle_enter(void)
 {
 
 }
 
-void __attribute__((weak)) mtkts_btsmdpa_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_pmic_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_battery_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_pa_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_wmt_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_bts_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_btsmdpa_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_pmic_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_battery_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_pa_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_wmt_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_cancel_ts1_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_cancel_ts2_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_cancel_ts3_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_cancel_ts4_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_cancel_ts5_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_start_ts1_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_start_ts2_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_start_ts3_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_start_ts4_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_start_ts5_timer(void)
+void __attribute__((weak)) mtk_thermal_idle_exit(void)
 {
 
 }
@@ -1502,18 +1402,8 @@ static inline void soidle_pre_handler(void)
 	/* cancel thermal hrtimer for power saving */
 	tscpu_cancel_thermal_timer();
 
-	mtkts_bts_cancel_thermal_timer();
-	mtkts_btsmdpa_cancel_thermal_timer();
-	mtkts_pmic_cancel_thermal_timer();
-	mtkts_battery_cancel_thermal_timer();
-	mtkts_pa_cancel_thermal_timer();
-	mtkts_wmt_cancel_thermal_timer();
-
-	mtkts_allts_cancel_ts1_timer();
-	mtkts_allts_cancel_ts2_timer();
-	mtkts_allts_cancel_ts3_timer();
-	mtkts_allts_cancel_ts4_timer();
-	mtkts_allts_cancel_ts5_timer();
+	/* stop polling of the zones that can wait for idle exit */
+	mtk_thermal_idle_enter();
 #endif
 }
 
@@ -1524,18 +1414,8 @@ static inline void soidle_post_handler(void)
 	/* restart thermal hrtimer for update temp info */
 	tscpu_start_thermal_timer();
 
-	mtkts_bts_start_thermal_timer();
-	mtkts_btsmdpa_start_thermal_timer();
-	mtkts_pmic_start_thermal_timer();
-	mtkts_battery_start_thermal_timer();
-	mtkts_pa_start_thermal_timer();
-	mtkts_wmt_start_thermal_timer();
-
-	mtkts_allts_start_ts1_timer();
-	mtkts_allts_start_ts2_timer();
-	mtkts_allts_start_ts3_timer();
-	mtkts_allts_start_ts4_timer();
-	mtkts_allts_start_ts5_timer();
+	/* restart the zone polling stopped at idle entry */
+	mtk_thermal_idle_exit();
 #endif
 }
 
@@ -1553,18 +1433,9 @@ static inline void dpidle_pre_handler(void)
 #ifdef CONFIG_THERMAL
 	/* cancel thermal hrtimer for power saving */
 	tscpu_cancel_thermal_timer();
-	mtkts_bts_cancel_thermal_timer();
-	mtkts_btsmdpa_cancel_thermal_timer();
-	mtkts_pmic_cancel_thermal_timer();
-	mtkts_battery_cancel_thermal_timer();
-	mtkts_pa_cancel_thermal_timer();
-	mtkts_wmt_cancel_thermal_timer();
-
-	mtkts_allts_cancel_ts1_timer();
-	mtkts_allts_cancel_ts2_timer();
-	mtkts_allts_cancel_ts3_timer();
-	mtkts_allts_cancel_ts4_timer();
-	mtkts_allts_cancel_ts5_timer();
+
+	/* stop polling of the zones that can wait for idle exit */
+	mtk_thermal_idle_enter();
 #endif
 }
 static inline void dpidle_post_handler(void)
@@ -1573,18 +1444,9 @@ static inline void dpidle_post_handler(void)
 #ifdef CONFIG_THERMAL
 	/* restart thermal hrtimer for update temp info */
 	tscpu_start_thermal_timer();
-	mtkts_bts_start_thermal_timer();
-	mtkts_btsmdpa_start_thermal_timer();
-	mtkts_pmic_start_thermal_timer();
-	mtkts_battery_start_thermal_timer();
-	mtkts_pa_start_thermal_timer();
-	mtkts_wmt_start_thermal_timer();
-
-	mtkts_allts_start_ts1_timer();
-	mtkts_allts_start_ts2_timer();
-	mtkts_allts_start_ts3_timer();
-	mtkts_allts_start_ts4_timer();
-	mtkts_allts_start_ts5_timer();
+
+	/* restart the zone polling stopped at idle entry */
+	mtk_thermal_idle_exit();
 #endif
 }
 #ifdef SPM_DEEPIDLE_PROFILE_TIME
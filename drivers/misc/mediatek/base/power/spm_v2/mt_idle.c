@@ -12,6 +12,10 @@
 
 #include <linux/debugfs.h>
 #include <linux/seq_file.h>
+#include <linux/kobject.h>
+#include <linux/sysfs.h>
+#include <linux/sched.h>
+#include <linux/math64.h>
 #include <linux/of.h>
 #include <linux/of_address.h>
 
@@ -36,6 +40,9 @@
 
 #include <asm/uaccess.h>
 
+#define CREATE_TRACE_POINTS
+#include <trace/events/mt_idle.h>
+
 #ifdef CONFIG_CPU_ISOLATION
 #include <linux/cpumask.h>
 #include <mt-plat/aee.h>
@@ -128,112 +135,12 @@ tscpu_start_thermal_timer(void)
 	/* FIXME: early porting */
 }
 
-void __attribute__((weak)) mtkts_bts_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_btsmdpa_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_pmic_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_battery_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_pa_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_wmt_cancel_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_bts_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_btsmdpa_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_pmic_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_battery_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_pa_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_wmt_start_thermal_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_cancel_ts1_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_cancel_ts2_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_cancel_ts3_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_cancel_ts4_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_cancel_ts5_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_start_ts1_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_start_ts2_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_start_ts3_timer(void)
+void __attribute__((weak)) mtk_thermal_idle_enter(void)
 {
 
 }
 
-void __attribute__((weak)) mtkts_allts_start_ts4_timer(void)
-{
-
-}
-
-void __attribute__((weak)) mtkts_allts_start_ts5_timer(void)
+void __attribute__((weak)) mtk_thermal_idle_exit(void)
 {
 
 }
@@ -339,6 +246,9 @@ static unsigned long long idle_ratio_profile_duration;
 static unsigned long long idle_ratio_start_time[NR_TYPES];
 static unsigned long long idle_ratio_value[NR_TYPES];
 
+/* never cleared, unlike xxx_block_cnt which restart with each block log */
+static unsigned long idle_block_total[NR_TYPES][NR_REASONS];
+
 /* Slow Idle */
 static unsigned int     slidle_block_mask[NR_GRPS] = {0x0};
 static unsigned long    slidle_cnt[NR_CPUS] = {0};
@@ -444,6 +354,60 @@ long int idle_get_current_time_ms(void)
 	return ((t.tv_sec & 0xFFF) * 1000000 + t.tv_usec) / 1000;
 }
 
+/*
+ * Per clock accounting of what keeps DP/SO3/SO/SL out, the condition masks
+ * only tell which clocks may block. MCDI has no clock condition, its slot
+ * stays empty.
+ */
+#define NR_BLOCKER_TYPES	(IDLE_TYPE_SL + 1)
+
+struct idle_blocker_stat {
+	unsigned int active[NR_GRPS];		/* clocks blocking at last check */
+	u64 start[NR_GRPS][32];			/* sched_clock() it began blocking */
+	u64 time[NR_GRPS][32];			/* ns spent blocking, closed periods */
+	unsigned long cnt[NR_GRPS][32];		/* entries it refused */
+};
+
+static struct idle_blocker_stat idle_blocker[NR_BLOCKER_TYPES];
+static DEFINE_SPINLOCK(idle_blocker_lock);
+
+/*
+ * Called once the clock check of @type has run. @block_mask holds the
+ * clocks that refused this entry and is all zero when the check passed.
+ * A clock blocks from the first check that finds it on until the first
+ * one that does not.
+ */
+static void idle_blocker_update(int type, unsigned int *block_mask)
+{
+	struct idle_blocker_stat *st = &idle_blocker[type];
+	unsigned long flags;
+	unsigned int bits;
+	u64 now = sched_clock();
+	int grp, bit;
+
+	spin_lock_irqsave(&idle_blocker_lock, flags);
+	for (grp = 0; grp < NR_GRPS; grp++) {
+		bits = st->active[grp] | block_mask[grp];
+		while (bits) {
+			bit = __ffs(bits);
+			bits &= bits - 1;
+
+			if (block_mask[grp] & (1U << bit)) {
+				st->cnt[grp][bit]++;
+				if (st->active[grp] & (1U << bit))
+					continue;
+				st->start[grp][bit] = now;
+				trace_idle_blocker(type, grp, bit, true);
+			} else {
+				st->time[grp][bit] += now - st->start[grp][bit];
+				trace_idle_blocker(type, grp, bit, false);
+			}
+		}
+		st->active[grp] = block_mask[grp];
+	}
+	spin_unlock_irqrestore(&idle_blocker_lock, flags);
+}
+
 static DEFINE_SPINLOCK(idle_spm_spin_lock);
 
 void idle_lock_spm(enum idle_lock_spm_id id)
@@ -539,6 +503,7 @@ void faudintbus_sq2pll(void)
 bool soidle3_can_enter(int cpu)
 {
 	int reason = NR_REASONS;
+	bool cg_checked = false;
 	int i;
 	unsigned long long soidle3_block_curr_time = 0;
 	unsigned int cpu_pwr_stat = 0;
@@ -608,6 +573,7 @@ bool soidle3_can_enter(int cpu)
 
 	if (soidle3_by_pass_cg == 0) {
 		memset(soidle3_block_mask, 0, NR_GRPS * sizeof(unsigned int));
+		cg_checked = true;
 		if (!cg_check_idle_can_enter(soidle3_condition_mask, soidle3_block_mask, MT_SOIDLE)) {
 			reason = BY_CLK;
 			goto out;
@@ -663,6 +629,9 @@ bool soidle3_can_enter(int cpu)
 	}
 
 out:
+	if (cg_checked)
+		idle_blocker_update(IDLE_TYPE_SO3, soidle3_block_mask);
+
 #ifdef CONFIG_CPU_ISOLATION
 	if (reason == BY_ISO && prev_reason == BY_ISO) {
 		if (by_iso_count++ > AEE_WARNING_BY_ISO) {
@@ -711,6 +680,7 @@ out:
 		}
 
 		soidle3_block_cnt[reason]++;
+		idle_block_total[IDLE_TYPE_SO3][reason]++;
 		ret = false;
 	} else {
 		soidle3_block_prev_time = idle_get_current_time_ms();
@@ -820,6 +790,7 @@ EXPORT_SYMBOL(disable_soidle_by_bit);
 bool soidle_can_enter(int cpu)
 {
 	int reason = NR_REASONS;
+	bool cg_checked = false;
 	int i;
 	unsigned long long soidle_block_curr_time = 0;
 	unsigned int cpu_pwr_stat = 0;
@@ -876,6 +847,7 @@ bool soidle_can_enter(int cpu)
 
 	if (soidle_by_pass_cg == 0) {
 		memset(soidle_block_mask, 0, NR_GRPS * sizeof(unsigned int));
+		cg_checked = true;
 		if (!cg_check_idle_can_enter(soidle_condition_mask, soidle_block_mask, MT_SOIDLE)) {
 			reason = BY_CLK;
 			goto out;
@@ -931,6 +903,9 @@ bool soidle_can_enter(int cpu)
 	}
 
 out:
+	if (cg_checked)
+		idle_blocker_update(IDLE_TYPE_SO, soidle_block_mask);
+
 #ifdef CONFIG_CPU_ISOLATION
 	if (reason == BY_ISO && prev_reason == BY_ISO) {
 		if (by_iso_count++ > AEE_WARNING_BY_ISO) {
@@ -979,6 +954,7 @@ out:
 		}
 
 		soidle_block_cnt[reason]++;
+		idle_block_total[IDLE_TYPE_SO][reason]++;
 		ret = false;
 	} else {
 		soidle_block_prev_time = idle_get_current_time_ms();
@@ -1087,6 +1063,7 @@ bool mcidle_can_enter(int cpu)
 mcidle_out:
 	if (reason < NR_REASONS) {
 		mcidle_block_cnt[cpu][reason]++;
+		idle_block_total[IDLE_TYPE_MC][reason]++;
 		return false;
 	}
 
@@ -1180,6 +1157,7 @@ EXPORT_SYMBOL(disable_dpidle_by_bit);
 static bool dpidle_can_enter(int cpu)
 {
 	int reason = NR_REASONS;
+	bool cg_checked = false;
 	int i = 0;
 	unsigned long long dpidle_block_curr_time = 0;
 	unsigned int cpu_pwr_stat = 0;
@@ -1239,6 +1217,7 @@ static bool dpidle_can_enter(int cpu)
 
 	if (dpidle_by_pass_cg == 0) {
 		memset(dpidle_block_mask, 0, NR_GRPS * sizeof(unsigned int));
+		cg_checked = true;
 		if (!cg_check_idle_can_enter(dpidle_condition_mask, dpidle_block_mask, MT_DPIDLE)) {
 			reason = BY_CLK;
 			goto out;
@@ -1294,6 +1273,9 @@ static bool dpidle_can_enter(int cpu)
 	}
 
 out:
+	if (cg_checked)
+		idle_blocker_update(IDLE_TYPE_DP, dpidle_block_mask);
+
 #ifdef CONFIG_CPU_ISOLATION
 	if (reason == BY_ISO && prev_reason == BY_ISO) {
 		if (by_iso_count++ > AEE_WARNING_BY_ISO) {
@@ -1341,6 +1323,7 @@ out:
 			}
 		}
 		dpidle_block_cnt[reason]++;
+		idle_block_total[IDLE_TYPE_DP][reason]++;
 		ret = false;
 	} else {
 		dpidle_block_prev_time = idle_get_current_time_ms();
@@ -1476,8 +1459,13 @@ static bool slidle_can_enter(void)
 	}
 
 out:
+	/* only reached past the CPU check with the clocks checked */
+	if (reason != BY_CPU)
+		idle_blocker_update(IDLE_TYPE_SL, slidle_block_mask);
+
 	if (reason < NR_REASONS) {
 		slidle_block_cnt[reason]++;
+		idle_block_total[IDLE_TYPE_SL][reason]++;
 		return false;
 	} else {
 		return true;
@@ -1546,19 +1534,8 @@ static inline void soidle_pre_handler(void)
 	/* cancel thermal hrtimer for power saving */
 	tscpu_cancel_thermal_timer();
 
-	/* cancel thermal timer/workqueues for power saving */
-	mtkts_bts_cancel_thermal_timer();
-	mtkts_btsmdpa_cancel_thermal_timer();
-	mtkts_pmic_cancel_thermal_timer();
-	mtkts_battery_cancel_thermal_timer();
-	mtkts_pa_cancel_thermal_timer();
-	mtkts_wmt_cancel_thermal_timer();
-
-	mtkts_allts_cancel_ts1_timer();
-	mtkts_allts_cancel_ts2_timer();
-	mtkts_allts_cancel_ts3_timer();
-	mtkts_allts_cancel_ts4_timer();
-	mtkts_allts_cancel_ts5_timer();
+	/* stop polling of the zones that can wait for idle exit */
+	mtk_thermal_idle_enter();
 #endif
 }
 
@@ -1575,19 +1552,8 @@ static inline void soidle_post_handler(void)
 	/* restart thermal hrtimer for update temp info */
 	tscpu_start_thermal_timer();
 
-	/* restart thermal timer/workqueues */
-	mtkts_bts_start_thermal_timer();
-	mtkts_btsmdpa_start_thermal_timer();
-	mtkts_pmic_start_thermal_timer();
-	mtkts_battery_start_thermal_timer();
-	mtkts_pa_start_thermal_timer();
-	mtkts_wmt_start_thermal_timer();
-
-	mtkts_allts_start_ts1_timer();
-	mtkts_allts_start_ts2_timer();
-	mtkts_allts_start_ts3_timer();
-	mtkts_allts_start_ts4_timer();
-	mtkts_allts_start_ts5_timer();
+	/* restart the zone polling stopped at idle entry */
+	mtk_thermal_idle_exit();
 #endif
 }
 
@@ -1643,19 +1609,8 @@ static inline void dpidle_pre_handler(void)
 	/* cancel thermal hrtimer for power saving */
 	tscpu_cancel_thermal_timer();
 
-	/* cancel thermal timer/workqueues for power saving */
-	mtkts_bts_cancel_thermal_timer();
-	mtkts_btsmdpa_cancel_thermal_timer();
-	mtkts_pmic_cancel_thermal_timer();
-	mtkts_battery_cancel_thermal_timer();
-	mtkts_pa_cancel_thermal_timer();
-	mtkts_wmt_cancel_thermal_timer();
-
-	mtkts_allts_cancel_ts1_timer();
-	mtkts_allts_cancel_ts2_timer();
-	mtkts_allts_cancel_ts3_timer();
-	mtkts_allts_cancel_ts4_timer();
-	mtkts_allts_cancel_ts5_timer();
+	/* stop polling of the zones that can wait for idle exit */
+	mtk_thermal_idle_enter();
 #endif
 #endif
 }
@@ -1668,19 +1623,8 @@ static inline void dpidle_post_handler(void)
 	/* restart thermal hrtimer for update temp info */
 	tscpu_start_thermal_timer();
 
-	/* restart thermal timer/workqueues */
-	mtkts_bts_start_thermal_timer();
-	mtkts_btsmdpa_start_thermal_timer();
-	mtkts_pmic_start_thermal_timer();
-	mtkts_battery_start_thermal_timer();
-	mtkts_pa_start_thermal_timer();
-	mtkts_wmt_start_thermal_timer();
-
-	mtkts_allts_start_ts1_timer();
-	mtkts_allts_start_ts2_timer();
-	mtkts_allts_start_ts3_timer();
-	mtkts_allts_start_ts4_timer();
-	mtkts_allts_start_ts5_timer();
+	/* restart the zone polling stopped at idle entry */
+	mtk_thermal_idle_exit();
 #endif
 #endif
 }
@@ -2076,6 +2020,38 @@ int rgidle_enter(int cpu)
 }
 EXPORT_SYMBOL(rgidle_enter);
 
+#ifdef CONFIG_CPU_IDLE_MTK_MENU
+static int (*idle_enter_handlers[NR_TYPES]) (int) = {
+	dpidle_enter,
+	soidle3_enter,
+	soidle_enter,
+	mcidle_enter,
+	slidle_enter,
+	rgidle_enter,
+};
+
+/*
+ * mt_idle_enter - enter the deepest allowed state not deeper than @type
+ *
+ * The governor picks @type by residency and latency only. The clock, PLL
+ * and CPU conditions of the SPM states are checked here, walking down the
+ * same order mt_idle_select() uses, and the state actually entered is
+ * returned.
+ */
+int mt_idle_enter(int cpu, int type)
+{
+	dump_idle_cnt_in_interval(cpu);
+
+	for (; type < IDLE_TYPE_RG; type++) {
+		if (idle_select_handlers[type] (cpu))
+			break;
+	}
+
+	return idle_enter_handlers[type] (cpu);
+}
+EXPORT_SYMBOL(mt_idle_enter);
+#endif
+
 static int mcdi_cpu_notify(struct notifier_block *self, unsigned long action, void *hcpu)
 {
 	if (!idle_switch[IDLE_TYPE_MC])
@@ -2824,6 +2800,117 @@ static const struct file_operations reg_dump_fops = {
 	.release = single_release,
 };
 
+/* idle_blocker: per clock blocking time and refused entries */
+static int idle_blocker_show(struct seq_file *m, void *v)
+{
+	struct idle_blocker_stat *st;
+	unsigned long flags;
+	u64 now, time;
+	int type, grp, bit;
+
+	seq_puts(m, "state    id   group    bit refused   block_ms  (* blocking now)\n");
+
+	spin_lock_irqsave(&idle_blocker_lock, flags);
+	now = sched_clock();
+	for (type = 0; type < NR_BLOCKER_TYPES; type++) {
+		st = &idle_blocker[type];
+		for (grp = 0; grp < NR_GRPS; grp++) {
+			for (bit = 0; bit < 32; bit++) {
+				if (!st->cnt[grp][bit])
+					continue;
+
+				time = st->time[grp][bit];
+				if (st->active[grp] & (1U << bit))
+					time += now - st->start[grp][bit];
+
+				seq_printf(m, "%-8s %-4d %-8s %-3d %-9lu %-9llu%s\n",
+					   idle_name[type], grp * 32 + bit,
+					   cg_grp_get_name(grp), bit, st->cnt[grp][bit],
+					   div_u64(time, NSEC_PER_MSEC),
+					   (st->active[grp] & (1U << bit)) ? " *" : "");
+			}
+		}
+	}
+	spin_unlock_irqrestore(&idle_blocker_lock, flags);
+
+	return 0;
+}
+
+static int idle_blocker_open(struct inode *inode, struct file *filp)
+{
+	return single_open(filp, idle_blocker_show, inode->i_private);
+}
+
+static ssize_t idle_blocker_write(struct file *filp, const char __user *userbuf,
+				  size_t count, loff_t *f_pos)
+{
+	unsigned long flags;
+	u64 now;
+	int type, grp, bit;
+
+	/* any write restarts the accounting, blocking clocks restart now */
+	spin_lock_irqsave(&idle_blocker_lock, flags);
+	now = sched_clock();
+	for (type = 0; type < NR_BLOCKER_TYPES; type++) {
+		memset(idle_blocker[type].time, 0, sizeof(idle_blocker[type].time));
+		memset(idle_blocker[type].cnt, 0, sizeof(idle_blocker[type].cnt));
+		for (grp = 0; grp < NR_GRPS; grp++)
+			for (bit = 0; bit < 32; bit++)
+				idle_blocker[type].start[grp][bit] = now;
+	}
+	spin_unlock_irqrestore(&idle_blocker_lock, flags);
+
+	return count;
+}
+
+static const struct file_operations idle_blocker_fops = {
+	.open = idle_blocker_open,
+	.read = seq_read,
+	.write = idle_blocker_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+/* /sys/power/idle_block: why each state was refused since boot */
+static ssize_t idle_block_show(int type, char *buf)
+{
+	char *p = buf;
+	int i;
+
+	for (i = 0; i < NR_REASONS; i++)
+		p += sprintf(p, "%s %lu\n", reason_name[i], idle_block_total[type][i]);
+
+	return p - buf;
+}
+
+#define DEFINE_IDLE_BLOCK_ATTR(_name, _type)					\
+	static ssize_t _name##_show(struct kobject *kobj,			\
+				    struct kobj_attribute *attr, char *buf)	\
+	{									\
+		return idle_block_show(_type, buf);				\
+	}									\
+	static struct kobj_attribute _name##_attr = __ATTR_RO(_name)
+
+DEFINE_IDLE_BLOCK_ATTR(dpidle, IDLE_TYPE_DP);
+DEFINE_IDLE_BLOCK_ATTR(soidle3, IDLE_TYPE_SO3);
+DEFINE_IDLE_BLOCK_ATTR(soidle, IDLE_TYPE_SO);
+DEFINE_IDLE_BLOCK_ATTR(mcidle, IDLE_TYPE_MC);
+DEFINE_IDLE_BLOCK_ATTR(slidle, IDLE_TYPE_SL);
+
+static struct attribute *idle_block_attrs[] = {
+	&dpidle_attr.attr,
+	&soidle3_attr.attr,
+	&soidle_attr.attr,
+	&mcidle_attr.attr,
+	&slidle_attr.attr,
+	NULL,
+};
+
+static struct attribute_group idle_block_attr_group = {
+	.name = "idle_block",
+	.attrs = idle_block_attrs,
+};
+
 /* debugfs entry */
 static struct dentry *root_entry;
 
@@ -2844,6 +2931,7 @@ static int mt_cpuidle_debugfs_init(void)
 	debugfs_create_file("mcidle_state", 0644, root_entry, NULL, &mcidle_state_fops);
 	debugfs_create_file("slidle_state", 0644, root_entry, NULL, &slidle_state_fops);
 	debugfs_create_file("reg_dump", 0644, root_entry, NULL, &reg_dump_fops);
+	debugfs_create_file("idle_blocker", 0644, root_entry, NULL, &idle_blocker_fops);
 
 	return 0;
 }
@@ -2870,6 +2958,10 @@ void mt_cpuidle_framework_init(void)
 
 	iomap_init();
 	mt_cpuidle_debugfs_init();
+
+	err = sysfs_create_group(power_kobj, &idle_block_attr_group);
+	if (err)
+		idle_warn("[%s]fail to create /sys/power/idle_block\n", __func__);
 #if defined(CONFIG_ARCH_MT6797)
 	set_sodi_fw_mode(sodi_fw);
 #endif
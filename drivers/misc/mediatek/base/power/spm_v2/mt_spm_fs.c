@@ -579,6 +579,11 @@ static ssize_t ddren_debug_store(struct kobject *kobj, struct kobj_attribute *at
 /**************************************
  * fm_suspend Function
  **************************************/
+static ssize_t suspend_timeline_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
+{
+	return spm_get_suspend_timeline(buf);
+}
+
 static ssize_t fm_suspend_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf)
 {
 	char *p = buf;
@@ -663,6 +668,7 @@ DEFINE_ATTR_RW(vcore_dvfs_ctrl);
 
 DEFINE_ATTR_RW(ddren_debug);
 DEFINE_ATTR_RO(fm_suspend);
+DEFINE_ATTR_RO(suspend_timeline);
 
 /* DEFINE_ATTR_RW(auto_suspend_resume); */
 
@@ -690,6 +696,7 @@ static struct attribute *spm_attrs[] = {
 	/* other debug interface */
 	__ATTR_OF(ddren_debug),
 	__ATTR_OF(fm_suspend),
+	__ATTR_OF(suspend_timeline),
 
 	/* __ATTR_OF(auto_suspend_resume), */
 
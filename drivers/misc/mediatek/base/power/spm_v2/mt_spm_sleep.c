@@ -6,6 +6,8 @@
 #include <linux/string.h>
 #include <linux/of_fdt.h>
 #include <asm/setup.h>
+#include <asm/arch_timer.h>
+#include <trace/events/power.h>
 
 #ifndef CONFIG_ARM64
 #include <mach/irqs.h>
@@ -65,6 +67,108 @@ u8 spm_snapshot_golden_setting = 0;
 
 struct wake_status spm_wakesta; /* record last wakesta */
 
+/**************************************
+ * suspend/resume timeline
+ **************************************/
+#define SPM_TL_NUM		48	/* fits the sysfs page */
+
+struct spm_tl_rec {
+	u64 cnt;		/* arch counter ticks */
+	u32 data;
+	u8 event;		/* enum suspend_tl_event | SUSPEND_TL_END */
+};
+
+static struct spm_tl_rec spm_tl[SPM_TL_NUM];
+static u32 spm_tl_idx;
+static DEFINE_SPINLOCK(spm_tl_lock);
+
+/* PM core phases, as reported through the suspend_resume tracepoint */
+static const struct {
+	const char *action;
+	u8 event;
+} spm_tl_actions[] = {
+	{ "sync_filesystems", SUSPEND_TL_SYNC_FS },
+	{ "freeze_processes", SUSPEND_TL_FREEZE },
+	{ "dpm_prepare", SUSPEND_TL_DPM_PREPARE },
+	{ "dpm_suspend", SUSPEND_TL_DPM_SUSPEND },
+	{ "dpm_suspend_late", SUSPEND_TL_DPM_SUSPEND_LATE },
+	{ "dpm_suspend_noirq", SUSPEND_TL_DPM_SUSPEND_NOIRQ },
+	{ "machine_suspend", SUSPEND_TL_MACHINE_SUSPEND },
+	{ "dpm_resume_noirq", SUSPEND_TL_DPM_RESUME_NOIRQ },
+	{ "dpm_resume_early", SUSPEND_TL_DPM_RESUME_EARLY },
+	{ "dpm_resume", SUSPEND_TL_DPM_RESUME },
+	{ "dpm_complete", SUSPEND_TL_DPM_COMPLETE },
+	{ "resume_console", SUSPEND_TL_RESUME_CONSOLE },
+	{ "thaw_processes", SUSPEND_TL_THAW },
+};
+
+static void spm_tl_rec(u8 event, u32 data)
+{
+	struct spm_tl_rec *rec;
+	unsigned long flags;
+	u64 cnt = arch_counter_get_cntvct();
+
+	spin_lock_irqsave(&spm_tl_lock, flags);
+	rec = &spm_tl[spm_tl_idx++ % SPM_TL_NUM];
+	rec->cnt = cnt;
+	rec->data = data;
+	rec->event = event;
+	spin_unlock_irqrestore(&spm_tl_lock, flags);
+
+	/* survives a reset in the middle of suspend or resume */
+	aee_rr_rec_suspend_tl(event, cnt, data);
+}
+
+static void spm_tl_suspend_resume(void *ignore, const char *action, int val, bool start)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(spm_tl_actions); i++) {
+		if (!strcmp(action, spm_tl_actions[i].action)) {
+			spm_tl_rec(spm_tl_actions[i].event | (start ? 0 : SUSPEND_TL_END), val);
+			return;
+		}
+	}
+}
+
+/* oldest first: offset from the sync_fs that started the cycle, and delta */
+ssize_t spm_get_suspend_timeline(char *buf)
+{
+	char *p = buf;
+	u32 rate = arch_timer_get_rate() ? : 1;
+	u64 base = 0, prev = 0;
+	u32 i, idx;
+
+	for (i = 0; i < SPM_TL_NUM; i++) {
+		struct spm_tl_rec rec;
+
+		idx = (spm_tl_idx + i) % SPM_TL_NUM;
+		rec = spm_tl[idx];
+		if (!rec.event)
+			continue;
+
+		if (!base || rec.event == SUSPEND_TL_SYNC_FS)
+			base = rec.cnt;
+		if (!prev)
+			prev = rec.cnt;
+
+		p += scnprintf(p, buf + PAGE_SIZE - p, "%10llu us +%9llu us  %-18s %-5s data = 0x%x\n",
+			       div_u64((rec.cnt - base) * USEC_PER_SEC, rate),
+			       div_u64((rec.cnt - prev) * USEC_PER_SEC, rate),
+			       suspend_tl_event_name(rec.event),
+			       rec.event & SUSPEND_TL_END ? "end" : "start", rec.data);
+		prev = rec.cnt;
+	}
+
+	return p - buf;
+}
+
+static int __init spm_tl_init(void)
+{
+	return register_trace_suspend_resume(spm_tl_suspend_resume, NULL);
+}
+late_initcall(spm_tl_init);
+
 /**************************************
  * SW code for suspend
  **************************************/
@@ -531,6 +635,7 @@ wake_reason_t spm_go_to_sleep(u32 spm_flags, u32 spm_data)
 	spm_suspend_aee_init();
 	aee_rr_rec_spm_suspend_val(SPM_SUSPEND_ENTER);
 #endif
+	spm_tl_rec(SUSPEND_TL_SPM_SLEEP, spm_flags);
 
 	if (dyna_load_pcm[DYNA_LOAD_PCM_SUSPEND + cpu / 4].ready)
 		pcmdesc = &(dyna_load_pcm[DYNA_LOAD_PCM_SUSPEND + cpu / 4].desc);
@@ -605,6 +710,7 @@ wake_reason_t spm_go_to_sleep(u32 spm_flags, u32 spm_data)
 
 	__spm_set_wakeup_event(pwrctrl);
 
+	spm_tl_rec(SUSPEND_TL_SPM_FW, pwrctrl->timer_val);
 	spm_kick_pcm_to_run(pwrctrl);
 
 #if SPM_AEE_RR_REC
@@ -618,6 +724,7 @@ wake_reason_t spm_go_to_sleep(u32 spm_flags, u32 spm_data)
 	/* record last wakesta */
 	/* __spm_get_wakeup_status(&wakesta); */
 	__spm_get_wakeup_status(&spm_wakesta);
+	spm_tl_rec(SUSPEND_TL_SPM_FW | SUSPEND_TL_END, spm_wakesta.timer_out);
 
 	spm_clean_after_wakeup();
 
@@ -626,6 +733,7 @@ wake_reason_t spm_go_to_sleep(u32 spm_flags, u32 spm_data)
 	/* record last wakesta */
 	/* last_wr = spm_output_wake_reason(&wakesta, pcmdesc); */
 	last_wr = spm_output_wake_reason(&spm_wakesta, pcmdesc);
+	spm_tl_rec(SUSPEND_TL_SPM_WAKE, spm_wakesta.r12);
 
 RESTORE_IRQ:
 #if defined(CONFIG_MTK_SYS_CIRQ)
@@ -652,6 +760,7 @@ RESTORE_IRQ:
 #if SPM_AEE_RR_REC
 	aee_rr_rec_spm_suspend_val(0);
 #endif
+	spm_tl_rec(SUSPEND_TL_SPM_SLEEP | SUSPEND_TL_END, last_wr);
 
 	return last_wr;
 }
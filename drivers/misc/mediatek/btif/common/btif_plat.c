@@ -41,6 +41,8 @@ MTK_BTIF_INFO_STR mtk_btif = {
 	.tx_tri_lvl = BTIF_TX_FIFO_THRE,
 	.rx_tri_lvl = BTIF_RX_FIFO_THRE,
 	.rx_data_len = 0,
+	.rx_tout_dft = 0,
+	.rx_tout_scale = 1,
 	.p_tx_fifo = NULL,
 };
 #if !(NEW_TX_HANDLING_SUPPORT)
@@ -475,7 +477,9 @@ int hal_btif_hw_init(P_MTK_BTIF_INFO_STR p_btif)
 /*set to newhandshake mode*/
 	btif_new_handshake_ctrl(p_btif, true);
 /*No need to access: enable sleep mode*/
-/*No need to access: set Rx timeout count*/
+/*set Rx timeout count, only touched once a coalescing profile changed it*/
+	if (1 != p_btif->rx_tout_scale)
+		hal_btif_rx_tout_set(p_btif, p_btif->rx_tout_scale);
 /*set Tx threshold*/
 /*set Rx threshold*/
 /*disable internal loopback test*/
@@ -683,6 +687,47 @@ static int btif_tx_fifo_reset(P_MTK_BTIF_INFO_STR p_btif)
 
 #endif
 
+/*****************************************************************************
+* FUNCTION
+*  hal_btif_rx_tout_set
+* DESCRIPTION
+*  set BTIF Rx timeout count to scale times of its reset value,
+*  a longer timeout lets Rx DMA collect more data before DONE interrupt
+* PARAMETERS
+* p_btif   [IN]        pointer to BTIF's information
+* scale    [IN]        multiplier of reset value, 1 restores reset value
+* RETURNS
+*  0 means success, negative means fail
+*****************************************************************************/
+int hal_btif_rx_tout_set(P_MTK_BTIF_INFO_STR p_btif, unsigned int scale)
+{
+	unsigned long base = p_btif->base;
+	unsigned int rto = 0;
+
+	if (0 == scale)
+		return -EINVAL;
+
+/*the reset value is chip specific, so take it from HW before first change*/
+	if (0 == p_btif->rx_tout_dft) {
+		p_btif->rx_tout_dft = BTIF_READ32(BTIF_RTOCNT(base)) &
+		    BTIF_RTOCNT_MASK;
+		if (0 == p_btif->rx_tout_dft) {
+			BTIF_ERR_FUNC("invalid BTIF_RTOCNT reset value\n");
+			return -EIO;
+		}
+	}
+
+	rto = p_btif->rx_tout_dft * scale;
+	if (rto > BTIF_RTOCNT_MASK)
+		rto = BTIF_RTOCNT_MASK;
+
+	btif_reg_sync_writel(rto, BTIF_RTOCNT(base));
+	p_btif->rx_tout_scale = scale;
+	BTIF_DBG_FUNC("BTIF_RTOCNT set to 0x%x, scale(%d)\n", rto, scale);
+
+	return 0;
+}
+
 /*****************************************************************************
 * FUNCTION
 *  hal_btif_loopback_ctrl
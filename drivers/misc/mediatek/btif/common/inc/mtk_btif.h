@@ -179,6 +179,20 @@ typedef struct _btif_log_queue_t_ {
 } BTIF_LOG_QUEUE_T, *P_BTIF_LOG_QUEUE_T;
 
 /*---------------------------------------------------------------------------*/
+/*Rx DMA coalescing and throughput statistics*/
+typedef struct _btif_rx_stat_str_ {
+	ENUM_BTIF_RX_PROFILE profile;	/*profile requested by user */
+	bool burst;		/*Rx timeout currently stretched */
+	unsigned long long rx_bytes;	/*bytes taken from Rx vFIFO */
+	unsigned int irq_cnt;	/*Rx DMA interrupts */
+	unsigned int max_burst;	/*largest amount taken by one interrupt */
+	unsigned int overrun_cnt;	/*times Rx data did not fit in btif_buf */
+	unsigned int max_pending;	/*btif_buf watermark */
+	unsigned long win_start;	/*jiffies AUTO throughput window began */
+	unsigned int win_bytes;	/*bytes received in AUTO window */
+	unsigned int rate;	/*bytes per second of last AUTO window */
+} btif_rx_stat_str, *p_btif_rx_stat_str;
+
 typedef struct _mtk_btif_ {
 	unsigned int open_counter;	/*open counter */
 	bool enable;		/*BTIF module enable flag */
@@ -205,6 +219,7 @@ typedef struct _mtk_btif_ {
 /* unsigned char rx_buf[BTIF_RX_BUFFER_SIZE]; */
 	btif_buf_str btif_buf;
 	spinlock_t rx_irq_spinlock;	/*lock for rx irq handling */
+	btif_rx_stat_str rx_stat;	/*Rx DMA statistics */
 
 /*rx workqueue information*/
 	/*lock to BTIF's rx bottom half when kernel thread is used */
@@ -343,6 +358,7 @@ int btif_dump_reg(p_mtk_btif p_btif);
 int btif_rx_notify_reg(p_mtk_btif p_btif, MTK_BTIF_RX_NOTIFY rx_notify);
 int btif_raise_wak_signal(p_mtk_btif p_btif);
 int btif_clock_ctrl(p_mtk_btif p_btif, int en);
+int btif_rx_profile_set(p_mtk_btif p_btif, ENUM_BTIF_RX_PROFILE profile);
 bool btif_parser_wmt_evt(p_mtk_btif p_btif,
 				const char *sub_str,
 				unsigned int sub_len);
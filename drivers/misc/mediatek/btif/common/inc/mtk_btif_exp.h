@@ -28,6 +28,13 @@ typedef enum _ENUM_BTIF_DBG_ID_ {
 	BTIF_DBG_MAX,
 } ENUM_BTIF_DBG_ID;
 
+typedef enum _ENUM_BTIF_RX_PROFILE_ {
+	BTIF_RX_PROFILE_DEFAULT = 0,	/*reset Rx timeout, lowest latency */
+	BTIF_RX_PROFILE_AUDIO = BTIF_RX_PROFILE_DEFAULT + 1,	/*A2DP/LE audio, coalesce Rx DMA interrupts */
+	BTIF_RX_PROFILE_AUTO = BTIF_RX_PROFILE_AUDIO + 1,	/*follow Rx throughput */
+	BTIF_RX_PROFILE_MAX,
+} ENUM_BTIF_RX_PROFILE;
+
 typedef enum _ENUM_BTIF_OP_ERROR_CODE_ {
 	E_BTIF_AGAIN = 0,
 	E_BTIF_FAIL = -1,
@@ -187,6 +194,25 @@ int mtk_wcn_btif_rx_cb_register(unsigned long u_id, MTK_WCN_BTIF_RX_CB rx_cb);
 *****************************************************************************/
 int mtk_wcn_btif_wakeup_consys(unsigned long u_id);
 
+/*****************************************************************************
+* FUNCTION
+*  mtk_wcn_btif_rx_profile_set
+* DESCRIPTION
+*  select how BTIF Rx DMA interrupts are coalesced.
+*  BTIF_RX_PROFILE_AUDIO stretches BTIF Rx timeout so that a
+*  streaming burst is taken by one interrupt,
+*  BTIF_RX_PROFILE_DEFAULT keeps the reset timeout for SCO/HID latency,
+*  BTIF_RX_PROFILE_AUTO switches between them by Rx throughput
+* PARAMETERS
+*  p_btif      [IN] pointer returned by mtk_wcn_btif_open
+*  profile     [IN] should be one of ENUM_BTIF_RX_PROFILE
+* RETURNS
+*  int          0 = succeed;
+*  others = fail, for detailed information, please see ENUM_BTIF_OP_ERROR_CODE
+*****************************************************************************/
+int mtk_wcn_btif_rx_profile_set(unsigned long u_id,
+				ENUM_BTIF_RX_PROFILE profile);
+
 /*--------------End of Normal Mode API declearation----------------*/
 
 /*--------------Debug Purpose API declearation----------------*/
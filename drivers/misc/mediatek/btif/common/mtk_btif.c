@@ -84,6 +84,7 @@ static void btif_dump_bbs_str(unsigned char *p_str, p_btif_buf_str p_bbs);
 static int _btif_dump_memory(char *str, unsigned char *p_buf, unsigned int buf_len);
 static int _btif_rx_btm_deinit(p_mtk_btif p_btif);
 static int _btif_rx_btm_sched(p_mtk_btif p_btif);
+static void _btif_rx_stat_update(p_mtk_btif p_btif, int rx_len);
 static int _btif_rx_btm_init(p_mtk_btif p_btif);
 static void btif_rx_tasklet(unsigned long func_data);
 static void btif_rx_worker(struct work_struct *p_work);
@@ -170,11 +171,17 @@ mtk_btif_dma g_dma[BTIF_PORT_NR][BTIF_DIR_MAX] = {
 	 },
 };
 
-#define G_MAX_PKG_LEN (7 * 1024)
-static int g_max_pkg_len = G_MAX_PKG_LEN; /*DMA vFIFO is set to 8 * 1024, we set this to 7/8 * vFIFO size*/
+#define G_MAX_PKG_LEN (14 * 1024)
+static int g_max_pkg_len = G_MAX_PKG_LEN; /*DMA vFIFO is set to 16 * 1024, we set this to 7/8 * vFIFO size*/
 static int g_max_pding_data_size = BTIF_RX_BUFFER_SIZE * 3 / 4;
 
 static int mtk_btif_dbg_lvl = BTIF_LOG_INFO;
+
+/*Rx timeout multiplier used while Rx DMA interrupts are coalesced*/
+#define BTIF_RX_BURST_TOUT_SCALE 4
+/*BTIF_RX_PROFILE_AUTO: A2DP SBC/AAC runs well above 24KB/s, SCO and HID well below*/
+#define BTIF_RX_BURST_ENTER_RATE (24 * 1024)
+#define BTIF_RX_BURST_EXIT_RATE (12 * 1024)
 #if BTIF_RXD_BE_BLOCKED_DETECT
 static struct timeval btif_rxd_time_stamp[MAX_BTIF_RXD_TIME_REC];
 #endif
@@ -737,7 +744,17 @@ long btif_unlocked_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
 /*-----------device property----------------*/
 static ssize_t driver_flag_read(struct device_driver *drv, char *buf)
 {
-	return sprintf(buf, "btif driver debug level:%d\n", mtk_btif_dbg_lvl);
+	p_btif_rx_stat_str p_stat = &(g_btif[0].rx_stat);
+
+	return sprintf(buf,
+		       "btif driver debug level:%d\n"
+		       "rx profile:%d, coalescing:%d, rate:%dB/s\n"
+		       "rx bytes:%llu, dma irq:%d, max burst:%d\n"
+		       "rx overrun:%d, max pending:%d\n",
+		       mtk_btif_dbg_lvl, p_stat->profile, p_stat->burst,
+		       p_stat->rate, p_stat->rx_bytes, p_stat->irq_cnt,
+		       p_stat->max_burst, p_stat->overrun_cnt,
+		       p_stat->max_pending);
 }
 
 static ssize_t driver_flag_set(struct device_driver *drv,
@@ -847,6 +864,17 @@ static ssize_t driver_flag_set(struct device_driver *drv,
 		BTIF_INFO_FUNC("g_max_pding_data_size is set to %d\n", y);
 		g_max_pding_data_size = y;
 		break;
+	case 0x12:
+		btif_rx_profile_set(&g_btif[0], y);
+		break;
+	case 0x13:
+		g_btif[0].rx_stat.rx_bytes = 0;
+		g_btif[0].rx_stat.irq_cnt = 0;
+		g_btif[0].rx_stat.max_burst = 0;
+		g_btif[0].rx_stat.overrun_cnt = 0;
+		g_btif[0].rx_stat.max_pending = 0;
+		BTIF_INFO_FUNC("rx statistics cleared\n");
+		break;
 	default:
 		mtk_btif_exp_open_test();
 		mtk_btif_exp_write_stress_test(3030, 1);
@@ -1022,6 +1050,7 @@ irqreturn_t btif_rx_dma_irq_handler(int irq, void *data)
 	p_mtk_btif p_btif = (p_mtk_btif) data;	/*&(g_btif[index]); */
 	p_mtk_btif_dma p_rx_dma = p_btif->p_rx_dma;
 	P_MTK_DMA_INFO_STR p_rx_dma_info = p_rx_dma->p_dma_info;
+	int rx_len = 0;
 
 	BTIF_DBG_FUNC("++, p_btif(0x%p)\n", data);
 
@@ -1032,7 +1061,9 @@ irqreturn_t btif_rx_dma_irq_handler(int irq, void *data)
 	hal_btif_dma_clk_ctrl(p_rx_dma_info, CLK_OUT_ENABLE);
 #endif
 
-	hal_rx_dma_irq_handler(p_rx_dma_info, NULL, 0);
+	rx_len = hal_rx_dma_irq_handler(p_rx_dma_info, NULL, 0);
+/*BTIF clock is still on here, so Rx timeout can be changed*/
+	_btif_rx_stat_update(p_btif, rx_len);
 
 #if MTK_BTIF_ENABLE_CLK_REF_COUNTER
 	hal_btif_dma_clk_ctrl(p_rx_dma_info, CLK_OUT_DISABLE);
@@ -1048,6 +1079,93 @@ irqreturn_t btif_rx_dma_irq_handler(int irq, void *data)
 	return IRQ_HANDLED;
 }
 
+/*****************************************************************************
+* FUNCTION
+*  _btif_rx_stat_update
+* DESCRIPTION
+*  account one Rx DMA interrupt and select Rx timeout for the next one
+* PARAMETERS
+* p_btif   [IN]        pointer to BTIF's structure
+* rx_len   [IN]        data length taken from Rx vFIFO by this interrupt
+* RETURNS
+*  none
+*****************************************************************************/
+static void _btif_rx_stat_update(p_mtk_btif p_btif, int rx_len)
+{
+	p_btif_rx_stat_str p_stat = &(p_btif->rx_stat);
+	bool burst = p_stat->burst;
+
+	if (rx_len > 0) {
+		p_stat->rx_bytes += rx_len;
+		p_stat->win_bytes += rx_len;
+		if (rx_len > p_stat->max_burst)
+			p_stat->max_burst = rx_len;
+	}
+	p_stat->irq_cnt++;
+
+/*clock was off, do not touch BTIF registers*/
+	if (rx_len < 0)
+		return;
+
+	switch (p_stat->profile) {
+	case BTIF_RX_PROFILE_AUDIO:
+		burst = true;
+		break;
+	case BTIF_RX_PROFILE_AUTO:
+		if (time_after_eq(jiffies, p_stat->win_start + HZ)) {
+			p_stat->rate = p_stat->win_bytes * HZ /
+			    (jiffies - p_stat->win_start);
+			p_stat->win_bytes = 0;
+			p_stat->win_start = jiffies;
+			if (p_stat->rate >= BTIF_RX_BURST_ENTER_RATE)
+				burst = true;
+			else if (p_stat->rate < BTIF_RX_BURST_EXIT_RATE)
+				burst = false;
+		}
+		break;
+	default:
+		burst = false;
+		break;
+	}
+
+	if (burst == p_stat->burst)
+		return;
+
+	if (0 == hal_btif_rx_tout_set(p_btif->p_btif_info,
+				      burst ? BTIF_RX_BURST_TOUT_SCALE : 1)) {
+		p_stat->burst = burst;
+		BTIF_DBG_FUNC("Rx DMA coalescing %s, rate(%d)\n",
+			      burst ? "on" : "off", p_stat->rate);
+	}
+}
+
+/*****************************************************************************
+* FUNCTION
+*  btif_rx_profile_set
+* DESCRIPTION
+*  select Rx DMA interrupt coalescing profile, the Rx timeout is changed
+*  by next Rx DMA interrupt, when BTIF clock is known to be on
+* PARAMETERS
+* p_btif   [IN]        pointer to BTIF's structure
+* profile  [IN]        one of ENUM_BTIF_RX_PROFILE
+* RETURNS
+*  0 means success, negative means fail
+*****************************************************************************/
+int btif_rx_profile_set(p_mtk_btif p_btif, ENUM_BTIF_RX_PROFILE profile)
+{
+	if (profile >= BTIF_RX_PROFILE_MAX) {
+		BTIF_ERR_FUNC("invalid rx profile:%d\n", profile);
+		return E_BTIF_INVAL_PARAM;
+	}
+
+	p_btif->rx_stat.win_bytes = 0;
+	p_btif->rx_stat.win_start = jiffies;
+	p_btif->rx_stat.profile = profile;
+	BTIF_INFO_FUNC("rx profile set to %d\n", profile);
+
+	return 0;
+}
+
 unsigned int btif_dma_rx_data_receiver(P_MTK_DMA_INFO_STR p_dma_info,
 				       unsigned char *p_buf,
 				       unsigned int buf_len)
@@ -2568,6 +2686,7 @@ unsigned int btif_bbs_write(p_btif_buf_str p_bbs,
 	}
 
 	if (ava_len < buf_len) {
+		p_btif->rx_stat.overrun_cnt++;
 		BTIF_ERR_FUNC("BTIF overrun, (%d)empty, (%d)needed\n",
 			      emp_len, buf_len);
 		hal_btif_dump_reg(p_btif->p_btif_info, REG_BTIF_ALL);
@@ -2586,6 +2705,9 @@ unsigned int btif_bbs_write(p_btif_buf_str p_bbs,
 	wr_len = min(buf_len, ava_len);
 	btif_bbs_wr_direct(p_bbs, p_buf, wr_len);
 
+	if (BBS_COUNT(p_bbs) > p_btif->rx_stat.max_pending)
+		p_btif->rx_stat.max_pending = BBS_COUNT(p_bbs);
+
 	if (BBS_COUNT(p_bbs) >= g_max_pding_data_size) {
 		BTIF_WARN_FUNC("Rx buf_len too long, size(%d)\n",
 			       BBS_COUNT(p_bbs));
@@ -3193,6 +3315,7 @@ static int BTIF_init(void)
 
 		INIT_LIST_HEAD(&(g_btif[index].user_list));
 		BBS_INIT(&(g_btif[index].btif_buf));
+		g_btif[index].rx_stat.profile = BTIF_RX_PROFILE_AUTO;
 		g_btif[index].enable = false;
 		g_btif[index].open_counter = 0;
 		g_btif[index].setting = &g_btif_setting[index];
@@ -359,6 +359,31 @@ int mtk_wcn_btif_wakeup_consys(unsigned long u_id)
 }
 EXPORT_SYMBOL(mtk_wcn_btif_wakeup_consys);
 
+/*****************************************************************************
+* FUNCTION
+*  mtk_wcn_btif_rx_profile_set
+* DESCRIPTION
+*  select how BTIF Rx DMA interrupts are coalesced
+* PARAMETERS
+*  p_btif      [IN] pointer returned by mtk_wcn_btif_open
+*  profile     [IN] should be one of ENUM_BTIF_RX_PROFILE
+* RETURNS
+*  int          0 = succeed; others = fail, for detailed information, please see ENUM_BTIF_OP_ERROR_CODE
+*****************************************************************************/
+int mtk_wcn_btif_rx_profile_set(unsigned long u_id,
+				ENUM_BTIF_RX_PROFILE profile)
+{
+	p_mtk_btif p_btif = NULL;
+
+	p_btif = btif_exp_srh_id(u_id);
+
+	if (NULL == p_btif)
+		return E_BTIF_INVAL_PARAM;
+
+	return btif_rx_profile_set(p_btif, profile);
+}
+EXPORT_SYMBOL(mtk_wcn_btif_rx_profile_set);
+
 
 /***************End of Normal Mode API declearation**********/
 
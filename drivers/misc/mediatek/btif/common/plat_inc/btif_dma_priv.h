@@ -15,7 +15,8 @@ extern struct clk *clk_btif_apdma; /*btif apdma clock*/
 #endif /* !defined(CONFIG_MTK_CLKMGR) */
 
 #define TX_DMA_VFF_SIZE (1024 * 8)	/*Tx vFIFO Len must be 8 Byte allignment */
-#define RX_DMA_VFF_SIZE (1024 * 8)	/*Rx vFIFO Len must be 8 Byte allignment */
+/*Rx vFIFO Len must be 8 Byte allignment, 16KB keeps an A2DP burst in one THRE interrupt*/
+#define RX_DMA_VFF_SIZE (1024 * 16)
 
 #define DMA_TX_THRE(n) (n - 7)	/*Tx Trigger Level */
 #define DMA_RX_THRE(n) ((n) * 3 / 4)	/*Rx Trigger Level */
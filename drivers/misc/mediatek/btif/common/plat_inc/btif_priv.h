@@ -64,6 +64,9 @@ struct clk *clk_btif; /*btif  clock*/
 #define BTIF_DMA_EN_AUTORST_DIS  (0x0 << 2)	/*0: after Rx timeout happens,
 							SW shall reset the interrupt by reading BTIF 0x4C */
 
+/*BTIF_RTOCNT bits*/
+#define BTIF_RTOCNT_MASK (0xFFFF)	/*Rx timeout count, in BTIF clock cycles */
+
 /*BTIF_TRI_LVL bits*/
 #define BTIF_TRI_LVL_TX_MASK ((0xf) << 0)
 #define BTIF_TRI_LVL_RX_MASK ((0x7) << 4)
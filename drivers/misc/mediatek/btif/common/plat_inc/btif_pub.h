@@ -110,6 +110,20 @@ int hal_btif_rx_cb_reg(P_MTK_BTIF_INFO_STR p_btif_info,
 *****************************************************************************/
 int hal_btif_loopback_ctrl(P_MTK_BTIF_INFO_STR p_btif, bool en);
 
+/*****************************************************************************
+* FUNCTION
+*  hal_btif_rx_tout_set
+* DESCRIPTION
+*  set BTIF Rx timeout count to scale times of its reset value,
+*  a longer timeout lets Rx DMA collect more data before DONE interrupt
+* PARAMETERS
+* p_btif   [IN]        pointer to BTIF's information
+* scale    [IN]        multiplier of reset value, 1 restores reset value
+* RETURNS
+*  0 means success, negative means fail
+*****************************************************************************/
+int hal_btif_rx_tout_set(P_MTK_BTIF_INFO_STR p_btif, unsigned int scale);
+
 /*****************************************************************************
 * FUNCTION
 *  hal_btif_rx_handler
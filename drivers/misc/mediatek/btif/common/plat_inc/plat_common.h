@@ -250,6 +250,9 @@ typedef struct _MTK_BTIF_INFO_STR_ {
 
 	unsigned int rx_data_len;	/*rx data length */
 
+	unsigned int rx_tout_dft;	/*Rx timeout count after reset, 0 if not read yet */
+	unsigned int rx_tout_scale;	/*Rx timeout count multiplier in use */
+
 	btif_rx_buf_write rx_cb;
 
 	struct kfifo *p_tx_fifo;	/*tx fifo */
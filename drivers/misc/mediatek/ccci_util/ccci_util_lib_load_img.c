@@ -20,6 +20,9 @@
 #endif
 #include <asm/setup.h>
 #include <linux/atomic.h>
+#include <linux/workqueue.h>
+#include <linux/completion.h>
+#include <linux/sched.h>
 #ifdef ENABLE_MD_IMG_SECURITY_FEATURE
 #include <sec_osal.h>
 #include <sec_export.h>
@@ -28,6 +31,9 @@
 #include <mt-plat/mt_ccci_common.h>
 #include "ccci_util_log.h"
 #include "ccci_util_lib_main.h"
+#ifdef CONFIG_MTPROF
+#include "bootprof.h"
+#endif
 #if defined(CONFIG_MTK_AEE_FEATURE)
 #include <mt-plat/aee.h>
 #endif
@@ -974,6 +980,52 @@ static inline void dump_md_image(int md_id, void *start_addr, u32 offset, u32 le
 
 }
 
+static void img_bootprof(int md_id, struct ccci_image_info *img, const char *phase)
+{
+#ifdef CONFIG_MTPROF
+	char buf[64];
+
+	snprintf(buf, sizeof(buf), "ccci: md%d %s %s", md_id + 1, phase,
+		 img->type == IMG_MD ? "md" : (img->type == IMG_DSP ? "dsp" : "armv7"));
+	log_boot(buf);
+#endif
+}
+
+/*
+ * Queue reads of the whole image file, in readahead sized chunks, without
+ * waiting for them.  The verification and the copy to reserved memory that
+ * follow both read the file again; with its pages already on their way
+ * they mostly wait on I/O that was issued up front instead of issuing
+ * small reads of their own, one after the other.
+ */
+static void img_prefetch(struct file *filp)
+{
+	loff_t size = i_size_read(file_inode(filp));
+
+	if (size > 0)
+		force_page_cache_readahead(filp->f_mapping, filp, 0, DIV_ROUND_UP(size, PAGE_SIZE));
+}
+
+#ifdef ENABLE_MD_IMG_SECURITY_FEATURE
+/* signature check of the image file, run off the loading thread */
+struct img_verify {
+	struct work_struct work;
+	struct completion done;
+	int md_id;
+	char *file_name;
+	unsigned int tail_length;
+	int offset;
+};
+
+static void img_verify_work(struct work_struct *work)
+{
+	struct img_verify *v = container_of(work, struct img_verify, work);
+
+	v->offset = signature_check_v2(v->md_id, v->file_name, &v->tail_length);
+	complete(&v->done);
+}
+#endif
+
 static int check_if_bypass_header(struct file *filp, int *img_size);
 static int load_std_firmware(int md_id, struct file *filp, struct ccci_image_info *img)
 {
@@ -984,7 +1036,8 @@ static int load_std_firmware(int md_id, struct file *filp, struct ccci_image_inf
 	mm_segment_t curr_fs;
 	phys_addr_t load_addr;
 	void *end_addr;
-	const int size_per_read = 1024 * 1024;
+	/* read straight into a write combined mapping, 4M at a time */
+	const int size_per_read = 4 * 1024 * 1024;
 	const int size = 1024;
 	int img_size = 0;
 	int hdr_size = 0;
@@ -1008,8 +1061,7 @@ static int load_std_firmware(int md_id, struct file *filp, struct ccci_image_inf
 	if (hdr_size) {
 		CCCI_UTIL_ERR_MSG("read size according to header(%d)\n", img_size);
 		while (1) {
-			/* Map 1M memory */
-			start = ioremap_nocache((load_addr + read_size), size_per_read);
+			start = ioremap_wc((load_addr + read_size), size_per_read);
 			if (start == NULL) {
 				CCCI_UTIL_ERR_MSG_WITH_ID(md_id, "image ioremap fail: %p\n", start);
 				set_fs(curr_fs);
@@ -1041,8 +1093,7 @@ static int load_std_firmware(int md_id, struct file *filp, struct ccci_image_inf
 	} else {
 		CCCI_UTIL_ERR_MSG("legacy load\n");
 		while (1) {
-			/* Map 1M memory */
-			start = ioremap_nocache((load_addr + read_size), size_per_read);
+			start = ioremap_wc((load_addr + read_size), size_per_read);
 			if (start == NULL) {
 				CCCI_UTIL_ERR_MSG_WITH_ID(md_id, "image ioremap fail: %p\n", start);
 				set_fs(curr_fs);
@@ -1070,6 +1121,8 @@ static int load_std_firmware(int md_id, struct file *filp, struct ccci_image_inf
 		}
 	}
 
+	/* drain the write combined stores before the header is read uncached */
+	wmb();
 	if (img->type == IMG_MD) {
 		/* Make sure in one scope */
 		start = ioremap_nocache(round_down(load_addr + img->size - 0x4000, 0x4000), 0x4000 * 2);
@@ -1112,8 +1165,11 @@ static int load_image(int md_id, struct ccci_image_info *img_inf, char post_fix[
 	unsigned int sec_tail_length = 0;
 	struct ccci_image_info *img = NULL;
 	MD_IMG_TYPE img_type;
+	unsigned long long t_start = sched_clock();
 #ifdef ENABLE_MD_IMG_SECURITY_FEATURE
 	unsigned int img_len = 0;
+	struct img_verify verify;
+	unsigned long long t_verify;
 #endif
 	img = img_inf;
 	img_type = img->type;
@@ -1132,14 +1188,29 @@ static int load_image(int md_id, struct ccci_image_info *img_inf, char post_fix[
 	} else {
 		CCCI_UTIL_DBG_MSG_WITH_ID(md_id, "open %s OK\n", img->file_name);
 	}
+	img_bootprof(md_id, img, "load start");
 
 	/*Begin to check header, only modem.img need check signature and cipher header */
 	sec_tail_length = 0;
 	if (img_type == IMG_MD) {
 		/*step1:check if need to signature */
 #ifdef ENABLE_MD_IMG_SECURITY_FEATURE
-		offset = signature_check_v2(md_id, img->file_name, &sec_tail_length);
-		CCCI_UTIL_INF_MSG_WITH_ID(md_id, "signature_check offset:%d, tail:%d\n", offset, sec_tail_length);
+		/* hash on another cpu while this one gets the file read in */
+		INIT_WORK_ONSTACK(&verify.work, img_verify_work);
+		init_completion(&verify.done);
+		verify.md_id = md_id;
+		verify.file_name = img->file_name;
+		verify.tail_length = 0;
+		queue_work(system_unbound_wq, &verify.work);
+		img_prefetch(filp);
+		wait_for_completion(&verify.done);
+		destroy_work_on_stack(&verify.work);
+		offset = verify.offset;
+		sec_tail_length = verify.tail_length;
+		t_verify = sched_clock();
+		img_bootprof(md_id, img, "verify done");
+		CCCI_UTIL_INF_MSG_WITH_ID(md_id, "signature_check offset:%d, tail:%d, %llu us\n", offset, sec_tail_length,
+					  (t_verify - t_start) / NSEC_PER_USEC);
 		if (offset < 0) {
 			CCCI_UTIL_INF_MSG_WITH_ID(md_id, "signature_check failed ret=%d\n", offset);
 			ret = offset;
@@ -1162,6 +1233,8 @@ static int load_image(int md_id, struct ccci_image_info *img_inf, char post_fix[
 		} else {
 #endif
 			CCCI_UTIL_INF_MSG_WITH_ID(md_id, "Not cipher image\n");
+			/* a no-op for the pages the verification already pulled in */
+			img_prefetch(filp);
 			ret = load_std_firmware(md_id, filp, img);
 			if (ret < 0) {
 				CCCI_UTIL_INF_MSG_WITH_ID(md_id, "load_firmware failed: ret=%d!\n", ret);
@@ -1186,6 +1259,10 @@ static int load_image(int md_id, struct ccci_image_info *img_inf, char post_fix[
 		}
 	}
 
+	img_bootprof(md_id, img, "load done");
+	CCCI_UTIL_INF_MSG_WITH_ID(md_id, "%s loaded in %llu us\n", img->file_name,
+				  (sched_clock() - t_start) / NSEC_PER_USEC);
+
  out:
 	if (filp != NULL)
 		close_img_file(filp, fp_id);
@@ -21,8 +21,10 @@
 #include <linux/etherdevice.h>
 #include <linux/ip.h>
 #include <linux/tcp.h>
+#include <linux/udp.h>
 #include <linux/ipv6.h>
 #include <net/ipv6.h>
+#include <net/dsfield.h>
 #include <net/sch_generic.h>
 #include <linux/skbuff.h>
 #include <linux/module.h>
@@ -245,6 +247,61 @@ int ccmni_debug_file_init(int md_id)
 	return 0;
 }
 
+/*
+ * Latency sensitive packets share the fast queue with pure TCP ACKs: voice
+ * and signalling marked CS5 and above (EF, IMS SIP), DNS and ICMP.  Only
+ * small packets qualify, so a bulk flow carrying a high DSCP cannot crowd
+ * the ACKs out of the fast queue.
+ */
+#define CCMNI_URGENT_DSCP	40	/* CS5 */
+#define CCMNI_URGENT_MAX_LEN	512
+#define CCMNI_DNS_PORT		53
+
+static inline int is_urgent_skb(int md_id, struct sk_buff *skb)
+{
+	u32 packet_type;
+	struct udphdr *udph;
+	int l4_off;
+	u8 proto, dscp;
+
+	if (skb->len > CCMNI_URGENT_MAX_LEN)
+		return 0;
+
+	packet_type = skb->data[0] & 0xF0;
+	if (packet_type == IPV6_VERSION) {
+		struct ipv6hdr *iph = (struct ipv6hdr *)skb->data;
+		__be16 frag_off;
+
+		dscp = ipv6_get_dsfield(iph) >> 2;
+		proto = iph->nexthdr;
+		l4_off = ipv6_skip_exthdr(skb, sizeof(struct ipv6hdr), &proto, &frag_off);
+		if (proto == IPPROTO_ICMPV6)
+			return 1;
+	} else if (packet_type == IPV4_VERSION) {
+		struct iphdr *iph = (struct iphdr *)skb->data;
+
+		dscp = iph->tos >> 2;
+		proto = iph->protocol;
+		l4_off = iph->ihl << 2;
+		if (proto == IPPROTO_ICMP)
+			return 1;
+	} else {
+		return 0;
+	}
+
+	if (dscp >= CCMNI_URGENT_DSCP)
+		return 1;
+	if (proto == IPPROTO_UDP && l4_off > 0 && l4_off + sizeof(struct udphdr) <= skb_headlen(skb)) {
+		udph = (struct udphdr *)(skb->data + l4_off);
+		if (udph->dest == htons(CCMNI_DNS_PORT))
+			return 1;
+	}
+
+	if (unlikely(ccmni_debug_level&CCMNI_DBG_LEVEL_ACK_SKB))
+		CCMNI_INF_MSG(md_id, "[SKB] urgent=0: proto=%d dscp=%d len=%d\n", proto, dscp, skb->len);
+	return 0;
+}
+
 /********************netdev register function********************/
 static u16 ccmni_select_queue(struct net_device *dev, struct sk_buff *skb,
 			    void *accel_priv, select_queue_fallback_t fallback)
@@ -252,7 +309,7 @@ static u16 ccmni_select_queue(struct net_device *dev, struct sk_buff *skb,
 	ccmni_instance_t *ccmni = (ccmni_instance_t *)netdev_priv(dev);
 
 	if (ccmni->ch.rx == CCCI_CCMNI1_RX || ccmni->ch.rx == CCCI_CCMNI2_RX) {
-		if (is_ack_skb(ccmni->md_id, skb))
+		if (is_ack_skb(ccmni->md_id, skb) || is_urgent_skb(ccmni->md_id, skb))
 			return CCMNI_TXQ_FAST;
 		else
 			return CCMNI_TXQ_NORMAL;
@@ -660,8 +717,8 @@ static int ccmni_init(int md_id, ccmni_ccci_ops_t *ccci_info)
 		for (i = 0; i < ctlb->ccci_ops->ccmni_num; i++) {
 			/* allocate netdev */
 			if (ctlb->ccci_ops->md_ability & MODEM_CAP_CCMNI_MQ)
-				/* alloc multiple tx queue, 2 txq and 1 rxq */
-				dev = alloc_etherdev_mqs(sizeof(ccmni_instance_t), 2, 1);
+				/* alloc multiple queue, 2 txq and one rxq per modem rxq */
+				dev = alloc_etherdev_mqs(sizeof(ccmni_instance_t), CCMNI_TXQ_NUM, CCMNI_RXQ_NUM);
 			else
 				dev = alloc_etherdev(sizeof(ccmni_instance_t));
 			if (unlikely(dev == NULL)) {
@@ -871,6 +928,16 @@ static int ccmni_rx_callback(int md_id, int rx_ch, struct sk_buff *skb, void *pr
 	skb->ip_summed = CHECKSUM_NONE;
 	skb_len = skb->len;
 
+	/*
+	 * Hash the flow here, where the IP header is known to be at skb->data,
+	 * so RPS can steer flows to other cores instead of keeping all of the
+	 * downlink on the cpu that serves the modem interrupt.
+	 */
+	skb_reset_network_header(skb);
+	skb_get_hash(skb);
+	if (skb_rx_queue_recorded(skb) && skb_get_rx_queue(skb) >= dev->real_num_rx_queues)
+		skb_record_rx_queue(skb, skb_get_rx_queue(skb) % dev->real_num_rx_queues);
+
 	if (unlikely(ccmni_debug_level&CCMNI_DBG_LEVEL_RX))
 		CCMNI_INF_MSG(md_id, "[RX]CCMNI%d(rx_ch=%d) recv data_len=%d\n", ccmni_idx, rx_ch, skb->len);
 
@@ -890,7 +957,7 @@ static int ccmni_rx_callback(int md_id, int rx_ch, struct sk_buff *skb, void *pr
 #endif
 
 	if (likely(ctlb->ccci_ops->md_ability & MODEM_CAP_NAPI)) {
-		netif_receive_skb(skb);
+		napi_gro_receive(&ccmni->napi, skb);
 	} else {
 		if (!in_interrupt())
 			netif_rx_ni(skb);
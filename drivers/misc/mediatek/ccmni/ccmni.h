@@ -125,6 +125,9 @@ typedef enum {
 	CCMNI_TXQ_END     = CCMNI_TXQ_NUM
 } CCMNI_TXQ_NO;
 
+/* one rx queue per modem rx queue, so each can be given its own rps_cpus */
+#define  CCMNI_RXQ_NUM          8
+
 /*****************************extern function************************************/
 /* int  ccmni_init(int md_id, ccmni_ccci_ops_t *ccci_info); */
 /* void ccmni_exit(int md_id); */
@@ -50,6 +50,8 @@
 /* use mutex because we don't access task list in IRQ */
 /* and we may allocate memory when create list items */
 static DEFINE_MUTEX(gCmdqTaskMutex);
+/* serializes consumers, so tasks reach a HW thread in the order they were assigned */
+static DEFINE_MUTEX(gCmdqConsumeMutex);
 static DEFINE_MUTEX(gCmdqSaveBufferMutex);
 /* static DEFINE_MUTEX(gCmdqWriteAddrMutex); */
 static DEFINE_SPINLOCK(gCmdqWriteAddrLock);
@@ -6624,6 +6626,9 @@ int32_t cmdqCoreSuspend(void)
 	/* destroy secure path notify thread */
 	cmdq_core_stop_secure_path_notify_thread();
 
+	/* no task may be between thread assignment and execution */
+	mutex_lock(&gCmdqConsumeMutex);
+
 	pEngine = gCmdqContext.engine;
 
 	execThreads = CMDQ_REG_GET32(CMDQ_CURR_LOADED_THR);
@@ -6692,6 +6697,8 @@ int32_t cmdqCoreSuspend(void)
 	gCmdqSuspended = true;
 	spin_unlock_irqrestore(&gCmdqThreadLock, flags);
 
+	mutex_unlock(&gCmdqConsumeMutex);
+
 	/* ALWAYS allow suspend */
 	return 0;
 }
@@ -6814,11 +6821,25 @@ static int32_t cmdq_core_exec_task_async_with_retry(TaskStruct *pTask, int32_t t
 	return status;
 }
 
+/* tasks assigned to a HW thread in one scan of the waiting list */
+#define CMDQ_CONSUME_BATCH_SIZE (CMDQ_MAX_THREAD_COUNT)
+
+/*
+ * Tasks are picked and assigned a HW thread under gCmdqTaskMutex, but
+ * programming the HW thread happens after the mutex is dropped, so other
+ * pipelines can queue and release tasks meanwhile.  pTask->thread is set
+ * at assignment, which tells cmdq_core_wait_task_done() the task is no
+ * longer on the waiting list.
+ */
 static int32_t cmdq_core_consume_waiting_list(struct work_struct *_ignore)
 {
 	struct list_head *p, *n = NULL;
 	struct TaskStruct *pTask = NULL;
 	struct ThreadStruct *pThread = NULL;
+	struct TaskStruct *runTask[CMDQ_CONSUME_BATCH_SIZE];
+	int32_t runThread[CMDQ_CONSUME_BATCH_SIZE];
+	int32_t runCount;
+	int32_t i;
 	int32_t thread = CMDQ_INVALID_THREAD;
 	int32_t status = 0;
 	bool threadAcquired = false;
@@ -6836,73 +6857,87 @@ static int32_t cmdq_core_consume_waiting_list(struct work_struct *_ignore)
 	CMDQ_PROF_MMP(cmdq_mmp_get_event()->consume_done, MMProfileFlagStart, current->pid, 0);
 	consumeTime = sched_clock();
 
-	mutex_lock(&gCmdqTaskMutex);
+	mutex_lock(&gCmdqConsumeMutex);
 
-	threadAcquired = false;
+	do {
+		runCount = 0;
 
-	/* scan and remove (if executed) waiting tasks */
-	list_for_each_safe(p, n, &gCmdqContext.taskWaitList) {
-		pTask = list_entry(p, struct TaskStruct, listEntry);
+		mutex_lock(&gCmdqTaskMutex);
 
-		thread_prio = cmdq_get_func()->priority(pTask->scenario);
+		/* scan and remove (if assigned) waiting tasks */
+		list_for_each_safe(p, n, &gCmdqContext.taskWaitList) {
+			pTask = list_entry(p, struct TaskStruct, listEntry);
+
+			thread_prio = cmdq_get_func()->priority(pTask->scenario);
 
-		CMDQ_MSG("-->THREAD: try acquire thread for task: 0x%p, thread_prio: %d\n",
-				   pTask, thread_prio);
-		CMDQ_MSG("-->THREAD: task_prio: %d, flag: 0x%llx, scenario:%d begin\n",
-				   pTask->priority, pTask->engineFlag, pTask->scenario);
+			CMDQ_MSG("-->THREAD: try acquire thread for task: 0x%p, thread_prio: %d\n",
+					   pTask, thread_prio);
+			CMDQ_MSG("-->THREAD: task_prio: %d, flag: 0x%llx, scenario:%d begin\n",
+					   pTask->priority, pTask->engineFlag, pTask->scenario);
 
-		CMDQ_GET_TIME_IN_MS(pTask->submit, consumeTime, waitingTimeMS);
-		needLog = waitingTimeMS >= CMDQ_PREDUMP_TIMEOUT_MS;
+			CMDQ_GET_TIME_IN_MS(pTask->submit, consumeTime, waitingTimeMS);
+			needLog = waitingTimeMS >= CMDQ_PREDUMP_TIMEOUT_MS;
 
-		/* Allocate hw thread */
-		thread = cmdq_core_acquire_thread(pTask->engineFlag,
-						  thread_prio, pTask->scenario, needLog,
-						  pTask->secData.isSecure);
+			/* Allocate hw thread */
+			thread = cmdq_core_acquire_thread(pTask->engineFlag,
+							  thread_prio, pTask->scenario, needLog,
+							  pTask->secData.isSecure);
 
-		if (CMDQ_INVALID_THREAD == thread) {
-			/* have to wait, remain in wait list */
-			CMDQ_MSG("<--THREAD: acquire thread fail, need to wait\n");
-			if (true == needLog) {
-				/* task wait too long */
-				CMDQ_ERR("acquire thread fail, task(0x%p), thread_prio(%d), flag(0x%llx)\n",
-						   pTask, thread_prio, pTask->engineFlag);
+			if (CMDQ_INVALID_THREAD == thread) {
+				/* have to wait, remain in wait list */
+				CMDQ_MSG("<--THREAD: acquire thread fail, need to wait\n");
+				if (true == needLog) {
+					/* task wait too long */
+					CMDQ_ERR("acquire thread fail, task(0x%p), thread_prio(%d), flag(0x%llx)\n",
+							   pTask, thread_prio, pTask->engineFlag);
 
-				dumpTriggerLoop =
-				    (CMDQ_SCENARIO_PRIMARY_DISP == pTask->scenario) ?
-				    (true) : (dumpTriggerLoop);
+					dumpTriggerLoop =
+					    (CMDQ_SCENARIO_PRIMARY_DISP == pTask->scenario) ?
+					    (true) : (dumpTriggerLoop);
+				}
+				continue;
 			}
-			continue;
-		}
 
-		pThread = &gCmdqContext.thread[thread];
+			pThread = &gCmdqContext.thread[thread];
 
-		/* some task is ready to run */
-		threadAcquired = true;
+			/* Assign loop function if the thread should be a loop thread */
+			pThread->loopCallback = pTask->loopCallback;
+			pThread->loopData = pTask->loopData;
 
-		/* Assign loop function if the thread should be a loop thread */
-		pThread->loopCallback = pTask->loopCallback;
-		pThread->loopData = pTask->loopData;
+			/* remove from wait list and put into active list */
+			list_del_init(&(pTask->listEntry));
+			list_add_tail(&(pTask->listEntry), &gCmdqContext.taskActiveList);
+			pTask->thread = thread;
 
-		/* Start execution, */
-		/* remove from wait list and put into active list */
-		list_del_init(&(pTask->listEntry));
-		list_add_tail(&(pTask->listEntry), &gCmdqContext.taskActiveList);
+			CMDQ_MSG("<--THREAD: acquire thread w/flag: 0x%llx on thread(%d): 0x%p end\n",
+				 pTask->engineFlag, thread, pThread);
 
-		CMDQ_MSG("<--THREAD: acquire thread w/flag: 0x%llx on thread(%d): 0x%p end\n",
-			 pTask->engineFlag, thread, pThread);
+			runTask[runCount] = pTask;
+			runThread[runCount] = thread;
+			if (++runCount >= CMDQ_CONSUME_BATCH_SIZE)
+				break;
+		}
 
-		/* Run task on thread */
-		status = cmdq_core_exec_task_async_with_retry(pTask, thread);
-		if (status < 0) {
-			CMDQ_ERR
-			    ("<--THREAD: cmdq_core_exec_task_async_with_retry fail, release task 0x%p\n",
-			     pTask);
-			cmdq_core_track_task_record(pTask, thread);
-			cmdq_core_release_thread(pTask);
-			cmdq_core_release_task_unlocked(pTask);
-			pTask = NULL;
+		mutex_unlock(&gCmdqTaskMutex);
+
+		/* Run tasks on their threads, in assignment order */
+		for (i = 0; i < runCount; i++) {
+			pTask = runTask[i];
+			threadAcquired = true;
+
+			status = cmdq_core_exec_task_async_with_retry(pTask, runThread[i]);
+			if (status < 0) {
+				CMDQ_ERR
+				    ("<--THREAD: cmdq_core_exec_task_async_with_retry fail, release task 0x%p\n",
+				     pTask);
+				cmdq_core_track_task_record(pTask, runThread[i]);
+				cmdq_core_release_thread(pTask);
+				cmdq_core_release_task(pTask);
+			}
 		}
-	}
+	} while (runCount >= CMDQ_CONSUME_BATCH_SIZE);
+
+	mutex_unlock(&gCmdqConsumeMutex);
 
 	if (dumpTriggerLoop) {
 		/* HACK: observe trigger loop status when acquire config thread failed. */
@@ -6918,8 +6953,6 @@ static int32_t cmdq_core_consume_waiting_list(struct work_struct *_ignore)
 		wake_up_all(&gCmdqThreadDispatchQueue);
 	}
 
-	mutex_unlock(&gCmdqTaskMutex);
-
 	CMDQ_PROF_END(current->pid, __func__);
 
 	CMDQ_PROF_MMP(cmdq_mmp_get_event()->consume_done, MMProfileFlagEnd, current->pid, 0);
@@ -7086,12 +7119,11 @@ int32_t cmdqCoreWaitResultAndReleaseTask(TaskStruct *pTask, cmdqRegValueStruct *
 		memset(CMDQ_U32_PTR(pResult->regValues), 0,
 		       pResult->count * sizeof(CMDQ_U32_PTR(pResult->regValues)[0]));
 
-		mutex_lock(&gCmdqTaskMutex);
+		/* the task is ours until released, no need for gCmdqTaskMutex */
 		for (i = 0; i < pResult->count && i < pTask->regCount; ++i) {
 			/* fill results */
 			CMDQ_U32_PTR(pResult->regValues)[i] = pTask->regResults[i];
 		}
-		mutex_unlock(&gCmdqTaskMutex);
 	}
 
 	cmdq_core_track_task_record(pTask, thread);
@@ -454,6 +454,9 @@ int32_t cmdqRecReset(cmdqRecHandle handle)
 	/* profile marker */
 	cmdq_rec_reset_profile_maker_data(handle);
 
+	/* template */
+	handle->templateSealed = false;
+
 	return 0;
 }
 
@@ -1477,6 +1480,117 @@ int32_t cmdqRecQueryOffset(cmdqRecHandle handle, uint32_t startIndex, const CMDQ
 	return Offset;
 }
 
+int32_t cmdqRecWritePatchable(cmdqRecHandle handle, uint32_t addr, uint32_t value, uint32_t mask)
+{
+	int32_t status;
+
+	if (NULL == handle)
+		return -EFAULT;
+
+	/* GPR addressing adds instructions after the write */
+	if (CMDQ_SPECIAL_SUBSYS_ADDR == cmdq_core_subsys_from_phys_addr(addr)) {
+		CMDQ_ERR("REC: address 0x%08x cannot be patched\n", addr);
+		return -EINVAL;
+	}
+
+	status = cmdqRecWrite(handle, addr, value, mask);
+	if (0 != status)
+		return status;
+
+	return (handle->blockSize / CMDQ_INST_SIZE) - 1;
+}
+
+static uint32_t *cmdq_rec_get_patch_command(cmdqRecHandle handle, uint32_t index)
+{
+	uint32_t *pCommand;
+
+	if (NULL == handle || handle->finalized ||
+	    (index + 1) * CMDQ_INST_SIZE > handle->blockSize)
+		return NULL;
+
+	pCommand = (uint32_t *) ((uint8_t *) handle->pBuffer + index * CMDQ_INST_SIZE);
+	if (CMDQ_CODE_WRITE != (pCommand[1] >> 24)) {
+		CMDQ_ERR("REC: instruction %d is not a write (0x%08x:0x%08x)\n", index,
+			 pCommand[1], pCommand[0]);
+		return NULL;
+	}
+
+	return pCommand;
+}
+
+int32_t cmdqRecPatchValue(cmdqRecHandle handle, uint32_t index, uint32_t value)
+{
+	uint32_t *pCommand = cmdq_rec_get_patch_command(handle, index);
+
+	if (NULL == pCommand)
+		return -EFAULT;
+
+	pCommand[0] = value;
+	return 0;
+}
+
+int32_t cmdqRecPatchAddress(cmdqRecHandle handle, uint32_t index, uint32_t addr)
+{
+	const uint32_t subsysBit = cmdq_get_func()->getSubsysLSBArgA();
+	uint32_t *pCommand = cmdq_rec_get_patch_command(handle, index);
+	int32_t subsys = cmdq_core_subsys_from_phys_addr(addr);
+
+	if (NULL == pCommand)
+		return -EFAULT;
+
+	if (0 > subsys || CMDQ_SPECIAL_SUBSYS_ADDR == subsys ||
+	    ((pCommand[1] >> subsysBit) & 0x1f) != (subsys & 0x1f)) {
+		CMDQ_ERR("REC: address 0x%08x is not in the subsys of instruction %d\n", addr,
+			 index);
+		return -EINVAL;
+	}
+
+	/* keep op, subsys and the mask bit, replace the offset */
+	pCommand[1] = (pCommand[1] & ~0xfffe) | (addr & 0xfffe);
+	return 0;
+}
+
+int32_t cmdqRecSealTemplate(cmdqRecHandle handle, uint32_t tag)
+{
+	if (NULL == handle)
+		return -EFAULT;
+
+	if (handle->finalized || handle->secData.isSecure)
+		return -EBUSY;
+
+	handle->templateSealed = true;
+	handle->templateTag = tag;
+	handle->templateSize = handle->blockSize;
+	handle->templatePrefetchCount = handle->prefetchCount;
+#ifdef CMDQ_PROFILE_MARKER_SUPPORT
+	handle->templateMarkerCount = handle->profileMarker.count;
+#endif
+
+	return 0;
+}
+
+int32_t cmdqRecRewindTemplate(cmdqRecHandle handle, uint32_t tag)
+{
+	if (NULL == handle)
+		return -EFAULT;
+
+	if (!handle->templateSealed || handle->templateTag != tag)
+		return -ENOENT;
+
+	if (NULL != handle->pRunningTask)
+		cmdqRecStopLoop(handle);
+
+	/* commands past the template are simply overwritten, no realloc */
+	handle->blockSize = handle->templateSize;
+	handle->prefetchCount = handle->templatePrefetchCount;
+	handle->finalized = false;
+#ifdef CMDQ_PROFILE_MARKER_SUPPORT
+	handle->profileMarker.count = handle->templateMarkerCount;
+#endif
+
+	return 0;
+}
+
 int32_t cmdqRecAcquireResource(cmdqRecHandle handle, CMDQ_EVENT_ENUM resourceEvent)
 {
 	bool acquireResult;
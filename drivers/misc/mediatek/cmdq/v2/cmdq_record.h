@@ -24,6 +24,15 @@ typedef struct cmdqRecStruct {
 #ifdef CMDQ_PROFILE_MARKER_SUPPORT
 	cmdqProfileMarkerStruct profileMarker;
 #endif
+
+	/* template, see cmdqRecSealTemplate() */
+	bool templateSealed;
+	uint32_t templateTag;
+	uint32_t templateSize;	/* command size of the template */
+	uint32_t templatePrefetchCount;
+#ifdef CMDQ_PROFILE_MARKER_SUPPORT
+	uint32_t templateMarkerCount;
+#endif
 } cmdqRecStruct, *cmdqRecHandle;
 
 typedef dma_addr_t cmdqBackupSlotHandle;
@@ -440,6 +449,67 @@ extern "C" {
 	int32_t cmdqRecQueryOffset(cmdqRecHandle handle, uint32_t startIndex,
 				   const CMDQ_CODE_ENUM opCode, CMDQ_EVENT_ENUM event);
 
+/**
+ * Append a write instruction that can be patched later
+ * Parameter:
+ *     handle: the command queue recorder handle
+ *     addr, value, mask: same as cmdqRecWrite
+ * Return:
+ *     >= 0 (index) of the write instruction for success; else the error code is returned
+ * Note:
+ *     addresses that need a GPR to reach cannot be patched
+ */
+	int32_t cmdqRecWritePatchable(cmdqRecHandle handle, uint32_t addr, uint32_t value,
+				      uint32_t mask);
+
+/**
+ * Replace the value of a write instruction in place
+ * Parameter:
+ *     handle: the command queue recorder handle
+ *     index: returned by cmdqRecWritePatchable()
+ *     value: the new value to write
+ * Return:
+ *     0 for success; else the error code is returned
+ */
+	int32_t cmdqRecPatchValue(cmdqRecHandle handle, uint32_t index, uint32_t value);
+
+/**
+ * Replace the register of a write instruction in place
+ * Parameter:
+ *     handle: the command queue recorder handle
+ *     index: returned by cmdqRecWritePatchable()
+ *     addr: the new register, in the same subsys as the recorded one
+ * Return:
+ *     0 for success; else the error code is returned
+ */
+	int32_t cmdqRecPatchAddress(cmdqRecHandle handle, uint32_t index, uint32_t addr);
+
+/**
+ * Keep the commands recorded so far as a template
+ * Parameter:
+ *     handle: the command queue recorder handle
+ *     tag: caller defined id of the template
+ * Return:
+ *     0 for success; else the error code is returned
+ * Note:
+ *     For commands that are identical from frame to frame: record them
+ *     once, seal them, then cmdqRecRewindTemplate() before each frame
+ *     instead of cmdqRecReset(), patch the placeholders, append the
+ *     per-frame commands and flush.  cmdqRecReset() drops the template.
+ *     Secure handles cannot be sealed.
+ */
+	int32_t cmdqRecSealTemplate(cmdqRecHandle handle, uint32_t tag);
+
+/**
+ * Drop the commands appended after the template
+ * Parameter:
+ *     handle: the command queue recorder handle
+ *     tag: id the template was sealed with
+ * Return:
+ *     0 for success; -ENOENT when the handle holds no template of that tag
+ */
+	int32_t cmdqRecRewindTemplate(cmdqRecHandle handle, uint32_t tag);
+
 /**
  * acquire resource by resourceEvent
  * Parameter:
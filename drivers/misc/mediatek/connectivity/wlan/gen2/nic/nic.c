@@ -2763,6 +2763,10 @@ VOID nicInitMGMT(IN P_ADAPTER_T prAdapter, IN P_REG_INFO_T prRegInfo)
 	swCrDebugInit(prAdapter);
 #endif /* CFG_SUPPORT_SWCR */
 
+#if CFG_SUPPORT_PS_POLICY
+	nicpmPsPolicyInit(prAdapter);
+#endif
+
 #if (CFG_SUPPORT_TDLS == 1)
 	TdlsexInit(prAdapter);
 #endif /* CFG_SUPPORT_TDLS */
@@ -2782,6 +2786,10 @@ VOID nicUninitMGMT(IN P_ADAPTER_T prAdapter)
 {
 	ASSERT(prAdapter);
 
+#if CFG_SUPPORT_PS_POLICY
+	nicpmPsPolicyUninit(prAdapter);
+#endif
+
 #if CFG_SUPPORT_SWCR
 	swCrDebugUninit(prAdapter);
 #endif /* CFG_SUPPORT_SWCR */
@@ -225,11 +225,65 @@
 *                              C O N S T A N T S
 ********************************************************************************
 */
+#if CFG_SUPPORT_PS_POLICY
+#define PS_POLICY_WINDOW_MS		1000	/* classification window */
+#define PS_POLICY_FLOW_NUM		16
+#define PS_POLICY_FLOW_IDLE_WINDOWS	4	/* drop a flow after this many silent windows */
+#define PS_POLICY_LATENCY_HOLD		3	/* windows to stay in CAM after the last interactive one */
+
+/* small packets at a steady rate: games, VoIP without RTP, remote shells */
+#define PS_POLICY_INTERACTIVE_MIN_PPS	10
+#define PS_POLICY_INTERACTIVE_MAX_PPS	300
+#define PS_POLICY_INTERACTIVE_MAX_LEN	400
+#define PS_POLICY_BULK_MIN_BPS		(256 * 1024)
+
+#define RTP_HDR_LEN			12
+#define RTP_VERSION			2
+#endif
 
 /*******************************************************************************
 *                             D A T A   T Y P E S
 ********************************************************************************
 */
+#if CFG_SUPPORT_PS_POLICY
+typedef enum _ENUM_PS_POLICY_CLASS_T {
+	PS_POLICY_CLASS_IDLE = 0,
+	PS_POLICY_CLASS_BULK,
+	PS_POLICY_CLASS_INTERACTIVE,
+	PS_POLICY_CLASS_NUM
+} ENUM_PS_POLICY_CLASS_T;
+
+typedef struct _PS_POLICY_FLOW_T {
+	UINT_32 u4DstAddr;
+	UINT_16 u2SrcPort;
+	UINT_16 u2DstPort;
+	UINT_8 ucProto;
+	BOOLEAN fgInUse;
+	BOOLEAN fgRtp;
+	UINT_8 ucIdleWindows;
+	UINT_32 u4Pkts;		/* in the current window */
+	UINT_32 u4Bytes;
+	UINT_32 u4AvgPps;	/* packet rate history, 1/4 EWMA over windows */
+} PS_POLICY_FLOW_T, *P_PS_POLICY_FLOW_T;
+
+typedef struct _PS_POLICY_T {
+	TIMER_T rTimer;
+	BOOLEAN fgTimerStarted;
+	BOOLEAN fgOverride;	/* ucAppliedMode is ours, ucBaseMode is the user's */
+	UINT_8 ucBaseMode;
+	UINT_8 ucAppliedMode;
+	UINT_8 ucLatencyHold;
+	ENUM_PS_POLICY_CLASS_T eClass;
+	OS_SYSTIME rClassStart;
+	PS_POLICY_FLOW_T arFlow[PS_POLICY_FLOW_NUM];
+
+	/* counters */
+	UINT_32 au4ClassMs[PS_POLICY_CLASS_NUM];	/* time spent per class */
+	UINT_32 u4LatencyEnter;	/* switches to CAM for interactive traffic */
+	UINT_32 u4BulkEnter;
+	UINT_32 u4FlowEvict;	/* flow table full */
+} PS_POLICY_T, *P_PS_POLICY_T;
+#endif
 
 /*******************************************************************************
 *                            P U B L I C   D A T A
@@ -240,6 +294,9 @@
 *                           P R I V A T E   D A T A
 ********************************************************************************
 */
+#if CFG_SUPPORT_PS_POLICY
+static PS_POLICY_T g_rPsPolicy;
+#endif
 
 /*******************************************************************************
 *                                 M A C R O S
@@ -667,3 +724,272 @@ BOOLEAN nicpmSetAcpiPowerD3(IN P_ADAPTER_T prAdapter)
 
 	return TRUE;
 }
+
+#if CFG_SUPPORT_PS_POLICY
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Check whether a UDP payload looks like RTP.
+*
+* \param[in] pucPayload UDP payload
+* \param[in] u4Len      Length of the UDP payload
+*
+* \retval TRUE  RTP version 2 header with an audio/video payload type
+* \retval FALSE Anything else
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN nicpmPsPolicyIsRtp(IN PUINT_8 pucPayload, IN UINT_32 u4Len)
+{
+	UINT_8 ucPayloadType;
+
+	if (u4Len < RTP_HDR_LEN || (pucPayload[0] >> 6) != RTP_VERSION)
+		return FALSE;
+
+	/* MPEG-TS over RTP, as used by WFD */
+	if (checkRtpAV(pucPayload, u4Len) != (UINT8) -1)
+		return TRUE;
+
+	/* static audio/video types, or dynamic ones; 72-76 would be RTCP */
+	ucPayloadType = pucPayload[1] & 0x7F;
+	return (ucPayloadType <= 34 || ucPayloadType >= 96) ? TRUE : FALSE;
+}
+
+static P_PS_POLICY_FLOW_T nicpmPsPolicyFindFlow(IN UINT_8 ucProto,
+						IN UINT_32 u4DstAddr, IN UINT_16 u2SrcPort, IN UINT_16 u2DstPort)
+{
+	P_PS_POLICY_FLOW_T prFlow, prFree = NULL, prVictim = NULL;
+	UINT_32 i;
+
+	for (i = 0; i < PS_POLICY_FLOW_NUM; i++) {
+		prFlow = &g_rPsPolicy.arFlow[i];
+		if (!prFlow->fgInUse) {
+			if (!prFree)
+				prFree = prFlow;
+			continue;
+		}
+		if (prFlow->ucProto == ucProto && prFlow->u4DstAddr == u4DstAddr &&
+		    prFlow->u2SrcPort == u2SrcPort && prFlow->u2DstPort == u2DstPort)
+			return prFlow;
+		/* the quietest flow makes room when the table is full */
+		if (!prVictim || prFlow->u4AvgPps < prVictim->u4AvgPps)
+			prVictim = prFlow;
+	}
+
+	if (!prFree) {
+		prFree = prVictim;
+		g_rPsPolicy.u4FlowEvict++;
+	}
+
+	kalMemZero(prFree, sizeof(*prFree));
+	prFree->fgInUse = TRUE;
+	prFree->ucProto = ucProto;
+	prFree->u4DstAddr = u4DstAddr;
+	prFree->u2SrcPort = u2SrcPort;
+	prFree->u2DstPort = u2DstPort;
+	return prFree;
+}
+
+static VOID nicpmPsPolicyApply(IN P_ADAPTER_T prAdapter, IN ENUM_PS_POLICY_CLASS_T eClass)
+{
+	P_PS_POLICY_T prPolicy = &g_rPsPolicy;
+	UINT_8 ucMode;
+	OS_SYSTIME rNow = kalGetTimeTick();
+
+	if (eClass == prPolicy->eClass)
+		return;
+
+	prPolicy->au4ClassMs[prPolicy->eClass] += rNow - prPolicy->rClassStart;
+	prPolicy->rClassStart = rNow;
+	prPolicy->eClass = eClass;
+
+	if (!prPolicy->fgOverride)
+		prPolicy->ucBaseMode = prAdapter->rWlanInfo.arPowerSaveMode[NETWORK_TYPE_AIS_INDEX].ucPsProfile;
+
+	switch (eClass) {
+	case PS_POLICY_CLASS_INTERACTIVE:
+		/* no beacon-interval wake latency on every downlink frame */
+		ucMode = Param_PowerModeCAM;
+		prPolicy->u4LatencyEnter++;
+		break;
+	case PS_POLICY_CLASS_BULK:
+		/* MAX PS polls one frame per beacon; fast PS sleeps between bursts only */
+		ucMode = (prPolicy->ucBaseMode == Param_PowerModeMAX_PSP) ?
+		    Param_PowerModeFast_PSP : prPolicy->ucBaseMode;
+		prPolicy->u4BulkEnter++;
+		break;
+	default:
+		ucMode = prPolicy->ucBaseMode;
+		break;
+	}
+
+	/* the user asked for CAM: nothing to gain */
+	if (prPolicy->ucBaseMode == Param_PowerModeCAM)
+		ucMode = Param_PowerModeCAM;
+
+	DBGLOG(NIC, INFO, "PS policy: class %d, PS mode %d (user %d)\n", eClass, ucMode, prPolicy->ucBaseMode);
+
+	if (ucMode != prAdapter->rWlanInfo.arPowerSaveMode[NETWORK_TYPE_AIS_INDEX].ucPsProfile)
+		nicConfigPowerSaveProfile(prAdapter, NETWORK_TYPE_AIS_INDEX, (PARAM_POWER_MODE) ucMode, FALSE);
+
+	prPolicy->ucAppliedMode = ucMode;
+	prPolicy->fgOverride = (ucMode != prPolicy->ucBaseMode) ? TRUE : FALSE;
+}
+
+static VOID nicpmPsPolicyTimeout(IN P_ADAPTER_T prAdapter, IN ULONG ulParam)
+{
+	P_PS_POLICY_T prPolicy = &g_rPsPolicy;
+	P_PS_POLICY_FLOW_T prFlow;
+	ENUM_PS_POLICY_CLASS_T eClass = PS_POLICY_CLASS_IDLE;
+	BOOLEAN fgActive = FALSE;
+	UINT_32 u4Pps, u4Bps;
+	UINT_32 i;
+
+	prPolicy->fgTimerStarted = FALSE;
+
+	/* the mode was changed behind our back (OID, CTIA): it is the user's now */
+	if (prPolicy->fgOverride &&
+	    prAdapter->rWlanInfo.arPowerSaveMode[NETWORK_TYPE_AIS_INDEX].ucPsProfile != prPolicy->ucAppliedMode) {
+		prPolicy->fgOverride = FALSE;
+		prPolicy->ucBaseMode = prAdapter->rWlanInfo.arPowerSaveMode[NETWORK_TYPE_AIS_INDEX].ucPsProfile;
+	}
+
+	for (i = 0; i < PS_POLICY_FLOW_NUM; i++) {
+		prFlow = &prPolicy->arFlow[i];
+		if (!prFlow->fgInUse)
+			continue;
+
+		u4Pps = prFlow->u4Pkts * MSEC_PER_SEC / PS_POLICY_WINDOW_MS;
+		u4Bps = prFlow->u4Bytes * (MSEC_PER_SEC / PS_POLICY_WINDOW_MS);
+		prFlow->u4AvgPps = (prFlow->u4AvgPps * 3 + u4Pps) / 4;
+
+		if (prFlow->u4Pkts == 0) {
+			if (++prFlow->ucIdleWindows >= PS_POLICY_FLOW_IDLE_WINDOWS)
+				prFlow->fgInUse = FALSE;
+			continue;
+		}
+		prFlow->ucIdleWindows = 0;
+		fgActive = TRUE;
+
+		if (u4Bps >= PS_POLICY_BULK_MIN_BPS) {
+			if (eClass == PS_POLICY_CLASS_IDLE)
+				eClass = PS_POLICY_CLASS_BULK;
+		} else if (prFlow->fgRtp ||
+			   (prFlow->u4AvgPps >= PS_POLICY_INTERACTIVE_MIN_PPS &&
+			    prFlow->u4AvgPps <= PS_POLICY_INTERACTIVE_MAX_PPS &&
+			    prFlow->u4Bytes / prFlow->u4Pkts <= PS_POLICY_INTERACTIVE_MAX_LEN)) {
+			eClass = PS_POLICY_CLASS_INTERACTIVE;
+		}
+
+		prFlow->u4Pkts = 0;
+		prFlow->u4Bytes = 0;
+	}
+
+	/* interactive traffic pauses (talk spurts, game menus): hold CAM a little */
+	if (eClass == PS_POLICY_CLASS_INTERACTIVE)
+		prPolicy->ucLatencyHold = PS_POLICY_LATENCY_HOLD;
+	else if (prPolicy->ucLatencyHold) {
+		prPolicy->ucLatencyHold--;
+		eClass = PS_POLICY_CLASS_INTERACTIVE;
+	}
+
+	if (!prAdapter->fgEnCtiaPowerMode)
+		nicpmPsPolicyApply(prAdapter, eClass);
+
+	/* keep sampling while there is traffic or a mode to give back */
+	if (fgActive || prPolicy->eClass != PS_POLICY_CLASS_IDLE) {
+		cnmTimerStartTimer(prAdapter, &prPolicy->rTimer, PS_POLICY_WINDOW_MS);
+		prPolicy->fgTimerStarted = TRUE;
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Initialize the traffic based power save policy.
+*
+* \param[in] prAdapter Pointer to the Adapter structure.
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID nicpmPsPolicyInit(IN P_ADAPTER_T prAdapter)
+{
+	kalMemZero(&g_rPsPolicy, sizeof(g_rPsPolicy));
+	g_rPsPolicy.rClassStart = kalGetTimeTick();
+
+	cnmTimerInitTimer(prAdapter, &g_rPsPolicy.rTimer, (PFN_MGMT_TIMEOUT_FUNC) nicpmPsPolicyTimeout, (ULONG) NULL);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Stop the power save policy and report its counters.
+*
+* \param[in] prAdapter Pointer to the Adapter structure.
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID nicpmPsPolicyUninit(IN P_ADAPTER_T prAdapter)
+{
+	P_PS_POLICY_T prPolicy = &g_rPsPolicy;
+
+	cnmTimerStopTimer(prAdapter, &prPolicy->rTimer);
+	prPolicy->fgTimerStarted = FALSE;
+
+	prPolicy->au4ClassMs[prPolicy->eClass] += kalGetTimeTick() - prPolicy->rClassStart;
+	DBGLOG(NIC, INFO, "PS policy: idle %ums, bulk %ums, interactive %ums, latency mode %u, bulk mode %u, evict %u\n",
+	       prPolicy->au4ClassMs[PS_POLICY_CLASS_IDLE], prPolicy->au4ClassMs[PS_POLICY_CLASS_BULK],
+	       prPolicy->au4ClassMs[PS_POLICY_CLASS_INTERACTIVE], prPolicy->u4LatencyEnter,
+	       prPolicy->u4BulkEnter, prPolicy->u4FlowEvict);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Account an outgoing AIS data frame to its flow. Called from the
+*        main thread for every OS packet.
+*
+* \param[in] prAdapter   Pointer to the Adapter structure.
+* \param[in] prPacket    The packet, starting with its Ethernet header
+* \param[in] u4PacketLen Length of the packet
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID nicpmPsPolicyTxClassify(IN P_ADAPTER_T prAdapter, IN P_NATIVE_PACKET prPacket, IN UINT_32 u4PacketLen)
+{
+	struct sk_buff *prSkb = (struct sk_buff *)prPacket;
+	PUINT_8 pucIpHdr, pucL4Hdr;
+	P_PS_POLICY_FLOW_T prFlow;
+	UINT_16 u2EtherType;
+	UINT_32 u4IpHdrLen, u4DstAddr;
+	UINT_8 ucProto;
+
+	if (u4PacketLen < ETH_HLEN + 20 + 8 || skb_headlen(prSkb) < ETH_HLEN + 20 + 8)
+		return;
+
+	u2EtherType = (prSkb->data[ETH_TYPE_LEN_OFFSET] << 8) | prSkb->data[ETH_TYPE_LEN_OFFSET + 1];
+	if (u2EtherType != ETH_P_IP)
+		return;
+
+	pucIpHdr = &prSkb->data[ETH_HLEN];
+	u4IpHdrLen = (pucIpHdr[0] & 0x0F) << 2;
+	ucProto = pucIpHdr[IPV4_HDR_IP_PROTOCOL_OFFSET];
+	if ((ucProto != IP_PROTOCOL_UDP && ucProto != IPPROTO_TCP) ||
+	    skb_headlen(prSkb) < ETH_HLEN + u4IpHdrLen + 8)
+		return;
+
+	pucL4Hdr = &pucIpHdr[u4IpHdrLen];
+	kalMemCopy(&u4DstAddr, &pucIpHdr[IPV4_HDR_IP_DST_ADDR_OFFSET], sizeof(u4DstAddr));
+
+	prFlow = nicpmPsPolicyFindFlow(ucProto, u4DstAddr,
+				       (pucL4Hdr[0] << 8) | pucL4Hdr[1], (pucL4Hdr[2] << 8) | pucL4Hdr[3]);
+	prFlow->u4Pkts++;
+	prFlow->u4Bytes += u4PacketLen;
+
+	if (ucProto == IP_PROTOCOL_UDP && !prFlow->fgRtp)
+		prFlow->fgRtp = nicpmPsPolicyIsRtp(&pucL4Hdr[8], skb_headlen(prSkb) - (ETH_HLEN + u4IpHdrLen + 8));
+
+	if (!g_rPsPolicy.fgTimerStarted) {
+		cnmTimerStartTimer(prAdapter, &g_rPsPolicy.rTimer, PS_POLICY_WINDOW_MS);
+		g_rPsPolicy.fgTimerStarted = TRUE;
+	}
+}
+#endif /* CFG_SUPPORT_PS_POLICY */
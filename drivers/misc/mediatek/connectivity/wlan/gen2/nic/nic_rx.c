@@ -924,6 +924,10 @@ VOID nicRxInitialize(IN P_ADAPTER_T prAdapter)
 	QUEUE_INITIALIZE(&prRxCtrl->rReceivedRfbList);
 	QUEUE_INITIALIZE(&prRxCtrl->rIndicatedRfbList);
 
+#if CFG_SUPPORT_RX_POOL
+	kalRxPoolInit(prAdapter->prGlueInfo, CFG_RX_MAX_PKT_NUM);
+#endif
+
 	pucMemHandle = prRxCtrl->pucRxCached;
 	for (i = CFG_RX_MAX_PKT_NUM; i != 0; i--) {
 		prSwRfb = (P_SW_RFB_T) pucMemHandle;
@@ -1008,6 +1012,10 @@ VOID nicRxUninitialize(IN P_ADAPTER_T prAdapter)
 		}
 	} while (TRUE);
 
+#if CFG_SUPPORT_RX_POOL
+	kalRxPoolUninit(prAdapter->prGlueInfo);
+#endif
+
 }				/* end of nicRxUninitialize() */
 
 /*----------------------------------------------------------------------------*/
@@ -2730,6 +2738,8 @@ VOID nicRxProcessRFBs(IN P_ADAPTER_T prAdapter)
 #if CFG_NATIVE_802_11
 		kalRxIndicatePkts(prAdapter->prGlueInfo, (UINT_32) prRxCtrl->ucNumIndPacket,
 				  (UINT_32) prRxCtrl->ucNumRetainedPacket);
+#elif CFG_SUPPORT_RX_GRO
+		kalRxIndicatePktsGro(prAdapter->prGlueInfo, prRxCtrl->apvIndPacket, (UINT_32) prRxCtrl->ucNumIndPacket);
 #else
 		kalRxIndicatePkts(prAdapter->prGlueInfo, prRxCtrl->apvIndPacket, (UINT_32) prRxCtrl->ucNumIndPacket);
 #endif
@@ -3271,7 +3281,11 @@ WLAN_STATUS nicRxSetupRFB(IN P_ADAPTER_T prAdapter, IN P_SW_RFB_T prSwRfb)
 
 	if (!prSwRfb->pvPacket) {
 		kalMemZero(prSwRfb, sizeof(SW_RFB_T));
+#if CFG_SUPPORT_RX_POOL
+		pvPacket = kalRxPoolAlloc(prAdapter->prGlueInfo, CFG_RX_MAX_PKT_SIZE, &pucRecvBuff);
+#else
 		pvPacket = kalPacketAlloc(prAdapter->prGlueInfo, CFG_RX_MAX_PKT_SIZE, &pucRecvBuff);
+#endif
 		if (pvPacket == NULL)
 			return WLAN_STATUS_RESOURCES;
 
@@ -3342,6 +3356,8 @@ VOID nicProcessRxInterrupt(IN P_ADAPTER_T prAdapter)
 {
 	ASSERT(prAdapter);
 
+	/* all RX port reads of this interrupt form one HIF burst */
+	kalDevPortAggBegin(prAdapter->prGlueInfo);
 #if CFG_SDIO_INTR_ENHANCE
 #if CFG_SDIO_RX_AGG
 	nicRxSDIOAggReceiveRFBs(prAdapter);
@@ -3351,6 +3367,7 @@ VOID nicProcessRxInterrupt(IN P_ADAPTER_T prAdapter)
 #else
 	nicRxReceiveRFBs(prAdapter);
 #endif /* CFG_SDIO_INTR_ENHANCE */
+	kalDevPortAggEnd(prAdapter->prGlueInfo);
 
 	nicRxProcessRFBs(prAdapter);
 
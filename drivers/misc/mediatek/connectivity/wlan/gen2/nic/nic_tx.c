@@ -726,6 +726,10 @@ BOOLEAN nicTxReleaseResource(IN P_ADAPTER_T prAdapter, IN unsigned char *aucTxRl
 		ASSERT(prTxCtrl->rTc.aucFreeBufferCount[TC4_INDEX] <= prTxCtrl->rTc.aucMaxNumOfBuffer[TC4_INDEX]);
 		ASSERT(prTxCtrl->rTc.aucFreeBufferCount[TC5_INDEX] <= prTxCtrl->rTc.aucMaxNumOfBuffer[TC5_INDEX]);
 		bStatus = TRUE;
+
+#if CFG_SUPPORT_TX_DONE_DEFER
+		kalTxDoneRelease(prAdapter->prGlueInfo, aucTxRlsCnt);
+#endif
 	}
 
 	return bStatus;
@@ -773,6 +777,11 @@ WLAN_STATUS nicTxResetResource(IN P_ADAPTER_T prAdapter)
 
 	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_RESOURCE);
 
+#if CFG_SUPPORT_TX_DONE_DEFER
+	/* the firmware will not release what it held before the reset */
+	kalTxDoneFlush(prAdapter->prGlueInfo);
+#endif
+
 	return WLAN_STATUS_SUCCESS;
 }
 
@@ -880,13 +889,17 @@ WLAN_STATUS nicTxMsduInfoList(IN P_ADAPTER_T prAdapter, IN P_MSDU_INFO_T prMsduI
 		prMsduInfo = prNextMsduInfo;
 	}
 
-	/* send packets to HIF port0 or port1 here */
+	/* send packets to HIF port0 or port1 here, as one HIF burst */
+	kalDevPortAggBegin(prAdapter->prGlueInfo);
+
 	if (qDataPort0.u4NumElem > 0)
 		nicTxMsduQueue(prAdapter, 0, &qDataPort0);
 
 	if (qDataPort1.u4NumElem > 0)
 		nicTxMsduQueue(prAdapter, 1, &qDataPort1);
 
+	kalDevPortAggEnd(prAdapter->prGlueInfo);
+
 	return WLAN_STATUS_SUCCESS;
 }
 
@@ -1151,30 +1164,6 @@ VOID nicTxLifetimeRecordEn(IN P_ADAPTER_T prAdapter, IN P_MSDU_INFO_T prMsduInfo
 }
 
 #if CFG_PRINT_RTP_PROFILE
-/*
-    in:
-	data   RTP packet pointer
-	size   RTP size
-    return
-	0:audio 1: video, -1:none
-*/
-UINT8 checkRtpAV(PUINT_8 data, UINT_32 size)
-{
-	PUINT_8 buf = data + 12;
-
-	while (buf + 188 <= data + size) {
-		int pid = ((buf[1] << 8) & 0x1F00) | (buf[2] & 0xFF);
-
-		if (pid == 0 || pid == 0x100 || pid == 0x1000)
-			buf += 188;
-		else if (pid == 0x1100)
-			return 0;
-		else if (pid == 0x1011)
-			return 1;
-	}
-	return -1;
-}
-
 VOID
 nicTxLifetimeCheckRTP(IN P_ADAPTER_T prAdapter,
 		      IN P_MSDU_INFO_T prMsduInfo,
@@ -1314,6 +1303,34 @@ nicTxLifetimeCheck(IN P_ADAPTER_T prAdapter,
 
 #endif
 
+#if (CFG_ENABLE_PKT_LIFETIME_PROFILE && CFG_PRINT_RTP_PROFILE) || CFG_SUPPORT_PS_POLICY
+/*
+    in:
+	data   RTP packet pointer
+	size   RTP size
+    return
+	0:audio 1: video, -1:none
+*/
+UINT8 checkRtpAV(PUINT_8 data, UINT_32 size)
+{
+	PUINT_8 buf = data + 12;
+
+	while (buf + 188 <= data + size) {
+		int pid = ((buf[1] << 8) & 0x1F00) | (buf[2] & 0xFF);
+
+		if (pid == 0 || pid == 0x100 || pid == 0x1000)
+			buf += 188;
+		else if (pid == 0x1100)
+			return 0;
+		else if (pid == 0x1011)
+			return 1;
+		else
+			buf += 188;
+	}
+	return -1;
+}
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*!
 * @brief In this function, we'll write frame(PACKET_INFO_T) into HIF.
@@ -1520,10 +1537,21 @@ WLAN_STATUS nicTxMsduQueue(IN P_ADAPTER_T prAdapter, UINT_8 ucPortIdx, P_QUE_T p
 				/* only free MSDU when it is not a MGMT frame */
 				QUEUE_INSERT_TAIL(&rFreeQueue, (P_QUE_ENTRY_T) prMsduInfo);
 
+#if CFG_SUPPORT_TX_DONE_DEFER
+				/* complete the skb when the firmware gives the TC buffer back */
+				if (prMsduInfo->eSrc == TX_PACKET_OS) {
+					if (!kalTxDoneDefer(prAdapter->prGlueInfo, prMsduInfo->ucTC, prNativePacket))
+						kalSendComplete(prAdapter->prGlueInfo, prNativePacket, WLAN_STATUS_SUCCESS);
+				} else if (prMsduInfo->eSrc == TX_PACKET_FORWARDING) {
+					GLUE_DEC_REF_CNT(prTxCtrl->i4PendingFwdFrameCount);
+					kalTxDoneDefer(prAdapter->prGlueInfo, prMsduInfo->ucTC, NULL);
+				}
+#else
 				if (prMsduInfo->eSrc == TX_PACKET_OS)
 					kalSendComplete(prAdapter->prGlueInfo, prNativePacket, WLAN_STATUS_SUCCESS);
 				else if (prMsduInfo->eSrc == TX_PACKET_FORWARDING)
 					GLUE_DEC_REF_CNT(prTxCtrl->i4PendingFwdFrameCount);
+#endif
 			}
 
 			prMsduInfo = prNextMsduInfo;
@@ -1779,6 +1807,10 @@ VOID nicTxRelease(IN P_ADAPTER_T prAdapter)
 
 	nicTxFlush(prAdapter);
 
+#if CFG_SUPPORT_TX_DONE_DEFER
+	kalTxDoneFlush(prAdapter->prGlueInfo);
+#endif
+
 	/* free MSDU_INFO_T from rTxMgmtMsduInfoList */
 	do {
 		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TXING_MGMT_LIST);
@@ -1986,6 +2018,11 @@ BOOLEAN nicTxFillMsduInfo(IN P_ADAPTER_T prAdapter, IN P_MSDU_INFO_T prMsduInfo,
 	nicTxLifetimeCheck(prAdapter, prMsduInfo, prPacket, ucPriorityParam, u4PacketLen, ucNetworkType);
 #endif
 
+#if CFG_SUPPORT_PS_POLICY
+	if (ucNetworkType == NETWORK_TYPE_AIS_INDEX && !fgIs1x)
+		nicpmPsPolicyTxClassify(prAdapter, prPacket, u4PacketLen);
+#endif
+
 	/* Save the value of Priority Parameter */
 	GLUE_SET_PKT_TID(prPacket, ucPriorityParam);
 
@@ -2044,6 +2081,15 @@ WLAN_STATUS nicTxAdjustTcq(IN P_ADAPTER_T prAdapter)
 	ASSERT(prTxCtrl);
 
 	qmAdjustTcQuotas(prAdapter, &rTcqAdjust, &prTxCtrl->rTc);
+
+	/* nothing to apply unless a reassignment is being annealed */
+	for (u4Num = 0; u4Num < TC_NUM; u4Num++) {
+		if (rTcqAdjust.acVariation[u4Num])
+			break;
+	}
+	if (u4Num == TC_NUM)
+		return WLAN_STATUS_SUCCESS;
+
 	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_RESOURCE);
 
 	for (u4Num = 0; u4Num < TC_NUM; u4Num++) {
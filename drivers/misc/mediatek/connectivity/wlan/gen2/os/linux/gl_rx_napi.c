@@ -0,0 +1,171 @@
+/*! \file   gl_rx_napi.c
+*    \brief  NAPI/GRO delivery of received data frames.
+*
+*    The main thread used to push every frame of an RX batch into the stack
+*    with netif_rx().  Frames of the AIS interface are now queued to a NAPI
+*    context instead, so that the in-sequence frames coming out of the
+*    reordering path are merged by GRO before they reach TCP.
+*/
+
+/*******************************************************************************
+*                         C O M P I L E R   F L A G S
+********************************************************************************
+*/
+
+/*******************************************************************************
+*                    E X T E R N A L   R E F E R E N C E S
+********************************************************************************
+*/
+#include "precomp.h"
+#include "gl_os.h"
+#include "gl_kal.h"
+
+#if CFG_SUPPORT_RX_GRO
+
+/*******************************************************************************
+*                              C O N S T A N T S
+********************************************************************************
+*/
+#define RX_NAPI_WEIGHT		64
+/* the main thread stops queueing to NAPI when the softirq falls this far behind */
+#define RX_NAPI_QUEUE_MAX	1024
+
+/*******************************************************************************
+*                              F U N C T I O N S
+********************************************************************************
+*/
+
+static int kalRxNapiPoll(struct napi_struct *napi, int budget)
+{
+	P_GLUE_INFO_T prGlueInfo = container_of(napi, GLUE_INFO_T, rRxNapi);
+	struct sk_buff *prSkb;
+	int work = 0;
+
+	while (work < budget) {
+		prSkb = skb_dequeue(&prGlueInfo->rRxNapiQueue);
+		if (!prSkb)
+			break;
+		napi_gro_receive(napi, prSkb);
+		work++;
+	}
+
+	if (work < budget) {
+		napi_complete(napi);
+		/* a frame queued after the last dequeue would be stranded */
+		if (!skb_queue_empty(&prGlueInfo->rRxNapiQueue))
+			napi_schedule(napi);
+	}
+	return work;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Set up the RX NAPI context on the AIS net device. Called once the
+*        net device has been allocated.
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalRxNapiInit(IN P_GLUE_INFO_T prGlueInfo)
+{
+	ASSERT(prGlueInfo);
+	ASSERT(prGlueInfo->prDevHandler);
+
+	skb_queue_head_init(&prGlueInfo->rRxNapiQueue);
+	netif_napi_add(prGlueInfo->prDevHandler, &prGlueInfo->rRxNapi, kalRxNapiPoll, RX_NAPI_WEIGHT);
+	napi_enable(&prGlueInfo->rRxNapi);
+	prGlueInfo->fgRxNapiEnabled = TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Tear down the RX NAPI context and drop the frames still queued.
+*        Called before the net device is freed.
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalRxNapiUninit(IN P_GLUE_INFO_T prGlueInfo)
+{
+	ASSERT(prGlueInfo);
+
+	if (!prGlueInfo->fgRxNapiEnabled)
+		return;
+
+	prGlueInfo->fgRxNapiEnabled = FALSE;
+	napi_disable(&prGlueInfo->rRxNapi);
+	netif_napi_del(&prGlueInfo->rRxNapi);
+	skb_queue_purge(&prGlueInfo->rRxNapiQueue);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Indicate a batch of received packets. AIS frames are queued to the
+*        NAPI context and handed to GRO from softirq; P2P and BOW frames,
+*        and everything while NAPI is not set up, take the netif_rx() path
+*        of kalRxIndicatePkts().
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+* \param[in] apvPkts    Array of packets to indicate
+* \param[in] ucPktNum   Number of packets in apvPkts
+*
+* \retval WLAN_STATUS_SUCCESS
+*/
+/*----------------------------------------------------------------------------*/
+WLAN_STATUS kalRxIndicatePktsGro(IN P_GLUE_INFO_T prGlueInfo, IN PVOID apvPkts[], IN UINT_8 ucPktNum)
+{
+	struct net_device *prNetDev = prGlueInfo->prDevHandler;
+	PVOID apvSlowPkts[CFG_RX_MAX_PKT_NUM];
+	UINT_8 ucSlowNum = 0;
+	UINT_8 ucQueued = 0;
+	UINT_8 ucIdx;
+
+	ASSERT(prGlueInfo);
+
+	if (!prGlueInfo->fgRxNapiEnabled ||
+	    skb_queue_len(&prGlueInfo->rRxNapiQueue) >= RX_NAPI_QUEUE_MAX)
+		return kalRxIndicatePkts(prGlueInfo, apvPkts, ucPktNum);
+
+	for (ucIdx = 0; ucIdx < ucPktNum; ucIdx++) {
+		struct sk_buff *prSkb = apvPkts[ucIdx];
+
+		if (!prSkb)
+			continue;
+
+		if (GLUE_GET_PKT_IS_P2P(prSkb) || GLUE_GET_PKT_IS_PAL(prSkb)) {
+			apvSlowPkts[ucSlowNum++] = prSkb;
+			continue;
+		}
+
+		prGlueInfo->rNetDevStats.rx_bytes += prSkb->len;
+		prGlueInfo->rNetDevStats.rx_packets++;
+		prNetDev->last_rx = jiffies;
+
+		prSkb->protocol = eth_type_trans(prSkb, prNetDev);
+		prSkb->dev = prNetDev;
+
+		skb_queue_tail(&prGlueInfo->rRxNapiQueue, prSkb);
+		ucQueued++;
+
+		/* the skb now belongs to the stack, recycle its RFB */
+		wlanReturnPacket(prGlueInfo->prAdapter, NULL);
+	}
+
+	if (ucQueued) {
+		/* raise the softirq on bh enable rather than at the next irq exit */
+		local_bh_disable();
+		napi_schedule(&prGlueInfo->rRxNapi);
+		local_bh_enable();
+	}
+
+	if (ucSlowNum)
+		kalRxIndicatePkts(prGlueInfo, apvSlowPkts, ucSlowNum);
+
+	return WLAN_STATUS_SUCCESS;
+}
+
+#endif /* CFG_SUPPORT_RX_GRO */
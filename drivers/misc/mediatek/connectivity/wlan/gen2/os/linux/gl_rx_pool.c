@@ -0,0 +1,163 @@
+/*! \file   gl_rx_pool.c
+*    \brief  Recycled page-backed RX buffers.
+*
+*    Every SW_RFB used to get a fresh skb from the slab once its previous
+*    one was indicated to the stack.  The pool keeps one page per RX buffer
+*    plus some slack for frames still held by the stack, and builds the RX
+*    skbs on top of them with build_skb().  When the stack frees such an skb
+*    only its page reference goes away; once the page is back to the pool's
+*    own reference it is reused for the next buffer.
+*/
+
+/*******************************************************************************
+*                         C O M P I L E R   F L A G S
+********************************************************************************
+*/
+
+/*******************************************************************************
+*                    E X T E R N A L   R E F E R E N C E S
+********************************************************************************
+*/
+#include "precomp.h"
+#include "gl_os.h"
+#include "gl_kal.h"
+
+#if CFG_SUPPORT_RX_POOL
+
+/*******************************************************************************
+*                              C O N S T A N T S
+********************************************************************************
+*/
+/* pages on top of the RX ring for frames sitting in socket queues */
+#define RX_POOL_EXTRA_PAGES	64
+
+/*******************************************************************************
+*                              F U N C T I O N S
+********************************************************************************
+*/
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Allocate the RX page pool for an RX ring of u4RingSize buffers.
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+* \param[in] u4RingSize Number of SW_RFBs
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalRxPoolInit(IN P_GLUE_INFO_T prGlueInfo, IN UINT_32 u4RingSize)
+{
+	UINT_32 u4Size = u4RingSize + RX_POOL_EXTRA_PAGES;
+	UINT_32 i;
+
+	ASSERT(prGlueInfo);
+
+	if (prGlueInfo->aprRxPoolPage)
+		return;
+
+	prGlueInfo->aprRxPoolPage = kcalloc(u4Size, sizeof(struct page *), GFP_KERNEL);
+	if (!prGlueInfo->aprRxPoolPage) {
+		DBGLOG(INIT, WARN, "RX pool: no memory, using the slab\n");
+		return;
+	}
+
+	for (i = 0; i < u4Size; i++) {
+		prGlueInfo->aprRxPoolPage[i] = alloc_page(GFP_KERNEL);
+		if (!prGlueInfo->aprRxPoolPage[i])
+			break;
+	}
+	/* a short pool still works, it just falls back to the slab sooner */
+	prGlueInfo->u4RxPoolSize = i;
+	prGlueInfo->u4RxPoolNext = 0;
+	kalMemZero(&prGlueInfo->rRxPoolStats, sizeof(prGlueInfo->rRxPoolStats));
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Drop the pool's page references. Pages still attached to skbs in
+*        the stack are freed when those skbs are.
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalRxPoolUninit(IN P_GLUE_INFO_T prGlueInfo)
+{
+	UINT_32 i;
+
+	ASSERT(prGlueInfo);
+
+	if (!prGlueInfo->aprRxPoolPage)
+		return;
+
+	DBGLOG(INIT, INFO, "RX pool: %u pages, recycled %u, busy %u, alloc fail %u\n",
+	       prGlueInfo->u4RxPoolSize, prGlueInfo->rRxPoolStats.u4Recycled,
+	       prGlueInfo->rRxPoolStats.u4Busy, prGlueInfo->rRxPoolStats.u4AllocFail);
+
+	for (i = 0; i < prGlueInfo->u4RxPoolSize; i++)
+		put_page(prGlueInfo->aprRxPoolPage[i]);
+
+	kfree(prGlueInfo->aprRxPoolPage);
+	prGlueInfo->aprRxPoolPage = NULL;
+	prGlueInfo->u4RxPoolSize = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Allocate an RX packet, from a free pool page when there is one and
+*        from the slab through kalPacketAlloc() otherwise.
+*
+* \param[in]  prGlueInfo Pointer of GLUE Data Structure
+* \param[in]  u4Size     Buffer size needed
+* \param[out] ppucData   Start of the packet buffer
+*
+* \return the packet, or NULL
+*/
+/*----------------------------------------------------------------------------*/
+PVOID kalRxPoolAlloc(IN P_GLUE_INFO_T prGlueInfo, IN UINT_32 u4Size, OUT PUINT_8 *ppucData)
+{
+	P_GL_RX_POOL_STATS_T prStats = &prGlueInfo->rRxPoolStats;
+	struct sk_buff *prSkb;
+	struct page *prPage = NULL;
+	UINT_32 u4Idx = prGlueInfo->u4RxPoolNext;
+	UINT_32 i;
+
+	if (!prGlueInfo->aprRxPoolPage ||
+	    NET_SKB_PAD + u4Size > PAGE_SIZE - SKB_DATA_ALIGN(sizeof(struct skb_shared_info)))
+		return kalPacketAlloc(prGlueInfo, u4Size, ppucData);
+
+	/* pages go out in ring order, so the oldest one is normally free again */
+	for (i = 0; i < prGlueInfo->u4RxPoolSize; i++) {
+		if (page_count(prGlueInfo->aprRxPoolPage[u4Idx]) == 1) {
+			prPage = prGlueInfo->aprRxPoolPage[u4Idx];
+			break;
+		}
+		if (++u4Idx == prGlueInfo->u4RxPoolSize)
+			u4Idx = 0;
+	}
+
+	if (!prPage) {
+		/* the stack holds every page: pool pressure */
+		prStats->u4Busy++;
+		return kalPacketAlloc(prGlueInfo, u4Size, ppucData);
+	}
+
+	get_page(prPage);
+	prSkb = build_skb(page_address(prPage), PAGE_SIZE);
+	if (!prSkb) {
+		put_page(prPage);
+		prStats->u4AllocFail++;
+		return kalPacketAlloc(prGlueInfo, u4Size, ppucData);
+	}
+
+	prGlueInfo->u4RxPoolNext = (u4Idx + 1 == prGlueInfo->u4RxPoolSize) ? 0 : u4Idx + 1;
+	prStats->u4Recycled++;
+
+	skb_reserve(prSkb, NET_SKB_PAD);
+	*ppucData = (PUINT_8) prSkb->data;
+	return (PVOID) prSkb;
+}
+
+#endif /* CFG_SUPPORT_RX_POOL */
@@ -0,0 +1,366 @@
+/*! \file   gl_tx_ac.c
+*    \brief  Per-AC software TX queues between the net device and QM.
+*
+*    The xmit path pushes packets onto one lock-less list per access
+*    category.  The main thread is the only consumer: it moves them into QM
+*    highest AC first, and keeps the number of packets each AC has sitting
+*    in QM under an adaptive, BQL-style limit.  Bulk traffic then queues up
+*    here, where voice and video frames can still overtake it, instead of in
+*    the per-STA queues ahead of them.
+*
+*    Pure TCP ACKs are queued with video so that downloads are not slowed by
+*    the uplink data in front of them, and an ACK that is cumulatively
+*    covered by the next one of the same flow in the batch is dropped.
+*/
+
+/*******************************************************************************
+*                         C O M P I L E R   F L A G S
+********************************************************************************
+*/
+
+/*******************************************************************************
+*                    E X T E R N A L   R E F E R E N C E S
+********************************************************************************
+*/
+#include "precomp.h"
+#include "gl_os.h"
+#include "gl_kal.h"
+
+#include <net/ipv6.h>
+#include <net/tcp.h>
+
+#if CFG_SUPPORT_TX_AC_QUEUE
+
+/*******************************************************************************
+*                              C O N S T A N T S
+********************************************************************************
+*/
+#define TX_AC_LIMIT_MIN		16	/* packets in QM per AC */
+#define TX_AC_LIMIT_MAX		512
+#define TX_AC_ADJUST_ROUNDS	64	/* service rounds between limit decreases */
+#define TX_AC_ACK_QUEUE		2	/* VI */
+
+/*******************************************************************************
+*                                 M A C R O S
+********************************************************************************
+*/
+/* the llist node shares cb[0] with the QUE_ENTRY_T used once the packet is in QM */
+#define TX_AC_GET_NODE(_p)	((struct llist_node *)GLUE_GET_PKT_QUEUE_ENTRY(_p))
+
+/*******************************************************************************
+*                              F U N C T I O N S
+********************************************************************************
+*/
+
+/* a TCP segment without payload, flags other than ACK or options other than timestamps */
+static struct tcphdr *kalTxAcGetPureAck(IN struct sk_buff *prSkb)
+{
+	struct ethhdr *prEthHdr = (struct ethhdr *)prSkb->data;
+	struct tcphdr *prTcpHdr;
+	UINT_32 u4L4Off, u4L3Len;
+	PUINT_8 pucOpt;
+
+	if (prEthHdr->h_proto == htons(ETH_P_IP)) {
+		struct iphdr *prIpHdr = (struct iphdr *)(prSkb->data + ETH_HLEN);
+
+		if (skb_headlen(prSkb) < ETH_HLEN + sizeof(struct iphdr) + sizeof(struct tcphdr) ||
+		    prIpHdr->protocol != IPPROTO_TCP || (prIpHdr->frag_off & htons(IP_MF | IP_OFFSET)))
+			return NULL;
+		u4L4Off = ETH_HLEN + (prIpHdr->ihl << 2);
+		u4L3Len = ETH_HLEN + ntohs(prIpHdr->tot_len);
+	} else if (prEthHdr->h_proto == htons(ETH_P_IPV6)) {
+		struct ipv6hdr *prIp6Hdr = (struct ipv6hdr *)(prSkb->data + ETH_HLEN);
+
+		if (skb_headlen(prSkb) < ETH_HLEN + sizeof(struct ipv6hdr) + sizeof(struct tcphdr) ||
+		    prIp6Hdr->nexthdr != IPPROTO_TCP)
+			return NULL;
+		u4L4Off = ETH_HLEN + sizeof(struct ipv6hdr);
+		u4L3Len = u4L4Off + ntohs(prIp6Hdr->payload_len);
+	} else {
+		return NULL;
+	}
+
+	if (skb_headlen(prSkb) < u4L4Off + sizeof(struct tcphdr))
+		return NULL;
+	prTcpHdr = (struct tcphdr *)(prSkb->data + u4L4Off);
+
+	if (tcp_flag_word(prTcpHdr) & (TCP_FLAG_SYN | TCP_FLAG_FIN | TCP_FLAG_RST | TCP_FLAG_URG |
+				       TCP_FLAG_ECE | TCP_FLAG_CWR | TCP_FLAG_PSH) ||
+	    !prTcpHdr->ack || u4L3Len != u4L4Off + (prTcpHdr->doff << 2))
+		return NULL;
+
+	/* SACK blocks and other options have to reach the peer */
+	if (prTcpHdr->doff == 5)
+		return prTcpHdr;
+	pucOpt = (PUINT_8) (prTcpHdr + 1);
+	if (prTcpHdr->doff == 8 && skb_headlen(prSkb) >= u4L3Len &&
+	    pucOpt[0] == TCPOPT_NOP && pucOpt[1] == TCPOPT_NOP && pucOpt[2] == TCPOPT_TIMESTAMP)
+		return prTcpHdr;
+
+	return NULL;
+}
+
+/* prNew acknowledges everything prOld does, for the same connection */
+static BOOLEAN kalTxAcAckCovers(IN struct sk_buff *prOld, IN struct tcphdr *prOldTcp,
+				IN struct sk_buff *prNew, IN struct tcphdr *prNewTcp)
+{
+	UINT_32 u4HdrLen = (PUINT_8) prNewTcp - prNew->data;
+
+	if ((PUINT_8) prOldTcp - prOld->data != u4HdrLen ||
+	    prOldTcp->source != prNewTcp->source || prOldTcp->dest != prNewTcp->dest)
+		return FALSE;
+
+	/* duplicate ACKs drive fast retransmit, keep them all */
+	if (!after(ntohl(prNewTcp->ack_seq), ntohl(prOldTcp->ack_seq)))
+		return FALSE;
+
+	if (((struct ethhdr *)prOld->data)->h_proto != ((struct ethhdr *)prNew->data)->h_proto)
+		return FALSE;
+
+	if (((struct ethhdr *)prNew->data)->h_proto == htons(ETH_P_IP)) {
+		struct iphdr *prOldIp = (struct iphdr *)(prOld->data + ETH_HLEN);
+		struct iphdr *prNewIp = (struct iphdr *)(prNew->data + ETH_HLEN);
+
+		return (prOldIp->saddr == prNewIp->saddr && prOldIp->daddr == prNewIp->daddr) ? TRUE : FALSE;
+	} else {
+		struct ipv6hdr *prOldIp6 = (struct ipv6hdr *)(prOld->data + ETH_HLEN);
+		struct ipv6hdr *prNewIp6 = (struct ipv6hdr *)(prNew->data + ETH_HLEN);
+
+		return (ipv6_addr_equal(&prOldIp6->saddr, &prNewIp6->saddr) &&
+			ipv6_addr_equal(&prOldIp6->daddr, &prNewIp6->daddr)) ? TRUE : FALSE;
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Initialize the per-AC TX queues. Once this is called the xmit path
+*        must queue OS packets with kalTxAcEnqueue().
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalTxAcInit(IN P_GLUE_INFO_T prGlueInfo)
+{
+	UINT_32 i;
+
+	ASSERT(prGlueInfo);
+
+	for (i = 0; i < CFG_MAX_TXQ_NUM; i++) {
+		init_llist_head(&prGlueInfo->arTxAcList[i]);
+		QUEUE_INITIALIZE(&prGlueInfo->arTxAcQueue[i]);
+		atomic_set(&prGlueInfo->arTxAcInflight[i], 0);
+		prGlueInfo->au4TxAcLimit[i] = TX_AC_LIMIT_MIN;
+		prGlueInfo->au4TxAcMinInflight[i] = ~0U;
+	}
+	prGlueInfo->u4TxAcRounds = 0;
+	prGlueInfo->fgTxAcEnabled = TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Complete every packet still waiting in the per-AC TX queues. Called
+*        with the net device queues stopped and the main thread halted.
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalTxAcUninit(IN P_GLUE_INFO_T prGlueInfo)
+{
+	struct llist_node *prNode, *prNext;
+	P_QUE_ENTRY_T prQueueEntry;
+	UINT_32 i;
+
+	ASSERT(prGlueInfo);
+
+	if (!prGlueInfo->fgTxAcEnabled)
+		return;
+	prGlueInfo->fgTxAcEnabled = FALSE;
+
+	for (i = 0; i < CFG_MAX_TXQ_NUM; i++) {
+		prNode = llist_del_all(&prGlueInfo->arTxAcList[i]);
+		while (prNode) {
+			prNext = prNode->next;
+			kalSendComplete(prGlueInfo, GLUE_GET_PKT_DESCRIPTOR(prNode), WLAN_STATUS_NOT_ACCEPTED);
+			prNode = prNext;
+		}
+
+		while (QUEUE_IS_NOT_EMPTY(&prGlueInfo->arTxAcQueue[i])) {
+			QUEUE_REMOVE_HEAD(&prGlueInfo->arTxAcQueue[i], prQueueEntry, P_QUE_ENTRY_T);
+			kalSendComplete(prGlueInfo, GLUE_GET_PKT_DESCRIPTOR(prQueueEntry), WLAN_STATUS_NOT_ACCEPTED);
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Queue an OS packet for transmission. Safe against concurrent
+*        callers and against the main thread draining the queue; the caller
+*        still wakes the main thread with kalSetEvent().
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+* \param[in] prSkb      The packet
+* \param[in] ucQueIdx   Net device TX queue (AC) of the packet
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalTxAcEnqueue(IN P_GLUE_INFO_T prGlueInfo, IN struct sk_buff *prSkb, IN UINT_8 ucQueIdx)
+{
+	if (ucQueIdx >= CFG_MAX_TXQ_NUM)
+		ucQueIdx = CFG_MAX_TXQ_NUM - 1;
+
+	/* the air AC still comes from the TID, only the service order changes */
+	if (ucQueIdx < TX_AC_ACK_QUEUE && kalTxAcGetPureAck(prSkb))
+		ucQueIdx = TX_AC_ACK_QUEUE;
+
+	GLUE_SET_PKT_TX_AC(prSkb, 0);
+	llist_add(TX_AC_GET_NODE(prSkb), &prGlueInfo->arTxAcList[ucQueIdx]);
+}
+
+/* the inflight count only goes up here, so the limit is checked lock-less */
+static VOID kalTxAcServiceQueue(IN P_GLUE_INFO_T prGlueInfo, IN UINT_32 u4Ac)
+{
+	P_QUE_T prQue = &prGlueInfo->arTxAcQueue[u4Ac];
+	atomic_t *prInflight = &prGlueInfo->arTxAcInflight[u4Ac];
+	struct llist_node *prNode, *prNext;
+	P_QUE_ENTRY_T prQueueEntry;
+	struct sk_buff *prSkb, *prAckSkb = NULL;
+	struct tcphdr *prTcpHdr, *prAckTcpHdr = NULL;
+	UINT_32 u4Inflight;
+	WLAN_STATUS rStatus;
+
+	prNode = llist_del_all(&prGlueInfo->arTxAcList[u4Ac]);
+	if (prNode) {
+		prNode = llist_reverse_order(prNode);
+		while (prNode) {
+			prNext = prNode->next;
+			prSkb = (struct sk_buff *)GLUE_GET_PKT_DESCRIPTOR(prNode);
+			prTcpHdr = (u4Ac == TX_AC_ACK_QUEUE) ? kalTxAcGetPureAck(prSkb) : NULL;
+
+			/* hold back the last ACK, the next one may supersede it */
+			if (prAckSkb) {
+				if (prTcpHdr && kalTxAcAckCovers(prAckSkb, prAckTcpHdr, prSkb, prTcpHdr))
+					kalSendComplete(prGlueInfo, prAckSkb, WLAN_STATUS_SUCCESS);
+				else
+					QUEUE_INSERT_TAIL(prQue, (P_QUE_ENTRY_T) GLUE_GET_PKT_QUEUE_ENTRY(prAckSkb));
+				prAckSkb = NULL;
+			}
+
+			if (prTcpHdr) {
+				prAckSkb = prSkb;
+				prAckTcpHdr = prTcpHdr;
+			} else {
+				QUEUE_INSERT_TAIL(prQue, (P_QUE_ENTRY_T) prNode);
+			}
+			prNode = prNext;
+		}
+		if (prAckSkb)
+			QUEUE_INSERT_TAIL(prQue, (P_QUE_ENTRY_T) GLUE_GET_PKT_QUEUE_ENTRY(prAckSkb));
+	}
+
+	if (QUEUE_IS_EMPTY(prQue))
+		return;
+
+	u4Inflight = atomic_read(prInflight);
+	/* QM ran dry for this AC while packets waited here: the limit is too low */
+	if (u4Inflight == 0 && prGlueInfo->au4TxAcLimit[u4Ac] < TX_AC_LIMIT_MAX)
+		prGlueInfo->au4TxAcLimit[u4Ac] = min_t(UINT_32, prGlueInfo->au4TxAcLimit[u4Ac] * 2, TX_AC_LIMIT_MAX);
+	if (u4Inflight < prGlueInfo->au4TxAcMinInflight[u4Ac])
+		prGlueInfo->au4TxAcMinInflight[u4Ac] = u4Inflight;
+
+	while (QUEUE_IS_NOT_EMPTY(prQue) && atomic_read(prInflight) < prGlueInfo->au4TxAcLimit[u4Ac]) {
+		QUEUE_REMOVE_HEAD(prQue, prQueueEntry, P_QUE_ENTRY_T);
+		prSkb = (struct sk_buff *)GLUE_GET_PKT_DESCRIPTOR(prQueueEntry);
+
+		GLUE_SET_PKT_TX_AC(prSkb, u4Ac + 1);
+		atomic_inc(prInflight);
+
+		rStatus = wlanEnqueueTxPacket(prGlueInfo->prAdapter, (P_NATIVE_PACKET) prSkb);
+		if (rStatus == WLAN_STATUS_RESOURCES) {
+			QUE_T rRetryQue;
+
+			/* out of MSDU_INFO_T: put it back in front, retry on the next round */
+			atomic_dec(prInflight);
+			GLUE_SET_PKT_TX_AC(prSkb, 0);
+			QUEUE_INITIALIZE(&rRetryQue);
+			QUEUE_INSERT_TAIL(&rRetryQue, prQueueEntry);
+			QUEUE_CONCATENATE_QUEUES(&rRetryQue, prQue);
+			QUEUE_MOVE_ALL(prQue, &rRetryQue);
+			break;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Move queued packets into QM, VO first. Only the main thread calls
+*        this.
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+*
+* \retval TRUE  Packets are still waiting in the per-AC queues
+* \retval FALSE All per-AC queues are empty
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN kalTxAcService(IN P_GLUE_INFO_T prGlueInfo)
+{
+	BOOLEAN fgPending = FALSE;
+	INT_32 i;
+
+	ASSERT(prGlueInfo);
+
+	for (i = CFG_MAX_TXQ_NUM - 1; i >= 0; i--) {
+		kalTxAcServiceQueue(prGlueInfo, i);
+		if (QUEUE_IS_NOT_EMPTY(&prGlueInfo->arTxAcQueue[i]))
+			fgPending = TRUE;
+	}
+
+	/* give back the slack an AC never used over the last rounds */
+	if (++prGlueInfo->u4TxAcRounds >= TX_AC_ADJUST_ROUNDS) {
+		prGlueInfo->u4TxAcRounds = 0;
+		for (i = 0; i < CFG_MAX_TXQ_NUM; i++) {
+			UINT_32 u4Slack = prGlueInfo->au4TxAcMinInflight[i];
+
+			if (u4Slack != ~0U && u4Slack > 1) {
+				prGlueInfo->au4TxAcLimit[i] -= u4Slack / 2;
+				if (prGlueInfo->au4TxAcLimit[i] < TX_AC_LIMIT_MIN)
+					prGlueInfo->au4TxAcLimit[i] = TX_AC_LIMIT_MIN;
+			}
+			prGlueInfo->au4TxAcMinInflight[i] = ~0U;
+		}
+	}
+
+	return fgPending;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Account a completed packet to its AC. Called through
+*        kalSendComplete() before the packet is freed.
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+* \param[in] pvPacket   The completed packet
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalTxAcComplete(IN P_GLUE_INFO_T prGlueInfo, IN PVOID pvPacket)
+{
+	UINT_8 ucAc;
+
+	if (!prGlueInfo->fgTxAcEnabled || !pvPacket)
+		return;
+
+	ucAc = GLUE_GET_PKT_TX_AC(pvPacket);
+	if (ucAc == 0 || ucAc > CFG_MAX_TXQ_NUM)
+		return;
+
+	GLUE_SET_PKT_TX_AC(pvPacket, 0);
+	atomic_dec(&prGlueInfo->arTxAcInflight[ucAc - 1]);
+}
+
+#endif /* CFG_SUPPORT_TX_AC_QUEUE */
@@ -0,0 +1,142 @@
+/*! \file   gl_tx_done.c
+*    \brief  Complete OS packets when the firmware has consumed them.
+*
+*    The data is copied into the HIF coalescing buffer, so the skb used to be
+*    completed right after the port write. TCP small queues then saw every
+*    packet leave at once and could not limit what sits in the firmware.
+*    The skbs are now kept, per TC, until the firmware gives the TC buffer
+*    back, which it does in transmit order.
+*/
+
+/*******************************************************************************
+*                         C O M P I L E R   F L A G S
+********************************************************************************
+*/
+
+/*******************************************************************************
+*                    E X T E R N A L   R E F E R E N C E S
+********************************************************************************
+*/
+#include "precomp.h"
+#include "gl_os.h"
+#include "gl_kal.h"
+
+#if CFG_SUPPORT_TX_DONE_DEFER
+
+/*******************************************************************************
+*                              C O N S T A N T S
+********************************************************************************
+*/
+/* TC4 carries commands as well, and those never show up here */
+#define TX_DONE_TC_TRACKED(_ucTC)	((_ucTC) < GL_TX_DONE_TC_NUM && (_ucTC) != TC4_INDEX)
+
+/*******************************************************************************
+*                              F U N C T I O N S
+********************************************************************************
+*/
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Record a frame that took a TC buffer. OS packets are completed by
+*        kalTxDoneRelease() once the firmware returns the buffer.
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+* \param[in] ucTC       TC the frame was sent on
+* \param[in] pvPacket   The OS packet, or NULL for a frame without one
+*
+* \retval TRUE  The packet is kept and will be completed later
+* \retval FALSE The caller completes the packet now
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN kalTxDoneDefer(IN P_GLUE_INFO_T prGlueInfo, IN UINT_8 ucTC, IN PVOID pvPacket)
+{
+	P_GL_TX_DONE_RING_T prRing;
+	BOOLEAN fgDeferred = FALSE;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	if (!TX_DONE_TC_TRACKED(ucTC))
+		return FALSE;
+
+	prRing = &prGlueInfo->arTxDoneRing[ucTC];
+
+	KAL_ACQUIRE_SPIN_LOCK(prGlueInfo->prAdapter, SPIN_LOCK_TX_RESOURCE);
+	/* a TC never has more buffers outstanding than the ring holds */
+	if ((UINT_8) (prRing->ucTail + 1) != prRing->ucHead) {
+		prRing->apvPkt[prRing->ucTail++] = pvPacket;
+		fgDeferred = TRUE;
+	}
+	KAL_RELEASE_SPIN_LOCK(prGlueInfo->prAdapter, SPIN_LOCK_TX_RESOURCE);
+
+	return fgDeferred;
+}
+
+static VOID kalTxDoneComplete(IN P_GLUE_INFO_T prGlueInfo, IN PUINT_8 aucTxRlsCnt)
+{
+	P_GL_TX_DONE_RING_T prRing;
+	QUE_T rDoneQue;
+	P_QUE_ENTRY_T prQueueEntry;
+	PVOID pvPacket;
+	UINT_32 u4Cnt;
+	UINT_8 ucTC;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	QUEUE_INITIALIZE(&rDoneQue);
+
+	KAL_ACQUIRE_SPIN_LOCK(prGlueInfo->prAdapter, SPIN_LOCK_TX_RESOURCE);
+	for (ucTC = 0; ucTC < GL_TX_DONE_TC_NUM; ucTC++) {
+		if (!TX_DONE_TC_TRACKED(ucTC))
+			continue;
+
+		prRing = &prGlueInfo->arTxDoneRing[ucTC];
+		/* NULL: everything. Releases during firmware download find an empty ring */
+		u4Cnt = aucTxRlsCnt ? aucTxRlsCnt[ucTC] : 0xFF;
+		while (u4Cnt-- && prRing->ucHead != prRing->ucTail) {
+			pvPacket = prRing->apvPkt[prRing->ucHead++];
+			if (pvPacket)
+				QUEUE_INSERT_TAIL(&rDoneQue, (P_QUE_ENTRY_T) GLUE_GET_PKT_QUEUE_ENTRY(pvPacket));
+		}
+	}
+	KAL_RELEASE_SPIN_LOCK(prGlueInfo->prAdapter, SPIN_LOCK_TX_RESOURCE);
+
+	while (QUEUE_IS_NOT_EMPTY(&rDoneQue)) {
+		QUEUE_REMOVE_HEAD(&rDoneQue, prQueueEntry, P_QUE_ENTRY_T);
+		kalSendComplete(prGlueInfo, GLUE_GET_PKT_DESCRIPTOR(prQueueEntry), WLAN_STATUS_SUCCESS);
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Complete the oldest packets of each TC for the TC buffers the
+*        firmware has released.
+*
+* \param[in] prGlueInfo  Pointer of GLUE Data Structure
+* \param[in] aucTxRlsCnt Released buffer count per TC
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalTxDoneRelease(IN P_GLUE_INFO_T prGlueInfo, IN PUINT_8 aucTxRlsCnt)
+{
+	ASSERT(aucTxRlsCnt);
+
+	kalTxDoneComplete(prGlueInfo, aucTxRlsCnt);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Complete every kept packet. Called when the TC buffer counts are
+*        reset and when TX is torn down.
+*
+* \param[in] prGlueInfo Pointer of GLUE Data Structure
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalTxDoneFlush(IN P_GLUE_INFO_T prGlueInfo)
+{
+	kalTxDoneComplete(prGlueInfo, NULL);
+}
+
+#endif /* CFG_SUPPORT_TX_DONE_DEFER */
@@ -838,6 +838,81 @@ BOOLEAN kalDevRegWrite(IN GLUE_INFO_T *GlueInfo, IN UINT_32 RegOffset, IN UINT_3
 } /* end of kalDevRegWrite() */
 
 
+#if (CONF_HIF_AGG == 1)
+static inline BOOLEAN HifAhbDmaClkHeld(GL_HIF_INFO_T *HifInfo)
+{
+	return HifInfo->DmaClkHold != 0;
+}
+
+static VOID HifAhbAggAccount(GL_HIF_INFO_T *HifInfo, BOOLEAN fgTx, UINT_32 Size)
+{
+	GL_HIF_AGG_STATS_T *prStats = &HifInfo->rAggStats;
+
+	if (fgTx) {
+		prStats->u4TxAggNum++;
+		prStats->u8TxAggBytes += Size;
+		if (Size > prStats->u4TxAggMaxBytes)
+			prStats->u4TxAggMaxBytes = Size;
+	} else {
+		prStats->u4RxAggNum++;
+		prStats->u8RxAggBytes += Size;
+		if (Size > prStats->u4RxAggMaxBytes)
+			prStats->u4RxAggMaxBytes = Size;
+	}
+}
+#else
+#define HifAhbDmaClkHeld(_HifInfo)			FALSE
+#define HifAhbAggAccount(_HifInfo, _fgTx, _Size)
+#endif /* CONF_HIF_AGG */
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief Start a burst of port transfers, e.g. all the frames of one TX
+*        round. The PDMA clock is enabled once here instead of around every
+*        DMA transaction; bursts may nest.
+*
+* \param[in] GlueInfo   Pointer to the GLUE_INFO_T structure.
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalDevPortAggBegin(IN P_GLUE_INFO_T GlueInfo)
+{
+#if (CONF_HIF_AGG == 1) && (CONF_MTK_AHB_DMA == 1)
+	GL_HIF_INFO_T *HifInfo = &GlueInfo->rHifInfo;
+
+	if ((HifInfo->fgDmaEnable != TRUE) || (HifInfo->DmaOps == NULL))
+		return;
+
+	if (HifInfo->DmaClkHold++ == 0) {
+		HifInfo->DmaOps->DmaClockCtrl(TRUE);
+		HifInfo->rAggStats.u4BurstNum++;
+	}
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* \brief End a burst started by kalDevPortAggBegin().
+*
+* \param[in] GlueInfo   Pointer to the GLUE_INFO_T structure.
+*
+* \return (none)
+*/
+/*----------------------------------------------------------------------------*/
+VOID kalDevPortAggEnd(IN P_GLUE_INFO_T GlueInfo)
+{
+#if (CONF_HIF_AGG == 1) && (CONF_MTK_AHB_DMA == 1)
+	GL_HIF_INFO_T *HifInfo = &GlueInfo->rHifInfo;
+
+	if ((HifInfo->fgDmaEnable != TRUE) || (HifInfo->DmaOps == NULL) || (HifInfo->DmaClkHold == 0))
+		return;
+
+	if (--HifInfo->DmaClkHold == 0)
+		HifInfo->DmaOps->DmaClockCtrl(FALSE);
+#endif
+}
+
 /*----------------------------------------------------------------------------*/
 /*!
 * \brief Read device I/O port
@@ -932,7 +1007,8 @@ kalDevPortRead(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, OUT
 		/* start to read data */
 		AP_DMA_HIF_LOCK(HifInfo);	/* lock to avoid other codes config GDMA */
 
-		prDmaOps->DmaClockCtrl(TRUE);
+		if (!HifAhbDmaClkHeld(HifInfo))
+			prDmaOps->DmaClockCtrl(TRUE);
 		prDmaOps->DmaConfig(HifInfo, &DmaConf);
 		prDmaOps->DmaStart(HifInfo);
 
@@ -971,7 +1047,8 @@ kalDevPortRead(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, OUT
 			}
 		} while (prDmaOps->DmaPollStart(HifInfo) != 0);
 
-		prDmaOps->DmaClockCtrl(FALSE);
+		if (!HifAhbDmaClkHeld(HifInfo))
+			prDmaOps->DmaClockCtrl(FALSE);
 
 		AP_DMA_HIF_UNLOCK(HifInfo);
 
@@ -981,6 +1058,7 @@ kalDevPortRead(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, OUT
 #else
 		dma_unmap_single(HifInfo->Dev, DmaConf.Dst, Size, DMA_FROM_DEVICE);
 #endif /* MTK_DMA_BUF_MEMCPY_SUP */
+		HifAhbAggAccount(HifInfo, FALSE, Size);
 		if (WlanDmaFatalErr) {
 			if (!fgIsResetting)
 				glDoChipReset();
@@ -1097,7 +1175,8 @@ kalDevPortWrite(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, IN
 		/* start to write */
 		AP_DMA_HIF_LOCK(HifInfo);
 
-		prDmaOps->DmaClockCtrl(TRUE);
+		if (!HifAhbDmaClkHeld(HifInfo))
+			prDmaOps->DmaClockCtrl(TRUE);
 		prDmaOps->DmaConfig(HifInfo, &DmaConf);
 		prDmaOps->DmaStart(HifInfo);
 
@@ -1135,13 +1214,15 @@ kalDevPortWrite(IN P_GLUE_INFO_T GlueInfo, IN UINT_16 Port, IN UINT_32 Size, IN
 			}
 		} while (prDmaOps->DmaPollStart(HifInfo) != 0);
 
-		prDmaOps->DmaClockCtrl(FALSE);
+		if (!HifAhbDmaClkHeld(HifInfo))
+			prDmaOps->DmaClockCtrl(FALSE);
 
 		AP_DMA_HIF_UNLOCK(HifInfo);
 
 #ifndef MTK_DMA_BUF_MEMCPY_SUP
 		dma_unmap_single(HifInfo->Dev, DmaConf.Src, Size, DMA_TO_DEVICE);
 #endif /* MTK_DMA_BUF_MEMCPY_SUP */
+		HifAhbAggAccount(HifInfo, TRUE, Size);
 		if (WlanDmaFatalErr) {
 			if (!fgIsResetting)
 				glDoChipReset();
@@ -1434,9 +1515,7 @@ static UINT_32 HifAhbDmaEnhanceModeConf(IN GLUE_INFO_T * GlueInfo, UINT_32 Burst
 	ASSERT(GlueInfo);
 	HifInfo = &GlueInfo->rHifInfo;
 
-	RegHSTCR = HIF_REG_READL(HifInfo, MCR_WHIER);
-
-	RegHSTCR = HIF_REG_READL(HifInfo, MCR_HSTCR);
+	/* every field of HSTCR is rewritten, no need to read it back first */
 	RegHSTCR =
 	    ((BurstLen << HSTCR_AFF_BURST_LEN_OFFSET) & HSTCR_AFF_BURST_LEN) |
 	    ((PortId << HSTCR_TRANS_TARGET_OFFSET) & HSTCR_TRANS_TARGET) |
@@ -1600,6 +1679,15 @@ VOID glDumpConnSysCpuInfo(P_GLUE_INFO_T prGlueInfo)
 	GL_HIF_INFO_T *prHifInfo = &prGlueInfo->rHifInfo;
 	unsigned short j;
 
+#if (CONF_HIF_AGG == 1)
+	DBGLOG(INIT, WARN, "HIF agg: bursts %u, TX %u/%llu bytes (max %u), RX %u/%llu bytes (max %u)\n",
+	       prHifInfo->rAggStats.u4BurstNum,
+	       prHifInfo->rAggStats.u4TxAggNum, prHifInfo->rAggStats.u8TxAggBytes,
+	       prHifInfo->rAggStats.u4TxAggMaxBytes,
+	       prHifInfo->rAggStats.u4RxAggNum, prHifInfo->rAggStats.u8RxAggBytes,
+	       prHifInfo->rAggStats.u4RxAggMaxBytes);
+#endif
+
 	for (j = 0; j < 512; j++) {
 		DBGLOG(INIT, WARN, "0x%08x ", MCU_REG_READL(prHifInfo, CONN_MCU_CPUPCR));
 		if ((j + 1) % 16 == 0)
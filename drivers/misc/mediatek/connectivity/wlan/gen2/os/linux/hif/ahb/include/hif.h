@@ -78,6 +78,8 @@
 
 #define CONF_HIF_DMA_INT         0	/* DMA interrupt mode */
 
+#define CONF_HIF_AGG             1	/* keep PDMA clock across a burst, aggregate stats */
+
 /*******************************************************************************
 *                    E X T E R N A L   R E F E R E N C E S
 ********************************************************************************
@@ -145,6 +147,19 @@ typedef struct _GL_HIF_DMA_OPS_T {	/* DMA Operators */
 
 } GL_HIF_DMA_OPS_T;
 
+#if (CONF_HIF_AGG == 1)
+/* one DMA transaction on a data port carries one aggregate */
+typedef struct _GL_HIF_AGG_STATS_T {
+	UINT_32 u4TxAggNum;	/* TX DMA transactions */
+	UINT_64 u8TxAggBytes;
+	UINT_32 u4TxAggMaxBytes;
+	UINT_32 u4RxAggNum;	/* RX DMA transactions */
+	UINT_64 u8RxAggBytes;
+	UINT_32 u4RxAggMaxBytes;
+	UINT_32 u4BurstNum;	/* kalDevPortAggBegin/End pairs */
+} GL_HIF_AGG_STATS_T;
+#endif /* CONF_HIF_AGG */
+
 typedef struct _GL_HIF_INFO_T {
 
 	/* General */
@@ -191,6 +206,11 @@ typedef struct _GL_HIF_INFO_T {
 	UINT_8 *DmaRegBaseAddr;	/* DMA register base */
 	GL_HIF_DMA_OPS_T *DmaOps;	/* DMA Operators */
 
+#if (CONF_HIF_AGG == 1)
+	UINT_32 DmaClkHold;	/* > 0: PDMA clock stays on between transfers */
+	GL_HIF_AGG_STATS_T rAggStats;
+#endif /* CONF_HIF_AGG */
+
 #if !defined(CONFIG_MTK_CLKMGR)
 	struct clk *clk_wifi_dma;
 #endif
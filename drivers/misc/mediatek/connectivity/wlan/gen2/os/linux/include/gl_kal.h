@@ -887,8 +887,16 @@ BOOLEAN kalIndicateAgpsNotify(P_ADAPTER_T prAdapter, UINT_8 cmd, PUINT_8 data, U
 * \return -
 */
 /*----------------------------------------------------------------------------*/
+#if CFG_SUPPORT_TX_AC_QUEUE
+#define kalSendComplete(prGlueInfo, pvPacket, status)   \
+	do { \
+		kalTxAcComplete(prGlueInfo, pvPacket); \
+		kalSendCompleteAndAwakeQueue(prGlueInfo, pvPacket); \
+	} while (0)
+#else
 #define kalSendComplete(prGlueInfo, pvPacket, status)   \
 	    kalSendCompleteAndAwakeQueue(prGlueInfo, pvPacket)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*!
@@ -1243,6 +1251,14 @@ VOID kalPacketFree(IN P_GLUE_INFO_T prGlueInfo, IN PVOID pvPacket);
 
 PVOID kalPacketAlloc(IN P_GLUE_INFO_T prGlueInfo, IN UINT_32 u4Size, OUT PUINT_8 *ppucData);
 
+#if CFG_SUPPORT_RX_POOL
+VOID kalRxPoolInit(IN P_GLUE_INFO_T prGlueInfo, IN UINT_32 u4RingSize);
+
+VOID kalRxPoolUninit(IN P_GLUE_INFO_T prGlueInfo);
+
+PVOID kalRxPoolAlloc(IN P_GLUE_INFO_T prGlueInfo, IN UINT_32 u4Size, OUT PUINT_8 *ppucData);
+#endif
+
 VOID kalOsTimerInitialize(IN P_GLUE_INFO_T prGlueInfo, IN PVOID prTimerHandler);
 
 BOOLEAN kalSetTimer(IN P_GLUE_INFO_T prGlueInfo, IN OS_SYSTIME rInterval);
@@ -1255,6 +1271,34 @@ kalProcessRxPacket(IN P_GLUE_INFO_T prGlueInfo, IN PVOID pvPacket, IN PUINT_8 pu
 
 WLAN_STATUS kalRxIndicatePkts(IN P_GLUE_INFO_T prGlueInfo, IN PVOID apvPkts[], IN UINT_8 ucPktNum);
 
+#if CFG_SUPPORT_TX_AC_QUEUE
+VOID kalTxAcInit(IN P_GLUE_INFO_T prGlueInfo);
+
+VOID kalTxAcUninit(IN P_GLUE_INFO_T prGlueInfo);
+
+VOID kalTxAcEnqueue(IN P_GLUE_INFO_T prGlueInfo, IN struct sk_buff *prSkb, IN UINT_8 ucQueIdx);
+
+BOOLEAN kalTxAcService(IN P_GLUE_INFO_T prGlueInfo);
+
+VOID kalTxAcComplete(IN P_GLUE_INFO_T prGlueInfo, IN PVOID pvPacket);
+#endif
+
+#if CFG_SUPPORT_TX_DONE_DEFER
+BOOLEAN kalTxDoneDefer(IN P_GLUE_INFO_T prGlueInfo, IN UINT_8 ucTC, IN PVOID pvPacket);
+
+VOID kalTxDoneRelease(IN P_GLUE_INFO_T prGlueInfo, IN PUINT_8 aucTxRlsCnt);
+
+VOID kalTxDoneFlush(IN P_GLUE_INFO_T prGlueInfo);
+#endif
+
+#if CFG_SUPPORT_RX_GRO
+VOID kalRxNapiInit(IN P_GLUE_INFO_T prGlueInfo);
+
+VOID kalRxNapiUninit(IN P_GLUE_INFO_T prGlueInfo);
+
+WLAN_STATUS kalRxIndicatePktsGro(IN P_GLUE_INFO_T prGlueInfo, IN PVOID apvPkts[], IN UINT_8 ucPktNum);
+#endif
+
 VOID
 kalIndicateStatusAndComplete(IN P_GLUE_INFO_T prGlueInfo, IN WLAN_STATUS eStatus, IN PVOID pvBuf, IN UINT_32 u4BufLen);
 
@@ -1311,6 +1355,10 @@ BOOLEAN
 kalDevPortWrite(P_GLUE_INFO_T prGlueInfo,
 		IN UINT_16 u2Port, IN UINT_32 u2Len, IN PUINT_8 pucBuf, IN UINT_32 u2ValidInBufSize);
 
+VOID kalDevPortAggBegin(IN P_GLUE_INFO_T prGlueInfo);
+
+VOID kalDevPortAggEnd(IN P_GLUE_INFO_T prGlueInfo);
+
 BOOLEAN kalDevWriteWithSdioCmd52(IN P_GLUE_INFO_T prGlueInfo, IN UINT_32 u4Addr, IN UINT_8 ucData);
 
 void kalDevLoopbkAuto(IN GLUE_INFO_T *GlueInfo);
@@ -567,6 +567,7 @@
 #include <linux/vmalloc.h>
 
 #include <linux/kfifo.h>	/* for kfifo interface */
+#include <linux/llist.h>	/* for lock-less TX queues */
 #include <linux/cdev.h>		/* for cdev interface */
 
 #include <linux/firmware.h>	/* for firmware download */
@@ -786,6 +787,25 @@ typedef struct _TDLS_INFO_T {
 */
 typedef struct _GL_P2P_INFO_T GL_P2P_INFO_T, *P_GL_P2P_INFO_T;
 
+#if CFG_SUPPORT_TX_DONE_DEFER
+#define GL_TX_DONE_TC_NUM		6	/* TC_NUM */
+
+/* 8-bit indexes wrap with the ring; a TC has at most 255 buffers */
+typedef struct _GL_TX_DONE_RING_T {
+	PVOID apvPkt[256];
+	UINT_8 ucHead;		/* oldest frame still held by the firmware */
+	UINT_8 ucTail;
+} GL_TX_DONE_RING_T, *P_GL_TX_DONE_RING_T;
+#endif
+
+#if CFG_SUPPORT_RX_POOL
+typedef struct _GL_RX_POOL_STATS_T {
+	UINT_32 u4Recycled;	/* RX buffers served from a pool page */
+	UINT_32 u4Busy;		/* no pool page free: fell back to the slab */
+	UINT_32 u4AllocFail;	/* build_skb() failed */
+} GL_RX_POOL_STATS_T, *P_GL_RX_POOL_STATS_T;
+#endif
+
 struct _GLUE_INFO_T {
 	/* Device handle */
 	struct net_device *prDevHandler;
@@ -977,6 +997,36 @@ struct _GLUE_INFO_T {
 /* UINT32                                  u4TdlsDisconIdx; */
 #endif				/* CFG_SUPPORT_TDLS */
 
+#if CFG_SUPPORT_TX_AC_QUEUE
+	/* per-AC TX queues: filled lock-less by xmit, drained by the main thread */
+	struct llist_head arTxAcList[CFG_MAX_TXQ_NUM];
+	QUE_T arTxAcQueue[CFG_MAX_TXQ_NUM];	/* main thread only */
+	atomic_t arTxAcInflight[CFG_MAX_TXQ_NUM];	/* handed to QM, not yet completed */
+	UINT_32 au4TxAcLimit[CFG_MAX_TXQ_NUM];
+	UINT_32 au4TxAcMinInflight[CFG_MAX_TXQ_NUM];
+	UINT_32 u4TxAcRounds;
+	BOOLEAN fgTxAcEnabled;
+#endif
+
+#if CFG_SUPPORT_TX_DONE_DEFER
+	/* OS packets waiting for the firmware to release their TC buffer */
+	GL_TX_DONE_RING_T arTxDoneRing[GL_TX_DONE_TC_NUM];
+#endif
+
+#if CFG_SUPPORT_RX_POOL
+	/* pages recycled as RX buffers, see gl_rx_pool.c */
+	struct page **aprRxPoolPage;
+	UINT_32 u4RxPoolSize;
+	UINT_32 u4RxPoolNext;
+	GL_RX_POOL_STATS_T rRxPoolStats;
+#endif
+
+#if CFG_SUPPORT_RX_GRO
+	/* RX frames of the AIS interface are handed to GRO from NAPI */
+	struct napi_struct rRxNapi;
+	struct sk_buff_head rRxNapiQueue;
+	BOOLEAN fgRxNapiEnabled;
+#endif
 };
 
 typedef irqreturn_t(*PFN_WLANISR) (int irq, void *dev_id, struct pt_regs *regs);
@@ -1193,6 +1243,13 @@ struct wpa_driver_hs20_data_s {
 #define GLUE_GET_PKT_XTIME(_p)    \
 	(*((UINT_64 *)&(((struct sk_buff *)(_p))->cb[GLUE_CB_OFFSET+16])))
 
+/* per-AC TX queue the packet was accounted to, plus one; 0 if none */
+#define GLUE_SET_PKT_TX_AC(_p, _ucAc) \
+	(*((PUINT_8)&(((struct sk_buff *)(_p))->cb[GLUE_CB_OFFSET+24])) = (UINT_8)(_ucAc))
+
+#define GLUE_GET_PKT_TX_AC(_p)    \
+	(*((PUINT_8)&(((struct sk_buff *)(_p))->cb[GLUE_CB_OFFSET+24])))
+
 /* Check validity of prDev, private data, and pointers */
 #define GLUE_CHK_DEV(prDev) \
 	((prDev && *((P_GLUE_INFO_T *) netdev_priv(prDev))) ? TRUE : FALSE)
@@ -1251,6 +1308,17 @@ BOOLEAN wlanIsLaunched(VOID);
 
 void p2pSetMulticastListWorkQueueWrapper(P_GLUE_INFO_T prGlueInfo);
 
+#if CFG_SUPPORT_PS_POLICY
+/* traffic based power save policy, nic_pwr_mgt.c */
+VOID nicpmPsPolicyInit(IN P_ADAPTER_T prAdapter);
+
+VOID nicpmPsPolicyUninit(IN P_ADAPTER_T prAdapter);
+
+VOID nicpmPsPolicyTxClassify(IN P_ADAPTER_T prAdapter, IN P_NATIVE_PACKET prPacket, IN UINT_32 u4PacketLen);
+
+UINT8 checkRtpAV(PUINT_8 data, UINT_32 size);
+#endif
+
 #endif
 
 /*******************************************************************************
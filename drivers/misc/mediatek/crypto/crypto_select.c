@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2015 MediaTek Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Pick the fastest implementation of the algorithms dm-crypt, ext4
+ * encryption and dm-verity use, by timing them on this SoC.
+ *
+ * Every registered driver of an algorithm in crypto_select_algs[] (the CE,
+ * NEON and generic ones, or an engine driver should one register) is timed
+ * at the request sizes of its users in the way they call it: ablkcipher
+ * for the ciphers, shash for the hashes.  The one with the lowest total
+ * time for one request of each size gets a priority above the others, so
+ * tfms allocated from then on by name get it.  Tfms allocated before are
+ * not moved.
+ *
+ * This runs once at boot.  In /sys/kernel/debug/crypto_select/, echo 1 >
+ * run times again, cat run gives the last result; bench_us is the time
+ * per driver and size, auto 0 only measures.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/err.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <linux/scatterlist.h>
+#include <linux/completion.h>
+#include <linux/random.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/mutex.h>
+#include <linux/rwsem.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/uaccess.h>
+#include <crypto/hash.h>
+#include <linux/crypto.h>
+#include "../../../../crypto/internal.h"
+
+#define SEL_MAX_SIZE	4096
+#define SEL_MAX_SIZES	3
+#define SEL_MAX_DRV	6
+#define SEL_MAX_EXTRA	2
+
+struct crypto_select_alg {
+	const char *name;
+	bool hash;
+	unsigned int keylen;
+	unsigned int sizes[SEL_MAX_SIZES];	/* 0 terminated */
+	/* template instances that only exist once asked for by driver name */
+	const char *extra[SEL_MAX_EXTRA];
+};
+
+static const struct crypto_select_alg crypto_select_algs[] = {
+	/* dm-crypt sectors, ext4 file contents pages */
+	{ "xts(aes)", false, 64, { 512, 4096 }, { "xts(aes-generic)", "xts(aes-ce)" } },
+	/* dm-crypt aes-cbc-essiv, ext4 file names through cts(cbc(aes)) */
+	{ "cbc(aes)", false, 32, { 32, 512, 4096 }, { "cbc(aes-generic)", "cbc(aes-ce)" } },
+	/* ext4 per file key derivation */
+	{ "ecb(aes)", false, 16, { 64 }, { "ecb(aes-generic)", "ecb(aes-ce)" } },
+	/* dm-verity blocks */
+	{ "sha256", true, 0, { 4096 } },
+	{ "sha1", true, 0, { 4096 } },
+};
+
+struct crypto_select_drv {
+	char driver[CRYPTO_MAX_ALG_NAME];
+	int prio;		/* when timed */
+	u64 ns[SEL_MAX_SIZES];	/* per request, 0: failed */
+	u64 total;
+};
+
+struct crypto_select_res {
+	int ndrv;
+	int pick;		/* index in drv[], -1: none */
+	int new_prio;		/* -1: left alone */
+	struct crypto_select_drv drv[SEL_MAX_DRV];
+};
+
+struct crypto_select_wait {
+	struct completion completion;
+	int err;
+};
+
+static u32 crypto_select_bench_us = 2000;
+static u32 crypto_select_auto = 1;
+
+static DEFINE_MUTEX(crypto_select_lock);
+static struct crypto_select_res crypto_select_res[ARRAY_SIZE(crypto_select_algs)];
+static void *crypto_select_buf;
+
+static void crypto_select_complete(struct crypto_async_request *req, int err)
+{
+	struct crypto_select_wait *w = req->data;
+
+	if (err == -EINPROGRESS)
+		return;
+	w->err = err;
+	complete(&w->completion);
+}
+
+static int crypto_select_wait_op(struct crypto_select_wait *w, int ret)
+{
+	if (ret == -EINPROGRESS || ret == -EBUSY) {
+		wait_for_completion(&w->completion);
+		ret = w->err;
+		reinit_completion(&w->completion);
+	}
+	return ret;
+}
+
+/* ns per request, 0 if the driver could not be used */
+static u64 crypto_select_time_cipher(const char *driver, const struct crypto_select_alg *a,
+				     unsigned int size)
+{
+	struct crypto_ablkcipher *tfm;
+	struct ablkcipher_request *req;
+	struct crypto_select_wait w;
+	struct scatterlist sg;
+	u8 key[64], iv[16];
+	ktime_t start, end;
+	u64 ops = 0, ns = 0;
+
+	tfm = crypto_alloc_ablkcipher(driver, 0, 0);
+	if (IS_ERR(tfm))
+		return 0;
+	req = ablkcipher_request_alloc(tfm, GFP_KERNEL);
+	if (!req)
+		goto out_tfm;
+
+	get_random_bytes(key, a->keylen);
+	if (crypto_ablkcipher_setkey(tfm, key, a->keylen))
+		goto out_req;
+	init_completion(&w.completion);
+	ablkcipher_request_set_callback(req, CRYPTO_TFM_REQ_MAY_BACKLOG, crypto_select_complete, &w);
+	sg_init_one(&sg, crypto_select_buf, size);
+	memset(iv, 0, sizeof(iv));
+	ablkcipher_request_set_crypt(req, &sg, &sg, size, iv);
+
+	/* once to warm up the caches and the key schedule */
+	if (crypto_select_wait_op(&w, crypto_ablkcipher_encrypt(req)))
+		goto out_req;
+	start = ktime_get();
+	end = ktime_add_us(start, crypto_select_bench_us);
+	do {
+		if (crypto_select_wait_op(&w, crypto_ablkcipher_encrypt(req)))
+			goto out_req;
+		ops++;
+	} while (ktime_compare(ktime_get(), end) < 0);
+	ns = div64_u64(ktime_to_ns(ktime_sub(ktime_get(), start)), ops) ?: 1;
+
+ out_req:
+	ablkcipher_request_free(req);
+ out_tfm:
+	crypto_free_ablkcipher(tfm);
+	return ns;
+}
+
+static u64 crypto_select_time_hash(const char *driver, unsigned int size)
+{
+	struct crypto_shash *tfm;
+	struct shash_desc *desc;
+	u8 out[64];
+	ktime_t start, end;
+	u64 ops = 0, ns = 0;
+
+	tfm = crypto_alloc_shash(driver, 0, 0);
+	if (IS_ERR(tfm))
+		return 0;
+	if (crypto_shash_digestsize(tfm) > sizeof(out))
+		goto out_tfm;
+	desc = kmalloc(sizeof(*desc) + crypto_shash_descsize(tfm), GFP_KERNEL);
+	if (!desc)
+		goto out_tfm;
+	desc->tfm = tfm;
+	desc->flags = 0;
+
+	if (crypto_shash_digest(desc, crypto_select_buf, size, out))
+		goto out_desc;
+	start = ktime_get();
+	end = ktime_add_us(start, crypto_select_bench_us);
+	do {
+		if (crypto_shash_digest(desc, crypto_select_buf, size, out))
+			goto out_desc;
+		ops++;
+	} while (ktime_compare(ktime_get(), end) < 0);
+	ns = div64_u64(ktime_to_ns(ktime_sub(ktime_get(), start)), ops) ?: 1;
+
+ out_desc:
+	kfree(desc);
+ out_tfm:
+	crypto_free_shash(tfm);
+	return ns;
+}
+
+static bool crypto_select_match(struct crypto_alg *q, const struct crypto_select_alg *a)
+{
+	u32 type = q->cra_flags & CRYPTO_ALG_TYPE_MASK;
+
+	if (crypto_is_larval(q) || crypto_is_moribund(q) || !(q->cra_flags & CRYPTO_ALG_TESTED))
+		return false;
+	if (strcmp(q->cra_name, a->name))
+		return false;
+	if (a->hash)
+		return type == CRYPTO_ALG_TYPE_SHASH;
+	return (type & CRYPTO_ALG_TYPE_BLKCIPHER_MASK) == CRYPTO_ALG_TYPE_BLKCIPHER;
+}
+
+static void crypto_select_one(const struct crypto_select_alg *a, struct crypto_select_res *res)
+{
+	struct crypto_select_drv *d;
+	struct crypto_alg *q;
+	int i, j, max_prio = 0, pick_prio = 0;
+
+	memset(res, 0, sizeof(*res));
+	res->pick = -1;
+	res->new_prio = -1;
+
+	/* instantiate the templates over the single block ciphers */
+	for (i = 0; i < SEL_MAX_EXTRA && a->extra[i]; i++)
+		crypto_has_alg(a->extra[i], 0, 0);
+
+	down_read(&crypto_alg_sem);
+	list_for_each_entry(q, &crypto_alg_list, cra_list) {
+		if (res->ndrv == SEL_MAX_DRV)
+			break;
+		if (!crypto_select_match(q, a))
+			continue;
+		d = &res->drv[res->ndrv++];
+		strlcpy(d->driver, q->cra_driver_name, sizeof(d->driver));
+		d->prio = q->cra_priority;
+	}
+	up_read(&crypto_alg_sem);
+
+	for (i = 0; i < res->ndrv; i++) {
+		d = &res->drv[i];
+		for (j = 0; j < SEL_MAX_SIZES && a->sizes[j]; j++) {
+			if (a->hash)
+				d->ns[j] = crypto_select_time_hash(d->driver, a->sizes[j]);
+			else
+				d->ns[j] = crypto_select_time_cipher(d->driver, a, a->sizes[j]);
+			if (!d->ns[j]) {
+				d->total = 0;
+				break;
+			}
+			d->total += d->ns[j];
+			cond_resched();
+		}
+		if (d->total && (res->pick < 0 || d->total < res->drv[res->pick].total))
+			res->pick = i;
+	}
+	if (res->pick < 0 || !crypto_select_auto)
+		return;
+
+	/* raise the pick just above the others, unless it already is */
+	down_write(&crypto_alg_sem);
+	list_for_each_entry(q, &crypto_alg_list, cra_list) {
+		if (!crypto_select_match(q, a))
+			continue;
+		if (!strcmp(q->cra_driver_name, res->drv[res->pick].driver))
+			pick_prio = q->cra_priority;
+		else
+			max_prio = max(max_prio, q->cra_priority);
+	}
+	if (pick_prio <= max_prio) {
+		list_for_each_entry(q, &crypto_alg_list, cra_list) {
+			if (crypto_select_match(q, a) &&
+			    !strcmp(q->cra_driver_name, res->drv[res->pick].driver)) {
+				q->cra_priority = max_prio + 1;
+				res->new_prio = max_prio + 1;
+				break;
+			}
+		}
+	}
+	up_write(&crypto_alg_sem);
+}
+
+/* crypto_select_lock held */
+static void crypto_select_run(void)
+{
+	struct crypto_select_res *res;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(crypto_select_algs); i++) {
+		res = &crypto_select_res[i];
+		crypto_select_one(&crypto_select_algs[i], res);
+		if (res->pick >= 0)
+			pr_info("crypto_select: %s: %s%s\n", crypto_select_algs[i].name,
+				res->drv[res->pick].driver, res->new_prio >= 0 ? " raised" : "");
+	}
+}
+
+static int crypto_select_show(struct seq_file *m, void *v)
+{
+	const struct crypto_select_alg *a;
+	struct crypto_select_res *res;
+	struct crypto_select_drv *d;
+	int i, j, k;
+
+	mutex_lock(&crypto_select_lock);
+	for (i = 0; i < ARRAY_SIZE(crypto_select_algs); i++) {
+		a = &crypto_select_algs[i];
+		res = &crypto_select_res[i];
+		for (j = 0; j < res->ndrv; j++) {
+			d = &res->drv[j];
+			for (k = 0; k < SEL_MAX_SIZES && a->sizes[k]; k++)
+				seq_printf(m, "alg=%s driver=%s prio=%d size=%u ns=%llu mbps=%llu\n",
+					   a->name, d->driver, d->prio, a->sizes[k], d->ns[k],
+					   d->ns[k] ? div64_u64((u64)a->sizes[k] * 8000, d->ns[k]) : 0);
+		}
+		if (res->pick >= 0)
+			seq_printf(m, "alg=%s pick=%s prio=%d\n", a->name, res->drv[res->pick].driver,
+				   res->new_prio >= 0 ? res->new_prio : res->drv[res->pick].prio);
+	}
+	mutex_unlock(&crypto_select_lock);
+	return 0;
+}
+
+static int crypto_select_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, crypto_select_show, NULL);
+}
+
+static ssize_t crypto_select_write(struct file *filp, const char __user *ubuf,
+				   size_t cnt, loff_t *ppos)
+{
+	char buf[16];
+	unsigned long val;
+	int ret;
+
+	if (cnt >= sizeof(buf))
+		return -EINVAL;
+
+	if (copy_from_user(&buf, ubuf, cnt))
+		return -EFAULT;
+
+	buf[cnt] = 0;
+
+	ret = kstrtoul(buf, 10, &val);
+	if (ret < 0)
+		return ret;
+	if (val != 1)
+		return -EINVAL;
+
+	mutex_lock(&crypto_select_lock);
+	crypto_select_run();
+	mutex_unlock(&crypto_select_lock);
+
+	return cnt;
+}
+
+static const struct file_operations crypto_select_fops = {
+	.open = crypto_select_open,
+	.read = seq_read,
+	.write = crypto_select_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init crypto_select_init(void)
+{
+	struct dentry *dir;
+
+	crypto_select_buf = kzalloc(SEL_MAX_SIZE, GFP_KERNEL);
+	if (!crypto_select_buf)
+		return -ENOMEM;
+
+	mutex_lock(&crypto_select_lock);
+	crypto_select_run();
+	mutex_unlock(&crypto_select_lock);
+
+	dir = debugfs_create_dir("crypto_select", NULL);
+	if (!dir)
+		return 0;
+
+	debugfs_create_u32("bench_us", 0644, dir, &crypto_select_bench_us);
+	debugfs_create_u32("auto", 0644, dir, &crypto_select_auto);
+	debugfs_create_file("run", 0644, dir, NULL, &crypto_select_fops);
+
+	return 0;
+}
+late_initcall(crypto_select_init);
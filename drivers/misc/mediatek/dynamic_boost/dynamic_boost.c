@@ -28,14 +28,13 @@
 #include <linux/sched.h>
 #include <linux/sched/rt.h>
 #include <linux/sysfs.h>
-#include <linux/kthread.h>
 #include <linux/slab.h>
 #include <linux/spinlock.h>
 #include <mt_hotplug_strategy.h>
 #include <mt_hotplug_strategy_internal.h>
 #include "mt_cpufreq.h"
-#include <linux/input.h>
 #include <linux/workqueue.h>
+#include <mt-plat/perfmgr.h>
 #include "dynamic_boost.h"
 
 struct boost_state {
@@ -46,20 +45,12 @@ struct boost_state {
 struct dynamic_boost {
 	spinlock_t boost_lock;
 	int last_req_mode;
-	wait_queue_head_t wq;
-	struct task_struct *thread;
+	struct work_struct update_work;
 	struct boost_state state[PRIO_DEFAULT];
-	atomic_t event;
 };
 
 static struct dynamic_boost dboost;
 
-struct dboost_input_handle {
-	struct input_handle handle;
-	int duration;
-	int prio_mode;
-};
-
 #define MAX_CORES_NUMBER nr_cpu_ids
 #define MAX_FREQUENCY 1
 #define MAX_DURATION 10000
@@ -80,8 +71,7 @@ static void dboost_disable_work(struct work_struct *work)
 		state->active--;
 	spin_unlock_irqrestore(&dboost.boost_lock, flags);
 
-	atomic_inc(&dboost.event);
-	wake_up(&dboost.wq);
+	queue_work(system_highpri_wq, &dboost.update_work);
 }
 
 /*
@@ -112,151 +102,148 @@ int set_dynamic_boost(int duration, int prio_mode)
 		state->active++;
 	spin_unlock_irqrestore(&dboost.boost_lock, flags);
 
-	atomic_inc(&dboost.event);
-	wake_up(&dboost.wq);
+	queue_work(system_highpri_wq, &dboost.update_work);
 	return 0;
 }
 EXPORT_SYMBOL(set_dynamic_boost);
 
-static int dboost_dvfs_hotplug_thread(void *ptr)
+/* Hand the top priority mode to the boost arbiter */
+static void dboost_update_work(struct work_struct *work)
 {
+	struct perfmgr_boost_req req;
 	int max_freq, cores_to_set_b, cores_to_set_l;
+	int i, set_mode = PRIO_DEFAULT;
 	unsigned long flags;
 #ifdef CONFIG_CPU_BOOST
     extern void set_boost_duration(unsigned int ms);
     extern void set_freq_threshold(unsigned int freq);
 #endif
 
-	set_user_nice(current, -10);
-
-	while (!kthread_should_stop()) {
-		int i, set_mode = PRIO_DEFAULT;
-
-		spin_lock_irqsave(&dboost.boost_lock, flags);
-		for (i = PRIO_DEFAULT - 1; i >= 0; i--) {
-			if (dboost.state[i].active) {
-				set_mode = i;
-				break;
-			}
+	spin_lock_irqsave(&dboost.boost_lock, flags);
+	for (i = PRIO_DEFAULT - 1; i >= 0; i--) {
+		if (dboost.state[i].active) {
+			set_mode = i;
+			break;
 		}
-		spin_unlock_irqrestore(&dboost.boost_lock, flags);
+	}
+	spin_unlock_irqrestore(&dboost.boost_lock, flags);
 
-		switch (set_mode) {
-		case PRIO_MAX_CORES_MAX_FREQ:
-			cores_to_set_b = num_possible_big_cpus();
-			cores_to_set_l = num_possible_little_cpus();
-			max_freq = MAX_FREQUENCY;
-			break;
-		case PRIO_MAX_CORES:
-			cores_to_set_b = num_possible_big_cpus();
-			cores_to_set_l = num_possible_little_cpus();
-			max_freq = 0;
+	switch (set_mode) {
+	case PRIO_MAX_CORES_MAX_FREQ:
+		cores_to_set_b = num_possible_big_cpus();
+		cores_to_set_l = num_possible_little_cpus();
+		max_freq = MAX_FREQUENCY;
+		break;
+	case PRIO_MAX_CORES:
+		cores_to_set_b = num_possible_big_cpus();
+		cores_to_set_l = num_possible_little_cpus();
+		max_freq = 0;
 #ifdef CONFIG_CPU_BOOST
             set_boost_duration(20);
             set_freq_threshold(1400000); 
             printk("ready to enable boost feature\n");
 #endif      
-			break;
-		case PRIO_FOUR_BIGS_MAX_FREQ:
-			cores_to_set_b = 4;
-			cores_to_set_l = 0;
-			max_freq = MAX_FREQUENCY;
-			break;
-		case PRIO_FOUR_BIGS:
-			cores_to_set_b = 4;
-			cores_to_set_l = 0;
-			max_freq = 0;
-			break;
-		case PRIO_TWO_BIGS_TWO_LITTLES_MAX_FREQ:
-			cores_to_set_b = 2;
-			cores_to_set_l = 2;
-			max_freq = MAX_FREQUENCY;
-			break;
-		case PRIO_TWO_BIGS_TWO_LITTLES:
-			cores_to_set_b = 2;
-			cores_to_set_l = 2;
-			max_freq = 0;
-			break;
-		case PRIO_FOUR_LITTLES_MAX_FREQ:
-			cores_to_set_b = 0;
-			cores_to_set_l = 4;
-			max_freq = MAX_FREQUENCY;
-			break;
-		case PRIO_FOUR_LITTLES:
-			cores_to_set_b = 0;
-			cores_to_set_l = 4;
-			max_freq = 0;
-			break;
-		case PRIO_TWO_BIGS_MAX_FREQ:
-			cores_to_set_b = 2;
-			cores_to_set_l = 0;
-			max_freq = MAX_FREQUENCY;
-			break;
-		case PRIO_TWO_BIGS:
-			cores_to_set_b = 2;
-			cores_to_set_l = 0;
-			max_freq = 0;
-			break;
-		case PRIO_ONE_BIG_ONE_LITTLE_MAX_FREQ:
-			cores_to_set_b = 1;
-			cores_to_set_l = 1;
-			max_freq = MAX_FREQUENCY;
-			break;
-		case PRIO_ONE_BIG_ONE_LITTLE:
-			cores_to_set_b = 1;
-			cores_to_set_l = 1;
-			max_freq = 0;
-			break;
-		case PRIO_ONE_BIG_MAX_FREQ:
-			cores_to_set_b = 1;
-			cores_to_set_l = 0;
-			max_freq = MAX_FREQUENCY;
-			break;
-		case PRIO_ONE_BIG:
-			cores_to_set_b = 1;
-			cores_to_set_l = 0;
-			max_freq = 0;
-			break;
-		case PRIO_TWO_LITTLES_MAX_FREQ:
-			cores_to_set_b = 0;
-			cores_to_set_l = 2;
-			max_freq = MAX_FREQUENCY;
-			break;
-		case PRIO_TWO_LITTLES:
-			cores_to_set_b = 0;
-			cores_to_set_l = 2;
-			max_freq = 0;
-			break;
-		case PRIO_RESET:
-			for (i = PRIO_DEFAULT - 1; i >= 0; i--)
-				dboost.state[i].active = 0;
-		default:
-			cores_to_set_b = 0;
-			cores_to_set_l = 0;
-			max_freq = 0;
+		break;
+	case PRIO_FOUR_BIGS_MAX_FREQ:
+		cores_to_set_b = 4;
+		cores_to_set_l = 0;
+		max_freq = MAX_FREQUENCY;
+		break;
+	case PRIO_FOUR_BIGS:
+		cores_to_set_b = 4;
+		cores_to_set_l = 0;
+		max_freq = 0;
+		break;
+	case PRIO_TWO_BIGS_TWO_LITTLES_MAX_FREQ:
+		cores_to_set_b = 2;
+		cores_to_set_l = 2;
+		max_freq = MAX_FREQUENCY;
+		break;
+	case PRIO_TWO_BIGS_TWO_LITTLES:
+		cores_to_set_b = 2;
+		cores_to_set_l = 2;
+		max_freq = 0;
+		break;
+	case PRIO_FOUR_LITTLES_MAX_FREQ:
+		cores_to_set_b = 0;
+		cores_to_set_l = 4;
+		max_freq = MAX_FREQUENCY;
+		break;
+	case PRIO_FOUR_LITTLES:
+		cores_to_set_b = 0;
+		cores_to_set_l = 4;
+		max_freq = 0;
+		break;
+	case PRIO_TWO_BIGS_MAX_FREQ:
+		cores_to_set_b = 2;
+		cores_to_set_l = 0;
+		max_freq = MAX_FREQUENCY;
+		break;
+	case PRIO_TWO_BIGS:
+		cores_to_set_b = 2;
+		cores_to_set_l = 0;
+		max_freq = 0;
+		break;
+	case PRIO_ONE_BIG_ONE_LITTLE_MAX_FREQ:
+		cores_to_set_b = 1;
+		cores_to_set_l = 1;
+		max_freq = MAX_FREQUENCY;
+		break;
+	case PRIO_ONE_BIG_ONE_LITTLE:
+		cores_to_set_b = 1;
+		cores_to_set_l = 1;
+		max_freq = 0;
+		break;
+	case PRIO_ONE_BIG_MAX_FREQ:
+		cores_to_set_b = 1;
+		cores_to_set_l = 0;
+		max_freq = MAX_FREQUENCY;
+		break;
+	case PRIO_ONE_BIG:
+		cores_to_set_b = 1;
+		cores_to_set_l = 0;
+		max_freq = 0;
+		break;
+	case PRIO_TWO_LITTLES_MAX_FREQ:
+		cores_to_set_b = 0;
+		cores_to_set_l = 2;
+		max_freq = MAX_FREQUENCY;
+		break;
+	case PRIO_TWO_LITTLES:
+		cores_to_set_b = 0;
+		cores_to_set_l = 2;
+		max_freq = 0;
+		break;
+	case PRIO_RESET:
+		spin_lock_irqsave(&dboost.boost_lock, flags);
+		for (i = PRIO_DEFAULT - 1; i >= 0; i--)
+			dboost.state[i].active = 0;
+		spin_unlock_irqrestore(&dboost.boost_lock, flags);
+	default:
+		cores_to_set_b = 0;
+		cores_to_set_l = 0;
+		max_freq = 0;
 #ifdef CONFIG_CPU_BOOST
             set_boost_duration(0);
             set_freq_threshold(0);
             printk("finally reset cpu boost feature\n");
 #endif
-			break;
-		}
-
-//		interactive_boost_cpu(max_freq);
-		if (!cores_to_set_l)
-			cores_to_set_l = 1;
-		hps_set_cpu_num_base(BASE_PERF_SERV, cores_to_set_l, cores_to_set_b);
-		/* printk("dynamic boost: Mode=%d cpu_min_num_big=%d cpu_min_num_little=%d\n",
-					set_mode, cores_to_set_b, cores_to_set_l);*/
-
-		dboost.last_req_mode = set_mode;
-
-		while (!atomic_read(&dboost.event))
-			wait_event(dboost.wq, atomic_read(&dboost.event));
+		break;
+	}
 
-		atomic_dec(&dboost.event);
+//	interactive_boost_cpu(max_freq);
+	/* printk("dynamic boost: Mode=%d cpu_min_num_big=%d cpu_min_num_little=%d\n",
+				set_mode, cores_to_set_b, cores_to_set_l);*/
+	if (cores_to_set_l || cores_to_set_b) {
+		perfmgr_boost_req_init(&req);
+		req.min_cores_l = cores_to_set_l;
+		req.min_cores_b = cores_to_set_b;
+		perfmgr_boost_request(PERFMGR_BOOST_DYNAMIC, &req, 0);
+	} else {
+		perfmgr_boost_cancel(PERFMGR_BOOST_DYNAMIC);
 	}
-	return 0;
+
+	dboost.last_req_mode = set_mode;
 }
 
 static ssize_t dynamic_boost_show(struct device *dev, struct device_attribute *attr, char *buf)
@@ -310,8 +297,7 @@ int dboost_suspend(struct device *dev)
 		dboost.state[i].active = 0;
 		spin_unlock_irqrestore(&dboost.boost_lock, flags);
 	}
-	atomic_inc(&dboost.event);
-	wake_up(&dboost.wq);
+	queue_work(system_highpri_wq, &dboost.update_work);
 	return 0;
 }
 
@@ -331,77 +317,6 @@ static struct platform_driver dynamic_boost_driver = {
 	},
 };
 
-#ifdef CONFIG_TOUCH_BOOST
-/******************************************************************************
- *                         Handle touch boost                                 *
- ******************************************************************************/
-static void dboost_input_event(struct input_handle *handle, unsigned int type,
-		unsigned int code, int value)
-{
-	struct dboost_input_handle *in = container_of(handle, struct dboost_input_handle, handle);
-
-	if ((type == EV_KEY && code == BTN_TOUCH) ||
-				(type == EV_ABS && code == ABS_MT_TRACKING_ID && value != 0))
-		set_dynamic_boost(in->duration, in->prio_mode);
-}
-
-static int dboost_input_connect(struct input_handler *handler,
-		struct input_dev *dev, const struct input_device_id *id)
-{
-	struct dboost_input_handle *in;
-	int error;
-
-	in = kzalloc(sizeof(struct dboost_input_handle), GFP_KERNEL);
-	if (!in)
-		return -ENOMEM;
-
-	in->handle.dev = dev;
-	in->handle.handler = handler;
-	in->handle.name = "dynamic_boost";
-
-	/* TODO: the following parameters should be configured through platform data */
-	in->prio_mode = PRIO_MAX_CORES;
-	in->duration = 150;
-
-	error = input_register_handle(&in->handle);
-	if (error)
-		goto err2;
-
-	error = input_open_device(&in->handle);
-	if (error)
-		goto err1;
-
-	return 0;
-err1:
-	input_unregister_handle(&in->handle);
-err2:
-	kfree(&in->handle);
-	return error;
-}
-
-static void dboost_input_disconnect(struct input_handle *handle)
-{
-	struct dboost_input_handle *in = container_of(handle, struct dboost_input_handle, handle);
-
-	input_close_device(handle);
-	input_unregister_handle(handle);
-	kfree(in);
-}
-
-static const struct input_device_id dboost_ids[] = {
-	{ .driver_info = 1 },
-	{ },
-};
-
-static struct input_handler dboost_input_handler = {
-	.event		= dboost_input_event,
-	.connect	= dboost_input_connect,
-	.disconnect	= dboost_input_disconnect,
-	.name		= "touch_boost_ond",
-	.id_table	= dboost_ids,
-};
-#endif /* CONFIG_TOUCH_BOOST */
-
 static int __init dynamic_boost_init(void)
 {
 	int ret = 0, i;
@@ -415,7 +330,7 @@ static int __init dynamic_boost_init(void)
 
 	spin_lock_init(&dboost.boost_lock);
 	dboost.last_req_mode = PRIO_DEFAULT;
-	atomic_set(&dboost.event, 0);
+	INIT_WORK(&dboost.update_work, dboost_update_work);
 
 	for (i = 0; i < ARRAY_SIZE(dboost.state); ++i) {
 		INIT_DELAYED_WORK(&dboost.state[i].work, dboost_disable_work);
@@ -426,18 +341,6 @@ static int __init dynamic_boost_init(void)
 #endif
 			dboost.state[i].active = 0;
 	}
-	init_waitqueue_head(&dboost.wq);
-
-	dboost.thread = kthread_run(dboost_dvfs_hotplug_thread, &dboost, "dynamic_boost");
-	if (IS_ERR(dboost.thread))
-		return -EINVAL;
-
-#ifdef CONFIG_TOUCH_BOOST
-	ret = input_register_handler(&dboost_input_handler);
-	if (ret)
-		return ret;
-#endif
-
 
 	return 0;
 }
@@ -446,10 +349,8 @@ late_initcall(dynamic_boost_init);
 
 static void __exit dynamic_boost_exit(void)
 {
-#ifdef CONFIG_TOUCH_BOOST
-	input_unregister_handler(&dboost_input_handler);
-#endif
-	kthread_stop(dboost.thread);
+	cancel_work_sync(&dboost.update_work);
+	perfmgr_boost_cancel(PERFMGR_BOOST_DYNAMIC);
 }
 
 module_exit(dynamic_boost_exit);
@@ -3,6 +3,7 @@
 #include <linux/sched.h>
 #include <linux/delay.h>
 #include <linux/module.h>
+#include <linux/percpu.h>
 
 #include <mt-plat/mt_ccci_common.h>
 #include "ccci_config.h"
@@ -205,16 +206,103 @@ static void ccci_req_queue_init(struct ccci_req_queue *queue)
 	init_waitqueue_head(&queue->req_wq);
 }
 
+/*
+ * Per cpu caches in front of the skb pools.  Allocation and recycling
+ * work on the local cache with only interrupts disabled, and the pool
+ * lock is taken once per batch to refill or drain it, instead of once
+ * per packet.
+ */
+#define SKB_CACHE_MAX 16
+
+static void ccci_skb_pool_cache_init(struct ccci_skb_queue *pool)
+{
+	int cpu;
+
+	pool->cache = alloc_percpu(struct sk_buff_head);
+	if (!pool->cache) {
+		CCCI_ERR_MSG(-1, BM, "no per cpu skb cache, pool size %d\n", pool->max_len);
+		return;
+	}
+	for_each_possible_cpu(cpu)
+		__skb_queue_head_init(per_cpu_ptr(pool->cache, cpu));
+	/* leave most of the pool where every cpu can reach it */
+	pool->cache_max = clamp_t(unsigned int, pool->max_len / (4 * num_possible_cpus()), 2, SKB_CACHE_MAX);
+}
+
+static struct sk_buff *ccci_skb_pool_get(struct ccci_skb_queue *pool)
+{
+	struct sk_buff_head *cache;
+	struct sk_buff *skb;
+	unsigned long flags;
+	int i;
+
+	if (!pool->cache)
+		return ccci_skb_dequeue(pool);
+
+	local_irq_save(flags);
+	cache = this_cpu_ptr(pool->cache);
+	if (skb_queue_empty(cache)) {
+		spin_lock(&pool->skb_list.lock);
+		for (i = 0; i < pool->cache_max / 2; i++) {
+			skb = __skb_dequeue(&pool->skb_list);
+			if (!skb)
+				break;
+			__skb_queue_tail(cache, skb);
+		}
+		if (pool->pre_filled && pool->skb_list.qlen < pool->max_len / RELOAD_TH)
+			queue_work(pool_reload_work_queue, &pool->reload_work);
+		spin_unlock(&pool->skb_list.lock);
+	}
+	skb = __skb_dequeue(cache);
+	local_irq_restore(flags);
+	return skb;
+}
+
+static void ccci_skb_pool_put(struct ccci_skb_queue *pool, struct sk_buff *skb)
+{
+	struct sk_buff_head *cache;
+	struct sk_buff_head overflow;
+	unsigned long flags;
+
+	if (!pool->cache) {
+		ccci_skb_enqueue(pool, skb);
+		return;
+	}
+
+	__skb_queue_head_init(&overflow);
+	local_irq_save(flags);
+	cache = this_cpu_ptr(pool->cache);
+	/* most recently freed first, its data is still cache hot */
+	__skb_queue_head(cache, skb);
+	if (skb_queue_len(cache) > pool->cache_max) {
+		spin_lock(&pool->skb_list.lock);
+		while (skb_queue_len(cache) > pool->cache_max / 2) {
+			skb = __skb_dequeue_tail(cache);
+			if (pool->skb_list.qlen < pool->max_len)
+				__skb_queue_tail(&pool->skb_list, skb);
+			else
+				__skb_queue_tail(&overflow, skb);
+		}
+		if (pool->skb_list.qlen > pool->max_history)
+			pool->max_history = pool->skb_list.qlen;
+		spin_unlock(&pool->skb_list.lock);
+	}
+	local_irq_restore(flags);
+
+	while ((skb = __skb_dequeue(&overflow)) != NULL)
+		dev_kfree_skb_any(skb);
+}
+
 static inline struct sk_buff *__alloc_skb_from_pool(int size)
 {
 	struct sk_buff *skb = NULL;
 
 	if (size > SKB_1_5K)
-		skb = ccci_skb_dequeue(&skb_pool_4K);
+		skb = ccci_skb_pool_get(&skb_pool_4K);
 	else if (size > SKB_16)
-		skb = ccci_skb_dequeue(&skb_pool_1_5K);
+		skb = ccci_skb_pool_get(&skb_pool_1_5K);
 	else if (size > 0)
-		skb = ccci_skb_dequeue(&skb_pool_16);
+		skb = ccci_skb_pool_get(&skb_pool_16);
 	return skb;
 }
 
@@ -306,6 +394,7 @@ void ccci_skb_queue_init(struct ccci_skb_queue *queue, unsigned int skb_size, un
 #endif
 	skb_queue_head_init(&queue->skb_list);
 	queue->max_len = max_len;
+	queue->cache = NULL;
 	if (fill_now) {
 		for (i = 0; i < queue->max_len; i++) {
 			struct sk_buff *skb = __alloc_skb_from_kernel(skb_size, GFP_KERNEL);
@@ -364,17 +453,22 @@ void ccci_free_skb(struct sk_buff *skb, DATA_POLICY policy)
 		     skb, policy, skb_size(skb));
 	switch (policy) {
 	case RECYCLE:
+		/* only a buffer nobody else refers to can be handed out again */
+		if (unlikely(skb_shared(skb) || skb_cloned(skb) || skb->destructor || skb_shinfo(skb)->nr_frags)) {
+			dev_kfree_skb_any(skb);
+			break;
+		}
 		/* 1. reset sk_buff (take __alloc_skb as ref.) */
 		skb->data = skb->head;
 		skb->len = 0;
 		skb_reset_tail_pointer(skb);
 		/* 2. enqueue */
 		if (skb_size(skb) < SKB_1_5K)
-			ccci_skb_enqueue(&skb_pool_16, skb);
+			ccci_skb_pool_put(&skb_pool_16, skb);
 		else if (skb_size(skb) < SKB_4K)
-			ccci_skb_enqueue(&skb_pool_1_5K, skb);
+			ccci_skb_pool_put(&skb_pool_1_5K, skb);
 		else
-			ccci_skb_enqueue(&skb_pool_4K, skb);
+			ccci_skb_pool_put(&skb_pool_4K, skb);
 		break;
 	case FREE:
 #ifdef CCCI_MEM_BM_DEBUG
@@ -616,6 +710,9 @@ int ccci_subsys_bm_init(void)
 	ccci_skb_queue_init(&skb_pool_4K, SKB_4K, SKB_POOL_SIZE_4K, 1);
 	ccci_skb_queue_init(&skb_pool_1_5K, SKB_1_5K, SKB_POOL_SIZE_1_5K, 1);
 	ccci_skb_queue_init(&skb_pool_16, SKB_16, SKB_POOL_SIZE_16, 1);
+	ccci_skb_pool_cache_init(&skb_pool_4K);
+	ccci_skb_pool_cache_init(&skb_pool_1_5K);
+	ccci_skb_pool_cache_init(&skb_pool_16);
 	/* init pool reload work */
 	pool_reload_work_queue = alloc_workqueue("pool_reload_work", WQ_UNBOUND | WQ_MEM_RECLAIM | WQ_HIGHPRI, 1);
 	INIT_WORK(&skb_pool_4K.reload_work, __4K_reload_work);
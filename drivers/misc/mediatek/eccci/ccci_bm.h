@@ -41,6 +41,8 @@ struct ccci_skb_queue {
 	struct work_struct reload_work;
 	unsigned char pre_filled;
 	unsigned int max_history;
+	struct sk_buff_head __percpu *cache;	/* only for skb pools, see ccci_skb_pool_get() */
+	unsigned int cache_max;
 	unsigned int magic_footer;
 };
 
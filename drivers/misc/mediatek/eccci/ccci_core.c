@@ -130,7 +130,7 @@ int ccci_port_recv_request(struct ccci_modem *md, struct ccci_request *req, stru
 			req->policy = RECYCLE;
 			ccci_free_req(req);
 		} else if (skb) {
-			dev_kfree_skb_any(skb);
+			ccci_free_skb(skb, RECYCLE);
 		}
 		ret = -CCCI_ERR_DROP_PACKET;
 	}
@@ -517,6 +517,7 @@ struct ccci_port {
 	unsigned int tx_busy_count;
 	unsigned int rx_busy_count;
 	int interception;
+	void *rx_ring;		/* char ports only, see dev_char_ring_setup() */
 };
 #define PORT_F_ALLOW_DROP	(1<<0)	/* packet will be dropped if port's Rx buffer full */
 #define PORT_F_RX_FULLED	(1<<1)	/* rx buffer has been full once */
@@ -3,6 +3,7 @@
 #include <linux/sched.h>
 #include <linux/delay.h>
 #include <linux/module.h>
+#include <linux/io.h>
 #include "ccci_ringbuf.h"
 #include "ccci_debug.h"
 
@@ -16,68 +17,67 @@
 #define CCIF_PKG_HEADER 0xAABBAABB
 #define CCIF_PKG_FOOTER 0xCCDDEEFF
 
-static inline void *rbf_memcpy(void *__dest, __const void *__src, size_t __n)
-{
-	int i = 0;
-	unsigned char *d = (unsigned char *)__dest, *s = (unsigned char *)__src;
-
-	for (i = __n >> 3; i > 0; i--) {
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-	}
-
-	if (__n & 1 << 2) {
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-		*d++ = *s++;
-	}
-
-	if (__n & 1 << 1) {
-		*d++ = *s++;
-		*d++ = *s++;
-	}
-
-	if (__n & 1)
-		*d++ = *s++;
-
-	return __dest;
-}
-
-/* #define rbf_memcpy memcpy */
+/*
+ * The buffer is shared memory mapped uncached, copy it with the io helpers;
+ * they move 8 bytes at a time, packages are 8 byte aligned.
+ */
 #define CCIF_RBF_READ(bufaddr, output_addr, read_size, read_pos, buflen)\
 	do {\
 		if (read_pos + read_size < buflen) {\
-			rbf_memcpy((unsigned char *)output_addr,\
-				(unsigned char *)(bufaddr) + read_pos, read_size);\
+			memcpy_fromio((unsigned char *)output_addr,\
+				(void __iomem *)((bufaddr) + read_pos), read_size);\
 		} else {\
-			rbf_memcpy((unsigned char *)output_addr,\
-					(unsigned char *)(bufaddr) + read_pos, buflen - read_pos);\
+			memcpy_fromio((unsigned char *)output_addr,\
+					(void __iomem *)((bufaddr) + read_pos), buflen - read_pos);\
 			output_addr = (unsigned char *)output_addr + buflen - read_pos;\
-			rbf_memcpy((unsigned char *)output_addr, (unsigned char *)(bufaddr),\
+			memcpy_fromio((unsigned char *)output_addr, (void __iomem *)(bufaddr),\
 					read_size - (buflen - read_pos));\
 		} \
 	} while (0)
 #define CCIF_RBF_WRITE(bufaddr, data_addr, data_size, write_pos, buflen)\
 	do {\
 		if (write_pos + data_size < buflen) {\
-			rbf_memcpy((unsigned char *)(bufaddr) + write_pos,\
+			memcpy_toio((void __iomem *)((bufaddr) + write_pos),\
 					(unsigned char *)data_addr, data_size);\
 		} else {\
-			rbf_memcpy((unsigned char *)(bufaddr) + write_pos,\
-					(unsigned char *)data_addr ,  buflen - write_pos);\
+			memcpy_toio((void __iomem *)((bufaddr) + write_pos),\
+					(unsigned char *)data_addr,  buflen - write_pos);\
 			data_addr = (unsigned char *)data_addr + buflen - write_pos;\
-			rbf_memcpy((unsigned char *)(bufaddr), (unsigned char *)data_addr,\
+			memcpy_toio((void __iomem *)(bufaddr), (unsigned char *)data_addr,\
 					data_size - (buflen - write_pos));\
 		} \
 	} while (0)
 
+#define CCIF_PKG_ALIGN(len) ((((len) + CCIF_HEADER_LEN + CCIF_FOOTER_LEN + 7) >> 3) << 3)
+
+/*
+ * The peer is the modem, not another cpu, so the barriers have to be the
+ * mandatory ones; a full barrier also keeps our stores to the data after
+ * the load of the pointer that frees it.
+ */
+static inline unsigned int rbf_load_acquire(unsigned int *ptr)
+{
+	unsigned int val = ACCESS_ONCE(*ptr);
+
+	mb();
+	return val;
+}
+
+static inline void rbf_store_release(unsigned int *ptr, unsigned int val)
+{
+	mb();
+	ACCESS_ONCE(*ptr) = val;
+}
+
+static inline int rbf_tx_free(unsigned int read, unsigned int write, unsigned int length)
+{
+	if (read == write)
+		return length - 1;
+	else if (read < write)
+		return length - write - 1 + read;
+	return read - write - 1;
+}
+
 static void ccci_ringbuf_dump(int md_id, unsigned char *title,
 			      unsigned char *buffer, unsigned int read,
 			      unsigned int length, int dump_size)
@@ -162,24 +162,15 @@ int ccci_ringbuf_writeable(int md_id, struct ccci_ringbuf *ringbuf, unsigned int
 		CCCI_ERR_MSG(md_id, TAG, "rbwb param error,ringbuf == NULL\n");
 		return -CCCI_RINGBUF_PARAM_ERR;
 	}
-	read = (unsigned int)(ringbuf->tx_control.read);
+	read = rbf_load_acquire(&ringbuf->tx_control.read);
 	write = (unsigned int)(ringbuf->tx_control.write);
 	length = (unsigned int)(ringbuf->tx_control.length);
 	if (write_size > length) {
 		CCCI_ERR_MSG(md_id, TAG, "rbwb param error,writesize(%d) > length(%d)\n", write_size, length);
 		return -CCCI_RINGBUF_PARAM_ERR;
 	}
-	write_size += CCIF_HEADER_LEN + CCIF_FOOTER_LEN;
-	/* 8 byte align */
-	write_size = (((write_size + 7) >> 3) << 3);
-	if (read == write) {
-		size = length - 1;
-	} else if (read < write) {
-		size = length - write - 1;
-		size += read;
-	} else {
-		size = read - write - 1;
-	}
+	write_size = CCIF_PKG_ALIGN(write_size);
+	size = rbf_tx_free(read, write, length);
 	/* if (write_size > size) {
 	   CCCI_INF_MSG(-1, TAG, "rbwb:rbf=%p write_size(%d)>size(%d) r=%d,w=%d\n",
 	   ringbuf,write_size,size,read,write);
@@ -187,66 +178,91 @@ int ccci_ringbuf_writeable(int md_id, struct ccci_ringbuf *ringbuf, unsigned int
 	return (write_size < size) ? write_size : -(write_size - size);
 }
 
-int ccci_ringbuf_write(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *data, int data_len)
+/*
+ * Write count packages, one per vector, and publish them to the modem with a
+ * single pointer update.  Stops at the first package that does not fit and
+ * returns the number written, or a negative error if none was.
+ */
+int ccci_ringbuf_writev(int md_id, struct ccci_ringbuf *ringbuf, const struct kvec *vec, int count)
 {
-	int aligned_data_len;
 	unsigned int read, write, length;
 	unsigned char *tx_buffer;
-	unsigned char *h_ptr;
+	unsigned char *h_ptr, *data;
+	int i, size, pkg_len, ret = -CCCI_RINGBUF_NOT_ENOUGH;
 
 	unsigned int header[2] = { CCIF_PKG_HEADER, 0x0 };
 	unsigned int footer[2] = { CCIF_PKG_FOOTER, CCIF_PKG_FOOTER };
 
-	if (ringbuf == NULL || data_len == 0 || data == NULL)
+	if (ringbuf == NULL || vec == NULL || count <= 0)
 		return -CCCI_RINGBUF_PARAM_ERR;
-	if (ccci_ringbuf_writeable(md_id, ringbuf, data_len) <= 0)
-		return -CCCI_RINGBUF_NOT_ENOUGH;
-	read = (unsigned int)(ringbuf->tx_control.read);
+	read = rbf_load_acquire(&ringbuf->tx_control.read);
 	write = (unsigned int)(ringbuf->tx_control.write);
 	length = (unsigned int)(ringbuf->tx_control.length);
 	tx_buffer = ringbuf->buffer + ringbuf->rx_control.length;
-	header[1] = data_len;
-	h_ptr = (unsigned char *)header;
-	CCIF_RBF_WRITE(tx_buffer, h_ptr, CCIF_HEADER_LEN, write, length);
-	write += CCIF_HEADER_LEN;
-	if (write >= length)
-		write -= length;
-	CCIF_RBF_WRITE(tx_buffer, data, data_len, write, length);
-	/* 8 byte align */
-	aligned_data_len = (((data_len + 7) >> 3) << 3);
-	write += aligned_data_len;
-	if (write >= length)
-		write -= length;
-	h_ptr = (unsigned char *)footer;
-	CCIF_RBF_WRITE(tx_buffer, h_ptr, CCIF_FOOTER_LEN, write, length);
-	write += CCIF_FOOTER_LEN;
-	if (write >= length)
-		write -= length;
+	size = rbf_tx_free(read, write, length);
+
+	for (i = 0; i < count; i++) {
+		if (vec[i].iov_base == NULL || vec[i].iov_len == 0 || vec[i].iov_len > length) {
+			ret = -CCCI_RINGBUF_PARAM_ERR;
+			break;
+		}
+		pkg_len = CCIF_PKG_ALIGN(vec[i].iov_len);
+		if (pkg_len >= size)
+			break;
+		size -= pkg_len;
+
+		header[1] = vec[i].iov_len;
+		h_ptr = (unsigned char *)header;
+		CCIF_RBF_WRITE(tx_buffer, h_ptr, CCIF_HEADER_LEN, write, length);
+		write += CCIF_HEADER_LEN;
+		if (write >= length)
+			write -= length;
+		data = vec[i].iov_base;
+		CCIF_RBF_WRITE(tx_buffer, data, vec[i].iov_len, write, length);
+		/* 8 byte align */
+		write += pkg_len - CCIF_HEADER_LEN - CCIF_FOOTER_LEN;
+		if (write >= length)
+			write -= length;
+		h_ptr = (unsigned char *)footer;
+		CCIF_RBF_WRITE(tx_buffer, h_ptr, CCIF_FOOTER_LEN, write, length);
+		write += CCIF_FOOTER_LEN;
+		if (write >= length)
+			write -= length;
+	}
 	CCCI_DBG_MSG(md_id, TAG,
-		     "rbw: rbf=0x%p,tx_buf=0x%p,o_write=%d,n_write=%d,datalen=%d,algined_data_len=%d,HLEN=%d,LEN=%d,read=%d\n",
+		     "rbw: rbf=0x%p,tx_buf=0x%p,o_write=%d,n_write=%d,count=%d/%d,LEN=%d,read=%d\n",
 		     ringbuf, tx_buffer, ringbuf->tx_control.write, write,
-		     data_len, aligned_data_len, 16, length, ringbuf->tx_control.read);
+		     i, count, length, read);
+	if (i == 0)
+		return ret;
 
-	ringbuf->tx_control.write = write;
+	rbf_store_release(&ringbuf->tx_control.write, write);
 
-	return data_len;
+	return i;
 }
 
-int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf)
+int ccci_ringbuf_write(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *data, int data_len)
+{
+	struct kvec vec = { .iov_base = data, .iov_len = data_len };
+	int ret;
+
+	if (data_len <= 0)
+		return -CCCI_RINGBUF_PARAM_ERR;
+	ret = ccci_ringbuf_writev(md_id, ringbuf, &vec, 1);
+
+	return ret == 1 ? data_len : ret;
+}
+
+/* check the package at read, write is the producer pointer already loaded */
+static int rbf_check_pkg(int md_id, struct ccci_ringbuf *ringbuf, unsigned int read, unsigned int write)
 {
 	unsigned char *rx_buffer, *outptr;
-	unsigned int read, write, ccci_pkg_len, ccif_pkg_len;
+	unsigned int ccci_pkg_len, ccif_pkg_len;
 	unsigned int footer_pos, length;
 	unsigned int header[2] = { 0 };
 	unsigned int footer[2] = { 0 };
 	int size;
 
-	if (ringbuf == NULL) {
-		CCCI_ERR_MSG(md_id, TAG, "rbrdb param error,ringbuf==NULL\n");
-		return -CCCI_RINGBUF_PARAM_ERR;
-	}
-	read = (unsigned int)(ringbuf->rx_control.read);
-	write = (unsigned int)(ringbuf->rx_control.write);
 	length = (unsigned int)(ringbuf->rx_control.length);
 	rx_buffer = ringbuf->buffer;
 	size = write - read;
@@ -269,9 +285,8 @@ int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf)
 	}
 	ccci_pkg_len = header[1];
 
-	ccif_pkg_len = CCIF_HEADER_LEN + ccci_pkg_len + CCIF_FOOTER_LEN;
 	/* 8 byte align */
-	ccif_pkg_len = (((ccif_pkg_len + 7) >> 3) << 3);
+	ccif_pkg_len = CCIF_PKG_ALIGN(ccci_pkg_len);
 	if (ccif_pkg_len > size) {
 		CCCI_ERR_MSG(md_id, TAG, "rbrdb:header ccif_pkg_len(%d) > all data size(%d)\n", ccif_pkg_len, size);
 		return -CCCI_RINGBUF_NOT_COMPLETE;
@@ -291,6 +306,19 @@ int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf)
 	return ccci_pkg_len;
 }
 
+int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf)
+{
+	unsigned int write;
+
+	if (ringbuf == NULL) {
+		CCCI_ERR_MSG(md_id, TAG, "rbrdb param error,ringbuf==NULL\n");
+		return -CCCI_RINGBUF_PARAM_ERR;
+	}
+	write = rbf_load_acquire(&ringbuf->rx_control.write);
+
+	return rbf_check_pkg(md_id, ringbuf, ringbuf->rx_control.read, write);
+}
+
 int ccci_ringbuf_read(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *buf, int read_size)
 {
 	unsigned int read, write, length;
@@ -315,13 +343,84 @@ void ccci_ringbuf_move_rpointer(int md_id, struct ccci_ringbuf *ringbuf, int rea
 
 	read = (unsigned int)(ringbuf->rx_control.read);
 	length = (unsigned int)(ringbuf->rx_control.length);
-	/* Update read pointer */
-	read += read_size + CCIF_HEADER_LEN + CCIF_FOOTER_LEN;
-	/* 8 byte align */
-	read = (((read + 7) >> 3) << 3);
+	/* Update read pointer, 8 byte align */
+	read += CCIF_PKG_ALIGN(read_size);
 	if (read >= length)
 		read -= length;
-	ringbuf->rx_control.read = read;
+	rbf_store_release(&ringbuf->rx_control.read, read);
+}
+
+/*
+ * Peek/commit consumer API: packages are looked at in place and their
+ * space is only given back to the modem by ccci_ringbuf_commit(), so a
+ * batch of packages costs one pointer update.
+ *
+ *	ccci_ringbuf_rd_begin(md_id, rbf, &rd);
+ *	while (ccci_ringbuf_peek(md_id, rbf, &rd) >= 0) {
+ *		... use rd.seg[] or ccci_ringbuf_peek_copy() ...
+ *		ccci_ringbuf_consume(rbf, &rd);
+ *	}
+ *	ccci_ringbuf_commit(md_id, rbf, &rd);
+ */
+void ccci_ringbuf_rd_begin(int md_id, struct ccci_ringbuf *ringbuf, struct ccci_ringbuf_rd *rd)
+{
+	rd->read = (unsigned int)(ringbuf->rx_control.read);
+	rd->write = rbf_load_acquire(&ringbuf->rx_control.write);
+	rd->pkg_len = 0;
+}
+
+/* returns the payload length of the next package, or a negative error */
+int ccci_ringbuf_peek(int md_id, struct ccci_ringbuf *ringbuf, struct ccci_ringbuf_rd *rd)
+{
+	unsigned int start, length;
+	int ret;
+
+	ret = rbf_check_pkg(md_id, ringbuf, rd->read, rd->write);
+	if (ret == -CCCI_RINGBUF_EMPTY) {
+		/* the modem may have written more since we looked */
+		rd->write = rbf_load_acquire(&ringbuf->rx_control.write);
+		ret = rbf_check_pkg(md_id, ringbuf, rd->read, rd->write);
+	}
+	if (ret < 0) {
+		rd->pkg_len = 0;
+		return ret;
+	}
+
+	length = (unsigned int)(ringbuf->rx_control.length);
+	start = rd->read + CCIF_HEADER_LEN;
+	if (start >= length)
+		start -= length;
+	rd->pkg_len = ret;
+	rd->seg[0].data = ringbuf->buffer + start;
+	rd->seg[0].len = min_t(unsigned int, ret, length - start);
+	rd->seg[1].data = ringbuf->buffer;
+	rd->seg[1].len = ret - rd->seg[0].len;
+
+	return ret;
+}
+
+void ccci_ringbuf_peek_copy(struct ccci_ringbuf_rd *rd, unsigned char *buf)
+{
+	memcpy_fromio(buf, (void __iomem *)rd->seg[0].data, rd->seg[0].len);
+	if (rd->seg[1].len)
+		memcpy_fromio(buf + rd->seg[0].len, (void __iomem *)rd->seg[1].data, rd->seg[1].len);
+}
+
+/* step over the peeked package, the modem does not see it until commit */
+void ccci_ringbuf_consume(struct ccci_ringbuf *ringbuf, struct ccci_ringbuf_rd *rd)
+{
+	unsigned int length = (unsigned int)(ringbuf->rx_control.length);
+
+	rd->read += CCIF_PKG_ALIGN(rd->pkg_len);
+	if (rd->read >= length)
+		rd->read -= length;
+	rd->pkg_len = 0;
+}
+
+void ccci_ringbuf_commit(int md_id, struct ccci_ringbuf *ringbuf, struct ccci_ringbuf_rd *rd)
+{
+	if (ringbuf->rx_control.read != rd->read)
+		rbf_store_release(&ringbuf->rx_control.read, rd->read);
 }
 
 void ccci_ringbuf_reset(int md_id, struct ccci_ringbuf *ringbuf, int dir)
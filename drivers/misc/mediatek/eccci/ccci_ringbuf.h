@@ -1,5 +1,6 @@
 #ifndef __CCCI_RINGBUF_H__
 #define __CCCI_RINGBUF_H__
+#include <linux/uio.h>
 #include "ccci_core.h"
 typedef enum {
 	CCCI_RINGBUF_OK = 0,
@@ -21,11 +22,41 @@ struct ccci_ringbuf {
 };
 #define CCCI_RINGBUF_CTL_LEN (8+sizeof(struct ccci_ringbuf)+8)
 
+/*
+ * Each direction of a ring buffer has exactly one producer and one consumer,
+ * one on the AP and one on the modem: the producer only ever stores write and
+ * the consumer only ever stores read.  The other side's pointer is loaded with
+ * acquire semantics before the data it covers is touched, and the own pointer
+ * is stored with release semantics once the data is copied, so no lock is
+ * shared with the modem.  AP side callers still serialize among themselves
+ * (tx_lock and rx_on_going in modem_ccif.c).
+ */
+
+/* Payload of a peeked package, split in two when it wraps */
+struct ccci_ringbuf_seg {
+	unsigned char *data;
+	unsigned int len;
+};
+
+/* Consumer cursor, see ccci_ringbuf_peek() */
+struct ccci_ringbuf_rd {
+	unsigned int read;	/* next package, not yet given back to the producer */
+	unsigned int write;	/* producer pointer as last loaded */
+	int pkg_len;
+	struct ccci_ringbuf_seg seg[2];
+};
+
 int ccci_ringbuf_readable(int md_id, struct ccci_ringbuf *ringbuf);
 int ccci_ringbuf_writeable(int md_id, struct ccci_ringbuf *ringbuf, unsigned int write_size);
 struct ccci_ringbuf *ccci_create_ringbuf(int md_id, unsigned char *buf, int buf_size, int rx_size, int tx_size);
 int ccci_ringbuf_read(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *buf, int read_size);
 int ccci_ringbuf_write(int md_id, struct ccci_ringbuf *ringbuf, unsigned char *data, int data_len);
+int ccci_ringbuf_writev(int md_id, struct ccci_ringbuf *ringbuf, const struct kvec *vec, int count);
 void ccci_ringbuf_move_rpointer(int md_id, struct ccci_ringbuf *ringbuf, int read_size);
+void ccci_ringbuf_rd_begin(int md_id, struct ccci_ringbuf *ringbuf, struct ccci_ringbuf_rd *rd);
+int ccci_ringbuf_peek(int md_id, struct ccci_ringbuf *ringbuf, struct ccci_ringbuf_rd *rd);
+void ccci_ringbuf_peek_copy(struct ccci_ringbuf_rd *rd, unsigned char *buf);
+void ccci_ringbuf_consume(struct ccci_ringbuf *ringbuf, struct ccci_ringbuf_rd *rd);
+void ccci_ringbuf_commit(int md_id, struct ccci_ringbuf *ringbuf, struct ccci_ringbuf_rd *rd);
 void ccci_ringbuf_reset(int md_id, struct ccci_ringbuf *ringbuf, int dir);
 #endif				/* __CCCI_RINGBUF_H__ */
@@ -0,0 +1,369 @@
+/*
+ * Traffic generator for the CLDMA loopback, see cldma_loopback_xmit().
+ *
+ * With loopback set in /sys/kernel/debug/cldma_mdN/,
+ *   echo "<ccmni> <bytes> <Mbps> <seconds> [tos]" > loopgen
+ * sends UDP packets of <bytes> (IP length) through that ccmni device of the
+ * modem, at <Mbps> or as fast as the device takes them for 0, and takes
+ * them off again with an rx_handler when they come back up, before the IP
+ * stack.  The write returns when the run is over, cat loopgen then gives
+ * the result as key=value lines: throughput, submit to receive latency,
+ * drops on the way and per CLDMA queue, and the busy time of all CPUs
+ * (anything else running included) per Gbps.  A tos of 160 (CS5) or more
+ * puts packets of up to 512 bytes on the fast queue, see is_urgent_skb().
+ */
+#include <linux/kernel.h>
+#include <linux/netdevice.h>
+#include <linux/rtnetlink.h>
+#include <linux/skbuff.h>
+#include <linux/ip.h>
+#include <linux/udp.h>
+#include <linux/in.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/sched.h>
+#include <linux/delay.h>
+#include <linux/kernel_stat.h>
+#include <linux/uaccess.h>
+#include <linux/math64.h>
+#include <linux/vmalloc.h>
+#include <net/ip.h>
+#include "ccci_config.h"
+#include "ccci_core.h"
+#include "modem_cldma.h"
+
+#define TAG "lpg"
+
+#define LOOPGEN_MAGIC		0x4c50474eU	/* "LPGN" */
+#define LOOPGEN_PORT		9
+#define LOOPGEN_HDR_LEN		(sizeof(struct iphdr) + sizeof(struct udphdr))
+#define LOOPGEN_BUCKET_US	10
+#define LOOPGEN_BUCKETS		2000	/* the last one takes 20ms and over */
+#define LOOPGEN_DRAIN_MS	200	/* wait for the last packets to come back */
+
+struct loopgen_payload {
+	__be32 magic;
+	u32 seq;
+	u64 stamp_ns;	/* local_clock() at dev_queue_xmit() */
+};
+
+struct loopgen_result {
+	char dev[IFNAMSIZ];
+	unsigned int size, rate_mbps, secs, tos;
+	u64 wall_ns, cpu_ns;
+	unsigned long tx_pkts, tx_drops, rx_pkts;
+	unsigned long dev_tx_dropped;
+	unsigned long txq_pkts[CLDMA_TXQ_NUM], txq_drops[CLDMA_TXQ_NUM];
+	unsigned long rxq_pkts[CLDMA_RXQ_NUM];
+	u64 lat_sum_ns, lat_max_ns;
+	unsigned int lat_us[3];	/* p50, p90, p99 */
+	int err;
+};
+
+static DEFINE_MUTEX(loopgen_mutex);
+static DEFINE_SPINLOCK(loopgen_rx_lock);	/* rx side, taken from softirq only */
+static unsigned int *loopgen_hist;
+static unsigned long loopgen_rx_pkts;
+static u64 loopgen_lat_sum, loopgen_lat_max;
+static struct loopgen_result loopgen_res;
+
+static rx_handler_result_t loopgen_rx_handler(struct sk_buff **pskb)
+{
+	struct sk_buff *skb = *pskb;
+	struct loopgen_payload *pl;
+	struct iphdr *iph;
+	struct udphdr *udph;
+	u64 lat;
+
+	if (skb->protocol != htons(ETH_P_IP) || !pskb_may_pull(skb, LOOPGEN_HDR_LEN + sizeof(*pl)))
+		return RX_HANDLER_PASS;
+	iph = (struct iphdr *)skb->data;
+	udph = (struct udphdr *)(iph + 1);
+	pl = (struct loopgen_payload *)(udph + 1);
+	if (iph->ihl != 5 || iph->protocol != IPPROTO_UDP || udph->dest != htons(LOOPGEN_PORT) ||
+	    pl->magic != htonl(LOOPGEN_MAGIC))
+		return RX_HANDLER_PASS;
+
+	lat = local_clock() - pl->stamp_ns;
+	spin_lock(&loopgen_rx_lock);
+	loopgen_rx_pkts++;
+	loopgen_lat_sum += lat;
+	loopgen_lat_max = max(loopgen_lat_max, lat);
+	loopgen_hist[min_t(u64, div_u64(lat, LOOPGEN_BUCKET_US * NSEC_PER_USEC), LOOPGEN_BUCKETS - 1)]++;
+	spin_unlock(&loopgen_rx_lock);
+
+	consume_skb(skb);
+	return RX_HANDLER_CONSUMED;
+}
+
+static struct sk_buff *loopgen_alloc_skb(struct net_device *dev, struct loopgen_result *res, u32 seq)
+{
+	struct sk_buff *skb;
+	struct iphdr *iph;
+	struct udphdr *udph;
+	struct loopgen_payload *pl;
+
+	skb = alloc_skb(LL_RESERVED_SPACE(dev) + res->size, GFP_KERNEL);
+	if (!skb)
+		return NULL;
+	skb_reserve(skb, LL_RESERVED_SPACE(dev));
+	skb_reset_network_header(skb);
+	/* nothing of the kernel leaks should it reach the modem after all */
+	iph = (struct iphdr *)skb_put(skb, res->size);
+	memset(iph, 0, res->size);
+
+	iph->version = 4;
+	iph->ihl = 5;
+	iph->tos = res->tos;
+	iph->tot_len = htons(res->size);
+	iph->id = htons((u16)seq);
+	iph->ttl = 64;
+	iph->protocol = IPPROTO_UDP;
+	iph->saddr = htonl(0x0a000001);	/* 10.0.0.1 */
+	iph->daddr = htonl(0x0a000002);
+	ip_send_check(iph);
+	udph = (struct udphdr *)(iph + 1);
+	udph->source = htons(LOOPGEN_PORT);
+	udph->dest = htons(LOOPGEN_PORT);
+	udph->len = htons(res->size - sizeof(struct iphdr));
+	pl = (struct loopgen_payload *)(udph + 1);
+	pl->magic = htonl(LOOPGEN_MAGIC);
+	pl->seq = seq;
+
+	skb->dev = dev;
+	skb->protocol = htons(ETH_P_IP);
+	return skb;
+}
+
+static u64 loopgen_cpu_busy(void)
+{
+	u64 busy = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		u64 *st = kcpustat_cpu(cpu).cpustat;
+
+		busy += cputime64_to_jiffies64(st[CPUTIME_USER] + st[CPUTIME_NICE] + st[CPUTIME_SYSTEM] +
+					       st[CPUTIME_IRQ] + st[CPUTIME_SOFTIRQ]);
+	}
+	return busy;
+}
+
+static unsigned int loopgen_percentile(unsigned long n, unsigned int permille)
+{
+	unsigned long want = div_u64((u64)n * permille + 999, 1000), seen = 0;
+	int i;
+
+	for (i = 0; i < LOOPGEN_BUCKETS; i++) {
+		seen += loopgen_hist[i];
+		if (seen >= want)
+			break;
+	}
+	return (i + 1) * LOOPGEN_BUCKET_US;
+}
+
+/* in the writer's context, loopgen_mutex held */
+static int loopgen_run(struct ccci_modem *md, struct loopgen_result *res)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	unsigned long txq_pkts[CLDMA_TXQ_NUM], txq_drops[CLDMA_TXQ_NUM], rxq_pkts[CLDMA_RXQ_NUM];
+	unsigned long dev_dropped;
+	struct net_device *dev;
+	struct sk_buff *skb;
+	struct loopgen_payload *pl;
+	u64 start, end, now, next, interval_ns = 0, cpu;
+	u32 seq = 0;
+	int i, ret;
+
+	if (!md_ctrl->loopback)
+		return -EPERM;
+	dev = dev_get_by_name(&init_net, res->dev);
+	if (!dev)
+		return -ENODEV;
+	if (res->size < LOOPGEN_HDR_LEN + sizeof(*pl) || res->size > dev->mtu || !res->secs) {
+		ret = -EINVAL;
+		goto out_put;
+	}
+	if (!loopgen_hist) {
+		loopgen_hist = vmalloc(LOOPGEN_BUCKETS * sizeof(*loopgen_hist));
+		if (!loopgen_hist) {
+			ret = -ENOMEM;
+			goto out_put;
+		}
+	}
+	memset(loopgen_hist, 0, LOOPGEN_BUCKETS * sizeof(*loopgen_hist));
+	loopgen_rx_pkts = 0;
+	loopgen_lat_sum = 0;
+	loopgen_lat_max = 0;
+
+	rtnl_lock();
+	ret = netdev_rx_handler_register(dev, loopgen_rx_handler, NULL);
+	rtnl_unlock();
+	if (ret)
+		goto out_put;
+
+	for (i = 0; i < CLDMA_TXQ_NUM; i++) {
+		txq_pkts[i] = md_ctrl->txq[i].loop_pkts;
+		txq_drops[i] = md_ctrl->txq[i].loop_drops;
+	}
+	for (i = 0; i < CLDMA_RXQ_NUM; i++)
+		rxq_pkts[i] = md_ctrl->rxq[i].loop_pkts;
+	dev_dropped = dev->stats.tx_dropped;
+	if (res->rate_mbps)
+		interval_ns = div_u64((u64)res->size * 8 * NSEC_PER_SEC, res->rate_mbps * 1000000ULL);
+
+	cpu = loopgen_cpu_busy();
+	start = next = local_clock();
+	end = start + (u64)res->secs * NSEC_PER_SEC;
+	while ((now = local_clock()) < end && !signal_pending(current)) {
+		if (interval_ns) {
+			if (now < next) {
+				if (next - now > 100 * NSEC_PER_USEC)
+					usleep_range(50, 100);
+				else
+					cpu_relax();
+				continue;
+			}
+			/* do not make up for a stall with a burst */
+			if (now - next > NSEC_PER_MSEC)
+				next = now;
+			next += interval_ns;
+		}
+
+		skb = loopgen_alloc_skb(dev, res, seq++);
+		if (!skb) {
+			res->tx_drops++;
+			usleep_range(100, 200);
+			continue;
+		}
+		pl = (struct loopgen_payload *)(skb->data + LOOPGEN_HDR_LEN);
+		pl->stamp_ns = local_clock();
+		if (net_xmit_eval(dev_queue_xmit(skb)) == 0) {
+			res->tx_pkts++;
+		} else {
+			res->tx_drops++;
+			/* the qdisc is full, let the ring drain */
+			if (!interval_ns)
+				usleep_range(20, 50);
+		}
+		if (!(seq & 63))
+			cond_resched();
+	}
+	now = local_clock();
+	res->wall_ns = now - start;
+	res->cpu_ns = div_u64((loopgen_cpu_busy() - cpu) * NSEC_PER_SEC, HZ);
+	msleep(LOOPGEN_DRAIN_MS);
+
+	rtnl_lock();
+	netdev_rx_handler_unregister(dev);	/* waits for the handler to be done */
+	rtnl_unlock();
+
+	res->rx_pkts = loopgen_rx_pkts;
+	res->lat_sum_ns = loopgen_lat_sum;
+	res->lat_max_ns = loopgen_lat_max;
+	if (res->rx_pkts) {
+		res->lat_us[0] = loopgen_percentile(res->rx_pkts, 500);
+		res->lat_us[1] = loopgen_percentile(res->rx_pkts, 900);
+		res->lat_us[2] = loopgen_percentile(res->rx_pkts, 990);
+	}
+	res->dev_tx_dropped = dev->stats.tx_dropped - dev_dropped;
+	for (i = 0; i < CLDMA_TXQ_NUM; i++) {
+		res->txq_pkts[i] = md_ctrl->txq[i].loop_pkts - txq_pkts[i];
+		res->txq_drops[i] = md_ctrl->txq[i].loop_drops - txq_drops[i];
+	}
+	for (i = 0; i < CLDMA_RXQ_NUM; i++)
+		res->rxq_pkts[i] = md_ctrl->rxq[i].loop_pkts - rxq_pkts[i];
+	CCCI_INF_MSG(md->index, TAG, "%s: %lu sent, %lu back in %llums\n", res->dev, res->tx_pkts,
+		     res->rx_pkts, div_u64(res->wall_ns, NSEC_PER_MSEC));
+	ret = 0;
+
+ out_put:
+	dev_put(dev);
+	return ret;
+}
+
+static int loopgen_show(struct seq_file *m, void *v)
+{
+	struct loopgen_result *res = &loopgen_res;
+	u64 mbps = 0, tx_mbps = 0, busy_pct = 0;
+	int i;
+
+	mutex_lock(&loopgen_mutex);
+	if (!res->dev[0])
+		goto out;
+	if (res->wall_ns) {
+		mbps = div64_u64((u64)res->rx_pkts * res->size * 8 * 1000, res->wall_ns);
+		tx_mbps = div64_u64((u64)res->tx_pkts * res->size * 8 * 1000, res->wall_ns);
+		busy_pct = div64_u64(res->cpu_ns * 100, res->wall_ns);
+	}
+	seq_printf(m, "dev=%s size=%u rate_mbps=%u secs=%u tos=%u err=%d\n", res->dev, res->size,
+		   res->rate_mbps, res->secs, res->tos, res->err);
+	seq_printf(m, "tx_pkts=%lu tx_drops=%lu dev_tx_dropped=%lu rx_pkts=%lu lost=%ld\n",
+		   res->tx_pkts, res->tx_drops, res->dev_tx_dropped, res->rx_pkts,
+		   (long)(res->tx_pkts - res->rx_pkts));
+	seq_printf(m, "tx_mbps=%llu rx_mbps=%llu cpu_busy_pct=%llu cpu_pct_per_gbps=%llu\n", tx_mbps, mbps,
+		   busy_pct, mbps ? div64_u64(busy_pct * 1000, mbps) : 0);
+	seq_printf(m, "lat_avg_us=%llu lat_p50_us=%u lat_p90_us=%u lat_p99_us=%u lat_max_us=%llu\n",
+		   res->rx_pkts ? div64_u64(res->lat_sum_ns, (u64)res->rx_pkts * NSEC_PER_USEC) : 0,
+		   res->lat_us[0], res->lat_us[1], res->lat_us[2],
+		   div_u64(res->lat_max_ns, NSEC_PER_USEC));
+	for (i = 0; i < CLDMA_TXQ_NUM; i++) {
+		if (res->txq_pkts[i] || res->txq_drops[i])
+			seq_printf(m, "txq=%d pkts=%lu drops=%lu\n", i, res->txq_pkts[i], res->txq_drops[i]);
+	}
+	for (i = 0; i < CLDMA_RXQ_NUM; i++) {
+		if (res->rxq_pkts[i])
+			seq_printf(m, "rxq=%d pkts=%lu\n", i, res->rxq_pkts[i]);
+	}
+ out:
+	mutex_unlock(&loopgen_mutex);
+	return 0;
+}
+
+static int loopgen_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, loopgen_show, inode->i_private);
+}
+
+static ssize_t loopgen_write(struct file *file, const char __user *ubuf, size_t cnt, loff_t *ppos)
+{
+	struct ccci_modem *md = ((struct seq_file *)file->private_data)->private;
+	struct loopgen_result res;
+	char buf[64];
+	int ret;
+
+	if (cnt >= sizeof(buf))
+		return -EINVAL;
+	if (copy_from_user(buf, ubuf, cnt))
+		return -EFAULT;
+	buf[cnt] = 0;
+
+	memset(&res, 0, sizeof(res));
+	if (sscanf(buf, "%15s %u %u %u %u", res.dev, &res.size, &res.rate_mbps, &res.secs, &res.tos) < 4)
+		return -EINVAL;
+	if (res.tos > 255)
+		return -EINVAL;
+
+	mutex_lock(&loopgen_mutex);
+	ret = loopgen_run(md, &res);
+	res.err = ret;
+	loopgen_res = res;
+	mutex_unlock(&loopgen_mutex);
+
+	return ret ? ret : cnt;
+}
+
+static const struct file_operations loopgen_fops = {
+	.open = loopgen_open,
+	.read = seq_read,
+	.write = loopgen_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+void cldma_loopgen_debugfs_init(struct ccci_modem *md, struct dentry *dir)
+{
+	debugfs_create_file("loopgen", 0644, dir, md, &loopgen_fops);
+}
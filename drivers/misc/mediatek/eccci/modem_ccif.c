@@ -51,6 +51,7 @@
 	((md->md_state != EXCEPTION || md->ex_stage != EX_INIT_DONE) && ((1<<qno) & NET_RX_QUEUE_MASK))
 
 #define RX_BUGDET 16
+#define CCIF_RX_COMMIT_BATCH 4	/* packages consumed per rx read pointer update */
 
 #define RINGQ_BASE (8)
 #define RINGQ_SRAM (7)
@@ -198,6 +199,7 @@ static int ccif_rx_collect(struct md_ccif_queue *queue, int budget, int blocking
 	int qno = queue->index;
 	struct ccci_header *ccci_h = NULL;
 	struct sk_buff *skb;
+	struct ccci_ringbuf_rd rd;
 
 	spin_lock_irqsave(&queue->rx_lock, flags);
 	if (queue->rx_on_going != 0) {
@@ -208,8 +210,9 @@ static int ccif_rx_collect(struct md_ccif_queue *queue, int budget, int blocking
 	}
 	queue->rx_on_going = 1;
 	spin_unlock_irqrestore(&queue->rx_lock, flags);
+	ccci_ringbuf_rd_begin(md->index, rx_buf, &rd);
 	while (1) {
-		pkg_size = ccci_ringbuf_readable(md->index, rx_buf);
+		pkg_size = ccci_ringbuf_peek(md->index, rx_buf, &rd);
 		if (pkg_size < 0) {
 			CCCI_DBG_MSG(md->index, TAG, "Q%d Rx:rbf readable ret=%d\n", queue->index, pkg_size);
 			BUG_ON(pkg_size != -CCCI_RINGBUF_EMPTY);
@@ -235,8 +238,7 @@ static int ccif_rx_collect(struct md_ccif_queue *queue, int budget, int blocking
 		}
 		data_ptr = (unsigned char *)skb_put(skb, pkg_size);
 		/* copy data into skb */
-		ret = ccci_ringbuf_read(md->index, rx_buf, data_ptr, pkg_size);
-		BUG_ON(ret < 0);
+		ccci_ringbuf_peek_copy(&rd, data_ptr);
 		ccci_h = (struct ccci_header *)skb->data;
 		if (atomic_cmpxchg(&md->wakeup_src, 1, 0) == 1)
 			CCCI_INF_MSG(md->index, TAG, "CCIF_MD wakeup source:(%d/%d)\n", queue->index,
@@ -250,7 +252,10 @@ static int ccif_rx_collect(struct md_ccif_queue *queue, int budget, int blocking
 				CCCI_INF_MSG(md->index, TAG, "Q%d Rx recv req ret=%d\n", queue->index, ret);
 				queue->debug_id = 0;
 			}
-			ccci_ringbuf_move_rpointer(md->index, rx_buf, pkg_size);
+			ccci_ringbuf_consume(rx_buf, &rd);
+			/* hand space back to the modem in batches rather than per package */
+			if ((count % CCIF_RX_COMMIT_BATCH) == 0)
+				ccci_ringbuf_commit(md->index, rx_buf, &rd);
 			ret = 0;
 			/* step forward */
 			req = list_entry(req->entry.next, struct ccci_request, entry);
@@ -275,6 +280,7 @@ static int ccif_rx_collect(struct md_ccif_queue *queue, int budget, int blocking
 	}
 
  OUT:
+	ccci_ringbuf_commit(md->index, rx_buf, &rd);
 	*result = count;
 	CCCI_DBG_MSG(md->index, TAG, "Q%d rx %d pkg,ret=%d\n", queue->index, count, ret);
 	spin_lock_irqsave(&queue->rx_lock, flags);
@@ -20,11 +20,15 @@
 #include <linux/netdevice.h>
 #include <linux/random.h>
 #include <linux/platform_device.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/math64.h>
 #if defined(CONFIG_MTK_AEE_FEATURE)
 #include <mt-plat/aee.h>
 #endif
 #include <mt_spm_sleep.h>
 #include <mt-plat/mt_boot.h>
+#include <mt-plat/perfmgr.h>
 #include "ccci_config.h"
 #include "ccci_core.h"
 #include "ccci_bm.h"
@@ -95,6 +99,7 @@ static const unsigned char high_priority_queue_mask = 0x00;
 
 #define CLDMA_CG_POLL 6
 #define CLDMA_ACTIVE_T 20
+#define CLDMA_TX_BATCH_MAX 16	/* packets filled before the doorbell is rung anyway */
 
 #define BOOT_TIMER_ON 20/*10*/
 
@@ -105,6 +110,12 @@ static const unsigned char high_priority_queue_mask = 0x00;
 #define IS_NET_QUE(md, qno) \
 	((md->md_state != EXCEPTION || md->ex_stage != EX_INIT_DONE) && ((1<<qno) & NET_RX_QUEUE_MASK))
 
+/*
+ * network skbs are freed as soon as CLDMA has consumed them, TCP small queues
+ * and BQL only see completions from here; other queues batch them up
+ */
+#define CLDMA_TX_DONE_DELAY(md, qno) (IS_NET_QUE(md, qno) ? 0 : msecs_to_jiffies(10))
+
 static void cldma_dump_gpd_queue(struct ccci_modem *md, unsigned int qno)
 {
 	unsigned int *tmp;
@@ -307,6 +318,35 @@ static void cldma_timeout_timer_func(unsigned long data)
 }
 #endif
 
+/*
+ * Network rings receive into page fragments wrapped by build_skb(), with
+ * NET_SKB_PAD of headroom for the Ethernet header ccmni puts in front of
+ * the packet.  Refilling them never goes to kmalloc, and the page frag
+ * cache hands a page out again once the stack has freed every skb on it.
+ */
+static struct sk_buff *cldma_rx_alloc_skb(struct cldma_ring *ring, char from_pool, char blocking)
+{
+	unsigned int size;
+	struct sk_buff *skb;
+	void *data;
+
+	if (!ring->frag_rx)
+		return ccci_alloc_skb(ring->pkt_size, from_pool, blocking);
+
+	size = SKB_DATA_ALIGN(NET_SKB_PAD + ring->pkt_size) + SKB_DATA_ALIGN(sizeof(struct skb_shared_info));
+	data = netdev_alloc_frag(size);
+	if (likely(data)) {
+		skb = build_skb(data, size);
+		if (likely(skb)) {
+			skb_reserve(skb, NET_SKB_PAD);
+			return skb;
+		}
+		put_page(virt_to_head_page(data));
+	}
+	/* out of fragments, a linear buffer still beats starving the ring */
+	return ccci_alloc_skb(ring->pkt_size, 0, blocking);
+}
+
 static int cldma_gpd_rx_refill(struct md_cd_queue *queue)
 {
 	struct ccci_modem *md = queue->modem;
@@ -327,7 +367,7 @@ static int cldma_gpd_rx_refill(struct md_cd_queue *queue)
 		}
 		spin_unlock_irqrestore(&queue->ring_lock, flags);
 		/* allocate a new skb outside of lock */
-		new_skb = ccci_alloc_skb(queue->tr_ring->pkt_size, !is_net_queue, 1);
+		new_skb = cldma_rx_alloc_skb(queue->tr_ring, !is_net_queue, 1);
 		if (likely(new_skb)) {
 			rgpd = (struct cldma_rgpd *)req->gpd;
 			req->data_buffer_ptr_saved =
@@ -358,6 +398,110 @@ static int cldma_gpd_rx_refill(struct md_cd_queue *queue)
 	return count;
 }
 
+/*
+ * Throughput boost
+ *
+ * At LTE rates the cpu collecting CLDMA Rx sits at whatever OPP the
+ * governor left it and starts dropping packets well below the radio limit.
+ * Collectors count the bytes of their queue and a deferrable work samples
+ * them every CLDMA_TPUT_SAMPLE_MS while there is traffic, keeping a smoothed
+ * rate per direction.  Above cldma_boost_on_kbps in either direction the
+ * modem files a perfmgr boost request (cores, LITTLE minimum frequency and
+ * vcore), dropped again once both rates are below cldma_boost_off_kbps.
+ * The request is timed, so it goes away by itself if sampling stops.
+ */
+#define CLDMA_TPUT_SAMPLE_MS	100
+#define CLDMA_BOOST_HOLD_MS	(4 * CLDMA_TPUT_SAMPLE_MS)
+
+static unsigned int cldma_boost_on_kbps = 60000;
+static unsigned int cldma_boost_off_kbps = 20000;
+static unsigned int cldma_boost_cores = 2;
+
+static inline void cldma_tput_account(struct md_cd_queue *queue, unsigned int bytes)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)queue->modem->private_data;
+
+	queue->tput_bytes += bytes;
+	if (unlikely(!atomic_read(&md_ctrl->tput_on)) && !atomic_xchg(&md_ctrl->tput_on, 1))
+		queue_delayed_work(system_wq, &md_ctrl->tput_work, msecs_to_jiffies(CLDMA_TPUT_SAMPLE_MS));
+}
+
+static void cldma_boost_update(struct ccci_modem *md, int boost)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	struct perfmgr_boost_req req;
+
+	if (boost) {
+		perfmgr_boost_req_init(&req);
+		req.min_cores_l = cldma_boost_cores;
+		req.min_freq_l = perfmgr_get_target_freq();
+		req.vcore = 1;
+		/* re-filed every sample to keep it from expiring */
+		perfmgr_boost_request(PERFMGR_BOOST_MODEM, &req, CLDMA_BOOST_HOLD_MS);
+	} else if (md_ctrl->tput_boost) {
+		perfmgr_boost_cancel(PERFMGR_BOOST_MODEM);
+	}
+	if (boost != md_ctrl->tput_boost)
+		CCCI_INF_MSG(md->index, TAG, "tput boost %d, rx=%ukbps tx=%ukbps\n", boost,
+			     md_ctrl->tput_kbps[IN], md_ctrl->tput_kbps[OUT]);
+	md_ctrl->tput_boost = boost;
+}
+
+static void cldma_tput_work(struct work_struct *work)
+{
+	struct md_cd_ctrl *md_ctrl = container_of(to_delayed_work(work), struct md_cd_ctrl, tput_work);
+	struct ccci_modem *md = md_ctrl->modem;
+	unsigned long long bytes[2] = { 0, 0 };
+	unsigned long long now = sched_clock();
+	unsigned long long delta = now - md_ctrl->tput_stamp;
+	int i, dir, boost;
+
+	for (i = 0; i < QUEUE_LEN(md_ctrl->rxq); i++)
+		bytes[IN] += ACCESS_ONCE(md_ctrl->rxq[i].tput_bytes);
+	for (i = 0; i < QUEUE_LEN(md_ctrl->txq); i++)
+		bytes[OUT] += ACCESS_ONCE(md_ctrl->txq[i].tput_bytes);
+
+	for (dir = IN; dir <= OUT; dir++) {
+		/* bytes * 8 / 1000 per second, ns clock */
+		unsigned int kbps = div64_u64((bytes[dir] - md_ctrl->tput_last[dir]) * 8 * USEC_PER_SEC,
+					      max_t(u64, delta, NSEC_PER_MSEC));
+
+		md_ctrl->tput_kbps[dir] = (md_ctrl->tput_kbps[dir] + kbps) / 2;
+		md_ctrl->tput_last[dir] = bytes[dir];
+	}
+	md_ctrl->tput_stamp = now;
+
+	if (md_ctrl->tput_boost)
+		boost = md_ctrl->tput_kbps[IN] >= cldma_boost_off_kbps ||
+			md_ctrl->tput_kbps[OUT] >= cldma_boost_off_kbps;
+	else
+		boost = md_ctrl->tput_kbps[IN] >= cldma_boost_on_kbps ||
+			md_ctrl->tput_kbps[OUT] >= cldma_boost_on_kbps;
+	if (!cldma_boost_on_kbps)
+		boost = 0;
+	cldma_boost_update(md, boost);
+
+	/* idle, the next packet restarts sampling */
+	if (!boost && !md_ctrl->tput_kbps[IN] && !md_ctrl->tput_kbps[OUT]) {
+		atomic_set(&md_ctrl->tput_on, 0);
+		return;
+	}
+	queue_delayed_work(system_wq, &md_ctrl->tput_work, msecs_to_jiffies(CLDMA_TPUT_SAMPLE_MS));
+}
+
+static void cldma_tput_stop(struct ccci_modem *md)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+
+	/* keep collectors from restarting it */
+	atomic_set(&md_ctrl->tput_on, 1);
+	cancel_delayed_work_sync(&md_ctrl->tput_work);
+	md_ctrl->tput_kbps[IN] = 0;
+	md_ctrl->tput_kbps[OUT] = 0;
+	cldma_boost_update(md, 0);
+	atomic_set(&md_ctrl->tput_on, 0);
+}
+
 static int cldma_gpd_rx_collect(struct md_cd_queue *queue, int budget, int blocking, int *result,
 				int *rxbytes)
 {
@@ -399,6 +543,7 @@ static int cldma_gpd_rx_collect(struct md_cd_queue *queue, int budget, int block
 							skb_data_size(req->skb), DMA_FROM_DEVICE);
 		skb_put(skb, rgpd->data_buff_len);
 		skb_bytes = skb->len;
+		cldma_tput_account(queue, skb_bytes);
 		ccci_h = *((struct ccci_header *)skb->data);
 		/* check wakeup source */
 		if (atomic_cmpxchg(&md->wakeup_src, 1, 0) == 1)
@@ -546,6 +691,7 @@ static int cldma_gpd_net_rx_collect(struct md_cd_queue *queue, int budget, int b
 		skb_put(skb, rgpd->data_buff_len);
 		skb_bytes = skb->len;
 		*rxbytes += skb_bytes;
+		cldma_tput_account(queue, skb_bytes);
 		ccci_chk_rx_seq_num(md, (struct ccci_header *)skb->data, queue->index);
 		/* upload skb */
 		if (using_napi) {
@@ -562,7 +708,7 @@ static int cldma_gpd_net_rx_collect(struct md_cd_queue *queue, int budget, int b
 		/* refill */
 		req = queue->rx_refill;
 		if (!req->skb) {
-			new_skb = ccci_alloc_skb(queue->tr_ring->pkt_size, 0, blocking);
+			new_skb = cldma_rx_alloc_skb(queue->tr_ring, 0, blocking);
 			if (likely(new_skb)) {
 				rgpd = (struct cldma_rgpd *)req->gpd;
 				req->data_buffer_ptr_saved =
@@ -691,6 +837,163 @@ static void cldma_rx_refill(struct work_struct *work)
 #endif
 }
 
+static unsigned int cldma_loop_backlog = 512;	/* looped packets waiting per Rx queue */
+
+/*
+ * Rx interrupt moderation
+ *
+ * A cycle runs from RX_DONE to the point the queue is drained and RX_DONE
+ * unmasked again.  While network Rx keeps up a packet rate above
+ * cldma_rx_mod_high, RX_DONE stays masked at the end of a cycle and the
+ * queue is polled again cldma_rx_mod_usec later, so a bulk download costs
+ * one interrupt instead of one per GPD.  Below cldma_rx_mod_low the
+ * interrupt is unmasked straight away and ping latency is unaffected.
+ */
+static unsigned int cldma_rx_mod_usec = 200;
+static unsigned int cldma_rx_mod_high = 4000;	/* packets per second */
+static unsigned int cldma_rx_mod_low = 1000;
+
+static void cldma_rx_schedule(struct ccci_modem *md, struct md_cd_queue *queue)
+{
+	if (md->md_state != EXCEPTION && queue->napi_port)
+		queue->napi_port->ops->md_state_notice(queue->napi_port, RX_IRQ);
+	else
+		queue_work(queue->worker, &queue->cldma_rx_work);
+}
+
+static enum hrtimer_restart cldma_rx_mod_timer_func(struct hrtimer *timer)
+{
+	struct md_cd_queue *queue = container_of(timer, struct md_cd_queue, rx_mod_timer);
+	struct ccci_modem *md = queue->modem;
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	unsigned long flags;
+	int active;
+
+	spin_lock_irqsave(&md_ctrl->cldma_timeout_lock, flags);
+	active = md_ctrl->rxq_active & (1 << queue->index);
+	spin_unlock_irqrestore(&md_ctrl->cldma_timeout_lock, flags);
+
+	/* stopped meanwhile, cldma_start() unmasks RX_DONE again */
+	if (active) {
+		queue->rx_mod_poll++;
+		cldma_rx_schedule(md, queue);
+	}
+	return HRTIMER_NORESTART;
+}
+
+/*
+ * End a cycle of @queue.  Called with cldma_timeout_lock held and the queue
+ * active, instead of unmasking RX_DONE; returns true if the interrupt was
+ * left masked and the moderation timer armed.
+ */
+static bool cldma_rx_mod_defer(struct md_cd_queue *queue)
+{
+	unsigned long long now = local_clock();
+	unsigned long long delta = now - queue->rx_mod_stamp;
+	unsigned int rate;
+
+	if (!IS_NET_QUE(queue->modem, queue->index) || !cldma_rx_mod_usec) {
+		queue->rx_mod_on = 0;
+		queue->rx_mod_cycle = 0;
+		return false;
+	}
+
+	rate = div64_u64((u64)queue->rx_mod_cycle * NSEC_PER_SEC, max_t(u64, delta, NSEC_PER_USEC));
+	queue->rx_mod_rate = (queue->rx_mod_rate * 3 + rate) / 4;
+	queue->rx_mod_pkts += queue->rx_mod_cycle;
+	queue->rx_mod_cycle = 0;
+	queue->rx_mod_stamp = now;
+
+	if (queue->rx_mod_on && queue->rx_mod_rate < cldma_rx_mod_low)
+		queue->rx_mod_on = 0;
+	else if (!queue->rx_mod_on && queue->rx_mod_rate >= cldma_rx_mod_high)
+		queue->rx_mod_on = 1;
+	if (!queue->rx_mod_on)
+		return false;
+
+	hrtimer_start(&queue->rx_mod_timer, ns_to_ktime((u64)cldma_rx_mod_usec * NSEC_PER_USEC),
+		      HRTIMER_MODE_REL);
+	return true;
+}
+
+static int cldma_rx_mod_show(struct seq_file *m, void *v)
+{
+	struct ccci_modem *md = m->private;
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	struct md_cd_queue *queue;
+	int i;
+
+	seq_printf(m, "usec=%u high=%u low=%u\n", cldma_rx_mod_usec, cldma_rx_mod_high, cldma_rx_mod_low);
+	seq_puts(m, "rxq  on  rate(pps)  irq        poll       pkts\n");
+	for (i = 0; i < QUEUE_LEN(md_ctrl->rxq); i++) {
+		queue = &md_ctrl->rxq[i];
+		if (!IS_NET_QUE(md, i))
+			continue;
+		seq_printf(m, "%-4d %-3d %-10u %-10lu %-10lu %lu\n", i, queue->rx_mod_on, queue->rx_mod_rate,
+			   queue->rx_mod_irq, queue->rx_mod_poll, queue->rx_mod_pkts);
+	}
+	return 0;
+}
+
+static int cldma_rx_mod_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, cldma_rx_mod_show, inode->i_private);
+}
+
+static const struct file_operations cldma_rx_mod_fops = {
+	.open = cldma_rx_mod_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int cldma_tput_show(struct seq_file *m, void *v)
+{
+	struct ccci_modem *md = m->private;
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+
+	seq_printf(m, "rx=%ukbps tx=%ukbps boost=%d on=%u off=%u\n", md_ctrl->tput_kbps[IN],
+		   md_ctrl->tput_kbps[OUT], md_ctrl->tput_boost, cldma_boost_on_kbps, cldma_boost_off_kbps);
+	return 0;
+}
+
+static int cldma_tput_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, cldma_tput_show, inode->i_private);
+}
+
+static const struct file_operations cldma_tput_fops = {
+	.open = cldma_tput_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static void cldma_rx_mod_debugfs_init(struct ccci_modem *md)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	struct dentry *dir;
+	char name[16];
+
+	snprintf(name, sizeof(name), "cldma_md%d", md->index + 1);
+	dir = debugfs_create_dir(name, NULL);
+	if (IS_ERR_OR_NULL(dir)) {
+		CCCI_ERR_MSG(md->index, TAG, "fail to create debugfs %s\n", name);
+		return;
+	}
+	debugfs_create_file("rx_mod", 0444, dir, md, &cldma_rx_mod_fops);
+	debugfs_create_u32("rx_mod_usec", 0644, dir, &cldma_rx_mod_usec);
+	debugfs_create_u32("rx_mod_high", 0644, dir, &cldma_rx_mod_high);
+	debugfs_create_u32("rx_mod_low", 0644, dir, &cldma_rx_mod_low);
+	debugfs_create_file("tput", 0444, dir, md, &cldma_tput_fops);
+	debugfs_create_u32("boost_on_kbps", 0644, dir, &cldma_boost_on_kbps);
+	debugfs_create_u32("boost_off_kbps", 0644, dir, &cldma_boost_off_kbps);
+	debugfs_create_u32("boost_cores", 0644, dir, &cldma_boost_cores);
+	debugfs_create_u32("loopback", 0644, dir, &md_ctrl->loopback);
+	debugfs_create_u32("loop_backlog", 0644, dir, &cldma_loop_backlog);
+	cldma_loopgen_debugfs_init(md, dir);
+}
+
 static void cldma_rx_done(struct work_struct *work)
 {
 	struct md_cd_queue *queue = container_of(work, struct md_cd_queue, cldma_rx_work);
@@ -742,7 +1045,10 @@ again:
 			goto again;
 		}
 		/* enable RX_DONE interrupt */
-		cldma_write32(md_ctrl->cldma_ap_ao_base, CLDMA_AP_L2RIMCR0, CLDMA_BM_ALL_QUEUE & (1 << queue->index));
+		queue->rx_mod_cycle += count;
+		if (!cldma_rx_mod_defer(queue))
+			cldma_write32(md_ctrl->cldma_ap_ao_base, CLDMA_AP_L2RIMCR0,
+				      CLDMA_BM_ALL_QUEUE & (1 << queue->index));
 	}
 	spin_unlock_irqrestore(&md_ctrl->cldma_timeout_lock, flags);
 	md_cd_lock_cldma_clock_src(0);
@@ -766,6 +1072,41 @@ again:
 #endif
 }
 
+/*
+ * Byte queue limits for network Tx.  A packet handed over by its net_device
+ * is accounted to BQL when its GPD is filled and completed here when the
+ * GPD is harvested, so the qdisc rather than the CLDMA ring holds the
+ * backlog and uplink queueing delay stays bounded.
+ */
+struct cldma_bql_batch {
+	struct netdev_queue *txq;
+	unsigned int pkts;
+	unsigned int bytes;
+};
+
+static void cldma_bql_flush(struct cldma_bql_batch *batch)
+{
+	if (batch->txq)
+		netdev_tx_completed_queue(batch->txq, batch->pkts, batch->bytes);
+	batch->txq = NULL;
+	batch->pkts = 0;
+	batch->bytes = 0;
+}
+
+static void cldma_bql_add(struct cldma_bql_batch *batch, struct sk_buff *skb, unsigned int bytes)
+{
+	struct netdev_queue *txq;
+
+	if (!bytes)
+		return;
+	txq = netdev_get_tx_queue(skb->dev, skb_get_queue_mapping(skb));
+	if (txq != batch->txq)
+		cldma_bql_flush(batch);
+	batch->txq = txq;
+	batch->pkts++;
+	batch->bytes += bytes;
+}
+
 /* this function may be called from both workqueue and ISR (timer) */
 static int cldma_gpd_bd_tx_collect(struct md_cd_queue *queue, int budget, int blocking, int *result)
 {
@@ -780,6 +1121,8 @@ static int cldma_gpd_bd_tx_collect(struct md_cd_queue *queue, int budget, int bl
 	int count = 0;
 	struct sk_buff *skb_free;
 	DATA_POLICY skb_free_p;
+	unsigned int bql_bytes;
+	struct cldma_bql_batch bql = { NULL, 0, 0 };
 
 	while (1) {
 		spin_lock_irqsave(&queue->ring_lock, flags);
@@ -806,8 +1149,10 @@ static int cldma_gpd_bd_tx_collect(struct md_cd_queue *queue, int budget, int bl
 		/* save skb reference */
 		skb_free = req->skb;
 		skb_free_p = req->policy;
+		bql_bytes = req->bql_bytes;
 		/* mark cldma_request as available */
 		req->skb = NULL;
+		req->bql_bytes = 0;
 		/* step forward */
 		queue->tr_done = cldma_ring_step_forward(queue->tr_ring, req);
 		if (likely(md->capability & MODEM_CAP_TXBUSY_STOP))
@@ -820,11 +1165,14 @@ static int cldma_gpd_bd_tx_collect(struct md_cd_queue *queue, int budget, int bl
 			     ccci_h->data[0], ccci_h->data[1], *(((u32 *) ccci_h) + 2), ccci_h->reserved, queue->index,
 			     tgpd->data_buff_len);
 		ccci_channel_update_packet_counter(md, ccci_h);
+		cldma_bql_add(&bql, skb_free, bql_bytes);
+		cldma_tput_account(queue, skb_free->len);
 		ccci_free_skb(skb_free, skb_free_p);
 #if TRAFFIC_MONITOR_INTERVAL
 		md_ctrl->tx_traffic_monitor[queue->index]++;
 #endif
 	}
+	cldma_bql_flush(&bql);
 	if (count)
 		wake_up_nr(&queue->req_wq, count);
 	return count;
@@ -844,6 +1192,8 @@ static int cldma_gpd_tx_collect(struct md_cd_queue *queue, int budget, int block
 	DATA_POLICY skb_free_p;
 	dma_addr_t dma_free;
 	unsigned int dma_len;
+	unsigned int bql_bytes;
+	struct cldma_bql_batch bql = { NULL, 0, 0 };
 
 	while (1) {
 		spin_lock_irqsave(&queue->ring_lock, flags);
@@ -870,8 +1220,10 @@ static int cldma_gpd_tx_collect(struct md_cd_queue *queue, int budget, int block
 		dma_len = tgpd->data_buff_len;
 		skb_free = req->skb;
 		skb_free_p = req->policy;
+		bql_bytes = req->bql_bytes;
 		/* mark cldma_request as available */
 		req->skb = NULL;
+		req->bql_bytes = 0;
 		/* step forward */
 		queue->tr_done = cldma_ring_step_forward(queue->tr_ring, req);
 		if (likely(md->capability & MODEM_CAP_TXBUSY_STOP))
@@ -895,11 +1247,14 @@ static int cldma_gpd_tx_collect(struct md_cd_queue *queue, int budget, int block
 			     ccci_h->data[0], ccci_h->data[1], *(((u32 *) ccci_h) + 2), ccci_h->reserved, queue->index,
 			     skb_free->len);
 		ccci_channel_update_packet_counter(md, ccci_h);
+		cldma_bql_add(&bql, skb_free, bql_bytes);
+		cldma_tput_account(queue, skb_free->len);
 		ccci_free_skb(skb_free, skb_free_p);
 #if TRAFFIC_MONITOR_INTERVAL
 		md_ctrl->tx_traffic_monitor[queue->index]++;
 #endif
 	}
+	cldma_bql_flush(&bql);
 	if (count)
 		wake_up_nr(&queue->req_wq, count);
 	return count;
@@ -935,7 +1290,7 @@ static void cldma_tx_done(struct work_struct *work)
 #endif
 
 	if (count) {
-		queue_delayed_work(queue->worker, &queue->cldma_tx_work, msecs_to_jiffies(10));
+		queue_delayed_work(queue->worker, &queue->cldma_tx_work, CLDMA_TX_DONE_DELAY(md, queue->index));
 	} else {
 #ifndef CLDMA_NO_TX_IRQ
 		unsigned long flags;
@@ -972,7 +1327,7 @@ static void cldma_rx_ring_init(struct ccci_modem *md, struct cldma_ring *ring)
 		for (i = 0; i < ring->length; i++) {
 			item = kzalloc(sizeof(struct cldma_request), GFP_KERNEL);
 			item->gpd = dma_pool_alloc(md_ctrl->gpd_dmapool, GFP_KERNEL, &item->gpd_addr);
-			item->skb = ccci_alloc_skb(ring->pkt_size, 1, 1);
+			item->skb = cldma_rx_alloc_skb(ring, 1, 1);
 			gpd = (struct cldma_rgpd *)item->gpd;
 			memset(gpd, 0, sizeof(struct cldma_rgpd));
 			item->data_buffer_ptr_saved = dma_map_single(&md->plat_dev->dev, item->skb->data,
@@ -1122,6 +1477,8 @@ static void cldma_rx_queue_init(struct md_cd_queue *queue)
 	}
 	ccci_skb_queue_init(&queue->skb_list, queue->tr_ring->pkt_size, SKB_RX_QUEUE_MAX_LEN, 0);
 	init_waitqueue_head(&queue->rx_wq);
+	hrtimer_init(&queue->rx_mod_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	queue->rx_mod_timer.function = cldma_rx_mod_timer_func;
 	if (IS_NET_QUE(md, queue->index))
 		queue->rx_thread = kthread_run(cldma_net_rx_push_thread, queue, "cldma_rxq%d", queue->index);
 	CCCI_DBG_MSG(md->index, TAG, "rxq%d work=%p\n", queue->index, &queue->cldma_rx_work);
@@ -1220,7 +1577,7 @@ static void cldma_irq_work_cb(struct ccci_modem *md)
 				cldma_write32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_L2TIMSR0,
 					      CLDMA_BM_ALL_QUEUE & (1 << i));
 				ret = queue_delayed_work(md_ctrl->txq[i].worker, &md_ctrl->txq[i].cldma_tx_work,
-							 msecs_to_jiffies(10));
+							 CLDMA_TX_DONE_DELAY(md, i));
 				CCCI_DBG_MSG(md->index, TAG, "qno%d queue_delayed_work=%d\n", i, ret);
 			}
 		}
@@ -1248,13 +1605,8 @@ static void cldma_irq_work_cb(struct ccci_modem *md)
 				cldma_write32(md_ctrl->cldma_ap_ao_base, CLDMA_AP_L2RIMSR0,
 					      CLDMA_BM_ALL_QUEUE & (1 << i));
 				cldma_read32(md_ctrl->cldma_ap_ao_base, CLDMA_AP_L2RIMSR0); /* dummy read */
-				if (md->md_state != EXCEPTION && md_ctrl->rxq[i].napi_port) {
-					md_ctrl->rxq[i].napi_port->ops->md_state_notice(md_ctrl->rxq[i].napi_port,
-							RX_IRQ);
-				} else {
-					ret = queue_work(md_ctrl->rxq[i].worker,
-									&md_ctrl->rxq[i].cldma_rx_work);
-				}
+				md_ctrl->rxq[i].rx_mod_irq++;
+				cldma_rx_schedule(md, &md_ctrl->rxq[i]);
 			}
 		}
 	}
@@ -1561,6 +1913,7 @@ static void md_cd_clear_all_queue(struct ccci_modem *md, DIRECTION dir)
 	struct cldma_request *req = NULL;
 	struct cldma_tgpd *tgpd;
 	unsigned long flags;
+	struct cldma_bql_batch bql = { NULL, 0, 0 };
 
 	if (dir == OUT) {
 		for (i = 0; i < QUEUE_LEN(md_ctrl->txq); i++) {
@@ -1580,12 +1933,17 @@ static void md_cd_clear_all_queue(struct ccci_modem *md, DIRECTION dir)
 					cldma_write32(&tgpd->data_buff_bd_ptr, 0, 0);
 				cldma_write16(&tgpd->data_buff_len, 0, 0);
 				if (req->skb) {
+					cldma_bql_add(&bql, req->skb, req->bql_bytes);
+					cldma_bql_flush(&bql);
 					ccci_free_skb(req->skb, req->policy);
 					req->skb = NULL;
+					req->bql_bytes = 0;
 				}
 			}
 			spin_unlock_irqrestore(&md_ctrl->txq[i].ring_lock, flags);
 		}
+		md_ctrl->txq_pending = 0;
+		md_ctrl->tx_batch = 0;
 	} else if (dir == IN) {
 		struct cldma_rgpd *rgpd;
 
@@ -1608,6 +1966,7 @@ static void md_cd_clear_all_queue(struct ccci_modem *md, DIRECTION dir)
 				}
 			}
 			spin_unlock_irqrestore(&md_ctrl->rxq[i].ring_lock, flags);
+			skb_queue_purge(&md_ctrl->rxq[i].loop_list);
 			list_for_each_entry(req, &md_ctrl->rxq[i].tr_ring->gpd_ring, entry) {
 				rgpd = (struct cldma_rgpd *)req->gpd;
 				if (req->skb == NULL) {
@@ -1618,7 +1977,7 @@ static void md_cd_clear_all_queue(struct ccci_modem *md, DIRECTION dir)
 					/*if ((1 << queue->index) & NET_TX_QUEUE_MASK)
 						req->skb = ccci_alloc_skb(queue->tr_ring->pkt_size, 0, 1);
 					else */
-					req->skb = ccci_alloc_skb(queue->tr_ring->pkt_size, 1, 1);
+					req->skb = cldma_rx_alloc_skb(queue->tr_ring, 1, 1);
 					req->data_buffer_ptr_saved =
 						dma_map_single(&md->plat_dev->dev, req->skb->data,
 								skb_data_size(req->skb), DMA_FROM_DEVICE);
@@ -2417,6 +2776,7 @@ static int md_cd_stop(struct ccci_modem *md, unsigned int timeout)
 	/* flush work before new start */
 	flush_work(&md_ctrl->ccif_work);
 	flush_work(&md_ctrl->wdt_work);
+	cldma_tput_stop(md);
 	del_timer(&md->ex_monitor);
 	del_timer(&md->ex_monitor2);
 	md_cd_check_emi_state(md, 1);	/* Check EMI before */
@@ -2602,6 +2962,88 @@ static int cldma_gpd_handle_tx_request(struct md_cd_queue *queue, struct cldma_r
 	return 0;
 }
 
+/*
+ * AP side loopback, for measuring the data path without a radio link: with
+ * loopback set in /sys/kernel/debug/cldma_mdN/, network Tx packets are not
+ * given to CLDMA but turned around onto the Rx queue of their port, as if
+ * the modem had echoed them, and go up through NAPI poll or the push
+ * thread, port_net and ccmni like any downlink packet.  The modem must
+ * still be up for the ports to be.  cldma_loopgen.c drives traffic over it.
+ */
+static void cldma_loopback_xmit(struct ccci_modem *md, struct md_cd_queue *txq, struct sk_buff *skb)
+{
+	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
+	struct ccci_header *ccci_h;
+	struct ccci_port *port;
+	struct md_cd_queue *rxq;
+	struct sk_buff *nskb;
+	unsigned long flags;
+	int ch, qno;
+
+	ch = ((struct ccci_header *)skb->data)->channel;
+	if (ch == CCCI_CCMNI1_DL_ACK)
+		ch = CCCI_CCMNI1_TX;
+	else if (ch == CCCI_CCMNI2_DL_ACK)
+		ch = CCCI_CCMNI2_TX;
+	else if (ch == CCCI_CCMNI3_DL_ACK)
+		ch = CCCI_CCMNI3_TX;
+	port = md->ops->get_port_by_channel(md, ch);
+	qno = port ? PORT_RXQ_INDEX(port) : -1;
+	if (unlikely(qno < 0 || qno >= QUEUE_LEN(md_ctrl->rxq) || !IS_NET_QUE(md, qno)))
+		goto drop;
+	rxq = &md_ctrl->rxq[qno];
+
+	/* the Rx path writes in front of the IP header, TCP keeps clones */
+	if (skb_cloned(skb)) {
+		nskb = skb_copy(skb, GFP_ATOMIC);
+		dev_kfree_skb_any(skb);
+		skb = nskb;
+		if (unlikely(!skb))
+			goto count;
+	}
+	skb_scrub_packet(skb, true);
+	ccci_h = (struct ccci_header *)skb->data;
+	ccci_h->channel = port->rx_ch;
+
+	if (rxq->napi_port) {
+		if (skb_queue_len(&rxq->loop_list) >= cldma_loop_backlog)
+			goto drop;
+		skb_queue_tail(&rxq->loop_list, skb);
+		cldma_rx_schedule(md, rxq);
+	} else {
+		if (skb_queue_len(&rxq->skb_list.skb_list) >=
+		    min_t(unsigned int, cldma_loop_backlog, rxq->skb_list.max_len))
+			goto drop;
+		ccci_skb_enqueue(&rxq->skb_list, skb);
+		wake_up_all(&rxq->rx_wq);
+	}
+	spin_lock_irqsave(&txq->ring_lock, flags);
+	txq->loop_pkts++;
+	spin_unlock_irqrestore(&txq->ring_lock, flags);
+	return;
+
+ drop:
+	dev_kfree_skb_any(skb);
+ count:
+	spin_lock_irqsave(&txq->ring_lock, flags);
+	txq->loop_drops++;
+	spin_unlock_irqrestore(&txq->ring_lock, flags);
+}
+
+/* from NAPI poll, ahead of the packets in the ring */
+static int cldma_loopback_rx(struct md_cd_queue *queue, int budget)
+{
+	struct sk_buff *skb;
+	int count = 0;
+
+	while (count < budget && (skb = skb_dequeue(&queue->loop_list)) != NULL) {
+		ccci_port_recv_request(queue->modem, NULL, skb);
+		count++;
+	}
+	queue->loop_pkts += count;
+	return count;
+}
+
 static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct ccci_request *req, struct sk_buff *skb)
 {
 	struct md_cd_ctrl *md_ctrl = (struct md_cd_ctrl *)md->private_data;
@@ -2657,6 +3099,11 @@ static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct c
 	queue = &md_ctrl->txq[qno];
 	tx_bytes = skb->len;
 
+	if (unlikely(md_ctrl->loopback) && !req && IS_NET_QUE(md, qno)) {
+		cldma_loopback_xmit(md, queue, skb);
+		goto __EXIT_FUN;
+	}
+
  retry:
 	spin_lock_irqsave(&queue->ring_lock, flags);
 		/* we use irqsave as network require a lock in softirq, cause a potential deadlock */
@@ -2668,6 +3115,10 @@ static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct c
 		wmb();
 		queue->budget--;
 		queue->tr_ring->handle_tx_request(queue, tx_req, skb, policy, ioc_override);
+		if (!req && skb->dev) {
+			tx_req->bql_bytes = tx_bytes;
+			netdev_tx_sent_queue(netdev_get_tx_queue(skb->dev, skb_get_queue_mapping(skb)), tx_bytes);
+		}
 		/* step forward */
 		queue->tx_xmit = cldma_ring_step_forward(queue->tr_ring, tx_req);
 		spin_unlock_irqrestore(&queue->ring_lock, flags);
@@ -2683,7 +3134,12 @@ static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct c
 		md_cd_lock_cldma_clock_src(1);
 			/* put it outside of spin_lock_irqsave to avoid disabling IRQ too long */
 		spin_lock_irqsave(&md_ctrl->cldma_timeout_lock, flags);
-		if (md_ctrl->txq_active & (1 << qno)) {
+		if ((md_ctrl->txq_active & (1 << qno)) && !req && skb->xmit_more &&
+		    md_ctrl->tx_batch < CLDMA_TX_BATCH_MAX) {
+			/* the stack has more packets for us, ring the doorbell once for all of them */
+			md_ctrl->txq_pending |= (1 << qno);
+			md_ctrl->tx_batch++;
+		} else if (md_ctrl->txq_active & (1 << qno)) {
 #ifdef ENABLE_CLDMA_TIMER
 			if (IS_NET_QUE(md, qno)) {
 				queue->timeout_start = local_clock();
@@ -2697,9 +3153,9 @@ static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct c
 #ifdef NO_START_ON_SUSPEND_RESUME
 			if (md_ctrl->txq_started) {
 #endif
-				/* resume Tx queue */
+				/* resume Tx queue, along with those whose doorbell was deferred */
 				cldma_write32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_UL_RESUME_CMD,
-				      CLDMA_BM_ALL_QUEUE & (1 << qno));
+				      CLDMA_BM_ALL_QUEUE & (md_ctrl->txq_active & (md_ctrl->txq_pending | (1 << qno))));
 				cldma_read32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_UL_RESUME_CMD);
 					/* dummy read to create a non-buffable write */
 #ifdef NO_START_ON_SUSPEND_RESUME
@@ -2710,6 +3166,8 @@ static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct c
 			}
 #endif
 
+			md_ctrl->txq_pending = 0;
+			md_ctrl->tx_batch = 0;
 #ifndef ENABLE_CLDMA_AP_SIDE
 			md_cd_ccif_send(md, AP_MD_PEER_WAKEUP);
 #endif
@@ -2732,6 +3190,16 @@ static int md_cd_send_request(struct ccci_modem *md, unsigned char qno, struct c
 		spin_unlock_irqrestore(&queue->ring_lock, flags);
 		/* check CLDMA status */
 		md_cd_lock_cldma_clock_src(1);
+		/* the stack stops sending on TX busy, do not leave deferred GPDs behind */
+		spin_lock_irqsave(&md_ctrl->cldma_timeout_lock, flags);
+		if (md_ctrl->txq_pending & md_ctrl->txq_active) {
+			cldma_write32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_UL_RESUME_CMD,
+				      CLDMA_BM_ALL_QUEUE & (md_ctrl->txq_pending & md_ctrl->txq_active));
+			cldma_read32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_UL_RESUME_CMD);	/* dummy read */
+		}
+		md_ctrl->txq_pending = 0;
+		md_ctrl->tx_batch = 0;
+		spin_unlock_irqrestore(&md_ctrl->cldma_timeout_lock, flags);
 		if (cldma_read32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_UL_STATUS) & (1 << qno)) {
 			CCCI_DBG_MSG(md->index, TAG, "ch=%d qno=%d free slot 0, CLDMA_AP_UL_STATUS=0x%x\n",
 				ccci_h.channel, qno, cldma_read32(md_ctrl->cldma_ap_pdn_base,
@@ -2816,7 +3284,12 @@ static int md_cd_napi_poll(struct ccci_modem *md, unsigned char qno, struct napi
 		return -CCCI_ERR_INVALID_QUEUE_INDEX;
 
 	queue = &md_ctrl->rxq[qno];
-	ret = queue->tr_ring->handle_rx_done(queue, weight, 0, &result, &rx_bytes);
+	ret = cldma_loopback_rx(queue, weight);
+	if (likely(ret < weight))
+		ret += queue->tr_ring->handle_rx_done(queue, weight - ret, 0, &result, &rx_bytes);
+	else
+		result = REACH_BUDGET;
+	queue->rx_mod_cycle += ret;
 	if (likely(weight < queue->budget))
 		all_clr = ret == 0 ? 1 : 0;
 	else
@@ -2832,8 +3305,14 @@ static int md_cd_napi_poll(struct ccci_modem *md, unsigned char qno, struct napi
 		cldma_write32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_L2RISAR0, (1 << queue->index));
 		all_clr = 0;
 	}
-	if (all_clr)
+	if (!skb_queue_empty(&queue->loop_list))
+		all_clr = 0;
+	if (all_clr) {
 		napi_complete(napi);
+		/* a loopback packet queued while we were still scheduled */
+		if (unlikely(!skb_queue_empty(&queue->loop_list)))
+			napi_schedule(napi);
+	}
 
 	spin_lock_irqsave(&md_ctrl->cldma_timeout_lock, flags);
 	if (md_ctrl->rxq_active & (1 << qno)) {
@@ -2841,7 +3320,7 @@ static int md_cd_napi_poll(struct ccci_modem *md, unsigned char qno, struct napi
 		cldma_write32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_SO_RESUME_CMD, CLDMA_BM_ALL_QUEUE & (1 << qno));
 		cldma_read32(md_ctrl->cldma_ap_pdn_base, CLDMA_AP_SO_RESUME_CMD);	/* dummy read */
 		/* enable RX_DONE interrupt */
-		if (all_clr)
+		if (all_clr && !cldma_rx_mod_defer(queue))
 			cldma_write32(md_ctrl->cldma_ap_ao_base, CLDMA_AP_L2RIMCR0, CLDMA_BM_ALL_QUEUE & (1 << qno));
 	}
 	spin_unlock_irqrestore(&md_ctrl->cldma_timeout_lock, flags);
@@ -3680,6 +4159,7 @@ static int ccci_modem_probe(struct platform_device *plat_dev)
 		md_ctrl->net_rx_ring[i].length = net_rx_queue_buffer_number[net_rx_ring2queue[i]];
 		md_ctrl->net_rx_ring[i].pkt_size = net_rx_queue_buffer_size[net_rx_ring2queue[i]];
 		md_ctrl->net_rx_ring[i].type = RING_GPD;
+		md_ctrl->net_rx_ring[i].frag_rx = 1;
 		md_ctrl->net_rx_ring[i].handle_rx_done = &cldma_gpd_net_rx_collect;
 		md_ctrl->net_rx_ring[i].handle_rx_refill = &cldma_gpd_rx_refill;
 		cldma_rx_ring_init(md, &md_ctrl->net_rx_ring[i]);
@@ -3719,6 +4199,8 @@ static int ccci_modem_probe(struct platform_device *plat_dev)
 	atomic_set(&md_ctrl->wdt_enabled, 0);
 	atomic_set(&md_ctrl->ccif_irq_enabled, 0);
 	INIT_WORK(&md_ctrl->wdt_work, md_cd_wdt_work);
+	INIT_DEFERRABLE_WORK(&md_ctrl->tput_work, cldma_tput_work);
+	atomic_set(&md_ctrl->tput_on, 0);
 #if TRAFFIC_MONITOR_INTERVAL
 	init_timer(&md_ctrl->traffic_monitor);
 	md_ctrl->traffic_monitor.function = md_cd_traffic_monitor_func;
@@ -3733,6 +4215,7 @@ static int ccci_modem_probe(struct platform_device *plat_dev)
 #endif
 	/* add sysfs entries */
 	md_cd_sysfs_init(md);
+	cldma_rx_mod_debugfs_init(md);
 	/* hook up to device */
 	plat_dev->dev.platform_data = md;
 #ifndef FEATURE_FPGA_PORTING
@@ -50,6 +50,7 @@ struct cldma_request {
 	/* inherit from struct ccci_request */
 	DATA_POLICY policy;
 	unsigned char ioc_override;	/* bit7: override or not; bit0: IOC setting */
+	unsigned int bql_bytes;	/* bytes reported to BQL, 0 if not a network packet */
 };
 
 typedef enum {
@@ -71,6 +72,7 @@ struct cldma_ring {
 	int length;		/* number of struct cldma_request */
 	int pkt_size;		/* size of each packet in ring */
 	CLDMA_RING_TYPE type;
+	char frag_rx;		/* Rx buffers are page fragments, see cldma_rx_alloc_skb() */
 
 	int (*handle_tx_request)(struct md_cd_queue *queue, struct cldma_request *req,
 				  struct sk_buff *skb, DATA_POLICY policy, unsigned int ioc_override);
@@ -150,6 +152,21 @@ struct md_cd_queue {
 	u16 debug_id;
 	DIRECTION dir;
 	unsigned int busy_count;
+
+	/* Rx interrupt moderation, only for network Rx */
+	struct hrtimer rx_mod_timer;
+	unsigned long long rx_mod_stamp;	/* end of the previous cycle */
+	unsigned int rx_mod_cycle;	/* packets collected in this cycle */
+	unsigned int rx_mod_rate;	/* packets per second, averaged over cycles */
+	char rx_mod_on;
+	unsigned long rx_mod_irq;	/* cycles started by RX_DONE */
+	unsigned long rx_mod_poll;	/* cycles started by the moderation timer */
+	unsigned long rx_mod_pkts;
+	unsigned long long tput_bytes;	/* bytes moved, sampled by cldma_tput_work() */
+	/* AP side loopback, see cldma_loopback_xmit() */
+	struct sk_buff_head loop_list;	/* only for network Rx with NAPI */
+	unsigned long loop_pkts;	/* Tx: turned around, Rx: delivered from loop_list */
+	unsigned long loop_drops;	/* only for Tx */
 };
 
 #define QUEUE_LEN(a) (sizeof(a)/sizeof(struct md_cd_queue))
@@ -160,6 +177,16 @@ struct md_cd_ctrl {
 	struct md_cd_queue rxq[CLDMA_RXQ_NUM];
 	unsigned short txq_active;
 	unsigned short rxq_active;
+	unsigned short txq_pending;	/* Tx queues with GPDs waiting for the doorbell */
+	unsigned short tx_batch;	/* packets behind the pending doorbell */
+	/* throughput driven boost, see cldma_tput_work() */
+	struct delayed_work tput_work;
+	atomic_t tput_on;		/* sampling, traffic seen recently */
+	unsigned long long tput_last[2];	/* bytes at the previous sample, per DIRECTION */
+	unsigned long long tput_stamp;
+	unsigned int tput_kbps[2];	/* smoothed, per DIRECTION */
+	char tput_boost;
+	u32 loopback;			/* network Tx goes back to Rx, not to the modem */
 #ifdef NO_START_ON_SUSPEND_RESUME
 	unsigned short txq_started;
 #endif
@@ -313,6 +340,7 @@ static inline void md_cd_queue_struct_init(struct md_cd_queue *queue, struct ccc
 	spin_lock_init(&queue->ring_lock);
 	queue->debug_id = 0;
 	queue->busy_count = 0;
+	skb_queue_head_init(&queue->loop_list);
 }
 #ifndef CONFIG_MTK_ECCCI_C2K
 #ifdef CONFIG_MTK_SVLTE_SUPPORT
@@ -332,6 +360,9 @@ extern int gf_port_list_reg[GF_PORT_LIST_MAX];
 extern int gf_port_list_unreg[GF_PORT_LIST_MAX];
 extern int ccci_ipc_set_garbage_filter(struct ccci_modem *md, int reg);
 
+/* cldma_loopgen.c */
+extern void cldma_loopgen_debugfs_init(struct ccci_modem *md, struct dentry *dir);
+
 #ifdef TEST_MESSAGE_FOR_BRINGUP
 extern int ccci_sysmsg_echo_test(int, int);
 extern int ccci_sysmsg_echo_test_l1core(int, int);
@@ -6,6 +6,10 @@
 #include <linux/module.h>
 #include <linux/poll.h>
 #include <linux/uidgid.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+#include <linux/slab.h>
+#include <linux/log2.h>
 #include <mt-plat/mt_ccci_common.h>
 #include <mt-plat/mt_boot_common.h>
 #ifdef CONFIG_COMPAT
@@ -128,6 +132,7 @@ static int dev_char_close(struct inode *inode, struct file *file)
 	if (port->rx_ch == CCCI_MD_LOG_RX)
 		del_timer(&port->modem->md_status_poller);
 #endif
+	dev_char_ring_free(port);
 	return 0;
 }
 
@@ -156,9 +161,8 @@ static void port_ch_dump(int md_id, char *str, void *msg_buf, int len)
 #endif
 }
 
-static ssize_t dev_char_read(struct file *file, char *buf, size_t count, loff_t *ppos)
+static ssize_t dev_char_read_one(struct ccci_port *port, char __user *buf, size_t count, int blocking)
 {
-	struct ccci_port *port = file->private_data;
 	struct ccci_request *req = NULL;
 	struct ccci_header *ccci_h = NULL;
 	int ret = 0, read_len = 0, full_req_done = 0;
@@ -166,7 +170,7 @@ static ssize_t dev_char_read(struct file *file, char *buf, size_t count, loff_t
 
 	/* 1. get incoming request */
 	if (list_empty(&port->rx_req_list)) {
-		if (!(file->f_flags & O_NONBLOCK)) {
+		if (blocking) {
 			ret = wait_event_interruptible(port->rx_wq, !list_empty(&port->rx_req_list));
 			if (ret == -ERESTARTSYS) {
 				ret = -EINTR;
@@ -245,6 +249,11 @@ static ssize_t dev_char_read(struct file *file, char *buf, size_t count, loff_t
 	return ret ? ret : read_len;
 }
 
+static ssize_t dev_char_read(struct file *file, char *buf, size_t count, loff_t *ppos)
+{
+	return dev_char_read_one(file->private_data, buf, count, !(file->f_flags & O_NONBLOCK));
+}
+
 #ifdef CONFIG_MTK_ECCCI_C2K
 
 int ccci_c2k_rawbulk_intercept(int ch_id, unsigned int interception)
@@ -385,10 +394,9 @@ push_err_out:
 
 #endif
 
-static ssize_t dev_char_write(struct file *file, const char __user *buf, size_t count, loff_t *ppos)
+static ssize_t dev_char_write_one(struct ccci_port *port, const char __user *buf, size_t count,
+	unsigned char blocking)
 {
-	struct ccci_port *port = file->private_data;
-	unsigned char blocking = !(file->f_flags & O_NONBLOCK);
 	struct ccci_request *req = NULL;
 	struct ccci_header *ccci_h = NULL;
 	size_t actual_count = 0;
@@ -500,6 +508,211 @@ static ssize_t dev_char_write(struct file *file, const char __user *buf, size_t
 	return -EBUSY;
 }
 
+static ssize_t dev_char_write(struct file *file, const char __user *buf, size_t count, loff_t *ppos)
+{
+	return dev_char_write_one(file->private_data, buf, count, !(file->f_flags & O_NONBLOCK));
+}
+
+/*
+ * One message per vector, so a daemon streaming a port does not pay a
+ * syscall per message. Stops at the first error; that error is only
+ * returned when no message was moved.
+ */
+static long dev_char_batch(struct ccci_port *port, struct file *file, unsigned int cmd, unsigned long arg)
+{
+	struct ccci_msg_batch batch;
+	struct ccci_msg_vec vec;
+	struct ccci_msg_vec __user *uvec;
+	int blocking = !(file->f_flags & O_NONBLOCK);
+	unsigned int i;
+	ssize_t ret = 0;
+
+	if (copy_from_user(&batch, (void __user *)arg, sizeof(batch)))
+		return -EFAULT;
+	if (batch.flags || batch.count == 0 || batch.count > CCCI_MSG_BATCH_MAX)
+		return -EINVAL;
+	uvec = (struct ccci_msg_vec __user *)(unsigned long)batch.vec;
+
+	for (i = 0; i < batch.count; i++) {
+		if (copy_from_user(&vec, &uvec[i], sizeof(vec))) {
+			ret = -EFAULT;
+			break;
+		}
+		if (cmd == CCCI_IOC_READ_BATCH) {
+			/* wait for the first message only, then take what is queued */
+			if (i && list_empty(&port->rx_req_list))
+				break;
+			ret = dev_char_read_one(port, (char __user *)(unsigned long)vec.buf, vec.len,
+						blocking && i == 0);
+		} else {
+			ret = dev_char_write_one(port, (const char __user *)(unsigned long)vec.buf, vec.len,
+						 blocking);
+		}
+		if (ret < 0)
+			break;
+		if (put_user((__u32)ret, &uvec[i].len)) {
+			ret = -EFAULT;
+			break;
+		}
+	}
+
+	return i ? i : ret;
+}
+
+/*
+ * Modem log ring: received modem log messages are copied into a vmalloc-ed
+ * ring which mdlogger maps, instead of queuing a request per message for
+ * read(). port->rx_ring is only changed under rx_req_lock.
+ */
+#define LOG_RING_SIZE_MIN	(64 * 1024)
+#define LOG_RING_SIZE_MAX	(4 * 1024 * 1024)
+
+struct ccci_log_ring {
+	struct ccci_log_ring_header *hdr;
+	unsigned char *data;
+	unsigned int size;
+	unsigned int head;	/* kernel copies, the mapping is only looked at */
+	unsigned int tail;
+};
+
+static unsigned int log_ring_free(struct ccci_log_ring *ring)
+{
+	return ring->size - (ring->head - ring->tail);
+}
+
+/* called with rx_req_lock held, returns 0 if the message is in the ring */
+static int log_ring_put(struct ccci_log_ring *ring, struct sk_buff *skb)
+{
+	unsigned int len = skb->len > sizeof(struct ccci_header) ? skb->len - sizeof(struct ccci_header) : 0;
+	unsigned int rec = sizeof(__u32) + ALIGN(len, 4);
+	unsigned int off = ring->head & (ring->size - 1);
+	unsigned int pad = 0;
+
+	/* records are contiguous, the tail of the area is skipped if too short */
+	if (off + rec > ring->size)
+		pad = ring->size - off;
+	if (rec + pad > log_ring_free(ring))
+		return -ENOSPC;
+	if (pad) {
+		*(__u32 *)(ring->data + off) = CCCI_LOG_RING_PAD;
+		ring->head += pad;
+		off = 0;
+	}
+	*(__u32 *)(ring->data + off) = len;
+	skb_copy_bits(skb, sizeof(struct ccci_header), ring->data + off + sizeof(__u32), len);
+	ring->head += rec;
+	smp_wmb();
+	ACCESS_ONCE(ring->hdr->head) = ring->head;
+	return 0;
+}
+
+static int dev_char_ring_setup(struct ccci_port *port, unsigned long arg)
+{
+	struct ccci_log_ring *ring;
+	struct ccci_request *req, *reqn;
+	unsigned int size;
+	unsigned long flags;
+
+	if (port->rx_ch != CCCI_MD_LOG_RX)
+		return -EINVAL;
+	if (get_user(size, (unsigned int __user *)arg))
+		return -EFAULT;
+	size = roundup_pow_of_two(clamp_t(unsigned int, size, LOG_RING_SIZE_MIN, LOG_RING_SIZE_MAX));
+
+	ring = kzalloc(sizeof(*ring), GFP_KERNEL);
+	if (!ring)
+		return -ENOMEM;
+	ring->hdr = vmalloc_user(PAGE_SIZE + size);
+	if (!ring->hdr) {
+		kfree(ring);
+		return -ENOMEM;
+	}
+	ring->data = (unsigned char *)ring->hdr + PAGE_SIZE;
+	ring->size = size;
+	ring->hdr->magic = CCCI_LOG_RING_MAGIC;
+	ring->hdr->data_offset = PAGE_SIZE;
+	ring->hdr->data_size = size;
+
+	spin_lock_irqsave(&port->rx_req_lock, flags);
+	if (port->rx_ring) {
+		spin_unlock_irqrestore(&port->rx_req_lock, flags);
+		vfree(ring->hdr);
+		kfree(ring);
+		return -EBUSY;
+	}
+	/* keep the order: whatever is queued for read() goes in first */
+	list_for_each_entry_safe(req, reqn, &port->rx_req_list, entry) {
+		if (req->state == PARTIAL_READ || log_ring_put(ring, req->skb))
+			break;
+		list_del(&req->entry);
+		port->rx_length--;
+		req->policy = RECYCLE;
+		ccci_free_req(req);
+	}
+	port->rx_ring = ring;
+	spin_unlock_irqrestore(&port->rx_req_lock, flags);
+	CCCI_INF_MSG(port->modem->index, CHAR, "port %s log ring %u bytes, by %s\n", port->name, size,
+		     current->comm);
+	return 0;
+}
+
+static int dev_char_ring_consume(struct ccci_port *port, unsigned long arg)
+{
+	struct ccci_log_ring *ring;
+	unsigned int tail;
+	unsigned long flags;
+	int ret = 0;
+
+	if (get_user(tail, (unsigned int __user *)arg))
+		return -EFAULT;
+
+	spin_lock_irqsave(&port->rx_req_lock, flags);
+	ring = port->rx_ring;
+	if (!ring) {
+		ret = -EINVAL;
+	} else if (tail - ring->tail > ring->head - ring->tail) {
+		ret = -EINVAL;
+	} else {
+		ring->tail = tail;
+		ring->hdr->tail = tail;
+		/* messages were left in the queue while we were full */
+		if (port->flags & PORT_F_RX_FULLED)
+			ccci_port_ask_more_request(port);
+	}
+	spin_unlock_irqrestore(&port->rx_req_lock, flags);
+	return ret;
+}
+
+static void dev_char_ring_free(struct ccci_port *port)
+{
+	struct ccci_log_ring *ring;
+	unsigned long flags;
+
+	spin_lock_irqsave(&port->rx_req_lock, flags);
+	ring = port->rx_ring;
+	port->rx_ring = NULL;
+	spin_unlock_irqrestore(&port->rx_req_lock, flags);
+	if (ring) {
+		vfree(ring->hdr);
+		kfree(ring);
+	}
+}
+
+static int dev_char_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct ccci_port *port = file->private_data;
+	struct ccci_log_ring *ring = port->rx_ring;
+
+	if (!ring)
+		return -ENODEV;
+	/* the ring is handed back through CCCI_IOC_LOG_RING_CONSUME, never written */
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	return remap_vmalloc_range(vma, ring->hdr, vma->vm_pgoff);
+}
+
 static int last_md_status[5];
 static int md_status_show_count[5];
 
@@ -904,6 +1117,16 @@ static long dev_char_ioctl(struct file *file, unsigned int cmd, unsigned long ar
 			CCCI_INF_MSG(md->index, CHAR, "send signal %d to rild %d ret=%ld\n", sig, pid, ret);
 		}
 		break;
+	case CCCI_IOC_READ_BATCH:
+	case CCCI_IOC_WRITE_BATCH:
+		ret = dev_char_batch(port, file, cmd, arg);
+		break;
+	case CCCI_IOC_LOG_RING_SETUP:
+		ret = dev_char_ring_setup(port, arg);
+		break;
+	case CCCI_IOC_LOG_RING_CONSUME:
+		ret = dev_char_ring_consume(port, arg);
+		break;
 	case CCCI_IOC_RESET_MD1_MD3_PCCIF:
 #ifdef CONFIG_MTK_ECCCI_C2K
 		CCCI_INF_MSG(md->index, CHAR, "reset md1/md3 pccif ioctl called by %s\n", current->comm);
@@ -959,6 +1182,12 @@ unsigned int dev_char_poll(struct file *fp, struct poll_table_struct *poll)
 		/* TODO: lack of poll wait for Tx */
 		if (!list_empty(&port->rx_req_list))
 			mask |= POLLIN | POLLRDNORM;
+		if (port->rx_ring) {
+			struct ccci_log_ring *ring = port->rx_ring;
+
+			if (ACCESS_ONCE(ring->head) != ACCESS_ONCE(ring->tail))
+				mask |= POLLIN | POLLRDNORM;
+		}
 		if (port->modem->ops->write_room(port->modem, PORT_TXQ_INDEX(port)) > 0)
 			mask |= POLLOUT | POLLWRNORM;
 		if (port->rx_ch == CCCI_UART1_RX &&
@@ -983,6 +1212,7 @@ static const struct file_operations char_dev_fops = {
 	.compat_ioctl = &dev_char_compat_ioctl,
 #endif
 	.poll = &dev_char_poll,
+	.mmap = &dev_char_mmap,
 };
 
 static int port_char_init(struct ccci_port *port)
@@ -1076,7 +1306,22 @@ static int port_char_recv_req(struct ccci_port *port, struct ccci_request *req)
 
 	CCCI_DBG_MSG(port->modem->index, CHAR, "recv on %s, len=%d\n", port->name, port->rx_length);
 	spin_lock_irqsave(&port->rx_req_lock, flags);
-	if (port->rx_length < port->rx_length_th) {
+	if (port->rx_ring) {
+		struct ccci_log_ring *ring = port->rx_ring;
+
+		if (log_ring_put(ring, req->skb) == 0) {
+			port->flags &= ~PORT_F_RX_FULLED;
+			spin_unlock_irqrestore(&port->rx_req_lock, flags);
+			list_del(&req->entry);
+			req->policy = RECYCLE;
+			ccci_free_req(req);
+			wake_lock_timeout(&port->rx_wakelock, HZ);
+			wake_up_all(&port->rx_wq);
+			return 0;
+		}
+		if (port->flags & PORT_F_ALLOW_DROP)
+			ring->hdr->dropped++;
+	} else if (port->rx_length < port->rx_length_th) {
 		port->flags &= ~PORT_F_RX_FULLED;
 		port->rx_length++;
 		list_del(&req->entry);	/* dequeue from queue's list */
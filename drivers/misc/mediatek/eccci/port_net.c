@@ -22,6 +22,7 @@
 
 #define NET_DAT_TXQ_INDEX(p) ((p)->modem->md_state == EXCEPTION?(p)->txq_exp_index:(p)->txq_index)
 #define NET_ACK_TXQ_INDEX(p) ((p)->modem->md_state == EXCEPTION?(p)->txq_exp_index:((p)->txq_exp_index&0x0F))
+#define NET_HAS_ACK_TXQ(p) (((p)->txq_exp_index & 0x0F) != 0x0F)
 
 #ifdef CCMNI_U
 int ccci_get_ccmni_channel(int md_id, int ccmni_idx, struct ccmni_ch *channel)
@@ -134,6 +135,9 @@ int ccmni_send_pkt(int md_id, int tx_ch, void *data)
 	/* } */
 	if (tx_ch == CCCI_CCMNI1_DL_ACK || tx_ch == CCCI_CCMNI2_DL_ACK || tx_ch == CCCI_CCMNI3_DL_ACK)
 		tx_queue = NET_ACK_TXQ_INDEX(port);
+	else if (skb_get_queue_mapping(skb) == CCMNI_TXQ_FAST && NET_HAS_ACK_TXQ(port))
+		/* latency sensitive data, see is_urgent_skb@ccmni.c: own hardware queue, data channel */
+		tx_queue = NET_ACK_TXQ_INDEX(port);
 	else
 		tx_queue = NET_DAT_TXQ_INDEX(port);
 
@@ -179,7 +183,18 @@ int ccmni_send_pkt(int md_id, int tx_ch, void *data)
 
 int ccmni_napi_poll(int md_id, int rx_ch, struct napi_struct *napi, int weight)
 {
-	return 0;
+	struct ccci_modem *md = ccci_get_modem_by_id(md_id);
+	struct ccci_port *port;
+
+	port = md ? md->ops->get_port_by_channel(md, rx_ch) : NULL;
+	if (unlikely(port == NULL)) {
+		CCCI_ERR_MSG(md_id, NET, "NAPI poll on invalid rx_ch %d\n", rx_ch);
+		napi_complete(napi);
+		return 0;
+	}
+
+	/* packets reach ccmni_rx_callback() from here, GRO is flushed on completion */
+	return md->ops->napi_poll(md, PORT_RXQ_INDEX(port), napi, weight);
 }
 
 struct ccmni_ccci_ops eccci_ccmni_ops = {
@@ -570,6 +585,7 @@ static int port_net_recv_skb(struct ccci_port *port, struct sk_buff *skb)
 #ifdef PORT_NET_TRACE
 	rx_cb_time = sched_clock();
 #endif
+	skb_record_rx_queue(skb, PORT_RXQ_INDEX(port));
 	ccmni_ops.rx_callback(port->modem->index, ccci_h->channel, skb, NULL);
 #ifdef PORT_NET_TRACE
 	rx_cb_time = sched_clock() - rx_cb_time;
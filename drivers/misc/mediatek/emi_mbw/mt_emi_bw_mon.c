@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2015 MediaTek Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * EMI bandwidth sampler.
+ *
+ * mon_kernel_init() sets the four monitor counters to MM, AP MCU, MD and
+ * GPU; every period_ms a deferrable work pauses the monitor, reads them
+ * with the total word count, and restarts it.  Samples go to a ring,
+ * /sys/kernel/debug/emi_bw/history, and add to per-master byte totals
+ * that the "emi_bw" perf PMU reports:
+ *
+ *   perf stat -a -C 0 -e emi_bw/total/,emi_bw/gpu/ ...
+ *
+ * period_ms=0 stops it and get_mem_bw() drives the monitor again.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/debugfs.h>
+#include <linux/device.h>
+#include <linux/moduleparam.h>
+#include <linux/perf_event.h>
+#include <linux/sched.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <linux/workqueue.h>
+#include <linux/jiffies.h>
+
+#include <mt-plat/mt_emi_bw.h>
+#include "mach/mt_emi_bm.h"
+
+#define TAG	"[EMI_BW] "
+
+#define EMI_BW_HISTORY	256	/* samples */
+#define EMI_BW_WORD	8	/* bytes per monitor word */
+
+/* monitor counter of each master, as set by mon_kernel_init() */
+static const unsigned int emi_bw_counter[EMI_BW_NR] = {
+	[EMI_BW_MM] = 1,
+	[EMI_BW_CPU] = 2,
+	[EMI_BW_MD] = 3,
+	[EMI_BW_GPU] = 4,
+};
+
+static const char * const emi_bw_name[EMI_BW_NR] = {
+	[EMI_BW_TOTAL] = "total",
+	[EMI_BW_CPU] = "cpu",
+	[EMI_BW_GPU] = "gpu",
+	[EMI_BW_MM] = "mm",
+	[EMI_BW_MD] = "md",
+};
+
+static unsigned int emi_bw_period_ms = 32;
+static bool emi_bw_running;
+static DEFINE_SPINLOCK(emi_bw_lock);
+static struct emi_bw_sample emi_bw_ring[EMI_BW_HISTORY];
+static unsigned int emi_bw_head;	/* next slot */
+static unsigned int emi_bw_nr;
+static unsigned int emi_bw_overruns;
+static u64 emi_bw_last_ns;
+/* bytes since boot, what the perf events count */
+static u64 emi_bw_bytes[EMI_BW_NR];
+
+static void emi_bw_work_func(struct work_struct *work);
+static DECLARE_DEFERRABLE_WORK(emi_bw_work, emi_bw_work_func);
+
+/* stopping the monitor clears it, but not always at the first try */
+static void emi_bw_restart(void)
+{
+	int count = 100;
+
+	BM_Enable(0);
+	while (BM_GetWordAllCount() != 0 && --count) {
+		BM_Enable(1);
+		BM_Enable(0);
+	}
+	BM_Enable(1);
+}
+
+static void emi_bw_take_sample(void)
+{
+	struct emi_bw_sample *s;
+	u64 words[EMI_BW_NR];
+	u64 now, dur;
+	long long all;
+	unsigned long flags;
+	int emi_dcm, i;
+
+	spin_lock_irqsave(&emi_bw_lock, flags);
+	emi_dcm = BM_GetEmiDcm();
+	BM_SetEmiDcm(0xff);
+	BM_Pause();
+	now = sched_clock();
+
+	all = BM_GetWordAllCount();
+	for (i = 0; i < EMI_BW_NR; i++)
+		words[i] = i == EMI_BW_TOTAL ? 0 :
+			(u32)BM_GetWordCount(emi_bw_counter[i]);
+
+	emi_bw_restart();
+	BM_SetEmiDcm(emi_dcm);
+
+	dur = now - emi_bw_last_ns;
+	emi_bw_last_ns = now;
+	/* overrun, or the monitor was paused over a suspend */
+	if (all == BM_ERR_OVERRUN || all < 0 ||
+	    dur > 10ULL * max(emi_bw_period_ms, 1U) * NSEC_PER_MSEC) {
+		emi_bw_overruns++;
+		goto out;
+	}
+	words[EMI_BW_TOTAL] = all;
+
+	s = &emi_bw_ring[emi_bw_head];
+	emi_bw_head = (emi_bw_head + 1) % EMI_BW_HISTORY;
+	if (emi_bw_nr < EMI_BW_HISTORY)
+		emi_bw_nr++;
+
+	s->end_ns = now;
+	s->dur_us = div_u64(dur, NSEC_PER_USEC);
+	for (i = 0; i < EMI_BW_NR; i++) {
+		u64 bytes = words[i] * EMI_BW_WORD;
+
+		ACCESS_ONCE(emi_bw_bytes[i]) = emi_bw_bytes[i] + bytes;
+		/* bytes per us is MB/s */
+		s->mbps[i] = s->dur_us ? div_u64(bytes, s->dur_us) : 0;
+	}
+out:
+	spin_unlock_irqrestore(&emi_bw_lock, flags);
+}
+
+static void emi_bw_work_func(struct work_struct *work)
+{
+	unsigned long flags;
+	unsigned int period;
+
+	/* under the lock, against a period_ms write restarting it */
+	spin_lock_irqsave(&emi_bw_lock, flags);
+	period = emi_bw_period_ms;
+	if (!period)
+		emi_bw_running = false;
+	spin_unlock_irqrestore(&emi_bw_lock, flags);
+	if (!period)
+		return;
+
+	emi_bw_take_sample();
+	queue_delayed_work(system_freezable_wq, &emi_bw_work,
+			   msecs_to_jiffies(period));
+}
+
+int mt_emi_bw_get(struct emi_bw_sample *s)
+{
+	unsigned long flags;
+	int ret = -ENODATA;
+
+	spin_lock_irqsave(&emi_bw_lock, flags);
+	if (emi_bw_running && emi_bw_nr) {
+		*s = emi_bw_ring[(emi_bw_head + EMI_BW_HISTORY - 1) % EMI_BW_HISTORY];
+		ret = 0;
+	}
+	spin_unlock_irqrestore(&emi_bw_lock, flags);
+
+	return ret;
+}
+EXPORT_SYMBOL(mt_emi_bw_get);
+
+u32 mt_emi_bw_get_mbps(enum emi_bw_master master)
+{
+	struct emi_bw_sample s;
+
+	if (master >= EMI_BW_NR || mt_emi_bw_get(&s))
+		return 0;
+	return s.mbps[master];
+}
+EXPORT_SYMBOL(mt_emi_bw_get_mbps);
+
+static int emi_bw_period_set(const char *val, const struct kernel_param *kp)
+{
+	unsigned long flags;
+	int ret;
+
+	ret = param_set_uint(val, kp);
+	if (ret || !emi_bw_period_ms)
+		return ret;
+
+	spin_lock_irqsave(&emi_bw_lock, flags);
+	if (!emi_bw_running) {
+		emi_bw_running = true;
+		emi_bw_last_ns = sched_clock();
+		/* get_mem_bw() may have left it paused */
+		emi_bw_restart();
+		queue_delayed_work(system_freezable_wq, &emi_bw_work,
+				   msecs_to_jiffies(emi_bw_period_ms));
+	}
+	spin_unlock_irqrestore(&emi_bw_lock, flags);
+
+	return 0;
+}
+
+static struct kernel_param_ops emi_bw_period_ops = {
+	.set = emi_bw_period_set,
+	.get = param_get_uint,
+};
+module_param_cb(period_ms, &emi_bw_period_ops, &emi_bw_period_ms,
+		S_IRUGO | S_IWUSR);
+
+bool mt_emi_bw_sampling(void)
+{
+	return ACCESS_ONCE(emi_bw_running);
+}
+
+static int emi_bw_history_show(struct seq_file *m, void *v)
+{
+	struct emi_bw_sample *ring;
+	unsigned int head, nr, overruns, i;
+	unsigned long flags;
+	int j;
+
+	ring = kmalloc(sizeof(emi_bw_ring), GFP_KERNEL);
+	if (!ring)
+		return -ENOMEM;
+
+	spin_lock_irqsave(&emi_bw_lock, flags);
+	memcpy(ring, emi_bw_ring, sizeof(emi_bw_ring));
+	head = emi_bw_head;
+	nr = emi_bw_nr;
+	overruns = emi_bw_overruns;
+	spin_unlock_irqrestore(&emi_bw_lock, flags);
+
+	seq_printf(m, "period %u ms, %s, %u samples dropped\n", emi_bw_period_ms,
+		   emi_bw_running ? "running" : "stopped", overruns);
+	seq_printf(m, "%16s %8s", "end(ns)", "dur(us)");
+	for (j = 0; j < EMI_BW_NR; j++)
+		seq_printf(m, " %7s", emi_bw_name[j]);
+	seq_puts(m, "  (MB/s)\n");
+
+	for (i = 0; i < nr; i++) {
+		struct emi_bw_sample *s;
+
+		s = &ring[(head + EMI_BW_HISTORY - nr + i) % EMI_BW_HISTORY];
+		seq_printf(m, "%16llu %8u", s->end_ns, s->dur_us);
+		for (j = 0; j < EMI_BW_NR; j++)
+			seq_printf(m, " %7u", s->mbps[j]);
+		seq_puts(m, "\n");
+	}
+	kfree(ring);
+
+	return 0;
+}
+
+static int emi_bw_history_open(struct inode *inode, struct file *file)
+{
+	return single_open_size(file, emi_bw_history_show, NULL,
+				(EMI_BW_HISTORY + 2) * 80);
+}
+
+static const struct file_operations emi_bw_history_fops = {
+	.open = emi_bw_history_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+/*
+ * perf PMU: one counting event per master, in bytes, moving once per
+ * sample.  The monitor is system wide, the events are opened on one CPU.
+ */
+static struct pmu emi_bw_pmu;
+
+static void emi_bw_event_read(struct perf_event *event)
+{
+	u64 prev, now;
+
+	now = ACCESS_ONCE(emi_bw_bytes[event->attr.config]);
+	prev = local64_xchg(&event->hw.prev_count, now);
+	local64_add(now - prev, &event->count);
+}
+
+static void emi_bw_event_start(struct perf_event *event, int flags)
+{
+	local64_set(&event->hw.prev_count,
+		    ACCESS_ONCE(emi_bw_bytes[event->attr.config]));
+	event->hw.state = 0;
+}
+
+static void emi_bw_event_stop(struct perf_event *event, int flags)
+{
+	if (event->hw.state & PERF_HES_STOPPED)
+		return;
+	if (flags & PERF_EF_UPDATE)
+		emi_bw_event_read(event);
+	event->hw.state |= PERF_HES_STOPPED | PERF_HES_UPTODATE;
+}
+
+static int emi_bw_event_add(struct perf_event *event, int flags)
+{
+	event->hw.state = PERF_HES_STOPPED | PERF_HES_UPTODATE;
+	if (flags & PERF_EF_START)
+		emi_bw_event_start(event, flags);
+	return 0;
+}
+
+static void emi_bw_event_del(struct perf_event *event, int flags)
+{
+	emi_bw_event_stop(event, PERF_EF_UPDATE);
+}
+
+static int emi_bw_event_init(struct perf_event *event)
+{
+	if (event->attr.type != emi_bw_pmu.type)
+		return -ENOENT;
+	if (event->attr.config >= EMI_BW_NR)
+		return -EINVAL;
+	/* counting only, and not per task */
+	if (is_sampling_event(event) || event->cpu < 0)
+		return -EINVAL;
+	return 0;
+}
+
+PMU_FORMAT_ATTR(event, "config:0-7");
+
+static struct attribute *emi_bw_format_attrs[] = {
+	&format_attr_event.attr,
+	NULL,
+};
+
+static struct attribute_group emi_bw_format_group = {
+	.name = "format",
+	.attrs = emi_bw_format_attrs,
+};
+
+static ssize_t emi_bw_event_show(struct device *dev,
+				 struct device_attribute *attr, char *page)
+{
+	struct perf_pmu_events_attr *pmu_attr =
+		container_of(attr, struct perf_pmu_events_attr, attr);
+
+	return sprintf(page, "event=0x%02llx\n", pmu_attr->id);
+}
+
+PMU_EVENT_ATTR(total, emi_bw_attr_total, EMI_BW_TOTAL, emi_bw_event_show);
+PMU_EVENT_ATTR(cpu, emi_bw_attr_cpu, EMI_BW_CPU, emi_bw_event_show);
+PMU_EVENT_ATTR(gpu, emi_bw_attr_gpu, EMI_BW_GPU, emi_bw_event_show);
+PMU_EVENT_ATTR(mm, emi_bw_attr_mm, EMI_BW_MM, emi_bw_event_show);
+PMU_EVENT_ATTR(md, emi_bw_attr_md, EMI_BW_MD, emi_bw_event_show);
+
+static struct attribute *emi_bw_event_attrs[] = {
+	&emi_bw_attr_total.attr.attr,
+	&emi_bw_attr_cpu.attr.attr,
+	&emi_bw_attr_gpu.attr.attr,
+	&emi_bw_attr_mm.attr.attr,
+	&emi_bw_attr_md.attr.attr,
+	NULL,
+};
+
+static struct attribute_group emi_bw_event_group = {
+	.name = "events",
+	.attrs = emi_bw_event_attrs,
+};
+
+static const struct attribute_group *emi_bw_attr_groups[] = {
+	&emi_bw_format_group,
+	&emi_bw_event_group,
+	NULL,
+};
+
+static struct pmu emi_bw_pmu = {
+	.task_ctx_nr = perf_invalid_context,
+	.attr_groups = emi_bw_attr_groups,
+	.event_init = emi_bw_event_init,
+	.add = emi_bw_event_add,
+	.del = emi_bw_event_del,
+	.start = emi_bw_event_start,
+	.stop = emi_bw_event_stop,
+	.read = emi_bw_event_read,
+};
+
+/* after mon_kernel_init() has set the counters up */
+static int __init emi_bw_mon_init(void)
+{
+	struct dentry *dir;
+	int ret;
+
+	ret = perf_pmu_register(&emi_bw_pmu, "emi_bw", -1);
+	if (ret)
+		pr_err(TAG"perf pmu register failed %d\n", ret);
+
+	dir = debugfs_create_dir("emi_bw", NULL);
+	if (dir)
+		debugfs_create_file("history", 0444, dir, NULL,
+				    &emi_bw_history_fops);
+
+	if (emi_bw_period_ms) {
+		emi_bw_running = true;
+		emi_bw_last_ns = sched_clock();
+		queue_delayed_work(system_freezable_wq, &emi_bw_work,
+				   msecs_to_jiffies(emi_bw_period_ms));
+	}
+
+	return 0;
+}
+late_initcall(emi_bw_mon_init);
@@ -6,6 +6,7 @@
 #include <linux/sched.h>
 #include "mach/mt_emi_bm.h"
 #include "mach/mt_mem_bw.h"
+#include <mt-plat/mt_emi_bw.h>
 #include <asm/div64.h>
 
 unsigned long long last_time_ns;
@@ -47,6 +48,10 @@ unsigned long long get_mem_bw(void)
 	if (g_pGetMemBW)
 		return g_pGetMemBW();
 
+	/* resetting the monitor here would cut the sampler's windows */
+	if (mt_emi_bw_sampling())
+		return mt_emi_bw_get_mbps(EMI_BW_TOTAL);
+
 	emi_dcm_disable = BM_GetEmiDcm();
 	/* pr_err("[get_mem_bw]emi_dcm_disable = %d\n", emi_dcm_disable); */
 	current_time_ns = sched_clock();
@@ -89,6 +89,11 @@ void ged_dvfs_cal_gpu_utilization_force(void);
 
 void ged_dvfs_run(unsigned long t, long phase, unsigned long ul3DFenceDoneTime);
 
+struct seq_file;
+unsigned long ged_dvfs_frame_done(unsigned long ulSubmitTS_us, unsigned long ulDoneTS_us, pid_t pid, const char *pszComm);
+void ged_dvfs_frame_dump(struct seq_file *psSeqFile);
+void ged_dvfs_frame_reset(void);
+
 void ged_dvfs_set_tuning_mode(GED_DVFS_TUNING_MODE eMode);
 GED_DVFS_TUNING_MODE ged_dvfs_get_tuning_mode(void);
 
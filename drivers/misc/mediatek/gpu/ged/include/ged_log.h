@@ -30,6 +30,8 @@ typedef enum GED_LOG_BUF_TYPE_TAG
     GED_LOG_BUF_TYPE_RINGBUFFER,
     GED_LOG_BUF_TYPE_QUEUEBUFFER,
     GED_LOG_BUF_TYPE_QUEUEBUFFER_AUTO_INCREASE,
+    /* per cpu rings of binary records, formatted when read; fmt must stay valid */
+    GED_LOG_BUF_TYPE_BINARY_RINGBUFFER,
 } GED_LOG_BUF_TYPE;
 
 GED_LOG_BUF_HANDLE ged_log_buf_alloc(int i32MaxLineCount, int i32MaxBufferSizeByte, GED_LOG_BUF_TYPE eType, const char* pszName, const char* pszNodeName);
@@ -47,6 +47,7 @@ typedef enum GED_INFO_TAG
     GED_SRV_SUICIDE,
     GED_PRE_HALF_PERIOD,
     GED_LATEST_START,
+    GED_VSYNC_PERIOD,
     GED_UNDEFINED
 } GED_INFO;
 
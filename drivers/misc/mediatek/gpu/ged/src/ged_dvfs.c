@@ -13,6 +13,10 @@
 
 #include <linux/slab.h>
 #include <linux/sched.h>
+#include <linux/seq_file.h>
+#include <linux/spinlock.h>
+#include <linux/jiffies.h>
+#include <linux/math64.h>
 
 #ifdef GED_DVFS_ENABLE
 #include <mt-plat/mt_boot.h>
@@ -21,6 +25,7 @@
 
 #include <trace/events/mtk_events.h>
 #include <mt-plat/mtk_gpu_utility.h>
+#include <mt-plat/perfmgr.h>
 
 #include <asm/siginfo.h>
 #include <linux/sched.h>
@@ -107,6 +112,7 @@ static unsigned long gL_ulWorkingPeriod_us = 0; // last frame half, t0
 
 
 static unsigned int  g_ui32FreqIDFromPolicy = 0;
+static bool gbFramePolicyActive; // OPP set from the frame deadline policy
 
 unsigned long g_ulvsync_period;
 static GED_DVFS_TUNING_MODE g_eTuningMode = 0;
@@ -202,6 +208,8 @@ unsigned long ged_query_info( GED_INFO eType)
             return g_ulWorkingPeriod_us;
         case GED_LATEST_START:
             return g_ulPreCalResetTS_us;
+        case GED_VSYNC_PERIOD:
+            return g_ulvsync_period;
         default:
             return 0;
     }
@@ -459,6 +467,13 @@ GED_ERROR ged_dvfs_um_commit( unsigned long gpu_tar_freq, bool bFallback)
      {
          ged_dvfs_probe_signal(GED_SRV_SUICIDE_EVENT);
     }
+
+	/* the frame deadline policy already picked the OPP at this vsync */
+	if (gbFramePolicyActive)
+	{
+		mutex_unlock(&gsDVFSLock);
+		return GED_OK;
+	}
      
      if(bFallback==true) // in the fallback mode, gpu_tar_freq taking as freq index
     {
@@ -872,6 +887,241 @@ void ged_dvfs_cal_gpu_utilization_force()
 	spin_unlock_irqrestore(&g_sSpinLock, ui32IRQFlags);
 }
 
+/*
+ * Frame deadline policy
+ *
+ * The loading based policies only see how busy the GPU was over the last
+ * sampling window, so after a scene change they climb one OPP per vsync.
+ * Each completed 3D fence tells how long the GPU worked on that frame,
+ * from the later of its submission and the previous completion up to its
+ * signal.  At the frequency it ran at, that is the frame's cost in cycles;
+ * the next frame is expected to cost the larger of the last frame and the
+ * mean of the recent ones, and the lowest OPP that fits that cost in the
+ * vsync period, with some headroom, is picked at the next SW vsync.
+ * Without recent fences (no 3D rendering) the loading policies stay in
+ * charge.
+ *
+ * A frame that missed its vsync although the GPU could have made it, and
+ * whose submission found the GPU idle, was held up on the CPU side.  A
+ * faster GPU does not help it: after a couple of those in a row the CPU
+ * is boosted through the perfmgr arbiter for a short while instead.
+ */
+#define GED_FRAME_HIST_SIZE		8
+#define GED_FRAME_HIST_MIN		3
+#define GED_FRAME_HEADROOM_PCT		90
+#define GED_FRAME_STALE_US		100000
+#define GED_FRAME_APP_NUM		8
+#define GED_FRAME_MISS_BUCKETS		4	/* met, 1, 2, 3+ periods late */
+#define GED_FRAME_CPU_BOUND_MIN		2
+#define GED_FRAME_CPU_BOOST_MS		100
+#define GED_FRAME_CPU_BOOST_CORES	2
+
+typedef struct GED_FRAME_APP_TAG
+{
+	pid_t pid;
+	char acComm[TASK_COMM_LEN];
+	unsigned long ulFrames;
+	unsigned long aulMiss[GED_FRAME_MISS_BUCKETS];
+	unsigned long ulCpuBound;
+	unsigned long ulLastSeen;
+} GED_FRAME_APP;
+
+static unsigned int gpu_frame_dvfs_enable = 1;
+static unsigned int gpu_frame_cpu_boost = 1;
+
+static DEFINE_SPINLOCK(gsFrameLock);
+static unsigned long long gaullFrameCycles[GED_FRAME_HIST_SIZE];
+static unsigned int gui32FrameCount;
+static unsigned long gulFrameLastDoneTS_us;
+static unsigned int gui32FrameCpuBound;
+static unsigned long gulFrameCpuBoosts;
+static GED_FRAME_APP gasFrameApp[GED_FRAME_APP_NUM];
+
+/* find the slot of an app, recycling the one seen least recently */
+static GED_FRAME_APP *ged_dvfs_frame_app(pid_t pid, const char *pszComm)
+{
+	GED_FRAME_APP *psApp = &gasFrameApp[0];
+	int i;
+
+	for (i = 0; i < GED_FRAME_APP_NUM; i++)
+	{
+		if (gasFrameApp[i].pid == pid && gasFrameApp[i].ulFrames)
+			return &gasFrameApp[i];
+		if (!gasFrameApp[i].ulFrames)
+		{
+			psApp = &gasFrameApp[i];
+			break;
+		}
+		if (time_before(gasFrameApp[i].ulLastSeen, psApp->ulLastSeen))
+			psApp = &gasFrameApp[i];
+	}
+
+	memset(psApp, 0, sizeof(*psApp));
+	psApp->pid = pid;
+	strlcpy(psApp->acComm, pszComm, sizeof(psApp->acComm));
+	return psApp;
+}
+
+/**
+ * ged_dvfs_frame_done - account a completed 3D frame
+ * @ulSubmitTS_us: time the frame's fence was handed to GED
+ * @ulDoneTS_us: time the fence signalled
+ * @pid: process that submitted the frame
+ * @pszComm: its name
+ *
+ * Called from the fence callback, may be in interrupt context.
+ * Returns the time the GPU spent on the frame, in us.
+ */
+unsigned long ged_dvfs_frame_done(unsigned long ulSubmitTS_us, unsigned long ulDoneTS_us, pid_t pid, const char *pszComm)
+{
+#ifdef GED_DVFS_ENABLE
+	unsigned long ulPeriod_us = g_ulvsync_period;
+	unsigned long ulStart_us, ulBusy_us, ulInterval_us;
+	unsigned int ui32Freq, ui32Late;
+	GED_FRAME_APP *psApp;
+	unsigned long ulIRQFlags;
+	bool bGPUIdle, bBoost = false;
+
+	ui32Freq = mt_gpufreq_get_freq_by_idx(mt_gpufreq_get_cur_freq_index());
+
+	spin_lock_irqsave(&gsFrameLock, ulIRQFlags);
+
+	/* the GPU works the fences in order, this one started after the last */
+	bGPUIdle = time_after(ulSubmitTS_us, gulFrameLastDoneTS_us);
+	ulStart_us = bGPUIdle ? ulSubmitTS_us : gulFrameLastDoneTS_us;
+	ulBusy_us = time_after(ulDoneTS_us, ulStart_us) ? ulDoneTS_us - ulStart_us : 0;
+	ulInterval_us = ulDoneTS_us - gulFrameLastDoneTS_us;
+	gulFrameLastDoneTS_us = ulDoneTS_us;
+
+	gaullFrameCycles[gui32FrameCount % GED_FRAME_HIST_SIZE] = div_u64((u64)ulBusy_us * ui32Freq, 1000);
+	gui32FrameCount++;
+
+	psApp = ged_dvfs_frame_app(pid, pszComm);
+	psApp->ulLastSeen = jiffies;
+	psApp->ulFrames++;
+	/* periods the frame overran its own, busy <= period met the deadline */
+	ui32Late = (ulPeriod_us && ulBusy_us) ? (ulBusy_us - 1) / ulPeriod_us : 0;
+	psApp->aulMiss[min_t(unsigned int, ui32Late, GED_FRAME_MISS_BUCKETS - 1)]++;
+
+	if (bGPUIdle && ulInterval_us > ulPeriod_us &&
+	    (u64)ulBusy_us * 100 < (u64)ulPeriod_us * GED_FRAME_HEADROOM_PCT)
+	{
+		psApp->ulCpuBound++;
+		if (++gui32FrameCpuBound >= GED_FRAME_CPU_BOUND_MIN && gpu_frame_cpu_boost)
+		{
+			gulFrameCpuBoosts++;
+			bBoost = true;
+		}
+	}
+	else
+	{
+		gui32FrameCpuBound = 0;
+	}
+
+	spin_unlock_irqrestore(&gsFrameLock, ulIRQFlags);
+
+	if (bBoost)
+	{
+		struct perfmgr_boost_req sReq;
+
+		/* re-filed while frames stay CPU bound, lapses on its own */
+		perfmgr_boost_req_init(&sReq);
+		sReq.min_cores_l = GED_FRAME_CPU_BOOST_CORES;
+		sReq.min_freq_l = perfmgr_get_target_freq();
+		perfmgr_boost_request(PERFMGR_BOOST_RENDER, &sReq, GED_FRAME_CPU_BOOST_MS);
+	}
+
+	return ulBusy_us;
+#else
+	return time_after(ulDoneTS_us, ulSubmitTS_us) ? ulDoneTS_us - ulSubmitTS_us : 0;
+#endif
+}
+
+/* lowest OPP expected to finish the next frame within the vsync period */
+static bool ged_dvfs_frame_policy(unsigned long t, unsigned int *pui32NewFreqID)
+{
+#ifdef GED_DVFS_ENABLE
+	int i32MaxLevel = (int)(mt_gpufreq_get_dvfs_table_num() - 1);
+	unsigned long long ullCycles, ullSum = 0, ullLast;
+	unsigned long long ullBudget;
+	unsigned int n;
+	unsigned long ulIRQFlags;
+	int i;
+
+	if (!gpu_frame_dvfs_enable || !g_ulvsync_period)
+		return false;
+
+	spin_lock_irqsave(&gsFrameLock, ulIRQFlags);
+	n = min_t(unsigned int, gui32FrameCount, GED_FRAME_HIST_SIZE);
+	if (n < GED_FRAME_HIST_MIN || time_after(t, gulFrameLastDoneTS_us + GED_FRAME_STALE_US))
+	{
+		spin_unlock_irqrestore(&gsFrameLock, ulIRQFlags);
+		return false;
+	}
+	for (i = 0; i < (int)n; i++)
+		ullSum += gaullFrameCycles[i];
+	ullLast = gaullFrameCycles[(gui32FrameCount - 1) % GED_FRAME_HIST_SIZE];
+	spin_unlock_irqrestore(&gsFrameLock, ulIRQFlags);
+
+	ullCycles = max(ullLast, div_u64(ullSum, n));
+
+	/* an OPP runs kHz * us / 1000 cycles within the budget */
+	ullBudget = (unsigned long long)g_ulvsync_period * GED_FRAME_HEADROOM_PCT / 100;
+	for (i = i32MaxLevel; i > 0; i--)
+	{
+		if ((unsigned long long)mt_gpufreq_get_freq_by_idx(i) * ullBudget >= ullCycles * 1000)
+			break;
+	}
+	*pui32NewFreqID = i;
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+void ged_dvfs_frame_dump(struct seq_file *psSeqFile)
+{
+	unsigned long ulIRQFlags;
+	GED_FRAME_APP asApp[GED_FRAME_APP_NUM];
+	unsigned long long ullLast = 0;
+	unsigned int ui32Count;
+	unsigned long ulBoosts;
+	int i, j;
+
+	spin_lock_irqsave(&gsFrameLock, ulIRQFlags);
+	memcpy(asApp, gasFrameApp, sizeof(asApp));
+	ui32Count = gui32FrameCount;
+	if (ui32Count)
+		ullLast = gaullFrameCycles[(ui32Count - 1) % GED_FRAME_HIST_SIZE];
+	ulBoosts = gulFrameCpuBoosts;
+	spin_unlock_irqrestore(&gsFrameLock, ulIRQFlags);
+
+	seq_printf(psSeqFile, "enable: %u active: %d frames: %u last(kcycles): %llu period(us): %lu\n",
+		gpu_frame_dvfs_enable, gbFramePolicyActive, ui32Count, ullLast, g_ulvsync_period);
+	seq_printf(psSeqFile, "cpu boost: %u boosts: %lu\n", gpu_frame_cpu_boost, ulBoosts);
+	seq_puts(psSeqFile, "pid     comm             frames     met        late1      late2      late3+     cpu_bound\n");
+	for (i = 0; i < GED_FRAME_APP_NUM; i++)
+	{
+		if (!asApp[i].ulFrames)
+			continue;
+		seq_printf(psSeqFile, "%-7d %-16s %-10lu", asApp[i].pid, asApp[i].acComm, asApp[i].ulFrames);
+		for (j = 0; j < GED_FRAME_MISS_BUCKETS; j++)
+			seq_printf(psSeqFile, " %-10lu", asApp[i].aulMiss[j]);
+		seq_printf(psSeqFile, " %lu\n", asApp[i].ulCpuBound);
+	}
+}
+
+void ged_dvfs_frame_reset(void)
+{
+	unsigned long ulIRQFlags;
+
+	spin_lock_irqsave(&gsFrameLock, ulIRQFlags);
+	memset(gasFrameApp, 0, sizeof(gasFrameApp));
+	gulFrameCpuBoosts = 0;
+	spin_unlock_irqrestore(&gsFrameLock, ulIRQFlags);
+}
+
 void ged_dvfs_run(unsigned long t, long phase, unsigned long ul3DFenceDoneTime)
 {
 	bool bError;	
@@ -916,6 +1166,15 @@ void ged_dvfs_run(unsigned long t, long phase, unsigned long ul3DFenceDoneTime)
 		
 		spin_unlock_irqrestore(&g_sSpinLock,ui32IRQFlags);
 
+		gbFramePolicyActive = (GED_DVFS_TIMER_BACKUP != phase && 0 != t &&
+			ged_dvfs_frame_policy(t, &g_ui32FreqIDFromPolicy));
+		if (gbFramePolicyActive)
+		{
+			g_CommitType = MTK_GPU_DVFS_TYPE_VSYNCBASED;
+			g_computed_freq_id = g_ui32FreqIDFromPolicy;
+			ged_dvfs_gpu_freq_commit(g_ui32FreqIDFromPolicy, GED_DVFS_DEFAULT_COMMIT);
+		}
+		else
 #ifdef GED_DVFS_UM_CAL        
 		if(GED_DVFS_TIMER_BACKUP==phase) // timer-backup DVFS use only
 #endif             
@@ -1217,5 +1476,7 @@ module_param(gpu_bottom_freq, uint, 0644);
 module_param(gpu_cust_boost_freq, uint, 0644);
 module_param(gpu_cust_upbound_freq, uint, 0644);
 module_param(g_gpu_timer_based_emu, uint, 0644);
+module_param(gpu_frame_dvfs_enable, uint, 0644);
+module_param(gpu_frame_cpu_boost, uint, 0644);
 #endif	
 
@@ -43,6 +43,7 @@ static struct dentry* gpsDvfsPreFreqEntry = NULL;
 static struct dentry* gpsDvfsGpuUtilizationEntry = NULL;
 static struct dentry* gpsFpsUpperBoundEntry = NULL;
 static struct dentry* gpsIntegrationReportReadEntry = NULL;
+static struct dentry* gpsFrameDeadlineEntry = NULL;
 
 int tokenizer(char* pcSrc, int i32len, int* pi32IndexArray, int i32NumToken)
 {
@@ -852,6 +853,51 @@ static struct seq_operations gsIntegrationReportReadOps =
 	.show = ged_dvfs_integration_report_seq_show,
 };
 //-----------------------------------------------------------------------------
+static void* ged_frame_deadline_seq_start(struct seq_file *psSeqFile, loff_t *puiPosition)
+{
+	if (0 == *puiPosition)
+	{
+		return SEQ_START_TOKEN;
+	}
+
+	return NULL;
+}
+//-----------------------------------------------------------------------------
+static void ged_frame_deadline_seq_stop(struct seq_file *psSeqFile, void *pvData)
+{
+
+}
+//-----------------------------------------------------------------------------
+static void* ged_frame_deadline_seq_next(struct seq_file *psSeqFile, void *pvData, loff_t *puiPosition)
+{
+	return NULL;
+}
+//-----------------------------------------------------------------------------
+static int ged_frame_deadline_seq_show(struct seq_file *psSeqFile, void *pvData)
+{
+	if (pvData != NULL)
+	{
+		ged_dvfs_frame_dump(psSeqFile);
+	}
+	return 0;
+}
+//-----------------------------------------------------------------------------
+static struct seq_operations gsFrameDeadlineReadOps =
+{
+	.start = ged_frame_deadline_seq_start,
+	.stop = ged_frame_deadline_seq_stop,
+	.next = ged_frame_deadline_seq_next,
+	.show = ged_frame_deadline_seq_show,
+};
+//-----------------------------------------------------------------------------
+/* any write clears the per app deadline histogram */
+static ssize_t ged_frame_deadline_write_entry(const char __user *pszBuffer, size_t uiCount,
+		loff_t uiPosition, void *pvData)
+{
+	ged_dvfs_frame_reset();
+	return uiCount;
+}
+//-----------------------------------------------------------------------------
 
 GED_ERROR ged_hal_init(void)
 {
@@ -1007,6 +1053,21 @@ GED_ERROR ged_hal_init(void)
 		goto ERROR;
 	}
 
+	/* Frame deadline policy state and per app missed deadlines */
+	err = ged_debugFS_create_entry(
+			"frame_deadline",
+			gpsHALDir,
+			&gsFrameDeadlineReadOps,
+			ged_frame_deadline_write_entry,
+			NULL,
+			&gpsFrameDeadlineEntry);
+
+	if (unlikely(err != GED_OK))
+	{
+		GED_LOGE("ged: failed to create frame_deadline entry!\n");
+		goto ERROR;
+	}
+
     return err;
 
 ERROR:
@@ -1018,6 +1079,7 @@ ERROR:
 //-----------------------------------------------------------------------------
 void ged_hal_exit(void)
 {
+	ged_debugFS_remove_entry(gpsFrameDeadlineEntry);
 	ged_debugFS_remove_entry(gpsIntegrationReportReadEntry);
     ged_debugFS_remove_entry(gpsFpsUpperBoundEntry);
     ged_debugFS_remove_entry(gpsVsyncOffsetLevelEntry);
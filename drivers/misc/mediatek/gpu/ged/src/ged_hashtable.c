@@ -14,14 +14,27 @@
 #include "ged_base.h"
 #include "ged_hashtable.h"
 #include <linux/hashtable.h>
+#include <linux/rculist.h>
+#include <linux/spinlock.h>
+#include <linux/atomic.h>
+
+/*
+ * Lookups only take rcu_read_lock(), so the per frame ioctls of the render
+ * threads never wait on each other; insert and remove lock one bucket.
+ */
+typedef struct GED_HASHBUCKET_TAG
+{
+    struct hlist_head   sHead;
+    spinlock_t          sLock;
+} GED_HASHBUCKET;
 
 typedef struct GED_HASHTABLE_TAG
 {
     unsigned int        ui32Bits;
     unsigned int        ui32Length;
-    unsigned int        ui32CurrentID;
-    unsigned int        ui32Count;
-    struct hlist_head*  psHashTable;
+    atomic_t            sCurrentID;
+    atomic_t            sCount;
+    GED_HASHBUCKET*     psHashTable;
 } GED_HASHTABLE;
 
 typedef struct GED_HASHNODE_TAG
@@ -29,14 +42,16 @@ typedef struct GED_HASHNODE_TAG
     unsigned int        ui32ID;
     void*               pvoid;
     struct hlist_node   sNode;
+    struct rcu_head     sRcu;
 } GED_HASHNODE;
 
 #define GED_HASHTABLE_INIT_ID 1234 // 0 = invalid
 
-void* __ged_hashtable_find(struct hlist_head *head, unsigned int ui32ID)
+/* under rcu_read_lock() or the bucket lock */
+static GED_HASHNODE* __ged_hashtable_find(struct hlist_head *head, unsigned int ui32ID)
 {
     GED_HASHNODE* psHN;
-    hlist_for_each_entry_rcu(psHN, head, sNode) 
+    hlist_for_each_entry_rcu(psHN, head, sNode)
     {
         if (psHN->ui32ID == ui32ID)
         {
@@ -46,10 +61,9 @@ void* __ged_hashtable_find(struct hlist_head *head, unsigned int ui32ID)
     return NULL;
 }
 
-static int ged_hash(GED_HASHTABLE_HANDLE hHashTable, unsigned int ui32ID)
+static GED_HASHBUCKET* ged_hash(GED_HASHTABLE* psHT, unsigned int ui32ID)
 {
-    GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
-    return hash_32(ui32ID, psHT->ui32Bits);
+    return &psHT->psHashTable[hash_32(ui32ID, psHT->ui32Bits)];
 }
 
 GED_HASHTABLE_HANDLE ged_hashtable_create(unsigned int ui32Bits)
@@ -69,19 +83,21 @@ GED_HASHTABLE_HANDLE ged_hashtable_create(unsigned int ui32Bits)
     {
         psHT->ui32Bits = ui32Bits;
         psHT->ui32Length = 1 << ui32Bits;
-        psHT->ui32CurrentID = GED_HASHTABLE_INIT_ID; // 0 = invalid
-        psHT->psHashTable = (struct hlist_head*)ged_alloc(psHT->ui32Length * sizeof(struct hlist_head));
+        atomic_set(&psHT->sCurrentID, GED_HASHTABLE_INIT_ID); // 0 = invalid
+        atomic_set(&psHT->sCount, 0);
+        psHT->psHashTable = (GED_HASHBUCKET*)ged_alloc(psHT->ui32Length * sizeof(GED_HASHBUCKET));
         if (psHT->psHashTable)
         {
             for (i = 0; i < psHT->ui32Length; i++)
             {
-                INIT_HLIST_HEAD(&psHT->psHashTable[i]);
+                INIT_HLIST_HEAD(&psHT->psHashTable[i].sHead);
+                spin_lock_init(&psHT->psHashTable[i].sLock);
             }
             return (GED_HASHTABLE_HANDLE)psHT;
         }
+        ged_free(psHT, sizeof(GED_HASHTABLE));
     }
 
-    ged_hashtable_destroy(psHT);
     return NULL;
 }
 
@@ -90,36 +106,27 @@ void ged_hashtable_destroy(GED_HASHTABLE_HANDLE hHashTable)
     GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
     if (psHT)
     {
-        int i = 0;
-        while(psHT->ui32Count > 0)
+        unsigned int i;
+        for (i = 0; i < psHT->ui32Length; i++)
         {
-            unsigned int ui32ID = 0;
+            GED_HASHBUCKET* psBucket = &psHT->psHashTable[i];
             GED_HASHNODE* psHN;
-            // get one to be freed
-            for (;i < psHT->ui32Length; i++)
-            {
-                struct hlist_head *head = &psHT->psHashTable[i];
-                hlist_for_each_entry_rcu(psHN, head, sNode) 
-                {
-                    ui32ID = psHN->ui32ID;
-                    break;
-                }
-                if (0 < ui32ID)
-                {
-                    break;
-                }
-            }
+            struct hlist_node* psTmp;
 
-            if (i >= psHT->ui32Length)
+            spin_lock(&psBucket->sLock);
+            hlist_for_each_entry_safe(psHN, psTmp, &psBucket->sHead, sNode)
             {
-                break;
+                hlist_del_rcu(&psHN->sNode);
+                kfree_rcu(psHN, sRcu);
             }
-
-            ged_hashtable_remove(psHT, ui32ID);
+            spin_unlock(&psBucket->sLock);
         }
 
+        /* the nodes go with this module, wait for them */
+        rcu_barrier();
+
         /* free the hash table */
-        ged_free(psHT->psHashTable, psHT->ui32Length * sizeof(struct hlist_head));
+        ged_free(psHT->psHashTable, psHT->ui32Length * sizeof(GED_HASHBUCKET));
         ged_free(psHT, sizeof(GED_HASHTABLE));
     }
 }
@@ -128,49 +135,47 @@ GED_ERROR ged_hashtable_insert(GED_HASHTABLE_HANDLE hHashTable, void* pvoid, uns
 {
     GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
     GED_HASHNODE* psHN = NULL;
-    unsigned int ui32Hash, ui32ID;
+    GED_HASHBUCKET* psBucket;
+    unsigned int ui32ID;
+    int i32Tries;
 
     if ((!psHT) || (!pui32ID))
     {
         return GED_ERROR_INVALID_PARAMS;
     }
 
-    ui32ID = psHT->ui32CurrentID + 1;
-    while(1)
+    psHN = (GED_HASHNODE*)ged_alloc(sizeof(GED_HASHNODE));
+    if (!psHN)
+    {
+        return GED_ERROR_OOM;
+    }
+    psHN->pvoid = pvoid;
+
+    /* an ID can only be taken by one of the nodes there, after a wrap */
+    for (i32Tries = atomic_read(&psHT->sCount) + 1; i32Tries > 0; i32Tries--)
     {
-        ui32Hash = ged_hash(psHT, ui32ID);
-        psHN = __ged_hashtable_find(&psHT->psHashTable[ui32Hash], ui32ID);
-        if (psHN != NULL)
+        ui32ID = (unsigned int)atomic_inc_return(&psHT->sCurrentID);
+        if (ui32ID == 0)//skip the value 0
         {
-            ui32ID++;
-            if (ui32ID == 0)//skip the value 0
-            {
-                ui32ID = 1;
-            }
-            if (ui32ID == psHT->ui32CurrentID)
-            {
-                return GED_ERROR_FAIL;
-            }
+            continue;
         }
-        else
+
+        psBucket = ged_hash(psHT, ui32ID);
+        spin_lock(&psBucket->sLock);
+        if (__ged_hashtable_find(&psBucket->sHead, ui32ID) == NULL)
         {
-            break;
+            psHN->ui32ID = ui32ID;
+            hlist_add_head_rcu(&psHN->sNode, &psBucket->sHead);
+            spin_unlock(&psBucket->sLock);
+            atomic_inc(&psHT->sCount);
+            *pui32ID = ui32ID;
+            return GED_OK;
         }
-    };
-
-    psHN = (GED_HASHNODE*)ged_alloc(sizeof(GED_HASHNODE));
-    if (psHN)
-    {
-        psHN->pvoid = pvoid;
-        psHN->ui32ID = ui32ID;
-        psHT->ui32CurrentID = ui32ID;
-        *pui32ID = ui32ID;
-        hlist_add_head_rcu(&psHN->sNode, &psHT->psHashTable[ui32Hash]);
-        psHT->ui32Count += 1;
-        return GED_OK;
+        spin_unlock(&psBucket->sLock);
     }
 
-    return GED_ERROR_OOM;
+    ged_free(psHN, sizeof(GED_HASHNODE));
+    return GED_ERROR_FAIL;
 }
 
 void ged_hashtable_remove(GED_HASHTABLE_HANDLE hHashTable, unsigned int ui32ID)
@@ -178,14 +183,22 @@ void ged_hashtable_remove(GED_HASHTABLE_HANDLE hHashTable, unsigned int ui32ID)
     GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
     if (psHT)
     {
-        unsigned int ui32Hash = ged_hash(psHT, ui32ID);
-        GED_HASHNODE* psHN = __ged_hashtable_find(&psHT->psHashTable[ui32Hash], ui32ID);
+        GED_HASHBUCKET* psBucket = ged_hash(psHT, ui32ID);
+        GED_HASHNODE* psHN;
+
+        spin_lock(&psBucket->sLock);
+        psHN = __ged_hashtable_find(&psBucket->sHead, ui32ID);
         if (psHN)
         {
             hlist_del_rcu(&psHN->sNode);
-            synchronize_rcu();
-            ged_free(psHN, sizeof(GED_HASHNODE));
-            psHT->ui32Count -= 1;
+        }
+        spin_unlock(&psBucket->sLock);
+
+        if (psHN)
+        {
+            /* ged_alloc() took it from kmalloc, readers may still see it */
+            kfree_rcu(psHN, sRcu);
+            atomic_dec(&psHT->sCount);
         }
     }
 }
@@ -195,16 +208,25 @@ void* ged_hashtable_find(GED_HASHTABLE_HANDLE hHashTable, unsigned int ui32ID)
     GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
     if (psHT)
     {
-        unsigned int ui32Hash = ged_hash(psHT, ui32ID);
-        GED_HASHNODE* psHN = __ged_hashtable_find(&psHT->psHashTable[ui32Hash], ui32ID);
+        GED_HASHNODE* psHN;
+        void* pvoid = NULL;
+
+        rcu_read_lock();
+        psHN = __ged_hashtable_find(&ged_hash(psHT, ui32ID)->sHead, ui32ID);
         if (psHN)
         {
-            return psHN->pvoid;
+            pvoid = ACCESS_ONCE(psHN->pvoid);
+        }
+        rcu_read_unlock();
+
+        if (psHN)
+        {
+            return pvoid;
         }
 #ifdef GED_DEBUG
         if (ui32ID != 0)
         {
-            GED_LOGE("ged_hashtable_find: ui32ID=%u ui32Hash=%u psHN=%p\n", ui32ID, ui32Hash, psHN);
+            GED_LOGE("ged_hashtable_find: ui32ID=%u psHN=%p\n", ui32ID, psHN);
         }
 #endif
     }
@@ -214,17 +236,20 @@ void* ged_hashtable_find(GED_HASHTABLE_HANDLE hHashTable, unsigned int ui32ID)
 GED_ERROR ged_hashtable_set(GED_HASHTABLE_HANDLE hHashTable, unsigned int ui32ID, void* pvoid)
 {
     GED_HASHTABLE* psHT = (GED_HASHTABLE*)hHashTable;
+    GED_ERROR ret = GED_ERROR_INVALID_PARAMS;
     if (psHT)
     {
-        unsigned int ui32Hash = ged_hash(psHT, ui32ID);
-        GED_HASHNODE* psHN = __ged_hashtable_find(&psHT->psHashTable[ui32Hash], ui32ID);
+        GED_HASHNODE* psHN;
+
+        rcu_read_lock();
+        psHN = __ged_hashtable_find(&ged_hash(psHT, ui32ID)->sHead, ui32ID);
         if (psHN)
         {
-            psHN->pvoid = pvoid;
-            return GED_OK;
+            ACCESS_ONCE(psHN->pvoid) = pvoid;
+            ret = GED_OK;
         }
+        rcu_read_unlock();
     }
 
-    return GED_ERROR_INVALID_PARAMS;
+    return ret;
 }
-
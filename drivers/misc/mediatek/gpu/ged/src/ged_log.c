@@ -22,6 +22,9 @@
 #include <linux/proc_fs.h>
 #include <linux/seq_file.h>
 #include <linux/rtc.h>
+#include <linux/log2.h>
+#include <linux/string.h>
+#include <linux/slab.h>
 
 #include <linux/module.h>
 
@@ -43,8 +46,49 @@ enum
     GED_LOG_ATTR_QUEUEBUFFER    = 0x2,
     /* increase buffersize when buffer is full */
     GED_LOG_ATTR_AUTO_INCREASE  = 0x4,
+    /* binary records in per cpu rings, see GED_LOG_BIN_RECORD */
+    GED_LOG_ATTR_BINARY         = 0x8,
 };
 
+/*
+ * Binary log records
+ *
+ * Formatting every DVFS and fence event under the buffer lock is what the
+ * text buffers cost on the hot path.  A binary buffer only keeps the
+ * format pointer and the arguments packed by vbin_printf() in a fixed
+ * size record of the writing cpu's ring; the ring is the cpu's own, so
+ * writers only disable interrupts.  Records are formatted with
+ * bstr_printf() when the debugfs file is read, merged across cpus by time.
+ * A reader detects a record overwritten under it through its sequence
+ * count, which is odd while the record is being written.
+ */
+#define GED_LOG_BIN_RECORD_SIZE     128
+#define GED_LOG_BIN_MIN_RECORDS     64
+#define GED_LOG_BIN_TRUNCATED       0xffff
+
+typedef struct GED_LOG_BIN_RECORD_TAG
+{
+    u32         seq;
+    u16         len;        /* words of args, GED_LOG_BIN_TRUNCATED if they did not fit */
+    u16         tattrs;
+    u64         time;
+    const char  *fmt;
+    int         pid;
+    int         tid;
+    u32         args[];
+} GED_LOG_BIN_RECORD;
+
+#define GED_LOG_BIN_ARGS_WORDS      ((GED_LOG_BIN_RECORD_SIZE - sizeof(GED_LOG_BIN_RECORD)) / sizeof(u32))
+
+typedef struct GED_LOG_BIN_RING_TAG
+{
+    u64         head;       /* records written */
+    u64         tail;       /* first record kept by the last reset */
+} GED_LOG_BIN_RING;
+
+/* each cpu: the ring header in a record sized slot, then the records */
+#define GED_LOG_BIN_HDR_SIZE        GED_LOG_BIN_RECORD_SIZE
+
 typedef struct GED_LOG_BUF_LINE_TAG
 {
     int         offset;
@@ -121,6 +165,52 @@ static GED_LOG_BUF* ged_log_buf_from_handle(GED_LOG_BUF_HANDLE hLogBuf)
     return ged_hashtable_find(ghHashTable, (unsigned int)hLogBuf);
 }
 
+static GED_LOG_BIN_RING *ged_log_bin_ring(GED_LOG_BUF *psGEDLogBuf, int cpu)
+{
+    /* i32LineCount holds the records of one cpu */
+    return psGEDLogBuf->pMemory + (unsigned long)cpu *
+        (GED_LOG_BIN_HDR_SIZE + psGEDLogBuf->i32LineCount * GED_LOG_BIN_RECORD_SIZE);
+}
+
+static GED_LOG_BIN_RECORD *ged_log_bin_record(GED_LOG_BUF *psGEDLogBuf, GED_LOG_BIN_RING *psRing, u64 idx)
+{
+    unsigned long slot = idx & (psGEDLogBuf->i32LineCount - 1);
+
+    return (void *)psRing + GED_LOG_BIN_HDR_SIZE + slot * GED_LOG_BIN_RECORD_SIZE;
+}
+
+static GED_ERROR __ged_log_buf_vprint_bin(GED_LOG_BUF *psGEDLogBuf, const char *fmt, va_list args, int attrs)
+{
+#ifdef CONFIG_BINARY_PRINTF
+    GED_LOG_BIN_RING *psRing;
+    GED_LOG_BIN_RECORD *psRec;
+    unsigned long ulIRQFlags;
+    u64 head;
+    int len;
+
+    local_irq_save(ulIRQFlags);
+    psRing = ged_log_bin_ring(psGEDLogBuf, smp_processor_id());
+    head = psRing->head;
+    psRec = ged_log_bin_record(psGEDLogBuf, psRing, head);
+
+    ACCESS_ONCE(psRec->seq) = ((u32)head << 1) | 1;
+    smp_wmb();
+    psRec->fmt = fmt;
+    psRec->tattrs = attrs & (GED_LOG_ATTR_TIME | GED_LOG_ATTR_TIME_TPT);
+    psRec->time = ged_get_time();
+    psRec->pid = current->tgid;
+    psRec->tid = current->pid;
+    len = vbin_printf(psRec->args, GED_LOG_BIN_ARGS_WORDS, fmt, args);
+    psRec->len = (len <= GED_LOG_BIN_ARGS_WORDS) ? len : GED_LOG_BIN_TRUNCATED;
+    smp_wmb();
+    ACCESS_ONCE(psRec->seq) = (u32)(head + 1) << 1;
+    smp_wmb();
+    ACCESS_ONCE(psRing->head) = head + 1;
+    local_irq_restore(ulIRQFlags);
+#endif
+    return GED_OK;
+}
+
 static GED_ERROR __ged_log_buf_vprint(GED_LOG_BUF *psGEDLogBuf, const char *fmt, va_list args, int attrs)
 {
     int buf_n;
@@ -129,6 +219,9 @@ static GED_ERROR __ged_log_buf_vprint(GED_LOG_BUF *psGEDLogBuf, const char *fmt,
     if (!psGEDLogBuf)
         return GED_OK;
 
+    if (attrs & GED_LOG_ATTR_BINARY)
+        return __ged_log_buf_vprint_bin(psGEDLogBuf, fmt, args, attrs);
+
     spin_lock_irqsave(&psGEDLogBuf->sSpinLock, psGEDLogBuf->ui32IRQFlags);
 
     /* if OOM */
@@ -279,7 +372,15 @@ static int __ged_log_buf_write(GED_LOG_BUF *psGEDLogBuf, const char __user *pszB
 
     buf[cnt] = 0;
 
-    __ged_log_buf_print(psGEDLogBuf, buf);
+    if (psGEDLogBuf->attrs & GED_LOG_ATTR_BINARY)
+    {
+        /* the record keeps fmt, which must outlive the stack buffer */
+        __ged_log_buf_print(psGEDLogBuf, "%s", buf);
+    }
+    else
+    {
+        __ged_log_buf_print(psGEDLogBuf, buf);
+    }
 
     return cnt;
 }
@@ -383,11 +484,119 @@ static int ged_log_buf_seq_show_print(struct seq_file *psSeqFile, GED_LOG_BUF *p
     return err;
 }
 
+static void ged_log_bin_seq_show_print(struct seq_file *psSeqFile, GED_LOG_BIN_RECORD *psRec)
+{
+#ifdef CONFIG_BINARY_PRINTF
+    char acLine[256];
+    int len;
+
+    if (psRec->tattrs & (GED_LOG_ATTR_TIME | GED_LOG_ATTR_TIME_TPT))
+    {
+        unsigned long long t = psRec->time;
+        unsigned long nanosec_rem = do_div(t, 1000000000);
+
+        seq_printf(psSeqFile, "[%5llu.%06lu] ", t, nanosec_rem / 1000);
+    }
+
+    if (psRec->tattrs & GED_LOG_ATTR_TIME_TPT)
+    {
+        seq_printf(psSeqFile, "%5d %5d ", psRec->pid, psRec->tid);
+    }
+
+    if (psRec->len == GED_LOG_BIN_TRUNCATED)
+    {
+        seq_printf(psSeqFile, "(args too long) %s", psRec->fmt);
+        len = strlen(psRec->fmt);
+        if (!len || psRec->fmt[len - 1] != '\n')
+            seq_putc(psSeqFile, '\n');
+        return;
+    }
+
+    len = bstr_printf(acLine, sizeof(acLine), psRec->fmt, psRec->args);
+    len = min_t(int, len, sizeof(acLine) - 1);
+    if (len > 0 && acLine[len - 1] == '\n')
+        acLine[len - 1] = 0;
+    seq_printf(psSeqFile, "%s\n", acLine);
+#endif
+}
+
+/* merge the records of all cpus by time, skipping those overwritten meanwhile */
+static void ged_log_bin_seq_show(struct seq_file *psSeqFile, GED_LOG_BUF *psGEDLogBuf)
+{
+    u64 aui64Rec[GED_LOG_BIN_RECORD_SIZE / sizeof(u64)];
+    GED_LOG_BIN_RECORD *psCopy = (GED_LOG_BIN_RECORD *)aui64Rec;
+    u64 *pui64Cur, *pui64End;
+    int cpu;
+
+    /* may be called under the log list read lock */
+    pui64Cur = kcalloc(2 * nr_cpu_ids, sizeof(u64), GFP_ATOMIC);
+    if (!pui64Cur)
+        return;
+    pui64End = pui64Cur + nr_cpu_ids;
+
+    for_each_possible_cpu(cpu)
+    {
+        GED_LOG_BIN_RING *psRing = ged_log_bin_ring(psGEDLogBuf, cpu);
+        u64 tail = ACCESS_ONCE(psRing->tail);
+
+        pui64End[cpu] = ACCESS_ONCE(psRing->head);
+        pui64Cur[cpu] = pui64End[cpu] > psGEDLogBuf->i32LineCount ?
+            pui64End[cpu] - psGEDLogBuf->i32LineCount : 0;
+        if (tail > pui64Cur[cpu] && tail <= pui64End[cpu])
+            pui64Cur[cpu] = tail;
+    }
+    smp_rmb();
+
+    while (1)
+    {
+        GED_LOG_BIN_RECORD *psRec = NULL;
+        u64 time = ULLONG_MAX;
+        u32 seq;
+        int next = -1;
+
+        for_each_possible_cpu(cpu)
+        {
+            GED_LOG_BIN_RECORD *psCand;
+
+            if (pui64Cur[cpu] >= pui64End[cpu])
+                continue;
+            psCand = ged_log_bin_record(psGEDLogBuf, ged_log_bin_ring(psGEDLogBuf, cpu), pui64Cur[cpu]);
+            if (next < 0 || ACCESS_ONCE(psCand->time) < time)
+            {
+                next = cpu;
+                psRec = psCand;
+                time = ACCESS_ONCE(psCand->time);
+            }
+        }
+        if (next < 0)
+            break;
+
+        seq = ACCESS_ONCE(psRec->seq);
+        smp_rmb();
+        memcpy(psCopy, psRec, GED_LOG_BIN_RECORD_SIZE);
+        smp_rmb();
+        if (seq == (u32)(pui64Cur[next] + 1) << 1 && seq == ACCESS_ONCE(psRec->seq))
+            ged_log_bin_seq_show_print(psSeqFile, psCopy);
+        pui64Cur[next]++;
+    }
+
+    kfree(pui64Cur);
+}
+
 static int ged_log_buf_seq_show(struct seq_file *psSeqFile, void *pvData)
 {
     GED_LOG_BUF *psGEDLogBuf = (GED_LOG_BUF *)pvData;
 
-    if (psGEDLogBuf != NULL)
+    if (psGEDLogBuf != NULL && (psGEDLogBuf->attrs & GED_LOG_ATTR_BINARY))
+    {
+        if (psGEDLogBuf->acName[0] != '\0')
+        {
+            seq_printf(psSeqFile, "---------- %s (binary, %d x %d records) ----------\n",
+                    psGEDLogBuf->acName, num_possible_cpus(), psGEDLogBuf->i32LineCount);
+        }
+        ged_log_bin_seq_show(psSeqFile, psGEDLogBuf);
+    }
+    else if (psGEDLogBuf != NULL)
     {
         int i;
 
@@ -473,10 +682,33 @@ GED_LOG_BUF_HANDLE ged_log_buf_alloc(
         case GED_LOG_BUF_TYPE_QUEUEBUFFER_AUTO_INCREASE:
             psGEDLogBuf->attrs = GED_LOG_ATTR_QUEUEBUFFER | GED_LOG_ATTR_AUTO_INCREASE;
             break;
+        case GED_LOG_BUF_TYPE_BINARY_RINGBUFFER:
+#ifdef CONFIG_BINARY_PRINTF
+            psGEDLogBuf->attrs = GED_LOG_ATTR_RINGBUFFER | GED_LOG_ATTR_BINARY;
+#else
+            psGEDLogBuf->attrs = GED_LOG_ATTR_RINGBUFFER;
+#endif
+            break;
     }
 
-    psGEDLogBuf->i32MemorySize = i32MaxBufferSizeByte + sizeof(GED_LOG_BUF_LINE) * i32MaxLineCount;
-    psGEDLogBuf->pMemory = ged_alloc(psGEDLogBuf->i32MemorySize);
+    if (psGEDLogBuf->attrs & GED_LOG_ATTR_BINARY)
+    {
+        /* the lines are spread over the cpus, the byte size is not used */
+        int i32Records = rounddown_pow_of_two(max(i32MaxLineCount / (int)num_possible_cpus(), GED_LOG_BIN_MIN_RECORDS));
+
+        BUILD_BUG_ON(sizeof(GED_LOG_BIN_RING) > GED_LOG_BIN_HDR_SIZE);
+        psGEDLogBuf->i32MemorySize = nr_cpu_ids * (GED_LOG_BIN_HDR_SIZE + i32Records * GED_LOG_BIN_RECORD_SIZE);
+        psGEDLogBuf->pMemory = ged_alloc(psGEDLogBuf->i32MemorySize);
+        if (psGEDLogBuf->pMemory)
+            memset(psGEDLogBuf->pMemory, 0, psGEDLogBuf->i32MemorySize);
+        i32MaxLineCount = i32Records;
+        i32MaxBufferSizeByte = 0;
+    }
+    else
+    {
+        psGEDLogBuf->i32MemorySize = i32MaxBufferSizeByte + sizeof(GED_LOG_BUF_LINE) * i32MaxLineCount;
+        psGEDLogBuf->pMemory = ged_alloc(psGEDLogBuf->i32MemorySize);
+    }
     if (NULL == psGEDLogBuf->pMemory)
     {
         ged_free(psGEDLogBuf, sizeof(GED_LOG_BUF));
@@ -484,8 +716,16 @@ GED_LOG_BUF_HANDLE ged_log_buf_alloc(
         return (GED_LOG_BUF_HANDLE)0;
     }
 
-    psGEDLogBuf->psLine = (GED_LOG_BUF_LINE *)psGEDLogBuf->pMemory;
-    psGEDLogBuf->pcBuffer = (char *)&psGEDLogBuf->psLine[i32MaxLineCount];
+    if (psGEDLogBuf->attrs & GED_LOG_ATTR_BINARY)
+    {
+        psGEDLogBuf->psLine = NULL;
+        psGEDLogBuf->pcBuffer = NULL;
+    }
+    else
+    {
+        psGEDLogBuf->psLine = (GED_LOG_BUF_LINE *)psGEDLogBuf->pMemory;
+        psGEDLogBuf->pcBuffer = (char *)&psGEDLogBuf->psLine[i32MaxLineCount];
+    }
     psGEDLogBuf->i32LineCount = i32MaxLineCount;
     psGEDLogBuf->i32BufferSize = i32MaxBufferSizeByte;
     psGEDLogBuf->i32LineCurrent = 0;
@@ -497,6 +737,7 @@ GED_LOG_BUF_HANDLE ged_log_buf_alloc(
     psGEDLogBuf->acNodeName[0] = '\0';
 
     /* Init Line */
+    if (psGEDLogBuf->psLine)
     {
         int i = 0;
         for (i = 0; i < psGEDLogBuf->i32LineCount; ++i)
@@ -561,7 +802,8 @@ GED_ERROR ged_log_buf_resize(
     GED_LOG_BUF_LINE *pi32NewLine;
     char *pcNewBuffer;
 
-    if ((NULL == psGEDLogBuf) || (i32NewMaxLineCount <= 0) || (i32NewMaxBufferSizeByte <= 0))
+    if ((NULL == psGEDLogBuf) || (i32NewMaxLineCount <= 0) || (i32NewMaxBufferSizeByte <= 0) ||
+        (psGEDLogBuf->attrs & GED_LOG_ATTR_BINARY))
     {
         return GED_ERROR_INVALID_PARAMS;
     }
@@ -806,7 +1048,19 @@ GED_ERROR ged_log_buf_print2(GED_LOG_BUF_HANDLE hLogBuf, int i32LogAttrs, const
 GED_ERROR ged_log_buf_reset(GED_LOG_BUF_HANDLE hLogBuf)
 {
     GED_LOG_BUF *psGEDLogBuf = ged_log_buf_from_handle(hLogBuf);
-    if (psGEDLogBuf)
+    if (psGEDLogBuf && (psGEDLogBuf->attrs & GED_LOG_ATTR_BINARY))
+    {
+        int cpu;
+
+        /* writers own the heads, hide what they wrote so far */
+        for_each_possible_cpu(cpu)
+        {
+            GED_LOG_BIN_RING *psRing = ged_log_bin_ring(psGEDLogBuf, cpu);
+
+            ACCESS_ONCE(psRing->tail) = ACCESS_ONCE(psRing->head);
+        }
+    }
+    else if (psGEDLogBuf)
     {
         int i;
         spin_lock_irqsave(&psGEDLogBuf->sSpinLock, psGEDLogBuf->ui32IRQFlags);
@@ -16,6 +16,8 @@
 #include <linux/sched.h>
 #include <asm/atomic.h>
 #include <linux/module.h>
+#include <linux/cred.h>
+#include <linux/uid_cputime.h>
 
 #if (LINUX_VERSION_CODE < KERNEL_VERSION(3,10,0))
 #include <linux/sync.h>
@@ -58,6 +60,11 @@ typedef struct GED_MONITOR_3D_FENCE_TAG
     struct sync_fence_waiter    sSyncWaiter;
 	struct work_struct          sWork;
     struct sync_fence*          psSyncFence;
+    unsigned long               ulSubmitTS_us;
+    unsigned long               ulBusy_us;
+    pid_t                       pid;
+    kuid_t                      uid;
+    char                        acComm[TASK_COMM_LEN];
 } GED_MONITOR_3D_FENCE;
 
 static void ged_sync_cb(struct sync_fence *fence, struct sync_fence_waiter *waiter)
@@ -75,6 +82,7 @@ static void ged_sync_cb(struct sync_fence *fence, struct sync_fence_waiter *wait
     ged_dvfs_cal_gpu_utilization_force();
 #endif	
 	psMonitor = GED_CONTAINER_OF(waiter, GED_MONITOR_3D_FENCE, sSyncWaiter);
+	psMonitor->ulBusy_us = ged_dvfs_frame_done(psMonitor->ulSubmitTS_us, (unsigned long)t, psMonitor->pid, psMonitor->acComm);
     
     ged_log_buf_print(ghLogBuf_DVFS, "[-] ged_monitor_3D_fence_done (ts=%llu) %p", t, psMonitor->psSyncFence);
     
@@ -124,6 +132,7 @@ static void ged_monitor_3D_fence_work_cb(struct work_struct *psWork)
     }
 
 	psMonitor = GED_CONTAINER_OF(psWork, GED_MONITOR_3D_FENCE, sWork);
+	uid_cputime_add_gpu(psMonitor->uid, psMonitor->ulBusy_us);
     sync_fence_put(psMonitor->psSyncFence);
     ged_free(psMonitor, sizeof(GED_MONITOR_3D_FENCE));
 }
@@ -162,6 +171,10 @@ GED_ERROR ged_monitor_3D_fence_add(int fence_fd)
 
     sync_fence_waiter_init(&psMonitor->sSyncWaiter, ged_sync_cb);
     INIT_WORK(&psMonitor->sWork, ged_monitor_3D_fence_work_cb);
+    psMonitor->ulSubmitTS_us = (unsigned long)t;
+    psMonitor->pid = current->tgid;
+    psMonitor->uid = current_uid();
+    get_task_comm(psMonitor->acComm, current->group_leader);
     psMonitor->psSyncFence = sync_fence_fdget(fence_fd);
     if (NULL == psMonitor->psSyncFence)
     {
@@ -962,6 +962,18 @@ copy_failed:
 			break;
 		}
 
+	case KBASE_FUNC_SET_PRIORITY:
+		{
+			struct kbase_uk_set_priority *sprio = args;
+
+			if (sizeof(*sprio) != args_size)
+				goto bad_size;
+
+			if (MALI_ERROR_NONE != kbasep_js_set_ctx_priority(kctx, sprio->realtime != 0, sprio->priority))
+				ukh->ret = MALI_ERROR_FUNCTION_FAILED;
+			break;
+		}
+
 	case KBASE_FUNC_POST_TERM:
 		{
 			kbase_event_close(kctx);
@@ -495,6 +495,7 @@ enum hrtimer_restart kbasep_reset_timer_callback(struct hrtimer *data);
 struct kbasep_mem_device {
 	atomic_t used_pages;   /* Tracks usage of OS shared memory. Updated
 				   when OS memory is allocated/freed. */
+	struct kbase_mem_pool pool;	/* zeroed pages for all contexts */
 
 };
 
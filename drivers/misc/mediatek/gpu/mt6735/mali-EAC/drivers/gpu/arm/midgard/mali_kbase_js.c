@@ -29,6 +29,7 @@
 #include "mali_kbase_jm.h"
 #include <mali_kbase_defs.h>
 #include <mali_kbase_config_defaults.h>
+#include <linux/capability.h>
 
 /*
  * Private types
@@ -679,6 +680,39 @@ void kbasep_js_kctx_term(struct kbase_context *kctx)
 	js_kctx_info->init_status = JS_KCTX_INIT_NONE;
 }
 
+mali_error kbasep_js_set_ctx_priority(struct kbase_context *kctx, mali_bool realtime, int priority)
+{
+	unsigned long flags;
+	struct kbase_device *kbdev;
+	struct kbasep_js_kctx_info *js_kctx_info;
+	struct kbasep_js_device_data *js_devdata;
+	mali_bool may_raise;
+	mali_error err;
+
+	KBASE_DEBUG_ASSERT(kctx != NULL);
+
+	if (priority < -20 || priority > 19)
+		return MALI_ERROR_FUNCTION_FAILED;
+
+	kbdev = kctx->kbdev;
+	js_devdata = &kbdev->js_data;
+	js_kctx_info = &kctx->jctx.sched_info;
+
+	/* Same rule as for CPU priorities: anyone may lower their priority,
+	 * raising it needs CAP_SYS_NICE */
+	may_raise = capable(CAP_SYS_NICE) ? MALI_TRUE : MALI_FALSE;
+
+	mutex_lock(&js_kctx_info->ctx.jsctx_mutex);
+	spin_lock_irqsave(&js_devdata->runpool_irq.lock, flags);
+
+	err = kbasep_js_policy_set_ctx_priority(&js_devdata->policy, kctx, realtime, priority, may_raise);
+
+	spin_unlock_irqrestore(&js_devdata->runpool_irq.lock, flags);
+	mutex_unlock(&js_kctx_info->ctx.jsctx_mutex);
+
+	return err;
+}
+
 /* Evict jobs from the NEXT registers
  *
  * The caller must hold:
@@ -914,6 +948,10 @@ mali_bool kbasep_js_add_job(struct kbase_context *kctx, struct kbase_jd_atom *at
 		 * matches requirements that aren't matched by any other job in the Run
 		 * Pool */
 		kbasep_js_try_run_next_job_nolock(kbdev);
+
+		/* A realtime job that found every slot busy kicks lower priority
+		 * work off rather than waiting for a timeslice to end */
+		kbasep_js_policy_preempt_for_job(js_policy, atom);
 	}
 	spin_unlock_irqrestore(&js_devdata->runpool_irq.lock, flags);
 	mutex_unlock(&js_devdata->runpool_mutex);
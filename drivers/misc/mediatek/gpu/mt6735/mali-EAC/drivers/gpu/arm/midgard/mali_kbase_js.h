@@ -124,6 +124,21 @@ mali_error kbasep_js_kctx_init(struct kbase_context * const kctx);
  */
 void kbasep_js_kctx_term(struct kbase_context *kctx);
 
+/**
+ * @brief Set the scheduling priority of a struct kbase_context
+ *
+ * \a realtime puts the context's jobs ahead of all non-realtime contexts,
+ * \a priority is a NICE value in [-20, 19] used to weight its runtime.
+ * Raising either needs CAP_SYS_NICE.
+ *
+ * The caller must \em not hold kbasep_js_kctx_info::ctx::jsctx_mutex or
+ * kbasep_js_device_data::runpool_irq::lock.
+ *
+ * @return MALI_ERROR_NONE on success, MALI_ERROR_FUNCTION_FAILED if the
+ * priority is out of range or not permitted.
+ */
+mali_error kbasep_js_set_ctx_priority(struct kbase_context *kctx, mali_bool realtime, int priority);
+
 /**
  * @brief Add a job chain to the Job Scheduler, and take necessary actions to
  * schedule the context/run the job.
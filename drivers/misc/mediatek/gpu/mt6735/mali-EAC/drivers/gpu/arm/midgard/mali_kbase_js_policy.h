@@ -600,6 +600,38 @@ void kbasep_js_policy_runpool_timers_sync(union kbasep_js_policy *js_policy);
  */
 mali_bool kbasep_js_policy_ctx_has_priority(union kbasep_js_policy *js_policy, struct kbase_context *current_ctx, struct kbase_context *new_ctx);
 
+/**
+ * @brief Change the scheduling priority of a context.
+ *
+ * \a realtime selects the realtime queue of the policy, \a priority is a
+ * NICE value in the range [-20, 19]. The new priority is applied straight
+ * away if the context is in the runpool, otherwise the next time it is
+ * scheduled in. Unless \a may_raise is set, the priority can only be lowered.
+ *
+ * The caller has the following conditions on locking:
+ * - kbasep_js_kctx_info::ctx::jsctx_mutex will be held.
+ * - kbasep_js_device_data::runpool_irq::lock will be held.
+ *
+ * @return MALI_ERROR_FUNCTION_FAILED if the change would raise the priority
+ * and \a may_raise is not set, MALI_ERROR_NONE otherwise.
+ */
+mali_error kbasep_js_policy_set_ctx_priority(union kbasep_js_policy *js_policy, struct kbase_context *kctx, mali_bool realtime, int priority, mali_bool may_raise);
+
+/**
+ * @brief Make room on the GPU for a newly added realtime job.
+ *
+ * Called after \a katom has been enqueued for a context that is already in
+ * the runpool. If \a katom belongs to a realtime context and every job slot
+ * it can run on is busy with non-realtime work, the policy may soft-stop
+ * that work rather than waiting for the scheduling timer to do so.
+ *
+ * The caller has the following conditions on locking:
+ * - kbasep_js_device_data::runpool_irq::lock will be held.
+ *
+ * This function must not sleep.
+ */
+void kbasep_js_policy_preempt_for_job(union kbasep_js_policy *js_policy, struct kbase_jd_atom *katom);
+
 	  /** @} *//* end group kbase_js_policy_ctx */
 
 /**
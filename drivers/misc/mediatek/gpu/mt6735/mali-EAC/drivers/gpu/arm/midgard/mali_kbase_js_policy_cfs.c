@@ -47,6 +47,11 @@
 #define PROCESS_PRIORITY_MIN (-20)
 #define PROCESS_PRIORITY_MAX  (19)
 
+/* NICE priority at or below which a non-realtime process is still given the
+ * realtime queue. This is Android's PRIORITY_URGENT_DISPLAY, which the
+ * compositor runs at, so its frames are not queued behind application work */
+#define PROCESS_PRIORITY_URGENT (-8)
+
 /** Core requirements that all the variants support */
 #define JS_CORE_REQ_ALL_OTHERS \
 	(BASE_JD_REQ_CF | BASE_JD_REQ_V | BASE_JD_REQ_PERMON | BASE_JD_REQ_EXTERNAL_RESOURCES | BASEP_JD_REQ_EVENT_NEVER)
@@ -539,6 +544,33 @@ STATIC void build_slot_lookups(struct kbase_device *kbdev, struct kbasep_js_poli
 
 }
 
+STATIC u32 slot_variants_supported(struct kbase_device *kbdev, struct kbasep_js_policy_cfs *policy_info, int job_slot_idx)
+{
+	if (kbdev->gpu_props.num_core_groups > 1 && kbasep_js_ctx_attr_is_attr_on_runpool(kbdev, KBASEP_JS_CTX_ATTR_COMPUTE_ALL_CORES) != MALI_FALSE) {
+		/* SS-allcore state, and there's more than one coregroup */
+		return get_slot_to_variant_lookup(policy_info->slot_to_variant_lookup_ss_allcore_state, job_slot_idx);
+	}
+
+	/* SS-state */
+	return get_slot_to_variant_lookup(policy_info->slot_to_variant_lookup_ss_state, job_slot_idx);
+}
+
+/**
+ * Apply a priority requested by kbasep_js_policy_set_ctx_priority().
+ *
+ * Must only be called whilst the ctx is not in a policy queue, as the queue it
+ * belongs to depends on process_rt_policy.
+ */
+STATIC void apply_requested_priority(struct kbasep_js_policy_cfs_ctx *ctx_info)
+{
+	if (ctx_info->priority_pending == MALI_FALSE)
+		return;
+
+	ctx_info->process_rt_policy = ctx_info->requested_rt_policy;
+	ctx_info->process_priority = ctx_info->requested_priority;
+	ctx_info->priority_pending = MALI_FALSE;
+}
+
 STATIC mali_error cached_variant_idx_init(const struct kbasep_js_policy_cfs *policy_info, const struct kbase_context *kctx, struct kbase_jd_atom *atom)
 {
 	struct kbasep_js_policy_cfs_job *job_info;
@@ -909,10 +941,14 @@ mali_error kbasep_js_policy_init_ctx(struct kbase_device *kbdev, struct kbase_co
 		ctx_info->process_rt_policy = MALI_TRUE;
 		ctx_info->process_priority = (((MAX_RT_PRIO - 1) - current->rt_priority) / 5) - 20;
 	} else {
-		ctx_info->process_rt_policy = MALI_FALSE;
 		ctx_info->process_priority = (current->static_prio - MAX_RT_PRIO) - 20;
+		ctx_info->process_rt_policy = (ctx_info->process_priority <= PROCESS_PRIORITY_URGENT) ? MALI_TRUE : MALI_FALSE;
 	}
 
+	ctx_info->requested_rt_policy = ctx_info->process_rt_policy;
+	ctx_info->requested_priority = ctx_info->process_priority;
+	ctx_info->priority_pending = MALI_FALSE;
+
 	ctx_info->bag_total_priority = 0;
 	ctx_info->bag_total_nr_atoms = 0;
 
@@ -1208,6 +1244,10 @@ void kbasep_js_policy_runpool_add_ctx(union kbasep_js_policy *js_policy, struct
 	/* ASSERT about scheduled-ness/queued-ness */
 	kbasep_js_debug_check(policy_info, kctx, KBASEP_JS_CHECK_NOTSCHEDULED);
 
+	/* The ctx has left the policy queue, so a pending priority change can't
+	 * upset the queue it was on */
+	apply_requested_priority(&kctx->jctx.sched_info.runpool.policy_ctx.cfs);
+
 	/* All enqueued contexts go to the back of the runpool */
 	list_add_tail(&kctx->jctx.sched_info.runpool.policy_ctx.cfs.list, &policy_info->scheduled_ctxs_head);
 
@@ -1387,13 +1427,7 @@ mali_bool kbasep_js_policy_dequeue_job(struct kbase_device *kbdev,
 	policy_info = &js_devdata->policy.cfs;
 
 	/* Get the variants for this slot */
-	if (kbdev->gpu_props.num_core_groups > 1 && kbasep_js_ctx_attr_is_attr_on_runpool(kbdev, KBASEP_JS_CTX_ATTR_COMPUTE_ALL_CORES) != MALI_FALSE) {
-		/* SS-allcore state, and there's more than one coregroup */
-		variants_supported = get_slot_to_variant_lookup(policy_info->slot_to_variant_lookup_ss_allcore_state, job_slot_idx);
-	} else {
-		/* SS-state */
-		variants_supported = get_slot_to_variant_lookup(policy_info->slot_to_variant_lookup_ss_state, job_slot_idx);
-	}
+	variants_supported = slot_variants_supported(kbdev, policy_info, job_slot_idx);
 
 	/* First pass through the runpool we consider the realtime priority jobs */
 	list_for_each(pos, &policy_info->scheduled_ctxs_head) {
@@ -1480,3 +1514,112 @@ mali_bool kbasep_js_policy_ctx_has_priority(union kbasep_js_policy *js_policy, s
 
 	return MALI_FALSE;
 }
+
+mali_error kbasep_js_policy_set_ctx_priority(union kbasep_js_policy *js_policy, struct kbase_context *kctx, mali_bool realtime, int priority, mali_bool may_raise)
+{
+	struct kbasep_js_policy_cfs_ctx *ctx_info;
+
+	KBASE_DEBUG_ASSERT(js_policy != NULL);
+	KBASE_DEBUG_ASSERT(kctx != NULL);
+	CSTD_UNUSED(js_policy);
+
+	ctx_info = &kctx->jctx.sched_info.runpool.policy_ctx.cfs;
+
+	if (may_raise == MALI_FALSE &&
+	    ((realtime != MALI_FALSE && ctx_info->requested_rt_policy == MALI_FALSE) ||
+	     priority < ctx_info->requested_priority))
+		return MALI_ERROR_FUNCTION_FAILED;
+
+	ctx_info->requested_rt_policy = realtime;
+	ctx_info->requested_priority = priority;
+	ctx_info->priority_pending = MALI_TRUE;
+
+	/* With the jsctx_mutex held, a scheduled ctx is only on the runpool list
+	 * and can take the new priority now. Otherwise it might be queued, so
+	 * wait until kbasep_js_policy_runpool_add_ctx() */
+	if (kctx->jctx.sched_info.ctx.is_scheduled != MALI_FALSE)
+		apply_requested_priority(ctx_info);
+
+	return MALI_ERROR_NONE;
+}
+
+void kbasep_js_policy_preempt_for_job(union kbasep_js_policy *js_policy, struct kbase_jd_atom *katom)
+{
+#if !KBASE_DISABLE_SCHEDULING_SOFT_STOPS && !CINSTR_DUMPING_ENABLED
+	struct kbase_device *kbdev;
+	struct kbasep_js_device_data *js_devdata;
+	struct kbasep_js_policy_cfs *policy_info;
+	struct kbase_jd_atom *victim = NULL;
+	int victim_slot = 0;
+	u32 softstop_flags = 0u;
+	int s;
+
+	KBASE_DEBUG_ASSERT(js_policy != NULL);
+	KBASE_DEBUG_ASSERT(katom != NULL);
+
+	kbdev = container_of(js_policy, struct kbase_device, js_data.policy);
+	js_devdata = &kbdev->js_data;
+	policy_info = &js_policy->cfs;
+
+	lockdep_assert_held(&js_devdata->runpool_irq.lock);
+
+	if (katom->kctx->jctx.sched_info.runpool.policy_ctx.cfs.process_rt_policy == MALI_FALSE)
+		return;
+
+	/* The current version of the model doesn't support Soft-Stop */
+	if (kbase_hw_has_issue(kbdev, BASE_HW_ISSUE_5736))
+		return;
+
+	for (s = 0; s < kbdev->gpu_props.num_job_slots; s++) {
+		struct kbase_jm_slot *slot = &kbdev->jm_slots[s];
+		struct kbase_jd_atom *head;
+		int i;
+
+		/* Already submitted by kbasep_js_try_run_next_job_nolock() */
+		for (i = 0; i < kbasep_jm_nr_jobs_submitted(slot); i++) {
+			if (kbasep_jm_peek_idx_submit_slot(slot, i) == katom)
+				return;
+		}
+
+		if (!(slot_variants_supported(kbdev, policy_info, s) & (1u << katom->sched_info.cfs.cached_variant_idx)))
+			continue;
+
+		/* An idle slot will pick the job up straight away */
+		if (kbasep_jm_nr_jobs_submitted(slot) == 0)
+			return;
+
+		if (victim != NULL)
+			continue;
+
+		head = kbasep_jm_peek_idx_submit_slot(slot, 0);
+		if (kbasep_jm_is_dummy_workaround_job(kbdev, head) != MALI_FALSE)
+			continue;
+
+		if (head->kctx->jctx.sched_info.runpool.policy_ctx.cfs.process_rt_policy != MALI_FALSE)
+			continue;
+
+		/* Each atom is only preempted once, so back to back realtime work
+		 * can't keep restarting the same job; the scheduling timer deals
+		 * with it from then on */
+		if (head->atom_flags & KBASE_KATOM_FLAG_BEEN_SOFT_STOPPPED)
+			continue;
+
+		victim = head;
+		victim_slot = s;
+	}
+
+	if (victim == NULL)
+		return;
+
+	dev_dbg(kbdev->dev, "Soft-stop for realtime ctx %p", (void *)katom->kctx);
+
+	/* See timer_callback() for why reading nr_user_contexts_running here
+	 * without the runpool_mutex is fine */
+	if (js_devdata->nr_user_contexts_running >= KBASE_DISJOINT_STATE_INTERLEAVED_CONTEXT_COUNT_THRESHOLD)
+		softstop_flags |= JS_COMMAND_SW_CAUSES_DISJOINT;
+	kbase_job_slot_softstop_swflags(kbdev, victim_slot, victim, softstop_flags);
+#else
+	CSTD_UNUSED(js_policy);
+	CSTD_UNUSED(katom);
+#endif
+}
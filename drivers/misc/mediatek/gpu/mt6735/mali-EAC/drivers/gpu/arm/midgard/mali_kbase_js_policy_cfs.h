@@ -131,10 +131,18 @@ typedef struct kbasep_js_policy_cfs_ctx {
 	u64 runtime_us;
 
 	/* Calling process policy scheme is a realtime scheduler and will use the priority queue
-	 * Non-mutable after ctx init */
+	 * Only changed while the ctx is not in a policy queue, with the
+	 * kbasep_js_device_data::runpool_irq::lock held */
 	mali_bool process_rt_policy;
 	/* Calling process NICE priority */
 	int process_priority;
+	/* Priority requested through kbasep_js_policy_set_ctx_priority(), applied
+	 * to process_rt_policy/process_priority the next time the ctx is known not
+	 * to be queued. Hold the kbasep_js_device_data::runpool_irq::lock when
+	 * accessing */
+	mali_bool requested_rt_policy;
+	int requested_priority;
+	mali_bool priority_pending;
 	/* Average NICE priority of all atoms in bag:
 	 * Hold the kbasep_js_kctx_info::ctx::jsctx_mutex when accessing  */
 	int bag_priority;
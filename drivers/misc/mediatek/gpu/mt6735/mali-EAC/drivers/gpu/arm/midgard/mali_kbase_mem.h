@@ -254,6 +254,8 @@ typedef struct kbase_va_region {
 	unsigned long flags;
 
 	size_t extent; /* nr of pages alloc'd on PF */
+	size_t grow_pages; /* nr of pages the last PF grew the region by */
+	unsigned long last_grow; /* jiffies of the last PF growth */
 
 	struct kbase_mem_phy_alloc * alloc; /* the one alloc object we mmap to the GPU and CPU when mapping this region */
 
@@ -29,14 +29,190 @@
 #include <linux/atomic.h>
 #include <linux/version.h>
 
+/*
+ * Device page pool
+ *
+ * Growing a tiler heap on GPU page fault used to allocate, zero and clean
+ * every page in the fault worker while the GPU is stalled.  Contexts now
+ * take pages their own free list cannot serve from a per device pool of
+ * pages that are already zeroed and mapped for DMA.  The pool is topped up
+ * by a background work item once it drops below half full and gives its
+ * pages back to the system under memory pressure.
+ */
+#define KBASE_MEM_POOL_MAX_PAGES	1024
+#define KBASE_MEM_POOL_REFILL_BATCH	32
+
+static struct page *kbase_mem_page_alloc(struct kbase_device *kbdev, gfp_t gfp)
+{
+	struct page *p;
+	void *mp;
+	dma_addr_t dma_addr;
+
+	p = alloc_page(gfp);
+	if (NULL == p)
+		return NULL;
+	mp = kmap(p);
+	if (NULL == mp) {
+		__free_page(p);
+		return NULL;
+	}
+	memset(mp, 0x00, PAGE_SIZE); /* instead of __GFP_ZERO, so we can do cache maintenance */
+	kunmap(p);
+
+	dma_addr = dma_map_page(kbdev->dev, p, 0, PAGE_SIZE, DMA_BIDIRECTIONAL);
+	if (dma_mapping_error(kbdev->dev, dma_addr)) {
+		__free_page(p);
+		return NULL;
+	}
+
+	SetPagePrivate(p);
+	kbase_set_dma_addr(p, dma_addr);
+	BUG_ON(dma_addr != PFN_PHYS(page_to_pfn(p)));
+	return p;
+}
+
+static void kbase_mem_page_free(struct kbase_device *kbdev, struct page *p)
+{
+	dma_unmap_page(kbdev->dev, kbase_dma_addr(p), PAGE_SIZE,
+		       DMA_BIDIRECTIONAL);
+	ClearPagePrivate(p);
+	__free_page(p);
+}
+
+static void kbase_mem_pool_refill_worker(struct work_struct *data)
+{
+	struct kbase_mem_pool *pool;
+	gfp_t gfp = GFP_HIGHUSER | __GFP_NORETRY | __GFP_NOWARN;
+
+	pool = container_of(data, struct kbase_mem_pool, refill_work);
+
+	while (ACCESS_ONCE(pool->cur_size) < pool->max_size) {
+		LIST_HEAD(batch);
+		struct page *p;
+		size_t i;
+
+		for (i = 0; i < KBASE_MEM_POOL_REFILL_BATCH; i++) {
+			p = kbase_mem_page_alloc(pool->kbdev, gfp);
+			if (NULL == p)
+				break;
+			list_add(&p->lru, &batch);
+		}
+
+		spin_lock(&pool->lock);
+		list_splice(&batch, &pool->page_list);
+		pool->cur_size += i;
+		spin_unlock(&pool->lock);
+
+		/* out of memory, try again on the next take */
+		if (i < KBASE_MEM_POOL_REFILL_BATCH)
+			break;
+	}
+}
+
+/* returns the number of pages placed in pages[], at most nr_pages */
+static size_t kbase_mem_pool_take(struct kbase_mem_pool *pool, size_t nr_pages, phys_addr_t *pages)
+{
+	struct page *p;
+	size_t i;
+
+	spin_lock(&pool->lock);
+	nr_pages = MIN(nr_pages, pool->cur_size);
+	for (i = 0; i < nr_pages; i++) {
+		p = list_first_entry(&pool->page_list, struct page, lru);
+		list_del(&p->lru);
+		pages[i] = PFN_PHYS(page_to_pfn(p));
+	}
+	pool->cur_size -= nr_pages;
+	if (pool->cur_size < pool->max_size / 2)
+		queue_work(system_unbound_wq, &pool->refill_work);
+	spin_unlock(&pool->lock);
+
+	return nr_pages;
+}
+
+static unsigned long kbase_mem_pool_count(struct shrinker *s,
+						struct shrink_control *sc)
+{
+	struct kbase_mem_pool *pool;
+
+	pool = container_of(s, struct kbase_mem_pool, reclaimer);
+	return ACCESS_ONCE(pool->cur_size);
+}
+
+static unsigned long kbase_mem_pool_scan(struct shrinker *s,
+						struct shrink_control *sc)
+{
+	struct kbase_mem_pool *pool;
+	LIST_HEAD(reclaim);
+	struct page *p, *tmp;
+	unsigned long freed;
+
+	pool = container_of(s, struct kbase_mem_pool, reclaimer);
+
+	spin_lock(&pool->lock);
+	for (freed = 0; freed < sc->nr_to_scan && pool->cur_size; freed++) {
+		p = list_first_entry(&pool->page_list, struct page, lru);
+		list_move(&p->lru, &reclaim);
+		pool->cur_size--;
+	}
+	spin_unlock(&pool->lock);
+
+	list_for_each_entry_safe(p, tmp, &reclaim, lru)
+		kbase_mem_page_free(pool->kbdev, p);
+
+	return freed;
+}
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(3, 12, 0)
+static int kbase_mem_pool_shrink(struct shrinker *s,
+		struct shrink_control *sc)
+{
+	if (sc->nr_to_scan)
+		kbase_mem_pool_scan(s, sc);
+	return kbase_mem_pool_count(s, sc);
+}
+#endif
+
 int kbase_mem_lowlevel_init(struct kbase_device *kbdev)
 {
+	struct kbase_mem_pool *pool = &kbdev->memdev.pool;
+
+	pool->kbdev = kbdev;
+	spin_lock_init(&pool->lock);
+	INIT_LIST_HEAD(&pool->page_list);
+	pool->cur_size = 0;
+	pool->max_size = KBASE_MEM_POOL_MAX_PAGES;
+	INIT_WORK(&pool->refill_work, kbase_mem_pool_refill_worker);
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(3, 12, 0)
+	pool->reclaimer.shrink = kbase_mem_pool_shrink;
+#else
+	pool->reclaimer.count_objects = kbase_mem_pool_count;
+	pool->reclaimer.scan_objects = kbase_mem_pool_scan;
+#endif
+	pool->reclaimer.seeks = DEFAULT_SEEKS;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 1, 0)
+	pool->reclaimer.batch = 0;
+#endif
+	register_shrinker(&pool->reclaimer);
+
+	/* filled by the first allocation, nothing is held for an unused GPU */
 	return 0;
 }
 
 void kbase_mem_lowlevel_term(struct kbase_device *kbdev)
 {
-	return;
+	struct kbase_mem_pool *pool = &kbdev->memdev.pool;
+	struct page *p, *tmp;
+
+	unregister_shrinker(&pool->reclaimer);
+	cancel_work_sync(&pool->refill_work);
+
+	list_for_each_entry_safe(p, tmp, &pool->page_list, lru) {
+		list_del(&p->lru);
+		kbase_mem_page_free(kbdev, p);
+	}
+	pool->cur_size = 0;
 }
 
 static unsigned long kbase_mem_allocator_count(struct shrinker *s,
@@ -153,7 +329,6 @@ KBASE_EXPORT_TEST_API(kbase_mem_allocator_term)
 mali_error kbase_mem_allocator_alloc(struct kbase_mem_allocator *allocator, size_t nr_pages, phys_addr_t *pages)
 {
 	struct page *p;
-	void *mp;
 	int i;
 	int num_from_free_list;
 	struct list_head from_free_list = LIST_HEAD_INIT(from_free_list);
@@ -185,6 +360,12 @@ mali_error kbase_mem_allocator_alloc(struct kbase_mem_allocator *allocator, size
 	if (i == nr_pages)
 		return MALI_ERROR_NONE;
 
+	/* Then from the zeroed pages of the device. */
+	i += kbase_mem_pool_take(&allocator->kbdev->memdev.pool, nr_pages - i, pages + i);
+
+	if (i == nr_pages)
+		return MALI_ERROR_NONE;
+
 #if defined(CONFIG_ARM) && !defined(CONFIG_HAVE_DMA_ATTRS) && LINUX_VERSION_CODE < KERNEL_VERSION(3, 5, 0)
 	/* DMA cache sync fails for HIGHMEM before 3.5 on ARM */
 	gfp = GFP_USER;
@@ -200,29 +381,10 @@ mali_error kbase_mem_allocator_alloc(struct kbase_mem_allocator *allocator, size
 
 	/* If not all pages were sourced from the pool, request new ones. */
 	for (; i < nr_pages; i++) {
-		dma_addr_t dma_addr;
-		p = alloc_page(gfp);
+		p = kbase_mem_page_alloc(allocator->kbdev, gfp);
 		if (NULL == p)
 			goto err_out_roll_back;
-		mp = kmap(p);
-		if (NULL == mp) {
-			__free_page(p);
-			goto err_out_roll_back;
-		}
-		memset(mp, 0x00, PAGE_SIZE); /* instead of __GFP_ZERO, so we can do cache maintenance */
-		kunmap(p);
-
-		dma_addr = dma_map_page(allocator->kbdev->dev, p, 0, PAGE_SIZE,
-				        DMA_BIDIRECTIONAL);
-		if (dma_mapping_error(allocator->kbdev->dev, dma_addr)) {
-			__free_page(p);
-			goto err_out_roll_back;
-		}
-
-		SetPagePrivate(p);
-		kbase_set_dma_addr(p, dma_addr);
 		pages[i] = PFN_PHYS(page_to_pfn(p));
-		BUG_ON(dma_addr != pages[i]);
 	}
 
 	return MALI_ERROR_NONE;
@@ -20,6 +20,7 @@
 #include <linux/atomic.h>
 #include <linux/mempool.h>
 #include <linux/slab.h>
+#include <linux/workqueue.h>
 
 /* raw page handling */
 struct kbase_mem_allocator
@@ -31,3 +32,15 @@ struct kbase_mem_allocator
 	struct list_head    free_list_head;
 	struct shrinker     free_list_reclaimer;
 };
+
+/* pre-zeroed pages shared by all contexts of a device, refilled in the background */
+struct kbase_mem_pool
+{
+	struct kbase_device *kbdev;
+	spinlock_t          lock;
+	struct list_head    page_list;
+	size_t              cur_size;
+	size_t              max_size;
+	struct work_struct  refill_work;
+	struct shrinker     reclaimer;
+};
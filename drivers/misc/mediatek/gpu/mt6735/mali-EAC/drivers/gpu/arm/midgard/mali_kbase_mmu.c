@@ -92,11 +92,30 @@ static size_t make_multiple(size_t minimum, size_t multiple)
 		return minimum + multiple - remainder;
 }
 
+/* A heap faulting again within the window grows twice as much as last time */
+#define KBASE_FAULT_GROW_WINDOW_MS	100
+#define KBASE_FAULT_GROW_MAX_PAGES	512
+
+static size_t kbase_mmu_fault_grow_pages(struct kbase_va_region *region, size_t minimum)
+{
+	size_t chunk = region->extent;
+
+	if (region->grow_pages && time_before(jiffies, region->last_grow +
+				msecs_to_jiffies(KBASE_FAULT_GROW_WINDOW_MS)))
+		chunk = MIN(region->grow_pages * 2,
+			    MAX(region->extent, (size_t)KBASE_FAULT_GROW_MAX_PAGES));
+
+	region->grow_pages = chunk;
+	region->last_grow = jiffies;
+
+	return make_multiple(MAX(minimum, chunk), region->extent);
+}
+
 static void page_fault_worker(struct work_struct *data)
 {
 	u64 fault_pfn;
 	u32 fault_access;
-	size_t new_pages;
+	size_t new_pages, min_pages;
 	size_t fault_rel_pfn;
 	struct kbase_as *faulting_as;
 	int as_no;
@@ -208,11 +227,16 @@ static void page_fault_worker(struct work_struct *data)
 		goto fault_done;
 	}
 
-	new_pages = make_multiple(fault_rel_pfn -
+	min_pages = make_multiple(fault_rel_pfn -
 			kbase_reg_current_backed_size(region) + 1,
 			region->extent);
+	new_pages = kbase_mmu_fault_grow_pages(region, min_pages);
 
 	/* cap to max vsize */
+	if (min_pages + kbase_reg_current_backed_size(region) >
+			region->nr_pages)
+		min_pages = region->nr_pages -
+				kbase_reg_current_backed_size(region);
 	if (new_pages + kbase_reg_current_backed_size(region) >
 			region->nr_pages)
 		new_pages = region->nr_pages -
@@ -231,7 +255,15 @@ static void page_fault_worker(struct work_struct *data)
 		goto fault_done;
 	}
 
-	if (MALI_ERROR_NONE == kbase_alloc_phy_pages_helper(region->alloc, new_pages)) {
+	err = kbase_alloc_phy_pages_helper(region->alloc, new_pages);
+	if (MALI_ERROR_NONE != err && new_pages > min_pages) {
+		/* no memory for the larger chunk, settle for what the fault needs */
+		new_pages = min_pages;
+		region->grow_pages = 0;
+		err = kbase_alloc_phy_pages_helper(region->alloc, new_pages);
+	}
+
+	if (MALI_ERROR_NONE == err) {
 		u32 op;
 
 		/* alloc success */
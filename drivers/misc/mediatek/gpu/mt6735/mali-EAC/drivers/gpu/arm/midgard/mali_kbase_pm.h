@@ -42,6 +42,7 @@ struct kbase_device;
 #include "mali_kbase_pm_always_on.h"
 #include "mali_kbase_pm_coarse_demand.h"
 #include "mali_kbase_pm_demand.h"
+#include "mali_kbase_pm_predictive.h"
 #if !MALI_CUSTOMER_RELEASE
 #include "mali_kbase_pm_demand_always_powered.h"
 #include "mali_kbase_pm_fast_start.h"
@@ -159,6 +160,7 @@ union kbase_pm_policy_data {
 	struct kbasep_pm_policy_always_on always_on;
 	struct kbasep_pm_policy_coarse_demand coarse_demand;
 	struct kbasep_pm_policy_demand demand;
+	struct kbasep_pm_policy_predictive predictive;
 #if !MALI_CUSTOMER_RELEASE
 	struct kbasep_pm_policy_demand_always_powered demand_always_powered;
 	struct kbasep_pm_policy_fast_start fast_start;
@@ -319,6 +321,9 @@ struct kbase_pm_device_data {
 
 	struct work_struct gpu_poweroff_work;
 
+	/** Re-evaluates the current policy, see kbase_pm_policy_update_async() */
+	struct work_struct policy_update_work;
+
 	/** Period of GPU poweroff timer */
 	ktime_t gpu_poweroff_time;
 
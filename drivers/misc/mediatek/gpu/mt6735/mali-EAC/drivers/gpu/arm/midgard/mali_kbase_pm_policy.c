@@ -30,6 +30,7 @@
 extern const struct kbase_pm_policy kbase_pm_always_on_policy_ops;
 extern const struct kbase_pm_policy kbase_pm_coarse_demand_policy_ops;
 extern const struct kbase_pm_policy kbase_pm_demand_policy_ops;
+extern const struct kbase_pm_policy kbase_pm_predictive_policy_ops;
 
 #if !MALI_CUSTOMER_RELEASE
 extern const struct kbase_pm_policy kbase_pm_fast_start_policy_ops;
@@ -41,6 +42,7 @@ static const struct kbase_pm_policy *const policy_list[] = {
 	&kbase_pm_always_on_policy_ops,
 	&kbase_pm_demand_policy_ops,
 	&kbase_pm_coarse_demand_policy_ops,
+	&kbase_pm_predictive_policy_ops,
 #if !MALI_CUSTOMER_RELEASE
 	&kbase_pm_demand_always_powered_policy_ops,
 	&kbase_pm_fast_start_policy_ops,
@@ -49,6 +51,7 @@ static const struct kbase_pm_policy *const policy_list[] = {
 	&kbase_pm_demand_policy_ops,
 	&kbase_pm_always_on_policy_ops,
 	&kbase_pm_coarse_demand_policy_ops,
+	&kbase_pm_predictive_policy_ops,
 #if !MALI_CUSTOMER_RELEASE
 	&kbase_pm_demand_always_powered_policy_ops,
 	&kbase_pm_fast_start_policy_ops,
@@ -250,6 +253,23 @@ static void kbasep_pm_do_gpu_poweroff_wq(struct work_struct *data)
 	mutex_unlock(&kbdev->pm.lock);
 }
 
+static void kbasep_pm_policy_update_wq(struct work_struct *data)
+{
+	struct kbase_device *kbdev;
+
+	kbdev = container_of(data, struct kbase_device, pm.policy_update_work);
+
+	mutex_lock(&kbdev->pm.lock);
+	kbase_pm_update_active(kbdev);
+	kbase_pm_update_cores_state(kbdev);
+	mutex_unlock(&kbdev->pm.lock);
+}
+
+void kbase_pm_policy_update_async(struct kbase_device *kbdev)
+{
+	queue_work(kbdev->pm.gpu_poweroff_wq, &kbdev->pm.policy_update_work);
+}
+
 mali_error kbase_pm_policy_init(struct kbase_device *kbdev)
 {
 	KBASE_DEBUG_ASSERT(kbdev != NULL);
@@ -258,6 +278,7 @@ mali_error kbase_pm_policy_init(struct kbase_device *kbdev)
 	if (NULL == kbdev->pm.gpu_poweroff_wq)
 		return MALI_ERROR_OUT_OF_MEMORY;
 	INIT_WORK(&kbdev->pm.gpu_poweroff_work, kbasep_pm_do_gpu_poweroff_wq);
+	INIT_WORK(&kbdev->pm.policy_update_work, kbasep_pm_policy_update_wq);
 
 	hrtimer_init(&kbdev->pm.gpu_poweroff_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
 	kbdev->pm.gpu_poweroff_timer.function = kbasep_pm_do_gpu_poweroff_callback;
@@ -277,6 +298,7 @@ mali_error kbase_pm_policy_init(struct kbase_device *kbdev)
 void kbase_pm_policy_term(struct kbase_device *kbdev)
 {
 	kbdev->pm.pm_current_policy->term(kbdev);
+	cancel_work_sync(&kbdev->pm.policy_update_work);
 }
 
 void kbase_pm_cancel_deferred_poweroff(struct kbase_device *kbdev)
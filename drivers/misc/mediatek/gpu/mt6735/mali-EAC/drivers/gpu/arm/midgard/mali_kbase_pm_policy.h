@@ -28,6 +28,7 @@ enum kbase_pm_policy_id {
 	KBASE_PM_POLICY_ID_DEMAND = 1,
 	KBASE_PM_POLICY_ID_ALWAYS_ON,
 	KBASE_PM_POLICY_ID_COARSE_DEMAND,
+	KBASE_PM_POLICY_ID_PREDICTIVE,
 #if !MALI_CUSTOMER_RELEASE
 	KBASE_PM_POLICY_ID_DEMAND_ALWAYS_POWERED,
 	KBASE_PM_POLICY_ID_FAST_START
@@ -107,6 +108,15 @@ mali_error kbase_pm_policy_init(struct kbase_device *kbdev);
  */
 void kbase_pm_policy_term(struct kbase_device *kbdev);
 
+/** Re-evaluate the current power policy from a work item
+ *
+ * For policies whose decisions change without any call into the power
+ * management code, e.g. from a timer. This may be called from atomic context.
+ *
+ * @param kbdev     The kbase device structure for the device (must be a valid pointer)
+ */
+void kbase_pm_policy_update_async(struct kbase_device *kbdev);
+
 /** Update the active power state of the GPU
  * Calls into the current power policy
  *
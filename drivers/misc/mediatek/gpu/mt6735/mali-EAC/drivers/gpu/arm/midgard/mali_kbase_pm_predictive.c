@@ -0,0 +1,209 @@
+/*
+ *
+ * (C) COPYRIGHT ARM Limited. All rights reserved.
+ *
+ * This program is free software and is provided to you under the terms of the
+ * GNU General Public License version 2 as published by the Free Software
+ * Foundation, and any use by you of this program is subject to the terms
+ * of such GNU licence.
+ *
+ * A copy of the licence is included with the program, and can also be obtained
+ * from Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ *
+ */
+
+
+
+/**
+ * @file mali_kbase_pm_predictive.c
+ * "Predictive" power management policy
+ */
+
+#include <mali_kbase.h>
+#include <mali_kbase_pm.h>
+#include "ged_dvfs.h"
+
+#if KBASE_PM_EN
+static u32 predictive_expected_gap_us(struct kbasep_pm_policy_predictive *data, u32 busy_us)
+{
+	u32 vsync_us;
+	u32 vsync_gap_us;
+
+	/* Nothing to go on yet, behave like coarse_demand */
+	if (data->gap_us == 0)
+		return U32_MAX;
+
+	/* A frame paced by the display goes idle for whatever is left of the
+	 * vsync period. Trust that over the average when the two agree, as it
+	 * also follows the phase of the current frame */
+	vsync_us = (u32)ged_query_info(GED_VSYNC_PERIOD);
+	if (vsync_us != 0 && busy_us < vsync_us) {
+		vsync_gap_us = vsync_us - busy_us;
+		if (data->gap_us >= vsync_gap_us - vsync_gap_us / 4 &&
+		    data->gap_us <= vsync_gap_us + vsync_gap_us / 4)
+			return vsync_gap_us;
+	}
+
+	return data->gap_us;
+}
+
+static void predictive_start_timer(struct kbasep_pm_policy_predictive *data, u32 delay_us)
+{
+	hrtimer_start(&data->timer, HR_TIMER_DELAY_NSEC((u64)delay_us * NSEC_PER_USEC), HRTIMER_MODE_REL);
+}
+
+static enum hrtimer_restart predictive_timer_callback(struct hrtimer *timer)
+{
+	struct kbase_device *kbdev;
+	struct kbasep_pm_policy_predictive *data;
+	enum hrtimer_restart ret = HRTIMER_NORESTART;
+	mali_bool update = MALI_TRUE;
+	unsigned long flags;
+
+	kbdev = container_of(timer, struct kbase_device, pm.pm_policy_data.predictive.timer);
+	data = &kbdev->pm.pm_policy_data.predictive;
+
+	spin_lock_irqsave(&kbdev->pm.power_change_lock, flags);
+
+	switch (data->state) {
+	case KBASE_PM_PREDICTIVE_WAIT:
+		/* Give the expected job a break-even period to show up */
+		data->state = KBASE_PM_PREDICTIVE_PREPOWERED;
+		hrtimer_forward_now(timer, HR_TIMER_DELAY_NSEC((u64)(KBASE_PM_PREDICTIVE_POWERUP_US + KBASE_PM_PREDICTIVE_BREAK_EVEN_US) * NSEC_PER_USEC));
+		ret = HRTIMER_RESTART;
+		break;
+	case KBASE_PM_PREDICTIVE_HOLD:
+	case KBASE_PM_PREDICTIVE_PREPOWERED:
+		/* The job didn't come, let the GPU power off */
+		data->state = KBASE_PM_PREDICTIVE_NONE;
+		break;
+	default:
+		/* Raced with the GPU becoming active */
+		update = MALI_FALSE;
+		break;
+	}
+
+	spin_unlock_irqrestore(&kbdev->pm.power_change_lock, flags);
+
+	if (update != MALI_FALSE)
+		kbase_pm_policy_update_async(kbdev);
+
+	return ret;
+}
+
+static mali_bool predictive_powered(struct kbase_device *kbdev)
+{
+	struct kbasep_pm_policy_predictive *data = &kbdev->pm.pm_policy_data.predictive;
+
+	if (kbdev->pm.active_count != 0)
+		return MALI_TRUE;
+
+	if (kbase_pm_is_suspending(kbdev))
+		return MALI_FALSE;
+
+	return (data->state == KBASE_PM_PREDICTIVE_HOLD ||
+		data->state == KBASE_PM_PREDICTIVE_PREPOWERED) ? MALI_TRUE : MALI_FALSE;
+}
+
+static u64 predictive_get_core_mask(struct kbase_device *kbdev)
+{
+	if (predictive_powered(kbdev) == MALI_FALSE)
+		return 0;
+
+	return kbdev->shader_present_bitmap;
+}
+
+static mali_bool predictive_get_core_active(struct kbase_device *kbdev)
+{
+	struct kbasep_pm_policy_predictive *data = &kbdev->pm.pm_policy_data.predictive;
+	ktime_t now;
+
+	lockdep_assert_held(&kbdev->pm.power_change_lock);
+
+	/* Only act on the active/idle edges, this is also called while the GPU
+	 * stays idle */
+	if ((kbdev->pm.active_count != 0) != (data->was_active != MALI_FALSE)) {
+		now = ktime_get();
+
+		if (kbdev->pm.active_count != 0) {
+			if (ktime_to_ns(data->idle_start) != 0) {
+				s64 gap_us = ktime_to_us(ktime_sub(now, data->idle_start));
+
+				gap_us = MIN(gap_us, KBASE_PM_PREDICTIVE_MAX_GAP_US);
+				if (data->gap_us == 0)
+					data->gap_us = (u32)gap_us;
+				else
+					data->gap_us = (u32)((3 * (s64)data->gap_us + gap_us) / 4);
+			}
+
+			data->state = KBASE_PM_PREDICTIVE_NONE;
+			hrtimer_try_to_cancel(&data->timer);
+			data->active_start = now;
+			data->was_active = MALI_TRUE;
+		} else {
+			s64 busy_us = ktime_to_us(ktime_sub(now, data->active_start));
+			u32 expected_us;
+
+			expected_us = predictive_expected_gap_us(data, (u32)MIN(busy_us, (s64)U32_MAX));
+
+			if (expected_us <= KBASE_PM_PREDICTIVE_BREAK_EVEN_US) {
+				/* Cheaper to stay up; give up after a break-even
+				 * period, at which point powering off would have
+				 * cost no more */
+				data->state = KBASE_PM_PREDICTIVE_HOLD;
+				predictive_start_timer(data, KBASE_PM_PREDICTIVE_BREAK_EVEN_US);
+			} else if (expected_us != U32_MAX) {
+				data->state = KBASE_PM_PREDICTIVE_WAIT;
+				predictive_start_timer(data, expected_us - KBASE_PM_PREDICTIVE_POWERUP_US);
+			} else {
+				data->state = KBASE_PM_PREDICTIVE_NONE;
+			}
+
+			data->idle_start = now;
+			data->was_active = MALI_FALSE;
+		}
+	}
+
+	return predictive_powered(kbdev);
+}
+
+static void predictive_init(struct kbase_device *kbdev)
+{
+	struct kbasep_pm_policy_predictive *data = &kbdev->pm.pm_policy_data.predictive;
+
+	hrtimer_init(&data->timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	data->timer.function = predictive_timer_callback;
+
+	data->state = KBASE_PM_PREDICTIVE_NONE;
+	data->was_active = MALI_FALSE;
+	data->active_start = ktime_set(0, 0);
+	data->idle_start = ktime_set(0, 0);
+	data->gap_us = 0;
+}
+
+static void predictive_term(struct kbase_device *kbdev)
+{
+	struct kbasep_pm_policy_predictive *data = &kbdev->pm.pm_policy_data.predictive;
+
+	/* The callback only takes the power_change_lock, so this is safe with
+	 * kbase_pm_device_data::lock held */
+	hrtimer_cancel(&data->timer);
+}
+
+/** The @ref struct kbase_pm_policy structure for the predictive power policy.
+ *
+ * This is the static structure that defines the predictive power policy's callback and name.
+ */
+const struct kbase_pm_policy kbase_pm_predictive_policy_ops = {
+	"predictive",			/* name */
+	predictive_init,		/* init */
+	predictive_term,		/* term */
+	predictive_get_core_mask,	/* get_core_mask */
+	predictive_get_core_active,	/* get_core_active */
+	0u,				/* flags */
+	KBASE_PM_POLICY_ID_PREDICTIVE,	/* id */
+};
+
+KBASE_EXPORT_TEST_API(kbase_pm_predictive_policy_ops)
+#endif  /* KBASE_PM_EN */
@@ -0,0 +1,86 @@
+/*
+ *
+ * (C) COPYRIGHT ARM Limited. All rights reserved.
+ *
+ * This program is free software and is provided to you under the terms of the
+ * GNU General Public License version 2 as published by the Free Software
+ * Foundation, and any use by you of this program is subject to the terms
+ * of such GNU licence.
+ *
+ * A copy of the licence is included with the program, and can also be obtained
+ * from Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ *
+ */
+
+
+
+/**
+ * @file mali_kbase_pm_predictive.h
+ * "Predictive" power management policy
+ */
+
+#ifndef MALI_KBASE_PM_PREDICTIVE_H
+#define MALI_KBASE_PM_PREDICTIVE_H
+
+#include <linux/hrtimer.h>
+
+/**
+ * The predictive power management policy powers cores like coarse_demand
+ * while there are active contexts, but decides what to do with an idle GPU
+ * from the idle gap it expects:
+ * - The expected gap is the average of recent idle gaps, or, when those
+ *   line up with the display refresh reported by GED, the time left until
+ *   the next vsync.
+ * - When the expected gap is below @ref KBASE_PM_PREDICTIVE_BREAK_EVEN_US
+ *   the GPU and all shader cores are kept powered, for at most that long.
+ * - Otherwise the GPU is powered off, and powered back up
+ *   @ref KBASE_PM_PREDICTIVE_POWERUP_US ahead of the expected next job. If
+ *   nothing is submitted within a break-even period of that point, the GPU
+ *   is powered off again.
+ */
+
+/** Idle time below which powering the GPU off and on again costs more than
+ * keeping it powered */
+#define KBASE_PM_PREDICTIVE_BREAK_EVEN_US 2000
+
+/** How long ahead of the expected next job the GPU is powered up */
+#define KBASE_PM_PREDICTIVE_POWERUP_US 500
+
+/** Idle gaps longer than this are not frame pacing, and are clamped before
+ * they are averaged */
+#define KBASE_PM_PREDICTIVE_MAX_GAP_US 100000
+
+enum kbasep_pm_predictive_state {
+	/** Powered according to kbase_pm_device_data::active_count */
+	KBASE_PM_PREDICTIVE_NONE,
+	/** Idle, but kept powered because a job is expected soon */
+	KBASE_PM_PREDICTIVE_HOLD,
+	/** Idle and powered off, the timer will pre-power the GPU */
+	KBASE_PM_PREDICTIVE_WAIT,
+	/** Idle and pre-powered for the expected job */
+	KBASE_PM_PREDICTIVE_PREPOWERED
+};
+
+/**
+ * Private structure for policy instance data.
+ *
+ * This contains data that is private to the particular power policy that is active.
+ * All fields but the timer are protected by
+ * kbase_pm_device_data::power_change_lock
+ */
+typedef struct kbasep_pm_policy_predictive {
+	/** Ends a hold, pre-powers the GPU or ends a pre-power */
+	struct hrtimer timer;
+
+	enum kbasep_pm_predictive_state state;
+	mali_bool was_active;
+
+	ktime_t active_start;
+	ktime_t idle_start;
+
+	/** Running average of the idle gaps, 0 until the first one is seen */
+	u32 gap_us;
+} kbasep_pm_policy_predictive;
+
+#endif				/* MALI_KBASE_PM_PREDICTIVE_H */
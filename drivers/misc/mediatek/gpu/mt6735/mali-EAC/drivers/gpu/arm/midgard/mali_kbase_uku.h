@@ -352,6 +352,13 @@ struct kbase_uk_disjoint_query {
 	u32 padding;
 };
 
+struct kbase_uk_set_priority {
+	union uk_header header;
+	/* IN */
+	s32 priority;
+	u32 realtime;
+};
+
 struct kbase_uk_set_flags {
 	union uk_header header;
 	/* IN */
@@ -470,7 +477,8 @@ enum kbase_uk_function_id {
 
 	KBASE_FUNC_DEBUGFS_MEM_PROFILE_ADD = (UK_FUNC_ID + 27),
 	KBASE_FUNC_JOB_SUBMIT = (UK_FUNC_ID + 28),
-	KBASE_FUNC_DISJOINT_QUERY = (UK_FUNC_ID + 29)
+	KBASE_FUNC_DISJOINT_QUERY = (UK_FUNC_ID + 29),
+	KBASE_FUNC_SET_PRIORITY = (UK_FUNC_ID + 30)
 
 };
 
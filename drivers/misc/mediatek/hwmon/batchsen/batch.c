@@ -76,6 +76,52 @@ static int batch_update_polling_rate(void)
 	return mindelay;
 }
 
+/* rearm the poll at the shortest max report latency of the batching sensors */
+static void batch_poll_rearm(struct batch_context *obj)
+{
+	mod_timer(&obj->timer, jiffies + msecs_to_jiffies(atomic_read(&obj->delay)));
+}
+
+/*
+ * Timestamp of the next sample of @handle read from the FIFO, for sensors
+ * that do not stamp their samples.  The total_count samples since the
+ * last read are spread evenly up to end_t, the time of this read.  If
+ * that puts them more than 1.1 sampling periods apart, the FIFO wrapped
+ * and lost older samples, so they are packed just before end_t instead.
+ * Each stamp is computed from the start of the batch, so per-sample
+ * rounding does not add up over a long batch.
+ */
+static int64_t batch_sample_time(struct batch_context *obj, int handle)
+{
+	struct batch_timestamp_info *pt = &obj->timestamp_info[handle];
+	int64_t period = (int64_t)obj->dev_list.data_dev[handle].samplingPeriodMs * 1100000;
+	int64_t t;
+
+	if (pt->total_count == 0) {
+		BATCH_ERR("pt->total_count == 0\n");
+		return pt->end_t;
+	}
+
+	if (pt->num == 1) {
+		pt->span = max_t(int64_t, pt->end_t - pt->start_t, 0);
+		if (div_s64(pt->span, pt->total_count) > period) {
+			BATCH_LOG("FIFO wrapper around, %lld, %u, %lld, %lld\n", period,
+				  pt->total_count, pt->start_t, pt->end_t);
+			pt->span = period * pt->total_count;
+		}
+		pt->base_t = pt->end_t - pt->span;
+	}
+
+	if (pt->num >= pt->total_count)
+		t = pt->end_t;
+	else
+		t = pt->base_t + div_s64(pt->span * pt->num, pt->total_count);
+
+	pt->num++;
+	pt->start_t = t;
+	return t;
+}
+
 static int get_fifo_data(struct batch_context *obj)
 {
 
@@ -156,8 +202,9 @@ int  batch_notify(enum BATCH_NOTIFY_TYPE type)
 	if (type == TYPE_BATCHTIMEOUT)
 		BATCH_LOG("fwq batch timeout notify do nothing\n");
 
+	/* the FIFO was just drained, the next poll is a full latency away */
 	if (batch_context_obj->is_polling_run)
-		mod_timer(&batch_context_obj->timer, jiffies + atomic_read(&batch_context_obj->delay)/(1000/HZ));
+		batch_poll_rearm(batch_context_obj);
 
 	return err;
 }
@@ -173,7 +220,7 @@ static void batch_work_func(struct work_struct *work)
 		BATCH_LOG("fwq!! get fifo data error !\n");
 
 	if (obj->is_polling_run)
-		mod_timer(&obj->timer, jiffies + atomic_read(&obj->delay)/(1000/HZ));
+		batch_poll_rearm(obj);
 
 	BATCH_LOG("fwq!! get data from sensor obj->delay=%d ---------  !\n", atomic_read(&obj->delay));
 }
@@ -228,7 +275,7 @@ static struct batch_context *batch_context_alloc_object(void)
 	atomic_set(&obj->wake, 0);
 	INIT_WORK(&obj->report, batch_work_func);
 	init_timer(&obj->timer);
-	obj->timer.expires	= jiffies + atomic_read(&obj->delay)/(1000/HZ);
+	obj->timer.expires	= jiffies + msecs_to_jiffies(atomic_read(&obj->delay));
 	obj->timer.function	= batch_poll;
 	obj->timer.data = (unsigned long)obj;
 	obj->is_first_data_after_enable = false;
@@ -328,7 +375,7 @@ static ssize_t batch_store_active(struct device *dev, struct device_attribute *a
 	if (delay > 0) {
 		cxt->is_polling_run = true;
 		atomic_set(&cxt->delay, delay);
-		mod_timer(&cxt->timer, jiffies + atomic_read(&cxt->delay)/(1000/HZ));
+		batch_poll_rearm(cxt);
 	} else {
 		cxt->is_polling_run = false;
 		del_timer_sync(&cxt->timer);
@@ -480,7 +527,7 @@ static ssize_t batch_store_batch(struct device *dev, struct device_attribute *at
 	if (delay > 0) {
 		cxt->is_polling_run = true;
 		atomic_set(&cxt->delay, delay);
-		mod_timer(&cxt->timer, jiffies + atomic_read(&cxt->delay)/(1000/HZ));
+		batch_poll_rearm(cxt);
 	} else {
 		cxt->is_polling_run = false;
 		del_timer_sync(&cxt->timer);
@@ -578,7 +625,6 @@ static long batch_unlocked_ioctl(struct file *fp, unsigned int cmd, unsigned lon
 	struct batch_trans_data batch_sensors_data;
 	int i;
 	int err;
-	struct batch_timestamp_info *pt;
 	int handle;
 
 	if (batch_context_obj == NULL) {
@@ -604,31 +650,9 @@ static long batch_unlocked_ioctl(struct file *fp, unsigned int cmd, unsigned lon
 			else {
 				handle = batch_sensors_data.data[i].sensor;
 
-				if (batch_context_obj->dev_list.data_dev[handle].is_timestamp_supported == 0) {
-					pt = &batch_context_obj->timestamp_info[handle];
-					batch_sensors_data.data[i].time = pt->end_t - pt->start_t;
-					if (pt->total_count == 0)
-						BATCH_ERR("pt->total_count == 0\n");
-					else
-						do_div(batch_sensors_data.data[i].time, pt->total_count);
-
-					if (batch_sensors_data.data[i].time > (int64_t)batch_context_obj->dev_list
-							.data_dev[handle].samplingPeriodMs*1100000) {
-						batch_sensors_data.data[i].time = pt->end_t - (int64_t)
-							batch_context_obj->dev_list.data_dev[handle]
-							.samplingPeriodMs*1100000*(pt->total_count-1);
-						BATCH_LOG("FIFO wrapper around1, %lld, %lld, %lld\n",
-								(int64_t)batch_context_obj->dev_list.data_dev[handle]
-								.samplingPeriodMs, (int64_t)pt->total_count,
-								(int64_t)batch_context_obj->dev_list.data_dev[handle]
-								.samplingPeriodMs*1100000*(pt->total_count-1));
-						BATCH_LOG("FIFO wrapper around2, %lld, %lld, %lld\n", pt->start_t,
-								batch_sensors_data.data[i].time, pt->end_t);
-					} else
-							batch_sensors_data.data[i].time += pt->start_t;
-
-					pt->start_t = batch_sensors_data.data[i].time;
-				}
+				if (batch_context_obj->dev_list.data_dev[handle].is_timestamp_supported == 0)
+					batch_sensors_data.data[i].time =
+						batch_sample_time(batch_context_obj, handle);
 				batch_sensors_data.data[i].sensor = IDToSensorType(handle);
 			}
 		}
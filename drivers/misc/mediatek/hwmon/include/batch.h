@@ -64,10 +64,12 @@ struct batch_control_path {
 };
 
 struct batch_timestamp_info {
-	int64_t start_t;
-	int64_t end_t;
-	uint32_t total_count;
-	uint32_t num;
+	int64_t start_t;	/* time of the last sample handed out */
+	int64_t end_t;		/* time of the FIFO read */
+	uint32_t total_count;	/* samples in the FIFO read, set by get_fifo_status */
+	uint32_t num;		/* next sample of the read, from 1 */
+	int64_t base_t;		/* batch_sample_time() state for the read */
+	int64_t span;
 };
 
 struct batch_data_path {
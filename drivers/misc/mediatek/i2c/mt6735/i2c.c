@@ -11,6 +11,7 @@
 #include <linux/device.h>
 #include <linux/platform_device.h>
 #include <linux/wait.h>
+#include <linux/workqueue.h>
 #include <linux/mm.h>
 #include <linux/dma-mapping.h>
 #include <asm/scatterlist.h>
@@ -58,6 +59,10 @@ u32 i2c_readl(struct mt_i2c_t *i2c, u8 offset)
 static void mt_i2c_clock_enable(struct mt_i2c_t *i2c);
 static void mt_i2c_clock_disable(struct mt_i2c_t *i2c);
 
+/* idle time before the clocks are gated, back-to-back transfers skip it */
+static unsigned int clk_idle_ms = 5;
+module_param(clk_idle_ms, uint, S_IRUGO | S_IWUSR);
+
 /***********************************I2C common Param **************************/
 u32 I2C_TIMING_REG_BACKUP[7] = { 0 };
 u32 I2C_HIGHSP_REG_BACKUP[7] = { 0 };
@@ -1163,6 +1168,14 @@ int mtk_i2c_transfer(struct i2c_adapter *adap, struct mt_i2c_msg msgs[], s32 num
 
 	struct mt_i2c_t *i2c = i2c_get_adapdata(adap);
 
+	/* queue behind i2c_transfer() users of the bus, like i2c_transfer() */
+	if (in_atomic() || irqs_disabled()) {
+		if (!rt_mutex_trylock(&adap->bus_lock))
+			return -EAGAIN;
+	} else {
+		i2c_lock_adapter(adap);
+	}
+
 	for (retry = 0; retry < adap->retries; retry++) {
 		ret = mt_i2c_do_transfer(i2c, msgs, num);
 		if (ret != -EAGAIN)
@@ -1170,6 +1183,7 @@ int mtk_i2c_transfer(struct i2c_adapter *adap, struct mt_i2c_msg msgs[], s32 num
 		if (retry < adap->retries - 1)
 			udelay(100);
 	}
+	i2c_unlock_adapter(adap);
 
 	if (ret != -EAGAIN)
 		return ret;
@@ -1252,52 +1266,92 @@ static s32 _i2c_deal_result_3dcamera(struct mt_i2c_t *i2c, struct mt_i2c_msg *ms
 }
 #endif
 
+/* called with the bus lock held */
 static void mt_i2c_clock_enable(struct mt_i2c_t *i2c)
 {
+	cancel_delayed_work(&i2c->clk_off_work);
 #if (!defined(CONFIG_MT_I2C_FPGA_ENABLE))
 #if defined(CONFIG_MTK_CLKMGR)
-	if (i2c->dma_en) {
+	if (i2c->dma_en && !i2c->clk_dma_on) {
 		I2CINFO(I2C_T_TRANSFERFLOW, "Before dma clock enable .....\n");
 		enable_clock(MT_CG_PERI_APDMA, "i2c");
+		i2c->clk_dma_on = true;
+	}
+	if (!i2c->clk_on) {
+		I2CINFO(I2C_T_TRANSFERFLOW, "Before i2c clock enable .....\n");
+		enable_clock(i2c->pdn, "i2c");
+		i2c->clk_on = true;
 	}
-	I2CINFO(I2C_T_TRANSFERFLOW, "Before i2c clock enable .....\n");
-	enable_clock(i2c->pdn, "i2c");
 	I2CINFO(I2C_T_TRANSFERFLOW, "clock enable done.....\n");
 #else
-	if (i2c->dma_en) {
+	if (i2c->dma_en && !i2c->clk_dma_on) {
 		I2CINFO(I2C_T_TRANSFERFLOW, "Before dma clock enable .....\n");
 		clk_prepare_enable(i2c->clk_dma);
+		i2c->clk_dma_on = true;
+	}
+	if (!i2c->clk_on) {
+		I2CINFO(I2C_T_TRANSFERFLOW, "Before i2c clock enable .....\n");
+		clk_prepare_enable(i2c->clk_main);
+		i2c->clk_on = true;
 	}
-	I2CINFO(I2C_T_TRANSFERFLOW, "Before i2c clock enable .....\n");
-	clk_prepare_enable(i2c->clk_main);
 	I2CINFO(I2C_T_TRANSFERFLOW, "clock enable done.....\n");
 #endif
 #endif
 }
 
-static void mt_i2c_clock_disable(struct mt_i2c_t *i2c)
+/* called with the bus lock held, or from the clk_off_work */
+static void mt_i2c_clock_off(struct mt_i2c_t *i2c)
 {
 #if (!defined(CONFIG_MT_I2C_FPGA_ENABLE))
 #if defined(CONFIG_MTK_CLKMGR)
-	if (i2c->dma_en) {
+	if (i2c->clk_dma_on) {
 		I2CINFO(I2C_T_TRANSFERFLOW, "Before dma clock disable .....\n");
 		disable_clock(MT_CG_PERI_APDMA, "i2c");
+		i2c->clk_dma_on = false;
+	}
+	if (i2c->clk_on) {
+		I2CINFO(I2C_T_TRANSFERFLOW, "Before i2c clock disable .....\n");
+		disable_clock(i2c->pdn, "i2c");
+		i2c->clk_on = false;
 	}
-	I2CINFO(I2C_T_TRANSFERFLOW, "Before i2c clock disable .....\n");
-	disable_clock(i2c->pdn, "i2c");
 	I2CINFO(I2C_T_TRANSFERFLOW, "clock disable done .....\n");
 #else
-	if (i2c->dma_en) {
+	if (i2c->clk_dma_on) {
 		I2CINFO(I2C_T_TRANSFERFLOW, "Before dma clock disable .....\n");
 		clk_disable_unprepare(i2c->clk_dma);
+		i2c->clk_dma_on = false;
+	}
+	if (i2c->clk_on) {
+		I2CINFO(I2C_T_TRANSFERFLOW, "Before i2c clock disable .....\n");
+		clk_disable_unprepare(i2c->clk_main);
+		i2c->clk_on = false;
 	}
-	I2CINFO(I2C_T_TRANSFERFLOW, "Before i2c clock disable .....\n");
-	clk_disable_unprepare(i2c->clk_main);
 	I2CINFO(I2C_T_TRANSFERFLOW, "clock disable done.....\n");
 #endif
 #endif
 }
 
+static void mt_i2c_clock_off_work(struct work_struct *work)
+{
+	struct mt_i2c_t *i2c = container_of(to_delayed_work(work), struct mt_i2c_t,
+					    clk_off_work);
+
+	/* a transfer that raced with us has already re-armed the work */
+	i2c_lock_adapter(&i2c->adap);
+	mt_i2c_clock_off(i2c);
+	i2c_unlock_adapter(&i2c->adap);
+}
+
+static void mt_i2c_clock_disable(struct mt_i2c_t *i2c)
+{
+	unsigned int ms = ACCESS_ONCE(clk_idle_ms);
+
+	if (!ms || in_atomic() || irqs_disabled())
+		mt_i2c_clock_off(i2c);
+	else
+		mod_delayed_work(system_wq, &i2c->clk_off_work, msecs_to_jiffies(ms));
+}
+
 #ifdef CONFIG_TRUSTONIC_TEE_SUPPORT
 int i2c_tui_enable_clock(void)
 {
@@ -1456,6 +1510,8 @@ static void mt_i2c_free(struct mt_i2c_t *i2c)
 
 	free_irq(i2c->irqnr, i2c);
 	i2c_del_adapter(&i2c->adap);
+	cancel_delayed_work_sync(&i2c->clk_off_work);
+	mt_i2c_clock_off(i2c);
 	kfree(i2c);
 }
 
@@ -1627,6 +1683,7 @@ static s32 mt_i2c_probe(struct platform_device *pdev)
 
 	spin_lock_init(&i2c->lock);
 	init_waitqueue_head(&i2c->wait);
+	INIT_DELAYED_WORK(&i2c->clk_off_work, mt_i2c_clock_off_work);
 
 	ret = request_irq(irq, mt_i2c_irq, IRQF_TRIGGER_LOW, I2C_DRV_NAME, i2c);
 
@@ -1677,8 +1734,14 @@ static s32 mt_i2c_remove(struct platform_device *pdev)
 #ifdef CONFIG_PM
 static s32 mt_i2c_suspend(struct platform_device *pdev, pm_message_t state)
 {
-	/* struct struct mt_i2c_t *i2c = platform_get_drvdata(pdev); */
+	struct mt_i2c_t *i2c = platform_get_drvdata(pdev);
 	/* dev_dbg(i2c->dev,"[I2C %d] Suspend!\n", i2c->id); */
+
+	/* do not wait for the idle timer with the clocks on */
+	cancel_delayed_work_sync(&i2c->clk_off_work);
+	i2c_lock_adapter(&i2c->adap);
+	mt_i2c_clock_off(i2c);
+	i2c_unlock_adapter(&i2c->adap);
 	return 0;
 }
 
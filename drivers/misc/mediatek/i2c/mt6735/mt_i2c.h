@@ -238,6 +238,10 @@ struct mt_i2c_t {
 	u32 defaul_speed;
 	struct mt_trans_data trans_data;
 	struct i2c_dma_buf dma_buf;
+	/* clocks stay on clk_idle_ms after a transfer, changed under the bus lock */
+	bool clk_on;
+	bool clk_dma_on;
+	struct delayed_work clk_off_work;
 #if !defined(CONFIG_MTK_CLKMGR)
 	struct clk *clk_main;	/* main clock for i2c bus */
 	struct clk *clk_dma;	/* DMA clock for i2c via DMA */
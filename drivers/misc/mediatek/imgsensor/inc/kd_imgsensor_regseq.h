@@ -0,0 +1,32 @@
+#ifndef _KD_IMGSENSOR_REGSEQ_H_
+#define _KD_IMGSENSOR_REGSEQ_H_
+
+/* Register sequence entry.
+ * len is the data width in bytes (1 or 2); len 0 is a delay of data ms.
+ * Entries whose addresses follow each other are sent as one DMA burst,
+ * so keep init tables in address order where the sensor allows it.
+ */
+typedef struct {
+	MUINT16 addr;
+	MUINT16 data;
+	MUINT8 len;
+} KD_SENSOR_REG;
+
+#define KD_SENSOR_REG8(a, d)		{ (a), (d), 1 }
+#define KD_SENSOR_REG16(a, d)		{ (a), (d), 2 }
+#define KD_SENSOR_REG_DELAY(ms)		{ 0, (ms), 0 }
+
+/* Called from the sequence worker once the whole table was sent.
+ * Must not issue sensor I2C itself.
+ */
+typedef void (*KD_SENSOR_REG_SEQ_DONE)(void *priv, int err);
+
+/* Write a table on the current bus, returns 0 or a negative errno */
+extern int kdSensorRegSeqWrite(const KD_SENSOR_REG *regs, MUINT32 count, u16 i2cId);
+/* Queue a table, regs must stay valid until done is called */
+extern int kdSensorRegSeqWriteAsync(const KD_SENSOR_REG *regs, MUINT32 count, u16 i2cId,
+				    KD_SENSOR_REG_SEQ_DONE done, void *priv);
+/* Wait for a queued table, returns its result */
+extern int kdSensorRegSeqSync(void);
+
+#endif
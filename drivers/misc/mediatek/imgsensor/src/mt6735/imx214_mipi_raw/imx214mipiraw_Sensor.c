@@ -33,6 +33,7 @@
 #include "kd_imgsensor.h"
 #include "kd_imgsensor_define.h"
 #include "kd_imgsensor_errcode.h"
+#include "kd_imgsensor_regseq.h"
 
 #include "imx214mipiraw_Sensor.h"
 
@@ -390,6 +391,8 @@ static kal_uint16 read_cmos_sensor(kal_uint32 addr)
 }
 
 #define write_cmos_sensor(addr, para) iWriteReg((u16) addr , (u32) para , 1,  imgsensor.i2c_write_id)
+#define write_cmos_sensor_table(regs) \
+	kdSensorRegSeqWrite(regs, ARRAY_SIZE(regs), imgsensor.i2c_write_id)
 
 static kal_uint32 imx214_ATR(UINT16 DarkLimit, UINT16 OverExp)
 {
@@ -750,329 +753,376 @@ static void night_mode(kal_bool enable)
 /*No Need to implement this function*/
 }	/*	night_mode	*/
 
+static const KD_SENSOR_REG sensor_init_regs[] = {
+	KD_SENSOR_REG8(0x0136, 0x18),
+	KD_SENSOR_REG8(0x0137, 0x00),
+
+	KD_SENSOR_REG8(0x0101, 0x00),
+	KD_SENSOR_REG8(0x0105, 0x01),
+	KD_SENSOR_REG8(0x0106, 0x01),
+	KD_SENSOR_REG8(0x4550, 0x02),
+	KD_SENSOR_REG8(0x4601, 0x00),
+	KD_SENSOR_REG8(0x4642, 0x05),
+	KD_SENSOR_REG8(0x6276, 0x00),
+	KD_SENSOR_REG8(0x900E, 0x06),
+	KD_SENSOR_REG8(0xA802, 0x90),
+	KD_SENSOR_REG8(0xA803, 0x11),
+	KD_SENSOR_REG8(0xA804, 0x62),
+	KD_SENSOR_REG8(0xA805, 0x77),
+	KD_SENSOR_REG8(0xA806, 0xAE),
+	KD_SENSOR_REG8(0xA807, 0x34),
+	KD_SENSOR_REG8(0xA808, 0xAE),
+	KD_SENSOR_REG8(0xA809, 0x35),
+	KD_SENSOR_REG8(0xA80A, 0x62),
+	KD_SENSOR_REG8(0xA80B, 0x83),
+	KD_SENSOR_REG8(0xAE33, 0x00),
+
+	KD_SENSOR_REG8(0x4174, 0x00),
+	KD_SENSOR_REG8(0x4175, 0x11),
+	KD_SENSOR_REG8(0x4612, 0x29),
+	KD_SENSOR_REG8(0x461B, 0x12),
+	KD_SENSOR_REG8(0x461F, 0x06),
+	KD_SENSOR_REG8(0x4635, 0x07),
+	KD_SENSOR_REG8(0x4637, 0x30),
+	KD_SENSOR_REG8(0x463F, 0x18),
+	KD_SENSOR_REG8(0x4641, 0x0D),
+	KD_SENSOR_REG8(0x465B, 0x12),
+	KD_SENSOR_REG8(0x465F, 0x11),
+	KD_SENSOR_REG8(0x4663, 0x11),
+	KD_SENSOR_REG8(0x4667, 0x0F),
+	KD_SENSOR_REG8(0x466F, 0x0F),
+	KD_SENSOR_REG8(0x470E, 0x09),
+	KD_SENSOR_REG8(0x4909, 0xAB),
+	KD_SENSOR_REG8(0x490B, 0x95),
+	KD_SENSOR_REG8(0x4915, 0x5D),
+	KD_SENSOR_REG8(0x4A5F, 0xFF),
+	KD_SENSOR_REG8(0x4A61, 0xFF),
+	KD_SENSOR_REG8(0x4A73, 0x62),
+	KD_SENSOR_REG8(0x4A85, 0x00),
+	KD_SENSOR_REG8(0x4A87, 0xFF),
+	KD_SENSOR_REG8(0x583C, 0x04),
+	KD_SENSOR_REG8(0x620E, 0x04),
+	KD_SENSOR_REG8(0x6EB2, 0x01),
+	KD_SENSOR_REG8(0x6EB3, 0x00),
+	KD_SENSOR_REG8(0x9300, 0x02),
+
+	KD_SENSOR_REG8(0x3001, 0x07),
+	KD_SENSOR_REG8(0x6D12, 0x3F),
+	KD_SENSOR_REG8(0x6D13, 0xFF),
+	KD_SENSOR_REG8(0x9344, 0x03),
+	KD_SENSOR_REG8(0x9706, 0x10),
+	KD_SENSOR_REG8(0x9707, 0x03),
+	KD_SENSOR_REG8(0x9708, 0x03),
+	KD_SENSOR_REG8(0x9E04, 0x01),
+	KD_SENSOR_REG8(0x9E05, 0x00),
+	KD_SENSOR_REG8(0x9E0C, 0x01),
+	KD_SENSOR_REG8(0x9E0D, 0x02),
+	KD_SENSOR_REG8(0x9E24, 0x00),
+	KD_SENSOR_REG8(0x9E25, 0x8C),
+	KD_SENSOR_REG8(0x9E26, 0x00),
+	KD_SENSOR_REG8(0x9E27, 0x94),
+	KD_SENSOR_REG8(0x9E28, 0x00),
+	KD_SENSOR_REG8(0x9E29, 0x96),
+	//write_cmos_sensor(0x5041,0x00);//no embedded data
+
+	KD_SENSOR_REG8(0x69DB, 0x01),
+	KD_SENSOR_REG8(0x6957, 0x01),
+	KD_SENSOR_REG8(0x6987, 0x17),
+	KD_SENSOR_REG8(0x698A, 0x03),
+	KD_SENSOR_REG8(0x698B, 0x03),
+	KD_SENSOR_REG8(0x0B8E, 0x01),
+	KD_SENSOR_REG8(0x0B8F, 0x00),
+	KD_SENSOR_REG8(0x0B90, 0x01),
+	KD_SENSOR_REG8(0x0B91, 0x00),
+	KD_SENSOR_REG8(0x0B92, 0x01),
+	KD_SENSOR_REG8(0x0B93, 0x00),
+	KD_SENSOR_REG8(0x0B94, 0x01),
+	KD_SENSOR_REG8(0x0B95, 0x00),
+	KD_SENSOR_REG8(0x6E50, 0x00),
+	KD_SENSOR_REG8(0x6E51, 0x32),
+	KD_SENSOR_REG8(0x9340, 0x00),
+	KD_SENSOR_REG8(0x9341, 0x3C),
+	KD_SENSOR_REG8(0x9342, 0x03),
+	KD_SENSOR_REG8(0x9343, 0xFF),
+	KD_SENSOR_REG8(0x0101, 0x03),
+};
+
+static void sensor_init_done(void *priv, int err)
+{
+	if (err)
+		LOG_INF("init setting failed, err %d\n", err);
+}
+
 static void sensor_init(void)
 {
 	LOG_INF("E\n");
-    //init setting
-    write_cmos_sensor(0x0136,0x18);
-    write_cmos_sensor(0x0137,0x00);
-
-    write_cmos_sensor(0x0101,0x00);
-    write_cmos_sensor(0x0105,0x01);
-    write_cmos_sensor(0x0106,0x01);
-    write_cmos_sensor(0x4550,0x02);
-    write_cmos_sensor(0x4601,0x00);
-    write_cmos_sensor(0x4642,0x05);
-    write_cmos_sensor(0x6276,0x00);
-    write_cmos_sensor(0x900E,0x06);
-    write_cmos_sensor(0xA802,0x90);
-    write_cmos_sensor(0xA803,0x11);
-    write_cmos_sensor(0xA804,0x62);
-    write_cmos_sensor(0xA805,0x77);
-    write_cmos_sensor(0xA806,0xAE);
-    write_cmos_sensor(0xA807,0x34);
-    write_cmos_sensor(0xA808,0xAE);
-    write_cmos_sensor(0xA809,0x35);
-    write_cmos_sensor(0xA80A,0x62);
-    write_cmos_sensor(0xA80B,0x83);
-    write_cmos_sensor(0xAE33,0x00);
-
-    write_cmos_sensor(0x4174,0x00);
-    write_cmos_sensor(0x4175,0x11);
-    write_cmos_sensor(0x4612,0x29);
-    write_cmos_sensor(0x461B,0x12);
-    write_cmos_sensor(0x461F,0x06);
-    write_cmos_sensor(0x4635,0x07);
-    write_cmos_sensor(0x4637,0x30);
-    write_cmos_sensor(0x463F,0x18);
-    write_cmos_sensor(0x4641,0x0D);
-    write_cmos_sensor(0x465B,0x12);
-    write_cmos_sensor(0x465F,0x11);
-    write_cmos_sensor(0x4663,0x11);
-    write_cmos_sensor(0x4667,0x0F);
-    write_cmos_sensor(0x466F,0x0F);
-    write_cmos_sensor(0x470E,0x09);
-    write_cmos_sensor(0x4909,0xAB);
-    write_cmos_sensor(0x490B,0x95);
-    write_cmos_sensor(0x4915,0x5D);
-    write_cmos_sensor(0x4A5F,0xFF);
-    write_cmos_sensor(0x4A61,0xFF);
-    write_cmos_sensor(0x4A73,0x62);
-    write_cmos_sensor(0x4A85,0x00);
-    write_cmos_sensor(0x4A87,0xFF);
-    write_cmos_sensor(0x583C,0x04);
-    write_cmos_sensor(0x620E,0x04);
-    write_cmos_sensor(0x6EB2,0x01);
-    write_cmos_sensor(0x6EB3,0x00);
-    write_cmos_sensor(0x9300,0x02);
-
-    write_cmos_sensor(0x3001,0x07);
-    write_cmos_sensor(0x6D12,0x3F);
-    write_cmos_sensor(0x6D13,0xFF);
-    write_cmos_sensor(0x9344,0x03);
-    write_cmos_sensor(0x9706,0x10);
-    write_cmos_sensor(0x9707,0x03);
-    write_cmos_sensor(0x9708,0x03);
-    write_cmos_sensor(0x9E04,0x01);
-    write_cmos_sensor(0x9E05,0x00);
-    write_cmos_sensor(0x9E0C,0x01);
-    write_cmos_sensor(0x9E0D,0x02);
-    write_cmos_sensor(0x9E24,0x00);
-    write_cmos_sensor(0x9E25,0x8C);
-    write_cmos_sensor(0x9E26,0x00);
-    write_cmos_sensor(0x9E27,0x94);
-    write_cmos_sensor(0x9E28,0x00);
-    write_cmos_sensor(0x9E29,0x96);
-    //write_cmos_sensor(0x5041,0x00);//no embedded data
-
-    write_cmos_sensor(0x69DB,0x01);
-    write_cmos_sensor(0x6957,0x01);
-    write_cmos_sensor(0x6987,0x17);
-    write_cmos_sensor(0x698A,0x03);
-    write_cmos_sensor(0x698B,0x03);
-    write_cmos_sensor(0x0B8E,0x01);
-    write_cmos_sensor(0x0B8F,0x00);
-    write_cmos_sensor(0x0B90,0x01);
-    write_cmos_sensor(0x0B91,0x00);
-    write_cmos_sensor(0x0B92,0x01);
-    write_cmos_sensor(0x0B93,0x00);
-    write_cmos_sensor(0x0B94,0x01);
-    write_cmos_sensor(0x0B95,0x00);
-    write_cmos_sensor(0x6E50,0x00);
-    write_cmos_sensor(0x6E51,0x32);
-    write_cmos_sensor(0x9340,0x00);
-    write_cmos_sensor(0x9341,0x3C);
-    write_cmos_sensor(0x9342,0x03);
-    write_cmos_sensor(0x9343,0xFF);
-    write_cmos_sensor(0x0101,0x03);
+    //init setting, streamed while open() returns; the next register access waits for it
+    kdSensorRegSeqWriteAsync(sensor_init_regs, ARRAY_SIZE(sensor_init_regs),
+			     imgsensor.i2c_write_id, sensor_init_done, NULL);
 }	/*	sensor_init  */
 
 
+static const KD_SENSOR_REG preview_setting_regs[] = {
+	KD_SENSOR_REG8(0x0100, 0x00),
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0220, 0x00),
+	KD_SENSOR_REG8(0x0221, 0x11),
+	KD_SENSOR_REG8(0x0222, 0x01),
+	KD_SENSOR_REG8(0x0340, 0x08),
+	KD_SENSOR_REG8(0x0341, 0x3E),
+	KD_SENSOR_REG8(0x0342, 0x13),
+	KD_SENSOR_REG8(0x0343, 0x90),
+	KD_SENSOR_REG8(0x0344, 0x00),
+	KD_SENSOR_REG8(0x0345, 0x00),
+	KD_SENSOR_REG8(0x0346, 0x00),
+	KD_SENSOR_REG8(0x0347, 0x00),
+	KD_SENSOR_REG8(0x0348, 0x10),
+	KD_SENSOR_REG8(0x0349, 0x6F),
+	KD_SENSOR_REG8(0x034A, 0x0C),
+	KD_SENSOR_REG8(0x034B, 0x2F),
+	KD_SENSOR_REG8(0x0381, 0x01),
+	KD_SENSOR_REG8(0x0383, 0x01),
+	KD_SENSOR_REG8(0x0385, 0x01),
+	KD_SENSOR_REG8(0x0387, 0x01),
+	KD_SENSOR_REG8(0x0900, 0x01),
+	KD_SENSOR_REG8(0x0901, 0x22),
+	KD_SENSOR_REG8(0x0902, 0x02),
+	KD_SENSOR_REG8(0x3000, 0x35),
+	KD_SENSOR_REG8(0x3054, 0x01),
+	KD_SENSOR_REG8(0x305C, 0x11),
+
+	KD_SENSOR_REG8(0x0112, 0x0A),
+	KD_SENSOR_REG8(0x0113, 0x0A),
+	KD_SENSOR_REG8(0x034C, 0x08),
+	KD_SENSOR_REG8(0x034D, 0x38),
+	KD_SENSOR_REG8(0x034E, 0x06),
+	KD_SENSOR_REG8(0x034F, 0x18),
+	KD_SENSOR_REG8(0x0401, 0x00),
+	KD_SENSOR_REG8(0x0404, 0x00),
+	KD_SENSOR_REG8(0x0405, 0x10),
+	KD_SENSOR_REG8(0x0408, 0x00),
+	KD_SENSOR_REG8(0x0409, 0x00),
+	KD_SENSOR_REG8(0x040A, 0x00),
+	KD_SENSOR_REG8(0x040B, 0x00),
+	KD_SENSOR_REG8(0x040C, 0x08),
+	KD_SENSOR_REG8(0x040D, 0x38),
+	KD_SENSOR_REG8(0x040E, 0x06),
+	KD_SENSOR_REG8(0x040F, 0x18),
+
+	KD_SENSOR_REG8(0x0301, 0x05),
+	KD_SENSOR_REG8(0x0303, 0x02),
+	KD_SENSOR_REG8(0x0305, 0x03),
+	KD_SENSOR_REG8(0x0306, 0x00),
+	KD_SENSOR_REG8(0x0307, 0x64),
+	KD_SENSOR_REG8(0x0309, 0x0A),
+	KD_SENSOR_REG8(0x030B, 0x01),
+	KD_SENSOR_REG8(0x0310, 0x00),
+
+	KD_SENSOR_REG8(0x0820, 0x0C),
+	KD_SENSOR_REG8(0x0821, 0x80),
+	KD_SENSOR_REG8(0x0822, 0x00),
+	KD_SENSOR_REG8(0x0823, 0x00),
+
+	KD_SENSOR_REG8(0x3A03, 0x06),
+	KD_SENSOR_REG8(0x3A04, 0x68),
+	KD_SENSOR_REG8(0x3A05, 0x01),
+
+	KD_SENSOR_REG8(0x0B06, 0x01),
+	KD_SENSOR_REG8(0x30A2, 0x00),
+
+	KD_SENSOR_REG8(0x30B4, 0x00),
+
+	KD_SENSOR_REG8(0x3A02, 0xFF),
+
+	KD_SENSOR_REG8(0x3011, 0x00),
+	KD_SENSOR_REG8(0x3013, 0x00),
+
+	KD_SENSOR_REG8(0x0202, 0x08),
+	KD_SENSOR_REG8(0x0203, 0x34),
+	KD_SENSOR_REG8(0x0224, 0x01),
+	KD_SENSOR_REG8(0x0225, 0xF4),
+
+	KD_SENSOR_REG8(0x0204, 0x00),
+	KD_SENSOR_REG8(0x0205, 0x00),
+	KD_SENSOR_REG8(0x020E, 0x01),
+	KD_SENSOR_REG8(0x020F, 0x00),
+	KD_SENSOR_REG8(0x0210, 0x01),
+	KD_SENSOR_REG8(0x0211, 0x00),
+	KD_SENSOR_REG8(0x0212, 0x01),
+	KD_SENSOR_REG8(0x0213, 0x00),
+	KD_SENSOR_REG8(0x0214, 0x01),
+	KD_SENSOR_REG8(0x0215, 0x00),
+	KD_SENSOR_REG8(0x0216, 0x00),
+	KD_SENSOR_REG8(0x0217, 0x00),
+
+	KD_SENSOR_REG8(0x4170, 0x00),
+	KD_SENSOR_REG8(0x4171, 0x10),
+	KD_SENSOR_REG8(0x4176, 0x00),
+	KD_SENSOR_REG8(0x4177, 0x3C),
+	KD_SENSOR_REG8(0xAE20, 0x04),
+	KD_SENSOR_REG8(0xAE21, 0x5C),
+
+	KD_SENSOR_REG8(0x0138, 0x01),
+	KD_SENSOR_REG8(0x0100, 0x01),
+};
+
 static void preview_setting(void)
 {
 	//Preview 2104*1560 30fps 24M MCLK 4lane 608Mbps/lane
 	// preview 30.01fps
-    write_cmos_sensor(0x0100,0x00);
-    write_cmos_sensor(0x0114,0x03);
-    write_cmos_sensor(0x0220,0x00);
-    write_cmos_sensor(0x0221,0x11);
-    write_cmos_sensor(0x0222,0x01);
-    write_cmos_sensor(0x0340,0x08);
-    write_cmos_sensor(0x0341,0x3E);
-    write_cmos_sensor(0x0342,0x13);
-    write_cmos_sensor(0x0343,0x90);
-    write_cmos_sensor(0x0344,0x00);
-    write_cmos_sensor(0x0345,0x00);
-    write_cmos_sensor(0x0346,0x00);
-    write_cmos_sensor(0x0347,0x00);
-    write_cmos_sensor(0x0348,0x10);
-    write_cmos_sensor(0x0349,0x6F);
-    write_cmos_sensor(0x034A,0x0C);
-    write_cmos_sensor(0x034B,0x2F);
-    write_cmos_sensor(0x0381,0x01);
-    write_cmos_sensor(0x0383,0x01);
-    write_cmos_sensor(0x0385,0x01);
-    write_cmos_sensor(0x0387,0x01);
-    write_cmos_sensor(0x0900,0x01);
-    write_cmos_sensor(0x0901,0x22);
-    write_cmos_sensor(0x0902,0x02);
-    write_cmos_sensor(0x3000,0x35);
-    write_cmos_sensor(0x3054,0x01);
-    write_cmos_sensor(0x305C,0x11);
-
-    write_cmos_sensor(0x0112,0x0A);
-    write_cmos_sensor(0x0113,0x0A);
-    write_cmos_sensor(0x034C,0x08);
-    write_cmos_sensor(0x034D,0x38);
-    write_cmos_sensor(0x034E,0x06);
-    write_cmos_sensor(0x034F,0x18);
-    write_cmos_sensor(0x0401,0x00);
-    write_cmos_sensor(0x0404,0x00);
-    write_cmos_sensor(0x0405,0x10);
-    write_cmos_sensor(0x0408,0x00);
-    write_cmos_sensor(0x0409,0x00);
-    write_cmos_sensor(0x040A,0x00);
-    write_cmos_sensor(0x040B,0x00);
-    write_cmos_sensor(0x040C,0x08);
-    write_cmos_sensor(0x040D,0x38);
-    write_cmos_sensor(0x040E,0x06);
-    write_cmos_sensor(0x040F,0x18);
-
-    write_cmos_sensor(0x0301,0x05);
-    write_cmos_sensor(0x0303,0x02);
-    write_cmos_sensor(0x0305,0x03);
-    write_cmos_sensor(0x0306,0x00);
-    write_cmos_sensor(0x0307,0x64);
-    write_cmos_sensor(0x0309,0x0A);
-    write_cmos_sensor(0x030B,0x01);
-    write_cmos_sensor(0x0310,0x00);
-
-    write_cmos_sensor(0x0820,0x0C);
-    write_cmos_sensor(0x0821,0x80);
-    write_cmos_sensor(0x0822,0x00);
-    write_cmos_sensor(0x0823,0x00);
-
-    write_cmos_sensor(0x3A03,0x06);
-    write_cmos_sensor(0x3A04,0x68);
-    write_cmos_sensor(0x3A05,0x01);
-
-    write_cmos_sensor(0x0B06,0x01);
-    write_cmos_sensor(0x30A2,0x00);
-
-    write_cmos_sensor(0x30B4,0x00);
-
-    write_cmos_sensor(0x3A02,0xFF);
-
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x00);
-
-    write_cmos_sensor(0x0202,0x08);
-    write_cmos_sensor(0x0203,0x34);
-    write_cmos_sensor(0x0224,0x01);
-    write_cmos_sensor(0x0225,0xF4);
-
-    write_cmos_sensor(0x0204,0x00);
-    write_cmos_sensor(0x0205,0x00);
-    write_cmos_sensor(0x020E,0x01);
-    write_cmos_sensor(0x020F,0x00);
-    write_cmos_sensor(0x0210,0x01);
-    write_cmos_sensor(0x0211,0x00);
-    write_cmos_sensor(0x0212,0x01);
-    write_cmos_sensor(0x0213,0x00);
-    write_cmos_sensor(0x0214,0x01);
-    write_cmos_sensor(0x0215,0x00);
-    write_cmos_sensor(0x0216,0x00);
-    write_cmos_sensor(0x0217,0x00);
-
-    write_cmos_sensor(0x4170,0x00);
-    write_cmos_sensor(0x4171,0x10);
-    write_cmos_sensor(0x4176,0x00);
-    write_cmos_sensor(0x4177,0x3C);
-    write_cmos_sensor(0xAE20,0x04);
-    write_cmos_sensor(0xAE21,0x5C);
-
-    write_cmos_sensor(0x0138,0x01);
-    write_cmos_sensor(0x0100,0x01);
+    write_cmos_sensor_table(preview_setting_regs);
 }   /*  preview_setting  */
 
+static const KD_SENSOR_REG preview_setting_HDR_regs[] = {
+	KD_SENSOR_REG8(0x0100, 0x00),
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0220, 0x01),
+	KD_SENSOR_REG8(0x0221, 0x22),
+	KD_SENSOR_REG8(0x0222, 0x08),
+	KD_SENSOR_REG8(0x0340, 0x08),
+	KD_SENSOR_REG8(0x0341, 0x3E),
+	KD_SENSOR_REG8(0x0342, 0x13),
+	KD_SENSOR_REG8(0x0343, 0x90),
+	KD_SENSOR_REG8(0x0344, 0x00),
+	KD_SENSOR_REG8(0x0345, 0x00),
+	KD_SENSOR_REG8(0x0346, 0x00),
+	KD_SENSOR_REG8(0x0347, 0x00),
+	KD_SENSOR_REG8(0x0348, 0x10),
+	KD_SENSOR_REG8(0x0349, 0x6F),
+	KD_SENSOR_REG8(0x034A, 0x0C),
+	KD_SENSOR_REG8(0x034B, 0x2F),
+	KD_SENSOR_REG8(0x0381, 0x01),
+	KD_SENSOR_REG8(0x0383, 0x01),
+	KD_SENSOR_REG8(0x0385, 0x01),
+	KD_SENSOR_REG8(0x0387, 0x01),
+	KD_SENSOR_REG8(0x0900, 0x00),
+	KD_SENSOR_REG8(0x0901, 0x00),
+	KD_SENSOR_REG8(0x0902, 0x00),
+	KD_SENSOR_REG8(0x3000, 0x35),
+	KD_SENSOR_REG8(0x3054, 0x01),
+	KD_SENSOR_REG8(0x305C, 0x11),
+
+	KD_SENSOR_REG8(0x0112, 0x0A),
+	KD_SENSOR_REG8(0x0113, 0x0A),
+	KD_SENSOR_REG8(0x034C, 0x08),
+	KD_SENSOR_REG8(0x034D, 0x38),
+	KD_SENSOR_REG8(0x034E, 0x06),
+	KD_SENSOR_REG8(0x034F, 0x18),
+	KD_SENSOR_REG8(0x0401, 0x00),
+	KD_SENSOR_REG8(0x0404, 0x00),
+	KD_SENSOR_REG8(0x0405, 0x10),
+	KD_SENSOR_REG8(0x0408, 0x00),
+	KD_SENSOR_REG8(0x0409, 0x00),
+	KD_SENSOR_REG8(0x040A, 0x00),
+	KD_SENSOR_REG8(0x040B, 0x00),
+	KD_SENSOR_REG8(0x040C, 0x08),
+	KD_SENSOR_REG8(0x040D, 0x38),
+	KD_SENSOR_REG8(0x040E, 0x06),
+	KD_SENSOR_REG8(0x040F, 0x18),
+
+	KD_SENSOR_REG8(0x0301, 0x05),
+	KD_SENSOR_REG8(0x0303, 0x02),
+	KD_SENSOR_REG8(0x0305, 0x03),
+	KD_SENSOR_REG8(0x0306, 0x00),
+	KD_SENSOR_REG8(0x0307, 0x64),
+	KD_SENSOR_REG8(0x0309, 0x0A),
+	KD_SENSOR_REG8(0x030B, 0x01),
+	KD_SENSOR_REG8(0x0310, 0x00),
+
+	KD_SENSOR_REG8(0x0820, 0x0C),
+	KD_SENSOR_REG8(0x0821, 0x80),
+	KD_SENSOR_REG8(0x0822, 0x00),
+	KD_SENSOR_REG8(0x0823, 0x00),
+
+	KD_SENSOR_REG8(0x3A03, 0x06),
+	KD_SENSOR_REG8(0x3A04, 0xE8),
+	KD_SENSOR_REG8(0x3A05, 0x01),
+
+	KD_SENSOR_REG8(0x0B06, 0x01),
+	KD_SENSOR_REG8(0x30A2, 0x00),
+
+	KD_SENSOR_REG8(0x30B4, 0x00),
+
+	KD_SENSOR_REG8(0x3A02, 0x06),
+
+	KD_SENSOR_REG8(0x3011, 0x00),
+	KD_SENSOR_REG8(0x3013, 0x01),
+
+	KD_SENSOR_REG8(0x0202, 0x08),
+	KD_SENSOR_REG8(0x0203, 0x34),
+	KD_SENSOR_REG8(0x0224, 0x01),
+	KD_SENSOR_REG8(0x0225, 0x06),
+
+	KD_SENSOR_REG8(0x0204, 0x00),
+	KD_SENSOR_REG8(0x0205, 0x00),
+	KD_SENSOR_REG8(0x020E, 0x01),
+	KD_SENSOR_REG8(0x020F, 0x00),
+	KD_SENSOR_REG8(0x0210, 0x01),
+	KD_SENSOR_REG8(0x0211, 0x00),
+	KD_SENSOR_REG8(0x0212, 0x01),
+	KD_SENSOR_REG8(0x0213, 0x00),
+	KD_SENSOR_REG8(0x0214, 0x01),
+	KD_SENSOR_REG8(0x0215, 0x00),
+	KD_SENSOR_REG8(0x0216, 0x00),
+	KD_SENSOR_REG8(0x0217, 0x00),
+
+	KD_SENSOR_REG8(0x4170, 0x00),
+	KD_SENSOR_REG8(0x4171, 0x10),
+	KD_SENSOR_REG8(0x4176, 0x00),
+	KD_SENSOR_REG8(0x4177, 0x3C),
+	KD_SENSOR_REG8(0xAE20, 0x04),
+	KD_SENSOR_REG8(0xAE21, 0x5C),
+	//mHDR  relation setting
+	KD_SENSOR_REG8(0x3010, 0x00),
+	KD_SENSOR_REG8(0x6D3A, 0x00), // 0: 16X16, 1:8X8
+	KD_SENSOR_REG8(0x3011, 0x00),
+	KD_SENSOR_REG8(0x3013, 0x01), // STATS output Enable
+	KD_SENSOR_REG8(0x5068, 0x35),
+	KD_SENSOR_REG8(0x5069, 0x01),
+	KD_SENSOR_REG8(0x30C2, 0x00),
+	KD_SENSOR_REG8(0x30C3, 0x40),
+	KD_SENSOR_REG8(0x610A, 0x08),
+	//[0]:1 hdr enable, [1]:0 LE/SE use same gain, 1 LE/SE separate gain
+	//[5]:0 auto, 1:direct
+	KD_SENSOR_REG8(0x0220, 0x01),
+	// hdr binning mode
+	KD_SENSOR_REG8(0x0221, 0x22),
+	//LE/SE ration 1,2,4,8
+	KD_SENSOR_REG8(0x0222, 0x08),
+};
+
+static const KD_SENSOR_REG preview_setting_HDR_regs_2[] = {
+	KD_SENSOR_REG8(0x30b2, 0x01),
+	KD_SENSOR_REG8(0x30b3, 0x01),
+	KD_SENSOR_REG8(0x30b4, 0x01),
+	KD_SENSOR_REG8(0x30b5, 0x01),
+	KD_SENSOR_REG8(0x30b6, 0x01),
+	KD_SENSOR_REG8(0x30b7, 0x01),
+	KD_SENSOR_REG8(0x30b8, 0x01),
+	KD_SENSOR_REG8(0x30b9, 0x01),
+	KD_SENSOR_REG8(0x30ba, 0x01),
+	KD_SENSOR_REG8(0x30bb, 0x01),
+	KD_SENSOR_REG8(0x30bc, 0x01),
+};
+
+static const KD_SENSOR_REG preview_setting_HDR_regs_3[] = {
+	KD_SENSOR_REG8(0x30b2, 0x00),
+	KD_SENSOR_REG8(0x30b3, 0x00),
+	KD_SENSOR_REG8(0x30b4, 0x00),
+	KD_SENSOR_REG8(0x30b5, 0x00),
+	KD_SENSOR_REG8(0x30b6, 0x00),
+	KD_SENSOR_REG8(0x30b7, 0x00),
+	KD_SENSOR_REG8(0x30b8, 0x00),
+	KD_SENSOR_REG8(0x30b9, 0x00),
+	KD_SENSOR_REG8(0x30ba, 0x00),
+	KD_SENSOR_REG8(0x30bb, 0x00),
+	KD_SENSOR_REG8(0x30bc, 0x00),
+};
+
 static void preview_setting_HDR(void)
 {
     LOG_INF("preview_setting_mHDR\n");
-    write_cmos_sensor(0x0100,0x00);
-    write_cmos_sensor(0x0114,0x03);
-    write_cmos_sensor(0x0220,0x01);
-    write_cmos_sensor(0x0221,0x22);
-    write_cmos_sensor(0x0222,0x08);
-    write_cmos_sensor(0x0340,0x08);
-    write_cmos_sensor(0x0341,0x3E);
-    write_cmos_sensor(0x0342,0x13);
-    write_cmos_sensor(0x0343,0x90);
-    write_cmos_sensor(0x0344,0x00);
-    write_cmos_sensor(0x0345,0x00);
-    write_cmos_sensor(0x0346,0x00);
-    write_cmos_sensor(0x0347,0x00);
-    write_cmos_sensor(0x0348,0x10);
-    write_cmos_sensor(0x0349,0x6F);
-    write_cmos_sensor(0x034A,0x0C);
-    write_cmos_sensor(0x034B,0x2F);
-    write_cmos_sensor(0x0381,0x01);
-    write_cmos_sensor(0x0383,0x01);
-    write_cmos_sensor(0x0385,0x01);
-    write_cmos_sensor(0x0387,0x01);
-    write_cmos_sensor(0x0900,0x00);
-    write_cmos_sensor(0x0901,0x00);
-    write_cmos_sensor(0x0902,0x00);
-    write_cmos_sensor(0x3000,0x35);
-    write_cmos_sensor(0x3054,0x01);
-    write_cmos_sensor(0x305C,0x11);
-
-    write_cmos_sensor(0x0112,0x0A);
-    write_cmos_sensor(0x0113,0x0A);
-    write_cmos_sensor(0x034C,0x08);
-    write_cmos_sensor(0x034D,0x38);
-    write_cmos_sensor(0x034E,0x06);
-    write_cmos_sensor(0x034F,0x18);
-    write_cmos_sensor(0x0401,0x00);
-    write_cmos_sensor(0x0404,0x00);
-    write_cmos_sensor(0x0405,0x10);
-    write_cmos_sensor(0x0408,0x00);
-    write_cmos_sensor(0x0409,0x00);
-    write_cmos_sensor(0x040A,0x00);
-    write_cmos_sensor(0x040B,0x00);
-    write_cmos_sensor(0x040C,0x08);
-    write_cmos_sensor(0x040D,0x38);
-    write_cmos_sensor(0x040E,0x06);
-    write_cmos_sensor(0x040F,0x18);
-
-    write_cmos_sensor(0x0301,0x05);
-    write_cmos_sensor(0x0303,0x02);
-    write_cmos_sensor(0x0305,0x03);
-    write_cmos_sensor(0x0306,0x00);
-    write_cmos_sensor(0x0307,0x64);
-    write_cmos_sensor(0x0309,0x0A);
-    write_cmos_sensor(0x030B,0x01);
-    write_cmos_sensor(0x0310,0x00);
-
-    write_cmos_sensor(0x0820,0x0C);
-    write_cmos_sensor(0x0821,0x80);
-    write_cmos_sensor(0x0822,0x00);
-    write_cmos_sensor(0x0823,0x00);
-
-    write_cmos_sensor(0x3A03,0x06);
-    write_cmos_sensor(0x3A04,0xE8);
-    write_cmos_sensor(0x3A05,0x01);
-
-    write_cmos_sensor(0x0B06,0x01);
-    write_cmos_sensor(0x30A2,0x00);
-
-    write_cmos_sensor(0x30B4,0x00);
-
-    write_cmos_sensor(0x3A02,0x06);
-
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x01);
-
-    write_cmos_sensor(0x0202,0x08);
-    write_cmos_sensor(0x0203,0x34);
-    write_cmos_sensor(0x0224,0x01);
-    write_cmos_sensor(0x0225,0x06);
-
-    write_cmos_sensor(0x0204,0x00);
-    write_cmos_sensor(0x0205,0x00);
-    write_cmos_sensor(0x020E,0x01);
-    write_cmos_sensor(0x020F,0x00);
-    write_cmos_sensor(0x0210,0x01);
-    write_cmos_sensor(0x0211,0x00);
-    write_cmos_sensor(0x0212,0x01);
-    write_cmos_sensor(0x0213,0x00);
-    write_cmos_sensor(0x0214,0x01);
-    write_cmos_sensor(0x0215,0x00);
-    write_cmos_sensor(0x0216,0x00);
-    write_cmos_sensor(0x0217,0x00);
-
-    write_cmos_sensor(0x4170,0x00);
-    write_cmos_sensor(0x4171,0x10);
-    write_cmos_sensor(0x4176,0x00);
-    write_cmos_sensor(0x4177,0x3C);
-    write_cmos_sensor(0xAE20,0x04);
-    write_cmos_sensor(0xAE21,0x5C);
-    //mHDR  relation setting
-    write_cmos_sensor(0x3010,0x00);
-    write_cmos_sensor(0x6D3A,0x00); // 0: 16X16, 1:8X8
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x01); // STATS output Enable
-    write_cmos_sensor(0x5068,0x35);
-    write_cmos_sensor(0x5069,0x01);
-    write_cmos_sensor(0x30C2,0x00);
-    write_cmos_sensor(0x30C3,0x40);
-    write_cmos_sensor(0x610A,0x08);
-    //[0]:1 hdr enable, [1]:0 LE/SE use same gain, 1 LE/SE separate gain
-    //[5]:0 auto, 1:direct
-    write_cmos_sensor(0x0220,0x01);
-    // hdr binning mode
-    write_cmos_sensor(0x0221,0x22);
-    //LE/SE ration 1,2,4,8
-    write_cmos_sensor(0x0222,0x08);
+    write_cmos_sensor_table(preview_setting_HDR_regs);
     //ATR
     imx214_ATR(3,3);
 #if 0
@@ -1112,31 +1162,11 @@ static void preview_setting_HDR(void)
     // Normal: 0x00, ZigZag: 0x01
     if(imgsensor.ihdr_mode == 9)
     {
-        write_cmos_sensor(0x30b2,0x01);
-        write_cmos_sensor(0x30b3,0x01);
-        write_cmos_sensor(0x30b4,0x01);
-        write_cmos_sensor(0x30b5,0x01);
-        write_cmos_sensor(0x30b6,0x01);
-        write_cmos_sensor(0x30b7,0x01);
-        write_cmos_sensor(0x30b8,0x01);
-        write_cmos_sensor(0x30b9,0x01);
-        write_cmos_sensor(0x30ba,0x01);
-        write_cmos_sensor(0x30bb,0x01);
-        write_cmos_sensor(0x30bc,0x01);
+        write_cmos_sensor_table(preview_setting_HDR_regs_2);
     }
     else
     {
-        write_cmos_sensor(0x30b2,0x00);
-        write_cmos_sensor(0x30b3,0x00);
-        write_cmos_sensor(0x30b4,0x00);
-        write_cmos_sensor(0x30b5,0x00);
-        write_cmos_sensor(0x30b6,0x00);
-        write_cmos_sensor(0x30b7,0x00);
-        write_cmos_sensor(0x30b8,0x00);
-        write_cmos_sensor(0x30b9,0x00);
-        write_cmos_sensor(0x30ba,0x00);
-        write_cmos_sensor(0x30bb,0x00);
-        write_cmos_sensor(0x30bc,0x00);
+        write_cmos_sensor_table(preview_setting_HDR_regs_3);
     }
 
     write_cmos_sensor(0x0138,0x01);
@@ -1145,6 +1175,306 @@ static void preview_setting_HDR(void)
 
 }	/*	preview_setting  */
 
+static const KD_SENSOR_REG capture_setting_regs[] = {
+	KD_SENSOR_REG8(0x0100, 0x00),
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0220, 0x00),
+	KD_SENSOR_REG8(0x0221, 0x11),
+	KD_SENSOR_REG8(0x0222, 0x01),
+	KD_SENSOR_REG8(0x0340, 0x0C),
+	KD_SENSOR_REG8(0x0341, 0x58),
+	KD_SENSOR_REG8(0x0342, 0x13),
+	KD_SENSOR_REG8(0x0343, 0x90),
+	KD_SENSOR_REG8(0x0344, 0x00),
+	KD_SENSOR_REG8(0x0345, 0x00),
+	KD_SENSOR_REG8(0x0346, 0x00),
+	KD_SENSOR_REG8(0x0347, 0x00),
+	KD_SENSOR_REG8(0x0348, 0x10),
+	KD_SENSOR_REG8(0x0349, 0x6F),
+	KD_SENSOR_REG8(0x034A, 0x0C),
+	KD_SENSOR_REG8(0x034B, 0x2F),
+	KD_SENSOR_REG8(0x0381, 0x01),
+	KD_SENSOR_REG8(0x0383, 0x01),
+	KD_SENSOR_REG8(0x0385, 0x01),
+	KD_SENSOR_REG8(0x0387, 0x01),
+	KD_SENSOR_REG8(0x0900, 0x00),
+	KD_SENSOR_REG8(0x0901, 0x00),
+	KD_SENSOR_REG8(0x0902, 0x00),
+	KD_SENSOR_REG8(0x3000, 0x35),
+	KD_SENSOR_REG8(0x3054, 0x01),
+	KD_SENSOR_REG8(0x305C, 0x11),
+
+	KD_SENSOR_REG8(0x0112, 0x0A),
+	KD_SENSOR_REG8(0x0113, 0x0A),
+	KD_SENSOR_REG8(0x034C, 0x10),
+	KD_SENSOR_REG8(0x034D, 0x70),
+	KD_SENSOR_REG8(0x034E, 0x0C),
+	KD_SENSOR_REG8(0x034F, 0x30),
+	KD_SENSOR_REG8(0x0401, 0x00),
+	KD_SENSOR_REG8(0x0404, 0x00),
+	KD_SENSOR_REG8(0x0405, 0x10),
+	KD_SENSOR_REG8(0x0408, 0x00),
+	KD_SENSOR_REG8(0x0409, 0x00),
+	KD_SENSOR_REG8(0x040A, 0x00),
+	KD_SENSOR_REG8(0x040B, 0x00),
+	KD_SENSOR_REG8(0x040C, 0x10),
+	KD_SENSOR_REG8(0x040D, 0x70),
+	KD_SENSOR_REG8(0x040E, 0x0C),
+	KD_SENSOR_REG8(0x040F, 0x30),
+
+	KD_SENSOR_REG8(0x0301, 0x05),
+	KD_SENSOR_REG8(0x0303, 0x02),
+	KD_SENSOR_REG8(0x0305, 0x03),
+	KD_SENSOR_REG8(0x0306, 0x00),
+	KD_SENSOR_REG8(0x0307, 0x96),
+	KD_SENSOR_REG8(0x0309, 0x0A),
+	KD_SENSOR_REG8(0x030B, 0x01),
+	KD_SENSOR_REG8(0x0310, 0x00),
+
+	KD_SENSOR_REG8(0x0820, 0x12),
+	KD_SENSOR_REG8(0x0821, 0xC0),
+	KD_SENSOR_REG8(0x0822, 0x00),
+	KD_SENSOR_REG8(0x0823, 0x00),
+
+	KD_SENSOR_REG8(0x3A03, 0x09),
+	KD_SENSOR_REG8(0x3A04, 0x20),
+	KD_SENSOR_REG8(0x3A05, 0x01),
+
+	KD_SENSOR_REG8(0x0B06, 0x01),
+	KD_SENSOR_REG8(0x30A2, 0x00),
+
+	KD_SENSOR_REG8(0x30B4, 0x00),
+
+	KD_SENSOR_REG8(0x3A02, 0xff),
+
+	KD_SENSOR_REG8(0x3011, 0x00),
+	KD_SENSOR_REG8(0x3013, 0x01),
+
+	KD_SENSOR_REG8(0x0202, 0x0C),
+	KD_SENSOR_REG8(0x0203, 0x4E),
+	KD_SENSOR_REG8(0x0224, 0x01),
+	KD_SENSOR_REG8(0x0225, 0xF4),
+
+	KD_SENSOR_REG8(0x0204, 0x00),
+	KD_SENSOR_REG8(0x0205, 0x00),
+	KD_SENSOR_REG8(0x020E, 0x01),
+	KD_SENSOR_REG8(0x020F, 0x00),
+	KD_SENSOR_REG8(0x0210, 0x01),
+	KD_SENSOR_REG8(0x0211, 0x00),
+	KD_SENSOR_REG8(0x0212, 0x01),
+	KD_SENSOR_REG8(0x0213, 0x00),
+	KD_SENSOR_REG8(0x0214, 0x01),
+	KD_SENSOR_REG8(0x0215, 0x00),
+	KD_SENSOR_REG8(0x0216, 0x00),
+	KD_SENSOR_REG8(0x0217, 0x00),
+
+	KD_SENSOR_REG8(0x4170, 0x00),
+	KD_SENSOR_REG8(0x4171, 0x10),
+	KD_SENSOR_REG8(0x4176, 0x00),
+	KD_SENSOR_REG8(0x4177, 0x3C),
+	KD_SENSOR_REG8(0xAE20, 0x04),
+	KD_SENSOR_REG8(0xAE21, 0x5C),
+
+	KD_SENSOR_REG8(0x0138, 0x01),
+	KD_SENSOR_REG8(0x0100, 0x01),
+};
+
+static const KD_SENSOR_REG capture_setting_regs_2[] = {
+	KD_SENSOR_REG8(0x0100, 0x00),
+
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0220, 0x00),
+	KD_SENSOR_REG8(0x0221, 0x11),
+	KD_SENSOR_REG8(0x0222, 0x01),
+	KD_SENSOR_REG8(0x0340, 0x0C),
+	KD_SENSOR_REG8(0x0341, 0x94),
+	KD_SENSOR_REG8(0x0342, 0x13),
+	KD_SENSOR_REG8(0x0343, 0x90),
+	KD_SENSOR_REG8(0x0344, 0x00),
+	KD_SENSOR_REG8(0x0345, 0x00),
+	KD_SENSOR_REG8(0x0346, 0x00),
+	KD_SENSOR_REG8(0x0347, 0x00),
+	KD_SENSOR_REG8(0x0348, 0x10),
+	KD_SENSOR_REG8(0x0349, 0x6F),
+	KD_SENSOR_REG8(0x034A, 0x0C),
+	KD_SENSOR_REG8(0x034B, 0x2F),
+	KD_SENSOR_REG8(0x0381, 0x01),
+	KD_SENSOR_REG8(0x0383, 0x01),
+	KD_SENSOR_REG8(0x0385, 0x01),
+	KD_SENSOR_REG8(0x0387, 0x01),
+	KD_SENSOR_REG8(0x0900, 0x00),
+	KD_SENSOR_REG8(0x0901, 0x00),
+	KD_SENSOR_REG8(0x0902, 0x00),
+	KD_SENSOR_REG8(0x3000, 0x35),
+	KD_SENSOR_REG8(0x3054, 0x01),
+	KD_SENSOR_REG8(0x305C, 0x11),
+
+	KD_SENSOR_REG8(0x0112, 0x0A),
+	KD_SENSOR_REG8(0x0113, 0x0A),
+	KD_SENSOR_REG8(0x034C, 0x10),
+	KD_SENSOR_REG8(0x034D, 0x70),
+	KD_SENSOR_REG8(0x034E, 0x0C),
+	KD_SENSOR_REG8(0x034F, 0x30),
+	KD_SENSOR_REG8(0x0401, 0x00),
+	KD_SENSOR_REG8(0x0404, 0x00),
+	KD_SENSOR_REG8(0x0405, 0x10),
+	KD_SENSOR_REG8(0x0408, 0x00),
+	KD_SENSOR_REG8(0x0409, 0x00),
+	KD_SENSOR_REG8(0x040A, 0x00),
+	KD_SENSOR_REG8(0x040B, 0x00),
+	KD_SENSOR_REG8(0x040C, 0x10),
+	KD_SENSOR_REG8(0x040D, 0x70),
+	KD_SENSOR_REG8(0x040E, 0x0C),
+	KD_SENSOR_REG8(0x040F, 0x30),
+
+	KD_SENSOR_REG8(0x0301, 0x05),
+	KD_SENSOR_REG8(0x0303, 0x02),
+	KD_SENSOR_REG8(0x0305, 0x03),
+	KD_SENSOR_REG8(0x0306, 0x00),
+	KD_SENSOR_REG8(0x0307, 0x79),
+	KD_SENSOR_REG8(0x0309, 0x0A),
+	KD_SENSOR_REG8(0x030B, 0x01),
+	KD_SENSOR_REG8(0x0310, 0x00),
+
+	KD_SENSOR_REG8(0x0820, 0x0F),
+	KD_SENSOR_REG8(0x0821, 0x20),
+	KD_SENSOR_REG8(0x0822, 0x00),
+	KD_SENSOR_REG8(0x0823, 0x00),
+
+	KD_SENSOR_REG8(0x3A03, 0x08),
+	KD_SENSOR_REG8(0x3A04, 0xC0),
+	KD_SENSOR_REG8(0x3A05, 0x02),
+
+	KD_SENSOR_REG8(0x0B06, 0x01),
+	KD_SENSOR_REG8(0x30A2, 0x00),
+	KD_SENSOR_REG8(0x30B4, 0x00),
+	KD_SENSOR_REG8(0x3A02, 0xFF),
+	KD_SENSOR_REG8(0x3013, 0x00),
+	KD_SENSOR_REG8(0x0202, 0x0C),
+	KD_SENSOR_REG8(0x0203, 0x8A),
+	KD_SENSOR_REG8(0x0224, 0x01),
+	KD_SENSOR_REG8(0x0225, 0xF4),
+	KD_SENSOR_REG8(0x0204, 0x00),
+	KD_SENSOR_REG8(0x0205, 0x00),
+	KD_SENSOR_REG8(0x020E, 0x01),
+	KD_SENSOR_REG8(0x020F, 0x00),
+	KD_SENSOR_REG8(0x0210, 0x01),
+	KD_SENSOR_REG8(0x0211, 0x00),
+	KD_SENSOR_REG8(0x0212, 0x01),
+	KD_SENSOR_REG8(0x0213, 0x00),
+	KD_SENSOR_REG8(0x0214, 0x01),
+	KD_SENSOR_REG8(0x0215, 0x00),
+	KD_SENSOR_REG8(0x0216, 0x00),
+	KD_SENSOR_REG8(0x0217, 0x00),
+	KD_SENSOR_REG8(0x4170, 0x00),
+	KD_SENSOR_REG8(0x4171, 0x10),
+	KD_SENSOR_REG8(0x4176, 0x00),
+	KD_SENSOR_REG8(0x4177, 0x3C),
+	KD_SENSOR_REG8(0xAE20, 0x04),
+	KD_SENSOR_REG8(0xAE21, 0x5C),
+
+	KD_SENSOR_REG8(0x0138, 0x01),
+	KD_SENSOR_REG8(0x0100, 0x01),
+};
+
+static const KD_SENSOR_REG capture_setting_regs_3[] = {
+	KD_SENSOR_REG8(0x0100, 0x00),
+
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0220, 0x00),
+	KD_SENSOR_REG8(0x0221, 0x11),
+	KD_SENSOR_REG8(0x0222, 0x01),
+	KD_SENSOR_REG8(0x0340, 0x0C),
+	KD_SENSOR_REG8(0x0341, 0x94),
+	KD_SENSOR_REG8(0x0342, 0x13),
+	KD_SENSOR_REG8(0x0343, 0x90),
+	KD_SENSOR_REG8(0x0344, 0x00),
+	KD_SENSOR_REG8(0x0345, 0x00),
+	KD_SENSOR_REG8(0x0346, 0x00),
+	KD_SENSOR_REG8(0x0347, 0x00),
+	KD_SENSOR_REG8(0x0348, 0x10),
+	KD_SENSOR_REG8(0x0349, 0x6F),
+	KD_SENSOR_REG8(0x034A, 0x0C),
+	KD_SENSOR_REG8(0x034B, 0x2F),
+	KD_SENSOR_REG8(0x0381, 0x01),
+	KD_SENSOR_REG8(0x0383, 0x01),
+	KD_SENSOR_REG8(0x0385, 0x01),
+	KD_SENSOR_REG8(0x0387, 0x01),
+	KD_SENSOR_REG8(0x0900, 0x00),
+	KD_SENSOR_REG8(0x0901, 0x00),
+	KD_SENSOR_REG8(0x0902, 0x00),
+	KD_SENSOR_REG8(0x3000, 0x35),
+	KD_SENSOR_REG8(0x3054, 0x01),
+	KD_SENSOR_REG8(0x305C, 0x11),
+
+	KD_SENSOR_REG8(0x0112, 0x0A),
+	KD_SENSOR_REG8(0x0113, 0x0A),
+	KD_SENSOR_REG8(0x034C, 0x10),
+	KD_SENSOR_REG8(0x034D, 0x70),
+	KD_SENSOR_REG8(0x034E, 0x0C),
+	KD_SENSOR_REG8(0x034F, 0x30),
+	KD_SENSOR_REG8(0x0401, 0x00),
+	KD_SENSOR_REG8(0x0404, 0x00),
+	KD_SENSOR_REG8(0x0405, 0x10),
+	KD_SENSOR_REG8(0x0408, 0x00),
+	KD_SENSOR_REG8(0x0409, 0x00),
+	KD_SENSOR_REG8(0x040A, 0x00),
+	KD_SENSOR_REG8(0x040B, 0x00),
+	KD_SENSOR_REG8(0x040C, 0x10),
+	KD_SENSOR_REG8(0x040D, 0x70),
+	KD_SENSOR_REG8(0x040E, 0x0C),
+	KD_SENSOR_REG8(0x040F, 0x30),
+
+	KD_SENSOR_REG8(0x0301, 0x05),
+	KD_SENSOR_REG8(0x0303, 0x02),
+	KD_SENSOR_REG8(0x0305, 0x03),
+	KD_SENSOR_REG8(0x0306, 0x00),
+	KD_SENSOR_REG8(0x0307, 0x4c),
+	KD_SENSOR_REG8(0x0309, 0x0A),
+	KD_SENSOR_REG8(0x030B, 0x01),
+	KD_SENSOR_REG8(0x0310, 0x00),
+
+	KD_SENSOR_REG8(0x0820, 0x09),
+	KD_SENSOR_REG8(0x0821, 0x80),
+	KD_SENSOR_REG8(0x0822, 0x00),
+	KD_SENSOR_REG8(0x0823, 0x00),
+
+	KD_SENSOR_REG8(0x3A03, 0x08),
+	KD_SENSOR_REG8(0x3A04, 0xC0),
+	KD_SENSOR_REG8(0x3A05, 0x02),
+
+	KD_SENSOR_REG8(0x0B06, 0x01),
+	KD_SENSOR_REG8(0x30A2, 0x00),
+	KD_SENSOR_REG8(0x30B4, 0x00),
+	KD_SENSOR_REG8(0x3A02, 0xFF),
+	KD_SENSOR_REG8(0x3013, 0x00),
+	KD_SENSOR_REG8(0x0202, 0x0C),
+	KD_SENSOR_REG8(0x0203, 0x8A),
+	KD_SENSOR_REG8(0x0224, 0x01),
+	KD_SENSOR_REG8(0x0225, 0xF4),
+	KD_SENSOR_REG8(0x0204, 0x00),
+	KD_SENSOR_REG8(0x0205, 0x00),
+	KD_SENSOR_REG8(0x020E, 0x01),
+	KD_SENSOR_REG8(0x020F, 0x00),
+	KD_SENSOR_REG8(0x0210, 0x01),
+	KD_SENSOR_REG8(0x0211, 0x00),
+	KD_SENSOR_REG8(0x0212, 0x01),
+	KD_SENSOR_REG8(0x0213, 0x00),
+	KD_SENSOR_REG8(0x0214, 0x01),
+	KD_SENSOR_REG8(0x0215, 0x00),
+	KD_SENSOR_REG8(0x0216, 0x00),
+	KD_SENSOR_REG8(0x0217, 0x00),
+	KD_SENSOR_REG8(0x4170, 0x00),
+	KD_SENSOR_REG8(0x4171, 0x10),
+	KD_SENSOR_REG8(0x4176, 0x00),
+	KD_SENSOR_REG8(0x4177, 0x3C),
+	KD_SENSOR_REG8(0xAE20, 0x04),
+	KD_SENSOR_REG8(0xAE21, 0x5C),
+
+	KD_SENSOR_REG8(0x0138, 0x01),
+	KD_SENSOR_REG8(0x0100, 0x01),
+};
+
 static void capture_setting(kal_uint16 currefps)
 {
 	LOG_INF("E! currefps:%d\n",currefps);
@@ -1154,667 +1484,399 @@ static void capture_setting(kal_uint16 currefps)
     if(currefps==300)
     {
         // full size 30.33ps
-        write_cmos_sensor(0x0100,0x00);
-        write_cmos_sensor(0x0114,0x03);
-        write_cmos_sensor(0x0220,0x00);
-        write_cmos_sensor(0x0221,0x11);
-        write_cmos_sensor(0x0222,0x01);
-        write_cmos_sensor(0x0340,0x0C);
-        write_cmos_sensor(0x0341,0x58);
-        write_cmos_sensor(0x0342,0x13);
-        write_cmos_sensor(0x0343,0x90);
-        write_cmos_sensor(0x0344,0x00);
-        write_cmos_sensor(0x0345,0x00);
-        write_cmos_sensor(0x0346,0x00);
-        write_cmos_sensor(0x0347,0x00);
-        write_cmos_sensor(0x0348,0x10);
-        write_cmos_sensor(0x0349,0x6F);
-        write_cmos_sensor(0x034A,0x0C);
-        write_cmos_sensor(0x034B,0x2F);
-        write_cmos_sensor(0x0381,0x01);
-        write_cmos_sensor(0x0383,0x01);
-        write_cmos_sensor(0x0385,0x01);
-        write_cmos_sensor(0x0387,0x01);
-        write_cmos_sensor(0x0900,0x00);
-        write_cmos_sensor(0x0901,0x00);
-        write_cmos_sensor(0x0902,0x00);
-        write_cmos_sensor(0x3000,0x35);
-        write_cmos_sensor(0x3054,0x01);
-        write_cmos_sensor(0x305C,0x11);
-
-        write_cmos_sensor(0x0112,0x0A);
-        write_cmos_sensor(0x0113,0x0A);
-        write_cmos_sensor(0x034C,0x10);
-        write_cmos_sensor(0x034D,0x70);
-        write_cmos_sensor(0x034E,0x0C);
-        write_cmos_sensor(0x034F,0x30);
-        write_cmos_sensor(0x0401,0x00);
-        write_cmos_sensor(0x0404,0x00);
-        write_cmos_sensor(0x0405,0x10);
-        write_cmos_sensor(0x0408,0x00);
-        write_cmos_sensor(0x0409,0x00);
-        write_cmos_sensor(0x040A,0x00);
-        write_cmos_sensor(0x040B,0x00);
-        write_cmos_sensor(0x040C,0x10);
-        write_cmos_sensor(0x040D,0x70);
-        write_cmos_sensor(0x040E,0x0C);
-        write_cmos_sensor(0x040F,0x30);
-
-        write_cmos_sensor(0x0301,0x05);
-        write_cmos_sensor(0x0303,0x02);
-        write_cmos_sensor(0x0305,0x03);
-        write_cmos_sensor(0x0306,0x00);
-        write_cmos_sensor(0x0307,0x96);
-        write_cmos_sensor(0x0309,0x0A);
-        write_cmos_sensor(0x030B,0x01);
-        write_cmos_sensor(0x0310,0x00);
-
-        write_cmos_sensor(0x0820,0x12);
-        write_cmos_sensor(0x0821,0xC0);
-        write_cmos_sensor(0x0822,0x00);
-        write_cmos_sensor(0x0823,0x00);
-
-        write_cmos_sensor(0x3A03,0x09);
-        write_cmos_sensor(0x3A04,0x20);
-        write_cmos_sensor(0x3A05,0x01);
-
-        write_cmos_sensor(0x0B06,0x01);
-        write_cmos_sensor(0x30A2,0x00);
-
-        write_cmos_sensor(0x30B4,0x00);
-
-        write_cmos_sensor(0x3A02,0xff);
-
-        write_cmos_sensor(0x3011,0x00);
-        write_cmos_sensor(0x3013,0x01);
-
-        write_cmos_sensor(0x0202,0x0C);
-        write_cmos_sensor(0x0203,0x4E);
-        write_cmos_sensor(0x0224,0x01);
-        write_cmos_sensor(0x0225,0xF4);
-
-        write_cmos_sensor(0x0204,0x00);
-        write_cmos_sensor(0x0205,0x00);
-        write_cmos_sensor(0x020E,0x01);
-        write_cmos_sensor(0x020F,0x00);
-        write_cmos_sensor(0x0210,0x01);
-        write_cmos_sensor(0x0211,0x00);
-        write_cmos_sensor(0x0212,0x01);
-        write_cmos_sensor(0x0213,0x00);
-        write_cmos_sensor(0x0214,0x01);
-        write_cmos_sensor(0x0215,0x00);
-        write_cmos_sensor(0x0216,0x00);
-        write_cmos_sensor(0x0217,0x00);
-
-        write_cmos_sensor(0x4170,0x00);
-        write_cmos_sensor(0x4171,0x10);
-        write_cmos_sensor(0x4176,0x00);
-        write_cmos_sensor(0x4177,0x3C);
-        write_cmos_sensor(0xAE20,0x04);
-        write_cmos_sensor(0xAE21,0x5C);
-
-        write_cmos_sensor(0x0138,0x01);
-        write_cmos_sensor(0x0100,0x01);
+        write_cmos_sensor_table(capture_setting_regs);
 
     }
     else if(currefps==240){
         // full siez 24pfs
-        write_cmos_sensor(0x0100,0x00);
-
-        write_cmos_sensor(0x0114,0x03);
-        write_cmos_sensor(0x0220,0x00);
-        write_cmos_sensor(0x0221,0x11);
-        write_cmos_sensor(0x0222,0x01);
-        write_cmos_sensor(0x0340,0x0C);
-        write_cmos_sensor(0x0341,0x94);
-        write_cmos_sensor(0x0342,0x13);
-        write_cmos_sensor(0x0343,0x90);
-        write_cmos_sensor(0x0344,0x00);
-        write_cmos_sensor(0x0345,0x00);
-        write_cmos_sensor(0x0346,0x00);
-        write_cmos_sensor(0x0347,0x00);
-        write_cmos_sensor(0x0348,0x10);
-        write_cmos_sensor(0x0349,0x6F);
-        write_cmos_sensor(0x034A,0x0C);
-        write_cmos_sensor(0x034B,0x2F);
-        write_cmos_sensor(0x0381,0x01);
-        write_cmos_sensor(0x0383,0x01);
-        write_cmos_sensor(0x0385,0x01);
-        write_cmos_sensor(0x0387,0x01);
-        write_cmos_sensor(0x0900,0x00);
-        write_cmos_sensor(0x0901,0x00);
-        write_cmos_sensor(0x0902,0x00);
-        write_cmos_sensor(0x3000,0x35);
-        write_cmos_sensor(0x3054,0x01);
-        write_cmos_sensor(0x305C,0x11);
-
-        write_cmos_sensor(0x0112,0x0A);
-        write_cmos_sensor(0x0113,0x0A);
-        write_cmos_sensor(0x034C,0x10);
-        write_cmos_sensor(0x034D,0x70);
-        write_cmos_sensor(0x034E,0x0C);
-        write_cmos_sensor(0x034F,0x30);
-        write_cmos_sensor(0x0401,0x00);
-        write_cmos_sensor(0x0404,0x00);
-        write_cmos_sensor(0x0405,0x10);
-        write_cmos_sensor(0x0408,0x00);
-        write_cmos_sensor(0x0409,0x00);
-        write_cmos_sensor(0x040A,0x00);
-        write_cmos_sensor(0x040B,0x00);
-        write_cmos_sensor(0x040C,0x10);
-        write_cmos_sensor(0x040D,0x70);
-        write_cmos_sensor(0x040E,0x0C);
-        write_cmos_sensor(0x040F,0x30);
-
-        write_cmos_sensor(0x0301,0x05);
-        write_cmos_sensor(0x0303,0x02);
-        write_cmos_sensor(0x0305,0x03);
-        write_cmos_sensor(0x0306,0x00);
-        write_cmos_sensor(0x0307,0x79);
-        write_cmos_sensor(0x0309,0x0A);
-        write_cmos_sensor(0x030B,0x01);
-        write_cmos_sensor(0x0310,0x00);
-
-        write_cmos_sensor(0x0820,0x0F);
-        write_cmos_sensor(0x0821,0x20);
-        write_cmos_sensor(0x0822,0x00);
-        write_cmos_sensor(0x0823,0x00);
-
-        write_cmos_sensor(0x3A03,0x08);
-        write_cmos_sensor(0x3A04,0xC0);
-        write_cmos_sensor(0x3A05,0x02);
-
-        write_cmos_sensor(0x0B06,0x01);
-        write_cmos_sensor(0x30A2,0x00);
-        write_cmos_sensor(0x30B4,0x00);
-        write_cmos_sensor(0x3A02,0xFF);
-        write_cmos_sensor(0x3013,0x00);
-        write_cmos_sensor(0x0202,0x0C);
-        write_cmos_sensor(0x0203,0x8A);
-        write_cmos_sensor(0x0224,0x01);
-        write_cmos_sensor(0x0225,0xF4);
-        write_cmos_sensor(0x0204,0x00);
-        write_cmos_sensor(0x0205,0x00);
-        write_cmos_sensor(0x020E,0x01);
-        write_cmos_sensor(0x020F,0x00);
-        write_cmos_sensor(0x0210,0x01);
-        write_cmos_sensor(0x0211,0x00);
-        write_cmos_sensor(0x0212,0x01);
-        write_cmos_sensor(0x0213,0x00);
-        write_cmos_sensor(0x0214,0x01);
-        write_cmos_sensor(0x0215,0x00);
-        write_cmos_sensor(0x0216,0x00);
-        write_cmos_sensor(0x0217,0x00);
-        write_cmos_sensor(0x4170,0x00);
-        write_cmos_sensor(0x4171,0x10);
-        write_cmos_sensor(0x4176,0x00);
-        write_cmos_sensor(0x4177,0x3C);
-        write_cmos_sensor(0xAE20,0x04);
-        write_cmos_sensor(0xAE21,0x5C);
-
-        write_cmos_sensor(0x0138,0x01);
-        write_cmos_sensor(0x0100,0x01);
+        write_cmos_sensor_table(capture_setting_regs_2);
     }
     else{
         // full siez 15pfs
-        write_cmos_sensor(0x0100,0x00);
-
-        write_cmos_sensor(0x0114,0x03);
-        write_cmos_sensor(0x0220,0x00);
-        write_cmos_sensor(0x0221,0x11);
-        write_cmos_sensor(0x0222,0x01);
-        write_cmos_sensor(0x0340,0x0C);
-        write_cmos_sensor(0x0341,0x94);
-        write_cmos_sensor(0x0342,0x13);
-        write_cmos_sensor(0x0343,0x90);
-        write_cmos_sensor(0x0344,0x00);
-        write_cmos_sensor(0x0345,0x00);
-        write_cmos_sensor(0x0346,0x00);
-        write_cmos_sensor(0x0347,0x00);
-        write_cmos_sensor(0x0348,0x10);
-        write_cmos_sensor(0x0349,0x6F);
-        write_cmos_sensor(0x034A,0x0C);
-        write_cmos_sensor(0x034B,0x2F);
-        write_cmos_sensor(0x0381,0x01);
-        write_cmos_sensor(0x0383,0x01);
-        write_cmos_sensor(0x0385,0x01);
-        write_cmos_sensor(0x0387,0x01);
-        write_cmos_sensor(0x0900,0x00);
-        write_cmos_sensor(0x0901,0x00);
-        write_cmos_sensor(0x0902,0x00);
-        write_cmos_sensor(0x3000,0x35);
-        write_cmos_sensor(0x3054,0x01);
-        write_cmos_sensor(0x305C,0x11);
-
-        write_cmos_sensor(0x0112,0x0A);
-        write_cmos_sensor(0x0113,0x0A);
-        write_cmos_sensor(0x034C,0x10);
-        write_cmos_sensor(0x034D,0x70);
-        write_cmos_sensor(0x034E,0x0C);
-        write_cmos_sensor(0x034F,0x30);
-        write_cmos_sensor(0x0401,0x00);
-        write_cmos_sensor(0x0404,0x00);
-        write_cmos_sensor(0x0405,0x10);
-        write_cmos_sensor(0x0408,0x00);
-        write_cmos_sensor(0x0409,0x00);
-        write_cmos_sensor(0x040A,0x00);
-        write_cmos_sensor(0x040B,0x00);
-        write_cmos_sensor(0x040C,0x10);
-        write_cmos_sensor(0x040D,0x70);
-        write_cmos_sensor(0x040E,0x0C);
-        write_cmos_sensor(0x040F,0x30);
-
-        write_cmos_sensor(0x0301,0x05);
-        write_cmos_sensor(0x0303,0x02);
-        write_cmos_sensor(0x0305,0x03);
-        write_cmos_sensor(0x0306,0x00);
-        write_cmos_sensor(0x0307,0x4c);
-        write_cmos_sensor(0x0309,0x0A);
-        write_cmos_sensor(0x030B,0x01);
-        write_cmos_sensor(0x0310,0x00);
-
-        write_cmos_sensor(0x0820,0x09);
-        write_cmos_sensor(0x0821,0x80);
-        write_cmos_sensor(0x0822,0x00);
-        write_cmos_sensor(0x0823,0x00);
-
-        write_cmos_sensor(0x3A03,0x08);
-        write_cmos_sensor(0x3A04,0xC0);
-        write_cmos_sensor(0x3A05,0x02);
-
-        write_cmos_sensor(0x0B06,0x01);
-        write_cmos_sensor(0x30A2,0x00);
-        write_cmos_sensor(0x30B4,0x00);
-        write_cmos_sensor(0x3A02,0xFF);
-        write_cmos_sensor(0x3013,0x00);
-        write_cmos_sensor(0x0202,0x0C);
-        write_cmos_sensor(0x0203,0x8A);
-        write_cmos_sensor(0x0224,0x01);
-        write_cmos_sensor(0x0225,0xF4);
-        write_cmos_sensor(0x0204,0x00);
-        write_cmos_sensor(0x0205,0x00);
-        write_cmos_sensor(0x020E,0x01);
-        write_cmos_sensor(0x020F,0x00);
-        write_cmos_sensor(0x0210,0x01);
-        write_cmos_sensor(0x0211,0x00);
-        write_cmos_sensor(0x0212,0x01);
-        write_cmos_sensor(0x0213,0x00);
-        write_cmos_sensor(0x0214,0x01);
-        write_cmos_sensor(0x0215,0x00);
-        write_cmos_sensor(0x0216,0x00);
-        write_cmos_sensor(0x0217,0x00);
-        write_cmos_sensor(0x4170,0x00);
-        write_cmos_sensor(0x4171,0x10);
-        write_cmos_sensor(0x4176,0x00);
-        write_cmos_sensor(0x4177,0x3C);
-        write_cmos_sensor(0xAE20,0x04);
-        write_cmos_sensor(0xAE21,0x5C);
-
-        write_cmos_sensor(0x0138,0x01);
-        write_cmos_sensor(0x0100,0x01);
+        write_cmos_sensor_table(capture_setting_regs_3);
     }
 }
 
+static const KD_SENSOR_REG normal_video_setting_regs[] = {
+	KD_SENSOR_REG8(0x0100, 0x00),
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0220, 0x00),
+	KD_SENSOR_REG8(0x0221, 0x11),
+	KD_SENSOR_REG8(0x0222, 0x01),
+	KD_SENSOR_REG8(0x0340, 0x0C),
+	KD_SENSOR_REG8(0x0341, 0x58),
+	KD_SENSOR_REG8(0x0342, 0x13),
+	KD_SENSOR_REG8(0x0343, 0x90),
+	KD_SENSOR_REG8(0x0344, 0x00),
+	KD_SENSOR_REG8(0x0345, 0x00),
+	KD_SENSOR_REG8(0x0346, 0x00),
+	KD_SENSOR_REG8(0x0347, 0x00),
+	KD_SENSOR_REG8(0x0348, 0x10),
+	KD_SENSOR_REG8(0x0349, 0x6F),
+	KD_SENSOR_REG8(0x034A, 0x0C),
+	KD_SENSOR_REG8(0x034B, 0x2F),
+	KD_SENSOR_REG8(0x0381, 0x01),
+	KD_SENSOR_REG8(0x0383, 0x01),
+	KD_SENSOR_REG8(0x0385, 0x01),
+	KD_SENSOR_REG8(0x0387, 0x01),
+	KD_SENSOR_REG8(0x0900, 0x00),
+	KD_SENSOR_REG8(0x0901, 0x00),
+	KD_SENSOR_REG8(0x0902, 0x00),
+	KD_SENSOR_REG8(0x3000, 0x35),
+	KD_SENSOR_REG8(0x3054, 0x01),
+	KD_SENSOR_REG8(0x305C, 0x11),
+
+	KD_SENSOR_REG8(0x0112, 0x0A),
+	KD_SENSOR_REG8(0x0113, 0x0A),
+	KD_SENSOR_REG8(0x034C, 0x10),
+	KD_SENSOR_REG8(0x034D, 0x70),
+	KD_SENSOR_REG8(0x034E, 0x0C),
+	KD_SENSOR_REG8(0x034F, 0x30),
+	KD_SENSOR_REG8(0x0401, 0x00),
+	KD_SENSOR_REG8(0x0404, 0x00),
+	KD_SENSOR_REG8(0x0405, 0x10),
+	KD_SENSOR_REG8(0x0408, 0x00),
+	KD_SENSOR_REG8(0x0409, 0x00),
+	KD_SENSOR_REG8(0x040A, 0x00),
+	KD_SENSOR_REG8(0x040B, 0x00),
+	KD_SENSOR_REG8(0x040C, 0x10),
+	KD_SENSOR_REG8(0x040D, 0x70),
+	KD_SENSOR_REG8(0x040E, 0x0C),
+	KD_SENSOR_REG8(0x040F, 0x30),
+
+	KD_SENSOR_REG8(0x0301, 0x05),
+	KD_SENSOR_REG8(0x0303, 0x02),
+	KD_SENSOR_REG8(0x0305, 0x03),
+	KD_SENSOR_REG8(0x0306, 0x00),
+	KD_SENSOR_REG8(0x0307, 0x96),
+	KD_SENSOR_REG8(0x0309, 0x0A),
+	KD_SENSOR_REG8(0x030B, 0x01),
+	KD_SENSOR_REG8(0x0310, 0x00),
+
+	KD_SENSOR_REG8(0x0820, 0x12),
+	KD_SENSOR_REG8(0x0821, 0xC0),
+	KD_SENSOR_REG8(0x0822, 0x00),
+	KD_SENSOR_REG8(0x0823, 0x00),
+
+	KD_SENSOR_REG8(0x3A03, 0x09),
+	KD_SENSOR_REG8(0x3A04, 0x20),
+	KD_SENSOR_REG8(0x3A05, 0x01),
+
+	KD_SENSOR_REG8(0x0B06, 0x01),
+	KD_SENSOR_REG8(0x30A2, 0x00),
+
+	KD_SENSOR_REG8(0x30B4, 0x00),
+
+	KD_SENSOR_REG8(0x3A02, 0xff),
+
+	KD_SENSOR_REG8(0x3011, 0x00),
+	KD_SENSOR_REG8(0x3013, 0x01),
+
+	KD_SENSOR_REG8(0x0202, 0x0C),
+	KD_SENSOR_REG8(0x0203, 0x4E),
+	KD_SENSOR_REG8(0x0224, 0x01),
+	KD_SENSOR_REG8(0x0225, 0xF4),
+
+	KD_SENSOR_REG8(0x0204, 0x00),
+	KD_SENSOR_REG8(0x0205, 0x00),
+	KD_SENSOR_REG8(0x020E, 0x01),
+	KD_SENSOR_REG8(0x020F, 0x00),
+	KD_SENSOR_REG8(0x0210, 0x01),
+	KD_SENSOR_REG8(0x0211, 0x00),
+	KD_SENSOR_REG8(0x0212, 0x01),
+	KD_SENSOR_REG8(0x0213, 0x00),
+	KD_SENSOR_REG8(0x0214, 0x01),
+	KD_SENSOR_REG8(0x0215, 0x00),
+	KD_SENSOR_REG8(0x0216, 0x00),
+	KD_SENSOR_REG8(0x0217, 0x00),
+
+	KD_SENSOR_REG8(0x4170, 0x00),
+	KD_SENSOR_REG8(0x4171, 0x10),
+	KD_SENSOR_REG8(0x4176, 0x00),
+	KD_SENSOR_REG8(0x4177, 0x3C),
+	KD_SENSOR_REG8(0xAE20, 0x04),
+	KD_SENSOR_REG8(0xAE21, 0x5C),
+
+	KD_SENSOR_REG8(0x0138, 0x01),
+	KD_SENSOR_REG8(0x0100, 0x01),
+};
+
 static void normal_video_setting(kal_uint16 currefps)
 {
 	LOG_INF("E! currefps:%d\n",currefps);
     // full size 30.33ps
-    write_cmos_sensor(0x0100,0x00);
-    write_cmos_sensor(0x0114,0x03);
-    write_cmos_sensor(0x0220,0x00);
-    write_cmos_sensor(0x0221,0x11);
-    write_cmos_sensor(0x0222,0x01);
-    write_cmos_sensor(0x0340,0x0C);
-    write_cmos_sensor(0x0341,0x58);
-    write_cmos_sensor(0x0342,0x13);
-    write_cmos_sensor(0x0343,0x90);
-    write_cmos_sensor(0x0344,0x00);
-    write_cmos_sensor(0x0345,0x00);
-    write_cmos_sensor(0x0346,0x00);
-    write_cmos_sensor(0x0347,0x00);
-    write_cmos_sensor(0x0348,0x10);
-    write_cmos_sensor(0x0349,0x6F);
-    write_cmos_sensor(0x034A,0x0C);
-    write_cmos_sensor(0x034B,0x2F);
-    write_cmos_sensor(0x0381,0x01);
-    write_cmos_sensor(0x0383,0x01);
-    write_cmos_sensor(0x0385,0x01);
-    write_cmos_sensor(0x0387,0x01);
-    write_cmos_sensor(0x0900,0x00);
-    write_cmos_sensor(0x0901,0x00);
-    write_cmos_sensor(0x0902,0x00);
-    write_cmos_sensor(0x3000,0x35);
-    write_cmos_sensor(0x3054,0x01);
-    write_cmos_sensor(0x305C,0x11);
-
-    write_cmos_sensor(0x0112,0x0A);
-    write_cmos_sensor(0x0113,0x0A);
-    write_cmos_sensor(0x034C,0x10);
-    write_cmos_sensor(0x034D,0x70);
-    write_cmos_sensor(0x034E,0x0C);
-    write_cmos_sensor(0x034F,0x30);
-    write_cmos_sensor(0x0401,0x00);
-    write_cmos_sensor(0x0404,0x00);
-    write_cmos_sensor(0x0405,0x10);
-    write_cmos_sensor(0x0408,0x00);
-    write_cmos_sensor(0x0409,0x00);
-    write_cmos_sensor(0x040A,0x00);
-    write_cmos_sensor(0x040B,0x00);
-    write_cmos_sensor(0x040C,0x10);
-    write_cmos_sensor(0x040D,0x70);
-    write_cmos_sensor(0x040E,0x0C);
-    write_cmos_sensor(0x040F,0x30);
-
-    write_cmos_sensor(0x0301,0x05);
-    write_cmos_sensor(0x0303,0x02);
-    write_cmos_sensor(0x0305,0x03);
-    write_cmos_sensor(0x0306,0x00);
-    write_cmos_sensor(0x0307,0x96);
-    write_cmos_sensor(0x0309,0x0A);
-    write_cmos_sensor(0x030B,0x01);
-    write_cmos_sensor(0x0310,0x00);
-
-    write_cmos_sensor(0x0820,0x12);
-    write_cmos_sensor(0x0821,0xC0);
-    write_cmos_sensor(0x0822,0x00);
-    write_cmos_sensor(0x0823,0x00);
-
-    write_cmos_sensor(0x3A03,0x09);
-    write_cmos_sensor(0x3A04,0x20);
-    write_cmos_sensor(0x3A05,0x01);
-
-    write_cmos_sensor(0x0B06,0x01);
-    write_cmos_sensor(0x30A2,0x00);
-
-    write_cmos_sensor(0x30B4,0x00);
-
-    write_cmos_sensor(0x3A02,0xff);
-
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x01);
-
-    write_cmos_sensor(0x0202,0x0C);
-    write_cmos_sensor(0x0203,0x4E);
-    write_cmos_sensor(0x0224,0x01);
-    write_cmos_sensor(0x0225,0xF4);
-
-    write_cmos_sensor(0x0204,0x00);
-    write_cmos_sensor(0x0205,0x00);
-    write_cmos_sensor(0x020E,0x01);
-    write_cmos_sensor(0x020F,0x00);
-    write_cmos_sensor(0x0210,0x01);
-    write_cmos_sensor(0x0211,0x00);
-    write_cmos_sensor(0x0212,0x01);
-    write_cmos_sensor(0x0213,0x00);
-    write_cmos_sensor(0x0214,0x01);
-    write_cmos_sensor(0x0215,0x00);
-    write_cmos_sensor(0x0216,0x00);
-    write_cmos_sensor(0x0217,0x00);
-
-    write_cmos_sensor(0x4170,0x00);
-    write_cmos_sensor(0x4171,0x10);
-    write_cmos_sensor(0x4176,0x00);
-    write_cmos_sensor(0x4177,0x3C);
-    write_cmos_sensor(0xAE20,0x04);
-    write_cmos_sensor(0xAE21,0x5C);
-
-    write_cmos_sensor(0x0138,0x01);
-    write_cmos_sensor(0x0100,0x01);
+    write_cmos_sensor_table(normal_video_setting_regs);
 
 }
 
+static const KD_SENSOR_REG fullsize_setting_HDR_regs[] = {
+	KD_SENSOR_REG8(0x0100, 0x00),
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0220, 0x01),
+	KD_SENSOR_REG8(0x0221, 0x11),
+	KD_SENSOR_REG8(0x0222, 0x08),
+	KD_SENSOR_REG8(0x0340, 0x0C),
+	KD_SENSOR_REG8(0x0341, 0x58),
+	KD_SENSOR_REG8(0x0342, 0x13),
+	KD_SENSOR_REG8(0x0343, 0x90),
+	KD_SENSOR_REG8(0x0344, 0x00),
+	KD_SENSOR_REG8(0x0345, 0x00),
+	KD_SENSOR_REG8(0x0346, 0x00),
+	KD_SENSOR_REG8(0x0347, 0x00),
+	KD_SENSOR_REG8(0x0348, 0x10),
+	KD_SENSOR_REG8(0x0349, 0x6F),
+	KD_SENSOR_REG8(0x034A, 0x0C),
+	KD_SENSOR_REG8(0x034B, 0x2F),
+	KD_SENSOR_REG8(0x0381, 0x01),
+	KD_SENSOR_REG8(0x0383, 0x01),
+	KD_SENSOR_REG8(0x0385, 0x01),
+	KD_SENSOR_REG8(0x0387, 0x01),
+	KD_SENSOR_REG8(0x0900, 0x00),
+	KD_SENSOR_REG8(0x0901, 0x00),
+	KD_SENSOR_REG8(0x0902, 0x00),
+	KD_SENSOR_REG8(0x3000, 0x35),
+	KD_SENSOR_REG8(0x3054, 0x01),
+	KD_SENSOR_REG8(0x305C, 0x11),
+
+	KD_SENSOR_REG8(0x0112, 0x0A),
+	KD_SENSOR_REG8(0x0113, 0x0A),
+	KD_SENSOR_REG8(0x034C, 0x10),
+	KD_SENSOR_REG8(0x034D, 0x70),
+	KD_SENSOR_REG8(0x034E, 0x0C),
+	KD_SENSOR_REG8(0x034F, 0x30),
+	KD_SENSOR_REG8(0x0401, 0x00),
+	KD_SENSOR_REG8(0x0404, 0x00),
+	KD_SENSOR_REG8(0x0405, 0x10),
+	KD_SENSOR_REG8(0x0408, 0x00),
+	KD_SENSOR_REG8(0x0409, 0x00),
+	KD_SENSOR_REG8(0x040A, 0x00),
+	KD_SENSOR_REG8(0x040B, 0x00),
+	KD_SENSOR_REG8(0x040C, 0x10),
+	KD_SENSOR_REG8(0x040D, 0x70),
+	KD_SENSOR_REG8(0x040E, 0x0C),
+	KD_SENSOR_REG8(0x040F, 0x30),
+
+	KD_SENSOR_REG8(0x0301, 0x05),
+	KD_SENSOR_REG8(0x0303, 0x02),
+	KD_SENSOR_REG8(0x0305, 0x03),
+	KD_SENSOR_REG8(0x0306, 0x00),
+	KD_SENSOR_REG8(0x0307, 0x96),
+	KD_SENSOR_REG8(0x0309, 0x0A),
+	KD_SENSOR_REG8(0x030B, 0x01),
+	KD_SENSOR_REG8(0x0310, 0x00),
+
+	KD_SENSOR_REG8(0x0820, 0x12),
+	KD_SENSOR_REG8(0x0821, 0xC0),
+	KD_SENSOR_REG8(0x0822, 0x00),
+	KD_SENSOR_REG8(0x0823, 0x00),
+
+	KD_SENSOR_REG8(0x3A03, 0x08),
+	KD_SENSOR_REG8(0x3A04, 0x90),
+	KD_SENSOR_REG8(0x3A05, 0x01),
+
+	KD_SENSOR_REG8(0x0B06, 0x01),
+	KD_SENSOR_REG8(0x30A2, 0x00),
+
+	KD_SENSOR_REG8(0x30B4, 0x00),
+
+	KD_SENSOR_REG8(0x3A02, 0x06),
+
+	KD_SENSOR_REG8(0x3011, 0x00),
+	KD_SENSOR_REG8(0x3013, 0x01),
+
+	KD_SENSOR_REG8(0x0202, 0x0C),
+	KD_SENSOR_REG8(0x0203, 0x4E),
+	KD_SENSOR_REG8(0x0224, 0x01),
+	KD_SENSOR_REG8(0x0225, 0x89),
+
+	KD_SENSOR_REG8(0x0204, 0x00),
+	KD_SENSOR_REG8(0x0205, 0x00),
+	KD_SENSOR_REG8(0x020E, 0x01),
+	KD_SENSOR_REG8(0x020F, 0x00),
+	KD_SENSOR_REG8(0x0210, 0x01),
+	KD_SENSOR_REG8(0x0211, 0x00),
+	KD_SENSOR_REG8(0x0212, 0x01),
+	KD_SENSOR_REG8(0x0213, 0x00),
+	KD_SENSOR_REG8(0x0214, 0x01),
+	KD_SENSOR_REG8(0x0215, 0x00),
+	KD_SENSOR_REG8(0x0216, 0x00),
+	KD_SENSOR_REG8(0x0217, 0x00),
+
+	KD_SENSOR_REG8(0x4170, 0x00),
+	KD_SENSOR_REG8(0x4171, 0x10),
+	KD_SENSOR_REG8(0x4176, 0x00),
+	KD_SENSOR_REG8(0x4177, 0x3C),
+	KD_SENSOR_REG8(0xAE20, 0x04),
+	KD_SENSOR_REG8(0xAE21, 0x5C),
+	//mHDR  relation setting
+	KD_SENSOR_REG8(0x3010, 0x00),
+	KD_SENSOR_REG8(0x6D3A, 0x00), // 0: 16X16, 1:8X8
+	KD_SENSOR_REG8(0x3011, 0x00),
+	KD_SENSOR_REG8(0x3013, 0x01), // STATS output Enable
+	KD_SENSOR_REG8(0x5068, 0x35),
+	KD_SENSOR_REG8(0x5069, 0x01),
+	KD_SENSOR_REG8(0x30C2, 0x00),
+	KD_SENSOR_REG8(0x30C3, 0x40),
+	KD_SENSOR_REG8(0x610A, 0x08),
+	//[0]:1 hdr enable, [1]:0 LE/SE use same gain, 1 LE/SE separate gain
+	//[5]:0 auto, 1:direct
+	KD_SENSOR_REG8(0x0220, 0x01),
+	// hdr binning mode
+	KD_SENSOR_REG8(0x0221, 0x11),
+	//LE/SE ration 1,2,4,8
+	KD_SENSOR_REG8(0x0222, 0x08),
+};
+
+static const KD_SENSOR_REG fullsize_setting_HDR_regs_2[] = {
+	KD_SENSOR_REG8(0x30b2, 0x01),
+	KD_SENSOR_REG8(0x30b3, 0x01),
+	KD_SENSOR_REG8(0x30b4, 0x01),
+	KD_SENSOR_REG8(0x30b5, 0x01),
+	KD_SENSOR_REG8(0x30b6, 0x01),
+	KD_SENSOR_REG8(0x30b7, 0x01),
+	KD_SENSOR_REG8(0x30b8, 0x01),
+	KD_SENSOR_REG8(0x30b9, 0x01),
+	KD_SENSOR_REG8(0x30ba, 0x01),
+	KD_SENSOR_REG8(0x30bb, 0x01),
+	KD_SENSOR_REG8(0x30bc, 0x01),
+};
+
+static const KD_SENSOR_REG fullsize_setting_HDR_regs_3[] = {
+	KD_SENSOR_REG8(0x30b2, 0x00),
+	KD_SENSOR_REG8(0x30b3, 0x00),
+	KD_SENSOR_REG8(0x30b4, 0x00),
+	KD_SENSOR_REG8(0x30b5, 0x00),
+	KD_SENSOR_REG8(0x30b6, 0x00),
+	KD_SENSOR_REG8(0x30b7, 0x00),
+	KD_SENSOR_REG8(0x30b8, 0x00),
+	KD_SENSOR_REG8(0x30b9, 0x00),
+	KD_SENSOR_REG8(0x30ba, 0x00),
+	KD_SENSOR_REG8(0x30bb, 0x00),
+	KD_SENSOR_REG8(0x30bc, 0x00),
+};
+
 static void fullsize_setting_HDR(kal_uint16 currefps)
 {
 	LOG_INF("E! currefps:%d\n",currefps);
     // full size 30.33ps
-    write_cmos_sensor(0x0100,0x00);
-    write_cmos_sensor(0x0114,0x03);
-    write_cmos_sensor(0x0220,0x01);
-    write_cmos_sensor(0x0221,0x11);
-    write_cmos_sensor(0x0222,0x08);
-    write_cmos_sensor(0x0340,0x0C);
-    write_cmos_sensor(0x0341,0x58);
-    write_cmos_sensor(0x0342,0x13);
-    write_cmos_sensor(0x0343,0x90);
-    write_cmos_sensor(0x0344,0x00);
-    write_cmos_sensor(0x0345,0x00);
-    write_cmos_sensor(0x0346,0x00);
-    write_cmos_sensor(0x0347,0x00);
-    write_cmos_sensor(0x0348,0x10);
-    write_cmos_sensor(0x0349,0x6F);
-    write_cmos_sensor(0x034A,0x0C);
-    write_cmos_sensor(0x034B,0x2F);
-    write_cmos_sensor(0x0381,0x01);
-    write_cmos_sensor(0x0383,0x01);
-    write_cmos_sensor(0x0385,0x01);
-    write_cmos_sensor(0x0387,0x01);
-    write_cmos_sensor(0x0900,0x00);
-    write_cmos_sensor(0x0901,0x00);
-    write_cmos_sensor(0x0902,0x00);
-    write_cmos_sensor(0x3000,0x35);
-    write_cmos_sensor(0x3054,0x01);
-    write_cmos_sensor(0x305C,0x11);
-
-    write_cmos_sensor(0x0112,0x0A);
-    write_cmos_sensor(0x0113,0x0A);
-    write_cmos_sensor(0x034C,0x10);
-    write_cmos_sensor(0x034D,0x70);
-    write_cmos_sensor(0x034E,0x0C);
-    write_cmos_sensor(0x034F,0x30);
-    write_cmos_sensor(0x0401,0x00);
-    write_cmos_sensor(0x0404,0x00);
-    write_cmos_sensor(0x0405,0x10);
-    write_cmos_sensor(0x0408,0x00);
-    write_cmos_sensor(0x0409,0x00);
-    write_cmos_sensor(0x040A,0x00);
-    write_cmos_sensor(0x040B,0x00);
-    write_cmos_sensor(0x040C,0x10);
-    write_cmos_sensor(0x040D,0x70);
-    write_cmos_sensor(0x040E,0x0C);
-    write_cmos_sensor(0x040F,0x30);
-
-    write_cmos_sensor(0x0301,0x05);
-    write_cmos_sensor(0x0303,0x02);
-    write_cmos_sensor(0x0305,0x03);
-    write_cmos_sensor(0x0306,0x00);
-    write_cmos_sensor(0x0307,0x96);
-    write_cmos_sensor(0x0309,0x0A);
-    write_cmos_sensor(0x030B,0x01);
-    write_cmos_sensor(0x0310,0x00);
-
-    write_cmos_sensor(0x0820,0x12);
-    write_cmos_sensor(0x0821,0xC0);
-    write_cmos_sensor(0x0822,0x00);
-    write_cmos_sensor(0x0823,0x00);
-
-    write_cmos_sensor(0x3A03,0x08);
-    write_cmos_sensor(0x3A04,0x90);
-    write_cmos_sensor(0x3A05,0x01);
-
-    write_cmos_sensor(0x0B06,0x01);
-    write_cmos_sensor(0x30A2,0x00);
-
-    write_cmos_sensor(0x30B4,0x00);
-
-    write_cmos_sensor(0x3A02,0x06);
-
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x01);
-
-    write_cmos_sensor(0x0202,0x0C);
-    write_cmos_sensor(0x0203,0x4E);
-    write_cmos_sensor(0x0224,0x01);
-    write_cmos_sensor(0x0225,0x89);
-
-    write_cmos_sensor(0x0204,0x00);
-    write_cmos_sensor(0x0205,0x00);
-    write_cmos_sensor(0x020E,0x01);
-    write_cmos_sensor(0x020F,0x00);
-    write_cmos_sensor(0x0210,0x01);
-    write_cmos_sensor(0x0211,0x00);
-    write_cmos_sensor(0x0212,0x01);
-    write_cmos_sensor(0x0213,0x00);
-    write_cmos_sensor(0x0214,0x01);
-    write_cmos_sensor(0x0215,0x00);
-    write_cmos_sensor(0x0216,0x00);
-    write_cmos_sensor(0x0217,0x00);
-
-    write_cmos_sensor(0x4170,0x00);
-    write_cmos_sensor(0x4171,0x10);
-    write_cmos_sensor(0x4176,0x00);
-    write_cmos_sensor(0x4177,0x3C);
-    write_cmos_sensor(0xAE20,0x04);
-    write_cmos_sensor(0xAE21,0x5C);
-    //mHDR  relation setting
-    write_cmos_sensor(0x3010,0x00);
-    write_cmos_sensor(0x6D3A,0x00); // 0: 16X16, 1:8X8
-    write_cmos_sensor(0x3011,0x00);
-    write_cmos_sensor(0x3013,0x01); // STATS output Enable
-    write_cmos_sensor(0x5068,0x35);
-    write_cmos_sensor(0x5069,0x01);
-    write_cmos_sensor(0x30C2,0x00);
-    write_cmos_sensor(0x30C3,0x40);
-    write_cmos_sensor(0x610A,0x08);
-    //[0]:1 hdr enable, [1]:0 LE/SE use same gain, 1 LE/SE separate gain
-    //[5]:0 auto, 1:direct
-    write_cmos_sensor(0x0220,0x01);
-    // hdr binning mode
-    write_cmos_sensor(0x0221,0x11);
-    //LE/SE ration 1,2,4,8
-    write_cmos_sensor(0x0222,0x08);
+    write_cmos_sensor_table(fullsize_setting_HDR_regs);
     //ATR
     imx214_ATR(3,3);
 
     // Normal: 0x00, ZigZag: 0x01
     if(imgsensor.ihdr_mode == 9)
     {
-        write_cmos_sensor(0x30b2,0x01);
-        write_cmos_sensor(0x30b3,0x01);
-        write_cmos_sensor(0x30b4,0x01);
-        write_cmos_sensor(0x30b5,0x01);
-        write_cmos_sensor(0x30b6,0x01);
-        write_cmos_sensor(0x30b7,0x01);
-        write_cmos_sensor(0x30b8,0x01);
-        write_cmos_sensor(0x30b9,0x01);
-        write_cmos_sensor(0x30ba,0x01);
-        write_cmos_sensor(0x30bb,0x01);
-        write_cmos_sensor(0x30bc,0x01);
+        write_cmos_sensor_table(fullsize_setting_HDR_regs_2);
     }
     else
     {
-        write_cmos_sensor(0x30b2,0x00);
-        write_cmos_sensor(0x30b3,0x00);
-        write_cmos_sensor(0x30b4,0x00);
-        write_cmos_sensor(0x30b5,0x00);
-        write_cmos_sensor(0x30b6,0x00);
-        write_cmos_sensor(0x30b7,0x00);
-        write_cmos_sensor(0x30b8,0x00);
-        write_cmos_sensor(0x30b9,0x00);
-        write_cmos_sensor(0x30ba,0x00);
-        write_cmos_sensor(0x30bb,0x00);
-        write_cmos_sensor(0x30bc,0x00);
+        write_cmos_sensor_table(fullsize_setting_HDR_regs_3);
     }
     write_cmos_sensor(0x0138,0x01);
     write_cmos_sensor(0x0100,0x01);
 
 }
 
+static const KD_SENSOR_REG hs_video_setting_regs[] = {
+	KD_SENSOR_REG8(0x0100, 0x00),
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0220, 0x00),
+	KD_SENSOR_REG8(0x0221, 0x11),
+	KD_SENSOR_REG8(0x0222, 0x01),
+	KD_SENSOR_REG8(0x0340, 0x05),
+	KD_SENSOR_REG8(0x0341, 0x08),
+	KD_SENSOR_REG8(0x0342, 0x13),
+	KD_SENSOR_REG8(0x0343, 0x90),
+	KD_SENSOR_REG8(0x0344, 0x00),
+	KD_SENSOR_REG8(0x0345, 0x00),
+	KD_SENSOR_REG8(0x0346, 0x01),
+	KD_SENSOR_REG8(0x0347, 0x78),
+	KD_SENSOR_REG8(0x0348, 0x10),
+	KD_SENSOR_REG8(0x0349, 0x6F),
+	KD_SENSOR_REG8(0x034A, 0x0A),
+	KD_SENSOR_REG8(0x034B, 0xB7),
+	KD_SENSOR_REG8(0x0381, 0x01),
+	KD_SENSOR_REG8(0x0383, 0x01),
+	KD_SENSOR_REG8(0x0385, 0x01),
+	KD_SENSOR_REG8(0x0387, 0x01),
+	KD_SENSOR_REG8(0x0900, 0x01),
+	KD_SENSOR_REG8(0x0901, 0x22),
+	KD_SENSOR_REG8(0x0902, 0x02),
+	KD_SENSOR_REG8(0x3000, 0x35),
+	KD_SENSOR_REG8(0x3054, 0x01),
+	KD_SENSOR_REG8(0x305C, 0x11),
+
+	KD_SENSOR_REG8(0x0112, 0x0A),
+	KD_SENSOR_REG8(0x0113, 0x0A),
+	KD_SENSOR_REG8(0x034C, 0x08),
+	KD_SENSOR_REG8(0x034D, 0x38),
+	KD_SENSOR_REG8(0x034E, 0x04),
+	KD_SENSOR_REG8(0x034F, 0xA0),
+	KD_SENSOR_REG8(0x0401, 0x00),
+	KD_SENSOR_REG8(0x0404, 0x00),
+	KD_SENSOR_REG8(0x0405, 0x10),
+	KD_SENSOR_REG8(0x0408, 0x00),
+	KD_SENSOR_REG8(0x0409, 0x00),
+	KD_SENSOR_REG8(0x040A, 0x00),
+	KD_SENSOR_REG8(0x040B, 0x00),
+	KD_SENSOR_REG8(0x040C, 0x08),
+	KD_SENSOR_REG8(0x040D, 0x38),
+	KD_SENSOR_REG8(0x040E, 0x04),
+	KD_SENSOR_REG8(0x040F, 0xA0),
+
+	KD_SENSOR_REG8(0x0301, 0x05),
+	KD_SENSOR_REG8(0x0303, 0x02),
+	KD_SENSOR_REG8(0x0305, 0x03),
+	KD_SENSOR_REG8(0x0306, 0x00),
+	KD_SENSOR_REG8(0x0307, 0x79), //79
+	KD_SENSOR_REG8(0x0309, 0x0A),
+	KD_SENSOR_REG8(0x030B, 0x01),
+	KD_SENSOR_REG8(0x0310, 0x00),
+
+	KD_SENSOR_REG8(0x0820, 0x0F), //0F
+	KD_SENSOR_REG8(0x0821, 0x20), // 20
+	KD_SENSOR_REG8(0x0822, 0x00),
+	KD_SENSOR_REG8(0x0823, 0x00),
+	KD_SENSOR_REG8(0x3A03, 0x06),
+	KD_SENSOR_REG8(0x3A04, 0x68),
+	KD_SENSOR_REG8(0x3A05, 0x01),
+	KD_SENSOR_REG8(0x0B06, 0x01),
+	KD_SENSOR_REG8(0x30A2, 0x00),
+	KD_SENSOR_REG8(0x30B4, 0x00),
+	KD_SENSOR_REG8(0x3A02, 0xFF),
+	KD_SENSOR_REG8(0x3013, 0x00),
+	KD_SENSOR_REG8(0x0202, 0x04),
+	KD_SENSOR_REG8(0x0203, 0xFE),
+	KD_SENSOR_REG8(0x0224, 0x01),
+	KD_SENSOR_REG8(0x0225, 0xF4),
+	KD_SENSOR_REG8(0x0204, 0x00),
+	KD_SENSOR_REG8(0x0205, 0x00),
+	KD_SENSOR_REG8(0x020E, 0x01),
+	KD_SENSOR_REG8(0x020F, 0x00),
+	KD_SENSOR_REG8(0x0210, 0x01),
+	KD_SENSOR_REG8(0x0211, 0x00),
+	KD_SENSOR_REG8(0x0212, 0x01),
+	KD_SENSOR_REG8(0x0213, 0x00),
+	KD_SENSOR_REG8(0x0214, 0x01),
+	KD_SENSOR_REG8(0x0215, 0x00),
+	KD_SENSOR_REG8(0x0216, 0x00),
+	KD_SENSOR_REG8(0x0217, 0x00),
+	KD_SENSOR_REG8(0x4170, 0x00),
+	KD_SENSOR_REG8(0x4171, 0x10),
+	KD_SENSOR_REG8(0x4176, 0x00),
+	KD_SENSOR_REG8(0x4177, 0x3C),
+	KD_SENSOR_REG8(0xAE20, 0x04),
+	KD_SENSOR_REG8(0xAE21, 0x5C),
+
+	KD_SENSOR_REG8(0x0138, 0x01),
+	KD_SENSOR_REG8(0x0100, 0x01),
+};
+
 static void hs_video_setting()
 {
 	LOG_INF("E\n");
 	//1080p 60fps
-	write_cmos_sensor(0x0100,0x00);
-	write_cmos_sensor(0x0114,0x03);
-	write_cmos_sensor(0x0220,0x00);
-	write_cmos_sensor(0x0221,0x11);
-	write_cmos_sensor(0x0222,0x01);
-	write_cmos_sensor(0x0340,0x05);
-	write_cmos_sensor(0x0341,0x08);
-	write_cmos_sensor(0x0342,0x13);
-	write_cmos_sensor(0x0343,0x90);
-	write_cmos_sensor(0x0344,0x00);
-	write_cmos_sensor(0x0345,0x00);
-	write_cmos_sensor(0x0346,0x01);
-	write_cmos_sensor(0x0347,0x78);
-	write_cmos_sensor(0x0348,0x10);
-	write_cmos_sensor(0x0349,0x6F);
-	write_cmos_sensor(0x034A,0x0A);
-	write_cmos_sensor(0x034B,0xB7);
-	write_cmos_sensor(0x0381,0x01);
-	write_cmos_sensor(0x0383,0x01);
-	write_cmos_sensor(0x0385,0x01);
-	write_cmos_sensor(0x0387,0x01);
-	write_cmos_sensor(0x0900,0x01);
-	write_cmos_sensor(0x0901,0x22);
-	write_cmos_sensor(0x0902,0x02);
-	write_cmos_sensor(0x3000,0x35);
-	write_cmos_sensor(0x3054,0x01);
-	write_cmos_sensor(0x305C,0x11);
-
-	write_cmos_sensor(0x0112,0x0A);
-	write_cmos_sensor(0x0113,0x0A);
-	write_cmos_sensor(0x034C,0x08);
-	write_cmos_sensor(0x034D,0x38);
-	write_cmos_sensor(0x034E,0x04);
-	write_cmos_sensor(0x034F,0xA0);
-	write_cmos_sensor(0x0401,0x00);
-	write_cmos_sensor(0x0404,0x00);
-	write_cmos_sensor(0x0405,0x10);
-	write_cmos_sensor(0x0408,0x00);
-	write_cmos_sensor(0x0409,0x00);
-	write_cmos_sensor(0x040A,0x00);
-	write_cmos_sensor(0x040B,0x00);
-	write_cmos_sensor(0x040C,0x08);
-	write_cmos_sensor(0x040D,0x38);
-	write_cmos_sensor(0x040E,0x04);
-	write_cmos_sensor(0x040F,0xA0);
-
-	write_cmos_sensor(0x0301,0x05);
-	write_cmos_sensor(0x0303,0x02);
-	write_cmos_sensor(0x0305,0x03);
-	write_cmos_sensor(0x0306,0x00);
-	write_cmos_sensor(0x0307,0x79);//79
-	write_cmos_sensor(0x0309,0x0A);
-	write_cmos_sensor(0x030B,0x01);
-	write_cmos_sensor(0x0310,0x00);
-
-	write_cmos_sensor(0x0820,0x0F);//0F
-	write_cmos_sensor(0x0821,0x20);// 20
-	write_cmos_sensor(0x0822,0x00);
-	write_cmos_sensor(0x0823,0x00);
-	write_cmos_sensor(0x3A03,0x06);
-	write_cmos_sensor(0x3A04,0x68);
-	write_cmos_sensor(0x3A05,0x01);
-	write_cmos_sensor(0x0B06,0x01);
-	write_cmos_sensor(0x30A2,0x00);
-	write_cmos_sensor(0x30B4,0x00);
-	write_cmos_sensor(0x3A02,0xFF);
-	write_cmos_sensor(0x3013,0x00);
-	write_cmos_sensor(0x0202,0x04);
-	write_cmos_sensor(0x0203,0xFE);
-	write_cmos_sensor(0x0224,0x01);
-	write_cmos_sensor(0x0225,0xF4);
-	write_cmos_sensor(0x0204,0x00);
-	write_cmos_sensor(0x0205,0x00);
-	write_cmos_sensor(0x020E,0x01);
-	write_cmos_sensor(0x020F,0x00);
-	write_cmos_sensor(0x0210,0x01);
-	write_cmos_sensor(0x0211,0x00);
-	write_cmos_sensor(0x0212,0x01);
-	write_cmos_sensor(0x0213,0x00);
-	write_cmos_sensor(0x0214,0x01);
-	write_cmos_sensor(0x0215,0x00);
-	write_cmos_sensor(0x0216,0x00);
-	write_cmos_sensor(0x0217,0x00);
-	write_cmos_sensor(0x4170,0x00);
-	write_cmos_sensor(0x4171,0x10);
-	write_cmos_sensor(0x4176,0x00);
-	write_cmos_sensor(0x4177,0x3C);
-	write_cmos_sensor(0xAE20,0x04);
-	write_cmos_sensor(0xAE21,0x5C);
-
-	write_cmos_sensor(0x0138,0x01);
-      write_cmos_sensor(0x0100,0x01);
+	write_cmos_sensor_table(hs_video_setting_regs);
 
 }
 
@@ -1824,99 +1886,103 @@ static void slim_video_setting()
 	hs_video_setting();
 }
 
+static const KD_SENSOR_REG vhdr_setting_regs[] = {
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0220, 0x01),
+	KD_SENSOR_REG8(0x0221, 0x22),
+	KD_SENSOR_REG8(0x0222, 0x10),
+	KD_SENSOR_REG8(0x0340, 0x06),
+	KD_SENSOR_REG8(0x0341, 0x68),
+	KD_SENSOR_REG8(0x0342, 0x13),
+	KD_SENSOR_REG8(0x0343, 0x90),
+	KD_SENSOR_REG8(0x0344, 0x00),
+	KD_SENSOR_REG8(0x0345, 0x00),
+	KD_SENSOR_REG8(0x0346, 0x01),
+	KD_SENSOR_REG8(0x0347, 0x78),
+	KD_SENSOR_REG8(0x0348, 0x10),
+	KD_SENSOR_REG8(0x0349, 0x6F),
+	KD_SENSOR_REG8(0x034A, 0x0A),
+	KD_SENSOR_REG8(0x034B, 0xB7),
+	KD_SENSOR_REG8(0x0381, 0x01),
+	KD_SENSOR_REG8(0x0383, 0x01),
+	KD_SENSOR_REG8(0x0385, 0x01),
+	KD_SENSOR_REG8(0x0387, 0x01),
+	KD_SENSOR_REG8(0x0900, 0x00),
+	KD_SENSOR_REG8(0x0901, 0x00),
+	KD_SENSOR_REG8(0x0902, 0x00),
+	KD_SENSOR_REG8(0x3000, 0x35),
+	KD_SENSOR_REG8(0x3054, 0x01),
+	KD_SENSOR_REG8(0x305C, 0x11),
+
+	KD_SENSOR_REG8(0x0112, 0x0A),
+	KD_SENSOR_REG8(0x0113, 0x0A),
+	KD_SENSOR_REG8(0x034C, 0x08),
+	KD_SENSOR_REG8(0x034D, 0x38),
+	KD_SENSOR_REG8(0x034E, 0x04),
+	KD_SENSOR_REG8(0x034F, 0xA0),
+	KD_SENSOR_REG8(0x0401, 0x00),
+	KD_SENSOR_REG8(0x0404, 0x00),
+	KD_SENSOR_REG8(0x0405, 0x10),
+	KD_SENSOR_REG8(0x0408, 0x00),
+	KD_SENSOR_REG8(0x0409, 0x00),
+	KD_SENSOR_REG8(0x040A, 0x00),
+	KD_SENSOR_REG8(0x040B, 0x00),
+	KD_SENSOR_REG8(0x040C, 0x08),
+	KD_SENSOR_REG8(0x040D, 0x38),
+	KD_SENSOR_REG8(0x040E, 0x04),
+	KD_SENSOR_REG8(0x040F, 0xA0),
+
+	KD_SENSOR_REG8(0x0301, 0x05),
+	KD_SENSOR_REG8(0x0303, 0x02),
+	KD_SENSOR_REG8(0x0305, 0x03),
+	KD_SENSOR_REG8(0x0306, 0x00),
+	KD_SENSOR_REG8(0x0307, 0x4D),
+	KD_SENSOR_REG8(0x0309, 0x0A),
+	KD_SENSOR_REG8(0x030B, 0x01),
+	KD_SENSOR_REG8(0x0310, 0x00),
+	KD_SENSOR_REG8(0x0820, 0x09),
+	KD_SENSOR_REG8(0x0821, 0xA0),
+	KD_SENSOR_REG8(0x0822, 0x00),
+	KD_SENSOR_REG8(0x0823, 0x00),
+	KD_SENSOR_REG8(0x3A03, 0x06),
+	KD_SENSOR_REG8(0x3A04, 0xE8),
+	KD_SENSOR_REG8(0x3A05, 0x01),
+	KD_SENSOR_REG8(0x0B06, 0x01),
+	KD_SENSOR_REG8(0x30A2, 0x00),
+	KD_SENSOR_REG8(0x30B4, 0x00),
+	KD_SENSOR_REG8(0x3A02, 0x06),
+	KD_SENSOR_REG8(0x3013, 0x01),
+	KD_SENSOR_REG8(0x0202, 0x06),
+	KD_SENSOR_REG8(0x0203, 0x5E),
+	KD_SENSOR_REG8(0x0224, 0x00),
+	KD_SENSOR_REG8(0x0225, 0xCB),
+	KD_SENSOR_REG8(0x0204, 0x00),
+	KD_SENSOR_REG8(0x0205, 0x00),
+	KD_SENSOR_REG8(0x020E, 0x01),
+	KD_SENSOR_REG8(0x020F, 0x00),
+	KD_SENSOR_REG8(0x0210, 0x01),
+	KD_SENSOR_REG8(0x0211, 0x00),
+	KD_SENSOR_REG8(0x0212, 0x01),
+	KD_SENSOR_REG8(0x0213, 0x00),
+	KD_SENSOR_REG8(0x0214, 0x01),
+	KD_SENSOR_REG8(0x0215, 0x00),
+	KD_SENSOR_REG8(0x0216, 0x00),
+	KD_SENSOR_REG8(0x0217, 0x00),
+	KD_SENSOR_REG8(0x4170, 0x00),
+	KD_SENSOR_REG8(0x4171, 0x10),
+	KD_SENSOR_REG8(0x4176, 0x00),
+	KD_SENSOR_REG8(0x4177, 0x3C),
+	KD_SENSOR_REG8(0xAE20, 0x04),
+	KD_SENSOR_REG8(0xAE21, 0x5C),
+
+	KD_SENSOR_REG8(0x0138, 0x01),
+	KD_SENSOR_REG8(0x0100, 0x01),
+};
+
 static void vhdr_setting()
 {
      	LOG_INF("E\n");
-write_cmos_sensor(0x0114,0x03);
-write_cmos_sensor(0x0220,0x01);
-write_cmos_sensor(0x0221,0x22);
-write_cmos_sensor(0x0222,0x10);
-write_cmos_sensor(0x0340,0x06);
-write_cmos_sensor(0x0341,0x68);
-write_cmos_sensor(0x0342,0x13);
-write_cmos_sensor(0x0343,0x90);
-write_cmos_sensor(0x0344,0x00);
-write_cmos_sensor(0x0345,0x00);
-write_cmos_sensor(0x0346,0x01);
-write_cmos_sensor(0x0347,0x78);
-write_cmos_sensor(0x0348,0x10);
-write_cmos_sensor(0x0349,0x6F);
-write_cmos_sensor(0x034A,0x0A);
-write_cmos_sensor(0x034B,0xB7);
-write_cmos_sensor(0x0381,0x01);
-write_cmos_sensor(0x0383,0x01);
-write_cmos_sensor(0x0385,0x01);
-write_cmos_sensor(0x0387,0x01);
-write_cmos_sensor(0x0900,0x00);
-write_cmos_sensor(0x0901,0x00);
-write_cmos_sensor(0x0902,0x00);
-write_cmos_sensor(0x3000,0x35);
-write_cmos_sensor(0x3054,0x01);
-write_cmos_sensor(0x305C,0x11);
-
-write_cmos_sensor(0x0112,0x0A);
-write_cmos_sensor(0x0113,0x0A);
-write_cmos_sensor(0x034C,0x08);
-write_cmos_sensor(0x034D,0x38);
-write_cmos_sensor(0x034E,0x04);
-write_cmos_sensor(0x034F,0xA0);
-write_cmos_sensor(0x0401,0x00);
-write_cmos_sensor(0x0404,0x00);
-write_cmos_sensor(0x0405,0x10);
-write_cmos_sensor(0x0408,0x00);
-write_cmos_sensor(0x0409,0x00);
-write_cmos_sensor(0x040A,0x00);
-write_cmos_sensor(0x040B,0x00);
-write_cmos_sensor(0x040C,0x08);
-write_cmos_sensor(0x040D,0x38);
-write_cmos_sensor(0x040E,0x04);
-write_cmos_sensor(0x040F,0xA0);
-
-write_cmos_sensor(0x0301,0x05);
-write_cmos_sensor(0x0303,0x02);
-write_cmos_sensor(0x0305,0x03);
-write_cmos_sensor(0x0306,0x00);
-write_cmos_sensor(0x0307,0x4D);
-write_cmos_sensor(0x0309,0x0A);
-write_cmos_sensor(0x030B,0x01);
-write_cmos_sensor(0x0310,0x00);
-write_cmos_sensor(0x0820,0x09);
-write_cmos_sensor(0x0821,0xA0);
-write_cmos_sensor(0x0822,0x00);
-write_cmos_sensor(0x0823,0x00);
-write_cmos_sensor(0x3A03,0x06);
-write_cmos_sensor(0x3A04,0xE8);
-write_cmos_sensor(0x3A05,0x01);
-write_cmos_sensor(0x0B06,0x01);
-write_cmos_sensor(0x30A2,0x00);
-write_cmos_sensor(0x30B4,0x00);
-write_cmos_sensor(0x3A02,0x06);
-write_cmos_sensor(0x3013,0x01);
-write_cmos_sensor(0x0202,0x06);
-write_cmos_sensor(0x0203,0x5E);
-write_cmos_sensor(0x0224,0x00);
-write_cmos_sensor(0x0225,0xCB);
-write_cmos_sensor(0x0204,0x00);
-write_cmos_sensor(0x0205,0x00);
-write_cmos_sensor(0x020E,0x01);
-write_cmos_sensor(0x020F,0x00);
-write_cmos_sensor(0x0210,0x01);
-write_cmos_sensor(0x0211,0x00);
-write_cmos_sensor(0x0212,0x01);
-write_cmos_sensor(0x0213,0x00);
-write_cmos_sensor(0x0214,0x01);
-write_cmos_sensor(0x0215,0x00);
-write_cmos_sensor(0x0216,0x00);
-write_cmos_sensor(0x0217,0x00);
-write_cmos_sensor(0x4170,0x00);
-write_cmos_sensor(0x4171,0x10);
-write_cmos_sensor(0x4176,0x00);
-write_cmos_sensor(0x4177,0x3C);
-write_cmos_sensor(0xAE20,0x04);
-write_cmos_sensor(0xAE21,0x5C);
-
-write_cmos_sensor(0x0138,0x01);
-write_cmos_sensor(0x0100,0x01);
+write_cmos_sensor_table(vhdr_setting_regs);
 
 }
 /*************************************************************************
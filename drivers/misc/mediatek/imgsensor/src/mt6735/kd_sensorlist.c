@@ -9,6 +9,7 @@
 #include <linux/slab.h>
 #include <linux/proc_fs.h>   /* proc file use */
 #include <linux/dma-mapping.h>
+#include <linux/workqueue.h>
 #include <linux/module.h>/*Luke++150701=For 3.18 build pass*/
 /*#include <linux/xlog.h> */
 #include <linux/seq_file.h>
@@ -20,6 +21,7 @@
 #include "kd_imgsensor_define.h"
 #include "kd_camera_feature.h"
 #include "kd_imgsensor_errcode.h"
+#include "kd_imgsensor_regseq.h"
 
 #include "kd_sensorlist.h"
 
@@ -39,6 +41,7 @@
 
 /*#include <mach/mt_chip.h>*//*Luke--150701=For 3.18 build pass */
 #include <mt_chip.h>/*Luke++150701=For 3.18 build pass */
+#include <mt_smi.h>
 #undef CONFIG_MTK_LEGACY/*LukeHu++1500701=For Kernel 3.18 build pass*/
 /*kernel standard for CCF*/
 #ifdef CONFIG_MTK_CLKMGR
@@ -204,6 +207,8 @@ static u32 gI2CBusNum = SUPPORT_I2C_BUS_NUM1;
 #define CLEAN_I2CBUS_FLAG(_x_)      ((~(1<<_x_))&(gCurrI2CBusEnableFlag))
 
 static DEFINE_MUTEX(kdCam_Mutex);
+/* sensor streaming holds the SMI camera profile, mutex : kdCam_Mutex */
+static BOOL g_bCamSmiScen = FALSE;
 static BOOL bSesnorVsyncFlag = FALSE;
 static ACDK_KD_SENSOR_SYNC_STRUCT g_NewSensorExpGain = {128, 128, 128, 128, 1000, 640, 0xFF, 0xFF, 0xFF, 0};
 
@@ -223,6 +228,13 @@ static wait_queue_head_t kd_sensor_wait_queue;
 bool setExpGainDoneFlag = 0;
 static unsigned int g_CurrentSensorIdx;
 static unsigned int g_IsSearchSensor;
+/* Probe results per socket (main, sub, main2), bit n is driver n of the sensor list.
+ * A socket keeps its results until an open on it fails, so a reopen or a new
+ * search does not power cycle every candidate again.
+ */
+static u32 g_ProbeFoundMask[3];
+static u32 g_ProbeAbsentMask[3];
+static u32 g_invokeDrvIdx[KDIMGSENSOR_MAX_INVOKE_DRIVERS];
 /*=============================================================================
 
 =============================================================================*/
@@ -257,6 +269,8 @@ int iMultiReadReg(u16 a_u2Addr , u8 *a_puBuff , u16 i2cId, u8 number)
 	int  i4RetValue = 0;
 	char puReadCmd[2] = {(char)(a_u2Addr >> 8) , (char)(a_u2Addr & 0xFF)};
 
+	kdSensorRegSeqSync();
+
 	if (gI2CBusNum == SUPPORT_I2C_BUS_NUM1) {
 		spin_lock(&kdsensor_drv_lock);
 
@@ -305,6 +319,8 @@ int iReadReg(u16 a_u2Addr , u8 *a_puBuff , u16 i2cId)
 	int  i4RetValue = 0;
 	char puReadCmd[2] = {(char)(a_u2Addr >> 8) , (char)(a_u2Addr & 0xFF)};
 
+	kdSensorRegSeqSync();
+
 	if (gI2CBusNum == SUPPORT_I2C_BUS_NUM1) {
 		spin_lock(&kdsensor_drv_lock);
 
@@ -366,6 +382,9 @@ int iReadReg(u16 a_u2Addr , u8 *a_puBuff , u16 i2cId)
 int iReadRegI2C(u8 *a_pSendData , u16 a_sizeSendData, u8 *a_pRecvData, u16 a_sizeRecvData, u16 i2cId)
 {
 	int  i4RetValue = 0;
+
+	kdSensorRegSeqSync();
+
 	if (gI2CBusNum == SUPPORT_I2C_BUS_NUM1) {
 		spin_lock(&kdsensor_drv_lock);
 		g_pstI2Cclient->addr = (i2cId >> 1);
@@ -434,6 +453,8 @@ int iWriteReg(u16 a_u2Addr , u32 a_u4Data , u32 a_u4Bytes , u16 i2cId)
 			     0 , 0 , 0 , 0
 			    };
 
+	kdSensorRegSeqSync();
+
 	/* PK_DBG("Addr : 0x%x,Val : 0x%x\n",a_u2Addr,a_u4Data); */
 
 	/* KD_IMGSENSOR_PROFILE_INIT(); */
@@ -481,7 +502,7 @@ int iWriteReg(u16 a_u2Addr , u32 a_u4Data , u32 a_u4Bytes , u16 i2cId)
 
 int kdSetI2CBusNum(u32 i2cBusNum)
 {
-
+	kdSensorRegSeqSync();
 	if ((i2cBusNum != SUPPORT_I2C_BUS_NUM2) && (i2cBusNum != SUPPORT_I2C_BUS_NUM1)) {
 		PK_ERR("[kdSetI2CBusNum] i2c bus number is not correct(%d)\n", i2cBusNum);
 		return -1;
@@ -495,6 +516,7 @@ int kdSetI2CBusNum(u32 i2cBusNum)
 
 void kdSetI2CSpeed(u32 i2cSpeed)
 {
+	kdSensorRegSeqSync();
 	if (gI2CBusNum == SUPPORT_I2C_BUS_NUM1) {
 		spin_lock(&kdsensor_drv_lock);
 		g_pstI2Cclient->timing = i2cSpeed;
@@ -535,6 +557,8 @@ int iBurstWriteReg_multi(u8 *pData, u32 bytes, u16 i2cId, u16 transfer_length)
 	int ret = 0;
 	int retry = 0;
 
+	kdSensorRegSeqSync();
+
 	if (gI2CBusNum == SUPPORT_I2C_BUS_NUM1) {
 		if (bytes > MAX_CMD_LEN) {
 			PK_DBG("[iBurstWriteReg] exceed the max write length\n");
@@ -630,6 +654,8 @@ int iMultiWriteReg(u8 *pData, u16 lens, u16 i2cId)
 {
 	int ret = 0;
 
+	kdSensorRegSeqSync();
+
 	if (gI2CBusNum == SUPPORT_I2C_BUS_NUM1) {
 		g_pstI2Cclient->addr = (i2cId >> 1);
 		g_pstI2Cclient->ext_flag = (g_pstI2Cclient->ext_flag) | (I2C_DMA_FLAG);
@@ -655,6 +681,8 @@ int iWriteRegI2C(u8 *a_pSendData , u16 a_sizeSendData, u16 i2cId)
 	int  i4RetValue = 0;
 	int retry = 3;
 
+	kdSensorRegSeqSync();
+
 	/* PK_DBG("Addr : 0x%x,Val : 0x%x\n",a_u2Addr,a_u4Data); */
 
 	/* KD_IMGSENSOR_PROFILE_INIT(); */
@@ -686,6 +714,188 @@ int iWriteRegI2C(u8 *a_pSendData , u16 a_sizeSendData, u16 i2cId)
 	return 0;
 }
 
+/*******************************************************************************
+* kdSensorRegSeqWrite
+********************************************************************************/
+/* One transaction is the 2 byte start address plus the data of every entry
+ * that follows on the next address. Short transactions go through the FIFO,
+ * longer ones through DMA from a coherent buffer kept for the device life.
+ */
+#define KD_REG_SEQ_BUF_SIZE		1024
+#define KD_REG_SEQ_FIFO_SIZE		8
+
+typedef struct {
+	const KD_SENSOR_REG *regs;
+	MUINT32 count;
+	u16 i2cId;
+	u32 busNum;
+	KD_SENSOR_REG_SEQ_DONE done;
+	void *priv;
+	int err;
+} KD_SENSOR_REG_SEQ_JOB;
+
+static void kdRegSeqWork(struct work_struct *work);
+
+static DEFINE_MUTEX(kdRegSeq_Mutex);
+static DECLARE_WORK(g_RegSeqWork, kdRegSeqWork);
+static KD_SENSOR_REG_SEQ_JOB g_RegSeqJob;
+static u8 *g_pRegSeqBuf;
+static dma_addr_t g_RegSeqBufPa;
+
+static int kdRegSeqSend(struct i2c_client *client, u16 i2cId, u16 bytes)
+{
+	u16 old_addr;
+	u32 old_flag;
+	int ret = 0;
+	int retry = 3;
+
+	spin_lock(&kdsensor_drv_lock);
+	old_addr = client->addr;
+	old_flag = client->ext_flag;
+	client->addr = (i2cId >> 1);
+	if (bytes > KD_REG_SEQ_FIFO_SIZE) {
+		client->ext_flag = (client->ext_flag | I2C_ENEXT_FLAG | I2C_DMA_FLAG);
+		client->ext_flag = (client->ext_flag) & (~I2C_POLLING_FLAG);
+	} else {
+		client->ext_flag = (client->ext_flag) & (~I2C_DMA_FLAG);
+	}
+	spin_unlock(&kdsensor_drv_lock);
+
+	do {
+		if (bytes > KD_REG_SEQ_FIFO_SIZE)
+			ret = i2c_master_send(client, (u8 *)(uintptr_t)g_RegSeqBufPa, bytes);
+		else
+			ret = i2c_master_send(client, g_pRegSeqBuf, bytes);
+		if (ret == bytes)
+			break;
+		PK_ERR("[kdRegSeqSend] I2C send failed, addr = 0x%x, len = %d, ret = %d\n",
+		       (g_pRegSeqBuf[0] << 8) | g_pRegSeqBuf[1], bytes, ret);
+		uDELAY(50);
+	} while (--retry > 0);
+
+	spin_lock(&kdsensor_drv_lock);
+	client->addr = old_addr;
+	client->ext_flag = old_flag;
+	spin_unlock(&kdsensor_drv_lock);
+
+	return (ret == bytes) ? 0 : -EIO;
+}
+
+/* Caller holds kdRegSeq_Mutex or runs as g_RegSeqWork */
+static int kdRegSeqRun(const KD_SENSOR_REG *regs, MUINT32 count, u16 i2cId, u32 busNum)
+{
+	struct i2c_client *client;
+	MUINT32 i = 0;
+	u16 next = 0;
+	u16 bytes = 0;
+	int ret = 0;
+
+	client = (busNum == SUPPORT_I2C_BUS_NUM1) ? g_pstI2Cclient : g_pstI2Cclient2;
+	if (NULL == client || NULL == g_pRegSeqBuf)
+		return -ENODEV;
+
+	for (i = 0; i < count; i++) {
+		if (regs[i].len > 2) {
+			PK_ERR("[kdRegSeqRun] bad entry %d, len = %d\n", i, regs[i].len);
+			return -EINVAL;
+		}
+		/* close the open transaction unless this entry extends it */
+		if (bytes && (regs[i].len == 0 || regs[i].addr != next ||
+			      bytes + regs[i].len > KD_REG_SEQ_BUF_SIZE)) {
+			ret = kdRegSeqSend(client, i2cId, bytes);
+			if (ret)
+				return ret;
+			bytes = 0;
+		}
+		if (regs[i].len == 0) {
+			usleep_range(regs[i].data * 1000, regs[i].data * 1000 + 100);
+			continue;
+		}
+		if (bytes == 0) {
+			g_pRegSeqBuf[0] = (u8)(regs[i].addr >> 8);
+			g_pRegSeqBuf[1] = (u8)(regs[i].addr & 0xFF);
+			bytes = 2;
+		}
+		if (regs[i].len == 2)
+			g_pRegSeqBuf[bytes++] = (u8)(regs[i].data >> 8);
+		g_pRegSeqBuf[bytes++] = (u8)(regs[i].data & 0xFF);
+		next = regs[i].addr + regs[i].len;
+	}
+	if (bytes)
+		ret = kdRegSeqSend(client, i2cId, bytes);
+
+	return ret;
+}
+
+static int kdRegSeqBufAlloc(void)
+{
+	if (g_pRegSeqBuf)
+		return 0;
+
+	g_pRegSeqBuf = dma_alloc_coherent(&(camerahw_platform_device.dev), KD_REG_SEQ_BUF_SIZE,
+					  &g_RegSeqBufPa, GFP_KERNEL);
+	if (NULL == g_pRegSeqBuf) {
+		PK_ERR("[kdRegSeqBufAlloc] Not enough memory\n");
+		return -ENOMEM;
+	}
+	return 0;
+}
+
+static void kdRegSeqWork(struct work_struct *work)
+{
+	KD_SENSOR_REG_SEQ_JOB *job = &g_RegSeqJob;
+
+	job->err = kdRegSeqRun(job->regs, job->count, job->i2cId, job->busNum);
+	if (job->done)
+		job->done(job->priv, job->err);
+}
+
+int kdSensorRegSeqWrite(const KD_SENSOR_REG *regs, MUINT32 count, u16 i2cId)
+{
+	int ret = 0;
+
+	mutex_lock(&kdRegSeq_Mutex);
+	flush_work(&g_RegSeqWork);
+	ret = kdRegSeqBufAlloc();
+	if (!ret)
+		ret = kdRegSeqRun(regs, count, i2cId, gI2CBusNum);
+	mutex_unlock(&kdRegSeq_Mutex);
+
+	return ret;
+}
+
+int kdSensorRegSeqWriteAsync(const KD_SENSOR_REG *regs, MUINT32 count, u16 i2cId,
+			     KD_SENSOR_REG_SEQ_DONE done, void *priv)
+{
+	int ret = 0;
+
+	mutex_lock(&kdRegSeq_Mutex);
+	flush_work(&g_RegSeqWork);
+	ret = kdRegSeqBufAlloc();
+	if (!ret) {
+		g_RegSeqJob.regs = regs;
+		g_RegSeqJob.count = count;
+		g_RegSeqJob.i2cId = i2cId;
+		g_RegSeqJob.busNum = gI2CBusNum;
+		g_RegSeqJob.done = done;
+		g_RegSeqJob.priv = priv;
+		g_RegSeqJob.err = 0;
+		queue_work(system_unbound_wq, &g_RegSeqWork);
+	}
+	mutex_unlock(&kdRegSeq_Mutex);
+
+	return ret;
+}
+
+/* Every other I2C entry point waits here, so a queued table never
+ * interleaves with single register accesses or a bus/speed change.
+ */
+int kdSensorRegSeqSync(void)
+{
+	flush_work(&g_RegSeqWork);
+	return g_RegSeqJob.err;
+}
+
 /*******************************************************************************
 * sensor function adapter
 ********************************************************************************/
@@ -703,6 +913,62 @@ kdSetI2CSlaveID(MINT32 i, MUINT32 socketIdx, MUINT32 firstSet)
 	return g_pInvokeSensorFunc[i]->SensorFeatureControl(SENSOR_FEATURE_SET_SLAVE_I2C_ID, (MUINT8 *)FeaturePara, (MUINT32 *)&FeatureParaLen);
 }
 
+/*******************************************************************************
+* sensor probe cache
+********************************************************************************/
+static int kdSensorProbeCacheIdx(CAMERA_DUAL_CAMERA_SENSOR_ENUM socketIdx)
+{
+	switch (socketIdx) {
+	case DUAL_CAMERA_MAIN_SENSOR:
+		return 0;
+	case DUAL_CAMERA_SUB_SENSOR:
+		return 1;
+	case DUAL_CAMERA_MAIN_2_SENSOR:
+		return 2;
+	default:
+		return -1;
+	}
+}
+
+/* 1 found, 0 not found, -1 not probed yet */
+static int kdSensorProbeCacheGet(CAMERA_DUAL_CAMERA_SENSOR_ENUM socketIdx, u32 drvIdx)
+{
+	int idx = kdSensorProbeCacheIdx(socketIdx);
+
+	if (idx < 0 || drvIdx >= MAX_NUM_OF_SUPPORT_SENSOR)
+		return -1;
+	if (g_ProbeFoundMask[idx] & (1 << drvIdx))
+		return 1;
+	if (g_ProbeAbsentMask[idx] & (1 << drvIdx))
+		return 0;
+	return -1;
+}
+
+static void kdSensorProbeCacheSet(CAMERA_DUAL_CAMERA_SENSOR_ENUM socketIdx, u32 drvIdx, BOOL found)
+{
+	int idx = kdSensorProbeCacheIdx(socketIdx);
+
+	if (idx < 0 || drvIdx >= MAX_NUM_OF_SUPPORT_SENSOR)
+		return;
+	if (found)
+		g_ProbeFoundMask[idx] |= (1 << drvIdx);
+	else
+		g_ProbeAbsentMask[idx] |= (1 << drvIdx);
+}
+
+/* The module on this socket no longer answers as probed, forget it */
+static void kdSensorProbeCacheDrop(CAMERA_DUAL_CAMERA_SENSOR_ENUM socketIdx)
+{
+	int idx = kdSensorProbeCacheIdx(socketIdx);
+
+	if (idx < 0)
+		return;
+	if (g_ProbeFoundMask[idx] || g_ProbeAbsentMask[idx])
+		PK_INF("drop probe cache of socket %d\n", socketIdx);
+	g_ProbeFoundMask[idx] = 0;
+	g_ProbeAbsentMask[idx] = 0;
+}
+
 /*  */
 MUINT32
 kd_MultiSensorOpen(void)
@@ -756,7 +1022,9 @@ kd_MultiSensorOpen(void)
 				/*  */
 				ret = g_pInvokeSensorFunc[i]->SensorOpen();
 				if (ERROR_NONE != ret) {
+					kdSensorProbeCacheDrop(g_invokeSocketIdx[i]);
 #ifndef CONFIG_FPGA_EARLY_PORTING
+					kdSensorRegSeqSync();
 					kdCISModulePowerOn((CAMERA_DUAL_CAMERA_SENSOR_ENUM)g_invokeSocketIdx[i], (char *)g_invokeSensorNameStr[i], false, CAMERA_HW_DRVNAME1);
 #endif
 					PK_ERR("SensorOpen");
@@ -999,6 +1267,8 @@ kd_MultiSensorClose(void)
 				}
 #endif
 				ret = g_pInvokeSensorFunc[i]->SensorClose();
+				/* do not cut power under a queued register table */
+				kdSensorRegSeqSync();
 
 #ifndef CONFIG_FPGA_EARLY_PORTING
 				/* Change the close power flow to close power in this function & */
@@ -1044,6 +1314,8 @@ kdModulePowerOn(
 		if (g_bEnableDriver[i]) {
 			/* PK_XLOG_INFO("[%s][%d][%d][%s][%s]\r\n",__FUNCTION__,g_bEnableDriver[i],socketIdx[i],sensorNameStr[i],mode_name); */
 #ifndef CONFIG_FPGA_EARLY_PORTING
+			if (!On)
+				kdSensorRegSeqSync();
 			ret = kdCISModulePowerOn(socketIdx[i], sensorNameStr[i], On, mode_name);
 #endif
 			if (ERROR_NONE != ret) {
@@ -1124,6 +1396,7 @@ int kdSetDriver(unsigned int *pDrvIndex)
 			/*  */
 			spin_lock(&kdsensor_drv_lock);
 			g_bEnableDriver[i] = TRUE;
+			g_invokeDrvIdx[i] = drvIdx[i];
 			spin_unlock(&kdsensor_drv_lock);
 			/* get sensor name */
 			memcpy((char *)g_invokeSensorNameStr[i], (char *)pSensorList[drvIdx[i]].drvname, sizeof(pSensorList[drvIdx[i]].drvname));
@@ -1345,6 +1618,11 @@ static inline int adopt_CAMERA_HW_Open(void)
 	}
 
 	KD_IMGSENSOR_PROFILE("SensorOpen");
+
+	if (ERROR_NONE == err && !g_bCamSmiScen) {
+		smi_kernel_scenario_enter(SMI_BWC_SCEN_VR);
+		g_bCamSmiScen = TRUE;
+	}
 	/* } */
 	/* else { */
 	/* PK_ERR("adopt_CAMERA_HW_Open Fail, g_CamHWOpend = %d\n ",atomic_read(&g_CamHWOpend) ); */
@@ -1370,6 +1648,31 @@ static inline int adopt_CAMERA_HW_CheckIsAlive(void)
 	MUINT32 retLen = 0;
 #ifndef CONFIG_MTK_FPGA
 	KD_IMGSENSOR_PROFILE_INIT();
+	/* Camera information */
+	if (gDrvIndex == 0x10000) {
+		memset(mtk_ccm_name, 0, camera_info_size);
+	}
+	/* every invoked socket probed before, answer without a power cycle */
+	for (i = KDIMGSENSOR_INVOKE_DRIVER_0; i < KDIMGSENSOR_MAX_INVOKE_DRIVERS; i++) {
+		if (DUAL_CAMERA_NONE_SENSOR != g_invokeSocketIdx[i] &&
+		    kdSensorProbeCacheGet(g_invokeSocketIdx[i], g_invokeDrvIdx[i]) < 0)
+			break;
+	}
+	if (KDIMGSENSOR_MAX_INVOKE_DRIVERS == i) {
+		for (i = KDIMGSENSOR_INVOKE_DRIVER_0; i < KDIMGSENSOR_MAX_INVOKE_DRIVERS; i++) {
+			if (DUAL_CAMERA_NONE_SENSOR == g_invokeSocketIdx[i])
+				continue;
+			if (kdSensorProbeCacheGet(g_invokeSocketIdx[i], g_invokeDrvIdx[i]) > 0) {
+				PK_INF(" Sensor found (cached) %s\n", g_invokeSensorNameStr[i]);
+				snprintf(mtk_ccm_name, sizeof(mtk_ccm_name), "%s CAM[%d]:%s;", mtk_ccm_name, g_invokeSocketIdx[i], g_invokeSensorNameStr[i]);
+				err = ERROR_NONE;
+			} else {
+				err = ERROR_SENSOR_CONNECT_FAIL;
+			}
+		}
+		KD_IMGSENSOR_PROFILE("CheckIsAlive cached");
+		return err ?  -EIO : err;
+	}
 	/* power on sensor */
 	kdModulePowerOn((CAMERA_DUAL_CAMERA_SENSOR_ENUM *)g_invokeSocketIdx, g_invokeSensorNameStr, true, CAMERA_HW_DRVNAME1);
 	/* wait for power stable */
@@ -1380,10 +1683,6 @@ static inline int adopt_CAMERA_HW_CheckIsAlive(void)
 	g_CurrentSensorIdx = 0;
 	/* Search sensor keep i2c debug log */
 	g_IsSearchSensor = 1;
-	/* Camera information */
-	if (gDrvIndex == 0x10000) {
-		memset(mtk_ccm_name, 0, camera_info_size);
-	}
 
 	if (g_pSensorFunc) {
 		for (i = KDIMGSENSOR_INVOKE_DRIVER_0; i < KDIMGSENSOR_MAX_INVOKE_DRIVERS; i++) {
@@ -1394,8 +1693,10 @@ static inline int adopt_CAMERA_HW_CheckIsAlive(void)
 					err = ERROR_SENSOR_CONNECT_FAIL;
 				} else if (sensorID == 0xFFFFFFFF) {  /* fail to open the sensor */
 					PK_DBG(" No Sensor Found");
+					kdSensorProbeCacheSet(g_invokeSocketIdx[i], g_invokeDrvIdx[i], FALSE);
 					err = ERROR_SENSOR_CONNECT_FAIL;
 				} else {
+					kdSensorProbeCacheSet(g_invokeSocketIdx[i], g_invokeDrvIdx[i], TRUE);
 
 					PK_INF(" Sensor found ID = 0x%x\n", sensorID);
 					snprintf(mtk_ccm_name, sizeof(mtk_ccm_name), "%s CAM[%d]:%s;", mtk_ccm_name, g_invokeSocketIdx[i], g_invokeSensorNameStr[i]);
@@ -2598,6 +2899,11 @@ static inline int adopt_CAMERA_HW_Close(void)
 
 	atomic_set(&g_CamHWOpening, 0);
 
+	if (g_bCamSmiScen) {
+		smi_kernel_scenario_exit(SMI_BWC_SCEN_VR);
+		g_bCamSmiScen = FALSE;
+	}
+
 	/* reset the delay frame flag */
 	spin_lock(&kdsensor_drv_lock);
 	g_NewSensorExpGain.uSensorExpDelayFrame = 0xFF;
@@ -3453,7 +3759,15 @@ static int CAMERA_HW_Open(struct inode *a_pstInode, struct file *a_pstFile)
 ********************************************************************************/
 static int CAMERA_HW_Release(struct inode *a_pstInode, struct file *a_pstFile)
 {
-	atomic_dec(&g_CamDrvOpenCnt);
+	/* camera daemon died without T_CLOSE */
+	if (atomic_dec_and_test(&g_CamDrvOpenCnt)) {
+		mutex_lock(&kdCam_Mutex);
+		if (g_bCamSmiScen) {
+			smi_kernel_scenario_exit(SMI_BWC_SCEN_VR);
+			g_bCamSmiScen = FALSE;
+		}
+		mutex_unlock(&kdCam_Mutex);
+	}
 
 	return 0;
 }
@@ -33,6 +33,7 @@
 #include "kd_imgsensor.h"
 #include "kd_imgsensor_define.h"
 #include "kd_imgsensor_errcode.h"
+#include "kd_imgsensor_regseq.h"
 
 #include "s5k2p8mipi_Sensor.h"
 
@@ -290,6 +291,13 @@ static void write_cmos_sensor_8(kal_uint16 addr, kal_uint8 para)
     iWriteRegI2C(pusendcmd , 3, imgsensor.i2c_write_id);
 }
 
+static void write_cmos_sensor_seq(const KD_SENSOR_REG *regs, MUINT32 count)
+{
+    kdSetI2CSpeed(imgsensor_info.i2c_speed); // Add this func to set i2c speed by each sensor
+    kdSensorRegSeqWrite(regs, count, imgsensor.i2c_write_id);
+}
+#define write_cmos_sensor_table(regs) write_cmos_sensor_seq(regs, ARRAY_SIZE(regs))
+
 
 static void set_dummy(void)
 {
@@ -557,6 +565,819 @@ static void set_mirror_flip(kal_uint8 image_mirror)
 *************************************************************************/
 
 
+static const KD_SENSOR_REG sensor_init_regs[] = {
+	KD_SENSOR_REG16(0x6010, 0x0001), //Reset
+	KD_SENSOR_REG_DELAY(3),
+	KD_SENSOR_REG16(0x6214, 0x7970), //open all clocks
+	KD_SENSOR_REG16(0x6218, 0x7150), //open all clocks
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x2E00),
+	KD_SENSOR_REG16(0x6F12, 0x0448),
+	KD_SENSOR_REG16(0x6F12, 0x0349),
+	KD_SENSOR_REG16(0x6F12, 0x0160),
+	KD_SENSOR_REG16(0x6F12, 0xC26A),
+	KD_SENSOR_REG16(0x6F12, 0x511A),
+	KD_SENSOR_REG16(0x6F12, 0x8180),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x10B9),
+	KD_SENSOR_REG16(0x6F12, 0x2000),
+	KD_SENSOR_REG16(0x6F12, 0x315C),
+	KD_SENSOR_REG16(0x6F12, 0x2000),
+	KD_SENSOR_REG16(0x6F12, 0x1AE0),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x2DE9),
+	KD_SENSOR_REG16(0x6F12, 0xF041),
+	KD_SENSOR_REG16(0x6F12, 0x0646),
+	KD_SENSOR_REG16(0x6F12, 0x9A48),
+	KD_SENSOR_REG16(0x6F12, 0x0F46),
+	KD_SENSOR_REG16(0x6F12, 0x9046),
+	KD_SENSOR_REG16(0x6F12, 0x4068),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0x85B2),
+	KD_SENSOR_REG16(0x6F12, 0x040C),
+	KD_SENSOR_REG16(0x6F12, 0x2946),
+	KD_SENSOR_REG16(0x6F12, 0x2046),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x4CF9),
+	KD_SENSOR_REG16(0x6F12, 0x4246),
+	KD_SENSOR_REG16(0x6F12, 0x3946),
+	KD_SENSOR_REG16(0x6F12, 0x3046),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x4CF9),
+	KD_SENSOR_REG16(0x6F12, 0x9348),
+	KD_SENSOR_REG16(0x6F12, 0x807E),
+	KD_SENSOR_REG16(0x6F12, 0x28B1),
+	KD_SENSOR_REG16(0x6F12, 0x9248),
+	KD_SENSOR_REG16(0x6F12, 0x90F8),
+	KD_SENSOR_REG16(0x6F12, 0xFA00),
+	KD_SENSOR_REG16(0x6F12, 0x08B1),
+	KD_SENSOR_REG16(0x6F12, 0x0122),
+	KD_SENSOR_REG16(0x6F12, 0x00E0),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0x9048),
+	KD_SENSOR_REG16(0x6F12, 0x0280),
+	KD_SENSOR_REG16(0x6F12, 0x2946),
+	KD_SENSOR_REG16(0x6F12, 0x2046),
+	KD_SENSOR_REG16(0x6F12, 0xBDE8),
+	KD_SENSOR_REG16(0x6F12, 0xF041),
+	KD_SENSOR_REG16(0x6F12, 0x0122),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x34B9),
+	KD_SENSOR_REG16(0x6F12, 0x8C4A),
+	KD_SENSOR_REG16(0x6F12, 0x10B5),
+	KD_SENSOR_REG16(0x6F12, 0x1268),
+	KD_SENSOR_REG16(0x6F12, 0xB2F8),
+	KD_SENSOR_REG16(0x6F12, 0xC230),
+	KD_SENSOR_REG16(0x6F12, 0x874A),
+	KD_SENSOR_REG16(0x6F12, 0x546B),
+	KD_SENSOR_REG16(0x6F12, 0xB2F8),
+	KD_SENSOR_REG16(0x6F12, 0x2E21),
+	KD_SENSOR_REG16(0x6F12, 0x6409),
+	KD_SENSOR_REG16(0x6F12, 0x6343),
+	KD_SENSOR_REG16(0x6F12, 0x4FF4),
+	KD_SENSOR_REG16(0x6F12, 0x7A74),
+	KD_SENSOR_REG16(0x6F12, 0x6243),
+	KD_SENSOR_REG16(0x6F12, 0x5209),
+	KD_SENSOR_REG16(0x6F12, 0xB3FB),
+	KD_SENSOR_REG16(0x6F12, 0xF2F3),
+	KD_SENSOR_REG16(0x6F12, 0x021D),
+	KD_SENSOR_REG16(0x6F12, 0x8A42),
+	KD_SENSOR_REG16(0x6F12, 0x02D2),
+	KD_SENSOR_REG16(0x6F12, 0x0A1A),
+	KD_SENSOR_REG16(0x6F12, 0x121F),
+	KD_SENSOR_REG16(0x6F12, 0x00E0),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0x9A42),
+	KD_SENSOR_REG16(0x6F12, 0x00D8),
+	KD_SENSOR_REG16(0x6F12, 0x1A46),
+	KD_SENSOR_REG16(0x6F12, 0x8048),
+	KD_SENSOR_REG16(0x6F12, 0x0280),
+	KD_SENSOR_REG16(0x6F12, 0x10BD),
+	KD_SENSOR_REG16(0x6F12, 0x2DE9),
+	KD_SENSOR_REG16(0x6F12, 0xF34F),
+	KD_SENSOR_REG16(0x6F12, 0x0446),
+	KD_SENSOR_REG16(0x6F12, 0x7848),
+	KD_SENSOR_REG16(0x6F12, 0x83B0),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0xC068),
+	KD_SENSOR_REG16(0x6F12, 0x010C),
+	KD_SENSOR_REG16(0x6F12, 0x80B2),
+	KD_SENSOR_REG16(0x6F12, 0xCDE9),
+	KD_SENSOR_REG16(0x6F12, 0x0001),
+	KD_SENSOR_REG16(0x6F12, 0x0146),
+	KD_SENSOR_REG16(0x6F12, 0x0198),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x07F9),
+	KD_SENSOR_REG16(0x6F12, 0xDFF8),
+	KD_SENSOR_REG16(0x6F12, 0xE091),
+	KD_SENSOR_REG16(0x6F12, 0xDFF8),
+	KD_SENSOR_REG16(0x6F12, 0xD4B1),
+	KD_SENSOR_REG16(0x6F12, 0x0021),
+	KD_SENSOR_REG16(0x6F12, 0x99F8),
+	KD_SENSOR_REG16(0x6F12, 0x2A70),
+	KD_SENSOR_REG16(0x6F12, 0x89F8),
+	KD_SENSOR_REG16(0x6F12, 0x2A10),
+	KD_SENSOR_REG16(0x6F12, 0xDFF8),
+	KD_SENSOR_REG16(0x6F12, 0xBCA1),
+	KD_SENSOR_REG16(0x6F12, 0x734D),
+	KD_SENSOR_REG16(0x6F12, 0xDBF8),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x9AF8),
+	KD_SENSOR_REG16(0x6F12, 0xFA80),
+	KD_SENSOR_REG16(0x6F12, 0xAE8A),
+	KD_SENSOR_REG16(0x6F12, 0xB0F8),
+	KD_SENSOR_REG16(0x6F12, 0xC400),
+	KD_SENSOR_REG16(0x6F12, 0x20B1),
+	KD_SENSOR_REG16(0x6F12, 0xA08A),
+	KD_SENSOR_REG16(0x6F12, 0x296E),
+	KD_SENSOR_REG16(0x6F12, 0x4843),
+	KD_SENSOR_REG16(0x6F12, 0x000B),
+	KD_SENSOR_REG16(0x6F12, 0xA882),
+	KD_SENSOR_REG16(0x6F12, 0x2046),
+	KD_SENSOR_REG16(0x6F12, 0x0499),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0xF4F8),
+	KD_SENSOR_REG16(0x6F12, 0xAE82),
+	KD_SENSOR_REG16(0x6F12, 0xB9F8),
+	KD_SENSOR_REG16(0x6F12, 0x1C00),
+	KD_SENSOR_REG16(0x6F12, 0x9AF8),
+	KD_SENSOR_REG16(0x6F12, 0xFA50),
+	KD_SENSOR_REG16(0x6F12, 0xC0F3),
+	KD_SENSOR_REG16(0x6F12, 0x0030),
+	KD_SENSOR_REG16(0x6F12, 0x4545),
+	KD_SENSOR_REG16(0x6F12, 0x08D0),
+	KD_SENSOR_REG16(0x6F12, 0x38B1),
+	KD_SENSOR_REG16(0x6F12, 0xDBF8),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0xB0F8),
+	KD_SENSOR_REG16(0x6F12, 0xC600),
+	KD_SENSOR_REG16(0x6F12, 0x10B1),
+	KD_SENSOR_REG16(0x6F12, 0x0020),
+	KD_SENSOR_REG16(0x6F12, 0xCAF8),
+	KD_SENSOR_REG16(0x6F12, 0x0001),
+	KD_SENSOR_REG16(0x6F12, 0x17F0),
+	KD_SENSOR_REG16(0x6F12, 0xFF00),
+	KD_SENSOR_REG16(0x6F12, 0x89F8),
+	KD_SENSOR_REG16(0x6F12, 0x2A00),
+	KD_SENSOR_REG16(0x6F12, 0x03D0),
+	KD_SENSOR_REG16(0x6F12, 0xA18A),
+	KD_SENSOR_REG16(0x6F12, 0x2068),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0xDEF8),
+	KD_SENSOR_REG16(0x6F12, 0xDDE9),
+	KD_SENSOR_REG16(0x6F12, 0x0010),
+	KD_SENSOR_REG16(0x6F12, 0x05B0),
+	KD_SENSOR_REG16(0x6F12, 0x0122),
+	KD_SENSOR_REG16(0x6F12, 0xBDE8),
+	KD_SENSOR_REG16(0x6F12, 0xF04F),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0xC7B8),
+	KD_SENSOR_REG16(0x6F12, 0x70B5),
+	KD_SENSOR_REG16(0x6F12, 0x0446),
+	KD_SENSOR_REG16(0x6F12, 0x5148),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0x0169),
+	KD_SENSOR_REG16(0x6F12, 0x0D0C),
+	KD_SENSOR_REG16(0x6F12, 0x8EB2),
+	KD_SENSOR_REG16(0x6F12, 0x3146),
+	KD_SENSOR_REG16(0x6F12, 0x2846),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0xBCF8),
+	KD_SENSOR_REG16(0x6F12, 0x2046),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0xCDF8),
+	KD_SENSOR_REG16(0x6F12, 0x94F8),
+	KD_SENSOR_REG16(0x6F12, 0x6000),
+	KD_SENSOR_REG16(0x6F12, 0x0128),
+	KD_SENSOR_REG16(0x6F12, 0x07D1),
+	KD_SENSOR_REG16(0x6F12, 0x5148),
+	KD_SENSOR_REG16(0x6F12, 0x0068),
+	KD_SENSOR_REG16(0x6F12, 0x8078),
+	KD_SENSOR_REG16(0x6F12, 0xF528),
+	KD_SENSOR_REG16(0x6F12, 0x02D0),
+	KD_SENSOR_REG16(0x6F12, 0x0020),
+	KD_SENSOR_REG16(0x6F12, 0x84F8),
+	KD_SENSOR_REG16(0x6F12, 0x6000),
+	KD_SENSOR_REG16(0x6F12, 0x3146),
+	KD_SENSOR_REG16(0x6F12, 0x2846),
+	KD_SENSOR_REG16(0x6F12, 0xBDE8),
+	KD_SENSOR_REG16(0x6F12, 0x7040),
+	KD_SENSOR_REG16(0x6F12, 0x0122),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0xA6B8),
+	KD_SENSOR_REG16(0x6F12, 0x70B5),
+	KD_SENSOR_REG16(0x6F12, 0x0446),
+	KD_SENSOR_REG16(0x6F12, 0x4048),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0x4069),
+	KD_SENSOR_REG16(0x6F12, 0x86B2),
+	KD_SENSOR_REG16(0x6F12, 0x050C),
+	KD_SENSOR_REG16(0x6F12, 0x3146),
+	KD_SENSOR_REG16(0x6F12, 0x2846),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x9BF8),
+	KD_SENSOR_REG16(0x6F12, 0x2046),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0xB1F8),
+	KD_SENSOR_REG16(0x6F12, 0x207C),
+	KD_SENSOR_REG16(0x6F12, 0x40B1),
+	KD_SENSOR_REG16(0x6F12, 0x424A),
+	KD_SENSOR_REG16(0x6F12, 0xA168),
+	KD_SENSOR_REG16(0x6F12, 0x2068),
+	KD_SENSOR_REG16(0x6F12, 0x92F8),
+	KD_SENSOR_REG16(0x6F12, 0xB921),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0xADF8),
+	KD_SENSOR_REG16(0x6F12, 0x4049),
+	KD_SENSOR_REG16(0x6F12, 0x0880),
+	KD_SENSOR_REG16(0x6F12, 0x3146),
+	KD_SENSOR_REG16(0x6F12, 0x2846),
+	KD_SENSOR_REG16(0x6F12, 0xBDE8),
+	KD_SENSOR_REG16(0x6F12, 0x7040),
+	KD_SENSOR_REG16(0x6F12, 0x0122),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x86B8),
+	KD_SENSOR_REG16(0x6F12, 0x2DE9),
+	KD_SENSOR_REG16(0x6F12, 0xF041),
+	KD_SENSOR_REG16(0x6F12, 0x304C),
+	KD_SENSOR_REG16(0x6F12, 0x8046),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0xA069),
+	KD_SENSOR_REG16(0x6F12, 0x87B2),
+	KD_SENSOR_REG16(0x6F12, 0x060C),
+	KD_SENSOR_REG16(0x6F12, 0x3946),
+	KD_SENSOR_REG16(0x6F12, 0x3046),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x7AF8),
+	KD_SENSOR_REG16(0x6F12, 0x2F4D),
+	KD_SENSOR_REG16(0x6F12, 0xB8F1),
+	KD_SENSOR_REG16(0x6F12, 0x000F),
+	KD_SENSOR_REG16(0x6F12, 0x0BD1),
+	KD_SENSOR_REG16(0x6F12, 0x3248),
+	KD_SENSOR_REG16(0x6F12, 0x0078),
+	KD_SENSOR_REG16(0x6F12, 0x40B1),
+	KD_SENSOR_REG16(0x6F12, 0x2868),
+	KD_SENSOR_REG16(0x6F12, 0xB0F8),
+	KD_SENSOR_REG16(0x6F12, 0x6A00),
+	KD_SENSOR_REG16(0x6F12, 0x20B1),
+	KD_SENSOR_REG16(0x6F12, 0x2188),
+	KD_SENSOR_REG16(0x6F12, 0x8842),
+	KD_SENSOR_REG16(0x6F12, 0x01D0),
+	KD_SENSOR_REG16(0x6F12, 0x0120),
+	KD_SENSOR_REG16(0x6F12, 0x00E0),
+	KD_SENSOR_REG16(0x6F12, 0x0020),
+	KD_SENSOR_REG16(0x6F12, 0x38B1),
+	KD_SENSOR_REG16(0x6F12, 0x2449),
+	KD_SENSOR_REG16(0x6F12, 0x0020),
+	KD_SENSOR_REG16(0x6F12, 0xC1F8),
+	KD_SENSOR_REG16(0x6F12, 0xDC01),
+	KD_SENSOR_REG16(0x6F12, 0x81F8),
+	KD_SENSOR_REG16(0x6F12, 0xCC01),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x83F8),
+	KD_SENSOR_REG16(0x6F12, 0x2868),
+	KD_SENSOR_REG16(0x6F12, 0xB0F8),
+	KD_SENSOR_REG16(0x6F12, 0x6A00),
+	KD_SENSOR_REG16(0x6F12, 0x2080),
+	KD_SENSOR_REG16(0x6F12, 0x4046),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x81F8),
+	KD_SENSOR_REG16(0x6F12, 0x3946),
+	KD_SENSOR_REG16(0x6F12, 0x3046),
+	KD_SENSOR_REG16(0x6F12, 0xBDE8),
+	KD_SENSOR_REG16(0x6F12, 0xF041),
+	KD_SENSOR_REG16(0x6F12, 0x0122),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x52B8),
+	KD_SENSOR_REG16(0x6F12, 0x10B5),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0xAFF2),
+	KD_SENSOR_REG16(0x6F12, 0x1721),
+	KD_SENSOR_REG16(0x6F12, 0x2048),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x78F8),
+	KD_SENSOR_REG16(0x6F12, 0x144C),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0xAFF2),
+	KD_SENSOR_REG16(0x6F12, 0xD711),
+	KD_SENSOR_REG16(0x6F12, 0x6060),
+	KD_SENSOR_REG16(0x6F12, 0x1D48),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x70F8),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0xAFF2),
+	KD_SENSOR_REG16(0x6F12, 0x0D11),
+	KD_SENSOR_REG16(0x6F12, 0xA060),
+	KD_SENSOR_REG16(0x6F12, 0x1B48),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x69F8),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0xAFF2),
+	KD_SENSOR_REG16(0x6F12, 0xB711),
+	KD_SENSOR_REG16(0x6F12, 0x2061),
+	KD_SENSOR_REG16(0x6F12, 0x1848),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x62F8),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0xAFF2),
+	KD_SENSOR_REG16(0x6F12, 0xE701),
+	KD_SENSOR_REG16(0x6F12, 0xE060),
+	KD_SENSOR_REG16(0x6F12, 0x1648),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x5BF8),
+	KD_SENSOR_REG16(0x6F12, 0x0022),
+	KD_SENSOR_REG16(0x6F12, 0xAFF2),
+	KD_SENSOR_REG16(0x6F12, 0xB301),
+	KD_SENSOR_REG16(0x6F12, 0x6061),
+	KD_SENSOR_REG16(0x6F12, 0x1348),
+	KD_SENSOR_REG16(0x6F12, 0x00F0),
+	KD_SENSOR_REG16(0x6F12, 0x54F8),
+	KD_SENSOR_REG16(0x6F12, 0xA061),
+	KD_SENSOR_REG16(0x6F12, 0x0020),
+	KD_SENSOR_REG16(0x6F12, 0x2080),
+	KD_SENSOR_REG16(0x6F12, 0x10BD),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x2000),
+	KD_SENSOR_REG16(0x6F12, 0x3140),
+	KD_SENSOR_REG16(0x6F12, 0x2000),
+	KD_SENSOR_REG16(0x6F12, 0x1B10),
+	KD_SENSOR_REG16(0x6F12, 0x2000),
+	KD_SENSOR_REG16(0x6F12, 0x2530),
+	KD_SENSOR_REG16(0x6F12, 0x4000),
+	KD_SENSOR_REG16(0x6F12, 0x9802),
+	KD_SENSOR_REG16(0x6F12, 0x2000),
+	KD_SENSOR_REG16(0x6F12, 0x0550),
+	KD_SENSOR_REG16(0x6F12, 0x4000),
+	KD_SENSOR_REG16(0x6F12, 0xF000),
+	KD_SENSOR_REG16(0x6F12, 0x2000),
+	KD_SENSOR_REG16(0x6F12, 0x1300),
+	KD_SENSOR_REG16(0x6F12, 0x2000),
+	KD_SENSOR_REG16(0x6F12, 0x2890),
+	KD_SENSOR_REG16(0x6F12, 0x2000),
+	KD_SENSOR_REG16(0x6F12, 0x02C0),
+	KD_SENSOR_REG16(0x6F12, 0x2000),
+	KD_SENSOR_REG16(0x6F12, 0x1410),
+	KD_SENSOR_REG16(0x6F12, 0x4000),
+	KD_SENSOR_REG16(0x6F12, 0xA358),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x15F7),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x7A4F),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x4A69),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x1349),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x3091),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x6F12, 0x6057),
+	KD_SENSOR_REG16(0x6F12, 0x40F2),
+	KD_SENSOR_REG16(0x6F12, 0xE96C),
+	KD_SENSOR_REG16(0x6F12, 0xC0F2),
+	KD_SENSOR_REG16(0x6F12, 0x000C),
+	KD_SENSOR_REG16(0x6F12, 0x6047),
+	KD_SENSOR_REG16(0x6F12, 0x41F2),
+	KD_SENSOR_REG16(0x6F12, 0xF75C),
+	KD_SENSOR_REG16(0x6F12, 0xC0F2),
+	KD_SENSOR_REG16(0x6F12, 0x000C),
+	KD_SENSOR_REG16(0x6F12, 0x6047),
+	KD_SENSOR_REG16(0x6F12, 0x41F2),
+	KD_SENSOR_REG16(0x6F12, 0x493C),
+	KD_SENSOR_REG16(0x6F12, 0xC0F2),
+	KD_SENSOR_REG16(0x6F12, 0x000C),
+	KD_SENSOR_REG16(0x6F12, 0x6047),
+	KD_SENSOR_REG16(0x6F12, 0x41F2),
+	KD_SENSOR_REG16(0x6F12, 0x9D1C),
+	KD_SENSOR_REG16(0x6F12, 0xC0F2),
+	KD_SENSOR_REG16(0x6F12, 0x000C),
+	KD_SENSOR_REG16(0x6F12, 0x6047),
+	KD_SENSOR_REG16(0x6F12, 0x44F6),
+	KD_SENSOR_REG16(0x6F12, 0x692C),
+	KD_SENSOR_REG16(0x6F12, 0xC0F2),
+	KD_SENSOR_REG16(0x6F12, 0x000C),
+	KD_SENSOR_REG16(0x6F12, 0x6047),
+	KD_SENSOR_REG16(0x6F12, 0x43F2),
+	KD_SENSOR_REG16(0x6F12, 0x910C),
+	KD_SENSOR_REG16(0x6F12, 0xC0F2),
+	KD_SENSOR_REG16(0x6F12, 0x000C),
+	KD_SENSOR_REG16(0x6F12, 0x6047),
+	KD_SENSOR_REG16(0x6F12, 0x40F2),
+	KD_SENSOR_REG16(0x6F12, 0x156C),
+	KD_SENSOR_REG16(0x6F12, 0xC0F2),
+	KD_SENSOR_REG16(0x6F12, 0x000C),
+	KD_SENSOR_REG16(0x6F12, 0x6047),
+	KD_SENSOR_REG16(0x6F12, 0x42F2),
+	KD_SENSOR_REG16(0x6F12, 0xC71C),
+	KD_SENSOR_REG16(0x6F12, 0xC0F2),
+	KD_SENSOR_REG16(0x6F12, 0x000C),
+	KD_SENSOR_REG16(0x6F12, 0x6047),
+	KD_SENSOR_REG16(0x6F12, 0x46F2),
+	KD_SENSOR_REG16(0x6F12, 0x570C),
+	KD_SENSOR_REG16(0x6F12, 0xC0F2),
+	KD_SENSOR_REG16(0x6F12, 0x000C),
+	KD_SENSOR_REG16(0x6F12, 0x6047),
+	KD_SENSOR_REG16(0x6F12, 0x4AF6),
+	KD_SENSOR_REG16(0x6F12, 0x850C),
+	KD_SENSOR_REG16(0x6F12, 0xC0F2),
+	KD_SENSOR_REG16(0x6F12, 0x000C),
+	KD_SENSOR_REG16(0x6F12, 0x6047),
+	KD_SENSOR_REG16(0x3EA6, 0xFFFF), //fe_isp_dadlc_analog_gain_thrshold_for_ladlc_low
+	KD_SENSOR_REG16(0x3EA8, 0xFFFF), //fe_isp_dadlc_analog_gain_thrshold_for_ladlc_high
+	KD_SENSOR_REG16(0x3A56, 0x3BB8), //Sampling enable
+	KD_SENSOR_REG16(0xF476, 0x0040), //DBR
+	KD_SENSOR_REG16(0xF40C, 0x1180), //CLP on, LDB off
+	KD_SENSOR_REG16(0xF480, 0x0015), //CLP LVL
+	KD_SENSOR_REG16(0x39EE, 0x0507),
+	KD_SENSOR_REG16(0x3A06, 0x0605),
+	KD_SENSOR_REG16(0x39D0, 0x0707),
+	KD_SENSOR_REG16(0xF432, 0x0100), //DBS
+	KD_SENSOR_REG16(0xF4A6, 0x00C0), //RDV
+	KD_SENSOR_REG16(0xF42E, 0x0060), //CDS
+	KD_SENSOR_REG16(0xF49C, 0x0000), //RMP
+	KD_SENSOR_REG16(0xF496, 0x0000), //REF
+	KD_SENSOR_REG16(0xF49E, 0x005E), //ADC_SAT
+	KD_SENSOR_REG16(0xF47A, 0x0017), //VRD 3.2V
+	KD_SENSOR_REG16(0xF462, 0x0000), //VPIX 2.92V
+	KD_SENSOR_REG16(0xF460, 0x0020), //VTG 3.8V
+	KD_SENSOR_REG16(0x3A64, 0x0010),
+	KD_SENSOR_REG16(0x3A66, 0x0010),
+	KD_SENSOR_REG16(0x3A68, 0x0010),
+	KD_SENSOR_REG16(0xF426, 0x0007), //LAT START
+	KD_SENSOR_REG16(0xF428, 0x0004), //LAT WIDTH
+	KD_SENSOR_REG16(0xF42A, 0x0004), //HOLD START
+	KD_SENSOR_REG16(0xF42C, 0x0004), //HOLD WIDTH
+	KD_SENSOR_REG16(0x32BC, 0x000D), //pixel boost
+	KD_SENSOR_REG16(0x3298, 0x005E),
+	KD_SENSOR_REG16(0x3880, 0x010B),
+	KD_SENSOR_REG16(0x3886, 0x010A),
+	KD_SENSOR_REG16(0x388C, 0x021A),
+	KD_SENSOR_REG16(0x389E, 0x021C),
+	KD_SENSOR_REG16(0x38A4, 0x0000),
+	KD_SENSOR_REG16(0x38AA, 0x015C),
+	KD_SENSOR_REG16(0x38B0, 0x015B),
+	KD_SENSOR_REG16(0x38B6, 0x021A),
+	KD_SENSOR_REG16(0x38C2, 0x0070),
+	KD_SENSOR_REG16(0x38C8, 0x021C),
+	KD_SENSOR_REG16(0x38CE, 0x0000),
+	KD_SENSOR_REG16(0x3976, 0x0006),
+	KD_SENSOR_REG16(0x31C0, 0x0C40), //default 0004
+	KD_SENSOR_REG16(0x31C2, 0x0C48), //default 0B1C
+	KD_SENSOR_REG16(0x31B2, 0x080C),
+	KD_SENSOR_REG16(0x31B4, 0x0401),
+	KD_SENSOR_REG16(0x31B2, 0x0804),
+	KD_SENSOR_REG16(0x39D6, 0x0F0F),
+	KD_SENSOR_REG16(0x39DC, 0x3030),
+	KD_SENSOR_REG16(0x39B0, 0x0000),
+	KD_SENSOR_REG16(0x30C2, 0x0300),
+	KD_SENSOR_REG16(0x3AF2, 0x0000),
+	KD_SENSOR_REG16(0x3AF4, 0x0000),
+	KD_SENSOR_REG16(0x3AF6, 0x0000),
+	KD_SENSOR_REG16(0x3AF8, 0x0000),
+	KD_SENSOR_REG16(0x3AFA, 0x0000),
+	KD_SENSOR_REG16(0x3AFC, 0x0000),
+	KD_SENSOR_REG16(0x3AFE, 0x0000),
+	KD_SENSOR_REG16(0x3B00, 0x0000),
+	KD_SENSOR_REG16(0x3B02, 0x0000),
+	KD_SENSOR_REG16(0x3B04, 0x0000),
+	KD_SENSOR_REG16(0x3B06, 0x0000),
+	KD_SENSOR_REG16(0x3B08, 0x0000),
+	KD_SENSOR_REG16(0x3B0A, 0x0000),
+	KD_SENSOR_REG16(0x3B0C, 0x0000),
+	KD_SENSOR_REG16(0x3B0E, 0x0000),
+	KD_SENSOR_REG16(0x3B10, 0x0000),
+	KD_SENSOR_REG16(0x3B12, 0x0000),
+	KD_SENSOR_REG16(0x3B14, 0x0000),
+	KD_SENSOR_REG16(0x3B16, 0x0000),
+	KD_SENSOR_REG16(0x3B18, 0x0000),
+	KD_SENSOR_REG16(0x3B1A, 0x0000),
+	KD_SENSOR_REG16(0x3B1C, 0x0000),
+	KD_SENSOR_REG16(0x3B1E, 0x0000),
+	KD_SENSOR_REG16(0x3B20, 0x0000),
+	KD_SENSOR_REG16(0x3B22, 0x0000),
+	KD_SENSOR_REG16(0x3B24, 0x0000),
+	KD_SENSOR_REG16(0x3B26, 0x0000),
+	KD_SENSOR_REG16(0x3B28, 0x0000),
+	KD_SENSOR_REG16(0x3B2A, 0x0000),
+	KD_SENSOR_REG16(0x3B2C, 0x0000),
+	KD_SENSOR_REG16(0x3B2E, 0x0000),
+	KD_SENSOR_REG16(0x3B30, 0x0000),
+	KD_SENSOR_REG16(0x3B32, 0x0000),
+	KD_SENSOR_REG16(0x3B34, 0x0000),
+	KD_SENSOR_REG16(0x3B36, 0x0000),
+	KD_SENSOR_REG16(0x3B38, 0x0000),
+	KD_SENSOR_REG16(0x3B3A, 0x0000),
+	KD_SENSOR_REG16(0x3B3C, 0x0000),
+	KD_SENSOR_REG16(0x3B3E, 0x0000),
+	KD_SENSOR_REG16(0x3B40, 0x0000),
+	KD_SENSOR_REG16(0x3B42, 0x0000),
+	KD_SENSOR_REG16(0x3B44, 0x0000),
+	KD_SENSOR_REG16(0x3B46, 0x0000),
+	KD_SENSOR_REG16(0x3B48, 0x0000),
+	KD_SENSOR_REG16(0x3B4A, 0x0000),
+	KD_SENSOR_REG16(0x3B4C, 0x0000),
+	KD_SENSOR_REG16(0x3B4E, 0x0000),
+	KD_SENSOR_REG16(0x3B50, 0x0000),
+	KD_SENSOR_REG16(0x3B52, 0x0000),
+	KD_SENSOR_REG16(0x3B54, 0x0000),
+	KD_SENSOR_REG16(0x3B56, 0x0000),
+	KD_SENSOR_REG16(0x3B58, 0x0000),
+	KD_SENSOR_REG16(0x3B5A, 0x0000),
+	KD_SENSOR_REG16(0x3B5C, 0x0000),
+	KD_SENSOR_REG16(0x3B5E, 0x0000),
+	KD_SENSOR_REG16(0x3B60, 0x0000),
+	KD_SENSOR_REG16(0x3B62, 0x0000),
+	KD_SENSOR_REG16(0x3B64, 0x0000),
+	KD_SENSOR_REG16(0x3B66, 0x0000),
+	KD_SENSOR_REG16(0x3B68, 0x0000),
+	KD_SENSOR_REG16(0x3B6A, 0x0000),
+	KD_SENSOR_REG16(0x3B6C, 0x0000),
+	KD_SENSOR_REG16(0x3B6E, 0x0000),
+	KD_SENSOR_REG16(0x3B70, 0x0000),
+	KD_SENSOR_REG16(0x3B72, 0x0000),
+	KD_SENSOR_REG16(0x3B74, 0x0000),
+	KD_SENSOR_REG16(0x3B76, 0x0000),
+	KD_SENSOR_REG16(0x3B78, 0x0000),
+	KD_SENSOR_REG16(0x3B7A, 0x0000),
+	KD_SENSOR_REG16(0x3B7C, 0x0000),
+	KD_SENSOR_REG16(0x3B7E, 0x0000),
+	KD_SENSOR_REG16(0x3B80, 0x0000),
+	KD_SENSOR_REG16(0x3B82, 0x0000),
+	KD_SENSOR_REG16(0x3B84, 0x0000),
+	KD_SENSOR_REG16(0x3B86, 0x0000),
+	KD_SENSOR_REG16(0x3B88, 0x0000),
+	KD_SENSOR_REG16(0x3B8A, 0x0000),
+	KD_SENSOR_REG16(0x3B8C, 0x0000),
+	KD_SENSOR_REG16(0x3B8E, 0x0000),
+	KD_SENSOR_REG16(0x3B90, 0x0000),
+	KD_SENSOR_REG16(0x3B92, 0x0000),
+	KD_SENSOR_REG16(0x3B94, 0x0000),
+	KD_SENSOR_REG16(0x3B96, 0x0000),
+	KD_SENSOR_REG16(0x3B98, 0x0000),
+	KD_SENSOR_REG16(0x3B9A, 0x0000),
+	KD_SENSOR_REG16(0x3B9C, 0x0000),
+	KD_SENSOR_REG16(0x3B9E, 0x0000),
+	KD_SENSOR_REG16(0x3BA0, 0x0000),
+	KD_SENSOR_REG16(0x3BA2, 0x0000),
+	KD_SENSOR_REG16(0x3BA4, 0x0000),
+	KD_SENSOR_REG16(0x3BA6, 0x0000),
+	KD_SENSOR_REG16(0x3BA8, 0x0000),
+	KD_SENSOR_REG16(0x3BAA, 0x0000),
+	KD_SENSOR_REG16(0x3BAC, 0x0000),
+	KD_SENSOR_REG16(0x3BAE, 0x0000),
+	KD_SENSOR_REG16(0x3BB0, 0x0000),
+	KD_SENSOR_REG16(0x3BB2, 0x0000),
+	KD_SENSOR_REG16(0x3BB4, 0x0000),
+	KD_SENSOR_REG16(0x3BB6, 0x0000),
+	KD_SENSOR_REG16(0x3BB8, 0x0000),
+	KD_SENSOR_REG16(0x3BBA, 0x0000),
+	KD_SENSOR_REG16(0x3BBC, 0x0000),
+	KD_SENSOR_REG16(0x3BBE, 0x0000),
+	KD_SENSOR_REG16(0x3BC0, 0x0000),
+	KD_SENSOR_REG16(0x3BC2, 0x0000),
+	KD_SENSOR_REG16(0x3BC4, 0x0000),
+	KD_SENSOR_REG16(0x3BC6, 0x0000),
+	KD_SENSOR_REG16(0x3BC8, 0x0000),
+	KD_SENSOR_REG16(0x3BCA, 0x0000),
+	KD_SENSOR_REG16(0x3BCC, 0x0000),
+	KD_SENSOR_REG16(0x3BCE, 0x0000),
+	KD_SENSOR_REG16(0x3BD0, 0x0000),
+	KD_SENSOR_REG16(0x3BD2, 0x0000),
+	KD_SENSOR_REG16(0x3BD4, 0x0000),
+	KD_SENSOR_REG16(0x3BD6, 0x0000),
+	KD_SENSOR_REG16(0x3BD8, 0x0000),
+	KD_SENSOR_REG16(0x3BDA, 0x0000),
+	KD_SENSOR_REG16(0x3BDC, 0x0000),
+	KD_SENSOR_REG16(0x3BDE, 0x0000),
+	KD_SENSOR_REG16(0x3BE0, 0x0000),
+	KD_SENSOR_REG16(0x3BE2, 0x0000),
+	KD_SENSOR_REG16(0x3BE4, 0x0000),
+	KD_SENSOR_REG16(0x3BE6, 0x0000),
+	KD_SENSOR_REG16(0x3BE8, 0x0000),
+	KD_SENSOR_REG16(0x3BEA, 0x0000),
+	KD_SENSOR_REG16(0x3BEC, 0x0000),
+	KD_SENSOR_REG16(0x3BEE, 0x0000),
+	KD_SENSOR_REG16(0x3BF0, 0x0000),
+	KD_SENSOR_REG16(0x3BF2, 0x0000),
+	KD_SENSOR_REG16(0x3BF4, 0x0000),
+	KD_SENSOR_REG16(0x3BF6, 0x0000),
+	KD_SENSOR_REG16(0x3BF8, 0x0000),
+	KD_SENSOR_REG16(0x3BFA, 0x0000),
+	KD_SENSOR_REG16(0x3BFC, 0x0000),
+	KD_SENSOR_REG16(0x3BFE, 0x0000),
+	KD_SENSOR_REG16(0x3C00, 0x0000),
+	KD_SENSOR_REG16(0x3C02, 0x0000),
+	KD_SENSOR_REG16(0x3C04, 0x0000),
+	KD_SENSOR_REG16(0x3C06, 0x0000),
+	KD_SENSOR_REG16(0x3C08, 0x0000),
+	KD_SENSOR_REG16(0x3C0A, 0x0000),
+	KD_SENSOR_REG16(0x3C0C, 0x0000),
+	KD_SENSOR_REG16(0x3C0E, 0x0000),
+	KD_SENSOR_REG16(0x3C10, 0x0000),
+	KD_SENSOR_REG16(0x3C12, 0x0000),
+	KD_SENSOR_REG16(0x3C14, 0x0000),
+	KD_SENSOR_REG16(0x3C16, 0x0000),
+	KD_SENSOR_REG16(0x3C18, 0x0000),
+	KD_SENSOR_REG16(0x3C1A, 0x0000),
+	KD_SENSOR_REG16(0x3C1C, 0x0000),
+	KD_SENSOR_REG16(0x3C1E, 0x0000),
+	KD_SENSOR_REG16(0x3C20, 0x0000),
+	KD_SENSOR_REG16(0x3C22, 0x0000),
+	KD_SENSOR_REG16(0x3C24, 0x0000),
+	KD_SENSOR_REG16(0x3C26, 0x0000),
+	KD_SENSOR_REG16(0x3C28, 0x0000),
+	KD_SENSOR_REG16(0x3C2A, 0x0000),
+	KD_SENSOR_REG16(0x3C2C, 0x0000),
+	KD_SENSOR_REG16(0x3C2E, 0x0000),
+	KD_SENSOR_REG16(0x3C30, 0x0000),
+	KD_SENSOR_REG16(0x3C32, 0x0000),
+	KD_SENSOR_REG16(0x3C34, 0x0000),
+	KD_SENSOR_REG16(0x3C36, 0x0000),
+	KD_SENSOR_REG16(0x3C38, 0x0000),
+	KD_SENSOR_REG16(0x3C3A, 0x0000),
+	KD_SENSOR_REG16(0x3C3C, 0x0000),
+	KD_SENSOR_REG16(0x3C3E, 0x0000),
+	KD_SENSOR_REG16(0x3C40, 0x0000),
+	KD_SENSOR_REG16(0x3C42, 0x0000),
+	KD_SENSOR_REG16(0x3C44, 0x0000),
+	KD_SENSOR_REG16(0x3C46, 0x0000),
+	KD_SENSOR_REG16(0x3C48, 0x0000),
+	KD_SENSOR_REG16(0x3C4A, 0x0000),
+	KD_SENSOR_REG16(0x3C4C, 0x0000),
+	KD_SENSOR_REG16(0x3C4E, 0x0000),
+	KD_SENSOR_REG16(0x3C50, 0x0000),
+	KD_SENSOR_REG16(0x3C52, 0x0000),
+	KD_SENSOR_REG16(0x3C54, 0x0000),
+	KD_SENSOR_REG16(0x3C56, 0x0000),
+	KD_SENSOR_REG16(0x3C58, 0x0000),
+	KD_SENSOR_REG16(0x3C5A, 0x0000),
+	KD_SENSOR_REG16(0x3C5C, 0x0000),
+	KD_SENSOR_REG16(0x3C5E, 0x0000),
+	KD_SENSOR_REG16(0x3C60, 0x0000),
+	KD_SENSOR_REG16(0x3C62, 0x0000),
+	KD_SENSOR_REG16(0x3C64, 0x0000),
+	KD_SENSOR_REG16(0x3C66, 0x0000),
+	KD_SENSOR_REG16(0x3C68, 0x0000),
+	KD_SENSOR_REG16(0x3C6A, 0x0000),
+	KD_SENSOR_REG16(0x3C6C, 0x0000),
+	KD_SENSOR_REG16(0x3C6E, 0x0000),
+	KD_SENSOR_REG16(0x3C70, 0x0000),
+	KD_SENSOR_REG16(0x3C72, 0x0000),
+	KD_SENSOR_REG16(0x3C74, 0x0000),
+	KD_SENSOR_REG16(0x3C76, 0x0000),
+	KD_SENSOR_REG16(0x3C78, 0x0000),
+	KD_SENSOR_REG16(0x3C7A, 0x0000),
+	KD_SENSOR_REG16(0x3C7C, 0x0000),
+	KD_SENSOR_REG16(0x3C7E, 0x0000),
+	KD_SENSOR_REG16(0x3C80, 0x0000),
+	KD_SENSOR_REG16(0x3C82, 0x0000),
+	KD_SENSOR_REG16(0x3C84, 0x0000),
+	KD_SENSOR_REG16(0x3C86, 0x0000),
+	KD_SENSOR_REG16(0x3C88, 0x0000),
+	KD_SENSOR_REG16(0x3C8A, 0x0000),
+	KD_SENSOR_REG16(0x3C8C, 0x0000),
+	KD_SENSOR_REG16(0x3C8E, 0x0000),
+	KD_SENSOR_REG16(0x3C90, 0x0000),
+	KD_SENSOR_REG16(0x3C92, 0x0000),
+	KD_SENSOR_REG16(0x3C94, 0x0000),
+	KD_SENSOR_REG16(0x3C96, 0x0000),
+	KD_SENSOR_REG16(0x3C98, 0x0000),
+	KD_SENSOR_REG16(0x3C9A, 0x0000),
+	KD_SENSOR_REG16(0x3C9C, 0x0000),
+	KD_SENSOR_REG16(0x3C9E, 0x0000),
+	KD_SENSOR_REG16(0x3CA0, 0x0000),
+	KD_SENSOR_REG16(0x3CA2, 0x0000),
+	KD_SENSOR_REG16(0x3CA4, 0x0000),
+	KD_SENSOR_REG16(0x3CA6, 0x0000),
+	KD_SENSOR_REG16(0x3CA8, 0x0000),
+	KD_SENSOR_REG16(0x3CAA, 0x0000),
+	KD_SENSOR_REG16(0x3CAC, 0x0000),
+	KD_SENSOR_REG16(0x3CAE, 0x0000),
+	KD_SENSOR_REG16(0x3CB0, 0x0000),
+	KD_SENSOR_REG16(0x3CB2, 0x0000),
+	KD_SENSOR_REG16(0x3CB4, 0x0000),
+	KD_SENSOR_REG16(0x3CB6, 0x0000),
+	KD_SENSOR_REG16(0x3CB8, 0x0000),
+	KD_SENSOR_REG16(0x3CBA, 0x0000),
+	KD_SENSOR_REG16(0x3CBC, 0x0000),
+	KD_SENSOR_REG16(0x3CBE, 0x0000),
+	KD_SENSOR_REG16(0x3CC0, 0x0000),
+	KD_SENSOR_REG16(0x3CC2, 0x0000),
+	KD_SENSOR_REG16(0x3CC4, 0x0000),
+	KD_SENSOR_REG16(0x3CC6, 0x0000),
+	KD_SENSOR_REG16(0x3CC8, 0x0000),
+	KD_SENSOR_REG16(0x3CCA, 0x0000),
+	KD_SENSOR_REG16(0x3CCC, 0x0000),
+	KD_SENSOR_REG16(0x3CCE, 0x0000),
+	KD_SENSOR_REG16(0x3CD0, 0x0000),
+	KD_SENSOR_REG16(0x3CD2, 0x0000),
+	KD_SENSOR_REG16(0x3CD4, 0x0000),
+	KD_SENSOR_REG16(0x3CD6, 0x0000),
+	KD_SENSOR_REG16(0x3CD8, 0x0000),
+	KD_SENSOR_REG16(0x3CDA, 0x0000),
+	KD_SENSOR_REG16(0x3CDC, 0x0000),
+	KD_SENSOR_REG16(0x3CDE, 0x0000),
+	KD_SENSOR_REG16(0x3CE0, 0x0000),
+	KD_SENSOR_REG16(0x3CE2, 0x0000),
+	KD_SENSOR_REG16(0x3CE4, 0x0000),
+	KD_SENSOR_REG16(0x3CE6, 0x0000),
+	KD_SENSOR_REG16(0x3CE8, 0x0000),
+	KD_SENSOR_REG16(0x3CEA, 0x0000),
+	KD_SENSOR_REG16(0x3CEC, 0x0000),
+	KD_SENSOR_REG16(0x3CEE, 0x0000),
+	KD_SENSOR_REG16(0x3CF0, 0x0000),
+	KD_SENSOR_REG16(0x3CF2, 0x0000),
+	KD_SENSOR_REG16(0x3DD4, 0x2000),
+	KD_SENSOR_REG16(0x3DD6, 0x2000),
+	KD_SENSOR_REG16(0x3DDC, 0x2000), //
+	KD_SENSOR_REG16(0x3DDE, 0x2000), //
+	KD_SENSOR_REG16(0x3DF4, 0x2000), //
+	KD_SENSOR_REG16(0x3DF6, 0x2000), //
+	KD_SENSOR_REG16(0x3DFC, 0x2000), //
+	KD_SENSOR_REG16(0x3DFE, 0x2000), //
+	KD_SENSOR_REG16(0x3E14, 0x2000), //
+	KD_SENSOR_REG16(0x3E16, 0x2000), //
+	KD_SENSOR_REG16(0x3E1C, 0x2000), //
+	KD_SENSOR_REG16(0x3E1E, 0x2000), //
+	KD_SENSOR_REG16(0x3E76, 0x0A04),
+	KD_SENSOR_REG16(0x6226, 0x0001), //Open clock to access ELG memory
+	KD_SENSOR_REG16(0x70B6, 0x0001), //Disable ELG
+	KD_SENSOR_REG16(0x3050, 0x0002),
+	KD_SENSOR_REG16(0x3068, 0x0000),
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x1410),
+	KD_SENSOR_REG16(0x6F12, 0x0000),
+	KD_SENSOR_REG16(0x602A, 0x1416),
+	KD_SENSOR_REG16(0x6F12, 0x0108),
+	KD_SENSOR_REG16(0x6F12, 0x0108),
+	KD_SENSOR_REG16(0x6F12, 0x0A08),
+	KD_SENSOR_REG16(0x602A, 0x141A), //modify address from 141B to 141A
+	KD_SENSOR_REG16(0x6F12, 0x0A08),
+	//S6F120203 : delete this register
+	KD_SENSOR_REG16(0x6F12, 0x0202),
+	KD_SENSOR_REG16(0x6F12, 0x0603),
+	//S6F120603 : delete this register
+
+	KD_SENSOR_REG16(0x602A, 0x1412),
+	KD_SENSOR_REG16(0x6F12, 0x0100),
+	KD_SENSOR_REG16(0x3E9E, 0x0011),
+	KD_SENSOR_REG16(0x3EA2, 0x0033),
+	//BPC
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x1748),
+	KD_SENSOR_REG16(0x6F12, 0x0101),
+	KD_SENSOR_REG16(0x0B04, 0x0101),
+	KD_SENSOR_REG16(0x306E, 0x039C), //smiaRegs_vendor_bpc_otp_clusters_address
+	KD_SENSOR_REG16(0x3072, 0x00FF), //smiaRegs_vendor_bpc_max_clusters_in_otp
+	KD_SENSOR_REG16(0x30C4, 0x0001), //smiaRegs_vendor_tnp_use_dgains_for_ladlc_enable
+	KD_SENSOR_REG16(0x30C6, 0x0001), //smiaRegs_vendor_tnp_reset_iir_on_ladlc_on_off
+	KD_SENSOR_REG16(0x3E86, 0x0104),
+	KD_SENSOR_REG16(0x302E, 0x0102),
+	//Immediate abort
+	KD_SENSOR_REG16(0x3028, 0x0000), //smiaRegs_vendor_sensor_abort_timing_method_on_rolling_sh
+	KD_SENSOR_REG16(0x302A, 0x0000), //smiaRegs_vendor_sensor_abort_timing_on_sw_stby
+	KD_SENSOR_REG16(0x3A70, 0x0000),
+	KD_SENSOR_REG16(0x3A72, 0x0000),
+	KD_SENSOR_REG16(0x3A74, 0x0000),
+	KD_SENSOR_REG16(0x3A76, 0x0000),
+	KD_SENSOR_REG16(0x3A78, 0x0000),
+	KD_SENSOR_REG16(0x3A7A, 0x0000),
+	KD_SENSOR_REG16(0x3A7C, 0x0000),
+	KD_SENSOR_REG16(0x3A7E, 0x0000),
+	KD_SENSOR_REG16(0x3A80, 0x0000),
+	KD_SENSOR_REG16(0x3A82, 0x0000),
+	KD_SENSOR_REG16(0x3A84, 0x0000),
+	KD_SENSOR_REG16(0x3A86, 0x0000),
+	KD_SENSOR_REG16(0x3A88, 0x0000),
+	KD_SENSOR_REG16(0x3A8A, 0x0000),
+	KD_SENSOR_REG16(0x3A8C, 0x0000),
+	KD_SENSOR_REG16(0x3A8E, 0x0000),
+	KD_SENSOR_REG16(0x3AB2, 0x0000),
+	KD_SENSOR_REG16(0x3AB4, 0x0000),
+	KD_SENSOR_REG16(0x3AB6, 0x0000),
+	KD_SENSOR_REG16(0x3AB8, 0x0000),
+	KD_SENSOR_REG16(0x3ABA, 0x0000),
+	KD_SENSOR_REG16(0x3ABC, 0x0000),
+	KD_SENSOR_REG16(0x3ABE, 0x0000),
+	KD_SENSOR_REG16(0x3AC0, 0x0000),
+	KD_SENSOR_REG16(0x3AC2, 0x0000),
+	KD_SENSOR_REG16(0x3AC4, 0x0000),
+	KD_SENSOR_REG16(0x3AC6, 0x0000),
+	KD_SENSOR_REG16(0x3AC8, 0x0000),
+	KD_SENSOR_REG16(0x3ACA, 0x0000),
+	KD_SENSOR_REG16(0x3ACC, 0x0000),
+	KD_SENSOR_REG16(0x3ACE, 0x0000),
+	KD_SENSOR_REG8(0x0114, 0x03),
+};
+
+static void sensor_init_done(void *priv, int err)
+{
+	if (err)
+		LOGE("init setting failed, err %d\n", err);
+}
+
 static void sensor_init(void)
 {
 	LOG_INF("E\n");
@@ -609,814 +1430,87 @@ static void sensor_init(void)
 	*/
 
 
-   write_cmos_sensor(0x6010,0x0001);	  //Reset
-   mdelay(3);
-   write_cmos_sensor(0x6214,0x7970);	  //open all clocks
-   write_cmos_sensor(0x6218,0x7150);	  //open all clocks
-   write_cmos_sensor(0x6028,0x2000);
-   write_cmos_sensor(0x602A,0x2E00);
-   write_cmos_sensor(0x6F12,0x0448);
-   write_cmos_sensor(0x6F12,0x0349);
-   write_cmos_sensor(0x6F12,0x0160);
-   write_cmos_sensor(0x6F12,0xC26A);
-   write_cmos_sensor(0x6F12,0x511A);
-   write_cmos_sensor(0x6F12,0x8180);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x10B9);
-   write_cmos_sensor(0x6F12,0x2000);
-   write_cmos_sensor(0x6F12,0x315C);
-   write_cmos_sensor(0x6F12,0x2000);
-   write_cmos_sensor(0x6F12,0x1AE0);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x2DE9);
-   write_cmos_sensor(0x6F12,0xF041);
-   write_cmos_sensor(0x6F12,0x0646);
-   write_cmos_sensor(0x6F12,0x9A48);
-   write_cmos_sensor(0x6F12,0x0F46);
-   write_cmos_sensor(0x6F12,0x9046);
-   write_cmos_sensor(0x6F12,0x4068);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0x85B2);
-   write_cmos_sensor(0x6F12,0x040C);
-   write_cmos_sensor(0x6F12,0x2946);
-   write_cmos_sensor(0x6F12,0x2046);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x4CF9);
-   write_cmos_sensor(0x6F12,0x4246);
-   write_cmos_sensor(0x6F12,0x3946);
-   write_cmos_sensor(0x6F12,0x3046);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x4CF9);
-   write_cmos_sensor(0x6F12,0x9348);
-   write_cmos_sensor(0x6F12,0x807E);
-   write_cmos_sensor(0x6F12,0x28B1);
-   write_cmos_sensor(0x6F12,0x9248);
-   write_cmos_sensor(0x6F12,0x90F8);
-   write_cmos_sensor(0x6F12,0xFA00);
-   write_cmos_sensor(0x6F12,0x08B1);
-   write_cmos_sensor(0x6F12,0x0122);
-   write_cmos_sensor(0x6F12,0x00E0);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0x9048);
-   write_cmos_sensor(0x6F12,0x0280);
-   write_cmos_sensor(0x6F12,0x2946);
-   write_cmos_sensor(0x6F12,0x2046);
-   write_cmos_sensor(0x6F12,0xBDE8);
-   write_cmos_sensor(0x6F12,0xF041);
-   write_cmos_sensor(0x6F12,0x0122);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x34B9);
-   write_cmos_sensor(0x6F12,0x8C4A);
-   write_cmos_sensor(0x6F12,0x10B5);
-   write_cmos_sensor(0x6F12,0x1268);
-   write_cmos_sensor(0x6F12,0xB2F8);
-   write_cmos_sensor(0x6F12,0xC230);
-   write_cmos_sensor(0x6F12,0x874A);
-   write_cmos_sensor(0x6F12,0x546B);
-   write_cmos_sensor(0x6F12,0xB2F8);
-   write_cmos_sensor(0x6F12,0x2E21);
-   write_cmos_sensor(0x6F12,0x6409);
-   write_cmos_sensor(0x6F12,0x6343);
-   write_cmos_sensor(0x6F12,0x4FF4);
-   write_cmos_sensor(0x6F12,0x7A74);
-   write_cmos_sensor(0x6F12,0x6243);
-   write_cmos_sensor(0x6F12,0x5209);
-   write_cmos_sensor(0x6F12,0xB3FB);
-   write_cmos_sensor(0x6F12,0xF2F3);
-   write_cmos_sensor(0x6F12,0x021D);
-   write_cmos_sensor(0x6F12,0x8A42);
-   write_cmos_sensor(0x6F12,0x02D2);
-   write_cmos_sensor(0x6F12,0x0A1A);
-   write_cmos_sensor(0x6F12,0x121F);
-   write_cmos_sensor(0x6F12,0x00E0);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0x9A42);
-   write_cmos_sensor(0x6F12,0x00D8);
-   write_cmos_sensor(0x6F12,0x1A46);
-   write_cmos_sensor(0x6F12,0x8048);
-   write_cmos_sensor(0x6F12,0x0280);
-   write_cmos_sensor(0x6F12,0x10BD);
-   write_cmos_sensor(0x6F12,0x2DE9);
-   write_cmos_sensor(0x6F12,0xF34F);
-   write_cmos_sensor(0x6F12,0x0446);
-   write_cmos_sensor(0x6F12,0x7848);
-   write_cmos_sensor(0x6F12,0x83B0);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0xC068);
-   write_cmos_sensor(0x6F12,0x010C);
-   write_cmos_sensor(0x6F12,0x80B2);
-   write_cmos_sensor(0x6F12,0xCDE9);
-   write_cmos_sensor(0x6F12,0x0001);
-   write_cmos_sensor(0x6F12,0x0146);
-   write_cmos_sensor(0x6F12,0x0198);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x07F9);
-   write_cmos_sensor(0x6F12,0xDFF8);
-   write_cmos_sensor(0x6F12,0xE091);
-   write_cmos_sensor(0x6F12,0xDFF8);
-   write_cmos_sensor(0x6F12,0xD4B1);
-   write_cmos_sensor(0x6F12,0x0021);
-   write_cmos_sensor(0x6F12,0x99F8);
-   write_cmos_sensor(0x6F12,0x2A70);
-   write_cmos_sensor(0x6F12,0x89F8);
-   write_cmos_sensor(0x6F12,0x2A10);
-   write_cmos_sensor(0x6F12,0xDFF8);
-   write_cmos_sensor(0x6F12,0xBCA1);
-   write_cmos_sensor(0x6F12,0x734D);
-   write_cmos_sensor(0x6F12,0xDBF8);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x9AF8);
-   write_cmos_sensor(0x6F12,0xFA80);
-   write_cmos_sensor(0x6F12,0xAE8A);
-   write_cmos_sensor(0x6F12,0xB0F8);
-   write_cmos_sensor(0x6F12,0xC400);
-   write_cmos_sensor(0x6F12,0x20B1);
-   write_cmos_sensor(0x6F12,0xA08A);
-   write_cmos_sensor(0x6F12,0x296E);
-   write_cmos_sensor(0x6F12,0x4843);
-   write_cmos_sensor(0x6F12,0x000B);
-   write_cmos_sensor(0x6F12,0xA882);
-   write_cmos_sensor(0x6F12,0x2046);
-   write_cmos_sensor(0x6F12,0x0499);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0xF4F8);
-   write_cmos_sensor(0x6F12,0xAE82);
-   write_cmos_sensor(0x6F12,0xB9F8);
-   write_cmos_sensor(0x6F12,0x1C00);
-   write_cmos_sensor(0x6F12,0x9AF8);
-   write_cmos_sensor(0x6F12,0xFA50);
-   write_cmos_sensor(0x6F12,0xC0F3);
-   write_cmos_sensor(0x6F12,0x0030);
-   write_cmos_sensor(0x6F12,0x4545);
-   write_cmos_sensor(0x6F12,0x08D0);
-   write_cmos_sensor(0x6F12,0x38B1);
-   write_cmos_sensor(0x6F12,0xDBF8);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0xB0F8);
-   write_cmos_sensor(0x6F12,0xC600);
-   write_cmos_sensor(0x6F12,0x10B1);
-   write_cmos_sensor(0x6F12,0x0020);
-   write_cmos_sensor(0x6F12,0xCAF8);
-   write_cmos_sensor(0x6F12,0x0001);
-   write_cmos_sensor(0x6F12,0x17F0);
-   write_cmos_sensor(0x6F12,0xFF00);
-   write_cmos_sensor(0x6F12,0x89F8);
-   write_cmos_sensor(0x6F12,0x2A00);
-   write_cmos_sensor(0x6F12,0x03D0);
-   write_cmos_sensor(0x6F12,0xA18A);
-   write_cmos_sensor(0x6F12,0x2068);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0xDEF8);
-   write_cmos_sensor(0x6F12,0xDDE9);
-   write_cmos_sensor(0x6F12,0x0010);
-   write_cmos_sensor(0x6F12,0x05B0);
-   write_cmos_sensor(0x6F12,0x0122);
-   write_cmos_sensor(0x6F12,0xBDE8);
-   write_cmos_sensor(0x6F12,0xF04F);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0xC7B8);
-   write_cmos_sensor(0x6F12,0x70B5);
-   write_cmos_sensor(0x6F12,0x0446);
-   write_cmos_sensor(0x6F12,0x5148);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0x0169);
-   write_cmos_sensor(0x6F12,0x0D0C);
-   write_cmos_sensor(0x6F12,0x8EB2);
-   write_cmos_sensor(0x6F12,0x3146);
-   write_cmos_sensor(0x6F12,0x2846);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0xBCF8);
-   write_cmos_sensor(0x6F12,0x2046);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0xCDF8);
-   write_cmos_sensor(0x6F12,0x94F8);
-   write_cmos_sensor(0x6F12,0x6000);
-   write_cmos_sensor(0x6F12,0x0128);
-   write_cmos_sensor(0x6F12,0x07D1);
-   write_cmos_sensor(0x6F12,0x5148);
-   write_cmos_sensor(0x6F12,0x0068);
-   write_cmos_sensor(0x6F12,0x8078);
-   write_cmos_sensor(0x6F12,0xF528);
-   write_cmos_sensor(0x6F12,0x02D0);
-   write_cmos_sensor(0x6F12,0x0020);
-   write_cmos_sensor(0x6F12,0x84F8);
-   write_cmos_sensor(0x6F12,0x6000);
-   write_cmos_sensor(0x6F12,0x3146);
-   write_cmos_sensor(0x6F12,0x2846);
-   write_cmos_sensor(0x6F12,0xBDE8);
-   write_cmos_sensor(0x6F12,0x7040);
-   write_cmos_sensor(0x6F12,0x0122);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0xA6B8);
-   write_cmos_sensor(0x6F12,0x70B5);
-   write_cmos_sensor(0x6F12,0x0446);
-   write_cmos_sensor(0x6F12,0x4048);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0x4069);
-   write_cmos_sensor(0x6F12,0x86B2);
-   write_cmos_sensor(0x6F12,0x050C);
-   write_cmos_sensor(0x6F12,0x3146);
-   write_cmos_sensor(0x6F12,0x2846);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x9BF8);
-   write_cmos_sensor(0x6F12,0x2046);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0xB1F8);
-   write_cmos_sensor(0x6F12,0x207C);
-   write_cmos_sensor(0x6F12,0x40B1);
-   write_cmos_sensor(0x6F12,0x424A);
-   write_cmos_sensor(0x6F12,0xA168);
-   write_cmos_sensor(0x6F12,0x2068);
-   write_cmos_sensor(0x6F12,0x92F8);
-   write_cmos_sensor(0x6F12,0xB921);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0xADF8);
-   write_cmos_sensor(0x6F12,0x4049);
-   write_cmos_sensor(0x6F12,0x0880);
-   write_cmos_sensor(0x6F12,0x3146);
-   write_cmos_sensor(0x6F12,0x2846);
-   write_cmos_sensor(0x6F12,0xBDE8);
-   write_cmos_sensor(0x6F12,0x7040);
-   write_cmos_sensor(0x6F12,0x0122);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x86B8);
-   write_cmos_sensor(0x6F12,0x2DE9);
-   write_cmos_sensor(0x6F12,0xF041);
-   write_cmos_sensor(0x6F12,0x304C);
-   write_cmos_sensor(0x6F12,0x8046);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0xA069);
-   write_cmos_sensor(0x6F12,0x87B2);
-   write_cmos_sensor(0x6F12,0x060C);
-   write_cmos_sensor(0x6F12,0x3946);
-   write_cmos_sensor(0x6F12,0x3046);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x7AF8);
-   write_cmos_sensor(0x6F12,0x2F4D);
-   write_cmos_sensor(0x6F12,0xB8F1);
-   write_cmos_sensor(0x6F12,0x000F);
-   write_cmos_sensor(0x6F12,0x0BD1);
-   write_cmos_sensor(0x6F12,0x3248);
-   write_cmos_sensor(0x6F12,0x0078);
-   write_cmos_sensor(0x6F12,0x40B1);
-   write_cmos_sensor(0x6F12,0x2868);
-   write_cmos_sensor(0x6F12,0xB0F8);
-   write_cmos_sensor(0x6F12,0x6A00);
-   write_cmos_sensor(0x6F12,0x20B1);
-   write_cmos_sensor(0x6F12,0x2188);
-   write_cmos_sensor(0x6F12,0x8842);
-   write_cmos_sensor(0x6F12,0x01D0);
-   write_cmos_sensor(0x6F12,0x0120);
-   write_cmos_sensor(0x6F12,0x00E0);
-   write_cmos_sensor(0x6F12,0x0020);
-   write_cmos_sensor(0x6F12,0x38B1);
-   write_cmos_sensor(0x6F12,0x2449);
-   write_cmos_sensor(0x6F12,0x0020);
-   write_cmos_sensor(0x6F12,0xC1F8);
-   write_cmos_sensor(0x6F12,0xDC01);
-   write_cmos_sensor(0x6F12,0x81F8);
-   write_cmos_sensor(0x6F12,0xCC01);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x83F8);
-   write_cmos_sensor(0x6F12,0x2868);
-   write_cmos_sensor(0x6F12,0xB0F8);
-   write_cmos_sensor(0x6F12,0x6A00);
-   write_cmos_sensor(0x6F12,0x2080);
-   write_cmos_sensor(0x6F12,0x4046);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x81F8);
-   write_cmos_sensor(0x6F12,0x3946);
-   write_cmos_sensor(0x6F12,0x3046);
-   write_cmos_sensor(0x6F12,0xBDE8);
-   write_cmos_sensor(0x6F12,0xF041);
-   write_cmos_sensor(0x6F12,0x0122);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x52B8);
-   write_cmos_sensor(0x6F12,0x10B5);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0xAFF2);
-   write_cmos_sensor(0x6F12,0x1721);
-   write_cmos_sensor(0x6F12,0x2048);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x78F8);
-   write_cmos_sensor(0x6F12,0x144C);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0xAFF2);
-   write_cmos_sensor(0x6F12,0xD711);
-   write_cmos_sensor(0x6F12,0x6060);
-   write_cmos_sensor(0x6F12,0x1D48);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x70F8);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0xAFF2);
-   write_cmos_sensor(0x6F12,0x0D11);
-   write_cmos_sensor(0x6F12,0xA060);
-   write_cmos_sensor(0x6F12,0x1B48);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x69F8);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0xAFF2);
-   write_cmos_sensor(0x6F12,0xB711);
-   write_cmos_sensor(0x6F12,0x2061);
-   write_cmos_sensor(0x6F12,0x1848);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x62F8);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0xAFF2);
-   write_cmos_sensor(0x6F12,0xE701);
-   write_cmos_sensor(0x6F12,0xE060);
-   write_cmos_sensor(0x6F12,0x1648);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x5BF8);
-   write_cmos_sensor(0x6F12,0x0022);
-   write_cmos_sensor(0x6F12,0xAFF2);
-   write_cmos_sensor(0x6F12,0xB301);
-   write_cmos_sensor(0x6F12,0x6061);
-   write_cmos_sensor(0x6F12,0x1348);
-   write_cmos_sensor(0x6F12,0x00F0);
-   write_cmos_sensor(0x6F12,0x54F8);
-   write_cmos_sensor(0x6F12,0xA061);
-   write_cmos_sensor(0x6F12,0x0020);
-   write_cmos_sensor(0x6F12,0x2080);
-   write_cmos_sensor(0x6F12,0x10BD);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x2000);
-   write_cmos_sensor(0x6F12,0x3140);
-   write_cmos_sensor(0x6F12,0x2000);
-   write_cmos_sensor(0x6F12,0x1B10);
-   write_cmos_sensor(0x6F12,0x2000);
-   write_cmos_sensor(0x6F12,0x2530);
-   write_cmos_sensor(0x6F12,0x4000);
-   write_cmos_sensor(0x6F12,0x9802);
-   write_cmos_sensor(0x6F12,0x2000);
-   write_cmos_sensor(0x6F12,0x0550);
-   write_cmos_sensor(0x6F12,0x4000);
-   write_cmos_sensor(0x6F12,0xF000);
-   write_cmos_sensor(0x6F12,0x2000);
-   write_cmos_sensor(0x6F12,0x1300);
-   write_cmos_sensor(0x6F12,0x2000);
-   write_cmos_sensor(0x6F12,0x2890);
-   write_cmos_sensor(0x6F12,0x2000);
-   write_cmos_sensor(0x6F12,0x02C0);
-   write_cmos_sensor(0x6F12,0x2000);
-   write_cmos_sensor(0x6F12,0x1410);
-   write_cmos_sensor(0x6F12,0x4000);
-   write_cmos_sensor(0x6F12,0xA358);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x15F7);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x7A4F);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x4A69);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x1349);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x3091);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x6F12,0x6057);
-   write_cmos_sensor(0x6F12,0x40F2);
-   write_cmos_sensor(0x6F12,0xE96C);
-   write_cmos_sensor(0x6F12,0xC0F2);
-   write_cmos_sensor(0x6F12,0x000C);
-   write_cmos_sensor(0x6F12,0x6047);
-   write_cmos_sensor(0x6F12,0x41F2);
-   write_cmos_sensor(0x6F12,0xF75C);
-   write_cmos_sensor(0x6F12,0xC0F2);
-   write_cmos_sensor(0x6F12,0x000C);
-   write_cmos_sensor(0x6F12,0x6047);
-   write_cmos_sensor(0x6F12,0x41F2);
-   write_cmos_sensor(0x6F12,0x493C);
-   write_cmos_sensor(0x6F12,0xC0F2);
-   write_cmos_sensor(0x6F12,0x000C);
-   write_cmos_sensor(0x6F12,0x6047);
-   write_cmos_sensor(0x6F12,0x41F2);
-   write_cmos_sensor(0x6F12,0x9D1C);
-   write_cmos_sensor(0x6F12,0xC0F2);
-   write_cmos_sensor(0x6F12,0x000C);
-   write_cmos_sensor(0x6F12,0x6047);
-   write_cmos_sensor(0x6F12,0x44F6);
-   write_cmos_sensor(0x6F12,0x692C);
-   write_cmos_sensor(0x6F12,0xC0F2);
-   write_cmos_sensor(0x6F12,0x000C);
-   write_cmos_sensor(0x6F12,0x6047);
-   write_cmos_sensor(0x6F12,0x43F2);
-   write_cmos_sensor(0x6F12,0x910C);
-   write_cmos_sensor(0x6F12,0xC0F2);
-   write_cmos_sensor(0x6F12,0x000C);
-   write_cmos_sensor(0x6F12,0x6047);
-   write_cmos_sensor(0x6F12,0x40F2);
-   write_cmos_sensor(0x6F12,0x156C);
-   write_cmos_sensor(0x6F12,0xC0F2);
-   write_cmos_sensor(0x6F12,0x000C);
-   write_cmos_sensor(0x6F12,0x6047);
-   write_cmos_sensor(0x6F12,0x42F2);
-   write_cmos_sensor(0x6F12,0xC71C);
-   write_cmos_sensor(0x6F12,0xC0F2);
-   write_cmos_sensor(0x6F12,0x000C);
-   write_cmos_sensor(0x6F12,0x6047);
-   write_cmos_sensor(0x6F12,0x46F2);
-   write_cmos_sensor(0x6F12,0x570C);
-   write_cmos_sensor(0x6F12,0xC0F2);
-   write_cmos_sensor(0x6F12,0x000C);
-   write_cmos_sensor(0x6F12,0x6047);
-   write_cmos_sensor(0x6F12,0x4AF6);
-   write_cmos_sensor(0x6F12,0x850C);
-   write_cmos_sensor(0x6F12,0xC0F2);
-   write_cmos_sensor(0x6F12,0x000C);
-   write_cmos_sensor(0x6F12,0x6047);
-   write_cmos_sensor(0x3EA6,0xFFFF);	   //fe_isp_dadlc_analog_gain_thrshold_for_ladlc_low
-   write_cmos_sensor(0x3EA8,0xFFFF);	   //fe_isp_dadlc_analog_gain_thrshold_for_ladlc_high
-   write_cmos_sensor(0x3A56,0x3BB8);	  //Sampling enable
-   write_cmos_sensor(0xF476,0x0040);	  //DBR
-   write_cmos_sensor(0xF40C,0x1180);	  //CLP on, LDB off
-   write_cmos_sensor(0xF480,0x0015);	  //CLP LVL
-   write_cmos_sensor(0x39EE,0x0507);
-   write_cmos_sensor(0x3A06,0x0605);
-   write_cmos_sensor(0x39D0,0x0707);
-   write_cmos_sensor(0xF432,0x0100);	  //DBS
-   write_cmos_sensor(0xF4A6,0x00C0);	  //RDV
-   write_cmos_sensor(0xF42E,0x0060);	  //CDS
-   write_cmos_sensor(0xF49C,0x0000);	  //RMP
-   write_cmos_sensor(0xF496,0x0000);	  //REF
-   write_cmos_sensor(0xF49E,0x005E);	  //ADC_SAT
-   write_cmos_sensor(0xF47A,0x0017);	  //VRD 3.2V
-   write_cmos_sensor(0xF462,0x0000);	  //VPIX 2.92V
-   write_cmos_sensor(0xF460,0x0020);	  //VTG 3.8V
-   write_cmos_sensor(0x3A64,0x0010);
-   write_cmos_sensor(0x3A66,0x0010);
-   write_cmos_sensor(0x3A68,0x0010);
-   write_cmos_sensor(0xF426,0x0007);	  //LAT START
-   write_cmos_sensor(0xF428,0x0004);	  //LAT WIDTH
-   write_cmos_sensor(0xF42A,0x0004);	  //HOLD START
-   write_cmos_sensor(0xF42C,0x0004);	  //HOLD WIDTH
-   write_cmos_sensor(0x32BC,0x000D);	  //pixel boost
-   write_cmos_sensor(0x3298,0x005E);
-   write_cmos_sensor(0x3880,0x010B);
-   write_cmos_sensor(0x3886,0x010A);
-   write_cmos_sensor(0x388C,0x021A);
-   write_cmos_sensor(0x389E,0x021C);
-   write_cmos_sensor(0x38A4,0x0000);
-   write_cmos_sensor(0x38AA,0x015C);
-   write_cmos_sensor(0x38B0,0x015B);
-   write_cmos_sensor(0x38B6,0x021A);
-   write_cmos_sensor(0x38C2,0x0070);
-   write_cmos_sensor(0x38C8,0x021C);
-   write_cmos_sensor(0x38CE,0x0000);
-   write_cmos_sensor(0x3976,0x0006);
-   write_cmos_sensor(0x31C0,0x0C40);	  //default 0004
-   write_cmos_sensor(0x31C2,0x0C48);	  //default 0B1C
-   write_cmos_sensor(0x31B2,0x080C);
-   write_cmos_sensor(0x31B4,0x0401);
-   write_cmos_sensor(0x31B2,0x0804);
-   write_cmos_sensor(0x39D6,0x0F0F);
-   write_cmos_sensor(0x39DC,0x3030);
-   write_cmos_sensor(0x39B0,0x0000);
-   write_cmos_sensor(0x30C2,0x0300);
-   write_cmos_sensor(0x3AF2,0x0000);
-   write_cmos_sensor(0x3AF4,0x0000);
-   write_cmos_sensor(0x3AF6,0x0000);
-   write_cmos_sensor(0x3AF8,0x0000);
-   write_cmos_sensor(0x3AFA,0x0000);
-   write_cmos_sensor(0x3AFC,0x0000);
-   write_cmos_sensor(0x3AFE,0x0000);
-   write_cmos_sensor(0x3B00,0x0000);
-   write_cmos_sensor(0x3B02,0x0000);
-   write_cmos_sensor(0x3B04,0x0000);
-   write_cmos_sensor(0x3B06,0x0000);
-   write_cmos_sensor(0x3B08,0x0000);
-   write_cmos_sensor(0x3B0A,0x0000);
-   write_cmos_sensor(0x3B0C,0x0000);
-   write_cmos_sensor(0x3B0E,0x0000);
-   write_cmos_sensor(0x3B10,0x0000);
-   write_cmos_sensor(0x3B12,0x0000);
-   write_cmos_sensor(0x3B14,0x0000);
-   write_cmos_sensor(0x3B16,0x0000);
-   write_cmos_sensor(0x3B18,0x0000);
-   write_cmos_sensor(0x3B1A,0x0000);
-   write_cmos_sensor(0x3B1C,0x0000);
-   write_cmos_sensor(0x3B1E,0x0000);
-   write_cmos_sensor(0x3B20,0x0000);
-   write_cmos_sensor(0x3B22,0x0000);
-   write_cmos_sensor(0x3B24,0x0000);
-   write_cmos_sensor(0x3B26,0x0000);
-   write_cmos_sensor(0x3B28,0x0000);
-   write_cmos_sensor(0x3B2A,0x0000);
-   write_cmos_sensor(0x3B2C,0x0000);
-   write_cmos_sensor(0x3B2E,0x0000);
-   write_cmos_sensor(0x3B30,0x0000);
-   write_cmos_sensor(0x3B32,0x0000);
-   write_cmos_sensor(0x3B34,0x0000);
-   write_cmos_sensor(0x3B36,0x0000);
-   write_cmos_sensor(0x3B38,0x0000);
-   write_cmos_sensor(0x3B3A,0x0000);
-   write_cmos_sensor(0x3B3C,0x0000);
-   write_cmos_sensor(0x3B3E,0x0000);
-   write_cmos_sensor(0x3B40,0x0000);
-   write_cmos_sensor(0x3B42,0x0000);
-   write_cmos_sensor(0x3B44,0x0000);
-   write_cmos_sensor(0x3B46,0x0000);
-   write_cmos_sensor(0x3B48,0x0000);
-   write_cmos_sensor(0x3B4A,0x0000);
-   write_cmos_sensor(0x3B4C,0x0000);
-   write_cmos_sensor(0x3B4E,0x0000);
-   write_cmos_sensor(0x3B50,0x0000);
-   write_cmos_sensor(0x3B52,0x0000);
-   write_cmos_sensor(0x3B54,0x0000);
-   write_cmos_sensor(0x3B56,0x0000);
-   write_cmos_sensor(0x3B58,0x0000);
-   write_cmos_sensor(0x3B5A,0x0000);
-   write_cmos_sensor(0x3B5C,0x0000);
-   write_cmos_sensor(0x3B5E,0x0000);
-   write_cmos_sensor(0x3B60,0x0000);
-   write_cmos_sensor(0x3B62,0x0000);
-   write_cmos_sensor(0x3B64,0x0000);
-   write_cmos_sensor(0x3B66,0x0000);
-   write_cmos_sensor(0x3B68,0x0000);
-   write_cmos_sensor(0x3B6A,0x0000);
-   write_cmos_sensor(0x3B6C,0x0000);
-   write_cmos_sensor(0x3B6E,0x0000);
-   write_cmos_sensor(0x3B70,0x0000);
-   write_cmos_sensor(0x3B72,0x0000);
-   write_cmos_sensor(0x3B74,0x0000);
-   write_cmos_sensor(0x3B76,0x0000);
-   write_cmos_sensor(0x3B78,0x0000);
-   write_cmos_sensor(0x3B7A,0x0000);
-   write_cmos_sensor(0x3B7C,0x0000);
-   write_cmos_sensor(0x3B7E,0x0000);
-   write_cmos_sensor(0x3B80,0x0000);
-   write_cmos_sensor(0x3B82,0x0000);
-   write_cmos_sensor(0x3B84,0x0000);
-   write_cmos_sensor(0x3B86,0x0000);
-   write_cmos_sensor(0x3B88,0x0000);
-   write_cmos_sensor(0x3B8A,0x0000);
-   write_cmos_sensor(0x3B8C,0x0000);
-   write_cmos_sensor(0x3B8E,0x0000);
-   write_cmos_sensor(0x3B90,0x0000);
-   write_cmos_sensor(0x3B92,0x0000);
-   write_cmos_sensor(0x3B94,0x0000);
-   write_cmos_sensor(0x3B96,0x0000);
-   write_cmos_sensor(0x3B98,0x0000);
-   write_cmos_sensor(0x3B9A,0x0000);
-   write_cmos_sensor(0x3B9C,0x0000);
-   write_cmos_sensor(0x3B9E,0x0000);
-   write_cmos_sensor(0x3BA0,0x0000);
-   write_cmos_sensor(0x3BA2,0x0000);
-   write_cmos_sensor(0x3BA4,0x0000);
-   write_cmos_sensor(0x3BA6,0x0000);
-   write_cmos_sensor(0x3BA8,0x0000);
-   write_cmos_sensor(0x3BAA,0x0000);
-   write_cmos_sensor(0x3BAC,0x0000);
-   write_cmos_sensor(0x3BAE,0x0000);
-   write_cmos_sensor(0x3BB0,0x0000);
-   write_cmos_sensor(0x3BB2,0x0000);
-   write_cmos_sensor(0x3BB4,0x0000);
-   write_cmos_sensor(0x3BB6,0x0000);
-   write_cmos_sensor(0x3BB8,0x0000);
-   write_cmos_sensor(0x3BBA,0x0000);
-   write_cmos_sensor(0x3BBC,0x0000);
-   write_cmos_sensor(0x3BBE,0x0000);
-   write_cmos_sensor(0x3BC0,0x0000);
-   write_cmos_sensor(0x3BC2,0x0000);
-   write_cmos_sensor(0x3BC4,0x0000);
-   write_cmos_sensor(0x3BC6,0x0000);
-   write_cmos_sensor(0x3BC8,0x0000);
-   write_cmos_sensor(0x3BCA,0x0000);
-   write_cmos_sensor(0x3BCC,0x0000);
-   write_cmos_sensor(0x3BCE,0x0000);
-   write_cmos_sensor(0x3BD0,0x0000);
-   write_cmos_sensor(0x3BD2,0x0000);
-   write_cmos_sensor(0x3BD4,0x0000);
-   write_cmos_sensor(0x3BD6,0x0000);
-   write_cmos_sensor(0x3BD8,0x0000);
-   write_cmos_sensor(0x3BDA,0x0000);
-   write_cmos_sensor(0x3BDC,0x0000);
-   write_cmos_sensor(0x3BDE,0x0000);
-   write_cmos_sensor(0x3BE0,0x0000);
-   write_cmos_sensor(0x3BE2,0x0000);
-   write_cmos_sensor(0x3BE4,0x0000);
-   write_cmos_sensor(0x3BE6,0x0000);
-   write_cmos_sensor(0x3BE8,0x0000);
-   write_cmos_sensor(0x3BEA,0x0000);
-   write_cmos_sensor(0x3BEC,0x0000);
-   write_cmos_sensor(0x3BEE,0x0000);
-   write_cmos_sensor(0x3BF0,0x0000);
-   write_cmos_sensor(0x3BF2,0x0000);
-   write_cmos_sensor(0x3BF4,0x0000);
-   write_cmos_sensor(0x3BF6,0x0000);
-   write_cmos_sensor(0x3BF8,0x0000);
-   write_cmos_sensor(0x3BFA,0x0000);
-   write_cmos_sensor(0x3BFC,0x0000);
-   write_cmos_sensor(0x3BFE,0x0000);
-   write_cmos_sensor(0x3C00,0x0000);
-   write_cmos_sensor(0x3C02,0x0000);
-   write_cmos_sensor(0x3C04,0x0000);
-   write_cmos_sensor(0x3C06,0x0000);
-   write_cmos_sensor(0x3C08,0x0000);
-   write_cmos_sensor(0x3C0A,0x0000);
-   write_cmos_sensor(0x3C0C,0x0000);
-   write_cmos_sensor(0x3C0E,0x0000);
-   write_cmos_sensor(0x3C10,0x0000);
-   write_cmos_sensor(0x3C12,0x0000);
-   write_cmos_sensor(0x3C14,0x0000);
-   write_cmos_sensor(0x3C16,0x0000);
-   write_cmos_sensor(0x3C18,0x0000);
-   write_cmos_sensor(0x3C1A,0x0000);
-   write_cmos_sensor(0x3C1C,0x0000);
-   write_cmos_sensor(0x3C1E,0x0000);
-   write_cmos_sensor(0x3C20,0x0000);
-   write_cmos_sensor(0x3C22,0x0000);
-   write_cmos_sensor(0x3C24,0x0000);
-   write_cmos_sensor(0x3C26,0x0000);
-   write_cmos_sensor(0x3C28,0x0000);
-   write_cmos_sensor(0x3C2A,0x0000);
-   write_cmos_sensor(0x3C2C,0x0000);
-   write_cmos_sensor(0x3C2E,0x0000);
-   write_cmos_sensor(0x3C30,0x0000);
-   write_cmos_sensor(0x3C32,0x0000);
-   write_cmos_sensor(0x3C34,0x0000);
-   write_cmos_sensor(0x3C36,0x0000);
-   write_cmos_sensor(0x3C38,0x0000);
-   write_cmos_sensor(0x3C3A,0x0000);
-   write_cmos_sensor(0x3C3C,0x0000);
-   write_cmos_sensor(0x3C3E,0x0000);
-   write_cmos_sensor(0x3C40,0x0000);
-   write_cmos_sensor(0x3C42,0x0000);
-   write_cmos_sensor(0x3C44,0x0000);
-   write_cmos_sensor(0x3C46,0x0000);
-   write_cmos_sensor(0x3C48,0x0000);
-   write_cmos_sensor(0x3C4A,0x0000);
-   write_cmos_sensor(0x3C4C,0x0000);
-   write_cmos_sensor(0x3C4E,0x0000);
-   write_cmos_sensor(0x3C50,0x0000);
-   write_cmos_sensor(0x3C52,0x0000);
-   write_cmos_sensor(0x3C54,0x0000);
-   write_cmos_sensor(0x3C56,0x0000);
-   write_cmos_sensor(0x3C58,0x0000);
-   write_cmos_sensor(0x3C5A,0x0000);
-   write_cmos_sensor(0x3C5C,0x0000);
-   write_cmos_sensor(0x3C5E,0x0000);
-   write_cmos_sensor(0x3C60,0x0000);
-   write_cmos_sensor(0x3C62,0x0000);
-   write_cmos_sensor(0x3C64,0x0000);
-   write_cmos_sensor(0x3C66,0x0000);
-   write_cmos_sensor(0x3C68,0x0000);
-   write_cmos_sensor(0x3C6A,0x0000);
-   write_cmos_sensor(0x3C6C,0x0000);
-   write_cmos_sensor(0x3C6E,0x0000);
-   write_cmos_sensor(0x3C70,0x0000);
-   write_cmos_sensor(0x3C72,0x0000);
-   write_cmos_sensor(0x3C74,0x0000);
-   write_cmos_sensor(0x3C76,0x0000);
-   write_cmos_sensor(0x3C78,0x0000);
-   write_cmos_sensor(0x3C7A,0x0000);
-   write_cmos_sensor(0x3C7C,0x0000);
-   write_cmos_sensor(0x3C7E,0x0000);
-   write_cmos_sensor(0x3C80,0x0000);
-   write_cmos_sensor(0x3C82,0x0000);
-   write_cmos_sensor(0x3C84,0x0000);
-   write_cmos_sensor(0x3C86,0x0000);
-   write_cmos_sensor(0x3C88,0x0000);
-   write_cmos_sensor(0x3C8A,0x0000);
-   write_cmos_sensor(0x3C8C,0x0000);
-   write_cmos_sensor(0x3C8E,0x0000);
-   write_cmos_sensor(0x3C90,0x0000);
-   write_cmos_sensor(0x3C92,0x0000);
-   write_cmos_sensor(0x3C94,0x0000);
-   write_cmos_sensor(0x3C96,0x0000);
-   write_cmos_sensor(0x3C98,0x0000);
-   write_cmos_sensor(0x3C9A,0x0000);
-   write_cmos_sensor(0x3C9C,0x0000);
-   write_cmos_sensor(0x3C9E,0x0000);
-   write_cmos_sensor(0x3CA0,0x0000);
-   write_cmos_sensor(0x3CA2,0x0000);
-   write_cmos_sensor(0x3CA4,0x0000);
-   write_cmos_sensor(0x3CA6,0x0000);
-   write_cmos_sensor(0x3CA8,0x0000);
-   write_cmos_sensor(0x3CAA,0x0000);
-   write_cmos_sensor(0x3CAC,0x0000);
-   write_cmos_sensor(0x3CAE,0x0000);
-   write_cmos_sensor(0x3CB0,0x0000);
-   write_cmos_sensor(0x3CB2,0x0000);
-   write_cmos_sensor(0x3CB4,0x0000);
-   write_cmos_sensor(0x3CB6,0x0000);
-   write_cmos_sensor(0x3CB8,0x0000);
-   write_cmos_sensor(0x3CBA,0x0000);
-   write_cmos_sensor(0x3CBC,0x0000);
-   write_cmos_sensor(0x3CBE,0x0000);
-   write_cmos_sensor(0x3CC0,0x0000);
-   write_cmos_sensor(0x3CC2,0x0000);
-   write_cmos_sensor(0x3CC4,0x0000);
-   write_cmos_sensor(0x3CC6,0x0000);
-   write_cmos_sensor(0x3CC8,0x0000);
-   write_cmos_sensor(0x3CCA,0x0000);
-   write_cmos_sensor(0x3CCC,0x0000);
-   write_cmos_sensor(0x3CCE,0x0000);
-   write_cmos_sensor(0x3CD0,0x0000);
-   write_cmos_sensor(0x3CD2,0x0000);
-   write_cmos_sensor(0x3CD4,0x0000);
-   write_cmos_sensor(0x3CD6,0x0000);
-   write_cmos_sensor(0x3CD8,0x0000);
-   write_cmos_sensor(0x3CDA,0x0000);
-   write_cmos_sensor(0x3CDC,0x0000);
-   write_cmos_sensor(0x3CDE,0x0000);
-   write_cmos_sensor(0x3CE0,0x0000);
-   write_cmos_sensor(0x3CE2,0x0000);
-   write_cmos_sensor(0x3CE4,0x0000);
-   write_cmos_sensor(0x3CE6,0x0000);
-   write_cmos_sensor(0x3CE8,0x0000);
-   write_cmos_sensor(0x3CEA,0x0000);
-   write_cmos_sensor(0x3CEC,0x0000);
-   write_cmos_sensor(0x3CEE,0x0000);
-   write_cmos_sensor(0x3CF0,0x0000);
-   write_cmos_sensor(0x3CF2,0x0000);
-   write_cmos_sensor(0x3DD4,0x2000);
-   write_cmos_sensor(0x3DD6,0x2000);
-   write_cmos_sensor(0x3DDC,0x2000);	  //
-   write_cmos_sensor(0x3DDE,0x2000);	  //
-   write_cmos_sensor(0x3DF4,0x2000);	  //
-   write_cmos_sensor(0x3DF6,0x2000);	  //
-   write_cmos_sensor(0x3DFC,0x2000);	  //
-   write_cmos_sensor(0x3DFE,0x2000);	  //
-   write_cmos_sensor(0x3E14,0x2000);	  //
-   write_cmos_sensor(0x3E16,0x2000);	  //
-   write_cmos_sensor(0x3E1C,0x2000);	  //
-   write_cmos_sensor(0x3E1E,0x2000);	  //
-   write_cmos_sensor(0x3E76,0x0A04);
-   write_cmos_sensor(0x6226,0x0001);	  //Open clock to access ELG memory
-   write_cmos_sensor(0x70B6,0x0001);	  //Disable ELG
-   write_cmos_sensor(0x3050,0x0002);
-   write_cmos_sensor(0x3068,0x0000);
-   write_cmos_sensor(0x6028,0x2000);
-   write_cmos_sensor(0x602A,0x1410);
-   write_cmos_sensor(0x6F12,0x0000);
-   write_cmos_sensor(0x602A,0x1416);
-   write_cmos_sensor(0x6F12,0x0108);
-   write_cmos_sensor(0x6F12,0x0108);
-   write_cmos_sensor(0x6F12,0x0A08);
-   write_cmos_sensor(0x602A,0x141A); //modify address from 141B to 141A
-   write_cmos_sensor(0x6F12,0x0A08);
-//S6F120203 : delete this register
-   write_cmos_sensor(0x6F12,0x0202);
-   write_cmos_sensor(0x6F12,0x0603);
-//S6F120603 : delete this register
-
-   write_cmos_sensor(0x602A,0x1412);
-   write_cmos_sensor(0x6F12,0x0100);
-   write_cmos_sensor(0x3E9E,0x0011);
-   write_cmos_sensor(0x3EA2,0x0033);
-	//BPC
-   write_cmos_sensor(0x6028,0x2000);
-   write_cmos_sensor(0x602A,0x1748);
-   write_cmos_sensor(0x6F12,0x0101);
-   write_cmos_sensor(0x0B04,0x0101);
-   write_cmos_sensor(0x306E,0x039C);	  //smiaRegs_vendor_bpc_otp_clusters_address
-   write_cmos_sensor(0x3072,0x00FF);	  //smiaRegs_vendor_bpc_max_clusters_in_otp
-   write_cmos_sensor(0x30C4,0x0001);	  //smiaRegs_vendor_tnp_use_dgains_for_ladlc_enable
-   write_cmos_sensor(0x30C6,0x0001);	  //smiaRegs_vendor_tnp_reset_iir_on_ladlc_on_off
-   write_cmos_sensor(0x3E86,0x0104);
-   write_cmos_sensor(0x302E,0x0102);
-	//Immediate abort
-   write_cmos_sensor(0x3028,0x0000); //smiaRegs_vendor_sensor_abort_timing_method_on_rolling_sh
-   write_cmos_sensor(0x302A,0x0000);  //smiaRegs_vendor_sensor_abort_timing_on_sw_stby
-   write_cmos_sensor(0x3A70,0x0000);
-   write_cmos_sensor(0x3A72,0x0000);
-   write_cmos_sensor(0x3A74,0x0000);
-   write_cmos_sensor(0x3A76,0x0000);
-   write_cmos_sensor(0x3A78,0x0000);
-   write_cmos_sensor(0x3A7A,0x0000);
-   write_cmos_sensor(0x3A7C,0x0000);
-   write_cmos_sensor(0x3A7E,0x0000);
-   write_cmos_sensor(0x3A80,0x0000);
-   write_cmos_sensor(0x3A82,0x0000);
-   write_cmos_sensor(0x3A84,0x0000);
-   write_cmos_sensor(0x3A86,0x0000);
-   write_cmos_sensor(0x3A88,0x0000);
-   write_cmos_sensor(0x3A8A,0x0000);
-   write_cmos_sensor(0x3A8C,0x0000);
-   write_cmos_sensor(0x3A8E,0x0000);
-   write_cmos_sensor(0x3AB2,0x0000);
-   write_cmos_sensor(0x3AB4,0x0000);
-   write_cmos_sensor(0x3AB6,0x0000);
-   write_cmos_sensor(0x3AB8,0x0000);
-   write_cmos_sensor(0x3ABA,0x0000);
-   write_cmos_sensor(0x3ABC,0x0000);
-   write_cmos_sensor(0x3ABE,0x0000);
-   write_cmos_sensor(0x3AC0,0x0000);
-   write_cmos_sensor(0x3AC2,0x0000);
-   write_cmos_sensor(0x3AC4,0x0000);
-   write_cmos_sensor(0x3AC6,0x0000);
-   write_cmos_sensor(0x3AC8,0x0000);
-   write_cmos_sensor(0x3ACA,0x0000);
-   write_cmos_sensor(0x3ACC,0x0000);
-   write_cmos_sensor(0x3ACE,0x0000);
-   write_cmos_sensor_8(0x0114,0x03);
+   //init setting, streamed while open() returns; the next register access waits for it
+   kdSetI2CSpeed(imgsensor_info.i2c_speed);
+   kdSensorRegSeqWriteAsync(sensor_init_regs, ARRAY_SIZE(sensor_init_regs),
+			    imgsensor.i2c_write_id, sensor_init_done, NULL);
 
 }	/*	sensor_init  */
 
 
+static const KD_SENSOR_REG preview_setting_regs[] = {
+	KD_SENSOR_REG16(0x0382, 0x0003), /*smiaRegs_rw_sub_sample_x_odd_inc*/
+	KD_SENSOR_REG16(0x0380, 0x0001), /*smiaRegs_rw_sub_sample_x_even_inc*/
+	KD_SENSOR_REG16(0x0386, 0x0003), /*smiaRegs_rw_sub_sample_y_odd_inc*/
+	KD_SENSOR_REG16(0x0384, 0x0001), /*smiaRegs_rw_sub_sample_y_even_inc*/
+	KD_SENSOR_REG8(0x0900, 0x01), /*smiaRegs_rw_binning_mode*/
+	KD_SENSOR_REG8(0x0901, 0x22), /*smiaRegs_rw_binning_type*/
+	KD_SENSOR_REG16(0x0400, 0x0000), /*smiaRegs_rw_scaling_scaling_mode*/
+	KD_SENSOR_REG16(0x0404, 0x0010), /*smiaRegs_rw_scaling_scale_m*/
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0111, 0x02), /*smiaRegs_rw_output_signalling_mode*/
+	KD_SENSOR_REG16(0x0136, 0x1800), /*smiaRegs_rw_op_cond_extclk_frequency_mhz*/
+	KD_SENSOR_REG16(0x0304, 0x0006), /*smiaRegs_rw_clocks_pre_pll_clk_div*/
+	KD_SENSOR_REG16(0x0306, 0x00AF), /*smiaRegs_rw_clocks_pll_multiplier // 175*/
+	KD_SENSOR_REG16(0x0300, 0x0005), /*smiaRegs_rw_clocks_vt_pix_clk_div*/
+	KD_SENSOR_REG16(0x0302, 0x0001), /*smiaRegs_rw_clocks_vt_sys_clk_div*/
+	KD_SENSOR_REG16(0x030C, 0x0004), /*smiaRegs_rw_clocks_secnd_pre_pll_clk_div*/
+	KD_SENSOR_REG16(0x030E, 0x004A), /*smiaRegs_rw_clocks_secnd_pll_multiplier  50*/
+	KD_SENSOR_REG16(0x030A, 0x0001), /*smiaRegs_rw_clocks_op_sys_clk_div*/
+	KD_SENSOR_REG16(0x0308, 0x0008), /*smiaRegs_rw_clocks_op_pix_clk_div*/
+	KD_SENSOR_REG16(0x1118, 0x43FA),
+	KD_SENSOR_REG16(0x1124, 0x43FA),
+	KD_SENSOR_REG16(0x112C, 0x42C0),
+	KD_SENSOR_REG16(0x1164, 0x4280),
+	KD_SENSOR_REG16(0x1170, 0x4100),
+	KD_SENSOR_REG16(0x301C, 0x4396),
+	KD_SENSOR_REG16(0x0342, 0x16F8), /*smiaRegs_rw_frame_timing_line_length_pck // 3216*/
+	KD_SENSOR_REG16(0x0340, 0x0C60), /*smiaRegs_rw_frame_timing_frame_length_lines // 580*/
+	KD_SENSOR_REG16(0x0200, 0x0100), /*smiaRegs_rw_integration_time_fine_integration_time*/
+	KD_SENSOR_REG16(0x0202, 0x0100), /*smiaRegs_rw_integration_time_coarse_integration_time*/
+	KD_SENSOR_REG8(0x0216, 0x00), /*smiaRegs_rw_wdr_multiple_exp_mode*/
+	KD_SENSOR_REG8(0x3054, 0x00), /*smiaRegs_vendor_sensor_enable_af_pixels*/
+	KD_SENSOR_REG16(0x306A, 0x8110),
+	KD_SENSOR_REG8(0x3A6B, 0x00),
+	KD_SENSOR_REG8(0x39BB, 0x02),
+	KD_SENSOR_REG16(0x3A58, 0x0060),
+	KD_SENSOR_REG8(0x39E3, 0x02),
+	KD_SENSOR_REG16(0x3238, 0x0219), /* SenAnalog_AIG_pDefaultNormalPtrs_3__1_              */
+	KD_SENSOR_REG16(0x324A, 0x00E2), /* SenAnalog_AIG_pDefaultNormalPtrs_6__1_              */
+	KD_SENSOR_REG16(0x3250, 0x0114), /*SenAnalog_AIG_pDefaultNormalPtrs_7__1_              */
+	KD_SENSOR_REG16(0x3274, 0x013B), /*SenAnalog_AIG_pDefaultNormalPtrs_13__1_             */
+	KD_SENSOR_REG16(0x32C2, 0x0114), /*SenAnalog_AIG_pDefaultNormalPtrs_26__1_             */
+	KD_SENSOR_REG16(0x32C8, 0x012D), /* SenAnalog_AIG_pDefaultNormalPtrs_27__1_             */
+	KD_SENSOR_REG16(0x32DA, 0x0114), /* SenAnalog_AIG_pDefaultNormalPtrs_30__1_             */
+	KD_SENSOR_REG16(0x32E0, 0x0115), /*  SenAnalog_AIG_pDefaultNormalPtrs_31__1_             */
+	KD_SENSOR_REG16(0x35FE, 0x007A), /*  SenAnalog_AIG_pDefaultNormalPtrs_164__1_            */
+	KD_SENSOR_REG16(0x37C6, 0x0073), /* SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_           */
+	KD_SENSOR_REG16(0x37CC, 0x0054), /*SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_           */
+	KD_SENSOR_REG16(0x37D2, 0x0048), /* SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_           */
+	KD_SENSOR_REG16(0x37DE, 0x0071), /* SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_           */
+	KD_SENSOR_REG16(0x37E4, 0x0056), /* SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_           */
+	KD_SENSOR_REG16(0x37EA, 0x0046), /* SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_           */
+	KD_SENSOR_REG16(0x37F6, 0x0071), /* SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_           */
+	KD_SENSOR_REG16(0x37FC, 0x0056), /* SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_           */
+	KD_SENSOR_REG16(0x3802, 0x0046), /*SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_   */
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x15b8),
+	KD_SENSOR_REG16(0x6F12, 0x8011),
+	KD_SENSOR_REG16(0x3140, 0x0FE2),
+	KD_SENSOR_REG8(0x31B5, 0x00),
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x1760),
+	KD_SENSOR_REG8(0x6F12, 0x01),
+	KD_SENSOR_REG16(0x6F12, 0x0048),
+	KD_SENSOR_REG16(0x6F12, 0x0050),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0xF42E),
+	KD_SENSOR_REG16(0x6F12, 0x006D),
+	KD_SENSOR_REG16(0x6F12, 0x006A),
+	KD_SENSOR_REG16(0x6F12, 0xF51E),
+};
+
 static void preview_setting(void)
 {
 	int retry=0;
@@ -1454,76 +1548,7 @@ static void preview_setting(void)
     write_cmos_sensor(0x034C,0x0A68);   /*smiaRegs_rw_frame_timing_x_output_size*/
     write_cmos_sensor(0x034E,0x05DC);   /*smiaRegs_rw_frame_timing_y_output_size*/
 #endif
-    write_cmos_sensor(0x0382,0x0003);   /*smiaRegs_rw_sub_sample_x_odd_inc*/
-    write_cmos_sensor(0x0380,0x0001);   /*smiaRegs_rw_sub_sample_x_even_inc*/
-    write_cmos_sensor(0x0386,0x0003);   /*smiaRegs_rw_sub_sample_y_odd_inc*/
-    write_cmos_sensor(0x0384,0x0001);   /*smiaRegs_rw_sub_sample_y_even_inc*/
-    write_cmos_sensor_8(0x0900,0x01);   /*smiaRegs_rw_binning_mode*/
-    write_cmos_sensor_8(0x0901,0x22);   /*smiaRegs_rw_binning_type*/
-    write_cmos_sensor(0x0400,0x0000);   /*smiaRegs_rw_scaling_scaling_mode*/
-    write_cmos_sensor(0x0404,0x0010);   /*smiaRegs_rw_scaling_scale_m*/
-	write_cmos_sensor_8(0x0114,0x03);
-    write_cmos_sensor_8(0x0111,0x02);   /*smiaRegs_rw_output_signalling_mode*/
-    write_cmos_sensor(0x0136,0x1800);   /*smiaRegs_rw_op_cond_extclk_frequency_mhz*/
-    write_cmos_sensor(0x0304,0x0006);   /*smiaRegs_rw_clocks_pre_pll_clk_div*/
-    write_cmos_sensor(0x0306,0x00AF);   /*smiaRegs_rw_clocks_pll_multiplier // 175*/
-    write_cmos_sensor(0x0300,0x0005);   /*smiaRegs_rw_clocks_vt_pix_clk_div*/
-    write_cmos_sensor(0x0302,0x0001);   /*smiaRegs_rw_clocks_vt_sys_clk_div*/
-    write_cmos_sensor(0x030C,0x0004);   /*smiaRegs_rw_clocks_secnd_pre_pll_clk_div*/
-    write_cmos_sensor(0x030E,0x004A);   /*smiaRegs_rw_clocks_secnd_pll_multiplier  50*/
-    write_cmos_sensor(0x030A,0x0001);   /*smiaRegs_rw_clocks_op_sys_clk_div*/
-    write_cmos_sensor(0x0308,0x0008);   /*smiaRegs_rw_clocks_op_pix_clk_div*/
-	write_cmos_sensor(0x1118,0x43FA);
-	write_cmos_sensor(0x1124,0x43FA);
-	write_cmos_sensor(0x112C,0x42C0);
-	write_cmos_sensor(0x1164,0x4280);
-	write_cmos_sensor(0x1170,0x4100);
-	write_cmos_sensor(0x301C,0x4396);
-	write_cmos_sensor(0x0342,0x16F8);   /*smiaRegs_rw_frame_timing_line_length_pck // 3216*/
-    write_cmos_sensor(0x0340,0x0C60);   /*smiaRegs_rw_frame_timing_frame_length_lines // 580*/
-    write_cmos_sensor(0x0200,0x0100);   /*smiaRegs_rw_integration_time_fine_integration_time*/
-    write_cmos_sensor(0x0202,0x0100);   /*smiaRegs_rw_integration_time_coarse_integration_time*/
-    write_cmos_sensor_8(0x0216,0x00);   /*smiaRegs_rw_wdr_multiple_exp_mode*/
-    write_cmos_sensor_8(0x3054,0x00);   /*smiaRegs_vendor_sensor_enable_af_pixels*/
-	write_cmos_sensor(0x306A,0x8110);
-	write_cmos_sensor_8(0x3A6B,0x00);
-    write_cmos_sensor_8(0x39BB,0x02);
-    write_cmos_sensor(0x3A58,0x0060);
-    write_cmos_sensor_8(0x39E3,0x02);
-    write_cmos_sensor(0x3238,0x0219);   /* SenAnalog_AIG_pDefaultNormalPtrs_3__1_              */
-    write_cmos_sensor(0x324A,0x00E2);   /* SenAnalog_AIG_pDefaultNormalPtrs_6__1_              */
-    write_cmos_sensor(0x3250,0x0114);    /*SenAnalog_AIG_pDefaultNormalPtrs_7__1_              */
-    write_cmos_sensor(0x3274,0x013B);    /*SenAnalog_AIG_pDefaultNormalPtrs_13__1_             */
-    write_cmos_sensor(0x32C2,0x0114);    /*SenAnalog_AIG_pDefaultNormalPtrs_26__1_             */
-    write_cmos_sensor(0x32C8,0x012D);   /* SenAnalog_AIG_pDefaultNormalPtrs_27__1_             */
-    write_cmos_sensor(0x32DA,0x0114);   /* SenAnalog_AIG_pDefaultNormalPtrs_30__1_             */
-    write_cmos_sensor(0x32E0,0x0115);  /*  SenAnalog_AIG_pDefaultNormalPtrs_31__1_             */
-    write_cmos_sensor(0x35FE,0x007A);  /*  SenAnalog_AIG_pDefaultNormalPtrs_164__1_            */
-    write_cmos_sensor(0x37C6,0x0073);   /* SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_           */
-    write_cmos_sensor(0x37CC,0x0054);    /*SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_           */
-    write_cmos_sensor(0x37D2,0x0048);   /* SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_           */
-    write_cmos_sensor(0x37DE,0x0071);   /* SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_           */
-    write_cmos_sensor(0x37E4,0x0056);   /* SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_           */
-    write_cmos_sensor(0x37EA,0x0046);   /* SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_           */
-    write_cmos_sensor(0x37F6,0x0071);   /* SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_           */
-    write_cmos_sensor(0x37FC,0x0056);   /* SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_           */
-    write_cmos_sensor(0x3802,0x0046);    /*SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_   */
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x15b8);
-	write_cmos_sensor(0x6F12,0x8011);
-	write_cmos_sensor(0x3140,0x0FE2);
-	write_cmos_sensor_8(0x31B5,0x00);
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x1760);
-	write_cmos_sensor_8(0x6F12,0x01);
-	write_cmos_sensor(0x6F12,0x0048);
-	write_cmos_sensor(0x6F12,0x0050);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0xF42E);
-	write_cmos_sensor(0x6F12,0x006D);
-	write_cmos_sensor(0x6F12,0x006A);
-	write_cmos_sensor(0x6F12,0xF51E);
+    write_cmos_sensor_table(preview_setting_regs);
 	if(imgsensor.ihdr_en)
 	{
 		write_cmos_sensor_8(0x0216,0x02);
@@ -1588,6 +1613,81 @@ static void preview_setting(void)
 }	/*	preview_setting  */
 
 
+static const KD_SENSOR_REG normal_capture_setting_regs[] = {
+	KD_SENSOR_REG16(0x0382, 0x0001), //smiaRegs_rw_sub_sample_x_odd_inc
+	KD_SENSOR_REG16(0x0380, 0x0001), //smiaRegs_rw_sub_sample_x_even_inc
+	KD_SENSOR_REG16(0x0386, 0x0001), //smiaRegs_rw_sub_sample_y_odd_inc
+	KD_SENSOR_REG16(0x0384, 0x0001), //smiaRegs_rw_sub_sample_y_even_inc
+	KD_SENSOR_REG8(0x0900, 0x00), //smiaRegs_rw_binning_mode
+	KD_SENSOR_REG8(0x0901, 0x11), //smiaRegs_rw_binning_type
+	KD_SENSOR_REG16(0x0400, 0x0000), //smiaRegs_rw_scaling_scaling_mode
+	KD_SENSOR_REG16(0x0404, 0x0010), //smiaRegs_rw_scaling_scale_m
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0111, 0x02), //smiaRegs_rw_output_signalling_mode
+	KD_SENSOR_REG16(0x0136, 0x1800), //smiaRegs_rw_op_cond_extclk_frequency_mhz
+	KD_SENSOR_REG16(0x0304, 0x0006), //smiaRegs_rw_clocks_pre_pll_clk_div
+	KD_SENSOR_REG16(0x0306, 0x00AF), //smiaRegs_rw_clocks_pll_multiplier // 175
+	KD_SENSOR_REG16(0x0300, 0x0005), //smiaRegs_rw_clocks_vt_pix_clk_div
+	KD_SENSOR_REG16(0x0302, 0x0001), //smiaRegs_rw_clocks_vt_sys_clk_div
+	KD_SENSOR_REG16(0x030C, 0x0004), //smiaRegs_rw_clocks_secnd_pre_pll_clk_div
+	KD_SENSOR_REG16(0x030E, 0x0074), //smiaRegs_rw_clocks_secnd_pll_multiplier // 50
+	KD_SENSOR_REG16(0x030A, 0x0001), //smiaRegs_rw_clocks_op_sys_clk_div
+	KD_SENSOR_REG16(0x0308, 0x0008), //smiaRegs_rw_clocks_op_pix_clk_div
+	KD_SENSOR_REG16(0x1118, 0x43FA),
+	KD_SENSOR_REG16(0x1124, 0x43FA),
+	KD_SENSOR_REG16(0x112C, 0x42C0),
+	KD_SENSOR_REG16(0x1164, 0x4280),
+	KD_SENSOR_REG16(0x1170, 0x4100),
+	KD_SENSOR_REG16(0x301C, 0x4396),
+	KD_SENSOR_REG16(0x0342, 0x16F8), //smiaRegs_rw_frame_timing_line_length_pck // 3216
+	KD_SENSOR_REG16(0x0340, 0x0C66), //smiaRegs_rw_frame_timing_frame_length_lines // 580
+	KD_SENSOR_REG16(0x0200, 0x0100), //smiaRegs_rw_integration_time_fine_integration_time
+	KD_SENSOR_REG16(0x0202, 0x0100), //smiaRegs_rw_integration_time_coarse_integration_time
+	KD_SENSOR_REG8(0x0216, 0x00), //smiaRegs_rw_wdr_multiple_exp_mode
+	KD_SENSOR_REG8(0x3054, 0x01), //smiaRegs_vendor_sensor_enable_af_pixels
+	KD_SENSOR_REG16(0x306A, 0x8000),
+	KD_SENSOR_REG8(0x3A6B, 0x00),
+	KD_SENSOR_REG8(0x39BB, 0x02),
+	KD_SENSOR_REG16(0x3A58, 0x0061),
+	KD_SENSOR_REG8(0x39E3, 0x02),
+	KD_SENSOR_REG16(0x3238, 0x0219), // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
+	KD_SENSOR_REG16(0x324A, 0x00DE), // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
+	KD_SENSOR_REG16(0x3250, 0x011F), //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
+	KD_SENSOR_REG16(0x3274, 0x013E), //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
+	KD_SENSOR_REG16(0x32C2, 0x011F), //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
+	KD_SENSOR_REG16(0x32C8, 0x0140), // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
+	KD_SENSOR_REG16(0x32DA, 0x011F), // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
+	KD_SENSOR_REG16(0x32E0, 0x0120), //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
+	KD_SENSOR_REG16(0x35FE, 0x0078), //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
+	KD_SENSOR_REG16(0x37C6, 0x0083), // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
+	KD_SENSOR_REG16(0x37CC, 0x005D), //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
+	KD_SENSOR_REG16(0x37D2, 0x0057), // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
+	KD_SENSOR_REG16(0x37DE, 0x0081), // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
+	KD_SENSOR_REG16(0x37E4, 0x005F), // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
+	KD_SENSOR_REG16(0x37EA, 0x0055), // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
+	KD_SENSOR_REG16(0x37F6, 0x0081), // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
+	KD_SENSOR_REG16(0x37FC, 0x005F), // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
+	KD_SENSOR_REG16(0x3802, 0x0055), //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x15b8),
+	KD_SENSOR_REG16(0x6F12, 0x8011),
+	KD_SENSOR_REG16(0x3140, 0x0FE2),
+	KD_SENSOR_REG8(0x31B5, 0x00),
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x1760),
+	KD_SENSOR_REG8(0x6F12, 0x01),
+	KD_SENSOR_REG16(0x6F12, 0x0048),
+	KD_SENSOR_REG16(0x6F12, 0x0050),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0xF42E),
+	KD_SENSOR_REG16(0x6F12, 0x006D),
+	KD_SENSOR_REG16(0x6F12, 0x006A),
+	KD_SENSOR_REG16(0x6F12, 0xF51E),
+
+	KD_SENSOR_REG16(0x0100, 0x0100), //smiaRegs_rw_general_setup // Stream on
+};
+
 static void normal_capture_setting(void)
 {    
 	int retry=0;
@@ -1638,78 +1738,7 @@ static void normal_capture_setting(void)
 	write_cmos_sensor(0x034C,0x14D0);	//smiaRegs_rw_frame_timing_x_output_size
 	write_cmos_sensor(0x034E,0x0BB8);	//smiaRegs_rw_frame_timing_y_output_size
 #endif
-	write_cmos_sensor(0x0382,0x0001);	//smiaRegs_rw_sub_sample_x_odd_inc
-	write_cmos_sensor(0x0380,0x0001);	//smiaRegs_rw_sub_sample_x_even_inc
-	write_cmos_sensor(0x0386,0x0001);	//smiaRegs_rw_sub_sample_y_odd_inc
-	write_cmos_sensor(0x0384,0x0001);	//smiaRegs_rw_sub_sample_y_even_inc
-	write_cmos_sensor_8(0x0900,0x00);	//smiaRegs_rw_binning_mode
-	write_cmos_sensor_8(0x0901,0x11);	//smiaRegs_rw_binning_type
-	write_cmos_sensor(0x0400,0x0000);	//smiaRegs_rw_scaling_scaling_mode
-	write_cmos_sensor(0x0404,0x0010);	//smiaRegs_rw_scaling_scale_m
-	write_cmos_sensor_8(0x0114,0x03);
-	write_cmos_sensor_8(0x0111,0x02);	//smiaRegs_rw_output_signalling_mode
-	write_cmos_sensor(0x0136,0x1800);	//smiaRegs_rw_op_cond_extclk_frequency_mhz
-	write_cmos_sensor(0x0304,0x0006);	//smiaRegs_rw_clocks_pre_pll_clk_div
-	write_cmos_sensor(0x0306,0x00AF);	//smiaRegs_rw_clocks_pll_multiplier // 175
-	write_cmos_sensor(0x0300,0x0005);	//smiaRegs_rw_clocks_vt_pix_clk_div
-	write_cmos_sensor(0x0302,0x0001);	//smiaRegs_rw_clocks_vt_sys_clk_div
-	write_cmos_sensor(0x030C,0x0004);	//smiaRegs_rw_clocks_secnd_pre_pll_clk_div
-	write_cmos_sensor(0x030E,0x0074);	//smiaRegs_rw_clocks_secnd_pll_multiplier // 50
-	write_cmos_sensor(0x030A,0x0001);	//smiaRegs_rw_clocks_op_sys_clk_div
-	write_cmos_sensor(0x0308,0x0008);	//smiaRegs_rw_clocks_op_pix_clk_div
-	write_cmos_sensor(0x1118,0x43FA);
-	write_cmos_sensor(0x1124,0x43FA);
-	write_cmos_sensor(0x112C,0x42C0);
-	write_cmos_sensor(0x1164,0x4280);
-	write_cmos_sensor(0x1170,0x4100);
-	write_cmos_sensor(0x301C,0x4396);
-	write_cmos_sensor(0x0342,0x16F8);	//smiaRegs_rw_frame_timing_line_length_pck // 3216
-	write_cmos_sensor(0x0340,0x0C66);	//smiaRegs_rw_frame_timing_frame_length_lines // 580
-	write_cmos_sensor(0x0200,0x0100);	//smiaRegs_rw_integration_time_fine_integration_time
-	write_cmos_sensor(0x0202,0x0100);	//smiaRegs_rw_integration_time_coarse_integration_time
-	write_cmos_sensor_8(0x0216,0x00);	//smiaRegs_rw_wdr_multiple_exp_mode
-	write_cmos_sensor_8(0x3054,0x01);	//smiaRegs_vendor_sensor_enable_af_pixels
-	write_cmos_sensor(0x306A,0x8000);
-	write_cmos_sensor_8(0x3A6B,0x00);
-	write_cmos_sensor_8(0x39BB,0x02);
-	write_cmos_sensor(0x3A58,0x0061);
-	write_cmos_sensor_8(0x39E3,0x02);
-	write_cmos_sensor(0x3238,0x0219);   // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
-	write_cmos_sensor(0x324A,0x00DE);   // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
-	write_cmos_sensor(0x3250,0x011F);    //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
-	write_cmos_sensor(0x3274,0x013E);    //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
-	write_cmos_sensor(0x32C2,0x011F);    //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
-	write_cmos_sensor(0x32C8,0x0140);   // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
-	write_cmos_sensor(0x32DA,0x011F);   // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
-	write_cmos_sensor(0x32E0,0x0120);  //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
-	write_cmos_sensor(0x35FE,0x0078);  //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
-	write_cmos_sensor(0x37C6,0x0083);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
-	write_cmos_sensor(0x37CC,0x005D);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
-	write_cmos_sensor(0x37D2,0x0057);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
-	write_cmos_sensor(0x37DE,0x0081);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
-	write_cmos_sensor(0x37E4,0x005F);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
-	write_cmos_sensor(0x37EA,0x0055);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
-	write_cmos_sensor(0x37F6,0x0081);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
-	write_cmos_sensor(0x37FC,0x005F);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
-	write_cmos_sensor(0x3802,0x0055);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x15b8);
-	write_cmos_sensor(0x6F12,0x8011);
-	write_cmos_sensor(0x3140,0x0FE2);
-	write_cmos_sensor_8(0x31B5,0x00);
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x1760);
-	write_cmos_sensor_8(0x6F12,0x01);
-	write_cmos_sensor(0x6F12,0x0048);
-	write_cmos_sensor(0x6F12,0x0050);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0xF42E);
-	write_cmos_sensor(0x6F12,0x006D);
-	write_cmos_sensor(0x6F12,0x006A);
-	write_cmos_sensor(0x6F12,0xF51E);
-
-	write_cmos_sensor(0x0100,0x0100);	//smiaRegs_rw_general_setup // Stream on
+	write_cmos_sensor_table(normal_capture_setting_regs);
 //    while(retry<10)
 //		{if(read_cmos_sensor_8(0x0005)==0xff)
 //		    {
@@ -1790,6 +1819,83 @@ static void normal_capture_setting(void)
 
 }
 
+static const KD_SENSOR_REG pip_capture_setting_regs[] = {
+	KD_SENSOR_REG16(0x0382, 0x0001), /*smiaRegs_rw_sub_sample_x_odd_inc*/
+	KD_SENSOR_REG16(0x0380, 0x0001), /*smiaRegs_rw_sub_sample_x_even_inc*/
+	KD_SENSOR_REG16(0x0386, 0x0001), /*smiaRegs_rw_sub_sample_y_odd_inc*/
+	KD_SENSOR_REG16(0x0384, 0x0001), /*smiaRegs_rw_sub_sample_y_even_inc*/
+	KD_SENSOR_REG8(0x0900, 0x00), /*smiaRegs_rw_binning_mode*/
+	KD_SENSOR_REG8(0x0901, 0x11), /*smiaRegs_rw_binning_type*/
+	KD_SENSOR_REG16(0x0400, 0x0000), /*smiaRegs_rw_scaling_scaling_mode*/
+	KD_SENSOR_REG16(0x0404, 0x0010), /*smiaRegs_rw_scaling_scale_m*/
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0111, 0x02), /*smiaRegs_rw_output_signalling_mode*/
+	KD_SENSOR_REG16(0x0136, 0x1800),
+	KD_SENSOR_REG16(0x0304, 0x0006),
+	KD_SENSOR_REG16(0x0306, 0x0074), //smiaRegs_rw_clocks_pll_multiplier // 175
+	KD_SENSOR_REG16(0x0300, 0x0005), //smiaRegs_rw_clocks_vt_pix_clk_div
+	KD_SENSOR_REG16(0x0302, 0x0001), //smiaRegs_rw_clocks_vt_sys_clk_div
+	KD_SENSOR_REG16(0x030C, 0x0004), //smiaRegs_rw_clocks_secnd_pre_pll_clk_div
+	KD_SENSOR_REG16(0x030E, 0x004B), //smiaRegs_rw_clocks_secnd_pll_multiplier // 50
+	KD_SENSOR_REG16(0x030A, 0x0001), //smiaRegs_rw_clocks_op_sys_clk_div
+	KD_SENSOR_REG16(0x0308, 0x0008), //smiaRegs_rw_clocks_op_pix_clk_div
+	KD_SENSOR_REG16(0x1118, 0x4100),
+	KD_SENSOR_REG16(0x1124, 0x4100),
+	KD_SENSOR_REG16(0x112C, 0x4100),
+	KD_SENSOR_REG16(0x1164, 0x4100),
+	KD_SENSOR_REG16(0x1170, 0x4100),
+	KD_SENSOR_REG16(0x301C, 0x4100),
+	KD_SENSOR_REG16(0x0342, 0x16f8), //smiaRegs_rw_frame_timing_line_length_pck // 3216
+	KD_SENSOR_REG16(0x0340, 0x0C66), //smiaRegs_rw_frame_timing_frame_length_lines // 580
+	KD_SENSOR_REG16(0x0200, 0x0100), //smiaRegs_rw_integration_time_fine_integration_time
+	KD_SENSOR_REG16(0x0202, 0x0100), //smiaRegs_rw_integration_time_coarse_integration_time
+	KD_SENSOR_REG8(0x0216, 0x00), //smiaRegs_rw_wdr_multiple_exp_mode
+	KD_SENSOR_REG8(0x3054, 0x01), //smiaRegs_vendor_sensor_enable_af_pixels
+	KD_SENSOR_REG16(0x3A6A, 0x8000),
+	KD_SENSOR_REG8(0x3A6B, 0x00),
+	KD_SENSOR_REG8(0x39BB, 0x02),
+	KD_SENSOR_REG16(0x3A58, 0x0061),
+	KD_SENSOR_REG8(0x39E3, 0x02),
+	KD_SENSOR_REG16(0x3238, 0x0219), // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
+	KD_SENSOR_REG16(0x324A, 0x00DE), // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
+	KD_SENSOR_REG16(0x3250, 0x011F), //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
+	KD_SENSOR_REG16(0x3274, 0x013E), //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
+	KD_SENSOR_REG16(0x32C2, 0x011F), //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
+	KD_SENSOR_REG16(0x32C8, 0x0140), // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
+	KD_SENSOR_REG16(0x32DA, 0x011F), // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
+	KD_SENSOR_REG16(0x32E0, 0x0120), //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
+	KD_SENSOR_REG16(0x35FE, 0x0078), //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
+	KD_SENSOR_REG16(0x37C6, 0x0083), // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
+	KD_SENSOR_REG16(0x37CC, 0x005D), //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
+	KD_SENSOR_REG16(0x37D2, 0x0057), // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
+	KD_SENSOR_REG16(0x37DE, 0x0081), // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
+	KD_SENSOR_REG16(0x37E4, 0x005F), // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
+	KD_SENSOR_REG16(0x37EA, 0x0055), // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
+	KD_SENSOR_REG16(0x37F6, 0x0081), // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
+	KD_SENSOR_REG16(0x37FC, 0x005F), // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
+	KD_SENSOR_REG16(0x3802, 0x0055), //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x15b8),
+	KD_SENSOR_REG16(0x6F12, 0x8011),
+	KD_SENSOR_REG16(0x3140, 0x0FE2),
+};
+
+static const KD_SENSOR_REG pip_capture_setting_regs_2[] = {
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x1760),
+	KD_SENSOR_REG8(0x6F12, 0x01),
+	KD_SENSOR_REG16(0x6F12, 0x0048),
+	KD_SENSOR_REG16(0x6F12, 0x0050),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0xF42E),
+	KD_SENSOR_REG16(0x6F12, 0x006D),
+	KD_SENSOR_REG16(0x6F12, 0x006A),
+	KD_SENSOR_REG16(0x6F12, 0xF51E),
+
+	KD_SENSOR_REG16(0x0100, 0x0100), //smiaRegs_rw_general_setup // Stream on
+};
+
 static void pip_capture_setting(void)
 {
 	int retry=0;
@@ -1827,78 +1933,9 @@ static void pip_capture_setting(void)
 	write_cmos_sensor(0x034C,0x14D0);	//smiaRegs_rw_frame_timing_x_output_size
     write_cmos_sensor(0x034E,0x0BB8);   /*smiaRegs_rw_frame_timing_y_output_size*/
 #endif
-    write_cmos_sensor(0x0382,0x0001);   /*smiaRegs_rw_sub_sample_x_odd_inc*/
-    write_cmos_sensor(0x0380,0x0001);   /*smiaRegs_rw_sub_sample_x_even_inc*/
-    write_cmos_sensor(0x0386,0x0001);   /*smiaRegs_rw_sub_sample_y_odd_inc*/
-    write_cmos_sensor(0x0384,0x0001);   /*smiaRegs_rw_sub_sample_y_even_inc*/
-    write_cmos_sensor_8(0x0900,0x00);   /*smiaRegs_rw_binning_mode*/
-    write_cmos_sensor_8(0x0901,0x11);   /*smiaRegs_rw_binning_type*/
-    write_cmos_sensor(0x0400,0x0000);   /*smiaRegs_rw_scaling_scaling_mode*/
-    write_cmos_sensor(0x0404,0x0010);   /*smiaRegs_rw_scaling_scale_m*/
-	 write_cmos_sensor_8(0x0114,0x03);
-    write_cmos_sensor_8(0x0111,0x02);   /*smiaRegs_rw_output_signalling_mode*/
-    write_cmos_sensor(0x0136,0x1800);
-    write_cmos_sensor(0x0304,0x0006);
-	write_cmos_sensor(0x0306,0x0074);	//smiaRegs_rw_clocks_pll_multiplier // 175
-	write_cmos_sensor(0x0300,0x0005);	//smiaRegs_rw_clocks_vt_pix_clk_div
-	write_cmos_sensor(0x0302,0x0001);	//smiaRegs_rw_clocks_vt_sys_clk_div
-	write_cmos_sensor(0x030C,0x0004);	//smiaRegs_rw_clocks_secnd_pre_pll_clk_div
-	write_cmos_sensor(0x030E,0x004B);	//smiaRegs_rw_clocks_secnd_pll_multiplier // 50
-	write_cmos_sensor(0x030A,0x0001);	//smiaRegs_rw_clocks_op_sys_clk_div
-	write_cmos_sensor(0x0308,0x0008);	//smiaRegs_rw_clocks_op_pix_clk_div
-	write_cmos_sensor(0x1118,0x4100);
-	write_cmos_sensor(0x1124,0x4100);
-	write_cmos_sensor(0x112C,0x4100);
-	write_cmos_sensor(0x1164,0x4100);
-	write_cmos_sensor(0x1170,0x4100);
-	write_cmos_sensor(0x301C,0x4100);
-	write_cmos_sensor(0x0342,0x16f8);	//smiaRegs_rw_frame_timing_line_length_pck // 3216
-	write_cmos_sensor(0x0340,0x0C66);	//smiaRegs_rw_frame_timing_frame_length_lines // 580
-	write_cmos_sensor(0x0200,0x0100);	//smiaRegs_rw_integration_time_fine_integration_time
-	write_cmos_sensor(0x0202,0x0100);	//smiaRegs_rw_integration_time_coarse_integration_time
-	write_cmos_sensor_8(0x0216,0x00);	//smiaRegs_rw_wdr_multiple_exp_mode
-	write_cmos_sensor_8(0x3054,0x01);	//smiaRegs_vendor_sensor_enable_af_pixels
-	write_cmos_sensor(0x3A6A,0x8000);
-	write_cmos_sensor_8(0x3A6B,0x00);
-	write_cmos_sensor_8(0x39BB,0x02);
-	write_cmos_sensor(0x3A58,0x0061);
-	write_cmos_sensor_8(0x39E3,0x02);
-	write_cmos_sensor(0x3238,0x0219);   // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
-	write_cmos_sensor(0x324A,0x00DE);   // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
-	write_cmos_sensor(0x3250,0x011F);    //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
-	write_cmos_sensor(0x3274,0x013E);    //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
-	write_cmos_sensor(0x32C2,0x011F);    //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
-	write_cmos_sensor(0x32C8,0x0140);   // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
-	write_cmos_sensor(0x32DA,0x011F);   // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
-	write_cmos_sensor(0x32E0,0x0120);  //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
-	write_cmos_sensor(0x35FE,0x0078);  //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
-	write_cmos_sensor(0x37C6,0x0083);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
-	write_cmos_sensor(0x37CC,0x005D);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
-	write_cmos_sensor(0x37D2,0x0057);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
-	write_cmos_sensor(0x37DE,0x0081);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
-	write_cmos_sensor(0x37E4,0x005F);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
-	write_cmos_sensor(0x37EA,0x0055);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
-	write_cmos_sensor(0x37F6,0x0081);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
-	write_cmos_sensor(0x37FC,0x005F);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
-	write_cmos_sensor(0x3802,0x0055);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x15b8);
-	write_cmos_sensor(0x6F12,0x8011);
-	write_cmos_sensor(0x3140,0x0FE2);
+    write_cmos_sensor_table(pip_capture_setting_regs);
 	write_cmos_sensor_8(0x31B5,0X00);
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x1760);
-	write_cmos_sensor_8(0x6F12,0x01);
-	write_cmos_sensor(0x6F12,0x0048);
-	write_cmos_sensor(0x6F12,0x0050);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0xF42E);
-	write_cmos_sensor(0x6F12,0x006D);
-	write_cmos_sensor(0x6F12,0x006A);
-	write_cmos_sensor(0x6F12,0xF51E);
-
-	write_cmos_sensor(0x0100,0x0100);	//smiaRegs_rw_general_setup // Stream on
+	write_cmos_sensor_table(pip_capture_setting_regs_2);
 //	while(retry<10)
 //	{
 //		if(read_cmos_sensor_8(0x0005)==0xff)
@@ -1948,6 +1985,82 @@ static void pip_capture_setting(void)
 
 }
 
+static const KD_SENSOR_REG pip_capture_15fps_setting_regs[] = {
+	KD_SENSOR_REG16(0x0382, 0x0001), /*smiaRegs_rw_sub_sample_x_odd_inc*/
+	KD_SENSOR_REG16(0x0380, 0x0001), /*smiaRegs_rw_sub_sample_x_even_inc*/
+	KD_SENSOR_REG16(0x0386, 0x0001), /*smiaRegs_rw_sub_sample_y_odd_inc*/
+	KD_SENSOR_REG16(0x0384, 0x0001), /*smiaRegs_rw_sub_sample_y_even_inc*/
+	KD_SENSOR_REG8(0x0900, 0x00), /*smiaRegs_rw_binning_mode*/
+	KD_SENSOR_REG8(0x0901, 0x11), /*smiaRegs_rw_binning_type*/
+	KD_SENSOR_REG16(0x0400, 0x0000), /*smiaRegs_rw_scaling_scaling_mode*/
+	KD_SENSOR_REG16(0x0404, 0x0010), /*smiaRegs_rw_scaling_scale_m*/
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0111, 0x02), /*smiaRegs_rw_output_signalling_mode*/
+	KD_SENSOR_REG16(0x0136, 0x1800),
+	KD_SENSOR_REG16(0x0304, 0x0006),
+	KD_SENSOR_REG16(0x0306, 0x0058), //smiaRegs_rw_clocks_pll_multiplier // 175
+	KD_SENSOR_REG16(0x0302, 0x0001), //smiaRegs_rw_clocks_vt_pix_clk_div
+	KD_SENSOR_REG16(0x0300, 0x0005), //smiaRegs_rw_clocks_vt_sys_clk_div
+	KD_SENSOR_REG16(0x030C, 0x0004), //smiaRegs_rw_clocks_secnd_pre_pll_clk_div
+	KD_SENSOR_REG16(0x030E, 0x003C), //smiaRegs_rw_clocks_secnd_pll_multiplier // 50
+	KD_SENSOR_REG16(0x030A, 0x0001), //smiaRegs_rw_clocks_op_sys_clk_div
+	KD_SENSOR_REG16(0x0308, 0x0008), //smiaRegs_rw_clocks_op_pix_clk_div
+	KD_SENSOR_REG16(0x1118, 0x4100),
+	KD_SENSOR_REG16(0x1124, 0x4100),
+	KD_SENSOR_REG16(0x112C, 0x4100),
+	KD_SENSOR_REG16(0x1164, 0x4100),
+	KD_SENSOR_REG16(0x1170, 0x4100),
+	KD_SENSOR_REG16(0x301C, 0x4100),
+	KD_SENSOR_REG16(0x0342, 0x16F8), //smiaRegs_rw_frame_timing_line_length_pck // 3216
+	KD_SENSOR_REG16(0x0340, 0x0C66), //smiaRegs_rw_frame_timing_frame_length_lines // 580
+	KD_SENSOR_REG16(0x0200, 0x0100), //smiaRegs_rw_integration_time_fine_integration_time
+	KD_SENSOR_REG16(0x0202, 0x0100), //smiaRegs_rw_integration_time_coarse_integration_time
+	KD_SENSOR_REG8(0x0216, 0x00), //smiaRegs_rw_wdr_multiple_exp_mode
+	KD_SENSOR_REG8(0x3054, 0x01), //smiaRegs_vendor_sensor_enable_af_pixels
+	KD_SENSOR_REG16(0x3A6A, 0x8000),
+	KD_SENSOR_REG8(0x3A6B, 0x00),
+	KD_SENSOR_REG8(0x39BB, 0x02),
+	KD_SENSOR_REG8(0x3005, 0x05),
+	KD_SENSOR_REG16(0x3A58, 0x0061),
+	KD_SENSOR_REG8(0x39E3, 0x02),
+	KD_SENSOR_REG16(0x3238, 0x0219), // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
+	KD_SENSOR_REG16(0x324A, 0x00DE), // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
+	KD_SENSOR_REG16(0x3250, 0x011F), //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
+	KD_SENSOR_REG16(0x3274, 0x013E), //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
+	KD_SENSOR_REG16(0x32C2, 0x011F), //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
+	KD_SENSOR_REG16(0x32C8, 0x0140), // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
+	KD_SENSOR_REG16(0x32DA, 0x011F), // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
+	KD_SENSOR_REG16(0x32E0, 0x0120), //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
+	KD_SENSOR_REG16(0x35FE, 0x0078), //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
+	KD_SENSOR_REG16(0x37C6, 0x0083), // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
+	KD_SENSOR_REG16(0x37CC, 0x005D), //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
+	KD_SENSOR_REG16(0x37D2, 0x0057), // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
+	KD_SENSOR_REG16(0x37DE, 0x0081), // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
+	KD_SENSOR_REG16(0x37E4, 0x005F), // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
+	KD_SENSOR_REG16(0x37EA, 0x0055), // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
+	KD_SENSOR_REG16(0x37F6, 0x0081), // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
+	KD_SENSOR_REG16(0x37FC, 0x005F), // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
+	KD_SENSOR_REG16(0x3802, 0x0055), //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x15b8),
+	KD_SENSOR_REG16(0x6F12, 0x8011),
+	KD_SENSOR_REG16(0x3140, 0x0FE2),
+	KD_SENSOR_REG8(0x31B5, 0x00),
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x1760),
+	KD_SENSOR_REG8(0x6F12, 0x01),
+	KD_SENSOR_REG16(0x6F12, 0x0048),
+	KD_SENSOR_REG16(0x6F12, 0x0050),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0xF42E),
+	KD_SENSOR_REG16(0x6F12, 0x006D),
+	KD_SENSOR_REG16(0x6F12, 0x006A),
+	KD_SENSOR_REG16(0x6F12, 0xF51E),
+
+	KD_SENSOR_REG16(0x0100, 0x0100), //smiaRegs_rw_general_setup // Stream on
+};
+
 static void pip_capture_15fps_setting(void)
 {
     int retry=0;
@@ -1985,79 +2098,7 @@ static void pip_capture_15fps_setting(void)
     write_cmos_sensor(0x034C,0x14D0);   //smiaRegs_rw_frame_timing_x_output_size
     write_cmos_sensor(0x034E,0x0BB8);   /*smiaRegs_rw_frame_timing_y_output_size*/
 #endif
-    write_cmos_sensor(0x0382,0x0001);   /*smiaRegs_rw_sub_sample_x_odd_inc*/
-    write_cmos_sensor(0x0380,0x0001);   /*smiaRegs_rw_sub_sample_x_even_inc*/
-    write_cmos_sensor(0x0386,0x0001);   /*smiaRegs_rw_sub_sample_y_odd_inc*/
-    write_cmos_sensor(0x0384,0x0001);   /*smiaRegs_rw_sub_sample_y_even_inc*/
-    write_cmos_sensor_8(0x0900,0x00);   /*smiaRegs_rw_binning_mode*/
-    write_cmos_sensor_8(0x0901,0x11);   /*smiaRegs_rw_binning_type*/
-    write_cmos_sensor(0x0400,0x0000);   /*smiaRegs_rw_scaling_scaling_mode*/
-    write_cmos_sensor(0x0404,0x0010);   /*smiaRegs_rw_scaling_scale_m*/
-    write_cmos_sensor_8(0x0114,0x03);
-    write_cmos_sensor_8(0x0111,0x02);   /*smiaRegs_rw_output_signalling_mode*/
-    write_cmos_sensor(0x0136,0x1800);
-    write_cmos_sensor(0x0304,0x0006);
-    write_cmos_sensor(0x0306,0x0058);   //smiaRegs_rw_clocks_pll_multiplier // 175
-    write_cmos_sensor(0x0302,0x0001);   //smiaRegs_rw_clocks_vt_pix_clk_div
-    write_cmos_sensor(0x0300,0x0005);   //smiaRegs_rw_clocks_vt_sys_clk_div
-    write_cmos_sensor(0x030C,0x0004);   //smiaRegs_rw_clocks_secnd_pre_pll_clk_div
-    write_cmos_sensor(0x030E,0x003C);   //smiaRegs_rw_clocks_secnd_pll_multiplier // 50
-    write_cmos_sensor(0x030A,0x0001);   //smiaRegs_rw_clocks_op_sys_clk_div
-    write_cmos_sensor(0x0308,0x0008);   //smiaRegs_rw_clocks_op_pix_clk_div
-    write_cmos_sensor(0x1118,0x4100);
-    write_cmos_sensor(0x1124,0x4100);
-    write_cmos_sensor(0x112C,0x4100);
-    write_cmos_sensor(0x1164,0x4100);
-    write_cmos_sensor(0x1170,0x4100);
-    write_cmos_sensor(0x301C,0x4100);
-    write_cmos_sensor(0x0342,0x16F8);   //smiaRegs_rw_frame_timing_line_length_pck // 3216
-    write_cmos_sensor(0x0340,0x0C66);   //smiaRegs_rw_frame_timing_frame_length_lines // 580
-    write_cmos_sensor(0x0200,0x0100);   //smiaRegs_rw_integration_time_fine_integration_time
-    write_cmos_sensor(0x0202,0x0100);   //smiaRegs_rw_integration_time_coarse_integration_time
-    write_cmos_sensor_8(0x0216,0x00);   //smiaRegs_rw_wdr_multiple_exp_mode
-    write_cmos_sensor_8(0x3054,0x01);   //smiaRegs_vendor_sensor_enable_af_pixels
-    write_cmos_sensor(0x3A6A,0x8000);
-    write_cmos_sensor_8(0x3A6B,0x00);
-    write_cmos_sensor_8(0x39BB,0x02);
-    write_cmos_sensor_8(0x3005,0x05);
-    write_cmos_sensor(0x3A58,0x0061);
-    write_cmos_sensor_8(0x39E3,0x02);
-    write_cmos_sensor(0x3238,0x0219);   // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
-    write_cmos_sensor(0x324A,0x00DE);   // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
-    write_cmos_sensor(0x3250,0x011F);    //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
-    write_cmos_sensor(0x3274,0x013E);    //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
-    write_cmos_sensor(0x32C2,0x011F);    //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
-    write_cmos_sensor(0x32C8,0x0140);   // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
-    write_cmos_sensor(0x32DA,0x011F);   // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
-    write_cmos_sensor(0x32E0,0x0120);  //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
-    write_cmos_sensor(0x35FE,0x0078);  //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
-    write_cmos_sensor(0x37C6,0x0083);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
-    write_cmos_sensor(0x37CC,0x005D);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
-    write_cmos_sensor(0x37D2,0x0057);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
-    write_cmos_sensor(0x37DE,0x0081);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
-    write_cmos_sensor(0x37E4,0x005F);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
-    write_cmos_sensor(0x37EA,0x0055);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
-    write_cmos_sensor(0x37F6,0x0081);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
-    write_cmos_sensor(0x37FC,0x005F);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
-    write_cmos_sensor(0x3802,0x0055);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
-    write_cmos_sensor(0x6028,0x2000);
-    write_cmos_sensor(0x602A,0x15b8);
-    write_cmos_sensor(0x6F12,0x8011);
-    write_cmos_sensor(0x3140,0x0FE2);
-    write_cmos_sensor_8(0x31B5,0x00);
-    write_cmos_sensor(0x6028,0x2000);
-    write_cmos_sensor(0x602A,0x1760);
-    write_cmos_sensor_8(0x6F12,0x01);
-    write_cmos_sensor(0x6F12,0x0048);
-    write_cmos_sensor(0x6F12,0x0050);
-    write_cmos_sensor(0x6F12,0x0060);
-    write_cmos_sensor(0x6F12,0x0060);
-    write_cmos_sensor(0x6F12,0xF42E);
-    write_cmos_sensor(0x6F12,0x006D);
-    write_cmos_sensor(0x6F12,0x006A);
-    write_cmos_sensor(0x6F12,0xF51E);
-
-    write_cmos_sensor(0x0100,0x0100);   //smiaRegs_rw_general_setup // Stream on
+    write_cmos_sensor_table(pip_capture_15fps_setting_regs);
 
 }
 
@@ -2081,123 +2122,205 @@ static void normal_video_setting(kal_uint16 currefps)
 	normal_capture_setting();
 
 }
+#ifdef SLOW_MOTION_120FPS
+static const KD_SENSOR_REG hs_video_setting_regs[] = {
+	KD_SENSOR_REG16(0x0100, 0x0000),
+	KD_SENSOR_REG16(0x0344, 0x0014), //smiaRegs_rw_frame_timing_x_addr_start
+	KD_SENSOR_REG16(0x0346, 0x000C), //smiaRegs_rw_frame_timing_y_addr_start
+	KD_SENSOR_REG16(0x0348, 0x14D3), //smiaRegs_rw_frame_timing_x_addr_end
+	KD_SENSOR_REG16(0x034A, 0x0BBB), //smiaRegs_rw_frame_timing_y_addr_end
+	KD_SENSOR_REG16(0x034C, 0x0530), //smiaRegs_rw_frame_timing_x_output_size
+	KD_SENSOR_REG16(0x034E, 0x02EC), //smiaRegs_rw_frame_timing_y_output_size
+	KD_SENSOR_REG16(0x0382, 0x0001), //smiaRegs_rw_sub_sample_x_odd_inc
+	KD_SENSOR_REG16(0x0380, 0x0001), //smiaRegs_rw_sub_sample_x_even_inc
+	KD_SENSOR_REG16(0x0386, 0x0007), //smiaRegs_rw_sub_sample_y_odd_inc
+	KD_SENSOR_REG16(0x0384, 0x0001), //smiaRegs_rw_sub_sample_y_even_inc
+	KD_SENSOR_REG8(0x0900, 0x01), //smiaRegs_rw_binning_mode
+	KD_SENSOR_REG8(0x0901, 0x14), //smiaRegs_rw_binning_type
+	KD_SENSOR_REG16(0x0400, 0x0001), //smiaRegs_rw_scaling_scaling_mode
+	KD_SENSOR_REG16(0x0404, 0x0040), //smiaRegs_rw_scaling_scale_m
+	KD_SENSOR_REG8(0x0114, 0x03), //smiaRegs_rw_output_signalling_mode
+	KD_SENSOR_REG8(0x0111, 0x02), //smiaRegs_rw_output_signalling_mode
+	KD_SENSOR_REG16(0x0136, 0x1800), //smiaRegs_rw_op_cond_extclk_frequency_mhz
+	KD_SENSOR_REG16(0x0304, 0x0006), //smiaRegs_rw_clocks_pre_pll_clk_div
+	KD_SENSOR_REG16(0x0306, 0x00AF), //smiaRegs_rw_clocks_pll_multiplier // 175
+	KD_SENSOR_REG16(0x0300, 0x0005), //smiaRegs_rw_clocks_vt_pix_clk_div
+	KD_SENSOR_REG16(0x0302, 0x0001), //smiaRegs_rw_clocks_vt_sys_clk_div
+	KD_SENSOR_REG16(0x030C, 0x0004), //smiaRegs_rw_clocks_secnd_pre_pll_clk_div
+	KD_SENSOR_REG16(0x030E, 0x0032), //smiaRegs_rw_clocks_secnd_pll_multiplier // 50
+	KD_SENSOR_REG16(0x030A, 0x0001), //smiaRegs_rw_clocks_op_sys_clk_div
+	KD_SENSOR_REG16(0x0308, 0x0008), //smiaRegs_rw_clocks_op_pix_clk_div
+	KD_SENSOR_REG16(0x1118, 0x43FA),
+	KD_SENSOR_REG16(0x1124, 0x43FA),
+	KD_SENSOR_REG16(0x112C, 0x42C0),
+	KD_SENSOR_REG16(0x1164, 0x4280),
+	KD_SENSOR_REG16(0x1170, 0x4100),
+	KD_SENSOR_REG16(0x301C, 0x4396),
+	KD_SENSOR_REG16(0x0342, 0x16F8), //smiaRegs_rw_frame_timing_line_length_pck // 3216
+	KD_SENSOR_REG16(0x0340, 0x0319), //smiaRegs_rw_frame_timing_frame_length_lines // 580
+	KD_SENSOR_REG16(0x0200, 0x0100), //smiaRegs_rw_integration_time_fine_integration_time
+	KD_SENSOR_REG16(0x0202, 0x0100), //smiaRegs_rw_integration_time_coarse_integration_time
+	KD_SENSOR_REG8(0x0216, 0x00), //smiaRegs_rw_wdr_multiple_exp_mode
+	KD_SENSOR_REG8(0x3054, 0x00), //smiaRegs_vendor_sensor_enable_af_pixels
+	KD_SENSOR_REG16(0x306A, 0x8220),
+	KD_SENSOR_REG8(0x3A6B, 0x00),
+	KD_SENSOR_REG8(0x39BB, 0x02),
+	KD_SENSOR_REG8(0x3005, 0x05),
+	KD_SENSOR_REG16(0x3A58, 0x0060),
+	KD_SENSOR_REG8(0x39E3, 0x02),
+	KD_SENSOR_REG16(0x3238, 0x0219), // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
+	KD_SENSOR_REG16(0x324A, 0x00E2), // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
+	KD_SENSOR_REG16(0x3250, 0x0114), //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
+	KD_SENSOR_REG16(0x3274, 0x013B), //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
+	KD_SENSOR_REG16(0x32C2, 0x0114), //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
+	KD_SENSOR_REG16(0x32C8, 0x012D), // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
+	KD_SENSOR_REG16(0x32DA, 0x0114), // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
+	KD_SENSOR_REG16(0x32E0, 0x0115), //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
+	KD_SENSOR_REG16(0x35FE, 0x007A), //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
+	KD_SENSOR_REG16(0x37C6, 0x0073), // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
+	KD_SENSOR_REG16(0x37CC, 0x0054), //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
+	KD_SENSOR_REG16(0x37D2, 0x0048), // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
+	KD_SENSOR_REG16(0x37DE, 0x0071), // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
+	KD_SENSOR_REG16(0x37E4, 0x0056), // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
+	KD_SENSOR_REG16(0x37EA, 0x0046), // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
+	KD_SENSOR_REG16(0x37F6, 0x0071), // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
+	KD_SENSOR_REG16(0x37FC, 0x0056), // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
+	KD_SENSOR_REG16(0x3802, 0x0046), //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x15b8),
+	KD_SENSOR_REG16(0x6F12, 0x8111),
+	KD_SENSOR_REG16(0x3140, 0x0F21),
+	KD_SENSOR_REG8(0x31B5, 0x01),
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x1760),
+	KD_SENSOR_REG8(0x6F12, 0x01),
+	KD_SENSOR_REG16(0x6F12, 0x0048),
+	KD_SENSOR_REG16(0x6F12, 0x0050),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0xF42E),
+	KD_SENSOR_REG16(0x6F12, 0x006D),
+	KD_SENSOR_REG16(0x6F12, 0x006A),
+	KD_SENSOR_REG16(0x6F12, 0xF51E),
+	KD_SENSOR_REG16(0x0100, 0x0100), //smiaRegs_rw_general_setup // Stream on
+	KD_SENSOR_REG_DELAY(100),
+	KD_SENSOR_REG16(0x3A70, 0x0000),
+	KD_SENSOR_REG16(0x3A72, 0x0000),
+	KD_SENSOR_REG16(0x3A74, 0x0000),
+	KD_SENSOR_REG16(0x3A76, 0x0000),
+	KD_SENSOR_REG16(0x3A78, 0x0000),
+	KD_SENSOR_REG16(0x3A7A, 0x0000),
+	KD_SENSOR_REG16(0x3A7C, 0x0000),
+	KD_SENSOR_REG16(0x3A7E, 0x0000),
+	KD_SENSOR_REG16(0x3A80, 0x0000),
+	KD_SENSOR_REG16(0x3A82, 0x0000),
+	KD_SENSOR_REG16(0x3A84, 0x0000),
+	KD_SENSOR_REG16(0x3A86, 0x0000),
+	KD_SENSOR_REG16(0x3A88, 0x0000),
+	KD_SENSOR_REG16(0x3A8A, 0x0000),
+	KD_SENSOR_REG16(0x3A8C, 0x0000),
+	KD_SENSOR_REG16(0x3A8E, 0x0000),
+	KD_SENSOR_REG16(0x3AB2, 0x0000),
+	KD_SENSOR_REG16(0x3AB4, 0x0000),
+	KD_SENSOR_REG16(0x3AB6, 0x0000),
+	KD_SENSOR_REG16(0x3AB8, 0x0000),
+	KD_SENSOR_REG16(0x3ABA, 0x0000),
+	KD_SENSOR_REG16(0x3ABC, 0x0000),
+	KD_SENSOR_REG16(0x3ABE, 0x0000),
+	KD_SENSOR_REG16(0x3AC0, 0x0000),
+	KD_SENSOR_REG16(0x3AC2, 0x0000),
+	KD_SENSOR_REG16(0x3AC4, 0x0000),
+	KD_SENSOR_REG16(0x3AC6, 0x0000),
+	KD_SENSOR_REG16(0x3AC8, 0x0000),
+	KD_SENSOR_REG16(0x3ACA, 0x0000),
+	KD_SENSOR_REG16(0x3ACC, 0x0000),
+	KD_SENSOR_REG16(0x3ACE, 0x0000),
+};
+#endif
+
+#ifndef SLOW_MOTION_120FPS
+static const KD_SENSOR_REG hs_video_setting_regs_2[] = {
+	KD_SENSOR_REG16(0x0382, 0x0003), //smiaRegs_rw_sub_sample_x_odd_inc
+	KD_SENSOR_REG16(0x0380, 0x0001), //smiaRegs_rw_sub_sample_x_even_inc
+	KD_SENSOR_REG16(0x0386, 0x0003), //smiaRegs_rw_sub_sample_y_odd_inc
+	KD_SENSOR_REG16(0x0384, 0x0001), //smiaRegs_rw_sub_sample_y_even_inc
+	KD_SENSOR_REG8(0x0900, 0x01), //smiaRegs_rw_binning_mode
+	KD_SENSOR_REG8(0x0901, 0x22), //smiaRegs_rw_binning_type
+	KD_SENSOR_REG16(0x0400, 0x0000), //smiaRegs_rw_scaling_scaling_mode
+	KD_SENSOR_REG16(0x0404, 0x0010), //smiaRegs_rw_scaling_scale_m
+	KD_SENSOR_REG8(0x0114, 0x03),
+	KD_SENSOR_REG8(0x0111, 0x02), //smiaRegs_rw_output_signalling_mode
+	KD_SENSOR_REG16(0x0136, 0x1800), //smiaRegs_rw_op_cond_extclk_frequency_mhz
+	KD_SENSOR_REG16(0x0304, 0x0006), //smiaRegs_rw_clocks_pre_pll_clk_div
+	KD_SENSOR_REG16(0x0306, 0x00AF), //smiaRegs_rw_clocks_pll_multiplier // 175
+	KD_SENSOR_REG16(0x0300, 0x0005), //smiaRegs_rw_clocks_vt_pix_clk_div
+	KD_SENSOR_REG16(0x0302, 0x0001), //smiaRegs_rw_clocks_vt_sys_clk_div
+	KD_SENSOR_REG16(0x030C, 0x0004), //smiaRegs_rw_clocks_secnd_pre_pll_clk_div
+	KD_SENSOR_REG16(0x030E, 0x004A), //smiaRegs_rw_clocks_secnd_pll_multiplier // 50
+	KD_SENSOR_REG16(0x030A, 0x0001), //smiaRegs_rw_clocks_op_sys_clk_div
+	KD_SENSOR_REG16(0x0308, 0x0008), //smiaRegs_rw_clocks_op_pix_clk_div
+	KD_SENSOR_REG16(0x1118, 0x43FA),
+	KD_SENSOR_REG16(0x1124, 0x43FA),
+	KD_SENSOR_REG16(0x112C, 0x42C0),
+	KD_SENSOR_REG16(0x1164, 0x4280),
+	KD_SENSOR_REG16(0x1170, 0x4100),
+	KD_SENSOR_REG16(0x301C, 0x4396),
+	KD_SENSOR_REG16(0x0342, 0x16F8), //smiaRegs_rw_frame_timing_line_length_pck // 3216
+	KD_SENSOR_REG16(0x0340, 0x0633), //smiaRegs_rw_frame_timing_frame_length_lines // 580
+	KD_SENSOR_REG16(0x0200, 0x0100), //smiaRegs_rw_integration_time_fine_integration_time
+	KD_SENSOR_REG16(0x0202, 0x0100), //smiaRegs_rw_integration_time_coarse_integration_time
+	KD_SENSOR_REG8(0x0216, 0x00), //smiaRegs_rw_wdr_multiple_exp_mode
+	KD_SENSOR_REG8(0x3054, 0x00), //smiaRegs_vendor_sensor_enable_af_pixels
+	KD_SENSOR_REG16(0x306A, 0x8110),
+	KD_SENSOR_REG8(0x3A6B, 0x00),
+	KD_SENSOR_REG8(0x39BB, 0x02),
+	KD_SENSOR_REG16(0x3A58, 0x0060),
+	KD_SENSOR_REG8(0x39E3, 0x02),
+	KD_SENSOR_REG16(0x3238, 0x0219), // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
+	KD_SENSOR_REG16(0x324A, 0x00E2), // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
+	KD_SENSOR_REG16(0x3250, 0x0114), //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
+	KD_SENSOR_REG16(0x3274, 0x013B), //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
+	KD_SENSOR_REG16(0x32C2, 0x0114), //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
+	KD_SENSOR_REG16(0x32C8, 0x012D), // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
+	KD_SENSOR_REG16(0x32DA, 0x0114), // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
+	KD_SENSOR_REG16(0x32E0, 0x0115), //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
+	KD_SENSOR_REG16(0x35FE, 0x007A), //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
+	KD_SENSOR_REG16(0x37C6, 0x0073), // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
+	KD_SENSOR_REG16(0x37CC, 0x0054), //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
+	KD_SENSOR_REG16(0x37D2, 0x0048), // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
+	KD_SENSOR_REG16(0x37DE, 0x0071), // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
+	KD_SENSOR_REG16(0x37E4, 0x0056), // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
+	KD_SENSOR_REG16(0x37EA, 0x0046), // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
+	KD_SENSOR_REG16(0x37F6, 0x0071), // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
+	KD_SENSOR_REG16(0x37FC, 0x0056), // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
+	KD_SENSOR_REG16(0x3802, 0x0046), //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x15b8),
+	KD_SENSOR_REG16(0x6F12, 0x8011),
+	KD_SENSOR_REG16(0x3140, 0x0FE2),
+	KD_SENSOR_REG8(0x31B5, 0x00),
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x1760),
+	KD_SENSOR_REG8(0x6F12, 0x01),
+	KD_SENSOR_REG16(0x6F12, 0x0048),
+	KD_SENSOR_REG16(0x6F12, 0x0050),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0xF42E),
+	KD_SENSOR_REG16(0x6F12, 0x006D),
+	KD_SENSOR_REG16(0x6F12, 0x006A),
+	KD_SENSOR_REG16(0x6F12, 0xF51E),
+	KD_SENSOR_REG16(0x0100, 0x0100), //smiaRegs_rw_general_setup // Stream on
+};
+#endif
+
 static void hs_video_setting(void)
 {
 int retry=0;
 	LOG_INF("E");
 #ifdef SLOW_MOTION_120FPS
 	LOG_INF("slow motion fps:120fps");
-	write_cmos_sensor(0x0100,0x0000);
-	write_cmos_sensor(0x0344,0x0014);	//smiaRegs_rw_frame_timing_x_addr_start
-	write_cmos_sensor(0x0346,0x000C);	//smiaRegs_rw_frame_timing_y_addr_start
-	write_cmos_sensor(0x0348,0x14D3);	//smiaRegs_rw_frame_timing_x_addr_end
-	write_cmos_sensor(0x034A,0x0BBB);	//smiaRegs_rw_frame_timing_y_addr_end
-	write_cmos_sensor(0x034C,0x0530);	//smiaRegs_rw_frame_timing_x_output_size
-	write_cmos_sensor(0x034E,0x02EC);	//smiaRegs_rw_frame_timing_y_output_size
-	write_cmos_sensor(0x0382,0x0001);	//smiaRegs_rw_sub_sample_x_odd_inc
-	write_cmos_sensor(0x0380,0x0001);	//smiaRegs_rw_sub_sample_x_even_inc
-	write_cmos_sensor(0x0386,0x0007);	//smiaRegs_rw_sub_sample_y_odd_inc
-	write_cmos_sensor(0x0384,0x0001);	//smiaRegs_rw_sub_sample_y_even_inc
-	write_cmos_sensor_8(0x0900,0x01);	//smiaRegs_rw_binning_mode
-	write_cmos_sensor_8(0x0901,0x14);	//smiaRegs_rw_binning_type
-	write_cmos_sensor(0x0400,0x0001);	//smiaRegs_rw_scaling_scaling_mode
-	write_cmos_sensor(0x0404,0x0040);	//smiaRegs_rw_scaling_scale_m
-	write_cmos_sensor_8(0x0114,0x03);	//smiaRegs_rw_output_signalling_mode
-	write_cmos_sensor_8(0x0111,0x02);	//smiaRegs_rw_output_signalling_mode
-	write_cmos_sensor(0x0136,0x1800);	//smiaRegs_rw_op_cond_extclk_frequency_mhz
-	write_cmos_sensor(0x0304,0x0006);	//smiaRegs_rw_clocks_pre_pll_clk_div
-	write_cmos_sensor(0x0306,0x00AF);	//smiaRegs_rw_clocks_pll_multiplier // 175
-	write_cmos_sensor(0x0300,0x0005);	//smiaRegs_rw_clocks_vt_pix_clk_div
-	write_cmos_sensor(0x0302,0x0001);	//smiaRegs_rw_clocks_vt_sys_clk_div
-	write_cmos_sensor(0x030C,0x0004);	//smiaRegs_rw_clocks_secnd_pre_pll_clk_div
-	write_cmos_sensor(0x030E,0x0032);	//smiaRegs_rw_clocks_secnd_pll_multiplier // 50
-	write_cmos_sensor(0x030A,0x0001);	//smiaRegs_rw_clocks_op_sys_clk_div
-	write_cmos_sensor(0x0308,0x0008);	//smiaRegs_rw_clocks_op_pix_clk_div
-	write_cmos_sensor(0x1118,0x43FA);
-	write_cmos_sensor(0x1124,0x43FA);
-	write_cmos_sensor(0x112C,0x42C0);
-	write_cmos_sensor(0x1164,0x4280);
-	write_cmos_sensor(0x1170,0x4100);
-	write_cmos_sensor(0x301C,0x4396);
-	write_cmos_sensor(0x0342,0x16F8);	//smiaRegs_rw_frame_timing_line_length_pck // 3216
-	write_cmos_sensor(0x0340,0x0319);	//smiaRegs_rw_frame_timing_frame_length_lines // 580
-	write_cmos_sensor(0x0200,0x0100);	//smiaRegs_rw_integration_time_fine_integration_time
-	write_cmos_sensor(0x0202,0x0100);	//smiaRegs_rw_integration_time_coarse_integration_time
-	write_cmos_sensor_8(0x0216,0x00);	//smiaRegs_rw_wdr_multiple_exp_mode
-	write_cmos_sensor_8(0x3054,0x00);	//smiaRegs_vendor_sensor_enable_af_pixels
-	write_cmos_sensor(0x306A,0x8220);
-	write_cmos_sensor_8(0x3A6B,0x00);
-	write_cmos_sensor_8(0x39BB,0x02);
-	write_cmos_sensor_8(0x3005,0x05);
-	write_cmos_sensor(0x3A58,0x0060);
-	write_cmos_sensor_8(0x39E3,0x02);
-	write_cmos_sensor(0x3238,0x0219);   // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
-	write_cmos_sensor(0x324A,0x00E2);   // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
-	write_cmos_sensor(0x3250,0x0114);    //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
-	write_cmos_sensor(0x3274,0x013B);    //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
-	write_cmos_sensor(0x32C2,0x0114);    //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
-	write_cmos_sensor(0x32C8,0x012D);   // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
-	write_cmos_sensor(0x32DA,0x0114);   // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
-	write_cmos_sensor(0x32E0,0x0115);  //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
-	write_cmos_sensor(0x35FE,0x007A);  //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
-	write_cmos_sensor(0x37C6,0x0073);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
-	write_cmos_sensor(0x37CC,0x0054);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
-	write_cmos_sensor(0x37D2,0x0048);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
-	write_cmos_sensor(0x37DE,0x0071);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
-	write_cmos_sensor(0x37E4,0x0056);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
-	write_cmos_sensor(0x37EA,0x0046);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
-	write_cmos_sensor(0x37F6,0x0071);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
-	write_cmos_sensor(0x37FC,0x0056);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
-	write_cmos_sensor(0x3802,0x0046);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x15b8);
-	write_cmos_sensor(0x6F12,0x8111);
-	write_cmos_sensor(0x3140,0x0F21);
-	write_cmos_sensor_8(0x31B5,0x01);
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x1760);
-	write_cmos_sensor_8(0x6F12,0x01);
-	write_cmos_sensor(0x6F12,0x0048);
-	write_cmos_sensor(0x6F12,0x0050);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0xF42E);
-	write_cmos_sensor(0x6F12,0x006D);
-	write_cmos_sensor(0x6F12,0x006A);
-	write_cmos_sensor(0x6F12,0xF51E);
-	write_cmos_sensor(0x0100,0x0100);	//smiaRegs_rw_general_setup // Stream on
-	mdelay(100);
-	write_cmos_sensor(0x3A70,0x0000);
-	write_cmos_sensor(0x3A72,0x0000);
-	write_cmos_sensor(0x3A74,0x0000);
-	write_cmos_sensor(0x3A76,0x0000);
-	write_cmos_sensor(0x3A78,0x0000);
-	write_cmos_sensor(0x3A7A,0x0000);
-	write_cmos_sensor(0x3A7C,0x0000);
-	write_cmos_sensor(0x3A7E,0x0000);
-	write_cmos_sensor(0x3A80,0x0000);
-	write_cmos_sensor(0x3A82,0x0000);
-	write_cmos_sensor(0x3A84,0x0000);
-	write_cmos_sensor(0x3A86,0x0000);
-	write_cmos_sensor(0x3A88,0x0000);
-	write_cmos_sensor(0x3A8A,0x0000);
-	write_cmos_sensor(0x3A8C,0x0000);
-	write_cmos_sensor(0x3A8E,0x0000);
-	write_cmos_sensor(0x3AB2,0x0000);
-	write_cmos_sensor(0x3AB4,0x0000);
-	write_cmos_sensor(0x3AB6,0x0000);
-	write_cmos_sensor(0x3AB8,0x0000);
-	write_cmos_sensor(0x3ABA,0x0000);
-	write_cmos_sensor(0x3ABC,0x0000);
-	write_cmos_sensor(0x3ABE,0x0000);
-	write_cmos_sensor(0x3AC0,0x0000);
-	write_cmos_sensor(0x3AC2,0x0000);
-	write_cmos_sensor(0x3AC4,0x0000);
-	write_cmos_sensor(0x3AC6,0x0000);
-	write_cmos_sensor(0x3AC8,0x0000);
-	write_cmos_sensor(0x3ACA,0x0000);
-	write_cmos_sensor(0x3ACC,0x0000);
-	write_cmos_sensor(0x3ACE,0x0000);
+	write_cmos_sensor_table(hs_video_setting_regs);
 #else
 	write_cmos_sensor(0x0100,0x0000);
 #ifdef FIX_VIEW_ANGLE
@@ -2215,77 +2338,7 @@ int retry=0;
     write_cmos_sensor(0x034C,0x0A68);   /*smiaRegs_rw_frame_timing_x_output_size*/
 	write_cmos_sensor(0x034E,0x05DC);	//smiaRegs_rw_frame_timing_y_output_size
 #endif
-	write_cmos_sensor(0x0382,0x0003);	//smiaRegs_rw_sub_sample_x_odd_inc
-	write_cmos_sensor(0x0380,0x0001);	//smiaRegs_rw_sub_sample_x_even_inc
-	write_cmos_sensor(0x0386,0x0003);	//smiaRegs_rw_sub_sample_y_odd_inc
-	write_cmos_sensor(0x0384,0x0001);	//smiaRegs_rw_sub_sample_y_even_inc
-	write_cmos_sensor_8(0x0900,0x01);	//smiaRegs_rw_binning_mode
-	write_cmos_sensor_8(0x0901,0x22);	//smiaRegs_rw_binning_type
-	write_cmos_sensor(0x0400,0x0000);	//smiaRegs_rw_scaling_scaling_mode
-	write_cmos_sensor(0x0404,0x0010);	//smiaRegs_rw_scaling_scale_m
-	write_cmos_sensor_8(0x0114,0x03);
-	write_cmos_sensor_8(0x0111,0x02);	//smiaRegs_rw_output_signalling_mode
-	write_cmos_sensor(0x0136,0x1800);	//smiaRegs_rw_op_cond_extclk_frequency_mhz
-	write_cmos_sensor(0x0304,0x0006);	//smiaRegs_rw_clocks_pre_pll_clk_div
-	write_cmos_sensor(0x0306,0x00AF);	//smiaRegs_rw_clocks_pll_multiplier // 175
-	write_cmos_sensor(0x0300,0x0005);	//smiaRegs_rw_clocks_vt_pix_clk_div
-	write_cmos_sensor(0x0302,0x0001);	//smiaRegs_rw_clocks_vt_sys_clk_div
-	write_cmos_sensor(0x030C,0x0004);	//smiaRegs_rw_clocks_secnd_pre_pll_clk_div
-	write_cmos_sensor(0x030E,0x004A);	//smiaRegs_rw_clocks_secnd_pll_multiplier // 50
-	write_cmos_sensor(0x030A,0x0001);	//smiaRegs_rw_clocks_op_sys_clk_div
-	write_cmos_sensor(0x0308,0x0008);	//smiaRegs_rw_clocks_op_pix_clk_div
-	write_cmos_sensor(0x1118,0x43FA);
-	write_cmos_sensor(0x1124,0x43FA);
-	write_cmos_sensor(0x112C,0x42C0);
-	write_cmos_sensor(0x1164,0x4280);
-	write_cmos_sensor(0x1170,0x4100);
-	write_cmos_sensor(0x301C,0x4396);
-	write_cmos_sensor(0x0342,0x16F8);	//smiaRegs_rw_frame_timing_line_length_pck // 3216
-	write_cmos_sensor(0x0340,0x0633);	//smiaRegs_rw_frame_timing_frame_length_lines // 580
-	write_cmos_sensor(0x0200,0x0100);	//smiaRegs_rw_integration_time_fine_integration_time
-	write_cmos_sensor(0x0202,0x0100);	//smiaRegs_rw_integration_time_coarse_integration_time
-	write_cmos_sensor_8(0x0216,0x00);	//smiaRegs_rw_wdr_multiple_exp_mode
-	write_cmos_sensor_8(0x3054,0x00);	//smiaRegs_vendor_sensor_enable_af_pixels
-	write_cmos_sensor(0x306A,0x8110);
-	write_cmos_sensor_8(0x3A6B,0x00);
-	write_cmos_sensor_8(0x39BB,0x02);
-	write_cmos_sensor(0x3A58,0x0060);
-	write_cmos_sensor_8(0x39E3,0x02);
-	write_cmos_sensor(0x3238,0x0219);   // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
-	write_cmos_sensor(0x324A,0x00E2);   // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
-	write_cmos_sensor(0x3250,0x0114);    //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
-	write_cmos_sensor(0x3274,0x013B);    //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
-	write_cmos_sensor(0x32C2,0x0114);    //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
-	write_cmos_sensor(0x32C8,0x012D);   // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
-	write_cmos_sensor(0x32DA,0x0114);   // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
-	write_cmos_sensor(0x32E0,0x0115);  //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
-	write_cmos_sensor(0x35FE,0x007A);  //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
-	write_cmos_sensor(0x37C6,0x0073);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
-	write_cmos_sensor(0x37CC,0x0054);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
-	write_cmos_sensor(0x37D2,0x0048);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
-	write_cmos_sensor(0x37DE,0x0071);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
-	write_cmos_sensor(0x37E4,0x0056);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
-	write_cmos_sensor(0x37EA,0x0046);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
-	write_cmos_sensor(0x37F6,0x0071);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
-	write_cmos_sensor(0x37FC,0x0056);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
-	write_cmos_sensor(0x3802,0x0046);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x15b8);
-	write_cmos_sensor(0x6F12,0x8011);
-	write_cmos_sensor(0x3140,0x0FE2);
-	write_cmos_sensor_8(0x31B5,0x00);
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x1760);
-	write_cmos_sensor_8(0x6F12,0x01);
-	write_cmos_sensor(0x6F12,0x0048);
-	write_cmos_sensor(0x6F12,0x0050);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0xF42E);
-	write_cmos_sensor(0x6F12,0x006D);
-	write_cmos_sensor(0x6F12,0x006A);
-	write_cmos_sensor(0x6F12,0xF51E);
-	write_cmos_sensor(0x0100,0x0100);	//smiaRegs_rw_general_setup // Stream on
+	write_cmos_sensor_table(hs_video_setting_regs_2);
 //	mdelay(100);
 //	write_cmos_sensor(0x3A70,0x0000);
 //	write_cmos_sensor(0x3A72,0x0000);
@@ -2335,90 +2388,94 @@ while(retry<10)
 	   }
 }
 
+static const KD_SENSOR_REG slim_video_setting_regs[] = {
+	KD_SENSOR_REG16(0x0100, 0x0000),
+	KD_SENSOR_REG16(0x0344, 0x0014), //smiaRegs_rw_frame_timing_x_addr_start
+	KD_SENSOR_REG16(0x0346, 0x000C), //smiaRegs_rw_frame_timing_y_addr_start
+	KD_SENSOR_REG16(0x0348, 0x14D3), //smiaRegs_rw_frame_timing_x_addr_end
+	KD_SENSOR_REG16(0x034A, 0x0BBB), //smiaRegs_rw_frame_timing_y_addr_end
+	KD_SENSOR_REG16(0x034C, 0x0530), //smiaRegs_rw_frame_timing_x_output_size
+	KD_SENSOR_REG16(0x034E, 0x02EC), //smiaRegs_rw_frame_timing_y_output_size
+	KD_SENSOR_REG16(0x0382, 0x0001), //smiaRegs_rw_sub_sample_x_odd_inc
+	KD_SENSOR_REG16(0x0380, 0x0001), //smiaRegs_rw_sub_sample_x_even_inc
+	KD_SENSOR_REG16(0x0386, 0x0007), //smiaRegs_rw_sub_sample_y_odd_inc
+	KD_SENSOR_REG16(0x0384, 0x0001), //smiaRegs_rw_sub_sample_y_even_inc
+	KD_SENSOR_REG8(0x0900, 0x01), //smiaRegs_rw_binning_mode
+	KD_SENSOR_REG8(0x0901, 0x14), //smiaRegs_rw_binning_type
+	KD_SENSOR_REG16(0x0400, 0x0001), //smiaRegs_rw_scaling_scaling_mode
+	KD_SENSOR_REG16(0x0404, 0x0040), //smiaRegs_rw_scaling_scale_m
+	KD_SENSOR_REG8(0x0114, 0x03), //smiaRegs_rw_output_signalling_mode
+	KD_SENSOR_REG8(0x0111, 0x02), //smiaRegs_rw_output_signalling_mode
+	KD_SENSOR_REG16(0x0136, 0x1800), //smiaRegs_rw_op_cond_extclk_frequency_mhz
+	KD_SENSOR_REG16(0x0304, 0x0006), //smiaRegs_rw_clocks_pre_pll_clk_div
+	KD_SENSOR_REG16(0x0306, 0x00AF), //smiaRegs_rw_clocks_pll_multiplier // 175
+	KD_SENSOR_REG16(0x0300, 0x0005), //smiaRegs_rw_clocks_vt_pix_clk_div
+	KD_SENSOR_REG16(0x0302, 0x0001), //smiaRegs_rw_clocks_vt_sys_clk_div
+	KD_SENSOR_REG16(0x030C, 0x0004), //smiaRegs_rw_clocks_secnd_pre_pll_clk_div
+	KD_SENSOR_REG16(0x030E, 0x0032), //smiaRegs_rw_clocks_secnd_pll_multiplier // 50
+	KD_SENSOR_REG16(0x030A, 0x0001), //smiaRegs_rw_clocks_op_sys_clk_div
+	KD_SENSOR_REG16(0x0308, 0x0008), //smiaRegs_rw_clocks_op_pix_clk_div
+	KD_SENSOR_REG16(0x1118, 0x43FA),
+	KD_SENSOR_REG16(0x1124, 0x43FA),
+	KD_SENSOR_REG16(0x112C, 0x42C0),
+	KD_SENSOR_REG16(0x1164, 0x4280),
+	KD_SENSOR_REG16(0x1170, 0x4100),
+	KD_SENSOR_REG16(0x301C, 0x4396),
+	KD_SENSOR_REG16(0x0342, 0x16F8), //smiaRegs_rw_frame_timing_line_length_pck // 3216
+	KD_SENSOR_REG16(0x0340, 0x0C64), //smiaRegs_rw_frame_timing_frame_length_lines // 580
+	KD_SENSOR_REG16(0x0200, 0x0100), //smiaRegs_rw_integration_time_fine_integration_time
+	KD_SENSOR_REG16(0x0202, 0x0100), //smiaRegs_rw_integration_time_coarse_integration_time
+	KD_SENSOR_REG8(0x0216, 0x00), //smiaRegs_rw_wdr_multiple_exp_mode
+	KD_SENSOR_REG8(0x3054, 0x00), //smiaRegs_vendor_sensor_enable_af_pixels
+	KD_SENSOR_REG16(0x306A, 0x8220),
+	KD_SENSOR_REG8(0x3A6B, 0x00),
+	KD_SENSOR_REG8(0x39BB, 0x02),
+	KD_SENSOR_REG8(0x3005, 0x05),
+	KD_SENSOR_REG16(0x3A58, 0x0060),
+	KD_SENSOR_REG8(0x39E3, 0x02),
+	KD_SENSOR_REG16(0x3238, 0x0219), // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
+	KD_SENSOR_REG16(0x324A, 0x00E2), // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
+	KD_SENSOR_REG16(0x3250, 0x0114), //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
+	KD_SENSOR_REG16(0x3274, 0x013B), //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
+	KD_SENSOR_REG16(0x32C2, 0x0114), //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
+	KD_SENSOR_REG16(0x32C8, 0x012D), // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
+	KD_SENSOR_REG16(0x32DA, 0x0114), // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
+	KD_SENSOR_REG16(0x32E0, 0x0115), //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
+	KD_SENSOR_REG16(0x35FE, 0x007A), //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
+	KD_SENSOR_REG16(0x37C6, 0x0073), // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
+	KD_SENSOR_REG16(0x37CC, 0x0054), //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
+	KD_SENSOR_REG16(0x37D2, 0x0048), // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
+	KD_SENSOR_REG16(0x37DE, 0x0071), // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
+	KD_SENSOR_REG16(0x37E4, 0x0056), // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
+	KD_SENSOR_REG16(0x37EA, 0x0046), // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
+	KD_SENSOR_REG16(0x37F6, 0x0071), // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
+	KD_SENSOR_REG16(0x37FC, 0x0056), // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
+	KD_SENSOR_REG16(0x3802, 0x0046), //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x15b8),
+	KD_SENSOR_REG16(0x6F12, 0x8111),
+	KD_SENSOR_REG16(0x3140, 0x0F21),
+	KD_SENSOR_REG8(0x31B5, 0x01),
+	KD_SENSOR_REG16(0x6028, 0x2000),
+	KD_SENSOR_REG16(0x602A, 0x1760),
+	KD_SENSOR_REG8(0x6F12, 0x01),
+	KD_SENSOR_REG16(0x6F12, 0x0048),
+	KD_SENSOR_REG16(0x6F12, 0x0050),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0x0060),
+	KD_SENSOR_REG16(0x6F12, 0xF42E),
+	KD_SENSOR_REG16(0x6F12, 0x006D),
+	KD_SENSOR_REG16(0x6F12, 0x006A),
+	KD_SENSOR_REG16(0x6F12, 0xF51E),
+
+	KD_SENSOR_REG16(0x0100, 0x0100), //smiaRegs_rw_general_setup // Stream on
+};
+
 static void slim_video_setting(void)
 {
 	LOG_INF("E");
 	//$MV1[mclk:24,width:1328,height:748,format:MIPI_RAW10,mipi_lane:4,mipi_hssettle:19,pvi_pclk_inverse:0]
-	write_cmos_sensor(0x0100,0x0000);
-	write_cmos_sensor(0x0344,0x0014);	//smiaRegs_rw_frame_timing_x_addr_start
-	write_cmos_sensor(0x0346,0x000C);	//smiaRegs_rw_frame_timing_y_addr_start
-	write_cmos_sensor(0x0348,0x14D3);	//smiaRegs_rw_frame_timing_x_addr_end
-	write_cmos_sensor(0x034A,0x0BBB);	//smiaRegs_rw_frame_timing_y_addr_end
-	write_cmos_sensor(0x034C,0x0530);	//smiaRegs_rw_frame_timing_x_output_size
-	write_cmos_sensor(0x034E,0x02EC);	//smiaRegs_rw_frame_timing_y_output_size
-	write_cmos_sensor(0x0382,0x0001);	//smiaRegs_rw_sub_sample_x_odd_inc
-	write_cmos_sensor(0x0380,0x0001);	//smiaRegs_rw_sub_sample_x_even_inc
-	write_cmos_sensor(0x0386,0x0007);	//smiaRegs_rw_sub_sample_y_odd_inc
-	write_cmos_sensor(0x0384,0x0001);	//smiaRegs_rw_sub_sample_y_even_inc
-	write_cmos_sensor_8(0x0900,0x01);	//smiaRegs_rw_binning_mode
-	write_cmos_sensor_8(0x0901,0x14);	//smiaRegs_rw_binning_type
-	write_cmos_sensor(0x0400,0x0001);	//smiaRegs_rw_scaling_scaling_mode
-	write_cmos_sensor(0x0404,0x0040);	//smiaRegs_rw_scaling_scale_m
-	write_cmos_sensor_8(0x0114,0x03);	//smiaRegs_rw_output_signalling_mode
-	write_cmos_sensor_8(0x0111,0x02);	//smiaRegs_rw_output_signalling_mode
-	write_cmos_sensor(0x0136,0x1800);	//smiaRegs_rw_op_cond_extclk_frequency_mhz
-	write_cmos_sensor(0x0304,0x0006);	//smiaRegs_rw_clocks_pre_pll_clk_div
-	write_cmos_sensor(0x0306,0x00AF);	//smiaRegs_rw_clocks_pll_multiplier // 175
-	write_cmos_sensor(0x0300,0x0005);	//smiaRegs_rw_clocks_vt_pix_clk_div
-	write_cmos_sensor(0x0302,0x0001);	//smiaRegs_rw_clocks_vt_sys_clk_div
-	write_cmos_sensor(0x030C,0x0004);	//smiaRegs_rw_clocks_secnd_pre_pll_clk_div
-	write_cmos_sensor(0x030E,0x0032);	//smiaRegs_rw_clocks_secnd_pll_multiplier // 50
-	write_cmos_sensor(0x030A,0x0001);	//smiaRegs_rw_clocks_op_sys_clk_div
-	write_cmos_sensor(0x0308,0x0008);	//smiaRegs_rw_clocks_op_pix_clk_div
-	write_cmos_sensor(0x1118,0x43FA);
-	write_cmos_sensor(0x1124,0x43FA);
-	write_cmos_sensor(0x112C,0x42C0);
-	write_cmos_sensor(0x1164,0x4280);
-	write_cmos_sensor(0x1170,0x4100);
-	write_cmos_sensor(0x301C,0x4396);
-	write_cmos_sensor(0x0342,0x16F8);	//smiaRegs_rw_frame_timing_line_length_pck // 3216
-	write_cmos_sensor(0x0340,0x0C64);	//smiaRegs_rw_frame_timing_frame_length_lines // 580
-	write_cmos_sensor(0x0200,0x0100);	//smiaRegs_rw_integration_time_fine_integration_time
-	write_cmos_sensor(0x0202,0x0100);	//smiaRegs_rw_integration_time_coarse_integration_time
-	write_cmos_sensor_8(0x0216,0x00);	//smiaRegs_rw_wdr_multiple_exp_mode
-	write_cmos_sensor_8(0x3054,0x00);	//smiaRegs_vendor_sensor_enable_af_pixels
-	write_cmos_sensor(0x306A,0x8220);
-	write_cmos_sensor_8(0x3A6B,0x00);
-	write_cmos_sensor_8(0x39BB,0x02);
-	write_cmos_sensor_8(0x3005,0x05);
-	write_cmos_sensor(0x3A58,0x0060);
-	write_cmos_sensor_8(0x39E3,0x02);
-	write_cmos_sensor(0x3238,0x0219);   // SenAnalog_AIG_pDefaultNormalPtrs_3__1_
-	write_cmos_sensor(0x324A,0x00E2);   // SenAnalog_AIG_pDefaultNormalPtrs_6__1_
-	write_cmos_sensor(0x3250,0x0114);    //SenAnalog_AIG_pDefaultNormalPtrs_7__1_
-	write_cmos_sensor(0x3274,0x013B);    //SenAnalog_AIG_pDefaultNormalPtrs_13__1_
-	write_cmos_sensor(0x32C2,0x0114);    //SenAnalog_AIG_pDefaultNormalPtrs_26__1_
-	write_cmos_sensor(0x32C8,0x012D);   // SenAnalog_AIG_pDefaultNormalPtrs_27__1_
-	write_cmos_sensor(0x32DA,0x0114);   // SenAnalog_AIG_pDefaultNormalPtrs_30__1_
-	write_cmos_sensor(0x32E0,0x0115);  //  SenAnalog_AIG_pDefaultNormalPtrs_31__1_
-	write_cmos_sensor(0x35FE,0x007A);  //  SenAnalog_AIG_pDefaultNormalPtrs_164__1_
-	write_cmos_sensor(0x37C6,0x0073);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_30__1_
-	write_cmos_sensor(0x37CC,0x0054);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_31__1_
-	write_cmos_sensor(0x37D2,0x0048);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_32__1_
-	write_cmos_sensor(0x37DE,0x0071);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_34__1_
-	write_cmos_sensor(0x37E4,0x0056);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_35__1_
-	write_cmos_sensor(0x37EA,0x0046);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_36__1_
-	write_cmos_sensor(0x37F6,0x0071);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_38__1_
-	write_cmos_sensor(0x37FC,0x0056);   // SenAnalog_AIG_pDefaultVdaAndShPtrs_39__1_
-	write_cmos_sensor(0x3802,0x0046);    //SenAnalog_AIG_pDefaultVdaAndShPtrs_40__1_
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x15b8);
-	write_cmos_sensor(0x6F12,0x8111);
-	write_cmos_sensor(0x3140,0x0F21);
-	write_cmos_sensor_8(0x31B5,0x01);
-	write_cmos_sensor(0x6028,0x2000);
-	write_cmos_sensor(0x602A,0x1760);
-	write_cmos_sensor_8(0x6F12,0x01);
-	write_cmos_sensor(0x6F12,0x0048);
-	write_cmos_sensor(0x6F12,0x0050);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0x0060);
-	write_cmos_sensor(0x6F12,0xF42E);
-	write_cmos_sensor(0x6F12,0x006D);
-	write_cmos_sensor(0x6F12,0x006A);
-	write_cmos_sensor(0x6F12,0xF51E);
-
-	write_cmos_sensor(0x0100,0x0100);	//smiaRegs_rw_general_setup // Stream on
+	write_cmos_sensor_table(slim_video_setting_regs);
 //	mdelay(100);
 //	write_cmos_sensor(0x3A70,0x0000);
 //	write_cmos_sensor(0x3A72,0x0000);
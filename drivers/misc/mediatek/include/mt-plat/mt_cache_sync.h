@@ -0,0 +1,83 @@
+#ifndef __MT_CACHE_SYNC_H__
+#define __MT_CACHE_SYNC_H__
+
+#include <linux/types.h>
+#include <linux/scatterlist.h>
+
+/*
+ * Range based inner cache maintenance
+ *
+ * By-VA maintenance is broadcast by the hardware and costs in the size of
+ * the range; smp_inner_dcache_flush_all() costs in the size of the caches
+ * and stops every core for it.  These only go to the set/way flush for a
+ * clean or flush large enough to pay for it (all_kb in
+ * /sys/kernel/debug/mt_cache_sync/, measured with bench there).  An
+ * invalidate is always done by VA: it cannot be widened to other lines.
+ *
+ * Pages must be in the linear map (or highmem on 32 bit).  Call from
+ * process context, the set/way flush waits for the other CPUs.
+ */
+enum mt_cache_op {
+	MT_CACHE_CLEAN,		/* CPU writes to the device */
+	MT_CACHE_INVALIDATE,	/* device writes to the CPU */
+	MT_CACHE_FLUSH,		/* both */
+};
+
+#if defined(CONFIG_ARM64) && defined(CONFIG_MEDIATEK_SOLUTION)
+
+extern void smp_inner_dcache_flush_all(void);
+extern void mt_cache_sync_range(const void *va, size_t size,
+				enum mt_cache_op op);
+/* @len bytes from @offset in the buffer described by @sgl */
+extern void mt_cache_sync_sg(struct scatterlist *sgl, unsigned int nents,
+			     size_t offset, size_t len, enum mt_cache_op op);
+
+#else
+
+#include <linux/dma-direction.h>
+#include <linux/highmem.h>
+#include <asm/cacheflush.h>
+
+static inline void mt_cache_sync_range(const void *va, size_t size,
+				       enum mt_cache_op op)
+{
+	if (op == MT_CACHE_CLEAN)
+		dmac_map_area(va, size, DMA_TO_DEVICE);
+	else if (op == MT_CACHE_INVALIDATE)
+		dmac_unmap_area(va, size, DMA_FROM_DEVICE);
+	else
+		dmac_flush_range(va, va + size);
+}
+
+static inline void mt_cache_sync_sg(struct scatterlist *sgl, unsigned int nents,
+				    size_t offset, size_t len, enum mt_cache_op op)
+{
+	struct scatterlist *sg;
+	unsigned int i;
+
+	for_each_sg(sgl, sg, nents, i) {
+		size_t pos, n;
+
+		if (offset >= sg->length) {
+			offset -= sg->length;
+			continue;
+		}
+		for (pos = sg->offset + offset; len && pos < sg->offset + sg->length;
+		     pos += n, len -= n) {
+			struct page *page = nth_page(sg_page(sg), pos >> PAGE_SHIFT);
+			void *va = kmap_atomic(page);
+
+			n = min_t(size_t, PAGE_SIZE - offset_in_page(pos), len);
+			n = min_t(size_t, n, sg->offset + sg->length - pos);
+			mt_cache_sync_range(va + offset_in_page(pos), n, op);
+			kunmap_atomic(va);
+		}
+		offset = 0;
+		if (!len)
+			break;
+	}
+}
+
+#endif
+
+#endif
@@ -373,12 +373,59 @@ enum{
 #define CCCI_IOC_GET_MD_PROTOCOL_TYPE	_IOR(CCCI_IOC_MAGIC, 42, char[16])
 #define CCCI_IOC_SEND_SIGNAL_TO_USER	_IOW(CCCI_IOC_MAGIC, 43, unsigned int) /* md_init */
 #define CCCI_IOC_RESET_MD1_MD3_PCCIF	_IO(CCCI_IOC_MAGIC, 45) /* md_init */
+/* several messages per call, see struct ccci_msg_batch */
+#define CCCI_IOC_READ_BATCH		_IOW(CCCI_IOC_MAGIC, 46, struct ccci_msg_batch)
+#define CCCI_IOC_WRITE_BATCH		_IOW(CCCI_IOC_MAGIC, 47, struct ccci_msg_batch)
+/* mmap-ed receive ring of the modem log port, see struct ccci_log_ring_header */
+#define CCCI_IOC_LOG_RING_SETUP		_IOW(CCCI_IOC_MAGIC, 48, unsigned int) /* mdlogger */
+#define CCCI_IOC_LOG_RING_CONSUME	_IOW(CCCI_IOC_MAGIC, 49, unsigned int) /* mdlogger */
 
 
 #define CCCI_IOC_SET_HEADER				_IO(CCCI_IOC_MAGIC,  112) /* emcs_va */
 #define CCCI_IOC_CLR_HEADER				_IO(CCCI_IOC_MAGIC,  113) /* emcs_va */
 #define CCCI_IOC_DL_TRAFFIC_CONTROL		_IOW(CCCI_IOC_MAGIC, 119, unsigned int) /* mdlogger */
 
+/*
+ * CCCI_IOC_READ_BATCH/CCCI_IOC_WRITE_BATCH move one message per vector entry,
+ * the way read()/write() move one per call, and return the number of entries
+ * done; len is updated to the bytes transferred.  Only the first message of
+ * a read batch may block.
+ */
+#define CCCI_MSG_BATCH_MAX	64
+
+struct ccci_msg_vec {
+	__u64 buf;		/* user pointer */
+	__u32 len;
+	__u32 reserved;
+};
+
+struct ccci_msg_batch {
+	__u64 vec;		/* user pointer to count struct ccci_msg_vec */
+	__u32 count;
+	__u32 flags;		/* must be 0 */
+};
+
+/*
+ * Once CCCI_IOC_LOG_RING_SETUP gave it a size, the modem log port delivers
+ * received messages into a ring readers mmap read-only: the header page is
+ * followed by data_size bytes of records, each a __u32 length and the
+ * payload padded to 4 bytes.  A record never wraps; a length with
+ * CCCI_LOG_RING_PAD set means the rest of the data area is unused.  head and
+ * tail are free running byte counts; readers consume up to head and hand
+ * the space back with CCCI_IOC_LOG_RING_CONSUME(new tail).
+ */
+#define CCCI_LOG_RING_MAGIC	0x474f4c43	/* "CLOG" */
+#define CCCI_LOG_RING_PAD	0x80000000
+
+struct ccci_log_ring_header {
+	__u32 magic;
+	__u32 data_offset;
+	__u32 data_size;	/* power of two */
+	__u32 head;
+	__u32 tail;
+	__u32 dropped;		/* messages that did not fit */
+};
+
 #define CCCI_IPC_MAGIC 'P' /* only for IPC user */
 /* CCCI == EEMCS */
 #define CCCI_IPC_RESET_RECV			_IO(CCCI_IPC_MAGIC, 0)
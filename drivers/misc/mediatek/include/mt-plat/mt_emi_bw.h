@@ -0,0 +1,37 @@
+#ifndef __MT_EMI_BW_H__
+#define __MT_EMI_BW_H__
+
+#include <linux/types.h>
+
+/*
+ * EMI bandwidth sampler
+ *
+ * The EMI bus monitor is read every period_ms and the bytes of each master
+ * group are kept as one sample.  Consumers read the last sample instead of
+ * pausing and resetting the monitor themselves, so DRAM DVFS, SMI and GPU
+ * DVFS see the same numbers; the history is in /sys/kernel/debug/emi_bw/
+ * and the running totals are the events of the "emi_bw" perf PMU.
+ */
+enum emi_bw_master {
+	EMI_BW_TOTAL,
+	EMI_BW_CPU,
+	EMI_BW_GPU,
+	EMI_BW_MM,
+	EMI_BW_MD,
+	EMI_BW_NR,
+};
+
+struct emi_bw_sample {
+	u64 end_ns;			/* sched_clock() */
+	u32 dur_us;
+	u32 mbps[EMI_BW_NR];		/* MB/s over the sample */
+};
+
+/* 0 and the last sample, -ENODATA when the sampler is not running */
+extern int mt_emi_bw_get(struct emi_bw_sample *s);
+/* total MB/s of the last sample, 0 when the sampler is not running */
+extern u32 mt_emi_bw_get_mbps(enum emi_bw_master master);
+/* get_mem_bw() leaves the monitor to the sampler while it runs */
+extern bool mt_emi_bw_sampling(void);
+
+#endif
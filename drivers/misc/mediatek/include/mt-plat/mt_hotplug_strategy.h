@@ -47,4 +47,8 @@ extern int hps_get_num_possible_cpus(unsigned int *little_cpu_ptr,
 				     unsigned int *big_cpu_ptr);
 extern int hps_get_num_online_cpus(unsigned int *little_cpu_ptr,
 				   unsigned int *big_cpu_ptr);
+extern int hps_get_park_enabled(unsigned int *little_ptr,
+				unsigned int *big_ptr);
+extern int hps_set_park_enabled(unsigned int little,
+				unsigned int big);
 #endif
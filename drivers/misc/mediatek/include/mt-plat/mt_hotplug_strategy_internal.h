@@ -140,6 +140,15 @@ struct hps_ctxt_struct {
 	unsigned int big_cpu_id_min;
 	unsigned int big_cpu_id_max;
 
+	/*
+	 * park: a core taken down by the algo is only made inactive to the
+	 * scheduler and left in its deepest idle state instead of being
+	 * powered off, so that bringing it back needs no cpu_up().
+	 */
+	unsigned int little_park_enabled;	/* default: 0 */
+	unsigned int big_park_enabled;		/* default: 0 */
+	struct cpumask parked_cpumask;
+
 	/* algo config */
 	unsigned int up_threshold;
 	unsigned int up_times;
@@ -243,6 +252,10 @@ extern unsigned int num_online_little_cpus(void);
 extern unsigned int num_online_big_cpus(void);
 extern int hps_cpu_is_cpu_big(int cpu);
 extern int hps_cpu_is_cpu_little(int cpu);
+extern int hps_cpu_park(int cpu);
+extern int hps_cpu_unpark(int cpu);
+extern unsigned int num_parked_little_cpus(void);
+extern unsigned int num_parked_big_cpus(void);
 extern unsigned int hps_cpu_get_percpu_load(int cpu);
 extern unsigned int hps_cpu_get_nr_heavy_task(void);
 extern void hps_cpu_get_tlp(unsigned int *avg, unsigned int *iowait_avg);
@@ -7,10 +7,35 @@
 #define PWRAP_READ 0
 #define PWRAP_WRITE 1
 
+/*
+ * One register access of a pwrap_batch() list.  An update writes
+ * (old & ~mask) | (wdata & mask); rdata gets the value read, for an
+ * update the one before the write.
+ */
+#define PWRAP_OP_READ	0
+#define PWRAP_OP_WRITE	1
+#define PWRAP_OP_UPDATE	2
+
+struct pwrap_op {
+	u32 type;
+	u32 adr;
+	u32 wdata;
+	u32 mask;
+	u32 rdata;
+};
+
+#define PWRAP_RD(_adr)	\
+	{ .type = PWRAP_OP_READ, .adr = (_adr) }
+#define PWRAP_WR(_adr, _val)	\
+	{ .type = PWRAP_OP_WRITE, .adr = (_adr), .wdata = (_val) }
+#define PWRAP_UPD(_adr, _mask, _val)	\
+	{ .type = PWRAP_OP_UPDATE, .adr = (_adr), .mask = (_mask), .wdata = (_val) }
+
 struct mt_pmic_wrap_driver {
 
 	struct device_driver driver;
 	s32 (*wacs2_hal)(u32 write, u32 adr, u32 wdata, u32 *rdata);
+	s32 (*batch_hal)(struct pwrap_op *ops, int nr);
 	s32 (*show_hal)(char *buf);
 	s32 (*store_hal)(const char *buf, size_t count);
 
@@ -23,6 +48,11 @@ s32 pwrap_read(u32 adr, u32 *rdata);
 s32 pwrap_write(u32 adr, u32 wdata);
 
 s32 pwrap_wacs2(u32 write, u32 adr, u32 wdata, u32 *rdata);
+/*
+ * Runs @nr ops in order with the wrapper held once, nothing else gets to
+ * the PMIC in between.  Stops at the first failing op.  Atomic context ok.
+ */
+s32 pwrap_batch(struct pwrap_op *ops, int nr);
 /*_____________ROME only_____________________________________________*/
 /********************************************************************/
 /* return value : EINT_STA: [0]: CPU IRQ status in MT6331 */
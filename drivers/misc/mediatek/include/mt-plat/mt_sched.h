@@ -19,3 +19,11 @@ extern unsigned int sched_get_nr_heavy_task(void);
 extern unsigned int sched_get_nr_heavy_task_by_threshold(unsigned int threshold);
 #endif /* CONFIG_MTK_SCHED_RQAVG_US */
 
+#ifdef CONFIG_MTK_SCHED_RQAVG_KS
+/*
+ * return: nr_running of all cpus integrated over time (ns) up to now,
+ *         for averaging over a caller defined window; keeps no state
+ */
+extern u64 sched_get_nr_prod_sum(void);
+#endif /* CONFIG_MTK_SCHED_RQAVG_KS */
+
@@ -190,6 +190,25 @@ extern int mmdvfs_set_step(MTK_SMI_BWC_SCEN scenario, mmdvfs_voltage_enum step);
 extern int mmdvfs_is_default_step_need_perf(void);
 extern void mmdvfs_mm_clock_switch_notify(int is_before, int is_to_high);
 
+/* SMI profile kernel API */
+#if defined(CONFIG_MTK_SMI_EXT) && !defined(CONFIG_MTK_SMI_VARIANT)
+/* take / drop a kernel reference on a scenario, process context only */
+extern int smi_kernel_scenario_enter(MTK_SMI_BWC_SCEN scen);
+extern int smi_kernel_scenario_exit(MTK_SMI_BWC_SCEN scen);
+/* report a display underflow, safe in IRQ context */
+extern void smi_disp_underflow_notify(void);
+#else
+static inline int smi_kernel_scenario_enter(MTK_SMI_BWC_SCEN scen)
+{
+	return 0;
+}
+static inline int smi_kernel_scenario_exit(MTK_SMI_BWC_SCEN scen)
+{
+	return 0;
+}
+static inline void smi_disp_underflow_notify(void) {}
+#endif
+
 #ifdef CONFIG_MTK_SMI_VARIANT
 /* Enable the power-domain and the clocks of the larb.
  *
@@ -0,0 +1,40 @@
+#ifndef __MT_VCORE_QOS_H__
+#define __MT_VCORE_QOS_H__
+
+#include <linux/list.h>
+#include <linux/types.h>
+
+/*
+ * Vcore/DRAM QoS
+ *
+ * Clients state what they need from DRAM - bandwidth and how long they can
+ * wait for it - instead of picking a vcore OPP.  Bandwidths add up and the
+ * tightest latency wins; vcore goes to the performance OPP when the sum
+ * is over what the low power OPP carries or when a client cannot wait for
+ * a DVFS switch.  Going up is done before the request returns, going down
+ * is held back a little so that on/off clients cost one switch, not many.
+ */
+#define VCORE_QOS_LAT_ANY	U32_MAX	/* no latency contract */
+#define VCORE_QOS_LAT_HPM	0	/* always at the performance OPP */
+
+struct vcore_qos_request {
+	struct list_head node;
+	const char *name;
+	u32 bw_mbps;
+	u32 lat_us;
+};
+
+#define DEFINE_VCORE_QOS_REQUEST(_var, _name)				\
+	struct vcore_qos_request _var = {				\
+		.node = LIST_HEAD_INIT(_var.node),			\
+		.name = _name,						\
+		.bw_mbps = 0,						\
+		.lat_us = VCORE_QOS_LAT_ANY,				\
+	}
+
+/* returns the vcore dvfs error if the performance OPP cannot be entered */
+extern int vcore_qos_update_request(struct vcore_qos_request *req,
+				    u32 bw_mbps, u32 lat_us);
+extern void vcore_qos_remove_request(struct vcore_qos_request *req);
+
+#endif
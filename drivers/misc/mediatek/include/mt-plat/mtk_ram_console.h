@@ -38,6 +38,54 @@ typedef enum {
 	AEE_FIQ_STEP_KE_NESTED_PANIC = 64,
 } AEE_FIQ_STEP_NUM;
 
+/* suspend/resume timeline records, see spm_tl_rec() in spm_v2/mt_spm_sleep.c */
+enum suspend_tl_event {
+	SUSPEND_TL_SYNC_FS = 1,
+	SUSPEND_TL_FREEZE,
+	SUSPEND_TL_DPM_PREPARE,
+	SUSPEND_TL_DPM_SUSPEND,
+	SUSPEND_TL_DPM_SUSPEND_LATE,
+	SUSPEND_TL_DPM_SUSPEND_NOIRQ,
+	SUSPEND_TL_MACHINE_SUSPEND,
+	SUSPEND_TL_SPM_SLEEP,		/* data: spm_flags */
+	SUSPEND_TL_SPM_FW,		/* PCM kicked until WFI left, data: PCM_TIMER_OUT */
+	SUSPEND_TL_SPM_WAKE,		/* data: r12 wake sources */
+	SUSPEND_TL_DPM_RESUME_NOIRQ,
+	SUSPEND_TL_DPM_RESUME_EARLY,
+	SUSPEND_TL_DPM_RESUME,
+	SUSPEND_TL_DPM_COMPLETE,
+	SUSPEND_TL_RESUME_CONSOLE,
+	SUSPEND_TL_THAW,
+	SUSPEND_TL_NR,
+};
+
+#define SUSPEND_TL_END		0x80	/* or'ed into the event when a phase ends */
+
+static inline const char *suspend_tl_event_name(u8 event)
+{
+	static const char *const name[SUSPEND_TL_NR] = {
+		[SUSPEND_TL_SYNC_FS] = "sync_fs",
+		[SUSPEND_TL_FREEZE] = "freeze",
+		[SUSPEND_TL_DPM_PREPARE] = "dpm_prepare",
+		[SUSPEND_TL_DPM_SUSPEND] = "dpm_suspend",
+		[SUSPEND_TL_DPM_SUSPEND_LATE] = "dpm_suspend_late",
+		[SUSPEND_TL_DPM_SUSPEND_NOIRQ] = "dpm_suspend_noirq",
+		[SUSPEND_TL_MACHINE_SUSPEND] = "machine_suspend",
+		[SUSPEND_TL_SPM_SLEEP] = "spm_sleep",
+		[SUSPEND_TL_SPM_FW] = "spm_fw",
+		[SUSPEND_TL_SPM_WAKE] = "spm_wake",
+		[SUSPEND_TL_DPM_RESUME_NOIRQ] = "dpm_resume_noirq",
+		[SUSPEND_TL_DPM_RESUME_EARLY] = "dpm_resume_early",
+		[SUSPEND_TL_DPM_RESUME] = "dpm_resume",
+		[SUSPEND_TL_DPM_COMPLETE] = "dpm_complete",
+		[SUSPEND_TL_RESUME_CONSOLE] = "resume_console",
+		[SUSPEND_TL_THAW] = "thaw",
+	};
+
+	event &= ~SUSPEND_TL_END;
+	return event < SUSPEND_TL_NR && name[event] ? name[event] : "?";
+}
+
 extern struct pstore_info *psinfo;
 
 #ifdef CONFIG_MTK_RAM_CONSOLE
@@ -53,6 +101,7 @@ extern void aee_rr_rec_hotplug(int cpu, u8 data1, u8 data2, unsigned long data3)
 extern void aee_sram_fiq_log(const char *msg);
 extern void ram_console_write(struct console *console, const char *s, unsigned int count);
 extern void aee_sram_fiq_save_bin(const char *buffer, size_t len);
+extern void aee_rr_rec_suspend_tl(u8 event, u64 cnt, u32 data);
 #ifdef CONFIG_MTK_EMMC_SUPPORT
 extern void last_kmsg_store_to_emmc(void);
 #endif
@@ -116,6 +165,10 @@ static inline void aee_sram_fiq_save_bin(unsigned char *buffer, size_t len)
 {
 }
 
+static inline void aee_rr_rec_suspend_tl(u8 event, u64 cnt, u32 data)
+{
+}
+
 #ifdef CONFIG_MTK_EMMC_SUPPORT
 static inline void last_kmsg_store_to_emmc(void)
 {
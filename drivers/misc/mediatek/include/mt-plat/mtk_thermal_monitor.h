@@ -66,6 +66,8 @@ typedef enum {
 } MTK_THERMAL_SENSOR_ID;
 
 extern int mtk_thermal_get_temp(MTK_THERMAL_SENSOR_ID id);
+extern void mtk_thermal_idle_enter(void);
+extern void mtk_thermal_idle_exit(void);
 extern struct proc_dir_entry *mtk_thermal_get_proc_drv_therm_dir_entry(void);
 
 /* This API function is implemented in mediatek/kernel/drivers/leds/leds.c */
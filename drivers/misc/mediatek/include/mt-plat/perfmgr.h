@@ -1,11 +1,92 @@
 #ifndef __PERFMGR_H__
 #define __PERFMGR_H__
 
+#include <linux/ioctl.h>
+#include <linux/types.h>
+
 extern int init_perfmgr_touch(void);
 extern int perfmgr_touch_suspend(void);
 
 extern int  perfmgr_get_target_core(void);
 extern int  perfmgr_get_target_freq(void);
-extern void perfmgr_boost(int enable, int core, int freq);
+
+/*
+ * Boost arbiter
+ *
+ * Boosters do not drive hotplug, dvfs or vcore themselves: each one is a
+ * client filing a (timed) request, and the arbiter resolves all active
+ * requests into a single setting.  Clients are ordered by priority, the
+ * last one being the highest.  Requests are resolved from the highest
+ * priority down, and a floor never goes above a cap set by a higher
+ * priority client, so the thermal cap always holds.
+ */
+enum perfmgr_boost_client {
+	PERFMGR_BOOST_FLIPER,		/* EMI bandwidth driven vcore */
+	PERFMGR_BOOST_TOUCH,
+	PERFMGR_BOOST_DYNAMIC,		/* set_dynamic_boost() */
+	PERFMGR_BOOST_LAUNCH,
+	PERFMGR_BOOST_CAMERA,
+	PERFMGR_BOOST_RENDER,		/* GED, CPU bound frames */
+	PERFMGR_BOOST_MODEM,		/* CLDMA throughput */
+	PERFMGR_BOOST_THERMAL,
+	NR_PERFMGR_BOOST_CLIENTS
+};
+
+#define PERFMGR_BOOST_NO_CAP	(-1)
+
+struct perfmgr_boost_req {
+	__s32 min_cores_l;	/* LITTLE cores kept online */
+	__s32 min_cores_b;	/* big cores kept online */
+	__s32 min_freq_l;	/* LITTLE cluster minimum frequency, kHz */
+	__s32 vcore;		/* 1: hold vcore at the performance OPP */
+	__s32 max_cores_l;	/* caps on the floors, PERFMGR_BOOST_NO_CAP: none */
+	__s32 max_cores_b;
+	__s32 max_freq_l;
+};
+
+/* /proc/perfmgr/boost */
+struct perfmgr_boost_ioctl {
+	__s32 client;		/* enum perfmgr_boost_client */
+	__u32 duration_ms;	/* 0: until PERFMGR_IOC_UNBOOST */
+	struct perfmgr_boost_req req;
+};
+
+#define PERFMGR_IOC_MAGIC	'P'
+#define PERFMGR_IOC_BOOST	_IOW(PERFMGR_IOC_MAGIC, 1, struct perfmgr_boost_ioctl)
+#define PERFMGR_IOC_UNBOOST	_IOW(PERFMGR_IOC_MAGIC, 2, __s32)
+
+#ifdef __KERNEL__
+static inline void perfmgr_boost_req_init(struct perfmgr_boost_req *req)
+{
+	req->min_cores_l = 0;
+	req->min_cores_b = 0;
+	req->min_freq_l = 0;
+	req->vcore = 0;
+	req->max_cores_l = PERFMGR_BOOST_NO_CAP;
+	req->max_cores_b = PERFMGR_BOOST_NO_CAP;
+	req->max_freq_l = PERFMGR_BOOST_NO_CAP;
+}
+
+extern int init_perfmgr_boost(void);
+extern int perfmgr_boost_request(enum perfmgr_boost_client client,
+				 const struct perfmgr_boost_req *req,
+				 unsigned int duration_ms);
+extern void perfmgr_boost_cancel(enum perfmgr_boost_client client);
+
+/*
+ * Touch boost from the touch panel interrupt, before the report is read:
+ * a short timed request that BTN_TOUCH then extends until the release.
+ * Safe to call from hard IRQ context.
+ */
+#ifdef CONFIG_MTK_PERFMGR_TOUCH_BOOST
+extern void perfmgr_touch_irq_boost(void);
+#else
+static inline void perfmgr_touch_irq_boost(void) { }
+#endif
+
+/* Platform backend, called when the resolved setting changes */
+extern void perfmgr_boost_apply(const struct perfmgr_boost_req *old,
+				const struct perfmgr_boost_req *new);
+#endif
 
 #endif				/* !__PERFMGR_H__ */
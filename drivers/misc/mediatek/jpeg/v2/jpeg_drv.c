@@ -20,6 +20,9 @@
 #include <linux/uaccess.h>
 #include <linux/sched.h>
 #include <linux/slab.h>
+#include <linux/list.h>
+#include <linux/poll.h>
+#include <linux/workqueue.h>
 
 /* #include <linux/xlog.h> */
 
@@ -413,6 +416,96 @@ static void jpeg_drv_enc_deinit(void)
 }
 
 
+static int jpeg_drv_enc_config(JPEG_ENC_DRV_IN *cfgEnc)
+{
+	unsigned int ret;
+
+	/* 0. reset */
+	jpeg_drv_enc_reset();
+
+	/* 1. set src config */
+	/* memset(&src_cfg, 0, sizeof(JpegDrvEncSrcCfg)); */
+
+	/* src_cfg.luma_addr = cfgEnc->srcBufferAddr; */
+	/* if (cfgEnc->encFormat == NV12 || cfgEnc->encFormat == NV21) */
+	/* { */
+	/* unsigned int srcChromaAddr = cfgEnc->srcChromaAddr; */
+	/* srcChromaAddr = TO_CEIL(srcChromaAddr, 128);    //((srcChromaAddr+127)&~127); */
+	/* src_cfg.chroma_addr = srcChromaAddr; */
+	/* } */
+	/*  */
+	/* src_cfg.width = cfgEnc->encWidth; */
+	/* src_cfg.height = cfgEnc->encHeight; */
+	/* src_cfg.yuv_format = cfgEnc->encFormat; */
+
+	/* 1. set src config */
+	JPEG_MSG("[JPEGDRV]SRC_IMG: %x %x, DU:%x, fmt:%x!!\n", cfgEnc->encWidth,
+		 cfgEnc->encHeight, cfgEnc->totalEncDU, cfgEnc->encFormat);
+
+	ret =
+	    jpeg_drv_enc_set_src_image(cfgEnc->encWidth, cfgEnc->encHeight, cfgEnc->encFormat,
+				       cfgEnc->totalEncDU);
+	if (ret == 0) {
+		JPEG_MSG("[JPEGDRV]JPEG Encoder set srouce image failed\n");
+		return -EFAULT;
+	}
+
+	/* 2. set src buffer info */
+	JPEG_MSG("[JPEGDRV]SRC_BUF: addr %x, %x, stride %x, %x!!\n", cfgEnc->srcBufferAddr,
+		 cfgEnc->srcChromaAddr, cfgEnc->imgStride, cfgEnc->memStride);
+
+	ret =
+	    jpeg_drv_enc_set_src_buf(cfgEnc->encFormat, cfgEnc->imgStride, cfgEnc->memStride,
+				     cfgEnc->srcBufferAddr, cfgEnc->srcChromaAddr);
+	if (ret == 0) {
+		JPEG_MSG("[JPEGDRV]JPEG Encoder set srouce buffer failed\n");
+		return -EFAULT;
+	}
+
+	/* if (0 == jpeg_drv_enc_src_cfg(src_cfg)) */
+	/* { */
+	/* JPEG_MSG("JPEG Encoder src cfg failed\n"); */
+	/* return -EFAULT; */
+	/* } */
+
+	/* 3. set dst buffer info */
+	JPEG_MSG("[JPEGDRV]DST_BUF: addr:%x, size:%x, ofs:%x, mask:%x!!\n",
+		 cfgEnc->dstBufferAddr, cfgEnc->dstBufferSize, cfgEnc->dstBufAddrOffset,
+		 cfgEnc->dstBufAddrOffsetMask);
+
+	ret =
+	    jpeg_drv_enc_set_dst_buff(cfgEnc->dstBufferAddr, cfgEnc->dstBufferSize,
+				      cfgEnc->dstBufAddrOffset, cfgEnc->dstBufAddrOffsetMask);
+	if (ret == 0) {
+		JPEG_MSG("[JPEGDRV]JPEG Encoder set dst buffer failed\n");
+		return -EFAULT;
+	}
+	/* memset(&dst_cfg, 0, sizeof(JpegDrvEncDstCfg)); */
+	/*  */
+	/* dst_cfg.dst_addr = cfgEnc->dstBufferAddr; */
+	/* dst_cfg.dst_size = cfgEnc->dstBufferSize; */
+	/* dst_cfg.exif_en = cfgEnc->enableEXIF; */
+	/*  */
+	/*  */
+	/* if (0 == jpeg_drv_enc_dst_buff(dst_cfg)) */
+	/* return -EFAULT; */
+
+	/* 4 .set ctrl config */
+	JPEG_MSG("[JPEGDRV]ENC_CFG: exif:%d, q:%d, DRI:%d !!\n", cfgEnc->enableEXIF,
+		 cfgEnc->encQuality, cfgEnc->restartInterval);
+
+	jpeg_drv_enc_ctrl_cfg(cfgEnc->enableEXIF, cfgEnc->encQuality, cfgEnc->restartInterval);
+
+	/* memset(&ctrl_cfg, 0, sizeof(JpegDrvEncCtrlCfg)); */
+	/*  */
+	/* ctrl_cfg.quality = cfgEnc->encQuality; */
+	/* ctrl_cfg.gmc_disable = cfgEnc->disableGMC; */
+	/* ctrl_cfg.restart_interval = cfgEnc->restartInterval; */
+	/*  */
+
+	return 0;
+}
+
 /* -------------------------------------------------------------------------- */
 /* JPEG REG DUMP FUNCTION */
 /* -------------------------------------------------------------------------- */
@@ -766,88 +859,9 @@ static int jpeg_enc_ioctl(unsigned int cmd, unsigned long arg, struct file *file
 			return -EFAULT;
 		}
 
-		/* 0. reset */
-		jpeg_drv_enc_reset();
-
-		/* 1. set src config */
-		/* memset(&src_cfg, 0, sizeof(JpegDrvEncSrcCfg)); */
-
-		/* src_cfg.luma_addr = cfgEnc.srcBufferAddr; */
-		/* if (cfgEnc.encFormat == NV12 || cfgEnc.encFormat == NV21) */
-		/* { */
-		/* unsigned int srcChromaAddr = cfgEnc.srcChromaAddr; */
-		/* srcChromaAddr = TO_CEIL(srcChromaAddr, 128);    //((srcChromaAddr+127)&~127); */
-		/* src_cfg.chroma_addr = srcChromaAddr; */
-		/* } */
-		/*  */
-		/* src_cfg.width = cfgEnc.encWidth; */
-		/* src_cfg.height = cfgEnc.encHeight; */
-		/* src_cfg.yuv_format = cfgEnc.encFormat; */
-
-		/* 1. set src config */
-		JPEG_MSG("[JPEGDRV]SRC_IMG: %x %x, DU:%x, fmt:%x!!\n", cfgEnc.encWidth,
-			 cfgEnc.encHeight, cfgEnc.totalEncDU, cfgEnc.encFormat);
-
-		ret =
-		    jpeg_drv_enc_set_src_image(cfgEnc.encWidth, cfgEnc.encHeight, cfgEnc.encFormat,
-					       cfgEnc.totalEncDU);
-		if (ret == 0) {
-			JPEG_MSG("[JPEGDRV]JPEG Encoder set srouce image failed\n");
-			return -EFAULT;
-		}
-
-		/* 2. set src buffer info */
-		JPEG_MSG("[JPEGDRV]SRC_BUF: addr %x, %x, stride %x, %x!!\n", cfgEnc.srcBufferAddr,
-			 cfgEnc.srcChromaAddr, cfgEnc.imgStride, cfgEnc.memStride);
-
-		ret =
-		    jpeg_drv_enc_set_src_buf(cfgEnc.encFormat, cfgEnc.imgStride, cfgEnc.memStride,
-					     cfgEnc.srcBufferAddr, cfgEnc.srcChromaAddr);
-		if (ret == 0) {
-			JPEG_MSG("[JPEGDRV]JPEG Encoder set srouce buffer failed\n");
+		if (jpeg_drv_enc_config(&cfgEnc) < 0)
 			return -EFAULT;
-		}
 
-		/* if (0 == jpeg_drv_enc_src_cfg(src_cfg)) */
-		/* { */
-		/* JPEG_MSG("JPEG Encoder src cfg failed\n"); */
-		/* return -EFAULT; */
-		/* } */
-
-		/* 3. set dst buffer info */
-		JPEG_MSG("[JPEGDRV]DST_BUF: addr:%x, size:%x, ofs:%x, mask:%x!!\n",
-			 cfgEnc.dstBufferAddr, cfgEnc.dstBufferSize, cfgEnc.dstBufAddrOffset,
-			 cfgEnc.dstBufAddrOffsetMask);
-
-		ret =
-		    jpeg_drv_enc_set_dst_buff(cfgEnc.dstBufferAddr, cfgEnc.dstBufferSize,
-					      cfgEnc.dstBufAddrOffset, cfgEnc.dstBufAddrOffsetMask);
-		if (ret == 0) {
-			JPEG_MSG("[JPEGDRV]JPEG Encoder set dst buffer failed\n");
-			return -EFAULT;
-		}
-		/* memset(&dst_cfg, 0, sizeof(JpegDrvEncDstCfg)); */
-		/*  */
-		/* dst_cfg.dst_addr = cfgEnc.dstBufferAddr; */
-		/* dst_cfg.dst_size = cfgEnc.dstBufferSize; */
-		/* dst_cfg.exif_en = cfgEnc.enableEXIF; */
-		/*  */
-		/*  */
-		/* if (0 == jpeg_drv_enc_dst_buff(dst_cfg)) */
-		/* return -EFAULT; */
-
-		/* 4 .set ctrl config */
-		JPEG_MSG("[JPEGDRV]ENC_CFG: exif:%d, q:%d, DRI:%d !!\n", cfgEnc.enableEXIF,
-			 cfgEnc.encQuality, cfgEnc.restartInterval);
-
-		jpeg_drv_enc_ctrl_cfg(cfgEnc.enableEXIF, cfgEnc.encQuality, cfgEnc.restartInterval);
-
-		/* memset(&ctrl_cfg, 0, sizeof(JpegDrvEncCtrlCfg)); */
-		/*  */
-		/* ctrl_cfg.quality = cfgEnc.encQuality; */
-		/* ctrl_cfg.gmc_disable = cfgEnc.disableGMC; */
-		/* ctrl_cfg.restart_interval = cfgEnc.restartInterval; */
-		/*  */
 		break;
 
 	case JPEG_ENC_IOCTL_START:
@@ -969,6 +983,303 @@ static int jpeg_enc_ioctl(unsigned int cmd, unsigned long arg, struct file *file
 }
 
 
+/* -------------------------------------------------------------------------- */
+/* JPEG JOB QUEUE FUNCTION */
+/* -------------------------------------------------------------------------- */
+
+/* Keep the engines claimed this long after the queue drains */
+#define JPEG_JOB_IDLE_MS 20
+
+typedef struct {
+	unsigned int status;	/* JPEG_DEC_PROCESS/JPEG_ENC_PROCESS, must be first, used as pStatus */
+	struct list_head doneList;	/* finished jobs, protected by jpeg_job_mutex */
+	unsigned int pending;	/* submitted and not yet polled */
+	wait_queue_head_t doneWait;
+} JpegFileStruct;
+
+typedef struct {
+	struct list_head list;
+	JpegFileStruct *owner;
+	JPEG_JOB_IN in;
+	JPEG_JOB_OUT out;
+} JpegJobStruct;
+
+static DEFINE_MUTEX(jpeg_job_mutex);
+static LIST_HEAD(jpeg_job_list);	/* protected by jpeg_job_mutex */
+static JpegFileStruct *jpeg_job_running_owner;	/* protected by jpeg_job_mutex */
+static DECLARE_WAIT_QUEUE_HEAD(jpeg_job_run_wait);
+static struct workqueue_struct *jpeg_job_wq;
+
+/* only touched from jpeg_job_wq and while it is frozen */
+#ifdef JPEG_DEC_DRIVER
+static int jpeg_job_dec_claimed;
+#endif
+static int jpeg_job_enc_claimed;
+
+static void jpeg_job_work_func(struct work_struct *work);
+static void jpeg_job_idle_func(struct work_struct *work);
+static DECLARE_DELAYED_WORK(jpeg_job_work, jpeg_job_work_func);
+static DECLARE_DELAYED_WORK(jpeg_job_idle_work, jpeg_job_idle_func);
+
+/* Power on and reset the engine once for a run of jobs, like *_IOCTL_INIT */
+static int jpeg_job_claim(unsigned int type)
+{
+#ifdef JPEG_DEC_DRIVER
+	if (type == JPEG_JOB_DEC) {
+		if (!jpeg_job_dec_claimed) {
+			if (jpeg_drv_dec_init() != 0)
+				return -EBUSY;
+			jpeg_job_dec_claimed = 1;
+		}
+		return 0;
+	}
+#endif
+	if (!jpeg_job_enc_claimed) {
+		if (jpeg_drv_enc_init() != 0)
+			return -EBUSY;
+		jpeg_job_enc_claimed = 1;
+	}
+	return 0;
+}
+
+static void jpeg_job_release(void)
+{
+#ifdef JPEG_DEC_DRIVER
+	if (jpeg_job_dec_claimed) {
+		jpeg_drv_dec_deinit();
+		jpeg_job_dec_claimed = 0;
+	}
+#endif
+	if (jpeg_job_enc_claimed) {
+		jpeg_drv_enc_deinit();
+		jpeg_job_enc_claimed = 0;
+	}
+}
+
+#ifdef JPEG_DEC_DRIVER
+static void jpeg_job_run_dec(JpegJobStruct *job)
+{
+	unsigned int decResult;
+
+	jpeg_drv_dec_reset();
+	if (jpeg_drv_dec_set_config_data(&job->in.param.dec) < 0) {
+		job->out.result = E_HWJPG_ERR_PARAM;
+		return;
+	}
+
+	jpeg_drv_dec_start();
+	if (jpeg_isr_dec_lisr() < 0)
+		wait_event_interruptible_timeout(dec_wait_queue, _jpeg_dec_int_status,
+						 msecs_to_jiffies(job->in.timeout));
+
+	decResult = jpeg_drv_dec_get_result();
+	if (decResult >= 2) {
+		JPEG_MSG("[JPEGDRV]Job %u Decode Result : %d, status %x!\n", job->in.fence, decResult,
+			 _jpeg_dec_int_status);
+		jpeg_drv_dec_dump_key_reg();
+		jpeg_drv_dec_warm_reset();
+	}
+	job->out.result = decResult | (_jpeg_dec_int_status << 8);
+	_jpeg_dec_int_status = 0;
+}
+#endif
+
+static void jpeg_job_run_enc(JpegJobStruct *job)
+{
+	unsigned int file_size = 0;
+	unsigned int ret;
+
+	if (jpeg_drv_enc_config(&job->in.param.enc) < 0) {
+		job->out.result = E_HWJPG_ERR_PARAM;
+		return;
+	}
+
+	jpeg_drv_enc_start();
+	if (jpeg_isr_enc_lisr() < 0)
+		wait_event_interruptible_timeout(enc_wait_queue, _jpeg_enc_int_status,
+						 msecs_to_jiffies(job->in.timeout));
+
+	ret = jpeg_drv_enc_get_result(&file_size);
+	if (ret != 0) {
+		JPEG_MSG("[JPEGDRV]Job %u Encode Result : %d!!\n", job->in.fence, ret);
+		jpeg_drv_enc_dump_reg();
+		jpeg_drv_enc_warm_reset();
+	}
+	job->out.result = ret;
+	job->out.fileSize = file_size;
+	job->out.cycleCount = jpeg_drv_enc_get_cycle_count();
+}
+
+static void jpeg_job_work_func(struct work_struct *work)
+{
+	JpegJobStruct *job;
+
+	for (;;) {
+		mutex_lock(&jpeg_job_mutex);
+		if (list_empty(&jpeg_job_list)) {
+			mutex_unlock(&jpeg_job_mutex);
+			break;
+		}
+		job = list_first_entry(&jpeg_job_list, JpegJobStruct, list);
+		if (jpeg_job_claim(job->in.type) != 0) {
+			/* someone uses the engine through *_IOCTL_INIT, retry later */
+			mutex_unlock(&jpeg_job_mutex);
+			queue_delayed_work(jpeg_job_wq, &jpeg_job_work, 1);
+			return;
+		}
+		list_del(&job->list);
+		jpeg_job_running_owner = job->owner;
+		mutex_unlock(&jpeg_job_mutex);
+
+		job->out.fence = job->in.fence;
+#ifdef JPEG_DEC_DRIVER
+		if (job->in.type == JPEG_JOB_DEC)
+			jpeg_job_run_dec(job);
+		else
+#endif
+			jpeg_job_run_enc(job);
+
+		mutex_lock(&jpeg_job_mutex);
+		list_add_tail(&job->list, &job->owner->doneList);
+		wake_up_interruptible(&job->owner->doneWait);
+		jpeg_job_running_owner = NULL;
+		mutex_unlock(&jpeg_job_mutex);
+		wake_up_all(&jpeg_job_run_wait);
+	}
+
+	queue_delayed_work(jpeg_job_wq, &jpeg_job_idle_work, msecs_to_jiffies(JPEG_JOB_IDLE_MS));
+}
+
+static void jpeg_job_idle_func(struct work_struct *work)
+{
+	mutex_lock(&jpeg_job_mutex);
+	if (list_empty(&jpeg_job_list))
+		jpeg_job_release();
+	mutex_unlock(&jpeg_job_mutex);
+}
+
+static int jpeg_job_ioctl(unsigned int cmd, unsigned long arg, struct file *file)
+{
+	JpegFileStruct *pFile = (JpegFileStruct *)file->private_data;
+	JpegJobStruct *job;
+	JPEG_JOB_OUT out;
+	long ret;
+
+	if (NULL == pFile) {
+		JPEG_WRN("Private data is null in job operation. HOW COULD THIS HAPPEN ??\n");
+		return -EFAULT;
+	}
+
+	switch (cmd) {
+	case JPEG_IOCTL_JOB_SUBMIT:
+		job = kzalloc(sizeof(JpegJobStruct), GFP_KERNEL);
+		if (NULL == job)
+			return -ENOMEM;
+		if (copy_from_user(&job->in, (void *)arg, sizeof(JPEG_JOB_IN))) {
+			JPEG_WRN("JPEG Job : Copy from user error\n");
+			kfree(job);
+			return -EFAULT;
+		}
+#ifdef JPEG_DEC_DRIVER
+		/* pause/resume needs JPEG_DEC_IOCTL_RESUME for every row */
+		if (job->in.type == JPEG_JOB_DEC && job->in.param.dec.decodeMode == JPEG_DEC_MODE_MCU_ROW) {
+			kfree(job);
+			return -EINVAL;
+		}
+		if (job->in.type != JPEG_JOB_DEC && job->in.type != JPEG_JOB_ENC) {
+#else
+		if (job->in.type != JPEG_JOB_ENC) {
+#endif
+			kfree(job);
+			return -EINVAL;
+		}
+		job->owner = pFile;
+
+		mutex_lock(&jpeg_job_mutex);
+		if (pFile->pending >= JPEG_JOB_QUEUE_MAX) {
+			mutex_unlock(&jpeg_job_mutex);
+			kfree(job);
+			return -EBUSY;
+		}
+		pFile->pending++;
+		list_add_tail(&job->list, &jpeg_job_list);
+		mutex_unlock(&jpeg_job_mutex);
+
+		queue_delayed_work(jpeg_job_wq, &jpeg_job_work, 0);
+		break;
+
+	case JPEG_IOCTL_JOB_POLL:
+		if (copy_from_user(&out, (void *)arg, sizeof(JPEG_JOB_OUT))) {
+			JPEG_WRN("JPEG Job : Copy from user error\n");
+			return -EFAULT;
+		}
+		if (out.timeout) {
+			ret = wait_event_interruptible_timeout(pFile->doneWait,
+							       !list_empty_careful(&pFile->doneList),
+							       msecs_to_jiffies(out.timeout));
+			if (ret < 0)
+				return ret;
+		}
+
+		mutex_lock(&jpeg_job_mutex);
+		if (list_empty(&pFile->doneList)) {
+			mutex_unlock(&jpeg_job_mutex);
+			return -EAGAIN;
+		}
+		job = list_first_entry(&pFile->doneList, JpegJobStruct, list);
+		list_del(&job->list);
+		pFile->pending--;
+		mutex_unlock(&jpeg_job_mutex);
+
+		out = job->out;
+		kfree(job);
+		if (copy_to_user((void *)arg, &out, sizeof(JPEG_JOB_OUT))) {
+			JPEG_WRN("JPEG Job : Copy to user error\n");
+			return -EFAULT;
+		}
+		break;
+
+	default:
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static unsigned int jpeg_job_poll(struct file *file, poll_table *wait)
+{
+	JpegFileStruct *pFile = (JpegFileStruct *)file->private_data;
+
+	poll_wait(file, &pFile->doneWait, wait);
+	if (!list_empty_careful(&pFile->doneList))
+		return POLLIN | POLLRDNORM;
+	return 0;
+}
+
+/* Drop the jobs of a closing file, waiting for the one on the engine */
+static void jpeg_job_flush_file(JpegFileStruct *pFile)
+{
+	JpegJobStruct *job, *tmp;
+
+	mutex_lock(&jpeg_job_mutex);
+	list_for_each_entry_safe(job, tmp, &jpeg_job_list, list) {
+		if (job->owner == pFile) {
+			list_del(&job->list);
+			kfree(job);
+		}
+	}
+	mutex_unlock(&jpeg_job_mutex);
+
+	wait_event(jpeg_job_run_wait, ACCESS_ONCE(jpeg_job_running_owner) != pFile);
+
+	mutex_lock(&jpeg_job_mutex);
+	list_for_each_entry_safe(job, tmp, &pFile->doneList, list) {
+		list_del(&job->list);
+		kfree(job);
+	}
+	pFile->pending = 0;
+	mutex_unlock(&jpeg_job_mutex);
+}
+
 /* -------------------------------------------------------------------------- */
 /*  */
 /* -------------------------------------------------------------------------- */
@@ -1138,6 +1449,8 @@ static long compat_jpeg_ioctl(struct file *filp, unsigned int cmd, unsigned long
 	case JPEG_DEC_IOCTL_RESUME:
 	case JPEG_DEC_IOCTL_FLUSH_CMDQ:
 	case JPEG_ENC_IOCTL_CONFIG:
+	case JPEG_IOCTL_JOB_SUBMIT:
+	case JPEG_IOCTL_JOB_POLL:
 		return filp->f_op->unlocked_ioctl(filp, cmd, (unsigned long)compat_ptr(arg));
 
 	default:
@@ -1167,6 +1480,9 @@ static long jpeg_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned lo
 	case JPEG_ENC_IOCTL_DEINIT:
 	case JPEG_ENC_IOCTL_START:
 		return jpeg_enc_ioctl(cmd, arg, file);
+	case JPEG_IOCTL_JOB_SUBMIT:
+	case JPEG_IOCTL_JOB_POLL:
+		return jpeg_job_ioctl(cmd, arg, file);
 	default:
 		break;
 	}
@@ -1175,17 +1491,20 @@ static long jpeg_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned lo
 
 static int jpeg_open(struct inode *inode, struct file *file)
 {
-	unsigned int *pStatus;
+	JpegFileStruct *pFile;
 	/* Allocate and initialize private data */
-	 file->private_data = kmalloc(sizeof(unsigned int), GFP_ATOMIC);
+	 file->private_data = kmalloc(sizeof(JpegFileStruct), GFP_ATOMIC);
 
 	if (NULL == file->private_data) {
 		JPEG_WRN("Not enough entry for JPEG open operation\n");
 		return -ENOMEM;
 	}
 
-	pStatus = (unsigned int *)file->private_data;
-	*pStatus = 0;
+	pFile = (JpegFileStruct *)file->private_data;
+	pFile->status = 0;
+	INIT_LIST_HEAD(&pFile->doneList);
+	pFile->pending = 0;
+	init_waitqueue_head(&pFile->doneWait);
 
 	return 0;
 }
@@ -1199,6 +1518,7 @@ static ssize_t jpeg_read(struct file *file, char __user *data, size_t len, loff_
 static int jpeg_release(struct inode *inode, struct file *file)
 {
 	if (NULL != file->private_data) {
+		jpeg_job_flush_file((JpegFileStruct *)file->private_data);
 		kfree(file->private_data);
 		file->private_data = NULL;
 	}
@@ -1246,6 +1566,7 @@ static struct file_operations const jpeg_fops = {
 	.release = jpeg_release,
 	.flush = jpeg_flush,
 	.read = jpeg_read,
+	.poll = jpeg_job_poll,
 };
 
 
@@ -1424,6 +1745,8 @@ static void jpeg_shutdown(struct platform_device *pdev)
 /* PM suspend */
 static int jpeg_suspend(struct platform_device *pdev, pm_message_t mesg)
 {
+	/* jpeg_job_wq is frozen by now */
+	jpeg_job_release();
 #ifdef JPEG_DEC_DRIVER
 	jpeg_drv_dec_deinit();
 #endif
@@ -1574,6 +1897,12 @@ static int __init jpeg_init(void)
 
 	JPEG_MSG("JPEG Codec initialize\n");
 
+	jpeg_job_wq = alloc_ordered_workqueue("jpeg_job", WQ_FREEZABLE);
+	if (!jpeg_job_wq) {
+		JPEG_ERR("failed to create jpeg job workqueue\n");
+		return -ENOMEM;
+	}
+
 #if 0
 	JPEG_MSG("Register the JPEG Codec device\n");
 	if (platform_device_register(&jpeg_device)) {
@@ -1587,6 +1916,7 @@ static int __init jpeg_init(void)
 	if (platform_driver_register(&jpeg_driver)) {
 		JPEG_ERR("failed to register jpeg codec driver\n");
 		platform_device_unregister(&jpeg_device);
+		destroy_workqueue(jpeg_job_wq);
 		ret = -ENODEV;
 		return ret;
 	}
@@ -1616,6 +1946,11 @@ static void __exit jpeg_exit(void)
 #endif
 	cmdqCoreRegisterCB(CMDQ_GROUP_JPEG, NULL, NULL, NULL, NULL);
 
+	cancel_delayed_work_sync(&jpeg_job_work);
+	cancel_delayed_work_sync(&jpeg_job_idle_work);
+	jpeg_job_release();
+	destroy_workqueue(jpeg_job_wq);
+
 	/* JPEG_MSG("Unregistering driver\n"); */
 	platform_driver_unregister(&jpeg_driver);
 	platform_device_unregister(&jpeg_device);
@@ -543,6 +543,36 @@ typedef struct {
 } JPEG_PMEM_RANGE;
 
 
+/* JPEG Job Queue Structure */
+/* Jobs run back to back with the engine kept on, results are read back */
+/* with JPEG_IOCTL_JOB_POLL or poll() in submission order. */
+typedef enum {
+	JPEG_JOB_DEC = 0,
+	JPEG_JOB_ENC
+} JpegJobType;
+
+#define JPEG_JOB_QUEUE_MAX     64	/* submitted and not yet polled, per file */
+
+typedef struct {
+	unsigned int type;	/* JpegJobType */
+	unsigned int fence;	/* caller chosen, returned with the result */
+	unsigned int timeout;	/* ms */
+	union {
+		JPEG_DEC_DRV_IN dec;	/* JPEG_DEC_MODE_MCU_ROW is not supported */
+		JPEG_ENC_DRV_IN enc;
+	} param;
+} JPEG_JOB_IN;
+
+typedef struct {
+	unsigned int timeout;	/* In : ms to wait for a result, 0 does not block */
+	unsigned int fence;
+	unsigned int result;	/* as JPEG_DEC_IOCTL_WAIT / JPEG_ENC_IOCTL_WAIT, E_HWJPG_ERR_PARAM */
+				/* if the job could not be configured */
+	unsigned int fileSize;	/* encoder only */
+	unsigned int cycleCount;	/* encoder only */
+} JPEG_JOB_OUT;
+
+
 #ifdef CONFIG_COMPAT
 
 typedef struct {
@@ -636,6 +666,11 @@ typedef struct {
 #define JPEG_ENC_IOCTL_DUMP_REG     _IO(JPEG_IOCTL_MAGIC, 21)
 #define JPEG_ENC_IOCTL_RW_REG       _IO(JPEG_IOCTL_MAGIC, 22)
 
+/* /////////////////// JPEG JOB IOCTL ///////////////////////////////////// */
+
+#define JPEG_IOCTL_JOB_SUBMIT       _IOW(JPEG_IOCTL_MAGIC, 40, JPEG_JOB_IN)
+#define JPEG_IOCTL_JOB_POLL         _IOWR(JPEG_IOCTL_MAGIC, 41, JPEG_JOB_OUT)
+
 #ifdef CONFIG_COMPAT
 
 #define COMPAT_JPEG_DEC_IOCTL_WAIT         _IOWR(JPEG_IOCTL_MAGIC,  5, compat_JPEG_DEC_DRV_OUT)
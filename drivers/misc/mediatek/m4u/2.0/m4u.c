@@ -16,6 +16,7 @@
 #include <linux/vmalloc.h>
 #include <linux/slab.h>
 #include <linux/timer.h>
+#include <linux/workqueue.h>
 #include <mt-plat/sync_write.h>
 #include <mach/mt_clkmgr.h>
 #include <mach/irqs.h>
@@ -82,6 +83,8 @@ static int m4u_buf_show(void *priv, unsigned int mva_start, unsigned int mva_end
 }
 
 
+static void m4u_lazy_free_show(struct seq_file *seq);
+
 int m4u_dump_buf_info(struct seq_file *seq)
 {
 
@@ -92,6 +95,7 @@ int m4u_dump_buf_info(struct seq_file *seq)
 	mva_foreach_priv((void *) m4u_buf_show, seq);
 
 	M4U_PRINT_LOG_OR_SEQ(seq, " dump mva allocated info done ========>\n");
+	m4u_lazy_free_show(seq);
 	return 0;
 }
 
@@ -590,6 +594,137 @@ int m4u_destroy_sgtable(struct sg_table *table)
 	return 0;
 }
 
+/*
+ * Lazy mva release
+ *
+ * ION buffers handed between display, codec and GPU are freed and allocated
+ * again all the time, and a camera session closing dozens of them used to
+ * wait for one range TLB invalidate each.  Their page table is still
+ * cleared right away, but the mva is parked and its range merged into the
+ * pending invalidate queue.  The queue is flushed from a work item,
+ * M4U_LAZY_FREE_DELAY_MS after the first park or as soon as
+ * M4U_LAZY_FREE_MAX mvas are waiting: one range invalidate per merged
+ * range, or a single full invalidate once more than M4U_LAZY_FREE_RANGES
+ * disjoint ranges piled up.  A parked mva keeps its buf_info and only goes
+ * back to the allocator after that flush; an allocation running out of mva
+ * space flushes the queue itself and retries.
+ */
+#define M4U_LAZY_FREE_MAX	32
+#define M4U_LAZY_FREE_RANGES	8
+#define M4U_LAZY_FREE_DELAY_MS	10
+
+static LIST_HEAD(m4u_lazy_free_list);
+static DEFINE_MUTEX(m4u_lazy_free_mutex);
+static unsigned int m4u_lazy_free_cnt;
+static struct m4u_tlb_range m4u_lazy_range[M4U_LAZY_FREE_RANGES];
+static int m4u_lazy_nr_range;	/* > M4U_LAZY_FREE_RANGES: flush all */
+static unsigned long m4u_lazy_free_total, m4u_lazy_retry_cnt;
+static unsigned long m4u_lazy_batch_cnt, m4u_lazy_range_flush_cnt, m4u_lazy_full_flush_cnt;
+
+static void m4u_lazy_free_work_fn(struct work_struct *work);
+static DECLARE_DELAYED_WORK(m4u_lazy_free_work, m4u_lazy_free_work_fn);
+
+static void m4u_lazy_free_add_range(unsigned int start, unsigned int end)
+{
+	struct m4u_tlb_range *r;
+	int i;
+
+	if (m4u_lazy_nr_range > M4U_LAZY_FREE_RANGES)
+		return;
+
+	for (i = 0; i < m4u_lazy_nr_range; i++) {
+		r = &m4u_lazy_range[i];
+		/* overlapping or adjacent */
+		if (start <= r->end + 1 && end + 1 >= r->start) {
+			r->start = min(r->start, start);
+			r->end = max(r->end, end);
+			return;
+		}
+	}
+
+	if (m4u_lazy_nr_range < M4U_LAZY_FREE_RANGES) {
+		m4u_lazy_range[m4u_lazy_nr_range].start = start;
+		m4u_lazy_range[m4u_lazy_nr_range].end = end;
+	}
+	m4u_lazy_nr_range++;
+}
+
+/* returns the number of mva released, m4u_lazy_free_mutex must be held */
+static int m4u_lazy_free_drain_locked(void)
+{
+	m4u_buf_info_t *pMvaInfo, *next;
+	m4u_domain_t *domain;
+	int cnt = 0;
+
+	if (list_empty(&m4u_lazy_free_list))
+		return 0;
+
+	pMvaInfo = list_first_entry(&m4u_lazy_free_list, m4u_buf_info_t, link);
+	domain = m4u_get_domain_by_port(pMvaInfo->port);
+	if (m4u_lazy_nr_range > M4U_LAZY_FREE_RANGES) {
+		m4u_flush_tlb_all(domain);
+		m4u_lazy_full_flush_cnt++;
+	} else {
+		m4u_flush_tlb_ranges(domain, m4u_lazy_range, m4u_lazy_nr_range);
+		m4u_lazy_range_flush_cnt += m4u_lazy_nr_range;
+	}
+
+	list_for_each_entry_safe(pMvaInfo, next, &m4u_lazy_free_list, link) {
+		list_del(&pMvaInfo->link);
+		if (m4u_do_mva_free(pMvaInfo->mva, pMvaInfo->size))
+			M4UMSG("lazy do_mva_free fail: mva=0x%x, size=0x%x\n",
+			       pMvaInfo->mva, pMvaInfo->size);
+		m4u_free_buf_info(pMvaInfo);
+		cnt++;
+	}
+
+	m4u_lazy_free_cnt = 0;
+	m4u_lazy_nr_range = 0;
+	m4u_lazy_batch_cnt++;
+	return cnt;
+}
+
+static int m4u_lazy_free_drain(void)
+{
+	int cnt;
+
+	mutex_lock(&m4u_lazy_free_mutex);
+	cnt = m4u_lazy_free_drain_locked();
+	mutex_unlock(&m4u_lazy_free_mutex);
+	return cnt;
+}
+
+static void m4u_lazy_free_work_fn(struct work_struct *work)
+{
+	m4u_lazy_free_drain();
+}
+
+/* the page table of pMvaInfo is already cleared by m4u_unmap_lazy() */
+static void m4u_lazy_free_park(m4u_buf_info_t *pMvaInfo)
+{
+	mutex_lock(&m4u_lazy_free_mutex);
+	list_add_tail(&pMvaInfo->link, &m4u_lazy_free_list);
+	m4u_lazy_free_add_range(pMvaInfo->mva_align,
+				pMvaInfo->mva_align + pMvaInfo->size_align - 1);
+	m4u_lazy_free_total++;
+
+	/* the caller never waits for the invalidate */
+	if (++m4u_lazy_free_cnt >= M4U_LAZY_FREE_MAX)
+		mod_delayed_work(system_wq, &m4u_lazy_free_work, 0);
+	else
+		schedule_delayed_work(&m4u_lazy_free_work,
+				      msecs_to_jiffies(M4U_LAZY_FREE_DELAY_MS));
+	mutex_unlock(&m4u_lazy_free_mutex);
+}
+
+static void m4u_lazy_free_show(struct seq_file *seq)
+{
+	M4U_PRINT_LOG_OR_SEQ(seq,
+		"lazy free: parked %u, freed %lu, batch %lu, range flush %lu, full flush %lu, retry %lu\n",
+		m4u_lazy_free_cnt, m4u_lazy_free_total, m4u_lazy_batch_cnt,
+		m4u_lazy_range_flush_cnt, m4u_lazy_full_flush_cnt, m4u_lazy_retry_cnt);
+}
+
 /* #define __M4U_MAP_MVA_TO_KERNEL_FOR_DEBUG__ */
 
 int m4u_alloc_mva(m4u_client_t *client, M4U_PORT_ID port,
@@ -638,6 +773,14 @@ int m4u_alloc_mva(m4u_client_t *client, M4U_PORT_ID port,
 	else
 		mva = m4u_do_mva_alloc(va, size, pMvaInfo);
 
+	if (mva == 0 && m4u_lazy_free_drain()) {
+		m4u_lazy_retry_cnt++;
+		if (flags & M4U_FLAGS_FIX_MVA)
+			mva = m4u_do_mva_alloc_fix(*pMva, size, pMvaInfo);
+		else
+			mva = m4u_do_mva_alloc(va, size, pMvaInfo);
+	}
+
 	if (mva == 0) {
 		m4u_aee_print("alloc mva fail: larb=%d,module=%s,size=%d\n",
 				m4u_port_2_larb_id(port), m4u_get_port_name(port), size);
@@ -773,7 +916,7 @@ int m4u_dealloc_mva_sg(int eModuleID, struct sg_table *sg_table,
 int m4u_dealloc_mva(m4u_client_t *client, M4U_PORT_ID port, unsigned int mva)
 {
 	m4u_buf_info_t *pMvaInfo;
-	int ret, is_err = 0;
+	int ret, is_err = 0, lazy;
 	unsigned int size;
 
 	MMProfileLogEx(M4U_MMP_Events[M4U_MMP_DEALLOC_MVA], MMProfileFlagStart, port, mva);
@@ -797,7 +940,14 @@ int m4u_dealloc_mva(m4u_client_t *client, M4U_PORT_ID port, unsigned int mva)
 		m4u_unmap_nonsec_buffer(mva, pMvaInfo->size);
 #endif
 
-	ret = m4u_unmap(m4u_get_domain_by_port(port), pMvaInfo->mva_align, pMvaInfo->size_align);
+	/* ion buffers: the mva is only released with the next batched TLB flush */
+	lazy = !pMvaInfo->va && !(pMvaInfo->flags & M4U_FLAGS_SEC_SHAREABLE);
+	if (lazy)
+		ret = m4u_unmap_lazy(m4u_get_domain_by_port(port), pMvaInfo->mva_align,
+				     pMvaInfo->size_align);
+	else
+		ret = m4u_unmap(m4u_get_domain_by_port(port), pMvaInfo->mva_align,
+				pMvaInfo->size_align);
 	if (ret) {
 		is_err = 1;
 		M4UMSG("m4u_unmap fail\n");
@@ -812,8 +962,7 @@ int m4u_dealloc_mva(m4u_client_t *client, M4U_PORT_ID port, unsigned int mva)
 		}
 	}
 
-	ret = m4u_do_mva_free(mva, pMvaInfo->size);
-	if (ret) {
+	if (!lazy && m4u_do_mva_free(mva, pMvaInfo->size)) {
 		is_err = 1;
 		M4UMSG("do_mva_free fail\n");
 	}
@@ -848,7 +997,10 @@ int m4u_dealloc_mva(m4u_client_t *client, M4U_PORT_ID port, unsigned int mva)
 	}
 #endif
 
-	m4u_free_buf_info(pMvaInfo);
+	if (lazy)
+		m4u_lazy_free_park(pMvaInfo);
+	else
+		m4u_free_buf_info(pMvaInfo);
 
 	MMProfileLogEx(M4U_MMP_Events[M4U_MMP_DEALLOC_MVA], MMProfileFlagEnd, size, mva);
 
@@ -877,6 +1029,10 @@ static void *m4u_cache_map_page_va(struct page *page)
 	int ret;
 	struct page **ppPage = &page;
 
+	/* lowmem is in the linear map already */
+	if (!PageHighMem(page))
+		return page_address(page);
+
 	ret = map_vm_area(cache_map_vm_struct, PAGE_KERNEL, ppPage);
 	if (ret) {
 		M4UMSG("error to map page\n");
@@ -885,9 +1041,10 @@ static void *m4u_cache_map_page_va(struct page *page)
 	return cache_map_vm_struct->addr;
 }
 
-static void m4u_cache_unmap_page_va(unsigned int va)
+static void m4u_cache_unmap_page_va(unsigned long va)
 {
-	unmap_kernel_range((unsigned long)cache_map_vm_struct->addr, PAGE_SIZE);
+	if (va == (unsigned long)cache_map_vm_struct->addr)
+		unmap_kernel_range(va, PAGE_SIZE);
 }
 
 
@@ -1172,6 +1329,15 @@ long m4u_dma_op(m4u_client_t *client, M4U_PORT_ID port,
 		}
 
 		BUG_ON(i >= npages);
+		if (!PageHighMem(page)) {
+			/* one range for the whole entry */
+			start = (unsigned long)page_address(page);
+			if (dma_type == M4U_DMA_MAP_AREA)
+				m4u_dma_map_area((void *)start, npages_this_entry * PAGE_SIZE, dma_dir);
+			else if (dma_type == M4U_DMA_UNMAP_AREA)
+				m4u_dma_unmap_area((void *)start, npages_this_entry * PAGE_SIZE, dma_dir);
+			continue;
+		}
 		for (j = 0; j < npages_this_entry; j++) {
 			start = (unsigned long) m4u_cache_map_page_va(page++);
 
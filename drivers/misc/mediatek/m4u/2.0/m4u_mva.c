@@ -23,6 +23,70 @@ static short mvaGraph[MVA_MAX_BLOCK_NR + 1];
 static void *mvaInfoGraph[MVA_MAX_BLOCK_NR + 1];
 static DEFINE_SPINLOCK(gMvaGraph_lock);
 
+/*
+ * Free regions are also linked by size: bin b holds the regions of
+ * 2^b .. 2^(b+1)-1 blocks, linked through their head index (index 0 is
+ * always busy, so 0 ends a list).  Allocation looks at the bins instead
+ * of walking every region of the graph.
+ */
+#define MVA_FREE_BIN_NR		12
+
+static short mvaFreeBin[MVA_FREE_BIN_NR];
+static short mvaFreeNext[MVA_MAX_BLOCK_NR + 1];
+static short mvaFreePrev[MVA_MAX_BLOCK_NR + 1];
+static short mvaFreeBinCnt[MVA_FREE_BIN_NR];
+static unsigned int mvaAllocFailCnt;
+
+static inline int mva_free_bin(short nr)
+{
+	return fls(nr) - 1;
+}
+
+static void mva_free_insert(short index)
+{
+	int bin = mva_free_bin(MVA_GET_NR(index));
+	short head = mvaFreeBin[bin];
+
+	mvaFreePrev[index] = 0;
+	mvaFreeNext[index] = head;
+	if (head)
+		mvaFreePrev[head] = index;
+	mvaFreeBin[bin] = index;
+	mvaFreeBinCnt[bin]++;
+}
+
+/* call before the region size in mvaGraph changes */
+static void mva_free_remove(short index)
+{
+	int bin = mva_free_bin(MVA_GET_NR(index));
+	short prev = mvaFreePrev[index], next = mvaFreeNext[index];
+
+	if (prev)
+		mvaFreeNext[prev] = next;
+	else
+		mvaFreeBin[bin] = next;
+	if (next)
+		mvaFreePrev[next] = prev;
+	mvaFreeBinCnt[bin]--;
+}
+
+/* free region of at least nr blocks, 0 if none */
+static short mva_free_find(short nr)
+{
+	int bin;
+	short s;
+
+	for (bin = mva_free_bin(nr); bin < MVA_FREE_BIN_NR; bin++) {
+		/* only the first bin may hold regions smaller than nr */
+		for (s = mvaFreeBin[bin]; s && MVA_GET_NR(s) < nr; s = mvaFreeNext[s])
+			;
+		if (s)
+			return s;
+	}
+
+	return 0;
+}
+
 void m4u_mvaGraph_init(void *priv_reserve)
 {
 	unsigned long irq_flags;
@@ -37,6 +101,11 @@ void m4u_mvaGraph_init(void *priv_reserve)
 	mvaGraph[MVA_MAX_BLOCK_NR] = MVA_MAX_BLOCK_NR;
 	mvaInfoGraph[MVA_MAX_BLOCK_NR] = priv_reserve;
 
+	memset(mvaFreeBin, 0, sizeof(mvaFreeBin));
+	memset(mvaFreeBinCnt, 0, sizeof(mvaFreeBinCnt));
+	mvaAllocFailCnt = 0;
+	mva_free_insert(1);
+
 	spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
 }
 
@@ -58,7 +127,9 @@ void m4u_mvaGraph_dump(void)
 	short index = 1, nr = 0;
 	int i, max_bit, is_busy;
 	short frag[12] = { 0 };
-	short nr_free = 0, nr_alloc = 0;
+	short nr_free = 0, nr_alloc = 0, largest = 0;
+	short bin_cnt[MVA_FREE_BIN_NR];
+	unsigned int fail_cnt;
 	unsigned long irq_flags;
 
 	M4ULOG_HIGH("[M4U_K] mva allocation info dump:====================>\n");
@@ -87,6 +158,13 @@ void m4u_mvaGraph_dump(void)
 		M4ULOG_HIGH("0x%08x  0x%08x  %4d    %d\n", addr, size, nr, is_busy);
 	}
 
+	for (i = MVA_FREE_BIN_NR - 1; i >= 0 && !largest; i--) {
+		for (index = mvaFreeBin[i]; index; index = mvaFreeNext[index])
+			largest = max_t(short, largest, MVA_GET_NR(index));
+	}
+	memcpy(bin_cnt, mvaFreeBinCnt, sizeof(bin_cnt));
+	fail_cnt = mvaAllocFailCnt;
+
 	spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
 
 	M4ULOG_HIGH("\n");
@@ -97,6 +175,11 @@ void m4u_mvaGraph_dump(void)
 	M4ULOG_HIGH("%4d  %4d  %4d  %4d  %4d  %4d  %4d  %4d  %4d  %4d  %4d  %4d\n",
 			frag[0], frag[1], frag[2], frag[3], frag[4], frag[5], frag[6],
 			frag[7], frag[8], frag[9], frag[10], frag[11]);
+	for (i = 0; i < MVA_FREE_BIN_NR; i++) {
+		if (bin_cnt[i] != frag[i])
+			M4UMSG("mva free bin %d holds %d regions, graph has %d\n", i, bin_cnt[i], frag[i]);
+	}
+	M4ULOG_HIGH("largest free region: %d blocks, alloc failures: %u\n", largest, fail_cnt);
 	M4ULOG_HIGH("[M4U_K] mva alloc dump done=========================<\n");
 }
 
@@ -217,10 +300,10 @@ unsigned int m4u_do_mva_alloc(unsigned long va, unsigned int size, void *priv)
 	spin_lock_irqsave(&gMvaGraph_lock, irq_flags);
 
 	/* ----------------------------------------------- */
-	/* find first match free region */
-	for (s = 1; (s < (MVA_MAX_BLOCK_NR + 1)) && (mvaGraph[s] < nr); s += (mvaGraph[s] & MVA_BLOCK_NR_MASK))
-		;
-	if (s > MVA_MAX_BLOCK_NR) {
+	/* find a free region large enough */
+	s = mva_free_find(nr);
+	if (!s) {
+		mvaAllocFailCnt++;
 		spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
 		M4UMSG("mva_alloc error: no available MVA region for %d blocks!\n", nr);
 		MMProfileLogEx(M4U_MMP_Events[M4U_MMP_M4U_ERROR], MMProfileFlagPulse, size, s);
@@ -230,6 +313,7 @@ unsigned int m4u_do_mva_alloc(unsigned long va, unsigned int size, void *priv)
 	/* ----------------------------------------------- */
 	/* alloc a mva region */
 	end = s + mvaGraph[s] - 1;
+	mva_free_remove(s);
 
 	if (unlikely(nr == mvaGraph[s])) {
 		MVA_SET_BUSY(s);
@@ -247,6 +331,7 @@ unsigned int m4u_do_mva_alloc(unsigned long va, unsigned int size, void *priv)
 
 		mvaInfoGraph[s] = priv;
 		mvaInfoGraph[new_end] = priv;
+		mva_free_insert(new_start);
 	}
 
 	spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
@@ -296,6 +381,7 @@ unsigned int m4u_do_mva_alloc_fix(unsigned int mva, unsigned int size, void *pri
 	/* carveout startIdx~startIdx+nr-1 out of region_start */
 	endIdx = startIdx + nr - 1;
 	region_end = region_start + MVA_GET_NR(region_start) - 1;
+	mva_free_remove(region_start);
 
 	if (startIdx == region_start && endIdx == region_end) {
 		MVA_SET_BUSY(startIdx);
@@ -305,11 +391,13 @@ unsigned int m4u_do_mva_alloc_fix(unsigned int mva, unsigned int size, void *pri
 		mvaGraph[endIdx] = mvaGraph[startIdx];
 		mvaGraph[endIdx + 1] = region_end - endIdx;
 		mvaGraph[region_end] = mvaGraph[endIdx + 1];
+		mva_free_insert(endIdx + 1);
 	} else if (endIdx == region_end) {
 		mvaGraph[region_start] = startIdx - region_start;
 		mvaGraph[startIdx - 1] = mvaGraph[region_start];
 		mvaGraph[startIdx] = nr | MVA_BUSY_MASK;
 		mvaGraph[endIdx] = mvaGraph[startIdx];
+		mva_free_insert(region_start);
 	} else {
 		mvaGraph[region_start] = startIdx - region_start;
 		mvaGraph[startIdx - 1] = mvaGraph[region_start];
@@ -317,6 +405,8 @@ unsigned int m4u_do_mva_alloc_fix(unsigned int mva, unsigned int size, void *pri
 		mvaGraph[endIdx] = mvaGraph[startIdx];
 		mvaGraph[endIdx + 1] = region_end - endIdx;
 		mvaGraph[region_end] = mvaGraph[endIdx + 1];
+		mva_free_insert(region_start);
+		mva_free_insert(endIdx + 1);
 	}
 
 	mvaInfoGraph[startIdx] = priv;
@@ -367,6 +457,7 @@ int m4u_do_mva_free(unsigned int mva, unsigned int size)
 	/* -------------------------------- */
 	/* merge with followed region */
 	if ((endIdx + 1 <= MVA_MAX_BLOCK_NR) && (!MVA_IS_BUSY(endIdx + 1))) {
+		mva_free_remove(endIdx + 1);
 		nr += mvaGraph[endIdx + 1];
 		mvaGraph[endIdx] = 0;
 		mvaGraph[endIdx + 1] = 0;
@@ -376,6 +467,7 @@ int m4u_do_mva_free(unsigned int mva, unsigned int size)
 	if ((startIdx - 1 > 0) && (!MVA_IS_BUSY(startIdx - 1))) {
 		int pre_nr = mvaGraph[startIdx - 1];
 
+		mva_free_remove(startIdx - pre_nr);
 		mvaGraph[startIdx] = 0;
 		mvaGraph[startIdx - 1] = 0;
 		startIdx -= pre_nr;
@@ -385,6 +477,7 @@ int m4u_do_mva_free(unsigned int mva, unsigned int size)
 	/* set region flags */
 	mvaGraph[startIdx] = nr;
 	mvaGraph[startIdx + nr - 1] = nr;
+	mva_free_insert(startIdx);
 
 	spin_unlock_irqrestore(&gMvaGraph_lock, irq_flags);
 
@@ -699,21 +699,40 @@ err_out:
 	return -1;
 }
 
+/* mix of descriptor sizes emitted by the map paths, see debugfs pgsize */
+enum {
+	M4U_PGSIZE_4K,
+	M4U_PGSIZE_64K,
+	M4U_PGSIZE_1M,
+	M4U_PGSIZE_16M,
+	M4U_PGSIZE_NR,
+};
+
+static const char * const m4u_pgsize_name[M4U_PGSIZE_NR] = {
+	"4K", "64K", "1M", "16M"
+};
+
+static atomic_t m4u_pgsize_cnt[M4U_PGSIZE_NR];
+
 /* notes: both iova & paddr should be aligned. */
 static inline int m4u_map_phys_align(m4u_domain_t *m4u_domain, unsigned int iova,
 				     unsigned long paddr, unsigned int size, unsigned int prot)
 {
 	int ret;
 
-	if (size == SZ_16M)
+	if (size == SZ_16M) {
 		ret = m4u_map_16M(m4u_domain, iova, paddr, prot);
-	else if (size == SZ_1M)
+		atomic_inc(&m4u_pgsize_cnt[M4U_PGSIZE_16M]);
+	} else if (size == SZ_1M) {
 		ret = m4u_map_1M(m4u_domain, iova, paddr, prot);
-	else if (size == SZ_64K)
+		atomic_inc(&m4u_pgsize_cnt[M4U_PGSIZE_1M]);
+	} else if (size == SZ_64K) {
 		ret = m4u_map_64K(m4u_domain, iova, paddr, prot);
-	else if (size == SZ_4K)
+		atomic_inc(&m4u_pgsize_cnt[M4U_PGSIZE_64K]);
+	} else if (size == SZ_4K) {
 		ret = m4u_map_4K(m4u_domain, iova, paddr, prot);
-	else {
+		atomic_inc(&m4u_pgsize_cnt[M4U_PGSIZE_4K]);
+	} else {
 		m4u_aee_print("%s: fail size=0x%x\n", __func__, size);
 		return -1;
 	}
@@ -817,6 +836,15 @@ int m4u_map_phys_range(m4u_domain_t *m4u_domain, unsigned int iova,
 	return ret;
 }
 
+static inline unsigned int m4u_sg_len(struct scatterlist *sg)
+{
+#ifdef CONFIG_NEED_SG_DMA_LENGTH
+	if (0 == sg_dma_address(sg))
+		return sg->length;
+#endif
+	return sg_dma_len(sg);
+}
+
 int m4u_map_sgtable(m4u_domain_t *m4u_domain, unsigned int mva,
 		    struct sg_table *sg_table, unsigned int size, unsigned int prot)
 {
@@ -833,11 +861,18 @@ int m4u_map_sgtable(m4u_domain_t *m4u_domain, unsigned int mva,
 		unsigned int len;
 
 		pa = get_sg_phys(sg);
-		len = sg_dma_len(sg);
-#ifdef CONFIG_NEED_SG_DMA_LENGTH
-		if (0 == sg_dma_address(sg))
-			len = sg->length;
-#endif
+		len = m4u_sg_len(sg);
+
+		/*
+		 * Merge physically adjacent entries so that a run of small
+		 * chunks can still be covered by 64K/1M descriptors.
+		 */
+		while (i + 1 < sg_table->nents && !sg_is_last(sg) &&
+		       get_sg_phys(sg_next(sg)) == pa + len) {
+			sg = sg_next(sg);
+			len += m4u_sg_len(sg);
+			i++;
+		}
 
 		M4ULOG_LOW("%s: for_each_sg i: %d, len: %d, mva: 0x%x\n", __func__, i, len, map_mva);
 
@@ -847,6 +882,7 @@ int m4u_map_sgtable(m4u_domain_t *m4u_domain, unsigned int mva,
 		}
 		if (len == SZ_4K) {	/* for most cases */
 			ret = m4u_map_4K(m4u_domain, map_mva, pa, prot);
+			atomic_inc(&m4u_pgsize_cnt[M4U_PGSIZE_4K]);
 		} else {
 			ret = m4u_map_phys_range(m4u_domain, map_mva, pa, len, prot);
 		}
@@ -902,7 +938,8 @@ int m4u_check_free_pte(m4u_domain_t *domain, imu_pgd_t *pgd)
 	}
 }
 
-int m4u_unmap(m4u_domain_t *domain, unsigned int mva, unsigned int size)
+static int __m4u_unmap(m4u_domain_t *domain, unsigned int mva, unsigned int size,
+		       int flush_tlb)
 {
 	imu_pgd_t *pgd;
 	int i, ret;
@@ -952,12 +989,45 @@ int m4u_unmap(m4u_domain_t *domain, unsigned int mva, unsigned int size)
 		}
 	}
 
-	m4u_invalid_tlb_by_range(domain, start, end_plus_1 - 1);
+	if (flush_tlb)
+		m4u_invalid_tlb_by_range(domain, start, end_plus_1 - 1);
 
 	write_unlock_domain(domain);
 	return 0;
 }
 
+int m4u_unmap(m4u_domain_t *domain, unsigned int mva, unsigned int size)
+{
+	return __m4u_unmap(domain, mva, size, 1);
+}
+
+/*
+ * Clear the page table only: the TLB may keep translating the range until
+ * it is covered by m4u_flush_tlb_ranges() or m4u_flush_tlb_all(), so the
+ * mva must not be reused before.
+ */
+int m4u_unmap_lazy(m4u_domain_t *domain, unsigned int mva, unsigned int size)
+{
+	return __m4u_unmap(domain, mva, size, 0);
+}
+
+void m4u_flush_tlb_ranges(m4u_domain_t *domain, const struct m4u_tlb_range *range, int nr)
+{
+	int i;
+
+	write_lock_domain(domain);
+	for (i = 0; i < nr; i++)
+		m4u_invalid_tlb_by_range(domain, range[i].start, range[i].end);
+	write_unlock_domain(domain);
+}
+
+void m4u_flush_tlb_all(m4u_domain_t *domain)
+{
+	write_lock_domain(domain);
+	m4u_invalid_tlb_by_domain(domain);
+	write_unlock_domain(domain);
+}
+
 int m4u_debug_pgtable_show(struct seq_file *s, void *unused)
 {
 	m4u_dump_pgtable(s->private, s);
@@ -976,6 +1046,28 @@ const struct file_operations m4u_debug_pgtable_fops = {
 	.release = seq_release,
 };
 
+static int m4u_debug_pgsize_show(struct seq_file *s, void *unused)
+{
+	int i;
+
+	for (i = 0; i < M4U_PGSIZE_NR; i++)
+		seq_printf(s, "%s: %d\n", m4u_pgsize_name[i],
+			   atomic_read(&m4u_pgsize_cnt[i]));
+	return 0;
+}
+
+static int m4u_debug_pgsize_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, m4u_debug_pgsize_show, inode->i_private);
+}
+
+static const struct file_operations m4u_debug_pgsize_fops = {
+	.open = m4u_debug_pgsize_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 int m4u_pgtable_init(struct m4u_device *m4u_dev, m4u_domain_t *m4u_domain)
 {
 	/* ======= alloc pagetable======================= */
@@ -1002,6 +1094,7 @@ int m4u_pgtable_init(struct m4u_device *m4u_dev, m4u_domain_t *m4u_domain)
 		return -1;
 
 	debugfs_create_file("pgtable", 0644, m4u_dev->debug_root, m4u_domain, &m4u_debug_pgtable_fops);
+	debugfs_create_file("pgsize", 0444, m4u_dev->debug_root, m4u_domain, &m4u_debug_pgsize_fops);
 
 	return 0;
 }
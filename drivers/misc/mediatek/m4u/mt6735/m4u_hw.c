@@ -90,6 +90,14 @@ void m4u_invalid_tlb_by_range(m4u_domain_t *m4u_domain, unsigned int mva_start,
    /* m4u_invalid_tlb_all(1); */
 }
 
+void m4u_invalid_tlb_by_domain(m4u_domain_t *m4u_domain)
+{
+	int i;
+
+	for (i = 0; i < TOTAL_M4U_NUM; i++)
+		m4u_invalid_tlb_all(i);
+}
+
 void m4u_invalid_tlb_sec(int m4u_id, int L2_en, int isInvAll, unsigned int mva_start, unsigned int mva_end)
 {
 	unsigned int reg = 0;
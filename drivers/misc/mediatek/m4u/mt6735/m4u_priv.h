@@ -170,6 +170,7 @@ unsigned long m4u_get_pte(m4u_domain_t *domain, unsigned int mva);
 /* ================================= */
 /* ==== define in m4u_hw.c     ===== */
 void m4u_invalid_tlb_by_range(m4u_domain_t *m4u_domain, unsigned int mva_start, unsigned int mva_end);
+void m4u_invalid_tlb_by_domain(m4u_domain_t *m4u_domain);
 m4u_domain_t *m4u_get_domain_by_port(M4U_PORT_ID port);
 m4u_domain_t *m4u_get_domain_by_id(int id);
 int m4u_get_domain_nr(void);
@@ -197,6 +198,16 @@ int m4u_dump_buf_info(struct seq_file *seq);
 int m4u_map_sgtable(m4u_domain_t *m4u_domain, unsigned int mva,
 		    struct sg_table *sg_table, unsigned int size, unsigned int prot);
 int m4u_unmap(m4u_domain_t *domain, unsigned int mva, unsigned int size);
+int m4u_unmap_lazy(m4u_domain_t *domain, unsigned int mva, unsigned int size);
+
+/* inclusive mva range of a batched TLB invalidate */
+struct m4u_tlb_range {
+	unsigned int start;
+	unsigned int end;
+};
+
+void m4u_flush_tlb_ranges(m4u_domain_t *domain, const struct m4u_tlb_range *range, int nr);
+void m4u_flush_tlb_all(m4u_domain_t *domain);
 
 
 void m4u_get_pgd(m4u_client_t *client, M4U_PORT_ID port, void **pgd_va, void **pgd_pa, unsigned int *size);
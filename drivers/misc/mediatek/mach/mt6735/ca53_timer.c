@@ -437,15 +437,20 @@ static u64 arch_counter_get_cntvct_mem(void)
  */
 u64 (*arch_timer_read_counter)(void) = arch_counter_get_cntpct; /*need used pct because VCT's OFFSET counter in bootup*/
 
-#if 0
+/*
+ * The vDSO reads CNTVCT, so the clocksource does too: with a non zero
+ * CNTVOFF the kernel and the userspace clock have to count the same.
+ */
+static u64 (*arch_counter_read_cs)(void) = arch_counter_get_cntvct;
+
 static cycle_t arch_counter_read(struct clocksource *cs)
 {
-	return arch_timer_read_counter();
+	return arch_counter_read_cs();
 }
 
 static cycle_t arch_counter_read_cc(const struct cyclecounter *cc)
 {
-	return arch_timer_read_counter();
+	return arch_counter_read_cs();
 }
 
 static struct clocksource clocksource_counter = {
@@ -453,14 +458,13 @@ static struct clocksource clocksource_counter = {
 	.rating	= 400,
 	.read	= arch_counter_read,
 	.mask	= CLOCKSOURCE_MASK(56),
-	.flags	= CLOCK_SOURCE_IS_CONTINUOUS | CLOCK_SOURCE_SUSPEND_NONSTOP,
+	.flags	= CLOCK_SOURCE_IS_CONTINUOUS,
 };
 
 static struct cyclecounter cyclecounter = {
 	.read	= arch_counter_read_cc,
 	.mask	= CLOCKSOURCE_MASK(56),
 };
-#endif
 
 static struct timecounter timecounter;
 
@@ -471,30 +475,36 @@ struct timecounter *arch_timer_get_timecounter(void)
 
 static void __init arch_counter_register(unsigned type)
 {
-	/*u64 start_count*/;
+	u64 start_count;
 
 	/* Register the CP15 based counter if we have one */
 	if (type & ARCH_CP15_TIMER) {
 		arch_timer_read_counter = arch_counter_get_cntpct; /*same as line 427*/
 	} else {
 		arch_timer_read_counter = arch_counter_get_cntvct_mem;
+		arch_counter_read_cs = arch_counter_get_cntvct_mem;
 
 		/* If the clocksource name is "arch_sys_counter" the
 		 * VDSO will attempt to read the CP15-based counter.
 		 * Ensure this does not happen when CP15-based
 		 * counter is not available.
 		 */
-		/*clocksource_counter.name = "arch_mem_counter";*/ /*used APXGPT as clocksource, no need this*/
+		clocksource_counter.name = "arch_mem_counter";
 	}
-#if 0
-	start_count = arch_timer_read_counter();
+
+	/*
+	 * A system register read instead of the 32 bit APXGPT over MMIO for
+	 * timekeeping and sched_clock, and one clock_gettime() can take
+	 * without a syscall.  The APXGPT stays as the lower rated fallback.
+	 */
+	start_count = arch_counter_read_cs();
 	clocksource_register_hz(&clocksource_counter, arch_timer_rate);
 	cyclecounter.mult = clocksource_counter.mult;
 	cyclecounter.shift = clocksource_counter.shift;
 	timecounter_init(&timecounter, &cyclecounter, start_count);
-#endif
+
 	/* 56 bits minimum, so we assume worst case rollover */
-	/*sched_clock_register(arch_timer_read_counter, 56, arch_timer_rate); *//*used MTK APXGPT as clocksource*/
+	sched_clock_register(arch_timer_read_counter, 56, arch_timer_rate);
 }
 
 static void arch_timer_stop(struct clock_event_device *clk)
@@ -6,6 +6,9 @@
 #include <linux/printk.h>
 #include <linux/init.h>
 #include <linux/rwlock.h>
+#include <linux/delay.h>
+#include <linux/moduleparam.h>
+#include <linux/mmzone.h>
 
 /* Trigger method for screen on/off */
 #ifdef CONFIG_HAS_EARLYSUSPEND
@@ -47,6 +50,24 @@ static int get_cma_num;				/* Number of allocation */
 static unsigned long get_cma_size;		/* in PAGES */
 static struct page **cma_aligned_pages;
 
+/*
+ * Pages that are pinned or under writeback fail migration for a while, so
+ * collection is retried a few times before entering screenoff with the
+ * segments that could be cleared.
+ */
+#define MLPT_ACQUIRE_RETRIES	3
+#define MLPT_ACQUIRE_DELAY_MS	50
+
+#ifdef CONFIG_CMA
+/*
+ * Movable allocations stay out of CMA (and so out of the lowpower area)
+ * while this many pages are free elsewhere, which keeps the segments empty
+ * and screenoff migration short.  Defaults to the size of the area.
+ */
+module_param_named(steer_free_pages, cma_fallback_free_pages, ulong,
+		S_IRUGO | S_IWUSR);
+#endif
+
 /*
  * Set aligned allocation -
  * @aligned: Requested alignment of pages (in PAGE_SIZE order).
@@ -129,7 +150,7 @@ static int acquire_memory(void)
 	while (i < get_cma_num) {
 		ret = get_memory_lowpower_cma_aligned(get_cma_size, get_cma_aligned, &page);
 		if (ret)
-			break;
+			return ret;
 		MLPT_PRINT("%s: PFN[%lu] allocated for [%d]\n", __func__, page_to_pfn(page), i);
 		insert_buffer(page, i);
 		++i;
@@ -339,6 +360,8 @@ static void __go_to_screenoff(void)
 /* Screen-off operations */
 static void go_to_screenoff(void)
 {
+	int retries = 0;
+
 	MLPT_PRINT("%s:+\n", __func__);
 	MLPT_START_PROFILE();
 
@@ -351,13 +374,14 @@ static void go_to_screenoff(void)
 	/* Collect free pages */
 	do {
 		/* Try to collect free pages. If done or can't proceed, then break. */
-		if (!acquire_memory())
+		if (!acquire_memory() || ++retries > MLPT_ACQUIRE_RETRIES)
 			break;
 
 		/* Action is changed, just leave here. */
 		if (!IS_ACTION_SCREENOFF(memory_lowpower_action))
 			goto out;
 
+		msleep(MLPT_ACQUIRE_DELAY_MS);
 	} while (1);
 
 	/* Clear SCREENON state */
@@ -514,6 +538,12 @@ int __init memory_lowpower_task_init(void)
 	}
 #endif
 
+#ifdef CONFIG_CMA
+	/* Steer movable allocations away from the lowpower area */
+	if (!cma_fallback_free_pages)
+		cma_fallback_free_pages = memory_lowpower_cma_size() >> PAGE_SHIFT;
+#endif
+
 	/* Set expected current state */
 	SetMlpsInit(&memory_lowpower_state);
 	SetMlpsScreenOn(&memory_lowpower_state);
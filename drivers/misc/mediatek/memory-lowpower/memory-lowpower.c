@@ -92,10 +92,12 @@ int put_memory_lowpower_cma_aligned(int count, struct page *pages)
 /*
  * get_memory_lowpwer_cma - allocate all cma memory belongs to lowpower cma
  *
+ * It returns 0 is success, otherwise returns -1
  */
 int get_memory_lowpower_cma(void)
 {
 	int count = cma_get_size(cma) >> PAGE_SHIFT;
+	int ret = 0;
 
 	if (cma_pages) {
 		pr_alert("cma already collected\n");
@@ -106,15 +108,17 @@ int get_memory_lowpower_cma(void)
 
 	cma_pages = cma_alloc(cma, count, 0);
 
-	if (cma_pages)
+	if (cma_pages) {
 		pr_debug("%s:%d ok\n", __func__, __LINE__);
-	else
+	} else {
 		pr_alert("lowpower cma allocation failed\n");
+		ret = -1;
+	}
 
 	mutex_unlock(&memory_lowpower_mutex);
 
 out:
-	return 0;
+	return ret;
 }
 
 /*
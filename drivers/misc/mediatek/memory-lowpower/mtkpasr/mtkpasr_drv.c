@@ -22,6 +22,10 @@ unsigned long bank_pfns;
 /* Internal control parameters */
 static unsigned long mtkpasr_triggered, mtkpasr_on, mtkpasr_srmask;
 
+/* Segments powered off by the last config, and over all configs */
+static int mtkpasr_last_segments;
+static unsigned long mtkpasr_total_segments;
+
 /* Count the number of free pages */
 static void count_free_pages(unsigned long *spfn, unsigned long *epfn)
 {
@@ -81,6 +85,8 @@ static int mtkpasr_config(int times, get_range_t func)
 	MTKPASR_PRINT("%s: PASR[0x%lx]\n", __func__, mtkpasr_on);
 
 	++mtkpasr_triggered;
+	mtkpasr_last_segments = hweight_long(mtkpasr_on);
+	mtkpasr_total_segments += mtkpasr_last_segments;
 
 	MTKPASR_PRINT("%s:-\n", __func__);
 
@@ -159,6 +165,12 @@ static ssize_t mtkpasr_status_show(struct device *dev, struct device_attribute *
 	return sprintf(buf, "Triggered [%lu]times :: Last PASR[0x%lx]\n", mtkpasr_triggered, mtkpasr_on);
 }
 
+static ssize_t segments_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	return sprintf(buf, "Last [%d]/[%d] :: Total [%lu]\n",
+			mtkpasr_last_segments, num_banks, mtkpasr_total_segments);
+}
+
 static ssize_t srmask_show(struct device *dev, struct device_attribute *attr, char *buf)
 {
 	return sprintf(buf, "%lu\n", mtkpasr_srmask);
@@ -208,6 +220,7 @@ static ssize_t execstate_show(struct device *dev, struct device_attribute *attr,
 static DEVICE_ATTR(membank, S_IRUGO, membank_show, NULL);
 static DEVICE_ATTR(enable, S_IRUGO | S_IWUSR, enable_show, enable_store);
 static DEVICE_ATTR(mtkpasr_status, S_IRUGO, mtkpasr_status_show, NULL);
+static DEVICE_ATTR(segments, S_IRUGO, segments_show, NULL);
 static DEVICE_ATTR(srmask, S_IRUGO | S_IWUSR, srmask_show, srmask_store);
 static DEVICE_ATTR(execstate, S_IRUGO, execstate_show, NULL);
 
@@ -215,6 +228,7 @@ static struct attribute *mtkpasr_attrs[] = {
 	&dev_attr_membank.attr,
 	&dev_attr_enable.attr,
 	&dev_attr_mtkpasr_status.attr,
+	&dev_attr_segments.attr,
 	&dev_attr_srmask.attr,
 	&dev_attr_execstate.attr,
 	NULL,
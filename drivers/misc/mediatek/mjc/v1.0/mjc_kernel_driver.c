@@ -9,6 +9,10 @@
 #include <linux/printk.h>
 #include <linux/slab.h>
 #include <linux/interrupt.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
 #include <asm/uaccess.h>
 
 /* #include <linux/earlysuspend.h> */
@@ -93,6 +97,22 @@ unsigned long gulRegister, gu1PaReg, gu1PaSize, gulCGRegister;
 int gi4IrqID;
 MJC_WRITE_REG_T gfWriteReg[MJC_FORCE_REG_NUM];
 
+/*
+ * The next frame can be locked and started as soon as the interrupt of the
+ * previous one came, before its MJC_WAITISR.  The event flag holds one
+ * completion only, so they are counted here and MJC_WAITISR takes one each.
+ */
+static unsigned int gu4IsrPending;	/* spinlock : ContextLock */
+
+static struct {
+	unsigned long long u8Frames;
+	unsigned long long u8Overlapped;	/* done before the previous was taken */
+	unsigned long long u8Timeouts;
+	unsigned long long u8HwNs;
+	unsigned long long u8MaxNs;
+	ktime_t rStart;
+} grMjcStat;	/* spinlock : ContextLock */
+
 
 /*****************************************************************************
  * FUNCTION
@@ -540,6 +560,10 @@ static long mjc_ioctl(struct file *pfile, unsigned int u4cmd, unsigned long u4ar
 				MJCMSG("[ERROR] mjc_ioctl() MJC_LOCKHW HW has been usaged\n");
 				return -1;
 			}
+			spin_lock_irqsave(&ContextLock, ulFlags);
+			grMjcStat.rStart = ktime_get();
+			spin_unlock_irqrestore(&ContextLock, ulFlags);
+
 			/* Gary todo */
 			enable_irq(gi4IrqID);
 
@@ -576,6 +600,10 @@ static long mjc_ioctl(struct file *pfile, unsigned int u4cmd, unsigned long u4ar
 
 			if (ret != 0) {
 				MJCMSG("[ERROR] mjc_ioctl() MJC_WAITISR TimeOut\n");
+				spin_lock_irqsave(&ContextLock, ulFlags);
+				grMjcStat.u8Timeouts++;
+				spin_unlock_irqrestore(&ContextLock, ulFlags);
+
 				spin_lock_irqsave(&HWLock, ulFlags);
 				_mjc_SetEvent(&(grHWLockContext.rEvent));
 				spin_unlock_irqrestore(&HWLock, ulFlags);
@@ -584,6 +612,14 @@ static long mjc_ioctl(struct file *pfile, unsigned int u4cmd, unsigned long u4ar
 
 				return -2;
 			}
+
+			/* the flag was cleared for all, leave it up for the next one */
+			spin_lock_irqsave(&ContextLock, ulFlags);
+			if (gu4IsrPending)
+				gu4IsrPending--;
+			if (gu4IsrPending)
+				*((unsigned char *)grContext.rEvent.pvFlag) = 1;
+			spin_unlock_irqrestore(&ContextLock, ulFlags);
 		}
 		break;
 
@@ -858,10 +894,18 @@ static const struct file_operations g_mjc_fops = {
 static irqreturn_t mjc_intr_dlr(int irq, void *dev_id)
 {
 	unsigned long ulFlags;
+	unsigned long long u8Ns;
 
 	MJCDBG("mjc_intr_dlr()");
 
 	spin_lock_irqsave(&ContextLock, ulFlags);
+	if (gu4IsrPending++)
+		grMjcStat.u8Overlapped++;
+	u8Ns = ktime_to_ns(ktime_sub(ktime_get(), grMjcStat.rStart));
+	grMjcStat.u8Frames++;
+	grMjcStat.u8HwNs += u8Ns;
+	if (u8Ns > grMjcStat.u8MaxNs)
+		grMjcStat.u8MaxNs = u8Ns;
 	_mjc_SetEvent(&(grContext.rEvent));
 	spin_unlock_irqrestore(&ContextLock, ulFlags);
 
@@ -1126,6 +1170,61 @@ static struct platform_driver mjcDrv = {
 };
 
 
+/*
+ * /sys/kernel/debug/mjc: frames, how many finished while the one before
+ * was still not taken by MJC_WAITISR, and the time from MJC_LOCKHW to the
+ * interrupt.  Writing resets it.
+ */
+static int mjc_stat_show(struct seq_file *m, void *v)
+{
+	unsigned long ulFlags;
+	unsigned long long u8Frames, u8Overlapped, u8Timeouts, u8HwNs, u8MaxNs;
+
+	spin_lock_irqsave(&ContextLock, ulFlags);
+	u8Frames = grMjcStat.u8Frames;
+	u8Overlapped = grMjcStat.u8Overlapped;
+	u8Timeouts = grMjcStat.u8Timeouts;
+	u8HwNs = grMjcStat.u8HwNs;
+	u8MaxNs = grMjcStat.u8MaxNs;
+	spin_unlock_irqrestore(&ContextLock, ulFlags);
+
+	seq_printf(m, "frames: %llu, overlapped: %llu, timeouts: %llu\n",
+		   u8Frames, u8Overlapped, u8Timeouts);
+	seq_printf(m, "lock to irq: avg %llu us, max %llu us\n",
+		   u8Frames ? div64_u64(u8HwNs, u8Frames) / NSEC_PER_USEC : 0,
+		   u8MaxNs / NSEC_PER_USEC);
+	return 0;
+}
+
+static int mjc_stat_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mjc_stat_show, NULL);
+}
+
+static ssize_t mjc_stat_write(struct file *filp, const char __user *ubuf,
+			      size_t cnt, loff_t *ppos)
+{
+	unsigned long ulFlags;
+
+	spin_lock_irqsave(&ContextLock, ulFlags);
+	grMjcStat.u8Frames = 0;
+	grMjcStat.u8Overlapped = 0;
+	grMjcStat.u8Timeouts = 0;
+	grMjcStat.u8HwNs = 0;
+	grMjcStat.u8MaxNs = 0;
+	spin_unlock_irqrestore(&ContextLock, ulFlags);
+
+	return cnt;
+}
+
+static const struct file_operations mjc_stat_fops = {
+	.open = mjc_stat_open,
+	.read = seq_read,
+	.write = mjc_stat_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 /*****************************************************************************
  * FUNCTION
  *    mjc_driver_init
@@ -1152,6 +1251,8 @@ static int __init mjc_driver_init(void)
 		gfWriteReg[cnt].val = 0;
 		gfWriteReg[cnt].mask = 0;
 	}
+
+	debugfs_create_file("mjc", 0644, NULL, NULL, &mjc_stat_fops);
 	return 0;
 }
 
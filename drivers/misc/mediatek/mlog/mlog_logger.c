@@ -13,6 +13,9 @@
 #include <linux/cred.h>
 #include <linux/rcupdate.h>
 #include <linux/seq_file.h>
+#include <linux/hashtable.h>
+#include <linux/mutex.h>
+#include <linux/workqueue.h>
 #include <asm/uaccess.h>
 #include <linux/version.h>
 
@@ -35,6 +38,7 @@
 
 #include "mlog_internal.h"
 #include "mlog_logger.h"
+#include "mlog_ring.h"
 
 #define CONFIG_MLOG_BUF_SHIFT   16	/* 64KB */
 
@@ -112,9 +116,29 @@ static int min_adj = -16;
 static int max_adj = 16;
 static int limit_pid = -1;
 
-static struct timer_list mlog_timer;
+static void mlog_work_fn(struct work_struct *work);
+static DECLARE_DEFERRABLE_WORK(mlog_work, mlog_work_fn);
 static unsigned long timer_intval = HZ;
 
+/*
+ * Last sample of every logged process, so that the binary ring only gets
+ * a record for processes which changed.  Every proc_keyframe samples all
+ * processes are emitted again, for readers that just started.
+ */
+#define MLOG_PROC_HASH_BITS	7
+
+struct mlog_proc_snap {
+	struct hlist_node node;
+	u64 start_time;
+	unsigned int gen;
+	struct mlog_proc_rec rec;
+};
+
+static DEFINE_HASHTABLE(mlog_proc_hash, MLOG_PROC_HASH_BITS);
+static DEFINE_MUTEX(mlog_proc_lock);
+static unsigned int mlog_proc_gen;
+static uint proc_keyframe = 50;
+
 static const char **strfmt_list;
 static int strfmt_idx;
 static int strfmt_len;
@@ -335,8 +359,9 @@ static void mlog_reset_buffer(void)
 #define mtkpasr_show_page_reserved(void) (0)
 #endif
 
-static void mlog_meminfo(void)
+static void mlog_meminfo(u8 trigger, u64 time)
 {
+	struct mlog_meminfo_rec rec;
 	unsigned long memfree;
 	unsigned long swapfree;
 	unsigned long cached;
@@ -393,12 +418,26 @@ static void mlog_meminfo(void)
 	mlog_emit_32(shmem);
 	mlog_emit_32(ion);
 	spin_unlock_bh(&mlogbuf_lock);
+
+	rec.memfree = memfree;
+	rec.swapfree = swapfree;
+	rec.cached = cached;
+	rec.gpuuse = gpuuse;
+	rec.gpu_page_cache = gpu_page_cache;
+	rec.mlock = mlock;
+	rec.zram = zram;
+	rec.active = active;
+	rec.inactive = inactive;
+	rec.shmem = shmem;
+	rec.ion = ion;
+	mlog_ring_emit(MLOG_REC_MEMINFO, trigger, time, &rec, sizeof(rec));
 }
 
-static void mlog_vmstat(void)
+static void mlog_vmstat(u8 trigger, u64 time)
 {
 	int cpu;
 	unsigned long v[NR_VM_EVENT_ITEMS];
+	struct mlog_vmstat_rec rec;
 
 	memset(v, 0, NR_VM_EVENT_ITEMS * sizeof(unsigned long));
 
@@ -417,11 +456,20 @@ static void mlog_vmstat(void)
 
 	mlog_emit_32(0);
 	spin_unlock_bh(&mlogbuf_lock);
+
+	rec.pswpin = v[PSWPIN];
+	rec.pswpout = v[PSWPOUT];
+	rec.pgfmfault = v[PGFMFAULT];
+	rec.pganfault = 0;
+	mlog_ring_emit(MLOG_REC_VMSTAT, trigger, time, &rec, sizeof(rec));
 }
 
-/* static void mlog_buddyinfo(void) */
-void mlog_buddyinfo(void)
+static void mlog_buddyinfo(u8 trigger, u64 time)
 {
+	struct {
+		struct mlog_buddyinfo_rec hdr;
+		__u32 nr_free[2 * MAX_ORDER];
+	} rec;
 	int i;
 	struct zone *zone;
 	struct zone *node_zones;
@@ -477,6 +525,14 @@ void mlog_buddyinfo(void)
 
 
 	spin_unlock_bh(&mlogbuf_lock);
+
+	rec.hdr.nr_zones = 2;
+	rec.hdr.nr_orders = MAX_ORDER;
+	for (order = 0; order < MAX_ORDER; ++order) {
+		rec.nr_free[order] = normal_nr_free[order];
+		rec.nr_free[MAX_ORDER + order] = high_nr_free[order];
+	}
+	mlog_ring_emit(MLOG_REC_BUDDYINFO, trigger, time, &rec, sizeof(rec));
 }
 
 struct task_struct *find_trylock_task_mm(struct task_struct *t)
@@ -500,9 +556,68 @@ static short lowmem_oom_score_adj_to_oom_adj(short oom_score_adj)
 		return ((oom_score_adj * -OOM_DISABLE * 10) / OOM_SCORE_ADJ_MAX + 5) / 10;	/* round */
 }
 
-static void mlog_procinfo(void)
+static struct mlog_proc_snap *mlog_proc_snap_find(pid_t pid)
+{
+	struct mlog_proc_snap *snap;
+
+	hash_for_each_possible(mlog_proc_hash, snap, node, pid)
+		if (snap->rec.pid == pid)
+			return snap;
+	return NULL;
+}
+
+/* Put @rec in the ring unless it matches what was logged for @p last time */
+static void mlog_proc_ring_emit(struct task_struct *p, struct mlog_proc_rec *rec,
+				bool keyframe, u8 trigger, u64 time)
+{
+	struct mlog_proc_snap *snap = mlog_proc_snap_find(rec->pid);
+
+	if (!snap) {
+		snap = kmalloc(sizeof(*snap), GFP_ATOMIC);
+		if (snap)
+			hash_add(mlog_proc_hash, &snap->node, rec->pid);
+	} else if (!keyframe && snap->start_time == p->start_time &&
+		   !memcmp(&snap->rec, rec, sizeof(*rec))) {
+		snap->gen = mlog_proc_gen;
+		return;
+	}
+
+	if (snap) {
+		snap->start_time = p->start_time;
+		snap->gen = mlog_proc_gen;
+		snap->rec = *rec;
+	}
+	mlog_ring_emit(MLOG_REC_PROC, trigger, time, rec, sizeof(*rec));
+}
+
+/* Processes not seen by this sample have exited or are no longer logged */
+static void mlog_proc_reap(u8 trigger, u64 time)
+{
+	struct mlog_proc_snap *snap;
+	struct hlist_node *tmp;
+	int bkt;
+
+	hash_for_each_safe(mlog_proc_hash, bkt, tmp, snap, node) {
+		struct mlog_proc_exit_rec rec;
+
+		if (snap->gen == mlog_proc_gen)
+			continue;
+
+		rec.pid = snap->rec.pid;
+		mlog_ring_emit(MLOG_REC_PROC_EXIT, trigger, time, &rec, sizeof(rec));
+		hash_del(&snap->node);
+		kfree(snap);
+	}
+}
+
+static void mlog_procinfo(u8 trigger, u64 time)
 {
 	struct task_struct *tsk;
+	bool keyframe;
+
+	mutex_lock(&mlog_proc_lock);
+	keyframe = !proc_keyframe || !(mlog_proc_gen % proc_keyframe);
+	mlog_proc_gen++;
 
 	rcu_read_lock();
 	for_each_process(tsk) {
@@ -515,6 +630,7 @@ static void mlog_procinfo(void)
 		unsigned long swap_in, swap_out, fm_flt, min_flt, maj_flt;
 		unsigned long rss;
 		unsigned long rswap;
+		struct mlog_proc_rec rec;
 
 		if (tsk->flags & PF_KTHREAD)
 			continue;
@@ -609,6 +725,16 @@ collect_proc_mem_info:
 		/* mlog_emit_32(maj_flt); */
 		spin_unlock_bh(&mlogbuf_lock);
 
+		memset(&rec, 0, sizeof(rec));
+		rec.pid = p->pid;
+		rec.adj = oom_score_adj;
+		rec.rss = rss;
+		rec.rswap = rswap;
+		rec.swpin = swap_in;
+		rec.swpout = swap_out;
+		rec.fmflt = fm_flt;
+		mlog_proc_ring_emit(p, &rec, keyframe, trigger, time);
+
  unlock_continue:
 		if (cred)
 			put_cred(cred);
@@ -617,6 +743,8 @@ collect_proc_mem_info:
 	}
 	rcu_read_unlock();
 
+	mlog_proc_reap(trigger, time);
+	mutex_unlock(&mlog_proc_lock);
 }
 
 void mlog(int type)
@@ -624,6 +752,7 @@ void mlog(int type)
 	/* unsigned long flag; */
 	unsigned long microsec_rem;
 	unsigned long long t = local_clock();
+	const u64 now = t;
 #ifdef PROFILE_MLOG_OVERHEAD
 	unsigned long long t1 = t;
 #endif
@@ -643,15 +772,15 @@ void mlog(int type)
 
 	/* memory log */
 	if (meminfo_filter)
-		mlog_meminfo();
+		mlog_meminfo(type, now);
 	if (vmstat_filter)
-		mlog_vmstat();
+		mlog_vmstat(type, now);
 
 	if (buddyinfo_filter)
-		mlog_buddyinfo();
+		mlog_buddyinfo(type, now);
 
 	if (proc_filter)
-		mlog_procinfo();
+		mlog_procinfo(type, now);
 
 	/* spin_unlock_irqrestore(&mlogbuf_lock, flag); */
 
@@ -744,11 +873,17 @@ int mlog_doread(char __user *buf, size_t len)
 }
 
 
-static void mlog_timer_handler(unsigned long data)
+/*
+ * Periodic sampling runs from a work item rather than a timer, so that
+ * walking the task list happens in process context and does not add
+ * softirq latency.
+ */
+static void mlog_work_fn(struct work_struct *work)
 {
 	mlog(MLOG_TRIGGER_TIMER);
 
-	mod_timer(&mlog_timer, round_jiffies(jiffies + timer_intval));
+	queue_delayed_work(system_freezable_wq, &mlog_work,
+			   round_jiffies_relative(timer_intval));
 }
 
 static void mlog_init_logger(void)
@@ -757,21 +892,31 @@ static void mlog_init_logger(void)
 	mlog_reset_format();
 	mlog_reset_buffer();
 
-	setup_timer(&mlog_timer, mlog_timer_handler, 0);
-	mlog_timer.expires = jiffies + timer_intval;
-
-	add_timer(&mlog_timer);
+	queue_delayed_work(system_freezable_wq, &mlog_work, timer_intval);
 }
 
 static void mlog_exit_logger(void)
 {
+	struct mlog_proc_snap *snap;
+	struct hlist_node *tmp;
+	int bkt;
+
+	cancel_delayed_work_sync(&mlog_work);
 
 	kfree(strfmt_list);
 	strfmt_list = NULL;
+
+	mutex_lock(&mlog_proc_lock);
+	hash_for_each_safe(mlog_proc_hash, bkt, tmp, snap, node) {
+		hash_del(&snap->node);
+		kfree(snap);
+	}
+	mutex_unlock(&mlog_proc_lock);
 }
 
 static int __init mlog_init(void)
 {
+	mlog_ring_init();
 	mlog_init_logger();
 	mlog_init_procfs();
 	return 0;
@@ -785,6 +930,7 @@ static void __exit mlog_exit(void)
 module_param(min_adj, int, S_IRUGO | S_IWUSR);
 module_param(max_adj, int, S_IRUGO | S_IWUSR);
 module_param(limit_pid, int, S_IRUGO | S_IWUSR);
+module_param(proc_keyframe, uint, S_IRUGO | S_IWUSR);
 
 static int do_filter_handler(const char *val, const struct kernel_param *kp)
 {
@@ -803,15 +949,15 @@ static const struct kernel_param_ops param_ops_change_filter = {
 
 static int do_time_intval_handler(const char *val, const struct kernel_param *kp)
 {
-	const int ret = param_set_uint(val, kp);
+	const int ret = param_set_ulong(val, kp);
 
-	mod_timer(&mlog_timer, jiffies + ret);
+	mod_delayed_work(system_freezable_wq, &mlog_work, timer_intval);
 	return ret;
 }
 
 static const struct kernel_param_ops param_ops_change_time_intval = {
 	.set = &do_time_intval_handler,
-	.get = &param_get_uint,
+	.get = &param_get_ulong,
 	.free = NULL,
 };
 
@@ -0,0 +1,115 @@
+#include <linux/types.h>
+#include <linux/kernel.h>
+#include <linux/mm.h>
+#include <linux/fs.h>
+#include <linux/proc_fs.h>
+#include <linux/vmalloc.h>
+#include <linux/cpumask.h>
+#include <linux/irqflags.h>
+#include <linux/string.h>
+
+#include "mlog_internal.h"
+#include "mlog_ring.h"
+
+#define MLOG_RING_HDR_SIZE	PAGE_SIZE
+#define MLOG_RING_NR_RECORDS	(MLOG_RING_DATA_PAGES * PAGE_SIZE / \
+				 MLOG_RECORD_SIZE)
+
+static void *mlog_ring_base;
+
+static struct mlog_ring_header *mlog_ring_hdr(int cpu)
+{
+	return mlog_ring_base + (unsigned long)cpu * MLOG_RING_SIZE;
+}
+
+static struct mlog_record *mlog_ring_slot(struct mlog_ring_header *hdr,
+					  u64 head)
+{
+	unsigned long idx = head & (MLOG_RING_NR_RECORDS - 1);
+
+	return (void *)hdr + MLOG_RING_HDR_SIZE + idx * MLOG_RECORD_SIZE;
+}
+
+/*
+ * Append a record to this cpu's ring.  Interrupts are only disabled to
+ * keep the slot for ourselves; no lock is shared with other cpus or with
+ * readers, which detect a torn slot through its sequence count.
+ */
+void mlog_ring_emit(u8 type, u8 trigger, u64 time, const void *data, u16 len)
+{
+	struct mlog_ring_header *hdr;
+	struct mlog_record *rec;
+	unsigned long flags;
+	u64 head;
+
+	if (!mlog_ring_base)
+		return;
+
+	if (WARN_ON_ONCE(len > MLOG_RECORD_SIZE - sizeof(*rec)))
+		return;
+
+	local_irq_save(flags);
+	hdr = mlog_ring_hdr(smp_processor_id());
+	head = hdr->head;
+	rec = mlog_ring_slot(hdr, head);
+
+	ACCESS_ONCE(rec->seq) = ((u32)head << 1) | 1;
+	smp_wmb();
+	rec->type = type;
+	rec->trigger = trigger;
+	rec->len = len;
+	rec->time = time;
+	memcpy(rec->data, data, len);
+	smp_wmb();
+	ACCESS_ONCE(rec->seq) = (u32)(head + 1) << 1;
+	smp_wmb();
+	ACCESS_ONCE(hdr->head) = head + 1;
+	local_irq_restore(flags);
+}
+
+static int mlog_ring_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	/* Producers own the rings, readers only ever get to look */
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	return remap_vmalloc_range(vma, mlog_ring_base, vma->vm_pgoff);
+}
+
+static const struct file_operations proc_mlog_ring_operations = {
+	.mmap = mlog_ring_mmap,
+	.llseek = noop_llseek,
+};
+
+int __init mlog_ring_init(void)
+{
+	unsigned long size = (unsigned long)nr_cpu_ids * MLOG_RING_SIZE;
+	int cpu;
+
+	BUILD_BUG_ON(MLOG_RING_NR_RECORDS & (MLOG_RING_NR_RECORDS - 1));
+	BUILD_BUG_ON(sizeof(struct mlog_record) +
+		     sizeof(struct mlog_buddyinfo_rec) +
+		     2 * MAX_ORDER * sizeof(__u32) > MLOG_RECORD_SIZE);
+
+	mlog_ring_base = vmalloc_user(size);
+	if (!mlog_ring_base) {
+		pr_err("[mlog] no memory for %lu byte ring\n", size);
+		return -ENOMEM;
+	}
+
+	for_each_possible_cpu(cpu) {
+		struct mlog_ring_header *hdr = mlog_ring_hdr(cpu);
+
+		hdr->magic = MLOG_RING_MAGIC;
+		hdr->version = MLOG_RING_VERSION;
+		hdr->header_size = MLOG_RING_HDR_SIZE;
+		hdr->record_size = MLOG_RECORD_SIZE;
+		hdr->nr_records = MLOG_RING_NR_RECORDS;
+		hdr->cpu = cpu;
+	}
+
+	proc_create("mlog_ring", S_IRUSR, NULL, &proc_mlog_ring_operations);
+	MLOG_PRINTK("[mlog] ring %d x %lu bytes\n", nr_cpu_ids, MLOG_RING_SIZE);
+	return 0;
+}
@@ -0,0 +1,102 @@
+#ifndef _MLOG_RING_H
+#define _MLOG_RING_H
+
+#include <linux/types.h>
+
+/*
+ * Binary mlog records, exported through /proc/mlog_ring.
+ *
+ * Every possible cpu owns MLOG_RING_SIZE bytes of the mapping: a page
+ * holding the struct mlog_ring_header, followed by nr_records fixed size
+ * slots.  Only the owning cpu writes its ring, so producers never take a lock.
+ * Readers mmap the file read-only and follow head; a record is valid
+ * once its seq is even and did not change while it was being copied.
+ *
+ * The layout below is an ABI: fields are only ever appended to records,
+ * and readers must use mlog_record.len rather than sizeof.
+ */
+#define MLOG_RING_MAGIC		0x474f4c4d	/* "MLOG" */
+#define MLOG_RING_VERSION	1
+
+#define MLOG_RING_DATA_PAGES	16
+#define MLOG_RING_SIZE		((MLOG_RING_DATA_PAGES + 1) * PAGE_SIZE)
+#define MLOG_RECORD_SIZE	128
+
+struct mlog_ring_header {
+	__u32 magic;
+	__u32 version;
+	__u32 header_size;	/* offset of the first slot */
+	__u32 record_size;
+	__u32 nr_records;	/* power of two */
+	__u32 cpu;
+	__u64 head;		/* records written, next slot is head % nr */
+};
+
+enum mlog_record_type {
+	MLOG_REC_MEMINFO = 1,
+	MLOG_REC_VMSTAT,
+	MLOG_REC_BUDDYINFO,
+	MLOG_REC_PROC,
+	MLOG_REC_PROC_EXIT,
+};
+
+struct mlog_record {
+	__u32 seq;		/* odd while the slot is being written */
+	__u8 type;		/* enum mlog_record_type */
+	__u8 trigger;		/* MLOG_TRIGGER_* of the sample */
+	__u16 len;		/* payload bytes */
+	__u64 time;		/* local_clock() of the sample, ns */
+	__u8 data[];
+};
+
+/* Sizes in kB */
+struct mlog_meminfo_rec {
+	__u32 memfree;
+	__u32 swapfree;
+	__u32 cached;
+	__u32 gpuuse;
+	__u32 gpu_page_cache;
+	__u32 mlock;
+	__u32 zram;
+	__u32 active;
+	__u32 inactive;
+	__u32 shmem;
+	__u32 ion;
+};
+
+struct mlog_vmstat_rec {
+	__u64 pswpin;
+	__u64 pswpout;
+	__u64 pgfmfault;
+	__u64 pganfault;
+};
+
+/* nr_free[] holds nr_orders entries for each of nr_zones zones */
+struct mlog_buddyinfo_rec {
+	__u16 nr_zones;
+	__u16 nr_orders;
+	__u32 nr_free[];
+};
+
+struct mlog_proc_rec {
+	__s32 pid;
+	__s16 adj;
+	__u16 reserved;
+	__u32 rss;		/* kB */
+	__u32 rswap;		/* kB */
+	__u32 swpin;
+	__u32 swpout;
+	__u32 fmflt;
+};
+
+struct mlog_proc_exit_rec {
+	__s32 pid;
+};
+
+#ifdef __KERNEL__
+extern int mlog_ring_init(void);
+extern void mlog_ring_emit(u8 type, u8 trigger, u64 time,
+			   const void *data, u16 len);
+#endif
+
+#endif
@@ -0,0 +1,501 @@
+/*
+ * Copyright (C) 2015 MediaTek Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Cost of the multimedia buffer path: ION alloc/free per heap and size,
+ * M4U map/unmap of ION and vmalloc buffers, ION cache sync, and CMDQ
+ * submit to complete latency with 1..N tasks in flight.
+ *
+ * echo ion|m4u|sync|cmdq|all > /sys/kernel/debug/mm_bench/run runs a
+ * set, cat run gives the last results, one "key=value ..." line per
+ * case, times in ns.  iters, cmdq_tasks and max_kb there set the size
+ * of a run.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/mutex.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/sizes.h>
+#include <linux/string.h>
+#include <linux/vmalloc.h>
+#include <linux/uaccess.h>
+#include <linux/atomic.h>
+#include <linux/completion.h>
+
+#include "ion_drv.h"
+#include "mtk_ion.h"
+#include "m4u.h"
+#include "cmdq_record.h"
+
+#define MM_BENCH_OUT_SIZE	SZ_32K
+#define MM_BENCH_CMDQ_DEPTH	8	/* most tasks in flight */
+#define MM_BENCH_TAG		"[MM_BENCH] "
+
+static const struct {
+	const char *name;
+	unsigned int mask;
+} mm_bench_heaps[] = {
+	{ "mm", ION_HEAP_MULTIMEDIA_MASK },
+	{ "carveout", ION_HEAP_CARVEOUT_MASK },
+};
+
+static const size_t mm_bench_sizes[] = {
+	SZ_4K, SZ_64K, SZ_256K, SZ_1M, SZ_4M, SZ_8M,
+};
+
+static u32 mm_bench_iters = 32;
+static u32 mm_bench_cmdq_tasks = 256;
+static u32 mm_bench_max_kb = 8192;
+
+static DEFINE_MUTEX(mm_bench_lock);
+static char *mm_bench_out;
+static size_t mm_bench_len;
+
+struct mm_bench_stat {
+	u64 min, max, sum;
+	u32 n;
+};
+
+static void mm_bench_stat_init(struct mm_bench_stat *s)
+{
+	s->min = U64_MAX;
+	s->max = 0;
+	s->sum = 0;
+	s->n = 0;
+}
+
+static void mm_bench_stat_add(struct mm_bench_stat *s, u64 ns)
+{
+	s->min = min(s->min, ns);
+	s->max = max(s->max, ns);
+	s->sum += ns;
+	s->n++;
+}
+
+static u64 mm_bench_since(ktime_t start)
+{
+	return ktime_to_ns(ktime_sub(ktime_get(), start));
+}
+
+/* called with mm_bench_lock held */
+static __printf(1, 2) void mm_bench_printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	mm_bench_len += vscnprintf(mm_bench_out + mm_bench_len,
+				   MM_BENCH_OUT_SIZE - mm_bench_len, fmt, args);
+	va_end(args);
+}
+
+static void mm_bench_print_stat(const char *key, struct mm_bench_stat *s)
+{
+	if (!s->n) {
+		mm_bench_printf(" %s_n=0", key);
+		return;
+	}
+	mm_bench_printf(" %s_min_ns=%llu %s_avg_ns=%llu %s_max_ns=%llu", key, s->min,
+			key, div_u64(s->sum, s->n), key, s->max);
+}
+
+static bool mm_bench_size_ok(size_t size)
+{
+	return size <= (size_t)mm_bench_max_kb * SZ_1K;
+}
+
+static void mm_bench_ion(struct ion_client *client)
+{
+	struct mm_bench_stat alloc, release;
+	struct ion_handle *handle;
+	ktime_t start;
+	size_t size;
+	int h, i, n, ret;
+
+	for (h = 0; h < ARRAY_SIZE(mm_bench_heaps); h++) {
+		for (i = 0; i < ARRAY_SIZE(mm_bench_sizes); i++) {
+			size = mm_bench_sizes[i];
+			if (!mm_bench_size_ok(size))
+				break;
+
+			mm_bench_stat_init(&alloc);
+			mm_bench_stat_init(&release);
+			ret = 0;
+			for (n = 0; n < mm_bench_iters; n++) {
+				start = ktime_get();
+				handle = ion_alloc(client, size, 0, mm_bench_heaps[h].mask, 0);
+				if (IS_ERR_OR_NULL(handle)) {
+					ret = handle ? PTR_ERR(handle) : -ENOMEM;
+					break;
+				}
+				mm_bench_stat_add(&alloc, mm_bench_since(start));
+
+				start = ktime_get();
+				ion_free(client, handle);
+				mm_bench_stat_add(&release, mm_bench_since(start));
+				cond_resched();
+			}
+
+			mm_bench_printf("ion heap=%s size=%zu n=%u", mm_bench_heaps[h].name,
+					size, alloc.n);
+			mm_bench_print_stat("alloc", &alloc);
+			mm_bench_print_stat("free", &release);
+			mm_bench_printf(" err=%d\n", ret);
+		}
+	}
+}
+
+static int mm_bench_cache_sync(struct ion_client *client, struct ion_handle *handle,
+			       ION_CACHE_SYNC_TYPE type)
+{
+	ion_sys_data_t sys_data;
+
+	memset(&sys_data, 0, sizeof(sys_data));
+	sys_data.sys_cmd = ION_SYS_CACHE_SYNC;
+	sys_data.cache_sync_param.kernel_handle = handle;
+	sys_data.cache_sync_param.sync_type = type;
+
+	return ion_kernel_ioctl(client, ION_CMD_SYSTEM, (unsigned long)&sys_data);
+}
+
+/* each op on a buffer the CPU just wrote, as after filling a frame */
+static void mm_bench_sync(struct ion_client *client)
+{
+	static const struct {
+		const char *name;
+		ION_CACHE_SYNC_TYPE type;
+	} ops[] = {
+		{ "clean", ION_CACHE_CLEAN_BY_RANGE },
+		{ "invalid", ION_CACHE_INVALID_BY_RANGE },
+		{ "flush", ION_CACHE_FLUSH_BY_RANGE },
+	};
+	struct mm_bench_stat stat[ARRAY_SIZE(ops)];
+	struct ion_handle *handle;
+	void *va;
+	ktime_t start;
+	size_t size;
+	int i, j, n, ret;
+
+	for (i = 0; i < ARRAY_SIZE(mm_bench_sizes); i++) {
+		size = mm_bench_sizes[i];
+		if (!mm_bench_size_ok(size))
+			break;
+
+		for (j = 0; j < ARRAY_SIZE(ops); j++)
+			mm_bench_stat_init(&stat[j]);
+		ret = 0;
+
+		handle = ion_alloc(client, size, 0, ION_HEAP_MULTIMEDIA_MASK,
+				   ION_FLAG_CACHED | ION_FLAG_CACHED_NEEDS_SYNC);
+		if (IS_ERR_OR_NULL(handle)) {
+			ret = handle ? PTR_ERR(handle) : -ENOMEM;
+			goto print;
+		}
+		va = ion_map_kernel(client, handle);
+		if (IS_ERR_OR_NULL(va)) {
+			ret = va ? PTR_ERR(va) : -ENOMEM;
+			ion_free(client, handle);
+			goto print;
+		}
+
+		for (n = 0; n < mm_bench_iters && !ret; n++) {
+			for (j = 0; j < ARRAY_SIZE(ops); j++) {
+				memset(va, n + j, size);
+				start = ktime_get();
+				ret = mm_bench_cache_sync(client, handle, ops[j].type);
+				if (ret)
+					break;
+				mm_bench_stat_add(&stat[j], mm_bench_since(start));
+			}
+			cond_resched();
+		}
+
+		ion_unmap_kernel(client, handle);
+		ion_free(client, handle);
+print:
+		mm_bench_printf("sync heap=mm size=%zu n=%u", size, stat[0].n);
+		for (j = 0; j < ARRAY_SIZE(ops); j++)
+			mm_bench_print_stat(ops[j].name, &stat[j]);
+		mm_bench_printf(" err=%d\n", ret);
+	}
+}
+
+/*
+ * An ION buffer is unmapped lazily, its TLB flush is batched with others
+ * (counted at the end of /sys/kernel/debug/m4u/buffer), so its unmap is
+ * the cost seen by the caller.  A vmalloc buffer is pinned on map and
+ * unmapped with a TLB flush each time.
+ */
+static int mm_bench_m4u_one(m4u_client_t *m4u, unsigned long va, struct sg_table *sgt,
+			    size_t size, struct mm_bench_stat *map,
+			    struct mm_bench_stat *unmap)
+{
+	unsigned int mva;
+	ktime_t start;
+	int n, ret;
+
+	for (n = 0; n < mm_bench_iters; n++) {
+		start = ktime_get();
+		ret = m4u_alloc_mva(m4u, M4U_PORT_DISP_OVL0, va, sgt, size,
+				    M4U_PROT_READ | M4U_PROT_WRITE, 0, &mva);
+		if (ret)
+			return ret;
+		mm_bench_stat_add(map, mm_bench_since(start));
+
+		start = ktime_get();
+		ret = m4u_dealloc_mva(m4u, M4U_PORT_DISP_OVL0, mva);
+		if (ret)
+			return ret;
+		mm_bench_stat_add(unmap, mm_bench_since(start));
+		cond_resched();
+	}
+
+	return 0;
+}
+
+static void mm_bench_m4u(struct ion_client *client)
+{
+	struct mm_bench_stat map, unmap;
+	struct ion_handle *handle;
+	struct sg_table *sgt;
+	m4u_client_t *m4u;
+	void *va;
+	size_t size;
+	int i, ret;
+
+	m4u = m4u_create_client();
+	if (IS_ERR_OR_NULL(m4u)) {
+		mm_bench_printf("m4u err=%ld\n", m4u ? PTR_ERR(m4u) : -ENOMEM);
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(mm_bench_sizes); i++) {
+		size = mm_bench_sizes[i];
+		if (!mm_bench_size_ok(size))
+			break;
+
+		mm_bench_stat_init(&map);
+		mm_bench_stat_init(&unmap);
+		handle = ion_alloc(client, size, 0, ION_HEAP_MULTIMEDIA_MASK, 0);
+		if (IS_ERR_OR_NULL(handle)) {
+			ret = handle ? PTR_ERR(handle) : -ENOMEM;
+		} else {
+			sgt = ion_sg_table(client, handle);
+			if (IS_ERR_OR_NULL(sgt))
+				ret = sgt ? PTR_ERR(sgt) : -EINVAL;
+			else
+				ret = mm_bench_m4u_one(m4u, 0, sgt, size, &map, &unmap);
+			ion_free(client, handle);
+		}
+		mm_bench_printf("m4u src=ion size=%zu n=%u", size, map.n);
+		mm_bench_print_stat("map", &map);
+		mm_bench_print_stat("unmap", &unmap);
+		mm_bench_printf(" err=%d\n", ret);
+
+		mm_bench_stat_init(&map);
+		mm_bench_stat_init(&unmap);
+		va = vmalloc(size);
+		if (!va) {
+			ret = -ENOMEM;
+		} else {
+			ret = mm_bench_m4u_one(m4u, (unsigned long)va, NULL, size, &map,
+					       &unmap);
+			vfree(va);
+		}
+		mm_bench_printf("m4u src=vmalloc size=%zu n=%u", size, map.n);
+		mm_bench_print_stat("map", &map);
+		mm_bench_print_stat("unmap", &unmap);
+		mm_bench_printf(" err=%d\n", ret);
+	}
+
+	m4u_destroy_client(m4u);
+}
+
+/* tasks of a wave; the callbacks run from the CMDQ auto release work */
+static ktime_t mm_bench_cmdq_submit[MM_BENCH_CMDQ_DEPTH];
+static u64 mm_bench_cmdq_lat[MM_BENCH_CMDQ_DEPTH];
+static atomic_t mm_bench_cmdq_left;
+static DECLARE_COMPLETION(mm_bench_cmdq_done);
+
+static int32_t mm_bench_cmdq_cb(unsigned long data)
+{
+	mm_bench_cmdq_lat[data] = mm_bench_since(mm_bench_cmdq_submit[data]);
+	if (atomic_dec_and_test(&mm_bench_cmdq_left))
+		complete(&mm_bench_cmdq_done);
+	return 0;
+}
+
+/*
+ * Empty DEBUG scenario tasks: no engine, so tasks in flight together go
+ * to different HW threads.  depth=1 is a blocking flush, the others are
+ * waves of depth async tasks; lat is from submit to the completion
+ * callback.
+ */
+static void mm_bench_cmdq(void)
+{
+	static const int depths[] = { 1, 2, 4, MM_BENCH_CMDQ_DEPTH };
+	struct mm_bench_stat lat;
+	cmdqRecHandle handle;
+	ktime_t start;
+	u64 total_ns;
+	int d, i, n, depth, ret;
+
+	ret = cmdqRecCreate(CMDQ_SCENARIO_DEBUG, &handle);
+	if (ret) {
+		mm_bench_printf("cmdq err=%d\n", ret);
+		return;
+	}
+
+	for (d = 0; d < ARRAY_SIZE(depths); d++) {
+		depth = depths[d];
+		mm_bench_stat_init(&lat);
+		ret = 0;
+		start = ktime_get();
+		for (n = 0; n < mm_bench_cmdq_tasks && !ret; n += depth) {
+			if (depth == 1) {
+				mm_bench_cmdq_submit[0] = ktime_get();
+				ret = cmdqRecFlush(handle);
+				if (!ret)
+					mm_bench_stat_add(&lat,
+							  mm_bench_since(mm_bench_cmdq_submit[0]));
+				continue;
+			}
+
+			reinit_completion(&mm_bench_cmdq_done);
+			atomic_set(&mm_bench_cmdq_left, depth);
+			for (i = 0; i < depth; i++) {
+				mm_bench_cmdq_submit[i] = ktime_get();
+				ret = cmdqRecFlushAsyncCallback(handle, mm_bench_cmdq_cb, i);
+				if (ret)
+					break;
+			}
+			/* the ones not submitted will not call back */
+			if (i < depth && atomic_sub_and_test(depth - i, &mm_bench_cmdq_left))
+				complete(&mm_bench_cmdq_done);
+			/* CMDQ times out a stuck task and still calls back */
+			wait_for_completion(&mm_bench_cmdq_done);
+			while (i--)
+				mm_bench_stat_add(&lat, mm_bench_cmdq_lat[i]);
+		}
+		total_ns = mm_bench_since(start);
+
+		mm_bench_printf("cmdq scenario=debug depth=%d n=%u", depth, lat.n);
+		mm_bench_print_stat("lat", &lat);
+		mm_bench_printf(" tasks_per_s=%llu err=%d\n",
+				total_ns ? div64_u64((u64)lat.n * NSEC_PER_SEC, total_ns) : 0,
+				ret);
+	}
+
+	cmdqRecDestroy(handle);
+}
+
+/* called with mm_bench_lock held */
+static int mm_bench_run(const char *what)
+{
+	bool all = !strcmp(what, "all");
+	struct ion_client *client;
+
+	if (!all && strcmp(what, "ion") && strcmp(what, "m4u") && strcmp(what, "sync") &&
+	    strcmp(what, "cmdq"))
+		return -EINVAL;
+
+	if (!mm_bench_out) {
+		mm_bench_out = vmalloc(MM_BENCH_OUT_SIZE);
+		if (!mm_bench_out)
+			return -ENOMEM;
+	}
+	mm_bench_len = 0;
+	mm_bench_out[0] = 0;
+
+	client = ion_client_create(g_ion_device, "mm_bench");
+	if (IS_ERR_OR_NULL(client)) {
+		pr_err(MM_BENCH_TAG"ion_client_create failed\n");
+		return -ENODEV;
+	}
+
+	if (all || !strcmp(what, "ion"))
+		mm_bench_ion(client);
+	if (all || !strcmp(what, "sync"))
+		mm_bench_sync(client);
+	if (all || !strcmp(what, "m4u"))
+		mm_bench_m4u(client);
+	if (all || !strcmp(what, "cmdq"))
+		mm_bench_cmdq();
+
+	ion_client_destroy(client);
+	return 0;
+}
+
+static int mm_bench_show(struct seq_file *m, void *v)
+{
+	mutex_lock(&mm_bench_lock);
+	if (mm_bench_out)
+		seq_write(m, mm_bench_out, mm_bench_len);
+	mutex_unlock(&mm_bench_lock);
+
+	return 0;
+}
+
+static int mm_bench_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mm_bench_show, NULL);
+}
+
+static ssize_t mm_bench_write(struct file *filp, const char __user *ubuf,
+			      size_t cnt, loff_t *ppos)
+{
+	char buf[16];
+	int ret;
+
+	if (cnt >= sizeof(buf))
+		return -EINVAL;
+
+	if (copy_from_user(&buf, ubuf, cnt))
+		return -EFAULT;
+
+	buf[cnt] = 0;
+
+	mutex_lock(&mm_bench_lock);
+	ret = mm_bench_run(strim(buf));
+	mutex_unlock(&mm_bench_lock);
+
+	return ret ? ret : cnt;
+}
+
+static const struct file_operations mm_bench_fops = {
+	.open = mm_bench_open,
+	.read = seq_read,
+	.write = mm_bench_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init mm_bench_init(void)
+{
+	struct dentry *dir;
+
+	dir = debugfs_create_dir("mm_bench", NULL);
+	if (!dir)
+		return 0;
+
+	debugfs_create_file("run", 0644, dir, NULL, &mm_bench_fops);
+	debugfs_create_u32("iters", 0644, dir, &mm_bench_iters);
+	debugfs_create_u32("cmdq_tasks", 0644, dir, &mm_bench_cmdq_tasks);
+	debugfs_create_u32("max_kb", 0644, dir, &mm_bench_max_kb);
+
+	return 0;
+}
+late_initcall(mm_bench_init);
@@ -32,6 +32,15 @@
 
 #define MRDUMP_GO_DUMP "MRDUMP04"
 
+/*
+ * dumpdesc.dump_options: how lk should write the full dump.  The dump is
+ * taken by lk after the reset, the kernel only asks; an lk that does not
+ * know an option ignores it and writes raw memory as before.
+ */
+#define MRDUMP_OPT_COMPRESS	(1 << 0)	/* LZ4 blocks, large sequential writes */
+#define MRDUMP_OPT_SKIP_ZERO	(1 << 1)	/* leave out all-zero pages */
+#define MRDUMP_OPT_SKIP_FREE	(1 << 2)	/* leave out pages set in free_bitmap */
+
 typedef uint32_t arm32_gregset_t[18];
 typedef uint64_t aarch64_gregset_t[34];
 
@@ -72,11 +81,23 @@ struct mrdump_machdesc {
 	uint32_t output_lbaooo;
 };
 
+/* after the crash record, so that an older lk finds everything else where it was */
+struct mrdump_dumpdesc {
+	uint32_t dump_options;
+	uint32_t reserved;
+
+	/* one bit per pfn from free_start_pfn, set when free at the crash */
+	uint64_t free_bitmap_pa;
+	uint64_t free_start_pfn;
+	uint64_t free_nr_pfn;
+};
+
 struct mrdump_control_block {
 	char sig[8];
 
 	struct mrdump_machdesc machdesc;
 	struct mrdump_crash_record crash_record;
+	struct mrdump_dumpdesc dumpdesc;
 };
 
 /* NOTE!! any change to this struct should be compatible in aed */
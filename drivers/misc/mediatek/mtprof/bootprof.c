@@ -17,10 +17,14 @@
 #include <linux/utsname.h>
 #include <linux/module.h>
 #include <linux/moduleparam.h>
+#include <linux/async.h>
+#include <linux/device.h>
+#include <linux/spinlock.h>
 #include <asm/uaccess.h>
 #include <linux/printk.h>
 
 #include "internal.h"
+#include "bootprof.h"
 /* #include <mt_hotplug_strategy.h> */
 #ifdef CONFIG_MT_SCHED_MON_DEFAULT_ENABLE
 #include "mt_sched_mon.h"
@@ -52,6 +56,142 @@ int boot_finish = 0;
 module_param_named(pl_t, bootprof_pl_t, int, S_IRUGO | S_IWUSR);
 module_param_named(lk_t, bootprof_lk_t, int, S_IRUGO | S_IWUSR);
 
+/*
+ * Cost of every initcall and driver probe while bootprof is on: all of
+ * them are counted, the ones over call_thres_us are listed.
+ */
+#define BOOT_CALL_NAME_SIZE 48
+#define BOOT_CALL_NUM 256
+
+enum boot_call_type {
+	BOOT_CALL_INITCALL,
+	BOOT_CALL_ASYNC,	/* initcall run by mt_async_initcall_schedule() */
+	BOOT_CALL_PROBE,
+	BOOT_CALL_DEFERRED,	/* probe retried from the deferred list */
+	BOOT_CALL_TYPES,
+};
+
+struct boot_call_struct {
+	u64 start;
+	u64 duration;
+	int ret;
+	pid_t pid;
+	enum boot_call_type type;
+	char name[BOOT_CALL_NAME_SIZE];
+};
+
+static struct boot_call_struct mt_bootcall[BOOT_CALL_NUM];
+static int boot_call_count;
+static int boot_call_dropped;
+static unsigned int boot_call_nr[BOOT_CALL_TYPES];
+static u64 boot_call_total[BOOT_CALL_TYPES];
+static DEFINE_SPINLOCK(mt_bootcall_lock);
+static int bootprof_call_thres_us = 1000;
+static bool bootprof_async_init = true;
+
+module_param_named(call_thres_us, bootprof_call_thres_us, int, S_IRUGO | S_IWUSR);
+module_param_named(async_init, bootprof_async_init, bool, S_IRUGO);
+
+static const char * const boot_call_name[] = {
+	[BOOT_CALL_INITCALL] = "initcall",
+	[BOOT_CALL_ASYNC] = "async",
+	[BOOT_CALL_PROBE] = "probe",
+	[BOOT_CALL_DEFERRED] = "deferred",
+};
+
+/* the name is formatted by the caller, when it can still be resolved */
+static struct boot_call_struct *
+log_boot_call(enum boot_call_type type, u64 duration, int ret)
+{
+	struct boot_call_struct *p = NULL;
+	unsigned long flags;
+
+	if (!mt_bootprof_enabled)
+		return NULL;
+
+	spin_lock_irqsave(&mt_bootcall_lock, flags);
+	boot_call_nr[type]++;
+	boot_call_total[type] += duration;
+	if (duration < (u64)bootprof_call_thres_us * NSEC_PER_USEC)
+		goto out;
+	if (boot_call_count >= BOOT_CALL_NUM) {
+		boot_call_dropped++;
+		goto out;
+	}
+	p = &mt_bootcall[boot_call_count++];
+	p->start = sched_clock() - duration;
+	p->duration = duration;
+	p->ret = ret;
+	p->pid = current->pid;
+	p->type = type;
+	p->name[0] = 0;
+out:
+	spin_unlock_irqrestore(&mt_bootcall_lock, flags);
+	return p;
+}
+
+static void log_boot_initcall_type(enum boot_call_type type, initcall_t fn,
+				   u64 duration, int ret)
+{
+	struct boot_call_struct *p = log_boot_call(type, duration, ret);
+
+	if (p)
+		snprintf(p->name, sizeof(p->name), "%pf", fn);
+}
+
+/* Called by do_one_initcall(), for built-in and module initcalls. */
+void log_boot_initcall(initcall_t fn, u64 duration, int ret)
+{
+	log_boot_initcall_type(BOOT_CALL_INITCALL, fn, duration, ret);
+}
+
+/* Called by really_probe() with what ->probe() returned. */
+void log_boot_probe(struct device *dev, struct device_driver *drv,
+		    bool deferred, u64 duration, int ret)
+{
+	struct boot_call_struct *p;
+
+	p = log_boot_call(deferred ? BOOT_CALL_DEFERRED : BOOT_CALL_PROBE,
+			  duration, ret);
+	if (p)
+		snprintf(p->name, sizeof(p->name), "%s %s",
+			 drv->name, dev_name(dev));
+}
+
+/* registered, so that kernel_init() waits for it before free_initmem() */
+static ASYNC_DOMAIN(mt_async_init_domain);
+
+static void mt_async_initcall_run(void *data, async_cookie_t cookie)
+{
+	initcall_t fn = (initcall_t)data;
+	u64 ts = sched_clock();
+	int ret;
+
+	ret = fn();
+	ts = sched_clock() - ts;
+	if (ret && ret != -ENODEV)
+		pr_err("[BOOTPROF] async initcall %pf returned %d\n", fn, ret);
+	log_boot_initcall_type(BOOT_CALL_ASYNC, fn, ts, ret);
+}
+
+int __init mt_async_initcall_schedule(initcall_t fn)
+{
+	if (!bootprof_async_init)
+		return fn();
+
+	async_schedule_domain(mt_async_initcall_run, (void *)fn,
+			      &mt_async_init_domain);
+	return 0;
+}
+
+static int __init mt_async_initcall_sync(void)
+{
+	async_synchronize_full_domain(&mt_async_init_domain);
+	return 0;
+}
+device_initcall_sync(mt_async_initcall_sync);
+late_initcall_sync(mt_async_initcall_sync);
+
 void log_boot(char *str)
 {
 	unsigned long long ts;
@@ -84,6 +224,7 @@ void log_boot(char *str)
 out:
 	mutex_unlock(&mt_bootprof_lock);
 }
+EXPORT_SYMBOL_GPL(log_boot);
 
 static void bootup_finish(void)
 {
@@ -153,7 +294,7 @@ mt_bootprof_write(struct file *filp, const char *ubuf, size_t cnt, loff_t *data)
 
 static int mt_bootprof_show(struct seq_file *m, void *v)
 {
-	int i;
+	int i, t;
 
 	SEQ_printf(m, "----------------------------------------\n");
 	SEQ_printf(m, "%d	    BOOT PROF (unit:msec)\n", mt_bootprof_enabled);
@@ -185,6 +326,30 @@ static int mt_bootprof_show(struct seq_file *m, void *v)
 	SEQ_printf(m, "%10Ld.%06ld : OFF\n",
 		   nsec_high(timestamp_off), nsec_low(timestamp_off));
 	SEQ_printf(m, "----------------------------------------\n");
+
+	for (t = 0; t < BOOT_CALL_TYPES; t++)
+		SEQ_printf(m, "%10Ld.%06ld : %u %s\n",
+			   nsec_high(boot_call_total[t]), nsec_low(boot_call_total[t]),
+			   boot_call_nr[t], boot_call_name[t]);
+	SEQ_printf(m, "----------------------------------------\n");
+	SEQ_printf(m, "calls over %d us\n", bootprof_call_thres_us);
+	SEQ_printf(m, "%-8s %17s %17s %6s %5s  %s\n",
+		   "type", "start", "time", "pid", "ret", "name");
+
+	for (i = 0; i < boot_call_count; i++) {
+		struct boot_call_struct *p = &mt_bootcall[i];
+
+		SEQ_printf(m, "%-8s %10Ld.%06ld %10Ld.%06ld %6d %5d  %s\n",
+			   boot_call_name[p->type],
+			   nsec_high(p->start), nsec_low(p->start),
+			   nsec_high(p->duration), nsec_low(p->duration),
+			   p->pid, p->ret, p->name);
+	}
+
+	if (boot_call_dropped)
+		SEQ_printf(m, "%d calls not logged, buffer full\n",
+			   boot_call_dropped);
+	SEQ_printf(m, "----------------------------------------\n");
 	return 0;
 }
 
@@ -9,3 +9,87 @@ static inline void log_boot(char *str)
 {
 }
 #endif
+
+/*
+  initcall and probe cost: drivers/misc/mtprof/bootprof
+  interface: /proc/bootprof
+*/
+#ifndef __BOOTPROF_CALL_H__
+#define __BOOTPROF_CALL_H__
+
+#include <linux/init.h>
+
+struct device;
+struct device_driver;
+
+#ifdef CONFIG_MTPROF
+extern void log_boot_initcall(initcall_t fn, u64 duration, int ret);
+extern void log_boot_probe(struct device *dev, struct device_driver *drv,
+			   bool deferred, u64 duration, int ret);
+extern int mt_async_initcall_schedule(initcall_t fn);
+#else
+static inline void log_boot_initcall(initcall_t fn, u64 duration, int ret)
+{
+}
+
+static inline void log_boot_probe(struct device *dev, struct device_driver *drv,
+				  bool deferred, u64 duration, int ret)
+{
+}
+#endif
+
+/*
+ * An initcall marked async is started from its level and runs next to the
+ * rest of it on the async threads; all of them are done before the _sync
+ * initcalls of the level.  Only for initcalls nothing after them at the
+ * same level depends on.
+ */
+#if defined(CONFIG_MTPROF) && !defined(MODULE)
+#define __mt_async_initcall(fn, level)					\
+	static int __init __mt_async_##fn(void)				\
+	{								\
+		return mt_async_initcall_schedule(fn);			\
+	}								\
+	level##_initcall(__mt_async_##fn)
+#else
+#define __mt_async_initcall(fn, level)	level##_initcall(fn)
+#endif
+
+#define mt_async_device_initcall(fn)	__mt_async_initcall(fn, device)
+#define mt_async_late_initcall(fn)	__mt_async_initcall(fn, late)
+
+#endif
+
+/*
+  resume logger: drivers/misc/mtprof/resumeprof
+  interface: /proc/resumeprof
+*/
+#ifndef __BOOTPROF_RESUME_H__
+#define __BOOTPROF_RESUME_H__
+
+#include <linux/ktime.h>
+
+struct device;
+
+enum resume_phase {
+	RESUME_PHASE_NOIRQ,
+	RESUME_PHASE_EARLY,
+	RESUME_PHASE_RESUME,
+	RESUME_PHASE_COMPLETE,
+	RESUME_PHASE_DONE,
+};
+
+#ifdef CONFIG_MTPROF
+extern void log_resume_phase(enum resume_phase phase);
+extern void log_resume_dev(struct device *dev, const char *info, ktime_t starttime);
+#else
+static inline void log_resume_phase(enum resume_phase phase)
+{
+}
+
+static inline void log_resume_dev(struct device *dev, const char *info, ktime_t starttime)
+{
+}
+#endif
+
+#endif
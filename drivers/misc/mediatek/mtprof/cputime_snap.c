@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2015 MediaTek Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Streamed cputime profile.
+ *
+ * Instead of walking every thread when read, like mtprof/cputime, the
+ * runtime is charged as it is used: when a thread is switched out or
+ * ticks, its delta goes to a record in a per-CPU buffer for the current
+ * interval.  Taking a snapshot flips every CPU to its other buffer and
+ * copies the old ones out, so the cost is in the number of threads that
+ * actually ran.
+ *
+ * echo 1/0 > /proc/mtprof/cputime_snap starts/stops it, echo 2 takes a
+ * snapshot for mmap() readers, read() from offset 0 takes one as well.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/mm.h>
+#include <linux/mutex.h>
+#include <linux/percpu.h>
+#include <linux/proc_fs.h>
+#include <linux/rcupdate.h>
+#include <linux/sched.h>
+#include <linux/uaccess.h>
+#include <linux/vmalloc.h>
+
+#include "mt_cputime.h"
+
+#define SNAP_RECS	1024	/* per CPU and interval */
+
+struct snap_cpu_buf {
+	u32 nr;
+	u32 dropped;
+	struct mt_cputime_snap_rec rec[SNAP_RECS];
+};
+
+int mt_cputime_snap_enabled;
+static u32 snap_gen = 1;
+static DEFINE_PER_CPU(struct snap_cpu_buf *, snap_buf[2]);
+static DEFINE_MUTEX(snap_lock);
+static struct mt_cputime_snap_hdr *snap;
+static unsigned long long snap_last_ns;
+
+void __mt_cputime_snap_account(struct task_struct *p)
+{
+	u32 gen = ACCESS_ONCE(snap_gen);
+	int cpu = smp_processor_id();
+	struct snap_cpu_buf *b = per_cpu(snap_buf, cpu)[gen & 1];
+	struct mt_cputime_snap_rec *r;
+	u64 delta;
+
+	if (!p->pid || !b)
+		return;
+
+	delta = p->se.sum_exec_runtime - p->se.mtk_snap_runtime;
+	if (!delta)
+		return;
+
+	if (p->se.mtk_snap_gen != gen || p->se.mtk_snap_cpu != cpu) {
+		if (b->nr >= SNAP_RECS) {
+			/* keep the delta, it goes to the next interval */
+			b->dropped++;
+			return;
+		}
+		p->se.mtk_snap_gen = gen;
+		p->se.mtk_snap_cpu = cpu;
+		p->se.mtk_snap_slot = b->nr;
+		r = &b->rec[b->nr++];
+		r->pid = p->pid;
+		r->tgid = p->tgid;
+		r->cpu = cpu;
+		r->reserved = 0;
+		r->runtime_ns = 0;
+		memcpy(r->comm, p->comm, sizeof(r->comm));
+	} else {
+		r = &b->rec[p->se.mtk_snap_slot];
+	}
+
+	r->runtime_ns += delta;
+	p->se.mtk_snap_runtime = p->se.sum_exec_runtime;
+}
+
+/* called with snap_lock held */
+static void snap_capture(void)
+{
+	struct mt_cputime_snap_rec *out;
+	u32 old = snap_gen, nr = 0, dropped = 0;
+	int cpu;
+
+	if (!snap)
+		return;
+
+	ACCESS_ONCE(snap_gen) = (old + 1) ? old + 1 : 1;
+	/* the accounting runs with the rq lock held, so this waits it out */
+	synchronize_sched();
+
+	snap->seq++;
+	smp_wmb();
+
+	out = (struct mt_cputime_snap_rec *)(snap + 1);
+	for_each_possible_cpu(cpu) {
+		struct snap_cpu_buf *b = per_cpu(snap_buf, cpu)[old & 1];
+
+		if (!b)
+			continue;
+		memcpy(&out[nr], b->rec, b->nr * sizeof(*out));
+		nr += b->nr;
+		dropped += b->dropped;
+		b->nr = 0;
+		b->dropped = 0;
+	}
+
+	snap->magic = MT_CPUTIME_SNAP_MAGIC;
+	snap->version = MT_CPUTIME_SNAP_VERSION;
+	snap->hdr_size = sizeof(*snap);
+	snap->rec_size = sizeof(*out);
+	snap->nr_recs = nr;
+	snap->dropped = dropped;
+	snap->start_ns = snap_last_ns;
+	snap->end_ns = snap_last_ns = sched_clock();
+
+	smp_wmb();
+	snap->seq++;
+}
+
+/* called with snap_lock held */
+static int snap_start(void)
+{
+	struct task_struct *g, *p;
+	int cpu, i;
+
+	if (!snap) {
+		snap = vmalloc_user(sizeof(*snap) + num_possible_cpus() *
+				    SNAP_RECS * sizeof(struct mt_cputime_snap_rec));
+		if (!snap)
+			return -ENOMEM;
+	}
+
+	for_each_possible_cpu(cpu) {
+		for (i = 0; i < 2; i++) {
+			struct snap_cpu_buf *b = per_cpu(snap_buf, cpu)[i];
+
+			if (!b) {
+				b = vzalloc(sizeof(struct snap_cpu_buf));
+				if (!b)
+					return -ENOMEM;
+				per_cpu(snap_buf, cpu)[i] = b;
+			}
+			b->nr = 0;
+			b->dropped = 0;
+		}
+	}
+
+	/* only what is used from now on counts */
+	rcu_read_lock();
+	do_each_thread(g, p) {
+		p->se.mtk_snap_runtime = p->se.sum_exec_runtime;
+		p->se.mtk_snap_gen = 0;
+	} while_each_thread(g, p);
+	rcu_read_unlock();
+
+	snap_last_ns = sched_clock();
+	mt_cputime_snap_enabled = 1;
+	return 0;
+}
+
+static ssize_t mt_cputime_snap_read(struct file *filp, char __user *ubuf,
+				    size_t cnt, loff_t *ppos)
+{
+	ssize_t ret = 0;
+	size_t used;
+
+	mutex_lock(&snap_lock);
+	if (!snap)
+		goto out;
+	if (*ppos == 0 && mt_cputime_snap_enabled)
+		snap_capture();
+	used = sizeof(*snap) + snap->nr_recs * sizeof(struct mt_cputime_snap_rec);
+	ret = simple_read_from_buffer(ubuf, cnt, ppos, snap, used);
+out:
+	mutex_unlock(&snap_lock);
+	return ret;
+}
+
+static ssize_t mt_cputime_snap_write(struct file *filp, const char __user *ubuf,
+				     size_t cnt, loff_t *ppos)
+{
+	char buf[16];
+	unsigned long val;
+	int ret;
+
+	if (cnt >= sizeof(buf))
+		return -EINVAL;
+
+	if (copy_from_user(&buf, ubuf, cnt))
+		return -EFAULT;
+
+	buf[cnt] = 0;
+
+	ret = kstrtoul(buf, 10, &val);
+	if (ret < 0)
+		return ret;
+
+	mutex_lock(&snap_lock);
+	if (val == 1 && !mt_cputime_snap_enabled) {
+		ret = snap_start();
+	} else if (val == 0 && mt_cputime_snap_enabled) {
+		mt_cputime_snap_enabled = 0;
+		synchronize_sched();
+	} else if (val == 2 && mt_cputime_snap_enabled) {
+		snap_capture();
+	}
+	mutex_unlock(&snap_lock);
+
+	return ret ? ret : cnt;
+}
+
+/* read only; the buffer is only freed with the kernel */
+static int mt_cputime_snap_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	int ret = -ENODEV;
+
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	mutex_lock(&snap_lock);
+	if (snap)
+		ret = remap_vmalloc_range(vma, snap, vma->vm_pgoff);
+	mutex_unlock(&snap_lock);
+
+	return ret;
+}
+
+static const struct file_operations mt_cputime_snap_fops = {
+	.read = mt_cputime_snap_read,
+	.write = mt_cputime_snap_write,
+	.mmap = mt_cputime_snap_mmap,
+	.llseek = default_llseek,
+};
+
+/* after mtprof/ is created */
+static int __init init_cputime_snap(void)
+{
+	if (!proc_create("mtprof/cputime_snap", 0664, NULL, &mt_cputime_snap_fops))
+		return -ENOMEM;
+	return 0;
+}
+late_initcall(init_cputime_snap);
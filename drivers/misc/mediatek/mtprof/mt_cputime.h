@@ -1,3 +1,6 @@
+#ifndef _MT_CPUTIME_H
+#define _MT_CPUTIME_H
+
 #include <linux/sched.h>
 
 bool mtsched_is_enabled(void);
@@ -14,3 +17,51 @@ static inline void end_mtproc_info(struct task_struct *p) {};
 static inline void mt_cputime_switch(int on) {};
 #endif
 
+/*
+ * /proc/mtprof/cputime_snap
+ *
+ * Binary snapshot of the cputime used since the previous one, read() or
+ * mmap() it.  The layout only grows at the end of each struct, with
+ * hdr_size/rec_size giving the sizes in use; version changes if a field
+ * ever changes meaning.  seq is odd while a snapshot is being written.
+ */
+#define MT_CPUTIME_SNAP_MAGIC	0x5343544d	/* "MTCS" */
+#define MT_CPUTIME_SNAP_VERSION	1
+
+struct mt_cputime_snap_hdr {
+	__u32 magic;
+	__u16 version;
+	__u16 hdr_size;
+	__u32 rec_size;
+	__u32 nr_recs;
+	__u32 dropped;		/* records lost to full per-CPU buffers */
+	__u32 seq;
+	__u64 start_ns;		/* sched_clock() of the previous snapshot */
+	__u64 end_ns;
+};
+
+/* one record per thread and CPU, more if it went back and forth */
+struct mt_cputime_snap_rec {
+	__s32 pid;
+	__s32 tgid;
+	__u32 cpu;
+	__u32 reserved;
+	__u64 runtime_ns;
+	char comm[16];
+};
+
+#ifdef CONFIG_MTPROF_CPUTIME
+extern int mt_cputime_snap_enabled;
+extern void __mt_cputime_snap_account(struct task_struct *p);
+
+/* rq lock held, @p is or just was current on this CPU */
+static inline void mt_cputime_snap_account(struct task_struct *p)
+{
+	if (unlikely(mt_cputime_snap_enabled))
+		__mt_cputime_snap_account(p);
+}
+#else
+static inline void mt_cputime_snap_account(struct task_struct *p) {};
+#endif
+
+#endif /* _MT_CPUTIME_H */
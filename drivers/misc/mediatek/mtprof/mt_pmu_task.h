@@ -0,0 +1,26 @@
+#ifndef _MT_PMU_TASK_H
+#define _MT_PMU_TASK_H
+
+#include <linux/sched.h>
+
+/*
+ * /proc/mtprof/pmu_task
+ *
+ * Cycles, instructions, L1D/L2D refills and branch mispredictions of
+ * every task, charged at context switch from per-CPU counting events.
+ */
+#ifdef CONFIG_MTPROF_PMU_TASK
+extern int mt_pmu_task_enabled;
+extern void __mt_pmu_task_account(struct task_struct *p);
+
+/* rq lock held, @p is being switched out on this CPU */
+static inline void mt_pmu_task_account(struct task_struct *p)
+{
+	if (unlikely(mt_pmu_task_enabled))
+		__mt_pmu_task_account(p);
+}
+#else
+static inline void mt_pmu_task_account(struct task_struct *p) {};
+#endif
+
+#endif /* _MT_PMU_TASK_H */
@@ -133,18 +133,35 @@ DECLARE_PER_CPU(unsigned long long, local_timer_te);
 #define MON_RESET 2
 
 #ifdef CONFIG_MT_RT_THROTTLE_MON
+extern u32 mt_rt_mon_gen;	/* current window, 0 when not monitoring */
+
+/* update_curr_rt(): charge @p's runtime to the current window */
+static inline void mt_rt_mon_account(struct task_struct *p, u64 delta_exec)
+{
+	u32 gen = ACCESS_ONCE(mt_rt_mon_gen);
+
+	if (!gen)
+		return;
+	if (p->se.mtk_rt_mon_gen != gen) {
+		p->se.mtk_rt_mon_cputime = 0;
+		p->se.mtk_rt_mon_isr_start = p->se.mtk_isr_time;
+		p->se.mtk_rt_mon_gen = gen;
+	}
+	p->se.mtk_rt_mon_cputime += delta_exec;
+}
+
 extern void save_mt_rt_mon_info(struct task_struct *p, unsigned long long ts);
 extern void end_mt_rt_mon_info(struct task_struct *p);
-extern void check_mt_rt_mon_info(struct task_struct *p);
 extern void mt_rt_mon_switch(int on);
 extern void mt_rt_mon_print_task(void);
 extern void mt_rt_mon_print_task_from_buffer(void);
 extern int mt_rt_mon_enable(void);
 #else
 static inline void
+mt_rt_mon_account(struct task_struct *p, u64 delta_exec) {};
+static inline void
 save_mt_rt_mon_info(struct task_struct *p, unsigned long long ts) {};
 static inline void end_mt_rt_mon_info(struct task_struct *p) {};
-static inline void check_mt_rt_mon_info(struct task_struct *p) {};
 static inline void mt_rt_mon_switch(int on) {};
 static inline void mt_rt_mon_print_task(void) {};
 static inline void mt_rt_mon_print_task_from_buffer(void) {};
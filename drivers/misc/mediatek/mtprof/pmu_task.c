@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2015 MediaTek Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Per-task PMU counts.
+ *
+ * One counting perf event per CPU and ARMv8 event, no sampling: at every
+ * context switch what the counters moved since the previous one is
+ * charged to the task going out.  A53 has six counters and the cycle
+ * counter for the five events; if MET or perf take some of them, perf
+ * rotates the events and the counts only cover the time they ran.
+ *
+ * echo 1/0 > /proc/mtprof/pmu_task starts/stops it, echo 2 starts a new
+ * window: tasks are listed with what they did since the window started.
+ */
+
+#include <linux/cpu.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/mutex.h>
+#include <linux/percpu.h>
+#include <linux/perf_event.h>
+#include <linux/proc_fs.h>
+#include <linux/rcupdate.h>
+#include <linux/sched.h>
+#include <linux/uaccess.h>
+
+#include "internal.h"
+#include "mt_pmu_task.h"
+
+/* ARMv8 PMUv3 architectural events, in the order of mtk_pmu_count[] */
+static const u64 mt_pmu_events[MTK_PMU_NR_EVENTS] = {
+	0x11,	/* CPU_CYCLES */
+	0x08,	/* INST_RETIRED */
+	0x03,	/* L1D_CACHE_REFILL */
+	0x17,	/* L2D_CACHE_REFILL */
+	0x10,	/* BR_MIS_PRED */
+};
+
+enum {
+	PMU_CYCLES,
+	PMU_INST,
+	PMU_L1D,
+	PMU_L2D,
+	PMU_BR,
+};
+
+struct pmu_task_cpu {
+	struct perf_event *ev[MTK_PMU_NR_EVENTS];
+	u64 last[MTK_PMU_NR_EVENTS];
+};
+
+int mt_pmu_task_enabled;
+static u32 pmu_task_gen = 1;
+static unsigned long long pmu_task_window_ns;
+static DEFINE_PER_CPU(struct pmu_task_cpu, pmu_task_cpu);
+static DEFINE_MUTEX(pmu_task_lock);
+
+void __mt_pmu_task_account(struct task_struct *p)
+{
+	struct pmu_task_cpu *pc = this_cpu_ptr(&pmu_task_cpu);
+	u32 gen = ACCESS_ONCE(pmu_task_gen);
+	int i;
+
+	if (p->se.mtk_pmu_gen != gen) {
+		memset(p->se.mtk_pmu_count, 0, sizeof(p->se.mtk_pmu_count));
+		p->se.mtk_pmu_gen = gen;
+	}
+
+	for (i = 0; i < MTK_PMU_NR_EVENTS; i++) {
+		struct perf_event *ev = ACCESS_ONCE(pc->ev[i]);
+		u64 val;
+
+		/* not on a counter right now, rotated out or in error */
+		if (!ev || ev->state != PERF_EVENT_STATE_ACTIVE)
+			continue;
+
+		/* what __perf_event_read() does, irqs are off */
+		ev->pmu->read(ev);
+		val = local64_read(&ev->count);
+		p->se.mtk_pmu_count[i] += val - pc->last[i];
+		pc->last[i] = val;
+	}
+}
+
+/* called with pmu_task_lock held */
+static void pmu_task_cpu_release(int cpu)
+{
+	struct pmu_task_cpu *pc = &per_cpu(pmu_task_cpu, cpu);
+	struct perf_event *ev[MTK_PMU_NR_EVENTS];
+	int i;
+
+	for (i = 0; i < MTK_PMU_NR_EVENTS; i++) {
+		ev[i] = pc->ev[i];
+		ACCESS_ONCE(pc->ev[i]) = NULL;
+	}
+	/* the accounting runs with the rq lock held */
+	synchronize_sched();
+	for (i = 0; i < MTK_PMU_NR_EVENTS; i++) {
+		if (ev[i])
+			perf_event_release_kernel(ev[i]);
+	}
+}
+
+/* called with pmu_task_lock held */
+static void pmu_task_cpu_create(int cpu)
+{
+	struct pmu_task_cpu *pc = &per_cpu(pmu_task_cpu, cpu);
+	struct perf_event_attr attr = {
+		.type = PERF_TYPE_RAW,
+		.size = sizeof(struct perf_event_attr),
+		.disabled = 0,
+	};
+	struct perf_event *ev;
+	int i;
+
+	for (i = 0; i < MTK_PMU_NR_EVENTS; i++) {
+		if (pc->ev[i])
+			continue;
+		attr.config = mt_pmu_events[i];
+		ev = perf_event_create_kernel_counter(&attr, cpu, NULL, NULL, NULL);
+		if (IS_ERR(ev)) {
+			pr_err("[PMU_TASK] cpu%d event 0x%llx: %ld\n",
+			       cpu, mt_pmu_events[i], PTR_ERR(ev));
+			continue;
+		}
+		pc->last[i] = 0;
+		smp_wmb();
+		ACCESS_ONCE(pc->ev[i]) = ev;
+	}
+}
+
+/* hotplug is frequent here, the events follow the CPUs */
+static int pmu_task_cpu_callback(struct notifier_block *nfb,
+				 unsigned long action, void *hcpu)
+{
+	int cpu = (long)hcpu;
+
+	switch (action & ~CPU_TASKS_FROZEN) {
+	case CPU_ONLINE:
+	case CPU_DOWN_FAILED:
+		mutex_lock(&pmu_task_lock);
+		if (mt_pmu_task_enabled)
+			pmu_task_cpu_create(cpu);
+		mutex_unlock(&pmu_task_lock);
+		break;
+	case CPU_DOWN_PREPARE:
+		mutex_lock(&pmu_task_lock);
+		pmu_task_cpu_release(cpu);
+		mutex_unlock(&pmu_task_lock);
+		break;
+	}
+	return NOTIFY_OK;
+}
+
+static struct notifier_block pmu_task_cpu_nb = {
+	.notifier_call = pmu_task_cpu_callback,
+};
+
+MT_DEBUG_ENTRY(pmu_task);
+
+/* called with pmu_task_lock held */
+void mt_pmu_task_switch(int on)
+{
+	int cpu;
+
+	if (on == mt_pmu_task_enabled)
+		return;
+
+	get_online_cpus();
+	if (on) {
+		pmu_task_window_ns = sched_clock();
+		ACCESS_ONCE(pmu_task_gen) = pmu_task_gen + 1;
+		for_each_online_cpu(cpu)
+			pmu_task_cpu_create(cpu);
+		mt_pmu_task_enabled = 1;
+	} else {
+		mt_pmu_task_enabled = 0;
+		for_each_online_cpu(cpu)
+			pmu_task_cpu_release(cpu);
+	}
+	put_online_cpus();
+}
+
+/* per thousand instructions, with one decimal */
+static void pmu_task_print_mpki(struct seq_file *m, u64 misses, u64 inst)
+{
+	u64 x10 = inst ? div64_u64(misses * 10000, inst) : 0;
+
+	SEQ_printf(m, " %5llu.%llu", div_u64(x10, 10), x10 - div_u64(x10, 10) * 10);
+}
+
+static int mt_pmu_task_show(struct seq_file *m, void *v)
+{
+	struct task_struct *g, *p;
+	u32 gen;
+
+	mutex_lock(&pmu_task_lock);
+	gen = pmu_task_gen;
+	SEQ_printf(m, "%d: window of %llu ms\n", mt_pmu_task_enabled,
+		   div_u64(sched_clock() - pmu_task_window_ns, NSEC_PER_MSEC));
+	SEQ_printf(m, "%6s %6s %-16s %12s %12s %5s %7s %7s %7s\n",
+		   "pid", "tgid", "comm", "cycles", "inst", "ipc",
+		   "l1d_mpki", "l2d_mpki", "br_mpki");
+
+	rcu_read_lock();
+	do_each_thread(g, p) {
+		u64 *c = p->se.mtk_pmu_count;
+		u64 ipc;
+
+		if (p->se.mtk_pmu_gen != gen || !c[PMU_CYCLES])
+			continue;
+		ipc = div64_u64(c[PMU_INST] * 100, c[PMU_CYCLES]);
+		SEQ_printf(m, "%6d %6d %-16s %12llu %12llu %2llu.%02llu",
+			   p->pid, p->tgid, p->comm, c[PMU_CYCLES], c[PMU_INST],
+			   div_u64(ipc, 100), ipc - div_u64(ipc, 100) * 100);
+		pmu_task_print_mpki(m, c[PMU_L1D], c[PMU_INST]);
+		pmu_task_print_mpki(m, c[PMU_L2D], c[PMU_INST]);
+		pmu_task_print_mpki(m, c[PMU_BR], c[PMU_INST]);
+		SEQ_printf(m, "\n");
+	} while_each_thread(g, p);
+	rcu_read_unlock();
+	mutex_unlock(&pmu_task_lock);
+
+	return 0;
+}
+
+static ssize_t mt_pmu_task_write(struct file *filp, const char *ubuf,
+				 size_t cnt, loff_t *data)
+{
+	char buf[16];
+	unsigned long val;
+	int ret;
+
+	if (cnt >= sizeof(buf))
+		return -EINVAL;
+
+	if (copy_from_user(&buf, ubuf, cnt))
+		return -EFAULT;
+
+	buf[cnt] = 0;
+
+	ret = kstrtoul(buf, 10, &val);
+	if (ret < 0)
+		return ret;
+
+	mutex_lock(&pmu_task_lock);
+	if (val == 0 || val == 1) {
+		mt_pmu_task_switch(val);
+	} else if (val == 2) {
+		pmu_task_window_ns = sched_clock();
+		ACCESS_ONCE(pmu_task_gen) = pmu_task_gen + 1;
+	}
+	mutex_unlock(&pmu_task_lock);
+
+	return cnt;
+}
+
+/* after mtprof/ is created */
+static int __init init_pmu_task(void)
+{
+	if (!proc_create("mtprof/pmu_task", 0664, NULL, &mt_pmu_task_fops))
+		return -ENOMEM;
+	return register_cpu_notifier(&pmu_task_cpu_nb);
+}
+late_initcall(init_pmu_task);
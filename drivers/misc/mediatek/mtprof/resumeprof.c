@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2015 MediaTek Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Timeline of the last system resume: the length of each dpm phase and
+ * every device callback that took longer than thres_us.
+ */
+
+#include <linux/proc_fs.h>
+#include <linux/sched.h>
+#include <linux/device.h>
+#include <linux/spinlock.h>
+#include <linux/module.h>
+#include <linux/moduleparam.h>
+#include <asm/uaccess.h>
+#include <linux/printk.h>
+
+#include "internal.h"
+#include "bootprof.h"
+
+#define RESUME_NAME_SIZE 32
+#define RESUME_LOG_NUM 256
+
+struct resume_log_struct {
+	s64 start;		/* ns from the start of the phase */
+	s64 duration;		/* ns */
+	const char *info;
+	pid_t pid;
+	enum resume_phase phase;
+	char name[RESUME_NAME_SIZE];
+};
+
+static struct resume_log_struct mt_resumeprof[RESUME_LOG_NUM];
+static int resume_log_count;
+static int resume_log_dropped;
+static ktime_t resume_phase_start[RESUME_PHASE_DONE + 1];
+static enum resume_phase resume_cur_phase = RESUME_PHASE_DONE;
+static DEFINE_SPINLOCK(mt_resumeprof_lock);
+static bool mt_resumeprof_enabled = true;
+static int resumeprof_thres_us = 500;
+
+module_param_named(thres_us, resumeprof_thres_us, int, S_IRUGO | S_IWUSR);
+
+static const char * const resume_phase_name[] = {
+	[RESUME_PHASE_NOIRQ] = "noirq",
+	[RESUME_PHASE_EARLY] = "early",
+	[RESUME_PHASE_RESUME] = "resume",
+	[RESUME_PHASE_COMPLETE] = "complete",
+};
+
+static s64 resume_phase_ns(enum resume_phase phase)
+{
+	if (phase >= RESUME_PHASE_DONE ||
+	    !ktime_to_ns(resume_phase_start[phase]) ||
+	    !ktime_to_ns(resume_phase_start[phase + 1]))
+		return 0;
+	return ktime_to_ns(ktime_sub(resume_phase_start[phase + 1],
+				     resume_phase_start[phase]));
+}
+
+static s64 resume_total_ns(void)
+{
+	enum resume_phase phase;
+
+	for (phase = RESUME_PHASE_NOIRQ; phase < RESUME_PHASE_DONE; phase++) {
+		if (ktime_to_ns(resume_phase_start[phase]))
+			return ktime_to_ns(ktime_sub(resume_phase_start[RESUME_PHASE_DONE],
+						     resume_phase_start[phase]));
+	}
+	return 0;
+}
+
+/*
+ * Called by the PM core when a resume phase starts.  A phase that does not
+ * follow the current one starts a new timeline: a failed suspend goes
+ * straight to RESUME_PHASE_RESUME, for instance.
+ */
+void log_resume_phase(enum resume_phase phase)
+{
+	unsigned long flags;
+	ktime_t now = ktime_get();
+
+	if (!mt_resumeprof_enabled)
+		return;
+
+	spin_lock_irqsave(&mt_resumeprof_lock, flags);
+	if (resume_cur_phase == RESUME_PHASE_DONE || phase <= resume_cur_phase) {
+		memset(resume_phase_start, 0, sizeof(resume_phase_start));
+		resume_log_count = 0;
+		resume_log_dropped = 0;
+	}
+	resume_phase_start[phase] = now;
+	resume_cur_phase = phase;
+	spin_unlock_irqrestore(&mt_resumeprof_lock, flags);
+
+	if (phase == RESUME_PHASE_DONE) {
+		s64 total = resume_total_ns();
+
+		pr_warn("RESUMEPROF: noirq %lld early %lld resume %lld complete %lld total %lld us\n",
+			resume_phase_ns(RESUME_PHASE_NOIRQ) >> 10,
+			resume_phase_ns(RESUME_PHASE_EARLY) >> 10,
+			resume_phase_ns(RESUME_PHASE_RESUME) >> 10,
+			resume_phase_ns(RESUME_PHASE_COMPLETE) >> 10,
+			total >> 10);
+	}
+}
+
+/* Called by the PM core after each device callback. */
+void log_resume_dev(struct device *dev, const char *info, ktime_t starttime)
+{
+	struct resume_log_struct *p;
+	unsigned long flags;
+	ktime_t now;
+	s64 duration;
+
+	if (!mt_resumeprof_enabled || resume_cur_phase == RESUME_PHASE_DONE)
+		return;
+
+	now = ktime_get();
+	duration = ktime_to_ns(ktime_sub(now, starttime));
+	if (duration < (s64)resumeprof_thres_us * NSEC_PER_USEC)
+		return;
+
+	spin_lock_irqsave(&mt_resumeprof_lock, flags);
+	if (resume_log_count >= RESUME_LOG_NUM) {
+		resume_log_dropped++;
+		goto out;
+	}
+	p = &mt_resumeprof[resume_log_count++];
+	p->start = ktime_to_ns(ktime_sub(starttime, resume_phase_start[resume_cur_phase]));
+	p->duration = duration;
+	p->info = info;
+	p->pid = current->pid;
+	p->phase = resume_cur_phase;
+	strlcpy(p->name, dev_name(dev), sizeof(p->name));
+out:
+	spin_unlock_irqrestore(&mt_resumeprof_lock, flags);
+}
+
+MT_DEBUG_ENTRY(resumeprof);
+
+void mt_resumeprof_switch(int on)
+{
+	mt_resumeprof_enabled = on;
+}
+
+static ssize_t
+mt_resumeprof_write(struct file *filp, const char *ubuf, size_t cnt, loff_t *data)
+{
+	char buf;
+
+	if (cnt < 1 || copy_from_user(&buf, ubuf, 1))
+		return -EFAULT;
+
+	if (buf == '0')
+		mt_resumeprof_switch(0);
+	else if (buf == '1')
+		mt_resumeprof_switch(1);
+
+	return cnt;
+}
+
+static int mt_resumeprof_show(struct seq_file *m, void *v)
+{
+	enum resume_phase phase;
+	int i;
+
+	SEQ_printf(m, "----------------------------------------\n");
+	SEQ_printf(m, "%d	    RESUME PROF (unit:msec)\n", mt_resumeprof_enabled);
+	SEQ_printf(m, "----------------------------------------\n");
+
+	for (phase = RESUME_PHASE_NOIRQ; phase < RESUME_PHASE_DONE; phase++)
+		SEQ_printf(m, "%10Ld.%06ld : %s\n",
+			   nsec_high(resume_phase_ns(phase)),
+			   nsec_low(resume_phase_ns(phase)),
+			   resume_phase_name[phase]);
+	SEQ_printf(m, "%10Ld.%06ld : total\n",
+		   nsec_high(resume_total_ns()), nsec_low(resume_total_ns()));
+
+	SEQ_printf(m, "----------------------------------------\n");
+	SEQ_printf(m, "callbacks over %d us, start is from the phase start\n",
+		   resumeprof_thres_us);
+	SEQ_printf(m, "%-8s %17s %17s %6s  %s\n",
+		   "phase", "start", "time", "pid", "device");
+
+	for (i = 0; i < resume_log_count; i++) {
+		struct resume_log_struct *p = &mt_resumeprof[i];
+
+		SEQ_printf(m, "%-8s %10Ld.%06ld %10Ld.%06ld %6d  %s (%scallback)\n",
+			   resume_phase_name[p->phase],
+			   nsec_high(p->start), nsec_low(p->start),
+			   nsec_high(p->duration), nsec_low(p->duration),
+			   p->pid, p->name, p->info ? p->info : "");
+	}
+
+	if (resume_log_dropped)
+		SEQ_printf(m, "%d callbacks not logged, buffer full\n",
+			   resume_log_dropped);
+	SEQ_printf(m, "----------------------------------------\n");
+	return 0;
+}
+
+static int __init init_resume_prof(void)
+{
+	struct proc_dir_entry *pe;
+
+	pe = proc_create("resumeprof", 0664, NULL, &mt_resumeprof_fops);
+	if (!pe)
+		return -ENOMEM;
+	return 0;
+}
+
+device_initcall(init_resume_prof);
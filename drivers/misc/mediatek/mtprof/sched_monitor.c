@@ -8,6 +8,7 @@
 #include <linux/uaccess.h>
 #include <linux/module.h>
 #include <linux/pid.h>
+#include <linux/vmalloc.h>
 
 #include <linux/irq.h>
 #include <linux/irqnr.h>
@@ -68,6 +69,39 @@ DEFINE_PER_CPU(int, MT_trace_in_resume_console);
 
 static DEFINE_MUTEX(mt_sched_mon_lock);
 
+#ifdef CONFIG_MT_SCHED_MONITOR
+/*
+ * Latency histograms, /proc/mtmon/lat_hist
+ *
+ * log2 buckets in us: bucket 0 is < 1us, bucket n is [2^(n-1), 2^n) us and
+ * the last one takes everything longer.  Each CPU only writes its own.
+ * IRQ handlers and softirq vectors are counted while lat_hist is on; the
+ * irqs-off and preempt-off sections come from the sched_mon monitors, so
+ * those also need the matching sched_mon bit.
+ */
+#define LAT_HIST_BUCKETS	16
+
+struct mt_lat_hist {
+	u32 irqs_off[LAT_HIST_BUCKETS];
+	u32 preempt_off[LAT_HIST_BUCKETS];
+	u32 softirq[NR_SOFTIRQS][LAT_HIST_BUCKETS];
+	u32 (*irq)[LAT_HIST_BUCKETS];	/* MAX_NR_IRQS entries */
+};
+
+static DEFINE_PER_CPU(struct mt_lat_hist, mt_lat_hist);
+static int mt_lat_hist_enabled;
+
+static inline void lat_hist_add(u32 *hist, unsigned long long dur)
+{
+	unsigned long long us = div_u64(dur, NSEC_PER_USEC);
+	int n = us ? fls64(us) : 0;
+
+	hist[min(n, LAT_HIST_BUCKETS - 1)]++;
+}
+#else
+#define lat_hist_add(hist, dur)	do {} while (0)
+#endif
+
 
 /* //////////////////////////////////////////////////////// */
 #define SPLIT_NS_H(x) nsec_high(x)
@@ -261,6 +295,12 @@ void mt_trace_ISR_end(int irq)
 	b->cur_event = 0;
 	b->cur_ts = 0;
 	event_duration_check(b);
+	if (mt_lat_hist_enabled && irq < MAX_NR_IRQS) {
+		struct mt_lat_hist *h = &__raw_get_cpu_var(mt_lat_hist);
+
+		if (h->irq)
+			lat_hist_add(h->irq[irq], b->last_te - b->last_ts);
+	}
 	aee_rr_rec_last_irq_exit(smp_processor_id(), irq, b->last_te);
 
 	/* reset HRTimer function counter */
@@ -295,6 +335,9 @@ void mt_trace_SoftIRQ_end(int sq_num)
 	b->cur_event = 0;
 	b->cur_ts = 0;
 	event_duration_check(b);
+	if (mt_lat_hist_enabled && sq_num < NR_SOFTIRQS)
+		lat_hist_add(__raw_get_cpu_var(mt_lat_hist).softirq[sq_num],
+			     b->last_te - b->last_ts);
 
 	/* reset soft timer function counter */
 	b = &__raw_get_cpu_var(sft_mon);
@@ -470,6 +513,8 @@ extern void MT_trace_check_preempt_dur(void)
 			b = &__raw_get_cpu_var(ISR_mon);
 			e = &__raw_get_cpu_var(Preempt_disable_mon);
 			t_dur = current->preempt_dur;
+			if (t_dur && e->last_ts > 0 && e->last_te > 0)
+				lat_hist_add(__raw_get_cpu_var(mt_lat_hist).preempt_off, t_dur);
 
 			if (t_dur > WARN_PREEMPT_DUR && e->last_ts > 0 && e->last_te > 0) {
 				pr_err("[PREEMPT DURATION WARN]dur:%llu ns (s:%llu,e:%llu),lock_dur:%llu owenr:%s lock:%pS\n",
@@ -680,6 +725,7 @@ void MT_trace_hardirqs_on(void)
 			t_diff = t_on - t_off;
 
 			__raw_get_cpu_var(t_irq_on) = t_on;
+			lat_hist_add(__raw_get_cpu_var(mt_lat_hist).irqs_off, t_diff);
 			if (t_diff > t_threshold) {
 				pr_emerg("\n----------------------------[IRQ disable monitor]-------------------------\n");
 				pr_emerg("[Sched Latency Warning:IRQ Disable too long(>%lldms)] Duration: %lld.%lu ms (off:%lld.%lums, on:%lld.%lums)\n",
@@ -781,6 +827,98 @@ static ssize_t mt_sched_monitor_write(struct file *filp, const char *ubuf,
 	return cnt;
 }
 
+#ifdef CONFIG_MT_SCHED_MONITOR
+MT_DEBUG_ENTRY(lat_hist);
+
+static void lat_hist_show_row(struct seq_file *m, const char *name, int id,
+			      u32 *hist)
+{
+	int i;
+
+	for (i = 0; i < LAT_HIST_BUCKETS; i++)
+		if (hist[i])
+			break;
+	if (i == LAT_HIST_BUCKETS)
+		return;
+
+	if (id < 0)
+		SEQ_printf(m, "%-12s", name);
+	else
+		SEQ_printf(m, "%-8s%4d", name, id);
+	for (i = 0; i < LAT_HIST_BUCKETS; i++)
+		SEQ_printf(m, " %7u", hist[i]);
+	SEQ_printf(m, "\n");
+}
+
+static int mt_lat_hist_show(struct seq_file *m, void *v)
+{
+	int cpu, i;
+
+	SEQ_printf(m, "lat_hist: %d (0: off, 1: on, 2: reset)\n",
+		   mt_lat_hist_enabled);
+	SEQ_printf(m, "%-12s %7s", "us", "<1");
+	for (i = 1; i < LAT_HIST_BUCKETS - 1; i++)
+		SEQ_printf(m, " %7u", 1U << (i - 1));
+	SEQ_printf(m, " %6u+\n", 1U << (LAT_HIST_BUCKETS - 2));
+
+	for_each_possible_cpu(cpu) {
+		struct mt_lat_hist *h = &per_cpu(mt_lat_hist, cpu);
+
+		SEQ_printf(m, "CPU#%d\n", cpu);
+		lat_hist_show_row(m, "irqs_off", -1, h->irqs_off);
+		lat_hist_show_row(m, "preempt_off", -1, h->preempt_off);
+		for (i = 0; i < NR_SOFTIRQS; i++)
+			lat_hist_show_row(m, "softirq", i, h->softirq[i]);
+		if (h->irq)
+			for (i = 0; i < MAX_NR_IRQS; i++)
+				lat_hist_show_row(m, "irq", i, h->irq[i]);
+	}
+
+	return 0;
+}
+
+static void lat_hist_reset(void)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct mt_lat_hist *h = &per_cpu(mt_lat_hist, cpu);
+
+		memset(h->irqs_off, 0, sizeof(h->irqs_off));
+		memset(h->preempt_off, 0, sizeof(h->preempt_off));
+		memset(h->softirq, 0, sizeof(h->softirq));
+		if (h->irq)
+			memset(h->irq, 0, MAX_NR_IRQS * sizeof(*h->irq));
+	}
+}
+
+static ssize_t mt_lat_hist_write(struct file *filp, const char *ubuf,
+				 size_t cnt, loff_t *data)
+{
+	char buf[64];
+	unsigned long val;
+	int ret;
+
+	if (cnt >= sizeof(buf))
+		return -EINVAL;
+
+	if (copy_from_user(&buf, ubuf, cnt))
+		return -EFAULT;
+
+	buf[cnt] = 0;
+
+	ret = kstrtoul(buf, 10, &val);
+	if (ret < 0)
+		return ret;
+
+	if (val == 2)
+		lat_hist_reset();
+	else
+		mt_lat_hist_enabled = !!val;
+	return cnt;
+}
+#endif
+
 void reset_sched_monitor(void)
 {
 }
@@ -866,6 +1004,8 @@ static int __init init_mtsched_mon(void)
 		per_cpu(tasklet_mon, cpu).type = evt_TASKLET;
 		per_cpu(hrt_mon, cpu).type = evt_HRTIMER;
 		per_cpu(sft_mon, cpu).type = evt_STIMER;
+		per_cpu(mt_lat_hist, cpu).irq =
+		    vzalloc(MAX_NR_IRQS * sizeof(*per_cpu(mt_lat_hist, cpu).irq));
 	}
 
 	WARN_ISR_DUR = TIME_3MS;
@@ -903,6 +1043,9 @@ static int __init init_mtsched_mon(void)
 	pe = proc_create("mtmon/sched_mon_duration_PREEMPT", 0664, NULL, &mt_sched_monitor_PREEMPT_DUR_fops);
 	if (!pe)
 		return -ENOMEM;
+	pe = proc_create("mtmon/lat_hist", 0664, NULL, &mt_lat_hist_fops);
+	if (!pe)
+		return -ENOMEM;
 #endif
 	return 0;
 }
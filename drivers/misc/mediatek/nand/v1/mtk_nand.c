@@ -3881,6 +3881,26 @@ static u32 mtk_nand_rrtry_setting(flashdev_info deviceinfo, enum readRetryType t
 	return value;
 }
 
+/*
+ * An aged block that needs read retry tends to need the same step for its
+ * other pages, so on Micron, whose steps are independent SET FEATUREs, the
+ * retry starts at the step that recovered the last page and goes round to
+ * the first ones after the last.  Hynix already keeps its position in
+ * g_hynix_retry_count; the other sequences have to start from step 0.
+ */
+static int g_micron_retry_ok;	/* step that recovered the last page */
+
+static int mtk_nand_rrtry_next(int retryCount, int *first)
+{
+	if (gn_devinfo.feature_set.FeatureSet.rtype != RTYPE_MICRON)
+		return retryCount;
+	if (retryCount == 0 && *first < 0)
+		return *first = g_micron_retry_ok;
+	if (retryCount >= gn_devinfo.feature_set.FeatureSet.readRetryCnt && *first > 0)
+		return *first = 0;
+	return retryCount;
+}
+
 typedef void(*rrtryFunctionType) (struct mtd_info *mtd, flashdev_info deviceinfo, u32 feature,
 				 bool defValue);
 
@@ -3931,6 +3951,7 @@ int mtk_nand_exec_read_page(struct mtd_info *mtd, u32 u4RowAddr, u32 u4PageSize,
 	u32 backup_corrected, backup_failed;
 	bool readRetry = FALSE;
 	int retryCount = 0;
+	int retryFirst = -1;
 	u32 retrytotalcnt = gn_devinfo.feature_set.FeatureSet.readRetryCnt;
 	u32 tempBitMap, bitMap;
 #ifdef NAND_PFM
@@ -4238,6 +4259,7 @@ int mtk_nand_exec_read_page(struct mtd_info *mtd, u32 u4RowAddr, u32 u4PageSize,
 			u32 feature;
 
 						tempBitMap = 0;
+			retryCount = mtk_nand_rrtry_next(retryCount, &retryFirst);
 						feature =
 				mtk_nand_rrtry_setting(gn_devinfo,
 						gn_devinfo.feature_set.FeatureSet.rtype,
@@ -4315,6 +4337,8 @@ int mtk_nand_exec_read_page(struct mtd_info *mtd, u32 u4RowAddr, u32 u4PageSize,
 			if ((gn_devinfo.feature_set.FeatureSet.rtype == RTYPE_HYNIX_16NM)
 				|| (gn_devinfo.feature_set.FeatureSet.rtype == RTYPE_HYNIX))
 				g_hynix_retry_count--;
+			if (gn_devinfo.feature_set.FeatureSet.rtype == RTYPE_MICRON)
+				g_micron_retry_ok = retryCount - 1;
 		} else {
 			MSG(INIT,
 				"u4RowAddr: 0x%x read retry fail, mtd_ecc(A): %x , fail, mtd_ecc(B): %x\n",
@@ -4348,6 +4372,7 @@ bool mtk_nand_exec_read_sector(struct mtd_info *mtd, u32 u4RowAddr, u32 u4ColAdd
 	u32 backup_corrected, backup_failed;
 	bool readRetry = FALSE;
 	int retryCount = 0;
+	int retryFirst = -1;
 	u32 retrytotalcnt = gn_devinfo.feature_set.FeatureSet.readRetryCnt;
 	u32 tempBitMap;
 #ifdef NAND_PFM
@@ -4680,7 +4705,10 @@ bool mtk_nand_exec_read_sector(struct mtd_info *mtd, u32 u4RowAddr, u32 u4ColAdd
 		}
 #endif
 		if (bRet == ERR_RTN_BCH_FAIL) {
-			u32 feature = mtk_nand_rrtry_setting(gn_devinfo,
+			u32 feature;
+
+			retryCount = mtk_nand_rrtry_next(retryCount, &retryFirst);
+			feature = mtk_nand_rrtry_setting(gn_devinfo,
 				gn_devinfo.feature_set.FeatureSet.rtype,
 				gn_devinfo.feature_set.FeatureSet.readRetryStart, retryCount);
 #if defined(CONFIG_MTK_TLC_NAND_SUPPORT)
@@ -4750,6 +4778,8 @@ bool mtk_nand_exec_read_sector(struct mtd_info *mtd, u32 u4RowAddr, u32 u4ColAdd
 				|| (gn_devinfo.feature_set.FeatureSet.rtype == RTYPE_HYNIX)) {
 				g_hynix_retry_count--;
 			}
+			if (gn_devinfo.feature_set.FeatureSet.rtype == RTYPE_MICRON)
+				g_micron_retry_ok = retryCount - 1;
 		} else {
 			MSG(INIT, "[Sector RD]u4RowAddr:0x%x read retry fail, mtd_ecc(A):%x , fail, mtd_ecc(B):%x\n",
 				u4RowAddr, mtd->ecc_stats.failed, backup_failed);
@@ -3562,6 +3562,26 @@ static u32 mtk_nand_rrtry_setting(flashdev_info_t deviceinfo, enum readRetryType
 	return value;
 }
 
+/*
+ * An aged block that needs read retry tends to need the same step for its
+ * other pages, so on Micron, whose steps are independent SET FEATUREs, the
+ * retry starts at the step that recovered the last page and goes round to
+ * the first ones after the last.  Hynix already keeps its position in
+ * g_hynix_retry_count; the other sequences have to start from step 0.
+ */
+static int g_micron_retry_ok;	/* step that recovered the last page */
+
+static int mtk_nand_rrtry_next(int retryCount, int *first)
+{
+	if (devinfo.feature_set.FeatureSet.rtype != RTYPE_MICRON)
+		return retryCount;
+	if (retryCount == 0 && *first < 0)
+		return *first = g_micron_retry_ok;
+	if (retryCount >= devinfo.feature_set.FeatureSet.readRetryCnt && *first > 0)
+		return *first = 0;
+	return retryCount;
+}
+
 typedef void (*rrtryFunctionType) (struct mtd_info *mtd, flashdev_info_t deviceinfo, u32 feature,
 				   bool defValue);
 
@@ -3608,6 +3628,7 @@ int mtk_nand_exec_read_page(struct mtd_info *mtd, u32 u4RowAddr, u32 u4PageSize,
 	u32 backup_corrected, backup_failed;
 	bool readRetry = FALSE;
 	int retryCount = 0;
+	int retryFirst = -1;
 	/* u32 val; */
 	u32 tempBitMap;
 #if 0
@@ -3730,6 +3751,7 @@ int mtk_nand_exec_read_page(struct mtd_info *mtd, u32 u4RowAddr, u32 u4PageSize,
 			u32 feature;
 
 			tempBitMap = 0;
+			retryCount = mtk_nand_rrtry_next(retryCount, &retryFirst);
 			/* feature= devinfo.feature_set.FeatureSet.readRetryStart+retryCount; */
 			feature = mtk_nand_rrtry_setting(devinfo, devinfo.feature_set.FeatureSet.rtype,
 						   devinfo.feature_set.FeatureSet.readRetryStart,
@@ -3790,6 +3812,8 @@ int mtk_nand_exec_read_page(struct mtd_info *mtd, u32 u4RowAddr, u32 u4PageSize,
 				|| (devinfo.feature_set.FeatureSet.rtype == RTYPE_HYNIX)) {
 				g_hynix_retry_count--;
 			}
+			if (devinfo.feature_set.FeatureSet.rtype == RTYPE_MICRON)
+				g_micron_retry_ok = retryCount - 1;
 		} else {
 			pr_err("u4RowAddr:0x%x read retry fail, mtd_ecc(A):%x ,fail, mtd_ecc(B):%x\n",
 				u4RowAddr, mtd->ecc_stats.failed, backup_failed);
@@ -3826,6 +3850,7 @@ bool mtk_nand_exec_read_sector(struct mtd_info *mtd, u32 u4RowAddr, u32 u4ColAdd
 	u32 backup_corrected, backup_failed;
 	bool readRetry = FALSE;
 	int retryCount = 0;
+	int retryFirst = -1;
 	u32 tempBitMap;
 #ifdef NAND_PFM
 	struct timeval pfm_time_read;
@@ -3903,8 +3928,11 @@ bool mtk_nand_exec_read_sector(struct mtd_info *mtd, u32 u4RowAddr, u32 u4ColAdd
 		else if (pre_randomizer && u4RowAddr < RAND_START_ADDR)
 			mtk_nand_turn_off_randomizer();
 		if (bRet == ERR_RTN_BCH_FAIL) {
+			u32 feature;
+
+			retryCount = mtk_nand_rrtry_next(retryCount, &retryFirst);
 			/* u32 feature = devinfo.feature_set.FeatureSet.readRetryStart+retryCount; */
-			u32 feature =
+			feature =
 				mtk_nand_rrtry_setting(devinfo, devinfo.feature_set.FeatureSet.rtype,
 						   devinfo.feature_set.FeatureSet.readRetryStart,
 						   retryCount);
@@ -3963,6 +3991,8 @@ bool mtk_nand_exec_read_sector(struct mtd_info *mtd, u32 u4RowAddr, u32 u4ColAdd
 				|| (devinfo.feature_set.FeatureSet.rtype == RTYPE_HYNIX)) {
 				g_hynix_retry_count--;
 			}
+			if (devinfo.feature_set.FeatureSet.rtype == RTYPE_MICRON)
+				g_micron_retry_ok = retryCount - 1;
 		}
 		mtk_nand_rrtry_func(mtd, devinfo, feature, TRUE);
 		g_sandisk_retry_case = 0;
@@ -22,6 +22,7 @@
 #include "mach/fliper.h"
 #include "mach/mt_mem_bw.h"
 #include <mt_vcore_dvfs.h>
+#include <mt-plat/perfmgr.h>
 #define SEQ_printf(m, x...)\
 	do {\
 		if (m)\
@@ -138,19 +139,19 @@ static int pp_index;
 static void mt_power_pef_transfer_work(void);
 static DECLARE_WORK(mt_pp_work, (void *) mt_power_pef_transfer_work);
 
+/* The EMI bandwidth vote goes through the boost arbiter */
 static int vcore_high(void)
 {
-	int ret = 0;
+	struct perfmgr_boost_req req;
 
-	ret = vcorefs_request_dvfs_opp(KIR_EMIBW, OPPI_PERF);
-	return ret;
+	perfmgr_boost_req_init(&req);
+	req.vcore = 1;
+	return perfmgr_boost_request(PERFMGR_BOOST_FLIPER, &req, 0);
 }
 static int vcore_low(void)
 {
-	int ret = 0;
-
-	ret = vcorefs_request_dvfs_opp(KIR_EMIBW, OPPI_UNREQ);
-	return ret;
+	perfmgr_boost_cancel(PERFMGR_BOOST_FLIPER);
+	return 0;
 }
 
 static void mt_power_pef_transfer_work(void)
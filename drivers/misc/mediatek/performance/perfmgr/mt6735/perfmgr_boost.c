@@ -9,6 +9,8 @@
 #include <linux/platform_device.h>
 #include "mt_hotplug_strategy.h"
 #include "mt_cpufreq.h"
+#include "mt_vcore_qos.h"
+#include "perfmgr.h"
 
 /*--------------DEFAULT SETTING-------------------*/
 
@@ -17,6 +19,8 @@
 
 /*-----------------------------------------------*/
 
+static DEFINE_VCORE_QOS_REQUEST(perfmgr_vcore_qos, "perfmgr");
+
 int perfmgr_get_target_core(void)
 {
 	return TARGET_CORE;
@@ -27,16 +31,23 @@ int perfmgr_get_target_freq(void)
 	return TARGET_FREQ;
 }
 
-void perfmgr_boost(int enable, int core, int freq)
+/* At least one LITTLE core always stays up */
+void perfmgr_boost_apply(const struct perfmgr_boost_req *old,
+			 const struct perfmgr_boost_req *new)
 {
-	if (enable) {
-		/* hps */
-		hps_set_cpu_num_base(BASE_PERF_SERV, core, 0);
-		mt_cpufreq_set_min_freq(MT_CPU_DVFS_LITTLE, freq);
-	} else {
-		/* hps */
-		hps_set_cpu_num_base(BASE_PERF_SERV, 1, 0);
-		mt_cpufreq_set_min_freq(MT_CPU_DVFS_LITTLE, 0);
+	if (new->min_cores_l != old->min_cores_l ||
+	    new->min_cores_b != old->min_cores_b)
+		hps_set_cpu_num_base(BASE_PERF_SERV, max(new->min_cores_l, 1),
+				     new->min_cores_b);
+
+	if (new->min_freq_l != old->min_freq_l)
+		mt_cpufreq_set_min_freq(MT_CPU_DVFS_LITTLE, new->min_freq_l);
+
+	if (new->vcore != old->vcore) {
+		if (new->vcore)
+			vcore_qos_update_request(&perfmgr_vcore_qos, 0,
+						 VCORE_QOS_LAT_HPM);
+		else
+			vcore_qos_remove_request(&perfmgr_vcore_qos);
 	}
 }
-
@@ -0,0 +1,301 @@
+/*
+ * Boost arbitration
+ *
+ * Touch boost, dynamic boost, fliper and userspace used to drive hotplug,
+ * the LITTLE cluster minimum frequency and vcore each on their own, so
+ * whichever released last undid the others, and a thermal limit could be
+ * overridden by the next touch.  They are all clients of this arbiter now:
+ * every client holds at most one request, optionally timed, and the
+ * resolved setting is pushed to the platform backend from a work item,
+ * so requests can be filed from any context.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ */
+
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <linux/module.h>
+#include <linux/spinlock.h>
+#include <linux/workqueue.h>
+#include <linux/jiffies.h>
+#include <linux/kernel.h>
+#include <linux/uaccess.h>
+
+#include "perfmgr.h"
+
+#undef TAG
+#define TAG "[PERFMGR]"
+
+struct perfmgr_boost_slot {
+	bool active;
+	bool timed;
+	unsigned long expires;
+	unsigned long count;
+	struct perfmgr_boost_req req;
+	struct delayed_work expire_work;
+};
+
+static const char * const perfmgr_boost_client_name[] = {
+	[PERFMGR_BOOST_FLIPER]	= "fliper",
+	[PERFMGR_BOOST_TOUCH]	= "touch",
+	[PERFMGR_BOOST_DYNAMIC]	= "dynamic",
+	[PERFMGR_BOOST_LAUNCH]	= "launch",
+	[PERFMGR_BOOST_CAMERA]	= "camera",
+	[PERFMGR_BOOST_RENDER]	= "render",
+	[PERFMGR_BOOST_MODEM]	= "modem",
+	[PERFMGR_BOOST_THERMAL]	= "thermal",
+};
+
+static DEFINE_SPINLOCK(boost_lock);
+static struct perfmgr_boost_slot boost_slot[NR_PERFMGR_BOOST_CLIENTS];
+static bool boost_ready;
+
+/* Owned by boost_apply_work */
+static struct perfmgr_boost_req boost_applied;
+
+static void perfmgr_boost_apply_work(struct work_struct *work);
+static DECLARE_WORK(boost_apply_work, perfmgr_boost_apply_work);
+
+/*
+ * Walk the requests from the highest priority client down, keeping a
+ * [floor, cap] range per resource: a floor raises the range's low end but
+ * stops at the cap already in place, a cap lowers the high end but not
+ * below the floor already granted.
+ */
+static void perfmgr_boost_resolve(struct perfmgr_boost_req *out)
+{
+	int lo_l = 0, lo_b = 0, lo_f = 0, vcore = 0;
+	int hi_l = INT_MAX, hi_b = INT_MAX, hi_f = INT_MAX;
+	int i;
+
+	for (i = NR_PERFMGR_BOOST_CLIENTS - 1; i >= 0; i--) {
+		const struct perfmgr_boost_req *r = &boost_slot[i].req;
+
+		if (!boost_slot[i].active)
+			continue;
+
+		lo_l = max(lo_l, min(r->min_cores_l, hi_l));
+		lo_b = max(lo_b, min(r->min_cores_b, hi_b));
+		lo_f = max(lo_f, min(r->min_freq_l, hi_f));
+		if (r->max_cores_l != PERFMGR_BOOST_NO_CAP)
+			hi_l = min(hi_l, max(r->max_cores_l, lo_l));
+		if (r->max_cores_b != PERFMGR_BOOST_NO_CAP)
+			hi_b = min(hi_b, max(r->max_cores_b, lo_b));
+		if (r->max_freq_l != PERFMGR_BOOST_NO_CAP)
+			hi_f = min(hi_f, max(r->max_freq_l, lo_f));
+		vcore |= r->vcore;
+	}
+
+	out->min_cores_l = lo_l;
+	out->min_cores_b = lo_b;
+	out->min_freq_l = lo_f;
+	out->vcore = vcore;
+	out->max_cores_l = hi_l == INT_MAX ? PERFMGR_BOOST_NO_CAP : hi_l;
+	out->max_cores_b = hi_b == INT_MAX ? PERFMGR_BOOST_NO_CAP : hi_b;
+	out->max_freq_l = hi_f == INT_MAX ? PERFMGR_BOOST_NO_CAP : hi_f;
+}
+
+static void perfmgr_boost_apply_work(struct work_struct *work)
+{
+	struct perfmgr_boost_req req;
+	unsigned long flags;
+
+	spin_lock_irqsave(&boost_lock, flags);
+	perfmgr_boost_resolve(&req);
+	spin_unlock_irqrestore(&boost_lock, flags);
+
+	if (!memcmp(&req, &boost_applied, sizeof(req)))
+		return;
+
+	pr_debug(TAG"boost l:%d b:%d freq:%d vcore:%d\n", req.min_cores_l,
+		 req.min_cores_b, req.min_freq_l, req.vcore);
+#ifdef MTK_BOOST_SUPPORT
+	perfmgr_boost_apply(&boost_applied, &req);
+#endif
+	boost_applied = req;
+}
+
+static void perfmgr_boost_expire_work(struct work_struct *work)
+{
+	struct perfmgr_boost_slot *slot = container_of(to_delayed_work(work),
+			struct perfmgr_boost_slot, expire_work);
+	unsigned long flags;
+	bool expired;
+
+	spin_lock_irqsave(&boost_lock, flags);
+	/* Re-armed by a new request while we were waiting for the lock */
+	expired = slot->active && slot->timed &&
+		  time_after_eq(jiffies, slot->expires);
+	if (expired)
+		slot->active = false;
+	spin_unlock_irqrestore(&boost_lock, flags);
+
+	if (expired)
+		queue_work(system_highpri_wq, &boost_apply_work);
+}
+
+/**
+ * perfmgr_boost_request - file or replace the request of a client
+ * @client: requesting client
+ * @req: floors and caps, see perfmgr_boost_req_init()
+ * @duration_ms: lifetime of the request, 0 to keep it until cancelled
+ *
+ * Safe to call from atomic context; the setting is applied shortly after.
+ */
+int perfmgr_boost_request(enum perfmgr_boost_client client,
+			  const struct perfmgr_boost_req *req,
+			  unsigned int duration_ms)
+{
+	struct perfmgr_boost_slot *slot;
+	unsigned long flags;
+
+	if (client < 0 || client >= NR_PERFMGR_BOOST_CLIENTS)
+		return -EINVAL;
+	if (!boost_ready)
+		return -EAGAIN;
+
+	slot = &boost_slot[client];
+
+	spin_lock_irqsave(&boost_lock, flags);
+	slot->active = true;
+	slot->req = *req;
+	slot->count++;
+	slot->timed = duration_ms != 0;
+	if (slot->timed) {
+		slot->expires = jiffies + msecs_to_jiffies(duration_ms);
+		mod_delayed_work(system_wq, &slot->expire_work,
+				 msecs_to_jiffies(duration_ms));
+	} else {
+		cancel_delayed_work(&slot->expire_work);
+	}
+	spin_unlock_irqrestore(&boost_lock, flags);
+
+	queue_work(system_highpri_wq, &boost_apply_work);
+	return 0;
+}
+EXPORT_SYMBOL(perfmgr_boost_request);
+
+/**
+ * perfmgr_boost_cancel - drop the request of a client
+ * @client: client whose request is dropped, if it has one
+ */
+void perfmgr_boost_cancel(enum perfmgr_boost_client client)
+{
+	struct perfmgr_boost_slot *slot;
+	unsigned long flags;
+	bool was_active;
+
+	if (client < 0 || client >= NR_PERFMGR_BOOST_CLIENTS || !boost_ready)
+		return;
+
+	slot = &boost_slot[client];
+
+	spin_lock_irqsave(&boost_lock, flags);
+	was_active = slot->active;
+	slot->active = false;
+	cancel_delayed_work(&slot->expire_work);
+	spin_unlock_irqrestore(&boost_lock, flags);
+
+	if (was_active)
+		queue_work(system_highpri_wq, &boost_apply_work);
+}
+EXPORT_SYMBOL(perfmgr_boost_cancel);
+
+/*--------------------PROC------------------------*/
+
+static void perfmgr_boost_show_req(struct seq_file *m,
+				   const struct perfmgr_boost_req *r)
+{
+	seq_printf(m, " l:%d/%d b:%d/%d freq:%d/%d vcore:%d\n",
+		   r->min_cores_l, r->max_cores_l, r->min_cores_b,
+		   r->max_cores_b, r->min_freq_l, r->max_freq_l, r->vcore);
+}
+
+static int perfmgr_boost_show(struct seq_file *m, void *v)
+{
+	struct perfmgr_boost_slot slot[NR_PERFMGR_BOOST_CLIENTS];
+	struct perfmgr_boost_req resolved;
+	unsigned long flags, now = jiffies;
+	int i;
+
+	spin_lock_irqsave(&boost_lock, flags);
+	memcpy(slot, boost_slot, sizeof(slot));
+	perfmgr_boost_resolve(&resolved);
+	spin_unlock_irqrestore(&boost_lock, flags);
+
+	seq_puts(m, "client   count     left(ms) floor/cap\n");
+	for (i = NR_PERFMGR_BOOST_CLIENTS - 1; i >= 0; i--) {
+		seq_printf(m, "%-8s %-9lu ", perfmgr_boost_client_name[i],
+			   slot[i].count);
+		if (!slot[i].active) {
+			seq_puts(m, "-\n");
+			continue;
+		}
+		if (slot[i].timed && time_before(now, slot[i].expires))
+			seq_printf(m, "%-8u", jiffies_to_msecs(slot[i].expires - now));
+		else
+			seq_printf(m, "%-8s", slot[i].timed ? "0" : "inf");
+		perfmgr_boost_show_req(m, &slot[i].req);
+	}
+	seq_puts(m, "resolved          ");
+	perfmgr_boost_show_req(m, &resolved);
+
+	return 0;
+}
+
+static int perfmgr_boost_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, perfmgr_boost_show, inode->i_private);
+}
+
+static long perfmgr_boost_ioctl(struct file *filp, unsigned int cmd,
+				unsigned long arg)
+{
+	struct perfmgr_boost_ioctl boost;
+	__s32 client;
+
+	switch (cmd) {
+	case PERFMGR_IOC_BOOST:
+		if (copy_from_user(&boost, (void __user *)arg, sizeof(boost)))
+			return -EFAULT;
+		return perfmgr_boost_request(boost.client, &boost.req,
+					     boost.duration_ms);
+	case PERFMGR_IOC_UNBOOST:
+		if (copy_from_user(&client, (void __user *)arg, sizeof(client)))
+			return -EFAULT;
+		if (client < 0 || client >= NR_PERFMGR_BOOST_CLIENTS)
+			return -EINVAL;
+		perfmgr_boost_cancel(client);
+		return 0;
+	}
+
+	return -ENOTTY;
+}
+
+static const struct file_operations perfmgr_boost_fops = {
+	.open = perfmgr_boost_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+	.unlocked_ioctl = perfmgr_boost_ioctl,
+	.compat_ioctl = perfmgr_boost_ioctl,
+};
+
+/*--------------------INIT------------------------*/
+
+int init_perfmgr_boost(void)
+{
+	int i;
+
+	for (i = 0; i < NR_PERFMGR_BOOST_CLIENTS; i++)
+		INIT_DELAYED_WORK(&boost_slot[i].expire_work,
+				  perfmgr_boost_expire_work);
+	perfmgr_boost_req_init(&boost_applied);
+	boost_ready = true;
+
+	proc_create("perfmgr/boost", 0660, NULL, &perfmgr_boost_fops);
+
+	return 0;
+}
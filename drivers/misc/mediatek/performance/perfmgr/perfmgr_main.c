@@ -60,6 +60,7 @@ static int __init init_perfmgr(void)
 
 
 	hps_dir = proc_mkdir("perfmgr", NULL);
+	init_perfmgr_boost();
 #ifdef MTK_TOUCH_BOOST
 	init_perfmgr_touch();
 #endif
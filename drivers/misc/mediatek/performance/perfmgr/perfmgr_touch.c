@@ -9,8 +9,8 @@
 #include <linux/string.h>
 #include <linux/notifier.h>
 #include <linux/slab.h>
-#include <linux/kthread.h>
 #include <linux/input.h>
+#include <linux/jiffies.h>
 
 #include <linux/platform_device.h>
 #include "perfmgr.h"
@@ -32,47 +32,26 @@
 
 struct touch_boost {
 	spinlock_t touch_lock;
-	wait_queue_head_t wq;
-	struct task_struct *thread;
-	int touch_event;
-	atomic_t event;
+	bool down;			/* between BTN_TOUCH press and release */
+	unsigned long irq_until;	/* the interrupt boost lasts until then */
 };
 
 /*--------------------------------------------*/
 
-static struct touch_boost tboost;
+/* the panel interrupt may fire before init_perfmgr_touch() */
+static struct touch_boost tboost = {
+	.touch_lock = __SPIN_LOCK_UNLOCKED(tboost.touch_lock),
+	.irq_until = INITIAL_JIFFIES,
+};
 
 static int perf_mgr_touch_enable = 1;
 static int perf_mgr_touch_core = 1;
 static int perf_mgr_touch_freq = 1;
+/* lifetime of the boost filed from the interrupt, ms, 0: no interrupt boost */
+static int perf_mgr_touch_irq_ms = 100;
 
 /*--------------------FUNCTION----------------*/
 
-static int tboost_thread(void *ptr)
-{
-	int event, core, freq;
-	unsigned long flags;
-
-	set_user_nice(current, -10);
-
-	while (!kthread_should_stop()) {
-
-		while (!atomic_read(&tboost.event))
-			wait_event(tboost.wq, atomic_read(&tboost.event));
-		atomic_dec(&tboost.event);
-
-		spin_lock_irqsave(&tboost.touch_lock, flags);
-		event = tboost.touch_event;
-		core = perf_mgr_touch_core;
-		freq = perf_mgr_touch_freq;
-		spin_unlock_irqrestore(&tboost.touch_lock, flags);
-#ifdef MTK_BOOST_SUPPORT
-		perfmgr_boost(event, core, freq);
-#endif
-	}
-	return 0;
-}
-
 static ssize_t perfmgr_tb_enable_write(struct file *filp, const char *ubuf,
 		size_t cnt, loff_t *data)
 {
@@ -214,6 +193,86 @@ static const struct file_operations perfmgr_tb_freq_fops = {
 	.release = single_release,
 };
 
+static ssize_t perfmgr_tb_irq_ms_write(struct file *filp, const char *ubuf,
+		size_t cnt, loff_t *data)
+{
+	char buf[64];
+	unsigned long val;
+	int ret;
+	unsigned long flags;
+
+	if (cnt >= sizeof(buf))
+		return -EINVAL;
+
+	if (copy_from_user(&buf, ubuf, cnt))
+		return -EFAULT;
+	buf[cnt] = 0;
+	ret = kstrtoul(buf, 10, &val);
+	if (ret < 0)
+		return ret;
+
+	if (val > MSEC_PER_SEC)
+		return -1;
+
+	spin_lock_irqsave(&tboost.touch_lock, flags);
+	perf_mgr_touch_irq_ms = val;
+	spin_unlock_irqrestore(&tboost.touch_lock, flags);
+
+	return cnt;
+}
+
+static int perfmgr_tb_irq_ms_show(struct seq_file *m, void *v)
+{
+	SEQ_printf(m, "%d\n", perf_mgr_touch_irq_ms);
+	return 0;
+}
+
+static int perfmgr_tb_irq_ms_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, perfmgr_tb_irq_ms_show, inode->i_private);
+}
+
+static const struct file_operations perfmgr_tb_irq_ms_fops = {
+	.open = perfmgr_tb_irq_ms_open,
+	.write = perfmgr_tb_irq_ms_write,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+/* called with tboost.touch_lock held */
+static void perfmgr_touch_boost(unsigned int duration_ms)
+{
+	struct perfmgr_boost_req req;
+
+	perfmgr_boost_req_init(&req);
+	req.min_cores_l = perf_mgr_touch_core;
+	req.min_freq_l = perf_mgr_touch_freq;
+
+	perfmgr_boost_request(PERFMGR_BOOST_TOUCH, &req, duration_ms);
+}
+
+/*
+ * The panel interrupt comes one I2C read and one input report before
+ * BTN_TOUCH, so the boost is already being applied when the report is
+ * decoded.  It is filed once per interrupt burst, not per interrupt.
+ */
+void perfmgr_touch_irq_boost(void)
+{
+	unsigned long flags;
+
+	if (!perf_mgr_touch_enable || !perf_mgr_touch_irq_ms)
+		return;
+
+	spin_lock_irqsave(&tboost.touch_lock, flags);
+	if (!tboost.down && time_after_eq(jiffies, tboost.irq_until)) {
+		tboost.irq_until = jiffies + msecs_to_jiffies(perf_mgr_touch_irq_ms / 2);
+		perfmgr_touch_boost(perf_mgr_touch_irq_ms);
+	}
+	spin_unlock_irqrestore(&tboost.touch_lock, flags);
+}
+EXPORT_SYMBOL(perfmgr_touch_irq_boost);
+
 static void dbs_input_event(struct input_handle *handle, unsigned int type,
 			    unsigned int code, int value)
 {
@@ -225,11 +284,14 @@ static void dbs_input_event(struct input_handle *handle, unsigned int type,
 	if ((type == EV_KEY) && (code == BTN_TOUCH)) {
 		pr_debug(TAG"input cb, type:%d, code:%d, value:%d\n", type, code, value);
 		spin_lock_irqsave(&tboost.touch_lock, flags);
-		tboost.touch_event = value;
+		tboost.down = value;
+		tboost.irq_until = jiffies;
+		if (value)
+			perfmgr_touch_boost(0);
 		spin_unlock_irqrestore(&tboost.touch_lock, flags);
 
-		atomic_inc(&tboost.event);
-		wake_up(&tboost.wq);
+		if (!value)
+			perfmgr_boost_cancel(PERFMGR_BOOST_TOUCH);
 	}
 }
 
@@ -304,13 +366,7 @@ int init_perfmgr_touch(void)
 	proc_create("tb_enable", 0644, touch_dir, &perfmgr_tb_enable_fops);
 	proc_create("tb_core", 0644, touch_dir, &perfmgr_tb_core_fops);
 	proc_create("tb_freq", 0644, touch_dir, &perfmgr_tb_freq_fops);
-
-	spin_lock_init(&tboost.touch_lock);
-	init_waitqueue_head(&tboost.wq);
-	atomic_set(&tboost.event, 0);
-	tboost.thread = (struct task_struct *)kthread_run(tboost_thread, &tboost, "touch_boost");
-	if (IS_ERR(tboost.thread))
-		return -EINVAL;
+	proc_create("tb_irq_ms", 0644, touch_dir, &perfmgr_tb_irq_ms_fops);
 
 	handle = input_register_handler(&dbs_input_handler);
 
@@ -319,10 +375,13 @@ int init_perfmgr_touch(void)
 
 int perfmgr_touch_suspend(void)
 {
+	unsigned long flags;
+
 	/*pr_debug(TAG"perfmgr_touch_suspend\n");*/
-#ifdef MTK_BOOST_SUPPORT
-	perfmgr_boost(0, 0, 0);
-#endif
+	spin_lock_irqsave(&tboost.touch_lock, flags);
+	tboost.down = false;
+	spin_unlock_irqrestore(&tboost.touch_lock, flags);
+	perfmgr_boost_cancel(PERFMGR_BOOST_TOUCH);
 	return 0;
 }
 
@@ -80,6 +80,12 @@ static s32 pwrap_wacs2_hal(u32  write, u32  adr, u32  wdata, u32 *rdata)
 	PWRAPERR("there is no PMIC real chip,PMIC_WRAP do Nothing\n");
 	return 0;
 }
+
+static s32 pwrap_batch_hal(struct pwrap_op *ops, int nr)
+{
+	PWRAPERR("there is no PMIC real chip,PMIC_WRAP do Nothing\n");
+	return 0;
+}
 /*
  *pmic_wrap init,init wrap interface
  *
@@ -508,34 +514,26 @@ static inline u32 wait_for_state_ready(loop_condition_fp fp, u32 timeout_us, voi
 	return 0;
 }
 
-/* -------------------------------------------------------- */
-/* Function : pwrap_wacs2_hal() */
-/* Description : */
-/* Parameter : */
-/* Return : */
-/* -------------------------------------------------------- */
-static s32 pwrap_wacs2_hal(u32  write, u32  adr, u32  wdata, u32 *rdata)
+static s32 pwrap_check_arg(u32 write, u32 adr, u32 wdata)
 {
-	/* u64 wrap_access_time=0x0; */
-	u32 reg_rdata = 0;
-	u32 wacs_write = 0;
-	u32 wacs_adr = 0;
-	u32 wacs_cmd = 0;
-	u32 return_value = 0;
-	unsigned long flags = 0;
-	/* PWRAPFUC(); */
-	/* #ifndef CONFIG_MTK_LDVT_PMIC_WRAP */
-	/* PWRAPLOG("wrapper access,write=%x,add=%x,wdata=%x,rdata=%x\n",write,adr,wdata,rdata); */
-	/* #endif */
-	/* Check argument validation */
 	if ((write & ~(0x1))    != 0)
 		return E_PWR_INVALID_RW;
 	if ((adr   & ~(0xffff)) != 0)
 		return E_PWR_INVALID_ADDR;
 	if ((wdata & ~(0xffff)) != 0)
 		return E_PWR_INVALID_WDAT;
+	return 0;
+}
+
+/* one WACS2 command, called with wrp_lock held */
+static s32 _pwrap_wacs2_locked(u32 write, u32 adr, u32 wdata, u32 *rdata)
+{
+	u32 reg_rdata = 0;
+	u32 wacs_write = 0;
+	u32 wacs_adr = 0;
+	u32 wacs_cmd = 0;
+	u32 return_value = 0;
 
-	spin_lock_irqsave(&wrp_lock, flags);
 	/* check pmicaddr 0xa bit11 & bit10 ,bit 11 only can write1 bit 10 only can write 0 request by Wy Chuang */
 	if (0 != write && 0xa == adr) {
 
@@ -550,7 +548,7 @@ static s32 pwrap_wacs2_hal(u32  write, u32  adr, u32  wdata, u32 *rdata)
 	PMIC_WRAP_WACS2_RDATA, PMIC_WRAP_WACS2_VLDCLR, 0);
 	if (return_value != 0) {
 		PWRAPERR("wait_for_fsm_idle fail,return_value=%d\n", return_value);
-		goto FAIL;
+		return return_value;
 	}
 	wacs_write  = write << 31;
 	wacs_adr    = (adr >> 1) << 16;
@@ -560,29 +558,85 @@ static s32 pwrap_wacs2_hal(u32  write, u32  adr, u32  wdata, u32 *rdata)
 	if (write == 0) {
 		if (NULL == rdata) {
 			PWRAPERR("rdata is a NULL pointer\n");
-			return_value = E_PWR_INVALID_ARG;
-			goto FAIL;
+			return E_PWR_INVALID_ARG;
 		}
 		return_value = wait_for_state_ready(wait_for_fsm_vldclr,
 			TIMEOUT_READ, PMIC_WRAP_WACS2_RDATA, &reg_rdata);
 		if (return_value != 0) {
 			PWRAPERR("wait_for_fsm_vldclr fail,return_value=%d\n", return_value);
-			return_value += 1;
-			goto FAIL;
+			return return_value + 1;
 		}
 		*rdata = GET_WACS0_RDATA(reg_rdata);
 		WRAP_WR32(PMIC_WRAP_WACS2_VLDCLR , 1);
 	}
-	/* spin_unlock_irqrestore(&wrp_lock,flags); */
-FAIL:
+	return 0;
+}
+
+/* -------------------------------------------------------- */
+/* Function : pwrap_wacs2_hal() */
+/* Description : */
+/* Parameter : */
+/* Return : */
+/* -------------------------------------------------------- */
+static s32 pwrap_wacs2_hal(u32  write, u32  adr, u32  wdata, u32 *rdata)
+{
+	u32 return_value = 0;
+	unsigned long flags = 0;
+
+	/* Check argument validation */
+	return_value = pwrap_check_arg(write, adr, wdata);
+	if (return_value != 0)
+		return return_value;
+
+	spin_lock_irqsave(&wrp_lock, flags);
+	return_value = _pwrap_wacs2_locked(write, adr, wdata, rdata);
 	spin_unlock_irqrestore(&wrp_lock, flags);
 	if (return_value != 0) {
 		PWRAPERR("pwrap_wacs2_hal fail,return_value=%d\n", return_value);
 		PWRAPERR("timeout:BUG_ON here\n");
 	/* BUG_ON(1); */
 	}
-	/* wrap_access_time=sched_clock(); */
-	/* pwrap_trace(wrap_access_time,return_value,write, adr, wdata,(u32)rdata); */
+	return return_value;
+}
+
+/* -------------------------------------------------------- */
+/* Function : pwrap_batch_hal() */
+/* Description : a list of accesses under one wrp_lock hold, */
+/*		 an update is a read and a write with nobody in between */
+/* Return : 0 or the error of the first failing op */
+/* -------------------------------------------------------- */
+static s32 pwrap_batch_hal(struct pwrap_op *ops, int nr)
+{
+	u32 return_value = 0;
+	unsigned long flags = 0;
+	struct pwrap_op *op;
+	int i;
+
+	for (i = 0; i < nr; i++) {
+		op = &ops[i];
+		if (op->type > PWRAP_OP_UPDATE)
+			return E_PWR_INVALID_ARG;
+		return_value = pwrap_check_arg(0, op->adr, op->wdata | op->mask);
+		if (return_value != 0)
+			return return_value;
+	}
+
+	spin_lock_irqsave(&wrp_lock, flags);
+	for (i = 0; i < nr && return_value == 0; i++) {
+		op = &ops[i];
+		if (op->type == PWRAP_OP_WRITE) {
+			return_value = _pwrap_wacs2_locked(1, op->adr, op->wdata, 0);
+			continue;
+		}
+		return_value = _pwrap_wacs2_locked(0, op->adr, 0, &op->rdata);
+		if (return_value == 0 && op->type == PWRAP_OP_UPDATE)
+			return_value = _pwrap_wacs2_locked(1, op->adr,
+				(op->rdata & ~op->mask) | (op->wdata & op->mask), 0);
+	}
+	spin_unlock_irqrestore(&wrp_lock, flags);
+	if (return_value != 0)
+		PWRAPERR("pwrap_batch_hal fail at op %d adr=0x%x,return_value=%d\n",
+			 i - 1, ops[i - 1].adr, return_value);
 	return return_value;
 }
 
@@ -1620,6 +1674,7 @@ static int __init pwrap_hal_init(void)
 	mt_wrp->store_hal = mt_pwrap_store_hal;
 	mt_wrp->show_hal = mt_pwrap_show_hal;
 	mt_wrp->wacs2_hal = pwrap_wacs2_hal;
+	mt_wrp->batch_hal = pwrap_batch_hal;
 
 	PWRAPLOG("mt_pwrap_init---- debug1\n");
 	pwrap_of_iomap();
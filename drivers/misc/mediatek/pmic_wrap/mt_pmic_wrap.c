@@ -66,6 +66,31 @@ s32 pwrap_write(u32 adr, u32 wdata)
 	return pwrap_wacs2(PWRAP_WRITE, adr, wdata, 0);
 }
 EXPORT_SYMBOL(pwrap_write);
+
+s32 pwrap_batch(struct pwrap_op *ops, int nr)
+{
+	s32 ret = 0;
+	int i;
+
+	if (mt_wrp.batch_hal != NULL)
+		return mt_wrp.batch_hal(ops, nr);
+
+	/* one op at a time, the update is not atomic then */
+	for (i = 0; i < nr && !ret; i++) {
+		struct pwrap_op *op = &ops[i];
+
+		if (op->type == PWRAP_OP_WRITE) {
+			ret = pwrap_write(op->adr, op->wdata);
+			continue;
+		}
+		ret = pwrap_read(op->adr, &op->rdata);
+		if (!ret && op->type == PWRAP_OP_UPDATE)
+			ret = pwrap_write(op->adr, (op->rdata & ~op->mask) |
+					  (op->wdata & op->mask));
+	}
+	return ret;
+}
+EXPORT_SYMBOL(pwrap_batch);
 /********************************************************************/
 /********************************************************************/
 /* return value : EINT_STA: [0]: CPU IRQ status in PMIC1 */
@@ -20,9 +20,12 @@
 #include <linux/of_reserved_mem.h>
 #include <linux/pstore.h>
 #include <linux/io.h>
+#include <linux/workqueue.h>
+#include <asm/unaligned.h>
 #include <mach/wd_api.h>
 #include "ram_console.h"
 #include <mt-plat/mt_debug_latch.h>
+#include <clocksource/arm_arch_timer.h>
 
 #define RAM_CONSOLE_HEADER_STR_LEN 1024
 
@@ -34,6 +37,9 @@ static int ram_console_init_done;
    This group of API call by sub-driver module to report reboot reasons
    aee_rr_* stand for previous reboot reason
  */
+#define SUSPEND_TL_RR_NUM 32
+#define SUSPEND_TL_CNT_MASK ((1ULL << 56) - 1)
+
 struct last_reboot_reason {
 	uint32_t fiq_step;
 	uint32_t exp_type;	/* 0xaeedeadX: X=1 (HWT), X=2 (KE), X=3 (nested panic) */
@@ -91,6 +97,11 @@ struct last_reboot_reason {
 	uint8_t isr_el1;
 
 	void *kparams;
+
+	/* ring of suspend_tl_event << 56 | arch counter */
+	uint64_t suspend_tl[SUSPEND_TL_RR_NUM];
+	uint32_t suspend_tl_data[SUSPEND_TL_RR_NUM];
+	uint32_t suspend_tl_idx;
 };
 
 struct reboot_reason_pl {
@@ -129,16 +140,45 @@ static struct ram_console_buffer *ram_console_buffer;
 static struct ram_console_buffer *ram_console_old;
 static struct ram_console_buffer *ram_console_buffer_pa;
 
-static DEFINE_SPINLOCK(ram_console_lock);
+/*
+ * Console writes come one at a time, under console_sem and with irqs off,
+ * so the buffer needs no lock of its own; this only tells the FIQ handler
+ * that a copy is in flight.
+ */
+static atomic_t rc_writing = ATOMIC_INIT(0);
 
 static atomic_t rc_in_fiq = ATOMIC_INIT(0);
 
 #ifdef __aarch64__
+/*
+ * The buffer is mapped uncached, where unaligned accesses fault: stores
+ * are aligned on dest, a word at a time once it is.  src is either as
+ * aligned as dest or in normal memory, the printk buffers.
+ */
 static void *_memcpy(void *dest, const void *src, size_t count)
 {
 	char *tmp = dest;
 	const char *s = src;
 
+	while (count && ((unsigned long)tmp & (sizeof(long) - 1))) {
+		*tmp++ = *s++;
+		count--;
+	}
+
+	if (!((unsigned long)s & (sizeof(long) - 1))) {
+		for (; count >= sizeof(long); count -= sizeof(long)) {
+			*(long *)tmp = *(const long *)s;
+			tmp += sizeof(long);
+			s += sizeof(long);
+		}
+	} else {
+		for (; count >= sizeof(long); count -= sizeof(long)) {
+			*(long *)tmp = get_unaligned((const long *)s);
+			tmp += sizeof(long);
+			s += sizeof(long);
+		}
+	}
+
 	while (count--)
 		*tmp++ = *s++;
 	return dest;
@@ -164,11 +204,46 @@ unsigned int ram_console_size(void)
 #include <mt-plat/sd_misc.h>
 
 #define EMMC_ADDR 0X700000
+/* how long the polled store waits for an async one to get off the card */
+#define LAST_KMSG_STORE_WAIT_MS 100
 static char *ram_console2_log;
+static char *last_kmsg_snap;
 
-void last_kmsg_store_to_emmc(void)
+/*
+ * From process context the buffer goes to expdb through the block layer,
+ * like last_kmsg2 is read back: a copy is taken, since the buffer is
+ * uncached and still being written, and the caller does not wait.
+ */
+static void last_kmsg_store_work_fn(struct work_struct *work)
+{
+	struct file *filp;
+	int buff_size = ram_console_buffer->sz_buffer;
+	ssize_t ret;
+
+	if (!last_kmsg_snap)
+		last_kmsg_snap = vmalloc(buff_size);
+	if (!last_kmsg_snap)
+		return;
+
+	/* the handle is cached by expdb_open() */
+	filp = expdb_open();
+	if (IS_ERR(filp))
+		return;
+
+	memcpy(last_kmsg_snap, ram_console_buffer, buff_size);
+	ret = kernel_write(filp, last_kmsg_snap, buff_size, EMMC_ADDR);
+	if (ret == buff_size)
+		ret = vfs_fsync(filp, 0);
+	if (ret < 0)
+		pr_err("ram_console: store kernel log to emmc failed %zd\n", ret);
+}
+
+static DECLARE_WORK(last_kmsg_store_work, last_kmsg_store_work_fn);
+
+static void last_kmsg_store_polled(void)
 {
 	int buff_size;
+	int wait = LAST_KMSG_STORE_WAIT_MS;
 	struct wd_api *wd_api = NULL;
 
 	get_wd_api(&wd_api);
@@ -182,6 +257,10 @@ void last_kmsg_store_to_emmc(void)
 #endif
 	}
 
+	/* the polled driver takes over the host, let a store in flight finish */
+	while (wait-- > 0 && (work_busy(&last_kmsg_store_work) & WORK_BUSY_RUNNING))
+		mdelay(1);
+
 	/* save log to emmc */
 	buff_size = ram_console_buffer->sz_buffer;
 	card_dump_func_write((unsigned char *)ram_console_buffer, buff_size, EMMC_ADDR,
@@ -190,6 +269,14 @@ void last_kmsg_store_to_emmc(void)
 	pr_err("ram_console: save kernel log (0x%x) to emmc!\n", buff_size);
 }
 
+void last_kmsg_store_to_emmc(void)
+{
+	if (oops_in_progress || irqs_disabled() || in_atomic())
+		last_kmsg_store_polled();
+	else
+		queue_work(system_unbound_wq, &last_kmsg_store_work);
+}
+
 static int ram_console_lastk_show(struct ram_console_buffer *buffer, struct seq_file *m, void *v);
 static int ram_console2_show(struct seq_file *m, void *v)
 {
@@ -386,7 +473,7 @@ void aee_sram_fiq_log(const char *msg)
 
 	atomic_set(&rc_in_fiq, 1);
 
-	while ((delay > 0) && (spin_is_locked(&ram_console_lock))) {
+	while ((delay > 0) && atomic_read(&rc_writing)) {
 		udelay(1);
 		delay--;
 	}
@@ -397,16 +484,16 @@ void aee_sram_fiq_log(const char *msg)
 
 void ram_console_write(struct console *console, const char *s, unsigned int count)
 {
-	unsigned long flags;
-
 	if (atomic_read(&rc_in_fiq))
 		return;
 
-	spin_lock_irqsave(&ram_console_lock, flags);
+	atomic_inc(&rc_writing);
+	smp_mb__after_atomic();
 
 	sram_log_save(s, count);
 
-	spin_unlock_irqrestore(&ram_console_lock, flags);
+	smp_mb__before_atomic();
+	atomic_dec(&rc_writing);
 }
 
 static struct console ram_console = {
@@ -1154,6 +1241,18 @@ u8 aee_rr_curr_thermal_status(void)
 	return LAST_RR_VAL(thermal_status);
 }
 
+void aee_rr_rec_suspend_tl(u8 event, u64 cnt, u32 data)
+{
+	uint32_t idx;
+
+	if (!ram_console_init_done || !ram_console_buffer)
+		return;
+	idx = LAST_RR_VAL(suspend_tl_idx) % SUSPEND_TL_RR_NUM;
+	LAST_RR_SET_WITH_ID(suspend_tl, idx, ((u64)event << 56) | (cnt & SUSPEND_TL_CNT_MASK));
+	LAST_RR_SET_WITH_ID(suspend_tl_data, idx, data);
+	LAST_RR_SET(suspend_tl_idx, idx + 1);
+}
+
 u8 aee_rr_curr_isr_el1(void)
 {
 	return LAST_RR_VAL(isr_el1);
@@ -1386,6 +1485,32 @@ void aee_rr_show_isr_el1(struct seq_file *m)
 	seq_printf(m, "isr_el1: %d\n", LAST_RRR_VAL(isr_el1));
 }
 
+/* oldest first, times in us from the previous record */
+void aee_rr_show_suspend_tl(struct seq_file *m)
+{
+	uint32_t start = LAST_RRR_VAL(suspend_tl_idx);
+	uint32_t rate = arch_timer_get_rate() ? : 1;
+	uint64_t prev = 0;
+	int i;
+
+	seq_puts(m, "suspend_tl:\n");
+	for (i = 0; i < SUSPEND_TL_RR_NUM; i++) {
+		uint32_t idx = (start + i) % SUSPEND_TL_RR_NUM;
+		uint64_t rec = LAST_RRR_VAL(suspend_tl[idx]);
+		uint64_t cnt = rec & SUSPEND_TL_CNT_MASK;
+		uint8_t event = rec >> 56;
+
+		if (!rec)
+			continue;
+		seq_printf(m, "  %-18s %-5s 0x%014llx +%llu us data 0x%x\n",
+			   suspend_tl_event_name(event),
+			   event & SUSPEND_TL_END ? "end" : "start", cnt,
+			   prev ? div_u64((cnt - prev) * USEC_PER_SEC, rate) : 0,
+			   LAST_RRR_VAL(suspend_tl_data[idx]));
+		prev = cnt;
+	}
+}
+
 __weak uint32_t get_suspend_debug_flag(void)
 {
 	return LAST_RR_VAL(suspend_debug_flag);
@@ -1463,7 +1588,8 @@ last_rr_show_t aee_rr_show[] = {
 	aee_rr_show_ptp_status,
 	aee_rr_show_thermal_temp,
 	aee_rr_show_thermal_status,
-	aee_rr_show_isr_el1
+	aee_rr_show_isr_el1,
+	aee_rr_show_suspend_tl
 };
 
 last_rr_show_cpu_t aee_rr_show_cpu[] = {
@@ -17,13 +17,27 @@
 #include <linux/percpu.h>
 #include <linux/hrtimer.h>
 #include <linux/sched.h>
+#include <linux/seqlock.h>
 #include <linux/math64.h>
 
-static DEFINE_PER_CPU(u64, nr_prod_sum);
-static DEFINE_PER_CPU(u64, last_time);
-static DEFINE_PER_CPU(u64, nr);
-static DEFINE_PER_CPU(unsigned long, iowait_prod_sum);
-static DEFINE_PER_CPU(spinlock_t, nr_lock) = __SPIN_LOCK_UNLOCKED(nr_lock);
+/*
+ * Updated from add/sub_nr_running() with the rq lock held, so there is
+ * only ever one writer per cpu.  The sums only grow: the reader keeps its
+ * own copy of where it stopped last time, and never writes here.
+ */
+struct nr_stats_s {
+	seqcount_t seq;
+	u64 last_time;
+	u64 nr;
+	u64 nr_prod_sum;
+	u64 iowait_prod_sum;
+};
+
+static DEFINE_PER_CPU(struct nr_stats_s, runqueue_stats);
+
+/* Sums up to last_get_time as seen by the previous poll, reader only */
+static DEFINE_PER_CPU(u64, nr_prod_read);
+static DEFINE_PER_CPU(u64, iowait_prod_read);
 static u64 last_get_time;
 
 /**
@@ -47,11 +61,11 @@ void sched_get_nr_running_avg(int *avg, int *iowait_avg)
 	*avg = 0;
 	*iowait_avg = 0;
 
-    preempt_disable_notrace();
-    curr_time = sched_clock();
-    preempt_enable_notrace();
+	preempt_disable_notrace();
+	curr_time = sched_clock();
+	preempt_enable_notrace();
 
-    diff = (s64) (curr_time - last_get_time);
+	diff = (s64) (curr_time - last_get_time);
 
 	if (!diff)
 		return;
@@ -60,25 +74,34 @@ void sched_get_nr_running_avg(int *avg, int *iowait_avg)
 
 	old_lgt = last_get_time;
 	last_get_time = curr_time;
-	/* read and reset nr_running counts */
+	/* read nr_running counts, projected up to curr_time */
 	for_each_possible_cpu(cpu) {
-		unsigned long flags;
+		struct nr_stats_s *stats = &per_cpu(runqueue_stats, cpu);
+		u64 last_time, nr, nr_sum, iowait_sum;
+		unsigned int seq;
+
+		do {
+			seq = read_seqcount_begin(&stats->seq);
+			last_time = stats->last_time;
+			nr = stats->nr;
+			nr_sum = stats->nr_prod_sum;
+			iowait_sum = stats->iowait_prod_sum;
+		} while (read_seqcount_retry(&stats->seq, seq));
 
-		spin_lock_irqsave(&per_cpu(nr_lock, cpu), flags);
 		/* error handling for problematic clock violation */
-		if ((s64) (curr_time - per_cpu(last_time, cpu) < 0)) {
+		if ((s64) (curr_time - last_time) < 0) {
 			clk_faulty = 1;
 			cpumask |= 1 << cpu;
+			continue;
 		}
 		/* ////// */
-		tmp_avg += per_cpu(nr_prod_sum, cpu);
-		tmp_avg += per_cpu(nr, cpu) * (curr_time - per_cpu(last_time, cpu));
-		tmp_iowait = per_cpu(iowait_prod_sum, cpu);
-		tmp_iowait += nr_iowait_cpu(cpu) * (curr_time - per_cpu(last_time, cpu));
-		per_cpu(last_time, cpu) = curr_time;
-		per_cpu(nr_prod_sum, cpu) = 0;
-		per_cpu(iowait_prod_sum, cpu) = 0;
-		spin_unlock_irqrestore(&per_cpu(nr_lock, cpu), flags);
+		nr_sum += nr * (curr_time - last_time);
+		iowait_sum += nr_iowait_cpu(cpu) * (curr_time - last_time);
+
+		tmp_avg += nr_sum - per_cpu(nr_prod_read, cpu);
+		tmp_iowait += iowait_sum - per_cpu(iowait_prod_read, cpu);
+		per_cpu(nr_prod_read, cpu) = nr_sum;
+		per_cpu(iowait_prod_read, cpu) = iowait_sum;
 	}
 
 	/* error handling for problematic clock violation */
@@ -104,6 +127,45 @@ void sched_get_nr_running_avg(int *avg, int *iowait_avg)
 }
 EXPORT_SYMBOL(sched_get_nr_running_avg);
 
+/**
+ * sched_get_nr_prod_sum
+ * @return: nr_running of all cpus integrated over time up to now, in
+ *	    task-nanoseconds.
+ *
+ * Unlike sched_get_nr_running_avg() this keeps no reader state, so any
+ * number of users may sample it and average over their own window by
+ * diffing two reads against sched_clock().
+ */
+u64 sched_get_nr_prod_sum(void)
+{
+	u64 curr_time, sum = 0;
+	int cpu;
+
+	preempt_disable_notrace();
+	curr_time = sched_clock();
+	preempt_enable_notrace();
+
+	for_each_possible_cpu(cpu) {
+		struct nr_stats_s *stats = &per_cpu(runqueue_stats, cpu);
+		u64 last_time, nr, nr_sum;
+		unsigned int seq;
+
+		do {
+			seq = read_seqcount_begin(&stats->seq);
+			last_time = stats->last_time;
+			nr = stats->nr;
+			nr_sum = stats->nr_prod_sum;
+		} while (read_seqcount_retry(&stats->seq, seq));
+
+		if ((s64) (curr_time - last_time) > 0)
+			nr_sum += nr * (curr_time - last_time);
+		sum += nr_sum;
+	}
+
+	return sum;
+}
+EXPORT_SYMBOL(sched_get_nr_prod_sum);
+
 /**
  * sched_update_nr_prod
  * @cpu: The core id of the nr running driver.
@@ -115,27 +177,24 @@ EXPORT_SYMBOL(sched_get_nr_running_avg);
  */
 void sched_update_nr_prod(int cpu, unsigned long nr_running, int inc)
 {
+	struct nr_stats_s *stats = &per_cpu(runqueue_stats, cpu);
 	s64 diff;
 	u64 curr_time;
-	unsigned long flags;
 
-	spin_lock_irqsave(&per_cpu(nr_lock, cpu), flags);
 	curr_time = sched_clock();
-	diff = (s64) (curr_time - per_cpu(last_time, cpu));
+	diff = (s64) (curr_time - stats->last_time);
 	/* skip this problematic clock violation */
-	if (diff < 0) {
-		spin_unlock_irqrestore(&per_cpu(nr_lock, cpu), flags);
+	if (diff < 0)
 		return;
-	}
 	/* ////////////////////////////////////// */
 
-	per_cpu(last_time, cpu) = curr_time;
-	per_cpu(nr, cpu) = nr_running + inc;
-
-	BUG_ON(per_cpu(nr, cpu) < 0);
+	BUG_ON((long)(nr_running + inc) < 0);
 
-	per_cpu(nr_prod_sum, cpu) += nr_running * diff;
-	per_cpu(iowait_prod_sum, cpu) += nr_iowait_cpu(cpu) * diff;
-	spin_unlock_irqrestore(&per_cpu(nr_lock, cpu), flags);
+	write_seqcount_begin(&stats->seq);
+	stats->last_time = curr_time;
+	stats->nr = nr_running + inc;
+	stats->nr_prod_sum += nr_running * diff;
+	stats->iowait_prod_sum += nr_iowait_cpu(cpu) * diff;
+	write_seqcount_end(&stats->seq);
 }
 EXPORT_SYMBOL(sched_update_nr_prod);
@@ -348,6 +348,47 @@ static int SCP_sensorHub_get_semaphore(void)
 	return err;
 }
 
+/*----------------------------------------------------------------------------*/
+/*
+ * The SCP writes the DRAM FIFO and the AP only its rp.  Instead of syncing
+ * the whole FIFO for every sample, only the header and the bytes that are
+ * read are synced, with the semaphore held so the SCP does not write them
+ * meanwhile.
+ */
+#define SCP_sensorFIFO_HDR_LEN	offsetof(struct sensorFIFO, data)
+
+static void SCP_sensorFIFO_sync_hdr_for_cpu(struct SCP_sensorHub_data *obj)
+{
+	dma_sync_single_range_for_cpu(&SCP_sensorHub_dev, obj->mapping, 0,
+				      SCP_sensorFIFO_HDR_LEN, DMA_FROM_DEVICE);
+}
+
+static void SCP_sensorFIFO_sync_hdr_for_device(struct SCP_sensorHub_data *obj)
+{
+	dma_sync_single_range_for_device(&SCP_sensorHub_dev, obj->mapping, 0,
+					 SCP_sensorFIFO_HDR_LEN, DMA_TO_DEVICE);
+}
+
+/* FIFO data from offset @from up to @to, which may have wrapped */
+static void SCP_sensorFIFO_sync_data_for_cpu(struct SCP_sensorHub_data *obj, int from, int to)
+{
+	int size = obj->SCP_sensorFIFO->FIFOSize;
+
+	if (from < to) {
+		dma_sync_single_range_for_cpu(&SCP_sensorHub_dev, obj->mapping,
+					      SCP_sensorFIFO_HDR_LEN + from, to - from,
+					      DMA_FROM_DEVICE);
+	} else if (from > to) {
+		dma_sync_single_range_for_cpu(&SCP_sensorHub_dev, obj->mapping,
+					      SCP_sensorFIFO_HDR_LEN + from, size - from,
+					      DMA_FROM_DEVICE);
+		if (to)
+			dma_sync_single_range_for_cpu(&SCP_sensorHub_dev, obj->mapping,
+						      SCP_sensorFIFO_HDR_LEN, to,
+						      DMA_FROM_DEVICE);
+	}
+}
+
 /*----------------------------------------------------------------------------*/
 static int SCP_sensorHub_init_client(void)	/* call by init done workqueue */
 {
@@ -361,11 +402,12 @@ static int SCP_sensorHub_init_client(void)	/* call by init done workqueue */
 	/* enable_clock(MT_CG_INFRA_APDMA, "sensorHub"); */
 	/* SCP_ERR("obj=%lld\n", obj); */
 
+	/* the header and the data, FIFOSize is the data only */
 	obj->mapping =
 	    dma_map_single(&SCP_sensorHub_dev, (void *)obj->SCP_sensorFIFO,
-		obj->SCP_sensorFIFO->FIFOSize, DMA_BIDIRECTIONAL);
+		SCP_SENSOR_HUB_FIFO_SIZE, DMA_BIDIRECTIONAL);
 	SCP_ERR("obj->mapping = %p\n", (void *)obj->mapping);
-	dma_sync_single_for_device(&SCP_sensorHub_dev, obj->mapping, obj->SCP_sensorFIFO->FIFOSize,
+	dma_sync_single_for_device(&SCP_sensorHub_dev, obj->mapping, SCP_SENSOR_HUB_FIFO_SIZE,
 				   DMA_TO_DEVICE);
 
 	data.set_config_req.sensorType = 0;
@@ -417,8 +459,7 @@ static int SCP_sensorHub_ReadSensorData(int handle, hwm_sensor_data *sensorData)
 		return -2;
 	}
 
-	dma_sync_single_for_cpu(&SCP_sensorHub_dev, obj->mapping, obj->SCP_sensorFIFO->FIFOSize,
-				DMA_FROM_DEVICE);
+	SCP_sensorFIFO_sync_hdr_for_cpu(obj);
 	pStart = (char *)obj->SCP_sensorFIFO + offsetof(struct sensorFIFO, data);
 	pEnd = (char *)pStart + obj->SCP_sensorFIFO->FIFOSize;
 	rp = pStart + (int)obj->SCP_sensorFIFO->rp;
@@ -453,6 +494,12 @@ static int SCP_sensorHub_ReadSensorData(int handle, hwm_sensor_data *sensorData)
 		}
 		return -6;
 	}
+		/* one record at most, past wp is never written back */
+		offset = (int)(rp - pStart);
+		SCP_sensorFIFO_sync_data_for_cpu(obj, offset,
+			(offset + (int)sizeof(struct SCP_sensorData)) %
+			(int)obj->SCP_sensorFIFO->FIFOSize);
+
 		pNext =
 		    rp + offsetof(struct SCP_sensorData,
 				  data) + ((struct SCP_sensorData *)rp)->dataLength;
@@ -479,8 +526,7 @@ static int SCP_sensorHub_ReadSensorData(int handle, hwm_sensor_data *sensorData)
 		}
 
 		obj->SCP_sensorFIFO->rp = (int)(rp - pStart);
-		dma_sync_single_for_device(&SCP_sensorHub_dev, obj->mapping,
-				obj->SCP_sensorFIFO->FIFOSize, DMA_TO_DEVICE);
+		SCP_sensorFIFO_sync_hdr_for_device(obj);
 		err = release_scp_semaphore(SEMAPHORE_SENSOR);
 		if (err < 0)	/* allow scp to access dram */
 			SCP_ERR("release_scp_semaphore fail : %d\n", err);
@@ -1042,8 +1088,15 @@ static int SCP_sensorHub_get_fifo_status(int *dataLen, int *status, char *reserv
 			SCP_ERR("SCP_sensorHub_get_semaphore fail : %d\n", err);
 			return -2;
 		}
-		dma_sync_single_for_cpu(&SCP_sensorHub_dev, obj->mapping,
-					obj->SCP_sensorFIFO->FIFOSize, DMA_FROM_DEVICE);
+		SCP_sensorFIFO_sync_hdr_for_cpu(obj);
+		pStart = (char *)obj->SCP_sensorFIFO + offsetof(struct sensorFIFO, data);
+		pEnd = (char *)pStart + obj->SCP_sensorFIFO->FIFOSize;
+		rp = pStart + (int)obj->SCP_sensorFIFO->rp;
+		wp = pStart + (int)obj->SCP_sensorFIFO->wp;
+		/* only what the SCP wrote since the last read */
+		if (pStart <= rp && rp < pEnd && pStart <= wp && wp <= pEnd)
+			SCP_sensorFIFO_sync_data_for_cpu(obj, (int)(rp - pStart),
+				(int)(wp - pStart) % (int)obj->SCP_sensorFIFO->FIFOSize);
 		/* No data need to sync. back to device, release semaphore immediately. */
 		err = release_scp_semaphore(SEMAPHORE_SENSOR);
 		if (err < 0) {
@@ -1051,11 +1104,6 @@ static int SCP_sensorHub_get_fifo_status(int *dataLen, int *status, char *reserv
 			return -3;
 		}
 
-		pStart = (char *)obj->SCP_sensorFIFO + offsetof(struct sensorFIFO, data);
-		pEnd = (char *)pStart + obj->SCP_sensorFIFO->FIFOSize;
-		rp = pStart + (int)obj->SCP_sensorFIFO->rp;
-		wp = pStart + (int)obj->SCP_sensorFIFO->wp;
-
 		if (SCP_TRC_BATCH & atomic_read(&(obj_data->trace))) {
 			SCP_ERR("FIFO pStart = %p, rp = %p, wp = %p, pEnd = %p\n", pStart, rp, wp,
 				pEnd);
@@ -10,6 +10,10 @@
 #include <linux/mm.h>
 #include <linux/vmalloc.h>
 #include <linux/slab.h>
+#include <linux/workqueue.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <linux/sched.h>
 #include <aee.h>
 
 /* Define SMI_INTERNAL_CCF_SUPPORT when CCF needs to be enabled */
@@ -32,6 +36,7 @@
 #endif				/* defined(SMI_INTERNAL_CCF_SUPPORT) */
 
 #include <asm/io.h>
+#include <asm/div64.h>
 
 #include <linux/ioctl.h>
 #include <linux/fs.h>
@@ -744,6 +749,80 @@ static void restore_larb_smi(int index)
 
 }
 
+/*
+ * Per larb bandwidth counters.
+ * The larb monitor is armed whenever a larb powers on and its byte count is
+ * folded into the totals before the larb powers off, so the numbers survive
+ * MTCMOS cycles. A deferrable work samples the powered larbs once per
+ * SMI_BW_SAMPLE_MS to turn the counts into MB/s.
+ */
+#define SMI_BW_SAMPLE_MS 1000
+
+struct smi_larb_bw {
+	unsigned long long total_bytes;
+	unsigned long long window_bytes;
+	unsigned int cur_mbps;
+	unsigned int peak_mbps;
+};
+
+static DEFINE_SPINLOCK(smi_bw_lock);
+static struct smi_larb_bw g_smi_larb_bw[SMI_LARB_NR];
+static unsigned int smi_bw_larb_on;	/* larbs with an armed monitor */
+static unsigned long long smi_bw_window_ns;
+
+static void smi_bw_sample_work_func(struct work_struct *work);
+static DECLARE_DEFERRABLE_WORK(smi_bw_sample_work, smi_bw_sample_work_func);
+
+/* caller holds smi_bw_lock, the larb clock must be on */
+static void smi_bw_larb_collect(int larb)
+{
+	unsigned long larb_base = gLarbBaseAddr[larb];
+	unsigned int bytes;
+
+	bytes = M4U_ReadReg32(larb_base, SMI_LARB_MON_BYTE_CNT);
+	M4U_WriteReg32(larb_base, SMI_LARB_MON_CLR, 1);
+	M4U_WriteReg32(larb_base, SMI_LARB_MON_CLR, 0);
+
+	g_smi_larb_bw[larb].total_bytes += bytes;
+	g_smi_larb_bw[larb].window_bytes += bytes;
+}
+
+/* called with the larb clock on, right after power on */
+static void smi_bw_larb_start(int larb)
+{
+	unsigned long larb_base = gLarbBaseAddr[larb];
+	unsigned long flags;
+
+	if (larb >= SMI_LARB_NR || !larb_base)
+		return;
+
+	spin_lock_irqsave(&smi_bw_lock, flags);
+	M4U_WriteReg32(larb_base, SMI_LARB_MON_CLR, 1);
+	M4U_WriteReg32(larb_base, SMI_LARB_MON_CLR, 0);
+	M4U_WriteReg32(larb_base, SMI_LARB_MON_CON, 0);
+	M4U_WriteReg32(larb_base, SMI_LARB_MON_EN, 1);
+	smi_bw_larb_on |= (1 << larb);
+	spin_unlock_irqrestore(&smi_bw_lock, flags);
+}
+
+/* called with the larb clock on, right before power off */
+static void smi_bw_larb_stop(int larb)
+{
+	unsigned long larb_base = gLarbBaseAddr[larb];
+	unsigned long flags;
+
+	if (larb >= SMI_LARB_NR || !larb_base)
+		return;
+
+	spin_lock_irqsave(&smi_bw_lock, flags);
+	if (smi_bw_larb_on & (1 << larb)) {
+		smi_bw_larb_collect(larb);
+		M4U_WriteReg32(larb_base, SMI_LARB_MON_EN, 0);
+		smi_bw_larb_on &= ~(1 << larb);
+	}
+	spin_unlock_irqrestore(&smi_bw_lock, flags);
+}
+
 static int larb_reg_backup(int larb)
 {
 	unsigned int *pReg = pLarbRegBackUp[larb];
@@ -752,6 +831,7 @@ static int larb_reg_backup(int larb)
 	*(pReg++) = M4U_ReadReg32(larb_base, SMI_LARB_CON);
 
 	backup_larb_smi(larb);
+	smi_bw_larb_stop(larb);
 
 	if (0 == larb)
 		g_bInited = 0;
@@ -823,6 +903,7 @@ int larb_reg_restore(int larb)
 	M4U_WriteReg32(larb_base, SMI_LARB_CON_SET, (regval));
 
 	smi_larb_init(larb);
+	smi_bw_larb_start(larb);
 
 	return 0;
 }
@@ -990,6 +1071,11 @@ struct pg_callbacks smi_clk_subsys_handle = {
 };
 #endif
 
+/* scenario references held by kernel drivers */
+static unsigned int g_smi_kernel_cnt[SMI_BWC_SCEN_CNT];
+/* display guard throttle level, protected by SMI_lock */
+static unsigned int smi_disp_guard_level;
+
 static int smi_bwc_config(MTK_SMI_BWC_CONFIG *p_conf, unsigned int *pu4LocalCnt)
 {
 	int i;
@@ -1009,12 +1095,15 @@ static int smi_bwc_config(MTK_SMI_BWC_CONFIG *p_conf, unsigned int *pu4LocalCnt)
 		return -1;
 	}
 #if defined(SMI_D1) || defined(SMI_D2) || defined(SMI_D3)
-	if (p_conf->b_on_off) {
-		/* set mmdvfs step according to certain scenarios */
-		mmdvfs_notify_scenario_enter(p_conf->scenario);
-	} else {
-		/* set mmdvfs step to default after the scenario exits */
-		mmdvfs_notify_scenario_exit(p_conf->scenario);
+	/* kernel clients drive their own mmdvfs steps */
+	if (pu4LocalCnt != g_smi_kernel_cnt) {
+		if (p_conf->b_on_off) {
+			/* set mmdvfs step according to certain scenarios */
+			mmdvfs_notify_scenario_enter(p_conf->scenario);
+		} else {
+			/* set mmdvfs step to default after the scenario exits */
+			mmdvfs_notify_scenario_exit(p_conf->scenario);
+		}
 	}
 #endif
 
@@ -1110,6 +1199,8 @@ static int smi_bwc_config(MTK_SMI_BWC_CONFIG *p_conf, unsigned int *pu4LocalCnt)
 
 	smi_bus_regs_setting(smi_profile,
 			smi_profile_config[smi_profile].setting);
+	/* a new profile starts unthrottled, the guard re-arms on underflow */
+	smi_disp_guard_level = 0;
 
 	/* Bandwidth Limiter */
 	switch (eFinalScen) {
@@ -1197,6 +1288,222 @@ static int smi_bwc_config(MTK_SMI_BWC_CONFIG *p_conf, unsigned int *pu4LocalCnt)
 	return 0;
 }
 
+/*
+ * Kernel side scenario switching.
+ * Drivers that own a multimedia path (display, camera, codec) call these
+ * when their path starts or stops so the profile follows the real HW load
+ * instead of waiting for userspace. References are counted separately from
+ * the ioctl ones. Process context only.
+ */
+int smi_kernel_scenario_enter(MTK_SMI_BWC_SCEN scen)
+{
+	MTK_SMI_BWC_CONFIG cfg;
+
+	cfg.scenario = scen;
+	cfg.b_on_off = 1;
+	return smi_bwc_config(&cfg, g_smi_kernel_cnt);
+}
+EXPORT_SYMBOL(smi_kernel_scenario_enter);
+
+int smi_kernel_scenario_exit(MTK_SMI_BWC_SCEN scen)
+{
+	MTK_SMI_BWC_CONFIG cfg;
+
+	cfg.scenario = scen;
+	cfg.b_on_off = 0;
+	return smi_bwc_config(&cfg, g_smi_kernel_cnt);
+}
+EXPORT_SYMBOL(smi_kernel_scenario_exit);
+
+/*
+ * Display underflow guard.
+ * The display larb has no bandwidth limiter of its own, it only loses when
+ * the other larbs are allowed too much of the common arbiter. On a display
+ * underflow the limits of the other larbs in the active profile are halved,
+ * once per SMI_DISP_GUARD_STEP_MS while underflows keep coming, and
+ * restored one step at a time after SMI_DISP_GUARD_HOLD_MS without one.
+ */
+#define SMI_DISP_LARB 0
+#define SMI_DISP_GUARD_MAX_LEVEL 3
+#define SMI_DISP_GUARD_STEP_MS 100
+#define SMI_DISP_GUARD_HOLD_MS 2000
+#define SMI_L1ARB_LIMIT_MASK 0xfff
+#define SMI_L1ARB_LIMIT_MIN 0x40
+
+static atomic_t smi_disp_underflow_cnt = ATOMIC_INIT(0);
+static unsigned int smi_disp_guard_quiet_ms;
+
+static void smi_disp_guard_work_func(struct work_struct *work);
+static DECLARE_DELAYED_WORK(smi_disp_guard_work, smi_disp_guard_work_func);
+
+/* caller holds SMI_lock with the display larb clock on */
+static void smi_disp_guard_apply(unsigned int level)
+{
+	struct SMI_SETTING *settings = smi_profile_config[smi_profile].setting;
+	struct SMI_SETTING_VALUE *l1arb;
+	unsigned int limit, value;
+	int i;
+
+	/* the first SMI_LARB_NR common entries are the larb L1ARB limits */
+	if (!settings || settings->smi_common_reg_num < SMI_LARB_NR)
+		return;
+
+	l1arb = settings->smi_common_setting_vals;
+	for (i = 0; i < SMI_LARB_NR; i++) {
+		if (i == SMI_DISP_LARB)
+			continue;
+
+		value = l1arb[i].value;
+		limit = value & SMI_L1ARB_LIMIT_MASK;
+		if (limit > SMI_L1ARB_LIMIT_MIN) {
+			limit = max_t(unsigned int, limit >> level, SMI_L1ARB_LIMIT_MIN);
+			value = (value & ~SMI_L1ARB_LIMIT_MASK) | limit;
+		}
+		M4U_WriteReg32(SMI_COMMON_EXT_BASE, l1arb[i].offset, value);
+	}
+}
+
+static void smi_disp_guard_work_func(struct work_struct *work)
+{
+	unsigned int underflow = atomic_xchg(&smi_disp_underflow_cnt, 0);
+	unsigned int level;
+
+	if (smi_tuning_mode == 1)
+		return;
+
+#if defined(SMI_INTERNAL_CCF_SUPPORT)
+	larb_clock_prepare(SMI_DISP_LARB, 1);
+#endif
+	spin_lock(&g_SMIInfo.SMI_lock);
+
+	level = smi_disp_guard_level;
+	if (underflow) {
+		smi_disp_guard_quiet_ms = 0;
+		if (level < SMI_DISP_GUARD_MAX_LEVEL)
+			level++;
+	} else {
+		smi_disp_guard_quiet_ms += SMI_DISP_GUARD_STEP_MS;
+		if (smi_disp_guard_quiet_ms >= SMI_DISP_GUARD_HOLD_MS && level > 0) {
+			smi_disp_guard_quiet_ms = 0;
+			level--;
+		}
+	}
+
+	if (level != smi_disp_guard_level) {
+		larb_clock_enable(SMI_DISP_LARB, 1);
+		smi_disp_guard_apply(level);
+		larb_clock_disable(SMI_DISP_LARB, 1);
+		SMIMSG("disp guard level %u -> %u, profile %u, underflow %u\n",
+		       smi_disp_guard_level, level, smi_profile, underflow);
+		smi_disp_guard_level = level;
+	}
+
+	spin_unlock(&g_SMIInfo.SMI_lock);
+#if defined(SMI_INTERNAL_CCF_SUPPORT)
+	larb_clock_unprepare(SMI_DISP_LARB, 1);
+#endif
+
+	if (level)
+		schedule_delayed_work(&smi_disp_guard_work,
+				      msecs_to_jiffies(SMI_DISP_GUARD_STEP_MS));
+}
+
+/* called by the display path on RDMA/OVL underflow, safe in IRQ context */
+void smi_disp_underflow_notify(void)
+{
+	atomic_inc(&smi_disp_underflow_cnt);
+	/* no-op when already queued, the work picks the count up */
+	schedule_delayed_work(&smi_disp_guard_work, 0);
+}
+EXPORT_SYMBOL(smi_disp_underflow_notify);
+
+static void smi_bw_sample_work_func(struct work_struct *work)
+{
+	unsigned long long now_ns = sched_clock();
+	unsigned long long period_us, mbps;
+	unsigned int larb_on;
+	unsigned long flags;
+	int i;
+
+	spin_lock_irqsave(&smi_bw_lock, flags);
+	larb_on = smi_bw_larb_on;
+	spin_unlock_irqrestore(&smi_bw_lock, flags);
+
+	/* keep the powered larbs on while their monitors are read */
+	for (i = 0; i < SMI_LARB_NR; i++) {
+		if (!(larb_on & (1 << i)))
+			continue;
+#if defined(SMI_INTERNAL_CCF_SUPPORT)
+		larb_clock_prepare(i, 1);
+#endif
+		larb_clock_enable(i, 1);
+	}
+
+	spin_lock_irqsave(&smi_bw_lock, flags);
+	period_us = now_ns - smi_bw_window_ns;
+	do_div(period_us, 1000);
+	for (i = 0; i < SMI_LARB_NR; i++) {
+		if (smi_bw_larb_on & larb_on & (1 << i))
+			smi_bw_larb_collect(i);
+
+		/* bytes per us is MB/s */
+		mbps = g_smi_larb_bw[i].window_bytes;
+		if (period_us)
+			do_div(mbps, period_us);
+		else
+			mbps = 0;
+		g_smi_larb_bw[i].cur_mbps = (unsigned int)mbps;
+		if (g_smi_larb_bw[i].cur_mbps > g_smi_larb_bw[i].peak_mbps)
+			g_smi_larb_bw[i].peak_mbps = g_smi_larb_bw[i].cur_mbps;
+		g_smi_larb_bw[i].window_bytes = 0;
+	}
+	smi_bw_window_ns = now_ns;
+	spin_unlock_irqrestore(&smi_bw_lock, flags);
+
+	for (i = 0; i < SMI_LARB_NR; i++) {
+		if (!(larb_on & (1 << i)))
+			continue;
+		larb_clock_disable(i, 1);
+#if defined(SMI_INTERNAL_CCF_SUPPORT)
+		larb_clock_unprepare(i, 1);
+#endif
+	}
+
+	schedule_delayed_work(&smi_bw_sample_work, msecs_to_jiffies(SMI_BW_SAMPLE_MS));
+}
+
+static int smi_bw_proc_show(struct seq_file *m, void *v)
+{
+	struct smi_larb_bw bw[SMI_LARB_NR];
+	unsigned long flags;
+	int i;
+
+	spin_lock_irqsave(&smi_bw_lock, flags);
+	memcpy(bw, g_smi_larb_bw, sizeof(bw));
+	spin_unlock_irqrestore(&smi_bw_lock, flags);
+
+	seq_printf(m, "profile %u, disp guard level %u\n", smi_profile, smi_disp_guard_level);
+	seq_puts(m, "larb  cur(MB/s)  peak(MB/s)  total(bytes)\n");
+	for (i = 0; i < SMI_LARB_NR; i++)
+		seq_printf(m, "%4d  %9u  %10u  %llu\n", i, bw[i].cur_mbps, bw[i].peak_mbps,
+			   bw[i].total_bytes);
+
+	return 0;
+}
+
+static int smi_bw_proc_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, smi_bw_proc_show, NULL);
+}
+
+static const struct file_operations smi_bw_proc_fops = {
+	.owner = THIS_MODULE,
+	.open = smi_bw_proc_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 #if !defined(SMI_INTERNAL_CCF_SUPPORT)
 struct larb_monitor larb_monitor_handler = {
 	.level = LARB_MONITOR_LEVEL_HIGH,
@@ -1254,11 +1561,19 @@ int smi_common_init(void)
 	register_larb_monitor(&larb_monitor_handler);
 #endif				/* defined(SMI_INTERNAL_CCF_SUPPORT) */
 
+	/* larbs were powered before the callbacks were registered */
+	for (i = 0; i < SMI_LARB_NR; i++)
+		smi_bw_larb_start(i);
+	smi_bw_window_ns = sched_clock();
+
 	for (i = 0; i < SMI_LARB_NR; i++) {
 		larb_clock_disable(i, 1);
 		larb_clock_unprepare(i, 1);
 	}
 
+	proc_create("driver/smi_bw", 0444, NULL, &smi_bw_proc_fops);
+	schedule_delayed_work(&smi_bw_sample_work, msecs_to_jiffies(SMI_BW_SAMPLE_MS));
+
 	return 0;
 }
 
@@ -1704,6 +2019,9 @@ static int __init smi_init(void)
 
 static void __exit smi_exit(void)
 {
+	cancel_delayed_work_sync(&smi_bw_sample_work);
+	cancel_delayed_work_sync(&smi_disp_guard_work);
+	remove_proc_entry("driver/smi_bw", NULL);
 	platform_driver_unregister(&smiDrv);
 
 }
@@ -13,6 +13,9 @@
 
 static struct ssusb_gpd_range Rx_gpd_List[15];
 static struct ssusb_gpd_range Tx_gpd_List[15];
+/* GPDs handed to the QMU and not completed yet */
+static u32 Rx_gpd_count[15];
+static u32 Tx_gpd_count[15];
 
 
 /**
@@ -125,10 +128,12 @@ static void reset_gpd_list(USB_DIR dir, int num)
 		Rx_gpd_List[num].enqueue = Rx_gpd_List[num].start;
 		Rx_gpd_List[num].dequeue = Rx_gpd_List[num].enqueue;
 		Rx_gpd_List[num].next = Rx_gpd_List[num].enqueue + 1;
+		Rx_gpd_count[num] = 0;
 	} else {
 		Tx_gpd_List[num].enqueue = Tx_gpd_List[num].start;
 		Tx_gpd_List[num].dequeue = Tx_gpd_List[num].enqueue;
 		Tx_gpd_List[num].next = Tx_gpd_List[num].enqueue + 1;
+		Tx_gpd_count[num] = 0;
 	}
 
 }
@@ -314,8 +319,11 @@ static struct ssusb_gpd *mu3d_hal_prepare_tx_gpd(struct ssusb_gpd *gpd, dma_addr
 	/*Default: bps=false */
 	TGPD_CLR_FORMAT_BPS(gpd);
 
-	/*Default: ioc=true */
-	TGPD_SET_FORMAT_IOC(gpd);
+	/* without IOC the completion is reported with a later GPD */
+	if (ioc)
+		TGPD_SET_FORMAT_IOC(gpd);
+	else
+		TGPD_CLR_FORMAT_IOC(gpd);
 
 	/*Get the next GPD */
 	Tx_gpd_List[ep_num].enqueue = get_next_gpd(USB_TX, ep_num);
@@ -334,6 +342,7 @@ static struct ssusb_gpd *mu3d_hal_prepare_tx_gpd(struct ssusb_gpd *gpd, dma_addr
 	/*Default: isHWO=true */
 	TGPD_SET_CHKSUM(gpd, CHECKSUM_LENGTH);	/*Set GPD Checksum */
 	TGPD_SET_FLAGS_HWO(gpd);	/*Set HWO flag */
+	Tx_gpd_count[ep_num]++;
 
 	return gpd;
 }
@@ -390,10 +399,24 @@ static struct ssusb_gpd *mu3d_hal_prepare_rx_gpd(struct ssusb_gpd *gpd, dma_addr
 	/*Default: isHWO=true */
 	TGPD_SET_CHKSUM(gpd, CHECKSUM_LENGTH);	/*Set GPD Checksum */
 	TGPD_SET_FLAGS_HWO(gpd);	/*Set HWO flag */
+	Rx_gpd_count[ep_num]++;
 
 	return gpd;
 }
 
+/**
+ * mu3d_hal_gpd_free - number of GPDs that can still be inserted
+ * @args - arg1: ep number, arg2: dir
+ *
+ * The ring always keeps an empty GPD as its tail.
+ */
+u32 mu3d_hal_gpd_free(int ep_num, USB_DIR dir)
+{
+	u32 count = (dir == USB_TX) ? Tx_gpd_count[ep_num] : Rx_gpd_count[ep_num];
+
+	return MAX_GPD_NUM - 1 - count;
+}
+
 /**
  * mu3d_hal_insert_transfer_gpd - insert new gpd/bd
  * @args - arg1: ep number, arg2: dir, arg3: data buffer, arg4: data length,  arg5: write hwo bit or not,  arg6: write ioc bit or not
@@ -604,7 +627,7 @@ void mu3d_hal_flush_qmu(struct musb *musb, int q_num, USB_DIR dir)
  * tasklet process both of them)-->qmu_interrupt for second one.
  * To avoid upper case, put qmu_done_tx in ISR directly to process it.
 */
-void qmu_done_tx(struct musb *musb, u8 ep_num, unsigned long flags)
+static void __qmu_done_tx(struct musb *musb, u8 ep_num, unsigned long flags)
 {
 	struct ssusb_gpd *gpd = Tx_gpd_List[ep_num].dequeue;
 	struct ssusb_gpd *gpd_current = NULL;
@@ -658,8 +681,11 @@ void qmu_done_tx(struct musb *musb, u8 ep_num, unsigned long flags)
 		gpd = mu3d_get_gpd_from_dma(USB_TX, ep_num, gpd_dma);
 
 		Tx_gpd_List[ep_num].dequeue = gpd;
+		Tx_gpd_count[ep_num]--;
 		musb_g_giveback(musb_ep, request, 0);
 		req = next_request(musb_ep);
+		if (!req)
+			break;
 		request = &req->request;
 	}
 
@@ -711,7 +737,7 @@ void qmu_done_tx(struct musb *musb, u8 ep_num, unsigned long flags)
     caller:qmu_interrupt after getting QMU done interrupt and TX is raised
 
 */
-void qmu_done_rx(struct musb *musb, u8 ep_num, unsigned long flags)
+static void __qmu_done_rx(struct musb *musb, u8 ep_num, unsigned long flags)
 {
 	struct ssusb_gpd *gpd = Rx_gpd_List[ep_num].dequeue;
 	struct ssusb_gpd *gpd_current = NULL;
@@ -784,8 +810,11 @@ void qmu_done_rx(struct musb *musb, u8 ep_num, unsigned long flags)
 		}
 
 		Rx_gpd_List[ep_num].dequeue = gpd;
+		Rx_gpd_count[ep_num]--;
 		musb_g_giveback(musb_ep, request, 0);
 		req = next_request(musb_ep);
+		if (!req)
+			break;
 		request = &req->request;
 	}
 
@@ -803,6 +832,62 @@ void qmu_done_rx(struct musb *musb, u8 ep_num, unsigned long flags)
 		ep_num, Rx_gpd_List[ep_num].dequeue, Rx_gpd_List[ep_num].enqueue);
 }
 
+/*
+ * Requests queued by the completion callbacks are only put on the ring
+ * once all the done GPDs are given back, and the queue is resumed once.
+ */
+void qmu_done_rx(struct musb *musb, u8 ep_num, unsigned long flags)
+{
+	struct musb_ep *musb_ep = &musb->endpoints[ep_num].ep_out;
+
+	musb_ep->qmu_in_done = 1;
+	__qmu_done_rx(musb, ep_num, flags);
+	musb_ep->qmu_in_done = 0;
+	musb_qmu_refill(musb, musb_ep);
+}
+
+void qmu_done_tx(struct musb *musb, u8 ep_num, unsigned long flags)
+{
+	struct musb_ep *musb_ep = &musb->endpoints[ep_num].ep_in;
+	u32 count = Tx_gpd_count[ep_num];
+
+	musb_ep->qmu_in_done = 1;
+	__qmu_done_tx(musb, ep_num, flags);
+	musb_ep->qmu_in_done = 0;
+
+	if (!Tx_gpd_count[ep_num])
+		musb_ep->qmu_no_ioc = 0;
+	else if (Tx_gpd_count[ep_num] < count && musb_ep->qmu_no_ioc)
+		/* still moving, poll again; a stalled queue waits for the empty irq */
+		musb_qmu_ioc_arm(musb);
+
+	musb_qmu_refill(musb, musb_ep);
+}
+
+/*
+ * TX GPDs without IOC are only reported by a later GPD with it, so a
+ * queue that keeps going without reaching one is polled from here.
+ */
+enum hrtimer_restart qmu_ioc_timeout(struct hrtimer *timer)
+{
+	struct musb *musb = container_of(timer, struct musb, qmu_ioc_timer);
+	u32 done = 0;
+	u32 i;
+
+	spin_lock(&musb->lock);
+	for (i = 1; i <= MAX_QMU_EP; i++) {
+		if (musb->endpoints[i].ep_in.qmu_no_ioc)
+			done |= QMU_TX_DONE(i);
+	}
+	if (done) {
+		musb->qmu_done_intr |= done;
+		tasklet_schedule(&musb->qmu_done);
+	}
+	spin_unlock(&musb->lock);
+
+	return HRTIMER_NORESTART;
+}
+
 void qmu_done_tasklet(unsigned long data)
 {
 	unsigned int qmu_val;
@@ -887,6 +972,15 @@ void qmu_exception_interrupt(struct musb *musb, u32 wQmuVal)
 		qmu_dbg(K_DEBUG, "%s Empty in QMU mode![0x%x]\r\n",
 			(wQmuVal & TXQ_EMPTY_INT) ? "TX" : "RX", wEmptyVal);
 		mu3d_writel(mbase, U3D_QEMIR, wEmptyVal);
+
+		/* the last GPDs of a drained TX queue may have had no IOC */
+		for (i = 1; i <= MAX_QMU_EP; i++) {
+			if ((wEmptyVal & QMU_TX_EMPTY(i)) &&
+			    musb->endpoints[i].ep_in.qmu_no_ioc) {
+				musb->qmu_done_intr |= QMU_TX_DONE(i);
+				tasklet_schedule(&musb->qmu_done);
+			}
+		}
 	}
 }
 
@@ -135,6 +135,7 @@ struct ssusb_gpd *mu3d_hal_prepare_rx_gpd(struct ssusb_gpd *gpd, dma_addr_t pBuf
 #endif
 void mu3d_hal_insert_transfer_gpd(int ep_num, USB_DIR dir, dma_addr_t buf,
 				  u32 count, u8 isHWO, u8 ioc, u8 bps, u8 zlp, u32 cMaxPacketSize);
+u32 mu3d_hal_gpd_free(int ep_num, USB_DIR dir);
 void mu3d_hal_alloc_qmu_mem(struct musb *musb);
 void mu3d_hal_free_qmu_mem(struct musb *musb);
 
@@ -148,6 +149,7 @@ void mu3d_hal_send_stall(struct musb *musb, int q_num, USB_DIR dir);
 /* void gpd_ptr_align(USB_DIR dir, u32 num, struct ssusb_gpd *ptr); */
 
 void qmu_done_tasklet(unsigned long data);
+enum hrtimer_restart qmu_ioc_timeout(struct hrtimer *timer);
 void qmu_exception_interrupt(struct musb *musb, u32 wQmuVal);
 
 #endif
@@ -1153,6 +1153,7 @@ static void musb_free(struct musb *musb)
 	cancel_work_sync(&musb->suspend_work);
 
 #ifdef USE_SSUSB_QMU
+	hrtimer_cancel(&musb->qmu_ioc_timer);
 	tasklet_kill(&musb->qmu_done);
 	mu3d_hal_free_qmu_mem(musb);
 #endif
@@ -1250,6 +1251,8 @@ static int musb_init_controller(struct musb *musb, struct device *dev, int irq)
 
 #ifdef USE_SSUSB_QMU
 	tasklet_init(&musb->qmu_done, qmu_done_tasklet, (unsigned long)musb);
+	hrtimer_init(&musb->qmu_ioc_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	musb->qmu_ioc_timer.function = qmu_ioc_timeout;
 #endif
 
 	/* attach to the IRQ */
@@ -34,6 +34,7 @@
 #include <linux/interrupt.h>
 #include <linux/errno.h>
 #include <linux/timer.h>
+#include <linux/hrtimer.h>
 #include <linux/clk.h>
 #include <linux/device.h>
 #include <linux/usb/ch9.h>
@@ -728,6 +729,7 @@ struct musb {
 #ifdef USE_SSUSB_QMU
 	struct tasklet_struct qmu_done;
 	u32 qmu_done_intr;
+	struct hrtimer qmu_ioc_timer;
 #endif
 };
 
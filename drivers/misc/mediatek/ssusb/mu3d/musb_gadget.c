@@ -154,6 +154,100 @@ void musb_g_giveback(struct musb_ep *ep,
 
 /* ----------------------------------------------------------------------- */
 
+#ifdef USE_SSUSB_QMU
+/*
+ * At SuperSpeed only every qmu_ioc_batch-th TX GPD interrupts, the others
+ * are given back with it.  A queue that drains raises its empty interrupt
+ * for the last ones, one that keeps going is polled every qmu_ioc_us.
+ * RX GPDs always interrupt, a short packet may end any of them.
+ */
+static unsigned int qmu_ioc_batch = 8;
+module_param(qmu_ioc_batch, uint, 0644);
+static unsigned int qmu_ioc_us = 100;
+module_param(qmu_ioc_us, uint, 0644);
+
+void musb_qmu_ioc_arm(struct musb *musb)
+{
+	if (!hrtimer_is_queued(&musb->qmu_ioc_timer))
+		hrtimer_start(&musb->qmu_ioc_timer,
+			      ns_to_ktime((u64)qmu_ioc_us * NSEC_PER_USEC), HRTIMER_MODE_REL);
+}
+
+/*
+ * Put the requests of @musb_ep that have no GPD yet on the ring, in order,
+ * for as long as it has room, and resume the queue once for all of them.
+ * The rest are picked up when GPDs complete.  musb->lock held.
+ */
+void musb_qmu_refill(struct musb *musb, struct musb_ep *musb_ep)
+{
+	struct musb_request *req;
+	u8 epnum = musb_ep->current_epnum;
+	USB_DIR dir = musb_ep->is_in ? USB_TX : USB_RX;
+	bool coalesce = musb_ep->is_in && musb->g.speed == USB_SPEED_SUPER &&
+	    qmu_ioc_batch > 1;
+	bool kicked = false;
+	u8 ioc;
+
+	/* qmu_done_rx/tx() refill when they are done */
+	if (musb_ep->qmu_in_done)
+		return;
+
+	list_for_each_entry(req, &musb_ep->req_list, list) {
+		if (req->qmu_queued || req->request.dma == DMA_ADDR_INVALID)
+			continue;
+		/* a TX ZLP is sent by PIO, once what is before it is done */
+		if (req->tx && req->request.length == 0)
+			break;
+		if (!mu3d_hal_gpd_free(epnum, dir))
+			break;
+
+		ioc = 1;
+		if (coalesce) {
+			/* the one filling the ring interrupts, to refill it */
+			if (++musb_ep->qmu_no_ioc >= qmu_ioc_batch ||
+			    mu3d_hal_gpd_free(epnum, dir) == 1)
+				musb_ep->qmu_no_ioc = 0;
+			else
+				ioc = 0;
+		}
+
+		mu3d_hal_insert_transfer_gpd(epnum, dir, req->request.dma,
+					     req->request.length, true, ioc, false,
+					     ((req->tx && req->request.zero == 1) ? 1 : 0),
+					     musb_ep->end_point.maxpacket);
+		req->qmu_queued = 1;
+		kicked = true;
+	}
+
+	if (!kicked)
+		return;
+
+	/*Enable Tx_DMAREQEN */
+	if (musb_ep->is_in)
+		mu3d_setmsk(musb_ep->hw_ep->addr_txcsr0, 0, TX_DMAREQEN);
+	mu3d_hal_resume_qmu(musb, epnum, dir);
+
+	if (musb_ep->qmu_no_ioc)
+		musb_qmu_ioc_arm(musb);
+}
+
+/* after the ring was reset, all the requests go back on it */
+void musb_qmu_requeue(struct musb *musb, struct musb_ep *musb_ep)
+{
+	struct musb_request *req;
+
+	list_for_each_entry(req, &musb_ep->req_list, list) {
+		if (req->tx)
+			req->request.actual = req->request.length;
+		req->qmu_queued = 0;
+	}
+	musb_ep->qmu_no_ioc = 0;
+	musb_qmu_refill(musb, musb_ep);
+}
+#endif
+
+/* ----------------------------------------------------------------------- */
+
 /*
  * Abort requests queued to an endpoint using the status. Synchronous.
  * caller locked controller and blocked irqs, and selected this ep.
@@ -169,6 +263,7 @@ static void nuke(struct musb_ep *ep, const int status)
 
 #ifdef USE_SSUSB_QMU
 	mu3d_hal_flush_qmu(ep->musb, ep->hw_ep->epnum, (ep->is_in ? USB_TX : USB_RX));
+	ep->qmu_no_ioc = 0;
 	/* mu3d_hal_start_qmu(ep->musb, ep->musb->mregs, ep->hw_ep->epnum, (ep->is_in? USB_TX: USB_RX)); */
 #endif
 
@@ -849,6 +944,7 @@ static int musb_gadget_queue(struct usb_ep *ep, struct usb_request *req, gfp_t g
 	request->request.status = -EINPROGRESS;
 	request->epnum = musb_ep->current_epnum;
 	request->tx = musb_ep->is_in;
+	request->qmu_queued = 0;
 
 	map_dma_buffer(request, musb, musb_ep);
 
@@ -875,18 +971,7 @@ static int musb_gadget_queue(struct usb_ep *ep, struct usb_request *req, gfp_t g
 
 			request->request.actual = request->request.length;
 			if (request->request.length > 0) {
-
-				mu3d_hal_insert_transfer_gpd(request->epnum, USB_TX,
-							     request->request.dma,
-							     request->request.length, true, true,
-							     false,
-							     ((request->request.zero == 1) ? 1 : 0),
-							     ep->maxpacket);
-				/*Enable Tx_DMAREQEN */
-				mu3d_setmsk(hw_ep->addr_txcsr0, 0, TX_DMAREQEN);
-
-				mu3d_hal_resume_qmu(musb, request->epnum, USB_TX);
-
+				musb_qmu_refill(musb, musb_ep);
 			} else if (request->request.length == 0) {
 
 				qmu_dbg(K_DEBUG, "[TX]" "==Have send ZLP==\n");
@@ -913,10 +998,7 @@ static int musb_gadget_queue(struct usb_ep *ep, struct usb_request *req, gfp_t g
 				}
 			}
 		} else {
-			mu3d_hal_insert_transfer_gpd(request->epnum, USB_RX, request->request.dma,
-						     request->request.length, true, true, false,
-						     0, ep->maxpacket);
-			mu3d_hal_resume_qmu(musb, request->epnum, USB_RX);
+			musb_qmu_refill(musb, musb_ep);
 		}
 	}
 #else
@@ -956,13 +1038,10 @@ static int musb_gadget_dequeue(struct usb_ep *ep, struct usb_request *request)
 		goto done;
 	}
 
-	/* if the hardware doesn't have the request, easy ... */
-	if (musb_ep->req_list.next != &req->list || musb_ep->busy)
-		musb_g_giveback(musb_ep, request, -ECONNRESET);
-
-	/* ... else abort the dma transfer ... */
-
 #ifdef USE_SSUSB_QMU
+	/* if the QMU doesn't have the request, easy ... */
+	if (!req->qmu_queued)
+		musb_g_giveback(musb_ep, request, -ECONNRESET);
 	else {
 		mu3d_hal_flush_qmu(musb, musb_ep->hw_ep->epnum, (musb_ep->is_in ? USB_TX : USB_RX));
 		/* is_in--> TX */
@@ -971,9 +1050,17 @@ static int musb_gadget_dequeue(struct usb_ep *ep, struct usb_request *request)
 
 		/* only start qmu, don't need to reset EP */
 		mu3d_hal_start_qmu(musb, musb_ep->hw_ep->epnum, (musb_ep->is_in ? USB_TX : USB_RX));
+		/* the ring was emptied with it, the ones queued after go back */
+		musb_qmu_requeue(musb, musb_ep);
 		status = 0;
 	}
 #else
+	/* if the hardware doesn't have the request, easy ... */
+	if (musb_ep->req_list.next != &req->list || musb_ep->busy)
+		musb_g_giveback(musb_ep, request, -ECONNRESET);
+
+	/* ... else abort the dma transfer ... */
+
 	/* else if (is_dma_capable() && musb_ep->dma) { */
 	/* struct dma_controller *c = musb->dma_controller; */
 
@@ -1165,7 +1252,7 @@ static void musb_gadget_fifo_flush(struct usb_ep *ep)
 #ifdef USE_SSUSB_QMU
 		mu3d_hal_flush_qmu(musb, epnum, USB_TX);
 		mu3d_hal_restart_qmu(musb, epnum, USB_TX);
-
+		musb_qmu_requeue(musb, musb_ep);
 #endif
 		txcsr0 = mu3d_readl(musb->endpoints[epnum].addr_txcsr0, 0);
 
@@ -1181,6 +1268,7 @@ static void musb_gadget_fifo_flush(struct usb_ep *ep)
 #ifdef USE_SSUSB_QMU
 		mu3d_hal_flush_qmu(musb, epnum, USB_RX);
 		mu3d_hal_restart_qmu(musb, epnum, USB_RX);
+		musb_qmu_requeue(musb, musb_ep);
 #endif
 		mu3d_dbg(K_DEBUG, "%s RESET\n", ep->name);
 		/* os_writew(musb->endpoints[epnum].addr_rxcsr0, rxcsr0 | USB_RXCSR_FLUSHFIFO); */
@@ -44,6 +44,7 @@ struct musb_request {
 	struct musb *musb;
 	u8 tx;			/* endpoint direction */
 	u8 epnum;
+	u8 qmu_queued;		/* has a GPD on the QMU ring */
 	enum buffer_map_state map_state;
 };
 
@@ -82,6 +83,11 @@ struct musb_ep {
 	/* true if lock must be dropped but req_list may not be advanced */
 	u8 busy;
 
+	/* true while QMU completions are given back, see musb_qmu_refill() */
+	u8 qmu_in_done;
+	/* GPDs queued since the last one with IOC */
+	u8 qmu_no_ioc;
+
 	/* u8 hb_mult; */
 };
 
@@ -113,4 +119,10 @@ extern void musb_g_giveback(struct musb_ep *, struct usb_request *, int);
 
 extern void musb_ep_restart(struct musb *, struct musb_request *);
 
+#ifdef USE_SSUSB_QMU
+extern void musb_qmu_refill(struct musb *musb, struct musb_ep *musb_ep);
+extern void musb_qmu_requeue(struct musb *musb, struct musb_ep *musb_ep);
+extern void musb_qmu_ioc_arm(struct musb *musb);
+#endif
+
 #endif				/* __MUSB_GADGET_H */
@@ -96,7 +96,10 @@ static int fp_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
 			up(&fp_api_lock);
 			return -EFAULT;
 		}
-		memset((void *)fp_buff_addr, 0, args_len + 16);
+		if (args_len > FP_SIZE - 16) {
+			up(&fp_api_lock);
+			return -EINVAL;
+		}
 		if (copy_from_user((void *)fp_buff_addr, (void *)arg,
 				args_len + 16)) {
 			printk(KERN_INFO "copy from user failed. \n");
@@ -104,10 +107,8 @@ static int fp_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
 			return -EFAULT;
 		}
 
-		Flush_Dcache_By_Area((unsigned long)fp_buff_addr,
-				fp_buff_addr + FP_SIZE);
-		/*send command data to TEEI*/
-		send_fp_command(FP_DRIVER_ID);
+		/*send command data to TEEI, it flushes what was copied*/
+		send_fp_command(args_len + 16);
 #ifdef FP_DEBUG
 		printk("back from TEEI try copy share mem to user \n");
 		printk("result in share memory %d  \n", *((unsigned int *)fp_buff_addr));
@@ -7,6 +7,12 @@
 #include <linux/semaphore.h>
 #include <linux/kthread.h>
 #include <linux/delay.h>
+#include <linux/sched.h>
+#include <linux/math64.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/spinlock.h>
+#include <linux/uaccess.h>
 #include "nt_smc_call.h"
 #include "utdriver_macro.h"
 #include "sched_status.h"
@@ -23,6 +29,28 @@
 
 #define printk(fmt, args...) printk("\033[;34m[TEEI][TZDriver][switch_fn]"fmt"\033[0m", ##args)
 
+/*
+ * Time spent in the secure world per kind of call, as seen from here:
+ * add_work_entry() covers the queueing to the switch thread and the world
+ * switch, FP_CALL the whole of send_fp_command() up to the ack IRQ.
+ * cat /sys/kernel/debug/teei_latency for it, echo 0 > to reset.
+ */
+#define FP_CALL		0x05
+#define SWITCH_STAT_NR	0x06
+
+struct switch_stat_struct {
+	unsigned int count;
+	unsigned long long total_ns;
+	unsigned long long max_ns;
+};
+
+static const char * const switch_stat_name[SWITCH_STAT_NR] = {
+	"-", "capi", "fdrv", "bdrv", "sched", "fp",
+};
+
+static struct switch_stat_struct switch_stat[SWITCH_STAT_NR];
+static DEFINE_SPINLOCK(switch_stat_lock);
+
 struct switch_head_struct
 {
 	struct list_head head;
@@ -153,9 +181,75 @@ static int check_work_type(int work_type)
 }
 
 
+void teei_switch_stat_account(int work_type, unsigned long long start_ns)
+{
+	unsigned long long ns = sched_clock() - start_ns;
+	unsigned long flags;
+
+	if (work_type <= 0 || work_type >= SWITCH_STAT_NR)
+		return;
+
+	spin_lock_irqsave(&switch_stat_lock, flags);
+	switch_stat[work_type].count++;
+	switch_stat[work_type].total_ns += ns;
+	if (ns > switch_stat[work_type].max_ns)
+		switch_stat[work_type].max_ns = ns;
+	spin_unlock_irqrestore(&switch_stat_lock, flags);
+}
+
+static int switch_stat_show(struct seq_file *m, void *v)
+{
+	struct switch_stat_struct stat[SWITCH_STAT_NR];
+	unsigned long flags;
+	int i;
+
+	spin_lock_irqsave(&switch_stat_lock, flags);
+	memcpy(stat, switch_stat, sizeof(stat));
+	spin_unlock_irqrestore(&switch_stat_lock, flags);
+
+	seq_printf(m, "%-6s %10s %10s %10s\n", "call", "count", "avg_us", "max_us");
+	for (i = 1; i < SWITCH_STAT_NR; i++)
+		seq_printf(m, "%-6s %10u %10llu %10llu\n", switch_stat_name[i], stat[i].count,
+			   stat[i].count ? div_u64(stat[i].total_ns, stat[i].count) / 1000 : 0,
+			   stat[i].max_ns / 1000);
+
+	return 0;
+}
+
+static int switch_stat_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, switch_stat_show, NULL);
+}
+
+static ssize_t switch_stat_write(struct file *filp, const char __user *ubuf,
+				 size_t cnt, loff_t *ppos)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&switch_stat_lock, flags);
+	memset(switch_stat, 0, sizeof(switch_stat));
+	spin_unlock_irqrestore(&switch_stat_lock, flags);
+
+	return cnt;
+}
+
+static const struct file_operations switch_stat_fops = {
+	.open = switch_stat_open,
+	.read = seq_read,
+	.write = switch_stat_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+void teei_switch_stat_init(void)
+{
+	debugfs_create_file("teei_latency", 0644, NULL, NULL, &switch_stat_fops);
+}
+
 int add_work_entry(int work_type, unsigned long buff)
 {
 	struct switch_call_struct *work_entry = NULL;
+	unsigned long long start_ns = sched_clock();
 	int retVal = 0;
 
 	retVal = check_work_type(work_type);
@@ -182,6 +276,8 @@ int add_work_entry(int work_type, unsigned long buff)
 #else
 	retVal = ut_smc_call((void *)work_entry);
 #endif	
+	if (retVal == 0)
+		teei_switch_stat_account(work_type, start_ns);
 	return retVal;
 }
 
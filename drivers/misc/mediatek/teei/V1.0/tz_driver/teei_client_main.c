@@ -176,6 +176,7 @@ struct fdrv_call_struct {
 #define FDRV_CALL       0x02
 #define BDRV_CALL       0x03
 #define SCHED_CALL      0x04
+#define FP_CALL         0x05	/* latency stat only */
 
 #define FP_SYS_NO       100
 
@@ -263,6 +264,8 @@ DECLARE_COMPLETION(global_down_lock);
 EXPORT_SYMBOL_GPL(global_down_lock);
 
 extern int add_work_entry(int work_type, unsigned long buff);
+extern void teei_switch_stat_account(int work_type, unsigned long long start_ns);
+extern void teei_switch_stat_init(void);
 /*
  * structures and MACROs for NQ buffer
  */
@@ -3549,7 +3552,10 @@ int __send_fp_command(unsigned long share_memory_size)
 	/* down(&boot_sema); */
 
 	set_fp_command(share_memory_size);
-	Flush_Dcache_By_Area((unsigned long)fp_buff_addr, fp_buff_addr + FP_BUFF_SIZE);
+	/* only the part the command uses, not the whole 512KB */
+	if (share_memory_size > FP_BUFF_SIZE)
+		share_memory_size = FP_BUFF_SIZE;
+	Flush_Dcache_By_Area((unsigned long)fp_buff_addr, fp_buff_addr + share_memory_size);
 	/* Flush_Dcache_By_Area((unsigned long)vfs_flush_address, vfs_flush_address + VFS_SIZE); */
 
 #if 0
@@ -3589,6 +3595,7 @@ int send_fp_command(unsigned long share_memory_size)
 	int cpu_id = 0;
 	int retVal = 0;
 	struct fdrv_call_struct fdrv_ent;
+	unsigned long long start_ns = sched_clock();
 
 	down(&fp_lock);
 	mutex_lock(&pm_mutex);
@@ -3631,6 +3638,7 @@ int send_fp_command(unsigned long share_memory_size)
 	mutex_unlock(&pm_mutex);
 	up(&fp_lock);
 
+	teei_switch_stat_account(FP_CALL, start_ns);
 	return fdrv_ent.retVal;
 }
 
@@ -4019,6 +4027,7 @@ static int teei_client_init(void)
 	register_cpu_notifier(&tz_driver_cpu_notifer);
 	printk("after  register cpu notify\n");
 	teei_config_init();
+	teei_switch_stat_init();
 
 	goto return_fn;
 
@@ -1306,8 +1306,6 @@ void add_bdrv_queue(int bdrv_id)
 
 void set_fp_command(unsigned long memory_size)
 {
-
-	printk("[%s][%d]", __func__, __LINE__);
 	struct fdrv_message_head fdrv_msg_head;
 
 	memset(&fdrv_msg_head, 0, sizeof(struct fdrv_message_head));
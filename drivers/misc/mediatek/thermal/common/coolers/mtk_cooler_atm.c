@@ -92,6 +92,7 @@ static int GPU_L_H_TRIP = 80, GPU_L_L_TRIP = 40;
    1: ATMv2 (FTL)
    2: CPU_GPU_Weight ATM v2
    3: Precise Power Budgeting + Hybrid Power Budgeting
+   4: Predictive ATM (budget from Tj predicted over atm_pred_horizon polls)
 */
 static int tscpu_atm = 1;
 static int tt_ratio_high_rise = 1;
@@ -104,6 +105,12 @@ static int tp_ratio_low_rise;
 static int tp_ratio_low_fall;
 /* static int cpu_loading = 0; */
 
+/* tscpu_atm == 4, tuned by /proc/driver/thermal/clatm_pred */
+static int atm_pred_horizon = 4;	/* polling intervals to look ahead */
+static int atm_pred_weight = 2;		/* weight of the newest Tj delta, out of 8 */
+static int atm_pred_max_step = 300;	/* largest budget change per interval, mW */
+static int atm_pred_slope;		/* filtered Tj delta per interval, m-degreeC */
+
 static int (*_adaptive_power_calc)(long prev_temp, long curr_temp, unsigned int gpu_loading);
 
 #if PRECISE_HYBRID_POWER_BUDGET
@@ -917,6 +924,83 @@ static int _adaptive_power(long prev_temp, long curr_temp, unsigned int gpu_load
 	return 0;
 }
 
+/*
+ * Same budget loop as ATM v2, but driven by the Tj expected atm_pred_horizon
+ * polling intervals ahead instead of the current one.  The budget starts to
+ * come down while Tj is still climbing towards TARGET_TJ, and is moved in
+ * steps of at most atm_pred_max_step, so that the CPU/GPU limits glide
+ * instead of jumping when the trip is reached.
+ */
+static long atm_pred_temp(long prev_temp, long curr_temp)
+{
+	int horizon = atm_pred_horizon;
+
+	atm_pred_slope += ((int)(curr_temp - prev_temp) - atm_pred_slope) * atm_pred_weight / 8;
+#if MTKTSCPU_FAST_POLLING
+	/* keep the same look-ahead time when polling faster */
+	horizon *= tscpu_cur_fp_factor;
+#endif
+	/* only look ahead on the way up, a falling Tj is handled as it is */
+	if (atm_pred_slope <= 0)
+		return curr_temp;
+
+	return curr_temp + (long)atm_pred_slope * horizon;
+}
+
+static int _adaptive_power_pred(long prev_temp, long curr_temp, unsigned int gpu_loading)
+{
+	static int triggered, total_power;
+	long pred_temp = atm_pred_temp(prev_temp, curr_temp);
+	int delta_power = 0;
+
+	if (cl_dev_adp_cpu_state_active == 1) {
+		/* Check if it is triggered */
+		if (!triggered) {
+			if (pred_temp < TARGET_TJ)
+				return 0;
+
+			triggered = 1;
+			total_power = FIRST_STEP_TOTAL_POWER_BUDGET -
+				(pred_temp - TARGET_TJ) / PACKAGE_THETA_JA_RISE;
+			total_power = clamp(total_power, MINIMUM_TOTAL_POWER, MAXIMUM_TOTAL_POWER);
+			tscpu_dprintk("%s triggered Tp %ld, Tc %ld, Tpred %ld, Pt %d\n", __func__,
+				      prev_temp, curr_temp, pred_temp, total_power);
+			return P_adaptive(total_power, gpu_loading);
+		}
+
+		/* Adjust total power budget if necessary */
+		if (pred_temp >= TARGET_TJ_HIGH)
+			delta_power = -MAX((int)(pred_temp - TARGET_TJ) / PACKAGE_THETA_JA_RISE,
+					   MINIMUM_BUDGET_CHANGE);
+		else if (pred_temp <= TARGET_TJ_LOW)
+			delta_power = MAX((int)(TARGET_TJ - pred_temp) / PACKAGE_THETA_JA_FALL,
+					  MINIMUM_BUDGET_CHANGE);
+
+		delta_power = clamp(delta_power, -atm_pred_max_step, atm_pred_max_step);
+		total_power = clamp(total_power + delta_power, MINIMUM_TOTAL_POWER,
+				    MAXIMUM_TOTAL_POWER);
+
+		tscpu_dprintk("%s Tp %ld, Tc %ld, Tpred %ld, slope %d, delta_power %d, Pt %d\n",
+			      __func__, prev_temp, curr_temp, pred_temp, atm_pred_slope,
+			      delta_power, total_power);
+		return P_adaptive(total_power, gpu_loading);
+	}
+
+	if (triggered) {
+		triggered = 0;
+		tscpu_dprintk("%s Tp %ld, Tc %ld, Pt %d\n", __func__, prev_temp, curr_temp, total_power);
+		return P_adaptive(0, 0);
+	}
+#if THERMAL_HEADROOM
+	if (thp_max_cpu_power != 0)
+		set_adaptive_cpu_power_limit((unsigned int) MAX(thp_max_cpu_power, MINIMUM_CPU_POWER));
+	else
+		set_adaptive_cpu_power_limit(0);
+#endif
+
+	return 0;
+}
+
 static int decide_ttj(void)
 {
 	int i = 0;
@@ -1247,6 +1331,46 @@ static ssize_t tscpu_write_gpu_threshold(struct file *file, const char __user *b
 	return -EINVAL;
 }
 
+static int tscpu_read_atm_pred(struct seq_file *m, void *v)
+{
+	seq_printf(m, "horizon %d weight %d max_step %d\n",
+		   atm_pred_horizon, atm_pred_weight, atm_pred_max_step);
+	seq_printf(m, "slope %d\n", atm_pred_slope);
+	return 0;
+}
+
+static ssize_t tscpu_write_atm_pred(struct file *file, const char __user *buffer,
+				    size_t count, loff_t *data)
+{
+	char desc[128];
+	int len = 0;
+
+	int horizon = -1, weight = -1, max_step = -1;
+
+
+	len = (count < (sizeof(desc) - 1)) ? count : (sizeof(desc) - 1);
+	if (copy_from_user(desc, buffer, len))
+		return 0;
+
+	desc[len] = '\0';
+
+	if (sscanf(desc, "%d %d %d", &horizon, &weight, &max_step) == 3) {
+		tscpu_printk("tscpu_write_atm_pred input %d %d %d\n", horizon, weight, max_step);
+
+		if ((horizon >= 0) && (weight > 0) && (weight <= 8) && (max_step > 0)) {
+			atm_pred_horizon = horizon;
+			atm_pred_weight = weight;
+			atm_pred_max_step = max_step;
+		} else {
+			tscpu_dprintk("tscpu_write_atm_pred out of range\n");
+		}
+
+		return count;
+	}
+	tscpu_dprintk("tscpu_write_atm_pred bad argument\n");
+	return -EINVAL;
+}
+
 /* +ASC+ */
 static int tscpu_read_atm(struct seq_file *m, void *v)
 {
@@ -1305,11 +1429,15 @@ static ssize_t tscpu_write_atm(struct file *file, const char __user *buffer, siz
 		tp_ratio_low_rise = tmp_tp_ratio_low_rise;
 		tp_ratio_low_fall = tmp_tp_ratio_low_fall;
 
+		if (tscpu_atm == 4) {
+			atm_pred_slope = 0;
+			_adaptive_power_calc = _adaptive_power_pred;
+		} else {
+			_adaptive_power_calc = _adaptive_power;
+		}
 #if PRECISE_HYBRID_POWER_BUDGET
 		if (tscpu_atm == 3)
 			_adaptive_power_calc = _adaptive_power_ppb;
-		else
-			_adaptive_power_calc = _adaptive_power;
 #endif
 
 		return count;
@@ -1616,6 +1744,20 @@ static const struct file_operations mtktscpu_gpu_threshold_fops = {
 	.release = single_release,
 };
 
+static int tscpu_atm_pred_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, tscpu_read_atm_pred, NULL);
+}
+
+static const struct file_operations mtktscpu_atm_pred_fops = {
+	.owner = THIS_MODULE,
+	.open = tscpu_atm_pred_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.write = tscpu_write_atm_pred,
+	.release = single_release,
+};
+
 /* +ASC+ */
 static int tscpu_open_atm(struct inode *inode, struct file *file)
 {
@@ -1716,6 +1858,12 @@ static void tscpu_cooler_create_fs(void)
 				&mtktscpu_gpu_threshold_fops);
 		if (entry)
 			proc_set_user(entry, uid, gid);
+
+		entry =
+		    proc_create("clatm_pred", S_IRUGO | S_IWUSR | S_IWGRP, mtktscpu_dir,
+				&mtktscpu_atm_pred_fops);
+		if (entry)
+			proc_set_user(entry, uid, gid);
 #endif				/* #if CPT_ADAPTIVE_AP_COOLER */
 
 
@@ -241,20 +241,6 @@ static int tsallts_get_crit_temp(struct thermal_zone_device *thermal, unsigned l
 	return 0;
 }
 
-void mtkts_allts_cancel_ts4_timer(void)
-{
-	if (thz_dev)
-		cancel_delayed_work(&(thz_dev->poll_queue));
-}
-
-
-void mtkts_allts_start_ts4_timer(void)
-{
-	if (thz_dev != NULL && interval != 0)
-		mod_delayed_work(system_freezable_wq, &(thz_dev->poll_queue), round_jiffies(msecs_to_jiffies(1000)));
-	/*1000 = 1sec */
-}
-
 /* bind callback functions to thermalzone */
 static struct thermal_zone_device_ops tsallts_dev_ops = {
 	.bind = tsallts_bind,
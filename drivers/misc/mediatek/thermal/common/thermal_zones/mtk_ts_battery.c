@@ -534,32 +534,6 @@ static ssize_t mtktsbattery_write(struct file *file, const char __user *buffer,
 	return -EINVAL;
 }
 
-void mtkts_battery_cancel_thermal_timer(void)
-{
-	/* cancel timer */
-	/*pr_debug("mtkts_battery_cancel_thermal_timer\n"); */
-
-	/* stop thermal framework polling when entering deep idle */
-	/* For charging current throttling during deep idle,
-	   this delayed work cannot be canceled.
-	if (thz_dev)
-		cancel_delayed_work(&(thz_dev->poll_queue));
-	*/
-	return;
-}
-
-void mtkts_battery_start_thermal_timer(void)
-{
-	/*pr_debug("mtkts_battery_start_thermal_timer\n"); */
-	/* resume thermal framework polling when leaving deep idle */
-	/* For charging current throttling during deep idle,
-	   this delayed work cannot be canceled.
-	if (thz_dev != NULL && interval != 0)
-		mod_delayed_work(system_freezable_wq, &(thz_dev->poll_queue), round_jiffies(msecs_to_jiffies(3000)));
-	*/
-	return;
-}
-
 int mtktsbattery_register_cooler(void)
 {
 	/* cooling devices */
@@ -1089,26 +1089,6 @@ static ssize_t mtkts_btsmdpa_param_write(struct file *file, const char __user *b
 	/* return 0; */
 /* } */
 
-void mtkts_btsmdpa_cancel_thermal_timer(void)
-{
-	/* cancel timer */
-	/* pr_debug("mtkts_btsmdpa_cancel_thermal_timer\n"); */
-
-	/* stop thermal framework polling when entering deep idle */
-	/* if (thz_dev)
-		cancel_delayed_work(&(thz_dev->poll_queue)); */
-}
-
-
-void mtkts_btsmdpa_start_thermal_timer(void)
-{
-	/* pr_debug("mtkts_btsmdpa_start_thermal_timer\n"); */
-	/* resume thermal framework polling when leaving deep idle */
-	/* if (thz_dev != NULL && interval != 0)
-		mod_delayed_work(system_freezable_wq, &(thz_dev->poll_queue), round_jiffies(msecs_to_jiffies(3000)));*/
-}
-
-
 static int mtkts_btsmdpa_register_thermal(void)
 {
 	mtkts_btsmdpa_dprintk("[mtkts_btsmdpa_register_thermal]\n");
@@ -2024,12 +2024,9 @@ void tscpu_update_tempinfo(void)
 #endif
 }
 
+/* the mtktscpu zone polling itself is paused by mtk_thermal_idle_enter() */
 void tscpu_cancel_thermal_timer(void)
 {
-	/* stop thermal framework polling when entering deep idle */
-	if (thz_dev)
-		cancel_delayed_work(&(thz_dev->poll_queue));
-
 #if defined(CONFIG_ARCH_MT6755)
 /*Patch to pause thermal controller and turn off auxadc GC.
   For mt6755 only*/
@@ -2040,10 +2037,6 @@ void tscpu_cancel_thermal_timer(void)
 
 void tscpu_start_thermal_timer(void)
 {
-	/* resume thermal framework polling when leaving deep idle */
-	if (thz_dev != NULL && interval != 0)
-		mod_delayed_work(system_freezable_wq, &(thz_dev->poll_queue), round_jiffies(msecs_to_jiffies(1000)));
-
 #if defined(CONFIG_ARCH_MT6755)
 /*Patch to pause thermal controller and turn off auxadc GC.
   For mt6755 only*/
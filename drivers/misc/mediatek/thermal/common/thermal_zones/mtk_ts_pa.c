@@ -567,26 +567,6 @@ static const struct file_operations _tx_thro_fops = {
 };
 #endif
 
-void mtkts_pa_cancel_thermal_timer(void)
-{
-	/* cancel timer */
-	/* pr_debug("mtkts_pa_cancel_thermal_timer\n"); */
-
-	/* stop thermal framework polling when entering deep idle */
-	if (thz_dev)
-		cancel_delayed_work(&(thz_dev->poll_queue));
-}
-
-
-void mtkts_pa_start_thermal_timer(void)
-{
-	/* pr_debug("mtkts_pa_start_thermal_timer\n"); */
-	/* resume thermal framework polling when leaving deep idle */
-	if (thz_dev != NULL && interval != 0)
-		mod_delayed_work(system_freezable_wq, &(thz_dev->poll_queue), round_jiffies(msecs_to_jiffies(3000)));
-}
-
-
 int mtktspa_register_cooler(void)
 {
 	/* cooling devices */
@@ -384,26 +384,6 @@ static ssize_t mtktspmic_write(struct file *file, const char __user *buffer, siz
 	return -EINVAL;
 }
 
-void mtkts_pmic_cancel_thermal_timer(void)
-{
-	/* cancel timer */
-	/* pr_debug("mtkts_pmic_cancel_thermal_timer\n"); */
-
-	/* stop thermal framework polling when entering deep idle */
-	if (thz_dev)
-		cancel_delayed_work(&(thz_dev->poll_queue));
-}
-
-
-void mtkts_pmic_start_thermal_timer(void)
-{
-	/* pr_debug("mtkts_pmic_start_thermal_timer\n"); */
-	/* resume thermal framework polling when leaving deep idle */
-	if (thz_dev != NULL && interval != 0)
-		mod_delayed_work(system_freezable_wq, &(thz_dev->poll_queue), round_jiffies(msecs_to_jiffies(1000)));
-}
-
-
 int mtktspmic_register_cooler(void)
 {
 	cl_dev_sysrst = mtk_thermal_cooling_device_register("mtktspmic-sysrst", NULL,
@@ -391,25 +391,6 @@ static ssize_t mtktstsx_write(struct file *file, const char __user *buffer, size
 	return -EINVAL;
 }
 
-void mtkts_tsx_cancel_thermal_timer(void)
-{
-	/* cancel timer */
-	/* pr_debug("mtkts_tsx_cancel_thermal_timer\n"); */
-
-	/* stop thermal framework polling when entering deep idle */
-	if (thz_dev)
-		cancel_delayed_work(&(thz_dev->poll_queue));
-}
-
-
-void mtkts_tsx_start_thermal_timer(void)
-{
-	/* pr_debug("mtkts_tsx_start_thermal_timer\n"); */
-	/* resume thermal framework polling when leaving deep idle */
-	if (thz_dev != NULL && interval != 0)
-		mod_delayed_work(system_freezable_wq, &(thz_dev->poll_queue), round_jiffies(msecs_to_jiffies(1000)));
-}
-
 /*
 int mtktstsx_register_cooler(void)
 {
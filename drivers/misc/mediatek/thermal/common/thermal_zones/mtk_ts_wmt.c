@@ -1557,43 +1557,6 @@ static ssize_t wmt_tm_write(struct file *filp, const char __user *buf, size_t co
 }
 
 
-void mtkts_wmt_cancel_thermal_timer(void)
-{
-
-	struct linux_thermal_ctrl_if *p_linux_if = 0;
-
-	/* wmt_tm_dprintk("[%s]\n", __func__); */
-
-	if (pg_wmt_tm)
-		p_linux_if = &pg_wmt_tm->linux_if;
-	else
-		return;
-
-	/* pr_debug("mtkts_wmt_cancel_thermal_timer\n"); */
-
-	/* stop thermal framework polling when entering deep idle */
-	if (p_linux_if->thz_dev)
-		cancel_delayed_work(&(p_linux_if->thz_dev->poll_queue));
-}
-
-void mtkts_wmt_start_thermal_timer(void)
-{
-	struct linux_thermal_ctrl_if *p_linux_if = 0;
-
-	/* wmt_tm_dprintk("[%s]\n", __func__); */
-
-	if (pg_wmt_tm)
-		p_linux_if = &pg_wmt_tm->linux_if;
-	else
-		return;
-
-	/* pr_debug("mtkts_wmt_start_thermal_timer\n"); */
-	/* resume thermal framework polling when leaving deep idle */
-	if (p_linux_if->thz_dev != NULL && p_linux_if->interval != 0)
-		mod_delayed_work(system_freezable_wq, &(p_linux_if->thz_dev->poll_queue),
-				 round_jiffies(msecs_to_jiffies(2000)));
-}
-
 static const struct file_operations _wmt_tm_fops = {
 	.owner = THIS_MODULE,
 	.open = wmt_tm_open,
@@ -20,6 +20,7 @@
 #include <linux/time.h>
 #include <linux/string.h>
 #include <linux/mutex.h>
+#include <linux/spinlock.h>
 #include <linux/bug.h>
 #include <linux/workqueue.h>
 #include <linux/slab.h>
@@ -97,6 +98,25 @@ struct proc_dir_entry *mtk_thermal_get_proc_drv_therm_dir_entry(void);
 static DEFINE_MUTEX(MTM_GET_TEMP_LOCK);
 static int *tz_last_values[MTK_THERMAL_SENSOR_COUNT] = { NULL };
 
+/*
+ * Zones whose polling is stopped while the CPUs sit in SODI or deep idle.
+ * mtktsAP, mtktsbtsmdpa and mtktsbattery are not in the list: the battery can
+ * heat up with fast charging while the CPUs are idle.
+ */
+static const char * const mtk_thermal_idle_tz_types[] = {
+	"mtktscpu", "mtktspmic", "mtktspa", "mtktswmt", "mtktstsx",
+	"mtkts1", "mtkts2", "mtkts3", "mtkts4", "mtkts5",
+};
+
+struct mtk_thermal_idle_tz {
+	struct thermal_zone_device *tz;
+	unsigned long expires;	/* poll deadline when it was stopped */
+	bool paused;
+};
+
+static struct mtk_thermal_idle_tz mtk_thermal_idle_tzs[ARRAY_SIZE(mtk_thermal_idle_tz_types)];
+static DEFINE_SPINLOCK(mtk_thermal_idle_lock);
+
 /* ************************************ */
 /* Global Variable */
 /* ************************************ */
@@ -2033,6 +2053,68 @@ static struct thermal_zone_device_ops mtk_thermal_wrapper_dev_ops = {
 	.notify = mtk_thermal_wrapper_notify,
 };
 
+static void mtk_thermal_idle_tz_set(const char *type, struct thermal_zone_device *tz)
+{
+	unsigned long flags;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(mtk_thermal_idle_tz_types); i++) {
+		if (strcmp(mtk_thermal_idle_tz_types[i], type))
+			continue;
+
+		spin_lock_irqsave(&mtk_thermal_idle_lock, flags);
+		mtk_thermal_idle_tzs[i].tz = tz;
+		mtk_thermal_idle_tzs[i].paused = false;
+		spin_unlock_irqrestore(&mtk_thermal_idle_lock, flags);
+		return;
+	}
+}
+
+/*
+ * Called by mt_idle before SODI/deep idle, with interrupts disabled.  The
+ * poll works of the listed zones are cancelled and their deadlines kept, so
+ * that no zone wakes the system up from idle.
+ */
+void mtk_thermal_idle_enter(void)
+{
+	struct mtk_thermal_idle_tz *itz;
+	unsigned long flags;
+
+	spin_lock_irqsave(&mtk_thermal_idle_lock, flags);
+	for (itz = mtk_thermal_idle_tzs;
+	     itz < mtk_thermal_idle_tzs + ARRAY_SIZE(mtk_thermal_idle_tzs); itz++) {
+		if (!itz->tz || itz->paused)
+			continue;
+		itz->expires = itz->tz->poll_queue.timer.expires;
+		itz->paused = cancel_delayed_work(&itz->tz->poll_queue);
+	}
+	spin_unlock_irqrestore(&mtk_thermal_idle_lock, flags);
+}
+
+/*
+ * Called by mt_idle after SODI/deep idle.  Each stopped poll goes back to its
+ * old deadline, and all the polls that fell due during idle run in one batch
+ * right now.  Re-arming them a fixed time after every idle exit would delay
+ * them for as long as the system keeps entering idle.
+ */
+void mtk_thermal_idle_exit(void)
+{
+	struct mtk_thermal_idle_tz *itz;
+	unsigned long flags;
+	unsigned long now = jiffies;
+
+	spin_lock_irqsave(&mtk_thermal_idle_lock, flags);
+	for (itz = mtk_thermal_idle_tzs;
+	     itz < mtk_thermal_idle_tzs + ARRAY_SIZE(mtk_thermal_idle_tzs); itz++) {
+		if (!itz->tz || !itz->paused)
+			continue;
+		itz->paused = false;
+		mod_delayed_work(system_freezable_power_efficient_wq, &itz->tz->poll_queue,
+				 time_after(itz->expires, now) ? itz->expires - now : 0);
+	}
+	spin_unlock_irqrestore(&mtk_thermal_idle_lock, flags);
+}
+
 /*mtk thermal zone register function */
 struct thermal_zone_device *mtk_thermal_zone_device_register_wrapper
 (char *type, int trips, void *devdata, const struct thermal_zone_device_ops *ops,
@@ -2074,6 +2156,13 @@ int tc1, int tc2, int passive_delay, int polling_delay) {
 					  NULL,	/* /< tzp */
 					  passive_delay, polling_delay);
 
+	if (IS_ERR(tz)) {
+		kfree(tzdata);
+		return tz;
+	}
+
+	mtk_thermal_idle_tz_set(type, tz);
+
 	tzidx = mtk_thermal_get_tz_idx(type);
 
 	/* registered the last_temperature to local arra */
@@ -2185,6 +2274,8 @@ void mtk_thermal_zone_device_unregister_wrapper(struct thermal_zone_device *tz)
 	}
 	mutex_unlock(&MTM_GET_TEMP_LOCK);
 
+	mtk_thermal_idle_tz_set(type, NULL);
+
 	THRML_LOG("%s+ tz : %s\n", __func__, type);
 
 	thermal_zone_device_unregister(tz);
@@ -584,6 +584,38 @@ void mtk_uart_vfifo_write_byte(struct mtk_uart *uart, unsigned int byte)
 		reg_sync_writel(wpt + 1, VFF_WPT(base));
 }
 
+/*---------------------------------------------------------------------------*/
+/* Copy a run of bytes into the TX VFIFO and move the write pointer once.    */
+/* The caller makes sure there is room for them.                             */
+/*---------------------------------------------------------------------------*/
+static void mtk_uart_vfifo_write_string(struct mtk_uart *uart, const unsigned char *chars,
+					unsigned int size)
+{
+	void *base = uart->tx_vfifo->base;
+	unsigned char *vff = (unsigned char *)uart->tx_vfifo->addr;
+	unsigned int wpt = UART_READ32(VFF_WPT(base));
+	unsigned int num_to_end = UART_READ32(VFF_LEN(base)) - (wpt & 0xffff);
+
+	if (num_to_end > size) {
+		memcpy(vff + (wpt & 0xffff), chars, size);
+		wpt += size;
+	} else {
+		memcpy(vff + (wpt & 0xffff), chars, num_to_end);
+		memcpy(vff, chars + num_to_end, size - num_to_end);
+		wpt = ((~wpt) & 0x10000) + size - num_to_end;
+	}
+#ifdef ENABLE_RAW_DATA_DUMP
+	{
+		unsigned int i;
+
+		for (i = 0; i < size; i++)
+			save_tx_raw_data(uart, (void *)&chars[i]);
+	}
+#endif
+	mb();			/* make sure write point updated after VFIFO written. */
+	reg_sync_writel(wpt, VFF_WPT(base));
+}
+
 /*---------------------------------------------------------------------------*/
 unsigned int mtk_uart_vfifo_read_byte(struct mtk_uart *uart)
 {
@@ -687,21 +719,22 @@ static void mtk_uart_dma_vfifo_tx_tasklet_byte(unsigned long arg)
 	DGBUF_INIT(vfifo);
 	begin = ktime_get();
 	a = ktime_to_timespec(begin);
-	while (len--) {
-		/*DMA limitation.
-		   Workaround: Polling flush bit to zero, set 1s timeout */
-		while (UART_READ32(VFF_FLUSH(vfifo->base))) {
-			end = ktime_get();
-			b = ktime_to_timespec(end);
-			if ((b.tv_sec - a.tv_sec) > 1 || ((b.tv_sec - a.tv_sec) == 1 && b.tv_nsec > a.tv_nsec)) {
-				pr_debug("[UART%d] Polling flush timeout\n", port->line);
-				return;
-			}
+	/*DMA limitation.
+	   Workaround: Polling flush bit to zero, set 1s timeout */
+	while (UART_READ32(VFF_FLUSH(vfifo->base))) {
+		end = ktime_get();
+		b = ktime_to_timespec(end);
+		if ((b.tv_sec - a.tv_sec) > 1 || ((b.tv_sec - a.tv_sec) == 1 && b.tv_nsec > a.tv_nsec)) {
+			pr_debug("[UART%d] Polling flush timeout\n", port->line);
+			return;
 		}
-		DGBUF_PUSH_CH(vfifo, (char)xmit->buf[xmit->tail]);
-		uart->write_byte(uart, xmit->buf[xmit->tail]);
-		xmit->tail = (xmit->tail + 1) & (UART_XMIT_SIZE - 1);
-		port->icount.tx++;
+	}
+	/* the whole run at once, not one write pointer update per byte */
+	if (len) {
+		DGBUF_PUSH_STR(vfifo, &xmit->buf[xmit->tail], len);
+		mtk_uart_vfifo_write_string(uart, &xmit->buf[xmit->tail], len);
+		xmit->tail = (xmit->tail + len) & (UART_XMIT_SIZE - 1);
+		port->icount.tx += len;
 	}
 #if defined(ENABLE_VFIFO_DEBUG)
 	if (UART_DEBUG_EVT(DBG_EVT_DMA) && UART_DEBUG_EVT(DBG_EVT_BUF)) {
@@ -14,6 +14,9 @@ static GPD_R Rx_gpd_List[15];
 static GPD_R Tx_gpd_List[15];
 static u64 Rx_gpd_Offset[15];
 static u64 Tx_gpd_Offset[15];
+/* GPDs handed to the QMU and not completed yet */
+static u32 Rx_gpd_count[15];
+static u32 Tx_gpd_count[15];
 
 u8 PDU_calcCksum(u8 *data, int len)
 {
@@ -174,12 +177,14 @@ void qmu_reset_gpd_pool(u32 ep_num, u8 isRx)
 	/* SW reset */
 	if (isRx) {
 		memset(Rx_gpd_head[ep_num], 0, size);
+		Rx_gpd_count[ep_num] = 0;
 		Rx_gpd_end[ep_num] = Rx_gpd_last[ep_num] = Rx_gpd_head[ep_num];
 		TGPD_CLR_FLAGS_HWO(Rx_gpd_end[ep_num]);
 		gpd_ptr_align(isRx, ep_num, Rx_gpd_end[ep_num]);
 
 	} else {
 		memset(Tx_gpd_head[ep_num], 0, size);
+		Tx_gpd_count[ep_num] = 0;
 		Tx_gpd_end[ep_num] = Tx_gpd_last[ep_num] = Tx_gpd_head[ep_num];
 		TGPD_CLR_FLAGS_HWO(Tx_gpd_end[ep_num]);
 		gpd_ptr_align(isRx, ep_num, Tx_gpd_end[ep_num]);
@@ -235,6 +240,7 @@ static void prepare_rx_gpd(u8 *pBuf, u32 data_len, u8 ep_num)
 	/* make sure struct ready before HWO */
 	mb();
 	TGPD_SET_FLAGS_HWO(gpd);
+	Rx_gpd_count[ep_num]++;
 }
 
 static void prepare_tx_gpd(u8 *pBuf, u32 data_len, u8 ep_num, u8 zlp)
@@ -275,7 +281,7 @@ static void prepare_tx_gpd(u8 *pBuf, u32 data_len, u8 ep_num, u8 zlp)
 	/* make sure struct ready before HWO */
 	mb();
 	TGPD_SET_FLAGS_HWO(gpd);
-
+	Tx_gpd_count[ep_num]++;
 }
 
 void mtk_qmu_resume(u8 ep_num, u8 isRx)
@@ -528,6 +534,14 @@ static void mtk_qmu_disable(u8 ep_num, u8 isRx)
 	}
 }
 
+/* the ring always keeps an empty GPD as its tail */
+u32 mtk_qmu_gpd_free(u8 ep_num, u8 isRx)
+{
+	if (isRx)
+		return MAX_GPD_NUM - 1 - Rx_gpd_count[ep_num];
+	return MAX_GPD_NUM - 1 - Tx_gpd_count[ep_num];
+}
+
 void mtk_qmu_insert_task(u8 ep_num, u8 isRx, u8 *buf, u32 length, u8 zlp)
 {
 	QMU_INFO("ep_num: %d, isRx: %d, buf: %p, length: %d\n", ep_num, isRx, buf, length);
@@ -539,7 +553,7 @@ void mtk_qmu_insert_task(u8 ep_num, u8 isRx, u8 *buf, u32 length, u8 zlp)
 	}
 }
 
-void qmu_done_rx(struct musb *musb, u8 ep_num)
+static void __qmu_done_rx(struct musb *musb, u8 ep_num)
 {
 	void __iomem *base = qmu_base;
 
@@ -648,8 +662,12 @@ void qmu_done_rx(struct musb *musb, u8 ep_num)
 		}
 
 		Rx_gpd_last[ep_num] = gpd;
+		Rx_gpd_count[ep_num]--;
+		req->qmu_gpds = 0;
 		musb_g_giveback(musb_ep, request, 0);
 		req = next_request(musb_ep);
+		if (!req)
+			break;
 		request = &req->request;
 	}
 
@@ -680,7 +698,7 @@ void qmu_done_rx(struct musb *musb, u8 ep_num)
 		 ep_num, Rx_gpd_last[ep_num], Rx_gpd_end[ep_num]);
 }
 
-void qmu_done_tx(struct musb *musb, u8 ep_num)
+static void __qmu_done_tx(struct musb *musb, u8 ep_num)
 {
 	void __iomem *base = qmu_base;
 	TGPD *gpd = Tx_gpd_last[ep_num];
@@ -749,6 +767,13 @@ void qmu_done_tx(struct musb *musb, u8 ep_num)
 		request = &req->request;
 
 		Tx_gpd_last[ep_num] = gpd;
+		Tx_gpd_count[ep_num]--;
+		/* the request is done with its last GPD */
+		if (req->qmu_gpds > 1) {
+			req->qmu_gpds--;
+			continue;
+		}
+		req->qmu_gpds = 0;
 		musb_g_giveback(musb_ep, request, 0);
 		req = next_request(musb_ep);
 		if (req != NULL)
@@ -793,6 +818,30 @@ void qmu_done_tx(struct musb *musb, u8 ep_num)
 	}
 }
 
+/*
+ * Requests queued by the completion callbacks are only put on the ring
+ * once all the done GPDs are given back, and the queue is resumed once.
+ */
+void qmu_done_rx(struct musb *musb, u8 ep_num)
+{
+	struct musb_ep *musb_ep = &musb->endpoints[ep_num].ep_out;
+
+	musb_ep->qmu_in_done = 1;
+	__qmu_done_rx(musb, ep_num);
+	musb_ep->qmu_in_done = 0;
+	musb_qmu_refill(musb, musb_ep);
+}
+
+void qmu_done_tx(struct musb *musb, u8 ep_num)
+{
+	struct musb_ep *musb_ep = &musb->endpoints[ep_num].ep_in;
+
+	musb_ep->qmu_in_done = 1;
+	__qmu_done_tx(musb, ep_num);
+	musb_ep->qmu_in_done = 0;
+	musb_qmu_refill(musb, musb_ep);
+}
+
 void flush_ep_csr(struct musb *musb, u8 ep_num, u8 isRx)
 {
 	void __iomem *mbase = musb->mregs;
@@ -870,47 +919,17 @@ void mtk_qmu_err_recover(struct musb *musb, u8 ep_num, u8 isRx, bool is_len_err)
 	else
 		musb_ep = &musb->endpoints[ep_num].ep_in;
 
-	/* requeue all req , basically the same as musb_kick_D_CmdQ */
-	list_for_each_entry(request, &musb_ep->req_list, list) {
-		QMU_ERR("request 0x%p length(0x%d) len_err(%d)\n", request, request->request.length,
-			is_len_err);
-
-		if (request->request.dma != DMA_ADDR_INVALID) {
-			if (request->tx) {
-				QMU_ERR("[TX] gpd=%p, epnum=%d, len=%d\n", Tx_gpd_end[ep_num],
-					ep_num, request->request.length);
-				request->request.actual = request->request.length;
-				if (request->request.length > 0) {
-					QMU_ERR("[TX]" "Send non-ZLP cases\n");
-					mtk_qmu_insert_task(request->epnum,
-							    isRx,
-							    (u8 *) request->request.dma,
-							    request->request.length,
-							    ((request->request.zero == 1) ? 1 : 0));
-
-				} else if (request->request.length == 0) {
-					/* this case may be a problem */
-					QMU_ERR("[TX]" "Send ZLP cases, may be a problem!!!\n");
-					musb_tx_zlp_qmu(musb, request->epnum);
-					musb_g_giveback(musb_ep, &(request->request), 0);
-				} else {
-					QMU_ERR("ERR, TX, request->request.length(%d)\n",
-						request->request.length);
-				}
-			} else {
-				QMU_ERR("[RX] gpd=%p, epnum=%d, len=%d\n",
-					Rx_gpd_end[ep_num], ep_num, request->request.length);
-				mtk_qmu_insert_task(request->epnum,
-						    isRx,
-						    (u8 *) request->request.dma,
-						    request->request.length,
-						    ((request->request.zero == 1) ? 1 : 0));
-			}
-		}
+	/* a TX ZLP at the head goes by PIO, nothing would complete to send it */
+	request = next_request(musb_ep);
+	if (request && request->tx && request->request.length == 0 &&
+	    request->request.dma != DMA_ADDR_INVALID) {
+		QMU_ERR("[TX]" "Send ZLP cases, may be a problem!!!\n");
+		musb_tx_zlp_qmu(musb, request->epnum);
+		musb_g_giveback(musb_ep, &(request->request), 0);
 	}
-	QMU_ERR("RESUME QMU\n");
-	/* RESUME QMU */
-	mtk_qmu_resume(ep_num, isRx);
+
+	QMU_ERR("REQUEUE and RESUME QMU, len_err(%d)\n", is_len_err);
+	musb_qmu_requeue(musb, musb_ep);
 }
 
 void mtk_qmu_irq_err(struct musb *musb, u32 qisar)
@@ -14,7 +14,10 @@
 #define GPD_LEN_ALIGNED (64)	/* > gpd len (16) and cache line size aligned */
 #define GPD_EXT_LEN (48)	/* GPD_LEN_ALIGNED - 16(should be sizeof(TGPD) */
 #define GPD_SZ (16)
-#define MAX_GPD_NUM 36
+#define MAX_GPD_NUM 64	/* one page per queue, the tail GPD is never used */
+/* bufLen is 16 bits: longer TX requests take several GPDs, RX must fit one */
+#define QMU_TX_GPD_MAX_LEN	0xF000
+#define QMU_RX_GPD_MAX_LEN	0xFFFF
 #define RXQ_NUM 8
 #define TXQ_NUM 8
 #define MAX_QMU_EP RXQ_NUM
@@ -318,6 +321,7 @@ extern void qmu_reset_gpd_pool(u32 ep_num, u8 isRx);
 extern bool mtk_is_qmu_enabled(u8 EP_Num, u8 isRx);
 extern void mtk_qmu_enable(struct musb *musb, u8 EP_Num, u8 isRx);
 extern void mtk_qmu_insert_task(u8 EP_Num, u8 isRx, u8 *buf, u32 length, u8 zlp);
+extern u32 mtk_qmu_gpd_free(u8 ep_num, u8 isRx);
 extern void mtk_qmu_resume(u8 EP_Num, u8 isRx);
 extern void qmu_done_rx(struct musb *musb, u8 ep_num);
 extern void qmu_done_tx(struct musb *musb, u8 ep_num);
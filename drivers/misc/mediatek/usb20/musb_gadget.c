@@ -2052,6 +2052,15 @@ static int musb_gadget_queue(struct usb_ep *ep, struct usb_request *req, gfp_t g
 	request->request.status = -EINPROGRESS;
 	request->epnum = musb_ep->current_epnum;
 	request->tx = musb_ep->is_in;
+	request->qmu_gpds = 0;
+
+#ifdef MUSB_QMU_SUPPORT
+	if (!musb_qmu_len_ok(request)) {
+		QMU_ERR("%s: request %p of %d bytes does not fit the GPD ring\n",
+			ep->name, req, request->request.length);
+		return -EINVAL;
+	}
+#endif
 
 	map_dma_buffer(request, musb, musb_ep);
 
@@ -2166,18 +2175,23 @@ static int musb_gadget_dequeue(struct usb_ep *ep, struct usb_request *request)
 		goto done;
 	}
 
-	/* if the hardware doesn't have the request, easy ... */
-	if (musb_ep->req_list.next != &req->list || musb_ep->busy)
-		musb_g_giveback(musb_ep, request, -ECONNRESET);
 #ifdef MUSB_QMU_SUPPORT
+	/* if the QMU doesn't have the request, easy ... */
+	if (!req->qmu_gpds)
+		musb_g_giveback(musb_ep, request, -ECONNRESET);
 	else {
 		QMU_DBG("dequeue req(%p), ep(%d), swep(%d)\n", request, musb_ep->hw_ep->epnum,
 			 ep->address);
 		musb_flush_qmu(musb_ep->hw_ep->epnum, (musb_ep->is_in ? TXQ : RXQ));
 		musb_g_giveback(musb_ep, request, -ECONNRESET);
 		musb_restart_qmu(musb, musb_ep->hw_ep->epnum, (musb_ep->is_in ? TXQ : RXQ));
+		/* the ring was emptied with it, the ones queued after go back */
+		musb_qmu_requeue(musb, musb_ep);
 	}
 #else
+	/* if the hardware doesn't have the request, easy ... */
+	if (musb_ep->req_list.next != &req->list || musb_ep->busy)
+		musb_g_giveback(musb_ep, request, -ECONNRESET);
 	/* ... else abort the dma transfer ... */
 	else if (is_dma_capable() && musb_ep->dma) {
 		struct dma_controller *c = musb->dma_controller;
@@ -50,6 +50,7 @@ struct musb_request {
 	struct musb *musb;
 	u8 tx;			/* endpoint direction */
 	u8 epnum;
+	u8 qmu_gpds;		/* its GPDs on the QMU ring, 0 if not queued */
 	enum buffer_map_state map_state;
 };
 
@@ -94,6 +95,9 @@ struct musb_ep {
 
 	/* true if packet is received in fifo and req_list is empty */
 	u8 rx_pending;
+
+	/* true while QMU completions are given back, see musb_qmu_refill() */
+	u8 qmu_in_done;
 };
 
 static inline struct musb_ep *to_musb_ep(struct usb_ep *ep)
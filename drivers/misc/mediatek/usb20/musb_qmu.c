@@ -64,27 +64,84 @@ void musb_disable_q_all(struct musb *musb)
 	}
 }
 
-void musb_kick_D_CmdQ(struct musb *musb, struct musb_request *request)
+/* TX requests are split over GPDs, an RX request must fit in one */
+bool musb_qmu_len_ok(struct musb_request *req)
 {
-	int isRx;
+	if (req->tx)
+		return req->request.length <= QMU_TX_GPD_MAX_LEN * (MAX_GPD_NUM - 1);
+	return req->request.length <= QMU_RX_GPD_MAX_LEN;
+}
 
-	isRx = request->tx ? 0 : 1;
+static u32 musb_qmu_nr_gpds(struct musb_request *req)
+{
+	if (!req->tx)
+		return 1;
+	return DIV_ROUND_UP(req->request.length, QMU_TX_GPD_MAX_LEN);
+}
 
-	/* enable qmu at musb_gadget_eanble */
-#if 0
-	if (!mtk_is_qmu_enabled(request->epnum, isRx)) {
-		/* enable qmu */
-		mtk_qmu_enable(musb, request->epnum, isRx);
+/*
+ * Put the requests of @musb_ep that have no GPD yet on the ring, in order,
+ * for as long as it has room, and resume the queue once for all of them.
+ * The rest are picked up when GPDs complete.  musb->lock held.
+ */
+void musb_qmu_refill(struct musb *musb, struct musb_ep *musb_ep)
+{
+	struct musb_request *req;
+	u8 ep_num = musb_ep->current_epnum;
+	u8 isRx = musb_ep->is_in ? 0 : 1;
+	u32 room = mtk_qmu_gpd_free(ep_num, isRx);
+	bool kicked = false;
+
+	/* qmu_done_rx/tx() refill when they are done */
+	if (musb_ep->qmu_in_done)
+		return;
+
+	list_for_each_entry(req, &musb_ep->req_list, list) {
+		u32 nr, off, len, i;
+
+		if (req->qmu_gpds || req->request.dma == DMA_ADDR_INVALID)
+			continue;
+		/* a TX ZLP is sent by PIO, once what is before it is done */
+		if (req->tx && req->request.length == 0)
+			break;
+		nr = musb_qmu_nr_gpds(req);
+		if (nr > room)
+			break;
+
+		for (i = 0, off = 0; i < nr; i++, off += len) {
+			len = min_t(u32, req->request.length - off, QMU_TX_GPD_MAX_LEN);
+			/* note tx needed additional zlp field, on its last GPD */
+			mtk_qmu_insert_task(ep_num, isRx,
+					    (u8 *) (req->request.dma + off), len,
+					    (i == nr - 1 && req->request.zero == 1) ? 1 : 0);
+		}
+		req->qmu_gpds = nr;
+		room -= nr;
+		kicked = true;
 	}
-#endif
 
-	/* note tx needed additional zlp field */
-	mtk_qmu_insert_task(request->epnum,
-			    isRx,
-			    (u8 *) request->request.dma,
-			    request->request.length, ((request->request.zero == 1) ? 1 : 0));
+	if (kicked)
+		mtk_qmu_resume(ep_num, isRx);
+}
+
+/* after the ring was reset, all the requests go back on it */
+void musb_qmu_requeue(struct musb *musb, struct musb_ep *musb_ep)
+{
+	struct musb_request *req;
+
+	list_for_each_entry(req, &musb_ep->req_list, list) {
+		if (req->tx)
+			req->request.actual = req->request.length;
+		req->qmu_gpds = 0;
+	}
+	musb_qmu_refill(musb, musb_ep);
+}
 
-	mtk_qmu_resume(request->epnum, isRx);
+void musb_kick_D_CmdQ(struct musb *musb, struct musb_request *request)
+{
+	/* enable qmu at musb_gadget_eanble */
+	request->qmu_gpds = 0;
+	musb_qmu_refill(musb, request->ep);
 }
 
 irqreturn_t musb_q_irq(struct musb *musb)
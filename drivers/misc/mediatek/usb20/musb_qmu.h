@@ -7,6 +7,9 @@
 extern int musb_qmu_init(struct musb *musb);
 extern void musb_qmu_exit(struct musb *musb);
 extern void musb_kick_D_CmdQ(struct musb *musb, struct musb_request *request);
+extern bool musb_qmu_len_ok(struct musb_request *req);
+extern void musb_qmu_refill(struct musb *musb, struct musb_ep *musb_ep);
+extern void musb_qmu_requeue(struct musb *musb, struct musb_ep *musb_ep);
 extern void musb_disable_q_all(struct musb *musb);
 extern irqreturn_t musb_q_irq(struct musb *musb);
 extern void musb_flush_qmu(u32 ep_num, u8 isRx);
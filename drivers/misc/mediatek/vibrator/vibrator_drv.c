@@ -13,7 +13,9 @@
 #include <linux/kernel.h>
 #include <linux/types.h>
 #include <linux/device.h>
-#include <linux/workqueue.h>
+#include <linux/kthread.h>
+#include <linux/sched.h>
+#include <linux/rtpm_prio.h>
 
 #include "timed_output.h"
 
@@ -76,14 +78,45 @@ do {	\
 /******************************************************************************
 Global Definations
 ******************************************************************************/
-static struct workqueue_struct *vibrator_queue;
-static struct work_struct vibrator_work;
+/*
+ * Everything played is a sequence: on, off, on... segments in ms.
+ * An enable() from timed_output replaces what is playing with a single
+ * on segment, a write to "pattern" queues a sequence after it.
+ *
+ * The LDO is switched by an RT kthread, the PMIC access may sleep, and
+ * each segment is timed by the hrtimer from the moment the LDO has been
+ * switched, so a late wakeup delays a click but does not shorten it.
+ * vibe_gen is bumped when the sequence is replaced, a timer started for
+ * an older one is ignored.
+ */
+#define VIB_SEQ_MAX		16
+#define VIB_QUEUE_MAX		4
+
+struct vib_seq {
+	unsigned int n;
+	unsigned int seg_ms[VIB_SEQ_MAX];
+};
+
+static struct task_struct *vibrator_task;
+static DEFINE_KTHREAD_WORKER(vibrator_worker);
+static void update_vibrator(struct kthread_work *work);
+static DEFINE_KTHREAD_WORK(vibrator_work, update_vibrator);
 static struct hrtimer vibe_timer;
 static spinlock_t vibe_lock;
 static int vibe_state;
 static int ldo_state;
 static int shutdown_flag;
 
+/* protected by vibe_lock */
+static struct vib_seq vibe_seq;
+static unsigned int vibe_seg;		/* next segment of vibe_seq */
+static struct vib_seq vibe_queue[VIB_QUEUE_MAX];
+static unsigned int vibe_queue_head;
+static unsigned int vibe_queued;
+static unsigned int vibe_gen;
+static unsigned int vibe_timer_gen;
+static bool vibe_timing;		/* a segment is being timed */
+
 static int vibr_Enable(void)
 {
 	if (!ldo_state) {
@@ -102,17 +135,74 @@ static int vibr_Disable(void)
 	return 0;
 }
 
-static void update_vibrator(struct work_struct *work)
+static void update_vibrator(struct kthread_work *work)
 {
-	if (!vibe_state)
+	unsigned long flags;
+	unsigned int gen, ms = 0;
+	int on = 0;
+
+	spin_lock_irqsave(&vibe_lock, flags);
+	if (vibe_timing) {
+		spin_unlock_irqrestore(&vibe_lock, flags);
+		return;
+	}
+	gen = vibe_gen;
+	while (vibe_seg >= vibe_seq.n && vibe_queued) {
+		vibe_seq = vibe_queue[vibe_queue_head];
+		vibe_queue_head = (vibe_queue_head + 1) % VIB_QUEUE_MAX;
+		vibe_queued--;
+		vibe_seg = 0;
+	}
+	if (vibe_seg < vibe_seq.n && !shutdown_flag) {
+		ms = vibe_seq.seg_ms[vibe_seg];
+		on = !(vibe_seg & 1);
+		vibe_seg++;
+	}
+	vibe_state = on;
+	spin_unlock_irqrestore(&vibe_lock, flags);
+
+	if (!on)
 		vibr_Disable();
 	else
 		vibr_Enable();
+
+	if (!ms)
+		return;
+
+	spin_lock_irqsave(&vibe_lock, flags);
+	/* otherwise replaced meanwhile, and queued again */
+	if (gen == vibe_gen && !vibe_timing) {
+		vibe_timing = true;
+		vibe_timer_gen = gen;
+		hrtimer_start(&vibe_timer,
+			      ktime_set(ms / 1000, (ms % 1000) * 1000000),
+			      HRTIMER_MODE_REL);
+	}
+	spin_unlock_irqrestore(&vibe_lock, flags);
+}
+
+/* the shortest on time that the motor can be felt with */
+static unsigned int vibrator_on_time(unsigned int value)
+{
+#if 1
+	struct vibrator_hw *hw = mt_get_cust_vibrator_hw();
+
+	VIB_DEBUG("vibrator_enable: vibrator cust timer: %d\n",
+		  hw->vib_timer);
+#ifdef CUST_VIBR_LIMIT
+	if (value > hw->vib_limit && value < hw->vib_timer)
+#else
+	if (value >= 10 && value < hw->vib_timer)
+#endif
+		value = hw->vib_timer;
+#endif
+
+	return (value > 15000 ? 15000 : value);
 }
 
 static int vibrator_get_time(struct timed_output_dev *dev)
 {
-	if (hrtimer_active(&vibe_timer)) {
+	if (vibe_state && hrtimer_active(&vibe_timer)) {
 		ktime_t r = hrtimer_get_remaining(&vibe_timer);
 
 		return ktime_to_ms(r);
@@ -120,52 +210,53 @@ static int vibrator_get_time(struct timed_output_dev *dev)
 		return 0;
 }
 
+/* called with vibe_lock held, the next run of the worker plays it */
+static void vibrator_replace(unsigned int value)
+{
+	vibe_gen++;
+	hrtimer_try_to_cancel(&vibe_timer);
+	vibe_timing = false;
+	vibe_queued = 0;
+	vibe_seg = 0;
+	vibe_seq.n = value ? 1 : 0;
+	vibe_seq.seg_ms[0] = value;
+}
+
 static void vibrator_enable(struct timed_output_dev *dev, int value)
 {
 	unsigned long flags;
 
-#if 1
-	struct vibrator_hw *hw = mt_get_cust_vibrator_hw();
-#endif
-
 	VIB_DEBUG("vibrator_enable: vibrator first in value = %d\n", value);
 
-	spin_lock_irqsave(&vibe_lock, flags);
-	while (hrtimer_cancel(&vibe_timer))
-		VIB_DEBUG("vibrator_enable: try to cancel hrtimer\n");
-
-	if (value == 0 || shutdown_flag == 1) {
+	if (value <= 0 || shutdown_flag == 1) {
 		VIB_DEBUG("vibrator_enable: shutdown_flag = %d\n",
 			  shutdown_flag);
-		vibe_state = 0;
+		value = 0;
 	} else {
-#if 1
-		VIB_DEBUG("vibrator_enable: vibrator cust timer: %d\n",
-			  hw->vib_timer);
-#ifdef CUST_VIBR_LIMIT
-		if (value > hw->vib_limit && value < hw->vib_timer)
-#else
-		if (value >= 10 && value < hw->vib_timer)
-#endif
-			value = hw->vib_timer;
-#endif
-
-		value = (value > 15000 ? 15000 : value);
-		vibe_state = 1;
-		hrtimer_start(&vibe_timer,
-			      ktime_set(value / 1000, (value % 1000) * 1000000),
-			      HRTIMER_MODE_REL);
+		value = vibrator_on_time(value);
 	}
+
+	spin_lock_irqsave(&vibe_lock, flags);
+	vibrator_replace(value);
 	spin_unlock_irqrestore(&vibe_lock, flags);
 	VIB_DEBUG("vibrator_enable: vibrator start: %d\n", value);
-	queue_work(vibrator_queue, &vibrator_work);
+	queue_kthread_work(&vibrator_worker, &vibrator_work);
 }
 
 static enum hrtimer_restart vibrator_timer_func(struct hrtimer *timer)
 {
-	vibe_state = 0;
-	VIB_DEBUG("vibrator_timer_func: vibrator will disable\n");
-	queue_work(vibrator_queue, &vibrator_work);
+	bool next = false;
+
+	spin_lock(&vibe_lock);
+	if (vibe_timer_gen == vibe_gen) {
+		vibe_timing = false;
+		next = true;
+	}
+	spin_unlock(&vibe_lock);
+
+	VIB_DEBUG("vibrator_timer_func: segment done\n");
+	if (next)
+		queue_kthread_work(&vibrator_worker, &vibrator_work);
 	return HRTIMER_NORESTART;
 }
 
@@ -192,6 +283,7 @@ static void vib_shutdown(struct platform_device *pdev)
 	VIB_DEBUG("vib_shutdown: enter!\n");
 	spin_lock_irqsave(&vibe_lock, flags);
 	shutdown_flag = 1;
+	vibrator_replace(0);
 	if (vibe_state) {
 		VIB_DEBUG("vib_shutdown: vibrator will disable\n");
 		vibe_state = 0;
@@ -235,6 +327,47 @@ static ssize_t store_vibr_on(struct device *dev, struct device_attribute *attr,
 
 static DEVICE_ATTR(vibr_on, 0220, NULL, store_vibr_on);
 
+/* "on off on ..." in ms, queued after what is playing */
+static ssize_t store_pattern(struct device *dev, struct device_attribute *attr,
+			     const char *buf, size_t size)
+{
+	struct vib_seq seq;
+	unsigned long flags;
+	const char *p = buf;
+	unsigned int ms;
+	int len, ret = size;
+	bool idle;
+
+	seq.n = 0;
+	while (sscanf(p, "%u%n", &ms, &len) == 1) {
+		if (!ms || seq.n >= VIB_SEQ_MAX)
+			return -EINVAL;
+		seq.seg_ms[seq.n] = (seq.n & 1) ? ms : vibrator_on_time(ms);
+		seq.n++;
+		p += len;
+	}
+	if (!seq.n)
+		return -EINVAL;
+
+	spin_lock_irqsave(&vibe_lock, flags);
+	if (shutdown_flag) {
+		ret = -ENODEV;
+	} else if (vibe_queued >= VIB_QUEUE_MAX) {
+		ret = -EBUSY;
+	} else {
+		vibe_queue[(vibe_queue_head + vibe_queued) % VIB_QUEUE_MAX] = seq;
+		vibe_queued++;
+	}
+	idle = !vibe_timing;
+	spin_unlock_irqrestore(&vibe_lock, flags);
+
+	if (ret > 0 && idle)
+		queue_kthread_work(&vibrator_worker, &vibrator_work);
+	return ret;
+}
+
+static DEVICE_ATTR(pattern, 0220, NULL, store_pattern);
+
 /******************************************************************************
  * vib_mod_init
  *
@@ -255,6 +388,7 @@ static DEVICE_ATTR(vibr_on, 0220, NULL, store_vibr_on);
 static int vib_mod_init(void)
 {
 	s32 ret;
+	struct sched_param param = { .sched_priority = RTPM_PRIO_VIBRATOR };
 
 	VIB_DEBUG("MediaTek MTK vibrator driver register, version %s\n",
 		  VERSION);
@@ -267,12 +401,13 @@ static int vib_mod_init(void)
 		return ret;
 	}
 
-	vibrator_queue = create_singlethread_workqueue(VIB_DEVICE);
-	if (!vibrator_queue) {
-		VIB_DEBUG("Unable to create workqueue\n");
+	vibrator_task = kthread_run(kthread_worker_fn, &vibrator_worker, VIB_DEVICE);
+	if (IS_ERR(vibrator_task)) {
+		VIB_DEBUG("Unable to create worker thread\n");
+		vibrator_task = NULL;
 		return -ENODATA;
 	}
-	INIT_WORK(&vibrator_work, update_vibrator);
+	sched_setscheduler(vibrator_task, SCHED_FIFO, &param);
 
 	spin_lock_init(&vibe_lock);
 	shutdown_flag = 0;
@@ -293,6 +428,10 @@ static int vib_mod_init(void)
 	if (ret)
 		VIB_DEBUG("device_create_file vibr_on fail!\n");
 
+	ret = device_create_file(mtk_vibrator.dev, &dev_attr_pattern);
+	if (ret)
+		VIB_DEBUG("device_create_file pattern fail!\n");
+
 	VIB_DEBUG("vib_mod_init Done\n");
 
 	return RSUCCESS;
@@ -319,8 +458,10 @@ static void vib_mod_exit(void)
 {
 	VIB_DEBUG("MediaTek MTK vibrator driver unregister, version %s\n",
 		  VERSION);
-	if (vibrator_queue)
-		destroy_workqueue(vibrator_queue);
+	if (vibrator_task) {
+		flush_kthread_worker(&vibrator_worker);
+		kthread_stop(vibrator_task);
+	}
 	VIB_DEBUG("vib_mod_exit Done\n");
 }
 
@@ -233,6 +233,12 @@ void disp_aal_notify_backlight_changed(int bl_1024)
 }
 
 
+/* the AAL service has set the init regs and reads back whole frame histograms */
+int disp_aal_is_active(void)
+{
+	return g_aal_is_init_regs_valid;
+}
+
 static int disp_aal_copy_hist_to_user(DISP_AAL_HIST __user *hist)
 {
 	unsigned long flags;
@@ -413,6 +419,10 @@ static int aal_config(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig, vo
 
 		AAL_DBG("AAL_CFG = 0x%x, AAL_SIZE = 0x%x(%d, %d)",
 			DISP_REG_GET(DISP_AAL_CFG), DISP_REG_GET(DISP_AAL_SIZE), width, height);
+	} else if (pConfig->partial_dirty) {
+		/* the histogram is not in use, see disp_aal_is_active() */
+		DISP_REG_SET(cmdq, DISP_AAL_SIZE,
+			     (ddp_path_roi_w(pConfig) << 16) | ddp_path_roi_h(pConfig));
 	}
 
 	if (pConfig->ovl_dirty || pConfig->rdma_dirty)
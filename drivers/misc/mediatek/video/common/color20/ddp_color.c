@@ -1695,7 +1695,7 @@ static int _color_config(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig,
 	int offset = C0_OFFSET;
 	void *cmdq = cmq_handle;
 
-	if (!pConfig->dst_dirty)
+	if (!pConfig->dst_dirty && !pConfig->partial_dirty)
 		return 0;
 
 	if (module == DISP_MODULE_COLOR0) {
@@ -1713,8 +1713,9 @@ static int _color_config(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig,
 #endif
 #endif
 	}
-	_color_reg_set(cmdq, DISP_COLOR_INTERNAL_IP_WIDTH + offset, pConfig->dst_w);	/* wrapper width */
-	_color_reg_set(cmdq, DISP_COLOR_INTERNAL_IP_HEIGHT + offset, pConfig->dst_h);	/* wrapper height */
+	/* wrapper width/height */
+	_color_reg_set(cmdq, DISP_COLOR_INTERNAL_IP_WIDTH + offset, ddp_path_roi_w(pConfig));
+	_color_reg_set(cmdq, DISP_COLOR_INTERNAL_IP_HEIGHT + offset, ddp_path_roi_h(pConfig));
 
 	return 0;
 }
@@ -70,8 +70,8 @@ void disp_dither_init(disp_dither_id_t id, int width, int height,
 
 static int disp_dither_config(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig, void *cmdq)
 {
-	if (pConfig->dst_dirty) {
-		disp_dither_init(DISP_DITHER0, pConfig->dst_w, pConfig->dst_h,
+	if (pConfig->dst_dirty || pConfig->partial_dirty) {
+		disp_dither_init(DISP_DITHER0, ddp_path_roi_w(pConfig), ddp_path_roi_h(pConfig),
 				 pConfig->lcm_bpp, cmdq);
 	}
 
@@ -59,8 +59,9 @@ static void disp_gamma_init(disp_gamma_id_t id, unsigned int width, unsigned int
 
 static int disp_gamma_config(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig, void *cmdq)
 {
-	if (pConfig->dst_dirty)
-		disp_gamma_init(DISP_GAMMA0, pConfig->dst_w, pConfig->dst_h, cmdq);
+	if (pConfig->dst_dirty || pConfig->partial_dirty)
+		disp_gamma_init(DISP_GAMMA0, ddp_path_roi_w(pConfig), ddp_path_roi_h(pConfig),
+				cmdq);
 	return 0;
 }
 
@@ -385,8 +386,9 @@ static int disp_ccorr_set_coef(const DISP_CCORR_COEF_T __user *user_color_corr,
 
 static int disp_ccorr_config(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig, void *cmdq)
 {
-	if (pConfig->dst_dirty)
-		disp_ccorr_init(DISP_CCORR0, pConfig->dst_w, pConfig->dst_h, cmdq);
+	if (pConfig->dst_dirty || pConfig->partial_dirty)
+		disp_ccorr_init(DISP_CCORR0, ddp_path_roi_w(pConfig), ddp_path_roi_h(pConfig),
+				cmdq);
 
 	return 0;
 }
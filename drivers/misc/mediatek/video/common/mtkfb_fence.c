@@ -348,7 +348,8 @@ static void mtkfb_ion_cache_flush(struct ion_client *client, struct ion_handle *
 
 	sys_data.sys_cmd = ION_SYS_CACHE_SYNC;
 	sys_data.cache_sync_param.kernel_handle = handle;
-	sys_data.cache_sync_param.sync_type = ION_CACHE_FLUSH_ALL;
+	/* the buffer only, mt_cache_sync picks set/way for a large one */
+	sys_data.cache_sync_param.sync_type = ION_CACHE_FLUSH_BY_RANGE;
 
 	if (ion_kernel_ioctl(client, ION_CMD_SYSTEM, (unsigned long)&sys_data))
 		MTKFB_FENCE_ERR("ion cache flush failed!\n");
@@ -33,5 +33,6 @@ extern int aal_dbg_en;
 void aal_test(const char *cmd, char *debug_output);
 
 void disp_aal_notify_backlight_changed(int bl_1024);
+int disp_aal_is_active(void);
 
 #endif
@@ -338,6 +338,7 @@ typedef enum {
 
 typedef enum {
 	DISP_FEATURE_TIME_SHARING = 0x00000001,
+	DISP_FEATURE_PARTIAL_UPDATE = 0x00000002,
 } DISP_FEATURE;
 
 typedef struct disp_caps_t {
@@ -357,6 +358,23 @@ typedef struct disp_session_buf_t {
 	unsigned int buf_hnd[3];
 } disp_session_buf_info;
 
+#define DISP_DIRTY_ROI_MAX	8
+
+typedef struct disp_dirty_rect_t {
+	unsigned int x, y;
+	unsigned int width, height;
+} disp_dirty_rect;
+
+/*
+ * Regions changed by the next DISP_IOCTL_SET_INPUT_BUFFER of the session,
+ * for DISP_FEATURE_PARTIAL_UPDATE.  roi_num 0: the whole screen.
+ */
+typedef struct disp_session_dirty_roi_t {
+	unsigned int session_id;
+	unsigned int roi_num;
+	disp_dirty_rect roi[DISP_DIRTY_ROI_MAX];
+} disp_session_dirty_roi;
+
 /* IOCTL commands. */
 #define DISP_IOW(num, dtype)     _IOW('O', num, dtype)
 #define DISP_IOR(num, dtype)     _IOR('O', num, dtype)
@@ -388,6 +406,7 @@ typedef struct disp_session_buf_t {
 #define DISP_IOCTL_GET_DISPLAY_CAPS			DISP_IOW(218, disp_caps_info)
 #define DISP_IOCTL_INSERT_SESSION_BUFFERS			DISP_IOW(219, disp_session_buf_info)
 #define	DISP_IOCTL_FRAME_CONFIG			DISP_IOW(220, disp_session_output_config)
+#define DISP_IOCTL_SET_DIRTY_ROI			DISP_IOW(221, disp_session_dirty_roi)
 
 
 #ifdef __KERNEL__
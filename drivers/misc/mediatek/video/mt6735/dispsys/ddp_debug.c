@@ -91,6 +91,8 @@ unsigned int disp_low_power_disable_ddp_clock = 0;
 unsigned int disp_low_power_disable_fence_thread = 0;
 unsigned int disp_low_power_remove_ovl = 1;
 unsigned int gSkipIdleDetect = 0;
+unsigned long int gIdleExitBudgetUs = 60000;
+unsigned long int gAutoDecouplePercent = 25;
 unsigned int gDumpClockStatus = 1;
 #ifdef DISP_ENABLE_SODI_FOR_VIDEO_MODE
 unsigned int gEnableSODIControl = 1;
@@ -655,6 +657,20 @@ static void process_dbg_opt(const char *opt)
 				       DISP_REG_RDMA_FIFO_CON, gRDMAFIFOLen);
 		sprintf(buf, "rdma_fifo, gRDMAFIFOLen=0x%x, reg=0x%x\n",
 			(unsigned int)gRDMAFIFOLen, DISP_REG_GET(DISP_REG_RDMA_FIFO_CON));
+	} else if (0 == strncmp(opt, "idle_budget:", 12)) {
+		p = (char *)opt + 12;
+		ret = kstrtoul(p, 10, &gIdleExitBudgetUs);
+		if (ret)
+			pr_err("DISP/%s: errno %d\n", __func__, ret);
+
+		sprintf(buf, "idle_budget, gIdleExitBudgetUs=%lu\n", gIdleExitBudgetUs);
+	} else if (0 == strncmp(opt, "auto_dc:", 8)) {
+		p = (char *)opt + 8;
+		ret = kstrtoul(p, 10, &gAutoDecouplePercent);
+		if (ret)
+			pr_err("DISP/%s: errno %d\n", __func__, ret);
+
+		sprintf(buf, "auto_dc, gAutoDecouplePercent=%lu\n", gAutoDecouplePercent);
 	} else if (0 == strncmp(opt, "g_regr:", 7)) {
 		unsigned int reg_va_before;
 		unsigned long reg_va;
@@ -928,8 +944,10 @@ void ddp_debug_init(void)
 		debugfs = debugfs_create_file("dispsys", S_IFREG | S_IRUGO, NULL, (void *)0, &debug_fops);
 
 		debugDir = debugfs_create_dir("disp", NULL);
-		if (debugDir)
+		if (debugDir) {
 			debugfs_dump = debugfs_create_file("dump", S_IFREG | S_IRUGO, debugDir, NULL, &debug_fops_dump);
+			dprec_frame_debugfs_init(debugDir);
+		}
 	}
 }
 
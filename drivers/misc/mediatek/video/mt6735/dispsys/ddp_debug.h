@@ -20,6 +20,8 @@ extern unsigned int disp_low_power_remove_ovl;
 extern unsigned int gDumpClockStatus;
 
 extern unsigned int gSkipIdleDetect;
+extern unsigned long int gIdleExitBudgetUs;
+extern unsigned long int gAutoDecouplePercent;
 extern unsigned int gEnableSODIControl;
 extern unsigned int gPrefetchControl;
 
@@ -2614,7 +2614,7 @@ int DSI_Send_ROI(DISP_MODULE_ENUM module, void *handle, unsigned int x, unsigned
 	data_array[1] = (y1_MSB << 24) | (y0_LSB << 16) | (y0_MSB << 8) | 0x2b;
 	data_array[2] = (y1_LSB);
 	DSI_set_cmdq(module, handle, data_array, 3, 1);
-	DDPMSG("DSI_Send_ROI Done!\n");
+	DDPDBG("DSI_Send_ROI (%d,%d,%d,%d) Done!\n", x, y, width, height);
 
 	/* data_array[0]= 0x002c3909; */
 	/* DSI_set_cmdq(module, handle, data_array, 1, 0); */
@@ -3176,6 +3176,27 @@ static void DSI_PHY_CLK_LP_PerLine_config(DISP_MODULE_ENUM module, cmdqRecHandle
 
 }
 
+/*
+ * Command mode partial update: the next frames carry only config->partial_roi.
+ * Goes in the config handle, which waits for the previous frame to be done,
+ * so the trigger loop sends the 0x2c memory write into the new window.
+ */
+static void ddp_dsi_config_partial(DISP_MODULE_ENUM module, disp_ddp_path_config *config,
+				   void *cmdq)
+{
+	LCM_DSI_PARAMS *dsi_config = &(config->dispif_config.dsi);
+	struct disp_rect *roi = &config->partial_roi;
+
+	if (dsi_config->mode != CMD_MODE)
+		return;
+
+	DSI_PS_Control(module, cmdq, dsi_config, ddp_path_roi_w(config), ddp_path_roi_h(config));
+	if (roi->width)
+		DSI_Send_ROI(module, cmdq, roi->x, roi->y, roi->width, roi->height);
+	else
+		DSI_Send_ROI(module, cmdq, 0, 0, config->dst_w, config->dst_h);
+}
+
 int ddp_dsi_config(DISP_MODULE_ENUM module, disp_ddp_path_config *config, void *cmdq)
 {
 	int i = 0;
@@ -3183,7 +3204,7 @@ int ddp_dsi_config(DISP_MODULE_ENUM module, disp_ddp_path_config *config, void *
 
 	if (!config->dst_dirty) {
 		if (atomic_read(&PMaster_enable) == 0)
-			return 0;
+			goto done;
 	}
 	/* DISPFUNC(); */
 	/* DISPDBG("===>run here 00 Pmaster: clk:%d\n",_dsi_context[0].dsi_params.PLL_CLOCK); */
@@ -3248,9 +3269,9 @@ force_config:
 	if (dsi_config->clk_lp_per_line_enable)
 		DSI_PHY_CLK_LP_PerLine_config(module, cmdq, dsi_config);
 
-
-
 done:
+	if (config->partial_dirty)
+		ddp_dsi_config_partial(module, config, cmdq);
 
 	return 0;
 }
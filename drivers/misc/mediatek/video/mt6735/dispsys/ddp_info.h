@@ -89,6 +89,14 @@ typedef struct _WDMA_CONFIG_STRUCT {
 	DISP_BUFFER_TYPE security;
 } WDMA_CONFIG_STRUCT;
 
+/* region of the panel updated by a command mode frame */
+struct disp_rect {
+	unsigned int x;
+	unsigned int y;
+	unsigned int width;
+	unsigned int height;
+};
+
 typedef struct {
 	/* for ovl */
 	bool ovl_dirty;
@@ -96,6 +104,7 @@ typedef struct {
 	bool wdma_dirty;
 	bool dst_dirty;
 	bool roi_dirty;
+	bool partial_dirty;	/* partial_roi changed */
 	bool is_memory;
 	OVL_CONFIG_STRUCT ovl_config[OVL_LAYER_NUM];
 	RDMA_CONFIG_STRUCT rdma_config;
@@ -105,8 +114,21 @@ typedef struct {
 	unsigned int dst_w;
 	unsigned int dst_h;
 	unsigned int fps;
+	/* width 0: the whole dst_w x dst_h frame */
+	struct disp_rect partial_roi;
 } disp_ddp_path_config;
 
+/* size of the frame going down the path, partial_roi or the whole panel */
+static inline unsigned int ddp_path_roi_w(disp_ddp_path_config *config)
+{
+	return config->partial_roi.width ? config->partial_roi.width : config->dst_w;
+}
+
+static inline unsigned int ddp_path_roi_h(disp_ddp_path_config *config)
+{
+	return config->partial_roi.width ? config->partial_roi.height : config->dst_h;
+}
+
 typedef int (*ddp_module_notify)(DISP_MODULE_ENUM, DISP_PATH_EVENT);
 
 typedef struct DDP_MODULE_DRIVER {
@@ -18,6 +18,7 @@
 #include "ddp_rdma.h"
 #include "ddp_rdma_ex.h"
 #include "primary_display.h"
+#include <mt-plat/mt_smi.h>
 
 /* IRQ log print kthread */
 static struct task_struct *disp_irq_log_task;
@@ -509,7 +510,8 @@ irqreturn_t disp_irq_handler(int irq, void *dev_id)
 			disp_irq_log_module |= 1 << module;
 			disp_irq_reset_module |= 1 << module;
 			rdma_underflow_irq_cnt[index]++;
-
+			/* let SMI throttle the other larbs */
+			smi_disp_underflow_notify();
 		}
 		if (reg_val & (1 << 5)) {
 			DDPIRQ("IRQ: RDMA%d target line!\n", index);
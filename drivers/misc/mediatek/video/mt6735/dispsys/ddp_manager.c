@@ -324,6 +324,16 @@ int dpmgr_path_set_video_mode(disp_path_handle dp_handle, int is_vdo_mode)
 	return 0;
 }
 
+int dpmgr_path_set_cmdq_handle(disp_path_handle dp_handle, cmdqRecHandle cmdq_handle)
+{
+	ddp_path_handle handle = NULL;
+
+	ASSERT(dp_handle != NULL);
+	handle = (ddp_path_handle) dp_handle;
+	handle->cmdqhandle = cmdq_handle;
+	return 0;
+}
+
 unsigned long hw_mutex_id_to_handle_map[128];
 disp_path_handle dpmgr_create_path(DDP_SCENARIO_ENUM scenario, cmdqRecHandle cmdq_handle)
 {
@@ -1340,6 +1350,7 @@ disp_ddp_path_config *dpmgr_path_get_last_config(disp_path_handle dp_handle)
 	handle->last_config.rdma_dirty = 0;
 	handle->last_config.wdma_dirty = 0;
 	handle->last_config.dst_dirty = 0;
+	handle->last_config.partial_dirty = 0;
 	return &handle->last_config;
 }
 
@@ -164,6 +164,14 @@ int dpmgr_path_set_dst_module(disp_path_handle dp_handle, DISP_MODULE_ENUM dst_m
 */
 int dpmgr_path_set_video_mode(disp_path_handle dp_handle, int is_vdo_mode);
 
+/* replace the cmdq handle the path was created with, for the commands
+ * the path builds on its own (start, stop, trigger, power).
+ * return 0.
+ * dp_handle: disp path handle.
+ * cmdq_handle: config handle used from now on.
+*/
+int dpmgr_path_set_cmdq_handle(disp_path_handle dp_handle, cmdqRecHandle cmdq_handle);
+
 /* init path , it will set mutex according to modules on this path and sof sorce.
  * and it will connect path , then initialize modules on this path.
  * return 0.
@@ -6,6 +6,10 @@
 #include <linux/kthread.h>
 #include <linux/mutex.h>
 #include <linux/string.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+#include <linux/sort.h>
 #include <stdarg.h>
 #include <mt-plat/met_drv.h>
 
@@ -892,10 +896,13 @@ void dprec_stub_irq(unsigned int irq_bit)
 	/* DISP_REG_SET(NULL, DISP_REG_CONFIG_MUTEX_INTEN,0xffffffff); */
 	if (irq_bit == DDP_IRQ_DSI0_EXT_TE)
 		dprec_logger_trigger(DPREC_LOGGER_DSI_EXT_TE, irq_bit, 0);
-	else if (irq_bit == DDP_IRQ_RDMA0_START)
+	else if (irq_bit == DDP_IRQ_RDMA0_START) {
 		dprec_logger_start(DPREC_LOGGER_RDMA0_TRANSFER, irq_bit, 0);
-	else if (irq_bit == DDP_IRQ_RDMA0_DONE)
+		dprec_frame_stage(DPREC_FRAME_START, 0);
+	} else if (irq_bit == DDP_IRQ_RDMA0_DONE) {
 		dprec_logger_done(DPREC_LOGGER_RDMA0_TRANSFER, irq_bit, 0);
+		dprec_frame_stage(DPREC_FRAME_DONE, 0);
+	}
 
 	/* DISPMSG("irq:0x%08x\n", irq_bit); */
 }
@@ -918,6 +925,209 @@ unsigned int dprec_get_vsync_count(void)
 	return vsync_cnt;
 }
 
+/*
+ * Frame timeline: a ring of the last DPREC_FRAME_NUM primary frames.  Each
+ * stage has its own sequence number and is the only one moving it, so the
+ * ioctl path, the RDMA irq and the present fence worker never take a lock;
+ * a hardware stage is given to the oldest frame the previous stage is done
+ * with, the present stage takes every frame its fence covers.
+ */
+#define DPREC_FRAME_NUM 128	/* power of 2 */
+#define DPREC_FRAME_SHOW 16
+
+typedef struct {
+	unsigned int fence;
+	unsigned long long ts[DPREC_FRAME_STAGE_NUM];
+} dprec_frame_record;
+
+static dprec_frame_record dprec_frame[DPREC_FRAME_NUM];
+static unsigned int dprec_frame_seq[DPREC_FRAME_STAGE_NUM];
+/* first frame of the summaries, moved by a write to the debugfs file */
+static unsigned int dprec_frame_base;
+static DEFINE_MUTEX(dprec_frame_lock);
+
+static const char * const dprec_frame_stage_name[DPREC_FRAME_STAGE_NUM] = {
+	[DPREC_FRAME_QUEUE] = "queue",
+	[DPREC_FRAME_CONFIG] = "config",
+	[DPREC_FRAME_TRIGGER] = "trigger",
+	[DPREC_FRAME_START] = "start",
+	[DPREC_FRAME_DONE] = "done",
+	[DPREC_FRAME_PRESENT] = "present",
+};
+
+static dprec_frame_record *dprec_frame_get(unsigned int seq)
+{
+	return &dprec_frame[seq & (DPREC_FRAME_NUM - 1)];
+}
+
+void dprec_frame_stage(DPREC_FRAME_STAGE stage, unsigned int val)
+{
+	unsigned long long now = sched_clock();
+	unsigned int submitted = ACCESS_ONCE(dprec_frame_seq[DPREC_FRAME_TRIGGER]);
+	unsigned int seq, limit;
+	dprec_frame_record *f;
+
+	switch (stage) {
+	case DPREC_FRAME_QUEUE:
+		f = dprec_frame_get(submitted);
+		if (!f->ts[stage])
+			f->ts[stage] = now;
+		break;
+	case DPREC_FRAME_CONFIG:
+		dprec_frame_get(submitted)->ts[stage] = now;
+		break;
+	case DPREC_FRAME_TRIGGER:
+		f = dprec_frame_get(submitted);
+		f->fence = val;
+		f->ts[stage] = now;
+		memset(dprec_frame_get(submitted + 1), 0, sizeof(*f));
+		smp_wmb();
+		ACCESS_ONCE(dprec_frame_seq[stage]) = submitted + 1;
+		break;
+	case DPREC_FRAME_START:
+	case DPREC_FRAME_DONE:
+		/* frames the present stage already took are skipped */
+		seq = dprec_frame_seq[stage];
+		if ((int)(ACCESS_ONCE(dprec_frame_seq[DPREC_FRAME_PRESENT]) - seq) > 0)
+			seq = ACCESS_ONCE(dprec_frame_seq[DPREC_FRAME_PRESENT]);
+		limit = stage == DPREC_FRAME_START ? submitted :
+			ACCESS_ONCE(dprec_frame_seq[DPREC_FRAME_START]);
+		if ((int)(limit - seq) > 0) {
+			smp_rmb();
+			dprec_frame_get(seq)->ts[stage] = now;
+			seq++;
+		}
+		dprec_frame_seq[stage] = seq;
+		break;
+	case DPREC_FRAME_PRESENT:
+		seq = dprec_frame_seq[stage];
+		smp_rmb();
+		while (seq != submitted && (int)(dprec_frame_get(seq)->fence - val) <= 0) {
+			dprec_frame_get(seq)->ts[stage] = now;
+			seq++;
+		}
+		ACCESS_ONCE(dprec_frame_seq[stage]) = seq;
+		break;
+	default:
+		break;
+	}
+}
+
+static int dprec_frame_cmp(const void *a, const void *b)
+{
+	unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* latency percentiles from stage @from to stage @to over the summary window */
+static void dprec_frame_show_interval(struct seq_file *m, unsigned int *us,
+				      unsigned int first, unsigned int last,
+				      DPREC_FRAME_STAGE from, DPREC_FRAME_STAGE to)
+{
+	unsigned int seq, n = 0;
+
+	for (seq = first; seq != last; seq++) {
+		dprec_frame_record *f = dprec_frame_get(seq);
+
+		if (f->ts[from] && f->ts[to] >= f->ts[from])
+			us[n++] = (unsigned int)div_u64(f->ts[to] - f->ts[from], 1000);
+	}
+
+	if (!n) {
+		seq_printf(m, "%-8s -> %-8s %6u\n",
+			   dprec_frame_stage_name[from], dprec_frame_stage_name[to], 0);
+		return;
+	}
+
+	sort(us, n, sizeof(*us), dprec_frame_cmp, NULL);
+	seq_printf(m, "%-8s -> %-8s %6u %8u %8u %8u %8u\n",
+		   dprec_frame_stage_name[from], dprec_frame_stage_name[to], n,
+		   us[n * 50 / 100], us[n * 90 / 100], us[n * 99 / 100], us[n - 1]);
+}
+
+static int dprec_frame_show(struct seq_file *m, void *v)
+{
+	unsigned int first, last, seq;
+	unsigned int *us;
+	int i;
+
+	us = kmalloc_array(DPREC_FRAME_NUM, sizeof(*us), GFP_KERNEL);
+	if (!us)
+		return -ENOMEM;
+
+	mutex_lock(&dprec_frame_lock);
+	/* presented frames still in the ring, minus the oldest being reused */
+	last = ACCESS_ONCE(dprec_frame_seq[DPREC_FRAME_PRESENT]);
+	first = last - (DPREC_FRAME_NUM - 2);
+	if ((int)(dprec_frame_base - first) > 0)
+		first = dprec_frame_base;
+	if ((int)(first - last) > 0)
+		first = last;
+	smp_rmb();
+
+	seq_printf(m, "presented frames: %u, latency in us\n", last - first);
+	seq_printf(m, "%-20s %6s %8s %8s %8s %8s\n",
+		   "stage", "frames", "p50", "p90", "p99", "max");
+	for (i = DPREC_FRAME_QUEUE; i < DPREC_FRAME_PRESENT; i++)
+		dprec_frame_show_interval(m, us, first, last, i, i + 1);
+	dprec_frame_show_interval(m, us, first, last,
+				  DPREC_FRAME_QUEUE, DPREC_FRAME_PRESENT);
+
+	seq_printf(m, "\nlast frames, us from queue:\n%8s %8s", "seq", "fence");
+	for (i = DPREC_FRAME_CONFIG; i < DPREC_FRAME_STAGE_NUM; i++)
+		seq_printf(m, " %8s", dprec_frame_stage_name[i]);
+	seq_puts(m, "\n");
+
+	seq = (int)(last - first) > DPREC_FRAME_SHOW ? last - DPREC_FRAME_SHOW : first;
+	for (; seq != last; seq++) {
+		dprec_frame_record *f = dprec_frame_get(seq);
+
+		seq_printf(m, "%8u %8d", seq, (int)f->fence);
+		for (i = DPREC_FRAME_CONFIG; i < DPREC_FRAME_STAGE_NUM; i++) {
+			if (f->ts[DPREC_FRAME_QUEUE] && f->ts[i] >= f->ts[DPREC_FRAME_QUEUE])
+				seq_printf(m, " %8llu",
+					   div_u64(f->ts[i] - f->ts[DPREC_FRAME_QUEUE], 1000));
+			else
+				seq_printf(m, " %8s", "-");
+		}
+		seq_puts(m, "\n");
+	}
+	mutex_unlock(&dprec_frame_lock);
+
+	kfree(us);
+	return 0;
+}
+
+static int dprec_frame_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, dprec_frame_show, NULL);
+}
+
+/* any write starts the summaries over */
+static ssize_t dprec_frame_write(struct file *file, const char __user *buf,
+				 size_t count, loff_t *ppos)
+{
+	mutex_lock(&dprec_frame_lock);
+	dprec_frame_base = ACCESS_ONCE(dprec_frame_seq[DPREC_FRAME_PRESENT]);
+	mutex_unlock(&dprec_frame_lock);
+	return count;
+}
+
+static const struct file_operations dprec_frame_fops = {
+	.open = dprec_frame_open,
+	.read = seq_read,
+	.write = dprec_frame_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+void dprec_frame_debugfs_init(struct dentry *dir)
+{
+	debugfs_create_file("frame_timeline", S_IFREG | S_IRUGO | S_IWUSR, dir, NULL,
+			    &dprec_frame_fops);
+}
+
 void dprec_reg_op(void *cmdq, unsigned int reg, unsigned int val, unsigned int mask)
 {
 	return;
@@ -1258,6 +1468,14 @@ unsigned int dprec_get_vsync_count(void)
 	return 0;
 }
 
+void dprec_frame_stage(DPREC_FRAME_STAGE stage, unsigned int val)
+{
+}
+
+void dprec_frame_debugfs_init(struct dentry *dir)
+{
+}
+
 void dprec_reg_op(void *cmdq, unsigned int reg, unsigned int val, unsigned int mask)
 {
 }
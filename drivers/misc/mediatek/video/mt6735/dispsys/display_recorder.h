@@ -128,6 +128,21 @@ typedef enum {
 
 #define DPREC_ERROR_LOG_BUFFER_LENGTH (1024 * 16)
 
+/* primary display frame timeline, in the order a frame goes through them */
+typedef enum {
+	DPREC_FRAME_QUEUE = 0,	/* first input buffer set by HWC */
+	DPREC_FRAME_CONFIG,	/* cmdq config built from the last one */
+	DPREC_FRAME_TRIGGER,	/* config flushed, val is the present fence */
+	DPREC_FRAME_START,	/* RDMA0 start after the trigger */
+	DPREC_FRAME_DONE,	/* RDMA0 done, end of scanout */
+	DPREC_FRAME_PRESENT,	/* present fences up to val signaled */
+	DPREC_FRAME_STAGE_NUM
+} DPREC_FRAME_STAGE;
+
+struct dentry;
+void dprec_frame_stage(DPREC_FRAME_STAGE stage, unsigned int val);
+void dprec_frame_debugfs_init(struct dentry *dir);
+
 void dprec_event_op(DPREC_EVENT event);
 void dprec_reg_op(void *cmdq, unsigned int reg, unsigned int val, unsigned int mask);
 int dprec_handle_option(unsigned int option);
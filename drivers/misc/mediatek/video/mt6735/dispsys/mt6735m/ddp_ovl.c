@@ -988,6 +988,29 @@ void ovl_reset_by_cmdq(void *handle, DISP_MODULE_ENUM module)
 	}
 }
 
+/* move a layer into the partial update ROI, disable it if it is outside */
+static void ovl_layer_clip(OVL_CONFIG_STRUCT *cfg, const struct disp_rect *roi)
+{
+	unsigned int x0 = max(cfg->dst_x, roi->x);
+	unsigned int y0 = max(cfg->dst_y, roi->y);
+	unsigned int x1 = min(cfg->dst_x + cfg->dst_w, roi->x + roi->width);
+	unsigned int y1 = min(cfg->dst_y + cfg->dst_h, roi->y + roi->height);
+
+	if (x1 <= x0 || y1 <= y0) {
+		cfg->layer_en = 0;
+		return;
+	}
+
+	cfg->src_x += x0 - cfg->dst_x;
+	cfg->src_y += y0 - cfg->dst_y;
+	cfg->dst_x = x0 - roi->x;
+	cfg->dst_y = y0 - roi->y;
+	cfg->dst_w = x1 - x0;
+	cfg->dst_h = y1 - y0;
+	cfg->src_w = cfg->dst_w;
+	cfg->src_h = cfg->dst_h;
+}
+
 static int ovl_is_sec[2];
 static int ovl_config_l(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig, void *handle)
 {
@@ -1027,10 +1050,12 @@ static int ovl_config_l(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig,
 		}
 	}
 
-	if (pConfig->dst_dirty || pConfig->roi_dirty)
-		ovl_roi(module, pConfig->dst_w, pConfig->dst_h, gOVLBackground, handle);
+	if (pConfig->dst_dirty || pConfig->roi_dirty || pConfig->partial_dirty)
+		ovl_roi(module, ddp_path_roi_w(pConfig), ddp_path_roi_h(pConfig),
+			gOVLBackground, handle);
 
-	if (!pConfig->ovl_dirty)
+	/* the layers move with the ROI */
+	if (!pConfig->ovl_dirty && !pConfig->partial_dirty)
 		return 0;
 
 	/* check if we has sec layer */
@@ -1097,8 +1122,16 @@ static int ovl_config_l(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig,
 	}
 
 	for (i = layer_min; i < layer_max; i++) {
-		if (pConfig->ovl_config[i].layer_en != 0) {
-			if (ovl_check_input_param(&pConfig->ovl_config[i]))
+		OVL_CONFIG_STRUCT clip, *cfg = &pConfig->ovl_config[i];
+
+		if (cfg->layer_en && pConfig->partial_roi.width) {
+			clip = *cfg;
+			ovl_layer_clip(&clip, &pConfig->partial_roi);
+			cfg = &clip;
+		}
+
+		if (cfg->layer_en != 0) {
+			if (ovl_check_input_param(cfg))
 				continue;
 
 			/* if AEE=1, assert layer addr must equal to asert_pa or
@@ -1106,12 +1139,12 @@ static int ovl_config_l(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig,
 			 */
 			if (module == DISP_MODULE_OVL0 &&
 			    i == (layer_max - 1) &&
-			    isAEEEnabled && pConfig->ovl_config[i].addr != get_Assert_Layer_PA()) {
+			    isAEEEnabled && cfg->addr != get_Assert_Layer_PA()) {
 				DDPMLOG
 				    ("O - assert layer skip. O%d/L%d/LMax%d/mva0x%lx,reg_addr=0x%x\n",
-				     module, i, layer_max, pConfig->ovl_config[i].addr,
+				     module, i, layer_max, cfg->addr,
 				     DISP_REG_GET(DISP_REG_OVL_L3_ADDR));
-				ovl_layer_switch(module, i % 4, pConfig->ovl_config[i].layer_en,
+				ovl_layer_switch(module, i % 4, cfg->layer_en,
 						 handle);
 				layer_enable |= (1 << (i % 4));
 				continue;
@@ -1127,35 +1160,29 @@ static int ovl_config_l(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig,
 				DISP_REG_SET(handle, DISP_REG_OVL_EN + DISP_OVL_INDEX_OFFSET, 1);
 			}
 
-			ovl_layer_config(module, i % 4, pConfig->ovl_config[i].source,
-					 pConfig->ovl_config[i].fmt, pConfig->ovl_config[i].addr,
-					 pConfig->ovl_config[i].src_x, pConfig->ovl_config[i].src_y,
-					 pConfig->ovl_config[i].src_pitch, pConfig->ovl_config[i].dst_x,
-					 pConfig->ovl_config[i].dst_y, pConfig->ovl_config[i].dst_w,
-					 pConfig->ovl_config[i].dst_h, pConfig->ovl_config[i].keyEn,
-					 pConfig->ovl_config[i].key, pConfig->ovl_config[i].aen,
-					 pConfig->ovl_config[i].alpha, pConfig->ovl_config[i].sur_aen,
-					 pConfig->ovl_config[i].src_alpha, pConfig->ovl_config[i].dst_alpha,
+			ovl_layer_config(module, i % 4, cfg->source, cfg->fmt, cfg->addr,
+					 cfg->src_x, cfg->src_y, cfg->src_pitch,
+					 cfg->dst_x, cfg->dst_y, cfg->dst_w, cfg->dst_h,
+					 cfg->keyEn, cfg->key, cfg->aen, cfg->alpha,
+					 cfg->sur_aen, cfg->src_alpha, cfg->dst_alpha,
 					 0xff000000,	/* constant_color */
-					 pConfig->ovl_config[i].yuv_range,
-					 pConfig->ovl_config[i].security, has_sec_layer, handle, pConfig->is_memory);
+					 cfg->yuv_range,
+					 cfg->security, has_sec_layer, handle, pConfig->is_memory);
 			DDPMLOG("O%d/L%d/S%d/%s/0x%lx/(%d,%d)/P%d/(%d,%d,%d,%d).\n",
 				module - DISP_MODULE_OVL0,
 				i,
-				pConfig->ovl_config[i].source,
+				cfg->source,
 				ovl_intput_format_name(ovl_input_fmt_convert
-						       (pConfig->ovl_config[i].fmt),
+						       (cfg->fmt),
 						       ovl_input_fmt_byte_swap(ovl_input_fmt_convert
-									       (pConfig->
-										ovl_config[i].
-										fmt))),
-				pConfig->ovl_config[i].addr, pConfig->ovl_config[i].src_x,
-				pConfig->ovl_config[i].src_y, pConfig->ovl_config[i].src_pitch,
-				pConfig->ovl_config[i].dst_x, pConfig->ovl_config[i].dst_y,
-				pConfig->ovl_config[i].dst_w, pConfig->ovl_config[i].dst_h);
+									       (cfg->fmt))),
+				cfg->addr, cfg->src_x,
+				cfg->src_y, cfg->src_pitch,
+				cfg->dst_x, cfg->dst_y,
+				cfg->dst_w, cfg->dst_h);
 			MMProfileLogEx(ddp_mmp_get_events()->ovl_enable, MMProfileFlagPulse,
 				       ((module - DISP_MODULE_OVL0) << 4) + (i % 4),
-				       pConfig->ovl_config[i].addr);
+				       cfg->addr);
 		} else {
 			/* from enable to disable */
 			if (DISP_REG_GET
@@ -1167,9 +1194,9 @@ static int ovl_config_l(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig,
 					       ((module - DISP_MODULE_OVL0) << 4) + (i % 4), 0);
 			}
 		}
-		ovl_layer_switch(module, i % 4, pConfig->ovl_config[i].layer_en, handle);
+		ovl_layer_switch(module, i % 4, cfg->layer_en, handle);
 
-		if (pConfig->ovl_config[i].layer_en == 1)
+		if (cfg->layer_en == 1)
 			layer_enable |= (1 << (i % 4));
 	}
 
@@ -651,8 +651,9 @@ static int do_rdma_config_l(DISP_MODULE_ENUM module, disp_ddp_path_config *pConf
 	RDMA_CONFIG_STRUCT *r_config = &pConfig->rdma_config;
 	enum RDMA_MODE mode = rdma_config_mode(r_config->address);
 	LCM_PARAMS *lcm_param = &(pConfig->dispif_config);
-	unsigned int width = pConfig->dst_dirty ? pConfig->dst_w : r_config->width;
-	unsigned int height = pConfig->dst_dirty ? pConfig->dst_h : r_config->height;
+	bool resize = pConfig->dst_dirty || pConfig->partial_dirty;
+	unsigned int width = resize ? ddp_path_roi_w(pConfig) : r_config->width;
+	unsigned int height = resize ? ddp_path_roi_h(pConfig) : r_config->height;
 
 	if (pConfig->fps)
 		rdma_fps[rdma_index(module)] = pConfig->fps / 100;
@@ -733,7 +734,7 @@ static int setup_rdma_sec(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig
 
 static int rdma_config_l(DISP_MODULE_ENUM module, disp_ddp_path_config *pConfig, void *handle)
 {
-	if (pConfig->dst_dirty || pConfig->rdma_dirty) {
+	if (pConfig->dst_dirty || pConfig->rdma_dirty || pConfig->partial_dirty) {
 		setup_rdma_sec(module, pConfig, handle);
 		do_rdma_config_l(module, pConfig, handle);
 	}
@@ -530,6 +530,7 @@ int _ioctl_trigger_session(unsigned long arg)
 		}
 		primary_display_merge_session_cmd(&config);
 		primary_display_trigger(0, NULL, 0);
+		dprec_frame_stage(DPREC_FRAME_TRIGGER, config.present_fence_idx);
 	} else if (DISP_SESSION_TYPE(session_id) == DISP_SESSION_EXTERNAL) {
 #if defined(CONFIG_MTK_HDMI_SUPPORT) || defined(CONFIG_MTK_EPD_SUPPORT)
 		mutex_lock(&disp_session_lock);
@@ -1489,7 +1490,9 @@ int _ioctl_set_input_buffer(unsigned long arg)
 		     DISP_SESSION_DEV(session_id), session_input.config_layer_num);
 
 	if (DISP_SESSION_TYPE(session_id) == DISP_SESSION_PRIMARY) {
+		dprec_frame_stage(DPREC_FRAME_QUEUE, 0);
 		ret = set_primary_buffer(&session_input);
+		dprec_frame_stage(DPREC_FRAME_CONFIG, 0);
 	} else if (DISP_SESSION_TYPE(session_id) == DISP_SESSION_EXTERNAL) {
 		ret = set_external_buffer(&session_input);
 	} else if (DISP_SESSION_TYPE(session_id) == DISP_SESSION_MEMORY) {
@@ -1772,6 +1775,8 @@ int _ioctl_get_display_caps(unsigned long arg)
 #ifdef OVL_TIME_SHARING
 	caps_info.disp_feature |= DISP_FEATURE_TIME_SHARING;
 #endif
+	if (primary_display_is_partial_update_supported())
+		caps_info.disp_feature |= DISP_FEATURE_PARTIAL_UPDATE;
 
 	DISPMSG("%s mode:%d, pass:%d, max_layer_num:%d\n",
 		__func__, caps_info.output_mode, caps_info.output_pass, caps_info.max_layer_num);
@@ -1852,6 +1857,24 @@ int _ioctl_insert_session_buffers(unsigned long arg)
 	return ret;
 }
 
+int _ioctl_set_dirty_roi(unsigned long arg)
+{
+	void __user *argp = (void __user *)arg;
+	disp_session_dirty_roi dirty;
+
+	if (copy_from_user(&dirty, argp, sizeof(dirty))) {
+		DISPMSG("[FB]: copy_from_user failed! line:%d\n", __LINE__);
+		return -EFAULT;
+	}
+
+	if (DISP_SESSION_TYPE(dirty.session_id) != DISP_SESSION_PRIMARY)
+		return -EINVAL;
+	if (dirty.roi_num > DISP_DIRTY_ROI_MAX)
+		return -EINVAL;
+
+	return primary_display_set_dirty_roi(dirty.roi, dirty.roi_num);
+}
+
 static DISP_MODE select_session_mode(disp_session_config *session_info)
 {
 	static DISP_MODE final_mode = DISP_SESSION_DIRECT_LINK_MODE;
@@ -1957,6 +1980,8 @@ const char *_session_ioctl_spy(unsigned int cmd)
 		return "DISP_IOCTL_GET_SESSION_INFO";
 	case DISP_IOCTL_INSERT_SESSION_BUFFERS:
 		return "DISP_IOCTL_INSERT_SESSION_BUFFERS";
+	case DISP_IOCTL_SET_DIRTY_ROI:
+		return "DISP_IOCTL_SET_DIRTY_ROI";
 	case DISP_IOCTL_AAL_EVENTCTL:
 		return "DISP_IOCTL_AAL_EVENTCTL";
 	case DISP_IOCTL_AAL_GET_HIST:
@@ -2061,6 +2086,8 @@ long mtk_disp_mgr_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 		return primary_display_get_lcm_index();
 	case DISP_IOCTL_INSERT_SESSION_BUFFERS:
 		return _ioctl_insert_session_buffers(arg);
+	case DISP_IOCTL_SET_DIRTY_ROI:
+		return _ioctl_set_dirty_roi(arg);
 	case DISP_IOCTL_AAL_EVENTCTL:
 	case DISP_IOCTL_AAL_GET_HIST:
 	case DISP_IOCTL_AAL_INIT_REG:
@@ -12,12 +12,15 @@
 #include <linux/vmalloc.h>
 #include <linux/slab.h>
 #include <linux/switch.h>
+#include <linux/workqueue.h>
+#include <linux/input.h>
 
 #include "disp_drv_platform.h"
 #include "ion_drv.h"
 #include "mtk_ion.h"
 
 #include "m4u.h"
+#include <mt-plat/mt_cache_sync.h>
 
 #include "mt_idle.h"
 #include "mt_spm_idle.h"
@@ -70,6 +73,7 @@
 
 #include "disp_assert_layer.h"
 #include "ddp_dsi.h"
+#include "ddp_aal.h"
 #include "mtk_disp_mgr.h"
 #include "ddp_wdma.h"
 #include "ddp_wdma_ex.h"
@@ -455,7 +459,7 @@ static int _disp_primary_path_dsi_clock_off(unsigned int level)
 	return 0;
 }
 
-int _disp_primary_path_set_vfp(int enter)
+int _disp_primary_path_set_vfp(unsigned int vfp)
 {
 	int ret = 0;
 
@@ -471,14 +475,11 @@ int _disp_primary_path_set_vfp(int enter)
 		DISPCHECK("primary set vfp, handle=%p\n", cmdq_handle_vfp);
 		cmdqRecReset(cmdq_handle_vfp);
 		_cmdq_insert_wait_frame_done_token_mira(cmdq_handle_vfp);
-		if (enter)
-			dpmgr_path_ioctl(pgc->dpmgr_handle, cmdq_handle_vfp, DDP_DSI_VFP_LP,
-					 (unsigned long *)&(lcm_param->dsi.vertical_vfp_lp));
-		else
-			dpmgr_path_ioctl(pgc->dpmgr_handle, cmdq_handle_vfp, DDP_DSI_VFP_LP,
-					 (unsigned long *)&(lcm_param->dsi.vertical_frontporch));
+		dpmgr_path_ioctl(pgc->dpmgr_handle, cmdq_handle_vfp, DDP_DSI_VFP_LP,
+				 (unsigned long *)&vfp);
 
-		MMProfileLogEx(ddp_mmp_get_events()->dal_clean, MMProfileFlagPulse, 0, enter);
+		MMProfileLogEx(ddp_mmp_get_events()->dal_clean, MMProfileFlagPulse, 0,
+			       vfp != lcm_param->dsi.vertical_frontporch);
 
 		_cmdq_flush_config_handle_mira(cmdq_handle_vfp, 1);
 		DISPCHECK("[VFP]cmdq_handle_vfp ret=%d\n", ret);
@@ -491,129 +492,324 @@ int _disp_primary_path_set_vfp(int enter)
 	return ret;
 }
 
-int primary_display_save_power_for_idle(int enter, unsigned int need_primary_lock)
-{
-	static unsigned int isLowPowerMode;
+/*
+ * Automatic decouple
+ *
+ * In direct link OVL fetches every layer for every refresh of a video mode
+ * panel; in decouple it blends them into the DC buffer once per update and
+ * RDMA reads that at the panel rate.  With several large layers updating
+ * slower than the panel, e.g. a video under the UI, decouple moves less:
+ *
+ *   DL: layers * refresh	DC: (layers + frame) * update + frame * refresh
+ *
+ * The estimate follows the configured layers and the update interval.  The
+ * path goes to decouple once it is gAutoDecouplePercent under direct link
+ * for DISP_AUTO_DC_FRAMES frames in a row, and back once it is not under
+ * for as many, so a few odd frames do not make it switch back and forth.
+ * A mode set by HWC or anyone else wins; a direct link request does not
+ * end a decouple the estimate chose.
+ */
+#define DISP_AUTO_DC_FRAMES	16
 
-	if (is_hwc_enabled == 0)
-		return 0;
+static struct {
+	int active;		/* in decouple because of the estimate */
+	int streak;		/* frames in a row in favour of the other mode */
+	unsigned long long last_update;
+	unsigned int interval_us;
+	unsigned long long dl_bw;	/* bytes/s */
+	unsigned long long dc_bw;
+	unsigned int switch_cnt;
+} auto_dc;
 
-	if (need_primary_lock)	/* if outer api has add primary lock, do not have to lock again */
-		_primary_path_lock(__func__);
+static void _primary_path_auto_dc_note(disp_ddp_path_config *data_config)
+{
+	unsigned long long now = sched_clock(), delta = now - auto_dc.last_update;
+	unsigned int delta_us = delta > NSEC_PER_SEC ? USEC_PER_SEC : (unsigned int)delta / 1000;
+	unsigned long long layer_bytes = 0, frame_bytes;
+	unsigned int refresh, update, i;
 
-	if (primary_get_state() == DISP_SLEPT) {
-		DISPMSG("suspend mode can not enable low power.\n");
-		goto end;
+	for (i = 0; i < HW_OVERLAY_COUNT; i++) {
+		OVL_CONFIG_STRUCT *cfg = &data_config->ovl_config[i];
+
+		if (!cfg->layer_en || cfg->source != OVL_LAYER_SOURCE_MEM)
+			continue;
+		layer_bytes += (unsigned long long)cfg->dst_w * cfg->dst_h *
+			       DP_COLOR_BITS_PER_PIXEL(cfg->fmt) / 8;
 	}
-	if (enter == 1 && isLowPowerMode == 1) {
-		DISPMSG("already in low power mode.\n");
-		goto end;
+	frame_bytes = (unsigned long long)primary_display_get_width() *
+		      primary_display_get_height() * primary_display_get_dc_bpp() / 8;
+
+	auto_dc.last_update = now;
+	auto_dc.interval_us = (auto_dc.interval_us * 3 + delta_us) / 4;
+
+	refresh = pgc->lcm_fps ? pgc->lcm_fps / 100 : 60;
+	update = auto_dc.interval_us ? USEC_PER_SEC / auto_dc.interval_us : refresh;
+	update = min(update, refresh);
+
+	auto_dc.dl_bw = layer_bytes * refresh;
+	auto_dc.dc_bw = (layer_bytes + frame_bytes) * update + frame_bytes * refresh;
+}
+
+static int _primary_path_auto_dc_allowed(void)
+{
+#ifdef DISP_HW_MODE_CAP
+	if (DISP_HW_MODE_CAP == DISP_OUTPUT_CAP_SWITCHABLE)
+		return gAutoDecouplePercent && primary_display_is_video_mode() &&
+		       primary_display_cmdq_enabled();
+#endif
+	return 0;
+}
+
+/* called with the primary lock held, before the input of a frame is configured */
+static void _primary_path_auto_dc_select(void)
+{
+	int allowed = _primary_path_auto_dc_allowed(), to;
+
+	if (pgc->session_mode == DISP_SESSION_DIRECT_LINK_MODE) {
+		if (!allowed || !auto_dc.dl_bw || auto_dc.dc_bw * 100 >=
+		    auto_dc.dl_bw * (100 - min_t(unsigned long, gAutoDecouplePercent, 100))) {
+			auto_dc.streak = 0;
+			return;
+		}
+		to = DISP_SESSION_DECOUPLE_MODE;
+	} else if (pgc->session_mode == DISP_SESSION_DECOUPLE_MODE && auto_dc.active) {
+		if (allowed && auto_dc.dc_bw < auto_dc.dl_bw) {
+			auto_dc.streak = 0;
+			return;
+		}
+		/* turned off: back at once */
+		if (!allowed)
+			auto_dc.streak = DISP_AUTO_DC_FRAMES;
+		to = DISP_SESSION_DIRECT_LINK_MODE;
+	} else {
+		auto_dc.streak = 0;
+		return;
 	}
-	if (enter == 0 && isLowPowerMode == 0) {
-		DISPMSG("already not in low power mode.\n");
-		goto end;
+
+	if (++auto_dc.streak < DISP_AUTO_DC_FRAMES)
+		return;
+
+	DISPMSG("auto decouple: %s, dl %lluKB/s dc %lluKB/s\n",
+		to == DISP_SESSION_DECOUPLE_MODE ? "enter" : "leave",
+		auto_dc.dl_bw >> 10, auto_dc.dc_bw >> 10);
+	auto_dc.streak = 0;
+	auto_dc.active = 0;
+	primary_display_switch_mode_nolock(to, pgc->session_id, 1);
+	if (to == DISP_SESSION_DECOUPLE_MODE && pgc->session_mode == DISP_SESSION_DECOUPLE_MODE)
+		auto_dc.active = 1;
+	auto_dc.switch_cnt++;
+}
+
+static int _primary_path_auto_dc_show(char *stringbuf, int buf_len)
+{
+	return scnprintf(stringbuf, buf_len,
+			 "|auto dc=%d allowed=%d margin=%lu%% dl=%lluKB/s dc=%lluKB/s interval=%dus streak=%d switch=%u\n",
+			 auto_dc.active, _primary_path_auto_dc_allowed(), gAutoDecouplePercent,
+			 auto_dc.dl_bw >> 10, auto_dc.dc_bw >> 10, auto_dc.interval_us,
+			 auto_dc.streak, auto_dc.switch_cnt);
+}
+
+/*
+ * Idle policy
+ *
+ * The idle detect thread used to apply every low power technique at once a
+ * fixed time after the last frame, whatever the content.  It now picks a
+ * level from the recent frame update rate:
+ *
+ *  ACTIVE	frames closer than DISP_IDLE_LOW_RATE_US apart
+ *  LOW_RATE	steady updates slower than that, e.g. video at 30fps or a
+ *		blinking cursor: only the mmdvfs vote drops, which is free to
+ *		take back on the next fast frame
+ *  STATIC	no frame for the idle time: VFP, OVL removal, clock gating and
+ *		the mmdvfs vote, as enabled by disp_low_power_*
+ *
+ * STATIC only uses the techniques whose exit latencies fit gIdleExitBudgetUs
+ * together, most power saving first, so the wake-up cost of the first frame
+ * after idle is bounded up front.  The measured exit latency and the time
+ * spent at each level are part of the debug state.
+ *
+ * The VFP technique steps the panel refresh down: STATIC starts at
+ * disp_idle_refresh_fps[0] and goes one entry further every
+ * DISP_IDLE_REFRESH_STEP_MS the screen stays static, by stretching the
+ * front porch of the panel timing.  A new frame puts the panel rate back
+ * with the rest of the level; so does a touch, before its frame comes.
+ */
+enum disp_idle_level {
+	DISP_IDLE_ACTIVE,
+	DISP_IDLE_LOW_RATE,
+	DISP_IDLE_STATIC,
+	DISP_IDLE_NR,
+};
+
+#define DISP_IDLE_TECH_DECOUPLE	(1 << 0)
+#define DISP_IDLE_TECH_CLOCK	(1 << 1)
+#define DISP_IDLE_TECH_VFP	(1 << 2)
+#define DISP_IDLE_TECH_MMDVFS	(1 << 3)
+
+#define DISP_IDLE_LOW_RATE_US	25000
+#define DISP_IDLE_SAMPLE_MS	100
+#define DISP_IDLE_REFRESH_STEP_MS	1000
+
+static const unsigned int disp_idle_refresh_fps[] = { 45, 30 };
+
+static const char * const disp_idle_level_name[DISP_IDLE_NR] = {
+	"active", "low_rate", "static",
+};
+
+/* worst exit latency of each technique, in the order STATIC picks them */
+static const struct {
+	unsigned int tech;
+	unsigned int exit_us;
+} disp_idle_tech_cost[] = {
+	{ DISP_IDLE_TECH_DECOUPLE,	34000 },	/* back to direct link, two frames */
+	{ DISP_IDLE_TECH_CLOCK,		1000 },
+	{ DISP_IDLE_TECH_VFP,		17000 },	/* waits for one frame done */
+	{ DISP_IDLE_TECH_MMDVFS,	1000 },
+};
+
+/* level and tech are changed with the primary path lock held */
+static struct {
+	enum disp_idle_level level;
+	unsigned int tech;		/* techniques in effect */
+	unsigned long long level_enter;
+	unsigned long long time_in[DISP_IDLE_NR];
+	unsigned int enter_cnt[DISP_IDLE_NR];
+	unsigned long long last_update;
+	unsigned int last_interval_us;
+	unsigned int interval_us;	/* running average between frames */
+	unsigned int exit_us;
+	unsigned int exit_max_us;
+	unsigned int refresh_step;	/* 0: panel rate, else disp_idle_refresh_fps[step - 1] */
+} idle_policy;
+
+static void _disp_primary_path_idle_note_update(unsigned long long now)
+{
+	unsigned long long delta = now - idle_policy.last_update;
+	unsigned int delta_us = delta > NSEC_PER_SEC ? USEC_PER_SEC : (unsigned int)delta / 1000;
+
+	idle_policy.last_update = now;
+	idle_policy.last_interval_us = delta_us;
+	idle_policy.interval_us = (idle_policy.interval_us * 3 + delta_us) / 4;
+}
+
+static unsigned int _disp_primary_path_idle_level_tech(enum disp_idle_level level)
+{
+	unsigned int tech = 0, cost = 0, i;
+
+	if (level == DISP_IDLE_LOW_RATE)
+		return DISP_IDLE_TECH_MMDVFS;
+	if (level != DISP_IDLE_STATIC)
+		return 0;
+
+	if (primary_display_is_video_mode()) {
+		if (disp_low_power_remove_ovl == 1)
+			tech |= DISP_IDLE_TECH_DECOUPLE;
+		if (disp_low_power_enlarge_blanking == 1)
+			tech |= DISP_IDLE_TECH_VFP;
+	} else if (disp_low_power_disable_ddp_clock == 1) {
+		tech |= DISP_IDLE_TECH_CLOCK;
 	}
-	isLowPowerMode = enter;
+	tech |= DISP_IDLE_TECH_MMDVFS;
 
-	if (pgc->plcm == NULL) {
-		DISPERR("lcm handle is null\n");
-		goto end;
+	for (i = 0; i < ARRAY_SIZE(disp_idle_tech_cost); i++) {
+		if (!(tech & disp_idle_tech_cost[i].tech))
+			continue;
+		if (cost + disp_idle_tech_cost[i].exit_us > gIdleExitBudgetUs)
+			tech &= ~disp_idle_tech_cost[i].tech;
+		else
+			cost += disp_idle_tech_cost[i].exit_us;
 	}
 
-	DISPMSG("low power in, enter=%d.\n", enter);
+	return tech;
+}
 
-	if (disp_low_power_enlarge_blanking == 1) {
-#if 0
-		if (pgc->plcm->params) {
-			vfp_for_low_power = pgc->plcm->params->dsi.vertical_frontporch_for_low_power;
-			vfp_original = pgc->plcm->params->dsi.vertical_frontporch;
-		}
+static void _disp_primary_path_set_refresh_step(unsigned int step)
+{
+	LCM_PARAMS *lcm_param = disp_lcm_get_params(pgc->plcm);
+	unsigned int fps = pgc->lcm_fps / 100;
+	unsigned int vfp, vtotal;
 
-		if (enter)
-			DISP_REG_SET(pgc->cmdq_handle_config, dispsys_reg[DISP_REG_DSI0] + DISP_DSI_REG_VFP,
-				     vfp_for_low_power);
-		else
-			DISP_REG_SET(pgc->cmdq_handle_config, dispsys_reg[DISP_REG_DSI0] + DISP_DSI_REG_VFP,
-				     vfp_original);
-#else
-		if (primary_display_is_video_mode() == 1)
-			_disp_primary_path_set_vfp(enter);
+	step = min_t(unsigned int, step, ARRAY_SIZE(disp_idle_refresh_fps));
+	if (step == idle_policy.refresh_step)
+		return;
 
-#endif
-	}
+	vfp = lcm_param->dsi.vertical_frontporch;
+	vtotal = lcm_param->dsi.vertical_sync_active + lcm_param->dsi.vertical_backporch +
+		 lcm_param->dsi.vertical_active_line + vfp;
+	if (step && !fps)	/* panel rate unknown, the panel's own low power VFP */
+		vfp = lcm_param->dsi.vertical_vfp_lp;
+	else if (step && fps > disp_idle_refresh_fps[step - 1])
+		vfp = vtotal * fps / disp_idle_refresh_fps[step - 1] - (vtotal - vfp);
+
+	DISPMSG("idle refresh step %d -> %d, vfp=%d.\n", idle_policy.refresh_step, step, vfp);
+	if (_disp_primary_path_set_vfp(vfp) == 0)
+		idle_policy.refresh_step = step;
+}
+
+static void _disp_primary_path_idle_tech(unsigned int tech, int enter)
+{
+	if (tech & DISP_IDLE_TECH_VFP)
+		_disp_primary_path_set_refresh_step(enter ? 1 : 0);
 
-	if (1 == disp_low_power_disable_ddp_clock) {/* open */
-		if (primary_display_is_video_mode() == 0 /* && gEnableLowPowerFeature==1 */) {
-			static unsigned int disp_low_power_disable_ddp_clock_cnt;
+	if (tech & DISP_IDLE_TECH_CLOCK) {
+		static unsigned int disp_low_power_disable_ddp_clock_cnt;
 
-			DISPDBG("MM clock, disp_low_power_disable_ddp_clock enter %d.\n",
-				disp_low_power_disable_ddp_clock_cnt++);
-			if (1 == enter)	{ /* only for command mode */
-				if (isIdlePowerOff == 0) {
-					/* extern void clk_stat_bug(void); */
-					unsigned long flags;
+		DISPDBG("MM clock, disp_low_power_disable_ddp_clock enter %d.\n",
+			disp_low_power_disable_ddp_clock_cnt++);
+		if (1 == enter)	{ /* only for command mode */
+			if (isIdlePowerOff == 0) {
+				unsigned long flags;
 
-					DISPMSG("off MM clock start.\n");
-					spin_lock_irqsave(&gLockTopClockOff, flags);
-					_disp_primary_path_idle_clock_off(0); /* parameter represent level */
-					isIdlePowerOff = 1;
-					spin_unlock_irqrestore(&gLockTopClockOff, flags);
+				DISPMSG("off MM clock start.\n");
+				spin_lock_irqsave(&gLockTopClockOff, flags);
+				_disp_primary_path_idle_clock_off(0); /* parameter represent level */
+				isIdlePowerOff = 1;
+				spin_unlock_irqrestore(&gLockTopClockOff, flags);
 #ifndef CONFIG_MTK_CLKMGR
-					ddp_clk_unprepare(DISP_MTCMOS_CLK);
+				ddp_clk_unprepare(DISP_MTCMOS_CLK);
 #endif
-					/* DISPMSG("off MM clock end.\n"); */
-					DISPMSG("***start dump regs! clk_stat_check\n");
+				DISPMSG("***start dump regs! clk_stat_check\n");
 #ifdef CONFIG_MTK_CLKMGR
-					clk_stat_check(SYS_DIS);
+				clk_stat_check(SYS_DIS);
 #endif
-					/*DISPMSG("---- start dump regs! clk_stat_bug.\n"); */
-					/* clk_stat_bug(); */
-				}
-			} else {
-				if (isIdlePowerOff == 1) {
-					unsigned long flags;
+			}
+		} else {
+			if (isIdlePowerOff == 1) {
+				unsigned long flags;
 
-					DISPMSG("on MM clock start.\n");
+				DISPMSG("on MM clock start.\n");
 #ifndef CONFIG_MTK_CLKMGR
-					ddp_clk_prepare(DISP_MTCMOS_CLK);
+				ddp_clk_prepare(DISP_MTCMOS_CLK);
 #endif
-					spin_lock_irqsave(&gLockTopClockOff, flags);
-					isIdlePowerOff = 0;
-					_disp_primary_path_idle_clock_on(0); /* parameter represent level */
-					spin_unlock_irqrestore(&gLockTopClockOff, flags);
-					DISPMSG("on MM clock end.\n");
-				}
-
+				spin_lock_irqsave(&gLockTopClockOff, flags);
+				isIdlePowerOff = 0;
+				_disp_primary_path_idle_clock_on(0); /* parameter represent level */
+				spin_unlock_irqrestore(&gLockTopClockOff, flags);
+				DISPMSG("on MM clock end.\n");
 			}
 		}
 	}
 
-	if (disp_low_power_disable_fence_thread == 1)
-		; /* already implemented. */
-
 	/* no need idle lock, cause primary lock will be used inside switch_mode */
-	if (disp_low_power_remove_ovl == 1) {
-		if (primary_display_is_video_mode() == 1) {/* only for video mode */
-			/* DISPMSG("[LP] OVL pgc->session_mode=%d, enter=%d\n", pgc->session_mode, enter); */
-			if (enter) {
-				if (pgc->session_mode == DISP_SESSION_DIRECT_LINK_MODE) {
-					DISPDBG("[LP]remove ovl.\n");
-					primary_display_switch_mode_nolock(DISP_SESSION_DECOUPLE_MODE,
-									   pgc->session_id, 1);
-				}
-				/* DISPMSG("disp_low_power_remove_ovl 2\n"); */
-			} else {
-				if (pgc->session_mode == DISP_SESSION_DECOUPLE_MODE) {
-					DISPDBG("[LP]add ovl.\n");
-					primary_display_switch_mode_nolock(DISP_SESSION_DIRECT_LINK_MODE,
-									   pgc->session_id, 1);
-				}
-				/* DISPMSG("disp_low_power_remove_ovl 4\n"); */
+	if (tech & DISP_IDLE_TECH_DECOUPLE) {
+		if (enter) {
+			if (pgc->session_mode == DISP_SESSION_DIRECT_LINK_MODE) {
+				DISPDBG("[LP]remove ovl.\n");
+				primary_display_switch_mode_nolock(DISP_SESSION_DECOUPLE_MODE,
+								   pgc->session_id, 1);
+			}
+		} else {
+			/* a decouple chosen for the bandwidth stays */
+			if (pgc->session_mode == DISP_SESSION_DECOUPLE_MODE && !auto_dc.active) {
+				DISPDBG("[LP]add ovl.\n");
+				primary_display_switch_mode_nolock(DISP_SESSION_DIRECT_LINK_MODE,
+								   pgc->session_id, 1);
 			}
 		}
 	}
 
-	if (is_mmdvfs_supported() && mmdvfs_get_mmdvfs_profile() == MMDVFS_PROFILE_D1_PLUS) {
+	if ((tech & DISP_IDLE_TECH_MMDVFS) && is_mmdvfs_supported() &&
+	    mmdvfs_get_mmdvfs_profile() == MMDVFS_PROFILE_D1_PLUS) {
 		if (_primary_path_IsForcedHPM(0) == false) {
 			DISPMSG("MMDVFS enter:%d\n", enter);
 			if (enter)
@@ -625,8 +821,58 @@ int primary_display_save_power_for_idle(int enter, unsigned int need_primary_loc
 			mmdvfs_set_step(MMDVFS_SCEN_DISP, MMDVFS_VOLTAGE_HIGH); /* Enter HPM mode */
 		}
 	}
+}
+
+static int _disp_primary_path_set_idle_level(enum disp_idle_level level,
+					     unsigned int need_primary_lock)
+{
+	unsigned long long start;
+	unsigned int tech;
+
+	if (is_hwc_enabled == 0)
+		return 0;
+
+	if (need_primary_lock)	/* if outer api has add primary lock, do not have to lock again */
+		_primary_path_lock(__func__);
+
+	if (primary_get_state() == DISP_SLEPT) {
+		DISPMSG("suspend mode can not enable low power.\n");
+		goto end;
+	}
+	if (level == idle_policy.level) {
+		DISPMSG("already in idle level %s.\n", disp_idle_level_name[level]);
+		goto end;
+	}
+
+	if (pgc->plcm == NULL) {
+		DISPERR("lcm handle is null\n");
+		goto end;
+	}
+
+	DISPMSG("idle level %s -> %s.\n", disp_idle_level_name[idle_policy.level],
+		disp_idle_level_name[level]);
+
+	tech = _disp_primary_path_idle_level_tech(level);
+	start = sched_clock();
+
+	/* take back what the new level does not use, then apply what it adds */
+	_disp_primary_path_idle_tech(idle_policy.tech & ~tech, 0);
+	_disp_primary_path_idle_tech(tech & ~idle_policy.tech, 1);
+
+	if (level < idle_policy.level) {
+		idle_policy.exit_us = (unsigned int)((sched_clock() - start) / 1000);
+		idle_policy.exit_max_us = max(idle_policy.exit_max_us, idle_policy.exit_us);
+	}
+
+	if (idle_policy.level_enter)
+		idle_policy.time_in[idle_policy.level] += start - idle_policy.level_enter;
+	idle_policy.level_enter = start;
+	idle_policy.enter_cnt[level]++;
+	idle_policy.level = level;
+	idle_policy.tech = tech;
+
 end:
-	if (enter)
+	if (level == DISP_IDLE_STATIC)
 		atomic_set(&isDdp_Idle, 1);
 
 	if (need_primary_lock)
@@ -635,6 +881,38 @@ end:
 	return 0;
 }
 
+int primary_display_save_power_for_idle(int enter, unsigned int need_primary_lock)
+{
+	return _disp_primary_path_set_idle_level(enter ? DISP_IDLE_STATIC : DISP_IDLE_ACTIVE,
+						 need_primary_lock);
+}
+
+static int _disp_primary_path_idle_policy_show(char *stringbuf, int buf_len)
+{
+	unsigned long long now = sched_clock();
+	int len = 0, i;
+
+	len += scnprintf(stringbuf + len, buf_len - len,
+			 "|idle level=%s tech=0x%x interval=%dus exit=%dus exit_max=%dus budget=%luus\n",
+			 disp_idle_level_name[idle_policy.level], idle_policy.tech,
+			 idle_policy.interval_us, idle_policy.exit_us, idle_policy.exit_max_us,
+			 gIdleExitBudgetUs);
+	len += scnprintf(stringbuf + len, buf_len - len, "|idle refresh=%dHz\n",
+			 idle_policy.refresh_step ?
+			 disp_idle_refresh_fps[idle_policy.refresh_step - 1] : pgc->lcm_fps / 100);
+	for (i = 0; i < DISP_IDLE_NR; i++) {
+		unsigned long long t = idle_policy.time_in[i];
+
+		if (i == idle_policy.level && idle_policy.level_enter)
+			t += now - idle_policy.level_enter;
+		len += scnprintf(stringbuf + len, buf_len - len, "|idle %-8s cnt=%d time=%llums\n",
+				 disp_idle_level_name[i], idle_policy.enter_cnt[i],
+				 t / NSEC_PER_MSEC);
+	}
+
+	return len;
+}
+
 #if defined(CONFIG_MTK_GMO_RAM_OPTIMIZE)
 static int release_idle_lp_dc_buffer(unsigned int need_primary_lock);
 static int allocate_idle_lp_dc_buffer(void);
@@ -668,6 +946,99 @@ void disp_exit_idle_ex(const char *caller)
 	}
 }
 
+/* one refresh step further down while the screen stays static */
+static void _disp_primary_path_idle_refresh_down(void)
+{
+	_primary_path_esd_check_lock();
+	_primary_path_lock(__func__);
+	if (primary_get_state() == DISP_ALIVE && atomic_read(&isDdp_Idle) == 1 &&
+	    idle_policy.level == DISP_IDLE_STATIC && (idle_policy.tech & DISP_IDLE_TECH_VFP))
+		_disp_primary_path_set_refresh_step(idle_policy.refresh_step + 1);
+	_primary_path_unlock(__func__);
+	_primary_path_esd_check_unlock();
+}
+
+static long _disp_primary_path_idle_refresh_timeout(void)
+{
+	if (idle_policy.refresh_step && idle_policy.refresh_step < ARRAY_SIZE(disp_idle_refresh_fps))
+		return msecs_to_jiffies(DISP_IDLE_REFRESH_STEP_MS);
+	return MAX_SCHEDULE_TIMEOUT;
+}
+
+/*
+ * A touch usually comes before new content: put the panel rate back now
+ * rather than on the first frame, and restart the idle time from here.
+ */
+static void _disp_primary_path_idle_touch_work(struct work_struct *work)
+{
+	disp_update_trigger_time();
+	_disp_primary_path_exit_idle("touch", 1);
+}
+
+static DECLARE_WORK(disp_idle_touch_work, _disp_primary_path_idle_touch_work);
+
+static void disp_idle_touch_event(struct input_handle *handle, unsigned int type,
+				  unsigned int code, int value)
+{
+	if (type == EV_KEY && code == BTN_TOUCH && value && idle_policy.refresh_step)
+		schedule_work(&disp_idle_touch_work);
+}
+
+static int disp_idle_touch_connect(struct input_handler *handler, struct input_dev *dev,
+				   const struct input_device_id *id)
+{
+	struct input_handle *handle;
+	int error;
+
+	handle = kzalloc(sizeof(struct input_handle), GFP_KERNEL);
+	if (!handle)
+		return -ENOMEM;
+
+	handle->dev = dev;
+	handle->handler = handler;
+	handle->name = "disp_idle";
+
+	error = input_register_handle(handle);
+	if (error)
+		goto err2;
+
+	error = input_open_device(handle);
+	if (error)
+		goto err1;
+
+	return 0;
+err1:
+	input_unregister_handle(handle);
+err2:
+	kfree(handle);
+	return error;
+}
+
+static void disp_idle_touch_disconnect(struct input_handle *handle)
+{
+	input_close_device(handle);
+	input_unregister_handle(handle);
+	kfree(handle);
+}
+
+/* touchscreens only */
+static const struct input_device_id disp_idle_touch_ids[] = {
+	{
+		.flags = INPUT_DEVICE_ID_MATCH_EVBIT | INPUT_DEVICE_ID_MATCH_ABSBIT,
+		.evbit = { BIT_MASK(EV_ABS) },
+		.absbit = { [BIT_WORD(ABS_MT_POSITION_X)] = BIT_MASK(ABS_MT_POSITION_X) },
+	},
+	{},
+};
+
+static struct input_handler disp_idle_touch_handler = {
+	.event = disp_idle_touch_event,
+	.connect = disp_idle_touch_connect,
+	.disconnect = disp_idle_touch_disconnect,
+	.name = "disp_idle",
+	.id_table = disp_idle_touch_ids,
+};
+
 static int _disp_primary_path_idle_detect_thread(void *data)
 {
 	int ret = 0, idle_time;
@@ -682,7 +1053,9 @@ static int _disp_primary_path_idle_detect_thread(void *data)
 #endif
 
 	while (1) {
-		msleep(idle_time); /* 0.5s trigger once */
+		unsigned long long since_us;
+
+		msleep(DISP_IDLE_SAMPLE_MS);
 		/* DISPMSG("[ddp_idle]_disp_primary_path_idle_detect start 1\n"); */
 
 		if (gSkipIdleDetect || atomic_read(&isDdp_Idle) == 1 ||
@@ -706,7 +1079,8 @@ static int _disp_primary_path_idle_detect_thread(void *data)
 		_primary_path_unlock(__func__);
 		/* _disp_primary_idle_lock(); */
 		_primary_path_esd_check_lock();
-		if (((sched_clock() - last_primary_trigger_time) / 1000) > idle_time * 1000) {
+		since_us = (sched_clock() - last_primary_trigger_time) / 1000;
+		if (since_us > idle_time * 1000) {
 #if defined(CONFIG_MTK_GMO_RAM_OPTIMIZE)
 			/* Dynamically allocate decouple buffer. */
 			if (primary_display_is_video_mode()) {
@@ -728,13 +1102,23 @@ static int _disp_primary_path_idle_detect_thread(void *data)
 			_primary_path_esd_check_unlock();
 		} else {
 			/* _disp_primary_idle_unlock(); */
+			/* still updating, but slowly and steadily */
+			if (idle_policy.level == DISP_IDLE_ACTIVE &&
+			    idle_policy.interval_us >= DISP_IDLE_LOW_RATE_US &&
+			    idle_policy.last_interval_us >= DISP_IDLE_LOW_RATE_US &&
+			    since_us < 2 * idle_policy.interval_us)
+				_disp_primary_path_set_idle_level(DISP_IDLE_LOW_RATE, 1);
 			_primary_path_set_dvfsHPM(false, 0);
 			_primary_path_esd_check_unlock();
 			continue;
 		}
 		/* _disp_primary_idle_unlock(); */
 
-		ret = wait_event_interruptible(idle_detect_wq, (atomic_read(&idle_detect_flag) != 0));
+		/* step the refresh down until something happens */
+		while (wait_event_interruptible_timeout(idle_detect_wq,
+				(atomic_read(&idle_detect_flag) != 0),
+				_disp_primary_path_idle_refresh_timeout()) == 0)
+			_disp_primary_path_idle_refresh_down();
 		atomic_set(&idle_detect_flag, 0);
 		/* printk("[ddp_idle]ret=%d\n", ret); */
 		if (kthread_should_stop()) {
@@ -1218,6 +1602,10 @@ int primary_display_get_debug_state(char *stringbuf, int buf_len)
 	len += scnprintf(stringbuf + len, buf_len - len, "|Current display driver status=%s + %s\n",
 			primary_display_is_video_mode() ? "video mode" : "cmd mode",
 			primary_display_cmdq_enabled() ? "CMDQ Enabled" : "CMDQ Disabled");
+#ifdef MTK_DISP_IDLE_LP
+	len += _disp_primary_path_idle_policy_show(stringbuf + len, buf_len - len);
+#endif
+	len += _primary_path_auto_dc_show(stringbuf + len, buf_len - len);
 
 	return len;
 }
@@ -2029,6 +2417,93 @@ void _cmdq_insert_wait_frame_done_token_mira(void *handle)
 #endif
 }
 
+#ifndef MTK_FB_CMDQ_DISABLE
+/*
+ * Pre-built config handle
+ *
+ * After each flush the config handle is reset and gets the prologue of
+ * the next frame (prefetch, SODI and the wait for frame done) before the
+ * next config can be recorded.  pgc->cmdq_handle_config_next holds a
+ * second handle whose prologue is built by a worker while the current
+ * frame is configured, so the trigger only swaps the two under the path
+ * lock.  The prologue depends on the display mode; if the mode changed
+ * since it was prepared it is rebuilt in place.
+ */
+#define CONFIG_PROLOGUE_VIDEO		(1 << 0)
+#define CONFIG_PROLOGUE_DECOUPLE	(1 << 1)
+#define CONFIG_PROLOGUE_PREFETCH	(1 << 2)
+
+static struct work_struct config_prepare_work;
+/* prologue pgc->cmdq_handle_config_next is (being) prepared with */
+static int config_prepare_key;
+
+static int _cmdq_config_prologue_key(int prefetch)
+{
+	int key = 0;
+
+	if (primary_display_is_video_mode() == 1)
+		key |= CONFIG_PROLOGUE_VIDEO;
+	if (_is_decouple_mode(pgc->session_mode))
+		key |= CONFIG_PROLOGUE_DECOUPLE;
+	if (prefetch)
+		key |= CONFIG_PROLOGUE_PREFETCH;
+
+	return key;
+}
+
+/*
+ * Same commands _trigger_display_interface() adds after the reset.  They
+ * are kept as a template of the handle, so only the first frame in each
+ * mode records them.
+ */
+static void _cmdq_build_config_prologue(cmdqRecHandle handle, int key)
+{
+	dprec_event_op(DPREC_EVENT_CMDQ_RESET);
+	if (cmdqRecRewindTemplate(handle, key) == 0)
+		return;
+
+	cmdqRecReset(handle);
+#ifdef DISP_ENABLE_SODI_FOR_VIDEO_MODE
+	if (key & CONFIG_PROLOGUE_PREFETCH)
+		cmdqRecEnablePrefetch(handle);
+#endif
+	if (key & CONFIG_PROLOGUE_DECOUPLE) {
+		/* nothing to wait for */
+	} else if (key & CONFIG_PROLOGUE_VIDEO) {
+		disp_set_sodi(1, handle);
+		cmdqRecWaitNoClear(handle, CMDQ_EVENT_DISP_RDMA0_EOF);
+		disp_set_sodi(0, handle);
+	} else {
+		cmdqRecWaitNoClear(handle, CMDQ_SYNC_TOKEN_STREAM_EOF);
+		dprec_event_op(DPREC_EVENT_CMDQ_WAIT_STREAM_EOF);
+	}
+	cmdqRecSealTemplate(handle, key);
+}
+
+static void _cmdq_prepare_config_work(struct work_struct *work)
+{
+	_cmdq_build_config_prologue(pgc->cmdq_handle_config_next, config_prepare_key);
+}
+
+/* called with the path lock held, right after the config handle was flushed */
+static void _cmdq_switch_config_handle(int key)
+{
+	cmdqRecHandle flushed = pgc->cmdq_handle_config;
+
+	flush_work(&config_prepare_work);
+	if (config_prepare_key != key)
+		_cmdq_build_config_prologue(pgc->cmdq_handle_config_next, key);
+
+	pgc->cmdq_handle_config = pgc->cmdq_handle_config_next;
+	pgc->cmdq_handle_config_next = flushed;
+	dpmgr_path_set_cmdq_handle(pgc->dpmgr_handle, pgc->cmdq_handle_config);
+
+	/* the next frame most likely runs in the same mode */
+	config_prepare_key = key;
+	queue_work(system_highpri_wq, &config_prepare_work);
+}
+#endif
+
 
 
 static int primary_display_is_secure_path(DISP_SESSION_TYPE session_type)
@@ -2045,6 +2520,110 @@ static int primary_display_is_secure_path(DISP_SESSION_TYPE session_type)
 	return 0;
 }
 
+/*
+ * Command mode partial update.  HWC passes the dirty rectangles of the next
+ * frame with DISP_IOCTL_SET_DIRTY_ROI; only their union goes through OVL, the
+ * PQ engines, RDMA and DSI into the panel RAM, the rest of the panel keeps
+ * what it has.  A frame without rectangles is a full one.
+ */
+static struct disp_rect primary_dirty_roi;	/* for the next config, width 0: all */
+
+int primary_display_is_partial_update_supported(void)
+{
+	LCM_PARAMS *lcm_param = disp_lcm_get_params(pgc->plcm);
+
+	if (!lcm_param || lcm_param->type != LCM_TYPE_DSI || lcm_param->dsi.ufoe_enable)
+		return 0;
+
+	return !primary_display_is_video_mode() && primary_display_cmdq_enabled();
+}
+
+int primary_display_set_dirty_roi(disp_dirty_rect *rects, unsigned int num)
+{
+	unsigned int w = primary_display_get_width();
+	unsigned int h = primary_display_get_height();
+	unsigned int x0 = w, y0 = h, x1 = 0, y1 = 0;
+	unsigned int i;
+
+	for (i = 0; i < num; i++) {
+		disp_dirty_rect *r = &rects[i];
+
+		if (!r->width || !r->height || r->x >= w || r->y >= h ||
+		    r->width > w || r->height > h)
+			continue;
+		x0 = min(x0, r->x);
+		y0 = min(y0, r->y);
+		x1 = max(x1, min(r->x + r->width, w));
+		y1 = max(y1, min(r->y + r->height, h));
+	}
+
+	_primary_path_lock(__func__);
+	memset(&primary_dirty_roi, 0, sizeof(primary_dirty_roi));
+	if (x1 > x0 && y1 > y0) {
+		/* even offsets and sizes for the 2 pixel YUV formats and the panels */
+		x0 = round_down(x0, 2);
+		y0 = round_down(y0, 2);
+		x1 = min(round_up(x1, 2), w);
+		y1 = min(round_up(y1, 2), h);
+		if (x0 || y0 || x1 != w || y1 != h) {
+			primary_dirty_roi.x = x0;
+			primary_dirty_roi.y = y0;
+			primary_dirty_roi.width = x1 - x0;
+			primary_dirty_roi.height = y1 - y0;
+		}
+	}
+	_primary_path_unlock(__func__);
+
+	return 0;
+}
+
+/* called with the primary lock held, for the direct link config of a frame */
+static void _primary_path_apply_partial_roi(disp_ddp_path_config *data_config)
+{
+	struct disp_rect roi = primary_dirty_roi;
+
+	/* one frame only */
+	memset(&primary_dirty_roi, 0, sizeof(primary_dirty_roi));
+
+	/* the AAL histogram is taken from the whole frame */
+	if (!primary_display_is_partial_update_supported() ||
+	    _is_decouple_mode(pgc->session_mode) || disp_aal_is_active())
+		memset(&roi, 0, sizeof(roi));
+
+	if (!memcmp(&roi, &data_config->partial_roi, sizeof(roi)))
+		return;
+
+	data_config->partial_roi = roi;
+	data_config->partial_dirty = 1;
+}
+
+/* back to whole frames on the direct link path, returns 1 if it was partial */
+static int _primary_path_config_full_roi(void *cmdq_handle)
+{
+	disp_ddp_path_config *data_config = dpmgr_path_get_last_config(pgc->dpmgr_handle);
+
+	if (!data_config->partial_roi.width)
+		return 0;
+
+	memset(&data_config->partial_roi, 0, sizeof(data_config->partial_roi));
+	data_config->partial_dirty = 1;
+	dpmgr_path_config(pgc->dpmgr_handle, data_config, cmdq_handle);
+
+	return 1;
+}
+
+/* same, and wait for a whole frame to be sent out */
+static void _primary_path_flush_full_roi(void)
+{
+	if (!_primary_path_config_full_roi(pgc->cmdq_handle_config))
+		return;
+
+	_cmdq_set_config_handle_dirty();
+	_cmdq_flush_config_handle(1, NULL, 0);
+	_cmdq_reset_config_handle();
+	_cmdq_insert_wait_frame_done_token();
+}
+
 static void directlink_path_add_memory(WDMA_CONFIG_STRUCT *p_wdma)
 {
 	int ret = 0;
@@ -2149,6 +2728,9 @@ static int _DL_switch_to_DC_fast(void)
 	spm_enable_sodi(0);
 #endif
 
+	/* the temp frame and the RDMA afterwards are whole frames */
+	_primary_path_flush_full_roi();
+
 	/* 1.save a temp frame to intermediate buffer */
 	directlink_path_add_memory(&wdma_config);
 
@@ -3151,6 +3733,13 @@ int _trigger_display_interface(int blocking, void *callback, unsigned int userda
 	if (_should_flush_cmdq_config_handle())
 		_cmdq_flush_config_handle(blocking, callback, userdata);
 
+	/* swap in the pre-built handle, it already holds steps 2 and 3 below */
+	if (_should_reset_cmdq_config_handle() && _should_insert_wait_frame_done_token() &&
+	    pgc->cmdq_handle_config_next) {
+		_cmdq_switch_config_handle(_cmdq_config_prologue_key(gPrefetchControl == 1 && cnt >= 20));
+		goto prepared;
+	}
+
 	if (_should_reset_cmdq_config_handle()) {
 		_cmdq_reset_config_handle();
 #ifdef DISP_ENABLE_SODI_FOR_VIDEO_MODE
@@ -3174,6 +3763,7 @@ int _trigger_display_interface(int blocking, void *callback, unsigned int userda
 		if (primary_display_is_video_mode() == 1)
 			disp_set_sodi(0, pgc->cmdq_handle_config);
 	}
+prepared:
 
 	if (cnt < 20)
 		cnt++;
@@ -3926,6 +4516,9 @@ int primary_display_esd_recovery(void)
 	disp_lcm_init(pgc->plcm, 1);
 	DISPCHECK("[ESD]lcm force init[end]\n");
 
+	/* the panel is back to its whole window */
+	_primary_path_config_full_roi(NULL);
+
 	MMProfileLogEx(ddp_mmp_get_events()->esd_recovery_t, MMProfileFlagPulse, 0, 9);
 
 	DISPCHECK("[ESD]start dpmgr path[begin]\n");
@@ -4871,6 +5464,7 @@ static int _present_fence_release_worker_thread(void *data)
 				MMProfileLogEx(ddp_mmp_get_events()->present_fence_release,
 					       MMProfileFlagPulse, gPresentFenceIndex,
 					       fence_increment);
+				dprec_frame_stage(DPREC_FRAME_PRESENT, gPresentFenceIndex);
 			}
 			_primary_path_unlock(__func__);
 			/* DISPPR_FENCE("RPF/%d/%d\n",
@@ -5188,6 +5782,14 @@ int primary_display_init(char *lcm_name, unsigned int lcm_fps)
 	} else {
 		DISPCHECK("cmdqRecCreate SUCCESS, g_cmdq_handle=0x%p\n", pgc->cmdq_handle_config);
 	}
+	/* without the spare handle, the trigger rebuilds the prologue in place */
+	if (cmdqRecCreate(CMDQ_SCENARIO_PRIMARY_DISP, &(pgc->cmdq_handle_config_next))) {
+		DISPCHECK("cmdqRecCreate for prepared config handle FAIL\n");
+		pgc->cmdq_handle_config_next = NULL;
+	} else {
+		INIT_WORK(&config_prepare_work, _cmdq_prepare_config_work);
+		config_prepare_key = -1;
+	}
 	/*create ovl2mem path cmdq handle */
 	ret = cmdqRecCreate(CMDQ_SCENARIO_DISP_COLOR, &(pgc->cmdq_handle_ovl1to2_config));
 	if (ret != 0) {
@@ -5477,6 +6079,8 @@ int primary_display_init(char *lcm_name, unsigned int lcm_fps)
 	primary_display_idle_detect_task = kthread_create(_disp_primary_path_idle_detect_thread, NULL,
 							  "display_idle_detect");
 	wake_up_process(primary_display_idle_detect_task);
+	if (input_register_handler(&disp_idle_touch_handler))
+		DISPERR("idle touch handler register fail\n");
 #endif
 
 	pgc->dc_type = DISP_OUTPUT_DECOUPLE;
@@ -5975,6 +6579,7 @@ int primary_display_resume(void)
 
 		data_config->fps = pgc->lcm_fps;
 		data_config->dst_dirty = 1;
+		memset(&data_config->partial_roi, 0, sizeof(data_config->partial_roi));
 
 		ret = dpmgr_path_config(pgc->dpmgr_handle, data_config, NULL);
 		MMProfileLogEx(ddp_mmp_get_events()->primary_resume, MMProfileFlagPulse, 2, 2);
@@ -6291,6 +6896,9 @@ int primary_display_trigger(int blocking, void *callback, unsigned int userdata)
 	int ret = 0;
 
 	last_primary_trigger_time = sched_clock();
+#ifdef MTK_DISP_IDLE_LP
+	_disp_primary_path_idle_note_update(last_primary_trigger_time);
+#endif
 #ifdef DISP_SWITCH_DST_MODE
 	if (is_switched_dst_mode) {
 		primary_display_switch_dst_mode(1); /* swith to vdo mode if trigger disp */
@@ -6318,6 +6926,10 @@ int primary_display_trigger(int blocking, void *callback, unsigned int userdata)
 
 #ifdef MTK_DISP_IDLE_LP
 	_disp_primary_path_exit_idle(__func__, 0);
+	/* a fast frame ends low rate idle right away */
+	if (idle_policy.level == DISP_IDLE_LOW_RATE &&
+	    idle_policy.last_interval_us < DISP_IDLE_LOW_RATE_US)
+		_disp_primary_path_set_idle_level(DISP_IDLE_ACTIVE, 0);
 #endif
 	dprec_logger_start(DPREC_LOGGER_PRIMARY_TRIGGER, pgc->session_mode, pgc->dc_type);
 
@@ -6765,6 +7377,8 @@ static int _config_ovl_input(disp_session_input_config *session_input,
 		data_config->dst_h = lcm_param->height;
 		data_config->dst_w = lcm_param->width;
 		data_config->is_memory = false;
+		if (disp_handle == pgc->dpmgr_handle)
+			_primary_path_apply_partial_roi(data_config);
 	}
 
 	for (i = 0; i < session_input->config_layer_num; i++) {
@@ -6874,6 +7488,7 @@ static int _config_ovl_input(disp_session_input_config *session_input,
 
 	update_debug_fps_meter(data_config);
 	if (DISP_SESSION_TYPE(session_input->session_id) == DISP_SESSION_PRIMARY) {
+		_primary_path_auto_dc_note(data_config);
 		last_primary_config = *data_config;
 		is_hwc_update_frame = 1;
 	}
@@ -6954,6 +7569,8 @@ int primary_display_config_input_multiple(disp_session_input_config *session_inp
 	/* call this in trigger is enough, do not have to call this in config */
 	_disp_primary_path_exit_idle(__func__, 0);
 #endif
+	if (DISP_SESSION_TYPE(session_input->session_id) == DISP_SESSION_PRIMARY)
+		_primary_path_auto_dc_select();
 
 	if (_is_decouple_mode(pgc->session_mode)) {
 		disp_handle = pgc->ovl2mem_path_handle;
@@ -7158,6 +7775,14 @@ int primary_display_switch_mode(int sess_mode, unsigned int session, int force)
 	if (primary_get_state() == DISP_BLANK)
 		sess_mode = DISP_SESSION_DECOUPLE_MODE;
 
+	if (auto_dc.active) {
+		if (sess_mode == DISP_SESSION_DIRECT_LINK_MODE &&
+		    pgc->session_mode == DISP_SESSION_DECOUPLE_MODE)
+			goto done;
+		auto_dc.active = 0;
+	}
+	auto_dc.streak = 0;
+
 	if (pgc->session_mode == sess_mode)
 		goto done;
 
@@ -8128,9 +8753,8 @@ int primary_display_capture_framebuffer_decouple(unsigned long pbuf, unsigned in
 	DISPMSG("map 0x%08x with %d bytes to 0x%08lx with %d bytes\n", mva, buffer_size, va,
 		mapped_size);
 
-	ret =
-	    m4u_cache_sync(m4uClient, M4U_PORT_DISP_WDMA0, va, buffer_size, mva,
-			   M4U_CACHE_FLUSH_ALL);
+	/* only the captured frame, not every cache of every CPU */
+	mt_cache_sync_range((void *)va, buffer_size, MT_CACHE_FLUSH);
 #if 1
 	{
 		unsigned int j = 0;
@@ -8199,6 +8823,9 @@ int primary_display_capture_framebuffer_ovl(unsigned long pbuf, unsigned int for
 		goto out;
 	}
 
+	/* WDMA takes the OVL output, that has to be the whole frame */
+	_primary_path_flush_full_roi();
+
 	m4uClient = m4u_create_client();
 	if (m4uClient == NULL) {
 		DISPCHECK("primary capture:Fail to alloc  m4uClient=0x%p\n", m4uClient);
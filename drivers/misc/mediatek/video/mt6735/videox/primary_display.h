@@ -206,6 +206,7 @@ typedef struct {
 	cmdqRecHandle cmdq_handle_trigger;
 
 	cmdqRecHandle cmdq_handle_config;
+	cmdqRecHandle cmdq_handle_config_next;
 	disp_path_handle dpmgr_handle;
 
 	cmdqRecHandle cmdq_handle_ovl1to2_config;
@@ -323,6 +324,8 @@ unsigned int primary_display_get_fps(void);
 int primary_display_get_original_width(void);
 int primary_display_get_original_height(void);
 int primary_display_insert_session_buf(disp_session_buf_info *session_buf_info);
+int primary_display_is_partial_update_supported(void);
+int primary_display_set_dirty_roi(disp_dirty_rect *rects, unsigned int num);
 int primary_display_enable_path_cg(int enable);
 int primary_display_lcm_ATA(void);
 int primary_display_setbacklight(unsigned int level);
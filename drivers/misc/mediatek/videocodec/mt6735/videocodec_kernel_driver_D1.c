@@ -20,6 +20,9 @@
 /* #include <mach/x_define_irq.h> */
 #include <linux/wait.h>
 #include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <linux/workqueue.h>
+#include <linux/ktime.h>
 #include <linux/semaphore.h>
 #include <mt-plat/dma.h>
 #include <linux/delay.h>
@@ -84,6 +87,12 @@
 #define DVFS_DEFAULT MMDVFS_VOLTAGE_HIGH
 #define MONITOR_START_MINUS_1   0
 #define SW_OVERHEAD_MS 1
+/* a frame busier than this share of the frame period is close to its deadline */
+#define DEADLINE_PERCENTAGE 75
+/* 273MHz / 136.5MHz, frame time at DVFS_LOW against DVFS_HIGH */
+#define VDEC_LOW_CLK_RATIO  2
+/* lock gaps longer than this are pauses, not frame periods */
+#define LOAD_IDLE_US        500000
 static VAL_BOOL_T   gMMDFVFSMonitorStarts = VAL_FALSE;
 static VAL_BOOL_T   gFirstDvfsLock = VAL_FALSE;
 static VAL_UINT32_T gMMDFVFSMonitorCounts;
@@ -92,6 +101,54 @@ static VAL_TIME_T   gMMDFVFSLastLockTime;
 static VAL_TIME_T   gMMDFVFSMonitorEndTime;
 static VAL_UINT32_T gHWLockInterval;
 static VAL_INT32_T  gHWLockMaxDuration;
+static int          gVdecDvfsLevel = DVFS_DEFAULT;
+static int          gVencDvfsLevel = DVFS_LOW;
+static u64          gu8VencMonitorStartUs;
+
+/* Frame level HW load. Userspace does not pass resolution or fps down, so
+ * the frame period is taken from the LOCKHW cadence and the frame cost from
+ * how long the lock is held, which already scales with resolution.
+ */
+typedef struct {
+	u64 u8LastLockUs;
+	VAL_UINT32_T u4PeriodUs;	/* running average of lock to lock time */
+	VAL_UINT32_T u4MaxBusyUs;	/* in the current monitor window */
+} VCODEC_DVFS_LOAD_T;
+
+static VCODEC_DVFS_LOAD_T grVdecLoad;	/* mutex : VdecHWLock */
+static VCODEC_DVFS_LOAD_T grVencLoad;	/* mutex : VencHWLock */
+
+static void VcodecLoadLock(VCODEC_DVFS_LOAD_T *pLoad, u64 u8NowUs)
+{
+	u64 u8IntervalUs = u8NowUs - pLoad->u8LastLockUs;
+
+	if (pLoad->u8LastLockUs != 0 && u8IntervalUs < LOAD_IDLE_US) {
+		if (pLoad->u4PeriodUs == 0)
+			pLoad->u4PeriodUs = (VAL_UINT32_T)u8IntervalUs;
+		else
+			pLoad->u4PeriodUs = (pLoad->u4PeriodUs * 7 + (VAL_UINT32_T)u8IntervalUs) / 8;
+	}
+	pLoad->u8LastLockUs = u8NowUs;
+}
+
+/* returns the frame busy time in percent of the frame period */
+static VAL_UINT32_T VcodecLoadUnlock(VCODEC_DVFS_LOAD_T *pLoad, u64 u8BusyUs)
+{
+	if (u8BusyUs > pLoad->u4MaxBusyUs)
+		pLoad->u4MaxBusyUs = (VAL_UINT32_T)u8BusyUs;
+	if (pLoad->u4PeriodUs == 0)
+		return 0;
+	return (VAL_UINT32_T)div_u64(u8BusyUs * 100, pLoad->u4PeriodUs);
+}
+
+/* worst frame of the window still meets DEADLINE_PERCENTAGE when u4Ratio times slower */
+static VAL_BOOL_T VcodecLoadFits(VCODEC_DVFS_LOAD_T *pLoad, VAL_UINT32_T u4Ratio)
+{
+	if (pLoad->u4PeriodUs == 0)
+		return VAL_FALSE;
+	return ((u64)pLoad->u4MaxBusyUs * u4Ratio * 100 < (u64)pLoad->u4PeriodUs * DEADLINE_PERCENTAGE) ?
+	       VAL_TRUE : VAL_FALSE;
+}
 
 #ifndef CONFIG_MTK_CLKMGR
 static struct clk *clk_MT_CG_TOP_MUX_VDEC;      /* TOP_MUX_VDEC */
@@ -141,7 +198,9 @@ void SendDvfsRequest(int level)
 #endif
 	} else {
 		MODULE_MFV_LOGD("[VCODEC][MMDVFS_VDEC] OOPS: level = %d\n", level);
+		return;
 	}
+	gVdecDvfsLevel = level;
 
 	if (0 != ret) {
 		/* Add one line comment for avoid kernel coding style, WARNING:BRACES: */
@@ -156,6 +215,7 @@ void VdecDvfsBegin(void)
 	gHWLockInterval = 0;
 	gFirstDvfsLock = VAL_TRUE;
 	gHWLockMaxDuration = 0;
+	grVdecLoad.u4MaxBusyUs = 0;
 	MODULE_MFV_LOGD("[VCODEC][MMDVFS_VDEC] VdecDvfsBegin");
 	/* eVideoGetTimeOfDay(&gMMDFVFSMonitorStartTime, sizeof(VAL_TIME_T)); */
 }
@@ -179,6 +239,7 @@ void VdecDvfsEnd(int level)
 	gMMDFVFSMonitorCounts = 0;
 	gHWLockInterval = 0;
 	gHWLockMaxDuration = 0;
+	grVdecLoad.u4MaxBusyUs = 0;
 }
 
 VAL_UINT32_T VdecDvfsStep(void)
@@ -195,12 +256,22 @@ VAL_UINT32_T VdecDvfsStep(void)
 	return _diff;
 }
 
-void VdecDvfsAdjustment(void)
+/* u4FramePerc: busy time of the frame just unlocked, see VcodecLoadUnlock */
+void VdecDvfsAdjustment(VAL_UINT32_T u4FramePerc)
 {
 	VAL_UINT32_T _monitor_duration = 0;
 	VAL_UINT32_T _diff = 0;
 	VAL_UINT32_T _perc = 0;
 
+	/* do not wait for the window end once frames get late at low clock */
+	if (DVFS_LOW == gVdecDvfsLevel && u4FramePerc > DEADLINE_PERCENTAGE) {
+		MODULE_MFV_LOGD("[VCODEC][MMDVFS_VDEC] frame %d%% of period %d us, raise now\n",
+			 u4FramePerc, grVdecLoad.u4PeriodUs);
+		SendDvfsRequest(DVFS_HIGH);
+		VdecDvfsEnd(DVFS_HIGH);
+		return;
+	}
+
 	if (VAL_TRUE == gMMDFVFSMonitorStarts && gMMDFVFSMonitorCounts > MONITOR_START_MINUS_1) {
 		_monitor_duration = VdecDvfsGetMonitorDuration();
 		if (_monitor_duration < MONITOR_DURATION_MS) {
@@ -214,7 +285,9 @@ void VdecDvfsAdjustment(void)
 				 DROP_PERCENTAGE, RAISE_PERCENTAGE);
 			MODULE_MFV_LOGD("[VCODEC][MMDVFS_VDEC] reset monitor duration (%d ms), percent: %d\n",
 				 _monitor_duration, _perc);
-			if (_perc < DROP_PERCENTAGE) {
+			/* drop only if the worst frame of the window still fits at low clock */
+			if (_perc < DROP_PERCENTAGE &&
+			    VcodecLoadFits(&grVdecLoad, (DVFS_HIGH == gVdecDvfsLevel) ? VDEC_LOW_CLK_RATIO : 1)) {
 				SendDvfsRequest(DVFS_LOW);
 				VdecDvfsEnd(DVFS_LOW);
 			} else if (_perc > RAISE_PERCENTAGE) {
@@ -228,6 +301,41 @@ void VdecDvfsAdjustment(void)
 	gMMDFVFSMonitorCounts++;
 }
 
+/* Encoder: no clock mux here, only the vcore/EMI step of SMI_BWC_SCEN_VENC */
+void VencDvfsRequest(int level)
+{
+	if (level == gVencDvfsLevel)
+		return;
+
+	MODULE_MFV_LOGD("[VCODEC][MMDVFS_VENC] level %d -> %d, period %d us, max busy %d us\n",
+		 gVencDvfsLevel, level, grVencLoad.u4PeriodUs, grVencLoad.u4MaxBusyUs);
+	if (0 != mmdvfs_set_step(SMI_BWC_SCEN_VENC, level)) {
+		/* Add one line comment for avoid kernel coding style, WARNING:BRACES: */
+		MODULE_MFV_LOGE("[VCODEC][MMDVFS_VENC] OOPS: mmdvfs_set_step error!");
+	}
+	gVencDvfsLevel = level;
+}
+
+void VencDvfsAdjustment(VAL_UINT32_T u4FramePerc, u64 u8NowUs)
+{
+	if (DVFS_LOW == gVencDvfsLevel && u4FramePerc > DEADLINE_PERCENTAGE) {
+		VencDvfsRequest(DVFS_HIGH);
+		gu8VencMonitorStartUs = u8NowUs;
+		grVencLoad.u4MaxBusyUs = 0;
+		return;
+	}
+
+	if (gu8VencMonitorStartUs == 0) {
+		gu8VencMonitorStartUs = u8NowUs;
+	} else if (u8NowUs - gu8VencMonitorStartUs >= MONITOR_DURATION_MS * 1000) {
+		/* no clock ratio to scale by, so ask for the same margin as a drop at the dec side */
+		if (DVFS_HIGH == gVencDvfsLevel && VcodecLoadFits(&grVencLoad, VDEC_LOW_CLK_RATIO))
+			VencDvfsRequest(DVFS_LOW);
+		gu8VencMonitorStartUs = u8NowUs;
+		grVencLoad.u4MaxBusyUs = 0;
+	}
+}
+
 void VdecDvfsMonitorStart(void)
 {
 	if (VAL_FALSE == gMMDFVFSMonitorStarts) {
@@ -305,6 +413,8 @@ static VAL_INT32_T Driver_Open_Count;         /* mutex : DriverOpenCountLock */
 static VAL_UINT32_T gu4PWRCounter;      /* mutex : PWRLock */
 static VAL_UINT32_T gu4EncEMICounter;   /* mutex : EncEMILock */
 static VAL_UINT32_T gu4DecEMICounter;   /* mutex : DecEMILock */
+static VAL_BOOL_T gbEncSmiScen;         /* mutex : EncEMILock, holds SMI_BWC_SCEN_VENC */
+static VAL_BOOL_T gbDecSmiScen;         /* mutex : DecEMILock, holds SMI_BWC_SCEN_VP */
 static VAL_UINT32_T gu4L2CCounter;      /* mutex : L2CLock */
 static VAL_BOOL_T bIsOpened = VAL_FALSE;    /* mutex : IsOpenedLock */
 static VAL_UINT32_T gu4HwVencIrqStatus; /* hardware VENC IRQ status (VP8/H264) */
@@ -529,6 +639,178 @@ void venc_power_off(void)
 	mutex_unlock(&VencPWRLock);
 }
 
+/* The lock owner's clocks stay on for a short while after UNLOCKHW, so a
+ * back-to-back LOCKHW of the same or another instance skips a power cycle.
+ */
+#define VCODEC_POWER_OFF_DELAY_MS	16
+
+static void vdec_power_off_work(struct work_struct *work)
+{
+	vdec_power_off();
+}
+
+static void venc_power_off_work(struct work_struct *work)
+{
+	venc_power_off();
+}
+
+static DECLARE_DELAYED_WORK(VdecPowerOffWork, vdec_power_off_work);
+static DECLARE_DELAYED_WORK(VencPowerOffWork, venc_power_off_work);
+
+/* Instances waiting for a HW lock, granted in arrival order so one instance
+ * re-locking right after UNLOCKHW cannot starve the others.
+ */
+typedef struct {
+	struct list_head list;
+	u64 u8QueuedUs;
+} VCODEC_HW_WAITER_T;
+
+static LIST_HEAD(DecHWWaitList);	/* mutex : VdecHWLock */
+static LIST_HEAD(EncHWWaitList);	/* mutex : VencHWLock */
+static DECLARE_WAIT_QUEUE_HEAD(DecHWWaitQueue);
+static DECLARE_WAIT_QUEUE_HEAD(EncHWWaitQueue);
+static u64 gu8DecLockedUs;		/* mutex : VdecHWLock */
+static u64 gu8EncLockedUs;		/* mutex : VencHWLock */
+
+static inline u64 vcodec_now_us(void)
+{
+	return ktime_to_us(ktime_get());
+}
+
+static void vcodec_hw_waiter_join(struct mutex *pLock, struct list_head *pWaitList, VCODEC_HW_WAITER_T *pWaiter)
+{
+	pWaiter->u8QueuedUs = vcodec_now_us();
+	mutex_lock(pLock);
+	list_add_tail(&pWaiter->list, pWaitList);
+	mutex_unlock(pLock);
+}
+
+/* Caller holds the mutex of pWaitList */
+static void vcodec_hw_waiter_leave_locked(wait_queue_head_t *pWaitQueue, VCODEC_HW_WAITER_T *pWaiter)
+{
+	list_del(&pWaiter->list);
+	/* the head may have changed */
+	wake_up_interruptible_all(pWaitQueue);
+}
+
+static void vcodec_hw_waiter_leave(struct mutex *pLock, wait_queue_head_t *pWaitQueue, VCODEC_HW_WAITER_T *pWaiter)
+{
+	mutex_lock(pLock);
+	vcodec_hw_waiter_leave_locked(pWaitQueue, pWaiter);
+	mutex_unlock(pLock);
+}
+
+static inline VAL_BOOL_T vcodec_hw_waiter_first(struct list_head *pWaitList, VCODEC_HW_WAITER_T *pWaiter)
+{
+	return (ACCESS_ONCE(pWaitList->next) == &pWaiter->list) ? VAL_TRUE : VAL_FALSE;
+}
+
+/* Same results as eVideoWaitEvent, but only wakes up when the lock is free
+ * and pWaiter is the oldest waiter. Rechecked under the lock by the caller.
+ */
+static VAL_RESULT_T vcodec_hw_wait_turn(wait_queue_head_t *pWaitQueue, struct list_head *pWaitList,
+					VAL_VCODEC_HW_LOCK_T *pHWLock, VCODEC_HW_WAITER_T *pWaiter,
+					VAL_UINT32_T u4TimeoutMs)
+{
+	long i4Ret;
+
+	i4Ret = wait_event_interruptible_timeout(*pWaitQueue,
+						 ACCESS_ONCE(pHWLock->pvHandle) == 0 &&
+						 vcodec_hw_waiter_first(pWaitList, pWaiter),
+						 msecs_to_jiffies(u4TimeoutMs));
+	if (0 == i4Ret)
+		return VAL_RESULT_INVALID_ISR;
+	else if (-ERESTARTSYS == i4Ret)
+		return VAL_RESULT_RESTARTSYS;
+	return VAL_RESULT_NO_ERROR;
+}
+
+/* Per instance HW usage, see /proc/driver/vcodec_util */
+#define VCODEC_UTIL_INSTANCE_MAX	8
+
+typedef struct {
+	VAL_VOID_T *pvHandle;
+	VAL_UINT32_T u4DriverType;
+	VAL_UINT32_T u4LockCount;
+	u64 u8BusyUs;
+	u64 u8WaitUs;
+	u64 u8FirstUs;
+	u64 u8LastUs;
+} VCODEC_INSTANCE_UTIL_T;
+
+static DEFINE_MUTEX(UtilLock);
+static VCODEC_INSTANCE_UTIL_T grVcodecUtil[VCODEC_UTIL_INSTANCE_MAX];	/* mutex : UtilLock */
+
+/* bLock: u8Us is the time spent waiting for the lock, else the time it was held */
+static void vcodec_util_update(VAL_VOID_T *pvHandle, VAL_UINT32_T u4DriverType, VAL_BOOL_T bLock, u64 u8Us)
+{
+	VCODEC_INSTANCE_UTIL_T *pUtil = NULL;
+	u64 u8NowUs = vcodec_now_us();
+	int i;
+
+	mutex_lock(&UtilLock);
+	for (i = 0; i < VCODEC_UTIL_INSTANCE_MAX; i++) {
+		if (grVcodecUtil[i].pvHandle == pvHandle) {
+			pUtil = &grVcodecUtil[i];
+			break;
+		}
+		/* reuse the least recently used slot */
+		if (pUtil == NULL || grVcodecUtil[i].u8LastUs < pUtil->u8LastUs)
+			pUtil = &grVcodecUtil[i];
+	}
+	if (pUtil->pvHandle != pvHandle) {
+		memset(pUtil, 0, sizeof(*pUtil));
+		pUtil->pvHandle = pvHandle;
+		pUtil->u8FirstUs = u8NowUs;
+	}
+	pUtil->u4DriverType = u4DriverType;
+	if (bLock) {
+		pUtil->u4LockCount++;
+		pUtil->u8WaitUs += u8Us;
+	} else {
+		pUtil->u8BusyUs += u8Us;
+	}
+	pUtil->u8LastUs = u8NowUs;
+	mutex_unlock(&UtilLock);
+}
+
+static int vcodec_util_show(struct seq_file *m, void *v)
+{
+	u64 u8NowUs = vcodec_now_us();
+	u64 u8SpanUs;
+	int i;
+
+	seq_puts(m, "instance           type  locks    busy_ms    wait_ms  util%\n");
+	mutex_lock(&UtilLock);
+	for (i = 0; i < VCODEC_UTIL_INSTANCE_MAX; i++) {
+		VCODEC_INSTANCE_UTIL_T *pUtil = &grVcodecUtil[i];
+
+		if (pUtil->pvHandle == 0)
+			continue;
+		u8SpanUs = u8NowUs - pUtil->u8FirstUs;
+		seq_printf(m, "0x%016lx %4d %6u %10llu %10llu %5llu\n",
+			   (VAL_ULONG_T)pUtil->pvHandle, pUtil->u4DriverType, pUtil->u4LockCount,
+			   div_u64(pUtil->u8BusyUs, 1000), div_u64(pUtil->u8WaitUs, 1000),
+			   u8SpanUs ? div64_u64(pUtil->u8BusyUs * 100, u8SpanUs) : 0);
+	}
+	mutex_unlock(&UtilLock);
+
+	return 0;
+}
+
+static int vcodec_util_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, vcodec_util_show, NULL);
+}
+
+static const struct file_operations vcodec_util_fops = {
+	.owner = THIS_MODULE,
+	.open = vcodec_util_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 void dec_isr(void)
 {
 	VAL_RESULT_T    eValRet;
@@ -825,6 +1107,8 @@ static long vcodec_lockhw(unsigned long arg)
 	VAL_TIME_T rCurTime;
 	VAL_UINT32_T u4TimeInterval;
 	VAL_ULONG_T ulFlagsLockHW;
+	VCODEC_HW_WAITER_T rWaiter;
+	VAL_BOOL_T bPowerHeld = VAL_FALSE;
 
 	MODULE_MFV_LOGD("VCODEC_LOCKHW + tid = %d\n", current->pid);
 
@@ -844,6 +1128,7 @@ static long vcodec_lockhw(unsigned long arg)
 	    rHWLock.eDriverType == VAL_DRIVER_TYPE_VC1_DEC ||
 	    rHWLock.eDriverType == VAL_DRIVER_TYPE_VC1_ADV_DEC ||
 	    rHWLock.eDriverType == VAL_DRIVER_TYPE_VP8_DEC) {
+		vcodec_hw_waiter_join(&VdecHWLock, &DecHWWaitList, &rWaiter);
 		while (bLockedHW == VAL_FALSE) {
 			mutex_lock(&DecHWLockEventTimeoutLock);
 			if (DecHWLockEvent.u4TimeoutMs == 1) {
@@ -856,7 +1141,8 @@ static long vcodec_lockhw(unsigned long arg)
 
 			if (FirstUseDecHW == 1) {
 				/* Add one line comment for avoid kernel coding style, WARNING:BRACES: */
-				eValRet = eVideoWaitEvent(&DecHWLockEvent, sizeof(VAL_EVENT_T));
+				eValRet = vcodec_hw_wait_turn(&DecHWWaitQueue, &DecHWWaitList, &grVcodecDecHWLock,
+								      &rWaiter, DecHWLockEvent.u4TimeoutMs);
 			}
 			mutex_lock(&DecHWLockEventTimeoutLock);
 			if (DecHWLockEvent.u4TimeoutMs != 1000) {
@@ -880,22 +1166,28 @@ static long vcodec_lockhw(unsigned long arg)
 			if (FirstUseDecHW == 0) {
 				MODULE_MFV_LOGD("VCODEC_LOCKHW, Not first time use HW, timeout = %d\n",
 					 DecHWLockEvent.u4TimeoutMs);
-				eValRet = eVideoWaitEvent(&DecHWLockEvent, sizeof(VAL_EVENT_T));
+				eValRet = vcodec_hw_wait_turn(&DecHWWaitQueue, &DecHWWaitList, &grVcodecDecHWLock,
+								      &rWaiter, DecHWLockEvent.u4TimeoutMs);
 			}
 
 			if (VAL_RESULT_INVALID_ISR == eValRet) {
 				ret = vcodec_lockhw_dec_fail(rHWLock, FirstUseDecHW);
 				if (ret) {
 					MODULE_MFV_LOGE("[ERROR] vcodec_lockhw_dec_fail failed: %lu\n", ret);
+					vcodec_hw_waiter_leave(&VdecHWLock, &DecHWWaitQueue, &rWaiter);
 					return -EFAULT;
 				}
 			} else if (VAL_RESULT_RESTARTSYS == eValRet) {
 				MODULE_MFV_LOGE("[WARNING] VCODEC_LOCKHW, VAL_RESULT_RESTARTSYS return when HWLock!!\n");
+				vcodec_hw_waiter_leave(&VdecHWLock, &DecHWWaitQueue, &rWaiter);
 				return -ERESTARTSYS;
 			}
 
 			mutex_lock(&VdecHWLock);
-			if (grVcodecDecHWLock.pvHandle == 0) { /* No one holds dec hw lock now */
+			/* No one holds dec hw lock now and no one queued before us */
+			if (grVcodecDecHWLock.pvHandle == 0 && vcodec_hw_waiter_first(&DecHWWaitList, &rWaiter)) {
+				list_del(&rWaiter.list);
+				gu8DecLockedUs = vcodec_now_us();
 				gu4VdecLockThreadId = current->pid;
 				grVcodecDecHWLock.pvHandle =
 					(VAL_VOID_T *)pmem_user_v2p_video((VAL_ULONG_T)rHWLock.pvHandle);
@@ -908,16 +1200,25 @@ static long vcodec_lockhw(unsigned long arg)
 					 current->pid,
 					 grVcodecDecHWLock.rLockedTime.u4Sec, grVcodecDecHWLock.rLockedTime.u4uSec);
 
+				vcodec_util_update(grVcodecDecHWLock.pvHandle, rHWLock.eDriverType, VAL_TRUE,
+						   gu8DecLockedUs - rWaiter.u8QueuedUs);
+
 				bLockedHW = VAL_TRUE;
+#ifndef KS_POWER_WORKAROUND
+				/* still powered from the previous owner */
+				bPowerHeld = cancel_delayed_work(&VdecPowerOffWork) ? VAL_TRUE : VAL_FALSE;
+#endif
 				if (VAL_RESULT_INVALID_ISR == eValRet && FirstUseDecHW != 1) {
 					MODULE_MFV_LOGE("[WARNING] VCODEC_LOCKHW, reset power/irq when HWLock!!\n");
 #ifndef KS_POWER_WORKAROUND
 					vdec_power_off();
+					bPowerHeld = VAL_FALSE;
 #endif
 					disable_irq(VDEC_IRQ_ID);
 				}
 #ifndef KS_POWER_WORKAROUND
-				vdec_power_on();
+				if (bPowerHeld == VAL_FALSE)
+					vdec_power_on();
 #endif
 				if (rHWLock.bSecureInst == VAL_FALSE) {
 					/* Add one line comment for avoid kernel coding style, WARNING:BRACES: */
@@ -926,9 +1227,10 @@ static long vcodec_lockhw(unsigned long arg)
 
 #ifdef ENABLE_MMDVFS_VDEC
 				VdecDvfsMonitorStart();
+				VcodecLoadLock(&grVdecLoad, gu8DecLockedUs);
 #endif
 
-			} else { /* Another one holding dec hw now */
+			} else { /* Another one holding dec hw now, or queued before us */
 				MODULE_MFV_LOGE("VCODEC_LOCKHW E\n");
 				eVideoGetTimeOfDay(&rCurTime, sizeof(VAL_TIME_T));
 				u4TimeInterval = (((((rCurTime.u4Sec - grVcodecDecHWLock.rLockedTime.u4Sec) * 1000000)
@@ -955,6 +1257,7 @@ static long vcodec_lockhw(unsigned long arg)
 	} else if (rHWLock.eDriverType == VAL_DRIVER_TYPE_H264_ENC ||
 		   rHWLock.eDriverType == VAL_DRIVER_TYPE_HEVC_ENC ||
 		   rHWLock.eDriverType == VAL_DRIVER_TYPE_JPEG_ENC) {
+		vcodec_hw_waiter_join(&VencHWLock, &EncHWWaitList, &rWaiter);
 		while (bLockedHW == VAL_FALSE) {
 			/* Early break for JPEG VENC */
 			if (rHWLock.u4TimeoutMs == 0) {
@@ -975,7 +1278,8 @@ static long vcodec_lockhw(unsigned long arg)
 			mutex_unlock(&EncHWLockEventTimeoutLock);
 			if (FirstUseEncHW == 1) {
 				/* Add one line comment for avoid kernel coding style, WARNING:BRACES: */
-				eValRet = eVideoWaitEvent(&EncHWLockEvent, sizeof(VAL_EVENT_T));
+				eValRet = vcodec_hw_wait_turn(&EncHWWaitQueue, &EncHWWaitList, &grVcodecEncHWLock,
+								      &rWaiter, EncHWLockEvent.u4TimeoutMs);
 			}
 
 			mutex_lock(&EncHWLockEventTimeoutLock);
@@ -1005,24 +1309,30 @@ static long vcodec_lockhw(unsigned long arg)
 
 			if (FirstUseEncHW == 0) {
 				/* Add one line comment for avoid kernel coding style, WARNING:BRACES: */
-				eValRet = eVideoWaitEvent(&EncHWLockEvent, sizeof(VAL_EVENT_T));
+				eValRet = vcodec_hw_wait_turn(&EncHWWaitQueue, &EncHWWaitList, &grVcodecEncHWLock,
+								      &rWaiter, EncHWLockEvent.u4TimeoutMs);
 			}
 
 			if (VAL_RESULT_INVALID_ISR == eValRet) {
 				ret = vcodec_lockhw_enc_fail(rHWLock, FirstUseEncHW);
 				if (ret) {
 					MODULE_MFV_LOGE("[ERROR] vcodec_lockhw_enc_fail failed: %lu\n", ret);
+					vcodec_hw_waiter_leave(&VencHWLock, &EncHWWaitQueue, &rWaiter);
 					return -EFAULT;
 				}
 			} else if (VAL_RESULT_RESTARTSYS == eValRet) {
+				vcodec_hw_waiter_leave(&VencHWLock, &EncHWWaitQueue, &rWaiter);
 				return -ERESTARTSYS;
 			}
 
 			mutex_lock(&VencHWLock);
-			if (grVcodecEncHWLock.pvHandle == 0) { /* No process use HW, so current process can use HW */
+			/* No process use HW and no one queued before us, so current process can use HW */
+			if (grVcodecEncHWLock.pvHandle == 0 && vcodec_hw_waiter_first(&EncHWWaitList, &rWaiter)) {
 				if (rHWLock.eDriverType == VAL_DRIVER_TYPE_H264_ENC ||
 				    rHWLock.eDriverType == VAL_DRIVER_TYPE_HEVC_ENC ||
 				    rHWLock.eDriverType == VAL_DRIVER_TYPE_JPEG_ENC) {
+					list_del(&rWaiter.list);
+					gu8EncLockedUs = vcodec_now_us();
 					grVcodecEncHWLock.pvHandle =
 						(VAL_VOID_T *)pmem_user_v2p_video((VAL_ULONG_T)rHWLock.pvHandle);
 					grVcodecEncHWLock.eDriverType = rHWLock.eDriverType;
@@ -1037,16 +1347,25 @@ static long vcodec_lockhw(unsigned long arg)
 						 grVcodecEncHWLock.rLockedTime.u4Sec,
 						 grVcodecEncHWLock.rLockedTime.u4uSec);
 
+					vcodec_util_update(grVcodecEncHWLock.pvHandle, rHWLock.eDriverType, VAL_TRUE,
+							   gu8EncLockedUs - rWaiter.u8QueuedUs);
+
 					bLockedHW = VAL_TRUE;
 					if (rHWLock.eDriverType == VAL_DRIVER_TYPE_H264_ENC ||
 					    rHWLock.eDriverType == VAL_DRIVER_TYPE_HEVC_ENC) {
 #ifndef KS_POWER_WORKAROUND
-						venc_power_on();
+						/* still powered from the previous owner */
+						bPowerHeld = cancel_delayed_work(&VencPowerOffWork) ? VAL_TRUE : VAL_FALSE;
+						if (bPowerHeld == VAL_FALSE)
+							venc_power_on();
+#endif
+#ifdef ENABLE_MMDVFS_VDEC
+						VcodecLoadLock(&grVencLoad, gu8EncLockedUs);
 #endif
 						enable_irq(VENC_IRQ_ID);
 					}
 				}
-			} else { /* someone use HW, and check timeout value */
+			} else { /* someone use HW or queued before us, and check timeout value */
 				if (rHWLock.u4TimeoutMs == 0) {
 					bLockedHW = VAL_FALSE;
 					mutex_unlock(&VencHWLock);
@@ -1078,6 +1397,7 @@ static long vcodec_lockhw(unsigned long arg)
 						 (VAL_ULONG_T)rHWLock.pvHandle,
 						 rHWLock.eDriverType);
 					gLockTimeOutCount = 0;
+					vcodec_hw_waiter_leave_locked(&EncHWWaitQueue, &rWaiter);
 					mutex_unlock(&VencHWLock);
 					return -EFAULT;
 				}
@@ -1096,6 +1416,7 @@ static long vcodec_lockhw(unsigned long arg)
 		}
 
 		if (VAL_FALSE == bLockedHW) {
+			vcodec_hw_waiter_leave(&VencHWLock, &EncHWWaitQueue, &rWaiter);
 			MODULE_MFV_LOGE("[ERROR] VCODEC_LOCKHW %d fail,someone locked HW already,0x%lx,%lx,0x%lx,type:%d\n",
 				 current->pid,
 				 (VAL_ULONG_T)grVcodecEncHWLock.pvHandle,
@@ -1129,6 +1450,7 @@ static long vcodec_unlockhw(unsigned long arg)
 	VAL_HW_LOCK_T rHWLock;
 	VAL_RESULT_T eValRet;
 	VAL_LONG_T ret;
+	u64 u8NowUs;
 
 	MODULE_MFV_LOGD("VCODEC_UNLOCKHW + tid = %d\n", current->pid);
 
@@ -1151,19 +1473,22 @@ static long vcodec_unlockhw(unsigned long arg)
 		mutex_lock(&VdecHWLock);
 		/* Current owner give up hw lock */
 		if (grVcodecDecHWLock.pvHandle == (VAL_VOID_T *)pmem_user_v2p_video((VAL_ULONG_T)rHWLock.pvHandle)) {
+			u8NowUs = vcodec_now_us();
+			vcodec_util_update(grVcodecDecHWLock.pvHandle, rHWLock.eDriverType, VAL_FALSE,
+					   u8NowUs - gu8DecLockedUs);
 			grVcodecDecHWLock.pvHandle = 0;
 			grVcodecDecHWLock.eDriverType = VAL_DRIVER_TYPE_NONE;
 			if (rHWLock.bSecureInst == VAL_FALSE) {
 				/* Add one line comment for avoid kernel coding style, WARNING:BRACES: */
 				disable_irq(VDEC_IRQ_ID);
 			}
-			/* TODO: check if turning power off is ok */
+			/* powered off by VdecPowerOffWork unless someone locks again first */
 #ifndef KS_POWER_WORKAROUND
-			vdec_power_off();
+			schedule_delayed_work(&VdecPowerOffWork, msecs_to_jiffies(VCODEC_POWER_OFF_DELAY_MS));
 #endif
 
 #ifdef ENABLE_MMDVFS_VDEC
-			VdecDvfsAdjustment();
+			VdecDvfsAdjustment(VcodecLoadUnlock(&grVdecLoad, u8NowUs - gu8DecLockedUs));
 #endif
 
 		} else { /* Not current owner */
@@ -1174,21 +1499,28 @@ static long vcodec_unlockhw(unsigned long arg)
 			return -EFAULT;
 		}
 		mutex_unlock(&VdecHWLock);
-		eValRet = eVideoSetEvent(&DecHWLockEvent, sizeof(VAL_EVENT_T));
+		wake_up_interruptible_all(&DecHWWaitQueue);
+		eValRet = VAL_RESULT_NO_ERROR;
 	} else if (rHWLock.eDriverType == VAL_DRIVER_TYPE_H264_ENC ||
 		   rHWLock.eDriverType == VAL_DRIVER_TYPE_HEVC_ENC ||
 		   rHWLock.eDriverType == VAL_DRIVER_TYPE_JPEG_ENC) {
 		mutex_lock(&VencHWLock);
 		/* Current owner give up hw lock */
 		if (grVcodecEncHWLock.pvHandle == (VAL_VOID_T *)pmem_user_v2p_video((VAL_ULONG_T)rHWLock.pvHandle)) {
+			u8NowUs = vcodec_now_us();
+			vcodec_util_update(grVcodecEncHWLock.pvHandle, rHWLock.eDriverType, VAL_FALSE,
+					   u8NowUs - gu8EncLockedUs);
 			grVcodecEncHWLock.pvHandle = 0;
 			grVcodecEncHWLock.eDriverType = VAL_DRIVER_TYPE_NONE;
 			if (rHWLock.eDriverType == VAL_DRIVER_TYPE_H264_ENC ||
 			    rHWLock.eDriverType == VAL_DRIVER_TYPE_HEVC_ENC) {
 				disable_irq(VENC_IRQ_ID);
-				/* turn venc power off */
+#ifdef ENABLE_MMDVFS_VDEC
+				VencDvfsAdjustment(VcodecLoadUnlock(&grVencLoad, u8NowUs - gu8EncLockedUs), u8NowUs);
+#endif
+				/* turn venc power off, see VencPowerOffWork */
 #ifndef KS_POWER_WORKAROUND
-				venc_power_off();
+				schedule_delayed_work(&VencPowerOffWork, msecs_to_jiffies(VCODEC_POWER_OFF_DELAY_MS));
 #endif
 			}
 		} else { /* Not current owner */
@@ -1203,7 +1535,8 @@ static long vcodec_unlockhw(unsigned long arg)
 			return -EFAULT;
 		}
 		mutex_unlock(&VencHWLock);
-		eValRet = eVideoSetEvent(&EncHWLockEvent, sizeof(VAL_EVENT_T));
+		wake_up_interruptible_all(&EncHWWaitQueue);
+		eValRet = VAL_RESULT_NO_ERROR;
 	} else {
 		MODULE_MFV_LOGE("[WARNING] VCODEC_UNLOCKHW Unknown instance\n");
 		return -EFAULT;
@@ -1357,6 +1690,11 @@ static long vcodec_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned
 		mutex_lock(&DecEMILock);
 		gu4DecEMICounter++;
 		MODULE_MFV_LOGE("[VCODEC] DEC_EMI_USER = %d\n", gu4DecEMICounter);
+		/* first decode session switches SMI to the playback profile */
+		if (!gbDecSmiScen) {
+			smi_kernel_scenario_enter(SMI_BWC_SCEN_VP);
+			gbDecSmiScen = VAL_TRUE;
+		}
 		user_data_addr = (VAL_UINT8_T *)arg;
 		ret = copy_to_user(user_data_addr, &gu4DecEMICounter, sizeof(VAL_UINT32_T));
 		if (ret) {
@@ -1391,6 +1729,20 @@ static long vcodec_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned
 			mutex_unlock(&DecEMILock);
 			return -EFAULT;
 		}
+		if (0 == gu4DecEMICounter && gbDecSmiScen) {
+			smi_kernel_scenario_exit(SMI_BWC_SCEN_VP);
+			gbDecSmiScen = VAL_FALSE;
+		}
+#ifdef ENABLE_MMDVFS_VDEC
+		/* last decode session gone, do not keep the voltage until release */
+		if (0 == gu4DecEMICounter) {
+			mutex_lock(&VdecHWLock);
+			SendDvfsRequest(DVFS_LOW);
+			VdecDvfsEnd(DVFS_LOW);
+			memset(&grVdecLoad, 0, sizeof(grVdecLoad));
+			mutex_unlock(&VdecHWLock);
+		}
+#endif
 		mutex_unlock(&DecEMILock);
 
 		MODULE_MFV_LOGD("VCODEC_DEC_DEC_EMI_USER - tid = %d\n", current->pid);
@@ -1403,6 +1755,10 @@ static long vcodec_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned
 		mutex_lock(&EncEMILock);
 		gu4EncEMICounter++;
 		MODULE_MFV_LOGE("[VCODEC] ENC_EMI_USER = %d\n", gu4EncEMICounter);
+		if (!gbEncSmiScen) {
+			smi_kernel_scenario_enter(SMI_BWC_SCEN_VENC);
+			gbEncSmiScen = VAL_TRUE;
+		}
 		user_data_addr = (VAL_UINT8_T *)arg;
 		ret = copy_to_user(user_data_addr, &gu4EncEMICounter, sizeof(VAL_UINT32_T));
 		if (ret) {
@@ -1429,6 +1785,19 @@ static long vcodec_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned
 			mutex_unlock(&EncEMILock);
 			return -EFAULT;
 		}
+		if (0 == gu4EncEMICounter && gbEncSmiScen) {
+			smi_kernel_scenario_exit(SMI_BWC_SCEN_VENC);
+			gbEncSmiScen = VAL_FALSE;
+		}
+#ifdef ENABLE_MMDVFS_VDEC
+		if (0 == gu4EncEMICounter) {
+			mutex_lock(&VencHWLock);
+			VencDvfsRequest(DVFS_LOW);
+			gu8VencMonitorStartUs = 0;
+			memset(&grVencLoad, 0, sizeof(grVencLoad));
+			mutex_unlock(&VencHWLock);
+		}
+#endif
 		mutex_unlock(&EncEMILock);
 
 		MODULE_MFV_LOGD("VCODEC_DEC_ENC_EMI_USER - tid = %d\n", current->pid);
@@ -2173,6 +2542,7 @@ static int vcodec_release(struct inode *inode, struct file *file)
 		grVcodecDecHWLock.rLockedTime.u4Sec = 0;
 		grVcodecDecHWLock.rLockedTime.u4uSec = 0;
 		mutex_unlock(&VdecHWLock);
+		wake_up_interruptible_all(&DecHWWaitQueue);
 
 		mutex_lock(&VencHWLock);
 		grVcodecEncHWLock.pvHandle = 0;
@@ -2180,13 +2550,22 @@ static int vcodec_release(struct inode *inode, struct file *file)
 		grVcodecEncHWLock.rLockedTime.u4Sec = 0;
 		grVcodecEncHWLock.rLockedTime.u4uSec = 0;
 		mutex_unlock(&VencHWLock);
+		wake_up_interruptible_all(&EncHWWaitQueue);
 
 		mutex_lock(&DecEMILock);
 		gu4DecEMICounter = 0;
+		if (gbDecSmiScen) {
+			smi_kernel_scenario_exit(SMI_BWC_SCEN_VP);
+			gbDecSmiScen = VAL_FALSE;
+		}
 		mutex_unlock(&DecEMILock);
 
 		mutex_lock(&EncEMILock);
 		gu4EncEMICounter = 0;
+		if (gbEncSmiScen) {
+			smi_kernel_scenario_exit(SMI_BWC_SCEN_VENC);
+			gbEncSmiScen = VAL_FALSE;
+		}
 		mutex_unlock(&EncEMILock);
 
 		mutex_lock(&PWRLock);
@@ -2230,6 +2609,13 @@ static int vcodec_release(struct inode *inode, struct file *file)
 			gHWLockMaxDuration = 0;
 			SendDvfsRequest(DVFS_LOW);
 		}
+		memset(&grVdecLoad, 0, sizeof(grVdecLoad));
+
+		mutex_lock(&VencHWLock);
+		VencDvfsRequest(DVFS_LOW);
+		gu8VencMonitorStartUs = 0;
+		memset(&grVencLoad, 0, sizeof(grVencLoad));
+		mutex_unlock(&VencHWLock);
 #endif
 
 	}
@@ -2650,6 +3036,11 @@ static int __init vcodec_driver_init(void)
 		MODULE_MFV_LOGE("[VCODEC][ERROR] create enc isr event error\n");
 	}
 
+	if (!proc_create("driver/vcodec_util", S_IRUGO, NULL, &vcodec_util_fops)) {
+		/* Add one line comment for avoid kernel coding style, WARNING:BRACES: */
+		MODULE_MFV_LOGE("[VCODEC][ERROR] create /proc/driver/vcodec_util failed\n");
+	}
+
 	MODULE_MFV_LOGD("vcodec_driver_init Done\n");
 
 #ifdef CONFIG_MTK_HIBERNATION
@@ -2684,6 +3075,11 @@ static void __exit vcodec_driver_exit(void)
 	free_irq(VENC_IRQ_ID, NULL);
 	free_irq(VDEC_IRQ_ID, NULL);
 
+	remove_proc_entry("driver/vcodec_util", NULL);
+	/* run a pending power off now rather than after the module is gone */
+	flush_delayed_work(&VdecPowerOffWork);
+	flush_delayed_work(&VencPowerOffWork);
+
 	/* MT6589_HWLockEvent part */
 	eValHWLockRet = eVideoCloseEvent(&DecHWLockEvent, sizeof(VAL_EVENT_T));
 	if (VAL_RESULT_NO_ERROR != eValHWLockRet) {
@@ -25,6 +25,7 @@
 #include <linux/seq_file.h>
 #include <linux/slab.h>
 #include <linux/uaccess.h>
+#include <linux/uid_cputime.h>
 
 #define UID_HASH_BITS	10
 DECLARE_HASHTABLE(hash_table, UID_HASH_BITS);
@@ -42,6 +43,7 @@ struct uid_entry {
 	cputime_t total_stime;
 	unsigned long long active_power;
 	unsigned long long power;
+	u64 gpu_us;
 	struct hlist_node hash;
 };
 
@@ -76,7 +78,8 @@ static struct uid_entry *find_or_register_uid(uid_t uid)
 	return uid_entry;
 }
 
-static int uid_stat_show(struct seq_file *m, void *v)
+/* sum the time and power of the live tasks of each uid, uid_lock held */
+static int uid_update_active(void)
 {
 	struct uid_entry *uid_entry;
 	struct task_struct *task, *temp;
@@ -84,8 +87,6 @@ static int uid_stat_show(struct seq_file *m, void *v)
 	cputime_t stime;
 	unsigned long bkt;
 
-	mutex_lock(&uid_lock);
-
 	hash_for_each(hash_table, bkt, uid_entry, hash) {
 		uid_entry->active_stime = 0;
 		uid_entry->active_utime = 0;
@@ -98,7 +99,6 @@ static int uid_stat_show(struct seq_file *m, void *v)
 			current_user_ns(), task_uid(task)));
 		if (!uid_entry) {
 			read_unlock(&tasklist_lock);
-			mutex_unlock(&uid_lock);
 			pr_err("%s: failed to find the uid_entry for uid %d\n",
 				__func__, from_kuid_munged(current_user_ns(),
 				task_uid(task)));
@@ -116,6 +116,23 @@ static int uid_stat_show(struct seq_file *m, void *v)
 	} while_each_thread(temp, task);
 	read_unlock(&tasklist_lock);
 
+	return 0;
+}
+
+static int uid_stat_show(struct seq_file *m, void *v)
+{
+	struct uid_entry *uid_entry;
+	unsigned long bkt;
+	int ret;
+
+	mutex_lock(&uid_lock);
+
+	ret = uid_update_active();
+	if (ret) {
+		mutex_unlock(&uid_lock);
+		return ret;
+	}
+
 	hash_for_each(hash_table, bkt, uid_entry, hash) {
 		cputime_t total_utime = uid_entry->utime +
 							uid_entry->active_utime;
@@ -161,6 +178,58 @@ static const struct file_operations uid_stat_fops = {
 	.release	= single_release,
 };
 
+/*
+ * Energy inputs per uid: cpu power as weighted by the cpufreq stats power
+ * table, and gpu busy time in us as reported by GED.
+ */
+static int uid_energy_show(struct seq_file *m, void *v)
+{
+	struct uid_entry *uid_entry;
+	unsigned long bkt;
+	int ret;
+
+	mutex_lock(&uid_lock);
+
+	ret = uid_update_active();
+	if (ret) {
+		mutex_unlock(&uid_lock);
+		return ret;
+	}
+
+	hash_for_each(hash_table, bkt, uid_entry, hash)
+		seq_printf(m, "%d: %llu %llu\n", uid_entry->uid,
+			uid_entry->power + uid_entry->active_power,
+			uid_entry->gpu_us);
+
+	mutex_unlock(&uid_lock);
+	return 0;
+}
+
+static int uid_energy_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, uid_energy_show, PDE_DATA(inode));
+}
+
+static const struct file_operations uid_energy_fops = {
+	.open		= uid_energy_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+void uid_cputime_add_gpu(kuid_t uid, u64 busy_us)
+{
+	struct uid_entry *uid_entry;
+
+	mutex_lock(&uid_lock);
+	uid_entry = find_or_register_uid(from_kuid_munged(current_user_ns(),
+							  uid));
+	if (uid_entry)
+		uid_entry->gpu_us += busy_us;
+	mutex_unlock(&uid_lock);
+}
+EXPORT_SYMBOL_GPL(uid_cputime_add_gpu);
+
 static int uid_remove_open(struct inode *inode, struct file *file)
 {
 	return single_open(file, NULL, NULL);
@@ -263,6 +332,9 @@ static int __init proc_uid_cputime_init(void)
 	proc_create_data("show_uid_stat", S_IRUGO, parent, &uid_stat_fops,
 					NULL);
 
+	proc_create_data("show_uid_energy", S_IRUGO, parent, &uid_energy_fops,
+					NULL);
+
 	profile_event_register(PROFILE_TASK_EXIT, &process_notifier_block);
 
 	return 0;
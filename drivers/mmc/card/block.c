@@ -198,6 +198,7 @@ static void mmc_blk_put(struct mmc_blk_data *md)
 	if (md->usage == 0) {
 		int devidx = mmc_get_devidx(md->disk);
 		blk_cleanup_queue(md->queue.queue);
+		mmc_queue_free_tags(&md->queue);
 
 		__clear_bit(devidx, dev_use);
 
@@ -868,6 +869,15 @@ static inline int mmc_blk_part_switch(struct mmc_card *card,
 		part_config &= ~EXT_CSD_PART_CONFIG_ACC_MASK;
 		part_config |= md->part_type;
 
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+		/* RPMB can't be accessed in command queue mode */
+		if (md->part_type == EXT_CSD_PART_CONFIG_ACC_RPMB) {
+			ret = mmc_cmdq_switch(card, false);
+			if (ret)
+				return ret;
+		}
+#endif
+
 		ret = mmc_switch(card, EXT_CSD_CMD_SET_NORMAL,
 				 EXT_CSD_PART_CONFIG, part_config,
 				 card->ext_csd.part_time);
@@ -1298,7 +1308,7 @@ out:
 		goto retry;
 	if (!err)
 		mmc_blk_reset_success(md, type);
-	blk_end_request(req, err, blk_rq_bytes(req));
+	mmc_queue_end_request(req, err, blk_rq_bytes(req));
 
 	return err ? 0 : 1;
 }
@@ -1365,7 +1375,7 @@ out_retry:
 	if (!err)
 		mmc_blk_reset_success(md, type);
 out:
-	blk_end_request(req, err, blk_rq_bytes(req));
+	mmc_queue_end_request(req, err, blk_rq_bytes(req));
 
 	return err ? 0 : 1;
 }
@@ -1380,7 +1390,7 @@ static int mmc_blk_issue_flush(struct mmc_queue *mq, struct request *req)
 	if (ret)
 		ret = -EIO;
 
-	blk_end_request_all(req, ret);
+	mmc_queue_end_request(req, ret, blk_rq_bytes(req));
 
 	return ret ? 0 : 1;
 }
@@ -1814,9 +1824,7 @@ static u8 mmc_blk_prep_packed_list(struct mmc_queue *mq, struct request *req)
 			break;
 		}
 
-		spin_lock_irq(q->queue_lock);
-		next = blk_fetch_request(q);
-		spin_unlock_irq(q->queue_lock);
+		next = mmc_queue_fetch(mq);
 		if (!next) {
 			put_back = false;
 			break;
@@ -1850,11 +1858,8 @@ static u8 mmc_blk_prep_packed_list(struct mmc_queue *mq, struct request *req)
 		reqs++;
 	} while (1);
 
-	if (put_back) {
-		spin_lock_irq(q->queue_lock);
-		blk_requeue_request(q, next);
-		spin_unlock_irq(q->queue_lock);
-	}
+	if (put_back)
+		mmc_queue_requeue(mq, next);
 
 	if (reqs > 0) {
 		list_add(&req->queuelist, &mqrq->packed->list);
@@ -1972,11 +1977,11 @@ static int mmc_blk_cmd_err(struct mmc_blk_data *md, struct mmc_card *card,
 
 		blocks = mmc_sd_num_wr_blocks(card);
 		if (blocks != (u32)-1) {
-			ret = blk_end_request(req, 0, blocks << 9);
+			ret = mmc_queue_end_request(req, 0, blocks << 9);
 		}
 	} else {
 		if (!mmc_packed_cmd(mq_rq->cmd_type))
-			ret = blk_end_request(req, 0, brq->data.bytes_xfered);
+			ret = mmc_queue_end_request(req, 0, brq->data.bytes_xfered);
 	}
 	return ret;
 }
@@ -2005,7 +2010,7 @@ static int mmc_blk_end_packed_req(struct mmc_queue_req *mq_rq)
 			return ret;
 		}
 		list_del_init(&prq->queuelist);
-		blk_end_request(prq, 0, blk_rq_bytes(prq));
+		mmc_queue_end_request(prq, 0, blk_rq_bytes(prq));
 		i++;
 	}
 
@@ -2023,7 +2028,7 @@ static void mmc_blk_abort_packed_req(struct mmc_queue_req *mq_rq)
 	while (!list_empty(&packed->list)) {
 		prq = list_entry_rq(packed->list.next);
 		list_del_init(&prq->queuelist);
-		blk_end_request(prq, -EIO, blk_rq_bytes(prq));
+		mmc_queue_end_request(prq, -EIO, blk_rq_bytes(prq));
 	}
 
 	mmc_blk_clear_packed(mq_rq);
@@ -2033,7 +2038,6 @@ static void mmc_blk_revert_packed_req(struct mmc_queue *mq,
 				      struct mmc_queue_req *mq_rq)
 {
 	struct request *prq;
-	struct request_queue *q = mq->queue;
 	struct mmc_packed *packed = mq_rq->packed;
 
 	BUG_ON(!packed);
@@ -2042,9 +2046,7 @@ static void mmc_blk_revert_packed_req(struct mmc_queue *mq,
 		prq = list_entry_rq(packed->list.prev);
 		if (prq->queuelist.prev != &packed->list) {
 			list_del_init(&prq->queuelist);
-			spin_lock_irq(q->queue_lock);
-			blk_requeue_request(mq->queue, prq);
-			spin_unlock_irq(q->queue_lock);
+			mmc_queue_requeue(mq, prq);
 		} else {
 			list_del_init(&prq->queuelist);
 		}
@@ -2541,7 +2543,7 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 				ret = mmc_blk_end_packed_req(mq_rq);
 				break;
 			} else {
-				ret = blk_end_request(req, 0,
+				ret = mmc_queue_end_request(req, 0,
 						brq->data.bytes_xfered);
 			}
 
@@ -2595,7 +2597,7 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 			 * time, so we only reach here after trying to
 			 * read a single sector.
 			 */
-			ret = blk_end_request(req, -EIO,
+			ret = mmc_queue_end_request(req, -EIO,
 						brq->data.blksz);
 			if (!ret)
 				goto start_new_req;
@@ -2638,7 +2640,7 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 		if (mmc_card_removed(card))
 			req->cmd_flags |= REQ_QUIET;
 		while (ret)
-			ret = blk_end_request(req, -EIO,
+			ret = mmc_queue_end_request(req, -EIO,
 					blk_rq_cur_bytes(req));
 	}
 
@@ -2646,7 +2648,7 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 	if (rqc) {
 		if (mmc_card_removed(card)) {
 			rqc->cmd_flags |= REQ_QUIET;
-			blk_end_request_all(rqc, -EIO);
+			mmc_queue_end_request(rqc, -EIO, blk_rq_bytes(rqc));
 		} else {
 			/*
 			 * If current request is packed, it needs to put back.
@@ -2663,6 +2665,286 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 	return 0;
 }
 
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+/*
+ * Software command queue.
+ * Requests are queued on the card with CMD44/CMD45 under a task ID,
+ * CMD13 with SQS set tells which tasks the card is ready to run and
+ * CMD46/CMD47 move their data. The card sees up to cmdq_depth requests
+ * at once and picks the order, while the host still transfers one
+ * task at a time.
+ */
+#define MMC_CMDQ_POLL_TIMEOUT_MS	(10 * 1000)	/* 10 second timeout */
+
+static inline bool mmc_blk_cmdq_rel_wr(struct mmc_blk_data *md,
+				       struct request *req)
+{
+	return ((req->cmd_flags & REQ_FUA) || (req->cmd_flags & REQ_META)) &&
+		(rq_data_dir(req) == WRITE) && (md->flags & MMC_BLK_REL_WR);
+}
+
+static bool mmc_blk_cmdq_can_queue(struct mmc_queue *mq, struct request *req)
+{
+	struct mmc_blk_data *md = mq->data;
+	struct mmc_card *card = mq->card;
+
+	if (!mq->mqrq_cmdq || !card->ext_csd.cmdq_support ||
+	    !(card->host->caps2 & MMC_CAP2_CMDQ))
+		return false;
+
+	if (md->part_type == EXT_CSD_PART_CONFIG_ACC_RPMB ||
+	    (req->cmd_flags & MMC_REQ_SPECIAL_MASK))
+		return false;
+
+	/* Legacy reliable writes have alignment rules a task can't follow */
+	if (mmc_blk_cmdq_rel_wr(md, req) &&
+	    !(card->ext_csd.rel_param & EXT_CSD_WR_REL_PARAM_EN))
+		return false;
+
+	return true;
+}
+
+/*
+ * Put the card in the mode the request needs: command queue mode for
+ * requests that can be queued as tasks, legacy mode for the rest.
+ * Returns true when the request should go through the command queue.
+ */
+static bool mmc_blk_cmdq_prepare(struct mmc_queue *mq, struct request *req)
+{
+	struct mmc_card *card = mq->card;
+	bool cmdq;
+
+	if (!req)
+		return false;
+
+	cmdq = mmc_blk_cmdq_can_queue(mq, req);
+	if (cmdq == card->ext_csd.cmdq_en)
+		return cmdq;
+
+	/* complete ongoing async transfer before switching modes */
+	if (card->host->areq)
+		mmc_blk_issue_rw_rq(mq, NULL);
+
+	if (mmc_cmdq_switch(card, cmdq) && cmdq) {
+		pr_warn("%s: command queue unusable, using legacy transfers\n",
+			mmc_hostname(card->host));
+		card->ext_csd.cmdq_support = false;
+		return false;
+	}
+
+	return cmdq;
+}
+
+static struct request *mmc_blk_cmdq_fetch(struct mmc_queue *mq)
+{
+	struct request *req;
+
+	spin_lock_irq(mmc_queue_lock(mq));
+	req = __mmc_queue_peek(mq);
+	if (req && mmc_blk_cmdq_can_queue(mq, req))
+		__mmc_queue_start(mq, req);
+	else
+		req = NULL;
+	spin_unlock_irq(mmc_queue_lock(mq));
+
+	return req;
+}
+
+static int mmc_blk_cmdq_queue_task(struct mmc_queue *mq, unsigned int tag)
+{
+	struct mmc_blk_data *md = mq->data;
+	struct mmc_card *card = mq->card;
+	struct mmc_queue_req *mqrq = &mq->mqrq_cmdq[tag];
+	struct mmc_blk_request *brq = &mqrq->brq;
+	struct request *req = mqrq->req;
+	struct mmc_command cmd = {0};
+	bool read = rq_data_dir(req) == READ;
+	int err;
+
+	memset(brq, 0, sizeof(struct mmc_blk_request));
+	brq->mrq.cmd = &brq->cmd;
+	brq->mrq.data = &brq->data;
+
+	brq->cmd.opcode = read ? MMC_EXECUTE_READ_TASK :
+		MMC_EXECUTE_WRITE_TASK;
+	brq->cmd.arg = MMC_CMDQ_TASK_ID(tag);
+	brq->cmd.flags = MMC_RSP_R1 | MMC_CMD_ADTC;
+
+	brq->data.blksz = 512;
+	brq->data.blocks = min(blk_rq_sectors(req), card->host->max_blk_count);
+	brq->data.flags = read ? MMC_DATA_READ : MMC_DATA_WRITE;
+	mmc_set_data_timeout(&brq->data, card);
+	brq->data.sg = mqrq->sg;
+	brq->data.sg_len = mmc_queue_map_sg(mq, mqrq);
+
+	cmd.opcode = MMC_QUE_TASK_PARAMS;
+	cmd.arg = brq->data.blocks | MMC_CMDQ_TASK_ID(tag) |
+		(read ? MMC_CMDQ_DATA_DIR_READ : 0) |
+		(read && rq_is_sync(req) ? MMC_CMDQ_PRIORITY : 0) |
+		(mmc_blk_cmdq_rel_wr(md, req) ? MMC_CMDQ_REL_WR : 0);
+	cmd.flags = MMC_RSP_R1 | MMC_CMD_AC;
+	err = mmc_wait_for_cmd(card->host, &cmd, 0);
+	if (!err && (cmd.resp[0] & CMD_ERRORS))
+		err = -EIO;
+	if (err)
+		return err;
+
+	cmd.opcode = MMC_QUE_TASK_ADDR;
+	cmd.arg = blk_rq_pos(req);
+	if (!mmc_card_blockaddr(card))
+		cmd.arg <<= 9;
+	err = mmc_wait_for_cmd(card->host, &cmd, 0);
+	if (!err && (cmd.resp[0] & CMD_ERRORS))
+		err = -EIO;
+	if (err)
+		return err;
+
+	__set_bit(tag, &mq->cmdq_tasks);
+	return 0;
+}
+
+/*
+ * Poll the queue status register until at least one queued task is
+ * ready for execution.
+ */
+static int mmc_blk_cmdq_wait_ready(struct mmc_queue *mq, unsigned long *ready)
+{
+	struct mmc_card *card = mq->card;
+	struct mmc_command cmd = {0};
+	unsigned long timeout;
+	int err;
+
+	timeout = jiffies + msecs_to_jiffies(MMC_CMDQ_POLL_TIMEOUT_MS);
+	do {
+		cmd.opcode = MMC_SEND_STATUS;
+		cmd.arg = card->rca << 16 | MMC_SEND_STATUS_SQS;
+		cmd.flags = MMC_RSP_R1 | MMC_CMD_AC;
+		err = mmc_wait_for_cmd(card->host, &cmd, 0);
+		if (err)
+			return err;
+
+		*ready = cmd.resp[0] & mq->cmdq_tasks;
+		if (*ready)
+			return 0;
+		cond_resched();
+	} while (time_before(jiffies, timeout));
+
+	return -ETIMEDOUT;
+}
+
+static int mmc_blk_cmdq_execute(struct mmc_queue *mq, unsigned int tag)
+{
+	struct mmc_card *card = mq->card;
+	struct mmc_queue_req *mqrq = &mq->mqrq_cmdq[tag];
+	struct mmc_blk_request *brq = &mqrq->brq;
+	struct request *req = mqrq->req;
+	int err;
+
+	mmc_wait_for_req(card->host, &brq->mrq);
+	__clear_bit(tag, &mq->cmdq_tasks);
+
+	err = brq->cmd.error ? brq->cmd.error : brq->data.error;
+	if (!err && (brq->cmd.resp[0] & CMD_ERRORS))
+		err = -EIO;
+	if (err)
+		return err;
+
+	mqrq->req = NULL;
+	if (mmc_queue_end_request(req, 0, brq->data.bytes_xfered))
+		mmc_queue_requeue(mq, req);
+
+	return 0;
+}
+
+/*
+ * Drop every queued task and leave command queue mode for good, the
+ * requests go back to the block queue and are redone by the legacy
+ * path with its own error recovery.
+ */
+static void mmc_blk_cmdq_abort(struct mmc_queue *mq, int err)
+{
+	struct mmc_card *card = mq->card;
+	struct mmc_command cmd = {0};
+	unsigned int i;
+
+	pr_err("%s: command queue error %d, using legacy transfers\n",
+	       mmc_hostname(card->host), err);
+
+	if (mq->cmdq_tasks) {
+		cmd.opcode = MMC_CMDQ_TASK_MGMT;
+		cmd.arg = MMC_CMDQ_DISCARD_QUEUE;
+		cmd.flags = MMC_RSP_R1B | MMC_CMD_AC;
+		mmc_wait_for_cmd(card->host, &cmd, 0);
+		mq->cmdq_tasks = 0;
+	}
+
+	card->ext_csd.cmdq_support = false;
+	mmc_cmdq_switch(card, false);
+
+	for (i = 0; i < mq->cmdq_depth; i++) {
+		if (mq->mqrq_cmdq[i].req) {
+			mmc_queue_requeue(mq, mq->mqrq_cmdq[i].req);
+			mq->mqrq_cmdq[i].req = NULL;
+		}
+	}
+}
+
+static int mmc_blk_cmdq_issue_rw_rq(struct mmc_queue *mq, struct request *req)
+{
+	unsigned long ready;
+	unsigned int tag;
+	int err;
+
+	/* The request lives in a task slot, not in the legacy pair */
+	mq->mqrq_cur->req = NULL;
+
+	while (req || mq->cmdq_tasks) {
+		/* Fill the card queue first so the card can pick the order */
+		while (req) {
+			tag = ffz(mq->cmdq_tasks);
+			mq->mqrq_cmdq[tag].req = req;
+			err = mmc_blk_cmdq_queue_task(mq, tag);
+			if (err)
+				goto abort;
+
+			req = NULL;
+			if (hweight_long(mq->cmdq_tasks) < mq->cmdq_depth)
+				req = mmc_blk_cmdq_fetch(mq);
+		}
+
+		err = mmc_blk_cmdq_wait_ready(mq, &ready);
+		if (err)
+			goto abort;
+
+		for_each_set_bit(tag, &ready, mq->cmdq_depth) {
+			err = mmc_blk_cmdq_execute(mq, tag);
+			if (err)
+				goto abort;
+		}
+
+		req = mmc_blk_cmdq_fetch(mq);
+	}
+
+	return 1;
+
+ abort:
+	mmc_blk_cmdq_abort(mq, err);
+	return 0;
+}
+#else
+static inline bool mmc_blk_cmdq_prepare(struct mmc_queue *mq,
+					struct request *req)
+{
+	return false;
+}
+
+static inline int mmc_blk_cmdq_issue_rw_rq(struct mmc_queue *mq,
+					   struct request *req)
+{
+	return 0;
+}
+#endif
+
 static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 {
 	int ret;
@@ -2671,6 +2953,7 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 	struct mmc_host *host = card->host;
 	unsigned long flags;
 	unsigned int cmd_flags = req ? req->cmd_flags : 0;
+	bool cmdq = false;
 
 #ifdef CONFIG_MMC_BLOCK_DEFERRED_RESUME
 	if (mmc_bus_needs_resume(card->host))
@@ -2689,7 +2972,7 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 	ret = mmc_blk_part_switch(card, md);
 	if (ret) {
 		if (req) {
-			blk_end_request_all(req, -EIO);
+			mmc_queue_end_request(req, -EIO, blk_rq_bytes(req));
 		}
 		ret = 0;
 		goto out;
@@ -2709,6 +2992,9 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 		if (card->host->areq)
 			mmc_blk_issue_rw_rq(mq, NULL);
 		ret = mmc_blk_issue_flush(mq, req);
+	} else if (mmc_blk_cmdq_prepare(mq, req)) {
+		ret = mmc_blk_cmdq_issue_rw_rq(mq, req);
+		cmdq = true;
 	} else {
 		if (!req && host->areq) {
 			spin_lock_irqsave(&host->context_info.lock, flags);
@@ -2720,12 +3006,14 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 
 out:
 	if ((!req && !(mq->flags & MMC_QUEUE_NEW_REQUEST)) ||
-	     (cmd_flags & MMC_REQ_SPECIAL_MASK)) {
+	     (cmd_flags & MMC_REQ_SPECIAL_MASK) || cmdq) {
 		/*
 		 * Release host when there are no more requests
 		 * and after special request(discard, flush) is done.
 		 * In case sepecial request, there is no reentry to
 		 * the 'mmc_blk_issue_rq' with 'mqrq_prev->req'.
+		 * The same goes for command queue batches, they
+		 * only return once every task is done.
 		 */
 		mmc_put_card(card);
 #ifdef MTK_BKOPS_IDLE_MAYA
@@ -2884,6 +3172,13 @@ static struct mmc_blk_data *mmc_blk_alloc_req(struct mmc_card *card,
 			md->flags |= MMC_BLK_PACKED_CMD;
 	}
 
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+	if (mmc_card_mmc(card) && card->ext_csd.cmdq_support &&
+	    (card->host->caps2 & MMC_CAP2_CMDQ) &&
+	    area_type != MMC_BLK_DATA_AREA_RPMB)
+		mmc_cmdq_init(&md->queue, card);
+#endif
+
 	return md;
 
  err_putdisk:
@@ -2987,6 +3282,9 @@ static void mmc_blk_remove_req(struct mmc_blk_data *md)
 		mmc_cleanup_queue(&md->queue);
 		if (md->flags & MMC_BLK_PACKED_CMD)
 			mmc_packed_clean(&md->queue);
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+		mmc_cmdq_clean(&md->queue);
+#endif
 		if (md->disk->flags & GENHD_FL_UP) {
 			device_remove_file(disk_to_dev(md->disk), &md->force_ro);
 			if ((md->area_type & MMC_BLK_DATA_AREA_BOOT) &&
@@ -23,6 +23,10 @@
 #include <linux/uaccess.h>
 #include <linux/seq_file.h>
 #include <linux/module.h>
+#include <linux/sort.h>
+#include <linux/vmalloc.h>
+#include <linux/ktime.h>
+#include <linux/bitops.h>
 
 #define RESULT_OK		0
 #define RESULT_FAIL		1
@@ -90,6 +94,8 @@ struct mmc_test_area {
  * @ts: time values of transfer
  * @rate: calculated transfer rate
  * @iops: I/O operations per second (times 100)
+ * @qd: queue depth of a latency test, 0 for the others
+ * @lat_us: p50, p99 and p99.9 latency of a latency test
  */
 struct mmc_test_transfer_result {
 	struct list_head link;
@@ -98,6 +104,8 @@ struct mmc_test_transfer_result {
 	struct timespec ts;
 	unsigned int rate;
 	unsigned int iops;
+	unsigned int qd;
+	unsigned int lat_us[3];
 };
 
 /**
@@ -517,18 +525,18 @@ static unsigned int mmc_test_rate(uint64_t bytes, struct timespec *ts)
 /*
  * Save transfer results for future usage
  */
-static void mmc_test_save_transfer_result(struct mmc_test_card *test,
-	unsigned int count, unsigned int sectors, struct timespec ts,
-	unsigned int rate, unsigned int iops)
+static struct mmc_test_transfer_result *mmc_test_save_transfer_result(
+	struct mmc_test_card *test, unsigned int count, unsigned int sectors,
+	struct timespec ts, unsigned int rate, unsigned int iops)
 {
 	struct mmc_test_transfer_result *tr;
 
 	if (!test->gr)
-		return;
+		return NULL;
 
-	tr = kmalloc(sizeof(struct mmc_test_transfer_result), GFP_KERNEL);
+	tr = kzalloc(sizeof(struct mmc_test_transfer_result), GFP_KERNEL);
 	if (!tr)
-		return;
+		return NULL;
 
 	tr->count = count;
 	tr->sectors = sectors;
@@ -537,6 +545,7 @@ static void mmc_test_save_transfer_result(struct mmc_test_card *test,
 	tr->iops = iops;
 
 	list_add_tail(&tr->link, &test->gr->tr_lst);
+	return tr;
 }
 
 /*
@@ -2351,6 +2360,666 @@ static int mmc_test_hw_reset(struct mmc_test_card *test)
 	return RESULT_FAIL;
 }
 
+/*
+ * Latency tests.  Each 4k request is timed from when it is given to the
+ * host, or queued on the card, until it has completed, and the times of a
+ * run are sorted for percentiles.  With the software command queue
+ * (MTK_EMMC_CQ_SUPPORT) queue depths past the two requests the host can
+ * pipeline are done as card tasks, so the same depth compares the legacy,
+ * the async and the command queue paths.
+ */
+#define MMC_TEST_LAT_CNT	4000	/* requests per run, at most */
+#define MMC_TEST_LAT_SECS	10	/* time per run, at most */
+#define MMC_TEST_LAT_SZ		4096
+#define MMC_TEST_LAT_QD_MAX	32
+#define MMC_TEST_LAT_BG_SZ	(256 * 1024)	/* background write */
+#define MMC_TEST_LAT_DISCARD_SZ	(1024 * 1024)
+#define MMC_TEST_LAT_DISCARD_EVERY 16	/* reads per discard */
+#define MMC_TEST_CMDQ_POLL_MS	(10 * 1000)
+
+#define MMC_TEST_CMD_ERRORS						\
+	(R1_OUT_OF_RANGE | R1_ADDRESS_ERROR | R1_BLOCK_LEN_ERROR |	\
+	 R1_WP_VIOLATION | R1_CC_ERROR | R1_ERROR)
+
+/**
+ * struct mmc_test_lat_req - one request of a latency test.
+ * @areq: for the async path
+ * @mrq: request
+ * @cmd: CMD18/CMD25, or CMD46/CMD47 for a task
+ * @stop: CMD12
+ * @data: data
+ * @start: when it was given to the host or queued
+ */
+struct mmc_test_lat_req {
+	struct mmc_test_async_req areq;
+	struct mmc_request mrq;
+	struct mmc_command cmd;
+	struct mmc_command stop;
+	struct mmc_data data;
+	ktime_t start;
+};
+
+/**
+ * struct mmc_test_lat - latency test state.
+ * @ns: latency of each request that completed
+ * @cnt: number of them
+ * @last_ea: erase group of the last random address
+ * @ts1: start of the run
+ * @ts2: end of the run
+ * @req: one per request in flight
+ */
+struct mmc_test_lat {
+	u64 ns[MMC_TEST_LAT_CNT];
+	unsigned int cnt;
+	unsigned int last_ea;
+	struct timespec ts1;
+	struct timespec ts2;
+	struct mmc_test_lat_req req[MMC_TEST_LAT_QD_MAX];
+};
+
+static struct mmc_test_lat *mmc_test_lat_alloc(void)
+{
+	return vzalloc(sizeof(struct mmc_test_lat));
+}
+
+static void mmc_test_lat_start(struct mmc_test_lat *lat)
+{
+	lat->cnt = 0;
+	getnstimeofday(&lat->ts1);
+}
+
+static bool mmc_test_lat_done(struct mmc_test_lat *lat, unsigned int queued)
+{
+	struct timespec ts;
+
+	if (queued >= MMC_TEST_LAT_CNT)
+		return true;
+	getnstimeofday(&ts);
+	ts = timespec_sub(ts, lat->ts1);
+	return ts.tv_sec >= MMC_TEST_LAT_SECS;
+}
+
+static void mmc_test_lat_add(struct mmc_test_lat *lat, ktime_t start)
+{
+	if (lat->cnt < MMC_TEST_LAT_CNT)
+		lat->ns[lat->cnt++] = ktime_to_ns(ktime_sub(ktime_get(), start));
+}
+
+/*
+ * A random address in the last three quarters of the card, in a new
+ * erase group each time, as mmc_test_rnd_perf() does.
+ */
+static unsigned int mmc_test_lat_addr(struct mmc_test_card *test,
+				      struct mmc_test_lat *lat,
+				      unsigned int ssz)
+{
+	unsigned int rnd_addr, range1, range2, ea;
+
+	rnd_addr = mmc_test_capacity(test->card) / 4;
+	range1 = rnd_addr / test->card->pref_erase;
+	range2 = test->card->pref_erase / ssz;
+
+	ea = mmc_test_rnd_num(range1);
+	if (ea == lat->last_ea)
+		ea -= 1;
+	lat->last_ea = ea;
+	return rnd_addr + test->card->pref_erase * ea +
+	       ssz * mmc_test_rnd_num(range2);
+}
+
+static int mmc_test_lat_cmp(const void *a, const void *b)
+{
+	u64 x = *(const u64 *)a, y = *(const u64 *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/*
+ * Print and save the percentiles of a run.
+ */
+static void mmc_test_print_lat(struct mmc_test_card *test,
+			       struct mmc_test_lat *lat, const char *what,
+			       unsigned int qd, const char *mode)
+{
+	struct mmc_test_transfer_result *tr;
+	unsigned int rate, iops, i, sectors = MMC_TEST_LAT_SZ >> 9;
+	unsigned int us[4];
+	struct timespec ts;
+
+	getnstimeofday(&lat->ts2);
+	if (!lat->cnt)
+		return;
+
+	sort(lat->ns, lat->cnt, sizeof(u64), mmc_test_lat_cmp, NULL);
+	us[0] = div_u64(lat->ns[lat->cnt / 2], NSEC_PER_USEC);
+	us[1] = div_u64(lat->ns[lat->cnt * 99 / 100], NSEC_PER_USEC);
+	us[2] = div_u64(lat->ns[lat->cnt * 999 / 1000], NSEC_PER_USEC);
+	us[3] = div_u64(lat->ns[lat->cnt - 1], NSEC_PER_USEC);
+
+	ts = timespec_sub(lat->ts2, lat->ts1);
+	rate = mmc_test_rate((uint64_t)lat->cnt * MMC_TEST_LAT_SZ, &ts);
+	iops = mmc_test_rate(lat->cnt * 100, &ts); /* I/O ops per sec x 100 */
+
+	pr_info("%s: %s latency of %u x %u sectors at depth %u (%s): "
+			 "p50 %u us, p99 %u us, p99.9 %u us, max %u us "
+			 "(%u kB/s, %u.%02u IOPS)\n",
+			 mmc_hostname(test->card->host), what, lat->cnt,
+			 sectors, qd, mode, us[0], us[1], us[2], us[3],
+			 rate / 1000, iops / 100, iops % 100);
+
+	tr = mmc_test_save_transfer_result(test, lat->cnt, sectors, ts, rate,
+					   iops);
+	if (tr) {
+		tr->qd = qd;
+		for (i = 0; i < ARRAY_SIZE(tr->lat_us); i++)
+			tr->lat_us[i] = us[i];
+	}
+}
+
+static void mmc_test_lat_reset(struct mmc_test_lat_req *r)
+{
+	mmc_test_nonblock_reset(&r->mrq, &r->cmd, &r->stop, &r->data);
+}
+
+/*
+ * Depth 1: one request after the other, a write waits for the card to
+ * finish programming.
+ */
+static int mmc_test_lat_sync(struct mmc_test_card *test,
+			     struct mmc_test_lat *lat, int write)
+{
+	struct mmc_test_area *t = &test->area;
+	unsigned int i;
+	ktime_t start;
+	int ret;
+
+	for (i = 0; !mmc_test_lat_done(lat, i); i++) {
+		start = ktime_get();
+		ret = mmc_test_area_transfer(test,
+				mmc_test_lat_addr(test, lat, t->blocks), write);
+		if (ret)
+			return ret;
+		mmc_test_lat_add(lat, start);
+	}
+	return 0;
+}
+
+/*
+ * Depth 2 through mmc_start_req(): the host prepares the next request
+ * while the card works on the current one.
+ */
+static int mmc_test_lat_async(struct mmc_test_card *test,
+			      struct mmc_test_lat *lat, int write)
+{
+	struct mmc_test_area *t = &test->area;
+	struct mmc_test_lat_req *cur = &lat->req[0], *other = &lat->req[1];
+	struct mmc_test_lat_req *tmp;
+	struct mmc_async_req *done;
+	unsigned int i;
+	int ret = 0;
+
+	for (i = 0; ; i++) {
+		if (!mmc_test_lat_done(lat, i)) {
+			mmc_test_lat_reset(cur);
+			cur->areq.areq.mrq = &cur->mrq;
+			cur->areq.areq.err_check = mmc_test_check_result_async;
+			cur->areq.test = test;
+			mmc_test_prepare_mrq(test, &cur->mrq, t->sg, t->sg_len,
+				mmc_test_lat_addr(test, lat, t->blocks),
+				t->blocks, 512, write);
+			cur->start = ktime_get();
+			done = mmc_start_req(test->card->host, &cur->areq.areq,
+					     &ret);
+		} else {
+			done = mmc_start_req(test->card->host, NULL, &ret);
+			cur = NULL;
+		}
+		if (ret)
+			return ret;
+		if (done)
+			mmc_test_lat_add(lat, container_of(done,
+				struct mmc_test_lat_req, areq.areq)->start);
+		if (!cur)
+			return 0;
+
+		tmp = cur;
+		cur = other;
+		other = tmp;
+	}
+}
+
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+static bool mmc_test_can_cmdq(struct mmc_test_card *test)
+{
+	return test->card->ext_csd.cmdq_support &&
+	       (test->card->host->caps2 & MMC_CAP2_CMDQ);
+}
+
+static int mmc_test_cmdq_cmd(struct mmc_test_card *test, u32 opcode, u32 arg)
+{
+	struct mmc_command cmd = {0};
+	int err;
+
+	cmd.opcode = opcode;
+	cmd.arg = arg;
+	cmd.flags = MMC_RSP_R1 | MMC_CMD_AC;
+	err = mmc_wait_for_cmd(test->card->host, &cmd, 0);
+	if (!err && (cmd.resp[0] & MMC_TEST_CMD_ERRORS))
+		err = -EIO;
+	return err;
+}
+
+/*
+ * Queue a task on the card with CMD44/CMD45, its data is moved later by
+ * mmc_test_cmdq_execute().
+ */
+static int mmc_test_cmdq_queue(struct mmc_test_card *test,
+			       struct mmc_test_lat_req *r, unsigned int tag,
+			       struct scatterlist *sg, unsigned int sg_len,
+			       unsigned int dev_addr, unsigned int blocks,
+			       int write)
+{
+	int err;
+
+	mmc_test_lat_reset(r);
+	r->mrq.stop = NULL;
+	r->cmd.opcode = write ? MMC_EXECUTE_WRITE_TASK : MMC_EXECUTE_READ_TASK;
+	r->cmd.arg = MMC_CMDQ_TASK_ID(tag);
+	r->cmd.flags = MMC_RSP_R1 | MMC_CMD_ADTC;
+	r->data.blksz = 512;
+	r->data.blocks = blocks;
+	r->data.flags = write ? MMC_DATA_WRITE : MMC_DATA_READ;
+	r->data.sg = sg;
+	r->data.sg_len = sg_len;
+	mmc_set_data_timeout(&r->data, test->card);
+
+	r->start = ktime_get();
+	err = mmc_test_cmdq_cmd(test, MMC_QUE_TASK_PARAMS, blocks |
+				MMC_CMDQ_TASK_ID(tag) |
+				(write ? 0 : MMC_CMDQ_DATA_DIR_READ |
+					     MMC_CMDQ_PRIORITY));
+	if (err)
+		return err;
+
+	if (!mmc_card_blockaddr(test->card))
+		dev_addr <<= 9;
+	return mmc_test_cmdq_cmd(test, MMC_QUE_TASK_ADDR, dev_addr);
+}
+
+static int mmc_test_cmdq_wait_ready(struct mmc_test_card *test,
+				    unsigned long tasks, unsigned long *ready)
+{
+	struct mmc_command cmd = {0};
+	unsigned long timeout;
+	int err;
+
+	timeout = jiffies + msecs_to_jiffies(MMC_TEST_CMDQ_POLL_MS);
+	do {
+		cmd.opcode = MMC_SEND_STATUS;
+		cmd.arg = test->card->rca << 16 | MMC_SEND_STATUS_SQS;
+		cmd.flags = MMC_RSP_R1 | MMC_CMD_AC;
+		err = mmc_wait_for_cmd(test->card->host, &cmd, 0);
+		if (err)
+			return err;
+
+		*ready = cmd.resp[0] & tasks;
+		if (*ready)
+			return 0;
+		cond_resched();
+	} while (time_before(jiffies, timeout));
+
+	return -ETIMEDOUT;
+}
+
+static int mmc_test_cmdq_execute(struct mmc_test_card *test,
+				 struct mmc_test_lat_req *r)
+{
+	mmc_wait_for_req(test->card->host, &r->mrq);
+	if (!r->cmd.error && !r->data.error &&
+	    (r->cmd.resp[0] & MMC_TEST_CMD_ERRORS))
+		return -EIO;
+	return mmc_test_check_result(test, &r->mrq);
+}
+
+static int mmc_test_cmdq_begin(struct mmc_test_card *test)
+{
+	return mmc_cmdq_switch(test->card, true);
+}
+
+/* Drop what is still queued if asked to, and go back to legacy transfers */
+static void mmc_test_cmdq_end(struct mmc_test_card *test, bool discard)
+{
+	struct mmc_command cmd = {0};
+
+	if (discard) {
+		cmd.opcode = MMC_CMDQ_TASK_MGMT;
+		cmd.arg = MMC_CMDQ_DISCARD_QUEUE;
+		cmd.flags = MMC_RSP_R1B | MMC_CMD_AC;
+		mmc_wait_for_cmd(test->card->host, &cmd, 0);
+	}
+	mmc_cmdq_switch(test->card, false);
+}
+
+/*
+ * Depth 2 and up as card tasks: the queue is kept full and the card
+ * picks which ready task runs next.
+ */
+static int mmc_test_lat_cmdq(struct mmc_test_card *test,
+			     struct mmc_test_lat *lat, int write,
+			     unsigned int qd)
+{
+	struct mmc_test_area *t = &test->area;
+	unsigned long tasks = 0, ready;
+	unsigned int tag, queued = 0;
+	int ret;
+
+	ret = mmc_test_cmdq_begin(test);
+	if (ret)
+		return ret;
+
+	do {
+		while (!mmc_test_lat_done(lat, queued) &&
+		       hweight_long(tasks) < qd) {
+			tag = ffz(tasks);
+			ret = mmc_test_cmdq_queue(test, &lat->req[tag], tag,
+					t->sg, t->sg_len,
+					mmc_test_lat_addr(test, lat, t->blocks),
+					t->blocks, write);
+			if (ret)
+				goto out;
+			__set_bit(tag, &tasks);
+			queued++;
+		}
+
+		ret = mmc_test_cmdq_wait_ready(test, tasks, &ready);
+		if (ret)
+			goto out;
+
+		for_each_set_bit(tag, &ready, qd) {
+			ret = mmc_test_cmdq_execute(test, &lat->req[tag]);
+			__clear_bit(tag, &tasks);
+			if (ret)
+				goto out;
+			mmc_test_lat_add(lat, lat->req[tag].start);
+		}
+	} while (tasks);
+
+out:
+	mmc_test_cmdq_end(test, tasks != 0);
+	return ret;
+}
+#else
+static inline bool mmc_test_can_cmdq(struct mmc_test_card *test)
+{
+	return false;
+}
+
+static inline int mmc_test_lat_cmdq(struct mmc_test_card *test,
+				    struct mmc_test_lat *lat, int write,
+				    unsigned int qd)
+{
+	return RESULT_UNSUP_HOST;
+}
+#endif
+
+static int mmc_test_random_lat(struct mmc_test_card *test, int write)
+{
+	const char *what = write ? "Random write" : "Random read";
+	struct mmc_test_lat *lat;
+	unsigned int qd, max_qd = 0, last_qd = 0;
+	int ret;
+
+	ret = mmc_test_area_map(test, MMC_TEST_LAT_SZ, 0, 0);
+	if (ret)
+		return ret;
+
+	lat = mmc_test_lat_alloc();
+	if (!lat)
+		return -ENOMEM;
+
+	mmc_test_lat_start(lat);
+	ret = mmc_test_lat_sync(test, lat, write);
+	if (ret)
+		goto out;
+	mmc_test_print_lat(test, lat, what, 1, "sync");
+
+	mmc_test_lat_start(lat);
+	ret = mmc_test_lat_async(test, lat, write);
+	if (ret)
+		goto out;
+	mmc_test_print_lat(test, lat, what, 2, "async");
+
+	if (mmc_test_can_cmdq(test))
+		max_qd = min_t(unsigned int, MMC_TEST_LAT_QD_MAX,
+			       test->card->ext_csd.cmdq_depth);
+
+	for (qd = 2; qd <= MMC_TEST_LAT_QD_MAX; qd <<= 1) {
+		unsigned int depth = min(qd, max_qd);
+
+		if (depth < 2 || depth == last_qd)
+			break;
+		last_qd = depth;
+
+		mmc_test_lat_start(lat);
+		ret = mmc_test_lat_cmdq(test, lat, write, depth);
+		if (ret)
+			goto out;
+		mmc_test_print_lat(test, lat, what, depth, "cmdq");
+	}
+out:
+	vfree(lat);
+	return ret;
+}
+
+/*
+ * Random 4k read latency by queue depth.
+ */
+static int mmc_test_random_read_lat(struct mmc_test_card *test)
+{
+	return mmc_test_random_lat(test, 0);
+}
+
+/*
+ * Random 4k write latency by queue depth.
+ */
+static int mmc_test_random_write_lat(struct mmc_test_card *test)
+{
+	return mmc_test_random_lat(test, 1);
+}
+
+/*
+ * 4k reads issued while a large write is in flight, which is what a
+ * foreground read meets when the page cache is being written back.  The
+ * read is timed from when it is issued, so the wait for the write is in.
+ */
+static int mmc_test_read_lat_bg_write(struct mmc_test_card *test)
+{
+	struct mmc_test_area *t = &test->area;
+	struct mmc_test_lat *lat;
+	struct mmc_test_lat_req *w, *r;
+	struct mmc_async_req *done;
+	struct scatterlist sg;
+	unsigned long wsz = min_t(unsigned long, MMC_TEST_LAT_BG_SZ,
+				  t->max_tfr);
+	unsigned int i, waddr = t->dev_addr;
+	int ret = 0;
+
+	/* the write uses the area, the read the test buffer */
+	ret = mmc_test_area_map(test, wsz, 0, 0);
+	if (ret)
+		return ret;
+	sg_init_one(&sg, test->buffer, MMC_TEST_LAT_SZ);
+
+	lat = mmc_test_lat_alloc();
+	if (!lat)
+		return -ENOMEM;
+	w = &lat->req[0];
+	r = &lat->req[1];
+
+	mmc_test_lat_start(lat);
+	for (i = 0; !mmc_test_lat_done(lat, i); i++) {
+		mmc_test_lat_reset(w);
+		w->areq.areq.mrq = &w->mrq;
+		w->areq.areq.err_check = mmc_test_check_result_async;
+		w->areq.test = test;
+		mmc_test_prepare_mrq(test, &w->mrq, t->sg, t->sg_len, waddr,
+				     t->blocks, 512, 1);
+		mmc_start_req(test->card->host, &w->areq.areq, &ret);
+		if (ret)
+			goto out;
+
+		mmc_test_lat_reset(r);
+		r->areq.areq.mrq = &r->mrq;
+		r->areq.areq.err_check = mmc_test_check_result_async;
+		r->areq.test = test;
+		mmc_test_prepare_mrq(test, &r->mrq, &sg, 1,
+				     mmc_test_lat_addr(test, lat,
+						       MMC_TEST_LAT_SZ >> 9),
+				     MMC_TEST_LAT_SZ >> 9, 512, 0);
+		r->start = ktime_get();
+		mmc_start_req(test->card->host, &r->areq.areq, &ret);
+		if (ret)
+			goto out;
+		done = mmc_start_req(test->card->host, NULL, &ret);
+		if (ret)
+			goto out;
+		if (done)
+			mmc_test_lat_add(lat, r->start);
+
+		waddr += t->blocks;
+		if (waddr + t->blocks > t->dev_addr + (t->max_sz >> 9))
+			waddr = t->dev_addr;
+	}
+	mmc_test_print_lat(test, lat, "Read with background write", 1,
+			   "async");
+
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+	if (!mmc_test_can_cmdq(test) || test->card->ext_csd.cmdq_depth < 2)
+		goto out;
+
+	/* the same with both as tasks, the card may run the read first */
+	ret = mmc_test_cmdq_begin(test);
+	if (ret)
+		goto out;
+	mmc_test_lat_start(lat);
+	for (i = 0; !mmc_test_lat_done(lat, i); i++) {
+		unsigned long tasks = BIT(0) | BIT(1), ready;
+		unsigned int tag;
+
+		ret = mmc_test_cmdq_queue(test, w, 0, t->sg, t->sg_len, waddr,
+					  t->blocks, 1);
+		if (!ret)
+			ret = mmc_test_cmdq_queue(test, r, 1, &sg, 1,
+					mmc_test_lat_addr(test, lat,
+							  MMC_TEST_LAT_SZ >> 9),
+					MMC_TEST_LAT_SZ >> 9, 0);
+		while (!ret && tasks) {
+			ret = mmc_test_cmdq_wait_ready(test, tasks, &ready);
+			if (ret)
+				break;
+			for_each_set_bit(tag, &ready, 2) {
+				ret = mmc_test_cmdq_execute(test,
+							    &lat->req[tag]);
+				__clear_bit(tag, &tasks);
+				if (ret)
+					break;
+				if (tag == 1)
+					mmc_test_lat_add(lat, r->start);
+			}
+		}
+		if (ret)
+			break;
+
+		waddr += t->blocks;
+		if (waddr + t->blocks > t->dev_addr + (t->max_sz >> 9))
+			waddr = t->dev_addr;
+	}
+	mmc_test_cmdq_end(test, ret != 0);
+	if (ret)
+		goto out;
+	mmc_test_print_lat(test, lat, "Read with background write", 2,
+			   "cmdq");
+#endif
+out:
+	vfree(lat);
+	return ret;
+}
+
+/*
+ * Random 4k reads with a discard of freshly written data every
+ * MMC_TEST_LAT_DISCARD_EVERY reads.  The discards are timed as well, the
+ * write before each is not.
+ */
+static int mmc_test_read_lat_discard(struct mmc_test_card *test)
+{
+	struct mmc_test_area *t = &test->area;
+	struct mmc_test_lat *lat;
+	u64 *dns;
+	unsigned long dsz = min_t(unsigned long, MMC_TEST_LAT_DISCARD_SZ,
+				  t->max_tfr);
+	unsigned int i, dcnt = 0, dmax;
+	unsigned int arg;
+	ktime_t start;
+	int ret = 0;
+
+	if (mmc_can_discard(test->card))
+		arg = MMC_DISCARD_ARG;
+	else if (mmc_can_trim(test->card))
+		arg = MMC_TRIM_ARG;
+	else
+		return RESULT_UNSUP_CARD;
+
+	if (!mmc_can_erase(test->card))
+		return RESULT_UNSUP_HOST;
+
+	lat = mmc_test_lat_alloc();
+	if (!lat)
+		return -ENOMEM;
+	dmax = MMC_TEST_LAT_CNT / MMC_TEST_LAT_DISCARD_EVERY + 1;
+	dns = kcalloc(dmax, sizeof(u64), GFP_KERNEL);
+	if (!dns) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	mmc_test_lat_start(lat);
+	for (i = 0; !mmc_test_lat_done(lat, i); i++) {
+		if (i % MMC_TEST_LAT_DISCARD_EVERY == 0 && dcnt < dmax) {
+			ret = mmc_test_area_io(test, dsz, t->dev_addr, 1, 0, 0);
+			if (ret)
+				goto out;
+			start = ktime_get();
+			ret = mmc_erase(test->card, t->dev_addr, dsz >> 9, arg);
+			if (ret)
+				goto out;
+			dns[dcnt++] = ktime_to_ns(ktime_sub(ktime_get(), start));
+			ret = mmc_test_area_map(test, MMC_TEST_LAT_SZ, 0, 0);
+			if (ret)
+				goto out;
+		}
+		start = ktime_get();
+		ret = mmc_test_area_transfer(test,
+				mmc_test_lat_addr(test, lat, t->blocks), 0);
+		if (ret)
+			goto out;
+		mmc_test_lat_add(lat, start);
+	}
+	mmc_test_print_lat(test, lat, "Read with discards", 1, "sync");
+
+	if (dcnt) {
+		sort(dns, dcnt, sizeof(u64), mmc_test_lat_cmp, NULL);
+		pr_info("%s: %s of %lu sectors x %u: p50 %llu us, max %llu us\n",
+			mmc_hostname(test->card->host),
+			arg == MMC_DISCARD_ARG ? "Discard" : "Trim", dsz >> 9,
+			dcnt, div_u64(dns[dcnt / 2], NSEC_PER_USEC),
+			div_u64(dns[dcnt - 1], NSEC_PER_USEC));
+	}
+out:
+	kfree(dns);
+	vfree(lat);
+	return ret;
+}
+
 static const struct mmc_test_case mmc_test_cases[] = {
 	{
 		.name = "Basic write (no data verification)",
@@ -2678,6 +3347,34 @@ static const struct mmc_test_case mmc_test_cases[] = {
 		.name = "eMMC hardware reset",
 		.run = mmc_test_hw_reset,
 	},
+
+	{
+		.name = "Random 4k read latency by queue depth",
+		.prepare = mmc_test_area_prepare,
+		.run = mmc_test_random_read_lat,
+		.cleanup = mmc_test_area_cleanup,
+	},
+
+	{
+		.name = "Random 4k write latency by queue depth",
+		.prepare = mmc_test_area_prepare,
+		.run = mmc_test_random_write_lat,
+		.cleanup = mmc_test_area_cleanup,
+	},
+
+	{
+		.name = "4k read latency with background writes",
+		.prepare = mmc_test_area_prepare,
+		.run = mmc_test_read_lat_bg_write,
+		.cleanup = mmc_test_area_cleanup,
+	},
+
+	{
+		.name = "Random 4k read latency with discards",
+		.prepare = mmc_test_area_prepare,
+		.run = mmc_test_read_lat_discard,
+		.cleanup = mmc_test_area_cleanup,
+	},
 };
 
 static DEFINE_MUTEX(mmc_test_lock);
@@ -2821,11 +3518,17 @@ static int mtf_test_show(struct seq_file *sf, void *data)
 		seq_printf(sf, "Test %d: %d\n", gr->testcase + 1, gr->result);
 
 		list_for_each_entry(tr, &gr->tr_lst, link) {
-			seq_printf(sf, "%u %d %lu.%09lu %u %u.%02u\n",
+			seq_printf(sf, "%u %d %lu.%09lu %u %u.%02u",
 				tr->count, tr->sectors,
 				(unsigned long)tr->ts.tv_sec,
 				(unsigned long)tr->ts.tv_nsec,
 				tr->rate, tr->iops / 100, tr->iops % 100);
+			/* latency tests: depth, then p50 p99 p99.9 in us */
+			if (tr->qd)
+				seq_printf(sf, " %u %u %u %u", tr->qd,
+					   tr->lat_us[0], tr->lat_us[1],
+					   tr->lat_us[2]);
+			seq_puts(sf, "\n");
 		}
 	}
 
@@ -22,6 +22,11 @@
 #include "queue.h"
 
 #define MMC_QUEUE_BOUNCESZ	65536
+#define MMC_QUEUE_MQ_DEPTH	64
+
+static bool use_blk_mq = IS_ENABLED(CONFIG_MMC_BLOCK_MQ);
+module_param(use_blk_mq, bool, 0444);
+MODULE_PARM_DESC(use_blk_mq, "Use blk-mq software queues for MMC block devices");
 
 /*
  * Prepare a MMC request. This just filters out odd stuff.
@@ -49,7 +54,6 @@ static int mmc_prep_request(struct request_queue *q, struct request *req)
 static int mmc_queue_thread(void *d)
 {
 	struct mmc_queue *mq = d;
-	struct request_queue *q = mq->queue;
 #ifdef MTK_BKOPS_IDLE_MAYA
 	struct mmc_card *card = mq->card;
 #endif
@@ -62,11 +66,13 @@ static int mmc_queue_thread(void *d)
 		struct mmc_queue_req *tmp;
 		unsigned int cmd_flags = 0;
 
-		spin_lock_irq(q->queue_lock);
+		spin_lock_irq(mmc_queue_lock(mq));
 		set_current_state(TASK_INTERRUPTIBLE);
-		req = blk_fetch_request(q);
+		req = __mmc_queue_peek(mq);
+		if (req)
+			__mmc_queue_start(mq, req);
 		mq->mqrq_cur->req = req;
-		spin_unlock_irq(q->queue_lock);
+		spin_unlock_irq(mmc_queue_lock(mq));
 
 		if (req || mq->mqrq_prev->req) {
 			set_current_state(TASK_RUNNING);
@@ -111,26 +117,14 @@ static int mmc_queue_thread(void *d)
 }
 
 /*
- * Generic MMC request handler.  This is called for any queue on a
- * particular host.  When the host is not busy, we look for a request
- * on any queue on this host, and attempt to issue it.  This may
- * not be the queue we were asked to process.
+ * Let the queue thread know a request arrived, called with
+ * mmc_queue_lock() held.
  */
-static void mmc_request_fn(struct request_queue *q)
+static void mmc_queue_kick(struct mmc_queue *mq)
 {
-	struct mmc_queue *mq = q->queuedata;
-	struct request *req;
 	unsigned long flags;
 	struct mmc_context_info *cntx;
 
-	if (!mq) {
-		while ((req = blk_fetch_request(q)) != NULL) {
-			req->cmd_flags |= REQ_QUIET;
-			__blk_end_request_all(req, -EIO);
-		}
-		return;
-	}
-
 	cntx = &mq->card->host->context_info;
 	if (!mq->mqrq_cur->req && mq->mqrq_prev->req) {
 		/*
@@ -148,6 +142,128 @@ static void mmc_request_fn(struct request_queue *q)
 		wake_up_process(mq->thread);
 }
 
+/*
+ * Generic MMC request handler.  This is called for any queue on a
+ * particular host.  When the host is not busy, we look for a request
+ * on any queue on this host, and attempt to issue it.  This may
+ * not be the queue we were asked to process.
+ */
+static void mmc_request_fn(struct request_queue *q)
+{
+	struct mmc_queue *mq = q->queuedata;
+	struct request *req;
+
+	if (!mq) {
+		while ((req = blk_fetch_request(q)) != NULL) {
+			req->cmd_flags |= REQ_QUIET;
+			__blk_end_request_all(req, -EIO);
+		}
+		return;
+	}
+
+	mmc_queue_kick(mq);
+}
+
+/*
+ * blk-mq entry point. It may not sleep, so the request is only moved
+ * from the per-CPU software queues to mq_list and the queue thread
+ * issues it like a request_fn one.
+ */
+static int mmc_mq_queue_rq(struct blk_mq_hw_ctx *hctx, struct request *req,
+			   bool last)
+{
+	struct mmc_queue *mq = req->q->queuedata;
+	unsigned long flags;
+
+	if (!mq || mmc_prep_request(req->q, req) != BLKPREP_OK) {
+		req->cmd_flags |= REQ_QUIET;
+		return BLK_MQ_RQ_QUEUE_ERROR;
+	}
+
+	blk_mq_start_request(req);
+
+	spin_lock_irqsave(&mq->mq_lock, flags);
+	list_add_tail(&req->queuelist, &mq->mq_list);
+	mmc_queue_kick(mq);
+	spin_unlock_irqrestore(&mq->mq_lock, flags);
+
+	return BLK_MQ_RQ_QUEUE_OK;
+}
+
+static struct blk_mq_ops mmc_mq_ops = {
+	.queue_rq	= mmc_mq_queue_rq,
+	.map_queue	= blk_mq_map_queue,
+};
+
+/* Next request to issue, called with mmc_queue_lock() held */
+struct request *__mmc_queue_peek(struct mmc_queue *mq)
+{
+	if (mq->use_mq)
+		return list_first_entry_or_null(&mq->mq_list, struct request,
+						queuelist);
+
+	return blk_peek_request(mq->queue);
+}
+
+/* Take a peeked request off the queue, with mmc_queue_lock() held */
+void __mmc_queue_start(struct mmc_queue *mq, struct request *req)
+{
+	if (mq->use_mq)
+		list_del_init(&req->queuelist);
+	else
+		blk_start_request(req);
+}
+
+struct request *mmc_queue_fetch(struct mmc_queue *mq)
+{
+	struct request *req;
+
+	spin_lock_irq(mmc_queue_lock(mq));
+	req = __mmc_queue_peek(mq);
+	if (req)
+		__mmc_queue_start(mq, req);
+	spin_unlock_irq(mmc_queue_lock(mq));
+
+	return req;
+}
+
+/* Put a fetched request back at the head of the queue */
+void mmc_queue_requeue(struct mmc_queue *mq, struct request *req)
+{
+	spin_lock_irq(mmc_queue_lock(mq));
+	if (mq->use_mq)
+		list_add(&req->queuelist, &mq->mq_list);
+	else
+		blk_requeue_request(mq->queue, req);
+	spin_unlock_irq(mmc_queue_lock(mq));
+}
+
+/*
+ * blk_end_request() for both kinds of queue.
+ * Returns true while part of the request is still pending.
+ */
+bool mmc_queue_end_request(struct request *req, int error,
+			   unsigned int nr_bytes)
+{
+	if (!req->q->mq_ops)
+		return blk_end_request(req, error, nr_bytes);
+
+	if (blk_update_request(req, error, nr_bytes))
+		return true;
+
+	__blk_mq_end_request(req, error);
+	return false;
+}
+
+/* Called after blk_cleanup_queue(), once no request can hold a tag */
+void mmc_queue_free_tags(struct mmc_queue *mq)
+{
+	if (mq->use_mq) {
+		blk_mq_free_tag_set(&mq->tag_set);
+		mq->use_mq = false;
+	}
+}
+
 static struct scatterlist *mmc_alloc_sg(int sg_len, int *err)
 {
 	struct scatterlist *sg;
@@ -206,15 +322,37 @@ int mmc_init_queue(struct mmc_queue *mq, struct mmc_card *card,
 		limit = (u64)dma_max_pfn(mmc_dev(host)) << PAGE_SHIFT;
 
 	mq->card = card;
-	mq->queue = blk_init_queue(mmc_request_fn, lock);
-	if (!mq->queue)
-		return -ENOMEM;
+	if (use_blk_mq) {
+		mq->tag_set.ops = &mmc_mq_ops;
+		mq->tag_set.nr_hw_queues = 1;
+		mq->tag_set.queue_depth = MMC_QUEUE_MQ_DEPTH;
+		mq->tag_set.numa_node = NUMA_NO_NODE;
+		mq->tag_set.flags = BLK_MQ_F_SHOULD_MERGE | BLK_MQ_F_SG_MERGE;
+
+		ret = blk_mq_alloc_tag_set(&mq->tag_set);
+		if (ret)
+			return ret;
+
+		mq->queue = blk_mq_init_queue(&mq->tag_set);
+		if (IS_ERR(mq->queue)) {
+			blk_mq_free_tag_set(&mq->tag_set);
+			return PTR_ERR(mq->queue);
+		}
+
+		spin_lock_init(&mq->mq_lock);
+		INIT_LIST_HEAD(&mq->mq_list);
+		mq->use_mq = true;
+	} else {
+		mq->queue = blk_init_queue(mmc_request_fn, lock);
+		if (!mq->queue)
+			return -ENOMEM;
+		blk_queue_prep_rq(mq->queue, mmc_prep_request);
+	}
 
 	mq->mqrq_cur = mqrq_cur;
 	mq->mqrq_prev = mqrq_prev;
 	mq->queue->queuedata = mq;
 
-	blk_queue_prep_rq(mq->queue, mmc_prep_request);
 	queue_flag_set_unlocked(QUEUE_FLAG_NONROT, mq->queue);
 	queue_flag_clear_unlocked(QUEUE_FLAG_ADD_RANDOM, mq->queue);
 	if (mmc_can_erase(card))
@@ -321,6 +459,7 @@ int mmc_init_queue(struct mmc_queue *mq, struct mmc_card *card,
 	mqrq_prev->bounce_buf = NULL;
 
 	blk_cleanup_queue(mq->queue);
+	mmc_queue_free_tags(mq);
 	return ret;
 }
 
@@ -338,10 +477,25 @@ void mmc_cleanup_queue(struct mmc_queue *mq)
 	kthread_stop(mq->thread);
 
 	/* Empty the queue */
-	spin_lock_irqsave(q->queue_lock, flags);
-	q->queuedata = NULL;
-	blk_start_queue(q);
-	spin_unlock_irqrestore(q->queue_lock, flags);
+	if (mq->use_mq) {
+		struct request *req;
+
+		spin_lock_irqsave(&mq->mq_lock, flags);
+		q->queuedata = NULL;
+		spin_unlock_irqrestore(&mq->mq_lock, flags);
+
+		/* the thread is gone, fail what it did not issue */
+		while ((req = mmc_queue_fetch(mq)) != NULL) {
+			req->cmd_flags |= REQ_QUIET;
+			blk_mq_end_request(req, -EIO);
+		}
+		blk_mq_start_stopped_hw_queues(q, true);
+	} else {
+		spin_lock_irqsave(q->queue_lock, flags);
+		q->queuedata = NULL;
+		blk_start_queue(q);
+		spin_unlock_irqrestore(q->queue_lock, flags);
+	}
 
 	kfree(mqrq_cur->bounce_sg);
 	mqrq_cur->bounce_sg = NULL;
@@ -408,6 +562,59 @@ void mmc_packed_clean(struct mmc_queue *mq)
 	mqrq_prev->packed = NULL;
 }
 
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+/*
+ * Every task ID gets its own request slot, so up to cmdq_depth
+ * requests can be queued on the card at the same time.
+ */
+int mmc_cmdq_init(struct mmc_queue *mq, struct mmc_card *card)
+{
+	unsigned int depth = min_t(unsigned int, card->ext_csd.cmdq_depth,
+				   MMC_CMDQ_MAX_DEPTH);
+	unsigned int i;
+	int ret = 0;
+
+	/* bounce buffers are only set up for the legacy pair */
+	if (mq->mqrq[0].bounce_buf)
+		return -EINVAL;
+
+	mq->mqrq_cmdq = kcalloc(depth, sizeof(struct mmc_queue_req),
+				GFP_KERNEL);
+	if (!mq->mqrq_cmdq) {
+		pr_warn("%s: unable to allocate cmdq slots\n",
+			mmc_card_name(card));
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < depth; i++) {
+		mq->mqrq_cmdq[i].sg = mmc_alloc_sg(card->host->max_segs, &ret);
+		if (ret) {
+			mq->cmdq_depth = i;
+			mmc_cmdq_clean(mq);
+			return ret;
+		}
+	}
+
+	mq->cmdq_depth = depth;
+	mq->cmdq_tasks = 0;
+	return 0;
+}
+
+void mmc_cmdq_clean(struct mmc_queue *mq)
+{
+	unsigned int i;
+
+	if (!mq->mqrq_cmdq)
+		return;
+
+	for (i = 0; i < mq->cmdq_depth; i++)
+		kfree(mq->mqrq_cmdq[i].sg);
+	kfree(mq->mqrq_cmdq);
+	mq->mqrq_cmdq = NULL;
+	mq->cmdq_depth = 0;
+}
+#endif
+
 /**
  * mmc_queue_suspend - suspend a MMC request queue
  * @mq: MMC queue to suspend
@@ -424,9 +631,13 @@ void mmc_queue_suspend(struct mmc_queue *mq)
 	if (!(mq->flags & MMC_QUEUE_SUSPENDED)) {
 		mq->flags |= MMC_QUEUE_SUSPENDED;
 
-		spin_lock_irqsave(q->queue_lock, flags);
-		blk_stop_queue(q);
-		spin_unlock_irqrestore(q->queue_lock, flags);
+		if (mq->use_mq) {
+			blk_mq_stop_hw_queues(q);
+		} else {
+			spin_lock_irqsave(q->queue_lock, flags);
+			blk_stop_queue(q);
+			spin_unlock_irqrestore(q->queue_lock, flags);
+		}
 
 		down(&mq->thread_sem);
 	}
@@ -446,9 +657,13 @@ void mmc_queue_resume(struct mmc_queue *mq)
 
 		up(&mq->thread_sem);
 
-		spin_lock_irqsave(q->queue_lock, flags);
-		blk_start_queue(q);
-		spin_unlock_irqrestore(q->queue_lock, flags);
+		if (mq->use_mq) {
+			blk_mq_start_stopped_hw_queues(q, true);
+		} else {
+			spin_lock_irqsave(q->queue_lock, flags);
+			blk_start_queue(q);
+			spin_unlock_irqrestore(q->queue_lock, flags);
+		}
 	}
 }
 
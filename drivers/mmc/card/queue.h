@@ -1,6 +1,8 @@
 #ifndef MMC_QUEUE_H
 #define MMC_QUEUE_H
 
+#include <linux/blk-mq.h>
+
 #define MMC_REQ_SPECIAL_MASK	(REQ_DISCARD | REQ_FLUSH)
 
 struct request;
@@ -57,6 +59,16 @@ struct mmc_queue {
 	struct mmc_queue_req	mqrq[2];
 	struct mmc_queue_req	*mqrq_cur;
 	struct mmc_queue_req	*mqrq_prev;
+
+	bool			use_mq;		/* blk-mq instead of request_fn */
+	struct blk_mq_tag_set	tag_set;
+	spinlock_t		mq_lock;	/* protects mq_list */
+	struct list_head	mq_list;	/* dispatched, not yet issued */
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+	struct mmc_queue_req	*mqrq_cmdq;	/* one per task ID */
+	unsigned int		cmdq_depth;
+	unsigned long		cmdq_tasks;	/* task IDs queued on card */
+#endif
 };
 
 extern int mmc_init_queue(struct mmc_queue *, struct mmc_card *, spinlock_t *,
@@ -65,6 +77,19 @@ extern void mmc_cleanup_queue(struct mmc_queue *);
 extern void mmc_queue_suspend(struct mmc_queue *);
 extern void mmc_queue_resume(struct mmc_queue *);
 
+extern struct request *__mmc_queue_peek(struct mmc_queue *);
+extern void __mmc_queue_start(struct mmc_queue *, struct request *);
+extern struct request *mmc_queue_fetch(struct mmc_queue *);
+extern void mmc_queue_requeue(struct mmc_queue *, struct request *);
+extern bool mmc_queue_end_request(struct request *, int, unsigned int);
+extern void mmc_queue_free_tags(struct mmc_queue *);
+
+/* Lock that protects the requests not yet fetched by the queue thread */
+static inline spinlock_t *mmc_queue_lock(struct mmc_queue *mq)
+{
+	return mq->use_mq ? &mq->mq_lock : mq->queue->queue_lock;
+}
+
 extern unsigned int mmc_queue_map_sg(struct mmc_queue *,
 				     struct mmc_queue_req *);
 extern void mmc_queue_bounce_pre(struct mmc_queue_req *);
@@ -73,6 +98,13 @@ extern void mmc_queue_bounce_post(struct mmc_queue_req *);
 extern int mmc_packed_init(struct mmc_queue *, struct mmc_card *);
 extern void mmc_packed_clean(struct mmc_queue *);
 
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+#define MMC_CMDQ_MAX_DEPTH	BITS_PER_LONG
+
+extern int mmc_cmdq_init(struct mmc_queue *, struct mmc_card *);
+extern void mmc_cmdq_clean(struct mmc_queue *);
+#endif
+
 extern int mmc_access_rpmb(struct mmc_queue *);
 
 #endif
@@ -2802,6 +2802,35 @@ int mmc_flush_cache(struct mmc_card *card)
 }
 EXPORT_SYMBOL(mmc_flush_cache);
 
+/*
+ * Turn the command queue ON/OFF.
+ * The card queue must be empty.
+ * This function should be called with host claimed
+ */
+int mmc_cmdq_switch(struct mmc_card *card, bool enable)
+{
+	int err;
+
+	if (!mmc_card_mmc(card) || card->ext_csd.cmdq_en == enable)
+		return 0;
+
+	if (enable && !card->ext_csd.cmdq_support)
+		return -EOPNOTSUPP;
+
+	err = mmc_switch(card, EXT_CSD_CMD_SET_NORMAL,
+			EXT_CSD_CMDQ_MODE_EN, enable,
+			card->ext_csd.generic_cmd6_time);
+	if (err)
+		pr_err("%s: cmdq %s error %d\n",
+				mmc_hostname(card->host),
+				enable ? "on" : "off", err);
+	else
+		card->ext_csd.cmdq_en = enable;
+
+	return err;
+}
+EXPORT_SYMBOL(mmc_cmdq_switch);
+
 #ifdef CONFIG_PM
 
 /* Do the card removal on suspend if card is assumed removeable
@@ -644,6 +644,13 @@ static int mmc_read_ext_csd(struct mmc_card *card, u8 *ext_csd)
 		card->ext_csd.data_sector_size = 512;
 	}
 
+	/* eMMC v5.1 or later */
+	if (card->ext_csd.rev >= 8) {
+		card->ext_csd.cmdq_support = ext_csd[EXT_CSD_CMDQ_SUPPORT] & 0x1;
+		card->ext_csd.cmdq_depth =
+			(ext_csd[EXT_CSD_CMDQ_DEPTH] & 0x1f) + 1;
+	}
+
 out:
 	return err;
 }
@@ -1602,6 +1609,12 @@ skip_cache:
 		}
 	}
 
+	/*
+	 * The card left command queue mode on reset, the block driver
+	 * turns it back on once it has a request to queue.
+	 */
+	card->ext_csd.cmdq_en = false;
+
 	if (!oldcard)
 		host->card = card;
 
@@ -1840,6 +1853,11 @@ static int _mmc_suspend(struct mmc_host *host, bool is_suspend)
 #endif
 	}
 
+	/* Leave command queue mode while the queue is known to be empty */
+	err = mmc_cmdq_switch(host->card, false);
+	if (err)
+		goto out;
+
 	/*
 	 * Turn off cache if eMMC reversion before v5.0
 	 */
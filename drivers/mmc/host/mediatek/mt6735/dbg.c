@@ -352,6 +352,124 @@ void msdc_performance(u32 opcode, u32 sizes, u32 bRx, u32 ticks)
 
 }
 
+/* ========= read/write latency histograms =========== */
+u32 msdc_lat_enable = 1;
+
+static const char * const msdc_lat_phase_name[MSDC_LAT_PHASE_NUM] = {
+	"queue", "cmd", "dma", "done"
+};
+
+static const char * const msdc_lat_size_name[MSDC_LAT_SIZE_NUM] = {
+	"<=4K", "<=32K", "<=128K", ">128K"
+};
+
+static int msdc_lat_size_idx(u32 size)
+{
+	if (size <= 4 * 1024)
+		return 0;
+	if (size <= 32 * 1024)
+		return 1;
+	if (size <= 128 * 1024)
+		return 2;
+	return 3;
+}
+
+/* called when a data request goes out, closes its queue phase */
+void msdc_lat_issue(struct msdc_host *host, int read)
+{
+	struct msdc_lat_req *req = &host->lat_req;
+
+	req->t_issue = sched_clock();
+	req->size = host->xfer_size;
+	req->read = read ? 1 : 0;
+	msdc_lat_account(host, MSDC_LAT_QUEUE, req->t_prep, req->t_issue);
+	req->t_prep = 0;
+}
+
+void msdc_lat_account(struct msdc_host *host, int phase, u64 start, u64 end)
+{
+	struct msdc_lat_stat *stat = &host->lat_stat;
+	struct msdc_lat_req *req = &host->lat_req;
+	u64 ns;
+	u32 us;
+	int bucket;
+
+	if (!msdc_lat_enable || !start || end < start)
+		return;
+
+	ns = end - start;
+	us = (u32)min_t(u64, div_u64(ns, NSEC_PER_USEC), U32_MAX);
+	bucket = us ? min_t(int, fls(us), MSDC_LAT_BUCKETS - 1) : 0;
+
+	stat->hist[req->read][msdc_lat_size_idx(req->size)][phase][bucket]++;
+	if (ns > stat->max_ns[req->read][phase])
+		stat->max_ns[req->read][phase] = ns;
+}
+
+static void msdc_lat_show_host(struct seq_file *m, struct msdc_host *host)
+{
+	struct msdc_lat_stat *stat = &host->lat_stat;
+	int dir, size, phase, i;
+	u32 total;
+
+	for (dir = 1; dir >= 0; dir--) {
+		seq_printf(m, "msdc%d %s max(us):", host->id, dir ? "read" : "write");
+		for (phase = 0; phase < MSDC_LAT_PHASE_NUM; phase++)
+			seq_printf(m, " %s %llu", msdc_lat_phase_name[phase],
+				   div_u64(stat->max_ns[dir][phase], NSEC_PER_USEC));
+		seq_puts(m, "\n");
+
+		for (size = 0; size < MSDC_LAT_SIZE_NUM; size++) {
+			for (phase = 0; phase < MSDC_LAT_PHASE_NUM; phase++) {
+				total = 0;
+				for (i = 0; i < MSDC_LAT_BUCKETS; i++)
+					total += stat->hist[dir][size][phase][i];
+				if (!total)
+					continue;
+				seq_printf(m, "  %-6s %-5s", msdc_lat_size_name[size],
+					   msdc_lat_phase_name[phase]);
+				for (i = 0; i < MSDC_LAT_BUCKETS; i++)
+					seq_printf(m, " %u", stat->hist[dir][size][phase][i]);
+				seq_puts(m, "\n");
+			}
+		}
+	}
+}
+
+static int msdc_lat_proc_show(struct seq_file *m, void *v)
+{
+	int i;
+
+	seq_printf(m, "enable %u, bucket n counts latencies below 2^n us\n",
+		   msdc_lat_enable);
+	for (i = 0; i < HOST_MAX_NUM; i++) {
+		if (mtk_msdc_host[i])
+			msdc_lat_show_host(m, mtk_msdc_host[i]);
+	}
+	return 0;
+}
+
+/* echo 0/1 > /proc/msdc_lat_hist: disable/enable, the histograms are reset */
+static ssize_t msdc_lat_proc_write(struct file *file, const char __user *buf,
+				   size_t count, loff_t *data)
+{
+	struct msdc_host *host;
+	u32 enable;
+	int i, ret;
+
+	ret = kstrtou32_from_user(buf, count, 0, &enable);
+	if (ret)
+		return ret;
+
+	msdc_lat_enable = enable ? 1 : 0;
+	for (i = 0; i < HOST_MAX_NUM; i++) {
+		host = mtk_msdc_host[i];
+		if (host)
+			memset(&host->lat_stat, 0, sizeof(host->lat_stat));
+	}
+	return count;
+}
+
 #define COMPARE_ADDRESS_MMC   0x402000
 #define COMPARE_ADDRESS_SD    0x2000
 #define COMPARE_ADDRESS_SDIO  0x0
@@ -3273,6 +3391,19 @@ static const struct file_operations msdc_proc_fops = {
 	.release = single_release,
 };
 
+static int msdc_lat_proc_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, msdc_lat_proc_show, inode->i_private);
+}
+
+static const struct file_operations msdc_lat_fops = {
+	.open = msdc_lat_proc_open,
+	.write = msdc_lat_proc_write,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 static int msdc_help_proc_open(struct inode *inode, struct file *file)
 {
 	return single_open(file, msdc_help_proc_show, inode->i_private);
@@ -3458,6 +3589,16 @@ int msdc_debug_proc_init(void)
 		pr_err("[%s]: failed to create /proc/msdc_DVT\n", __func__);
 #endif
 
+#ifndef USER_BUILD_KERNEL
+	prEntry = proc_create("msdc_lat_hist", 0660, NULL, &msdc_lat_fops);
+#else
+	prEntry = proc_create("msdc_lat_hist", 0440, NULL, &msdc_lat_fops);
+#endif
+	if (prEntry)
+		pr_err("[%s]: successfully create /proc/msdc_lat_hist\n", __func__);
+	else
+		pr_err("[%s]: failed to create /proc/msdc_lat_hist\n", __func__);
+
 	memset(msdc_drv_mode, 0, sizeof(msdc_drv_mode));
 #ifndef USER_BUILD_KERNEL
 	tune = proc_create("msdc_tune", 0660, NULL, &msdc_tune_fops);
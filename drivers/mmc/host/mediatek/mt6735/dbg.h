@@ -176,4 +176,8 @@ extern void GPT_GetCounter64(u32 *cntL32, u32 *cntH32);
 u32 msdc_time_calc(u32 old_L32, u32 old_H32, u32 new_L32, u32 new_H32);
 void msdc_performance(u32 opcode, u32 sizes, u32 bRx, u32 ticks);
 
+extern u32 msdc_lat_enable;
+void msdc_lat_issue(struct msdc_host *host, int read);
+void msdc_lat_account(struct msdc_host *host, int phase, u64 start, u64 end);
+
 #endif
@@ -1045,6 +1045,20 @@ struct scatterlist_ex {
 #define DMA_FLAG_PAD_BLOCK  (0x00000002)
 #define DMA_FLAG_PAD_DWORD  (0x00000004)
 
+/* The descriptor checksum is only checked by HW when DECSEN is set,
+ * so skip it by default. Define MSDC_DMA_DESC_CHKSUM to turn it on
+ * again when chasing descriptor corruption.
+ */
+/* #define MSDC_DMA_DESC_CHKSUM */
+#ifdef MSDC_DMA_DESC_CHKSUM
+#define MSDC_DMA_FLAGS      DMA_FLAG_EN_CHKSUM
+#else
+#define MSDC_DMA_FLAGS      DMA_FLAG_NONE
+#endif
+
+/* one descriptor set for the running transfer, one for the next */
+#define MSDC_DMA_DESC_SETS  (2)
+
 struct msdc_dma {
 	u32 flags;		/* flags */
 	u32 xfersz;		/* xfer size in bytes */
@@ -1067,6 +1081,12 @@ struct msdc_dma {
 	dma_addr_t bd_addr;	/* the physical address of bd array */
 	u32 used_gpd;		/* the number of used gpd elements */
 	u32 used_bd;		/* the number of used bd elements */
+
+	struct gpd_t *gpd_set[MSDC_DMA_DESC_SETS];
+	struct bd_t *bd_set[MSDC_DMA_DESC_SETS];
+	dma_addr_t gpd_set_addr[MSDC_DMA_DESC_SETS];
+	dma_addr_t bd_set_addr[MSDC_DMA_DESC_SETS];
+	u8 cur_set;		/* set of the running or last transfer */
 };
 
 struct tune_counter {
@@ -1104,6 +1124,42 @@ struct msdc_saved_para {
 	u8 resp_wait_cnt;
 };
 
+/* HS400 DS delay the CRC tuning settled on, for the card in cid */
+struct msdc_hs400_tuned {
+	u32 cid[4];
+	u8 ds_dly1;
+	u8 ds_dly3;
+	bool valid;
+};
+
+/* read/write latency histograms, see /proc/msdc_lat_hist */
+enum msdc_lat_phase {
+	MSDC_LAT_QUEUE = 0,	/* pre_req to issue */
+	MSDC_LAT_CMD,		/* issue to command response */
+	MSDC_LAT_DMA,		/* DMA start to transfer done */
+	MSDC_LAT_DONE,		/* transfer done to request done */
+	MSDC_LAT_PHASE_NUM,
+};
+
+#define MSDC_LAT_SIZE_NUM	(4)	/* <=4K, <=32K, <=128K, larger */
+#define MSDC_LAT_BUCKETS	(16)	/* bucket n: below 2^n us */
+
+struct msdc_lat_stat {
+	u32 hist[2][MSDC_LAT_SIZE_NUM][MSDC_LAT_PHASE_NUM][MSDC_LAT_BUCKETS];
+	u64 max_ns[2][MSDC_LAT_PHASE_NUM];
+};
+
+/* timestamps of the request in flight */
+struct msdc_lat_req {
+	u64 t_prep;
+	u64 t_issue;
+	u64 t_cmd;
+	u64 t_dma;
+	u64 t_xfer;
+	u32 size;
+	u8 read;
+};
+
 #if defined(MTK_SDIO30_ONLINE_TUNING_SUPPORT) || defined(ONLINE_TUNING_DVTTEST)
 
 #define DMA_ON 0
@@ -1214,6 +1270,7 @@ struct msdc_host {
 
 	int power_domain;
 	struct msdc_saved_para saved_para;
+	struct msdc_hs400_tuned hs400_tuned;
 	int sd_cd_polarity;
 	/* to make sure insert mmc_rescan this work in start_host when boot up */
 	int sd_cd_insert_work;
@@ -1231,6 +1288,8 @@ struct msdc_host {
 #endif
 	struct work_struct			work_tune; /* new thread tune */
 	struct mmc_request			*mrq_tune; /* backup host->mrq */
+	struct msdc_lat_req			lat_req;
+	struct msdc_lat_stat			lat_stat;
 };
 
 struct tag_msdc_hw_para {
@@ -52,6 +52,7 @@
 #include "mt_sd.h"
 #ifdef MTK_SDIO30_ONLINE_TUNING_SUPPORT
 #include <mt_vcore_dvfs.h>
+#include <mt-plat/mt_vcore_qos.h>
 #endif /* MTK_SDIO30_ONLINE_TUNING_SUPPORT */
 
 #include <queue.h>
@@ -249,6 +250,8 @@ static unsigned int met_mmc_bdnum;
 
 #define MSDC_COOKIE_PIO        (1<<0)
 #define MSDC_COOKIE_ASYNC    (1<<1)
+#define MSDC_COOKIE_DESC     (1<<2)	/* gpd/bd built in pre_req */
+#define MSDC_COOKIE_DESC_SET (1<<3)	/* ... into descriptor set 1 */
 
 #define msdc_use_async_way(x) (x & MSDC_COOKIE_ASYNC)
 #define msdc_async_use_dma(x) ((x & MSDC_COOKIE_ASYNC) && (!(x & MSDC_COOKIE_PIO)))
@@ -1850,6 +1853,46 @@ static void msdc_reset_tmo_tune_counter(struct msdc_host *host,	int index)
 	}
 }
 
+/*
+ * A switch to HS400 loads the ETT table, so after a re-init or a resume
+ * that powers the card off the DS delay sweep started over from it.  Keep
+ * what a sweep ended on for this card and start from there instead; if it
+ * stops working the same sweep runs again.
+ */
+static void msdc_hs400_tuned_save(struct msdc_host *host, bool ok)
+{
+	void __iomem *base = host->base;
+	struct mmc_card *card = host->mmc->card;
+	struct msdc_hs400_tuned *t = &host->hs400_tuned;
+
+	if (!ok || !card || host->timing != MMC_TIMING_MMC_HS400) {
+		t->valid = false;
+		return;
+	}
+
+	memcpy(t->cid, card->raw_cid, sizeof(t->cid));
+	sdr_get_field(EMMC50_PAD_DS_TUNE, MSDC_EMMC50_PAD_DS_TUNE_DLY1, t->ds_dly1);
+	sdr_get_field(EMMC50_PAD_DS_TUNE, MSDC_EMMC50_PAD_DS_TUNE_DLY3, t->ds_dly3);
+	t->valid = true;
+}
+
+static void msdc_hs400_tuned_apply(struct msdc_host *host)
+{
+	void __iomem *base = host->base;
+	struct mmc_card *card = host->mmc->card;
+	struct msdc_hs400_tuned *t = &host->hs400_tuned;
+
+	if (!t->valid || !card || memcmp(t->cid, card->raw_cid, sizeof(t->cid)))
+		return;
+
+	sdr_set_field(EMMC50_PAD_DS_TUNE, MSDC_EMMC50_PAD_DS_TUNE_DLY1, t->ds_dly1);
+	sdr_set_field(EMMC50_PAD_DS_TUNE, MSDC_EMMC50_PAD_DS_TUNE_DLY3, t->ds_dly3);
+	host->saved_para.ds_dly1 = t->ds_dly1;
+	host->saved_para.ds_dly3 = t->ds_dly3;
+	pr_err("msdc%d HS400 tuned ds_dly1<0x%x>, ds_dly3<0x%x>", host->id,
+		t->ds_dly1, t->ds_dly3);
+}
+
 static void msdc_reset_crc_tune_counter(struct msdc_host *host,	int index)
 {
 	void __iomem *base = host->base;
@@ -1900,6 +1943,10 @@ static void msdc_reset_crc_tune_counter(struct msdc_host *host,	int index)
 			host->t_counter.time_read = 0;
 			host->t_counter.time_write = 0;
 			if (host->t_counter.time_hs400 != 0) {
+				/* msdc_lower_freq() comes here with the sweep used up */
+				msdc_hs400_tuned_save(host, !g_reset_tune &&
+					host->t_counter.time_hs400 <
+					(g_ett_tune ? (32 * 32) : MAX_HS400_TUNE_COUNT));
 				if (g_reset_tune) {
 					sdr_set_field(EMMC50_PAD_DS_TUNE,
 						MSDC_EMMC50_PAD_DS_TUNE_DLY1, 0x1c);
@@ -2151,20 +2198,17 @@ static void msdc_eirq_sdio(void *data)
 
 #ifdef MTK_SDIO30_ONLINE_TUNING_SUPPORT
 
+/* transfers run at the online tuned timing, which only holds at HPM */
+static DEFINE_VCORE_QOS_REQUEST(sdio_vcore_qos, "sdio");
+
 static void sdio_unreq_vcore(struct work_struct *work)
 {
 	struct msdc_host *host = mtk_msdc_host[2];	/* 6630 in msdc2@Denali */
 
 	pr_warn("** sdio_unreq_vcore() irqs_disabled():%d\n", irqs_disabled());
 	might_sleep();
-	/* mmc_claim_host(host->mmc); */
-	if (vcorefs_request_dvfs_opp(KIR_SDIO, OPPI_UNREQ) == 0) {
-		pr_debug("unrequest vcore pass\n");
-		host->sdio_performance_vcore = 0;
-	} else {
-		pr_err("unrequest vcore fail\n");
-	}
-	/* mmc_release_host(host->mmc); */
+	vcore_qos_remove_request(&sdio_vcore_qos);
+	host->sdio_performance_vcore = 0;
 }
 
 static noinline void sdio_set_vcore_performance(struct msdc_host *host,
@@ -2182,7 +2226,8 @@ static noinline void sdio_set_vcore_performance(struct msdc_host *host,
 		/* true if dwork was pending, false otherwise */
 		if (cancel_delayed_work_sync(&(host->set_vcore_workq)) == 0) {
 			pr_warn("** cancel @ FALSE\n");
-			if (vcorefs_request_dvfs_opp(KIR_SDIO, OPPI_PERF) == 0) {
+			if (vcore_qos_update_request(&sdio_vcore_qos, 0,
+						     VCORE_QOS_LAT_HPM) == 0) {
 				pr_debug("msdc%d -> request vcore pass\n", host->id);
 				host->sdio_performance_vcore = 1;
 			} else {
@@ -3589,6 +3634,13 @@ static unsigned int msdc_command_start(struct msdc_host *host,
 #endif /* end of MTK_MSDC_USE_CMD23 */
 	} else if (opcode == MMC_WRITE_BLOCK) {
 		rawcmd |= ((1 << 11) | (1 << 13));
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+	} else if (opcode == MMC_EXECUTE_READ_TASK) {
+		/* task length was set by CMD44, no auto stop command */
+		rawcmd |= (2 << 11);
+	} else if (opcode == MMC_EXECUTE_WRITE_TASK) {
+		rawcmd |= ((2 << 11) | (1 << 13));
+#endif
 	} else if (opcode == SD_IO_RW_EXTENDED) {
 		if (cmd->data->flags & MMC_DATA_WRITE)
 			rawcmd |= (1 << 13);
@@ -4340,6 +4392,7 @@ static void msdc_dma_start(struct msdc_host *host)
 
 	if (host->autocmd & MSDC_AUTOCMD12)
 		wints |= MSDC_INT_ACMDCRCERR | MSDC_INT_ACMDTMO | MSDC_INT_ACMDRDY;
+	host->lat_req.t_dma = sched_clock();
 	sdr_set_field(MSDC_DMA_CTRL, MSDC_DMA_CTRL_START, 1);
 
 	sdr_set_bits(MSDC_INTEN, wints);
@@ -4410,19 +4463,107 @@ static u8 msdc_dma_calcs(u8 *buf, u32 len)
 	return 0xFF - (u8) sum;
 }
 
+/* fill the gpd/bd list of a descriptor set */
+static void msdc_dma_fill_desc(struct msdc_host *host, u8 set, u32 flags,
+	struct scatterlist *sg, u32 sglen)
+{
+	struct msdc_dma *dma = &host->dma;
+	struct gpd_t *gpd = dma->gpd_set[set];
+	struct bd_t *bd = dma->bd_set[set];
+	dma_addr_t dma_address;
+	u32 dma_len;
+	u32 j, num, bdlen;
+	u8 blkpad, dwpad, chksum;
+
+	blkpad = (flags & DMA_FLAG_PAD_BLOCK) ? 1 : 0;
+	dwpad = (flags & DMA_FLAG_PAD_DWORD) ? 1 : 0;
+	chksum = (flags & DMA_FLAG_EN_CHKSUM) ? 1 : 0;
+
+	/* calculate the required number of gpd */
+	num = (sglen + MAX_BD_PER_GPD - 1) / MAX_BD_PER_GPD;
+	BUG_ON(num != 1);
+
+	bdlen = sglen;
+
+	/* modify gpd */
+	/* gpd->intr = 0; */
+	gpd->hwo = 1;	/* hw will clear it */
+	gpd->bdp = 1;
+	gpd->chksum = 0;	/* need to clear first. */
+	gpd->chksum = (chksum ? msdc_dma_calcs((u8 *) gpd, 16) : 0);
+
+	/* modify bd */
+	for (j = 0; j < bdlen; j++) {
+#ifdef MSDC_DMA_VIOLATION_DEBUG
+		if (g_dma_debug[host->id]
+		    && (msdc_latest_operation_type[host->id] == OPER_TYPE_READ)) {
+			pr_debug("[%s] msdc%d do write 0x10000\n", __func__, host->id);
+			dma_address = 0x10000;
+		} else
+			dma_address = sg_dma_address(sg);
+#else
+		dma_address = sg_dma_address(sg);
+#endif
+
+		/* descriptors are built for dma transfers only */
+		dma_len = msdc_sg_len(sg, 1);
+
+		N_MSG(DMA, "DMA DESC mode dma_len<%x> dma_address<%llx>",
+			dma_len, (u64) dma_address);
+
+		msdc_init_bd(&bd[j], blkpad, dwpad, dma_address, dma_len);
+
+		if (j == bdlen - 1)
+			bd[j].eol = 1;	/* the last bd */
+		else
+			bd[j].eol = 0;
+
+		bd[j].chksum = 0;	/* checksume need to clear first */
+		bd[j].chksum = (chksum ? msdc_dma_calcs((u8 *) (&bd[j]), 16) : 0);
+
+		sg++;
+	}
+#ifdef MSDC_DMA_VIOLATION_DEBUG
+	if (g_dma_debug[host->id]
+	    && (msdc_latest_operation_type[host->id] == OPER_TYPE_READ))
+		g_dma_debug[host->id] = 0;
+#endif
+}
+
+/* point the dma engine at a filled descriptor set */
+static void msdc_dma_start_desc(struct msdc_host *host, struct msdc_dma *dma,
+	u8 set)
+{
+	void __iomem *base = host->base;
+
+#if defined(FEATURE_MET_MMC_INDEX)
+	met_mmc_bdnum = dma->sglen;
+#endif
+
+	dma->cur_set = set;
+	dma->gpd = dma->gpd_set[set];
+	dma->bd = dma->bd_set[set];
+	dma->gpd_addr = dma->gpd_set_addr[set];
+	dma->bd_addr = dma->bd_set_addr[set];
+
+	dma->used_gpd += 2;
+	dma->used_bd += dma->sglen;
+
+	sdr_set_field(MSDC_DMA_CFG, MSDC_DMA_CFG_DECSEN,
+		(dma->flags & DMA_FLAG_EN_CHKSUM) ? 1 : 0);
+	sdr_set_field(MSDC_DMA_CTRL, MSDC_DMA_CTRL_BRUSTSZ, dma->burstsz);
+	sdr_set_field(MSDC_DMA_CTRL, MSDC_DMA_CTRL_MODE, 1);
+
+	sdr_write32(MSDC_DMA_SA, (u32) dma->gpd_addr);
+}
+
 /* gpd bd setup + dma registers */
 static int msdc_dma_config(struct msdc_host *host, struct msdc_dma *dma)
 {
 	void __iomem *base = host->base;
-	u32 sglen = dma->sglen;
-	/* u32 i, j, num, bdlen, arg, xfersz; */
-	u32 j, num, bdlen;
 	dma_addr_t dma_address;
 	u32 dma_len;
-	u8 blkpad, dwpad, chksum;
 	struct scatterlist *sg = dma->sg;
-	struct gpd_t *gpd;
-	struct bd_t *bd;
 
 	switch (dma->mode) {
 	case MSDC_MODE_DMA_BASIC:
@@ -4450,73 +4591,9 @@ static int msdc_dma_config(struct msdc_host *host, struct msdc_dma *dma)
 		sdr_set_field(MSDC_DMA_CTRL, MSDC_DMA_CTRL_MODE, 0);
 		break;
 	case MSDC_MODE_DMA_DESC:
-		blkpad = (dma->flags & DMA_FLAG_PAD_BLOCK) ? 1 : 0;
-		dwpad = (dma->flags & DMA_FLAG_PAD_DWORD) ? 1 : 0;
-		chksum = (dma->flags & DMA_FLAG_EN_CHKSUM) ? 1 : 0;
-
-		/* calculate the required number of gpd */
-		num = (sglen + MAX_BD_PER_GPD - 1) / MAX_BD_PER_GPD;
-		BUG_ON(num != 1);
-
-		gpd = dma->gpd;
-		bd = dma->bd;
-		bdlen = sglen;
-
-#if defined(FEATURE_MET_MMC_INDEX)
-		met_mmc_bdnum = bdlen;
-#endif
-
-		/* modify gpd */
-		/* gpd->intr = 0; */
-		gpd->hwo = 1;	/* hw will clear it */
-		gpd->bdp = 1;
-		gpd->chksum = 0;	/* need to clear first. */
-		gpd->chksum = (chksum ? msdc_dma_calcs((u8 *) gpd, 16) : 0);
-
-		/* modify bd */
-		for (j = 0; j < bdlen; j++) {
-#ifdef MSDC_DMA_VIOLATION_DEBUG
-			if (g_dma_debug[host->id]
-			    && (msdc_latest_operation_type[host->id] == OPER_TYPE_READ)) {
-				pr_debug("[%s] msdc%d do write 0x10000\n", __func__, host->id);
-				dma_address = 0x10000;
-			} else
-				dma_address = sg_dma_address(sg);
-#else
-			dma_address = sg_dma_address(sg);
-#endif
-
-			dma_len = msdc_sg_len(sg, host->dma_xfer);
-
-			N_MSG(DMA, "DMA DESC mode dma_len<%x> dma_address<%llx>",
-				dma_len, (u64) dma_address);
-
-			msdc_init_bd(&bd[j], blkpad, dwpad, dma_address, dma_len);
-
-			if (j == bdlen - 1)
-				bd[j].eol = 1;	/* the last bd */
-			else
-				bd[j].eol = 0;
-
-			bd[j].chksum = 0;	/* checksume need to clear first */
-			bd[j].chksum = (chksum ? msdc_dma_calcs((u8 *) (&bd[j]), 16) : 0);
-
-			sg++;
-		}
-#ifdef MSDC_DMA_VIOLATION_DEBUG
-		if (g_dma_debug[host->id]
-		    && (msdc_latest_operation_type[host->id] == OPER_TYPE_READ))
-			g_dma_debug[host->id] = 0;
-#endif
-
-		dma->used_gpd += 2;
-		dma->used_bd += bdlen;
-
-		sdr_set_field(MSDC_DMA_CFG, MSDC_DMA_CFG_DECSEN, chksum);
-		sdr_set_field(MSDC_DMA_CTRL, MSDC_DMA_CTRL_BRUSTSZ, dma->burstsz);
-		sdr_set_field(MSDC_DMA_CTRL, MSDC_DMA_CTRL_MODE, 1);
-
-		sdr_write32(MSDC_DMA_SA, (u32) dma->gpd_addr);
+		/* the other set may hold a request prepared ahead */
+		msdc_dma_fill_desc(host, dma->cur_set, dma->flags, sg, dma->sglen);
+		msdc_dma_start_desc(host, dma, dma->cur_set);
 		break;
 
 	default:
@@ -4530,28 +4607,39 @@ static int msdc_dma_config(struct msdc_host *host, struct msdc_dma *dma)
 	return 0;
 }
 
-static void msdc_dma_setup(struct msdc_host *host, struct msdc_dma *dma,
-	struct scatterlist *sg, unsigned int sglen)
+static bool msdc_dma_use_desc(struct msdc_host *host, struct scatterlist *sg,
+	unsigned int sglen, u32 dma_xfer)
 {
-	u32 max_dma_len = 0;
+	u32 max_dma_len;
 
+	if (host->hw->host_function == MSDC_SDIO)
+		max_dma_len = MAX_DMA_CNT_SDIO;
+	else
+		max_dma_len = MAX_DMA_CNT;
+
+	return !(sglen == 1 && msdc_sg_len(sg, dma_xfer) <= max_dma_len);
+}
+
+static void msdc_dma_init_xfer(struct msdc_host *host, struct msdc_dma *dma,
+	struct scatterlist *sg, unsigned int sglen)
+{
 	BUG_ON(sglen > MAX_BD_NUM);	/* not support currently */
 	dma->sg = sg;
-	dma->flags = DMA_FLAG_EN_CHKSUM;
-	/* dma->flags = DMA_FLAG_NONE; */ /* CHECKME */
+	dma->flags = MSDC_DMA_FLAGS;
 	dma->sglen = sglen;
 	dma->xfersz = host->xfer_size;
 	dma->burstsz = MSDC_BRUST_64B;
+}
 
-	if (host->hw->host_function == MSDC_SDIO)
-		max_dma_len = MAX_DMA_CNT_SDIO;
-	else
-		max_dma_len = MAX_DMA_CNT;
+static void msdc_dma_setup(struct msdc_host *host, struct msdc_dma *dma,
+	struct scatterlist *sg, unsigned int sglen)
+{
+	msdc_dma_init_xfer(host, dma, sg, sglen);
 
-	if (sglen == 1 && msdc_sg_len(sg, host->dma_xfer) <= max_dma_len)
-		dma->mode = MSDC_MODE_DMA_BASIC;
-	else
+	if (msdc_dma_use_desc(host, sg, sglen, host->dma_xfer))
 		dma->mode = MSDC_MODE_DMA_DESC;
+	else
+		dma->mode = MSDC_MODE_DMA_BASIC;
 
 	N_MSG(DMA, "DMA mode<%d> sglen<%d> xfersz<%d>",
 		dma->mode, dma->sglen, dma->xfersz);
@@ -4559,6 +4647,36 @@ static void msdc_dma_setup(struct msdc_host *host, struct msdc_dma *dma,
 	msdc_dma_config(host, dma);
 }
 
+/* async request whose descriptors were built by msdc_dma_prepare() */
+static void msdc_dma_setup_prepared(struct msdc_host *host, struct msdc_dma *dma,
+	struct mmc_data *data)
+{
+	msdc_dma_init_xfer(host, dma, data->sg, data->sg_len);
+	dma->mode = MSDC_MODE_DMA_DESC;
+
+	N_MSG(DMA, "DMA prepared sglen<%d> xfersz<%d>", dma->sglen, dma->xfersz);
+
+	msdc_dma_start_desc(host, dma,
+		(data->host_cookie & MSDC_COOKIE_DESC_SET) ? 1 : 0);
+}
+
+/* Build the descriptors of the next async request while the current
+ * one is still on the bus, in the set the running transfer does not use.
+ */
+static void msdc_dma_prepare(struct msdc_host *host, struct mmc_data *data)
+{
+	u8 set = host->dma.cur_set ^ 1;
+
+	if (!msdc_dma_use_desc(host, data->sg, data->sg_len, 1))
+		return;
+
+	BUG_ON(data->sg_len > MAX_BD_NUM);
+	msdc_dma_fill_desc(host, set, MSDC_DMA_FLAGS, data->sg, data->sg_len);
+	data->host_cookie |= MSDC_COOKIE_DESC;
+	if (set)
+		data->host_cookie |= MSDC_COOKIE_DESC_SET;
+}
+
 /* set block number before send command */
 static void msdc_set_blknum(struct msdc_host *host, u32 blknum)
 {
@@ -4827,6 +4945,7 @@ static int msdc_do_request(struct mmc_host *mmc, struct mmc_request *mrq)
 		}
 
 		msdc_set_blknum(host, data->blocks);
+		msdc_lat_issue(host, read);
 		/* msdc_clr_fifo();  */ /* no need */
 
 #ifdef MTK_MSDC_USE_CMD23
@@ -4895,6 +5014,9 @@ static int msdc_do_request(struct mmc_host *mmc, struct mmc_request *mrq)
 			/* then wait command done */
 			if (msdc_command_resp_polling(host, cmd, 0, CMD_TIMEOUT))
 				goto stop;
+			host->lat_req.t_cmd = sched_clock();
+			msdc_lat_account(host, MSDC_LAT_CMD, host->lat_req.t_issue,
+					 host->lat_req.t_cmd);
 
 			/* for read, the data coming too fast, then CRC error
 			 * start DMA no business with CRC.
@@ -4920,6 +5042,10 @@ static int msdc_do_request(struct mmc_host *mmc, struct mmc_request *mrq)
 				msdc_dump_info(host->id);
 				data->error = (unsigned int)-ETIMEDOUT;
 				msdc_reset(host->id);
+			} else {
+				host->lat_req.t_xfer = sched_clock();
+				msdc_lat_account(host, MSDC_LAT_DMA, host->lat_req.t_dma,
+						 host->lat_req.t_xfer);
 			}
 			spin_lock(&host->lock);
 			msdc_dma_stop(host);
@@ -5418,7 +5544,9 @@ static void msdc_pre_req(struct mmc_host *mmc, struct mmc_request *mrq,
 		if (msdc_async_use_dma(data->host_cookie)) {
 			dir = read ? DMA_FROM_DEVICE : DMA_TO_DEVICE;
 			(void)dma_map_sg(mmc_dev(mmc), data->sg, data->sg_len, dir);
+			msdc_dma_prepare(host, data);
 		}
+		host->lat_req.t_prep = sched_clock();
 		N_MSG(OPS, "CMD<%d> ARG<0x%x>data<%s %s> blksz<%d> block<%d> error<%d>",
 		      mrq->cmd->opcode, mrq->cmd->arg,
 		      (data->host_cookie ? "dma" : "pio"), (read ? "read " : "write"),
@@ -5534,6 +5662,7 @@ static int msdc_do_request_async(struct mmc_host *mmc, struct mmc_request *mrq)
 		msdc_set_timeout(host, data->timeout_ns, data->timeout_clks);
 
 	msdc_set_blknum(host, data->blocks);
+	msdc_lat_issue(host, read);
 	msdc_dma_on();		/* enable DMA mode first!! */
 	/* init_completion(&host->xfer_done); */
 
@@ -5595,11 +5724,17 @@ static int msdc_do_request_async(struct mmc_host *mmc, struct mmc_request *mrq)
 	/* then wait command done */
 	if (msdc_command_resp_polling(host, cmd, 0, CMD_TIMEOUT) != 0)
 		goto stop;
+	host->lat_req.t_cmd = sched_clock();
+	msdc_lat_account(host, MSDC_LAT_CMD, host->lat_req.t_issue,
+			 host->lat_req.t_cmd);
 
 	/* for read, the data coming too fast, then CRC error
 	   start DMA no business with CRC. */
 	/* init_completion(&host->xfer_done); */
-	msdc_dma_setup(host, &host->dma, data->sg, data->sg_len);
+	if (data->host_cookie & MSDC_COOKIE_DESC)
+		msdc_dma_setup_prepared(host, &host->dma, data);
+	else
+		msdc_dma_setup(host, &host->dma, data->sg, data->sg_len);
 	msdc_dma_start(host);
 	spin_unlock(&host->lock);
 
@@ -7550,6 +7685,7 @@ static void msdc_ops_set_ios(struct mmc_host *mmc, struct mmc_ios *ios)
 				/* switch from eMMC 4.5 backward speed mode to HS400 */
 				emmc_hs400_backup();
 				msdc_apply_ett_settings(host, MSDC_HS400_MODE);
+				msdc_hs400_tuned_apply(host);
 			}
 			/* switch from HS400 to eMMC 4.5 backward speed mode */
 			if (host->timing == MMC_TIMING_MMC_HS400)
@@ -8062,9 +8198,14 @@ done:
 	if (!(msdc_async_use_dma(data->host_cookie)) || !(host->tune == 0)) {
 		complete(&host->xfer_done);
 	} else {
+		host->lat_req.t_xfer = sched_clock();
+		msdc_lat_account(host, MSDC_LAT_DMA, host->lat_req.t_dma,
+				 host->lat_req.t_xfer);
 		msdc_dma_stop(host);
 		msdc_dma_clear(host);
 		mmc_request_done(mmc, mrq);
+		msdc_lat_account(host, MSDC_LAT_DONE, host->lat_req.t_xfer,
+				 sched_clock());
 		msdc_gate_clock(host, 1);
 		host->error &= ~REQ_DAT_ERR;
 	}
@@ -8314,29 +8455,43 @@ void msdc_dump_gpd_bd(int id)
 /* init gpd and bd list in msdc_drv_probe */
 static void msdc_init_gpd_bd(struct msdc_host *host, struct msdc_dma *dma)
 {
-	struct gpd_t *gpd = dma->gpd;
-	struct bd_t *bd = dma->bd;
+	struct gpd_t *gpd;
+	struct bd_t *bd;
 	struct bd_t *ptr, *prev;
+	dma_addr_t gpd_addr, bd_addr;
+	int i;
 
 	/* we just support one gpd */
 	int bdlen = MAX_BD_PER_GPD;
 
-	/* init the 2 gpd */
-	memset(gpd, 0, sizeof(struct gpd_t) * 2);
-	gpd->next = (u32) dma->gpd_addr + sizeof(struct gpd_t);
+	for (i = 0; i < MSDC_DMA_DESC_SETS; i++) {
+		gpd = dma->gpd + i * MAX_GPD_NUM;
+		bd = dma->bd + i * MAX_BD_NUM;
+		gpd_addr = dma->gpd_addr + i * MAX_GPD_NUM * sizeof(struct gpd_t);
+		bd_addr = dma->bd_addr + i * MAX_BD_NUM * sizeof(struct bd_t);
 
-	/* gpd->intr = 0; */
-	gpd->bdp = 1;		/* hwo, cs, bd pointer */
-	/* gpd->ptr  = (void*)virt_to_phys(bd); */
-	gpd->ptr = (u32) dma->bd_addr;	/* physical address */
+		dma->gpd_set[i] = gpd;
+		dma->bd_set[i] = bd;
+		dma->gpd_set_addr[i] = gpd_addr;
+		dma->bd_set_addr[i] = bd_addr;
 
-	memset(bd, 0, sizeof(struct bd_t) * bdlen);
-	ptr = bd + bdlen - 1;
-	while (ptr != bd) {
-		prev = ptr - 1;
-		prev->next = ((u32) dma->bd_addr + sizeof(struct bd_t) * (ptr - bd));
-		ptr = prev;
+		/* init the 2 gpd */
+		memset(gpd, 0, sizeof(struct gpd_t) * 2);
+		gpd->next = (u32) gpd_addr + sizeof(struct gpd_t);
+
+		/* gpd->intr = 0; */
+		gpd->bdp = 1;		/* hwo, cs, bd pointer */
+		gpd->ptr = (u32) bd_addr;	/* physical address */
+
+		memset(bd, 0, sizeof(struct bd_t) * bdlen);
+		ptr = bd + bdlen - 1;
+		while (ptr != bd) {
+			prev = ptr - 1;
+			prev->next = ((u32) bd_addr + sizeof(struct bd_t) * (ptr - bd));
+			ptr = prev;
+		}
 	}
+	dma->cur_set = 0;
 }
 
 #ifdef MSDC_DMA_ADDR_DEBUG
@@ -9000,6 +9155,10 @@ static int msdc_drv_probe(struct platform_device *pdev)
 		mmc->caps |= MMC_CAP_ERASE;
 #else
 	mmc->caps |= MMC_CAP_ERASE;
+#endif
+#ifdef CONFIG_MTK_EMMC_CQ_SUPPORT
+	if (host->hw->host_function == MSDC_EMMC)
+		mmc->caps2 |= MMC_CAP2_CMDQ;
 #endif
 	mmc->max_busy_timeout = 0;
 	/* MMC core transfer sizes tunable parameters */
@@ -9094,9 +9253,11 @@ static int msdc_drv_probe(struct platform_device *pdev)
 	/* using dma_alloc_coherent */
 	/* todo: using 1, for all 4 slots */
 	host->dma.gpd = dma_alloc_coherent(&pdev->dev,
-		MAX_GPD_NUM * sizeof(struct gpd_t),	&host->dma.gpd_addr, GFP_KERNEL);
+		MSDC_DMA_DESC_SETS * MAX_GPD_NUM * sizeof(struct gpd_t),
+		&host->dma.gpd_addr, GFP_KERNEL);
 	host->dma.bd = dma_alloc_coherent(&pdev->dev,
-		MAX_BD_NUM * sizeof(struct bd_t), &host->dma.bd_addr, GFP_KERNEL);
+		MSDC_DMA_DESC_SETS * MAX_BD_NUM * sizeof(struct bd_t),
+		&host->dma.bd_addr, GFP_KERNEL);
 	BUG_ON((!host->dma.gpd) || (!host->dma.bd));
 	msdc_init_gpd_bd(host, &host->dma);
 	msdc_clock_src[host->id] = host->hw->clk_src;
@@ -9285,10 +9446,10 @@ static int msdc_drv_remove(struct platform_device *pdev)
 
 	free_irq(host->irq, host);
 
-	dma_free_coherent(NULL, MAX_GPD_NUM * sizeof(struct gpd_t), host->dma.gpd,
-		host->dma.gpd_addr);
-	dma_free_coherent(NULL, MAX_BD_NUM * sizeof(struct bd_t), host->dma.bd,
-		host->dma.bd_addr);
+	dma_free_coherent(NULL, MSDC_DMA_DESC_SETS * MAX_GPD_NUM * sizeof(struct gpd_t),
+		host->dma.gpd_set[0], host->dma.gpd_set_addr[0]);
+	dma_free_coherent(NULL, MSDC_DMA_DESC_SETS * MAX_BD_NUM * sizeof(struct bd_t),
+		host->dma.bd_set[0], host->dma.bd_set_addr[0]);
 
 	mem = platform_get_resource(pdev, IORESOURCE_MEM, 0);
 
@@ -30,6 +30,8 @@
 #include <linux/personality.h>
 #include <linux/bitops.h>
 #include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/wait.h>
 #include <linux/shmem_fs.h>
 #include "ashmem.h"
 
@@ -44,9 +46,13 @@
  * @file:		The shmem-based backing file
  * @size:		The size of the mapping, in bytes
  * @prot_masks:		The allowed protection bits, as vm_flags
+ * @mutex:		Protects all of the above
+ * @purge_inflight:	Ranges the shrinker took off the LRU and is still
+ *			punching holes for
+ * @purge_wait:		Woken when @purge_inflight drops to zero
  *
  * The lifecycle of this structure is from our parent file's open() until
- * its release(). It is also protected by 'ashmem_mutex'
+ * its release().
  *
  * Warning: Mappings do NOT pin this structure; It dies on close()
  */
@@ -56,6 +62,9 @@ struct ashmem_area {
 	struct file *file;
 	size_t size;
 	unsigned long prot_mask;
+	struct mutex mutex;
+	atomic_t purge_inflight;
+	wait_queue_head_t purge_wait;
 };
 
 /**
@@ -68,7 +77,8 @@ struct ashmem_area {
  * @purged:	         The purge status (ASHMEM_NOT or ASHMEM_WAS_PURGED)
  *
  * The lifecycle of this structure is from unpin to pin.
- * It is protected by 'ashmem_mutex'
+ * It is protected by its area's mutex; @lru, @purged and changes to the
+ * bounds of a range on the LRU also need 'ashmem_lru_lock'.
  */
 struct ashmem_range {
 	struct list_head lru;
@@ -79,22 +89,29 @@ struct ashmem_range {
 	unsigned int purged;
 };
 
-/* LRU list of unpinned pages, protected by ashmem_mutex */
+/* LRU list of unpinned pages, protected by ashmem_lru_lock */
 static LIST_HEAD(ashmem_lru_list);
 
 /**
  * long lru_count - The count of pages on our LRU list.
  *
- * This is protected by ashmem_mutex.
+ * This is protected by ashmem_lru_lock.
  */
 static unsigned long lru_count;
 
 /**
- * ashmem_mutex - protects the list of and each individual ashmem_area
+ * ashmem_lru_lock - protects the LRU list and the purge state of the ranges
  *
- * Lock Ordering: ashmex_mutex -> i_mutex -> i_alloc_sem
+ * Held for list updates only, never across an allocation or a hole punch,
+ * so the shrinker can always take it.
+ *
+ * Lock Ordering: asma->mutex -> ashmem_lru_lock
+ *		  asma->mutex -> i_mutex -> i_alloc_sem
  */
-static DEFINE_MUTEX(ashmem_mutex);
+static DEFINE_SPINLOCK(ashmem_lru_lock);
+
+/* ranges the shrinker takes off the LRU before it drops ashmem_lru_lock */
+#define ASHMEM_PURGE_BATCH	8
 
 static struct kmem_cache *ashmem_area_cachep __read_mostly;
 static struct kmem_cache *ashmem_range_cachep __read_mostly;
@@ -129,6 +146,8 @@ static struct kmem_cache *ashmem_range_cachep __read_mostly;
  *
  * The range is first added to the end (tail) of the LRU list.
  * After this, the size of the range is added to @lru_count
+ *
+ * Caller must hold ashmem_lru_lock.
  */
 static inline void lru_add(struct ashmem_range *range)
 {
@@ -142,6 +161,8 @@ static inline void lru_add(struct ashmem_range *range)
  *
  * The range is first deleted from the LRU list.
  * After this, the size of the range is removed from @lru_count
+ *
+ * Caller must hold ashmem_lru_lock.
  */
 static inline void lru_del(struct ashmem_range *range)
 {
@@ -150,27 +171,20 @@ static inline void lru_del(struct ashmem_range *range)
 }
 
 /**
- * range_alloc() - Allocates and initializes a new ashmem_range structure
+ * range_insert() - Initializes a new ashmem_range structure and links it in
+ * @range:	   The ashmem_range, allocated before taking ashmem_lru_lock
  * @asma:	   The associated ashmem_area
  * @prev_range:	   The previous ashmem_range in the sorted asma->unpinned list
  * @purged:	   Initial purge status (ASMEM_NOT_PURGED or ASHMEM_WAS_PURGED)
  * @start:	   The starting page (inclusive)
  * @end:	   The ending page (inclusive)
  *
- * This function is protected by ashmem_mutex.
- *
- * Return: 0 if successful, or -ENOMEM if there is an error
+ * Caller must hold asma->mutex and ashmem_lru_lock.
  */
-static int range_alloc(struct ashmem_area *asma,
-		       struct ashmem_range *prev_range, unsigned int purged,
-		       size_t start, size_t end)
+static void range_insert(struct ashmem_range *range, struct ashmem_area *asma,
+			 struct ashmem_range *prev_range, unsigned int purged,
+			 size_t start, size_t end)
 {
-	struct ashmem_range *range;
-
-	range = kmem_cache_zalloc(ashmem_range_cachep, GFP_KERNEL);
-	if (unlikely(!range))
-		return -ENOMEM;
-
 	range->asma = asma;
 	range->pgstart = start;
 	range->pgend = end;
@@ -180,13 +194,13 @@ static int range_alloc(struct ashmem_area *asma,
 
 	if (range_on_lru(range))
 		lru_add(range);
-
-	return 0;
 }
 
 /**
  * range_del() - Deletes and dealloctes an ashmem_range structure
  * @range:	 The associated ashmem_range that has previously been allocated
+ *
+ * Caller must hold asma->mutex and ashmem_lru_lock.
  */
 static void range_del(struct ashmem_range *range)
 {
@@ -207,6 +221,8 @@ static void range_del(struct ashmem_range *range)
  *
  * Theoretically, with a little tweaking, this could eventually be changed
  * to range_resize, and expand the lru_count if the new range is larger.
+ *
+ * Caller must hold asma->mutex and ashmem_lru_lock.
  */
 static inline void range_shrink(struct ashmem_range *range,
 				size_t start, size_t end)
@@ -244,6 +260,9 @@ static int ashmem_open(struct inode *inode, struct file *file)
 		return -ENOMEM;
 
 	INIT_LIST_HEAD(&asma->unpinned_list);
+	mutex_init(&asma->mutex);
+	atomic_set(&asma->purge_inflight, 0);
+	init_waitqueue_head(&asma->purge_wait);
 	memcpy(asma->name, ASHMEM_NAME_PREFIX, ASHMEM_NAME_PREFIX_LEN);
 	asma->prot_mask = PROT_MASK;
 	file->private_data = asma;
@@ -264,10 +283,17 @@ static int ashmem_release(struct inode *ignored, struct file *file)
 	struct ashmem_area *asma = file->private_data;
 	struct ashmem_range *range, *next;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->mutex);
+	spin_lock(&ashmem_lru_lock);
 	list_for_each_entry_safe(range, next, &asma->unpinned_list, unpinned)
 		range_del(range);
-	mutex_unlock(&ashmem_mutex);
+	spin_unlock(&ashmem_lru_lock);
+	mutex_unlock(&asma->mutex);
+
+	/* the shrinker wakes us under ashmem_lru_lock, let it finish that */
+	wait_event(asma->purge_wait, !atomic_read(&asma->purge_inflight));
+	spin_lock(&ashmem_lru_lock);
+	spin_unlock(&ashmem_lru_lock);
 
 	if (asma->file)
 		fput(asma->file);
@@ -291,7 +317,7 @@ static ssize_t ashmem_read(struct file *file, char __user *buf,
 	struct ashmem_area *asma = file->private_data;
 	int ret = 0;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->mutex);
 
 	/* If size is not set, or set to 0, always return EOF. */
 	if (asma->size == 0)
@@ -302,7 +328,7 @@ static ssize_t ashmem_read(struct file *file, char __user *buf,
 		goto out_unlock;
 	}
 
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->mutex);
 
 	/*
 	 * asma and asma->file are used outside the lock here.  We assume
@@ -318,7 +344,7 @@ static ssize_t ashmem_read(struct file *file, char __user *buf,
 	return ret;
 
 out_unlock:
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->mutex);
 	return ret;
 }
 
@@ -327,7 +353,7 @@ static loff_t ashmem_llseek(struct file *file, loff_t offset, int origin)
 	struct ashmem_area *asma = file->private_data;
 	int ret;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->mutex);
 
 	if (asma->size == 0) {
 		ret = -EINVAL;
@@ -347,7 +373,7 @@ static loff_t ashmem_llseek(struct file *file, loff_t offset, int origin)
 	file->f_pos = asma->file->f_pos;
 
 out:
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->mutex);
 	return ret;
 }
 
@@ -363,7 +389,7 @@ static int ashmem_mmap(struct file *file, struct vm_area_struct *vma)
 	struct ashmem_area *asma = file->private_data;
 	int ret = 0;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->mutex);
 
 	/* user needs to SET_SIZE before mapping */
 	if (unlikely(!asma->size)) {
@@ -405,7 +431,7 @@ static int ashmem_mmap(struct file *file, struct vm_area_struct *vma)
 	}
 
 out:
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->mutex);
 	return ret;
 }
 
@@ -420,37 +446,68 @@ out:
  * proceed without risk of deadlock (due to gfp_mask).
  *
  * We approximate LRU via least-recently-unpinned, jettisoning unpinned partial
- * chunks of ashmem regions LRU-wise one-at-a-time until we hit 'nr_to_scan'
- * pages freed.
+ * chunks of ashmem regions LRU-wise until we hit 'nr_to_scan' ranges.  Up to
+ * ASHMEM_PURGE_BATCH of them are marked purged and taken off the LRU at a
+ * time, and the holes are punched with no lock held, so pin/unpin of other
+ * areas goes on meanwhile.  A pin of the same area waits for the punch, see
+ * ashmem_pin().
  */
 static unsigned long
 ashmem_shrink_scan(struct shrinker *shrink, struct shrink_control *sc)
 {
-	struct ashmem_range *range, *next;
+	struct {
+		struct ashmem_area *asma;
+		struct file *file;
+		loff_t start;
+		loff_t len;
+	} batch[ASHMEM_PURGE_BATCH];
+	struct ashmem_range *range;
 	unsigned long freed = 0;
+	int i, n;
 
 	/* We might recurse into filesystem code, so bail out if necessary */
 	if (!(sc->gfp_mask & __GFP_FS))
 		return SHRINK_STOP;
 
-	if (!mutex_trylock(&ashmem_mutex))
-		return -1;
+	while (sc->nr_to_scan > 0) {
+		n = 0;
+		spin_lock(&ashmem_lru_lock);
+		while (n < ASHMEM_PURGE_BATCH && sc->nr_to_scan > 0 &&
+		       !list_empty(&ashmem_lru_list)) {
+			range = list_first_entry(&ashmem_lru_list,
+						 struct ashmem_range, lru);
+			batch[n].asma = range->asma;
+			batch[n].file = range->asma->file;
+			batch[n].start = range->pgstart * PAGE_SIZE;
+			batch[n].len = range_size(range) * PAGE_SIZE;
+			get_file(batch[n].file);
+			atomic_inc(&range->asma->purge_inflight);
+			n++;
+
+			range->purged = ASHMEM_WAS_PURGED;
+			lru_del(range);
+
+			freed += range_size(range);
+			sc->nr_to_scan--;
+		}
+		spin_unlock(&ashmem_lru_lock);
 
-	list_for_each_entry_safe(range, next, &ashmem_lru_list, lru) {
-		loff_t start = range->pgstart * PAGE_SIZE;
-		loff_t end = (range->pgend + 1) * PAGE_SIZE;
+		if (!n)
+			break;
 
-		range->asma->file->f_op->fallocate(range->asma->file,
-				FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
-				start, end - start);
-		range->purged = ASHMEM_WAS_PURGED;
-		lru_del(range);
+		for (i = 0; i < n; i++) {
+			batch[i].file->f_op->fallocate(batch[i].file,
+					FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+					batch[i].start, batch[i].len);
+			fput(batch[i].file);
+		}
 
-		freed += range_size(range);
-		if (--sc->nr_to_scan <= 0)
-			break;
+		spin_lock(&ashmem_lru_lock);
+		for (i = 0; i < n; i++)
+			if (atomic_dec_and_test(&batch[i].asma->purge_inflight))
+				wake_up_all(&batch[i].asma->purge_wait);
+		spin_unlock(&ashmem_lru_lock);
 	}
-	mutex_unlock(&ashmem_mutex);
 	return freed;
 }
 
@@ -479,7 +536,7 @@ static int set_prot_mask(struct ashmem_area *asma, unsigned long prot)
 {
 	int ret = 0;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->mutex);
 
 	/* the user can only remove, not add, protection bits */
 	if (unlikely((asma->prot_mask & prot) != prot)) {
@@ -494,7 +551,7 @@ static int set_prot_mask(struct ashmem_area *asma, unsigned long prot)
 	asma->prot_mask = prot;
 
 out:
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->mutex);
 	return ret;
 }
 
@@ -505,10 +562,10 @@ static int set_name(struct ashmem_area *asma, void __user *name)
 	char local_name[ASHMEM_NAME_LEN];
 
 	/*
-	 * Holding the ashmem_mutex while doing a copy_from_user might cause
+	 * Holding the asma->mutex while doing a copy_from_user might cause
 	 * an data abort which would try to access mmap_sem. If another
 	 * thread has invoked ashmem_mmap then it will be holding the
-	 * semaphore and will be waiting for ashmem_mutex, there by leading to
+	 * semaphore and will be waiting for asma->mutex, there by leading to
 	 * deadlock. We'll release the mutex  and take the name to a local
 	 * variable that does not need protection and later copy the local
 	 * variable to the structure member with lock held.
@@ -518,14 +575,14 @@ static int set_name(struct ashmem_area *asma, void __user *name)
 		return len;
 	if (len == ASHMEM_NAME_LEN)
 		local_name[ASHMEM_NAME_LEN - 1] = '\0';
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->mutex);
 	/* cannot change an existing mapping's name */
 	if (unlikely(asma->file))
 		ret = -EINVAL;
 	else
 		strcpy(asma->name + ASHMEM_NAME_PREFIX_LEN, local_name);
 
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->mutex);
 	return ret;
 }
 
@@ -541,7 +598,7 @@ static int get_name(struct ashmem_area *asma, void __user *name)
 	 */
 	char local_name[ASHMEM_NAME_LEN];
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->mutex);
 	if (asma->name[ASHMEM_NAME_PREFIX_LEN] != '\0') {
 
 		/*
@@ -554,7 +611,7 @@ static int get_name(struct ashmem_area *asma, void __user *name)
 		len = sizeof(ASHMEM_NAME_DEF);
 		memcpy(local_name, ASHMEM_NAME_DEF, len);
 	}
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->mutex);
 
 	/*
 	 * Now we are just copying from the stack variable to userland
@@ -569,13 +626,15 @@ static int get_name(struct ashmem_area *asma, void __user *name)
  * ashmem_pin - pin the given ashmem region, returning whether it was
  * previously purged (ASHMEM_WAS_PURGED) or not (ASHMEM_NOT_PURGED).
  *
- * Caller must hold ashmem_mutex.
+ * Caller must hold asma->mutex.
  */
 static int ashmem_pin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 {
-	struct ashmem_range *range, *next;
+	struct ashmem_range *range, *next, *spare = NULL;
 	int ret = ASHMEM_NOT_PURGED;
 
+restart:
+	spin_lock(&ashmem_lru_lock);
 	list_for_each_entry_safe(range, next, &asma->unpinned_list, unpinned) {
 		/* moved past last applicable page; we can short circuit */
 		if (range_before_page(range, pgstart))
@@ -622,12 +681,31 @@ static int ashmem_pin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 			 * more complicated, we allocate a new range for the
 			 * second half and adjust the first chunk's endpoint.
 			 */
-			range_alloc(asma, range, range->purged,
-				    pgend + 1, range->pgend);
+			if (!spare) {
+				spin_unlock(&ashmem_lru_lock);
+				spare = kmem_cache_zalloc(ashmem_range_cachep,
+							  GFP_KERNEL);
+				if (unlikely(!spare))
+					return -ENOMEM;
+				goto restart;
+			}
+			range_insert(spare, asma, range, range->purged,
+				     pgend + 1, range->pgend);
 			range_shrink(range, range->pgstart, pgstart - 1);
+			spare = NULL;
 			break;
 		}
 	}
+	spin_unlock(&ashmem_lru_lock);
+
+	if (spare)
+		kmem_cache_free(ashmem_range_cachep, spare);
+
+	/*
+	 * A punch the shrinker took before the ranges were changed above may
+	 * still cover these pages; do not hand them back before it is done.
+	 */
+	wait_event(asma->purge_wait, !atomic_read(&asma->purge_inflight));
 
 	return ret;
 }
@@ -635,13 +713,18 @@ static int ashmem_pin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 /*
  * ashmem_unpin - unpin the given range of pages. Returns zero on success.
  *
- * Caller must hold ashmem_mutex.
+ * Caller must hold asma->mutex.
  */
 static int ashmem_unpin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 {
-	struct ashmem_range *range, *next;
+	struct ashmem_range *range, *next, *new_range;
 	unsigned int purged = ASHMEM_NOT_PURGED;
 
+	new_range = kmem_cache_zalloc(ashmem_range_cachep, GFP_KERNEL);
+	if (unlikely(!new_range))
+		return -ENOMEM;
+
+	spin_lock(&ashmem_lru_lock);
 restart:
 	list_for_each_entry_safe(range, next, &asma->unpinned_list, unpinned) {
 		/* short circuit: this is our insertion point */
@@ -652,8 +735,11 @@ restart:
 		 * The user can ask us to unpin pages that are already entirely
 		 * or partially pinned. We handle those two cases here.
 		 */
-		if (page_range_subsumed_by_range(range, pgstart, pgend))
+		if (page_range_subsumed_by_range(range, pgstart, pgend)) {
+			spin_unlock(&ashmem_lru_lock);
+			kmem_cache_free(ashmem_range_cachep, new_range);
 			return 0;
+		}
 		if (page_range_in_range(range, pgstart, pgend)) {
 			pgstart = min_t(size_t, range->pgstart, pgstart),
 			pgend = max_t(size_t, range->pgend, pgend);
@@ -663,14 +749,17 @@ restart:
 		}
 	}
 
-	return range_alloc(asma, range, purged, pgstart, pgend);
+	range_insert(new_range, asma, range, purged, pgstart, pgend);
+	spin_unlock(&ashmem_lru_lock);
+
+	return 0;
 }
 
 /*
  * ashmem_get_pin_status - Returns ASHMEM_IS_UNPINNED if _any_ pages in the
  * given interval are unpinned and ASHMEM_IS_PINNED otherwise.
  *
- * Caller must hold ashmem_mutex.
+ * Caller must hold asma->mutex.
  */
 static int ashmem_get_pin_status(struct ashmem_area *asma, size_t pgstart,
 				 size_t pgend)
@@ -719,7 +808,7 @@ static int ashmem_pin_unpin(struct ashmem_area *asma, unsigned long cmd,
 	pgstart = pin.offset / PAGE_SIZE;
 	pgend = pgstart + (pin.len / PAGE_SIZE) - 1;
 
-	mutex_lock(&ashmem_mutex);
+	mutex_lock(&asma->mutex);
 
 	switch (cmd) {
 	case ASHMEM_PIN:
@@ -733,7 +822,7 @@ static int ashmem_pin_unpin(struct ashmem_area *asma, unsigned long cmd,
 		break;
 	}
 
-	mutex_unlock(&ashmem_mutex);
+	mutex_unlock(&asma->mutex);
 
 	return ret;
 }
@@ -22,6 +22,7 @@
 #include <linux/file.h>
 #include <linux/freezer.h>
 #include <linux/fs.h>
+#include <linux/hash.h>
 #include <linux/list.h>
 #include <linux/miscdevice.h>
 #include <linux/mm.h>
@@ -204,6 +205,14 @@ module_param_named(debug_mask, binder_debug_mask, uint, S_IWUSR | S_IRUGO);
 static bool binder_debug_no_lock;
 module_param_named(proc_no_lock, binder_debug_no_lock, bool, S_IWUSR | S_IRUGO);
 
+/* Upper bound of pages a proc keeps mapped for later buffers */
+static unsigned int binder_cache_max_pages = 64;
+module_param_named(cache_max_pages, binder_cache_max_pages, uint, S_IWUSR | S_IRUGO);
+
+/* Calls taking at least this long end up in binder_transaction_latency */
+static unsigned int binder_slow_transaction_ms = 100;
+module_param_named(slow_transaction_ms, binder_slow_transaction_ms, uint, S_IWUSR | S_IRUGO);
+
 static DECLARE_WAIT_QUEUE_HEAD(binder_user_error_wait);
 static int binder_stop_on_user_error;
 
@@ -387,6 +396,7 @@ struct binder_node {
 	unsigned has_async_transaction:1;
 	unsigned accept_fds:1;
 	unsigned min_priority:8;
+	unsigned sched_policy:2;
 	struct list_head async_todo;
 #ifdef BINDER_MONITOR
 	char name[MAX_SERVICE_NAME_LEN];
@@ -452,6 +462,8 @@ enum wait_on_reason {
 };
 #endif
 
+#define BINDER_LAT_HASH_BITS	4
+
 struct binder_proc {
 	struct hlist_node proc_node;
 	struct rb_root threads;
@@ -473,7 +485,14 @@ struct binder_proc {
 	struct rb_root allocated_buffers;
 	size_t free_async_space;
 
+	struct hlist_head lat_stats[1 << BINDER_LAT_HASH_BITS];
+	unsigned int nr_lat_stats;
+
 	struct page **pages;
+	struct list_head cached_pages;
+	size_t nr_cached_pages;
+	size_t nr_used_pages;
+	size_t peak_used_pages;
 	size_t buffer_size;
 	uint32_t buffer_free;
 	struct list_head todo;
@@ -521,6 +540,11 @@ struct binder_thread {
 	/* we are also waiting on */
 	wait_queue_head_t wait;
 	struct binder_stats stats;
+#ifdef RT_PRIO_INHERIT
+	/* priority to return to after the next incoming transaction */
+	unsigned long saved_rt_prio:16;
+	unsigned long saved_policy:16;
+#endif
 };
 
 struct binder_transaction {
@@ -540,6 +564,14 @@ struct binder_transaction {
 	long priority;
 	long saved_priority;
 	kuid_t sender_euid;
+	/* local_clock() stamps of the call, carried over to its reply */
+	u64 lat_start;
+	u64 lat_read;
+	u64 lat_reply;
+	u64 lat_queued;
+	u64 lat_copy;	/* ns from BC_TRANSACTION/BC_REPLY until queued */
+	unsigned int lat_code;
+	int lat_pid;
 #ifdef RT_PRIO_INHERIT
 	unsigned long rt_prio:16;
 	unsigned long policy:16;
@@ -1312,19 +1344,170 @@ static long task_close_fd(struct binder_proc *proc, unsigned int fd)
 	return retval;
 }
 
+/*
+ * binder_main_lock contention, shown in the debugfs stats file.  Updated
+ * with the lock held, so it needs no locking of its own.
+ */
+struct binder_lock_stats {
+	u64 acquired;
+	u64 contended;
+	u64 wait_ns;
+	u64 max_wait_ns;
+	const char *max_wait_tag;
+	u64 hold_ns;
+	u64 max_hold_ns;
+	const char *max_hold_tag;
+};
+
+static struct binder_lock_stats binder_lock_stats;
+static u64 binder_lock_time;
+static const char *binder_lock_owner;
+
 static inline void binder_lock(const char *tag)
 {
+	struct binder_lock_stats *st = &binder_lock_stats;
+
 	trace_binder_lock(tag);
-	mutex_lock(&binder_main_lock);
+	if (!mutex_trylock(&binder_main_lock)) {
+		u64 start = local_clock();
+		u64 wait;
+
+		mutex_lock(&binder_main_lock);
+		wait = local_clock() - start;
+		st->contended++;
+		st->wait_ns += wait;
+		if (wait > st->max_wait_ns) {
+			st->max_wait_ns = wait;
+			st->max_wait_tag = tag;
+		}
+	}
+	st->acquired++;
+	binder_lock_owner = tag;
+	binder_lock_time = local_clock();
 	trace_binder_locked(tag);
 }
 
 static inline void binder_unlock(const char *tag)
 {
+	struct binder_lock_stats *st = &binder_lock_stats;
+	u64 hold = local_clock() - binder_lock_time;
+
+	st->hold_ns += hold;
+	if (hold > st->max_hold_ns) {
+		st->max_hold_ns = hold;
+		st->max_hold_tag = binder_lock_owner;
+	}
 	trace_binder_unlock(tag);
 	mutex_unlock(&binder_main_lock);
 }
 
+/*
+ * Per (proc, transaction code) latency histograms, shown in the debugfs
+ * latency file.  The deliver and process stages (and copy and wakeup)
+ * are accounted to the server, the reply stages to the client: replies do
+ * not keep a reference on the thread that sent them.  Like the rest of
+ * binder_proc they are only touched with binder_main_lock held.
+ */
+enum binder_lat_stage {
+	BINDER_LAT_DELIVER,	/* queued until read by the server */
+	BINDER_LAT_PROCESS,	/* read by the server until BC_REPLY */
+	BINDER_LAT_REPLY,	/* BC_REPLY until read by the client */
+	/* parts of the above: */
+	BINDER_LAT_COPY,	/* buffer alloc, copy and objects of the call */
+	BINDER_LAT_WAKEUP,	/* call queued until the server thread runs */
+	BINDER_LAT_REPLY_COPY,
+	BINDER_LAT_REPLY_WAKEUP,
+	BINDER_LAT_NR_STAGES
+};
+
+static const char * const binder_lat_stage_strings[] = {
+	"deliver",
+	"process",
+	"reply",
+	"copy",
+	"wakeup",
+	"reply_copy",
+	"reply_wakeup"
+};
+
+/* Upper bounds of the histogram buckets in us, the last bucket is open */
+static const unsigned int binder_lat_bounds[] = {
+	10, 50, 100, 1000, 4000, 16000, 64000, 256000
+};
+#define BINDER_LAT_BUCKETS	(ARRAY_SIZE(binder_lat_bounds) + 1)
+
+/* Codes tracked per proc, anything beyond is not accounted */
+#define BINDER_LAT_MAX_CODES	64
+
+struct binder_lat_stats {
+	struct hlist_node node;
+	unsigned int code;
+	u64 count[BINDER_LAT_NR_STAGES];
+	u64 total_ns[BINDER_LAT_NR_STAGES];
+	u64 max_ns[BINDER_LAT_NR_STAGES];
+	u32 hist[BINDER_LAT_NR_STAGES][BINDER_LAT_BUCKETS];
+};
+
+static inline u64 binder_lat_delta(u64 from, u64 to)
+{
+	/* local_clock() may go back a little when crossing cpus */
+	return to > from ? to - from : 0;
+}
+
+static struct binder_lat_stats *binder_lat_get(struct binder_proc *proc,
+					       unsigned int code)
+{
+	struct hlist_head *head;
+	struct binder_lat_stats *st;
+
+	head = &proc->lat_stats[hash_32(code, BINDER_LAT_HASH_BITS)];
+	hlist_for_each_entry(st, head, node)
+		if (st->code == code)
+			return st;
+
+	if (proc->nr_lat_stats >= BINDER_LAT_MAX_CODES)
+		return NULL;
+	st = kzalloc(sizeof(*st), GFP_KERNEL);
+	if (!st)
+		return NULL;
+	st->code = code;
+	hlist_add_head(&st->node, head);
+	proc->nr_lat_stats++;
+	return st;
+}
+
+static void binder_lat_add(struct binder_proc *proc, unsigned int code,
+			   enum binder_lat_stage stage, u64 ns)
+{
+	struct binder_lat_stats *st = binder_lat_get(proc, code);
+	u64 us = div_u64(ns, NSEC_PER_USEC);
+	int b;
+
+	if (!st)
+		return;
+
+	for (b = 0; b < ARRAY_SIZE(binder_lat_bounds); b++)
+		if (us < binder_lat_bounds[b])
+			break;
+	st->hist[stage][b]++;
+	st->count[stage]++;
+	st->total_ns[stage] += ns;
+	if (ns > st->max_ns[stage])
+		st->max_ns[stage] = ns;
+}
+
+static void binder_lat_free(struct binder_proc *proc)
+{
+	struct binder_lat_stats *st;
+	struct hlist_node *tmp;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(proc->lat_stats); i++)
+		hlist_for_each_entry_safe(st, tmp, &proc->lat_stats[i], node)
+			kfree(st);
+	proc->nr_lat_stats = 0;
+}
+
 static void binder_set_nice(long nice)
 {
 	long min_nice;
@@ -1432,6 +1615,122 @@ static struct binder_buffer *binder_buffer_lookup(struct binder_proc *proc, uint
 	return NULL;
 }
 
+/*
+ * Page cache of binder buffers
+ *
+ * Pages that no buffer uses any more stay mapped in the kernel and in the
+ * proc's vma, on proc->cached_pages with the most recently released first,
+ * so that the next buffers covering them skip alloc_page(), map_vm_area()
+ * and vm_insert_page().  A proc caches up to the pages it recently needed
+ * at its peak, and never more than binder_cache_max_pages; the peak decays
+ * each time the shrinker runs, which also gives the oldest cached pages
+ * back under memory pressure.  page->lru links a cached page, page->private
+ * holds its index in proc->pages.  All of it is under binder_main_lock.
+ */
+static unsigned long binder_cached_pages;
+
+static bool binder_cache_page(struct binder_proc *proc, struct page *page,
+			      void *page_addr)
+{
+	size_t want = 0;
+
+	if (proc->peak_used_pages > proc->nr_used_pages)
+		want = proc->peak_used_pages - proc->nr_used_pages;
+	want = min_t(size_t, want, binder_cache_max_pages);
+
+	if (!proc->vma || proc->nr_cached_pages >= want)
+		return false;
+
+	set_page_private(page, (page_addr - proc->buffer) / PAGE_SIZE);
+	list_add(&page->lru, &proc->cached_pages);
+	proc->nr_cached_pages++;
+	binder_cached_pages++;
+	return true;
+}
+
+static void binder_uncache_page(struct binder_proc *proc, struct page *page)
+{
+	BUG_ON(list_empty(&page->lru));
+	list_del_init(&page->lru);
+	set_page_private(page, 0);
+	proc->nr_cached_pages--;
+	binder_cached_pages--;
+}
+
+/* Free up to @nr of @proc's cached pages, oldest first */
+static unsigned long binder_shrink_proc(struct binder_proc *proc,
+					unsigned long nr)
+{
+	struct mm_struct *mm = get_task_mm(proc->tsk);
+	unsigned long freed = 0;
+
+	if (mm && (mm != proc->vma_vm_mm || !down_read_trylock(&mm->mmap_sem))) {
+		mmput(mm);
+		return 0;
+	}
+
+	while (freed < nr && !list_empty(&proc->cached_pages)) {
+		struct page *page = list_last_entry(&proc->cached_pages,
+						    struct page, lru);
+		unsigned long index = page_private(page);
+		void *page_addr = proc->buffer + index * PAGE_SIZE;
+
+		binder_uncache_page(proc, page);
+		if (mm && proc->vma)
+			zap_page_range(proc->vma, (uintptr_t)page_addr +
+				       proc->user_buffer_offset, PAGE_SIZE, NULL);
+		unmap_kernel_range((unsigned long)page_addr, PAGE_SIZE);
+		__free_page(page);
+		proc->pages[index] = NULL;
+#ifdef MTK_BINDER_PAGE_USED_RECORD
+		if (binder_page_used > 0)
+			binder_page_used--;
+		if (proc->page_used > 0)
+			proc->page_used--;
+#endif
+		freed++;
+	}
+
+	if (mm) {
+		up_read(&mm->mmap_sem);
+		mmput(mm);
+	}
+	return freed;
+}
+
+static unsigned long binder_shrink_count(struct shrinker *shrink,
+					 struct shrink_control *sc)
+{
+	return ACCESS_ONCE(binder_cached_pages);
+}
+
+static unsigned long binder_shrink_scan(struct shrinker *shrink,
+					struct shrink_control *sc)
+{
+	struct binder_proc *proc;
+	unsigned long freed = 0;
+
+	/* Reclaim from under a binder call, or a busy driver: come back later */
+	if (!mutex_trylock(&binder_main_lock))
+		return SHRINK_STOP;
+
+	hlist_for_each_entry(proc, &binder_procs, proc_node) {
+		proc->peak_used_pages = max(proc->nr_used_pages,
+					    proc->peak_used_pages / 2);
+		if (freed < sc->nr_to_scan && proc->nr_cached_pages)
+			freed += binder_shrink_proc(proc, sc->nr_to_scan - freed);
+	}
+
+	mutex_unlock(&binder_main_lock);
+	return freed;
+}
+
+static struct shrinker binder_shrinker = {
+	.count_objects = binder_shrink_count,
+	.scan_objects = binder_shrink_scan,
+	.seeks = DEFAULT_SEEKS,
+};
+
 static int binder_update_page_range(struct binder_proc *proc, int allocate,
 				    void *start, void *end, struct vm_area_struct *vma)
 {
@@ -1477,13 +1776,20 @@ static int binder_update_page_range(struct binder_proc *proc, int allocate,
 
 		page = &proc->pages[(page_addr - proc->buffer) / PAGE_SIZE];
 
-		BUG_ON(*page);
+		/* Still mapped since an earlier buffer released it */
+		if (*page) {
+			binder_uncache_page(proc, *page);
+			proc->nr_used_pages++;
+			continue;
+		}
+
 		*page = alloc_page(GFP_KERNEL | __GFP_HIGHMEM | __GFP_ZERO);
 		if (*page == NULL) {
 			pr_err("%d: binder_alloc_buf failed for page at %p\n",
 			       proc->pid, page_addr);
 			goto err_alloc_page_failed;
 		}
+		INIT_LIST_HEAD(&(*page)->lru);
 #ifdef MTK_BINDER_PAGE_USED_RECORD
 		binder_page_used++;
 		proc->page_used++;
@@ -1510,7 +1816,10 @@ static int binder_update_page_range(struct binder_proc *proc, int allocate,
 			goto err_vm_insert_page_failed;
 		}
 		/* vm_insert_page does not seem to increment the refcount */
+		proc->nr_used_pages++;
 	}
+	if (proc->nr_used_pages > proc->peak_used_pages)
+		proc->peak_used_pages = proc->nr_used_pages;
 	if (mm) {
 		up_write(&mm->mmap_sem);
 		mmput(mm);
@@ -1520,6 +1829,9 @@ static int binder_update_page_range(struct binder_proc *proc, int allocate,
 free_range:
 	for (page_addr = end - PAGE_SIZE; page_addr >= start; page_addr -= PAGE_SIZE) {
 		page = &proc->pages[(page_addr - proc->buffer) / PAGE_SIZE];
+		proc->nr_used_pages--;
+		if (allocate == 0 && binder_cache_page(proc, *page, page_addr))
+			continue;
 		if (vma)
 			zap_page_range(vma, (uintptr_t) page_addr +
 				       proc->user_buffer_offset, PAGE_SIZE, NULL);
@@ -2229,6 +2541,11 @@ static void binder_transaction_buffer_release(struct binder_proc *proc,
 	}
 }
 
+static inline bool binder_rt_policy(unsigned int policy)
+{
+	return policy == SCHED_FIFO || policy == SCHED_RR;
+}
+
 #ifdef RT_PRIO_INHERIT
 static void mt_sched_setscheduler_nocheck(struct task_struct *p, int policy,
 					  struct sched_param *param)
@@ -2239,6 +2556,33 @@ static void mt_sched_setscheduler_nocheck(struct task_struct *p, int policy,
 	if (ret)
 		pr_err("set scheduler fail, error code: %d\n", ret);
 }
+
+/*
+ * Raise @tsk to the rt priority a synchronous transaction runs at.  The
+ * priority is never lowered here; that is left to the reply, and to the
+ * thread going back into the thread pool.
+ */
+static void binder_rt_boost(struct task_struct *tsk,
+			    struct binder_transaction *t, const char *where)
+{
+	struct sched_param param = {
+		.sched_priority = t->rt_prio,
+	};
+
+	if (!binder_rt_policy(t->policy) || (t->flags & TF_ONE_WAY))
+		return;
+	if (rt_task(tsk) && t->rt_prio <= tsk->rt_priority)
+		return;
+#ifdef BINDER_MONITOR
+	if (log_disable & BINDER_RT_LOG_ENABLE) {
+		pr_debug
+		    ("%s set %d sched_policy from %d to %d rt_prio from %d to %d\n",
+		     where, tsk->pid, tsk->policy, (int)t->policy,
+		     tsk->rt_priority, (int)t->rt_prio);
+	}
+#endif
+	mt_sched_setscheduler_nocheck(tsk, t->policy, &param);
+}
 #endif
 
 #ifdef BINDER_MONITOR
@@ -2339,6 +2683,7 @@ static void binder_transaction(struct binder_proc *proc,
 	struct binder_transaction *in_reply_to = NULL;
 	struct binder_transaction_log_entry *e;
 	uint32_t return_error;
+	u64 lat_begin;
 
 #ifdef BINDER_MONITOR
 	struct binder_transaction_log_entry log_entry;
@@ -2389,10 +2734,13 @@ static void binder_transaction(struct binder_proc *proc,
 #endif
 		binder_set_nice(in_reply_to->saved_priority);
 #ifdef RT_PRIO_INHERIT
-		if (rt_task(current)
-		    && (MAX_RT_PRIO != in_reply_to->saved_rt_prio)
-		    && !(thread->looper & (BINDER_LOOPER_STATE_REGISTERED |
-					   BINDER_LOOPER_STATE_ENTERED))) {
+		/*
+		 * Looper threads are restored too: with nested calls they may
+		 * carry on with more work before getting back to the pool.
+		 */
+		if ((MAX_RT_PRIO != in_reply_to->saved_rt_prio)
+		    && (current->policy != in_reply_to->saved_policy
+			|| current->rt_priority != in_reply_to->saved_rt_prio)) {
 			struct sched_param param = {
 				.sched_priority = in_reply_to->saved_rt_prio,
 			};
@@ -2589,10 +2937,19 @@ static void binder_transaction(struct binder_proc *proc,
 	t->code = tr->code;
 	t->flags = tr->flags;
 	t->priority = task_nice(current);
+	lat_begin = local_clock();
+	if (!reply)
+		t->lat_start = lat_begin;
 #ifdef RT_PRIO_INHERIT
 	t->rt_prio = current->rt_priority;
 	t->policy = current->policy;
 	t->saved_rt_prio = MAX_RT_PRIO;
+	if (!reply && binder_rt_policy(target_node->sched_policy) &&
+	    (!binder_rt_policy(t->policy) ||
+	     t->rt_prio < target_node->min_priority)) {
+		t->policy = target_node->sched_policy;
+		t->rt_prio = target_node->min_priority;
+	}
 #endif
 
 	trace_binder_transaction(reply, t, target_node);
@@ -2678,6 +3035,19 @@ static void binder_transaction(struct binder_proc *proc,
 					    fp->flags & FLAT_BINDER_FLAG_PRIORITY_MASK;
 					node->accept_fds =
 					    !!(fp->flags & FLAT_BINDER_FLAG_ACCEPTS_FDS);
+					node->sched_policy =
+					    (fp->flags & FLAT_BINDER_FLAG_SCHED_POLICY_MASK) >>
+					    FLAT_BINDER_FLAG_SCHED_POLICY_SHIFT;
+					if (binder_rt_policy(node->sched_policy) &&
+					    (node->min_priority < 1 ||
+					     node->min_priority >= MAX_USER_RT_PRIO)) {
+						binder_user_error
+						    ("%d:%d node %d bad rt priority %u\n",
+						     proc->pid, thread->pid,
+						     node->debug_id, node->min_priority);
+						node->sched_policy = SCHED_NORMAL;
+						node->min_priority = 0;
+					}
 #ifdef BINDER_MONITOR
 					parse_service_name(tr, proc, node->name);
 #endif
@@ -2854,6 +3224,13 @@ static void binder_transaction(struct binder_proc *proc,
 #ifdef BINDER_MONITOR
 		binder_update_transaction_time(&binder_transaction_log, in_reply_to, 2);
 #endif
+		t->lat_start = in_reply_to->lat_start;
+		t->lat_read = in_reply_to->lat_read;
+		t->lat_reply = local_clock();
+		t->lat_code = in_reply_to->code;
+		t->lat_pid = proc->pid;
+		binder_lat_add(proc, t->lat_code, BINDER_LAT_PROCESS,
+			       binder_lat_delta(t->lat_read, t->lat_reply));
 		binder_pop_transaction(target_thread, in_reply_to);
 	} else if (!(t->flags & TF_ONE_WAY)) {
 		BUG_ON(t->buffer->async_transaction != 0);
@@ -2869,6 +3246,8 @@ static void binder_transaction(struct binder_proc *proc,
 		} else
 			target_node->has_async_transaction = 1;
 	}
+	t->lat_queued = local_clock();
+	t->lat_copy = binder_lat_delta(lat_begin, t->lat_queued);
 	t->work.type = BINDER_WORK_TRANSACTION;
 	list_add_tail(&t->work.entry, target_list);
 	tcomplete->type = BINDER_WORK_TRANSACTION_COMPLETE;
@@ -2898,24 +3277,13 @@ static void binder_transaction(struct binder_proc *proc,
 				show_stack(tsk, NULL);
 			}
 #endif
-			if (!reply && (t->policy == SCHED_RR || t->policy == SCHED_FIFO)
-			    && t->rt_prio > tsk->rt_priority && !(t->flags & TF_ONE_WAY)) {
-				struct sched_param param = {
-					.sched_priority = t->rt_prio,
-				};
-
-				t->saved_rt_prio = tsk->rt_priority;
-				t->saved_policy = tsk->policy;
-				mt_sched_setscheduler_nocheck(tsk, t->policy, &param);
-#ifdef BINDER_MONITOR
-				if (log_disable & BINDER_RT_LOG_ENABLE) {
-					pr_debug
-					    ("write set %d sched_policy from %d to %d rt_prio from %d to %d\n",
-					     tsk->pid, t->saved_policy,
-					     t->policy, t->saved_rt_prio, t->rt_prio);
-				}
-#endif
-			}
+			/*
+			 * Boost the waiter before it runs.  What it goes back
+			 * to is recorded by the thread that picks up t, which
+			 * need not be this one.
+			 */
+			if (!reply)
+				binder_rt_boost(tsk, t, "write");
 			if (curr->func(curr, TASK_INTERRUPTIBLE, 0, NULL) &&
 			    (flags & WQ_FLAG_EXCLUSIVE))
 				break;
@@ -3403,6 +3771,25 @@ static int binder_has_thread_work(struct binder_thread *thread)
 		(thread->looper & BINDER_LOOPER_STATE_NEED_RETURN);
 }
 
+/* The client got its reply, trace the whole call if it was slow */
+static void binder_lat_replied(struct binder_proc *proc,
+			       struct binder_transaction *t, u64 woken)
+{
+	u64 now = local_clock();
+	u64 total = binder_lat_delta(t->lat_start, now);
+
+	binder_lat_add(proc, t->lat_code, BINDER_LAT_REPLY,
+		       binder_lat_delta(t->lat_reply, now));
+	binder_lat_add(proc, t->lat_code, BINDER_LAT_REPLY_COPY, t->lat_copy);
+	binder_lat_add(proc, t->lat_code, BINDER_LAT_REPLY_WAKEUP,
+		       binder_lat_delta(t->lat_queued, woken));
+	if (total >= (u64)binder_slow_transaction_ms * NSEC_PER_MSEC)
+		trace_binder_transaction_latency(t, t->lat_pid,
+				binder_lat_delta(t->lat_start, t->lat_read),
+				binder_lat_delta(t->lat_read, t->lat_reply),
+				binder_lat_delta(t->lat_reply, now));
+}
+
 static int binder_thread_read(struct binder_proc *proc,
 			      struct binder_thread *thread,
 			      binder_uintptr_t binder_buffer, size_t size,
@@ -3414,6 +3801,7 @@ static int binder_thread_read(struct binder_proc *proc,
 
 	int ret = 0;
 	int wait_for_proc_work;
+	u64 woken;
 
 	if (*consumed == 0) {
 		if (put_user(BR_NOOP, (uint32_t __user *)ptr))
@@ -3450,6 +3838,20 @@ retry:
 	}
 
 
+#ifdef RT_PRIO_INHERIT
+	/*
+	 * Record the priority the next transaction has to restore before
+	 * anyone can boost us: threads waiting for process work are put
+	 * back to the defaults below, other threads keep their own.
+	 */
+	if (wait_for_proc_work) {
+		thread->saved_rt_prio = proc->default_rt_prio;
+		thread->saved_policy = proc->default_policy;
+	} else {
+		thread->saved_rt_prio = current->rt_priority;
+		thread->saved_policy = current->policy;
+	}
+#endif
 	thread->looper |= BINDER_LOOPER_STATE_WAITING;
 	if (wait_for_proc_work)
 		proc->ready_threads++;
@@ -3502,6 +3904,8 @@ retry:
 		} else
 			ret = wait_event_freezable(thread->wait, binder_has_thread_work(thread));
 	}
+	/* the wakeup stages end here, binder_main_lock is part of deliver */
+	woken = local_clock();
 
 	binder_lock(__func__);
 
@@ -3710,37 +4114,37 @@ retry:
 			tr.cookie = target_node->cookie;
 			t->saved_priority = task_nice(current);
 #ifdef RT_PRIO_INHERIT
-			/* since we may fail the rt inherit due to target
-			 * wait queue task_list is empty, check again here.
+			/*
+			 * We may already have been boosted while waiting, so
+			 * restore to what we had before, not what we have now.
+			 * Since we may fail the rt inherit due to target
+			 * wait queue task_list is empty, boost again here.
 			 */
-			if ((SCHED_RR == t->policy || SCHED_FIFO == t->policy)
-			    && t->rt_prio > current->rt_priority && !(t->flags & TF_ONE_WAY)) {
-				struct sched_param param = {
-					.sched_priority = t->rt_prio,
-				};
-
-				t->saved_rt_prio = current->rt_priority;
-				t->saved_policy = current->policy;
-				mt_sched_setscheduler_nocheck(current, t->policy, &param);
-#ifdef BINDER_MONITOR
-				if (log_disable & BINDER_RT_LOG_ENABLE) {
-					pr_debug
-					    ("read set %d sched_policy from %d to %d rt_prio from %d to %d\n",
-					     proc->pid, t->saved_policy,
-					     t->policy, t->saved_rt_prio, t->rt_prio);
-				}
+			t->saved_rt_prio = thread->saved_rt_prio;
+			t->saved_policy = thread->saved_policy;
+			binder_rt_boost(current, t, "read");
 #endif
-			}
-#endif
-			if (t->priority < target_node->min_priority && !(t->flags & TF_ONE_WAY))
+			if (binder_rt_policy(target_node->sched_policy)) {
+				/* min_priority is an rt priority, no nice floor */
+				if (!(t->flags & TF_ONE_WAY))
+					binder_set_nice(t->priority);
+			} else if (t->priority < target_node->min_priority &&
+				   !(t->flags & TF_ONE_WAY))
 				binder_set_nice(t->priority);
 			else if (!(t->flags & TF_ONE_WAY) ||
 				 t->saved_priority > target_node->min_priority)
 				binder_set_nice(target_node->min_priority);
+			t->lat_read = local_clock();
+			binder_lat_add(proc, t->code, BINDER_LAT_DELIVER,
+				       binder_lat_delta(t->lat_start, t->lat_read));
+			binder_lat_add(proc, t->code, BINDER_LAT_COPY, t->lat_copy);
+			binder_lat_add(proc, t->code, BINDER_LAT_WAKEUP,
+				       binder_lat_delta(t->lat_queued, woken));
 			cmd = BR_TRANSACTION;
 		} else {
 			tr.target.ptr = 0;
 			tr.cookie = 0;
+			binder_lat_replied(proc, t, woken);
 			cmd = BR_REPLY;
 		}
 		tr.code = t->code;
@@ -4370,6 +4774,7 @@ static int binder_open(struct inode *nodp, struct file *filp)
 	get_task_struct(current);
 	proc->tsk = current;
 	INIT_LIST_HEAD(&proc->todo);
+	INIT_LIST_HEAD(&proc->cached_pages);
 	init_waitqueue_head(&proc->wait);
 	proc->default_priority = task_nice(current);
 #ifdef RT_PRIO_INHERIT
@@ -4606,6 +5011,7 @@ static void binder_deferred_release(struct binder_proc *proc)
 	binder_stats_deleted(BINDER_STAT_PROC);
 
 	page_count = 0;
+	binder_cached_pages -= proc->nr_cached_pages;
 	if (proc->pages) {
 		int i;
 
@@ -4634,6 +5040,7 @@ static void binder_deferred_release(struct binder_proc *proc)
 	}
 
 	put_task_struct(proc->tsk);
+	binder_lat_free(proc);
 
 	binder_debug(BINDER_DEBUG_OPEN_CLOSE,
 		     "%s: %d threads %d, nodes %d (ref %d), refs %d, active transactions %d, buffers %d, pages %d\n",
@@ -4947,6 +5354,22 @@ static const char *const binder_objstat_strings[] = {
 	"transaction_complete"
 };
 
+static void print_binder_lock_stats(struct seq_file *m)
+{
+	struct binder_lock_stats *st = &binder_lock_stats;
+
+	seq_printf(m, "lock: acquired %llu contended %llu\n",
+		   st->acquired, st->contended);
+	seq_printf(m, "lock: wait %llu us max %llu us (%s)\n",
+		   div_u64(st->wait_ns, NSEC_PER_USEC),
+		   div_u64(st->max_wait_ns, NSEC_PER_USEC),
+		   st->max_wait_tag ? st->max_wait_tag : "-");
+	seq_printf(m, "lock: hold %llu us max %llu us (%s)\n",
+		   div_u64(st->hold_ns, NSEC_PER_USEC),
+		   div_u64(st->max_hold_ns, NSEC_PER_USEC),
+		   st->max_hold_tag ? st->max_hold_tag : "-");
+}
+
 static void print_binder_stats(struct seq_file *m, const char *prefix, struct binder_stats *stats)
 {
 	int i;
@@ -5011,6 +5434,9 @@ static void print_binder_proc_stats(struct seq_file *m, struct binder_proc *proc
 	for (n = rb_first(&proc->allocated_buffers); n != NULL; n = rb_next(n))
 		count++;
 	seq_printf(m, "  buffers: %d\n", count);
+	seq_printf(m, "  pages: %zd used %zd peak %zd cached\n",
+		   proc->nr_used_pages, proc->peak_used_pages,
+		   proc->nr_cached_pages);
 
 	count = 0;
 	list_for_each_entry(w, &proc->todo, entry) {
@@ -5060,6 +5486,7 @@ static int binder_stats_show(struct seq_file *m, void *unused)
 
 	seq_puts(m, "binder stats:\n");
 
+	print_binder_lock_stats(m);
 	print_binder_stats(m, "", &binder_stats);
 
 	hlist_for_each_entry(proc, &binder_procs, proc_node)
@@ -5501,6 +5928,52 @@ static int binder_page_used_show(struct seq_file *s, void *p)
 BINDER_DEBUG_ENTRY(page_used);
 #endif
 
+static void print_binder_lat_stats(struct seq_file *m, struct binder_lat_stats *st)
+{
+	int i, b;
+
+	for (i = 0; i < BINDER_LAT_NR_STAGES; i++) {
+		if (!st->count[i])
+			continue;
+		seq_printf(m, "  code %u %s: count %llu avg %llu us max %llu us:",
+			   st->code, binder_lat_stage_strings[i], st->count[i],
+			   div64_u64(st->total_ns[i], st->count[i] * NSEC_PER_USEC),
+			   div_u64(st->max_ns[i], NSEC_PER_USEC));
+		for (b = 0; b < BINDER_LAT_BUCKETS; b++)
+			seq_printf(m, " %u", st->hist[i][b]);
+		seq_puts(m, "\n");
+	}
+}
+
+static int binder_latency_show(struct seq_file *m, void *unused)
+{
+	struct binder_proc *proc;
+	struct binder_lat_stats *st;
+	int do_lock = !binder_debug_no_lock;
+	int i;
+
+	seq_puts(m, "binder latency, buckets (us):");
+	for (i = 0; i < ARRAY_SIZE(binder_lat_bounds); i++)
+		seq_printf(m, " <%u", binder_lat_bounds[i]);
+	seq_printf(m, " >=%u\n", binder_lat_bounds[i - 1]);
+
+	if (do_lock)
+		binder_lock(__func__);
+	hlist_for_each_entry(proc, &binder_procs, proc_node) {
+		if (!proc->nr_lat_stats)
+			continue;
+		seq_printf(m, "proc %d (%s)\n", proc->pid,
+			   proc->tsk ? proc->tsk->comm : "");
+		for (i = 0; i < ARRAY_SIZE(proc->lat_stats); i++)
+			hlist_for_each_entry(st, &proc->lat_stats[i], node)
+				print_binder_lat_stats(m, st);
+	}
+	if (do_lock)
+		binder_unlock(__func__);
+	return 0;
+}
+
+BINDER_DEBUG_ENTRY(latency);
 BINDER_DEBUG_ENTRY(state);
 BINDER_DEBUG_ENTRY(stats);
 BINDER_DEBUG_ENTRY(transactions);
@@ -5543,6 +6016,8 @@ static int __init binder_init(void)
 	if (!binder_deferred_workqueue)
 		return -ENOMEM;
 
+	register_shrinker(&binder_shrinker);
+
 	binder_debugfs_dir_entry_root = debugfs_create_dir("binder", NULL);
 	if (binder_debugfs_dir_entry_root)
 		binder_debugfs_dir_entry_proc = debugfs_create_dir("proc",
@@ -5558,6 +6033,9 @@ static int __init binder_init(void)
 		debugfs_create_file("transactions",
 				    S_IRUGO,
 				    binder_debugfs_dir_entry_root, NULL, &binder_transactions_fops);
+		debugfs_create_file("latency",
+				    S_IRUGO,
+				    binder_debugfs_dir_entry_root, NULL, &binder_latency_fops);
 		debugfs_create_file("transaction_log",
 				    S_IRUGO,
 				    binder_debugfs_dir_entry_root,
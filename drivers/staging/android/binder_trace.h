@@ -144,6 +144,32 @@ TRACE_EVENT(binder_transaction_received,
 	TP_printk("transaction=%d", __entry->debug_id)
 );
 
+TRACE_EVENT(binder_transaction_latency,
+	TP_PROTO(struct binder_transaction *t, int server_pid,
+		 u64 deliver_ns, u64 process_ns, u64 reply_ns),
+	TP_ARGS(t, server_pid, deliver_ns, process_ns, reply_ns),
+
+	TP_STRUCT__entry(
+		__field(int, debug_id)
+		__field(int, server_pid)
+		__field(unsigned int, code)
+		__field(u64, deliver_ns)
+		__field(u64, process_ns)
+		__field(u64, reply_ns)
+	),
+	TP_fast_assign(
+		__entry->debug_id = t->debug_id;
+		__entry->server_pid = server_pid;
+		__entry->code = t->lat_code;
+		__entry->deliver_ns = deliver_ns;
+		__entry->process_ns = process_ns;
+		__entry->reply_ns = reply_ns;
+	),
+	TP_printk("transaction=%d server=%d code=0x%x deliver=%llu process=%llu reply=%llu ns",
+		  __entry->debug_id, __entry->server_pid, __entry->code,
+		  __entry->deliver_ns, __entry->process_ns, __entry->reply_ns)
+);
+
 TRACE_EVENT(binder_transaction_node_to_ref,
 	TP_PROTO(struct binder_transaction *t, struct binder_node *node,
 		 struct binder_ref *ref),
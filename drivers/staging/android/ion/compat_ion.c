@@ -79,6 +79,11 @@ struct compat_ion_sys_get_client_param {
 	compat_uint_t client;
 };
 
+struct compat_ion_sys_cma_prepare_param {
+	compat_uint_t heap_id;
+	compat_ulong_t len;
+};
+
 struct compat_ion_sys_data {
 	compat_uint_t sys_cmd;
 	union {
@@ -87,6 +92,7 @@ struct compat_ion_sys_data {
 		struct compat_ion_sys_get_client_param get_client_param;
 		struct compat_ion_sys_client_name client_name_param;
 		struct compat_ion_dma_param dma_param;
+		struct compat_ion_sys_cma_prepare_param cma_prepare_param;
 	};
 };
 
@@ -547,6 +553,23 @@ static int compat_put_ion_sys_get_client_param(
 	return err;
 }
 
+static int compat_get_ion_sys_cma_prepare_param(
+			struct compat_ion_sys_cma_prepare_param __user *data32,
+			struct ion_sys_cma_prepare_param __user *data)
+{
+	compat_uint_t heap_id;
+	compat_ulong_t len;
+
+	int err;
+
+	err = get_user(heap_id, &data32->heap_id);
+	err |= put_user(heap_id, &data->heap_id);
+	err |= get_user(len, &data32->len);
+	err |= put_user(len, &data->len);
+
+	return err;
+}
+
 static int compat_get_ion_sys_data(
 			struct compat_ion_sys_data __user *data32,
 			struct ion_sys_data __user *data)
@@ -584,6 +607,12 @@ static int compat_get_ion_sys_data(
 		err |= compat_get_ion_sys_dma_op_param(&data32->dma_param, &data->dma_param);
 		break;
 	}
+	case ION_SYS_CMA_PREPARE:
+	{
+		err |= compat_get_ion_sys_cma_prepare_param(&data32->cma_prepare_param,
+				&data->cma_prepare_param);
+		break;
+	}
 	}
 
 	return err;
@@ -36,6 +36,7 @@
 #include <linux/debugfs.h>
 #include <linux/dma-buf.h>
 #include <linux/idr.h>
+#include <mt-plat/mt_cache_sync.h>
 
 #include "ion.h"
 #include "ion_priv.h"
@@ -1219,7 +1220,14 @@ static int ion_dma_buf_begin_cpu_access(struct dma_buf *dmabuf, size_t start,
 	mutex_lock(&buffer->lock);
 	vaddr = ion_buffer_kmap_get(buffer);
 	mutex_unlock(&buffer->lock);
-	return PTR_ERR_OR_ZERO(vaddr);
+	if (IS_ERR(vaddr))
+		return PTR_ERR(vaddr);
+
+	/* only the range the CPU is about to read */
+	if (ion_buffer_cached(buffer) && direction != DMA_TO_DEVICE)
+		mt_cache_sync_sg(buffer->sg_table->sgl, buffer->sg_table->nents,
+				 start, len, MT_CACHE_INVALIDATE);
+	return 0;
 }
 
 static void ion_dma_buf_end_cpu_access(struct dma_buf *dmabuf, size_t start,
@@ -1228,6 +1236,10 @@ static void ion_dma_buf_end_cpu_access(struct dma_buf *dmabuf, size_t start,
 {
 	struct ion_buffer *buffer = dmabuf->priv;
 
+	if (ion_buffer_cached(buffer) && direction != DMA_FROM_DEVICE)
+		mt_cache_sync_sg(buffer->sg_table->sgl, buffer->sg_table->nents,
+				 start, len, MT_CACHE_CLEAN);
+
 	mutex_lock(&buffer->lock);
 	ion_buffer_kmap_put(buffer);
 	mutex_unlock(&buffer->lock);
@@ -1634,6 +1646,9 @@ static int ion_debug_heap_show(struct seq_file *s, void *unused)
 	if (heap->flags & ION_HEAP_FLAG_DEFER_FREE)
 		seq_printf(s, "%16.s %16zu\n", "deferred free",
 				heap->free_list_size);
+	if (heap->flags & ION_HEAP_FLAG_DEFER_FREE_BATCH)
+		seq_printf(s, "%16.s %16lu %16lu\n", "batches/overflow",
+				heap->free_batches, heap->free_overflows);
 	seq_puts(s, "----------------------------------------------------\n");
 
 	if (heap->debug_show)
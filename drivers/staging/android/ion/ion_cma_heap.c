@@ -20,15 +20,40 @@
 #include <linux/errno.h>
 #include <linux/err.h>
 #include <linux/dma-mapping.h>
+#include <linux/dma-contiguous.h>
+#include <linux/cma.h>
+#include <linux/seq_file.h>
+#include <linux/workqueue.h>
 
 #include "ion.h"
 #include "ion_priv.h"
 
 #define ION_CMA_ALLOCATE_FAILED -1
 
+/* How long a warmed range is held for the allocation it was prepared for */
+#define ION_CMA_WARM_TIMEOUT	(2 * HZ)
+
+/*
+ * Warm CMA: a client that knows it is about to allocate a large buffer
+ * (camera open, secure video start) calls ion_cma_heap_prepare() first.
+ * That migrates movable pages out of the CMA area in the background by
+ * taking the range with cma_alloc(), and holds it until the allocation
+ * arrives or ION_CMA_WARM_TIMEOUT expires.  The range is released right
+ * before dma_alloc_coherent(), which then finds it free and does not have
+ * to wait for migration.
+ */
 struct ion_cma_heap {
 	struct ion_heap heap;
 	struct device *dev;
+	struct cma *cma;
+	struct mutex warm_lock;
+	struct page *warm_pages;
+	int warm_count;
+	int warm_request;
+	struct work_struct warm_work;
+	struct delayed_work warm_expire;
+	unsigned long warm_hits;
+	unsigned long warm_misses;
 };
 
 #define to_cma_heap(x) container_of(x, struct ion_cma_heap, heap)
@@ -58,6 +83,74 @@ static int ion_cma_get_sgtable(struct device *dev, struct sg_table *sgt,
 	return 0;
 }
 
+static void ion_cma_warm_drop(struct ion_cma_heap *cma_heap)
+{
+	if (!cma_heap->warm_pages)
+		return;
+
+	cma_release(cma_heap->cma, cma_heap->warm_pages, cma_heap->warm_count);
+	cma_heap->warm_pages = NULL;
+	cma_heap->warm_count = 0;
+}
+
+static void ion_cma_warm_work(struct work_struct *work)
+{
+	struct ion_cma_heap *cma_heap = container_of(work, struct ion_cma_heap,
+						     warm_work);
+	int count;
+
+	mutex_lock(&cma_heap->warm_lock);
+	count = cma_heap->warm_request;
+	if (count > cma_heap->warm_count) {
+		ion_cma_warm_drop(cma_heap);
+		cma_heap->warm_pages = cma_alloc(cma_heap->cma, count, 0);
+		if (cma_heap->warm_pages)
+			cma_heap->warm_count = count;
+	}
+	if (cma_heap->warm_pages)
+		mod_delayed_work(system_wq, &cma_heap->warm_expire,
+				 ION_CMA_WARM_TIMEOUT);
+	mutex_unlock(&cma_heap->warm_lock);
+}
+
+static void ion_cma_warm_expire(struct work_struct *work)
+{
+	struct ion_cma_heap *cma_heap = container_of(to_delayed_work(work),
+						     struct ion_cma_heap,
+						     warm_expire);
+
+	mutex_lock(&cma_heap->warm_lock);
+	if (cma_heap->warm_pages)
+		cma_heap->warm_misses++;
+	ion_cma_warm_drop(cma_heap);
+	mutex_unlock(&cma_heap->warm_lock);
+}
+
+/**
+ * ion_cma_heap_prepare - get ready for a large allocation from this heap
+ * @heap:	an ION_HEAP_TYPE_DMA heap
+ * @len:	size of the allocation that is expected to follow
+ *
+ * Starts clearing @len bytes of the heap's CMA area and returns right
+ * away.  Returns -EINVAL if @heap is not a CMA heap or has no CMA area.
+ */
+int ion_cma_heap_prepare(struct ion_heap *heap, size_t len)
+{
+	struct ion_cma_heap *cma_heap;
+
+	if (heap->type != ION_HEAP_TYPE_DMA)
+		return -EINVAL;
+
+	cma_heap = to_cma_heap(heap);
+	if (!cma_heap->cma || !len ||
+	    PAGE_ALIGN(len) > cma_get_size(cma_heap->cma))
+		return -EINVAL;
+
+	cma_heap->warm_request = PAGE_ALIGN(len) >> PAGE_SHIFT;
+	queue_work(system_unbound_wq, &cma_heap->warm_work);
+	return 0;
+}
+
 /* ION CMA heap operations functions */
 static int ion_cma_allocate(struct ion_heap *heap, struct ion_buffer *buffer,
 			    unsigned long len, unsigned long align,
@@ -81,8 +174,16 @@ static int ion_cma_allocate(struct ion_heap *heap, struct ion_buffer *buffer,
 		return ION_CMA_ALLOCATE_FAILED;
 	}
 
+	/* Hand a warmed range over, it is still free when we take it */
+	mutex_lock(&cma_heap->warm_lock);
+	if (cma_heap->warm_pages) {
+		cancel_delayed_work(&cma_heap->warm_expire);
+		cma_heap->warm_hits++;
+		ion_cma_warm_drop(cma_heap);
+	}
 	info->cpu_addr = dma_alloc_coherent(dev, len, &(info->handle),
 						GFP_HIGHUSER | __GFP_ZERO);
+	mutex_unlock(&cma_heap->warm_lock);
 
 	if (!info->cpu_addr) {
 		dev_err(dev, "Fail to allocate buffer\n");
@@ -181,6 +282,30 @@ static void ion_cma_unmap_kernel(struct ion_heap *heap,
 {
 }
 
+static int ion_cma_heap_debug_show(struct ion_heap *heap, struct seq_file *s,
+				   void *unused)
+{
+	struct ion_cma_heap *cma_heap = to_cma_heap(heap);
+	unsigned long allocated, movable;
+
+	if (!cma_heap->cma)
+		return 0;
+
+	cma_get_occupancy(cma_heap->cma, &allocated, &movable);
+	seq_printf(s, "%16s %16lu\n", "cma total", cma_get_size(cma_heap->cma));
+	seq_printf(s, "%16s %16lu\n", "cma allocated", allocated << PAGE_SHIFT);
+	seq_printf(s, "%16s %16lu\n", "cma movable", movable << PAGE_SHIFT);
+
+	mutex_lock(&cma_heap->warm_lock);
+	seq_printf(s, "%16s %16lu\n", "cma warm",
+		   (unsigned long)cma_heap->warm_count << PAGE_SHIFT);
+	mutex_unlock(&cma_heap->warm_lock);
+	seq_printf(s, "%16s %16lu\n", "warm hits", cma_heap->warm_hits);
+	seq_printf(s, "%16s %16lu\n", "warm misses", cma_heap->warm_misses);
+
+	return 0;
+}
+
 static struct ion_heap_ops ion_cma_ops = {
 	.allocate = ion_cma_allocate,
 	.free = ion_cma_free,
@@ -205,7 +330,12 @@ struct ion_heap *ion_cma_heap_create(struct ion_platform_heap *data)
 	/* get device from private heaps data, later it will be
 	 * used to make the link with reserved CMA memory */
 	cma_heap->dev = data->priv;
+	cma_heap->cma = dev_get_cma_area(cma_heap->dev);
+	mutex_init(&cma_heap->warm_lock);
+	INIT_WORK(&cma_heap->warm_work, ion_cma_warm_work);
+	INIT_DELAYED_WORK(&cma_heap->warm_expire, ion_cma_warm_expire);
 	cma_heap->heap.type = ION_HEAP_TYPE_DMA;
+	cma_heap->heap.debug_show = ion_cma_heap_debug_show;
 	return &cma_heap->heap;
 }
 
@@ -213,5 +343,8 @@ void ion_cma_heap_destroy(struct ion_heap *heap)
 {
 	struct ion_cma_heap *cma_heap = to_cma_heap(heap);
 
+	cancel_work_sync(&cma_heap->warm_work);
+	cancel_delayed_work_sync(&cma_heap->warm_expire);
+	ion_cma_warm_drop(cma_heap);
 	kfree(cma_heap);
 }
@@ -18,6 +18,7 @@
 #include <linux/freezer.h>
 #include <linux/kthread.h>
 #include <linux/mm.h>
+#include <linux/moduleparam.h>
 #include <linux/rtmutex.h>
 #include <linux/sched.h>
 #include <linux/scatterlist.h>
@@ -172,11 +173,32 @@ int ion_heap_pages_zero(struct page *page, size_t size, pgprot_t pgprot)
 	return ion_heap_sglist_zero(&sg, 1, pgprot);
 }
 
+/* batched deferred free: list bound in bytes and buffers per batch */
+static unsigned long ion_heap_freelist_max = 128 * 1024 * 1024;
+module_param_named(freelist_max, ion_heap_freelist_max, ulong, S_IRUGO | S_IWUSR);
+
+#define ION_HEAP_FREE_BATCH	16
+/* buffers skip the page pools for this long after a shrinker scan */
+#define ION_HEAP_SHRINK_HOLDOFF	HZ
+
 void ion_heap_freelist_add(struct ion_heap *heap, struct ion_buffer *buffer)
 {
 	/* add by k, for mm heap to free mva */
 	if (heap->ops->add_freelist)
 		heap->ops->add_freelist(buffer);
+
+	/*
+	 * Bounded queue: rather than letting an idle-starved free thread
+	 * pile up hundreds of MB, make the releasing task pay for it.
+	 */
+	if ((heap->flags & ION_HEAP_FLAG_DEFER_FREE_BATCH) &&
+	    ion_heap_freelist_size(heap) + buffer->size > ion_heap_freelist_max) {
+		heap->free_overflows++;
+		wake_up(&heap->waitqueue);
+		ion_buffer_destroy(buffer);
+		return;
+	}
+
 	spin_lock(&heap->free_lock);
 	list_add(&buffer->list, &heap->free_list);
 	heap->free_list_size += buffer->size;
@@ -267,22 +289,78 @@ static int ion_heap_deferred_free(void *data)
 	return 0;
 }
 
+static bool ion_heap_shrinking(struct ion_heap *heap)
+{
+	return heap->last_shrink &&
+		time_before(jiffies, heap->last_shrink + ION_HEAP_SHRINK_HOLDOFF);
+}
+
+static int ion_heap_deferred_free_batch(void *data)
+{
+	struct ion_heap *heap = data;
+	struct ion_buffer *buffer, *tmp;
+	LIST_HEAD(batch);
+	bool skip_pools;
+	int nr;
+
+	set_user_nice(current, 10);
+
+	while (true) {
+		wait_event_freezable(heap->waitqueue,
+				     ion_heap_freelist_size(heap) > 0);
+
+		/*
+		 * Pages taken off the free list while the shrinker is trying
+		 * to empty the pools go straight back to the buddy allocator.
+		 */
+		skip_pools = ion_heap_shrinking(heap);
+
+		spin_lock(&heap->free_lock);
+		for (nr = 0; nr < ION_HEAP_FREE_BATCH &&
+			     !list_empty(&heap->free_list); nr++) {
+			buffer = list_first_entry(&heap->free_list,
+						  struct ion_buffer, list);
+			list_move_tail(&buffer->list, &batch);
+			heap->free_list_size -= buffer->size;
+		}
+		spin_unlock(&heap->free_lock);
+
+		if (!nr)
+			continue;
+
+		list_for_each_entry_safe(buffer, tmp, &batch, list) {
+			list_del(&buffer->list);
+			if (skip_pools)
+				buffer->private_flags |=
+					ION_PRIV_FLAG_SHRINKER_FREE;
+			ion_buffer_destroy(buffer);
+		}
+		heap->free_batches++;
+		cond_resched();
+	}
+
+	return 0;
+}
+
 int ion_heap_init_deferred_free(struct ion_heap *heap)
 {
 	struct sched_param param = { .sched_priority = 0 };
+	bool batch = heap->flags & ION_HEAP_FLAG_DEFER_FREE_BATCH;
 
 	INIT_LIST_HEAD(&heap->free_list);
 	heap->free_list_size = 0;
 	spin_lock_init(&heap->free_lock);
 	init_waitqueue_head(&heap->waitqueue);
-	heap->task = kthread_run(ion_heap_deferred_free, heap,
+	heap->task = kthread_run(batch ? ion_heap_deferred_free_batch :
+				 ion_heap_deferred_free, heap,
 				 "%s", heap->name);
 	if (IS_ERR(heap->task)) {
 		pr_err("%s: creating thread for deferred free failed\n",
 		       __func__);
 		return PTR_ERR_OR_ZERO(heap->task);
 	}
-	sched_setscheduler(heap->task, SCHED_IDLE, &param);
+	if (!batch)
+		sched_setscheduler(heap->task, SCHED_IDLE, &param);
 	return 0;
 }
 
@@ -310,6 +388,8 @@ static unsigned long ion_heap_shrink_scan(struct shrinker *shrinker,
 	if (to_scan == 0)
 		return 0;
 
+	heap->last_shrink = jiffies;
+
 	/*
 	 * shrink the free list first, no point in zeroing the memory if we're
 	 * just going to reclaim it. Also, skip any possible page pooling.
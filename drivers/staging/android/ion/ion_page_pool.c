@@ -20,6 +20,8 @@
 #include <linux/fs.h>
 #include <linux/list.h>
 #include <linux/module.h>
+#include <linux/percpu.h>
+#include <linux/sizes.h>
 #include <linux/slab.h>
 #include <linux/swap.h>
 #include "ion_priv.h"
@@ -35,15 +37,8 @@ static void *ion_page_pool_alloc_pages(struct ion_page_pool *pool)
 	return page;
 }
 
-static void ion_page_pool_free_pages(struct ion_page_pool *pool,
-				     struct page *page)
+static void __ion_page_pool_add(struct ion_page_pool *pool, struct page *page)
 {
-	__free_pages(page, pool->order);
-}
-
-static int ion_page_pool_add(struct ion_page_pool *pool, struct page *page)
-{
-	mutex_lock(&pool->mutex);
 	if (PageHighMem(page)) {
 		list_add_tail(&page->lru, &pool->high_items);
 		pool->high_count++;
@@ -51,10 +46,30 @@ static int ion_page_pool_add(struct ion_page_pool *pool, struct page *page)
 		list_add_tail(&page->lru, &pool->low_items);
 		pool->low_count++;
 	}
+}
+
+static int ion_page_pool_add(struct ion_page_pool *pool, struct page *page)
+{
+	mutex_lock(&pool->mutex);
+	__ion_page_pool_add(pool, page);
 	mutex_unlock(&pool->mutex);
 	return 0;
 }
 
+static void ion_page_pool_add_batch(struct ion_page_pool *pool,
+				    struct page **pages, int nr)
+{
+	int i;
+
+	if (!nr)
+		return;
+
+	mutex_lock(&pool->mutex);
+	for (i = 0; i < nr; i++)
+		__ion_page_pool_add(pool, pages[i]);
+	mutex_unlock(&pool->mutex);
+}
+
 static struct page *ion_page_pool_remove(struct ion_page_pool *pool, bool high)
 {
 	struct page *page;
@@ -73,19 +88,75 @@ static struct page *ion_page_pool_remove(struct ion_page_pool *pool, bool high)
 	return page;
 }
 
+/*
+ * Per-cpu magazines: the common alloc/free path only touches the local
+ * cpu's magazine, whose lock is uncontended except while the shrinker
+ * drains it. The pool mutex is taken once per mag_batch pages when a
+ * magazine runs empty or overflows.
+ */
+static struct page *ion_page_pool_mag_alloc(struct ion_page_pool *pool)
+{
+	struct ion_page_pool_magazine *mag;
+	struct page *page = NULL;
+
+	mag = get_cpu_ptr(pool->mags);
+	spin_lock(&mag->lock);
+	if (mag->count) {
+		page = mag->pages[--mag->count];
+		mag->alloc_hits++;
+	} else {
+		mag->alloc_misses++;
+	}
+	spin_unlock(&mag->lock);
+	put_cpu_ptr(pool->mags);
+
+	return page;
+}
+
+/* Stash refilled pages in the local magazine, returns how many fit */
+static int ion_page_pool_mag_fill(struct ion_page_pool *pool,
+				  struct page **pages, int nr)
+{
+	struct ion_page_pool_magazine *mag;
+	int i;
+
+	mag = get_cpu_ptr(pool->mags);
+	spin_lock(&mag->lock);
+	for (i = 0; i < nr && mag->count < pool->mag_size; i++)
+		mag->pages[mag->count++] = pages[i];
+	spin_unlock(&mag->lock);
+	put_cpu_ptr(pool->mags);
+
+	return i;
+}
+
 struct page *ion_page_pool_alloc(struct ion_page_pool *pool)
 {
+	struct page *batch[ION_PAGE_POOL_MAG_SIZE];
 	struct page *page = NULL;
+	int nr = 0;
+	int used;
 
 	BUG_ON(!pool);
 
+	page = ion_page_pool_mag_alloc(pool);
+	if (page)
+		return page;
+
 	mutex_lock(&pool->mutex);
 	if (pool->high_count)
 		page = ion_page_pool_remove(pool, true);
 	else if (pool->low_count)
 		page = ion_page_pool_remove(pool, false);
+	/* refill the magazine so that the next allocations stay local */
+	while (page && nr < pool->mag_batch - 1 &&
+	       (pool->high_count || pool->low_count))
+		batch[nr++] = ion_page_pool_remove(pool, !!pool->high_count);
 	mutex_unlock(&pool->mutex);
 
+	used = ion_page_pool_mag_fill(pool, batch, nr);
+	ion_page_pool_add_batch(pool, batch + used, nr - used);
+
 	if (!page)
 		page = ion_page_pool_alloc_pages(pool);
 
@@ -94,13 +165,78 @@ struct page *ion_page_pool_alloc(struct ion_page_pool *pool)
 
 void ion_page_pool_free(struct ion_page_pool *pool, struct page *page)
 {
-	int ret;
+	struct ion_page_pool_magazine *mag;
+	struct page *batch[ION_PAGE_POOL_MAG_SIZE];
+	int nr = 0;
 
 	BUG_ON(pool->order != compound_order(page));
 
-	ret = ion_page_pool_add(pool, page);
-	if (ret)
-		ion_page_pool_free_pages(pool, page);
+	mag = get_cpu_ptr(pool->mags);
+	spin_lock(&mag->lock);
+	if (mag->count < pool->mag_size) {
+		mag->free_hits++;
+	} else {
+		/* spill the oldest batch to the pool and keep the hot pages */
+		mag->free_misses++;
+		nr = pool->mag_batch;
+		memcpy(batch, mag->pages, nr * sizeof(batch[0]));
+		memmove(mag->pages, mag->pages + nr,
+			(mag->count - nr) * sizeof(mag->pages[0]));
+		mag->count -= nr;
+	}
+	mag->pages[mag->count++] = page;
+	spin_unlock(&mag->lock);
+	put_cpu_ptr(pool->mags);
+
+	ion_page_pool_add_batch(pool, batch, nr);
+}
+
+/* Move every magazine's pages back to the pool lists */
+static void ion_page_pool_drain_mags(struct ion_page_pool *pool)
+{
+	struct ion_page_pool_magazine *mag;
+	struct page *batch[ION_PAGE_POOL_MAG_SIZE];
+	int cpu, nr;
+
+	for_each_possible_cpu(cpu) {
+		mag = per_cpu_ptr(pool->mags, cpu);
+		spin_lock(&mag->lock);
+		nr = mag->count;
+		memcpy(batch, mag->pages, nr * sizeof(batch[0]));
+		mag->count = 0;
+		spin_unlock(&mag->lock);
+
+		ion_page_pool_add_batch(pool, batch, nr);
+	}
+}
+
+static int ion_page_pool_mag_total(struct ion_page_pool *pool)
+{
+	int cpu, count = 0;
+
+	for_each_possible_cpu(cpu)
+		count += ACCESS_ONCE(per_cpu_ptr(pool->mags, cpu)->count);
+
+	return count;
+}
+
+void ion_page_pool_mag_stat(struct ion_page_pool *pool,
+			    struct ion_page_pool_mag_stat *stat)
+{
+	struct ion_page_pool_magazine *mag;
+	int cpu;
+
+	memset(stat, 0, sizeof(*stat));
+	for_each_possible_cpu(cpu) {
+		mag = per_cpu_ptr(pool->mags, cpu);
+		spin_lock(&mag->lock);
+		stat->count += mag->count;
+		stat->alloc_hits += mag->alloc_hits;
+		stat->alloc_misses += mag->alloc_misses;
+		stat->free_hits += mag->free_hits;
+		stat->free_misses += mag->free_misses;
+		spin_unlock(&mag->lock);
+	}
 }
 
 static int ion_page_pool_total(struct ion_page_pool *pool, bool high)
@@ -110,12 +246,43 @@ static int ion_page_pool_total(struct ion_page_pool *pool, bool high)
 	if (high)
 		count += pool->high_count;
 
+	/* magazine pages are counted regardless of zone, they get drained */
+	count += ion_page_pool_mag_total(pool);
+
 	return count << pool->order;
 }
 
+int ion_page_pool_count(struct ion_page_pool *pool)
+{
+	return pool->high_count + pool->low_count +
+		ion_page_pool_mag_total(pool);
+}
+
+int ion_page_pool_fill(struct ion_page_pool *pool, int nr)
+{
+	gfp_t gfp_mask = (pool->gfp_mask | __GFP_NORETRY | __GFP_NOWARN |
+			  __GFP_NO_KSWAPD) & ~__GFP_WAIT;
+	struct page *page;
+	int added = 0;
+
+	while (ion_page_pool_count(pool) < nr) {
+		page = alloc_pages(gfp_mask, pool->order);
+		if (!page)
+			break;
+		ion_pages_sync_for_device(NULL, page, PAGE_SIZE << pool->order,
+					  DMA_BIDIRECTIONAL);
+		ion_page_pool_add(pool, page);
+		added++;
+		cond_resched();
+	}
+
+	return added;
+}
+
 int ion_page_pool_shrink(struct ion_page_pool *pool, gfp_t gfp_mask,
 				int nr_to_scan)
 {
+	LIST_HEAD(pages);
 	int freed;
 	bool high;
 
@@ -127,21 +294,23 @@ int ion_page_pool_shrink(struct ion_page_pool *pool, gfp_t gfp_mask,
 	if (nr_to_scan == 0)
 		return ion_page_pool_total(pool, high);
 
+	ion_page_pool_drain_mags(pool);
+
+	mutex_lock(&pool->mutex);
 	for (freed = 0; freed < nr_to_scan; freed++) {
 		struct page *page;
 
-		mutex_lock(&pool->mutex);
-		if (pool->low_count) {
+		if (pool->low_count)
 			page = ion_page_pool_remove(pool, false);
-		} else if (high && pool->high_count) {
+		else if (high && pool->high_count)
 			page = ion_page_pool_remove(pool, true);
-		} else {
-			mutex_unlock(&pool->mutex);
+		else
 			break;
-		}
-		mutex_unlock(&pool->mutex);
-		ion_page_pool_free_pages(pool, page);
+		list_add(&page->lru, &pages);
 	}
+	mutex_unlock(&pool->mutex);
+
+	free_pages_bulk(&pages, pool->order);
 
 	return freed;
 }
@@ -150,10 +319,28 @@ struct ion_page_pool *ion_page_pool_create(gfp_t gfp_mask, unsigned int order)
 {
 	struct ion_page_pool *pool = kmalloc(sizeof(struct ion_page_pool),
 					     GFP_KERNEL);
+	int cpu;
+
 	if (!pool) {
 		IONMSG("%s kmalloc failed pool is null.\n", __func__);
 		return NULL;
 	}
+	pool->mags = alloc_percpu(struct ion_page_pool_magazine);
+	if (!pool->mags) {
+		IONMSG("%s alloc_percpu failed for magazines.\n", __func__);
+		kfree(pool);
+		return NULL;
+	}
+	for_each_possible_cpu(cpu) {
+		struct ion_page_pool_magazine *mag = per_cpu_ptr(pool->mags, cpu);
+
+		spin_lock_init(&mag->lock);
+		mag->count = 0;
+	}
+	/* keep roughly 256KB per cpu cached, but at least one page */
+	pool->mag_size = clamp_t(int, SZ_256K >> (PAGE_SHIFT + order), 1,
+				 ION_PAGE_POOL_MAG_SIZE);
+	pool->mag_batch = DIV_ROUND_UP(pool->mag_size, 2);
 	pool->high_count = 0;
 	pool->low_count = 0;
 	INIT_LIST_HEAD(&pool->low_items);
@@ -168,6 +355,7 @@ struct ion_page_pool *ion_page_pool_create(gfp_t gfp_mask, unsigned int order)
 
 void ion_page_pool_destroy(struct ion_page_pool *pool)
 {
+	free_percpu(pool->mags);
 	kfree(pool);
 }
 
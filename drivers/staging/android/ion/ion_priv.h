@@ -217,6 +217,13 @@ struct ion_heap_ops {
  * heap flags - flags between the heaps and core ion code
  */
 #define ION_HEAP_FLAG_DEFER_FREE (1 << 0)
+/*
+ * Together with ION_HEAP_FLAG_DEFER_FREE: the free thread runs as a normal
+ * (nice) task instead of SCHED_IDLE and drains the free list in batches,
+ * the free list is bounded to ion_heap_freelist_max bytes and buffers bypass
+ * the heap's page pools while the heap shrinker is active.
+ */
+#define ION_HEAP_FLAG_DEFER_FREE_BATCH (1 << 1)
 
 /**
  * private flags - flags internal to ion
@@ -246,6 +253,9 @@ struct ion_heap_ops {
  * @lock:		protects the free list
  * @waitqueue:		queue to wait on from deferred free thread
  * @task:		task struct of deferred free thread
+ * @last_shrink:	jiffies of the last shrinker scan of this heap
+ * @free_batches:	batches drained by the deferred free thread
+ * @free_overflows:	buffers freed synchronously because the list was full
  * @debug_show:		called when heap debug file is read to add any
  *			heap specific debug info to output
  *
@@ -268,6 +278,9 @@ struct ion_heap {
 	spinlock_t free_lock;
 	wait_queue_head_t waitqueue;
 	struct task_struct *task;
+	unsigned long last_shrink;
+	unsigned long free_batches;
+	unsigned long free_overflows;
 
 	int (*debug_show)(struct ion_heap *heap, struct seq_file *, void *);
 };
@@ -420,6 +433,7 @@ void ion_mm_heap_destroy(struct ion_heap *);
 
 struct ion_heap *ion_cma_heap_create(struct ion_platform_heap *);
 void ion_cma_heap_destroy(struct ion_heap *);
+int ion_cma_heap_prepare(struct ion_heap *heap, size_t len);
 
 struct ion_heap *ion_fb_heap_create(struct ion_platform_heap *);
 void ion_fb_heap_destroy(struct ion_heap *);
@@ -446,6 +460,29 @@ int ion_device_destroy_heaps(struct ion_device *dev, int need_lock);
  * invalidated from the cache, provides a significant performance benefit on
  * many systems */
 
+/**
+ * struct ion_page_pool_magazine - per-cpu cache in front of a page pool
+ * @lock:		protects the magazine; only contended when the shrinker
+ *			drains all cpus
+ * @count:		number of pages in @pages
+ * @alloc_hits:		allocations served from the magazine
+ * @alloc_misses:	allocations that had to go to the pool
+ * @free_hits:		frees absorbed by the magazine
+ * @free_misses:	frees that overflowed and spilled a batch to the pool
+ * @pages:		the cached pages
+ */
+#define ION_PAGE_POOL_MAG_SIZE	16
+
+struct ion_page_pool_magazine {
+	spinlock_t lock;
+	int count;
+	unsigned long alloc_hits;
+	unsigned long alloc_misses;
+	unsigned long free_hits;
+	unsigned long free_misses;
+	struct page *pages[ION_PAGE_POOL_MAG_SIZE];
+};
+
 /**
  * struct ion_page_pool - pagepool struct
  * @high_count:		number of highmem items in the pool
@@ -457,6 +494,9 @@ int ion_device_destroy_heaps(struct ion_device *dev, int need_lock);
  * @gfp_mask:		gfp_mask to use from alloc
  * @order:		order of pages in the pool
  * @list:		plist node for list of pools
+ * @mags:		per-cpu magazines serving the common alloc/free path
+ * @mag_size:		pages each magazine holds at most
+ * @mag_batch:		pages moved between a magazine and the pool at once
  *
  * Allows you to keep a pool of pre allocated pages to use from your heap.
  * Keeping a pool of pages that is ready for dma, ie any cached mapping have
@@ -472,6 +512,20 @@ struct ion_page_pool {
 	gfp_t gfp_mask;
 	unsigned int order;
 	struct plist_node list;
+	struct ion_page_pool_magazine __percpu *mags;
+	int mag_size;
+	int mag_batch;
+};
+
+/**
+ * struct ion_page_pool_mag_stat - magazine counters summed over all cpus
+ */
+struct ion_page_pool_mag_stat {
+	int count;
+	unsigned long alloc_hits;
+	unsigned long alloc_misses;
+	unsigned long free_hits;
+	unsigned long free_misses;
 };
 
 struct ion_page_pool *ion_page_pool_create(gfp_t gfp_mask, unsigned int order);
@@ -489,6 +543,26 @@ void ion_page_pool_free(struct ion_page_pool *, struct page *);
 int ion_page_pool_shrink(struct ion_page_pool *pool, gfp_t gfp_mask,
 			  int nr_to_scan);
 
+/** ion_page_pool_count - number of items (of pool->order) in the pool
+ * @pool:		the pool
+ */
+int ion_page_pool_count(struct ion_page_pool *pool);
+
+/** ion_page_pool_fill - top the pool up with fresh pages
+ * @pool:		the pool
+ * @nr:			number of items the pool should hold
+ *
+ * Pages come straight from the buddy allocator, zeroed if the pool's gfp
+ * mask asks for it, without entering reclaim or waking kswapd. Stops at
+ * the first failed allocation.
+ *
+ * returns the number of items added
+ */
+int ion_page_pool_fill(struct ion_page_pool *pool, int nr);
+
+void ion_page_pool_mag_stat(struct ion_page_pool *pool,
+			    struct ion_page_pool_mag_stat *stat);
+
 /**
  * ion_pages_sync_for_device - cache flush pages for use with the specified
  *                             device
@@ -17,12 +17,18 @@
 #include <asm/page.h>
 #include <linux/dma-mapping.h>
 #include <linux/err.h>
+#include <linux/freezer.h>
 #include <linux/highmem.h>
+#include <linux/kthread.h>
 #include <linux/mm.h>
+#include <linux/moduleparam.h>
 #include <linux/scatterlist.h>
 #include <linux/seq_file.h>
+#include <linux/sizes.h>
 #include <linux/slab.h>
 #include <linux/vmalloc.h>
+#include <linux/vmpressure.h>
+#include <linux/wait.h>
 #include "ion.h"
 #include "ion_priv.h"
 
@@ -49,9 +55,76 @@ static inline unsigned int order_to_size(int order)
 
 struct ion_system_heap {
 	struct ion_heap heap;
+	struct task_struct *prefill_task;
+	wait_queue_head_t prefill_wait;
+	atomic_t prefill_kick;
 	struct ion_page_pool *pools[0];
 };
 
+/*
+ * The uncached pools are kept topped up with zeroed pages by a low priority
+ * thread so that large allocations are served by list pops instead of the
+ * buddy allocator zeroing pages on the allocating thread. The targets are
+ * in KB per order (8, 4, 0); 0 disables prefill for that order.
+ */
+static unsigned int prefill_kb[] = {8192, 4096, 0};
+module_param_array(prefill_kb, uint, NULL, S_IRUGO | S_IWUSR);
+
+/* Any medium or worse vmpressure pauses prefill for this long */
+#define ION_PREFILL_BACKOFF	(2 * HZ)
+static unsigned long prefill_backoff_until;
+/* system heaps sharing the vmpressure listener */
+static int prefill_heaps;
+
+static int ion_system_heap_vmpressure(struct notifier_block *nb,
+				      unsigned long level, void *data)
+{
+	if (level >= VMPRESSURE_MEDIUM)
+		prefill_backoff_until = jiffies + ION_PREFILL_BACKOFF;
+
+	return NOTIFY_OK;
+}
+
+static struct notifier_block ion_system_heap_vmpressure_nb = {
+	.notifier_call = ion_system_heap_vmpressure,
+};
+
+static void ion_system_heap_kick_prefill(struct ion_system_heap *sys_heap)
+{
+	if (!sys_heap->prefill_task)
+		return;
+
+	atomic_set(&sys_heap->prefill_kick, 1);
+	wake_up(&sys_heap->prefill_wait);
+}
+
+static int ion_system_heap_prefill_thread(void *data)
+{
+	struct ion_system_heap *sys_heap = data;
+	int i, target;
+
+	set_user_nice(current, MAX_NICE);
+	set_freezable();
+
+	while (!kthread_should_stop()) {
+		wait_event_freezable(sys_heap->prefill_wait,
+				     atomic_read(&sys_heap->prefill_kick) ||
+				     kthread_should_stop());
+		atomic_set(&sys_heap->prefill_kick, 0);
+
+		for (i = 0; i < num_orders; i++) {
+			if (time_before(jiffies, prefill_backoff_until))
+				break;
+
+			target = (prefill_kb[i] * SZ_1K) >> (PAGE_SHIFT + orders[i]);
+			if (target)
+				ion_page_pool_fill(sys_heap->pools[i], target);
+		}
+	}
+
+	return 0;
+}
+
 static struct page *alloc_buffer_page(struct ion_system_heap *heap,
 				      struct ion_buffer *buffer,
 				      unsigned long order)
@@ -77,8 +150,14 @@ static struct page *alloc_buffer_page(struct ion_system_heap *heap,
 	return page;
 }
 
+/*
+ * Pages that bypass the pools are queued on @to_free, one list per order,
+ * for the caller to release with free_pages_bulk(); with NULL they are
+ * freed right away.
+ */
 static void free_buffer_page(struct ion_system_heap *heap,
-			     struct ion_buffer *buffer, struct page *page)
+			     struct ion_buffer *buffer, struct page *page,
+			     struct list_head *to_free)
 {
 	unsigned int order = compound_order(page);
 	bool cached = ion_buffer_cached(buffer);
@@ -87,6 +166,8 @@ static void free_buffer_page(struct ion_system_heap *heap,
 		struct ion_page_pool *pool = heap->pools[order_to_index(order)];
 
 		ion_page_pool_free(pool, page);
+	} else if (to_free) {
+		list_add(&page->lru, &to_free[order_to_index(order)]);
 	} else {
 		__free_pages(page, order);
 	}
@@ -165,13 +246,15 @@ static int ion_system_heap_allocate(struct ion_heap *heap,
 	}
 
 	buffer->priv_virt = table;
+	if (!ion_buffer_cached(buffer))
+		ion_system_heap_kick_prefill(sys_heap);
 	return 0;
 
 free_table:
 	kfree(table);
 free_pages:
 	list_for_each_entry_safe(page, tmp_page, &pages, lru)
-		free_buffer_page(sys_heap, buffer, page);
+		free_buffer_page(sys_heap, buffer, page, NULL);
 	return -ENOMEM;
 }
 
@@ -182,6 +265,7 @@ static void ion_system_heap_free(struct ion_buffer *buffer)
 							heap);
 	struct sg_table *table = buffer->sg_table;
 	bool cached = ion_buffer_cached(buffer);
+	struct list_head to_free[ARRAY_SIZE(orders)];
 	struct scatterlist *sg;
 	int i;
 
@@ -190,8 +274,12 @@ static void ion_system_heap_free(struct ion_buffer *buffer)
 	if (!cached && !(buffer->private_flags & ION_PRIV_FLAG_SHRINKER_FREE))
 		ion_heap_buffer_zero(buffer);
 
+	for (i = 0; i < num_orders; i++)
+		INIT_LIST_HEAD(&to_free[i]);
 	for_each_sg(table->sgl, sg, table->nents, i)
-		free_buffer_page(sys_heap, buffer, sg_page(sg));
+		free_buffer_page(sys_heap, buffer, sg_page(sg), to_free);
+	for (i = 0; i < num_orders; i++)
+		free_pages_bulk(&to_free[i], orders[i]);
 	sg_free_table(table);
 	kfree(table);
 }
@@ -247,7 +335,12 @@ static int ion_system_heap_debug_show(struct ion_heap *heap, struct seq_file *s,
 
 	for (i = 0; i < num_orders; i++) {
 		struct ion_page_pool *pool = sys_heap->pools[i];
+		struct ion_page_pool_mag_stat stat;
 
+		ion_page_pool_mag_stat(pool, &stat);
+		seq_printf(s, "%d order %u pages in magazines, alloc hit %lu miss %lu, free hit %lu spill %lu\n",
+			   stat.count, pool->order, stat.alloc_hits,
+			   stat.alloc_misses, stat.free_hits, stat.free_misses);
 		seq_printf(s, "%d order %u highmem pages in pool = %lu total\n",
 			   pool->high_count, pool->order,
 			   (PAGE_SIZE << pool->order) * pool->high_count);
@@ -270,7 +363,8 @@ struct ion_heap *ion_system_heap_create(struct ion_platform_heap *unused)
 		return ERR_PTR(-ENOMEM);
 	heap->heap.ops = &system_heap_ops;
 	heap->heap.type = ION_HEAP_TYPE_SYSTEM;
-	heap->heap.flags = ION_HEAP_FLAG_DEFER_FREE;
+	heap->heap.flags = ION_HEAP_FLAG_DEFER_FREE |
+			   ION_HEAP_FLAG_DEFER_FREE_BATCH;
 
 	for (i = 0; i < num_orders; i++) {
 		struct ion_page_pool *pool;
@@ -285,6 +379,18 @@ struct ion_heap *ion_system_heap_create(struct ion_platform_heap *unused)
 	}
 
 	heap->heap.debug_show = ion_system_heap_debug_show;
+
+	init_waitqueue_head(&heap->prefill_wait);
+	atomic_set(&heap->prefill_kick, 1);
+	heap->prefill_task = kthread_run(ion_system_heap_prefill_thread, heap,
+					 "ion_prefill");
+	if (IS_ERR(heap->prefill_task)) {
+		pr_err("%s: failed to start prefill thread\n", __func__);
+		heap->prefill_task = NULL;
+	} else if (!prefill_heaps++) {
+		vmpressure_notifier_register(&ion_system_heap_vmpressure_nb);
+	}
+
 	return &heap->heap;
 
 destroy_pools:
@@ -301,6 +407,11 @@ void ion_system_heap_destroy(struct ion_heap *heap)
 							heap);
 	int i;
 
+	if (sys_heap->prefill_task) {
+		if (!--prefill_heaps)
+			vmpressure_notifier_unregister(&ion_system_heap_vmpressure_nb);
+		kthread_stop(sys_heap->prefill_task);
+	}
 	for (i = 0; i < num_orders; i++)
 		ion_page_pool_destroy(sys_heap->pools[i]);
 	kfree(sys_heap);
@@ -27,6 +27,7 @@
 #include <linux/vmalloc.h>
 #include "ion_profile.h"
 #include <linux/debugfs.h>
+#include <mt-plat/mt_cache_sync.h>
 #include "ion_priv.h"
 #include "ion_drv_priv.h"
 #include "mtk/mtk_ion.h"
@@ -86,37 +87,6 @@ static int __ion_cache_sync_kernel(unsigned long start, size_t size,
 	return 0;
 }
 
-static struct vm_struct *cache_map_vm_struct;
-static int ion_cache_sync_init(void)
-{
-	cache_map_vm_struct = get_vm_area(PAGE_SIZE, VM_ALLOC);
-	if (!cache_map_vm_struct)
-		return -ENOMEM;
-
-	return 0;
-}
-
-static void *ion_cache_map_page_va(struct page *page)
-{
-	int ret;
-	struct page **ppPage = &page;
-
-	ret = map_vm_area(cache_map_vm_struct, PAGE_KERNEL, ppPage);
-	if (ret) {
-		IONMSG("error to map page\n");
-		return NULL;
-	}
-	return cache_map_vm_struct->addr;
-}
-
-static void ion_cache_unmap_page_va(unsigned long va)
-{
-	unmap_kernel_range((unsigned long) cache_map_vm_struct->addr, PAGE_SIZE);
-}
-
-/* lock to protect cache_map_vm_struct */
-static DEFINE_MUTEX(gIon_cache_sync_user_lock);
-
 static long ion_sys_cache_sync(struct ion_client *client,
 		ion_sys_cache_sync_param_t *pParam, int from_kernel) {
 	ION_FUNC_ENTER;
@@ -138,10 +108,7 @@ static long ion_sys_cache_sync(struct ion_client *client,
 #endif
 				{
 			struct ion_buffer *buffer;
-			struct scatterlist *sg;
-			int i, j;
-			struct sg_table *table = NULL;
-			int npages = 0;
+			enum mt_cache_op op;
 
 			mutex_lock(&client->lock);
 			/*if (!ion_handle_validate(client, kernel_handle)) {
@@ -151,46 +118,25 @@ static long ion_sys_cache_sync(struct ion_client *client,
 			 }
 			 */
 			buffer = kernel_handle->buffer;
-
-			table = buffer->sg_table;
-			npages = PAGE_ALIGN(buffer->size) / PAGE_SIZE;
-
-			mutex_lock(&gIon_cache_sync_user_lock);
-
-			if (!cache_map_vm_struct) {
-				IONMSG(" error: cache_map_vm_struct is NULL, retry\n");
-				ion_cache_sync_init();
-			}
-
-			if (!cache_map_vm_struct) {
-				IONMSG("error: cache_map_vm_struct is NULL, no vmalloc area\n");
-				mutex_unlock(&gIon_cache_sync_user_lock);
-				mutex_unlock(&client->lock);
-				return -ENOMEM;
-			}
-
-			for_each_sg(table->sgl, sg, table->nents, i) {
-				int npages_this_entry = PAGE_ALIGN(sg->length) / PAGE_SIZE;
-				struct page *page = sg_page(sg);
-
-				BUG_ON(i >= npages);
-				for (j = 0; j < npages_this_entry; j++) {
-					start = (unsigned long) ion_cache_map_page_va(page++);
-
-					if (IS_ERR_OR_NULL((void *) start)) {
-						IONMSG("cannot do cache sync: ret=%lu\n", start);
-						mutex_unlock(&gIon_cache_sync_user_lock);
-						mutex_unlock(&client->lock);
-						return -EFAULT;
-					}
-
-					__ion_cache_sync_kernel(start, PAGE_SIZE, pParam->sync_type);
-
-					ion_cache_unmap_page_va(start);
-				}
+			size = buffer->size;
+
+			if (pParam->sync_type == ION_CACHE_CLEAN_BY_RANGE) {
+				op = MT_CACHE_CLEAN;
+				MMProfileLogEx(ION_MMP_Events[PROFILE_DMA_CLEAN_RANGE],
+						MMProfileFlagStart, size, 0);
+			} else if (pParam->sync_type == ION_CACHE_INVALID_BY_RANGE) {
+				op = MT_CACHE_INVALIDATE;
+				MMProfileLogEx(ION_MMP_Events[PROFILE_DMA_INVALID_RANGE],
+						MMProfileFlagStart, size, 0);
+			} else {
+				op = MT_CACHE_FLUSH;
+				MMProfileLogEx(ION_MMP_Events[PROFILE_DMA_FLUSH_RANGE],
+						MMProfileFlagStart, size, 0);
 			}
+			/* through the linear map, no per page mapping */
+			mt_cache_sync_sg(buffer->sg_table->sgl, buffer->sg_table->nents,
+					 0, size, op);
 
-			mutex_unlock(&gIon_cache_sync_user_lock);
 			mutex_unlock(&client->lock);
 		} else {
 			start = (unsigned long) pParam->va;
@@ -291,13 +237,17 @@ int ion_sys_copy_client_name(const char *src, char *dst)
 long ion_dma_op(struct ion_client *client, ion_sys_dma_param_t *pParam, int from_kernel)
 {
 	struct ion_buffer *buffer;
-	struct scatterlist *sg;
-	int i, j;
-	struct sg_table *table = NULL;
-	int npages = 0;
-	unsigned long start = -1;
-
 	struct ion_handle *kernel_handle;
+	enum mt_cache_op op;
+
+	/* what dmac_map_area()/dmac_unmap_area() do for each direction */
+	if (pParam->dma_type == ION_DMA_MAP_AREA)
+		op = pParam->dma_dir == ION_DMA_FROM_DEVICE ?
+			MT_CACHE_INVALIDATE : MT_CACHE_CLEAN;
+	else if (pParam->dma_dir != ION_DMA_TO_DEVICE)
+		op = MT_CACHE_INVALIDATE;
+	else
+		return 0;
 
 	kernel_handle = ion_drv_get_handle(client, pParam->handle,
 					   pParam->kernel_handle, from_kernel);
@@ -308,49 +258,8 @@ long ion_dma_op(struct ion_client *client, ion_sys_dma_param_t *pParam, int from
 
 	mutex_lock(&client->lock);
 	buffer = kernel_handle->buffer;
-
-	table = buffer->sg_table;
-	npages = PAGE_ALIGN(buffer->size) / PAGE_SIZE;
-
-	mutex_lock(&gIon_cache_sync_user_lock);
-
-	if (!cache_map_vm_struct) {
-		IONMSG(" error: cache_map_vm_struct is NULL, retry\n");
-		ion_cache_sync_init();
-	}
-
-	if (!cache_map_vm_struct) {
-		IONMSG("error: cache_map_vm_struct is NULL, no vmalloc area\n");
-		mutex_unlock(&gIon_cache_sync_user_lock);
-		mutex_unlock(&client->lock);
-		return -ENOMEM;
-	}
-
-	for_each_sg(table->sgl, sg, table->nents, i) {
-		int npages_this_entry = PAGE_ALIGN(sg->length) / PAGE_SIZE;
-		struct page *page = sg_page(sg);
-
-		BUG_ON(i >= npages);
-		for (j = 0; j < npages_this_entry; j++) {
-			start = (unsigned long)ion_cache_map_page_va(page++);
-
-			if (IS_ERR_OR_NULL((void *)start)) {
-				IONMSG("cannot do cache sync: ret=%lu\n", start);
-				mutex_unlock(&gIon_cache_sync_user_lock);
-				mutex_unlock(&client->lock);
-				return -EFAULT;
-			}
-
-			if (pParam->dma_type == ION_DMA_MAP_AREA)
-				ion_dma_map_area_va((void *)start, PAGE_SIZE, pParam->dma_dir);
-			else if (pParam->dma_type == ION_DMA_UNMAP_AREA)
-				ion_dma_unmap_area_va((void *)start, PAGE_SIZE, pParam->dma_dir);
-
-			ion_cache_unmap_page_va(start);
-		}
-	}
-
-	mutex_unlock(&gIon_cache_sync_user_lock);
+	mt_cache_sync_sg(buffer->sg_table->sgl, buffer->sg_table->nents,
+			 0, buffer->size, op);
 	mutex_unlock(&client->lock);
 
 	ion_drv_put_kernel_handle(kernel_handle);
@@ -461,6 +370,20 @@ static long ion_sys_ioctl(struct ion_client *client, unsigned int cmd,
 	case ION_SYS_DMA_OP:
 		ion_sys_dma_op(client, &Param.dma_param, from_kernel);
 		break;
+	case ION_SYS_CMA_PREPARE:
+	{
+		struct ion_heap *heap;
+
+		heap = ion_drv_get_heap(g_ion_device, Param.cma_prepare_param.heap_id, 1);
+		if (!heap) {
+			IONMSG("[ion_sys_ioctl]: Error. No heap %u to prepare.\n",
+					Param.cma_prepare_param.heap_id);
+			ret = -EINVAL;
+			break;
+		}
+		ret = ion_cma_heap_prepare(heap, Param.cma_prepare_param.len);
+	}
+	break;
 	case ION_SYS_SET_HANDLE_BACKTRACE: {
 #if  ION_RUNTIME_DEBUGGER
 		unsigned int i;
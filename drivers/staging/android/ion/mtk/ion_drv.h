@@ -28,6 +28,7 @@ typedef enum {
 	ION_SYS_SET_HANDLE_BACKTRACE,
 	ION_SYS_SET_CLIENT_NAME,
 	ION_SYS_DMA_OP,
+	ION_SYS_CMA_PREPARE,
 } ION_SYS_CMDS;
 
 typedef enum {
@@ -90,6 +91,15 @@ typedef struct ion_sys_get_phys_param {
 	unsigned long len;
 } ion_sys_get_phys_param_t;
 
+/*
+ * Hint that an allocation of len bytes from CMA heap heap_id follows soon,
+ * so the heap can clear its CMA area in advance.
+ */
+typedef struct ion_sys_cma_prepare_param {
+	unsigned int heap_id;
+	unsigned long len;
+} ion_sys_cma_prepare_param_t;
+
 #define ION_MM_DBG_NAME_LEN 16
 #define ION_MM_SF_BUF_INFO_LEN 16
 
@@ -126,6 +136,7 @@ typedef struct ion_sys_data {
 		ion_sys_client_name_t client_name_param;
 		ion_sys_record_t record_param;
 		ion_sys_dma_param_t dma_param;
+		ion_sys_cma_prepare_param_t cma_prepare_param;
 	};
 } ion_sys_data_t;
 
@@ -47,9 +47,14 @@ static unsigned int high_order_gfp_flags = (GFP_HIGHUSER | __GFP_ZERO
 		| __GFP_NOWARN | __GFP_NORETRY | __GFP_NO_KSWAPD) & ~__GFP_WAIT;
 static unsigned int low_order_gfp_flags = (GFP_HIGHUSER | __GFP_ZERO
 		| __GFP_NOWARN);
+#ifdef CONFIG_MTK_ION_MM_HEAP_LARGE_PAGES
+/* 1MB and 64KB chunks line up with M4U section and large page entries */
+static const unsigned int orders[] = {8, 4, 0};
+#else
 static const unsigned int orders[] = { 1, 0 };
-/* static const unsigned int orders[] = {8, 4, 0}; */
+#endif
 static const int num_orders = ARRAY_SIZE(orders);
+static atomic_long_t mm_heap_order_allocs[ARRAY_SIZE(orders)];
 static int order_to_index(unsigned int order)
 {
 	int i;
@@ -102,6 +107,8 @@ static struct page *alloc_buffer_page(struct ion_system_heap *heap,
 	if (split_pages)
 		split_page(page, order);
 
+	atomic_long_inc(&mm_heap_order_allocs[order_to_index(order)]);
+
 	return page;
 }
 
@@ -386,10 +393,13 @@ int ion_mm_heap_pool_total(struct ion_heap *heap)
 
 	for (i = 0; i < num_orders; i++) {
 		struct ion_page_pool *pool = sys_heap->pools[i];
+		struct ion_page_pool_mag_stat stat;
 
-		total += (pool->high_count + pool->low_count) * (1 << pool->order);
+		ion_page_pool_mag_stat(pool, &stat);
+		total += (pool->high_count + pool->low_count + stat.count) * (1 << pool->order);
 		pool = sys_heap->cached_pools[i];
-		total += (pool->high_count + pool->low_count) * (1 << pool->order);
+		ion_page_pool_mag_stat(pool, &stat);
+		total += (pool->high_count + pool->low_count + stat.count) * (1 << pool->order);
 	}
 
 	return total;
@@ -419,7 +429,15 @@ static int ion_mm_heap_debug_show(struct ion_heap *heap, struct seq_file *s, voi
 
 	for (i = 0; i < num_orders; i++) {
 		struct ion_page_pool *pool = sys_heap->pools[i];
+		struct ion_page_pool_mag_stat stat;
 
+		ION_PRINT_LOG_OR_SEQ(s, "order %u chunks allocated = %ld\n",
+				pool->order, atomic_long_read(&mm_heap_order_allocs[i]));
+		ion_page_pool_mag_stat(pool, &stat);
+		ION_PRINT_LOG_OR_SEQ(s,
+				"%d order %u pages in magazines, alloc hit %lu miss %lu, free hit %lu spill %lu\n",
+				stat.count, pool->order, stat.alloc_hits, stat.alloc_misses,
+				stat.free_hits, stat.free_misses);
 		ION_PRINT_LOG_OR_SEQ(s,
 				"%d order %u highmem pages in pool = %lu total\n",
 				pool->high_count, pool->order, (1 << pool->order) * PAGE_SIZE * pool->high_count);
@@ -427,6 +445,11 @@ static int ion_mm_heap_debug_show(struct ion_heap *heap, struct seq_file *s, voi
 				"%d order %u lowmem pages in pool = %lu total\n",
 				pool->low_count, pool->order, (1 << pool->order) * PAGE_SIZE * pool->low_count);
 		pool = sys_heap->cached_pools[i];
+		ion_page_pool_mag_stat(pool, &stat);
+		ION_PRINT_LOG_OR_SEQ(s,
+				"%d order %u pages in cached magazines, alloc hit %lu miss %lu, free hit %lu spill %lu\n",
+				stat.count, pool->order, stat.alloc_hits, stat.alloc_misses,
+				stat.free_hits, stat.free_misses);
 		ION_PRINT_LOG_OR_SEQ(s,
 				"%d order %u highmem pages in cached_pool = %lu total\n",
 				pool->high_count, pool->order, (1 << pool->order) * PAGE_SIZE * pool->high_count);
@@ -434,8 +457,11 @@ static int ion_mm_heap_debug_show(struct ion_heap *heap, struct seq_file *s, voi
 				"%d order %u lowmem pages in cached_pool = %lu total\n",
 				pool->low_count, pool->order, (1 << pool->order) * PAGE_SIZE * pool->low_count);
 	}
-	if (heap->flags & ION_HEAP_FLAG_DEFER_FREE)
+	if (heap->flags & ION_HEAP_FLAG_DEFER_FREE) {
 		ION_PRINT_LOG_OR_SEQ(s, "mm_heap_freelist total_size=0x%zu\n", ion_heap_freelist_size(heap));
+		ION_PRINT_LOG_OR_SEQ(s, "mm_heap_freelist batches=%lu overflows=%lu\n",
+				heap->free_batches, heap->free_overflows);
+	}
 	else
 		ION_PRINT_LOG_OR_SEQ(s, "mm_heap defer free disabled\n");
 
@@ -652,7 +678,7 @@ struct ion_heap *ion_mm_heap_create(struct ion_platform_heap *unused)
 	}
 	heap->heap.ops = &system_heap_ops;
 	heap->heap.type = ION_HEAP_TYPE_MULTIMEDIA;
-	heap->heap.flags = ION_HEAP_FLAG_DEFER_FREE;
+	heap->heap.flags = ION_HEAP_FLAG_DEFER_FREE | ION_HEAP_FLAG_DEFER_FREE_BATCH;
 	heap->pools = kcalloc(num_orders, sizeof(struct ion_page_pool *), GFP_KERNEL);
 	if (!heap->pools)
 		goto err_alloc_pools;
@@ -668,6 +694,11 @@ struct ion_heap *ion_mm_heap_create(struct ion_platform_heap *unused)
 
 		if (orders[i] > 0)
 			gfp_flags = high_order_gfp_flags;
+#ifdef CONFIG_MTK_ION_MM_HEAP_LARGE_PAGES
+		/* order-4 may still compact cheaply, only order-8 is opportunistic */
+		if (orders[i] == 4)
+			gfp_flags = low_order_gfp_flags | __GFP_NORETRY;
+#endif
 		pool = ion_page_pool_create(gfp_flags, orders[i]);
 		if (!pool)
 			goto err_create_pool;
@@ -42,6 +42,18 @@
 #include <linux/rcupdate.h>
 #include <linux/notifier.h>
 #include <linux/freezer.h>
+#include <linux/kthread.h>
+#include <linux/delay.h>
+
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#endif
+
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_VMPRESSURE
+#include <linux/vmpressure.h>
+#include <linux/wait.h>
+#endif
 
 #if defined(CONFIG_MTK_AEE_FEATURE) && defined(CONFIG_MT_ENG_BUILD)
 #include <mt-plat/aee.h>
@@ -106,6 +118,9 @@ static int total_low_ratio = 1;
 static struct task_struct *lowmem_deathpending;
 static unsigned long lowmem_deathpending_timeout;
 
+/* Bumped on every kill, see lowmem_kill_generation() */
+static atomic_t lowmem_kill_gen = ATOMIC_INIT(0);
+
 #define lowmem_print(level, x...)			\
 	do {						\
 		if (lowmem_debug_level >= (level))	\
@@ -130,6 +145,389 @@ task_notify_func(struct notifier_block *self, unsigned long val, void *data)
 	return NOTIFY_DONE;
 }
 
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+/*
+ * Processes (thread group leaders) bucketed by oom_score_adj. The index is
+ * maintained from fork/exit/exec and oom_score_adj writes so that victim
+ * selection only looks at the few buckets at or above min_score_adj
+ * instead of walking the whole task list.
+ */
+#define LMK_ADJ_BUCKETS		256
+#define LMK_ADJ_RANGE		(OOM_SCORE_ADJ_MAX - OOM_SCORE_ADJ_MIN + 1)
+
+static struct list_head lmk_adj_buckets[LMK_ADJ_BUCKETS];
+static DEFINE_SPINLOCK(lmk_adj_lock);
+static bool lmk_adj_index_ready;
+static uint32_t lowmem_use_adj_index = 1;
+
+static inline int lmk_adj_bucket(short oom_score_adj)
+{
+	return (oom_score_adj - OOM_SCORE_ADJ_MIN) * LMK_ADJ_BUCKETS /
+		LMK_ADJ_RANGE;
+}
+
+static void __lmk_adj_index_add(struct task_struct *p)
+{
+	list_add_tail(&p->lmk_adj_node,
+		      &lmk_adj_buckets[lmk_adj_bucket(p->signal->oom_score_adj)]);
+}
+
+/* Called with tasklist_lock write-locked */
+void lmk_adj_index_add(struct task_struct *p)
+{
+	INIT_LIST_HEAD(&p->lmk_adj_node);
+
+	if (!lmk_adj_index_ready || (p->flags & PF_KTHREAD))
+		return;
+
+	spin_lock(&lmk_adj_lock);
+	__lmk_adj_index_add(p);
+	spin_unlock(&lmk_adj_lock);
+}
+
+/* Called with tasklist_lock write-locked */
+void lmk_adj_index_del(struct task_struct *p)
+{
+	if (list_empty(&p->lmk_adj_node))
+		return;
+
+	spin_lock(&lmk_adj_lock);
+	list_del_init(&p->lmk_adj_node);
+	spin_unlock(&lmk_adj_lock);
+}
+
+/* Called with tasklist_lock write-locked when a thread execs via de_thread */
+void lmk_adj_index_replace(struct task_struct *old, struct task_struct *new)
+{
+	INIT_LIST_HEAD(&new->lmk_adj_node);
+
+	if (list_empty(&old->lmk_adj_node))
+		return;
+
+	spin_lock(&lmk_adj_lock);
+	list_replace_init(&old->lmk_adj_node, &new->lmk_adj_node);
+	spin_unlock(&lmk_adj_lock);
+}
+
+/*
+ * Called after oom_score_adj of @p's thread group was rewritten. Must not be
+ * called with task_lock held: victim selection takes it under lmk_adj_lock.
+ */
+void lmk_adj_index_update(struct task_struct *p)
+{
+	struct task_struct *leader;
+
+	rcu_read_lock();
+	leader = READ_ONCE(p->group_leader);
+	spin_lock_irq(&lmk_adj_lock);
+	if (!list_empty(&leader->lmk_adj_node))
+		list_move_tail(&leader->lmk_adj_node,
+			       &lmk_adj_buckets[lmk_adj_bucket(
+					leader->signal->oom_score_adj)]);
+	spin_unlock_irq(&lmk_adj_lock);
+	rcu_read_unlock();
+}
+
+static void __init lmk_adj_index_init(void)
+{
+	struct task_struct *p;
+	int i;
+
+	for (i = 0; i < LMK_ADJ_BUCKETS; i++)
+		INIT_LIST_HEAD(&lmk_adj_buckets[i]);
+
+	write_lock_irq(&tasklist_lock);
+	spin_lock(&lmk_adj_lock);
+	for_each_process(p) {
+		if (p->flags & PF_KTHREAD)
+			continue;
+		__lmk_adj_index_add(p);
+	}
+	lmk_adj_index_ready = true;
+	spin_unlock(&lmk_adj_lock);
+	write_unlock_irq(&tasklist_lock);
+}
+
+/*
+ * Pick the process with the highest oom_score_adj >= @min_score_adj, the one
+ * with the largest footprint among equals, by walking buckets downwards and
+ * stopping after the first bucket that yields a candidate. Returns
+ * ERR_PTR(-EBUSY) if a candidate is still dying from a previous kill.
+ * Must be called under rcu_read_lock().
+ */
+static struct task_struct *lowmem_select_indexed(short min_score_adj,
+		int other_file, int *selected_tasksize,
+		short *selected_oom_score_adj, int *nr_scanned)
+{
+	struct task_struct *tsk, *p;
+	struct task_struct *selected = NULL;
+	short oom_score_adj;
+	int tasksize;
+	int b;
+
+	spin_lock_irq(&lmk_adj_lock);
+	for (b = LMK_ADJ_BUCKETS - 1;
+	     b >= lmk_adj_bucket(min_score_adj) && !selected; b--) {
+		list_for_each_entry(tsk, &lmk_adj_buckets[b], lmk_adj_node) {
+			(*nr_scanned)++;
+
+			p = find_lock_task_mm(tsk);
+			if (!p)
+				continue;
+
+			if (test_tsk_thread_flag(p, TIF_MEMDIE) &&
+			    time_before_eq(jiffies, lowmem_deathpending_timeout)) {
+				task_unlock(p);
+				spin_unlock_irq(&lmk_adj_lock);
+				return ERR_PTR(-EBUSY);
+			}
+
+			oom_score_adj = p->signal->oom_score_adj;
+			if (oom_score_adj < min_score_adj) {
+				task_unlock(p);
+				continue;
+			}
+
+			tasksize = get_mm_rss(p->mm);
+#ifdef CONFIG_ZRAM
+			tasksize += get_mm_counter(p->mm, MM_SWAPENTS);
+#endif
+			task_unlock(p);
+			if (tasksize <= 0)
+				continue;
+			if (selected) {
+				if (oom_score_adj < *selected_oom_score_adj)
+					continue;
+				if (oom_score_adj == *selected_oom_score_adj &&
+				    tasksize <= *selected_tasksize)
+					continue;
+			}
+#ifdef CONFIG_MTK_GMO_RAM_OPTIMIZE
+			if (!strcmp(p->comm, "ub:secureRandom") &&
+			    (REVERT_ADJ(oom_score_adj) == 9) &&
+			    (other_file > 30*256))
+				continue;
+#endif
+			selected = p;
+			*selected_tasksize = tasksize;
+			*selected_oom_score_adj = oom_score_adj;
+		}
+	}
+	spin_unlock_irq(&lmk_adj_lock);
+
+	if (selected)
+		lowmem_print(2, "select '%s' (%d), adj %d, score_adj %hd, size %d, to kill\n",
+			     selected->comm, selected->pid,
+			     REVERT_ADJ(*selected_oom_score_adj),
+			     *selected_oom_score_adj, *selected_tasksize);
+
+	return selected;
+}
+
+/* Selection cost, log2(us) buckets, for the full walk and the index */
+#define LMK_SCAN_HIST_SLOTS	16
+enum {
+	LMK_SCAN_WALK,
+	LMK_SCAN_INDEX,
+	LMK_SCAN_NR_METHODS,
+};
+
+static const char * const lmk_scan_method_name[LMK_SCAN_NR_METHODS] = {
+	[LMK_SCAN_WALK] = "walk",
+	[LMK_SCAN_INDEX] = "index",
+};
+
+static uint32_t lmk_scan_hist[LMK_SCAN_NR_METHODS][LMK_SCAN_HIST_SLOTS];
+static u64 lmk_scan_tasks[LMK_SCAN_NR_METHODS];
+
+/* Called with lowmem_shrink_lock held */
+static void lowmem_account_scan(int method, u64 start_ns, int nr_scanned)
+{
+	u64 us = (sched_clock() - start_ns) >> 10;
+	int slot = us ? min(fls64(us), LMK_SCAN_HIST_SLOTS - 1) : 0;
+
+	lmk_scan_hist[method][slot]++;
+	lmk_scan_tasks[method] += nr_scanned;
+}
+
+static int lowmem_scan_cost_show(struct seq_file *m, void *unused)
+{
+	int method, slot;
+
+	spin_lock(&lowmem_shrink_lock);
+	for (method = 0; method < LMK_SCAN_NR_METHODS; method++) {
+		seq_printf(m, "%s: tasks scanned %llu\n",
+			   lmk_scan_method_name[method],
+			   lmk_scan_tasks[method]);
+		for (slot = 0; slot < LMK_SCAN_HIST_SLOTS; slot++)
+			seq_printf(m, "  <%6uus: %u\n", 1U << slot,
+				   lmk_scan_hist[method][slot]);
+	}
+	spin_unlock(&lowmem_shrink_lock);
+
+	return 0;
+}
+
+static int lowmem_scan_cost_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, lowmem_scan_cost_show, NULL);
+}
+
+static const struct file_operations lowmem_scan_cost_fops = {
+	.open = lowmem_scan_cost_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static void __init lowmem_debugfs_init(void)
+{
+	struct dentry *dir;
+
+	dir = debugfs_create_dir("lowmemorykiller", NULL);
+	if (!dir)
+		return;
+	debugfs_create_file("scan_cost", S_IRUGO, dir, NULL,
+			    &lowmem_scan_cost_fops);
+}
+#else
+static inline void lmk_adj_index_init(void) {}
+static inline void lowmem_debugfs_init(void) {}
+#endif
+
+/*
+ * Victim reaping: a SIGKILLed task only gives its memory back once it gets
+ * to run exit_mm(), which can take seconds for a task stuck in D state or
+ * sitting in a throttled cgroup. Meanwhile lowmem_deathpending holds off
+ * further kills and the system keeps reclaiming. Tear down the private
+ * anonymous memory of the victim right away from a kernel thread instead;
+ * nothing the dying task can still observe depends on it.
+ */
+#define LMK_REAP_QUEUE_SIZE	8
+#define LMK_REAP_RETRIES	10
+
+static uint32_t lowmem_reap_enable = 1;
+static uint32_t lowmem_reaped_pages;
+static struct task_struct *lmk_reap_queue[LMK_REAP_QUEUE_SIZE];
+static unsigned int lmk_reap_head, lmk_reap_tail;
+static DEFINE_SPINLOCK(lmk_reap_lock);
+static DECLARE_WAIT_QUEUE_HEAD(lmk_reap_wait);
+static struct task_struct *lmk_reaper;
+
+static void lowmem_queue_reap(struct task_struct *tsk)
+{
+	if (!lowmem_reap_enable || !lmk_reaper)
+		return;
+
+	spin_lock(&lmk_reap_lock);
+	if (lmk_reap_tail - lmk_reap_head < LMK_REAP_QUEUE_SIZE) {
+		get_task_struct(tsk);
+		lmk_reap_queue[lmk_reap_tail++ % LMK_REAP_QUEUE_SIZE] = tsk;
+	}
+	spin_unlock(&lmk_reap_lock);
+	wake_up(&lmk_reap_wait);
+}
+
+static struct task_struct *lowmem_dequeue_reap(void)
+{
+	struct task_struct *tsk = NULL;
+
+	spin_lock(&lmk_reap_lock);
+	if (lmk_reap_head != lmk_reap_tail)
+		tsk = lmk_reap_queue[lmk_reap_head++ % LMK_REAP_QUEUE_SIZE];
+	spin_unlock(&lmk_reap_lock);
+
+	return tsk;
+}
+
+/*
+ * Returns false if mmap_sem is contended and the caller should retry,
+ * true once the task has been dealt with one way or the other.
+ */
+static bool lowmem_reap_task(struct task_struct *tsk, unsigned long *freed)
+{
+	struct mm_struct *mm;
+	struct vm_area_struct *vma;
+	unsigned long rss;
+	bool ret = true;
+
+	mm = get_task_mm(tsk);
+	if (!mm)
+		return true;
+
+	/*
+	 * Leave the mm alone if anything besides the dying thread group
+	 * holds it (vfork/CLONE_VM children, a core dump in progress), the
+	 * extra reference is ours.
+	 */
+	if (atomic_read(&mm->mm_users) > get_nr_threads(tsk) + 1 ||
+	    mm->core_state)
+		goto out_put;
+
+	if (!down_read_trylock(&mm->mmap_sem)) {
+		ret = false;
+		goto out_put;
+	}
+
+	rss = get_mm_rss(mm);
+	for (vma = mm->mmap; vma; vma = vma->vm_next) {
+		if (vma->vm_flags & (VM_LOCKED | VM_HUGETLB | VM_PFNMAP))
+			continue;
+		if (vma->vm_file || (vma->vm_flags & VM_SHARED))
+			continue;
+
+		zap_page_range(vma, vma->vm_start,
+			       vma->vm_end - vma->vm_start, NULL);
+	}
+	*freed = rss - min(rss, get_mm_rss(mm));
+	up_read(&mm->mmap_sem);
+
+out_put:
+	mmput(mm);
+	return ret;
+}
+
+static int lowmem_reaper_thread(void *data)
+{
+	struct task_struct *tsk;
+	unsigned long freed;
+	int attempts;
+
+	set_freezable();
+
+	while (!kthread_should_stop()) {
+		wait_event_freezable(lmk_reap_wait,
+				     lmk_reap_head != lmk_reap_tail ||
+				     kthread_should_stop());
+
+		while ((tsk = lowmem_dequeue_reap())) {
+			freed = 0;
+			for (attempts = 0; attempts < LMK_REAP_RETRIES; attempts++) {
+				if (lowmem_reap_task(tsk, &freed))
+					break;
+				msleep(10);
+			}
+
+			if (freed) {
+				lowmem_reaped_pages += freed;
+				lowmem_print(2, "reaped '%s' (%d), %lukB\n",
+					     tsk->comm, tsk->pid,
+					     freed * (PAGE_SIZE / 1024));
+				/*
+				 * Most of the victim's memory is back, no need
+				 * to keep holding off the next kill until it
+				 * finishes exiting.
+				 */
+				if (lowmem_deathpending == tsk)
+					lowmem_deathpending_timeout = jiffies;
+			}
+			put_task_struct(tsk);
+		}
+	}
+
+	return 0;
+}
+
 static unsigned long lowmem_count(struct shrinker *s,
 				  struct shrink_control *sc)
 {
@@ -163,6 +561,10 @@ static unsigned long lowmem_scan(struct shrinker *s, struct shrink_control *sc)
 
 	int print_extra_info = 0;
 	static unsigned long lowmem_print_extra_info_timeout;
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+	u64 scan_start_ns;
+	int nr_scanned = 0;
+#endif
 
 #ifdef CONFIG_MTK_GMO_RAM_OPTIMIZE
 	int other_anon = global_page_state(NR_INACTIVE_ANON) - global_page_state(NR_ACTIVE_ANON);
@@ -285,12 +687,36 @@ static unsigned long lowmem_scan(struct shrinker *s, struct shrink_control *sc)
 	}
 
 	rcu_read_lock();
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+	scan_start_ns = sched_clock();
+	/*
+	 * The candidate log and the eng build memory dump need to see every
+	 * task, everything else can go through the oom_score_adj index.
+	 */
+	if (!IS_ENABLED(CONFIG_MT_ENG_BUILD) && !print_extra_info &&
+	    lowmem_use_adj_index && lmk_adj_index_ready) {
+		selected = lowmem_select_indexed(min_score_adj, other_file,
+						 &selected_tasksize,
+						 &selected_oom_score_adj,
+						 &nr_scanned);
+		lowmem_account_scan(LMK_SCAN_INDEX, scan_start_ns, nr_scanned);
+		if (IS_ERR(selected)) {
+			rcu_read_unlock();
+			spin_unlock(&lowmem_shrink_lock);
+			return SHRINK_STOP;
+		}
+		goto selected_done;
+	}
+#endif
 	for_each_process(tsk) {
 		struct task_struct *p;
 		short oom_score_adj;
 
 		if (tsk->flags & PF_KTHREAD)
 			continue;
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+		nr_scanned++;
+#endif
 
 		p = find_lock_task_mm(tsk);
 		if (!p)
@@ -422,6 +848,10 @@ log_again:
 #ifdef CONFIG_MT_ENG_BUILD
 	if (log_offset > 0)
 		lowmem_print(1, "\n%s", lmk_log_buf);
+#endif
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+	lowmem_account_scan(LMK_SCAN_WALK, scan_start_ns, nr_scanned);
+selected_done:
 #endif
 
 	if (selected) {
@@ -512,6 +942,8 @@ log_again:
 #endif
 
 		send_sig(SIGKILL, selected, 0);
+		atomic_inc(&lowmem_kill_gen);
+		lowmem_queue_reap(selected);
 		rem += selected_tasksize;
 	}
 
@@ -528,6 +960,93 @@ static struct shrinker lowmem_shrinker = {
 	.seeks = DEFAULT_SEEKS * 16
 };
 
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_VMPRESSURE
+/*
+ * vmpressure driven kill path: kswapd reclaim already reports
+ * medium/critical pressure for the root memcg long before allocations
+ * fall into direct reclaim, so let a dedicated thread run the minfree
+ * check as soon as that happens instead of waiting for the shrinker.
+ */
+static uint32_t lowmem_vmpressure_level = VMPRESSURE_MEDIUM;
+static uint32_t lowmem_vmpressure_kills;
+static atomic_t lowmem_vmpressure_pending = ATOMIC_INIT(0);
+static DECLARE_WAIT_QUEUE_HEAD(lowmem_vmpressure_wait);
+static struct task_struct *lowmem_vmpressure_task;
+
+static int lowmem_vmpressure_notify(struct notifier_block *nb,
+				    unsigned long level, void *data)
+{
+	if (level < lowmem_vmpressure_level)
+		return NOTIFY_DONE;
+
+	atomic_set(&lowmem_vmpressure_pending, 1);
+	wake_up(&lowmem_vmpressure_wait);
+
+	return NOTIFY_OK;
+}
+
+static struct notifier_block lowmem_vmpressure_nb = {
+	.notifier_call = lowmem_vmpressure_notify,
+};
+
+static int lowmem_vmpressure_thread(void *data)
+{
+	struct sched_param param = { .sched_priority = 1 };
+	struct shrink_control sc = {
+		.gfp_mask = GFP_KERNEL,
+		.nr_to_scan = SWAP_CLUSTER_MAX,
+	};
+	unsigned long rem;
+
+	sched_setscheduler_nocheck(current, SCHED_FIFO, &param);
+	set_freezable();
+
+	while (!kthread_should_stop()) {
+		wait_event_freezable(lowmem_vmpressure_wait,
+				     atomic_read(&lowmem_vmpressure_pending) ||
+				     kthread_should_stop());
+
+		if (!atomic_xchg(&lowmem_vmpressure_pending, 0))
+			continue;
+
+		rem = lowmem_scan(&lowmem_shrinker, &sc);
+		if (rem && rem != SHRINK_STOP) {
+			lowmem_vmpressure_kills++;
+			lowmem_print(3, "vmpressure kill freed %lu pages\n", rem);
+		}
+	}
+
+	return 0;
+}
+
+static void __init lowmem_vmpressure_init(void)
+{
+	lowmem_vmpressure_task = kthread_run(lowmem_vmpressure_thread, NULL,
+					     "lmk_vmpressure");
+	if (IS_ERR(lowmem_vmpressure_task)) {
+		pr_err("failed to start vmpressure thread: %ld\n",
+		       PTR_ERR(lowmem_vmpressure_task));
+		lowmem_vmpressure_task = NULL;
+		return;
+	}
+
+	vmpressure_notifier_register(&lowmem_vmpressure_nb);
+}
+
+static void lowmem_vmpressure_exit(void)
+{
+	if (!lowmem_vmpressure_task)
+		return;
+
+	vmpressure_notifier_unregister(&lowmem_vmpressure_nb);
+	kthread_stop(lowmem_vmpressure_task);
+	lowmem_vmpressure_task = NULL;
+}
+#else
+static inline void lowmem_vmpressure_init(void) {}
+static inline void lowmem_vmpressure_exit(void) {}
+#endif
+
 static int __init lowmem_init(void)
 {
 #ifdef CONFIG_HIGHMEM
@@ -539,8 +1058,17 @@ static int __init lowmem_init(void)
 #endif
 
 
+	lmk_adj_index_init();
+	lowmem_debugfs_init();
+	lmk_reaper = kthread_run(lowmem_reaper_thread, NULL, "lmk_reaper");
+	if (IS_ERR(lmk_reaper)) {
+		pr_err("failed to start reaper thread: %ld\n",
+		       PTR_ERR(lmk_reaper));
+		lmk_reaper = NULL;
+	}
 	task_free_register(&task_nb);
 	register_shrinker(&lowmem_shrinker);
+	lowmem_vmpressure_init();
 
 #ifdef CONFIG_HIGHMEM
 	normal_pages = totalram_pages - totalhigh_pages;
@@ -554,7 +1082,10 @@ static int __init lowmem_init(void)
 
 static void __exit lowmem_exit(void)
 {
+	lowmem_vmpressure_exit();
 	unregister_shrinker(&lowmem_shrinker);
+	if (lmk_reaper)
+		kthread_stop(lmk_reaper);
 	task_free_unregister(&task_nb);
 }
 
@@ -653,28 +1184,30 @@ int get_min_free_pages(pid_t pid)
 	if (lowmem_minfree_size < array_size)
 		array_size = lowmem_minfree_size;
 
-	for_each_process(p) {
-		/* search pid */
-		if (p->pid == pid) {
-			task_lock(p);
-			target_oom_adj = p->signal->oom_score_adj;
-			task_unlock(p);
-			/* get min_free value of the pid */
-			for (i = array_size - 1; i >= 0; i--) {
-				if (target_oom_adj >= lowmem_adj[i]) {
-					pr_debug("pid: %d, target_oom_adj = %d, lowmem_adj[%d] = %d, lowmem_minfree[%d] = %d\n",
-							pid, target_oom_adj, i, lowmem_adj[i], i,
-							lowmem_minfree[i]);
-					return lowmem_minfree[i];
-				}
-			}
-			goto out;
+	/* look the pid up directly instead of walking every process */
+	rcu_read_lock();
+	p = find_task_by_vpid(pid);
+	if (!p) {
+		rcu_read_unlock();
+		lowmem_print(3, "[%s]pid: %d not found, lowmem_minfree = 0\n",
+				__func__, pid);
+		return 0;
+	}
+	target_oom_adj = p->signal->oom_score_adj;
+	rcu_read_unlock();
+
+	/* get min_free value of the pid */
+	for (i = array_size - 1; i >= 0; i--) {
+		if (target_oom_adj >= lowmem_adj[i]) {
+			pr_debug("pid: %d, target_oom_adj = %d, lowmem_adj[%d] = %d, lowmem_minfree[%d] = %d\n",
+					pid, target_oom_adj, i, lowmem_adj[i], i,
+					lowmem_minfree[i]);
+			return lowmem_minfree[i];
 		}
 	}
 
-out:
 	lowmem_print(3, "[%s]pid: %d, adj: %d, lowmem_minfree = 0\n",
-			__func__, pid, p->signal->oom_score_adj);
+			__func__, pid, target_oom_adj);
 	return 0;
 }
 EXPORT_SYMBOL(get_min_free_pages);
@@ -703,6 +1236,17 @@ size_t query_lmk_minfree(int index)
 }
 EXPORT_SYMBOL(query_lmk_minfree);
 
+/*
+ * Returns a counter that changes whenever LMK kills a process, so users
+ * caching results derived from the minfree levels and the process list
+ * (almk) can tell when to recompute them.
+ */
+unsigned int lowmem_kill_generation(void)
+{
+	return atomic_read(&lowmem_kill_gen);
+}
+EXPORT_SYMBOL(lowmem_kill_generation);
+
 module_param_named(cost, lowmem_shrinker.seeks, int, S_IRUGO | S_IWUSR);
 #ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_AUTODETECT_OOM_ADJ_VALUES
 module_param_cb(adj, &lowmem_adj_array_ops,
@@ -752,6 +1296,15 @@ module_param_cb(flm_warn_adj, &flm_warn_adj_ops, &lowmem_kernel_warn_adj, S_IRUG
 module_param_named(debug_adj, lowmem_debug_adj, short, S_IRUGO | S_IWUSR);
 #endif
 module_param_named(candidate_log, enable_candidate_log, uint, S_IRUGO | S_IWUSR);
+module_param_named(reap, lowmem_reap_enable, uint, S_IRUGO | S_IWUSR);
+module_param_named(reaped_pages, lowmem_reaped_pages, uint, S_IRUGO);
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+module_param_named(use_adj_index, lowmem_use_adj_index, uint, S_IRUGO | S_IWUSR);
+#endif
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_VMPRESSURE
+module_param_named(vmpressure_level, lowmem_vmpressure_level, uint, S_IRUGO | S_IWUSR);
+module_param_named(vmpressure_kills, lowmem_vmpressure_kills, uint, S_IRUGO);
+#endif
 
 late_initcall(lowmem_init);
 module_exit(lowmem_exit);
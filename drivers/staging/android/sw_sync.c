@@ -39,6 +39,8 @@ struct sync_pt *sw_sync_pt_create(struct sw_sync_timeline *obj, u32 value)
 
 	pt = (struct sw_sync_pt *)
 		sync_pt_create(&obj->obj, sizeof(struct sw_sync_pt));
+	if (pt == NULL)
+		return NULL;
 
 	pt->value = value;
 
@@ -118,6 +120,10 @@ struct sw_sync_timeline *sw_sync_timeline_create(const char *name)
 				     sizeof(struct sw_sync_timeline),
 				     name);
 
+	/* the counter only moves forward */
+	if (obj)
+		obj->obj.ordered = true;
+
 	return obj;
 }
 EXPORT_SYMBOL(sw_sync_timeline_create);
@@ -115,6 +115,9 @@ void sync_timeline_signal(struct sync_timeline *obj)
 				 active_list) {
 		if (fence_is_signaled_locked(&pt->base))
 			list_del_init(&pt->active_list);
+		else if (obj->ordered && !obj->destroyed)
+			/* the rest of the sorted list is later still */
+			break;
 	}
 
 	spin_unlock_irqrestore(&obj->child_list_lock, flags);
@@ -373,6 +376,11 @@ int sync_fence_wait(struct sync_fence *fence, long timeout)
 	long ret;
 	int i;
 
+	/* already signaled, skip the trace and wait queue setup */
+	ret = atomic_read(&fence->status);
+	if (ret <= 0)
+		goto done;
+
 	if (timeout < 0)
 		timeout = MAX_SCHEDULE_TIMEOUT;
 	else
@@ -398,6 +406,7 @@ int sync_fence_wait(struct sync_fence *fence, long timeout)
 	}
 
 	ret = atomic_read(&fence->status);
+done:
 	if (ret) {
 		pr_info("fence error %ld on [%p]\n", ret, fence);
 		sync_dump();
@@ -462,6 +471,19 @@ static bool android_fence_enable_signaling(struct fence *fence)
 	if (android_fence_signaled(fence))
 		return false;
 
+	if (parent->ordered) {
+		struct sync_pt *pos;
+
+		/* points mostly arrive in order, so search from the tail */
+		list_for_each_entry_reverse(pos, &parent->active_list_head,
+					    active_list) {
+			if (parent->ops->compare(pos, pt) <= 0)
+				break;
+		}
+		list_add(&pt->active_list, &pos->active_list);
+		return true;
+	}
+
 	list_add_tail(&pt->active_list, &parent->active_list_head);
 	return true;
 }
@@ -83,6 +83,8 @@ struct sync_timeline_ops {
  * @ops:		ops that define the implementation of the sync_timeline
  * @name:		name of the sync_timeline. Useful for debugging
  * @destroyed:		set when sync_timeline is destroyed
+ * @ordered:		points signal in @compare order, keeps @active_list_head
+ *			  sorted so a signal stops at the first pending point
  * @child_list_head:	list of children sync_pts for this sync_timeline
  * @child_list_lock:	lock protecting @child_list_head, destroyed, and
  *			  sync_pt.status
@@ -96,6 +98,7 @@ struct sync_timeline {
 
 	/* protected by child_list_lock */
 	bool			destroyed;
+	bool			ordered;
 	int			context, value;
 
 	struct list_head	child_list_head;
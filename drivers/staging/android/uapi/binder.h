@@ -37,6 +37,13 @@ enum {
 enum {
 	FLAT_BINDER_FLAG_PRIORITY_MASK = 0xff,
 	FLAT_BINDER_FLAG_ACCEPTS_FDS = 0x100,
+	/*
+	 * Minimum scheduling policy of the node.  With SCHED_FIFO or
+	 * SCHED_RR the priority mask holds the minimum rt priority that
+	 * synchronous transactions to the node run at, instead of a nice.
+	 */
+	FLAT_BINDER_FLAG_SCHED_POLICY_MASK = 3U << 9,
+	FLAT_BINDER_FLAG_SCHED_POLICY_SHIFT = 9,
 };
 
 #ifdef BINDER_IPC_32BIT
@@ -33,6 +33,7 @@
 
 #include <linux/usb.h>
 #include <linux/usb_usual.h>
+#include <linux/dma-mapping.h>
 #include <linux/usb/ch9.h>
 #include <linux/usb/f_mtp.h>
 
@@ -41,6 +42,9 @@
 
 #define MTP_BULK_BUFFER_SIZE       16384
 #define INTR_BUFFER_SIZE           28
+/* tried first, MTP_BULK_BUFFER_SIZE if the allocation fails */
+#define MTP_TX_BUFFER_INIT_SIZE    131072
+#define MTP_RX_BUFFER_INIT_SIZE    49152	/* the musb QMU takes up to 64K per OUT request */
 
 /* String IDs */
 #define INTERFACE_STRING_INDEX	0
@@ -58,6 +62,12 @@
 #define RX_REQ_MAX 2
 #define INTR_REQ_MAX 5
 
+/* bulk request sizes, used from the next bind */
+static unsigned int mtp_tx_req_len = MTP_TX_BUFFER_INIT_SIZE;
+module_param(mtp_tx_req_len, uint, S_IRUGO | S_IWUSR);
+static unsigned int mtp_rx_req_len = MTP_RX_BUFFER_INIT_SIZE;
+module_param(mtp_rx_req_len, uint, S_IRUGO | S_IWUSR);
+
 /* ID for Microsoft MTP OS String */
 #define MTP_OS_STRING_ID   0xEE
 
@@ -137,6 +147,10 @@ struct mtp_dev {
 	wait_queue_head_t intr_wq;
 	struct usb_request *rx_req[RX_REQ_MAX];
 	int rx_done;
+	/* bulk request buffers, mapped once for the UDC when dma_dev is set */
+	unsigned tx_req_len;
+	unsigned rx_req_len;
+	struct device *dma_dev;
 
 	/* for processing MTP_SEND_FILE, MTP_RECEIVE_FILE and
 	 * MTP_SEND_FILE_WITH_HEADER ioctls on a work queue
@@ -643,7 +657,13 @@ static inline struct mtp_dev *func_to_mtp(struct usb_function *f)
 	return container_of(f, struct mtp_dev, function);
 }
 
-static struct usb_request *mtp_request_new(struct usb_ep *ep, int buffer_size)
+/*
+ * With @dma_dev the buffer is mapped here for the whole life of the
+ * request, and the UDC only syncs what each transfer uses instead of
+ * mapping and unmapping it every time.
+ */
+static struct usb_request *mtp_request_new(struct usb_ep *ep, int buffer_size,
+		struct device *dma_dev, enum dma_data_direction dir)
 {
 	struct usb_request *req = usb_ep_alloc_request(ep, GFP_KERNEL);
 	if (!req)
@@ -651,21 +671,35 @@ static struct usb_request *mtp_request_new(struct usb_ep *ep, int buffer_size)
 
 	/* now allocate buffers for the requests */
 #if defined(CONFIG_64BIT) && defined(CONFIG_MTK_LM_MODE)
-	req->buf = kmalloc(buffer_size, GFP_KERNEL | GFP_DMA);
+	req->buf = kmalloc(buffer_size, GFP_KERNEL | GFP_DMA | __GFP_NOWARN);
 #else
-	req->buf = kmalloc(buffer_size, GFP_KERNEL);
+	req->buf = kmalloc(buffer_size, GFP_KERNEL | __GFP_NOWARN);
 #endif
 	if (!req->buf) {
 		usb_ep_free_request(ep, req);
 		return NULL;
 	}
 
+	if (dma_dev) {
+		dma_addr_t dma = dma_map_single(dma_dev, req->buf, buffer_size, dir);
+
+		if (dma_mapping_error(dma_dev, dma)) {
+			kfree(req->buf);
+			usb_ep_free_request(ep, req);
+			return NULL;
+		}
+		req->dma = dma;
+	}
+
 	return req;
 }
 
-static void mtp_request_free(struct usb_request *req, struct usb_ep *ep)
+static void mtp_request_free(struct usb_request *req, struct usb_ep *ep,
+		int buffer_size, struct device *dma_dev, enum dma_data_direction dir)
 {
 	if (req) {
+		if (dma_dev)
+			dma_unmap_single(dma_dev, req->dma, buffer_size, dir);
 		kfree(req->buf);
 		usb_ep_free_request(ep, req);
 	}
@@ -715,6 +749,26 @@ static struct usb_request
 	return req;
 }
 
+static void mtp_free_tx_reqs(struct mtp_dev *dev)
+{
+	struct usb_request *req;
+
+	while ((req = mtp_req_get(dev, &dev->tx_idle)))
+		mtp_request_free(req, dev->ep_in, dev->tx_req_len,
+				 dev->dma_dev, DMA_TO_DEVICE);
+}
+
+static void mtp_free_rx_reqs(struct mtp_dev *dev)
+{
+	int i;
+
+	for (i = 0; i < RX_REQ_MAX; i++) {
+		mtp_request_free(dev->rx_req[i], dev->ep_out, dev->rx_req_len,
+				 dev->dma_dev, DMA_FROM_DEVICE);
+		dev->rx_req[i] = NULL;
+	}
+}
+
 static void mtp_complete_in(struct usb_ep *ep, struct usb_request *req)
 {
 	struct mtp_dev *dev = _mtp_dev;
@@ -790,22 +844,39 @@ static int mtp_create_bulk_endpoints(struct mtp_dev *dev,
 	dev->ep_intr = ep;
 
 	/* now allocate requests for our endpoints */
+	dev->dma_dev = cdev->gadget->dev.parent;
+	dev->tx_req_len = max(mtp_tx_req_len, (unsigned)MTP_BULK_BUFFER_SIZE);
+	dev->rx_req_len = max(mtp_rx_req_len, (unsigned)MTP_BULK_BUFFER_SIZE);
+retry_tx_alloc:
 	for (i = 0; i < TX_REQ_MAX; i++) {
-		req = mtp_request_new(dev->ep_in, MTP_BULK_BUFFER_SIZE);
-		if (!req)
-			goto fail;
+		req = mtp_request_new(dev->ep_in, dev->tx_req_len,
+				      dev->dma_dev, DMA_TO_DEVICE);
+		if (!req) {
+			if (dev->tx_req_len <= MTP_BULK_BUFFER_SIZE)
+				goto fail;
+			mtp_free_tx_reqs(dev);
+			dev->tx_req_len = MTP_BULK_BUFFER_SIZE;
+			goto retry_tx_alloc;
+		}
 		req->complete = mtp_complete_in;
 		mtp_req_put(dev, &dev->tx_idle, req);
 	}
+retry_rx_alloc:
 	for (i = 0; i < RX_REQ_MAX; i++) {
-		req = mtp_request_new(dev->ep_out, MTP_BULK_BUFFER_SIZE);
-		if (!req)
-			goto fail;
+		req = mtp_request_new(dev->ep_out, dev->rx_req_len,
+				      dev->dma_dev, DMA_FROM_DEVICE);
+		if (!req) {
+			if (dev->rx_req_len <= MTP_BULK_BUFFER_SIZE)
+				goto fail;
+			mtp_free_rx_reqs(dev);
+			dev->rx_req_len = MTP_BULK_BUFFER_SIZE;
+			goto retry_rx_alloc;
+		}
 		req->complete = mtp_complete_out;
 		dev->rx_req[i] = req;
 	}
 	for (i = 0; i < INTR_REQ_MAX; i++) {
-		req = mtp_request_new(dev->ep_intr, INTR_BUFFER_SIZE);
+		req = mtp_request_new(dev->ep_intr, INTR_BUFFER_SIZE, NULL, DMA_NONE);
 		if (!req)
 			goto fail;
 		req->complete = mtp_complete_intr;
@@ -879,7 +950,7 @@ static ssize_t mtp_read(struct file *fp, char __user *buf,
 
 	DBG(cdev, "mtp_read(%zu)\n", count);
 
-	if (count > MTP_BULK_BUFFER_SIZE)
+	if (count > dev->rx_req_len)
 		return -EINVAL;
 
 	if (dev->epOut_halt) {
@@ -1060,8 +1131,8 @@ static ssize_t mtp_write(struct file *fp, const char __user *buf,
 			break;
 		}
 
-		if (count > MTP_BULK_BUFFER_SIZE)
-			xfer = MTP_BULK_BUFFER_SIZE;
+		if (count > dev->tx_req_len)
+			xfer = dev->tx_req_len;
 		else
 			xfer = count;
 		if (xfer && copy_from_user(req->buf, buf, xfer)) {
@@ -1168,8 +1239,8 @@ static void send_file_work(struct work_struct *data)
 			break;
 		}
 
-		if (count > MTP_BULK_BUFFER_SIZE)
-			xfer = MTP_BULK_BUFFER_SIZE;
+		if (count > dev->tx_req_len)
+			xfer = dev->tx_req_len;
 		else
 			xfer = count;
 
@@ -1310,8 +1381,8 @@ static void receive_file_work(struct work_struct *data)
 			read_req = dev->rx_req[cur_buf];
 			cur_buf = (cur_buf + 1) % RX_REQ_MAX;
 
-			read_req->length = (count > MTP_BULK_BUFFER_SIZE
-					? MTP_BULK_BUFFER_SIZE : count);
+			read_req->length = (count > dev->rx_req_len
+					? dev->rx_req_len : count);
 
 
 		/* This might be modified TBD,
@@ -2117,15 +2188,12 @@ mtp_function_unbind(struct usb_configuration *c, struct usb_function *f)
 {
 	struct mtp_dev	*dev = func_to_mtp(f);
 	struct usb_request *req;
-	int i;
 	printk("%s, line %d: \n", __func__, __LINE__);
 
-	while ((req = mtp_req_get(dev, &dev->tx_idle)))
-		mtp_request_free(req, dev->ep_in);
-	for (i = 0; i < RX_REQ_MAX; i++)
-		mtp_request_free(dev->rx_req[i], dev->ep_out);
+	mtp_free_tx_reqs(dev);
+	mtp_free_rx_reqs(dev);
 	while ((req = mtp_req_get(dev, &dev->intr_idle)))
-		mtp_request_free(req, dev->ep_intr);
+		mtp_request_free(req, dev->ep_intr, INTR_BUFFER_SIZE, NULL, DMA_NONE);
 	dev->state = STATE_OFFLINE;
 	dev->dev_disconnected = 1;
 }
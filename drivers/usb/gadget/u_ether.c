@@ -702,6 +702,22 @@ static inline int is_promisc(u16 cdc_filter)
 	return cdc_filter & USB_CDC_PACKET_TYPE_PROMISCUOUS;
 }
 
+/*
+ * Frames to put in one DL transfer.  None are held while the UDC keeps up
+ * with TX_REQ_THRESHOLD requests; past that, the deeper the backlog the
+ * more frames go in each request, up to dl_max_pkts_per_xfer.  A held
+ * request is sent by tx_complete() when one of the queued ones is done.
+ * Called with req_lock held.
+ */
+static inline unsigned int tx_aggr_pkts(struct eth_dev *dev)
+{
+	int backlog = dev->no_tx_req_used - TX_REQ_THRESHOLD;
+
+	if (backlog <= 0)
+		return 1;
+	return min_t(unsigned int, dev->dl_max_pkts_per_xfer, backlog + 1);
+}
+
 static int alloc_tx_buffer(struct eth_dev *dev)
 {
 	struct list_head	*act;
@@ -893,14 +909,11 @@ static netdev_tx_t eth_start_xmit(struct sk_buff *skb,
 
 		spin_lock_irqsave(&dev->req_lock, flags);
 		dev->tx_skb_hold_count++;
-		/* if (dev->tx_skb_hold_count < dev->dl_max_pkts_per_xfer) { */
-		if ((dev->tx_skb_hold_count < dev->dl_max_pkts_per_xfer)
+		if ((dev->tx_skb_hold_count < tx_aggr_pkts(dev))
 			&& (length < (max_size - dev->net->mtu))) {
-			if (dev->no_tx_req_used > TX_REQ_THRESHOLD) {
-				list_add(&req->list, &dev->tx_reqs);
-				spin_unlock_irqrestore(&dev->req_lock, flags);
-				goto success;
-			}
+			list_add(&req->list, &dev->tx_reqs);
+			spin_unlock_irqrestore(&dev->req_lock, flags);
+			goto success;
 		}
 
 		dev->no_tx_req_used++;
@@ -31,6 +31,7 @@
 #include <linux/mempool.h>
 #include <linux/module.h>
 #include <linux/mutex.h>
+#include <linux/percpu.h>
 #include <linux/random.h>
 #include <linux/scatterlist.h>
 #include <linux/spinlock_types.h>
@@ -58,6 +59,94 @@ static DEFINE_SPINLOCK(ext4_crypto_ctx_lock);
 static struct kmem_cache *ext4_crypto_ctx_cachep;
 struct kmem_cache *ext4_crypt_info_cachep;
 
+/*
+ * Contexts and bounce pages are taken and released once per page on the
+ * read and write paths, from several cpus at once.  Keep a few of each per
+ * cpu so that the global list and the mempool are only touched when a cpu
+ * runs out.  Release can happen from bio completion, hence the irq
+ * disabling.
+ */
+#define EXT4_CPU_CACHE_CTXS	16
+#define EXT4_CPU_CACHE_PAGES	16
+
+struct ext4_crypto_cpu_cache {
+	struct list_head ctxs;
+	unsigned int nr_ctxs;
+	unsigned int nr_pages;
+	struct page *pages[EXT4_CPU_CACHE_PAGES];
+};
+
+static DEFINE_PER_CPU(struct ext4_crypto_cpu_cache, ext4_crypto_cpu_cache);
+
+static struct ext4_crypto_ctx *ext4_cpu_get_ctx(void)
+{
+	struct ext4_crypto_cpu_cache *cc;
+	struct ext4_crypto_ctx *ctx;
+	unsigned long flags;
+
+	local_irq_save(flags);
+	cc = this_cpu_ptr(&ext4_crypto_cpu_cache);
+	ctx = list_first_entry_or_null(&cc->ctxs, struct ext4_crypto_ctx,
+				       free_list);
+	if (ctx) {
+		list_del(&ctx->free_list);
+		cc->nr_ctxs--;
+	}
+	local_irq_restore(flags);
+	return ctx;
+}
+
+static bool ext4_cpu_put_ctx(struct ext4_crypto_ctx *ctx)
+{
+	struct ext4_crypto_cpu_cache *cc;
+	unsigned long flags;
+	bool cached = false;
+
+	local_irq_save(flags);
+	cc = this_cpu_ptr(&ext4_crypto_cpu_cache);
+	if (cc->nr_ctxs < EXT4_CPU_CACHE_CTXS) {
+		list_add(&ctx->free_list, &cc->ctxs);
+		cc->nr_ctxs++;
+		cached = true;
+	}
+	local_irq_restore(flags);
+	return cached;
+}
+
+static struct page *ext4_alloc_bounce_page(void)
+{
+	struct ext4_crypto_cpu_cache *cc;
+	struct page *page = NULL;
+	unsigned long flags;
+
+	local_irq_save(flags);
+	cc = this_cpu_ptr(&ext4_crypto_cpu_cache);
+	if (cc->nr_pages)
+		page = cc->pages[--cc->nr_pages];
+	local_irq_restore(flags);
+
+	if (!page)
+		page = mempool_alloc(ext4_bounce_page_pool, GFP_NOWAIT);
+	return page;
+}
+
+static void ext4_free_bounce_page(struct page *page)
+{
+	struct ext4_crypto_cpu_cache *cc;
+	unsigned long flags;
+
+	local_irq_save(flags);
+	cc = this_cpu_ptr(&ext4_crypto_cpu_cache);
+	if (cc->nr_pages < EXT4_CPU_CACHE_PAGES) {
+		cc->pages[cc->nr_pages++] = page;
+		page = NULL;
+	}
+	local_irq_restore(flags);
+
+	if (page)
+		mempool_free(page, ext4_bounce_page_pool);
+}
+
 /**
  * ext4_release_crypto_ctx() - Releases an encryption context
  * @ctx: The encryption context to release.
@@ -72,9 +161,11 @@ void ext4_release_crypto_ctx(struct ext4_crypto_ctx *ctx)
 	unsigned long flags;
 
 	if (ctx->flags & EXT4_WRITE_PATH_FL && ctx->w.bounce_page)
-		mempool_free(ctx->w.bounce_page, ext4_bounce_page_pool);
+		ext4_free_bounce_page(ctx->w.bounce_page);
 	ctx->w.bounce_page = NULL;
 	ctx->w.control_page = NULL;
+	if (ext4_cpu_put_ctx(ctx))
+		return;
 	if (ctx->flags & EXT4_CTX_REQUIRES_FREE_ENCRYPT_FL) {
 		kmem_cache_free(ext4_crypto_ctx_cachep, ctx);
 	} else {
@@ -88,7 +179,8 @@ void ext4_release_crypto_ctx(struct ext4_crypto_ctx *ctx)
  * ext4_get_crypto_ctx() - Gets an encryption context
  * @inode:       The inode for which we are doing the crypto
  *
- * Allocates and initializes an encryption context.
+ * Allocates and initializes an encryption context.  Contexts are
+ * interchangeable, so one cached on this cpu is used first.
  *
  * Return: An allocated and initialized encryption context on success; error
  * value or NULL otherwise.
@@ -113,6 +205,9 @@ struct ext4_crypto_ctx *ext4_get_crypto_ctx(struct inode *inode)
 	 * should generally be a "last resort" option for a filesystem
 	 * to be able to do its job.
 	 */
+	ctx = ext4_cpu_get_ctx();
+	if (ctx)
+		goto got_ctx;
 	spin_lock_irqsave(&ext4_crypto_ctx_lock, flags);
 	ctx = list_first_entry_or_null(&ext4_free_crypto_ctxs,
 				       struct ext4_crypto_ctx, free_list);
@@ -129,6 +224,7 @@ struct ext4_crypto_ctx *ext4_get_crypto_ctx(struct inode *inode)
 	} else {
 		ctx->flags &= ~EXT4_CTX_REQUIRES_FREE_ENCRYPT_FL;
 	}
+got_ctx:
 	ctx->flags &= ~EXT4_WRITE_PATH_FL;
 
 out:
@@ -149,7 +245,22 @@ static DEFINE_MUTEX(crypto_init);
 void ext4_exit_crypto(void)
 {
 	struct ext4_crypto_ctx *pos, *n;
-
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct ext4_crypto_cpu_cache *cc =
+			per_cpu_ptr(&ext4_crypto_cpu_cache, cpu);
+
+		if (!cc->ctxs.next)
+			continue;
+		list_for_each_entry_safe(pos, n, &cc->ctxs, free_list)
+			kmem_cache_free(ext4_crypto_ctx_cachep, pos);
+		INIT_LIST_HEAD(&cc->ctxs);
+		cc->nr_ctxs = 0;
+		while (cc->nr_pages)
+			mempool_free(cc->pages[--cc->nr_pages],
+				     ext4_bounce_page_pool);
+	}
 	list_for_each_entry_safe(pos, n, &ext4_free_crypto_ctxs, free_list)
 		kmem_cache_free(ext4_crypto_ctx_cachep, pos);
 	INIT_LIST_HEAD(&ext4_free_crypto_ctxs);
@@ -177,11 +288,13 @@ void ext4_exit_crypto(void)
  */
 int ext4_init_crypto(void)
 {
-	int i, res = -ENOMEM;
+	int i, cpu, res = -ENOMEM;
 
 	mutex_lock(&crypto_init);
 	if (ext4_read_workqueue)
 		goto already_initialized;
+	for_each_possible_cpu(cpu)
+		INIT_LIST_HEAD(&per_cpu_ptr(&ext4_crypto_cpu_cache, cpu)->ctxs);
 	ext4_read_workqueue = alloc_workqueue("ext4_crypto", WQ_HIGHPRI, 0);
 	if (!ext4_read_workqueue)
 		goto fail;
@@ -253,29 +366,34 @@ typedef enum {
 	EXT4_ENCRYPT,
 } ext4_direction_t;
 
-static int ext4_page_crypto(struct ext4_crypto_ctx *ctx,
-			    struct inode *inode,
-			    ext4_direction_t rw,
-			    pgoff_t index,
-			    struct page *src_page,
-			    struct page *dest_page)
+static struct ablkcipher_request *ext4_crypto_req_alloc(struct inode *inode)
+{
+	struct ext4_crypt_info *ci = EXT4_I(inode)->i_crypt_info;
+	struct ablkcipher_request *req;
 
+	req = ablkcipher_request_alloc(ci->ci_ctfm, GFP_NOFS);
+	if (!req)
+		printk_ratelimited(KERN_ERR
+				   "%s: crypto_request_alloc() failed\n",
+				   __func__);
+	return req;
+}
+
+/*
+ * Each page has its own XTS tweak, so a page is one cipher operation; the
+ * request itself can be reused for every page of a bio.
+ */
+static int __ext4_page_crypto(struct ablkcipher_request *req,
+			      ext4_direction_t rw,
+			      pgoff_t index,
+			      struct page *src_page,
+			      struct page *dest_page)
 {
 	u8 xts_tweak[EXT4_XTS_TWEAK_SIZE];
-	struct ablkcipher_request *req = NULL;
 	DECLARE_EXT4_COMPLETION_RESULT(ecr);
 	struct scatterlist dst, src;
-	struct ext4_crypt_info *ci = EXT4_I(inode)->i_crypt_info;
-	struct crypto_ablkcipher *tfm = ci->ci_ctfm;
 	int res = 0;
 
-	req = ablkcipher_request_alloc(tfm, GFP_NOFS);
-	if (!req) {
-		printk_ratelimited(KERN_ERR
-				   "%s: crypto_request_alloc() failed\n",
-				   __func__);
-		return -ENOMEM;
-	}
 	ablkcipher_request_set_callback(
 		req, CRYPTO_TFM_REQ_MAY_BACKLOG | CRYPTO_TFM_REQ_MAY_SLEEP,
 		ext4_crypt_complete, &ecr);
@@ -300,7 +418,6 @@ static int ext4_page_crypto(struct ext4_crypto_ctx *ctx,
 		wait_for_completion(&ecr.completion);
 		res = ecr.res;
 	}
-	ablkcipher_request_free(req);
 	if (res) {
 		printk_ratelimited(
 			KERN_ERR
@@ -311,9 +428,28 @@ static int ext4_page_crypto(struct ext4_crypto_ctx *ctx,
 	return 0;
 }
 
+static int ext4_page_crypto(struct ext4_crypto_ctx *ctx,
+			    struct inode *inode,
+			    ext4_direction_t rw,
+			    pgoff_t index,
+			    struct page *src_page,
+			    struct page *dest_page)
+
+{
+	struct ablkcipher_request *req;
+	int res;
+
+	req = ext4_crypto_req_alloc(inode);
+	if (!req)
+		return -ENOMEM;
+	res = __ext4_page_crypto(req, rw, index, src_page, dest_page);
+	ablkcipher_request_free(req);
+	return res;
+}
+
 static struct page *alloc_bounce_page(struct ext4_crypto_ctx *ctx)
 {
-	ctx->w.bounce_page = mempool_alloc(ext4_bounce_page_pool, GFP_NOWAIT);
+	ctx->w.bounce_page = ext4_alloc_bounce_page();
 	if (ctx->w.bounce_page == NULL)
 		return ERR_PTR(-ENOMEM);
 	ctx->flags |= EXT4_WRITE_PATH_FL;
@@ -386,6 +522,43 @@ int ext4_decrypt(struct ext4_crypto_ctx *ctx, struct page *page)
 				EXT4_DECRYPT, page->index, page, page);
 }
 
+/**
+ * ext4_decrypt_bio_pages() - Decrypts all pages of a read bio in-place
+ * @ctx: The encryption context.
+ * @bio: The bio whose pages, all locked and of one inode, were just read.
+ *
+ * Marks each page uptodate or in error and unlocks it.  One cipher request
+ * is used for the whole bio.
+ *
+ * Called from the read completion work.
+ */
+void ext4_decrypt_bio_pages(struct ext4_crypto_ctx *ctx, struct bio *bio)
+{
+	struct ablkcipher_request *req;
+	struct bio_vec *bv;
+	int i;
+
+	req = ext4_crypto_req_alloc(bio->bi_io_vec[0].bv_page->mapping->host);
+
+	bio_for_each_segment_all(bv, bio, i) {
+		struct page *page = bv->bv_page;
+		int ret = -ENOMEM;
+
+		if (req)
+			ret = __ext4_page_crypto(req, EXT4_DECRYPT,
+						 page->index, page, page);
+		if (ret) {
+			WARN_ON_ONCE(1);
+			SetPageError(page);
+		} else
+			SetPageUptodate(page);
+		unlock_page(page);
+	}
+
+	if (req)
+		ablkcipher_request_free(req);
+}
+
 /*
  * Convenience function which takes care of allocating and
  * deallocating the encryption context
@@ -407,6 +580,7 @@ int ext4_encrypted_zeroout(struct inode *inode, struct ext4_extent *ex)
 {
 	struct ext4_crypto_ctx	*ctx;
 	struct page		*ciphertext_page = NULL;
+	struct ablkcipher_request *req = NULL;
 	struct bio		*bio;
 	ext4_lblk_t		lblk = ex->ee_block;
 	ext4_fsblk_t		pblk = ext4_ext_pblock(ex);
@@ -425,9 +599,15 @@ int ext4_encrypted_zeroout(struct inode *inode, struct ext4_extent *ex)
 		goto errout;
 	}
 
+	req = ext4_crypto_req_alloc(inode);
+	if (!req) {
+		err = -ENOMEM;
+		goto errout;
+	}
+
 	while (len--) {
-		err = ext4_page_crypto(ctx, inode, EXT4_ENCRYPT, lblk,
-				       ZERO_PAGE(0), ciphertext_page);
+		err = __ext4_page_crypto(req, EXT4_ENCRYPT, lblk,
+					 ZERO_PAGE(0), ciphertext_page);
 		if (err)
 			goto errout;
 
@@ -451,6 +631,8 @@ int ext4_encrypted_zeroout(struct inode *inode, struct ext4_extent *ex)
 	}
 	err = 0;
 errout:
+	if (req)
+		ablkcipher_request_free(req);
 	ext4_release_crypto_ctx(ctx);
 	return err;
 }
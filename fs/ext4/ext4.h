@@ -898,6 +898,10 @@ struct ext4_inode_info {
 	/* mballoc */
 	struct list_head i_prealloc_list;
 	spinlock_t i_prealloc_lock;
+	/* append detection, protected by i_data_sem */
+	ext4_lblk_t i_mb_stream_last;	/* start of the last request */
+	ext4_lblk_t i_mb_stream_next;	/* end of its normalized window */
+	unsigned int i_mb_stream_streak; /* appends in a row */
 
 	/* extents status tree */
 	struct ext4_es_tree i_es_tree;
@@ -906,6 +910,7 @@ struct ext4_inode_info {
 	unsigned int i_es_all_nr;	/* protected by i_es_lock */
 	unsigned int i_es_lru_nr;	/* protected by i_es_lock */
 	unsigned long i_touch_when;	/* jiffies of last accessing */
+	ext4_lblk_t i_es_shrink_lblk;	/* where the shrinker resumes */
 
 	/* ialloc */
 	ext4_group_t	i_last_alloc_group;
@@ -1303,6 +1308,7 @@ struct ext4_sb_info {
 	unsigned int s_mb_stats;
 	unsigned int s_mb_order2_reqs;
 	unsigned int s_mb_group_prealloc;
+	unsigned int s_mb_stream_prealloc;
 	unsigned int s_max_dir_size_kb;
 	/* where last allocation was done - for stream allocation */
 	unsigned long s_mb_last_group;
@@ -2066,6 +2072,7 @@ void ext4_restore_control_page(struct page *data_page);
 struct page *ext4_encrypt(struct inode *inode,
 			  struct page *plaintext_page);
 int ext4_decrypt(struct ext4_crypto_ctx *ctx, struct page *page);
+void ext4_decrypt_bio_pages(struct ext4_crypto_ctx *ctx, struct bio *bio);
 int ext4_decrypt_one(struct inode *inode, struct page *page);
 int ext4_encrypted_zeroout(struct inode *inode, struct ext4_extent *ex);
 
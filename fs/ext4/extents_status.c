@@ -1268,6 +1268,7 @@ static int __es_try_to_reclaim_extents(struct ext4_inode_info *ei,
 	struct rb_node *node;
 	struct extent_status *es;
 	unsigned long nr_shrunk = 0;
+	ext4_lblk_t start = ei->i_es_shrink_lblk;
 	static DEFINE_RATELIMIT_STATE(_rs, DEFAULT_RATELIMIT_INTERVAL,
 				      DEFAULT_RATELIMIT_BURST);
 
@@ -1278,7 +1279,17 @@ static int __es_try_to_reclaim_extents(struct ext4_inode_info *ei,
 	    __ratelimit(&_rs))
 		ext4_warning(inode->i_sb, "forced shrink of precached extents");
 
-	node = rb_first(&tree->root);
+	/*
+	 * Resume where the previous pass on this inode stopped, so that a
+	 * large inode is shrunk round-robin instead of rescanning (and
+	 * re-reclaiming) its head, and the delayed extents there, each time.
+	 */
+	es = __es_tree_search(&tree->root, start);
+	node = es ? &es->rb_node : NULL;
+	if (!node) {
+		node = rb_first(&tree->root);
+		start = 0;
+	}
 	while (node != NULL) {
 		es = rb_entry(node, struct extent_status, rb_node);
 		node = rb_next(&es->rb_node);
@@ -1293,7 +1304,18 @@ static int __es_try_to_reclaim_extents(struct ext4_inode_info *ei,
 			if (--nr_to_scan == 0)
 				break;
 		}
+		/* wrap around once to the part before where we started */
+		if (!node && start) {
+			node = rb_first(&tree->root);
+			start = 0;
+		} else if (node && !start && ei->i_es_shrink_lblk &&
+			   rb_entry(node, struct extent_status,
+				    rb_node)->es_lblk >= ei->i_es_shrink_lblk) {
+			node = NULL;
+		}
 	}
+	ei->i_es_shrink_lblk = node ?
+		rb_entry(node, struct extent_status, rb_node)->es_lblk : 0;
 	tree->cache_es = NULL;
 	return nr_shrunk;
 }
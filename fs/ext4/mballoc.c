@@ -2598,6 +2598,7 @@ int ext4_mb_init(struct super_block *sb)
 	sbi->s_mb_min_to_scan = MB_DEFAULT_MIN_TO_SCAN;
 	sbi->s_mb_stats = MB_DEFAULT_STATS;
 	sbi->s_mb_stream_request = MB_DEFAULT_STREAM_THRESHOLD;
+	sbi->s_mb_stream_prealloc = MB_DEFAULT_STREAM_PREALLOC;
 	sbi->s_mb_order2_reqs = MB_DEFAULT_ORDER2_REQS;
 	/*
 	 * The default group preallocation is 512, which for 4k block
@@ -3085,6 +3086,37 @@ ext4_mb_normalize_request(struct ext4_allocation_context *ac,
 	size = size >> bsbits;
 	start = start_off >> bsbits;
 
+	/*
+	 * A file growing by appends (a camera recording, say) comes back
+	 * here each time the window preallocated for it is used up, with a
+	 * request inside that window.  Preallocate a larger window ahead of
+	 * the write pointer for every such request in a row, so the file
+	 * keeps getting large contiguous extents.  The unused part goes back
+	 * when the file is closed, like any inode preallocation.
+	 */
+	if (ac->ac_o_ex.fe_logical > ei->i_mb_stream_last &&
+	    ac->ac_o_ex.fe_logical <= ei->i_mb_stream_next) {
+		if (ei->i_mb_stream_streak < MB_STREAM_MAX_SHIFT)
+			ei->i_mb_stream_streak++;
+	} else {
+		ei->i_mb_stream_streak = 0;
+	}
+	ei->i_mb_stream_last = ac->ac_o_ex.fe_logical;
+
+	if (ei->i_mb_stream_streak && sbi->s_mb_stream_prealloc &&
+	    size >= (2 << (20 - bsbits))) {
+		ext4_lblk_t window;
+
+		window = min_t(ext4_lblk_t, size << ei->i_mb_stream_streak,
+			       sbi->s_mb_stream_prealloc);
+		window = min_t(ext4_lblk_t, window,
+			       EXT4_BLOCKS_PER_GROUP(ac->ac_sb));
+		if (window > size) {
+			start = ac->ac_o_ex.fe_logical;
+			size = window;
+		}
+	}
+
 	/* don't cover already allocated blocks in selected range */
 	if (ar->pleft && start <= ar->lleft) {
 		size -= ar->lleft + 1 - start;
@@ -3160,6 +3192,8 @@ ext4_mb_normalize_request(struct ext4_allocation_context *ac,
 	}
 	BUG_ON(size <= 0 || size > EXT4_BLOCKS_PER_GROUP(ac->ac_sb));
 
+	ei->i_mb_stream_next = start + size;
+
 	/* now prepare goal request */
 
 	/* XXX: is it better to align blocks WRT to logical
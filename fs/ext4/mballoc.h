@@ -89,6 +89,13 @@ extern ushort ext4_mballoc_debug;
  */
 #define MB_DEFAULT_GROUP_PREALLOC	512
 
+/*
+ * largest window preallocated ahead of a file that keeps growing by
+ * appends (8192 blocks, 32MB with 4k blocks); 0 disables
+ */
+#define MB_DEFAULT_STREAM_PREALLOC	8192
+#define MB_STREAM_MAX_SHIFT		4
+
 
 struct ext4_free_data {
 	/* MUST be the first member */
@@ -47,8 +47,8 @@
 #include "ext4.h"
 
 /*
- * Call ext4_decrypt on every single page, reusing the encryption
- * context.
+ * Decrypt every page of the bio in place, reusing the encryption
+ * context and a single cipher request.
  */
 static void completion_pages(struct work_struct *work)
 {
@@ -56,20 +56,8 @@ static void completion_pages(struct work_struct *work)
 	struct ext4_crypto_ctx *ctx =
 		container_of(work, struct ext4_crypto_ctx, r.work);
 	struct bio	*bio	= ctx->r.bio;
-	struct bio_vec	*bv;
-	int		i;
 
-	bio_for_each_segment_all(bv, bio, i) {
-		struct page *page = bv->bv_page;
-
-		int ret = ext4_decrypt(ctx, page);
-		if (ret) {
-			WARN_ON_ONCE(1);
-			SetPageError(page);
-		} else
-			SetPageUptodate(page);
-		unlock_page(page);
-	}
+	ext4_decrypt_bio_pages(ctx, bio);
 	ext4_release_crypto_ctx(ctx);
 	bio_put(bio);
 #else
@@ -254,6 +254,15 @@ ino_t f2fs_inode_by_name(struct inode *dir, struct qstr *qstr)
 	return res;
 }
 
+/*
+ * Record that dir has dentries not covered by the last checkpoint, which
+ * fsync of the directory cannot recover by roll-forward.
+ */
+static inline void mark_dentry_changed(struct inode *dir)
+{
+	F2FS_I(dir)->dentry_ver = cur_cp_version(F2FS_CKPT(F2FS_I_SB(dir)));
+}
+
 void f2fs_set_link(struct inode *dir, struct f2fs_dir_entry *de,
 		struct page *page, struct inode *inode)
 {
@@ -265,6 +274,7 @@ void f2fs_set_link(struct inode *dir, struct f2fs_dir_entry *de,
 	set_page_dirty(page);
 	dir->i_mtime = dir->i_ctime = CURRENT_TIME;
 	mark_inode_dirty(dir);
+	mark_dentry_changed(dir);
 
 	f2fs_put_page(page, 1);
 }
@@ -407,6 +417,7 @@ static void update_parent_metadata(struct inode *dir, struct inode *inode,
 	}
 	dir->i_mtime = dir->i_ctime = CURRENT_TIME;
 	mark_inode_dirty(dir);
+	mark_dentry_changed(dir);
 
 	if (F2FS_I(dir)->i_current_depth != current_depth) {
 		F2FS_I(dir)->i_current_depth = current_depth;
@@ -589,6 +600,7 @@ void f2fs_delete_entry(struct f2fs_dir_entry *dentry, struct page *page,
 	set_page_dirty(page);
 
 	dir->i_ctime = dir->i_mtime = CURRENT_TIME;
+	mark_dentry_changed(dir);
 
 	if (inode) {
 		struct f2fs_sb_info *sbi = F2FS_I_SB(dir);
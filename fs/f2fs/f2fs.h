@@ -19,6 +19,7 @@
 #include <linux/magic.h>
 #include <linux/kobject.h>
 #include <linux/sched.h>
+#include <linux/rbtree.h>
 
 #ifdef CONFIG_F2FS_CHECK_FS
 #define f2fs_bug_on(sbi, condition)	BUG_ON(condition)
@@ -266,6 +267,7 @@ struct f2fs_inode_info {
 	unsigned int clevel;		/* maximum level of given file name */
 	nid_t i_xattr_nid;		/* node id that contains xattrs */
 	unsigned long long xattr_ver;	/* cp version of xattr modification */
+	unsigned long long dentry_ver;	/* cp version of dentry modification */
 	struct extent_info ext;		/* in-memory extent cache entry */
 	struct dir_inode_entry *dirty_dir;	/* the pointer of dirty dir */
 
@@ -385,6 +387,29 @@ struct flush_cmd_control {
 	struct llist_node *dispatch_list;	/* list for command dispatch */
 };
 
+/* a range of freed blocks waiting for the discard thread */
+struct discard_cmd {
+	struct rb_node rb_node;		/* in the range tree, keyed by start */
+	struct list_head list;		/* in a pend_list size bucket */
+	block_t start;			/* first block to be discarded */
+	block_t len;			/* # of consecutive blocks */
+};
+
+#define DISCARD_ORDERS		10	/* size buckets, ilog2(len) */
+
+struct discard_cmd_control {
+	struct task_struct *f2fs_issue_discard;	/* discard thread */
+	wait_queue_head_t discard_wait_queue;	/* waiting queue for wake-up */
+	wait_queue_head_t discard_done_queue;	/* waiting for issue_start/len */
+	spinlock_t lock;			/* protects the fields below */
+	struct rb_root root;			/* pending ranges */
+	struct list_head pend_list[DISCARD_ORDERS];
+	unsigned int nr_cmds;			/* # of pending ranges */
+	block_t issue_start;			/* range being discarded now */
+	block_t issue_len;
+	struct mutex issue_mutex;		/* one discard in flight */
+};
+
 struct f2fs_sm_info {
 	struct sit_info *sit_info;		/* whole segment information */
 	struct free_segmap_info *free_info;	/* free segment information */
@@ -417,6 +442,11 @@ struct f2fs_sm_info {
 	/* for flush command control */
 	struct flush_cmd_control *cmd_control_info;
 
+	/* for discard command control */
+	struct discard_cmd_control *dcc_info;
+	unsigned int discard_idle_interval;	/* poll interval while busy, ms */
+	unsigned int max_discard_cmds;		/* issue regardless of I/O above */
+
 };
 
 /*
@@ -1302,6 +1332,9 @@ void f2fs_balance_fs_bg(struct f2fs_sb_info *);
 int f2fs_issue_flush(struct f2fs_sb_info *);
 int create_flush_cmd_control(struct f2fs_sb_info *);
 void destroy_flush_cmd_control(struct f2fs_sb_info *);
+int create_discard_cmd_control(struct f2fs_sb_info *);
+void destroy_discard_cmd_control(struct f2fs_sb_info *);
+void f2fs_flush_discard_cmds(struct f2fs_sb_info *);
 void invalidate_blocks(struct f2fs_sb_info *, block_t);
 void refresh_sit_entry(struct f2fs_sb_info *, block_t, block_t);
 void clear_prefree_segments(struct f2fs_sb_info *);
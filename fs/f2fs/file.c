@@ -134,6 +134,34 @@ static inline bool need_do_checkpoint(struct inode *inode)
 	return need_cp;
 }
 
+/*
+ * A directory whose dentries and inode are all covered by the last
+ * checkpoint has nothing to persist, so fsync need not write a new one.
+ */
+static bool dir_clean_since_cp(struct inode *inode)
+{
+	struct f2fs_sb_info *sbi = F2FS_I_SB(inode);
+	struct f2fs_inode_info *fi = F2FS_I(inode);
+	unsigned long long cp_ver = cur_cp_version(F2FS_CKPT(sbi));
+	struct page *i;
+	bool clean;
+
+	if (!S_ISDIR(inode->i_mode) || !is_checkpointed_node(sbi, inode->i_ino))
+		return false;
+
+	down_read(&fi->i_sem);
+	clean = fi->dentry_ver != cp_ver && fi->xattr_ver != cp_ver;
+	up_read(&fi->i_sem);
+	if (!clean || is_inode_flag_set(fi, FI_DIRTY_INODE) ||
+			need_inode_block_update(sbi, inode->i_ino))
+		return false;
+
+	i = find_get_page(NODE_MAPPING(sbi), inode->i_ino);
+	clean = !(i && PageDirty(i));
+	f2fs_put_page(i, 0);
+	return clean;
+}
+
 int f2fs_sync_file(struct file *file, loff_t start, loff_t end, int datasync)
 {
 	struct inode *inode = file->f_mapping->host;
@@ -164,6 +192,9 @@ int f2fs_sync_file(struct file *file, loff_t start, loff_t end, int datasync)
 		return ret;
 	}
 
+	if (dir_clean_since_cp(inode))
+		goto out;
+
 	/*
 	 * if there is no written data, don't waste time to write recovery info.
 	 */
@@ -17,6 +17,8 @@
 #include <linux/delay.h>
 #include <linux/freezer.h>
 #include <linux/blkdev.h>
+#include <linux/genhd.h>
+#include <linux/fb.h>
 
 #include "f2fs.h"
 #include "node.h"
@@ -26,6 +28,80 @@
 
 static struct kmem_cache *winode_slab;
 
+/*
+ * Background GC is paced by the screen: while it is on GC only runs when
+ * the device was idle for idle_interval, once it goes off the threads are
+ * woken and run with the short idle_interval_off and minimum sleep time.
+ */
+static bool f2fs_gc_screen_off;
+static LIST_HEAD(f2fs_gc_list);
+static DEFINE_SPINLOCK(f2fs_gc_list_lock);
+
+static unsigned long bdev_ios(struct block_device *bdev)
+{
+	struct hd_struct *part = bdev->bd_part;
+
+	return part_stat_read(part, ios[READ]) +
+				part_stat_read(part, ios[WRITE]);
+}
+
+/*
+ * Wait for idle_interval and check that no request completed or got
+ * queued on the device meanwhile.
+ */
+static bool gc_wait_idle(struct f2fs_sb_info *sbi,
+				struct f2fs_gc_kthread *gc_th)
+{
+	struct block_device *bdev = sbi->sb->s_bdev;
+	unsigned int interval = ACCESS_ONCE(f2fs_gc_screen_off) ?
+			gc_th->idle_interval_off : gc_th->idle_interval;
+	unsigned long ios;
+
+	if (!is_idle(sbi))
+		return false;
+
+	ios = bdev_ios(bdev);
+	wait_event_interruptible_timeout(gc_th->gc_wait_queue_head,
+				kthread_should_stop(),
+				msecs_to_jiffies(interval));
+	if (kthread_should_stop())
+		return false;
+
+	return is_idle(sbi) && bdev_ios(bdev) == ios;
+}
+
+#ifdef CONFIG_FB
+static int f2fs_gc_fb_notifier(struct notifier_block *nb,
+				unsigned long event, void *data)
+{
+	struct fb_event *evdata = data;
+	struct f2fs_gc_kthread *gc_th;
+	bool off;
+
+	if (event != FB_EVENT_BLANK || !evdata || !evdata->data)
+		return 0;
+
+	off = *(int *)evdata->data != FB_BLANK_UNBLANK;
+	if (off == f2fs_gc_screen_off)
+		return 0;
+	f2fs_gc_screen_off = off;
+	if (!off)
+		return 0;
+
+	spin_lock(&f2fs_gc_list_lock);
+	list_for_each_entry(gc_th, &f2fs_gc_list, list) {
+		gc_th->gc_wake = true;
+		wake_up(&gc_th->gc_wait_queue_head);
+	}
+	spin_unlock(&f2fs_gc_list_lock);
+	return 0;
+}
+
+static struct notifier_block f2fs_gc_fb_nb = {
+	.notifier_call = f2fs_gc_fb_notifier,
+};
+#endif
+
 static int gc_thread_func(void *data)
 {
 	struct f2fs_sb_info *sbi = data;
@@ -40,11 +116,17 @@ static int gc_thread_func(void *data)
 			continue;
 		else
 			wait_event_interruptible_timeout(*wq,
-						kthread_should_stop(),
+						kthread_should_stop() ||
+						gc_th->gc_wake,
 						msecs_to_jiffies(wait_ms));
 		if (kthread_should_stop())
 			break;
 
+		if (gc_th->gc_wake) {
+			gc_th->gc_wake = false;
+			wait_ms = gc_th->min_sleep_time;
+		}
+
 		if (sbi->sb->s_writers.frozen >= SB_FREEZE_WRITE) {
 			wait_ms = increase_sleep_time(gc_th, wait_ms);
 			continue;
@@ -56,24 +138,26 @@ static int gc_thread_func(void *data)
 		 * 1. There are enough dirty segments.
 		 * 2. IO subsystem is idle by checking the # of writeback pages.
 		 * 3. IO subsystem is idle by checking the # of requests in
-		 *    bdev's request list.
+		 *    bdev's request list, and no request went to the device
+		 *    for the idle interval.
 		 *
 		 * Note) We have to avoid triggering GCs frequently.
 		 * Because it is possible that some segments can be
 		 * invalidated soon after by user update or deletion.
 		 * So, I'd like to wait some time to collect dirty segments.
 		 */
-		if (!mutex_trylock(&sbi->gc_mutex))
-			continue;
-
-		if (!is_idle(sbi)) {
+		if (!gc_wait_idle(sbi, gc_th)) {
 			wait_ms = increase_sleep_time(gc_th, wait_ms);
-			mutex_unlock(&sbi->gc_mutex);
 			continue;
 		}
 
+		if (!mutex_trylock(&sbi->gc_mutex))
+			continue;
+
 		if (has_enough_invalid_blocks(sbi))
-			wait_ms = decrease_sleep_time(gc_th, wait_ms);
+			wait_ms = ACCESS_ONCE(f2fs_gc_screen_off) ?
+				gc_th->min_sleep_time :
+				decrease_sleep_time(gc_th, wait_ms);
 		else
 			wait_ms = increase_sleep_time(gc_th, wait_ms);
 
@@ -109,6 +193,9 @@ int start_gc_thread(struct f2fs_sb_info *sbi)
 	gc_th->no_gc_sleep_time = DEF_GC_THREAD_NOGC_SLEEP_TIME;
 
 	gc_th->gc_idle = 0;
+	gc_th->idle_interval = DEF_GC_IDLE_INTERVAL;
+	gc_th->idle_interval_off = DEF_GC_IDLE_INTERVAL_OFF;
+	gc_th->gc_wake = false;
 
 	sbi->gc_thread = gc_th;
 	init_waitqueue_head(&sbi->gc_thread->gc_wait_queue_head);
@@ -118,7 +205,12 @@ int start_gc_thread(struct f2fs_sb_info *sbi)
 		err = PTR_ERR(gc_th->f2fs_gc_task);
 		kfree(gc_th);
 		sbi->gc_thread = NULL;
+		goto out;
 	}
+
+	spin_lock(&f2fs_gc_list_lock);
+	list_add(&gc_th->list, &f2fs_gc_list);
+	spin_unlock(&f2fs_gc_list_lock);
 out:
 	return err;
 }
@@ -128,6 +220,9 @@ void stop_gc_thread(struct f2fs_sb_info *sbi)
 	struct f2fs_gc_kthread *gc_th = sbi->gc_thread;
 	if (!gc_th)
 		return;
+	spin_lock(&f2fs_gc_list_lock);
+	list_del(&gc_th->list);
+	spin_unlock(&f2fs_gc_list_lock);
 	kthread_stop(gc_th->f2fs_gc_task);
 	kfree(gc_th);
 	sbi->gc_thread = NULL;
@@ -247,53 +342,77 @@ static inline unsigned int get_gc_cost(struct f2fs_sb_info *sbi,
 		return get_cb_cost(sbi, segno);
 }
 
+/* Sections looked at per bucket of the victim index */
+#define VICTIM_BUCKET_SCAN	8
+
 /*
- * This function is called from two paths.
- * One is garbage collection and the other is SSR segment selection.
- * When it is called during GC, it just gets a victim segment
- * and it does not remove it from dirty seglist.
- * When it is called from SSR segment selection, it finds a segment
- * which has minimum valid blocks and removes it from dirty seglist.
+ * LFS victims come from the victim index: greedy takes the best of the
+ * first sections in the lowest non-empty bucket, cost-benefit compares
+ * the oldest sections of every bucket, so every selection costs at most
+ * NR_VICTIM_BUCKETS * VICTIM_BUCKET_SCAN cost calculations.
  */
-static int get_victim_by_default(struct f2fs_sb_info *sbi,
-		unsigned int *result, int gc_type, int type, char alloc_mode)
+static void get_victim_from_index(struct f2fs_sb_info *sbi, int gc_type,
+				struct victim_sel_policy *p)
 {
 	struct dirty_seglist_info *dirty_i = DIRTY_I(sbi);
-	struct victim_sel_policy p;
-	unsigned int secno, max_cost;
-	int nsearched = 0;
+	struct list_head *entry;
+	unsigned int secno, segno, nscan;
+	unsigned long cost;
+	int i;
 
-	mutex_lock(&dirty_i->seglist_lock);
+	for (i = 0; i < NR_VICTIM_BUCKETS; i++) {
+		nscan = 0;
+		list_for_each(entry, &dirty_i->victim_bucket[i]) {
+			if (nscan++ >= VICTIM_BUCKET_SCAN)
+				break;
 
-	p.alloc_mode = alloc_mode;
-	select_policy(sbi, gc_type, type, &p);
+			secno = entry - dirty_i->victim_list;
+			segno = secno * sbi->segs_per_sec;
 
-	p.min_segno = NULL_SEGNO;
-	p.min_cost = max_cost = get_max_cost(sbi, &p);
+			if (sec_usage_check(sbi, secno))
+				continue;
+			if (gc_type == BG_GC &&
+					test_bit(secno, dirty_i->victim_secmap))
+				continue;
 
-	if (p.alloc_mode == LFS && gc_type == FG_GC) {
-		p.min_segno = check_bg_victims(sbi);
-		if (p.min_segno != NULL_SEGNO)
-			goto got_it;
+			cost = get_gc_cost(sbi, segno, p);
+			if (p->min_cost > cost) {
+				p->min_segno = segno;
+				p->min_cost = cost;
+			}
+		}
+
+		/* everything in a higher bucket has more valid blocks */
+		if (p->gc_mode == GC_GREEDY && p->min_segno != NULL_SEGNO)
+			break;
 	}
+}
+
+static void get_victim_from_segmap(struct f2fs_sb_info *sbi, int gc_type,
+				struct victim_sel_policy *p,
+				unsigned int max_cost)
+{
+	struct dirty_seglist_info *dirty_i = DIRTY_I(sbi);
+	unsigned int secno;
+	int nsearched = 0;
 
 	while (1) {
 		unsigned long cost;
 		unsigned int segno;
 
-		segno = find_next_bit(p.dirty_segmap, MAIN_SEGS(sbi), p.offset);
+		segno = find_next_bit(p->dirty_segmap, MAIN_SEGS(sbi), p->offset);
 		if (segno >= MAIN_SEGS(sbi)) {
-			if (sbi->last_victim[p.gc_mode]) {
-				sbi->last_victim[p.gc_mode] = 0;
-				p.offset = 0;
+			if (sbi->last_victim[p->gc_mode]) {
+				sbi->last_victim[p->gc_mode] = 0;
+				p->offset = 0;
 				continue;
 			}
 			break;
 		}
 
-		p.offset = segno + p.ofs_unit;
-		if (p.ofs_unit > 1)
-			p.offset -= segno % p.ofs_unit;
+		p->offset = segno + p->ofs_unit;
+		if (p->ofs_unit > 1)
+			p->offset -= segno % p->ofs_unit;
 
 		secno = GET_SECNO(sbi, segno);
 
@@ -302,20 +421,57 @@ static int get_victim_by_default(struct f2fs_sb_info *sbi,
 		if (gc_type == BG_GC && test_bit(secno, dirty_i->victim_secmap))
 			continue;
 
-		cost = get_gc_cost(sbi, segno, &p);
+		cost = get_gc_cost(sbi, segno, p);
 
-		if (p.min_cost > cost) {
-			p.min_segno = segno;
-			p.min_cost = cost;
+		if (p->min_cost > cost) {
+			p->min_segno = segno;
+			p->min_cost = cost;
 		} else if (unlikely(cost == max_cost)) {
 			continue;
 		}
 
-		if (nsearched++ >= p.max_search) {
-			sbi->last_victim[p.gc_mode] = segno;
+		if (nsearched++ >= p->max_search) {
+			sbi->last_victim[p->gc_mode] = segno;
 			break;
 		}
 	}
+}
+
+/*
+ * This function is called from two paths.
+ * One is garbage collection and the other is SSR segment selection.
+ * When it is called during GC, it just gets a victim segment
+ * and it does not remove it from dirty seglist.
+ * When it is called from SSR segment selection, it finds a segment
+ * which has minimum valid blocks and removes it from dirty seglist.
+ */
+static int get_victim_by_default(struct f2fs_sb_info *sbi,
+		unsigned int *result, int gc_type, int type, char alloc_mode)
+{
+	struct dirty_seglist_info *dirty_i = DIRTY_I(sbi);
+	struct victim_sel_policy p;
+	unsigned int secno, max_cost;
+
+	mutex_lock(&dirty_i->seglist_lock);
+
+	p.alloc_mode = alloc_mode;
+	select_policy(sbi, gc_type, type, &p);
+
+	p.min_segno = NULL_SEGNO;
+	p.min_cost = max_cost = get_max_cost(sbi, &p);
+
+	if (p.alloc_mode == LFS && gc_type == FG_GC) {
+		p.min_segno = check_bg_victims(sbi);
+		if (p.min_segno != NULL_SEGNO)
+			goto got_it;
+	}
+
+	/* SSR picks among the segments of one log type, see select_policy() */
+	if (p.alloc_mode == LFS)
+		get_victim_from_index(sbi, gc_type, &p);
+	else
+		get_victim_from_segmap(sbi, gc_type, &p, max_cost);
+
 	if (p.min_segno != NULL_SEGNO) {
 got_it:
 		if (p.alloc_mode == LFS) {
@@ -750,10 +906,16 @@ int __init create_gc_caches(void)
 			sizeof(struct inode_entry));
 	if (!winode_slab)
 		return -ENOMEM;
+#ifdef CONFIG_FB
+	fb_register_client(&f2fs_gc_fb_nb);
+#endif
 	return 0;
 }
 
 void destroy_gc_caches(void)
 {
+#ifdef CONFIG_FB
+	fb_unregister_client(&f2fs_gc_fb_nb);
+#endif
 	kmem_cache_destroy(winode_slab);
 }
@@ -16,6 +16,8 @@
 #define DEF_GC_THREAD_MIN_SLEEP_TIME	30000	/* milliseconds */
 #define DEF_GC_THREAD_MAX_SLEEP_TIME	60000
 #define DEF_GC_THREAD_NOGC_SLEEP_TIME	300000	/* wait 5 min */
+#define DEF_GC_IDLE_INTERVAL		2000	/* no I/O for 2s, screen on */
+#define DEF_GC_IDLE_INTERVAL_OFF	200	/* screen off */
 #define LIMIT_INVALID_BLOCK	40 /* percentage over total user space */
 #define LIMIT_FREE_BLOCK	40 /* percentage over invalid + free space */
 
@@ -33,6 +35,13 @@ struct f2fs_gc_kthread {
 
 	/* for changing gc mode */
 	unsigned int gc_idle;
+
+	/* the device must see no I/O for this long before a bg gc round */
+	unsigned int idle_interval;
+	unsigned int idle_interval_off;
+
+	struct list_head list;			/* on f2fs_gc_list */
+	bool gc_wake;				/* woken by a screen change */
 };
 
 struct inode_entry {
@@ -428,9 +428,15 @@ static int f2fs_rename(struct inode *old_dir, struct dentry *old_dentry,
 		}
 	}
 
-	down_write(&F2FS_I(old_inode)->i_sem);
-	file_lost_pino(old_inode);
-	up_write(&F2FS_I(old_inode)->i_sem);
+	/*
+	 * Within one directory i_pino stays valid and i_name was updated
+	 * above, so fsync can still recover the new dentry by roll-forward.
+	 */
+	if (old_dir != new_dir) {
+		down_write(&F2FS_I(old_inode)->i_sem);
+		file_lost_pino(old_inode);
+		up_write(&F2FS_I(old_inode)->i_sem);
+	}
 
 	old_inode->i_ctime = CURRENT_TIME;
 	mark_inode_dirty(old_inode);
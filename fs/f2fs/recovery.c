@@ -158,12 +158,37 @@ static void recover_inode(struct inode *inode, struct page *page)
 			ino_of_node(page), F2FS_INODE(page)->i_name);
 }
 
+/*
+ * Roll-forward walks the warm node chain, which is laid out sequentially
+ * by the log, one block at a time.  Keep RECOVERY_RA_DEPTH bios in flight
+ * in front of the walk instead of waiting for a fresh readahead every
+ * time the previous window runs out.
+ */
+#define RECOVERY_RA_DEPTH	4
+
+static struct page *get_node_chain_page(struct f2fs_sb_info *sbi,
+					block_t blkaddr, block_t *ra_end)
+{
+	block_t window = MAX_BIO_BLOCKS(sbi);
+	block_t depth = window * RECOVERY_RA_DEPTH;
+
+	/* the chain jumped: restart the window at the new position */
+	if (blkaddr >= *ra_end || *ra_end - blkaddr > depth)
+		*ra_end = blkaddr;
+
+	while (*ra_end < blkaddr + depth && *ra_end < MAX_BLKADDR(sbi)) {
+		ra_meta_pages(sbi, *ra_end, window, META_POR);
+		*ra_end += window;
+	}
+	return get_meta_page(sbi, blkaddr);
+}
+
 static int find_fsync_dnodes(struct f2fs_sb_info *sbi, struct list_head *head)
 {
 	unsigned long long cp_ver = cur_cp_version(F2FS_CKPT(sbi));
 	struct curseg_info *curseg;
 	struct page *page = NULL;
-	block_t blkaddr;
+	block_t blkaddr, ra_end = 0;
 	int err = 0;
 
 	/* get node pages in the current segment */
@@ -176,7 +201,7 @@ static int find_fsync_dnodes(struct f2fs_sb_info *sbi, struct list_head *head)
 		if (blkaddr < MAIN_BLKADDR(sbi) || blkaddr >= MAX_BLKADDR(sbi))
 			return 0;
 
-		page = get_meta_page_ra(sbi, blkaddr);
+		page = get_node_chain_page(sbi, blkaddr, &ra_end);
 
 		if (cp_ver != cpver_of_node(page))
 			break;
@@ -424,7 +449,7 @@ static int recover_data(struct f2fs_sb_info *sbi,
 	struct curseg_info *curseg;
 	struct page *page = NULL;
 	int err = 0;
-	block_t blkaddr;
+	block_t blkaddr, ra_end = 0;
 
 	/* get node pages in the current segment */
 	curseg = CURSEG_I(sbi, type);
@@ -436,7 +461,7 @@ static int recover_data(struct f2fs_sb_info *sbi,
 		if (blkaddr < MAIN_BLKADDR(sbi) || blkaddr >= MAX_BLKADDR(sbi))
 			break;
 
-		page = get_meta_page_ra(sbi, blkaddr);
+		page = get_node_chain_page(sbi, blkaddr, &ra_end);
 
 		if (cp_ver != cpver_of_node(page)) {
 			f2fs_put_page(page, 1);
@@ -20,11 +20,13 @@
 #include "f2fs.h"
 #include "segment.h"
 #include "node.h"
+#include "gc.h"
 #include <trace/events/f2fs.h>
 
 #define __reverse_ffz(x) __reverse_ffs(~(x))
 
 static struct kmem_cache *discard_entry_slab;
+static struct kmem_cache *discard_cmd_slab;
 static struct kmem_cache *sit_entry_set_slab;
 static struct kmem_cache *inmem_entry_slab;
 
@@ -346,6 +348,28 @@ void destroy_flush_cmd_control(struct f2fs_sb_info *sbi)
 	SM_I(sbi)->cmd_control_info = NULL;
 }
 
+static void update_victim_index(struct f2fs_sb_info *sbi, unsigned int segno)
+{
+	struct dirty_seglist_info *dirty_i = DIRTY_I(sbi);
+	unsigned int secno = GET_SECNO(sbi, segno);
+	unsigned int start = secno * sbi->segs_per_sec;
+	unsigned int end = start + sbi->segs_per_sec;
+	struct list_head *entry = &dirty_i->victim_list[secno];
+	unsigned int valid, bucket;
+
+	if (find_next_bit(dirty_i->dirty_segmap[DIRTY], end, start) >= end) {
+		list_del_init(entry);
+		return;
+	}
+
+	valid = get_valid_blocks(sbi, start, sbi->segs_per_sec);
+	bucket = valid * NR_VICTIM_BUCKETS /
+			(sbi->blocks_per_seg * sbi->segs_per_sec);
+	if (bucket >= NR_VICTIM_BUCKETS)
+		bucket = NR_VICTIM_BUCKETS - 1;
+	list_move_tail(entry, &dirty_i->victim_bucket[bucket]);
+}
+
 static void __locate_dirty_segment(struct f2fs_sb_info *sbi, unsigned int segno,
 		enum dirty_type dirty_type)
 {
@@ -368,6 +392,7 @@ static void __locate_dirty_segment(struct f2fs_sb_info *sbi, unsigned int segno,
 		}
 		if (!test_and_set_bit(segno, dirty_i->dirty_segmap[t]))
 			dirty_i->nr_dirty[t]++;
+		update_victim_index(sbi, segno);
 	}
 }
 
@@ -389,6 +414,7 @@ static void __remove_dirty_segment(struct f2fs_sb_info *sbi, unsigned int segno,
 		if (get_valid_blocks(sbi, segno, sbi->segs_per_sec) == 0)
 			clear_bit(GET_SECNO(sbi, segno),
 						dirty_i->victim_secmap);
+		update_victim_index(sbi, segno);
 	}
 }
 
@@ -431,6 +457,311 @@ static int f2fs_issue_discard(struct f2fs_sb_info *sbi,
 	return blkdev_issue_discard(sbi->sb->s_bdev, start, len, GFP_NOFS, 0);
 }
 
+static inline int discard_order(block_t len)
+{
+	return min_t(int, ilog2(len), DISCARD_ORDERS - 1);
+}
+
+/* the pending range with the largest start <= blkaddr */
+static struct discard_cmd *__lookup_discard_cmd(
+		struct discard_cmd_control *dcc, block_t blkaddr)
+{
+	struct rb_node *node = dcc->root.rb_node;
+	struct discard_cmd *dc, *found = NULL;
+
+	while (node) {
+		dc = rb_entry(node, struct discard_cmd, rb_node);
+		if (blkaddr < dc->start) {
+			node = node->rb_left;
+		} else {
+			found = dc;
+			node = node->rb_right;
+		}
+	}
+	return found;
+}
+
+static void __insert_discard_cmd(struct discard_cmd_control *dcc,
+						struct discard_cmd *dc)
+{
+	struct rb_node **p = &dcc->root.rb_node;
+	struct rb_node *parent = NULL;
+	struct discard_cmd *this;
+
+	while (*p) {
+		parent = *p;
+		this = rb_entry(parent, struct discard_cmd, rb_node);
+		if (dc->start < this->start)
+			p = &parent->rb_left;
+		else
+			p = &parent->rb_right;
+	}
+	rb_link_node(&dc->rb_node, parent, p);
+	rb_insert_color(&dc->rb_node, &dcc->root);
+	list_add_tail(&dc->list, &dcc->pend_list[discard_order(dc->len)]);
+	dcc->nr_cmds++;
+}
+
+static void __remove_discard_cmd(struct discard_cmd_control *dcc,
+						struct discard_cmd *dc)
+{
+	rb_erase(&dc->rb_node, &dcc->root);
+	list_del(&dc->list);
+	dcc->nr_cmds--;
+}
+
+/* dc->len changed, move it to its new size bucket */
+static void __relink_discard_cmd(struct discard_cmd_control *dcc,
+						struct discard_cmd *dc)
+{
+	list_move_tail(&dc->list, &dcc->pend_list[discard_order(dc->len)]);
+}
+
+/*
+ * Queue [blkstart, blkstart + blklen) for the discard thread. The range is
+ * merged with any pending range it overlaps or touches, so that freed
+ * segments coalesce into a few large discards rather than many small ones.
+ */
+static void f2fs_queue_discard(struct f2fs_sb_info *sbi,
+				block_t blkstart, block_t blklen)
+{
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+	struct discard_cmd *new, *dc;
+	struct rb_node *node;
+	block_t end = blkstart + blklen;
+
+	if (!dcc) {
+		f2fs_issue_discard(sbi, blkstart, blklen);
+		return;
+	}
+
+	new = f2fs_kmem_cache_alloc(discard_cmd_slab, GFP_NOFS);
+
+	spin_lock(&dcc->lock);
+	dc = __lookup_discard_cmd(dcc, blkstart);
+	node = dc ? rb_next(&dc->rb_node) : rb_first(&dcc->root);
+	if (dc && dc->start + dc->len >= blkstart) {
+		blkstart = dc->start;
+		end = max(end, dc->start + dc->len);
+		__remove_discard_cmd(dcc, dc);
+		kmem_cache_free(discard_cmd_slab, dc);
+	}
+	while (node) {
+		dc = rb_entry(node, struct discard_cmd, rb_node);
+		if (dc->start > end)
+			break;
+		node = rb_next(node);
+		end = max(end, dc->start + dc->len);
+		__remove_discard_cmd(dcc, dc);
+		kmem_cache_free(discard_cmd_slab, dc);
+	}
+	new->start = blkstart;
+	new->len = end - blkstart;
+	__insert_discard_cmd(dcc, new);
+	spin_unlock(&dcc->lock);
+
+	wake_up(&dcc->discard_wait_queue);
+}
+
+/*
+ * blkaddr is about to be written again, so it must not be discarded later.
+ * Drop it from the pending ranges, and wait if it is being discarded now.
+ */
+static void f2fs_punch_discard_cmd(struct f2fs_sb_info *sbi, block_t blkaddr)
+{
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+	struct discard_cmd *dc, *tail = NULL;
+	block_t end;
+
+	if (!dcc || (!dcc->nr_cmds && !dcc->issue_len))
+		return;
+retry:
+	spin_lock(&dcc->lock);
+	if (dcc->issue_len && blkaddr >= dcc->issue_start &&
+			blkaddr < dcc->issue_start + dcc->issue_len) {
+		spin_unlock(&dcc->lock);
+		wait_event(dcc->discard_done_queue,
+			!dcc->issue_len || blkaddr < dcc->issue_start ||
+			blkaddr >= dcc->issue_start + dcc->issue_len);
+		goto retry;
+	}
+
+	dc = __lookup_discard_cmd(dcc, blkaddr);
+	if (!dc || blkaddr >= dc->start + dc->len)
+		goto out;
+
+	end = dc->start + dc->len;
+	if (blkaddr + 1 < end) {
+		if (!tail) {
+			spin_unlock(&dcc->lock);
+			tail = f2fs_kmem_cache_alloc(discard_cmd_slab,
+								GFP_NOFS);
+			goto retry;
+		}
+		tail->start = blkaddr + 1;
+		tail->len = end - tail->start;
+		__insert_discard_cmd(dcc, tail);
+		tail = NULL;
+	}
+
+	if (blkaddr > dc->start) {
+		dc->len = blkaddr - dc->start;
+		__relink_discard_cmd(dcc, dc);
+	} else {
+		__remove_discard_cmd(dcc, dc);
+		kmem_cache_free(discard_cmd_slab, dc);
+	}
+out:
+	spin_unlock(&dcc->lock);
+	if (tail)
+		kmem_cache_free(discard_cmd_slab, tail);
+}
+
+/*
+ * Issue the largest pending range, at most MAX_DISCARD_ISSUE_BLOCKS of it
+ * so that a foreground request never queues behind a huge discard.
+ */
+static bool __issue_discard_cmd(struct f2fs_sb_info *sbi)
+{
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+	struct discard_cmd *dc = NULL;
+	block_t start, len;
+	int i;
+
+	mutex_lock(&dcc->issue_mutex);
+	spin_lock(&dcc->lock);
+	for (i = DISCARD_ORDERS - 1; i >= 0; i--) {
+		if (!list_empty(&dcc->pend_list[i])) {
+			dc = list_first_entry(&dcc->pend_list[i],
+						struct discard_cmd, list);
+			break;
+		}
+	}
+	if (!dc) {
+		spin_unlock(&dcc->lock);
+		mutex_unlock(&dcc->issue_mutex);
+		return false;
+	}
+
+	start = dc->start;
+	len = min_t(block_t, dc->len, MAX_DISCARD_ISSUE_BLOCKS);
+	if (len == dc->len) {
+		__remove_discard_cmd(dcc, dc);
+	} else {
+		dc->start += len;
+		dc->len -= len;
+		__relink_discard_cmd(dcc, dc);
+		dc = NULL;
+	}
+	dcc->issue_start = start;
+	dcc->issue_len = len;
+	spin_unlock(&dcc->lock);
+
+	if (dc)
+		kmem_cache_free(discard_cmd_slab, dc);
+
+	f2fs_issue_discard(sbi, start, len);
+
+	spin_lock(&dcc->lock);
+	dcc->issue_len = 0;
+	spin_unlock(&dcc->lock);
+	wake_up_all(&dcc->discard_done_queue);
+	mutex_unlock(&dcc->issue_mutex);
+	return true;
+}
+
+/* issue every pending discard now, e.g. for FITRIM or at umount */
+void f2fs_flush_discard_cmds(struct f2fs_sb_info *sbi)
+{
+	if (!SM_I(sbi)->dcc_info)
+		return;
+
+	while (__issue_discard_cmd(sbi))
+		cond_resched();
+}
+
+static bool discard_urgent(struct f2fs_sb_info *sbi)
+{
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+
+	return dcc->nr_cmds > SM_I(sbi)->max_discard_cmds ||
+			utilization(sbi) > DISCARD_URGENT_UTIL;
+}
+
+static int issue_discard_thread(void *data)
+{
+	struct f2fs_sb_info *sbi = data;
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+	wait_queue_head_t *q = &dcc->discard_wait_queue;
+repeat:
+	if (kthread_should_stop())
+		return 0;
+
+	if (dcc->nr_cmds) {
+		/*
+		 * Stay out of the way of foreground I/O unless the queue has
+		 * grown too long or the device is nearly full, where the FTL
+		 * needs to know about free blocks the most.
+		 */
+		if (is_idle(sbi) || discard_urgent(sbi)) {
+			__issue_discard_cmd(sbi);
+			cond_resched();
+		} else {
+			wait_event_interruptible_timeout(*q,
+				kthread_should_stop(), msecs_to_jiffies(
+				SM_I(sbi)->discard_idle_interval));
+		}
+		goto repeat;
+	}
+
+	wait_event_interruptible(*q,
+		kthread_should_stop() || dcc->nr_cmds);
+	goto repeat;
+}
+
+int create_discard_cmd_control(struct f2fs_sb_info *sbi)
+{
+	dev_t dev = sbi->sb->s_bdev->bd_dev;
+	struct discard_cmd_control *dcc;
+	int err = 0;
+	int i;
+
+	dcc = kzalloc(sizeof(struct discard_cmd_control), GFP_KERNEL);
+	if (!dcc)
+		return -ENOMEM;
+	init_waitqueue_head(&dcc->discard_wait_queue);
+	init_waitqueue_head(&dcc->discard_done_queue);
+	spin_lock_init(&dcc->lock);
+	mutex_init(&dcc->issue_mutex);
+	dcc->root = RB_ROOT;
+	for (i = 0; i < DISCARD_ORDERS; i++)
+		INIT_LIST_HEAD(&dcc->pend_list[i]);
+	SM_I(sbi)->dcc_info = dcc;
+	dcc->f2fs_issue_discard = kthread_run(issue_discard_thread, sbi,
+				"f2fs_discard-%u:%u", MAJOR(dev), MINOR(dev));
+	if (IS_ERR(dcc->f2fs_issue_discard)) {
+		err = PTR_ERR(dcc->f2fs_issue_discard);
+		kfree(dcc);
+		SM_I(sbi)->dcc_info = NULL;
+		return err;
+	}
+
+	return err;
+}
+
+void destroy_discard_cmd_control(struct f2fs_sb_info *sbi)
+{
+	struct discard_cmd_control *dcc = SM_I(sbi)->dcc_info;
+
+	if (!dcc)
+		return;
+	if (dcc->f2fs_issue_discard)
+		kthread_stop(dcc->f2fs_issue_discard);
+	f2fs_flush_discard_cmds(sbi);
+	kfree(dcc);
+	SM_I(sbi)->dcc_info = NULL;
+}
+
 void discard_next_dnode(struct f2fs_sb_info *sbi, block_t blkaddr)
 {
 	if (f2fs_issue_discard(sbi, blkaddr, 1)) {
@@ -564,14 +895,14 @@ void clear_prefree_segments(struct f2fs_sb_info *sbi)
 		if (!test_opt(sbi, DISCARD))
 			continue;
 
-		f2fs_issue_discard(sbi, START_BLOCK(sbi, start),
+		f2fs_queue_discard(sbi, START_BLOCK(sbi, start),
 				(end - start) << sbi->log_blocks_per_seg);
 	}
 	mutex_unlock(&dirty_i->seglist_lock);
 
 	/* send small discards */
 	list_for_each_entry_safe(entry, this, head, list) {
-		f2fs_issue_discard(sbi, entry->blkaddr, entry->len);
+		f2fs_queue_discard(sbi, entry->blkaddr, entry->len);
 		list_del(&entry->list);
 		SM_I(sbi)->nr_discards -= entry->len;
 		kmem_cache_free(discard_entry_slab, entry);
@@ -620,6 +951,7 @@ static void update_sit_entry(struct f2fs_sb_info *sbi, block_t blkaddr, int del)
 
 	/* Update valid block bitmap */
 	if (del > 0) {
+		f2fs_punch_discard_cmd(sbi, blkaddr);
 		if (f2fs_set_bit(offset, se->cur_valid_map))
 			f2fs_bug_on(sbi, 1);
 	} else {
@@ -1019,6 +1351,7 @@ int f2fs_trim_fs(struct f2fs_sb_info *sbi, struct fstrim_range *range)
 
 	/* do checkpoint to issue discard commands safely */
 	write_checkpoint(sbi, &cpc);
+	f2fs_flush_discard_cmds(sbi);
 out:
 	range->len = cpc.trimmed << sbi->log_blocksize;
 	return 0;
@@ -1976,10 +2309,20 @@ static int init_victim_secmap(struct f2fs_sb_info *sbi)
 {
 	struct dirty_seglist_info *dirty_i = DIRTY_I(sbi);
 	unsigned int bitmap_size = f2fs_bitmap_size(MAIN_SECS(sbi));
+	unsigned int i;
 
 	dirty_i->victim_secmap = kzalloc(bitmap_size, GFP_KERNEL);
 	if (!dirty_i->victim_secmap)
 		return -ENOMEM;
+
+	dirty_i->victim_list = vmalloc(MAIN_SECS(sbi) *
+					sizeof(struct list_head));
+	if (!dirty_i->victim_list)
+		return -ENOMEM;
+	for (i = 0; i < MAIN_SECS(sbi); i++)
+		INIT_LIST_HEAD(&dirty_i->victim_list[i]);
+	for (i = 0; i < NR_VICTIM_BUCKETS; i++)
+		INIT_LIST_HEAD(&dirty_i->victim_bucket[i]);
 	return 0;
 }
 
@@ -1987,6 +2330,7 @@ static int build_dirty_segmap(struct f2fs_sb_info *sbi)
 {
 	struct dirty_seglist_info *dirty_i;
 	unsigned int bitmap_size, i;
+	int err;
 
 	/* allocate memory for dirty segments list information */
 	dirty_i = kzalloc(sizeof(struct dirty_seglist_info), GFP_KERNEL);
@@ -2004,8 +2348,12 @@ static int build_dirty_segmap(struct f2fs_sb_info *sbi)
 			return -ENOMEM;
 	}
 
+	err = init_victim_secmap(sbi);
+	if (err)
+		return err;
+
 	init_dirty_segmap(sbi);
-	return init_victim_secmap(sbi);
+	return 0;
 }
 
 /*
@@ -2065,6 +2413,8 @@ int build_segment_manager(struct f2fs_sb_info *sbi)
 	INIT_LIST_HEAD(&sm_info->discard_list);
 	sm_info->nr_discards = 0;
 	sm_info->max_discards = 0;
+	sm_info->discard_idle_interval = DEF_DISCARD_IDLE_INTERVAL;
+	sm_info->max_discard_cmds = DEF_MAX_DISCARD_CMDS;
 
 	INIT_LIST_HEAD(&sm_info->sit_entry_set);
 
@@ -2074,6 +2424,12 @@ int build_segment_manager(struct f2fs_sb_info *sbi)
 			return err;
 	}
 
+	if (test_opt(sbi, DISCARD) && !f2fs_readonly(sbi->sb)) {
+		err = create_discard_cmd_control(sbi);
+		if (err)
+			return err;
+	}
+
 	err = build_sit_info(sbi);
 	if (err)
 		return err;
@@ -2111,6 +2467,7 @@ static void destroy_victim_secmap(struct f2fs_sb_info *sbi)
 {
 	struct dirty_seglist_info *dirty_i = DIRTY_I(sbi);
 	kfree(dirty_i->victim_secmap);
+	vfree(dirty_i->victim_list);
 }
 
 static void destroy_dirty_segmap(struct f2fs_sb_info *sbi)
@@ -2184,6 +2541,7 @@ void destroy_segment_manager(struct f2fs_sb_info *sbi)
 	if (!sm_info)
 		return;
 	destroy_flush_cmd_control(sbi);
+	destroy_discard_cmd_control(sbi);
 	destroy_dirty_segmap(sbi);
 	destroy_curseg(sbi);
 	destroy_free_segmap(sbi);
@@ -2199,10 +2557,15 @@ int __init create_segment_manager_caches(void)
 	if (!discard_entry_slab)
 		goto fail;
 
+	discard_cmd_slab = f2fs_kmem_cache_create("discard_cmd",
+			sizeof(struct discard_cmd));
+	if (!discard_cmd_slab)
+		goto destory_discard_entry;
+
 	sit_entry_set_slab = f2fs_kmem_cache_create("sit_entry_set",
 			sizeof(struct nat_entry_set));
 	if (!sit_entry_set_slab)
-		goto destory_discard_entry;
+		goto destroy_discard_cmd;
 
 	inmem_entry_slab = f2fs_kmem_cache_create("inmem_page_entry",
 			sizeof(struct inmem_pages));
@@ -2212,6 +2575,8 @@ int __init create_segment_manager_caches(void)
 
 destroy_sit_entry_set:
 	kmem_cache_destroy(sit_entry_set_slab);
+destroy_discard_cmd:
+	kmem_cache_destroy(discard_cmd_slab);
 destory_discard_entry:
 	kmem_cache_destroy(discard_entry_slab);
 fail:
@@ -2221,6 +2586,7 @@ fail:
 void destroy_segment_manager_caches(void)
 {
 	kmem_cache_destroy(sit_entry_set_slab);
+	kmem_cache_destroy(discard_cmd_slab);
 	kmem_cache_destroy(discard_entry_slab);
 	kmem_cache_destroy(inmem_entry_slab);
 }
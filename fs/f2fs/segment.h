@@ -16,6 +16,11 @@
 
 #define DEF_RECLAIM_PREFREE_SEGMENTS	5	/* 5% over total segments */
 
+#define DEF_DISCARD_IDLE_INTERVAL	100	/* ms between busy checks */
+#define DEF_MAX_DISCARD_CMDS		4096	/* pending ranges before forcing */
+#define DISCARD_URGENT_UTIL		80	/* force discards above 80% util */
+#define MAX_DISCARD_ISSUE_BLOCKS	2048	/* 8MB per discard command */
+
 /* L: Logical segment # in volume, R: Relative segment # in main area */
 #define GET_L2R_SEGNO(free_i, segno)	(segno - free_i->start_segno)
 #define GET_R2L_SEGNO(free_i, segno)	(segno + free_i->start_segno)
@@ -225,12 +230,22 @@ enum dirty_type {
 	NR_DIRTY_TYPE
 };
 
+/*
+ * Dirty sections are also kept on one of NR_VICTIM_BUCKETS lists by their
+ * share of valid blocks.  A section goes to the tail of its list whenever
+ * its valid blocks change, so each list runs from the oldest to the most
+ * recently modified section.
+ */
+#define NR_VICTIM_BUCKETS	16
+
 struct dirty_seglist_info {
 	const struct victim_selection *v_ops;	/* victim selction operation */
 	unsigned long *dirty_segmap[NR_DIRTY_TYPE];
 	struct mutex seglist_lock;		/* lock for segment bitmaps */
 	int nr_dirty[NR_DIRTY_TYPE];		/* # of dirty segments */
 	unsigned long *victim_secmap;		/* background GC victims */
+	struct list_head *victim_list;		/* one entry per section */
+	struct list_head victim_bucket[NR_VICTIM_BUCKETS];
 };
 
 /* victim selection function for cleaning and SSR */
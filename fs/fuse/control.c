@@ -61,6 +61,24 @@ static ssize_t fuse_conn_waiting_read(struct file *file, char __user *buf,
 	return simple_read_from_buffer(buf, len, ppos, tmp, size);
 }
 
+static ssize_t fuse_conn_lookup_stats_read(struct file *file, char __user *buf,
+					   size_t len, loff_t *ppos)
+{
+	char tmp[96];
+	size_t size;
+	struct fuse_conn *fc = fuse_ctl_file_conn_get(file);
+
+	if (!fc)
+		return 0;
+
+	size = sprintf(tmp, "lookups %ld\nnegative %ld\nnegative_hits %ld\n",
+		       atomic_long_read(&fc->nr_lookups),
+		       atomic_long_read(&fc->nr_negative),
+		       atomic_long_read(&fc->nr_negative_hits));
+	fuse_conn_put(fc);
+	return simple_read_from_buffer(buf, len, ppos, tmp, size);
+}
+
 static ssize_t fuse_conn_limit_read(struct file *file, char __user *buf,
 				    size_t len, loff_t *ppos, unsigned val)
 {
@@ -182,6 +200,12 @@ static const struct file_operations fuse_ctl_waiting_ops = {
 	.llseek = no_llseek,
 };
 
+static const struct file_operations fuse_ctl_lookup_stats_ops = {
+	.open = nonseekable_open,
+	.read = fuse_conn_lookup_stats_read,
+	.llseek = no_llseek,
+};
+
 static const struct file_operations fuse_conn_max_background_ops = {
 	.open = nonseekable_open,
 	.read = fuse_conn_max_background_read,
@@ -260,7 +284,9 @@ int fuse_ctl_add_conn(struct fuse_conn *fc)
 				 1, NULL, &fuse_conn_max_background_ops) ||
 	    !fuse_ctl_add_dentry(parent, fc, "congestion_threshold",
 				 S_IFREG | 0600, 1, NULL,
-				 &fuse_conn_congestion_threshold_ops))
+				 &fuse_conn_congestion_threshold_ops) ||
+	    !fuse_ctl_add_dentry(parent, fc, "lookup_stats", S_IFREG | 0400, 1,
+				 NULL, &fuse_ctl_lookup_stats_ops))
 		goto err;
 
 	return 0;
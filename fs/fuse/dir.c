@@ -267,6 +267,9 @@ static int fuse_dentry_revalidate(struct dentry *entry, unsigned int flags)
 			fuse_advise_use_readdirplus(parent->d_inode);
 			dput(parent);
 		}
+	} else {
+		/* a cached miss: no round trip to userspace */
+		atomic_long_inc(&get_fuse_conn_super(entry->d_sb)->nr_negative_hits);
 	}
 	ret = 1;
 out:
@@ -322,6 +325,7 @@ int fuse_lookup_name(struct super_block *sb, u64 nodeid, struct qstr *name,
 
 	fuse_lookup_init(fc, req, nodeid, name, outarg);
 	fuse_request_send(fc, req);
+	atomic_long_inc(&fc->nr_lookups);
 	err = req->out.h.error;
 	fuse_put_request(fc, req);
 	/* Zero nodeid is same as -ENOENT, but with valid timeout */
@@ -358,6 +362,7 @@ static struct dentry *fuse_lookup(struct inode *dir, struct dentry *entry,
 	struct inode *inode;
 	struct dentry *newent;
 	bool outarg_valid = true;
+	struct fuse_conn *fc = get_fuse_conn(dir);
 
 	err = fuse_lookup_name(dir->i_sb, get_node_id(dir), &entry->d_name,
 			       &outarg, &inode);
@@ -380,9 +385,16 @@ static struct dentry *fuse_lookup(struct inode *dir, struct dentry *entry,
 	entry = newent ? newent : entry;
 	if (outarg_valid)
 		fuse_change_entry_timeout(entry, &outarg);
+	else if (fc->negative_timeout)
+		/* -ENOENT carries no timeout, use the mount's */
+		fuse_dentry_settime(entry, get_jiffies_64() +
+				    msecs_to_jiffies(fc->negative_timeout));
 	else
 		fuse_invalidate_entry_cache(entry);
 
+	if (!inode && fuse_dentry_time(entry))
+		atomic_long_inc(&fc->nr_negative);
+
 	fuse_advise_use_readdirplus(dir);
 	return newent;
 
@@ -464,6 +476,7 @@ static int fuse_create_open(struct inode *dir, struct dentry *entry,
 	if (!S_ISREG(outentry.attr.mode) || invalid_nodeid(outentry.nodeid))
 		goto out_free_ff;
 
+	fuse_passthrough_open(ff, req);
 	fuse_put_request(fc, req);
 	ff->fh = outopen.fh;
 	ff->nodeid = outentry.nodeid;
@@ -11,6 +11,7 @@
 #include "fuse_i.h"
 #include "mt_fuse.h"
 #include <linux/debugfs.h>
+#include <linux/percpu.h>
 #include <linux/slab.h>
 #include <linux/time.h>
 
@@ -22,9 +23,23 @@ int fuse_ringbuf_index = 0;
 /* kernel print buffer */
 static char *fuse_iolog_buf;
 
-/* mutex used to protect the buffers */
+/* mutex used to protect the buffers, taken by the log thread and readers */
 struct mutex fuse_iolog_lock;
 
+/*
+ * Requests only account into the current cpu's table, so the request path
+ * never waits on the log thread or on other cpus.  The log thread folds
+ * the per-cpu tables into fuse_iolog.
+ */
+struct fuse_iolog_cpu {
+	spinlock_t lock;
+	unsigned int dropped;		/* samples that found no free entry */
+	struct fuse_proc_info info[FUSE_IOLOG_MAX];
+};
+
+static DEFINE_PER_CPU(struct fuse_iolog_cpu, fuse_iolog_pcpu);
+static unsigned int fuse_iolog_dropped;
+
 /* kernel log thread */
 struct task_struct *fuse_iolog_thread = NULL;
 
@@ -161,6 +176,16 @@ int fuse_iolog_print(void)
 		}
 	}
 
+	if (fuse_iolog_dropped) {
+		n = snprintf(ptr, len, "{dropped:%u}", fuse_iolog_dropped);
+		len -= n;
+		ptr += n;
+		fuse_iolog_dropped = 0;
+
+		if (len < 0)
+			goto overflow;
+	}
+
 	if (i > 0) {
 		if (fuseio_klog_enable)
 			pr_debug("[BLOCK_TAG] FUSEIO %s\n", &fuse_iolog_buf[0]);
@@ -294,6 +319,61 @@ inline int fuse_iolog_proc_update(struct fuse_proc_info *info,
 	return 0;
 }
 
+static void fuse_iolog_rw_add(struct fuse_rw_info *dst,
+	struct fuse_rw_info *src)
+{
+	dst->count += src->count;
+	dst->bytes += src->bytes;
+	dst->us += src->us;
+}
+
+/* fold one per-cpu entry into fuse_iolog, with fuse_iolog_lock held */
+static void fuse_iolog_merge(struct fuse_proc_info *src)
+{
+	struct fuse_proc_info *info;
+	int i;
+
+	for (i = 0; i < FUSE_IOLOG_MAX; i++) {
+		info = &fuse_iolog[i];
+		if (!info->valid)
+			break;
+		if (info->pid == src->pid && (!src->misc_type ||
+		    !info->misc_type || info->misc_type == src->misc_type))
+			goto merge;
+	}
+
+	if (i == FUSE_IOLOG_MAX) {
+		fuse_iolog_print();
+		fuse_iolog_clear();
+		info = &fuse_iolog[0];
+	}
+	info->valid = 1;
+	info->pid = src->pid;
+merge:
+	if (src->misc_type)
+		info->misc_type = src->misc_type;
+	fuse_iolog_rw_add(&info->read, &src->read);
+	fuse_iolog_rw_add(&info->write, &src->write);
+	fuse_iolog_rw_add(&info->misc, &src->misc);
+}
+
+static void fuse_iolog_collect(void)
+{
+	struct fuse_iolog_cpu *pc;
+	int cpu, i;
+
+	for_each_possible_cpu(cpu) {
+		pc = &per_cpu(fuse_iolog_pcpu, cpu);
+		spin_lock(&pc->lock);
+		for (i = 0; i < FUSE_IOLOG_MAX && pc->info[i].valid; i++)
+			fuse_iolog_merge(&pc->info[i]);
+		memset(pc->info, 0, sizeof(pc->info));
+		fuse_iolog_dropped += pc->dropped;
+		pc->dropped = 0;
+		spin_unlock(&pc->lock);
+	}
+}
+
 static int fuse_iolog_watch(void *arg)
 {
 	unsigned int timeout;
@@ -317,6 +397,7 @@ static int fuse_iolog_watch(void *arg)
 
 		mutex_lock(&fuse_iolog_lock);
 
+		fuse_iolog_collect();
 		n = fuse_iolog_print();
 
 		if (n > 0) {
@@ -417,6 +498,7 @@ static const struct file_operations fuseio_seq_debug_fops = {
 void fuse_iolog_init(void)
 {
 	int ret;
+	int i;
 
 	fuse_iolog_buf = kmalloc(FUSE_IOLOG_BUFLEN, GFP_NOFS);
 	fuse_iolog = kmalloc_array(FUSE_IOLOG_MAX, sizeof(struct fuse_proc_info), GFP_NOFS);
@@ -425,6 +507,9 @@ void fuse_iolog_init(void)
 	if (!fuse_iolog_buf || !fuse_iolog || !fuse_ringbuf)
 		goto error_out;
 
+	for_each_possible_cpu(i)
+		spin_lock_init(&per_cpu(fuse_iolog_pcpu, i).lock);
+
 	mutex_init(&fuse_iolog_lock);
 	mutex_lock(&fuse_iolog_lock);
 	fuse_iolog_clear();
@@ -481,6 +566,7 @@ void fuse_iolog_add(__u32 io_bytes, int type,
 	struct timespec *start,
 	struct timespec *end)
 {
+	struct fuse_iolog_cpu *pc;
 	struct fuse_proc_info *info;
 	struct timespec diff;
 	pid_t pid;
@@ -489,10 +575,11 @@ void fuse_iolog_add(__u32 io_bytes, int type,
 	pid = task_pid_nr(current);
 	fuse_time_diff(start, end, &diff);
 
-	mutex_lock(&fuse_iolog_lock);
+	pc = &get_cpu_var(fuse_iolog_pcpu);
+	spin_lock(&pc->lock);
 
 	for (i = 0; i < FUSE_IOLOG_MAX; i++)   {
-		info = &fuse_iolog[i];
+		info = &pc->info[i];
 		if (info->valid) {
 			if (info->pid == pid) {
 				if (fuse_iolog_proc_update(info, io_bytes, type, &diff))
@@ -514,15 +601,11 @@ void fuse_iolog_add(__u32 io_bytes, int type,
 		}
 	}
 
-	if (i == FUSE_IOLOG_MAX) {
-		fuse_iolog_print();
-		fuse_iolog_clear();
-		info = &fuse_iolog[0];
-		info->valid = 1;
-		info->pid = pid;
-		fuse_iolog_proc_update(info, io_bytes, type, &diff);
-	}
+	/* table full until the next collection, don't stall the request */
+	pc->dropped++;
+	if (fuse_iolog_thread)
+		wake_up_process(fuse_iolog_thread);
 out:
-	mutex_unlock(&fuse_iolog_lock);
+	spin_unlock(&pc->lock);
+	put_cpu_var(fuse_iolog_pcpu);
 }
-
@@ -0,0 +1,166 @@
+/*
+  FUSE: passthrough read/write/mmap to a lower file
+
+  This program can be distributed under the terms of the GNU GPL.
+  See the file COPYING.
+*/
+
+#include "fuse_i.h"
+#include "mt_fuse.h"
+
+#include <linux/file.h>
+#include <linux/fs.h>
+#include <linux/aio.h>
+#include <linux/mm.h>
+#include <linux/uio.h>
+
+/*
+ * Called from fuse_dev_do_write() in the context of the daemon, so that
+ * passthrough_fd is looked up in the daemon's file table.  The reference
+ * is kept in the request until the opener moves it into its fuse_file.
+ */
+void fuse_setup_passthrough(struct fuse_conn *fc, struct fuse_req *req)
+{
+	struct fuse_open_out *open_out;
+	struct file *filp;
+	struct inode *inode;
+
+	if (req->in.h.opcode == FUSE_OPEN && req->out.numargs == 1)
+		open_out = req->out.args[0].value;
+	else if (req->in.h.opcode == FUSE_CREATE && req->out.numargs == 2)
+		open_out = req->out.args[1].value;
+	else
+		return;
+
+	if (req->out.h.error || !(open_out->open_flags & FOPEN_PASSTHROUGH))
+		return;
+	open_out->open_flags &= ~FOPEN_PASSTHROUGH;
+
+	filp = fget(open_out->passthrough_fd);
+	if (!filp) {
+		pr_warn("fuse: passthrough fd %d is not open\n",
+			open_out->passthrough_fd);
+		return;
+	}
+
+	inode = file_inode(filp);
+	if (!S_ISREG(inode->i_mode) ||
+	    !filp->f_op->read_iter || !filp->f_op->write_iter ||
+	    inode->i_sb->s_stack_depth >= FILESYSTEM_MAX_STACK_DEPTH) {
+		pr_warn("fuse: passthrough fd %d cannot be used\n",
+			open_out->passthrough_fd);
+		fput(filp);
+		return;
+	}
+
+	req->passthrough_filp = filp;
+}
+
+void fuse_passthrough_open(struct fuse_file *ff, struct fuse_req *req)
+{
+	ff->passthrough_filp = req->passthrough_filp;
+	req->passthrough_filp = NULL;
+}
+
+void fuse_passthrough_release(struct fuse_file *ff)
+{
+	if (ff->passthrough_filp) {
+		fput(ff->passthrough_filp);
+		ff->passthrough_filp = NULL;
+	}
+}
+
+/* keep the fuse inode size and page cache in line with the lower file */
+static void fuse_passthrough_update(struct inode *inode, struct file *lower,
+				    loff_t pos, ssize_t written)
+{
+	struct fuse_conn *fc = get_fuse_conn(inode);
+	struct fuse_inode *fi = get_fuse_inode(inode);
+
+	spin_lock(&fc->lock);
+	fi->attr_version = ++fc->attr_version;
+	i_size_write(inode, i_size_read(file_inode(lower)));
+	spin_unlock(&fc->lock);
+
+	if (inode->i_mapping->nrpages)
+		invalidate_inode_pages2_range(inode->i_mapping,
+				pos >> PAGE_CACHE_SHIFT,
+				(pos + written - 1) >> PAGE_CACHE_SHIFT);
+	fuse_invalidate_attr(inode);
+}
+
+static ssize_t fuse_passthrough_rw(struct kiocb *iocb, struct iov_iter *iter,
+				   int rw)
+{
+	struct file *file = iocb->ki_filp;
+	struct fuse_file *ff = file->private_data;
+	struct file *lower = ff->passthrough_filp;
+	struct kiocb kiocb;
+	loff_t pos = iocb->ki_pos;
+	ssize_t ret;
+	FUSE_IOLOG_INIT(iov_iter_count(iter), rw == WRITE ? FUSE_WRITE :
+			FUSE_READ);
+
+	if (rw == WRITE && (file->f_flags & O_APPEND))
+		pos = i_size_read(file_inode(lower));
+
+	/* the lower operation completes before the fuse iocb does */
+	init_sync_kiocb(&kiocb, lower);
+	kiocb.ki_pos = pos;
+	kiocb.ki_nbytes = iov_iter_count(iter);
+
+	FUSE_IOLOG_START();
+	if (rw == WRITE) {
+		file_start_write(lower);
+		ret = lower->f_op->write_iter(&kiocb, iter);
+		file_end_write(lower);
+	} else {
+		ret = lower->f_op->read_iter(&kiocb, iter);
+	}
+	if (ret == -EIOCBQUEUED)
+		ret = wait_on_sync_kiocb(&kiocb);
+	FUSE_IOLOG_END();
+	FUSE_IOLOG_PRINT();
+
+	if (ret > 0) {
+		iocb->ki_pos = kiocb.ki_pos;
+		if (rw == WRITE)
+			fuse_passthrough_update(file_inode(file), lower,
+						pos, ret);
+	}
+	return ret;
+}
+
+ssize_t fuse_passthrough_read_iter(struct kiocb *iocb, struct iov_iter *to)
+{
+	return fuse_passthrough_rw(iocb, to, READ);
+}
+
+ssize_t fuse_passthrough_write_iter(struct kiocb *iocb, struct iov_iter *from)
+{
+	return fuse_passthrough_rw(iocb, from, WRITE);
+}
+
+/*
+ * Map the lower file directly: the vma holds the lower file from now on,
+ * so faults never come back to fuse.
+ */
+int fuse_passthrough_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct fuse_file *ff = file->private_data;
+	struct file *lower = ff->passthrough_filp;
+	int ret;
+
+	if (!lower->f_op->mmap)
+		return -ENODEV;
+
+	vma->vm_file = get_file(lower);
+	ret = lower->f_op->mmap(lower, vma);
+	if (ret) {
+		vma->vm_file = file;
+		fput(lower);
+	} else {
+		fput(file);
+	}
+	return ret;
+}
@@ -62,11 +62,20 @@ static void journal_brelse_array(struct buffer_head *b[], int n)
  * do the IO in reasonably large chunks.
  *
  * This is not so critical that we need to be enormously clever about
- * the readahead size, though.  128K is a purely arbitrary, good-enough
- * fixed value.
+ * the readahead size, though.  It only needs to be deep enough to keep
+ * flash storage busy while the previous window is being parsed: jread()
+ * starts the next window once the scan is half way through the current
+ * one, so the passes rarely wait on the device.
  */
 
-#define MAXBUF 8
+#define MAXBUF 32
+#define JBD2_RECOVERY_RA_SIZE	(512 * 1024)
+
+static inline unsigned int jbd2_recovery_ra_blocks(journal_t *journal)
+{
+	return JBD2_RECOVERY_RA_SIZE / journal->j_blocksize;
+}
+
 static int do_readahead(journal_t *journal, unsigned int start)
 {
 	int err;
@@ -76,8 +85,7 @@ static int do_readahead(journal_t *journal, unsigned int start)
 
 	struct buffer_head * bufs[MAXBUF];
 
-	/* Do up to 128K of readahead */
-	max = start + (128 * 1024 / journal->j_blocksize);
+	max = start + jbd2_recovery_ra_blocks(journal);
 	if (max > journal->j_maxlen)
 		max = journal->j_maxlen;
 
@@ -122,6 +130,29 @@ failed:
 	return err;
 }
 
+/*
+ * Keep the readahead window ahead of the scan: if the block half a
+ * window further on is not cached yet, start reading from there.
+ */
+static void jbd2_readahead_ahead(journal_t *journal, unsigned int offset)
+{
+	unsigned int next = offset + jbd2_recovery_ra_blocks(journal) / 2;
+	unsigned long long blocknr;
+	struct buffer_head *bh;
+
+	if (next >= journal->j_maxlen)
+		return;
+	if (jbd2_journal_bmap(journal, next, &blocknr))
+		return;
+
+	bh = __find_get_block(journal->j_dev, blocknr, journal->j_blocksize);
+	if (bh) {
+		brelse(bh);
+		return;
+	}
+	do_readahead(journal, next);
+}
+
 #endif /* __KERNEL__ */
 
 
@@ -162,6 +193,7 @@ static int jread(struct buffer_head **bhp, journal_t *journal,
 			do_readahead(journal, offset);
 		wait_on_buffer(bh);
 	}
+	jbd2_readahead_ahead(journal, offset);
 
 	if (!buffer_uptodate(bh)) {
 		printk(KERN_ERR "JBD2: Failed to read block at offset %u\n",
@@ -80,6 +80,7 @@
 #include <linux/poll.h>
 #include <linux/nsproxy.h>
 #include <linux/oom.h>
+#include <linux/khugepaged.h>
 #include <linux/elf.h>
 #include <linux/pid_namespace.h>
 #include <linux/user_namespace.h>
@@ -898,11 +899,14 @@ static ssize_t oom_adj_write(struct file *file, const char __user *buf,
 		  task_pid_nr(task));
 
 	task->signal->oom_score_adj = oom_adj;
+	khugepaged_adj_update(task->mm, oom_adj);
 	trace_oom_score_adj_update(task);
 err_sighand:
 	unlock_task_sighand(task, &flags);
 err_task_lock:
 	task_unlock(task);
+	if (!err)
+		lmk_adj_index_update(task);
 	put_task_struct(task);
 out:
 	return err < 0 ? err : count;
@@ -986,12 +990,15 @@ static ssize_t oom_score_adj_write(struct file *file, const char __user *buf,
 	task->signal->oom_score_adj = (short)oom_score_adj;
 	if (has_capability_noaudit(current, CAP_SYS_RESOURCE))
 		task->signal->oom_score_adj_min = (short)oom_score_adj;
+	khugepaged_adj_update(task->mm, (short)oom_score_adj);
 	trace_oom_score_adj_update(task);
 
 err_sighand:
 	unlock_task_sighand(task, &flags);
 err_task_lock:
 	task_unlock(task);
+	if (!err)
+		lmk_adj_index_update(task);
 	put_task_struct(task);
 out:
 	return err < 0 ? err : count;
@@ -66,6 +66,15 @@ void task_mem(struct seq_file *m, struct mm_struct *mm)
 		(PTRS_PER_PTE * sizeof(pte_t) *
 		 atomic_long_read(&mm->nr_ptes)) >> 10,
 		swap << (PAGE_SHIFT-10));
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	seq_printf(m,
+		"ThpFaults:\t%u\n"
+		"ThpCollapses:\t%u\n"
+		"ThpSplits:\t%u\n",
+		atomic_read(&mm->thp_faults),
+		atomic_read(&mm->thp_collapses),
+		atomic_read(&mm->thp_splits));
+#endif
 }
 
 unsigned long task_vsize(struct mm_struct *mm)
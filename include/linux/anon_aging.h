@@ -0,0 +1,107 @@
+#ifndef _LINUX_ANON_AGING_H
+#define _LINUX_ANON_AGING_H
+
+#include <linux/mm.h>
+#include <linux/page-flags.h>
+#include <linux/vmstat.h>
+
+#ifdef CONFIG_ANON_AGING
+/*
+ * Anonymous pages on the LRU are sorted into generations by a 2-bit age
+ * kept in page->flags.  Generation 0 holds pages that were just faulted
+ * in, or that the page table walker or reclaim found in use; every pass
+ * of reclaim over the active list moves an idle page one generation
+ * older, and only pages that reached anon_aging_evict_gen are deactivated
+ * and considered for swap out.
+ */
+#define ANON_AGE_SHIFT		PG_anon_age0
+#define ANON_AGE_MASK		(3UL << ANON_AGE_SHIFT)
+#define ANON_AGE_MAX		3
+
+extern int anon_aging_enabled;
+extern int anon_aging_evict_gen;
+
+static inline int page_anon_age(struct page *page)
+{
+	return (page->flags & ANON_AGE_MASK) >> ANON_AGE_SHIFT;
+}
+
+static inline void set_page_anon_age(struct page *page, int age)
+{
+	unsigned long old, new;
+
+	do {
+		old = ACCESS_ONCE(page->flags);
+		new = (old & ~ANON_AGE_MASK) |
+		      ((unsigned long)age << ANON_AGE_SHIFT);
+	} while (cmpxchg(&page->flags, old, new) != old);
+}
+
+/* Pages added to the active list start young, the rest (swap readahead) old */
+static inline void anon_aging_lru_add(struct page *page)
+{
+	if (anon_aging_enabled && PageSwapBacked(page))
+		set_page_anon_age(page, PageActive(page) ? 0 : ANON_AGE_MAX);
+}
+
+/*
+ * Reclaim found @page on the active anon list: move it to an older
+ * generation, or back to the youngest if it was @referenced.  Returns
+ * true if the page is still too young to be deactivated.
+ */
+static inline bool anon_aging_keep_active(struct page *page, bool referenced)
+{
+	int age;
+
+	if (!anon_aging_enabled)
+		return false;
+
+	if (referenced) {
+		set_page_anon_age(page, 0);
+		count_vm_event(ANON_AGING_KEEP);
+		return true;
+	}
+
+	age = page_anon_age(page);
+	if (age < ANON_AGE_MAX)
+		set_page_anon_age(page, age + 1);
+
+	if (age + 1 >= anon_aging_evict_gen)
+		return false;
+
+	count_vm_event(ANON_AGING_KEEP);
+	return true;
+}
+
+/* The page table walker saw @page in use after it was deactivated */
+static inline bool anon_aging_page_young(struct page *page)
+{
+	if (!anon_aging_enabled || !PageAnon(page) || page_anon_age(page))
+		return false;
+
+	count_vm_event(ANON_AGING_ACTIVATE);
+	return true;
+}
+
+extern void anon_aging_kick(void);
+#else
+static inline void anon_aging_lru_add(struct page *page)
+{
+}
+
+static inline bool anon_aging_keep_active(struct page *page, bool referenced)
+{
+	return false;
+}
+
+static inline bool anon_aging_page_young(struct page *page)
+{
+	return false;
+}
+
+static inline void anon_aging_kick(void)
+{
+}
+#endif /* CONFIG_ANON_AGING */
+
+#endif /* _LINUX_ANON_AGING_H */
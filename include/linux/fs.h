@@ -772,6 +772,9 @@ struct file_ra_state {
 	unsigned int ra_pages;		/* Maximum readahead window */
 	unsigned int mmap_miss;		/* Cache miss stat for mmap accesses */
 	loff_t prev_pos;		/* Cache last read() position */
+
+	unsigned short ra_hit;		/* windows consumed, see ra_adapt() */
+	unsigned short ra_miss;		/* windows evicted before use */
 };
 
 /*
@@ -23,6 +23,10 @@ struct inet_diag_handler {
 	void			(*idiag_get_info)(struct sock *sk,
 						  struct inet_diag_msg *r,
 						  void *info);
+
+	/* optional, adds per protocol attributes along with the info */
+	int			(*idiag_get_aux)(struct sock *sk,
+						 struct sk_buff *skb);
 	__u16                   idiag_type;
 };
 
@@ -36,6 +36,9 @@ static inline void khugepaged_exit(struct mm_struct *mm)
 		__khugepaged_exit(mm);
 }
 
+/* oom_score_adj of the owner changed, called with task_lock held */
+extern void khugepaged_adj_update(struct mm_struct *mm, short adj);
+
 static inline int khugepaged_enter(struct vm_area_struct *vma,
 				   unsigned long vm_flags)
 {
@@ -55,6 +58,9 @@ static inline int khugepaged_fork(struct mm_struct *mm, struct mm_struct *oldmm)
 static inline void khugepaged_exit(struct mm_struct *mm)
 {
 }
+static inline void khugepaged_adj_update(struct mm_struct *mm, short adj)
+{
+}
 static inline int khugepaged_enter(struct vm_area_struct *vma,
 				   unsigned long vm_flags)
 {
@@ -85,6 +85,9 @@ struct mmc_ext_csd {
 	unsigned int		hpi_cmd;		/* cmd used as HPI */
 	bool			bkops;		/* background support bit */
 	bool			bkops_en;	/* background enable bit */
+	bool			cmdq_support;	/* command queue support bit */
+	bool			cmdq_en;	/* command queue enable bit */
+	unsigned int		cmdq_depth;	/* command queue depth */
 	unsigned int            data_sector_size;       /* 512 bytes or 4KB */
 	unsigned int            data_tag_unit_size;     /* DATA TAG UNIT size */
 	unsigned int		boot_ro_lock;		/* ro lock support */
@@ -199,6 +199,7 @@ extern void mmc_get_card(struct mmc_card *card);
 extern void mmc_put_card(struct mmc_card *card);
 
 extern int mmc_flush_cache(struct mmc_card *);
+extern int mmc_cmdq_switch(struct mmc_card *, bool);
 
 extern int mmc_detect_card_removed(struct mmc_host *host);
 
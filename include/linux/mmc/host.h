@@ -290,6 +290,7 @@ struct mmc_host {
 #define MMC_CAP2_HS400		(MMC_CAP2_HS400_1_8V | \
 				 MMC_CAP2_HS400_1_2V)
 #define MMC_CAP2_SDIO_IRQ_NOTHREAD (1 << 17)
+#define MMC_CAP2_CMDQ		(1 << 18)	/* Can do eMMC command queue */
 
 	mmc_pm_flag_t		pm_caps;	/* supported pm features */
 
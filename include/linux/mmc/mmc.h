@@ -85,6 +85,13 @@ extern const u8 tuning_blk_pattern_8bit[MMC_TUNING_BLK_PATTERN_8BIT_SIZE];
   /* class 7 */
 #define MMC_LOCK_UNLOCK          42   /* adtc                    R1b */
 
+  /* class 11 */
+#define MMC_QUE_TASK_PARAMS      44   /* ac   [20:16] task id    R1  */
+#define MMC_QUE_TASK_ADDR        45   /* ac   [31:0] data addr   R1  */
+#define MMC_EXECUTE_READ_TASK    46   /* adtc [20:16] task id    R1  */
+#define MMC_EXECUTE_WRITE_TASK   47   /* adtc [20:16] task id    R1  */
+#define MMC_CMDQ_TASK_MGMT       48   /* ac   [20:16] task id    R1b */
+
   /* class 8 */
 #define MMC_APP_CMD              55   /* ac   [31:16] RCA        R1  */
 #define MMC_GEN_CMD              56   /* adtc [0] RD/WR          R1  */
@@ -106,6 +113,27 @@ static inline bool mmc_op_multi(u32 opcode)
  *	[02:00] Command Set
  */
 
+/*
+ * MMC_QUE_TASK_PARAMS argument format:
+ *
+ *	[31]	Reliable Write Request
+ *	[30]	Data Direction (1 = read)
+ *	[23]	Priority
+ *	[20:16] Task ID
+ *	[15:00] Number of Blocks
+ *
+ * MMC_SEND_STATUS with SQS set returns the Queue Status Register,
+ * one ready bit per task ID.
+ */
+#define MMC_CMDQ_REL_WR		(1 << 31)
+#define MMC_CMDQ_DATA_DIR_READ	(1 << 30)
+#define MMC_CMDQ_PRIORITY	(1 << 23)
+#define MMC_CMDQ_TASK_ID(x)	((x) << 16)
+#define MMC_SEND_STATUS_SQS	(1 << 15)
+
+#define MMC_CMDQ_DISCARD_QUEUE	1	/* MMC_CMDQ_TASK_MGMT op codes */
+#define MMC_CMDQ_DISCARD_TASK	2
+
 /*
   MMC status in R1, for native mode (SPI bits are different)
   Type
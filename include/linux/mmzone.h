@@ -65,6 +65,7 @@ enum {
 
 #ifdef CONFIG_CMA
 #  define is_migrate_cma(migratetype) unlikely((migratetype) == MIGRATE_CMA)
+extern unsigned long cma_fallback_free_pages;
 #else
 #  define is_migrate_cma(migratetype) false
 #endif
@@ -211,6 +212,14 @@ struct zone_reclaim_stat {
 	 */
 	unsigned long		recent_rotated[2];
 	unsigned long		recent_scanned[2];
+
+	/*
+	 * File pages that refaulted into the working set: the zone's
+	 * WORKINGSET_ACTIVATE count when last sampled, and the refaults
+	 * accumulated since, decayed along with recent_scanned[1].
+	 */
+	unsigned long		refaults;
+	unsigned long		recent_refaulted;
 };
 
 struct lruvec {
@@ -753,6 +762,10 @@ typedef struct pglist_data {
 					   mem_hotplug_begin/end() */
 	int kswapd_max_order;
 	enum zone_type classzone_idx;
+#ifdef CONFIG_COMPACTION
+	wait_queue_head_t kcompactd_wait;
+	struct task_struct *kcompactd;	/* proactive compaction daemon */
+#endif
 #ifdef CONFIG_NUMA_BALANCING
 	/* Lock serializing the migrate rate limiting window */
 	spinlock_t numabalancing_migrate_lock;
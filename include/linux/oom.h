@@ -92,6 +92,21 @@ static inline bool oom_gfp_allowed(gfp_t gfp_mask)
 
 extern struct task_struct *find_lock_task_mm(struct task_struct *p);
 
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+/* Hooks keeping the low memory killer's oom_score_adj index in sync */
+extern void lmk_adj_index_add(struct task_struct *p);
+extern void lmk_adj_index_del(struct task_struct *p);
+extern void lmk_adj_index_replace(struct task_struct *old,
+				  struct task_struct *new);
+extern void lmk_adj_index_update(struct task_struct *p);
+#else
+static inline void lmk_adj_index_add(struct task_struct *p) {}
+static inline void lmk_adj_index_del(struct task_struct *p) {}
+static inline void lmk_adj_index_replace(struct task_struct *old,
+					 struct task_struct *new) {}
+static inline void lmk_adj_index_update(struct task_struct *p) {}
+#endif
+
 /* sysctls */
 extern int sysctl_oom_dump_tasks;
 extern int sysctl_oom_kill_allocating_task;
@@ -109,6 +109,10 @@ enum pageflags {
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
 	PG_compound_lock,
 #endif
+#ifdef CONFIG_ANON_AGING
+	PG_anon_age0,		/* Anon page generation, 2 bits, */
+	PG_anon_age1,		/* see <linux/anon_aging.h> */
+#endif
 #ifdef CONFIG_TOI_INCREMENTAL
 	PG_toi_ignore,		/* Ignore this page */
 	PG_toi_ro,		/* Page was made RO by TOI */
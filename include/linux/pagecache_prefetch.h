@@ -0,0 +1,28 @@
+#ifndef _LINUX_PAGECACHE_PREFETCH_H
+#define _LINUX_PAGECACHE_PREFETCH_H
+
+#include <linux/fs.h>
+
+#ifdef CONFIG_PAGECACHE_PREFETCH
+/*
+ * While a trace is recorded, every page cache miss of a read or a fault
+ * on a block backed file is logged in order as a (file, page range).
+ */
+extern bool prefetch_recording;
+extern void __prefetch_record(struct file *file, pgoff_t index,
+			      unsigned long nr);
+
+static inline void prefetch_record(struct file *file, pgoff_t index,
+				   unsigned long nr)
+{
+	if (unlikely(prefetch_recording))
+		__prefetch_record(file, index, nr);
+}
+#else
+static inline void prefetch_record(struct file *file, pgoff_t index,
+				   unsigned long nr)
+{
+}
+#endif
+
+#endif /* _LINUX_PAGECACHE_PREFETCH_H */
@@ -702,6 +702,8 @@ extern void __suspend_report_result(const char *function, void *fn, int ret);
 
 extern int device_pm_wait_for_dev(struct device *sub, struct device *dev);
 extern void dpm_for_each_dev(void *data, void (*fn)(struct device *, void *));
+extern int device_pm_add_link(struct device *consumer, struct device *supplier);
+extern void device_pm_remove_links(struct device *dev);
 
 extern int pm_generic_prepare(struct device *dev);
 extern int pm_generic_suspend_late(struct device *dev);
@@ -745,6 +747,16 @@ static inline void dpm_for_each_dev(void *data, void (*fn)(struct device *, void
 {
 }
 
+static inline int device_pm_add_link(struct device *consumer,
+				     struct device *supplier)
+{
+	return 0;
+}
+
+static inline void device_pm_remove_links(struct device *dev)
+{
+}
+
 #define pm_generic_prepare		NULL
 #define pm_generic_suspend_late		NULL
 #define pm_generic_suspend_noirq	NULL
@@ -39,6 +39,7 @@
 #define RTPM_PRIO_WDT                       REG_RT_PRIO(99)
 
 #define RTPM_PRIO_TPD                       REG_RT_PRIO(4)
+#define RTPM_PRIO_VIBRATOR                  REG_RT_PRIO(4)
 #define RTPM_PRIO_KSDIOIRQ                  REG_RT_PRIO(1)
 #define RTPM_PRIO_MTLTE_SYS_SDIO_THREAD     REG_RT_PRIO(96)
 
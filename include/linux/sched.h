@@ -466,6 +466,7 @@ static inline int get_dumpable(struct mm_struct *mm)
 
 #define MMF_HAS_UPROBES		19	/* has uprobes */
 #define MMF_RECALC_UPROBES	20	/* MMF_HAS_UPROBES can be wrong */
+#define MMF_THP_FOREGROUND	21	/* khugepaged may collapse, see oom_score_adj */
 
 #define MMF_INIT_MASK		(MMF_DUMPABLE_MASK | MMF_DUMP_FILTER_MASK)
 
@@ -1081,6 +1082,36 @@ struct hmp_domain {
 	struct list_head hmp_domains;
 };
 
+/*
+ * Energy model of a cpu or of its cluster, from the sched-energy-costs
+ * device tree nodes.  cap_states are sorted by increasing capacity, and
+ * idle_states from the shallowest to the deepest state.
+ */
+struct capacity_state {
+	unsigned long cap;	/* compute capacity at this OPP */
+	unsigned long power;	/* power when busy at this OPP */
+};
+
+struct idle_state {
+	unsigned long power;	/* power when idle in this state */
+};
+
+struct sched_group_energy {
+	unsigned int nr_idle_states;
+	struct idle_state *idle_states;
+	unsigned int nr_cap_states;
+	struct capacity_state *cap_states;
+};
+
+enum sched_energy_level {
+	SCHED_ENERGY_CPU,
+	SCHED_ENERGY_CLUSTER,
+	NR_SCHED_ENERGY_LEVELS
+};
+
+extern const struct sched_group_energy *
+arch_get_energy_costs(int cpu, enum sched_energy_level level);
+
 #ifdef CONFIG_HMP_TRACER
 struct hmp_statisic {
 	unsigned int nr_force_up;   /* The number of task force up-migration */
@@ -1183,6 +1214,8 @@ struct sched_statistics {
 	u64			nr_failed_migrations_running;
 	u64			nr_failed_migrations_hot;
 	u64			nr_forced_migrations;
+	u64			nr_migrations_xcluster;
+	u64			nr_failed_migrations_xcluster_hot;
 
 	u64			nr_wakeups;
 	u64			nr_wakeups_sync;
@@ -1238,9 +1271,26 @@ struct sched_entity {
 #if defined(CONFIG_MTPROF_CPUTIME) || defined(CONFIG_MT_RT_THROTTLE_MON)
 	u64			mtk_isr_time;
 #endif
+#ifdef CONFIG_MT_RT_THROTTLE_MON
+	/* rt throttle monitor window, see mt_rt_mon_account() */
+	u32			mtk_rt_mon_gen;
+	u64			mtk_rt_mon_cputime;
+	u64			mtk_rt_mon_isr_start;
+#endif
 #ifdef CONFIG_MTPROF_CPUTIME
 	int			mtk_isr_count;
 	struct mtk_isr_info  *mtk_isr;
+	/* mtprof/cputime_snap: runtime reported so far and its record */
+	u64			mtk_snap_runtime;
+	u32			mtk_snap_gen;
+	u16			mtk_snap_cpu;
+	u16			mtk_snap_slot;
+#endif
+#ifdef CONFIG_MTPROF_PMU_TASK
+#define MTK_PMU_NR_EVENTS	5
+	/* mtprof/pmu_task: PMU counts in window mtk_pmu_gen */
+	u64			mtk_pmu_count[MTK_PMU_NR_EVENTS];
+	u32			mtk_pmu_gen;
 #endif
 };
 
@@ -1420,6 +1470,9 @@ struct task_struct {
 #endif
 
 	struct list_head tasks;
+#ifdef CONFIG_ANDROID_LOW_MEMORY_KILLER_ADJ_INDEX
+	struct list_head lmk_adj_node;
+#endif
 #ifdef CONFIG_SMP
 	struct plist_node pushable_tasks;
 	struct rb_node pushable_dl_tasks;
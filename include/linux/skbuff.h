@@ -2632,6 +2632,10 @@ struct sk_buff *__skb_recv_datagram(struct sock *sk, unsigned flags,
 				    int *peeked, int *off, int *err);
 struct sk_buff *skb_recv_datagram(struct sock *sk, unsigned flags, int noblock,
 				  int *err);
+struct sk_buff *__skb_recv_datagram_batch(struct sock *sk,
+					  struct sk_buff_head *reader,
+					  unsigned flags, int *peeked,
+					  int *off, int *err);
 unsigned int datagram_poll(struct file *file, struct socket *sock,
 			   struct poll_table_struct *wait);
 int skb_copy_datagram_iovec(const struct sk_buff *from, int offset,
@@ -2648,6 +2652,8 @@ int skb_copy_datagram_const_iovec(const struct sk_buff *from, int offset,
 				  int size);
 void skb_free_datagram(struct sock *sk, struct sk_buff *skb);
 void skb_free_datagram_locked(struct sock *sk, struct sk_buff *skb);
+int __skb_kill_datagram(struct sock *sk, struct sk_buff_head *queue,
+			struct sk_buff *skb, unsigned int flags);
 int skb_kill_datagram(struct sock *sk, struct sk_buff *skb, unsigned int flags);
 int skb_copy_bits(const struct sk_buff *skb, int offset, void *to, int len);
 int skb_store_bits(struct sk_buff *skb, int offset, const void *from, int len);
@@ -8,6 +8,9 @@
  */
 #include <linux/kobject.h>
 
+/* __slab_alloc() latency buckets: < 1us, then 4 times wider each */
+#define NR_SLUB_LATENCY_BUCKETS	6
+
 enum stat_item {
 	ALLOC_FASTPATH,		/* Allocation from cpu slab */
 	ALLOC_SLOWPATH,		/* Allocation by getting a new cpu slab */
@@ -35,6 +38,9 @@ enum stat_item {
 	CPU_PARTIAL_FREE,	/* Refill cpu partial on free */
 	CPU_PARTIAL_NODE,	/* Refill cpu partial from node partial */
 	CPU_PARTIAL_DRAIN,	/* Drain cpu partial to node partial */
+	ALLOC_SLOWPATH_LATENCY,	/* Histogram of slowpath latency */
+	ALLOC_SLOWPATH_LATENCY_LAST = ALLOC_SLOWPATH_LATENCY +
+					NR_SLUB_LATENCY_BUCKETS - 1,
 	NR_SLUB_STAT_ITEMS };
 
 struct kmem_cache_cpu {
@@ -126,6 +126,16 @@ static inline struct tcp_request_sock *tcp_rsk(const struct request_sock *req)
 	return (struct tcp_request_sock *)req;
 }
 
+/* Sender states timed by the chronograph, in increasing priority */
+enum tcp_chrono {
+	TCP_CHRONO_UNSPEC,
+	TCP_CHRONO_BUSY,		/* data queued or in flight */
+	TCP_CHRONO_CWND_LIMITED,	/* stalled on the congestion window */
+	TCP_CHRONO_RWND_LIMITED,	/* stalled on the peer's window */
+	TCP_CHRONO_SNDBUF_LIMITED,	/* the writer waits for sndbuf */
+	__TCP_CHRONO_MAX,
+};
+
 struct tcp_sock {
 	/* inet_connection_sock has to be the first member of tcp_sock */
 	struct inet_connection_sock	inet_conn;
@@ -272,6 +282,11 @@ struct tcp_sock {
 	int	undo_retrans;	/* number of undoable retransmissions. */
 	u32	total_retrans;	/* Total retransmits for entire connection */
 
+	u8	chrono_type;	/* Currently timed enum tcp_chrono */
+	u32	chrono_start;	/* Start of the current chrono, in jiffies */
+	u32	chrono_stat[__TCP_CHRONO_MAX - 1]; /* jiffies per chrono */
+	u32	rtt_hist[TCP_DIAG_RTT_BUCKETS]; /* RTT samples, log2 ms */
+
 	u32	urg_seq;	/* Seq of received urgent pointer */
 	unsigned int		keepalive_time;	  /* time before keep alive takes place */
 	unsigned int		keepalive_intvl;  /* time interval between keep alive probes */
@@ -39,6 +39,8 @@ static inline int udp_hashfn(struct net *net, unsigned num, unsigned mask)
 	return (num + net_hash_mix(net)) & mask;
 }
 
+struct udp_tx_route;
+
 struct udp_sock {
 	/* inet_sock has to be the first member */
 	struct inet_sock inet;
@@ -75,6 +77,17 @@ struct udp_sock {
 	 */
 	int (*encap_rcv)(struct sock *sk, struct sk_buff *skb);
 	void (*encap_destroy)(struct sock *sk);
+	/*
+	 * Datagrams moved off sk_receive_queue in one go by the readers,
+	 * see __skb_recv_datagram_batch().
+	 */
+	struct sk_buff_head	reader_queue;
+	/*
+	 * Route of the last unconnected send, reused while the sender keeps
+	 * talking to the same peer.
+	 */
+	struct udp_tx_route __rcu *tx_route;
+	__be32			tx_last_daddr;
 };
 
 static inline struct udp_sock *udp_sk(const struct sock *sk)
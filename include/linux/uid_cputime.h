@@ -0,0 +1,30 @@
+/* include/linux/uid_cputime.h
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef __uid_cputime_h
+#define __uid_cputime_h
+
+#include <linux/types.h>
+#include <linux/uidgid.h>
+
+/* Usage of other engines charged to a uid, next to its cpu time. */
+
+#ifdef CONFIG_UID_CPUTIME
+void uid_cputime_add_gpu(kuid_t uid, u64 busy_us);
+#else
+static inline void uid_cputime_add_gpu(kuid_t uid, u64 busy_us)
+{
+}
+#endif
+
+#endif /* __uid_cputime_h */
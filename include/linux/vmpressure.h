@@ -8,6 +8,14 @@
 #include <linux/types.h>
 #include <linux/cgroup.h>
 #include <linux/eventfd.h>
+#include <linux/notifier.h>
+
+enum vmpressure_levels {
+	VMPRESSURE_LOW = 0,
+	VMPRESSURE_MEDIUM,
+	VMPRESSURE_CRITICAL,
+	VMPRESSURE_NUM_LEVELS,
+};
 
 struct vmpressure {
 	unsigned long scanned;
@@ -39,10 +47,20 @@ extern int vmpressure_register_event(struct mem_cgroup *memcg,
 				     const char *args);
 extern void vmpressure_unregister_event(struct mem_cgroup *memcg,
 					struct eventfd_ctx *eventfd);
+extern int vmpressure_notifier_register(struct notifier_block *nb);
+extern int vmpressure_notifier_unregister(struct notifier_block *nb);
 #else
 static inline void vmpressure(gfp_t gfp, struct mem_cgroup *memcg,
 			      unsigned long scanned, unsigned long reclaimed) {}
 static inline void vmpressure_prio(gfp_t gfp, struct mem_cgroup *memcg,
 				   int prio) {}
+static inline int vmpressure_notifier_register(struct notifier_block *nb)
+{
+	return -ENOSYS;
+}
+static inline int vmpressure_notifier_unregister(struct notifier_block *nb)
+{
+	return -ENOSYS;
+}
 #endif /* CONFIG_MEMCG */
 #endif /* __LINUX_VMPRESSURE_H */
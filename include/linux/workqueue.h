@@ -104,6 +104,9 @@ struct work_struct {
 #ifdef CONFIG_LOCKDEP
 	struct lockdep_map lockdep_map;
 #endif
+#ifdef CONFIG_MTK_WQ_STATS
+	u64 mtk_queue_ns;	/* sched_clock() at insert, 0 if not stamped */
+#endif
 };
 
 #define WORK_DATA_INIT()	ATOMIC_LONG_INIT(WORK_STRUCT_NO_POOL)
@@ -192,6 +195,12 @@ static inline void destroy_delayed_work_on_stack(struct delayed_work *work) { }
 static inline unsigned int work_static(struct work_struct *work) { return 0; }
 #endif
 
+#ifdef CONFIG_MTK_WQ_STATS
+#define __INIT_WORK_STATS(_work)	((_work)->mtk_queue_ns = 0)
+#else
+#define __INIT_WORK_STATS(_work)	do { } while (0)
+#endif
+
 /*
  * initialize all of a work item in one go
  *
@@ -209,6 +218,7 @@ static inline unsigned int work_static(struct work_struct *work) { return 0; }
 		lockdep_init_map(&(_work)->lockdep_map, #_work, &__key, 0); \
 		INIT_LIST_HEAD(&(_work)->entry);			\
 		(_work)->func = (_func);				\
+		__INIT_WORK_STATS(_work);				\
 	} while (0)
 #else
 #define __INIT_WORK(_work, _func, _onstack)				\
@@ -217,6 +227,7 @@ static inline unsigned int work_static(struct work_struct *work) { return 0; }
 		(_work)->data = (atomic_long_t) WORK_DATA_INIT();	\
 		INIT_LIST_HEAD(&(_work)->entry);			\
 		(_work)->func = (_func);				\
+		__INIT_WORK_STATS(_work);				\
 	} while (0)
 #endif
 
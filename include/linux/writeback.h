@@ -166,6 +166,23 @@ void __bdi_update_bandwidth(struct backing_dev_info *bdi,
 void page_writeback_init(void);
 void balance_dirty_pages_ratelimited(struct address_space *mapping);
 
+#ifdef CONFIG_BLK_CGROUP
+int blkcg_dirty_class(struct task_struct *tsk);
+void blkcg_account_dirty(struct task_struct *tsk, unsigned long dirtied,
+			 unsigned long paused);
+#else
+static inline int blkcg_dirty_class(struct task_struct *tsk)
+{
+	return 0;
+}
+
+static inline void blkcg_account_dirty(struct task_struct *tsk,
+				       unsigned long dirtied,
+				       unsigned long paused)
+{
+}
+#endif
+
 typedef int (*writepage_t)(struct page *page, struct writeback_control *wbc,
 				void *data);
 
@@ -26,7 +26,7 @@ static __inline__ int udplite_getfrag(void *from, char *to, int  offset,
 static inline int udplite_sk_init(struct sock *sk)
 {
 	udp_sk(sk)->pcflag = UDPLITE_BIT;
-	return 0;
+	return udp_init_sock(sk);
 }
 
 /*
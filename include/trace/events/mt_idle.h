@@ -0,0 +1,43 @@
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM mt_idle
+
+#if !defined(_TRACE_MT_IDLE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _TRACE_MT_IDLE_H
+
+#include <linux/tracepoint.h>
+
+/*
+ * A clock started or stopped keeping an SPM idle state out. @type is the
+ * IDLE_TYPE_* of mt_idle.c, @grp and @bit name the clock as in the
+ * enable/disable_xxidle_by_bit() ids (grp * 32 + bit).
+ */
+TRACE_EVENT(idle_blocker,
+
+	TP_PROTO(int type, int grp, int bit, bool on),
+
+	TP_ARGS(type, grp, bit, on),
+
+	TP_STRUCT__entry(
+		__field(int, type)
+		__field(int, grp)
+		__field(int, bit)
+		__field(bool, on)
+	),
+
+	TP_fast_assign(
+		__entry->type = type;
+		__entry->grp = grp;
+		__entry->bit = bit;
+		__entry->on = on;
+	),
+
+	TP_printk("type=%d id=%d grp=%d bit=%d %s",
+		  __entry->type, __entry->grp * 32 + __entry->bit,
+		  __entry->grp, __entry->bit,
+		  __entry->on ? "block" : "release")
+);
+
+#endif /* _TRACE_MT_IDLE_H */
+
+/* This part must be outside protection */
+#include <trace/define_trace.h>
@@ -1259,6 +1259,81 @@ TRACE_EVENT(sched_cfs_length,
 );
 #endif /* CONFIG_HMP_TRACER */
 
+#ifdef CONFIG_SCHED_HMP
+/*
+ * Tracepoint for the estimated energy of one candidate cpu
+ */
+TRACE_EVENT(sched_energy_cpu,
+
+	TP_PROTO(struct task_struct *tsk, int cpu, unsigned long util,
+		 unsigned long energy),
+
+	TP_ARGS(tsk, cpu, util, energy),
+
+	TP_STRUCT__entry(
+		__field(pid_t, pid)
+		__field(int, cpu)
+		__field(unsigned long, util)
+		__field(unsigned long, energy)
+	),
+
+	TP_fast_assign(
+		__entry->pid    = tsk->pid;
+		__entry->cpu    = cpu;
+		__entry->util   = util;
+		__entry->energy = energy;
+	),
+
+	TP_printk("pid=%d cpu=%d cpu-util=%lu energy=%lu",
+			__entry->pid,
+			__entry->cpu,
+			__entry->util,
+			__entry->energy)
+);
+
+/*
+ * Tracepoint for showing the result of energy aware wakeup selection
+ */
+TRACE_EVENT(sched_energy_select_task_rq,
+
+	TP_PROTO(struct task_struct *tsk, int prev_cpu, int target_cpu,
+		 unsigned long task_util, unsigned long prev_energy,
+		 unsigned long target_energy),
+
+	TP_ARGS(tsk, prev_cpu, target_cpu, task_util, prev_energy,
+		target_energy),
+
+	TP_STRUCT__entry(
+		__array(char, comm, TASK_COMM_LEN)
+		__field(pid_t, pid)
+		__field(int, prev_cpu)
+		__field(int, target_cpu)
+		__field(unsigned long, task_util)
+		__field(unsigned long, prev_energy)
+		__field(unsigned long, target_energy)
+	),
+
+	TP_fast_assign(
+		memcpy(__entry->comm, tsk->comm, TASK_COMM_LEN);
+		__entry->pid           = tsk->pid;
+		__entry->prev_cpu      = prev_cpu;
+		__entry->target_cpu    = target_cpu;
+		__entry->task_util     = task_util;
+		__entry->prev_energy   = prev_energy;
+		__entry->target_energy = target_energy;
+	),
+
+	TP_printk("pid=%4d task-util=%4lu pre-cpu=%d(%lu) target=%d(%lu) comm=%s",
+			__entry->pid,
+			__entry->task_util,
+			__entry->prev_cpu,
+			__entry->prev_energy,
+			__entry->target_cpu,
+			__entry->target_energy,
+			__entry->comm)
+);
+#endif /* CONFIG_SCHED_HMP */
+
 /*
  * Tracepoint for showing tracked rq runnable ratio [0..1023].
  */
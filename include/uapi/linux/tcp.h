@@ -191,6 +191,23 @@ struct tcp_info {
 	__u64	tcpi_max_pacing_rate;
 };
 
+/* INET_DIAG_TCPSTATS, sent along with INET_DIAG_INFO */
+
+#define TCP_DIAG_RTT_BUCKETS	12
+
+struct tcp_diag_stats {
+	/* usec spent with data queued, and in each sender limited state */
+	__u64	tcpi_busy_time;
+	__u64	tcpi_cwnd_limited;
+	__u64	tcpi_rwnd_limited;
+	__u64	tcpi_sndbuf_limited;
+
+	/* RTT samples: bucket 0 is below 1 ms, bucket n covers
+	 * [2^(n-1), 2^n) ms and the last one everything above.
+	 */
+	__u32	tcpi_rtt_hist[TCP_DIAG_RTT_BUCKETS];
+};
+
 /* for TCP_MD5SIG socket option */
 #define TCP_MD5SIG_MAXKEYLEN	80
 
@@ -812,6 +812,9 @@ int __init_or_module do_one_initcall(initcall_t fn)
 		local_irq_enable();
 	}
 	WARN(msgbuf[0], "initcall %pF returned with %s\n", fn, msgbuf);
+#ifdef CONFIG_MTPROF
+	log_boot_initcall(fn, ts, ret);
+#endif
 	if (ts > 15000000) {
 		/* log more than 15ms initcalls */
 		snprintf(msgbuf, 64, "%pf %10llu ns", fn, ts);
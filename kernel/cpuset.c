@@ -1497,16 +1497,28 @@ static void cpuset_attach(struct cgroup_subsys_state *css,
 		 */
 		WARN_ON_ONCE(set_cpus_allowed_ptr(task, cpus_attach));
 
-		cpuset_change_task_nodemask(task, &cpuset_attach_nodemask_to);
+		/*
+		 * mems_allowed only changes under cpuset_mutex.  Moving
+		 * between cpusets with the same mems, which is every move
+		 * on a single node, has nothing to rebind.
+		 */
+		if (!nodes_equal(task->mems_allowed, cpuset_attach_nodemask_to))
+			cpuset_change_task_nodemask(task,
+						    &cpuset_attach_nodemask_to);
 		cpuset_update_task_spread_flag(cs, task);
 	}
 
 	/*
 	 * Change mm, possibly for multiple threads in a threadgroup. This is
-	 * expensive and may sleep.
+	 * expensive and may sleep.  With the same mems before and after there
+	 * is neither a policy to rebind nor a page to migrate, so skip taking
+	 * mmap_sem for writing and walking every vma.
 	 */
 	cpuset_attach_nodemask_to = cs->effective_mems;
-	mm = get_task_mm(leader);
+	if (nodes_equal(oldcs->old_mems_allowed, cpuset_attach_nodemask_to))
+		mm = NULL;
+	else
+		mm = get_task_mm(leader);
 	if (mm) {
 		mpol_rebind_mm(mm, &cpuset_attach_nodemask_to);
 
@@ -300,7 +300,7 @@ static void __rt_mutex_adjust_prio(struct task_struct *task)
  * of task. We do not use the spin_xx_mutex() variants here as we are
  * outside of the debug path.)
  */
-static void rt_mutex_adjust_prio(struct task_struct *task)
+void rt_mutex_adjust_prio(struct task_struct *task)
 {
 	unsigned long flags;
 
@@ -962,7 +962,11 @@ static int task_blocks_on_rt_mutex(struct rt_mutex *lock,
  *
  * Called with lock->wait_lock held.
  */
-static void wakeup_next_waiter(struct rt_mutex *lock)
+/*
+ * With @wake the woken task is handed back with a reference instead,
+ * for the caller to wake once it dropped its own locks.
+ */
+static void wakeup_next_waiter(struct rt_mutex *lock, struct task_struct **wake)
 {
 	struct rt_mutex_waiter *waiter;
 	unsigned long flags;
@@ -996,7 +1000,12 @@ static void wakeup_next_waiter(struct rt_mutex *lock)
 	 * long as we hold lock->wait_lock. The waiter task needs to
 	 * acquire it in order to dequeue the waiter.
 	 */
-	wake_up_process(waiter->task);
+	if (wake) {
+		get_task_struct(waiter->task);
+		*wake = waiter->task;
+	} else {
+		wake_up_process(waiter->task);
+	}
 }
 
 /*
@@ -1252,10 +1261,11 @@ static inline int rt_mutex_slowtrylock(struct rt_mutex *lock)
 }
 
 /*
- * Slow path to release a rt-mutex:
+ * Slow path to release a rt-mutex.  Returns true if the priority of
+ * current has to be adjusted, after the waiter in @wake is woken.
  */
-static void __sched
-rt_mutex_slowunlock(struct rt_mutex *lock)
+static bool __sched
+rt_mutex_slowunlock(struct rt_mutex *lock, struct task_struct **wake)
 {
 	raw_spin_lock(&lock->wait_lock);
 
@@ -1297,7 +1307,7 @@ rt_mutex_slowunlock(struct rt_mutex *lock)
 	while (!rt_mutex_has_waiters(lock)) {
 		/* Drops lock->wait_lock ! */
 		if (unlock_rt_mutex_safe(lock) == true)
-			return;
+			return false;
 		/* Relock the rtmutex and try again */
 		raw_spin_lock(&lock->wait_lock);
 	}
@@ -1306,12 +1316,12 @@ rt_mutex_slowunlock(struct rt_mutex *lock)
 	 * The wakeup next waiter path does not suffer from the above
 	 * race. See the comments there.
 	 */
-	wakeup_next_waiter(lock);
+	wakeup_next_waiter(lock, wake);
 
 	raw_spin_unlock(&lock->wait_lock);
 
-	/* Undo pi boosting if necessary: */
-	rt_mutex_adjust_prio(current);
+	/* check PI boosting */
+	return true;
 }
 
 /*
@@ -1362,12 +1372,14 @@ rt_mutex_fasttrylock(struct rt_mutex *lock,
 
 static inline void
 rt_mutex_fastunlock(struct rt_mutex *lock,
-		    void (*slowfn)(struct rt_mutex *lock))
+		    bool (*slowfn)(struct rt_mutex *lock,
+				   struct task_struct **wake))
 {
 	if (likely(rt_mutex_cmpxchg(lock, current, NULL)))
 		rt_mutex_deadlock_account_unlock(current);
-	else
-		slowfn(lock);
+	else if (slowfn(lock, NULL))
+		/* Undo pi boosting if necessary: */
+		rt_mutex_adjust_prio(current);
 }
 
 /**
@@ -1461,6 +1473,25 @@ void __sched rt_mutex_unlock(struct rt_mutex *lock)
 }
 EXPORT_SYMBOL_GPL(rt_mutex_unlock);
 
+/**
+ * rt_mutex_futex_unlock - Futex variant of rt_mutex_unlock
+ * @lock: the rt_mutex to be unlocked
+ * @wake: the next owner, to wake with wake_up_process() and release
+ *	  with put_task_struct() once the hash bucket lock is dropped
+ *
+ * Returns: true/false indicating whether priority adjustment is
+ * required or not, after the wakeup.
+ */
+bool __sched rt_mutex_futex_unlock(struct rt_mutex *lock,
+				   struct task_struct **wake)
+{
+	if (likely(rt_mutex_cmpxchg(lock, current, NULL))) {
+		rt_mutex_deadlock_account_unlock(current);
+		return false;
+	}
+	return rt_mutex_slowunlock(lock, wake);
+}
+
 /**
  * rt_mutex_destroy - mark a mutex unusable
  * @lock: the mutex to be destroyed
@@ -45,6 +45,7 @@
 #include <linux/rculist.h>
 #include <linux/poll.h>
 #include <linux/irq_work.h>
+#include <linux/kthread.h>
 #include <linux/utsname.h>
 #include <mt-plat/aee.h>
 #include <linux/ctype.h>
@@ -1138,6 +1139,24 @@ static bool printk_time = IS_ENABLED(CONFIG_PRINTK_TIME);
 module_param_named(time, printk_time, bool, S_IRUGO | S_IWUSR);
 module_param_named(disable_uart, printk_disable_uart, bool, S_IRUGO | S_IWUSR);
 
+/*
+ * Print to the consoles from the "printk" kthread rather than from the
+ * caller, which may sit in an IRQ or hot path behind a slow UART.  Oopses
+ * and panics still print synchronously.
+ */
+static bool printk_offload = true;
+module_param_named(offload, printk_offload, bool, S_IRUGO | S_IWUSR);
+static struct task_struct *printk_kthread __read_mostly;
+static int printk_kthread_pending;
+
+static bool printk_offloading(void)
+{
+	return printk_offload && printk_kthread && !oops_in_progress &&
+	       system_state == SYSTEM_RUNNING;
+}
+
+static void printk_offload_kick(void);
+
 static size_t print_time(u64 ts, char *buf)
 {
 	unsigned long rem_nsec;
@@ -1965,6 +1984,11 @@ asmlinkage int vprintk_emit(int facility, int level,
 
 	/* If called from the scheduler, we can not call up(). */
 	if (!in_sched) {
+		if (printk_offloading()) {
+			printk_offload_kick();
+			return printed_len;
+		}
+
 		lockdep_off();
 		/*
 		 * Disable preemption to avoid being preempted while holding
@@ -2903,9 +2927,13 @@ static void wake_up_klogd_work_func(struct irq_work *irq_work)
 	int pending = __this_cpu_xchg(printk_pending, 0);
 
 	if (pending & PRINTK_PENDING_OUTPUT) {
-		/* If trylock fails, someone else is doing the printing */
-		if (console_trylock())
+		if (printk_offloading()) {
+			ACCESS_ONCE(printk_kthread_pending) = 1;
+			wake_up_process(printk_kthread);
+		} else if (console_trylock()) {
+			/* If trylock fails, someone else is doing the printing */
 			console_unlock();
+		}
 	}
 
 	if (pending & PRINTK_PENDING_WAKEUP)
@@ -2927,6 +2955,47 @@ void wake_up_klogd(void)
 	preempt_enable();
 }
 
+/* safe from any context: the wakeup goes through the irq_work */
+static void printk_offload_kick(void)
+{
+	preempt_disable();
+	this_cpu_or(printk_pending, PRINTK_PENDING_OUTPUT);
+	irq_work_queue(this_cpu_ptr(&wake_up_klogd_work));
+	preempt_enable();
+}
+
+static int printk_kthread_func(void *data)
+{
+	while (!kthread_should_stop()) {
+		set_current_state(TASK_INTERRUPTIBLE);
+		if (!xchg(&printk_kthread_pending, 0)) {
+			schedule();
+			continue;
+		}
+		__set_current_state(TASK_RUNNING);
+
+		console_lock();
+		console_unlock();
+	}
+
+	return 0;
+}
+
+static int __init printk_kthread_init(void)
+{
+	struct task_struct *t;
+
+	t = kthread_run(printk_kthread_func, NULL, "printk");
+	if (IS_ERR(t)) {
+		pr_err("printk: failed to start printk kthread\n");
+		return PTR_ERR(t);
+	}
+	printk_kthread = t;
+
+	return 0;
+}
+late_initcall(printk_kthread_init);
+
 int printk_deferred(const char *fmt, ...)
 {
 	va_list args;
@@ -42,6 +42,8 @@
 #ifdef CONFIG_RCU_NOCB_CPU
 static cpumask_var_t rcu_nocb_mask; /* CPUs to have callbacks offloaded. */
 static bool have_rcu_nocb_mask;	    /* Was rcu_nocb_mask allocated? */
+static cpumask_var_t rcu_nocb_affinity_mask; /* Where rcuo kthreads run. */
+static bool have_rcu_nocb_affinity; /* Was rcu_nocb_affinity given? */
 static bool __read_mostly rcu_nocb_poll;    /* Offload kthread are to poll. */
 static char __initdata nocb_buf[NR_CPUS * 5];
 #endif /* #ifdef CONFIG_RCU_NOCB_CPU */
@@ -1988,6 +1990,19 @@ static int __init rcu_nocb_setup(char *str)
 }
 __setup("rcu_nocbs=", rcu_nocb_setup);
 
+/*
+ * Parse the boot-time CPU list the rcuo kthreads are confined to, the
+ * housekeeping CPUs.  User space can still move them later.
+ */
+static int __init rcu_nocb_affinity_setup(char *str)
+{
+	alloc_bootmem_cpumask_var(&rcu_nocb_affinity_mask);
+	have_rcu_nocb_affinity = true;
+	cpulist_parse(str, rcu_nocb_affinity_mask);
+	return 1;
+}
+__setup("rcu_nocb_affinity=", rcu_nocb_affinity_setup);
+
 static int __init parse_rcu_nocb_poll(char *arg)
 {
 	rcu_nocb_poll = 1;
@@ -2440,6 +2455,8 @@ static int rcu_nocb_kthread(void *arg)
 				cl++;
 			c++;
 			local_bh_enable();
+			/* a large batch must not hog its housekeeping CPU */
+			cond_resched_rcu_qs();
 			list = next;
 		}
 		trace_rcu_batch_end(rdp->rsp->name, c, !!list, 0, 0, 1);
@@ -2543,6 +2560,38 @@ static void __init rcu_boot_init_nocb_percpu_data(struct rcu_data *rdp)
 	rdp->nocb_follower_tail = &rdp->nocb_follower_head;
 }
 
+/*
+ * Confine an rcuo kthread to the rcu_nocb_affinity= CPUs, once one of
+ * them is up.  Those spawned before are moved by rcu_nocb_affine_all().
+ */
+static void rcu_nocb_affine_kthread(struct task_struct *t)
+{
+	if (!have_rcu_nocb_affinity ||
+	    !cpumask_intersects(rcu_nocb_affinity_mask, cpu_active_mask))
+		return;
+	if (set_cpus_allowed_ptr(t, rcu_nocb_affinity_mask))
+		pr_info("\tFailed to confine %s/%d to rcu_nocb_affinity.\n",
+			t->comm, task_pid_nr(t));
+}
+
+static int __init rcu_nocb_affine_all(void)
+{
+	struct rcu_state *rsp;
+	struct task_struct *t;
+	int cpu;
+
+	if (!have_rcu_nocb_mask || !have_rcu_nocb_affinity)
+		return 0;
+	for_each_rcu_flavor(rsp)
+		for_each_cpu(cpu, rcu_nocb_mask) {
+			t = ACCESS_ONCE(per_cpu_ptr(rsp->rda, cpu)->nocb_kthread);
+			if (t)
+				rcu_nocb_affine_kthread(t);
+		}
+	return 0;
+}
+late_initcall(rcu_nocb_affine_all);
+
 /*
  * If the specified CPU is a no-CBs CPU that does not already have its
  * rcuo kthread for the specified RCU flavor, spawn it.  If the CPUs are
@@ -2585,6 +2634,7 @@ static void rcu_spawn_one_nocb_kthread(struct rcu_state *rsp, int cpu)
 			"rcuo%c/%d", rsp->abbr, cpu);
 	BUG_ON(IS_ERR(t));
 	ACCESS_ONCE(rdp_spawn->nocb_kthread) = t;
+	rcu_nocb_affine_kthread(t);
 }
 
 /*
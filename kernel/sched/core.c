@@ -88,6 +88,8 @@
 #include "../smpboot.h"
 #ifdef CONFIG_MTPROF
 #include "mt_sched_mon.h"
+#include "mt_cputime.h"
+#include "mt_pmu_task.h"
 #endif
 #define CREATE_TRACE_POINTS
 #include <trace/events/sched.h>
@@ -1984,6 +1986,13 @@ static void __sched_fork(unsigned long clone_flags, struct task_struct *p)
 	p->se.nr_migrations		= 0;
 	p->se.vruntime			= 0;
 	INIT_LIST_HEAD(&p->se.group_node);
+#ifdef CONFIG_MTPROF_CPUTIME
+	p->se.mtk_snap_runtime		= 0;
+	p->se.mtk_snap_gen		= 0;
+#endif
+#ifdef CONFIG_MTPROF_PMU_TASK
+	p->se.mtk_pmu_gen		= 0;
+#endif
 #ifdef CONFIG_SCHED_HMP
 	p->se.avg.hmp_last_up_migration = 0;
 	p->se.avg.hmp_last_down_migration = 0;
@@ -2705,6 +2714,9 @@ void scheduler_tick(void)
 	raw_spin_lock(&rq->lock);
 	update_rq_clock(rq);
 	curr->sched_class->task_tick(rq, curr, 0);
+#ifdef CONFIG_MTPROF
+	mt_cputime_snap_account(curr);
+#endif
 	update_cpu_load_active(rq);
 #ifdef CONFIG_MT_SCHED_MONITOR
 	mt_trace_rqlock_start(&rq->lock);
@@ -3081,6 +3093,10 @@ need_resched:
 		rq->nr_switches++;
 		rq->curr = next;
 		++*switch_count;
+#ifdef CONFIG_MTPROF
+		mt_cputime_snap_account(prev);
+		mt_pmu_task_account(prev);
+#endif
 
 		context_switch(rq, prev, next); /* unlocks the rq */
 		/*
@@ -3922,9 +3938,6 @@ change:
 	task_rq_unlock(rq, p, &flags);
 
 	rt_mutex_adjust_pi(p);
-#ifdef CONFIG_MTPROF
-	check_mt_rt_mon_info(p);
-#endif
 
 	return 0;
 }
@@ -8202,6 +8215,7 @@ cpu_cgroup_css_alloc(struct cgroup_subsys_state *parent_css)
 	tg = sched_create_group(parent);
 	if (IS_ERR(tg))
 		return ERR_PTR(-ENOMEM);
+	tg->timer_slack_ns = parent->timer_slack_ns;
 
 	return &tg->css;
 }
@@ -8256,10 +8270,31 @@ static int cpu_cgroup_can_attach(struct cgroup_subsys_state *css,
 static void cpu_cgroup_attach(struct cgroup_subsys_state *css,
 			      struct cgroup_taskset *tset)
 {
+	u64 slack = ACCESS_ONCE(css_tg(css)->timer_slack_ns);
 	struct task_struct *task;
 
-	cgroup_taskset_for_each(task, tset)
+	cgroup_taskset_for_each(task, tset) {
 		sched_move_task(task);
+		/* like PR_SET_TIMERSLACK_PID, rt tasks ignore it anyway */
+		task->timer_slack_ns = slack ? slack : task->default_timer_slack_ns;
+	}
+}
+
+static u64 cpu_timer_slack_read_u64(struct cgroup_subsys_state *css,
+				    struct cftype *cft)
+{
+	return css_tg(css)->timer_slack_ns;
+}
+
+static int cpu_timer_slack_write_u64(struct cgroup_subsys_state *css,
+				     struct cftype *cftype, u64 slack)
+{
+	if (slack > ULONG_MAX)
+		return -EINVAL;
+
+	/* tasks already in the group keep theirs until attached again */
+	css_tg(css)->timer_slack_ns = slack;
+	return 0;
 }
 
 static void cpu_cgroup_exit(struct cgroup_subsys_state *css,
@@ -8564,6 +8599,11 @@ static u64 cpu_rt_period_read_uint(struct cgroup_subsys_state *css,
 #endif /* CONFIG_RT_GROUP_SCHED */
 
 static struct cftype cpu_files[] = {
+	{
+		.name = "timer_slack_ns",
+		.read_u64 = cpu_timer_slack_read_u64,
+		.write_u64 = cpu_timer_slack_write_u64,
+	},
 #ifdef CONFIG_FAIR_GROUP_SCHED
 	{
 		.name = "shares",
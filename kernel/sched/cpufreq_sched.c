@@ -0,0 +1,222 @@
+/*
+ * Scheduler driven cpu frequency selection
+ *
+ * The fair class reports the PELT usage of each cpu whenever a task is
+ * enqueued or dequeued and on every tick.  The "sched" governor picks the
+ * lowest frequency that serves the busiest cpu of a policy with some
+ * headroom, so frequency follows a load change within a tick instead of
+ * waiting for the next sampling period.  Usage is frequency invariant
+ * (see arch_scale_freq_capacity()), so the request maps directly onto a
+ * fraction of the maximum frequency.
+ *
+ * Frequency changes may sleep, so they are handed from the scheduler to a
+ * per policy kthread through irq_work.  Limits from thermal, PPM or the
+ * boost interfaces still apply through policy->min and policy->max.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ */
+
+#include <linux/cpufreq.h>
+#include <linux/irq_work.h>
+#include <linux/kthread.h>
+#include <linux/module.h>
+#include <linux/percpu.h>
+#include <linux/slab.h>
+
+#include "sched.h"
+
+/* Pick the frequency at which usage is 80% of the capacity */
+#define CAPACITY_MARGIN		1280
+
+/* Never ask the driver for a change more often than this */
+#define THROTTLE_NSEC_MIN	(500 * NSEC_PER_USEC)
+
+struct static_key __sched_freq __read_mostly = STATIC_KEY_INIT_FALSE;
+
+struct gov_data {
+	struct cpufreq_policy *policy;
+	struct task_struct *task;
+	struct irq_work irq_work;
+	unsigned int requested_freq;
+	bool pending;
+	u64 throttle_nsec;
+	u64 last_request;
+};
+
+/* Last usage reported for each cpu, in SCHED_CAPACITY_SCALE units */
+static DEFINE_PER_CPU(unsigned long, cpu_sched_capacity);
+static DEFINE_PER_CPU(struct gov_data *, cpu_gov_data);
+
+static int cpufreq_sched_thread(void *data)
+{
+	struct gov_data *gd = data;
+	struct sched_param param = { .sched_priority = 50 };
+
+	sched_setscheduler_nocheck(current, SCHED_FIFO, &param);
+	set_cpus_allowed_ptr(current, gd->policy->related_cpus);
+
+	while (1) {
+		set_current_state(TASK_INTERRUPTIBLE);
+		if (kthread_should_stop())
+			break;
+		if (!ACCESS_ONCE(gd->pending)) {
+			schedule();
+			continue;
+		}
+		__set_current_state(TASK_RUNNING);
+
+		gd->pending = false;
+		smp_mb();
+		__cpufreq_driver_target(gd->policy,
+					ACCESS_ONCE(gd->requested_freq),
+					CPUFREQ_RELATION_L);
+	}
+	__set_current_state(TASK_RUNNING);
+
+	return 0;
+}
+
+static void cpufreq_sched_irq_work(struct irq_work *irq_work)
+{
+	struct gov_data *gd = container_of(irq_work, struct gov_data, irq_work);
+
+	wake_up_process(gd->task);
+}
+
+/**
+ * update_cpu_capacity_request - report the usage of a cpu
+ * @cpu: cpu whose usage changed, with its rq lock held
+ * @capacity: usage of @cpu relative to its maximum capacity
+ *
+ * Raises or lowers the frequency of the policy @cpu belongs to, going by
+ * the busiest of its cpus.
+ */
+void update_cpu_capacity_request(int cpu, unsigned long capacity)
+{
+	struct gov_data *gd;
+	struct cpufreq_policy *policy;
+	unsigned long max_capacity = 0;
+	unsigned int freq;
+	u64 now;
+	int i;
+
+	per_cpu(cpu_sched_capacity, cpu) = capacity;
+
+	gd = ACCESS_ONCE(per_cpu(cpu_gov_data, cpu));
+	if (!gd)
+		return;
+	policy = gd->policy;
+
+	for_each_cpu(i, policy->cpus)
+		max_capacity = max(max_capacity, per_cpu(cpu_sched_capacity, i));
+
+	freq = ((u64)policy->cpuinfo.max_freq * max_capacity *
+		CAPACITY_MARGIN) >> (2 * SCHED_CAPACITY_SHIFT);
+	freq = clamp(freq, policy->min, policy->max);
+	if (freq == gd->requested_freq)
+		return;
+
+	now = local_clock();
+	if (now - gd->last_request < gd->throttle_nsec)
+		return;
+
+	gd->last_request = now;
+	gd->requested_freq = freq;
+	smp_wmb();
+	gd->pending = true;
+	irq_work_queue(&gd->irq_work);
+}
+
+static int cpufreq_sched_start(struct cpufreq_policy *policy)
+{
+	struct gov_data *gd;
+	int cpu;
+
+	gd = kzalloc(sizeof(*gd), GFP_KERNEL);
+	if (!gd)
+		return -ENOMEM;
+
+	gd->policy = policy;
+	gd->requested_freq = policy->cur;
+	gd->throttle_nsec = max_t(u64, policy->cpuinfo.transition_latency,
+				  THROTTLE_NSEC_MIN);
+	init_irq_work(&gd->irq_work, cpufreq_sched_irq_work);
+
+	gd->task = kthread_create(cpufreq_sched_thread, gd, "kschedfreq:%d",
+				  cpumask_first(policy->related_cpus));
+	if (IS_ERR(gd->task)) {
+		pr_err("cpufreq_sched: failed to create thread for cpu %d\n",
+		       policy->cpu);
+		kfree(gd);
+		return -ENOMEM;
+	}
+	get_task_struct(gd->task);
+	wake_up_process(gd->task);
+
+	policy->governor_data = gd;
+	for_each_cpu(cpu, policy->cpus)
+		per_cpu(cpu_gov_data, cpu) = gd;
+	static_key_slow_inc(&__sched_freq);
+
+	return 0;
+}
+
+static void cpufreq_sched_stop(struct cpufreq_policy *policy)
+{
+	struct gov_data *gd = policy->governor_data;
+	int cpu;
+
+	static_key_slow_dec(&__sched_freq);
+	for_each_cpu(cpu, policy->related_cpus)
+		per_cpu(cpu_gov_data, cpu) = NULL;
+
+	/* Requests are made with the rq lock held, wait them out */
+	synchronize_sched();
+	irq_work_sync(&gd->irq_work);
+
+	kthread_stop(gd->task);
+	put_task_struct(gd->task);
+	policy->governor_data = NULL;
+	kfree(gd);
+}
+
+static int cpufreq_sched_setup(struct cpufreq_policy *policy,
+			       unsigned int event)
+{
+	switch (event) {
+	case CPUFREQ_GOV_START:
+		return cpufreq_sched_start(policy);
+	case CPUFREQ_GOV_STOP:
+		cpufreq_sched_stop(policy);
+		break;
+	case CPUFREQ_GOV_LIMITS:
+		if (policy->max < policy->cur)
+			__cpufreq_driver_target(policy, policy->max,
+						CPUFREQ_RELATION_H);
+		else if (policy->min > policy->cur)
+			__cpufreq_driver_target(policy, policy->min,
+						CPUFREQ_RELATION_L);
+		break;
+	}
+
+	return 0;
+}
+
+#ifndef CONFIG_CPU_FREQ_DEFAULT_GOV_SCHED
+static
+#endif
+struct cpufreq_governor cpufreq_gov_sched = {
+	.name		= "sched",
+	.governor	= cpufreq_sched_setup,
+	.owner		= THIS_MODULE,
+};
+
+static int __init cpufreq_sched_init(void)
+{
+	return cpufreq_register_governor(&cpufreq_gov_sched);
+}
+
+/* Try to make this the default governor */
+fs_initcall(cpufreq_sched_init);
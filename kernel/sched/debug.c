@@ -707,6 +707,8 @@ void proc_sched_show_task(struct task_struct *p, struct seq_file *m)
 	P(se.statistics.nr_failed_migrations_running);
 	P(se.statistics.nr_failed_migrations_hot);
 	P(se.statistics.nr_forced_migrations);
+	P(se.statistics.nr_migrations_xcluster);
+	P(se.statistics.nr_failed_migrations_xcluster_hot);
 	P(se.statistics.nr_wakeups);
 	P(se.statistics.nr_wakeups_sync);
 	P(se.statistics.nr_wakeups_migrate);
@@ -104,6 +104,13 @@ const_debug unsigned int sysctl_sched_migration_cost = 33000UL;
 const_debug unsigned int sysctl_sched_migration_cost = 500000UL;
 #endif
 
+/*
+ * A task pulled to a cpu that does not share its cache also leaves a warm
+ * L2 behind, so it stays cache hot for longer against such migrations.
+ * (default: 2 msec)
+ */
+const_debug unsigned int sysctl_sched_xcluster_migration_cost = 2000000UL;
+
 /*
  * The exponential sliding  window over which load is averaged for shares
  * distribution.
@@ -4783,6 +4790,12 @@ static void hmp_offline_cpu(int cpu) {}
  * increased. Here we update the fair scheduling stats and
  * then put the task into the rbtree:
  */
+#ifdef CONFIG_SMP
+static void update_capacity_of(int cpu);
+#else
+static inline void update_capacity_of(int cpu) { }
+#endif
+
 static void
 enqueue_task_fair(struct rq *rq, struct task_struct *p, int flags)
 {
@@ -4826,6 +4839,7 @@ enqueue_task_fair(struct rq *rq, struct task_struct *p, int flags)
 		BUG_ON(rq->cfs.nr_running > rq->cfs.h_nr_running);
 #endif
 	}
+	update_capacity_of(cpu_of(rq));
 	hrtick_update(rq);
 #ifdef CONFIG_MTK_SCHED_CMP_TGS
 	sched_tg_enqueue_fair(rq, p);
@@ -4897,6 +4911,7 @@ static void dequeue_task_fair(struct rq *rq, struct task_struct *p, int flags)
 #endif
 		update_rq_runnable_avg(rq, 1);
 	}
+	update_capacity_of(cpu_of(rq));
 	hrtick_update(rq);
 #ifdef CONFIG_MTK_SCHED_CMP_TGS
 	sched_tg_dequeue_fair(rq, p);
@@ -5545,6 +5560,173 @@ static int mt_select_task_rq_fair(struct task_struct *p, int prev_cpu)
 #endif
 }
 
+#ifdef CONFIG_SCHED_HMP
+/*
+ * Energy aware wakeup
+ *
+ * With an energy model for every cpu, a waking task goes to the cpu where
+ * the estimated energy of the whole system is lowest, among the cpus that
+ * still have room for it.  A cluster is assumed to run at the lowest
+ * capacity state that fits its busiest cpu; busy power is paid for the
+ * utilized share of that state and idle power for the rest, using the
+ * deepest idle state for cpus and clusters that are left without work.
+ * That last part is what keeps an idle cluster from being woken for a
+ * task that fits elsewhere.
+ */
+const struct sched_group_energy * __weak
+arch_get_energy_costs(int cpu, enum sched_energy_level level)
+{
+	return NULL;
+}
+
+static int get_cpu_usage(int cpu);
+
+/* A task only fits a cpu if usage stays below 80% of its capacity */
+#define ENERGY_CAPACITY_MARGIN	1280
+
+static inline unsigned long energy_task_util(struct task_struct *p)
+{
+	return p->se.avg.utilization_avg_contrib;
+}
+
+/* Usage of @cpu once @p moved from its current cpu to @dst_cpu */
+static unsigned long energy_cpu_util(int cpu, struct task_struct *p, int dst_cpu)
+{
+	unsigned long util = get_cpu_usage(cpu);
+	unsigned long task_util = energy_task_util(p);
+
+	if (cpu == task_cpu(p))
+		util -= min(util, task_util);
+	if (cpu == dst_cpu)
+		util += task_util;
+
+	return util;
+}
+
+static bool energy_task_fits(int cpu, struct task_struct *p)
+{
+	return energy_cpu_util(cpu, p, cpu) * ENERGY_CAPACITY_MARGIN <
+		capacity_orig_of(cpu) * SCHED_CAPACITY_SCALE;
+}
+
+static unsigned long energy_of_state(const struct sched_group_energy *sge,
+				     int idx, unsigned long util,
+				     unsigned long cap)
+{
+	const struct idle_state *is;
+
+	idx = min_t(int, idx, sge->nr_cap_states - 1);
+	util = min(util, cap);
+	is = &sge->idle_states[util ? 0 : sge->nr_idle_states - 1];
+
+	return (util * sge->cap_states[idx].power +
+		(cap - util) * is->power) / cap;
+}
+
+static unsigned long energy_of_cluster(const struct cpumask *cpus,
+				       struct task_struct *p, int dst_cpu)
+{
+	int first = cpumask_first(cpus);
+	const struct sched_group_energy *cpu_sge, *cl_sge;
+	unsigned long max_util = 0, energy = 0, cap;
+	int cpu, idx;
+
+	cpu_sge = arch_get_energy_costs(first, SCHED_ENERGY_CPU);
+	cl_sge = arch_get_energy_costs(first, SCHED_ENERGY_CLUSTER);
+
+	for_each_cpu(cpu, cpus)
+		max_util = max(max_util, energy_cpu_util(cpu, p, dst_cpu));
+
+	for (idx = 0; idx < cpu_sge->nr_cap_states - 1; idx++)
+		if (cpu_sge->cap_states[idx].cap >= max_util)
+			break;
+	cap = cpu_sge->cap_states[idx].cap;
+
+	for_each_cpu(cpu, cpus)
+		energy += energy_of_state(cpu_sge, idx,
+					  energy_cpu_util(cpu, p, dst_cpu), cap);
+	if (cl_sge)
+		energy += energy_of_state(cl_sge, idx, max_util, cap);
+
+	return energy;
+}
+
+static unsigned long energy_of_system(struct task_struct *p, int dst_cpu)
+{
+	struct cpumask cls_cpus;
+	unsigned long energy = 0;
+	int id;
+
+	for (id = 0; id < arch_get_nr_clusters(); id++) {
+		arch_get_cluster_cpus(&cls_cpus, id);
+		cpumask_and(&cls_cpus, &cls_cpus, cpu_online_mask);
+		if (!cpumask_empty(&cls_cpus))
+			energy += energy_of_cluster(&cls_cpus, p, dst_cpu);
+	}
+
+	return energy;
+}
+
+/*
+ * Returns the cpu @p should wake up on, or -1 to leave the decision to
+ * the HMP heuristics: without a complete energy model, or if @p fits
+ * nowhere and needs the regular up-migration.
+ */
+static int energy_aware_wake_cpu(struct task_struct *p, int prev_cpu)
+{
+	unsigned long prev_energy = ULONG_MAX, best_energy = ULONG_MAX;
+	unsigned long energy, util, min_util;
+	struct cpumask cls_cpus;
+	int cpu, id, target, best_cpu = -1;
+
+	for_each_online_cpu(cpu)
+		if (!arch_get_energy_costs(cpu, SCHED_ENERGY_CPU))
+			return -1;
+
+	if (cpu_active(prev_cpu) && cpumask_test_cpu(prev_cpu, tsk_cpus_allowed(p)) &&
+	    energy_task_fits(prev_cpu, p)) {
+		prev_energy = energy_of_system(p, prev_cpu);
+		best_energy = prev_energy;
+		best_cpu = prev_cpu;
+		trace_sched_energy_cpu(p, prev_cpu,
+				       energy_cpu_util(prev_cpu, p, prev_cpu), prev_energy);
+	}
+
+	/* Within a cluster, only the least utilized cpu is worth a look */
+	for (id = 0; id < arch_get_nr_clusters(); id++) {
+		arch_get_cluster_cpus(&cls_cpus, id);
+		cpumask_and(&cls_cpus, &cls_cpus, cpu_active_mask);
+		cpumask_and(&cls_cpus, &cls_cpus, tsk_cpus_allowed(p));
+
+		target = -1;
+		min_util = ULONG_MAX;
+		for_each_cpu(cpu, &cls_cpus) {
+			if (cpu == prev_cpu || !energy_task_fits(cpu, p))
+				continue;
+			util = energy_cpu_util(cpu, p, cpu);
+			if (util < min_util) {
+				min_util = util;
+				target = cpu;
+			}
+		}
+		if (target < 0)
+			continue;
+
+		energy = energy_of_system(p, target);
+		trace_sched_energy_cpu(p, target, min_util, energy);
+		if (energy < best_energy) {
+			best_energy = energy;
+			best_cpu = target;
+		}
+	}
+
+	trace_sched_energy_select_task_rq(p, prev_cpu, best_cpu,
+					  energy_task_util(p), prev_energy,
+					  best_energy);
+	return best_cpu;
+}
+#endif /* CONFIG_SCHED_HMP */
+
 #ifdef CONFIG_MTK_SCHED_TRACERS
 #define LB_RESET		0
 #define LB_AFFINITY		0x10
@@ -5594,6 +5776,14 @@ select_task_rq_fair(struct task_struct *p, int prev_cpu, int sd_flag, int wake_f
 		return per_cpu(sd_pack_buddy, cpu);
 #endif /* CONFIG_HMP_PACK_SMALL_TASK */
 
+#ifdef CONFIG_SCHED_HMP
+	if (sched_feat(ENERGY_AWARE) && (sd_flag & SD_BALANCE_WAKE)) {
+		prefer_cpu = energy_aware_wake_cpu(p, prev_cpu);
+		if (prefer_cpu >= 0)
+			return prefer_cpu;
+	}
+#endif /* CONFIG_SCHED_HMP */
+
 	/* always put non-kernel forking tasks on a big domain */
 	if (sched_feat(SCHED_HMP) && p->mm && (sd_flag & SD_BALANCE_FORK)) {
 		/* TODO: This part should be functionalized */
@@ -5778,6 +5968,18 @@ static int get_cpu_usage(int cpu)
 	return usage + blocked;
 }
 
+/* Tell the sched cpufreq governor about the usage of @cpu */
+static void update_capacity_of(int cpu)
+{
+	unsigned long req;
+
+	if (!sched_freq())
+		return;
+
+	req = get_cpu_usage(cpu) * SCHED_CAPACITY_SCALE / capacity_orig_of(cpu);
+	update_cpu_capacity_request(cpu, req);
+}
+
 /*
  * Called immediately before a task is migrated to a new cpu; task_cpu(p) and
  * cfs_rq_of(p) references at time of call are still valid and identify the
@@ -6337,6 +6539,8 @@ static void move_task(struct task_struct *p, struct lb_env *env)
  */
 static int task_hot(struct task_struct *p, struct lb_env *env)
 {
+	bool xcluster = sched_feat(XCLUSTER_HOT) &&
+			!cpus_share_cache(env->src_cpu, env->dst_cpu);
 	s64 delta;
 
 	lockdep_assert_held(&env->src_rq->lock);
@@ -6349,9 +6553,10 @@ static int task_hot(struct task_struct *p, struct lb_env *env)
 
 #ifdef CONFIG_MT_LOAD_BALANCE_ENHANCEMENT
 	/*
-	force ignore the cache hot when current rq is idle and src cpu have more than 2 tasks
+	force ignore the cache hot when current rq is idle and src cpu have more than 2 tasks,
+	within the cluster only: the L2 is lost for good otherwise
 	 */
-	if (env->mt_ignore_cachehot_in_idle) {
+	if (env->mt_ignore_cachehot_in_idle && !xcluster) {
 		if (!this_rq()->nr_running && (task_rq(p)->nr_running >= 2))
 			return 0;
 	}
@@ -6372,6 +6577,10 @@ static int task_hot(struct task_struct *p, struct lb_env *env)
 
 	delta = rq_clock_task(env->src_rq) - p->se.exec_start;
 
+	if (xcluster)
+		return delta < (s64)max(sysctl_sched_migration_cost,
+					sysctl_sched_xcluster_migration_cost);
+
 	return delta < (s64)sysctl_sched_migration_cost;
 }
 
@@ -6541,10 +6750,14 @@ int can_migrate_task(struct task_struct *p, struct lb_env *env)
 			mt_sched_printf(sched_lb, "[%s] %d %s running fail",
 				__func__, p->pid, p->comm);
 		}
+		if (!cpus_share_cache(env->src_cpu, env->dst_cpu))
+			schedstat_inc(p, se.statistics.nr_migrations_xcluster);
 		return 1;
 	}
 
 	schedstat_inc(p, se.statistics.nr_failed_migrations_hot);
+	if (!cpus_share_cache(env->src_cpu, env->dst_cpu))
+		schedstat_inc(p, se.statistics.nr_failed_migrations_xcluster_hot);
 	return 0;
 }
 
@@ -10331,6 +10544,7 @@ static void task_tick_fair(struct rq *rq, struct task_struct *curr, int queued)
 		task_tick_numa(rq, curr);
 
 	update_rq_runnable_avg(rq, 1);
+	update_capacity_of(cpu_of(rq));
 }
 
 /*
@@ -93,3 +93,17 @@ SCHED_FEAT(SCHED_HMP, true)
 #else
 SCHED_FEAT(SCHED_HMP, false)
 #endif
+
+/*
+ * Energy aware wakeups: place waking tasks on the cpu that costs the
+ * least energy according to the platform energy model, where one is
+ * provided.  Falls back to the HMP heuristics otherwise.
+ */
+SCHED_FEAT(ENERGY_AWARE, false)
+
+/*
+ * Charge sysctl_sched_xcluster_migration_cost for balancing a task to a
+ * cpu outside its cache domain, so idle cpus pull cache hot tasks from
+ * within their own cluster first.
+ */
+SCHED_FEAT(XCLUSTER_HOT, true)
@@ -1135,6 +1135,9 @@ static void update_curr_rt(struct rq *rq)
 	per_cpu(exec_start, cpu) = curr->se.exec_start;
 	curr->se.sum_exec_runtime += delta_exec;
 	account_group_exec_runtime(curr, delta_exec);
+#ifdef CONFIG_MTPROF
+	mt_rt_mon_account(curr, delta_exec);
+#endif
 
 	curr->se.exec_start = rq_clock_task(rq);
 	cpuacct_charge(curr, delta_exec);
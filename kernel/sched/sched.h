@@ -241,6 +241,9 @@ struct task_group {
 #endif
 
 	struct cfs_bandwidth cfs_bandwidth;
+
+	/* timer_slack_ns given to tasks attached, 0: their default */
+	u64 timer_slack_ns;
 };
 
 #ifdef CONFIG_FAIR_GROUP_SCHED
@@ -1322,6 +1325,7 @@ extern void check_preempt_curr(struct rq *rq, struct task_struct *p, int flags);
 extern const_debug unsigned int sysctl_sched_time_avg;
 extern const_debug unsigned int sysctl_sched_nr_migrate;
 extern const_debug unsigned int sysctl_sched_migration_cost;
+extern const_debug unsigned int sysctl_sched_xcluster_migration_cost;
 
 static inline u64 sched_avg_period(void)
 {
@@ -1362,6 +1366,20 @@ extern unsigned long arch_scale_cpu_capacity(struct sched_domain *sd, int cpu);
 extern void arch_scale_set_curr_freq(int cpu, unsigned long freq);
 extern void arch_scale_set_max_freq(int cpu, unsigned long freq);
 
+#ifdef CONFIG_CPU_FREQ_GOV_SCHED
+extern struct static_key __sched_freq;
+
+static inline bool sched_freq(void)
+{
+	return static_key_false(&__sched_freq);
+}
+
+void update_cpu_capacity_request(int cpu, unsigned long capacity);
+#else
+static inline bool sched_freq(void) { return false; }
+static inline void update_cpu_capacity_request(int cpu, unsigned long capacity) { }
+#endif
+
 static inline void sched_rt_avg_update(struct rq *rq, u64 rt_delta)
 {
 	rq->rt_avg += rt_delta * arch_scale_freq_capacity(NULL, cpu_of(rq));
@@ -1314,6 +1314,8 @@ retry:
 				break;
 			}
 
+			if (basenow.tv64 < hrtimer_get_expires_tv64(timer))
+				cpu_base->nr_coalesced++;
 			__run_hrtimer(timer, &basenow);
 		}
 	}
@@ -48,6 +48,10 @@
 #include <linux/nodemask.h>
 #include <linux/moduleparam.h>
 #include <linux/uaccess.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/jump_label.h>
+#include <linux/hash.h>
 
 #include "workqueue_internal.h"
 
@@ -1228,6 +1232,185 @@ fail:
 	return -EAGAIN;
 }
 
+#ifdef CONFIG_MTK_WQ_STATS
+/*
+ * Per work function cost: how long works waited on the pool before a
+ * worker picked them up, and the wall and CPU time they ran for.  Off by
+ * default behind a static key; /sys/kernel/debug/workqueue_stats, echo
+ * 1/0 to start/stop, 2 to clear.  Entries are claimed lock-free by the
+ * first execution of a function and never released.
+ */
+#define WQ_STATS_SIZE		512	/* power of 2 */
+#define WQ_STATS_PROBES		8
+
+struct wq_stats_entry {
+	unsigned long func;
+	atomic64_t count;
+	atomic64_t lat_sum;		/* ns */
+	atomic64_t lat_max;
+	atomic64_t exec_sum;		/* ns, wall */
+	atomic64_t exec_max;
+	atomic64_t cpu_sum;		/* ns */
+	char wq_name[WQ_NAME_LEN];	/* of the first execution */
+};
+
+static struct static_key wq_stats_key = STATIC_KEY_INIT_FALSE;
+static struct wq_stats_entry wq_stats[WQ_STATS_SIZE];
+static atomic_t wq_stats_full;
+static bool wq_stats_on;
+static DEFINE_MUTEX(wq_stats_mutex);
+
+static void wq_stats_max(atomic64_t *max, s64 val)
+{
+	s64 old = atomic64_read(max);
+
+	while (val > old) {
+		s64 prev = atomic64_cmpxchg(max, old, val);
+
+		if (prev == old)
+			break;
+		old = prev;
+	}
+}
+
+static struct wq_stats_entry *wq_stats_get(work_func_t func,
+					   struct workqueue_struct *wq)
+{
+	unsigned long key = (unsigned long)func;
+	unsigned int i, h = hash_long(key, ilog2(WQ_STATS_SIZE));
+
+	for (i = 0; i < WQ_STATS_PROBES; i++) {
+		struct wq_stats_entry *e = &wq_stats[(h + i) & (WQ_STATS_SIZE - 1)];
+		unsigned long cur = ACCESS_ONCE(e->func);
+
+		if (cur == key)
+			return e;
+		if (!cur && !cmpxchg(&e->func, 0, key)) {
+			strlcpy(e->wq_name, wq->name, sizeof(e->wq_name));
+			return e;
+		}
+		/* lost the race, someone else may have claimed it for us */
+		if (ACCESS_ONCE(e->func) == key)
+			return e;
+	}
+	atomic_inc(&wq_stats_full);
+	return NULL;
+}
+
+/* @pool->lock held */
+static inline void wq_stats_queued(struct work_struct *work)
+{
+	if (static_key_false(&wq_stats_key))
+		work->mtk_queue_ns = sched_clock();
+}
+
+static void wq_stats_account(work_func_t func, struct workqueue_struct *wq,
+			     u64 queued, u64 start, u64 cpu_start)
+{
+	struct wq_stats_entry *e = wq_stats_get(func, wq);
+	u64 exec = sched_clock() - start;
+
+	if (!e)
+		return;
+	atomic64_inc(&e->count);
+	/* queued before the stats were on */
+	if (queued && start > queued) {
+		atomic64_add(start - queued, &e->lat_sum);
+		wq_stats_max(&e->lat_max, start - queued);
+	}
+	atomic64_add(exec, &e->exec_sum);
+	wq_stats_max(&e->exec_max, exec);
+	atomic64_add(task_sched_runtime(current) - cpu_start, &e->cpu_sum);
+}
+
+static int wq_stats_show(struct seq_file *m, void *v)
+{
+	int i;
+
+	seq_printf(m, "enabled: %d, functions not tracked: %d\n",
+		   wq_stats_on, atomic_read(&wq_stats_full));
+	seq_printf(m, "%-40s %-16s %10s %10s %10s %10s %10s %12s\n",
+		   "function", "workqueue", "count", "lat_avg", "lat_max",
+		   "exec_avg", "exec_max", "cpu_total");
+	seq_puts(m, "(us)\n");
+
+	for (i = 0; i < WQ_STATS_SIZE; i++) {
+		struct wq_stats_entry *e = &wq_stats[i];
+		u64 count = atomic64_read(&e->count);
+
+		if (!e->func || !count)
+			continue;
+		seq_printf(m, "%-40pf %-16s %10llu %10llu %10llu %10llu %10llu %12llu\n",
+			   (void *)e->func, e->wq_name, count,
+			   div64_u64(atomic64_read(&e->lat_sum), count * NSEC_PER_USEC),
+			   div_u64(atomic64_read(&e->lat_max), NSEC_PER_USEC),
+			   div64_u64(atomic64_read(&e->exec_sum), count * NSEC_PER_USEC),
+			   div_u64(atomic64_read(&e->exec_max), NSEC_PER_USEC),
+			   div_u64(atomic64_read(&e->cpu_sum), NSEC_PER_USEC));
+	}
+	return 0;
+}
+
+static int wq_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open_size(file, wq_stats_show, NULL,
+				(WQ_STATS_SIZE + 3) * 140);
+}
+
+static ssize_t wq_stats_write(struct file *file, const char __user *ubuf,
+			      size_t cnt, loff_t *ppos)
+{
+	unsigned long val;
+	int i, ret;
+
+	ret = kstrtoul_from_user(ubuf, cnt, 10, &val);
+	if (ret)
+		return ret;
+
+	mutex_lock(&wq_stats_mutex);
+	if (val == 1 && !wq_stats_on) {
+		static_key_slow_inc(&wq_stats_key);
+		wq_stats_on = true;
+	} else if (val == 0 && wq_stats_on) {
+		static_key_slow_dec(&wq_stats_key);
+		wq_stats_on = false;
+	} else if (val == 2) {
+		/* racing updates may survive, good enough for statistics */
+		for (i = 0; i < WQ_STATS_SIZE; i++) {
+			struct wq_stats_entry *e = &wq_stats[i];
+
+			atomic64_set(&e->count, 0);
+			atomic64_set(&e->lat_sum, 0);
+			atomic64_set(&e->lat_max, 0);
+			atomic64_set(&e->exec_sum, 0);
+			atomic64_set(&e->exec_max, 0);
+			atomic64_set(&e->cpu_sum, 0);
+		}
+		atomic_set(&wq_stats_full, 0);
+	}
+	mutex_unlock(&wq_stats_mutex);
+
+	return cnt;
+}
+
+static const struct file_operations wq_stats_fops = {
+	.open = wq_stats_open,
+	.read = seq_read,
+	.write = wq_stats_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init wq_stats_init(void)
+{
+	debugfs_create_file("workqueue_stats", 0644, NULL, NULL, &wq_stats_fops);
+	return 0;
+}
+fs_initcall(wq_stats_init);
+#else
+static inline void wq_stats_queued(struct work_struct *work) { }
+#endif /* CONFIG_MTK_WQ_STATS */
+
 /**
  * insert_work - insert a work into a pool
  * @pwq: pwq @work belongs to
@@ -1250,6 +1433,7 @@ static void insert_work(struct pool_workqueue *pwq, struct work_struct *work,
 	set_work_pwq(work, pwq, extra_flags);
 	list_add_tail(&work->entry, head);
 	get_pwq(pwq);
+	wq_stats_queued(work);
 
 	/*
 	 * Ensure either wq_worker_sleeping() sees the above
@@ -1941,6 +2125,11 @@ __acquires(&pool->lock)
 	bool cpu_intensive = pwq->wq->flags & WQ_CPU_INTENSIVE;
 	int work_color;
 	struct worker *collision;
+#ifdef CONFIG_MTK_WQ_STATS
+	bool wq_stats = static_key_false(&wq_stats_key);
+	u64 wq_stats_queue_ns = work->mtk_queue_ns;
+	u64 wq_stats_start = 0, wq_stats_cpu = 0;
+#endif
 #ifdef CONFIG_LOCKDEP
 	/*
 	 * It is permissible to free the struct work_struct from
@@ -2004,6 +2193,10 @@ __acquires(&pool->lock)
 	 * PENDING and queued state changes happen together while IRQ is
 	 * disabled.
 	 */
+#ifdef CONFIG_MTK_WQ_STATS
+	/* a stale stamp would show up as latency the next time */
+	work->mtk_queue_ns = 0;
+#endif
 	set_work_pool_and_clear_pending(work, pool->id);
 
 	spin_unlock_irq(&pool->lock);
@@ -2011,7 +2204,19 @@ __acquires(&pool->lock)
 	lock_map_acquire_read(&pwq->wq->lockdep_map);
 	lock_map_acquire(&lockdep_map);
 	trace_workqueue_execute_start(work);
+#ifdef CONFIG_MTK_WQ_STATS
+	if (wq_stats) {
+		wq_stats_cpu = task_sched_runtime(current);
+		wq_stats_start = sched_clock();
+	}
+#endif
 	worker->current_func(work);
+#ifdef CONFIG_MTK_WQ_STATS
+	/* @work may be gone, only what was read before is used */
+	if (wq_stats)
+		wq_stats_account(worker->current_func, pwq->wq,
+				 wq_stats_queue_ns, wq_stats_start, wq_stats_cpu);
+#endif
 	/*
 	 * While we must be careful to not use "work" after this, the trace
 	 * point will only record its address.
@@ -0,0 +1,204 @@
+/*
+ * Multi-generation aging of anonymous pages
+ *
+ * With most anonymous memory swapped to zram, the active/inactive anon
+ * lists alone make poor decisions: deactivation is unconditional, so a
+ * hot page of a background app only has one trip through the inactive
+ * list to show a reference before it is compressed, and is decompressed
+ * again right away.  In this mode anon pages instead carry a generation
+ * (see <linux/anon_aging.h>), reclaim only deactivates pages that went
+ * idle for several passes, and a background walker samples the page
+ * tables of swapping processes to move pages that are in use back to the
+ * youngest generation.  The walk goes through each mm's page tables in
+ * one batch instead of the per-page rmap walks reclaim does, which is a
+ * lot cheaper for the many anon pages that are mapped exactly once.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ */
+
+#include <linux/anon_aging.h>
+#include <linux/freezer.h>
+#include <linux/hugetlb.h>
+#include <linux/kthread.h>
+#include <linux/module.h>
+#include <linux/sched.h>
+#include <linux/swap.h>
+#include <linux/vmstat.h>
+#include <linux/wait.h>
+
+int anon_aging_enabled __read_mostly;
+module_param_named(enabled, anon_aging_enabled, int, S_IRUGO | S_IWUSR);
+
+/* Number of idle reclaim passes before an anon page may be deactivated */
+int anon_aging_evict_gen __read_mostly = 2;
+module_param_named(evict_gen, anon_aging_evict_gen, int, S_IRUGO | S_IWUSR);
+
+/* Minimum time between two page table walks */
+static unsigned int anon_aging_interval_ms = 1000;
+module_param_named(interval_ms, anon_aging_interval_ms, uint,
+		   S_IRUGO | S_IWUSR);
+
+static struct task_struct *anon_aging_task;
+static DECLARE_WAIT_QUEUE_HEAD(anon_aging_wait);
+static unsigned long anon_aging_last;
+static bool anon_aging_pending;
+
+static int anon_aging_pte_range(pmd_t *pmd, unsigned long addr,
+				unsigned long end, struct mm_walk *walk)
+{
+	struct vm_area_struct *vma = walk->private;
+	unsigned long young = 0;
+	struct page *page;
+	spinlock_t *ptl;
+	pte_t *pte;
+
+	split_huge_page_pmd(vma, addr, pmd);
+	if (pmd_trans_unstable(pmd))
+		return 0;
+
+	pte = pte_offset_map_lock(vma->vm_mm, pmd, addr, &ptl);
+	for (; addr != end; pte++, addr += PAGE_SIZE) {
+		if (!pte_present(*pte))
+			continue;
+
+		page = vm_normal_page(vma, addr, *pte);
+		if (!page || !PageAnon(page) || !PageLRU(page))
+			continue;
+
+		/*
+		 * No TLB flush: a stale young bit only delays noticing the
+		 * next access until the entry is evicted, which is fine
+		 * for sampling purposes.
+		 */
+		if (ptep_test_and_clear_young(vma, addr, pte)) {
+			set_page_anon_age(page, 0);
+			young++;
+		}
+	}
+	pte_unmap_unlock(pte - 1, ptl);
+
+	count_vm_events(ANON_AGING_YOUNG, young);
+	cond_resched();
+	return 0;
+}
+
+static void anon_aging_walk_mm(struct mm_struct *mm)
+{
+	struct vm_area_struct *vma;
+	struct mm_walk walk = {
+		.pmd_entry = anon_aging_pte_range,
+		.mm = mm,
+	};
+
+	/* Never hold up a task that is changing its address space */
+	if (!down_read_trylock(&mm->mmap_sem))
+		return;
+
+	for (vma = mm->mmap; vma; vma = vma->vm_next) {
+		if (!vma->anon_vma || is_vm_hugetlb_page(vma) ||
+		    (vma->vm_flags & (VM_LOCKED | VM_PFNMAP | VM_IO)))
+			continue;
+
+		walk.private = vma;
+		walk_page_range(vma->vm_start, vma->vm_end, &walk);
+
+		if (kthread_should_stop())
+			break;
+	}
+
+	up_read(&mm->mmap_sem);
+}
+
+/*
+ * Walk every mm that has pages out in swap: these are on init_mm.mmlist,
+ * and are exactly the processes whose anon memory is being aged out.
+ */
+static void anon_aging_walk(void)
+{
+	struct mm_struct *prev_mm = NULL;
+	struct list_head *p = &init_mm.mmlist;
+
+	count_vm_event(ANON_AGING_WALK);
+
+	spin_lock(&mmlist_lock);
+	while ((p = p->next) != &init_mm.mmlist) {
+		struct mm_struct *mm = list_entry(p, struct mm_struct, mmlist);
+
+		if (!atomic_inc_not_zero(&mm->mm_users))
+			continue;
+		spin_unlock(&mmlist_lock);
+
+		/* Our reference on prev_mm keeps it, and p, on the list */
+		if (prev_mm)
+			mmput(prev_mm);
+		prev_mm = mm;
+
+		anon_aging_walk_mm(mm);
+
+		spin_lock(&mmlist_lock);
+		if (kthread_should_stop())
+			break;
+	}
+	spin_unlock(&mmlist_lock);
+
+	if (prev_mm)
+		mmput(prev_mm);
+}
+
+static int anon_aging_thread(void *unused)
+{
+	struct sched_param param = { .sched_priority = 0 };
+
+	/* Sampling is worthless if it competes with the foreground */
+	sched_setscheduler(current, SCHED_IDLE, &param);
+	set_freezable();
+
+	while (!kthread_should_stop()) {
+		wait_event_freezable(anon_aging_wait,
+				     ACCESS_ONCE(anon_aging_pending) ||
+				     kthread_should_stop());
+		if (kthread_should_stop())
+			break;
+
+		anon_aging_pending = false;
+		anon_aging_walk();
+	}
+
+	return 0;
+}
+
+/**
+ * anon_aging_kick - request a page table walk
+ *
+ * Called by kswapd when it starts balancing a node.  The walk runs at
+ * most once every anon_aging_interval_ms.
+ */
+void anon_aging_kick(void)
+{
+	unsigned long next;
+
+	if (!anon_aging_enabled || !anon_aging_task)
+		return;
+
+	next = anon_aging_last + msecs_to_jiffies(anon_aging_interval_ms);
+	if (time_before(jiffies, next))
+		return;
+
+	anon_aging_last = jiffies;
+	anon_aging_pending = true;
+	wake_up(&anon_aging_wait);
+}
+
+static int __init anon_aging_init(void)
+{
+	anon_aging_task = kthread_run(anon_aging_thread, NULL, "kanonaged");
+	if (IS_ERR(anon_aging_task)) {
+		pr_err("anon_aging: failed to start kanonaged\n");
+		anon_aging_task = NULL;
+	}
+
+	return 0;
+}
+module_init(anon_aging_init);
@@ -56,6 +56,48 @@ unsigned long cma_get_size(struct cma *cma)
 	return cma->count << PAGE_SHIFT;
 }
 
+/**
+ * cma_get_occupancy() - report how much of a contiguous area is in use
+ * @cma:       Contiguous memory region to look at.
+ * @allocated: Set to the number of pages handed out by cma_alloc().
+ * @movable:   Set to the number of pages not handed out by cma_alloc(), but
+ *             in use by movable allocations, which a cma_alloc() covering
+ *             them would have to migrate first.
+ *
+ * The free page scan is not serialised against the allocator, so @movable
+ * is only a snapshot.
+ */
+void cma_get_occupancy(struct cma *cma, unsigned long *allocated,
+		       unsigned long *movable)
+{
+	unsigned long bitmap_maxno = cma->count >> cma->order_per_bit;
+	unsigned long pfn, end_pfn = cma->base_pfn + cma->count;
+	unsigned long free = 0;
+
+	mutex_lock(&cma->lock);
+	*allocated = bitmap_weight(cma->bitmap, bitmap_maxno) <<
+			cma->order_per_bit;
+
+	for (pfn = cma->base_pfn; pfn < end_pfn; pfn++) {
+		struct page *page = pfn_to_page(pfn);
+		unsigned long order;
+
+		if (!PageBuddy(page))
+			continue;
+
+		/* Stale if the page was allocated meanwhile, bound it */
+		order = page_private(page);
+		if (order >= MAX_ORDER)
+			continue;
+
+		free += 1UL << order;
+		pfn += (1UL << order) - 1;
+	}
+	mutex_unlock(&cma->lock);
+
+	*movable = cma->count - min(cma->count, *allocated + free);
+}
+
 static unsigned long cma_bitmap_aligned_mask(struct cma *cma, int align_order)
 {
 	if (align_order <= cma->order_per_bit)
@@ -16,6 +16,8 @@
 #include <linux/sysfs.h>
 #include <linux/balloon_compaction.h>
 #include <linux/page-isolation.h>
+#include <linux/kthread.h>
+#include <linux/freezer.h>
 #include "internal.h"
 
 #ifdef CONFIG_COMPACTION
@@ -1492,6 +1494,169 @@ int sysctl_extfrag_handler(struct ctl_table *table, int write,
 	return 0;
 }
 
+/*
+ * Proactive compaction: a kcompactd thread per node periodically looks for
+ * zones that have plenty of free memory but no free block of
+ * sysctl_compaction_proactive_order, and compacts them before an allocation
+ * has to stall in direct compaction. A zone is only considered fragmented
+ * when its fragmentation index for that order is above
+ * sysctl_compaction_proactive_fragindex; below that the failure is due to a
+ * lack of memory, which is kswapd's business.
+ *
+ * The thread runs SCHED_IDLE and only does async compaction, which backs
+ * off on need_resched() and lock contention, so it gets out of the way as
+ * soon as anything interactive wants the cpu.
+ */
+int sysctl_compaction_proactive_interval = 500;	/* ms, 0 disables */
+int sysctl_compaction_proactive_order = 4;
+int sysctl_compaction_proactive_fragindex = 500;
+
+static bool kcompactd_zone_needs_compaction(struct zone *zone, int order)
+{
+	unsigned long watermark = low_wmark_pages(zone);
+	int fragindex;
+
+	/* Already have a free block of the target order */
+	if (zone_watermark_ok(zone, order, watermark, 0, 0))
+		return false;
+
+	/* Not enough free pages to build one, compaction would be wasted */
+	if (!zone_watermark_ok(zone, 0, watermark + (2UL << order), 0, 0))
+		return false;
+
+	fragindex = fragmentation_index(zone, order);
+	return fragindex == -1000 ||
+		fragindex > sysctl_compaction_proactive_fragindex;
+}
+
+static void kcompactd_do_work(pg_data_t *pgdat)
+{
+	int zoneid;
+	struct zone *zone;
+	struct compact_control cc = {
+		.order = ACCESS_ONCE(sysctl_compaction_proactive_order),
+		.mode = MIGRATE_ASYNC,
+	};
+	bool woken = false;
+
+	for (zoneid = 0; zoneid < MAX_NR_ZONES; zoneid++) {
+		int status;
+
+		zone = &pgdat->node_zones[zoneid];
+		if (!populated_zone(zone))
+			continue;
+
+		if (compaction_deferred(zone, cc.order))
+			continue;
+
+		if (!kcompactd_zone_needs_compaction(zone, cc.order))
+			continue;
+
+		if (!woken) {
+			count_vm_event(KCOMPACTD_WAKE);
+			woken = true;
+		}
+
+		cc.nr_freepages = 0;
+		cc.nr_migratepages = 0;
+		cc.contended = 0;
+		cc.zone = zone;
+		INIT_LIST_HEAD(&cc.freepages);
+		INIT_LIST_HEAD(&cc.migratepages);
+
+		status = compact_zone(zone, &cc);
+
+		if (zone_watermark_ok(zone, cc.order,
+					low_wmark_pages(zone), 0, 0)) {
+			compaction_defer_reset(zone, cc.order, false);
+			count_vm_event(KCOMPACTD_SUCCESS);
+		} else if (status == COMPACT_COMPLETE) {
+			/* Scanned the whole zone and still failed, back off */
+			defer_compaction(zone, cc.order);
+		}
+
+		VM_BUG_ON(!list_empty(&cc.freepages));
+		VM_BUG_ON(!list_empty(&cc.migratepages));
+
+		if (kthread_should_stop())
+			return;
+	}
+}
+
+static int kcompactd(void *p)
+{
+	pg_data_t *pgdat = (pg_data_t *)p;
+	const struct cpumask *cpumask = cpumask_of_node(pgdat->node_id);
+	struct sched_param param = { .sched_priority = 0 };
+
+	if (!cpumask_empty(cpumask))
+		set_cpus_allowed_ptr(current, cpumask);
+
+	/* Only ever use cpu time nobody else wants */
+	sched_setscheduler(current, SCHED_IDLE, &param);
+	set_freezable();
+
+	while (!kthread_should_stop()) {
+		int interval = ACCESS_ONCE(sysctl_compaction_proactive_interval);
+		long timeout = interval ? msecs_to_jiffies(interval) :
+					  MAX_SCHEDULE_TIMEOUT;
+		DEFINE_WAIT(wait);
+
+		prepare_to_wait(&pgdat->kcompactd_wait, &wait,
+				TASK_INTERRUPTIBLE);
+		if (!kthread_should_stop())
+			schedule_timeout(timeout);
+		finish_wait(&pgdat->kcompactd_wait, &wait);
+
+		try_to_freeze();
+
+		if (kthread_should_stop())
+			break;
+
+		if (!ACCESS_ONCE(sysctl_compaction_proactive_interval))
+			continue;
+
+		kcompactd_do_work(pgdat);
+	}
+
+	return 0;
+}
+
+/* Wake every kcompactd so a new interval or target takes effect at once */
+int sysctl_compaction_proactive_handler(struct ctl_table *table, int write,
+			void __user *buffer, size_t *length, loff_t *ppos)
+{
+	int ret, nid;
+
+	ret = proc_dointvec_minmax(table, write, buffer, length, ppos);
+	if (ret || !write)
+		return ret;
+
+	for_each_node_state(nid, N_MEMORY)
+		wake_up_interruptible(&NODE_DATA(nid)->kcompactd_wait);
+
+	return 0;
+}
+
+static int __init kcompactd_init(void)
+{
+	int nid;
+
+	for_each_node_state(nid, N_MEMORY) {
+		pg_data_t *pgdat = NODE_DATA(nid);
+
+		pgdat->kcompactd = kthread_run(kcompactd, pgdat,
+					       "kcompactd%d", nid);
+		if (IS_ERR(pgdat->kcompactd)) {
+			pr_err("Failed to start kcompactd on node %d\n", nid);
+			pgdat->kcompactd = NULL;
+		}
+	}
+
+	return 0;
+}
+subsys_initcall(kcompactd_init);
+
 #if defined(CONFIG_SYSFS) && defined(CONFIG_NUMA)
 static ssize_t sysfs_compact_node(struct device *dev,
 			struct device_attribute *attr,
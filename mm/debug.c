@@ -48,6 +48,10 @@ static const struct trace_print_flags pageflag_names[] = {
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
 	{1UL << PG_compound_lock,	"compound_lock"	},
 #endif
+#ifdef CONFIG_ANON_AGING
+	{1UL << PG_anon_age0,		"anon_age0"	},
+	{1UL << PG_anon_age1,		"anon_age1"	},
+#endif
 #ifdef CONFIG_TOI_INCREMENTAL
 	{1UL << PG_toi_ignore,		"toi_ignore"	},
 	{1UL << PG_toi_ro,		"toi_ro"	},
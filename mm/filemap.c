@@ -35,6 +35,7 @@
 #include <linux/memcontrol.h>
 #include <linux/cleancache.h>
 #include <linux/rmap.h>
+#include <linux/pagecache_prefetch.h>
 #include "internal.h"
 
 #define CREATE_TRACE_POINTS
@@ -1489,6 +1490,7 @@ static ssize_t do_generic_file_read(struct file *filp, loff_t *ppos,
 find_page:
 		page = find_get_page(mapping, index);
 		if (!page) {
+			prefetch_record(filp, index, last_index - index);
 			page_cache_sync_readahead(mapping,
 					ra, filp,
 					index, last_index - index);
@@ -1796,6 +1798,8 @@ static void do_sync_mmap_readahead(struct vm_area_struct *vma,
 		return;
 	}
 
+	page_cache_ra_miss(mapping, ra, offset);
+
 	/* Avoid banging the cache line if not needed */
 	if (ra->mmap_miss < MMAP_LOTSAMISS * 10)
 		ra->mmap_miss++;
@@ -1892,6 +1896,7 @@ int filemap_fault(struct vm_area_struct *vma, struct vm_fault *vmf)
 	} else if (!page) {
 		trace_mm_fmflt_op_read(0);
 		/* No page in the page cache at all */
+		prefetch_record(file, offset, 1);
 		do_sync_mmap_readahead(vma, ra, file, offset);
 		trace_mm_fmflt_op_read_done(0);
 
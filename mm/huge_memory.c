@@ -23,6 +23,8 @@
 #include <linux/pagemap.h>
 #include <linux/migrate.h>
 #include <linux/hashtable.h>
+#include <linux/vmpressure.h>
+#include <linux/oom.h>
 
 #include <asm/tlb.h>
 #include <asm/pgalloc.h>
@@ -58,6 +60,16 @@ static struct task_struct *khugepaged_thread __read_mostly;
 static DEFINE_MUTEX(khugepaged_mutex);
 static DEFINE_SPINLOCK(khugepaged_mm_lock);
 static DECLARE_WAIT_QUEUE_HEAD(khugepaged_wait);
+/*
+ * Only collapse in mms whose owner has an oom_score_adj of at most
+ * foreground_adj: the pages of a cached app are better left to reclaim.
+ */
+static unsigned int khugepaged_foreground_only __read_mostly = 1;
+static int khugepaged_foreground_adj __read_mostly;
+/* no scan for this long after a medium or worse vmpressure event */
+static unsigned int khugepaged_pressure_backoff_millisecs __read_mostly = 10000;
+static unsigned long khugepaged_backoff_until;
+static unsigned int khugepaged_pressure_backoffs;
 /*
  * default collapse hugepages if there is at least one pte mapped like
  * it would have happened if the vma was large enough during page
@@ -513,6 +525,92 @@ static ssize_t full_scans_show(struct kobject *kobj,
 static struct kobj_attribute full_scans_attr =
 	__ATTR_RO(full_scans);
 
+static ssize_t foreground_only_show(struct kobject *kobj,
+				    struct kobj_attribute *attr,
+				    char *buf)
+{
+	return sprintf(buf, "%u\n", khugepaged_foreground_only);
+}
+static ssize_t foreground_only_store(struct kobject *kobj,
+				     struct kobj_attribute *attr,
+				     const char *buf, size_t count)
+{
+	unsigned long val;
+	int err;
+
+	err = kstrtoul(buf, 10, &val);
+	if (err || val > 1)
+		return -EINVAL;
+
+	khugepaged_foreground_only = val;
+
+	return count;
+}
+static struct kobj_attribute foreground_only_attr =
+	__ATTR(foreground_only, 0644, foreground_only_show,
+	       foreground_only_store);
+
+static ssize_t foreground_adj_show(struct kobject *kobj,
+				   struct kobj_attribute *attr,
+				   char *buf)
+{
+	return sprintf(buf, "%d\n", khugepaged_foreground_adj);
+}
+static ssize_t foreground_adj_store(struct kobject *kobj,
+				    struct kobj_attribute *attr,
+				    const char *buf, size_t count)
+{
+	int adj;
+	int err;
+
+	err = kstrtoint(buf, 10, &adj);
+	if (err || adj < OOM_SCORE_ADJ_MIN || adj > OOM_SCORE_ADJ_MAX)
+		return -EINVAL;
+
+	/* applies to mms from the next oom_score_adj write of their owner */
+	khugepaged_foreground_adj = adj;
+
+	return count;
+}
+static struct kobj_attribute foreground_adj_attr =
+	__ATTR(foreground_adj, 0644, foreground_adj_show,
+	       foreground_adj_store);
+
+static ssize_t pressure_backoff_millisecs_show(struct kobject *kobj,
+					       struct kobj_attribute *attr,
+					       char *buf)
+{
+	return sprintf(buf, "%u\n", khugepaged_pressure_backoff_millisecs);
+}
+static ssize_t pressure_backoff_millisecs_store(struct kobject *kobj,
+						struct kobj_attribute *attr,
+						const char *buf, size_t count)
+{
+	unsigned long msecs;
+	int err;
+
+	err = kstrtoul(buf, 10, &msecs);
+	if (err || msecs > UINT_MAX)
+		return -EINVAL;
+
+	khugepaged_pressure_backoff_millisecs = msecs;
+
+	return count;
+}
+static struct kobj_attribute pressure_backoff_millisecs_attr =
+	__ATTR(pressure_backoff_millisecs, 0644,
+	       pressure_backoff_millisecs_show,
+	       pressure_backoff_millisecs_store);
+
+static ssize_t pressure_backoffs_show(struct kobject *kobj,
+				      struct kobj_attribute *attr,
+				      char *buf)
+{
+	return sprintf(buf, "%u\n", khugepaged_pressure_backoffs);
+}
+static struct kobj_attribute pressure_backoffs_attr =
+	__ATTR_RO(pressure_backoffs);
+
 static ssize_t khugepaged_defrag_show(struct kobject *kobj,
 				      struct kobj_attribute *attr, char *buf)
 {
@@ -571,6 +669,10 @@ static struct attribute *khugepaged_attr[] = {
 	&full_scans_attr.attr,
 	&scan_sleep_millisecs_attr.attr,
 	&alloc_sleep_millisecs_attr.attr,
+	&foreground_only_attr.attr,
+	&foreground_adj_attr.attr,
+	&pressure_backoff_millisecs_attr.attr,
+	&pressure_backoffs_attr.attr,
 	NULL,
 };
 
@@ -646,6 +748,8 @@ static int __init hugepage_init(void)
 		goto out;
 
 	register_shrinker(&huge_zero_page_shrinker);
+	/* without memcg there are no global pressure events, nothing to do */
+	vmpressure_notifier_register(&khugepaged_vmpressure_nb);
 
 	/*
 	 * By default disable transparent hugepages on smaller systems,
@@ -843,6 +947,7 @@ int do_huge_pmd_anonymous_page(struct mm_struct *mm, struct vm_area_struct *vma,
 	}
 
 	count_vm_event(THP_FAULT_ALLOC);
+	atomic_inc(&mm->thp_faults);
 	return 0;
 }
 
@@ -1156,6 +1261,7 @@ alloc:
 	}
 
 	count_vm_event(THP_FAULT_ALLOC);
+	atomic_inc(&mm->thp_faults);
 
 	if (!page)
 		clear_huge_page(new_page, haddr, HPAGE_PMD_NR);
@@ -1865,7 +1971,10 @@ static void __split_huge_page(struct page *page,
 		struct vm_area_struct *vma = avc->vma;
 		unsigned long addr = vma_address(page, vma);
 		BUG_ON(is_vma_temporary_stack(vma));
-		mapcount += __split_huge_page_splitting(page, vma, addr);
+		if (__split_huge_page_splitting(page, vma, addr)) {
+			atomic_inc(&vma->vm_mm->thp_splits);
+			mapcount++;
+		}
 	}
 	/*
 	 * It is critical that new vmas are added to the tail of the
@@ -2533,6 +2642,7 @@ static void collapse_huge_page(struct mm_struct *mm,
 	*hpage = NULL;
 
 	khugepaged_pages_collapsed++;
+	atomic_inc(&mm->thp_collapses);
 out_up_write:
 	up_write(&mm->mmap_sem);
 	return;
@@ -2660,6 +2770,9 @@ static unsigned int khugepaged_scan_mm_slot(unsigned int pages,
 	down_read(&mm->mmap_sem);
 	if (unlikely(khugepaged_test_exit(mm)))
 		vma = NULL;
+	else if (khugepaged_foreground_only &&
+		 !test_bit(MMF_THP_FOREGROUND, &mm->flags))
+		vma = NULL;	/* skip to the next mm */
 	else
 		vma = find_vma(mm, khugepaged_scan.address);
 
@@ -2762,6 +2875,9 @@ static void khugepaged_do_scan(void)
 
 	barrier(); /* write khugepaged_pages_to_scan to local stack */
 
+	if (time_before(jiffies, ACCESS_ONCE(khugepaged_backoff_until)))
+		return;
+
 	while (progress < pages) {
 		if (!khugepaged_prealloc_page(&hpage, &wait))
 			break;
@@ -2787,6 +2903,30 @@ static void khugepaged_do_scan(void)
 		put_page(hpage);
 }
 
+static int khugepaged_vmpressure(struct notifier_block *nb,
+				 unsigned long level, void *data)
+{
+	if (level >= VMPRESSURE_MEDIUM && khugepaged_pressure_backoff_millisecs) {
+		khugepaged_backoff_until = jiffies +
+			msecs_to_jiffies(khugepaged_pressure_backoff_millisecs);
+		khugepaged_pressure_backoffs++;
+	}
+
+	return NOTIFY_OK;
+}
+
+static struct notifier_block khugepaged_vmpressure_nb = {
+	.notifier_call = khugepaged_vmpressure,
+};
+
+void khugepaged_adj_update(struct mm_struct *mm, short adj)
+{
+	if (adj <= ACCESS_ONCE(khugepaged_foreground_adj))
+		set_bit(MMF_THP_FOREGROUND, &mm->flags);
+	else
+		clear_bit(MMF_THP_FOREGROUND, &mm->flags);
+}
+
 static void khugepaged_wait_work(void)
 {
 	try_to_freeze();
@@ -25,6 +25,8 @@ static inline void set_page_count(struct page *page, int v)
 extern int __do_page_cache_readahead(struct address_space *mapping,
 		struct file *filp, pgoff_t offset, unsigned long nr_to_read,
 		unsigned long lookahead_size);
+extern void page_cache_ra_miss(struct address_space *mapping,
+		struct file_ra_state *ra, pgoff_t offset);
 
 /*
  * Submit IO for the read-ahead request in file_ra_state.
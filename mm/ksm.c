@@ -44,6 +44,9 @@
 #include <linux/fb.h>
 
 #include <asm/tlbflush.h>
+#ifdef CONFIG_ARM64
+#include <asm/hwcap.h>
+#endif
 #include "internal.h"
 
 #ifdef CONFIG_NUMA
@@ -103,12 +106,14 @@
  * @mm_list: link into the mm_slots list, rooted in ksm_mm_head
  * @rmap_list: head for this mm_slot's singly-linked list of rmap_items
  * @mm: the mm that this information is valid for
+ * @oom_score_adj: of its process, as of the start of the current full scan
  */
 struct mm_slot {
 	struct hlist_node link;
 	struct list_head mm_list;
 	struct rmap_item *rmap_list;
 	struct mm_struct *mm;
+	short oom_score_adj;
 };
 
 /**
@@ -228,6 +233,33 @@ static unsigned int ksm_thread_pages_to_scan = 100;
 /* Milliseconds ksmd should sleep between batches */
 static unsigned int ksm_thread_sleep_millisecs = 20;
 
+/* Microseconds a batch may take before ksmd stops it early, 0: no limit */
+static unsigned int ksm_scan_budget_usecs = 2000;
+
+/*
+ * Processes with an oom_score_adj below this are not scanned: with the
+ * default only those Android has moved out of the foreground, visible
+ * and perceptible classes.  OOM_SCORE_ADJ_MIN scans everything.
+ */
+static int ksm_min_oom_score_adj = 300;
+
+/* Map pages of zeroes to the zero page instead of sharing a KSM page */
+static unsigned int ksm_use_zero_pages = 1;
+
+/* Pages mapped to the zero page so far */
+static unsigned long ksm_zero_pages_merged;
+
+/* Checksum of a page of zeroes */
+static u32 zero_checksum __read_mostly;
+
+#ifdef CONFIG_ARM64
+/* Checksums use the CRC32 instructions */
+static bool ksm_use_crc32 __read_mostly;
+#endif
+
+/* ksmd is paused while the display is on, see ksmd_should_run() */
+static bool ksm_display_on = true;
+
 #ifdef CONFIG_NUMA
 /* Zeroed when merging across nodes is not allowed */
 static unsigned int ksm_merge_across_nodes = 1;
@@ -830,15 +862,47 @@ error:
 }
 #endif /* CONFIG_SYSFS */
 
+#ifdef CONFIG_ARM64
+/*
+ * The checksum only has to tell a page that changed since the last scan,
+ * identical pages are still compared in full: the CRC32 instructions of
+ * ARMv8 do that for less than jhash2 costs.
+ */
+static u32 crc32_page(const void *addr)
+{
+	const u64 *p = addr, *end = addr + PAGE_SIZE;
+	u32 crc = ~0U;
+
+	for (; p < end; p++)
+		asm(".arch armv8-a+crc\n\tcrc32x %w0, %w0, %x1"
+		    : "+r" (crc) : "r" (*p));
+	return crc;
+}
+#endif
+
 static u32 calc_checksum(struct page *page)
 {
 	u32 checksum;
 	void *addr = kmap_atomic(page);
-	checksum = jhash2(addr, PAGE_SIZE / 4, 17);
+#ifdef CONFIG_ARM64
+	if (ksm_use_crc32)
+		checksum = crc32_page(addr);
+	else
+#endif
+		checksum = jhash2(addr, PAGE_SIZE / 4, 17);
 	kunmap_atomic(addr);
 	return checksum;
 }
 
+static bool page_is_zero_filled(struct page *page)
+{
+	void *addr = kmap_atomic(page);
+	bool zero = !memchr_inv(addr, 0, PAGE_SIZE);
+
+	kunmap_atomic(addr);
+	return zero;
+}
+
 static int memcmp_pages(struct page *page1, struct page *page2)
 {
 	char *addr1, *addr2;
@@ -926,7 +990,7 @@ out:
  * replace_page - replace page in vma by new ksm page
  * @vma:      vma that holds the pte pointing to page
  * @page:     the page we are replacing by kpage
- * @kpage:    the ksm page we replace page by
+ * @kpage:    the ksm page we replace page by, or the zero page
  * @orig_pte: the original value of the pte
  *
  * Returns 0 on success, -EFAULT on failure.
@@ -937,6 +1001,7 @@ static int replace_page(struct vm_area_struct *vma, struct page *page,
 	struct mm_struct *mm = vma->vm_mm;
 	pmd_t *pmd;
 	pte_t *ptep;
+	pte_t newpte;
 	spinlock_t *ptl;
 	unsigned long addr;
 	int err = -EFAULT;
@@ -961,12 +1026,19 @@ static int replace_page(struct vm_area_struct *vma, struct page *page,
 		goto out_mn;
 	}
 
-	get_page(kpage);
-	page_add_anon_rmap(kpage, vma, addr);
+	if (!is_zero_pfn(page_to_pfn(kpage))) {
+		get_page(kpage);
+		page_add_anon_rmap(kpage, vma, addr);
+		newpte = mk_pte(kpage, vma->vm_page_prot);
+	} else {
+		/* no rmap and no reference, like do_anonymous_page() */
+		newpte = pte_mkspecial(pfn_pte(page_to_pfn(kpage),
+					       vma->vm_page_prot));
+	}
 
 	flush_cache_page(vma, addr, pte_pfn(*ptep));
 	ptep_clear_flush(vma, addr, ptep);
-	set_pte_at_notify(mm, addr, ptep, mk_pte(kpage, vma->vm_page_prot));
+	set_pte_at_notify(mm, addr, ptep, newpte);
 
 	page_remove_rmap(page);
 	if (!page_mapped(page))
@@ -1063,7 +1135,8 @@ static int try_to_merge_one_page(struct vm_area_struct *vma,
 			err = replace_page(vma, page, kpage, orig_pte);
 	}
 
-	if ((vma->vm_flags & VM_LOCKED) && kpage && !err) {
+	if ((vma->vm_flags & VM_LOCKED) && kpage && !err &&
+	    !is_zero_pfn(page_to_pfn(kpage))) {
 		munlock_vma_page(page);
 		if (!PageMlocked(kpage)) {
 			unlock_page(page);
@@ -1113,6 +1186,33 @@ out:
 	return err;
 }
 
+/*
+ * try_to_merge_with_zero_page - map the zero page instead of page, which
+ * must be all zeroes.  Nothing goes to the stable tree: a write fault
+ * just allocates a new page, as for any other zero page mapping.
+ *
+ * This function returns 0 if the page was replaced, -EFAULT otherwise.
+ */
+static int try_to_merge_with_zero_page(struct rmap_item *rmap_item,
+				       struct page *page)
+{
+	struct mm_struct *mm = rmap_item->mm;
+	struct vm_area_struct *vma;
+	int err = -EFAULT;
+
+	down_read(&mm->mmap_sem);
+	if (ksm_test_exit(mm))
+		goto out;
+	vma = find_vma(mm, rmap_item->address);
+	if (!vma || vma->vm_start > rmap_item->address)
+		goto out;
+
+	err = try_to_merge_one_page(vma, page, ZERO_PAGE(rmap_item->address));
+out:
+	up_read(&mm->mmap_sem);
+	return err;
+}
+
 /*
  * try_to_merge_two_pages - take two identical pages and prepare them
  * to be merged into one page.
@@ -1440,6 +1540,23 @@ static void cmp_and_merge_page(struct page *page, struct rmap_item *rmap_item)
 			return;
 	}
 
+	/*
+	 * Zero pages are the most common duplicates and the cheapest to
+	 * find: the test stops at the first byte that is not zero, and no
+	 * tree is searched for them.  Like any other page, one must stay
+	 * unchanged for a scan before it is merged.
+	 */
+	if (!stable_node && ksm_use_zero_pages && page_is_zero_filled(page)) {
+		if (rmap_item->oldchecksum != zero_checksum) {
+			rmap_item->oldchecksum = zero_checksum;
+			return;
+		}
+		remove_rmap_item_from_tree(rmap_item);
+		if (!try_to_merge_with_zero_page(rmap_item, page))
+			ksm_zero_pages_merged++;
+		return;
+	}
+
 	/* We first start with searching the page inside the stable tree */
 	kpage = stable_tree_search(page);
 	if (kpage == page && rmap_item->head == stable_node) {
@@ -1537,6 +1654,52 @@ static struct rmap_item *get_next_rmap_item(struct mm_slot *mm_slot,
 	return rmap_item;
 }
 
+/*
+ * Give each mm_slot the oom_score_adj of its process, for skipping the
+ * ones in the foreground.  Done once per full scan: an app which changes
+ * class keeps its old one until the next.
+ */
+static void ksm_update_slots_adj(void)
+{
+	struct task_struct *p, *t;
+	struct mm_slot *slot;
+
+	rcu_read_lock();
+	for_each_process(p) {
+		t = find_lock_task_mm(p);
+		if (!t)
+			continue;
+		if (test_bit(MMF_VM_MERGEABLE, &t->mm->flags)) {
+			spin_lock(&ksm_mmlist_lock);
+			slot = get_mm_slot(t->mm);
+			if (slot)
+				slot->oom_score_adj = t->signal->oom_score_adj;
+			spin_unlock(&ksm_mmlist_lock);
+		}
+		task_unlock(t);
+	}
+	rcu_read_unlock();
+}
+
+/*
+ * An mm left out of a full scan must not keep rmap_items in the unstable
+ * tree: they would be two scans old when next removed.
+ */
+static void ksm_skip_slot(struct mm_slot *slot)
+{
+	struct rmap_item *rmap_item;
+
+	for (rmap_item = slot->rmap_list; rmap_item;
+	     rmap_item = rmap_item->rmap_list)
+		if (rmap_item->address & UNSTABLE_FLAG)
+			remove_rmap_item_from_tree(rmap_item);
+
+	spin_lock(&ksm_mmlist_lock);
+	ksm_scan.mm_slot = list_entry(slot->mm_list.next,
+						struct mm_slot, mm_list);
+	spin_unlock(&ksm_mmlist_lock);
+}
+
 static struct rmap_item *scan_get_next_rmap_item(struct page **page)
 {
 	struct mm_struct *mm;
@@ -1586,6 +1749,9 @@ static struct rmap_item *scan_get_next_rmap_item(struct page **page)
 		for (nid = 0; nid < ksm_nr_node_ids; nid++)
 			root_unstable_tree[nid] = RB_ROOT;
 
+		if (ksm_min_oom_score_adj > OOM_SCORE_ADJ_MIN)
+			ksm_update_slots_adj();
+
 		spin_lock(&ksm_mmlist_lock);
 		slot = list_entry(slot->mm_list.next, struct mm_slot, mm_list);
 		ksm_scan.mm_slot = slot;
@@ -1602,6 +1768,12 @@ next_mm:
 	}
 
 	mm = slot->mm;
+	/* an exiting mm is never skipped, this scan has to free its slot */
+	if (slot->oom_score_adj < ACCESS_ONCE(ksm_min_oom_score_adj) &&
+	    !ksm_test_exit(mm)) {
+		ksm_skip_slot(slot);
+		goto next_slot;
+	}
 	down_read(&mm->mmap_sem);
 	if (ksm_test_exit(mm))
 		vma = NULL;
@@ -1682,6 +1854,7 @@ next_mm:
 		up_read(&mm->mmap_sem);
 	}
 
+next_slot:
 	/* Repeat until we've completed scanning the whole list */
 	slot = ksm_scan.mm_slot;
 	if (slot != &ksm_mm_head)
@@ -1694,13 +1867,19 @@ next_mm:
 /**
  * ksm_do_scan  - the ksm scanner main worker function.
  * @scan_npages - number of pages we want to scan before we return.
+ *
+ * It also returns once the batch has taken ksm_scan_budget_usecs.
  */
 static void ksm_do_scan(unsigned int scan_npages)
 {
 	struct rmap_item *rmap_item;
 	struct page *uninitialized_var(page);
+	unsigned int budget = ACCESS_ONCE(ksm_scan_budget_usecs);
+	u64 deadline = local_clock() + (u64)budget * NSEC_PER_USEC;
 
 	while (scan_npages-- && likely(!freezing(current))) {
+		if (budget && local_clock() > deadline)
+			return;
 		cond_resched();
 		rmap_item = scan_get_next_rmap_item(&page);
 		if (!rmap_item)
@@ -1783,15 +1962,27 @@ static void ksm_tuning_pressure(void)
 #endif
 }
 
+/*
+ * Merging costs CPU time the user would notice while using the phone,
+ * so ksmd only runs while the display is off.  That leaves run to the
+ * user: the display no longer starts or stops it.
+ */
+static void ksm_display_change(bool on)
+{
+	ksm_display_on = on;
+	if (!on)
+		wake_up_interruptible(&ksm_thread_wait);
+}
+
 #ifdef CONFIG_HAS_EARLYSUSPEND
 static void ksm_early_suspend(struct early_suspend *h)
 {
-	ksm_run_change(KSM_RUN_STOP);
+	ksm_display_change(false);
 }
 
 static void ksm_late_resume(struct early_suspend *h)
 {
-	ksm_run_change(KSM_RUN_MERGE);
+	ksm_display_change(true);
 }
 
 static struct early_suspend ksm_early_suspend_handler = {
@@ -1810,9 +2001,9 @@ static int ksm_fb_notifier_callback(struct notifier_block *p,
 	blank = *(int *)((struct fb_event *)data)->data;
 
 	if (blank == FB_BLANK_UNBLANK) { /*LCD ON*/
-		ksm_run_change(KSM_RUN_MERGE);
+		ksm_display_change(true);
 	} else if (blank == FB_BLANK_POWERDOWN) { /*LCD OFF*/
-		ksm_run_change(KSM_RUN_STOP);
+		ksm_display_change(false);
 	}
 
 	return 0;
@@ -1820,7 +2011,7 @@ static int ksm_fb_notifier_callback(struct notifier_block *p,
 
 static struct notifier_block ksm_fb_notifier = {
 	.notifier_call = ksm_fb_notifier_callback,
-}
+};
 #endif
 #else /* no KSM_KCTL_INTERFACE*/
 static ssize_t ksm_run_change(unsigned long flags)
@@ -1831,6 +2022,10 @@ EXPORT_SYMBOL(ksm_run_change);
 
 static int ksmd_should_run(void)
 {
+#ifdef KSM_KCTL_INTERFACE
+	if (ACCESS_ONCE(ksm_display_on))
+		return 0;
+#endif
 	return (ksm_run & KSM_RUN_MERGE) && !list_empty(&ksm_mm_head.mm_list);
 }
 
@@ -1924,6 +2119,9 @@ int __ksm_enter(struct mm_struct *mm)
 	/* Check ksm_run too?  Would need tighter locking */
 	needs_wakeup = list_empty(&ksm_mm_head.mm_list);
 
+	/* the caller is the process of mm, or its parent in fork */
+	mm_slot->oom_score_adj = current->signal->oom_score_adj;
+
 	spin_lock(&ksm_mmlist_lock);
 	insert_to_mm_slots_hash(mm, mm_slot);
 	/*
@@ -2257,6 +2455,74 @@ static ssize_t pages_to_scan_store(struct kobject *kobj,
 }
 KSM_ATTR(pages_to_scan);
 
+static ssize_t scan_budget_usecs_show(struct kobject *kobj,
+				      struct kobj_attribute *attr, char *buf)
+{
+	return sprintf(buf, "%u\n", ksm_scan_budget_usecs);
+}
+
+static ssize_t scan_budget_usecs_store(struct kobject *kobj,
+				       struct kobj_attribute *attr,
+				       const char *buf, size_t count)
+{
+	unsigned long usecs;
+	int err;
+
+	err = kstrtoul(buf, 10, &usecs);
+	if (err || usecs > UINT_MAX)
+		return -EINVAL;
+
+	ksm_scan_budget_usecs = usecs;
+
+	return count;
+}
+KSM_ATTR(scan_budget_usecs);
+
+static ssize_t min_oom_score_adj_show(struct kobject *kobj,
+				      struct kobj_attribute *attr, char *buf)
+{
+	return sprintf(buf, "%d\n", ksm_min_oom_score_adj);
+}
+
+static ssize_t min_oom_score_adj_store(struct kobject *kobj,
+				       struct kobj_attribute *attr,
+				       const char *buf, size_t count)
+{
+	int err, adj;
+
+	err = kstrtoint(buf, 10, &adj);
+	if (err || adj < OOM_SCORE_ADJ_MIN || adj > OOM_SCORE_ADJ_MAX)
+		return -EINVAL;
+
+	ksm_min_oom_score_adj = adj;
+
+	return count;
+}
+KSM_ATTR(min_oom_score_adj);
+
+static ssize_t use_zero_pages_show(struct kobject *kobj,
+				   struct kobj_attribute *attr, char *buf)
+{
+	return sprintf(buf, "%u\n", ksm_use_zero_pages);
+}
+
+static ssize_t use_zero_pages_store(struct kobject *kobj,
+				    struct kobj_attribute *attr,
+				    const char *buf, size_t count)
+{
+	int err;
+	unsigned long knob;
+
+	err = kstrtoul(buf, 10, &knob);
+	if (err || knob > 1)
+		return -EINVAL;
+
+	ksm_use_zero_pages = knob;
+
+	return count;
+}
+KSM_ATTR(use_zero_pages);
+
 static ssize_t run_show(struct kobject *kobj, struct kobj_attribute *attr,
 			char *buf)
 {
@@ -2401,6 +2667,13 @@ static ssize_t pages_volatile_show(struct kobject *kobj,
 }
 KSM_ATTR_RO(pages_volatile);
 
+static ssize_t zero_pages_merged_show(struct kobject *kobj,
+				      struct kobj_attribute *attr, char *buf)
+{
+	return sprintf(buf, "%lu\n", ksm_zero_pages_merged);
+}
+KSM_ATTR_RO(zero_pages_merged);
+
 static ssize_t full_scans_show(struct kobject *kobj,
 			       struct kobj_attribute *attr, char *buf)
 {
@@ -2417,6 +2690,10 @@ static struct attribute *ksm_attrs[] = {
 	&pages_unshared_attr.attr,
 	&pages_volatile_attr.attr,
 	&full_scans_attr.attr,
+	&scan_budget_usecs_attr.attr,
+	&min_oom_score_adj_attr.attr,
+	&use_zero_pages_attr.attr,
+	&zero_pages_merged_attr.attr,
 #ifdef CONFIG_NUMA
 	&merge_across_nodes_attr.attr,
 #endif
@@ -2438,6 +2715,11 @@ static int __init ksm_init(void)
 	if (err)
 		goto out;
 
+#ifdef CONFIG_ARM64
+	ksm_use_crc32 = elf_hwcap & HWCAP_CRC32;
+#endif
+	zero_checksum = calc_checksum(ZERO_PAGE(0));
+
 	ksm_thread = kthread_run(ksm_scan_thread, NULL, "ksmd");
 	if (IS_ERR(ksm_thread)) {
 		pr_err("ksm: creating kthread failed\n");
@@ -315,6 +315,8 @@ struct mem_cgroup {
 	atomic_t	oom_wakeups;
 
 	int	swappiness;
+	/* usage below which reclaim leaves the working set alone */
+	unsigned long long workingset_protect;
 	/* OOM-Killer disable */
 	int		oom_kill_disable;
 
@@ -4494,6 +4496,59 @@ static int mem_cgroup_swappiness_write(struct cgroup_subsys_state *css,
 	return 0;
 }
 
+static u64 mem_cgroup_protect_read(struct cgroup_subsys_state *css,
+				   struct cftype *cft)
+{
+	return mem_cgroup_from_css(css)->workingset_protect;
+}
+
+static ssize_t mem_cgroup_protect_write(struct kernfs_open_file *of,
+					char *buf, size_t nbytes, loff_t off)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_css(of_css(of));
+	unsigned long long val;
+	int ret;
+
+	/* Nothing to protect the root against */
+	if (mem_cgroup_is_root(memcg))
+		return -EINVAL;
+
+	ret = res_counter_memparse_write_strategy(strstrip(buf), &val);
+	if (ret)
+		return ret;
+
+	memcg->workingset_protect = val;
+	return nbytes;
+}
+
+/**
+ * mem_cgroup_protected - check if a memcg's working set is protected
+ * @root: top of the hierarchy being reclaimed, NULL for global reclaim
+ * @memcg: the memcg to check
+ *
+ * Returns %true if @memcg and all its ancestors below @root use less
+ * memory than their memory.workingset_protect_in_bytes, in which case
+ * reclaim should go after other groups first.
+ */
+bool mem_cgroup_protected(struct mem_cgroup *root, struct mem_cgroup *memcg)
+{
+	if (mem_cgroup_disabled())
+		return false;
+
+	if (!root)
+		root = root_mem_cgroup;
+	if (memcg == root)
+		return false;
+
+	for (; memcg && memcg != root; memcg = parent_mem_cgroup(memcg)) {
+		if (res_counter_read_u64(&memcg->res, RES_USAGE) >=
+		    ACCESS_ONCE(memcg->workingset_protect))
+			return false;
+	}
+
+	return true;
+}
+
 static void __mem_cgroup_threshold(struct mem_cgroup *memcg, bool swap)
 {
 	struct mem_cgroup_threshold_ary *t;
@@ -5181,6 +5236,11 @@ static struct cftype mem_cgroup_files[] = {
 		.read_u64 = mem_cgroup_swappiness_read,
 		.write_u64 = mem_cgroup_swappiness_write,
 	},
+	{
+		.name = "workingset_protect_in_bytes",
+		.read_u64 = mem_cgroup_protect_read,
+		.write = mem_cgroup_protect_write,
+	},
 	{
 		.name = "move_charge_at_immigrate",
 		.read_u64 = mem_cgroup_move_charge_read,
@@ -2425,7 +2425,11 @@ static void unmap_region(struct mm_struct *mm,
  * Create a list of vma's touched by the unmap, removing them from the mm's
  * vma list as we go..
  */
-static void
+/*
+ * Returns false if the gap left behind can be grown into by a stack
+ * expanding under mmap_sem for read, see do_munmap_downgrade().
+ */
+static bool
 detach_vmas_to_be_unmapped(struct mm_struct *mm, struct vm_area_struct *vma,
 	struct vm_area_struct *prev, unsigned long end)
 {
@@ -2450,6 +2454,12 @@ detach_vmas_to_be_unmapped(struct mm_struct *mm, struct vm_area_struct *vma,
 
 	/* Kill the cache */
 	vmacache_invalidate(mm);
+
+	if (vma && (vma->vm_flags & VM_GROWSDOWN))
+		return false;
+	if (prev && (prev->vm_flags & VM_GROWSUP))
+		return false;
+	return true;
 }
 
 /*
@@ -2538,7 +2548,13 @@ int split_vma(struct mm_struct *mm, struct vm_area_struct *vma,
  * work.  This now handles partial unmappings.
  * Jeremy Fitzhardinge <jeremy@goop.org>
  */
-int do_munmap(struct mm_struct *mm, unsigned long start, size_t len)
+/*
+ * With @downgrade, mmap_sem is downgraded to read once the vmas are
+ * detached, so page faults in other threads are not held off while the
+ * pages and page tables are freed.  Returns 1 if it was downgraded.
+ */
+static int do_munmap_downgrade(struct mm_struct *mm, unsigned long start,
+			       size_t len, bool downgrade)
 {
 	unsigned long end;
 	struct vm_area_struct *vma, *prev, *last;
@@ -2618,13 +2634,23 @@ int do_munmap(struct mm_struct *mm, unsigned long start, size_t len)
 	/*
 	 * Remove the vma's, and unmap the actual pages
 	 */
-	detach_vmas_to_be_unmapped(mm, vma, prev, end);
+	if (!detach_vmas_to_be_unmapped(mm, vma, prev, end))
+		downgrade = false;
+
+	if (downgrade)
+		downgrade_write(&mm->mmap_sem);
+
 	unmap_region(mm, vma, prev, start, end);
 
 	/* Fix up all other VM information */
 	remove_vma_list(mm, vma);
 
-	return 0;
+	return downgrade ? 1 : 0;
+}
+
+int do_munmap(struct mm_struct *mm, unsigned long start, size_t len)
+{
+	return do_munmap_downgrade(mm, start, len, false);
 }
 
 int vm_munmap(unsigned long start, size_t len)
@@ -2641,8 +2667,20 @@ EXPORT_SYMBOL(vm_munmap);
 
 SYSCALL_DEFINE2(munmap, unsigned long, addr, size_t, len)
 {
+	struct mm_struct *mm = current->mm;
+	int ret;
+
 	profile_munmap(addr);
-	return vm_munmap(addr, len);
+
+	down_write(&mm->mmap_sem);
+	ret = do_munmap_downgrade(mm, addr, len, true);
+	if (ret == 1) {
+		up_read(&mm->mmap_sem);
+		ret = 0;
+	} else {
+		up_write(&mm->mmap_sem);
+	}
+	return ret;
 }
 
 static inline void verify_mm_writelocked(struct mm_struct *mm)
@@ -257,15 +257,24 @@ static unsigned long global_dirtyable_memory(void)
  * Calculate the dirty thresholds based on sysctl parameters
  * - vm.dirty_background_ratio  or  vm.dirty_background_bytes
  * - vm.dirty_ratio             or  vm.dirty_bytes
- * The dirty limits will be lifted by 1/4 for PF_LESS_THROTTLE (ie. nfsd) and
- * real-time tasks.
+ * The dirty limits will be lifted by 1/4 for PF_LESS_THROTTLE (ie. nfsd),
+ * real-time tasks and tasks of a foreground blkcg, and lowered by 1/4 for
+ * tasks of other, background, blkcgs.
  */
+static int dirty_throttle_class(struct task_struct *tsk)
+{
+	if (tsk->flags & PF_LESS_THROTTLE || rt_task(tsk))
+		return 1;
+	return blkcg_dirty_class(tsk);
+}
+
 void global_dirty_limits(unsigned long *pbackground, unsigned long *pdirty)
 {
 	const unsigned long available_memory = global_dirtyable_memory();
 	unsigned long background;
 	unsigned long dirty;
 	struct task_struct *tsk;
+	int class;
 
 	if (vm_dirty_bytes)
 		dirty = DIV_ROUND_UP(vm_dirty_bytes, PAGE_SIZE);
@@ -280,9 +289,13 @@ void global_dirty_limits(unsigned long *pbackground, unsigned long *pdirty)
 	if (background >= dirty)
 		background = dirty / 2;
 	tsk = current;
-	if (tsk->flags & PF_LESS_THROTTLE || rt_task(tsk)) {
+	class = dirty_throttle_class(tsk);
+	if (class > 0) {
 		background += background / 4;
 		dirty += dirty / 4;
+	} else if (class < 0) {
+		background -= background / 4;
+		dirty -= dirty / 4;
 	}
 	*pbackground = background;
 	*pdirty = dirty;
@@ -301,6 +314,7 @@ static unsigned long zone_dirty_limit(struct zone *zone)
 	unsigned long zone_memory = zone_dirtyable_memory(zone);
 	struct task_struct *tsk = current;
 	unsigned long dirty;
+	int class;
 
 	if (vm_dirty_bytes)
 		dirty = DIV_ROUND_UP(vm_dirty_bytes, PAGE_SIZE) *
@@ -308,8 +322,11 @@ static unsigned long zone_dirty_limit(struct zone *zone)
 	else
 		dirty = vm_dirty_ratio * zone_memory / 100;
 
-	if (tsk->flags & PF_LESS_THROTTLE || rt_task(tsk))
+	class = dirty_throttle_class(tsk);
+	if (class > 0)
 		dirty += dirty / 4;
+	else if (class < 0)
+		dirty -= dirty / 4;
 
 	return dirty;
 }
@@ -1359,6 +1376,8 @@ static void balance_dirty_pages(struct address_space *mapping,
 	bool strictlimit = bdi->capabilities & BDI_CAP_STRICTLIMIT;
 	unsigned long start_time = jiffies;
 
+	blkcg_account_dirty(current, pages_dirtied, 0);
+
 	for (;;) {
 		unsigned long now = jiffies;
 		unsigned long uninitialized_var(bdi_thresh);
@@ -1495,6 +1514,7 @@ pause:
 					  start_time);
 		__set_current_state(TASK_KILLABLE);
 		io_schedule_timeout(pause);
+		blkcg_account_dirty(current, 0, pause);
 
 		current->dirty_paused_when = now + pause;
 		current->nr_dirtied = 0;
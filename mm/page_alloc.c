@@ -1120,6 +1120,35 @@ static void try_to_steal_freepages(struct zone *zone, struct page *page,
 	}
 }
 
+#ifdef CONFIG_CMA
+/*
+ * Keep movable allocations out of MIGRATE_CMA pageblocks for as long as the
+ * zone has more than this many other free pages above its high watermark.
+ * CMA areas that are powered down or handed out as a whole (e.g. the memory
+ * lowpower area) then only need to be evacuated of what memory pressure
+ * forced into them.  0 keeps the default of falling back to CMA first.
+ */
+unsigned long cma_fallback_free_pages __read_mostly;
+
+static bool cma_fallback_allowed(struct zone *zone)
+{
+	unsigned long free;
+
+	if (!cma_fallback_free_pages)
+		return true;
+
+	free = zone_page_state(zone, NR_FREE_PAGES) -
+		zone_page_state(zone, NR_FREE_CMA_PAGES);
+
+	return free < high_wmark_pages(zone) + cma_fallback_free_pages;
+}
+#else
+static inline bool cma_fallback_allowed(struct zone *zone)
+{
+	return true;
+}
+#endif
+
 /* Remove an element from the buddy allocator from the fallback list */
 static inline struct page *
 __rmqueue_fallback(struct zone *zone, unsigned int order, int start_migratetype)
@@ -1127,7 +1156,9 @@ __rmqueue_fallback(struct zone *zone, unsigned int order, int start_migratetype)
 	struct free_area *area;
 	unsigned int current_order;
 	struct page *page;
+	bool use_cma = cma_fallback_allowed(zone);
 
+retry:
 	/* Find the largest possible block of pages in the other list */
 	for (current_order = MAX_ORDER-1;
 				current_order >= order && current_order <= MAX_ORDER-1;
@@ -1141,6 +1172,9 @@ __rmqueue_fallback(struct zone *zone, unsigned int order, int start_migratetype)
 			if (migratetype == MIGRATE_RESERVE)
 				break;
 
+			if (is_migrate_cma(migratetype) && !use_cma)
+				continue;
+
 			area = &(zone->free_area[current_order]);
 			if (list_empty(&area->free_list[migratetype]))
 				continue;
@@ -1187,6 +1221,12 @@ __rmqueue_fallback(struct zone *zone, unsigned int order, int start_migratetype)
 		}
 	}
 
+	/* Free pages of other types were isolated or reserved: take CMA */
+	if (!use_cma) {
+		use_cma = true;
+		goto retry;
+	}
+
 	return NULL;
 }
 
@@ -1452,6 +1492,77 @@ out:
 	local_irq_restore(flags);
 }
 
+/*
+ * Pages freed per hold of the zone lock by free_pages_bulk(), so that
+ * interrupts are not held off for the whole list.
+ */
+#define FREE_PAGES_BULK_BATCH	64
+
+/**
+ * free_pages_bulk - drop a reference to each page on a list
+ * @list: pages of @order, linked through page->lru
+ * @order: allocation order of every page on @list
+ *
+ * Does what __free_pages() does for each page, but frees the high order
+ * pages whose last reference went away in batches under a single hold of
+ * the zone lock, instead of taking it once per page.  Order-0 pages go to
+ * the pcp lists, which already drain to the buddy lists in batches.
+ * @list is empty on return.
+ */
+void free_pages_bulk(struct list_head *list, unsigned int order)
+{
+	struct zone *locked_zone = NULL;
+	struct page *page, *next;
+	unsigned long nr_scanned;
+	unsigned long flags;
+	int batch = 0;
+
+	list_for_each_entry_safe(page, next, list, lru) {
+		if (!put_page_testzero(page) ||
+		    (order && !free_pages_prepare(page, order)))
+			list_del(&page->lru);
+	}
+
+	if (!order) {
+		free_hot_cold_page_list(list, false);
+		INIT_LIST_HEAD(list);
+		return;
+	}
+
+	local_irq_save(flags);
+	list_for_each_entry_safe(page, next, list, lru) {
+		unsigned long pfn = page_to_pfn(page);
+		struct zone *zone = page_zone(page);
+		int migratetype;
+
+		if (zone != locked_zone || ++batch > FREE_PAGES_BULK_BATCH) {
+			if (locked_zone) {
+				spin_unlock(&locked_zone->lock);
+				local_irq_restore(flags);
+				local_irq_save(flags);
+			}
+			spin_lock(&zone->lock);
+			locked_zone = zone;
+			batch = 0;
+
+			nr_scanned = zone_page_state(zone, NR_PAGES_SCANNED);
+			if (nr_scanned)
+				__mod_zone_page_state(zone, NR_PAGES_SCANNED,
+						      -nr_scanned);
+		}
+
+		list_del(&page->lru);
+		migratetype = get_pfnblock_migratetype(page, pfn);
+		set_freepage_migratetype(page, migratetype);
+		__count_vm_events(PGFREE, 1 << order);
+		__free_one_page(page, pfn, zone, order, migratetype);
+	}
+	if (locked_zone)
+		spin_unlock(&locked_zone->lock);
+	local_irq_restore(flags);
+}
+EXPORT_SYMBOL(free_pages_bulk);
+
 /*
  * Free a list of 0-order pages
  */
@@ -4922,6 +5033,9 @@ static void __paginginit free_area_init_core(struct pglist_data *pgdat,
 #endif
 	init_waitqueue_head(&pgdat->kswapd_wait);
 	init_waitqueue_head(&pgdat->pfmemalloc_wait);
+#ifdef CONFIG_COMPACTION
+	init_waitqueue_head(&pgdat->kcompactd_wait);
+#endif
 	pgdat_page_cgroup_init(pgdat);
 
 	for (j = 0; j < MAX_NR_ZONES; j++) {
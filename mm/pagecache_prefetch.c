@@ -0,0 +1,537 @@
+/*
+ * Trace driven page cache prefetch
+ *
+ * Boot and app launch spend much of their time in small synchronous
+ * reads: every major fault on an APK, odex or library brings in one
+ * read-around window, and the faults come in whatever order the code
+ * happens to run.  While a trace is recorded, each page cache miss of a
+ * read or a fault is logged here as (file, page range) in the order it
+ * happened.  Userspace reads the trace from /proc/prefetch_trace and
+ * stores it, and on the next boot or launch writes it back to
+ * /proc/prefetch_replay.  A background thread then reads the recorded
+ * ranges ahead of the workload, one file at a time in order of first
+ * use, with the ranges of each file sorted and merged into large reads.
+ *
+ * Trace lines are "<path> <first page> <pages>"; lines starting with '#'
+ * are ignored by the replay.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ */
+
+#include <linux/pagecache_prefetch.h>
+#include <linux/blkdev.h>
+#include <linux/dcache.h>
+#include <linux/file.h>
+#include <linux/hashtable.h>
+#include <linux/kthread.h>
+#include <linux/mm.h>
+#include <linux/module.h>
+#include <linux/proc_fs.h>
+#include <linux/sched.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+#include <linux/sort.h>
+#include <linux/uaccess.h>
+#include <linux/vmalloc.h>
+
+#include "bootprof.h"
+
+#define PREFETCH_MAX_FILES	4096
+#define PREFETCH_MAX_RANGES	65536
+#define PREFETCH_PATH_MAX	256
+#define PREFETCH_HASH_BITS	10
+
+/* Largest trace accepted by /proc/prefetch_replay */
+#define PREFETCH_REPLAY_MAX	(4 << 20)
+
+/* Ranges of a file closer than this many pages are read as one */
+#define PREFETCH_MERGE_GAP	16
+
+bool prefetch_recording __read_mostly;
+
+/* Start recording before init runs, for a boot trace */
+static bool prefetch_record_boot;
+module_param_named(record_boot, prefetch_record_boot, bool, S_IRUGO);
+
+struct prefetch_file {
+	struct hlist_node node;
+	struct super_block *sb;
+	unsigned long ino;
+	char *path;
+};
+
+struct prefetch_range {
+	unsigned int file;
+	unsigned int nr;
+	pgoff_t start;
+};
+
+static DEFINE_SPINLOCK(prefetch_lock);
+static DEFINE_MUTEX(prefetch_mutex);
+static DEFINE_HASHTABLE(prefetch_files_hash, PREFETCH_HASH_BITS);
+static struct prefetch_file *prefetch_files;
+static struct prefetch_range *prefetch_ranges;
+static unsigned int prefetch_nr_files;
+static unsigned int prefetch_nr_ranges;
+static unsigned long prefetch_dropped;
+
+static struct task_struct *prefetch_replay_task;
+
+static struct prefetch_file *prefetch_find_file(struct file *file)
+{
+	struct inode *inode = file_inode(file);
+	struct prefetch_file *pf;
+	char buf[PREFETCH_PATH_MAX];
+	char *path;
+
+	hash_for_each_possible(prefetch_files_hash, pf, node, inode->i_ino) {
+		if (pf->sb == inode->i_sb && pf->ino == inode->i_ino)
+			return pf;
+	}
+
+	if (prefetch_nr_files >= PREFETCH_MAX_FILES)
+		return NULL;
+
+	path = d_path(&file->f_path, buf, sizeof(buf));
+	if (IS_ERR(path) || strpbrk(path, " \t\n"))
+		return NULL;
+
+	pf = &prefetch_files[prefetch_nr_files];
+	pf->path = kstrdup(path, GFP_ATOMIC | __GFP_NOWARN);
+	if (!pf->path)
+		return NULL;
+	pf->sb = inode->i_sb;
+	pf->ino = inode->i_ino;
+	hash_add(prefetch_files_hash, &pf->node, pf->ino);
+	prefetch_nr_files++;
+
+	return pf;
+}
+
+void __prefetch_record(struct file *file, pgoff_t index, unsigned long nr)
+{
+	struct inode *inode;
+	struct prefetch_file *pf;
+	struct prefetch_range *last;
+	unsigned int idx;
+
+	if (!file || !nr)
+		return;
+	inode = file_inode(file);
+	if (!S_ISREG(inode->i_mode) || !inode->i_sb->s_bdev)
+		return;
+
+	spin_lock(&prefetch_lock);
+	if (!prefetch_recording)
+		goto out;
+
+	pf = prefetch_find_file(file);
+	if (!pf) {
+		prefetch_dropped++;
+		goto out;
+	}
+	idx = pf - prefetch_files;
+
+	/* extend the last range when the reader simply moved on */
+	if (prefetch_nr_ranges) {
+		last = &prefetch_ranges[prefetch_nr_ranges - 1];
+		if (last->file == idx && index >= last->start &&
+		    index <= last->start + last->nr) {
+			if (index + nr > last->start + last->nr)
+				last->nr = index + nr - last->start;
+			goto out;
+		}
+	}
+
+	if (prefetch_nr_ranges >= PREFETCH_MAX_RANGES) {
+		prefetch_dropped++;
+		prefetch_recording = false;
+		goto out;
+	}
+
+	last = &prefetch_ranges[prefetch_nr_ranges++];
+	last->file = idx;
+	last->start = index;
+	last->nr = nr;
+out:
+	spin_unlock(&prefetch_lock);
+}
+
+static void prefetch_clear(void)
+{
+	unsigned int i;
+
+	if (!prefetch_files)
+		return;
+
+	spin_lock(&prefetch_lock);
+	for (i = 0; i < prefetch_nr_files; i++)
+		kfree(prefetch_files[i].path);
+	hash_init(prefetch_files_hash);
+	prefetch_nr_files = 0;
+	prefetch_nr_ranges = 0;
+	prefetch_dropped = 0;
+	spin_unlock(&prefetch_lock);
+}
+
+static int prefetch_start(void)
+{
+	if (!prefetch_files) {
+		prefetch_files = vzalloc(PREFETCH_MAX_FILES *
+					 sizeof(*prefetch_files));
+		prefetch_ranges = vzalloc(PREFETCH_MAX_RANGES *
+					  sizeof(*prefetch_ranges));
+		if (!prefetch_files || !prefetch_ranges) {
+			vfree(prefetch_files);
+			vfree(prefetch_ranges);
+			prefetch_files = NULL;
+			prefetch_ranges = NULL;
+			return -ENOMEM;
+		}
+	}
+
+	prefetch_clear();
+	prefetch_recording = true;
+	log_boot("prefetch: record start");
+	return 0;
+}
+
+static void prefetch_stop(void)
+{
+	char msg[64];
+
+	if (!prefetch_recording)
+		return;
+
+	spin_lock(&prefetch_lock);
+	prefetch_recording = false;
+	spin_unlock(&prefetch_lock);
+
+	snprintf(msg, sizeof(msg), "prefetch: record stop, %u files %u ranges",
+		 prefetch_nr_files, prefetch_nr_ranges);
+	log_boot(msg);
+}
+
+/* ========= /proc/prefetch_trace =========== */
+
+static void *prefetch_seq_get(loff_t pos)
+{
+	if (pos == 0)
+		return SEQ_START_TOKEN;
+	/* the ranges are only stable once recording stopped */
+	if (prefetch_recording || pos > prefetch_nr_ranges)
+		return NULL;
+	return &prefetch_ranges[pos - 1];
+}
+
+static void *prefetch_seq_start(struct seq_file *m, loff_t *pos)
+{
+	mutex_lock(&prefetch_mutex);
+	return prefetch_seq_get(*pos);
+}
+
+static void *prefetch_seq_next(struct seq_file *m, void *v, loff_t *pos)
+{
+	++*pos;
+	return prefetch_seq_get(*pos);
+}
+
+static void prefetch_seq_stop(struct seq_file *m, void *v)
+{
+	mutex_unlock(&prefetch_mutex);
+}
+
+static int prefetch_seq_show(struct seq_file *m, void *v)
+{
+	struct prefetch_range *r = v;
+
+	if (v == SEQ_START_TOKEN) {
+		seq_printf(m, "# %s files %u ranges %u dropped %lu\n",
+			   prefetch_recording ? "recording" : "stopped",
+			   prefetch_nr_files, prefetch_nr_ranges,
+			   prefetch_dropped);
+		return 0;
+	}
+
+	seq_printf(m, "%s %lu %u\n", prefetch_files[r->file].path,
+		   (unsigned long)r->start, r->nr);
+	return 0;
+}
+
+static const struct seq_operations prefetch_seq_ops = {
+	.start = prefetch_seq_start,
+	.next = prefetch_seq_next,
+	.stop = prefetch_seq_stop,
+	.show = prefetch_seq_show,
+};
+
+static int prefetch_trace_open(struct inode *inode, struct file *file)
+{
+	return seq_open(file, &prefetch_seq_ops);
+}
+
+/* echo start/stop/clear > /proc/prefetch_trace */
+static ssize_t prefetch_trace_write(struct file *file, const char __user *ubuf,
+				    size_t count, loff_t *ppos)
+{
+	char buf[16];
+	int ret = 0;
+
+	if (count >= sizeof(buf))
+		return -EINVAL;
+	if (copy_from_user(buf, ubuf, count))
+		return -EFAULT;
+	buf[count] = '\0';
+	strim(buf);
+
+	mutex_lock(&prefetch_mutex);
+	if (!strcmp(buf, "start"))
+		ret = prefetch_start();
+	else if (!strcmp(buf, "stop"))
+		prefetch_stop();
+	else if (!strcmp(buf, "clear") && !prefetch_recording)
+		prefetch_clear();
+	else
+		ret = -EINVAL;
+	mutex_unlock(&prefetch_mutex);
+
+	return ret ? ret : count;
+}
+
+static const struct file_operations prefetch_trace_fops = {
+	.open = prefetch_trace_open,
+	.write = prefetch_trace_write,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = seq_release,
+};
+
+/* ========= replay =========== */
+
+struct replay_file {
+	struct hlist_node node;
+	const char *path;
+};
+
+struct replay_range {
+	unsigned int file;
+	unsigned long nr;
+	pgoff_t start;
+};
+
+struct replay_ctx {
+	char *buf;
+	size_t len;
+};
+
+static int replay_range_cmp(const void *a, const void *b)
+{
+	const struct replay_range *ra = a, *rb = b;
+
+	if (ra->file != rb->file)
+		return ra->file < rb->file ? -1 : 1;
+	if (ra->start != rb->start)
+		return ra->start < rb->start ? -1 : 1;
+	return 0;
+}
+
+static unsigned long prefetch_read_range(struct file *filp, pgoff_t start,
+					 unsigned long nr)
+{
+	struct address_space *mapping = filp->f_mapping;
+	unsigned long done = 0, chunk;
+
+	while (nr && !kthread_should_stop()) {
+		chunk = max_sane_readahead(nr);
+		if (force_page_cache_readahead(mapping, filp, start, chunk))
+			break;
+		start += chunk;
+		nr -= chunk;
+		done += chunk;
+		cond_resched();
+	}
+	return done;
+}
+
+static int prefetch_replay_thread(void *data)
+{
+	struct replay_ctx *ctx = data;
+	struct replay_file *files;
+	struct replay_range *ranges;
+	struct hlist_head *hash;
+	unsigned int nr_files = 0, nr_ranges = 0, i, cur = UINT_MAX;
+	unsigned long pages = 0;
+	struct file *filp = NULL;
+	char *line, *p = ctx->buf;
+	char msg[64];
+	u64 ts = sched_clock();
+
+	files = vmalloc(PREFETCH_MAX_FILES * sizeof(*files));
+	ranges = vmalloc(PREFETCH_MAX_RANGES * sizeof(*ranges));
+	hash = kcalloc(1 << PREFETCH_HASH_BITS, sizeof(*hash), GFP_KERNEL);
+	if (!files || !ranges || !hash)
+		goto out;
+
+	while ((line = strsep(&p, "\n")) && nr_ranges < PREFETCH_MAX_RANGES) {
+		char *path = strsep(&line, " ");
+		char *start = strsep(&line, " ");
+		unsigned long s, n;
+		struct replay_file *rf;
+		unsigned int h;
+		bool found = false;
+
+		if (!path || *path != '/' || !start || !line ||
+		    kstrtoul(start, 10, &s) || kstrtoul(strim(line), 10, &n) ||
+		    !n)
+			continue;
+
+		h = full_name_hash((const unsigned char *)path, strlen(path)) &
+		    ((1 << PREFETCH_HASH_BITS) - 1);
+		hlist_for_each_entry(rf, &hash[h], node) {
+			if (!strcmp(rf->path, path)) {
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			if (nr_files >= PREFETCH_MAX_FILES)
+				continue;
+			rf = &files[nr_files++];
+			rf->path = path;
+			hlist_add_head(&rf->node, &hash[h]);
+		}
+
+		ranges[nr_ranges].file = rf - files;
+		ranges[nr_ranges].start = s;
+		ranges[nr_ranges].nr = n;
+		nr_ranges++;
+	}
+
+	/* files stay in order of first use, ranges go in file order */
+	sort(ranges, nr_ranges, sizeof(*ranges), replay_range_cmp, NULL);
+
+	snprintf(msg, sizeof(msg), "prefetch: replay start, %u files %u ranges",
+		 nr_files, nr_ranges);
+	log_boot(msg);
+
+	for (i = 0; i < nr_ranges && !kthread_should_stop(); i++) {
+		struct replay_range *r = &ranges[i];
+		pgoff_t end = r->start + r->nr;
+
+		if (r->file != cur) {
+			if (filp)
+				fput(filp);
+			cur = r->file;
+			filp = filp_open(files[cur].path,
+					 O_RDONLY | O_LARGEFILE | O_NOATIME, 0);
+			if (IS_ERR(filp))
+				filp = NULL;
+		}
+		if (!filp)
+			continue;
+
+		while (i + 1 < nr_ranges && ranges[i + 1].file == cur &&
+		       ranges[i + 1].start <= end + PREFETCH_MERGE_GAP) {
+			i++;
+			end = max_t(pgoff_t, end,
+				    ranges[i].start + ranges[i].nr);
+		}
+
+		pages += prefetch_read_range(filp, r->start, end - r->start);
+	}
+	if (filp)
+		fput(filp);
+
+	snprintf(msg, sizeof(msg), "prefetch: replay done, %lu pages %llums",
+		 pages, div_u64(sched_clock() - ts, NSEC_PER_MSEC));
+	log_boot(msg);
+out:
+	kfree(hash);
+	vfree(ranges);
+	vfree(files);
+	vfree(ctx->buf);
+	kfree(ctx);
+
+	mutex_lock(&prefetch_mutex);
+	prefetch_replay_task = NULL;
+	mutex_unlock(&prefetch_mutex);
+	return 0;
+}
+
+/* ========= /proc/prefetch_replay =========== */
+
+static int prefetch_replay_open(struct inode *inode, struct file *file)
+{
+	struct replay_ctx *ctx;
+
+	ctx = kzalloc(sizeof(*ctx), GFP_KERNEL);
+	if (!ctx)
+		return -ENOMEM;
+	ctx->buf = vmalloc(PREFETCH_REPLAY_MAX + 1);
+	if (!ctx->buf) {
+		kfree(ctx);
+		return -ENOMEM;
+	}
+	file->private_data = ctx;
+	return nonseekable_open(inode, file);
+}
+
+static ssize_t prefetch_replay_write(struct file *file, const char __user *ubuf,
+				     size_t count, loff_t *ppos)
+{
+	struct replay_ctx *ctx = file->private_data;
+
+	if (count > PREFETCH_REPLAY_MAX - ctx->len)
+		return -EFBIG;
+	if (copy_from_user(ctx->buf + ctx->len, ubuf, count))
+		return -EFAULT;
+	ctx->len += count;
+	return count;
+}
+
+/* the trace is replayed once the writer closes the file */
+static int prefetch_replay_release(struct inode *inode, struct file *file)
+{
+	struct replay_ctx *ctx = file->private_data;
+	struct task_struct *task;
+
+	mutex_lock(&prefetch_mutex);
+	if (!ctx->len || prefetch_replay_task)
+		goto free;
+
+	ctx->buf[ctx->len] = '\0';
+	task = kthread_run(prefetch_replay_thread, ctx, "kprefetchd");
+	if (IS_ERR(task))
+		goto free;
+	prefetch_replay_task = task;
+	mutex_unlock(&prefetch_mutex);
+	return 0;
+
+free:
+	mutex_unlock(&prefetch_mutex);
+	vfree(ctx->buf);
+	kfree(ctx);
+	return 0;
+}
+
+static const struct file_operations prefetch_replay_fops = {
+	.open = prefetch_replay_open,
+	.write = prefetch_replay_write,
+	.llseek = no_llseek,
+	.release = prefetch_replay_release,
+};
+
+static int __init pagecache_prefetch_init(void)
+{
+	proc_create("prefetch_trace", S_IRUSR | S_IWUSR, NULL,
+		    &prefetch_trace_fops);
+	proc_create("prefetch_replay", S_IWUSR, NULL, &prefetch_replay_fops);
+
+	if (prefetch_record_boot && prefetch_start())
+		pr_err("pagecache_prefetch: no memory for the boot trace\n");
+
+	return 0;
+}
+module_init(pagecache_prefetch_init);
@@ -232,6 +232,73 @@ int force_page_cache_readahead(struct address_space *mapping, struct file *filp,
 	return 0;
 }
 
+/*
+ * Per-file adaptive window.
+ *
+ * A readahead marker reached by the reader is a window that was used, a
+ * miss on a page of the last window that left a shadow entry behind is a
+ * window that was evicted before use.  Every RA_ADAPT_PERIOD samples the
+ * file's ra_pages is doubled when nearly all windows were used and halved
+ * when most of them were thrashed, between a quarter and four times the
+ * device default.
+ */
+#define RA_ADAPT_PERIOD		8
+
+static void ra_adapt(struct address_space *mapping, struct file_ra_state *ra)
+{
+	unsigned long bdi_pages = mapping->backing_dev_info->ra_pages;
+	unsigned int total = ra->ra_hit + ra->ra_miss;
+
+	if (total < RA_ADAPT_PERIOD)
+		return;
+
+	if (ra->ra_hit * 8 >= total * 7) {
+		if (ra->ra_pages < bdi_pages * 4) {
+			ra->ra_pages = min(ra->ra_pages * 2, bdi_pages * 4);
+			count_vm_event(READAHEAD_GROW);
+		}
+	} else if (ra->ra_miss * 2 > total) {
+		if (ra->ra_pages > max(bdi_pages / 4, 1UL)) {
+			ra->ra_pages = max(ra->ra_pages / 2,
+					   max(bdi_pages / 4, 1UL));
+			count_vm_event(READAHEAD_SHRINK);
+		}
+	}
+	ra->ra_hit = 0;
+	ra->ra_miss = 0;
+}
+
+static void page_cache_ra_hit(struct address_space *mapping,
+			      struct file_ra_state *ra)
+{
+	ra->ra_hit++;
+	count_vm_event(READAHEAD_HIT);
+	ra_adapt(mapping, ra);
+}
+
+/*
+ * Called on a cache miss at @offset: if the page was part of the last
+ * window and got evicted since, that readahead was wasted.
+ */
+void page_cache_ra_miss(struct address_space *mapping,
+			struct file_ra_state *ra, pgoff_t offset)
+{
+	void *entry;
+
+	if (!ra_has_index(ra, offset))
+		return;
+
+	rcu_read_lock();
+	entry = radix_tree_lookup(&mapping->page_tree, offset);
+	rcu_read_unlock();
+	if (!radix_tree_exceptional_entry(entry))
+		return;
+
+	ra->ra_miss++;
+	count_vm_event(READAHEAD_MISS);
+	ra_adapt(mapping, ra);
+}
+
 #define MAX_READAHEAD   ((512*4096)/PAGE_CACHE_SIZE)
 /*
  * Given a desired number of PAGE_CACHE_SIZE readahead pages, return a
@@ -500,6 +567,8 @@ void page_cache_sync_readahead(struct address_space *mapping,
 		return;
 	}
 
+	page_cache_ra_miss(mapping, ra, offset);
+
 	/* do read-ahead */
 	ondemand_readahead(mapping, ra, filp, false, offset, req_size);
 }
@@ -537,6 +606,7 @@ page_cache_async_readahead(struct address_space *mapping,
 		return;
 
 	ClearPageReadahead(page);
+	page_cache_ra_hit(mapping, ra);
 
 	/*
 	 * Defer asynchronous read-ahead on IO congestion.
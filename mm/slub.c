@@ -32,6 +32,7 @@
 #include <linux/fault-inject.h>
 #include <linux/stacktrace.h>
 #include <linux/prefetch.h>
+#include <linux/static_key.h>
 #include <linux/memcontrol.h>
 
 #include <trace/events/kmem.h>
@@ -230,9 +231,50 @@ static inline int sysfs_slab_alias(struct kmem_cache *s, const char *p)
 static inline void memcg_propagate_slab_attrs(struct kmem_cache *s) { }
 #endif
 
+#ifdef CONFIG_SLUB_STATS
+/*
+ * Statistics are compiled in but only collected while slub.stats is set,
+ * until then every stat() is a patched out branch.
+ */
+static struct static_key slub_stats_key = STATIC_KEY_INIT_FALSE;
+static bool slub_stats_enabled;
+static DEFINE_MUTEX(slub_stats_mutex);
+
+static void slub_stats_update(void)
+{
+	/* Jump labels cannot be patched before slab_sysfs_init() */
+	if (slab_state < FULL)
+		return;
+
+	mutex_lock(&slub_stats_mutex);
+	if (slub_stats_enabled && !static_key_enabled(&slub_stats_key))
+		static_key_slow_inc(&slub_stats_key);
+	else if (!slub_stats_enabled && static_key_enabled(&slub_stats_key))
+		static_key_slow_dec(&slub_stats_key);
+	mutex_unlock(&slub_stats_mutex);
+}
+
+static int slub_stats_set(const char *val, const struct kernel_param *kp)
+{
+	int ret = param_set_bool(val, kp);
+
+	if (!ret)
+		slub_stats_update();
+	return ret;
+}
+
+static struct kernel_param_ops slub_stats_ops = {
+	.set = slub_stats_set,
+	.get = param_get_bool,
+};
+module_param_cb(stats, &slub_stats_ops, &slub_stats_enabled, 0644);
+#endif
+
 static inline void stat(const struct kmem_cache *s, enum stat_item si)
 {
 #ifdef CONFIG_SLUB_STATS
+	if (!static_key_false(&slub_stats_key))
+		return;
 	/*
 	 * The rmw is racy on a preemptible kernel but this is acceptable, so
 	 * avoid this_cpu_add()'s irq-disable overhead.
@@ -241,6 +283,32 @@ static inline void stat(const struct kmem_cache *s, enum stat_item si)
 #endif
 }
 
+static inline u64 stat_clock(void)
+{
+#ifdef CONFIG_SLUB_STATS
+	if (static_key_false(&slub_stats_key))
+		return local_clock();
+#endif
+	return 0;
+}
+
+/* Account the time since stat_clock() returned @start */
+static inline void stat_latency(const struct kmem_cache *s, u64 start)
+{
+#ifdef CONFIG_SLUB_STATS
+	unsigned long us;
+	int bucket = 0;
+
+	if (!static_key_false(&slub_stats_key) || !start)
+		return;
+
+	us = (local_clock() - start) >> 10;
+	if (us)
+		bucket = min(1 + ilog2(us) / 2, NR_SLUB_LATENCY_BUCKETS - 1);
+	raw_cpu_inc(s->cpu_slab->stat[ALLOC_SLOWPATH_LATENCY + bucket]);
+#endif
+}
+
 /********************************************************************
  * 			Core slab cache functions
  *******************************************************************/
@@ -2515,8 +2583,11 @@ redo:
 	object = c->freelist;
 	page = c->page;
 	if (unlikely(!object || !node_match(page, node))) {
+		u64 start = stat_clock();
+
 		object = __slab_alloc(s, gfpflags, node, addr, c);
 		stat(s, ALLOC_SLOWPATH);
+		stat_latency(s, start);
 	} else {
 		void *next_object = get_freepointer_safe(s, object);
 
@@ -4910,6 +4981,40 @@ STAT_ATTR(CPU_PARTIAL_ALLOC, cpu_partial_alloc);
 STAT_ATTR(CPU_PARTIAL_FREE, cpu_partial_free);
 STAT_ATTR(CPU_PARTIAL_NODE, cpu_partial_node);
 STAT_ATTR(CPU_PARTIAL_DRAIN, cpu_partial_drain);
+
+static ssize_t alloc_slowpath_latency_show(struct kmem_cache *s, char *buf)
+{
+	static const char * const names[NR_SLUB_LATENCY_BUCKETS] = {
+		"<1us", "<4us", "<16us", "<64us", "<256us", ">=256us",
+	};
+	int len = 0;
+	int i, cpu;
+
+	for (i = 0; i < NR_SLUB_LATENCY_BUCKETS; i++) {
+		unsigned long sum = 0;
+
+		for_each_online_cpu(cpu)
+			sum += per_cpu_ptr(s->cpu_slab, cpu)->stat[
+					ALLOC_SLOWPATH_LATENCY + i];
+		len += sprintf(buf + len, "%s%s=%lu", i ? " " : "",
+			       names[i], sum);
+	}
+
+	return len + sprintf(buf + len, "\n");
+}
+
+static ssize_t alloc_slowpath_latency_store(struct kmem_cache *s,
+					    const char *buf, size_t length)
+{
+	int i;
+
+	if (buf[0] != '0')
+		return -EINVAL;
+	for (i = 0; i < NR_SLUB_LATENCY_BUCKETS; i++)
+		clear_stat(s, ALLOC_SLOWPATH_LATENCY + i);
+	return length;
+}
+SLAB_ATTR(alloc_slowpath_latency);
 #endif
 
 static struct attribute *slab_attrs[] = {
@@ -4977,6 +5082,7 @@ static struct attribute *slab_attrs[] = {
 	&cpu_partial_free_attr.attr,
 	&cpu_partial_node_attr.attr,
 	&cpu_partial_drain_attr.attr,
+	&alloc_slowpath_latency_attr.attr,
 #endif
 #ifdef CONFIG_FAILSLAB
 	&failslab_attr.attr,
@@ -5335,6 +5441,10 @@ static int __init slab_sysfs_init(void)
 	}
 
 	mutex_unlock(&slab_mutex);
+#ifdef CONFIG_SLUB_STATS
+	/* Pick up slub.stats given on the command line */
+	slub_stats_update();
+#endif
 	resiliency_test();
 	return 0;
 }
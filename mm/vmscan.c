@@ -53,6 +53,7 @@
 
 #include <linux/swapops.h>
 #include <linux/balloon_compaction.h>
+#include <linux/anon_aging.h>
 
 #include "internal.h"
 
@@ -995,8 +996,12 @@ static unsigned long shrink_page_list(struct list_head *page_list,
 			}
 		}
 
-		if (!force_reclaim)
+		if (!force_reclaim) {
 			references = page_check_references(page, sc);
+			if (references != PAGEREF_ACTIVATE &&
+			    anon_aging_page_young(page))
+				references = PAGEREF_ACTIVATE;
+		}
 
 		switch (references) {
 		case PAGEREF_ACTIVATE:
@@ -1726,6 +1731,7 @@ static void shrink_active_list(unsigned long nr_to_scan,
 	unsigned long nr_taken;
 	unsigned long nr_scanned;
 	unsigned long vm_flags;
+	int referenced;
 	LIST_HEAD(l_hold);	/* The pages which were snipped off */
 	LIST_HEAD(l_active);
 	LIST_HEAD(l_inactive);
@@ -1775,8 +1781,9 @@ static void shrink_active_list(unsigned long nr_to_scan,
 			}
 		}
 
-		if (page_referenced(page, 0, sc->target_mem_cgroup,
-				    &vm_flags)) {
+		referenced = page_referenced(page, 0, sc->target_mem_cgroup,
+					     &vm_flags);
+		if (referenced) {
 			nr_rotated += hpage_nr_pages(page);
 			/*
 			 * Identify referenced, file-backed active pages and
@@ -1793,6 +1800,12 @@ static void shrink_active_list(unsigned long nr_to_scan,
 			}
 		}
 
+		/* Anon pages only leave the active list once they got old */
+		if (!file && anon_aging_keep_active(page, referenced)) {
+			list_add(&page->lru, &l_active);
+			continue;
+		}
+
 		ClearPageActive(page);	/* we are de-activating */
 		list_add(&page->lru, &l_inactive);
 	}
@@ -1919,6 +1932,46 @@ enum scan_balance {
 	SCAN_FILE,
 };
 
+/*
+ * The file LRU is considered to be thrashing when more than one in
+ * WORKINGSET_THRASH_RATIO recently scanned file pages came back as a
+ * working set refault.
+ */
+#define WORKINGSET_THRASH_RATIO		8
+
+/*
+ * Memory cgroups below their working set protection are skipped by
+ * reclaim until the scan priority drops below this.
+ */
+#define WORKINGSET_PROTECT_PRIORITY	(DEF_PRIORITY - 2)
+
+/*
+ * Sample the zone's working set refaults into the lruvec's reclaim stats
+ * and report whether reclaim is evicting file pages that are still needed.
+ */
+static bool lruvec_file_thrashing(struct lruvec *lruvec)
+{
+	struct zone_reclaim_stat *reclaim_stat = &lruvec->reclaim_stat;
+	struct zone *zone = lruvec_zone(lruvec);
+	unsigned long refaults, file;
+	bool thrashing;
+
+	file = get_lru_size(lruvec, LRU_ACTIVE_FILE) +
+	       get_lru_size(lruvec, LRU_INACTIVE_FILE);
+	refaults = zone_page_state(zone, WORKINGSET_ACTIVATE);
+
+	spin_lock_irq(&zone->lru_lock);
+	/* Clamp so the first sample of a new lruvec can't swamp the stats */
+	reclaim_stat->recent_refaulted += min(refaults - reclaim_stat->refaults,
+					      file);
+	reclaim_stat->refaults = refaults;
+	thrashing = reclaim_stat->recent_refaulted * WORKINGSET_THRASH_RATIO >
+		    reclaim_stat->recent_scanned[1];
+	spin_unlock_irq(&zone->lru_lock);
+
+	return thrashing;
+}
+
 
 #ifdef CONFIG_ZRAM
 static int vmscan_swap_file_ratio = 1;
@@ -1978,6 +2031,7 @@ static void get_scan_count(struct lruvec *lruvec, int swappiness,
 	enum scan_balance scan_balance;
 	unsigned long anon, file;
 	bool force_scan = false;
+	bool file_thrashing;
 	unsigned long ap, fp;
 	enum lru_list lru;
 	bool some_scanned;
@@ -2056,11 +2110,17 @@ static void get_scan_count(struct lruvec *lruvec, int swappiness,
 
 	/*
 	 * There is enough inactive page cache, do not reclaim
-	 * anything from the anonymous working set right now.
+	 * anything from the anonymous working set right now -
+	 * unless that cache is refaulting as fast as it is being
+	 * reclaimed, in which case cold anon is the better victim.
 	 */
+	file_thrashing = lruvec_file_thrashing(lruvec);
 	if (!inactive_file_is_low(lruvec)) {
-		scan_balance = SCAN_FILE;
-		goto out;
+		if (!file_thrashing) {
+			scan_balance = SCAN_FILE;
+			goto out;
+		}
+		count_vm_event(WORKINGSET_SCAN_BALANCE);
 	}
 
 	scan_balance = SCAN_FRACT;
@@ -2156,6 +2216,7 @@ static void get_scan_count(struct lruvec *lruvec, int swappiness,
 	if (unlikely(reclaim_stat->recent_scanned[1] > file / 4)) {
 		reclaim_stat->recent_scanned[1] /= 2;
 		reclaim_stat->recent_rotated[1] /= 2;
+		reclaim_stat->recent_refaulted /= 2;
 	}
 
 	/*
@@ -2166,8 +2227,13 @@ static void get_scan_count(struct lruvec *lruvec, int swappiness,
 	ap = anon_prio * (reclaim_stat->recent_scanned[0] + 1);
 	ap /= reclaim_stat->recent_rotated[0] + 1;
 
+	/*
+	 * A working set refault is a file page reclaim should not have
+	 * evicted in the first place, so it weighs like another rotation.
+	 */
 	fp = file_prio * (reclaim_stat->recent_scanned[1] + 1);
-	fp /= reclaim_stat->recent_rotated[1] + 1;
+	fp /= reclaim_stat->recent_rotated[1] +
+	      reclaim_stat->recent_refaulted + 1;
 	spin_unlock_irq(&zone->lru_lock);
 
 	fraction[0] = ap;
@@ -2434,6 +2500,17 @@ static bool shrink_zone(struct zone *zone, struct scan_control *sc)
 			struct lruvec *lruvec;
 			int swappiness;
 
+			/*
+			 * Leave protected working sets alone while there
+			 * is still other memory to go after.
+			 */
+			if (sc->priority > WORKINGSET_PROTECT_PRIORITY &&
+			    mem_cgroup_protected(root, memcg)) {
+				count_vm_event(WORKINGSET_MEMCG_PROTECTED);
+				memcg = mem_cgroup_iter(root, memcg, &reclaim);
+				continue;
+			}
+
 			lruvec = mem_cgroup_zone_lruvec(zone, memcg);
 			swappiness = mem_cgroup_swappiness(memcg);
 
@@ -3201,6 +3278,7 @@ static unsigned long balance_pgdat(pg_data_t *pgdat, int order,
 		.may_swap = 1,
 	};
 	count_vm_event(PAGEOUTRUN);
+	anon_aging_kick();
 
 	do {
 		unsigned long lru_pages = 0;
@@ -815,6 +815,8 @@ const char * const vmstat_text[] = {
 	"pgfault",
 	"pgmajfault",
 	"pgfmfault",
+	"pgfault_sem_wait",
+	"pgfault_retry",
 
 	TEXTS_FOR_ZONES("pgrefill")
 	TEXTS_FOR_ZONES("pgsteal_kswapd")
@@ -835,9 +837,21 @@ const char * const vmstat_text[] = {
 	"allocstall",
 
 	"pgrotated",
+	"workingset_scan_balance",
+	"workingset_memcg_protected",
+#ifdef CONFIG_ANON_AGING
+	"anon_aging_walk",
+	"anon_aging_young",
+	"anon_aging_keep",
+	"anon_aging_activate",
+#endif
 
 	"drop_pagecache",
 	"drop_slab",
+	"readahead_hit",
+	"readahead_miss",
+	"readahead_grow",
+	"readahead_shrink",
 
 #ifdef CONFIG_NUMA_BALANCING
 	"numa_pte_updates",
@@ -857,6 +871,8 @@ const char * const vmstat_text[] = {
 	"compact_stall",
 	"compact_fail",
 	"compact_success",
+	"compact_daemon_wake",
+	"compact_daemon_success",
 #endif
 
 #ifdef CONFIG_HUGETLB_PAGE
@@ -228,6 +228,89 @@ no_packet:
 }
 EXPORT_SYMBOL(__skb_recv_datagram);
 
+/**
+ *	__skb_recv_datagram_batch - Receive a datagram through a reader queue
+ *	@sk: socket
+ *	@reader: queue private to the readers of @sk
+ *	@flags: MSG_ flags
+ *	@peeked: returns non-zero if this packet has been seen before
+ *	@off: an offset in bytes to peek skb from. Returns an offset
+ *	      within an skb where data actually starts
+ *	@err: error code returned
+ *
+ *	Like __skb_recv_datagram(), but datagrams are taken from @reader.
+ *	When @reader runs empty, everything the bottom half has queued on
+ *	sk_receive_queue so far is moved over under a single acquisition of
+ *	its lock, so a reader draining a burst (recvmmsg) no longer contends
+ *	with the softirq for every datagram.  Peeking moves the whole receive
+ *	queue first, so the offset covers both queues in order.
+ */
+struct sk_buff *__skb_recv_datagram_batch(struct sock *sk,
+					  struct sk_buff_head *reader,
+					  unsigned int flags, int *peeked,
+					  int *off, int *err)
+{
+	struct sk_buff_head *queue = &sk->sk_receive_queue;
+	struct sk_buff *skb;
+	long timeo;
+	int error = sock_error(sk);
+
+	if (error)
+		goto no_packet;
+
+	timeo = sock_rcvtimeo(sk, flags & MSG_DONTWAIT);
+
+	do {
+		unsigned long cpu_flags;
+		int _off = *off;
+
+		spin_lock_irqsave(&reader->lock, cpu_flags);
+		if (skb_queue_empty(reader) || (flags & MSG_PEEK)) {
+			spin_lock(&queue->lock);
+			skb_queue_splice_tail_init(queue, reader);
+			spin_unlock(&queue->lock);
+		}
+
+		skb_queue_walk(reader, skb) {
+			*peeked = skb->peeked;
+			if (flags & MSG_PEEK) {
+				if (_off >= skb->len && (skb->len || _off ||
+							 skb->peeked)) {
+					_off -= skb->len;
+					continue;
+				}
+				skb->peeked = 1;
+				atomic_inc(&skb->users);
+			} else
+				__skb_unlink(skb, reader);
+
+			spin_unlock_irqrestore(&reader->lock, cpu_flags);
+			*off = _off;
+			return skb;
+		}
+		spin_unlock_irqrestore(&reader->lock, cpu_flags);
+
+		if (sk_can_busy_loop(sk) &&
+		    sk_busy_loop(sk, flags & MSG_DONTWAIT))
+			continue;
+
+		/* User doesn't want to wait */
+		error = -EAGAIN;
+		if (!timeo)
+			goto no_packet;
+
+		/* the receive queue was emptied above, wait for it to fill */
+	} while (!wait_for_more_packets(sk, err, &timeo,
+					(struct sk_buff *)queue));
+
+	return NULL;
+
+no_packet:
+	*err = error;
+	return NULL;
+}
+EXPORT_SYMBOL(__skb_recv_datagram_batch);
+
 struct sk_buff *skb_recv_datagram(struct sock *sk, unsigned int flags,
 				  int noblock, int *err)
 {
@@ -265,8 +348,9 @@ void skb_free_datagram_locked(struct sock *sk, struct sk_buff *skb)
 EXPORT_SYMBOL(skb_free_datagram_locked);
 
 /**
- *	skb_kill_datagram - Free a datagram skbuff forcibly
+ *	__skb_kill_datagram - Free a datagram skbuff forcibly
  *	@sk: socket
+ *	@queue: the queue the datagram was received from
  *	@skb: datagram skbuff
  *	@flags: MSG_ flags
  *
@@ -274,30 +358,31 @@ EXPORT_SYMBOL(skb_free_datagram_locked);
  *	skb_recv_datagram.  The flags argument must match the one
  *	used for skb_recv_datagram.
  *
- *	If the MSG_PEEK flag is set, and the packet is still on the
- *	receive queue of the socket, it will be taken off the queue
+ *	If the MSG_PEEK flag is set, and the packet is still on
+ *	@queue, it will be taken off the queue
  *	before it is freed.
  *
  *	This function currently only disables BH when acquiring the
- *	sk_receive_queue lock.  Therefore it must not be used in a
+ *	lock of @queue.  Therefore it must not be used in a
  *	context where that lock is acquired in an IRQ context.
  *
  *	It returns 0 if the packet was removed by us.
  */
 
-int skb_kill_datagram(struct sock *sk, struct sk_buff *skb, unsigned int flags)
+int __skb_kill_datagram(struct sock *sk, struct sk_buff_head *queue,
+			struct sk_buff *skb, unsigned int flags)
 {
 	int err = 0;
 
 	if (flags & MSG_PEEK) {
 		err = -ENOENT;
-		spin_lock_bh(&sk->sk_receive_queue.lock);
-		if (skb == skb_peek(&sk->sk_receive_queue)) {
-			__skb_unlink(skb, &sk->sk_receive_queue);
+		spin_lock_bh(&queue->lock);
+		if (skb == skb_peek(queue)) {
+			__skb_unlink(skb, queue);
 			atomic_dec(&skb->users);
 			err = 0;
 		}
-		spin_unlock_bh(&sk->sk_receive_queue.lock);
+		spin_unlock_bh(&queue->lock);
 	}
 
 	kfree_skb(skb);
@@ -306,6 +391,12 @@ int skb_kill_datagram(struct sock *sk, struct sk_buff *skb, unsigned int flags)
 
 	return err;
 }
+EXPORT_SYMBOL(__skb_kill_datagram);
+
+int skb_kill_datagram(struct sock *sk, struct sk_buff *skb, unsigned int flags)
+{
+	return __skb_kill_datagram(sk, &sk->sk_receive_queue, skb, flags);
+}
 EXPORT_SYMBOL(skb_kill_datagram);
 
 /**
@@ -0,0 +1,682 @@
+/*
+ * Forwarding fast path for established IPv4 conntrack flows
+ *
+ * Forwarded TCP and UDP flows that conntrack has seen established in both
+ * directions are learned at POST_ROUTING: the NAT translation, the route
+ * and the conntrack entry are kept in a small flow table.  Later packets
+ * of such a flow are picked up at the very start of PRE_ROUTING, rewritten
+ * and handed to the neighbour layer of the output device directly, so the
+ * rest of the netfilter hooks, the routing lookup and ip_forward() are not
+ * run for them any more.
+ *
+ * Everything that needs to see each packet (conntrack helpers, sequence
+ * adjustment, fragments, IP options, TCP connection teardown) stays on the
+ * normal path.  Since iptables rules in FORWARD and POSTROUTING are skipped
+ * as well, the fast path is off until net.netfilter.nf_conntrack_fastpath
+ * is set.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <linux/types.h>
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/ip.h>
+#include <linux/tcp.h>
+#include <linux/udp.h>
+#include <linux/jhash.h>
+#include <linux/percpu.h>
+#include <linux/random.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+#include <linux/sysctl.h>
+#include <linux/workqueue.h>
+#include <linux/netdevice.h>
+#include <linux/netfilter.h>
+#include <linux/netfilter_ipv4.h>
+#include <net/ip.h>
+#include <net/route.h>
+#include <net/arp.h>
+#include <net/checksum.h>
+#include <net/net_namespace.h>
+#include <net/netfilter/nf_conntrack.h>
+#include <net/netfilter/nf_conntrack_core.h>
+#include <net/netfilter/nf_conntrack_helper.h>
+
+#define NF_FP_HASH_BITS		10
+#define NF_FP_HASH_SIZE		(1 << NF_FP_HASH_BITS)
+#define NF_FP_MAX_FLOWS		4096
+#define NF_FP_CACHE_SIZE	64
+#define NF_FP_GC_INTERVAL	HZ
+#define NF_FP_IDLE_TIMEOUT	(10 * HZ)
+
+struct nf_fp_tuple {
+	__be32		saddr;
+	__be32		daddr;
+	__be16		sport;
+	__be16		dport;
+	u8		protonum;
+	int		iif;
+};
+
+struct nf_fp_flow {
+	struct hlist_node	hnode;
+	struct rcu_head		rcu;
+
+	/* the packet as it arrives */
+	struct nf_fp_tuple	tuple;
+
+	/* and as it leaves */
+	__be32			new_saddr;
+	__be32			new_daddr;
+	__be16			new_sport;
+	__be16			new_dport;
+
+	struct nf_conn		*ct;
+	enum ip_conntrack_info	ctinfo;
+	struct dst_entry	*dst;
+	unsigned long		ct_timeout;
+	unsigned long		last_used;
+
+	u64			packets;
+	u64			bytes;
+};
+
+/* direct-mapped per-CPU front of the hash table */
+struct nf_fp_cache_slot {
+	struct nf_fp_flow	*flow;
+	unsigned int		gen;
+};
+
+struct nf_fp_cpu {
+	struct nf_fp_cache_slot	cache[NF_FP_CACHE_SIZE];
+	unsigned long		fast;
+	unsigned long		cache_hit;
+	unsigned long		learned;
+};
+
+static int nf_fp_enable __read_mostly;
+static struct hlist_head nf_fp_hash[NF_FP_HASH_SIZE];
+static DEFINE_SPINLOCK(nf_fp_lock);
+static unsigned int nf_fp_count;
+static u32 nf_fp_seed __read_mostly;
+/* bumped on every removal, invalidates all per-CPU cache slots at once */
+static atomic_t nf_fp_gen = ATOMIC_INIT(0);
+static struct nf_fp_cpu __percpu *nf_fp_cpu;
+static struct delayed_work nf_fp_gc_work;
+
+static u32 nf_fp_hash_tuple(const struct nf_fp_tuple *t)
+{
+	return jhash_3words((__force u32)t->saddr, (__force u32)t->daddr,
+			    ((__force u32)t->sport << 16 | (__force u32)t->dport) ^
+			    (t->protonum << 24) ^ t->iif,
+			    nf_fp_seed);
+}
+
+static bool nf_fp_tuple_equal(const struct nf_fp_tuple *a,
+			      const struct nf_fp_tuple *b)
+{
+	return a->saddr == b->saddr && a->daddr == b->daddr &&
+	       a->sport == b->sport && a->dport == b->dport &&
+	       a->protonum == b->protonum && a->iif == b->iif;
+}
+
+static struct nf_fp_flow *nf_fp_find(const struct nf_fp_tuple *t, u32 hash)
+{
+	struct nf_fp_flow *flow;
+
+	hlist_for_each_entry_rcu(flow, &nf_fp_hash[hash & (NF_FP_HASH_SIZE - 1)],
+				 hnode) {
+		if (nf_fp_tuple_equal(&flow->tuple, t))
+			return flow;
+	}
+	return NULL;
+}
+
+static void nf_fp_flow_free(struct rcu_head *head)
+{
+	struct nf_fp_flow *flow = container_of(head, struct nf_fp_flow, rcu);
+
+	dst_release(flow->dst);
+	nf_ct_put(flow->ct);
+	kfree(flow);
+}
+
+/* called with nf_fp_lock held */
+static void nf_fp_flow_remove(struct nf_fp_flow *flow)
+{
+	hlist_del_init_rcu(&flow->hnode);
+	nf_fp_count--;
+	atomic_inc(&nf_fp_gen);
+	call_rcu(&flow->rcu, nf_fp_flow_free);
+}
+
+static void nf_fp_flow_kill(struct nf_fp_flow *flow)
+{
+	spin_lock_bh(&nf_fp_lock);
+	/* another CPU may have got there first */
+	if (!hlist_unhashed(&flow->hnode))
+		nf_fp_flow_remove(flow);
+	spin_unlock_bh(&nf_fp_lock);
+}
+
+static bool nf_fp_flow_stale(const struct nf_fp_flow *flow)
+{
+	const struct nf_conn *ct = flow->ct;
+
+	if (nf_ct_is_dying(flow->ct))
+		return true;
+	if (nf_ct_protonum(ct) == IPPROTO_TCP &&
+	    ct->proto.tcp.state != TCP_CONNTRACK_ESTABLISHED)
+		return true;
+	/* route cache flushes only show up through the dst check */
+	return flow->dst->obsolete && !dst_check(flow->dst, 0);
+}
+
+/* remove the flows matching @dev, or all of them when @dev is NULL */
+static void nf_fp_flush(const struct net_device *dev)
+{
+	struct nf_fp_flow *flow;
+	struct hlist_node *n;
+	unsigned int i;
+
+	spin_lock_bh(&nf_fp_lock);
+	for (i = 0; i < NF_FP_HASH_SIZE; i++) {
+		hlist_for_each_entry_safe(flow, n, &nf_fp_hash[i], hnode) {
+			if (!dev || flow->dst->dev == dev ||
+			    flow->tuple.iif == dev->ifindex)
+				nf_fp_flow_remove(flow);
+		}
+	}
+	spin_unlock_bh(&nf_fp_lock);
+}
+
+static void nf_fp_gc(struct work_struct *work)
+{
+	struct nf_fp_flow *flow;
+	struct hlist_node *n;
+	unsigned int i;
+
+	spin_lock_bh(&nf_fp_lock);
+	for (i = 0; i < NF_FP_HASH_SIZE; i++) {
+		hlist_for_each_entry_safe(flow, n, &nf_fp_hash[i], hnode) {
+			if (nf_fp_flow_stale(flow) ||
+			    time_after(jiffies, flow->last_used + NF_FP_IDLE_TIMEOUT))
+				nf_fp_flow_remove(flow);
+		}
+	}
+	spin_unlock_bh(&nf_fp_lock);
+
+	queue_delayed_work(system_power_efficient_wq, &nf_fp_gc_work,
+			   NF_FP_GC_INTERVAL);
+}
+
+static struct nf_fp_flow *nf_fp_lookup(const struct nf_fp_tuple *t)
+{
+	unsigned int gen = atomic_read(&nf_fp_gen);
+	struct nf_fp_cache_slot *slot;
+	struct nf_fp_flow *flow;
+	struct nf_fp_cpu *cpu;
+	u32 hash;
+
+	hash = nf_fp_hash_tuple(t);
+	cpu = get_cpu_ptr(nf_fp_cpu);
+	slot = &cpu->cache[hash % NF_FP_CACHE_SIZE];
+
+	/*
+	 * A flow is freed an RCU grace period after the generation moved on,
+	 * so a slot of the current generation still points to live memory.
+	 */
+	if (slot->gen == gen && slot->flow &&
+	    nf_fp_tuple_equal(&slot->flow->tuple, t)) {
+		cpu->cache_hit++;
+		flow = slot->flow;
+		goto out;
+	}
+
+	flow = nf_fp_find(t, hash);
+	if (flow) {
+		slot->flow = flow;
+		slot->gen = gen;
+	}
+out:
+	put_cpu_ptr(nf_fp_cpu);
+	return flow;
+}
+
+static void nf_fp_nat_l4(struct sk_buff *skb, __sum16 *check,
+			 __be32 oldip, __be32 newip,
+			 __be16 *port, __be16 newport, bool udp)
+{
+	/* a zero UDP checksum means none was computed */
+	if (udp && !*check && skb->ip_summed != CHECKSUM_PARTIAL) {
+		*port = newport;
+		return;
+	}
+
+	if (oldip != newip)
+		inet_proto_csum_replace4(check, skb, oldip, newip, 1);
+	if (*port != newport) {
+		inet_proto_csum_replace2(check, skb, *port, newport, 0);
+		*port = newport;
+	}
+	if (udp && !*check)
+		*check = CSUM_MANGLED_0;
+}
+
+static unsigned int nf_fp_rx_hook(const struct nf_hook_ops *ops,
+				  struct sk_buff *skb,
+				  const struct net_device *in,
+				  const struct net_device *out,
+				  int (*okfn)(struct sk_buff *))
+{
+	struct nf_fp_tuple t;
+	struct nf_fp_flow *flow;
+	struct dst_entry *dst;
+	struct net_device *dev;
+	struct neighbour *neigh;
+	const struct iphdr *iph;
+	struct iphdr *niph;
+	unsigned int thoff, hdrlen;
+	__be16 *ports;
+	__sum16 *check;
+	__be32 nexthop;
+
+	if (!nf_fp_enable || skb->pkt_type != PACKET_HOST ||
+	    !net_eq(dev_net(in), &init_net))
+		return NF_ACCEPT;
+
+	if (!pskb_may_pull(skb, sizeof(struct iphdr)))
+		return NF_ACCEPT;
+
+	iph = ip_hdr(skb);
+	if (iph->ihl != 5 || ip_is_fragment(iph) || iph->ttl <= 1)
+		return NF_ACCEPT;
+
+	thoff = sizeof(struct iphdr);
+	switch (iph->protocol) {
+	case IPPROTO_TCP:
+		hdrlen = sizeof(struct tcphdr);
+		break;
+	case IPPROTO_UDP:
+		hdrlen = sizeof(struct udphdr);
+		break;
+	default:
+		return NF_ACCEPT;
+	}
+
+	if (!pskb_may_pull(skb, thoff + hdrlen))
+		return NF_ACCEPT;
+
+	iph = ip_hdr(skb);
+	ports = (__be16 *)(skb_network_header(skb) + thoff);
+
+	t.saddr = iph->saddr;
+	t.daddr = iph->daddr;
+	t.sport = ports[0];
+	t.dport = ports[1];
+	t.protonum = iph->protocol;
+	t.iif = in->ifindex;
+
+	flow = nf_fp_lookup(&t);
+	if (!flow)
+		return NF_ACCEPT;
+
+	if (unlikely(nf_fp_flow_stale(flow))) {
+		nf_fp_flow_kill(flow);
+		return NF_ACCEPT;
+	}
+
+	/* conntrack has to see the teardown */
+	if (iph->protocol == IPPROTO_TCP) {
+		const struct tcphdr *th = (const struct tcphdr *)ports;
+
+		if (unlikely(th->fin || th->syn || th->rst)) {
+			nf_fp_flow_kill(flow);
+			return NF_ACCEPT;
+		}
+	}
+
+	dst = flow->dst;
+	dev = dst->dev;
+	if (skb->len > ip_dst_mtu_maybe_forward(dst, true) &&
+	    !(skb_is_gso(skb) &&
+	      skb_gso_network_seglen(skb) <= ip_dst_mtu_maybe_forward(dst, true)))
+		return NF_ACCEPT;
+
+	if (skb_cow(skb, LL_RESERVED_SPACE(dev) + dst->header_len))
+		return NF_ACCEPT;
+
+	rcu_read_lock_bh();
+	nexthop = rt_nexthop((struct rtable *)dst, flow->new_daddr);
+	neigh = __ipv4_neigh_lookup_noref(dev, (__force u32)nexthop);
+	if (unlikely(!neigh)) {
+		rcu_read_unlock_bh();
+		return NF_ACCEPT;
+	}
+
+	/* from here on the packet goes out through the fast path */
+	skb_forward_csum(skb);
+
+	niph = ip_hdr(skb);
+	ports = (__be16 *)(skb_network_header(skb) + thoff);
+	if (niph->protocol == IPPROTO_TCP)
+		check = &((struct tcphdr *)ports)->check;
+	else
+		check = &((struct udphdr *)ports)->check;
+
+	nf_fp_nat_l4(skb, check, niph->saddr, flow->new_saddr,
+		     &ports[0], flow->new_sport, niph->protocol == IPPROTO_UDP);
+	nf_fp_nat_l4(skb, check, niph->daddr, flow->new_daddr,
+		     &ports[1], flow->new_dport, niph->protocol == IPPROTO_UDP);
+	if (niph->saddr != flow->new_saddr) {
+		csum_replace4(&niph->check, niph->saddr, flow->new_saddr);
+		niph->saddr = flow->new_saddr;
+	}
+	if (niph->daddr != flow->new_daddr) {
+		csum_replace4(&niph->check, niph->daddr, flow->new_daddr);
+		niph->daddr = flow->new_daddr;
+	}
+	ip_decrease_ttl(niph);
+	skb->priority = rt_tos2priority(niph->tos);
+
+	flow->packets++;
+	flow->bytes += skb->len;
+	flow->last_used = jiffies;
+	nf_ct_refresh_acct(flow->ct, flow->ctinfo, skb, flow->ct_timeout);
+	this_cpu_inc(nf_fp_cpu->fast);
+
+	skb_dst_drop(skb);
+	skb_dst_set(skb, dst_clone(dst));
+	skb->dev = dev;
+	skb->protocol = htons(ETH_P_IP);
+	IP_INC_STATS_BH(dev_net(dev), IPSTATS_MIB_OUTFORWDATAGRAMS);
+
+	dst_neigh_output(dst, neigh, skb);
+	rcu_read_unlock_bh();
+
+	return NF_STOLEN;
+}
+
+static unsigned int nf_fp_learn_hook(const struct nf_hook_ops *ops,
+				     struct sk_buff *skb,
+				     const struct net_device *in,
+				     const struct net_device *out,
+				     int (*okfn)(struct sk_buff *))
+{
+	const struct nf_conntrack_tuple *orig, *reply;
+	enum ip_conntrack_info ctinfo;
+	enum ip_conntrack_dir dir;
+	struct nf_fp_flow *flow;
+	struct nf_fp_tuple t;
+	struct dst_entry *dst;
+	struct nf_conn *ct;
+	long timeout;
+	u32 hash;
+
+	if (!nf_fp_enable || !(IPCB(skb)->flags & IPSKB_FORWARDED) ||
+	    !net_eq(dev_net(out), &init_net))
+		return NF_ACCEPT;
+
+	ct = nf_ct_get(skb, &ctinfo);
+	if (!ct || nf_ct_is_untracked(ct) ||
+	    (ctinfo != IP_CT_ESTABLISHED && ctinfo != IP_CT_ESTABLISHED_REPLY))
+		return NF_ACCEPT;
+
+	if (!test_bit(IPS_ASSURED_BIT, &ct->status) ||
+	    test_bit(IPS_SEQ_ADJUST_BIT, &ct->status) || nfct_help(ct))
+		return NF_ACCEPT;
+
+	switch (nf_ct_protonum(ct)) {
+	case IPPROTO_TCP:
+		if (ct->proto.tcp.state != TCP_CONNTRACK_ESTABLISHED)
+			return NF_ACCEPT;
+		break;
+	case IPPROTO_UDP:
+		break;
+	default:
+		return NF_ACCEPT;
+	}
+
+	dst = skb_dst(skb);
+	if (!dst || dst_xfrm(dst) ||
+	    ((struct rtable *)dst)->rt_type != RTN_UNICAST)
+		return NF_ACCEPT;
+
+	timeout = (long)(ct->timeout.expires - jiffies);
+	if (timeout <= 0)
+		return NF_ACCEPT;
+
+	dir = CTINFO2DIR(ctinfo);
+	orig = &ct->tuplehash[dir].tuple;
+	reply = &ct->tuplehash[!dir].tuple;
+
+	t.saddr = orig->src.u3.ip;
+	t.daddr = orig->dst.u3.ip;
+	t.sport = orig->src.u.all;
+	t.dport = orig->dst.u.all;
+	t.protonum = nf_ct_protonum(ct);
+	t.iif = skb->skb_iif;
+	hash = nf_fp_hash_tuple(&t);
+
+	spin_lock_bh(&nf_fp_lock);
+	if (nf_fp_count >= NF_FP_MAX_FLOWS || nf_fp_find(&t, hash))
+		goto out;
+
+	flow = kzalloc(sizeof(*flow), GFP_ATOMIC);
+	if (!flow)
+		goto out;
+
+	flow->tuple = t;
+	flow->new_saddr = reply->dst.u3.ip;
+	flow->new_daddr = reply->src.u3.ip;
+	flow->new_sport = reply->dst.u.all;
+	flow->new_dport = reply->src.u.all;
+	flow->ctinfo = ctinfo;
+	flow->ct_timeout = timeout;
+	flow->last_used = jiffies;
+	nf_conntrack_get(&ct->ct_general);
+	flow->ct = ct;
+	dst_hold(dst);
+	flow->dst = dst;
+
+	if (nf_ct_protonum(ct) == IPPROTO_TCP) {
+		/* the window tracking no longer sees every segment */
+		spin_lock(&ct->lock);
+		ct->proto.tcp.seen[0].flags |= IP_CT_TCP_FLAG_BE_LIBERAL;
+		ct->proto.tcp.seen[1].flags |= IP_CT_TCP_FLAG_BE_LIBERAL;
+		spin_unlock(&ct->lock);
+	}
+
+	hlist_add_head_rcu(&flow->hnode,
+			   &nf_fp_hash[hash & (NF_FP_HASH_SIZE - 1)]);
+	nf_fp_count++;
+	this_cpu_inc(nf_fp_cpu->learned);
+out:
+	spin_unlock_bh(&nf_fp_lock);
+	return NF_ACCEPT;
+}
+
+static struct nf_hook_ops nf_fp_ops[] __read_mostly = {
+	{
+		.hook		= nf_fp_rx_hook,
+		.owner		= THIS_MODULE,
+		.pf		= NFPROTO_IPV4,
+		.hooknum	= NF_INET_PRE_ROUTING,
+		.priority	= NF_IP_PRI_CONNTRACK_DEFRAG - 1,
+	},
+	{
+		.hook		= nf_fp_learn_hook,
+		.owner		= THIS_MODULE,
+		.pf		= NFPROTO_IPV4,
+		.hooknum	= NF_INET_POST_ROUTING,
+		.priority	= NF_IP_PRI_LAST,
+	},
+};
+
+static int nf_fp_netdev_event(struct notifier_block *this,
+			      unsigned long event, void *ptr)
+{
+	struct net_device *dev = netdev_notifier_info_to_dev(ptr);
+
+	if (event == NETDEV_DOWN || event == NETDEV_UNREGISTER)
+		nf_fp_flush(dev);
+	return NOTIFY_DONE;
+}
+
+static struct notifier_block nf_fp_netdev_notifier = {
+	.notifier_call	= nf_fp_netdev_event,
+};
+
+static int nf_fp_sysctl_enable(struct ctl_table *table, int write,
+			       void __user *buffer, size_t *lenp, loff_t *ppos)
+{
+	int ret;
+
+	ret = proc_dointvec_minmax(table, write, buffer, lenp, ppos);
+	if (!ret && write && !nf_fp_enable)
+		nf_fp_flush(NULL);
+	return ret;
+}
+
+static int zero;
+static int one = 1;
+
+static struct ctl_table nf_fp_sysctl_table[] = {
+	{
+		.procname	= "nf_conntrack_fastpath",
+		.data		= &nf_fp_enable,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= nf_fp_sysctl_enable,
+		.extra1		= &zero,
+		.extra2		= &one,
+	},
+	{ }
+};
+
+static struct ctl_table_header *nf_fp_sysctl_header;
+
+#ifdef CONFIG_PROC_FS
+static int nf_fp_seq_show(struct seq_file *s, void *v)
+{
+	unsigned long fast = 0, cache_hit = 0, learned = 0;
+	struct nf_fp_flow *flow;
+	struct net_device *dev;
+	unsigned int i;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		const struct nf_fp_cpu *c = per_cpu_ptr(nf_fp_cpu, cpu);
+
+		fast += c->fast;
+		cache_hit += c->cache_hit;
+		learned += c->learned;
+	}
+	seq_printf(s, "flows=%u fast=%lu cache_hit=%lu learned=%lu\n",
+		   nf_fp_count, fast, cache_hit, learned);
+
+	rcu_read_lock();
+	for (i = 0; i < NF_FP_HASH_SIZE; i++) {
+		hlist_for_each_entry_rcu(flow, &nf_fp_hash[i], hnode) {
+			dev = dev_get_by_index_rcu(&init_net, flow->tuple.iif);
+			seq_printf(s, "%s>%s proto=%u src=%pI4:%u dst=%pI4:%u -> src=%pI4:%u dst=%pI4:%u packets=%llu bytes=%llu\n",
+				   dev ? dev->name : "?", flow->dst->dev->name,
+				   flow->tuple.protonum,
+				   &flow->tuple.saddr, ntohs(flow->tuple.sport),
+				   &flow->tuple.daddr, ntohs(flow->tuple.dport),
+				   &flow->new_saddr, ntohs(flow->new_sport),
+				   &flow->new_daddr, ntohs(flow->new_dport),
+				   flow->packets, flow->bytes);
+		}
+	}
+	rcu_read_unlock();
+	return 0;
+}
+
+static int nf_fp_seq_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, nf_fp_seq_show, NULL);
+}
+
+static const struct file_operations nf_fp_seq_fops = {
+	.owner		= THIS_MODULE,
+	.open		= nf_fp_seq_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+#endif
+
+static int __init nf_fastpath_ipv4_init(void)
+{
+	unsigned int i;
+	int ret = -ENOMEM;
+
+	nf_fp_cpu = alloc_percpu(struct nf_fp_cpu);
+	if (!nf_fp_cpu)
+		return ret;
+
+	for (i = 0; i < NF_FP_HASH_SIZE; i++)
+		INIT_HLIST_HEAD(&nf_fp_hash[i]);
+	get_random_bytes(&nf_fp_seed, sizeof(nf_fp_seed));
+
+	nf_fp_sysctl_header = register_net_sysctl(&init_net, "net/netfilter",
+						  nf_fp_sysctl_table);
+	if (!nf_fp_sysctl_header)
+		goto err_sysctl;
+
+#ifdef CONFIG_PROC_FS
+	if (!proc_create("nf_conntrack_fastpath", 0440, init_net.proc_net,
+			 &nf_fp_seq_fops))
+		goto err_proc;
+#endif
+
+	ret = register_netdevice_notifier(&nf_fp_netdev_notifier);
+	if (ret < 0)
+		goto err_notifier;
+
+	ret = nf_register_hooks(nf_fp_ops, ARRAY_SIZE(nf_fp_ops));
+	if (ret < 0)
+		goto err_hooks;
+
+	INIT_DEFERRABLE_WORK(&nf_fp_gc_work, nf_fp_gc);
+	queue_delayed_work(system_power_efficient_wq, &nf_fp_gc_work,
+			   NF_FP_GC_INTERVAL);
+	return 0;
+
+err_hooks:
+	unregister_netdevice_notifier(&nf_fp_netdev_notifier);
+err_notifier:
+#ifdef CONFIG_PROC_FS
+	remove_proc_entry("nf_conntrack_fastpath", init_net.proc_net);
+err_proc:
+#endif
+	unregister_net_sysctl_table(nf_fp_sysctl_header);
+err_sysctl:
+	free_percpu(nf_fp_cpu);
+	return ret;
+}
+
+static void __exit nf_fastpath_ipv4_fini(void)
+{
+	nf_unregister_hooks(nf_fp_ops, ARRAY_SIZE(nf_fp_ops));
+	cancel_delayed_work_sync(&nf_fp_gc_work);
+	unregister_netdevice_notifier(&nf_fp_netdev_notifier);
+#ifdef CONFIG_PROC_FS
+	remove_proc_entry("nf_conntrack_fastpath", init_net.proc_net);
+#endif
+	unregister_net_sysctl_table(nf_fp_sysctl_header);
+	nf_fp_flush(NULL);
+	rcu_barrier();
+	free_percpu(nf_fp_cpu);
+}
+
+module_init(nf_fastpath_ipv4_init);
+module_exit(nf_fastpath_ipv4_fini);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("IPv4 forwarding fast path for established conntrack flows");
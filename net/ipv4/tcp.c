@@ -1004,6 +1004,7 @@ new_segment:
 
 wait_for_sndbuf:
 		set_bit(SOCK_NOSPACE, &sk->sk_socket->flags);
+		tcp_chrono_start(sk, TCP_CHRONO_SNDBUF_LIMITED);
 wait_for_memory:
 		tcp_push(sk, flags & ~MSG_MORE, mss_now,
 			 TCP_NAGLE_PUSH, size_goal);
@@ -1299,6 +1300,7 @@ new_segment:
 
 wait_for_sndbuf:
 			set_bit(SOCK_NOSPACE, &sk->sk_socket->flags);
+			tcp_chrono_start(sk, TCP_CHRONO_SNDBUF_LIMITED);
 wait_for_memory:
 			if (copied)
 				tcp_push(sk, flags & ~MSG_MORE, mss_now,
@@ -2742,6 +2744,34 @@ void tcp_get_info(const struct sock *sk, struct tcp_info *info)
 }
 EXPORT_SYMBOL_GPL(tcp_get_info);
 
+/* Return the sender chrono times and the RTT histogram for sock_diag. */
+void tcp_get_diag_stats(const struct sock *sk, struct tcp_diag_stats *stats)
+{
+	const struct tcp_sock *tp = tcp_sk(sk);
+	u32 chrono[__TCP_CHRONO_MAX - 1];
+	u32 busy = 0;
+	int i;
+
+	memcpy(chrono, tp->chrono_stat, sizeof(chrono));
+	/* include the chrono still running */
+	if (tp->chrono_type > TCP_CHRONO_UNSPEC)
+		chrono[tp->chrono_type - 1] += tcp_time_stamp - tp->chrono_start;
+
+	/* the limited states are all spent busy as well */
+	for (i = 0; i < ARRAY_SIZE(chrono); i++)
+		busy += chrono[i];
+
+#define CHRONO_US(type)	((u64)jiffies_to_msecs(chrono[(type) - 1]) * USEC_PER_MSEC)
+	stats->tcpi_busy_time = (u64)jiffies_to_msecs(busy) * USEC_PER_MSEC;
+	stats->tcpi_cwnd_limited = CHRONO_US(TCP_CHRONO_CWND_LIMITED);
+	stats->tcpi_rwnd_limited = CHRONO_US(TCP_CHRONO_RWND_LIMITED);
+	stats->tcpi_sndbuf_limited = CHRONO_US(TCP_CHRONO_SNDBUF_LIMITED);
+#undef CHRONO_US
+
+	memcpy(stats->tcpi_rtt_hist, tp->rtt_hist, sizeof(stats->tcpi_rtt_hist));
+}
+EXPORT_SYMBOL_GPL(tcp_get_diag_stats);
+
 static int do_tcp_getsockopt(struct sock *sk, int level,
 		int optname, char __user *optval, int __user *optlen)
 {
@@ -33,6 +33,19 @@ static void tcp_diag_get_info(struct sock *sk, struct inet_diag_msg *r,
 		tcp_get_info(sk, info);
 }
 
+static int tcp_diag_get_aux(struct sock *sk, struct sk_buff *skb)
+{
+	struct nlattr *attr;
+
+	attr = nla_reserve(skb, INET_DIAG_TCPSTATS,
+			   sizeof(struct tcp_diag_stats));
+	if (!attr)
+		return -EMSGSIZE;
+
+	tcp_get_diag_stats(sk, nla_data(attr));
+	return 0;
+}
+
 static void tcp_diag_dump(struct sk_buff *skb, struct netlink_callback *cb,
 			  struct inet_diag_req_v2 *r, struct nlattr *bc)
 {
@@ -49,6 +62,7 @@ static const struct inet_diag_handler tcp_diag_handler = {
 	.dump		 = tcp_diag_dump,
 	.dump_one	 = tcp_diag_dump_one,
 	.idiag_get_info	 = tcp_diag_get_info,
+	.idiag_get_aux	 = tcp_diag_get_aux,
 	.idiag_type	 = IPPROTO_TCP,
 };
 
@@ -679,12 +679,25 @@ static void tcp_event_data_recv(struct sock *sk, struct sk_buff *skb)
  * To save cycles in the RFC 1323 implementation it was better to break
  * it up into three procedures. -- erics
  */
+static void tcp_rtt_hist_add(struct tcp_sock *tp, long mrtt_us)
+{
+	unsigned int bucket = 0;
+	long ms = mrtt_us / USEC_PER_MSEC;
+
+	if (ms > 0)
+		bucket = min_t(unsigned int, ilog2(ms) + 1,
+			       TCP_DIAG_RTT_BUCKETS - 1);
+	tp->rtt_hist[bucket]++;
+}
+
 static void tcp_rtt_estimator(struct sock *sk, long mrtt_us)
 {
 	struct tcp_sock *tp = tcp_sk(sk);
 	long m = mrtt_us; /* RTT */
 	u32 srtt = tp->srtt_us;
 
+	tcp_rtt_hist_add(tp, mrtt_us);
+
 	/*	The following amusing code comes from Jacobson's
 	 *	article in SIGCOMM '88.  Note that rtt and mdev
 	 *	are scaled versions of rtt and mean deviation.
@@ -3149,6 +3162,8 @@ static int tcp_clean_rtx_queue(struct sock *sk, int prior_fackets,
 
 	if (skb && (TCP_SKB_CB(skb)->sacked & TCPCB_SACKED_ACKED))
 		flag |= FLAG_SACK_RENEGING;
+	if (!skb)
+		tcp_chrono_stop(sk, TCP_CHRONO_BUSY);
 
 	skb_mstamp_get(&now);
 	if (likely(first_ackt.v64)) {
@@ -4795,8 +4810,11 @@ static void tcp_check_space(struct sock *sk)
 	if (sock_flag(sk, SOCK_QUEUE_SHRUNK)) {
 		sock_reset_flag(sk, SOCK_QUEUE_SHRUNK);
 		if (sk->sk_socket &&
-		    test_bit(SOCK_NOSPACE, &sk->sk_socket->flags))
+		    test_bit(SOCK_NOSPACE, &sk->sk_socket->flags)) {
 			tcp_new_space(sk);
+			if (!test_bit(SOCK_NOSPACE, &sk->sk_socket->flags))
+				tcp_chrono_stop(sk, TCP_CHRONO_SNDBUF_LIMITED);
+		}
 	}
 }
 
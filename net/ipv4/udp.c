@@ -883,6 +883,81 @@ out:
 }
 EXPORT_SYMBOL(udp_push_pending_frames);
 
+struct udp_tx_route {
+	struct rcu_head	rcu;
+	struct rtable	*rt;
+	/* the flow as passed to the route lookup */
+	__be32		daddr;
+	__be32		saddr;
+	__u32		mark;
+	int		oif;
+	__u8		tos;
+	/* the source address the lookup picked */
+	__be32		fl4_saddr;
+};
+
+static void udp_tx_route_free(struct rcu_head *head)
+{
+	struct udp_tx_route *c = container_of(head, struct udp_tx_route, rcu);
+
+	ip_rt_put(c->rt);
+	kfree(c);
+}
+
+static struct rtable *udp_tx_route_get(struct sock *sk, struct flowi4 *fl4)
+{
+	struct udp_tx_route *c;
+	struct rtable *rt = NULL;
+
+	rcu_read_lock();
+	c = rcu_dereference(udp_sk(sk)->tx_route);
+	if (c && c->daddr == fl4->daddr && c->saddr == fl4->saddr &&
+	    c->oif == fl4->flowi4_oif && c->tos == fl4->flowi4_tos &&
+	    c->mark == fl4->flowi4_mark && dst_check(&c->rt->dst, 0)) {
+		/* the entry keeps its reference until a grace period passes */
+		rt = c->rt;
+		dst_hold(&rt->dst);
+		fl4->saddr = c->fl4_saddr;
+	}
+	rcu_read_unlock();
+	return rt;
+}
+
+static void udp_tx_route_set(struct sock *sk, struct rtable *rt,
+			     const struct flowi4 *fl4, __be32 daddr,
+			     __be32 saddr, int oif, __u8 tos)
+{
+	struct udp_sock *up = udp_sk(sk);
+	struct udp_tx_route *c;
+
+	/* a server answering many peers would only churn the entry */
+	if (up->tx_last_daddr != daddr) {
+		up->tx_last_daddr = daddr;
+		return;
+	}
+
+	if ((rt->rt_flags & (RTCF_BROADCAST | RTCF_MULTICAST)) ||
+	    dst_xfrm(&rt->dst))
+		return;
+
+	c = kmalloc(sizeof(*c), GFP_ATOMIC);
+	if (!c)
+		return;
+
+	dst_hold(&rt->dst);
+	c->rt = rt;
+	c->daddr = daddr;
+	c->saddr = saddr;
+	c->mark = sk->sk_mark;
+	c->oif = oif;
+	c->tos = tos;
+	c->fl4_saddr = fl4->saddr;
+
+	c = xchg((__force struct udp_tx_route **)&up->tx_route, c);
+	if (c)
+		call_rcu(&c->rcu, udp_tx_route_free);
+}
+
 int udp_sendmsg(struct kiocb *iocb, struct sock *sk, struct msghdr *msg,
 		size_t len)
 {
@@ -895,6 +970,7 @@ int udp_sendmsg(struct kiocb *iocb, struct sock *sk, struct msghdr *msg,
 	struct rtable *rt = NULL;
 	int free = 0;
 	int connected = 0;
+	int cacheable;
 	__be32 daddr, faddr, saddr;
 	__be16 dport;
 	u8  tos;
@@ -1032,9 +1108,11 @@ int udp_sendmsg(struct kiocb *iocb, struct sock *sk, struct msghdr *msg,
 	if (connected)
 		rt = (struct rtable *)sk_dst_check(sk, 0);
 
-	if (rt == NULL) {
-		struct net *net = sock_net(sk);
+	/* plain unicast sends may reuse the route of the previous one */
+	cacheable = !connected && !ipc.opt && !(tos & RTO_ONLINK) &&
+		    !ipv4_is_multicast(daddr);
 
+	if (rt == NULL) {
 		fl4 = &fl4_stack;
 		flowi4_init_output(fl4, ipc.oif, sk->sk_mark, tos,
 				   RT_SCOPE_UNIVERSE, sk->sk_protocol,
@@ -1042,6 +1120,13 @@ int udp_sendmsg(struct kiocb *iocb, struct sock *sk, struct msghdr *msg,
 				   faddr, saddr, dport, inet->inet_sport,
 				   sock_i_uid(sk));
 
+		if (cacheable)
+			rt = udp_tx_route_get(sk, fl4);
+	}
+
+	if (rt == NULL) {
+		struct net *net = sock_net(sk);
+
 		security_sk_classify_flow(sk, flowi4_to_flowi(fl4));
 		rt = ip_route_output_flow(net, fl4, sk);
 		if (IS_ERR(rt)) {
@@ -1058,6 +1143,9 @@ int udp_sendmsg(struct kiocb *iocb, struct sock *sk, struct msghdr *msg,
 			goto out;
 		if (connected)
 			sk_dst_set(sk, dst_clone(&rt->dst));
+		else if (cacheable)
+			udp_tx_route_set(sk, rt, fl4, faddr, saddr,
+					 ipc.oif, tos);
 	}
 
 	if (msg->msg_flags&MSG_CONFIRM)
@@ -1203,13 +1291,17 @@ out:
  */
 static unsigned int first_packet_length(struct sock *sk)
 {
-	struct sk_buff_head list_kill, *rcvq = &sk->sk_receive_queue;
+	struct sk_buff_head list_kill, *rcvq = &udp_sk(sk)->reader_queue;
 	struct sk_buff *skb;
 	unsigned int res;
 
 	__skb_queue_head_init(&list_kill);
 
 	spin_lock_bh(&rcvq->lock);
+	/* the readers see the datagrams in reader_queue first */
+	spin_lock_irq(&sk->sk_receive_queue.lock);
+	skb_queue_splice_tail_init(&sk->sk_receive_queue, rcvq);
+	spin_unlock_irq(&sk->sk_receive_queue.lock);
 	while ((skb = skb_peek(rcvq)) != NULL &&
 		udp_lib_checksum_complete(skb)) {
 		UDP_INC_STATS_BH(sock_net(sk), UDP_MIB_CSUMERRORS,
@@ -1291,8 +1383,9 @@ int udp_recvmsg(struct kiocb *iocb, struct sock *sk, struct msghdr *msg,
 		return ip_recv_error(sk, msg, len, addr_len);
 
 try_again:
-	skb = __skb_recv_datagram(sk, flags | (noblock ? MSG_DONTWAIT : 0),
-				  &peeked, &off, &err);
+	skb = __skb_recv_datagram_batch(sk, &udp_sk(sk)->reader_queue,
+					flags | (noblock ? MSG_DONTWAIT : 0),
+					&peeked, &off, &err);
 	if (!skb)
 		goto out;
 
@@ -1364,7 +1457,7 @@ out:
 
 csum_copy_err:
 	slow = lock_sock_fast(sk);
-	if (!skb_kill_datagram(sk, skb, flags)) {
+	if (!__skb_kill_datagram(sk, &udp_sk(sk)->reader_queue, skb, flags)) {
 		UDP_INC_STATS_USER(sock_net(sk), UDP_MIB_CSUMERRORS, is_udplite);
 		UDP_INC_STATS_USER(sock_net(sk), UDP_MIB_INERRORS, is_udplite);
 	}
@@ -2029,12 +2122,37 @@ int udp_rcv(struct sk_buff *skb)
 	return __udp4_lib_rcv(skb, &udp_table, IPPROTO_UDP);
 }
 
+int udp_init_sock(struct sock *sk)
+{
+	skb_queue_head_init(&udp_sk(sk)->reader_queue);
+	return 0;
+}
+EXPORT_SYMBOL(udp_init_sock);
+
+/*
+ *	Drop what the readers still hold and the cached route. Shared with
+ *	IPv6, whose sockets also carry v4-mapped traffic.
+ */
+void udp_lib_destroy_queues(struct sock *sk)
+{
+	struct udp_sock *up = udp_sk(sk);
+	struct udp_tx_route *c;
+
+	skb_queue_purge(&up->reader_queue);
+
+	c = xchg((__force struct udp_tx_route **)&up->tx_route, NULL);
+	if (c)
+		call_rcu(&c->rcu, udp_tx_route_free);
+}
+EXPORT_SYMBOL(udp_lib_destroy_queues);
+
 void udp_destroy_sock(struct sock *sk)
 {
 	struct udp_sock *up = udp_sk(sk);
 	bool slow = lock_sock_fast(sk);
 	udp_flush_pending_frames(sk);
 	unlock_sock_fast(sk, slow);
+	udp_lib_destroy_queues(sk);
 	if (static_key_false(&udp_encap_needed) && up->encap_type) {
 		void (*encap_destroy)(struct sock *sk);
 		encap_destroy = ACCESS_ONCE(up->encap_destroy);
@@ -2249,6 +2367,10 @@ unsigned int udp_poll(struct file *file, struct socket *sock, poll_table *wait)
 
 	sock_rps_record_flow(sk);
 
+	/* datagram_poll() only looks at sk_receive_queue */
+	if (!skb_queue_empty(&udp_sk(sk)->reader_queue))
+		mask |= POLLIN | POLLRDNORM;
+
 	/* Check for false positives due to checksum errors */
 	if ((mask & POLLRDNORM) && !(file->f_flags & O_NONBLOCK) &&
 	    !(sk->sk_shutdown & RCV_SHUTDOWN) && !first_packet_length(sk))
@@ -2266,6 +2388,7 @@ struct proto udp_prot = {
 	.connect	   = ip4_datagram_connect,
 	.disconnect	   = udp_disconnect,
 	.ioctl		   = udp_ioctl,
+	.init		   = udp_init_sock,
 	.destroy	   = udp_destroy_sock,
 	.setsockopt	   = udp_setsockopt,
 	.getsockopt	   = udp_getsockopt,
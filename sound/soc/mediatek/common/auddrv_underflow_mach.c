@@ -37,9 +37,14 @@
  *******************************************************************************/
 
 #include <mt-plat/aee.h>
+#include <linux/init.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/spinlock.h>
 #include "auddrv_underflow_mach.h"
 
 #define UnderflowrecordNumber (20)
+#define UnderflowStreamNumber (16)
 
 static bool bEnableDump;
 /* default setting for samplerate and interrupt count */
@@ -61,6 +66,17 @@ static unsigned long long UnderflowTime[UnderflowrecordNumber] = { 0 };
 
 static unsigned int UnderflowCounter;
 static unsigned int UnderflowThreshold = 3;
+static unsigned int LateInterruptCounter;
+
+struct UnderflowStream {
+	const char *name;
+	unsigned int count;		/* since the stream was last reset */
+	unsigned int total;		/* since boot */
+	unsigned long long last_time;	/* ns */
+};
+
+static struct UnderflowStream UnderflowStreams[UnderflowStreamNumber];
+static DEFINE_SPINLOCK(UnderflowStreamLock);
 static void ClearInterruptTiming(void);
 static void DumpUnderFlowTime(void);
 static void ClearUnderFlowTime(void);
@@ -174,6 +190,7 @@ void Auddrv_CheckInterruptTiming(void)
 			     mDL1_Interrupt_Interval_Limit);
 			Irq_time_t2 = Irq_time_t1 - Irq_time_t2;
 			if (Irq_time_t2 > mDL1_Interrupt_Interval_Limit * 1000000) {
+				LateInterruptCounter++;
 				pr_debug
 				    ("%s interrupt may be blocked Irq_time_t2 = %llu Interval_Limit = %d\n",
 				     __func__, Irq_time_t2, mDL1_Interrupt_Interval_Limit);
@@ -236,3 +253,88 @@ bool Auddrv_Enable_dump(bool bEnable)
 	bEnableDump = bEnable;
 	return true;
 }
+
+/*
+/    per stream underflow record, the slot of a name is kept once taken
+*/
+static struct UnderflowStream *GetUnderFlowStream(const char *name)
+{
+	int i;
+
+	for (i = 0; i < UnderflowStreamNumber; i++) {
+		if (UnderflowStreams[i].name == name)
+			return &UnderflowStreams[i];
+		if (!UnderflowStreams[i].name) {
+			UnderflowStreams[i].name = name;
+			return &UnderflowStreams[i];
+		}
+	}
+	return NULL;
+}
+
+void Auddrv_Stream_UnderFlow(const char *name)
+{
+	struct UnderflowStream *stream;
+	unsigned long flags;
+
+	spin_lock_irqsave(&UnderflowStreamLock, flags);
+	stream = GetUnderFlowStream(name);
+	if (stream) {
+		stream->count++;
+		stream->total++;
+		stream->last_time = sched_clock();
+	}
+	spin_unlock_irqrestore(&UnderflowStreamLock, flags);
+
+	Auddrv_Set_UnderFlow();
+}
+
+void Auddrv_Stream_Reset(const char *name)
+{
+	struct UnderflowStream *stream;
+	unsigned long flags;
+
+	spin_lock_irqsave(&UnderflowStreamLock, flags);
+	stream = GetUnderFlowStream(name);
+	if (stream)
+		stream->count = 0;
+	spin_unlock_irqrestore(&UnderflowStreamLock, flags);
+}
+
+static int Auddrv_UnderFlow_Show(struct seq_file *m, void *v)
+{
+	struct UnderflowStream streams[UnderflowStreamNumber];
+	unsigned long flags;
+	int i;
+
+	spin_lock_irqsave(&UnderflowStreamLock, flags);
+	memcpy(streams, UnderflowStreams, sizeof(streams));
+	spin_unlock_irqrestore(&UnderflowStreamLock, flags);
+
+	seq_printf(m, "%-16s %10s %10s %20s\n", "stream", "count", "total", "last(ns)");
+	for (i = 0; i < UnderflowStreamNumber && streams[i].name; i++)
+		seq_printf(m, "%-16s %10u %10u %20llu\n", streams[i].name, streams[i].count,
+			   streams[i].total, streams[i].last_time);
+	seq_printf(m, "late DL1 interrupts: %u, limit %u ms\n", LateInterruptCounter,
+		   mDL1_Interrupt_Interval_Limit);
+	return 0;
+}
+
+static int Auddrv_UnderFlow_Open(struct inode *inode, struct file *file)
+{
+	return single_open(file, Auddrv_UnderFlow_Show, NULL);
+}
+
+static const struct file_operations Auddrv_UnderFlow_Fops = {
+	.open = Auddrv_UnderFlow_Open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init Auddrv_UnderFlow_Init(void)
+{
+	debugfs_create_file("auddrv_underflow", 0444, NULL, NULL, &Auddrv_UnderFlow_Fops);
+	return 0;
+}
+late_initcall(Auddrv_UnderFlow_Init);
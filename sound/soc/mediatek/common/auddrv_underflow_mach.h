@@ -47,3 +47,11 @@ void RefineInterrruptInterval(void);
 bool Auddrv_Set_DlSamplerate(unsigned int Samplerate);
 bool Auddrv_Set_InterruptSample(unsigned int count);
 bool Auddrv_Enable_dump(bool bEnable);
+
+/*
+ * per stream underflow counters, /sys/kernel/debug/auddrv_underflow
+ * name is the stream (memif) name, it has to be a string constant, and the
+ * calls are safe from the AFE interrupt.
+ */
+void Auddrv_Stream_UnderFlow(const char *name);
+void Auddrv_Stream_Reset(const char *name);
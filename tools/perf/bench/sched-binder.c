@@ -0,0 +1,686 @@
+/*
+ * sched-binder.c
+ *
+ * binder: Benchmark for binder calls between two processes
+ *
+ * Each pair is a client process making synchronous calls of a given size
+ * to a server process that replies straight away, over the raw binder
+ * ioctls so no framework code is timed.  Client and server can be pinned
+ * to CPUs and given a nice or SCHED_FIFO priority, per pair, to compare
+ * placements across clusters and priority inheritance.
+ *
+ * The server registers with servicemanager, which has to allow it (run
+ * as root, SELinux permissive), or with -M becomes the context manager
+ * where there is none.  With access to debugfs the kernel side of the
+ * calls is split up too, from /sys/kernel/debug/binder/latency.
+ */
+#include "../perf.h"
+#include "../util/util.h"
+#include "../util/parse-options.h"
+#include "../builtin.h"
+#include "bench.h"
+#include "../../../drivers/staging/android/uapi/binder.h"
+
+#include <err.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define BB_MAP_SIZE		(1024 * 1024)
+#define BB_MAX_SIZE		(256 * 1024)
+#define BB_MAX_SIZES		16
+#define BB_WARMUP		100
+#define BB_CODE_WARMUP		999
+#define BB_CODE(i)		(1000 + (i))	/* per size in binder/latency */
+
+#define SM_CHECK_SERVICE	2
+#define SM_ADD_SERVICE		3
+#define SM_NAME			"android.os.IServiceManager"
+
+static unsigned int loops = 10000;
+static unsigned int nr_pairs = 1;
+static const char *sizes_str = "0,64,1024,4096,16384";
+static const char *client_cpus_str = "";
+static const char *server_cpus_str = "";
+static int client_nice, server_nice;
+static unsigned int client_fifo, server_fifo;
+static const char *device = "/dev/binder";
+static bool echo, context_mgr, histogram;
+
+static const struct option options[] = {
+	OPT_UINTEGER('l', "loop",	&loops,		"Specify number of calls per size"),
+	OPT_UINTEGER('p', "pairs",	&nr_pairs,	"Specify number of client/server pairs"),
+	OPT_STRING('s', "sizes",	&sizes_str,	"n,...", "Call sizes in bytes"),
+	OPT_STRING('c', "client-cpus",	&client_cpus_str, "cpu,...", "Pin client i to the i-th CPU listed"),
+	OPT_STRING('S', "server-cpus",	&server_cpus_str, "cpu,...", "Pin server i to the i-th CPU listed"),
+	OPT_INTEGER('n', "client-nice",	&client_nice,	"Nice of the clients"),
+	OPT_INTEGER('N', "server-nice",	&server_nice,	"Nice of the servers"),
+	OPT_UINTEGER('f', "client-fifo", &client_fifo,	"SCHED_FIFO priority of the clients, 0: none"),
+	OPT_UINTEGER('F', "server-fifo", &server_fifo,	"SCHED_FIFO priority of the servers, 0: none"),
+	OPT_BOOLEAN('e', "echo",	&echo,		"Reply with as much data as the call had"),
+	OPT_BOOLEAN('M', "context-mgr",	&context_mgr,	"Server is the context manager, no servicemanager"),
+	OPT_BOOLEAN('H', "histogram",	&histogram,	"Print a log2 histogram of the call times"),
+	OPT_STRING('d', "device",	&device,	"path", "Binder device"),
+	OPT_END()
+};
+
+static const char * const bench_sched_binder_usage[] = {
+	"perf bench sched binder <options>",
+	NULL
+};
+
+static unsigned int sizes[BB_MAX_SIZES], nr_sizes;
+static int client_cpus[64], nr_client_cpus;
+static int server_cpus[64], nr_server_cpus;
+
+/* shared with the children */
+struct bb_result {
+	u64 elapsed_ns[BB_MAX_SIZES];
+	u64 ns[];		/* [size][loop] */
+};
+
+static void *results;
+static size_t result_size;
+
+static struct bb_result *pair_result(unsigned int pair)
+{
+	return results + (size_t)pair * result_size;
+}
+
+struct bb_ctx {
+	int fd;
+	u8 wbuf[512];
+	size_t wlen;
+	u8 rbuf[512];
+	size_t rpos, rlen;
+};
+
+struct bb_parcel {
+	u8 data[256];
+	size_t len;
+	binder_size_t offs[1];
+	size_t nr_offs;
+};
+
+/* the server's one object, its address is the node */
+static int bb_node;
+static u8 payload[BB_MAX_SIZE];
+
+static u64 now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void bb_put(struct bb_ctx *c, const void *p, size_t n)
+{
+	BUG_ON(c->wlen + n > sizeof(c->wbuf));
+	memcpy(c->wbuf + c->wlen, p, n);
+	c->wlen += n;
+}
+
+static void bb_put_cmd(struct bb_ctx *c, u32 cmd, const void *p, size_t n)
+{
+	bb_put(c, &cmd, sizeof(cmd));
+	if (n)
+		bb_put(c, p, n);
+}
+
+static void bb_open(struct bb_ctx *c)
+{
+	struct binder_version vers;
+
+	memset(c, 0, sizeof(*c));
+	c->fd = open(device, O_RDWR | O_CLOEXEC);
+	if (c->fd < 0)
+		err(EXIT_FAILURE, "open %s", device);
+	if (ioctl(c->fd, BINDER_VERSION, &vers) < 0 ||
+	    vers.protocol_version != BINDER_CURRENT_PROTOCOL_VERSION)
+		errx(EXIT_FAILURE, "binder protocol version mismatch");
+	if (mmap(NULL, BB_MAP_SIZE, PROT_READ, MAP_PRIVATE, c->fd, 0) == MAP_FAILED)
+		err(EXIT_FAILURE, "mmap %s", device);
+}
+
+static void bb_ioctl(struct bb_ctx *c)
+{
+	struct binder_write_read bwr;
+
+	memset(&bwr, 0, sizeof(bwr));
+	bwr.write_size = c->wlen;
+	bwr.write_buffer = (uintptr_t)c->wbuf;
+	bwr.read_size = sizeof(c->rbuf);
+	bwr.read_buffer = (uintptr_t)c->rbuf;
+
+	while (ioctl(c->fd, BINDER_WRITE_READ, &bwr) < 0) {
+		if (errno != EINTR)
+			err(EXIT_FAILURE, "BINDER_WRITE_READ");
+		bwr.write_size -= bwr.write_consumed;
+		bwr.write_buffer += bwr.write_consumed;
+		bwr.write_consumed = 0;
+	}
+	c->wlen = 0;
+	c->rpos = 0;
+	c->rlen = bwr.read_consumed;
+}
+
+/*
+ * Write what is queued, then return the next BR_TRANSACTION or BR_REPLY
+ * and answer the reference counting on the way.
+ */
+static u32 bb_next(struct bb_ctx *c, struct binder_transaction_data *tr)
+{
+	struct binder_ptr_cookie pc;
+	binder_uintptr_t cookie;
+	u32 cmd;
+
+	for (;;) {
+		if (c->rpos >= c->rlen) {
+			bb_ioctl(c);
+			continue;
+		}
+		memcpy(&cmd, c->rbuf + c->rpos, sizeof(cmd));
+		c->rpos += sizeof(cmd);
+
+		switch (cmd) {
+		case BR_NOOP:
+		case BR_TRANSACTION_COMPLETE:
+		case BR_SPAWN_LOOPER:
+			break;
+		case BR_INCREFS:
+		case BR_ACQUIRE:
+			memcpy(&pc, c->rbuf + c->rpos, sizeof(pc));
+			c->rpos += sizeof(pc);
+			bb_put_cmd(c, cmd == BR_INCREFS ? BC_INCREFS_DONE : BC_ACQUIRE_DONE,
+				   &pc, sizeof(pc));
+			break;
+		case BR_RELEASE:
+		case BR_DECREFS:
+			c->rpos += sizeof(pc);
+			break;
+		case BR_DEAD_BINDER:
+			memcpy(&cookie, c->rbuf + c->rpos, sizeof(cookie));
+			c->rpos += sizeof(cookie);
+			bb_put_cmd(c, BC_DEAD_BINDER_DONE, &cookie, sizeof(cookie));
+			break;
+		case BR_TRANSACTION:
+		case BR_REPLY:
+			memcpy(tr, c->rbuf + c->rpos, sizeof(*tr));
+			c->rpos += sizeof(*tr);
+			return cmd;
+		default:
+			errx(EXIT_FAILURE, "unexpected binder return 0x%x", cmd);
+		}
+	}
+}
+
+/* a synchronous call, hand the reply to bb_free() when done with it */
+static void bb_call(struct bb_ctx *c, u32 handle, u32 code, const void *data, size_t len,
+		    const binder_size_t *offs, size_t nr_offs, struct binder_transaction_data *reply)
+{
+	struct binder_transaction_data tr;
+
+	memset(&tr, 0, sizeof(tr));
+	tr.target.handle = handle;
+	tr.code = code;
+	tr.flags = TF_ACCEPT_FDS;
+	tr.data_size = len;
+	tr.offsets_size = nr_offs * sizeof(binder_size_t);
+	tr.data.ptr.buffer = (uintptr_t)data;
+	tr.data.ptr.offsets = (uintptr_t)offs;
+	bb_put_cmd(c, BC_TRANSACTION, &tr, sizeof(tr));
+
+	while (bb_next(c, reply) != BR_REPLY)
+		;
+	if (reply->flags & TF_STATUS_CODE)
+		errx(EXIT_FAILURE, "call 0x%x failed", code);
+}
+
+/* goes with the next write */
+static void bb_free(struct bb_ctx *c, struct binder_transaction_data *tr)
+{
+	bb_put_cmd(c, BC_FREE_BUFFER, &tr->data.ptr.buffer, sizeof(binder_uintptr_t));
+}
+
+static void parcel_put32(struct bb_parcel *p, u32 v)
+{
+	memcpy(p->data + p->len, &v, sizeof(v));
+	p->len += sizeof(v);
+}
+
+static void parcel_put_str16(struct bb_parcel *p, const char *s)
+{
+	u32 i, n = strlen(s);
+	u16 ch;
+
+	parcel_put32(p, n);
+	for (i = 0; i <= n; i++) {
+		ch = (unsigned char)s[i];
+		memcpy(p->data + p->len, &ch, sizeof(ch));
+		p->len += sizeof(ch);
+	}
+	p->len = PERF_ALIGN(p->len, 4);
+}
+
+static void parcel_put_binder(struct bb_parcel *p, void *node)
+{
+	struct flat_binder_object obj;
+
+	memset(&obj, 0, sizeof(obj));
+	obj.type = BINDER_TYPE_BINDER;
+	obj.flags = 0x7f | FLAT_BINDER_FLAG_ACCEPTS_FDS;
+	obj.binder = (uintptr_t)node;
+	p->offs[p->nr_offs++] = p->len;
+	memcpy(p->data + p->len, &obj, sizeof(obj));
+	p->len += sizeof(obj);
+}
+
+static void service_name(char *buf, size_t len, unsigned int pair)
+{
+	snprintf(buf, len, "perf.bench.binder.%d.%u", getppid(), pair);
+}
+
+static void set_sched(int cpu, int nice, unsigned int fifo)
+{
+	struct sched_param sp = { .sched_priority = fifo };
+	cpu_set_t set;
+
+	if (cpu >= 0) {
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		if (sched_setaffinity(0, sizeof(set), &set))
+			warn("sched_setaffinity to CPU %d", cpu);
+	}
+	if (nice && setpriority(PRIO_PROCESS, 0, nice))
+		warn("setpriority %d", nice);
+	if (fifo && sched_setscheduler(0, SCHED_FIFO, &sp))
+		warn("SCHED_FIFO %u", fifo);
+}
+
+static void NORETURN server(unsigned int pair, int ready_fd)
+{
+	struct binder_transaction_data tr, reply;
+	struct bb_parcel p;
+	struct bb_ctx c;
+	char name[64];
+	u32 status;
+
+	bb_open(&c);
+	if (context_mgr) {
+		if (ioctl(c.fd, BINDER_SET_CONTEXT_MGR, 0) < 0)
+			err(EXIT_FAILURE, "BINDER_SET_CONTEXT_MGR");
+	} else {
+		memset(&p, 0, sizeof(p));
+		service_name(name, sizeof(name), pair);
+		parcel_put32(&p, 0);
+		parcel_put_str16(&p, SM_NAME);
+		parcel_put_str16(&p, name);
+		parcel_put_binder(&p, &bb_node);
+		parcel_put32(&p, 0);
+		bb_call(&c, 0, SM_ADD_SERVICE, p.data, p.len, p.offs, p.nr_offs, &reply);
+		status = reply.data_size >= sizeof(status) ?
+			 *(u32 *)(uintptr_t)reply.data.ptr.buffer : ~0U;
+		if (status)
+			errx(EXIT_FAILURE, "servicemanager would not add %s", name);
+		bb_free(&c, &reply);
+	}
+	set_sched(nr_server_cpus ? server_cpus[pair % nr_server_cpus] : -1,
+		  server_nice, server_fifo);
+	if (write(ready_fd, "r", 1) != 1)
+		err(EXIT_FAILURE, "write");
+	close(ready_fd);
+
+	bb_put_cmd(&c, BC_ENTER_LOOPER, NULL, 0);
+	for (;;) {
+		if (bb_next(&c, &tr) != BR_TRANSACTION)
+			continue;
+		memset(&reply, 0, sizeof(reply));
+		reply.data_size = echo ? tr.data_size : 0;
+		reply.data.ptr.buffer = (uintptr_t)payload;
+		bb_put_cmd(&c, BC_REPLY, &reply, sizeof(reply));
+		bb_free(&c, &tr);
+	}
+}
+
+static u32 client_handle(struct bb_ctx *c, unsigned int pair)
+{
+	struct binder_transaction_data reply;
+	struct flat_binder_object *obj;
+	struct bb_parcel p;
+	binder_size_t off;
+	char name[64];
+	u32 handle;
+
+	if (context_mgr)
+		return 0;
+
+	memset(&p, 0, sizeof(p));
+	service_name(name, sizeof(name), pair);
+	parcel_put32(&p, 0);
+	parcel_put_str16(&p, SM_NAME);
+	parcel_put_str16(&p, name);
+	bb_call(c, 0, SM_CHECK_SERVICE, p.data, p.len, NULL, 0, &reply);
+	if (reply.offsets_size < sizeof(off))
+		errx(EXIT_FAILURE, "servicemanager does not know %s", name);
+	off = *(binder_size_t *)(uintptr_t)reply.data.ptr.offsets;
+	obj = (struct flat_binder_object *)(uintptr_t)(reply.data.ptr.buffer + off);
+	if (obj->type != BINDER_TYPE_HANDLE)
+		errx(EXIT_FAILURE, "%s is not a handle", name);
+	handle = obj->handle;
+	/* keep the ref when the reply that brought it is freed */
+	bb_put_cmd(c, BC_ACQUIRE, &handle, sizeof(handle));
+	bb_free(c, &reply);
+	return handle;
+}
+
+static void NORETURN client(unsigned int pair, int ready_fd, int go_fd, int done_fd)
+{
+	struct bb_result *res = pair_result(pair);
+	struct binder_transaction_data reply;
+	struct bb_ctx c;
+	unsigned int i, s;
+	u32 handle;
+	u64 start, t;
+	char ch;
+
+	if (read(ready_fd, &ch, 1) != 1)
+		errx(EXIT_FAILURE, "server %u did not come up", pair);
+	bb_open(&c);
+	handle = client_handle(&c, pair);
+	set_sched(nr_client_cpus ? client_cpus[pair % nr_client_cpus] : -1,
+		  client_nice, client_fifo);
+	for (i = 0; i < BB_WARMUP; i++) {
+		bb_call(&c, handle, BB_CODE_WARMUP, payload, sizes[0], NULL, 0, &reply);
+		bb_free(&c, &reply);
+	}
+
+	/* start all pairs together */
+	if (write(done_fd, "r", 1) != 1)
+		err(EXIT_FAILURE, "write");
+	if (read(go_fd, &ch, 1) < 0)
+		err(EXIT_FAILURE, "read");
+
+	for (s = 0; s < nr_sizes; s++) {
+		start = now_ns();
+		for (i = 0; i < loops; i++) {
+			t = now_ns();
+			bb_call(&c, handle, BB_CODE(s), payload, sizes[s], NULL, 0, &reply);
+			res->ns[s * loops + i] = now_ns() - t;
+			bb_free(&c, &reply);
+		}
+		res->elapsed_ns[s] = now_ns() - start;
+	}
+	if (c.wlen) {
+		/* the last BC_FREE_BUFFER, nothing comes back for it */
+		struct binder_write_read bwr;
+
+		memset(&bwr, 0, sizeof(bwr));
+		bwr.write_size = c.wlen;
+		bwr.write_buffer = (uintptr_t)c.wbuf;
+		if (ioctl(c.fd, BINDER_WRITE_READ, &bwr) < 0)
+			warn("BINDER_WRITE_READ");
+	}
+
+	/* stay around for binder/latency to be read, it goes with the proc */
+	if (write(done_fd, "d", 1) != 1)
+		err(EXIT_FAILURE, "write");
+	while (read(go_fd, &ch, 1) > 0)
+		;
+	exit(0);
+}
+
+static int parse_list(const char *str, int *out, int max, const char *what)
+{
+	char *end;
+	long v;
+	int n = 0;
+
+	while (*str) {
+		v = strtol(str, &end, 10);
+		if (end == str || v < 0 || n == max)
+			errx(EXIT_FAILURE, "bad %s list", what);
+		out[n++] = v;
+		str = *end == ',' ? end + 1 : end;
+		if (*end && *end != ',')
+			errx(EXIT_FAILURE, "bad %s list", what);
+	}
+	return n;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	u64 x = *(const u64 *)a, y = *(const u64 *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static const char * const stage_names[] = {
+	"deliver", "copy", "wakeup", "process", "reply", "reply_copy", "reply_wakeup",
+};
+#define NR_STAGES	ARRAY_SIZE(stage_names)
+
+struct stage_stat {
+	u64 count, sum_us, max_us;
+};
+
+/* sum up what binder/latency has for the procs of the pairs */
+static bool read_kernel_stats(pid_t *pids, unsigned int nr_pids,
+			      struct stage_stat st[][NR_STAGES])
+{
+	unsigned long long count, avg, max;
+	char line[256], stage[32];
+	unsigned int code, i;
+	bool ours = false, any = false;
+	int pid;
+	FILE *f;
+
+	f = fopen("/sys/kernel/debug/binder/latency", "r");
+	if (!f)
+		return false;
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "proc %d", &pid) == 1) {
+			ours = false;
+			for (i = 0; i < nr_pids; i++)
+				if (pids[i] == pid)
+					ours = true;
+			continue;
+		}
+		if (!ours || sscanf(line, " code %u %31[a-z_]: count %llu avg %llu us max %llu us",
+				    &code, stage, &count, &avg, &max) != 5)
+			continue;
+		if (code < BB_CODE(0) || code >= BB_CODE(nr_sizes))
+			continue;
+		for (i = 0; i < NR_STAGES; i++) {
+			struct stage_stat *s = &st[code - BB_CODE(0)][i];
+
+			if (strcmp(stage, stage_names[i]))
+				continue;
+			s->count += count;
+			s->sum_us += count * avg;
+			if (max > s->max_us)
+				s->max_us = max;
+			any = true;
+		}
+	}
+	fclose(f);
+	return any;
+}
+
+static void print_histogram(u64 *ns, unsigned int n)
+{
+	unsigned int i, b, hist[32] = { 0 };
+	u64 us;
+
+	for (i = 0; i < n; i++) {
+		us = ns[i] / 1000;
+		for (b = 0; us > 1 && b < ARRAY_SIZE(hist) - 1; b++)
+			us >>= 1;
+		hist[b]++;
+	}
+	for (b = 0; b < ARRAY_SIZE(hist); b++)
+		if (hist[b])
+			printf(" %24s <%7u usecs: %u\n", "", 2U << b, hist[b]);
+}
+
+int bench_sched_binder(int argc, const char **argv, const char *prefix __maybe_unused)
+{
+	struct stage_stat (*kst)[NR_STAGES];
+	int ready[2], go[2], done[2];
+	int size_list[BB_MAX_SIZES];
+	pid_t *pids;
+	u64 *all, elapsed;
+	double rate;
+	unsigned int i, s, n;
+	bool have_kst;
+	char ch;
+
+	argc = parse_options(argc, argv, options, bench_sched_binder_usage, 0);
+
+	nr_sizes = parse_list(sizes_str, size_list, BB_MAX_SIZES, "size");
+	for (s = 0; s < nr_sizes; s++) {
+		if (size_list[s] > BB_MAX_SIZE)
+			errx(EXIT_FAILURE, "sizes go up to %d", BB_MAX_SIZE);
+		sizes[s] = size_list[s];
+	}
+	nr_client_cpus = parse_list(client_cpus_str, client_cpus, ARRAY_SIZE(client_cpus), "CPU");
+	nr_server_cpus = parse_list(server_cpus_str, server_cpus, ARRAY_SIZE(server_cpus), "CPU");
+	if (!nr_sizes || !loops || !nr_pairs)
+		errx(EXIT_FAILURE, "nothing to do");
+	if (context_mgr && nr_pairs > 1)
+		errx(EXIT_FAILURE, "only one pair can use the context manager");
+
+	result_size = PERF_ALIGN(sizeof(struct bb_result) + (size_t)nr_sizes * loops * sizeof(u64), 64);
+	results = mmap(NULL, result_size * nr_pairs, PROT_READ | PROT_WRITE,
+		       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (results == MAP_FAILED)
+		err(EXIT_FAILURE, "mmap");
+	pids = calloc(2 * nr_pairs, sizeof(*pids));
+	all = malloc((size_t)nr_pairs * loops * sizeof(u64));
+	kst = calloc(nr_sizes, sizeof(*kst));
+	if (!pids || !all || !kst)
+		err(EXIT_FAILURE, "calloc");
+	if (pipe(go) || pipe(done))
+		err(EXIT_FAILURE, "pipe");
+
+	for (i = 0; i < nr_pairs; i++) {
+		if (pipe(ready))
+			err(EXIT_FAILURE, "pipe");
+		pids[2 * i] = fork();
+		if (pids[2 * i] < 0)
+			err(EXIT_FAILURE, "fork");
+		if (!pids[2 * i]) {
+			/* the pipes must not stay open for the clients */
+			close(ready[0]);
+			close(go[0]);
+			close(go[1]);
+			close(done[0]);
+			close(done[1]);
+			server(i, ready[1]);
+		}
+		pids[2 * i + 1] = fork();
+		if (pids[2 * i + 1] < 0)
+			err(EXIT_FAILURE, "fork");
+		if (!pids[2 * i + 1]) {
+			close(ready[1]);
+			close(go[1]);
+			close(done[0]);
+			client(i, ready[0], go[0], done[1]);
+		}
+		close(ready[0]);
+		close(ready[1]);
+	}
+	close(go[0]);
+	close(done[1]);
+
+	for (i = 0; i < nr_pairs; i++)
+		if (read(done[0], &ch, 1) != 1)
+			errx(EXIT_FAILURE, "a pair failed to start");
+	/* go */
+	for (i = 0; i < nr_pairs; i++)
+		if (write(go[1], "g", 1) != 1)
+			err(EXIT_FAILURE, "write");
+	for (i = 0; i < nr_pairs; i++)
+		if (read(done[0], &ch, 1) != 1)
+			errx(EXIT_FAILURE, "a pair failed");
+
+	have_kst = read_kernel_stats(pids, 2 * nr_pairs, kst);
+	close(go[1]);
+	for (i = 0; i < nr_pairs; i++) {
+		kill(pids[2 * i], SIGKILL);
+		waitpid(pids[2 * i], NULL, 0);
+		waitpid(pids[2 * i + 1], NULL, 0);
+	}
+
+	if (bench_format == BENCH_FORMAT_DEFAULT) {
+		printf("# Executed %u binder calls per size in each of %u pair%s%s\n\n",
+		       loops, nr_pairs, nr_pairs > 1 ? "s" : "", echo ? ", echoed" : "");
+		printf(" %8s %10s %9s %9s %9s %9s %9s  (usecs)\n",
+		       "size", "calls/sec", "avg", "p50", "p90", "p99", "max");
+	}
+
+	for (s = 0; s < nr_sizes; s++) {
+		u64 sum = 0;
+
+		rate = 0;
+		for (i = 0, n = 0; i < nr_pairs; i++) {
+			struct bb_result *res = pair_result(i);
+
+			memcpy(all + n, &res->ns[s * loops], loops * sizeof(u64));
+			n += loops;
+			elapsed = res->elapsed_ns[s];
+			if (elapsed)
+				rate += (double)loops * 1e9 / elapsed;
+		}
+		for (i = 0; i < n; i++)
+			sum += all[i];
+		qsort(all, n, sizeof(u64), cmp_u64);
+
+		if (bench_format == BENCH_FORMAT_SIMPLE) {
+			printf("%u %.3f\n", sizes[s], (double)sum / n / 1000);
+			continue;
+		}
+		printf(" %8u %10.0f %9.3f %9.3f %9.3f %9.3f %9.3f\n", sizes[s], rate,
+		       (double)sum / n / 1000, all[n / 2] / 1000.0, all[n * 9 / 10] / 1000.0,
+		       all[n * 99 / 100] / 1000.0, all[n - 1] / 1000.0);
+		if (histogram)
+			print_histogram(all, n);
+	}
+
+	if (bench_format == BENCH_FORMAT_DEFAULT && have_kst) {
+		printf("\n# In the kernel, from binder/latency (avg/max usecs)\n\n %8s", "size");
+		for (i = 0; i < NR_STAGES; i++)
+			printf(" %13s", stage_names[i]);
+		printf("\n");
+		for (s = 0; s < nr_sizes; s++) {
+			printf(" %8u", sizes[s]);
+			for (i = 0; i < NR_STAGES; i++) {
+				struct stage_stat *st = &kst[s][i];
+				char buf[32];
+
+				snprintf(buf, sizeof(buf), "%llu/%llu",
+					 st->count ? (unsigned long long)(st->sum_us / st->count) : 0ULL,
+					 (unsigned long long)st->max_us);
+				printf(" %13s", buf);
+			}
+			printf("\n");
+		}
+	}
+
+	free(kst);
+	free(all);
+	free(pids);
+	munmap(results, result_size * nr_pairs);
+	return 0;
+}